@@ -99,35 +99,45 @@ struct ExecutableAllocator {
 
     static void makeWritable(void* addr, int size)
     {
-#if ENABLE(ASSEMBLER_WX_EXCLUSIVE)
+        if (!QV4::ExecutableAllocator::isWXExclusive()) {
+            // We assume we already have RWX
+            (void)addr; // suppress unused parameter warning
+            (void)size; // suppress unused parameter warning
+            return;
+        }
+
         size_t pageSize = WTF::pageSize();
         size_t iaddr = reinterpret_cast<size_t>(addr);
         size_t roundAddr = iaddr & ~(pageSize - static_cast<size_t>(1));
-
+#if OS(WINDOWS)
+#if !OS(WINRT)
+        DWORD oldProtect;
+        VirtualProtect(reinterpret_cast<void*>(roundAddr), size + (iaddr - roundAddr), PAGE_READWRITE, &oldProtect);
+#endif
+#else
         int mode = PROT_READ | PROT_WRITE;
         mprotect(reinterpret_cast<void*>(roundAddr), size + (iaddr - roundAddr), mode);
-#else
-        // We assume we already have RWX
-        (void)addr; // suppress unused parameter warning
-        (void)size; // suppress unused parameter warning
 #endif
     }
 
     static void makeExecutable(void* addr, int size)
     {
+        const bool wxExclusive = QV4::ExecutableAllocator::isWXExclusive();
         size_t pageSize = WTF::pageSize();
         size_t iaddr = reinterpret_cast<size_t>(addr);
         size_t roundAddr = iaddr & ~(pageSize - static_cast<size_t>(1));
 #if OS(WINDOWS)
 #if !OS(WINRT)
         DWORD oldProtect;
-        VirtualProtect(reinterpret_cast<void*>(roundAddr), size + (iaddr - roundAddr), PAGE_EXECUTE_READWRITE, &oldProtect);
+        VirtualProtect(reinterpret_cast<void*>(roundAddr), size + (iaddr - roundAddr),
+                       wxExclusive ? PAGE_EXECUTE_READ : PAGE_EXECUTE_READWRITE, &oldProtect);
+#else
+        (void)wxExclusive;
 #endif
 #else
         int mode = PROT_READ | PROT_EXEC;
-#if !ENABLE(ASSEMBLER_WX_EXCLUSIVE)
-        mode |= PROT_WRITE;
-#endif
+        if (!wxExclusive)
+            mode |= PROT_WRITE;
         mprotect(reinterpret_cast<void*>(roundAddr), size + (iaddr - roundAddr), mode);
 #endif
     }
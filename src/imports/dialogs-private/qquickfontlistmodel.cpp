@@ -52,6 +52,21 @@ QT_BEGIN_NAMESPACE
 
 using namespace QV4;
 
+// The number of families added to the model by each fetchMore().
+#define FONTLISTMODEL_FETCH_SIZE 64
+
+enum FontFamilyFlag {
+    FontFamilyKnown = 0x1,
+    FontFamilySmoothlyScalable = 0x2,
+    FontFamilyFixedPitch = 0x4
+};
+
+// Finding out whether a family is scalable or fixed pitch makes the font
+// database load the family, which is slow for large font sets. The answers
+// do not change for a family, so they are shared by all the models.
+typedef QHash<QString, int> QQuickFontFamilyFlags;
+Q_GLOBAL_STATIC(QQuickFontFamilyFlags, fontFamilyFlags)
+
 class QQuickFontListModelPrivate
 {
     Q_DECLARE_PUBLIC(QQuickFontListModel)
@@ -60,27 +75,84 @@ public:
     QQuickFontListModelPrivate(QQuickFontListModel *q)
         : q_ptr(q), ws(QFontDatabase::Any)
         , options(QSharedPointer<QFontDialogOptions>(new QFontDialogOptions()))
+        , checked(0), complete(false)
     {}
 
     QQuickFontListModel *q_ptr;
     QFontDatabase db;
     QFontDatabase::WritingSystem ws;
     QSharedPointer<QFontDialogOptions> options;
+    // the families of the writing system, of which the first checked
+    // have been filtered into families
+    QStringList candidates;
+    int checked;
     QStringList families;
     QHash<int, QByteArray> roleNames;
+    bool complete;
     ~QQuickFontListModelPrivate() {}
-    void init();
+    int familyFlags(const QString &family);
+    bool acceptFamily(const QString &family);
+    void fetch(int count, const QString &family = QString());
 };
 
 
-void QQuickFontListModelPrivate::init()
+int QQuickFontListModelPrivate::familyFlags(const QString &family)
+{
+    QQuickFontFamilyFlags *cache = fontFamilyFlags();
+    int flags = cache->value(family);
+    if (!(flags & FontFamilyKnown)) {
+        flags = FontFamilyKnown;
+        if (db.isSmoothlyScalable(family))
+            flags |= FontFamilySmoothlyScalable;
+        if (db.isFixedPitch(family))
+            flags |= FontFamilyFixedPitch;
+        cache->insert(family, flags);
+    }
+    return flags;
+}
+
+bool QQuickFontListModelPrivate::acceptFamily(const QString &family)
+{
+    const QFontDialogOptions::FontDialogOptions scalableMask = (QFontDialogOptions::FontDialogOptions)(QFontDialogOptions::ScalableFonts | QFontDialogOptions::NonScalableFonts);
+    const QFontDialogOptions::FontDialogOptions spacingMask = (QFontDialogOptions::FontDialogOptions)(QFontDialogOptions::ProportionalFonts | QFontDialogOptions::MonospacedFonts);
+    const QFontDialogOptions::FontDialogOptions opts = options->options();
+
+    if ((opts & scalableMask) && (opts & scalableMask) != scalableMask) {
+        if (bool(opts & QFontDialogOptions::ScalableFonts) != bool(familyFlags(family) & FontFamilySmoothlyScalable))
+            return false;
+    }
+    if ((opts & spacingMask) && (opts & spacingMask) != spacingMask) {
+        if (bool(opts & QFontDialogOptions::MonospacedFonts) != bool(familyFlags(family) & FontFamilyFixedPitch))
+            return false;
+    }
+    return true;
+}
+
+/*
+    Filters candidates until \a count more families have been accepted, or
+    until \a family has been accepted if it is given, and appends them to the
+    model.
+*/
+void QQuickFontListModelPrivate::fetch(int count, const QString &family)
 {
     Q_Q(QQuickFontListModel);
 
-    families = db.families();
+    QStringList accepted;
+    bool found = false;
+    while (checked < candidates.count() && (family.isEmpty() ? accepted.count() < count : !found)) {
+        const QString &candidate = candidates.at(checked++);
+        if (acceptFamily(candidate)) {
+            accepted << candidate;
+            found = candidate == family;
+        }
+    }
+    if (accepted.isEmpty())
+        return;
 
+    q->beginInsertRows(QModelIndex(), families.count(), families.count() + accepted.count() - 1);
+    families += accepted;
+    q->endInsertRows();
     emit q->rowCountChanged();
-    emit q->writingSystemChanged();
 }
 
 QQuickFontListModel::QQuickFontListModel(QObject *parent)
@@ -88,7 +160,6 @@ QQuickFontListModel::QQuickFontListModel(QObject *parent)
 {
     Q_D(QQuickFontListModel);
     d->roleNames[FontFamilyRole] = "family";
-    d->init();
 }
 
 QQuickFontListModel::~QQuickFontListModel()
@@ -127,6 +198,19 @@ int QQuickFontListModel::rowCount(const QModelIndex &parent) const
     return d->families.size();
 }
 
+bool QQuickFontListModel::canFetchMore(const QModelIndex &parent) const
+{
+    Q_D(const QQuickFontListModel);
+    return !parent.isValid() && d->checked < d->candidates.count();
+}
+
+void QQuickFontListModel::fetchMore(const QModelIndex &parent)
+{
+    Q_D(QQuickFontListModel);
+    if (!parent.isValid())
+        d->fetch(FONTLISTMODEL_FETCH_SIZE);
+}
+
 QModelIndex QQuickFontListModel::index(int row, int , const QModelIndex &) const
 {
     return createIndex(row, 0);
@@ -162,24 +246,23 @@ void QQuickFontListModel::updateFamilies()
 {
     Q_D(QQuickFontListModel);
 
-    beginResetModel();
-    const QFontDialogOptions::FontDialogOptions scalableMask = (QFontDialogOptions::FontDialogOptions)(QFontDialogOptions::ScalableFonts | QFontDialogOptions::NonScalableFonts);
-    const QFontDialogOptions::FontDialogOptions spacingMask = (QFontDialogOptions::FontDialogOptions)(QFontDialogOptions::ProportionalFonts | QFontDialogOptions::MonospacedFonts);
-    const QFontDialogOptions::FontDialogOptions options = d->options->options();
+    // the options are all set while the component is created, so
+    // the families are only listed once it is complete
+    if (!d->complete)
+        return;
 
+    beginResetModel();
+    d->candidates = d->db.families(d->ws);
+    d->checked = 0;
     d->families.clear();
-    foreach (const QString &family, d->db.families(d->ws)) {
-        if ((options & scalableMask) && (options & scalableMask) != scalableMask) {
-            if (bool(options & QFontDialogOptions::ScalableFonts) != d->db.isSmoothlyScalable(family))
-                continue;
-        }
-        if ((options & spacingMask) && (options & spacingMask) != spacingMask) {
-            if (bool(options & QFontDialogOptions::MonospacedFonts) != d->db.isFixedPitch(family))
-                continue;
-        }
-        d->families << family;
+    // the rest is filtered as the view asks for more rows
+    while (d->families.count() < FONTLISTMODEL_FETCH_SIZE && d->checked < d->candidates.count()) {
+        const QString &family = d->candidates.at(d->checked++);
+        if (d->acceptFamily(family))
+            d->families << family;
     }
     endResetModel();
+    emit rowCountChanged();
 }
 
 bool QQuickFontListModel::scalableFonts() const
@@ -227,6 +310,22 @@ QQmlV4Handle QQuickFontListModel::get(int idx) const
     return QQmlV4Handle(o);
 }
 
+/*
+    Returns the row of \a family, filtering the families up to it if they
+    have not been fetched yet, or -1 if the model does not contain it.
+*/
+int QQuickFontListModel::indexOf(const QString &family)
+{
+    Q_D(QQuickFontListModel);
+    int index = d->families.indexOf(family);
+    if (index == -1 && d->candidates.indexOf(family, d->checked) != -1) {
+        d->fetch(0, family);
+        if (!d->families.isEmpty() && d->families.last() == family)
+            index = d->families.count() - 1;
+    }
+    return index;
+}
+
 QQmlV4Handle QQuickFontListModel::pointSizes()
 {
     QQmlEngine *engine = qmlContext(this)->engine();
@@ -253,6 +352,10 @@ void QQuickFontListModel::classBegin()
 
 void QQuickFontListModel::componentComplete()
 {
+    Q_D(QQuickFontListModel);
+    d->complete = true;
+    updateFamilies();
+    emit writingSystemChanged();
 }
 
 void QQuickFontListModel::setScalableFonts(bool arg)
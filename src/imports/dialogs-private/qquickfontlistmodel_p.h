@@ -79,6 +79,8 @@ public:
     virtual QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const;
     virtual QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const;
     virtual QHash<int, QByteArray> roleNames() const;
+    virtual bool canFetchMore(const QModelIndex &parent) const;
+    virtual void fetchMore(const QModelIndex &parent);
 
     int count() const { return rowCount(QModelIndex()); }
 
@@ -91,6 +93,7 @@ public:
     bool proportionalFonts() const;
 
     Q_INVOKABLE QQmlV4Handle get(int index) const;
+    Q_INVOKABLE int indexOf(const QString &family);
     Q_INVOKABLE QQmlV4Handle pointSizes();
 
     virtual void classBegin();
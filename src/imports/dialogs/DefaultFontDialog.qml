@@ -212,15 +212,10 @@ AbstractFontDialog {
                                     content.font.family = fontModel.get(0).family
                                     fontListView.currentIndex = 0
                                 } else {
-                                    var find = false
-                                    for (var i = 0; i < fontModel.count; ++i) {
-                                        if (content.font.family == fontModel.get(i).family) {
-                                            find = true
-                                            fontListView.currentIndex = i
-                                            break
-                                        }
-                                    }
-                                    if (find == false) {
+                                    var i = fontModel.indexOf(content.font.family)
+                                    if (i >= 0) {
+                                        fontListView.currentIndex = i
+                                    } else {
                                         content.font.family = fontModel.get(0).family
                                         fontListView.currentIndex = 0
                                     }
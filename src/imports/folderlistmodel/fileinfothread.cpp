@@ -41,9 +41,15 @@
 
 #include "fileinfothread_p.h"
 #include <qdiriterator.h>
+#include <QSet>
+#include <QVector>
 
 #include <QDebug>
 
+// The number of rows delivered at a time while an unsorted directory is
+// still being read.
+#define FILEINFOTHREAD_CHUNK_SIZE 256
+
 
 FileInfoThread::FileInfoThread(QObject *parent)
     : QThread(parent),
@@ -248,6 +254,13 @@ void FileInfoThread::getFileInfos(const QString &path)
     if (showDirsFirst)
         sortFlags = sortFlags | QDir::DirsFirst;
 
+    if (!folderUpdate && !sortUpdate
+            && (sortFlags & (QDir::SortByMask | QDir::DirsFirst | QDir::DirsLast | QDir::Reversed)) == QDir::Unsorted) {
+        streamFileInfos(path, filter);
+        needUpdate = false;
+        return;
+    }
+
     QDir currentDir(path, QString(), sortFlags);
     QFileInfoList fileInfoList;
     QList<FileProperty> filePropertyList;
@@ -260,13 +273,21 @@ void FileInfoThread::getFileInfos(const QString &path)
             filePropertyList << FileProperty(info);
         }
         if (folderUpdate) {
-            int fromIndex = 0;
-            int toIndex = currentFileList.size()-1;
-            findChangeRange(filePropertyList, fromIndex, toIndex);
-            folderUpdate = false;
-            currentFileList = filePropertyList;
-            //qDebug() << "emit directoryUpdated : " << fromIndex << " " << toIndex;
-            emit directoryUpdated(path, filePropertyList, fromIndex, toIndex);
+            QList<QPair<int, int> > removed;
+            QList<QPair<int, int> > inserted;
+            if (findChanges(filePropertyList, removed, inserted)) {
+                folderUpdate = false;
+                currentFileList = filePropertyList;
+                emit directoryChangesFound(path, filePropertyList, removed, inserted);
+            } else {
+                int fromIndex = 0;
+                int toIndex = currentFileList.size()-1;
+                findChangeRange(filePropertyList, fromIndex, toIndex);
+                folderUpdate = false;
+                currentFileList = filePropertyList;
+                //qDebug() << "emit directoryUpdated : " << fromIndex << " " << toIndex;
+                emit directoryUpdated(path, filePropertyList, fromIndex, toIndex);
+            }
         } else {
             currentFileList = filePropertyList;
             if (sortUpdate) {
@@ -318,3 +339,96 @@ void FileInfoThread::findChangeRange(const QList<FileProperty> &list, int &fromI
     // For now I let the rest of the list be updated..
     toIndex = list.size() > currentFileList.size() ? list.size() - 1 : currentFileList.size() - 1;
 }
+
+// Entries are the same when both the name and the type match.
+static inline QString changeKey(const FileProperty &property)
+{
+    return property.isDir() ? property.fileName() + QLatin1Char('/') : property.fileName();
+}
+
+static void addToRangeList(QList<QPair<int, int> > &ranges, int index)
+{
+    if (!ranges.isEmpty() && ranges.last().first + ranges.last().second == index)
+        ++ranges.last().second;
+    else
+        ranges.append(qMakePair(index, 1));
+}
+
+/*
+    Finds the entries that were removed from the current list and the entries
+    that were added to \a list, as (index, count) ranges. The removed ranges are
+    indexes in the current list, the inserted ranges indexes in \a list.
+
+    Returns false if the entries present in both lists are not in the same
+    order, for example because a file that changed moved in a Time or Size
+    sort. The caller has to fall back to updating a whole range then.
+*/
+bool FileInfoThread::findChanges(const QList<FileProperty> &list, QList<QPair<int, int> > &removed,
+                                 QList<QPair<int, int> > &inserted) const
+{
+    QSet<QString> currentNames;
+    QSet<QString> newNames;
+    currentNames.reserve(currentFileList.size());
+    newNames.reserve(list.size());
+    foreach (const FileProperty &property, currentFileList)
+        currentNames.insert(changeKey(property));
+    foreach (const FileProperty &property, list)
+        newNames.insert(changeKey(property));
+
+    QVector<bool> kept(currentFileList.size());
+    for (int i = 0; i < currentFileList.size(); ++i) {
+        kept[i] = newNames.contains(changeKey(currentFileList.at(i)));
+        if (!kept.at(i))
+            addToRangeList(removed, i);
+    }
+
+    int current = 0;
+    for (int i = 0; i < list.size(); ++i) {
+        const FileProperty &property = list.at(i);
+        if (!currentNames.contains(changeKey(property))) {
+            addToRangeList(inserted, i);
+            continue;
+        }
+        while (current < currentFileList.size() && !kept.at(current))
+            ++current;
+        if (current == currentFileList.size() || currentFileList.at(current) != property)
+            return false;
+        ++current;
+    }
+    return true;
+}
+
+/*
+    Reads an unsorted directory and hands out the first rows while the rest of
+    the directory is still being read, so that a view on a very large
+    directory does not stay empty until everything has been listed.
+*/
+void FileInfoThread::streamFileInfos(const QString &path, QDir::Filters filter)
+{
+    QList<FileProperty> filePropertyList;
+    QList<FileProperty> chunk;
+    bool changed = false;
+
+    QDirIterator it(path, nameFilters, filter);
+    while (it.hasNext()) {
+        it.next();
+        FileProperty property(it.fileInfo());
+        filePropertyList << property;
+        chunk << property;
+        if (chunk.size() == FILEINFOTHREAD_CHUNK_SIZE) {
+            if (changed) {
+                emit directoryAppended(path, chunk);
+            } else {
+                emit directoryChanged(path, chunk);
+                changed = true;
+            }
+            chunk.clear();
+        }
+    }
+
+    if (!changed)
+        emit directoryChanged(path, chunk);
+    else if (!chunk.isEmpty())
+        emit directoryAppended(path, chunk);
+    currentFileList = filePropertyList;
+}
@@ -48,6 +48,7 @@
 #include <QFileSystemWatcher>
 #include <QFileInfo>
 #include <QDir>
+#include <QPair>
 
 #include "fileproperty_p.h"
 
@@ -59,6 +60,10 @@ Q_SIGNALS:
     void directoryChanged(const QString &directory, const QList<FileProperty> &list) const;
     void directoryUpdated(const QString &directory, const QList<FileProperty> &list, int fromIndex, int toIndex) const;
     void sortFinished(const QList<FileProperty> &list) const;
+    void directoryAppended(const QString &directory, const QList<FileProperty> &list) const;
+    void directoryChangesFound(const QString &directory, const QList<FileProperty> &list,
+                               const QList<QPair<int, int> > &removed,
+                               const QList<QPair<int, int> > &inserted) const;
 
 public:
     FileInfoThread(QObject *parent = 0);
@@ -87,6 +92,9 @@ protected:
     void run();
     void getFileInfos(const QString &path);
     void findChangeRange(const QList<FileProperty> &list, int &fromIndex, int &toIndex);
+    bool findChanges(const QList<FileProperty> &list, QList<QPair<int, int> > &removed,
+                     QList<QPair<int, int> > &inserted) const;
+    void streamFileInfos(const QString &path, QDir::Filters filter);
 
 private:
     QMutex mutex;
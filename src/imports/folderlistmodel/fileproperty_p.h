@@ -53,12 +53,11 @@ public:
         mFileName = info.fileName();
         mFilePath = info.filePath();
         mBaseName = info.baseName();
-        mSize = info.size();
         mSuffix = info.completeSuffix();
         mIsDir = info.isDir();
         mIsFile = info.isFile();
-        mLastModified = info.lastModified();
-        mLastRead = info.lastRead();
+        mSize = 0;
+        mStatLoaded = false;
     }
     ~FileProperty()
     {}
@@ -66,12 +65,12 @@ public:
     inline QString fileName() const { return mFileName; }
     inline QString filePath() const { return mFilePath; }
     inline QString baseName() const { return mBaseName; }
-    inline qint64 size() const { return mSize; }
+    inline qint64 size() const { loadStat(); return mSize; }
     inline QString suffix() const { return mSuffix; }
     inline bool isDir() const { return mIsDir; }
     inline bool isFile() const { return mIsFile; }
-    inline QDateTime lastModified() const { return mLastModified; }
-    inline QDateTime lastRead() const { return mLastRead; }
+    inline QDateTime lastModified() const { loadStat(); return mLastModified; }
+    inline QDateTime lastRead() const { loadStat(); return mLastRead; }
 
     inline bool operator !=(const FileProperty &fileInfo) const {
         return !operator==(fileInfo);
@@ -81,14 +80,29 @@ public:
     }
 
 private:
+    // The size and times need a stat() of the file, which is the expensive
+    // part of listing a large directory. They are only read the first time a
+    // delegate asks for them, which happens in the GUI thread.
+    void loadStat() const
+    {
+        if (mStatLoaded)
+            return;
+        QFileInfo info(mFilePath);
+        mSize = info.size();
+        mLastModified = info.lastModified();
+        mLastRead = info.lastRead();
+        mStatLoaded = true;
+    }
+
     QString mFileName;
     QString mFilePath;
     QString mBaseName;
     QString mSuffix;
-    qint64 mSize;
     bool mIsDir;
     bool mIsFile;
-    QDateTime mLastModified;
-    QDateTime mLastRead;
+    mutable bool mStatLoaded;
+    mutable qint64 mSize;
+    mutable QDateTime mLastModified;
+    mutable QDateTime mLastRead;
 };
 #endif // FILEPROPERTY_P_H
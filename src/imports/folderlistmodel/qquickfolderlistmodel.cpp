@@ -87,6 +87,10 @@ public:
     void _q_directoryChanged(const QString &directory, const QList<FileProperty> &list);
     void _q_directoryUpdated(const QString &directory, const QList<FileProperty> &list, int fromIndex, int toIndex);
     void _q_sortFinished(const QList<FileProperty> &list);
+    void _q_directoryAppended(const QString &directory, const QList<FileProperty> &list);
+    void _q_directoryChangesFound(const QString &directory, const QList<FileProperty> &list,
+                                  const QList<QPair<int, int> > &removed,
+                                  const QList<QPair<int, int> > &inserted);
 
     static QString resolvePath(const QUrl &path);
 };
@@ -96,12 +100,17 @@ void QQuickFolderListModelPrivate::init()
 {
     Q_Q(QQuickFolderListModel);
     qRegisterMetaType<QList<FileProperty> >("QList<FileProperty>");
+    qRegisterMetaType<QList<QPair<int, int> > >("QList<QPair<int,int> >");
     q->connect(&fileInfoThread, SIGNAL(directoryChanged(QString, QList<FileProperty>)),
                q, SLOT(_q_directoryChanged(QString, QList<FileProperty>)));
     q->connect(&fileInfoThread, SIGNAL(directoryUpdated(QString, QList<FileProperty>, int, int)),
                q, SLOT(_q_directoryUpdated(QString, QList<FileProperty>, int, int)));
     q->connect(&fileInfoThread, SIGNAL(sortFinished(QList<FileProperty>)),
                q, SLOT(_q_sortFinished(QList<FileProperty>)));
+    q->connect(&fileInfoThread, SIGNAL(directoryAppended(QString, QList<FileProperty>)),
+               q, SLOT(_q_directoryAppended(QString, QList<FileProperty>)));
+    q->connect(&fileInfoThread, SIGNAL(directoryChangesFound(QString, QList<FileProperty>, QList<QPair<int,int> >, QList<QPair<int,int> >)),
+               q, SLOT(_q_directoryChangesFound(QString, QList<FileProperty>, QList<QPair<int,int> >, QList<QPair<int,int> >)));
     q->connect(q, SIGNAL(rowCountChanged()), q, SIGNAL(countChanged()));
 }
 
@@ -206,6 +215,50 @@ void QQuickFolderListModelPrivate::_q_sortFinished(const QList<FileProperty> &li
     q->endInsertRows();
 }
 
+void QQuickFolderListModelPrivate::_q_directoryAppended(const QString &directory, const QList<FileProperty> &list)
+{
+    Q_Q(QQuickFolderListModel);
+
+    // Rows of a folder that was left while it was still being read.
+    if (list.isEmpty() || directory != resolvePath(currentDir))
+        return;
+
+    q->beginInsertRows(QModelIndex(), data.size(), data.size() + list.size() - 1);
+    data += list;
+    q->endInsertRows();
+    emit q->rowCountChanged();
+}
+
+void QQuickFolderListModelPrivate::_q_directoryChangesFound(const QString &directory, const QList<FileProperty> &list,
+                                                            const QList<QPair<int, int> > &removed,
+                                                            const QList<QPair<int, int> > &inserted)
+{
+    Q_Q(QQuickFolderListModel);
+    Q_UNUSED(directory);
+
+    QModelIndex parent;
+    // Remove from the back so that the indexes of the earlier ranges stay valid.
+    for (int i = removed.count() - 1; i >= 0; --i) {
+        const int index = removed.at(i).first;
+        const int count = removed.at(i).second;
+        q->beginRemoveRows(parent, index, index + count - 1);
+        data.erase(data.begin() + index, data.begin() + index + count);
+        q->endRemoveRows();
+    }
+    // The inserted ranges are indexes in the new list, which the rows before
+    // each range already match once the earlier ranges are inserted.
+    for (int i = 0; i < inserted.count(); ++i) {
+        const int index = inserted.at(i).first;
+        const int count = inserted.at(i).second;
+        q->beginInsertRows(parent, index, index + count - 1);
+        for (int j = index; j < index + count; ++j)
+            data.insert(j, list.at(j));
+        q->endInsertRows();
+    }
+    if (!removed.isEmpty() || !inserted.isEmpty())
+        emit q->rowCountChanged();
+}
+
 QString QQuickFolderListModelPrivate::resolvePath(const QUrl &path)
 {
     QString localPath = QQmlFile::urlToLocalFileOrQrc(path);
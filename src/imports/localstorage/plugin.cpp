@@ -54,6 +54,10 @@
 #include <QtCore/qcryptographichash.h>
 #include <QtCore/qsettings.h>
 #include <QtCore/qdir.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qcache.h>
+#include <QtCore/qvector.h>
+#include <QtCore/qmetatype.h>
 #include <private/qv4sqlerrors_p.h>
 #include <private/qv4engine_p.h>
 #include <private/qv4object_p.h>
@@ -85,6 +89,113 @@ using namespace QV4;
     return Encode::undefined(); \
 }
 
+// The number of prepared statements kept for each database connection.
+#define LOCALSTORAGE_STATEMENT_CACHE_SIZE 32
+
+struct QQmlSqlBinding
+{
+    QQmlSqlBinding() : index(-1) {}
+
+    QString name;   // bound by name if set, otherwise by index
+    int index;
+    QVariant value;
+};
+
+struct QQmlSqlStatement
+{
+    QString sql;
+    QList<QQmlSqlBinding> bindings;
+};
+
+struct QQmlSqlStatementResult
+{
+    QQmlSqlStatementResult() : ok(false), rowsAffected(0) {}
+
+    bool ok;
+    QString error;
+    int rowsAffected;
+    QString insertId;
+    QVector<QSqlRecord> records;
+};
+
+struct QQmlSqlJob
+{
+    enum Kind { Execute, Commit, Rollback };
+
+    QQmlSqlJob() : transactionId(0), kind(Execute), begin(false) {}
+
+    int transactionId;
+    Kind kind;
+    bool begin;
+    QList<QQmlSqlStatement> statements;
+};
+
+struct QQmlSqlJobResult
+{
+    QQmlSqlJobResult() : transactionId(0), kind(QQmlSqlJob::Execute), ok(true) {}
+
+    int transactionId;
+    QQmlSqlJob::Kind kind;
+    bool ok;
+    QString error;
+    QList<QQmlSqlStatementResult> results;
+};
+
+Q_DECLARE_METATYPE(QQmlSqlJob)
+Q_DECLARE_METATYPE(QQmlSqlJobResult)
+
+/*
+    A least recently used cache of prepared queries for a single connection.
+
+    A query is taken out of the cache while it is in use and put back once its results are no
+    longer needed, so a query is never shared between two result sets.
+*/
+class QQmlSqlStatementCache
+{
+public:
+    QQmlSqlStatementCache() : m_queries(LOCALSTORAGE_STATEMENT_CACHE_SIZE) {}
+
+    QSqlQuery take(const QSqlDatabase &database, const QString &sql, bool forwardOnly, bool *prepared);
+    void release(const QString &sql, QSqlQuery &query);
+
+private:
+    QCache<QString, QSqlQuery> m_queries;
+};
+
+QSqlQuery QQmlSqlStatementCache::take(const QSqlDatabase &database, const QString &sql, bool forwardOnly, bool *prepared)
+{
+    QSqlQuery *cached = m_queries.take(sql);
+    if (cached && cached->driver() != database.driver()) {
+        // The connection has been removed and added again since the query was prepared.
+        delete cached;
+        cached = 0;
+    }
+
+    if (cached) {
+        QSqlQuery query = *cached;
+        delete cached;
+
+        // Values bound by the previous execution would otherwise be reused for any placeholder
+        // which isn't bound this time.
+        for (int ii = 0; ii < query.boundValues().count(); ++ii)
+            query.bindValue(ii, QVariant());
+        *prepared = true;
+        return query;
+    }
+
+    QSqlQuery query(database);
+    query.setForwardOnly(forwardOnly);
+    *prepared = query.prepare(sql);
+    return query;
+}
+
+void QQmlSqlStatementCache::release(const QString &sql, QSqlQuery &query)
+{
+    query.finish();
+    m_queries.insert(sql, new QSqlQuery(query));
+}
+
+class QQmlSqlAsyncDatabase;
 
 class QQmlSqlDatabaseData : public QV8Engine::Deletable
 {
@@ -92,9 +203,19 @@ public:
     QQmlSqlDatabaseData(QV8Engine *engine);
     ~QQmlSqlDatabaseData();
 
+    QQmlSqlStatementCache *statementCache(const QString &connectionName);
+    QQmlSqlAsyncDatabase *asyncDatabase(const QString &connectionName, const QString &databaseName);
+
     PersistentValue databaseProto;
     PersistentValue queryProto;
     PersistentValue rowsProto;
+    PersistentValue asyncDatabaseProto;
+    PersistentValue asyncQueryProto;
+
+private:
+    QV8Engine *m_engine;
+    QHash<QString, QQmlSqlStatementCache *> m_statementCaches;
+    QHash<QString, QQmlSqlAsyncDatabase *> m_asyncDatabases;
 };
 
 V8_DEFINE_EXTENSION(QQmlSqlDatabaseData, databaseData)
@@ -104,9 +225,10 @@ class QQmlSqlDatabaseWrapper : public Object
     V4_OBJECT
 
 public:
-    enum Type { Database, Query, Rows };
+    enum Type { Database, Query, Rows, AsyncDatabase, AsyncQuery };
     QQmlSqlDatabaseWrapper(QV8Engine *e)
         : Object(QV8Engine::getV4(e)), type(Database), inTransaction(false), readonly(false), forwardOnly(false)
+        , hasRecords(false), asyncDatabase(0), transactionId(0)
     {
         setVTable(staticVTable());
     }
@@ -129,6 +251,11 @@ public:
 
     QSqlQuery sqlQuery; // type == Rows
     bool forwardOnly; // type == Rows
+    QVector<QSqlRecord> records; // type == Rows, read by an asynchronous transaction
+    bool hasRecords; // type == Rows
+
+    QQmlSqlAsyncDatabase *asyncDatabase; // type == AsyncDatabase or AsyncQuery
+    int transactionId; // type == AsyncQuery
 };
 
 DEFINE_REF(QQmlSqlDatabaseWrapper, Object);
@@ -138,7 +265,7 @@ static ReturnedValue qmlsqldatabase_version(CallContext *ctx)
 {
     QV4::Scope scope(ctx);
     QV4::Scoped<QQmlSqlDatabaseWrapper> r(scope, ctx->callData->thisObject.as<QQmlSqlDatabaseWrapper>());
-    if (!r || r->type != QQmlSqlDatabaseWrapper::Database)
+    if (!r || (r->type != QQmlSqlDatabaseWrapper::Database && r->type != QQmlSqlDatabaseWrapper::AsyncDatabase))
         V4THROW_REFERENCE("Not a SQLDatabase object");
 
     return Encode(ctx->engine->newString(r->version));
@@ -151,6 +278,9 @@ static ReturnedValue qmlsqldatabase_rows_length(CallContext *ctx)
     if (!r || r->type != QQmlSqlDatabaseWrapper::Rows)
         V4THROW_REFERENCE("Not a SQLDatabase::Rows object");
 
+    if (r->hasRecords)
+        return Encode(r->records.count());
+
     int s = r->sqlQuery.size();
     if (s < 0) {
         // Inefficient
@@ -169,6 +299,8 @@ static ReturnedValue qmlsqldatabase_rows_forwardOnly(CallContext *ctx)
     QV4::Scoped<QQmlSqlDatabaseWrapper> r(scope, ctx->callData->thisObject.as<QQmlSqlDatabaseWrapper>());
     if (!r || r->type != QQmlSqlDatabaseWrapper::Rows)
         V4THROW_REFERENCE("Not a SQLDatabase::Rows object");
+    if (r->hasRecords)
+        return Encode(r->forwardOnly);
     return Encode(r->sqlQuery.isForwardOnly());
 }
 
@@ -181,12 +313,25 @@ static ReturnedValue qmlsqldatabase_rows_setForwardOnly(CallContext *ctx)
     if (ctx->callData->argc < 1)
         return ctx->throwTypeError();
 
-    r->sqlQuery.setForwardOnly(ctx->callData->args[0].toBoolean());
+    if (r->hasRecords)
+        r->forwardOnly = ctx->callData->args[0].toBoolean();
+    else
+        r->sqlQuery.setForwardOnly(ctx->callData->args[0].toBoolean());
     return Encode::undefined();
 }
 
 QQmlSqlDatabaseData::~QQmlSqlDatabaseData()
 {
+    qDeleteAll(m_asyncDatabases);
+    qDeleteAll(m_statementCaches);
+}
+
+QQmlSqlStatementCache *QQmlSqlDatabaseData::statementCache(const QString &connectionName)
+{
+    QQmlSqlStatementCache *&cache = m_statementCaches[connectionName];
+    if (!cache)
+        cache = new QQmlSqlStatementCache;
+    return cache;
 }
 
 static QString qmlsqldatabase_databasesPath(QV8Engine *engine)
@@ -212,8 +357,13 @@ static ReturnedValue qmlsqldatabase_rows_index(QQmlSqlDatabaseWrapperRef r, Exec
     Scope scope(v4);
     QV8Engine *v8 = v4->v8Engine;
 
-    if (r->sqlQuery.at() == (int)index || r->sqlQuery.seek(index)) {
-        QSqlRecord record = r->sqlQuery.record();
+    // Rows read by an asynchronous transaction are only converted when they are accessed.
+    const bool hasRecord = r->hasRecords
+            ? index < quint32(r->records.count())
+            : (r->sqlQuery.at() == (int)index || r->sqlQuery.seek(index));
+
+    if (hasRecord) {
+        QSqlRecord record = r->hasRecords ? r->records.at(index) : r->sqlQuery.record();
         // XXX optimize
         Scoped<Object> row(scope, v4->newObject());
         for (int ii = 0; ii < record.count(); ++ii) {
@@ -252,6 +402,86 @@ static ReturnedValue qmlsqldatabase_rows_item(CallContext *ctx)
     return qmlsqldatabase_rows_index(r, ctx->engine, ctx->callData->argc ? ctx->callData->args[0].toUInt32() : 0);
 }
 
+static void qmlsqldatabase_bindings(QV8Engine *engine, const ValueRef values, QList<QQmlSqlBinding> *bindings)
+{
+    Scope scope(QV8Engine::getV4(engine));
+
+    if (values->asArrayObject()) {
+        ScopedArrayObject array(scope, values);
+        quint32 size = array->getLength();
+        QV4::ScopedValue v(scope);
+        for (quint32 ii = 0; ii < size; ++ii) {
+            QQmlSqlBinding binding;
+            binding.index = ii;
+            binding.value = engine->toVariant((v = array->getIndexed(ii)), -1);
+            bindings->append(binding);
+        }
+    } else if (values->asObject()) {
+        ScopedObject object(scope, values);
+        ObjectIterator it(scope, object, ObjectIterator::WithProtoChain|ObjectIterator::EnumerableOnly);
+        ScopedValue key(scope);
+        QV4::ScopedValue val(scope);
+        while (1) {
+            key = it.nextPropertyName(val);
+            if (key->isNull())
+                break;
+            QQmlSqlBinding binding;
+            binding.value = engine->toVariant(val, -1);
+            if (key->isString()) {
+                binding.name = key->stringValue()->toQString();
+            } else {
+                assert(key->isInteger());
+                binding.index = key->integerValue();
+            }
+            bindings->append(binding);
+        }
+    } else {
+        QQmlSqlBinding binding;
+        binding.index = 0;
+        binding.value = engine->toVariant(values, -1);
+        bindings->append(binding);
+    }
+}
+
+static void qmlsqldatabase_bind(QSqlQuery *query, const QList<QQmlSqlBinding> &bindings)
+{
+    for (int ii = 0; ii < bindings.count(); ++ii) {
+        const QQmlSqlBinding &binding = bindings.at(ii);
+        if (binding.name.isEmpty())
+            query->bindValue(binding.index, binding.value);
+        else
+            query->bindValue(binding.name, binding.value);
+    }
+}
+
+static ReturnedValue qmlsqldatabase_newRows(ExecutionContext *ctx, const QSqlDatabase &db)
+{
+    QV8Engine *engine = ctx->engine->v8Engine;
+    Scope scope(ctx);
+
+    QV4::Scoped<QQmlSqlDatabaseWrapper> rows(scope, new (ctx->engine->memoryManager) QQmlSqlDatabaseWrapper(engine));
+    QV4::ScopedObject p(scope, databaseData(engine)->rowsProto.value());
+    rows->setPrototype(p.getPointer());
+    rows->type = QQmlSqlDatabaseWrapper::Rows;
+    rows->database = db;
+    return rows.asReturnedValue();
+}
+
+static ReturnedValue qmlsqldatabase_newResultSet(ExecutionContext *ctx, int rowsAffected, const QString &insertId, const ValueRef rows)
+{
+    QV8Engine *engine = ctx->engine->v8Engine;
+    Scope scope(ctx);
+
+    Scoped<Object> resultObject(scope, ctx->engine->newObject());
+    // XXX optimize
+    ScopedString s(scope);
+    ScopedValue v(scope);
+    resultObject->put((s = ctx->engine->newIdentifier("rowsAffected")), (v = Primitive::fromInt32(rowsAffected)));
+    resultObject->put((s = ctx->engine->newIdentifier("insertId")), (v = engine->toString(insertId)));
+    resultObject->put((s = ctx->engine->newIdentifier("rows")), rows);
+    return resultObject.asReturnedValue();
+}
+
 static ReturnedValue qmlsqldatabase_executeSql(CallContext *ctx)
 {
     QV4::Scope scope(ctx);
@@ -272,57 +502,30 @@ static ReturnedValue qmlsqldatabase_executeSql(CallContext *ctx)
         V4THROW_SQL(SQLEXCEPTION_SYNTAX_ERR, QQmlEngine::tr("Read-only Transaction"));
     }
 
-    QSqlQuery query(db);
+    QQmlSqlStatementCache *statements = databaseData(engine)->statementCache(db.connectionName());
     bool err = false;
+    bool prepared = false;
+    QSqlQuery query = statements->take(db, sql, false, &prepared);
 
     ScopedValue result(scope, Primitive::undefinedValue());
 
-    if (query.prepare(sql)) {
+    if (prepared) {
         if (ctx->callData->argc > 1) {
             ScopedValue values(scope, ctx->callData->args[1]);
-            if (values->asArrayObject()) {
-                ScopedArrayObject array(scope, values);
-                quint32 size = array->getLength();
-                QV4::ScopedValue v(scope);
-                for (quint32 ii = 0; ii < size; ++ii)
-                    query.bindValue(ii, engine->toVariant((v = array->getIndexed(ii)), -1));
-            } else if (values->asObject()) {
-                ScopedObject object(scope, values);
-                ObjectIterator it(scope, object, ObjectIterator::WithProtoChain|ObjectIterator::EnumerableOnly);
-                ScopedValue key(scope);
-                QV4::ScopedValue val(scope);
-                while (1) {
-                    key = it.nextPropertyName(val);
-                    if (key->isNull())
-                        break;
-                    QVariant v = engine->toVariant(val, -1);
-                    if (key->isString()) {
-                        query.bindValue(key->stringValue()->toQString(), v);
-                    } else {
-                        assert(key->isInteger());
-                        query.bindValue(key->integerValue(), v);
-                    }
-                }
-            } else {
-                query.bindValue(0, engine->toVariant(values, -1));
-            }
+            QList<QQmlSqlBinding> bindings;
+            qmlsqldatabase_bindings(engine, values, &bindings);
+            qmlsqldatabase_bind(&query, bindings);
         }
         if (query.exec()) {
-            QV4::Scoped<QQmlSqlDatabaseWrapper> rows(scope, new (ctx->engine->memoryManager) QQmlSqlDatabaseWrapper(engine));
-            QV4::ScopedObject p(scope, databaseData(engine)->rowsProto.value());
-            rows->setPrototype(p.getPointer());
-            rows->type = QQmlSqlDatabaseWrapper::Rows;
-            rows->database = db;
-            rows->sqlQuery = query;
-
-            Scoped<Object> resultObject(scope, ctx->engine->newObject());
-            result = resultObject.asReturnedValue();
-            // XXX optimize
-            ScopedString s(scope);
-            ScopedValue v(scope);
-            resultObject->put((s = ctx->engine->newIdentifier("rowsAffected")), (v = Primitive::fromInt32(query.numRowsAffected())));
-            resultObject->put((s = ctx->engine->newIdentifier("insertId")), (v = engine->toString(query.lastInsertId().toString())));
-            resultObject->put((s = ctx->engine->newIdentifier("rows")), rows);
+            QV4::Scoped<QQmlSqlDatabaseWrapper> rows(scope, qmlsqldatabase_newRows(ctx, db));
+            result = qmlsqldatabase_newResultSet(ctx, query.numRowsAffected(), query.lastInsertId().toString(), rows);
+
+            // The rows of a SELECT are read from the query as they are accessed, so it can
+            // only be reused for other statements.
+            if (query.isSelect())
+                rows->sqlQuery = query;
+            else
+                statements->release(sql, query);
         } else {
             err = true;
         }
@@ -472,7 +675,510 @@ static ReturnedValue qmlsqldatabase_read_transaction(CallContext *ctx)
     return qmlsqldatabase_transaction_shared(ctx, true);
 }
 
+/*
+    Runs the statements of asynchronous transactions on the thread of a single database, using
+    a connection of its own.
+*/
+class QQmlSqlDatabaseWorker : public QObject
+{
+    Q_OBJECT
+public:
+    QQmlSqlDatabaseWorker(const QString &connectionName, const QString &databaseName)
+        : m_connectionName(connectionName), m_databaseName(databaseName), m_statements(0)
+    {
+    }
+    ~QQmlSqlDatabaseWorker();
+
+public Q_SLOTS:
+    void process(const QQmlSqlJob &job);
+
+Q_SIGNALS:
+    void processed(const QQmlSqlJobResult &result);
+
+private:
+    QString m_connectionName;
+    QString m_databaseName;
+    QSqlDatabase m_database;
+    QQmlSqlStatementCache *m_statements;
+};
+
+QQmlSqlDatabaseWorker::~QQmlSqlDatabaseWorker()
+{
+    delete m_statements;
+    if (m_database.isValid()) {
+        m_database.close();
+        m_database = QSqlDatabase();
+        QSqlDatabase::removeDatabase(m_connectionName);
+    }
+}
+
+void QQmlSqlDatabaseWorker::process(const QQmlSqlJob &job)
+{
+    QQmlSqlJobResult result;
+    result.transactionId = job.transactionId;
+    result.kind = job.kind;
+
+    if (!m_database.isValid()) {
+        m_database = QSqlDatabase::addDatabase(QLatin1String("QSQLITE"), m_connectionName);
+        m_database.setDatabaseName(m_databaseName);
+        m_statements = new QQmlSqlStatementCache;
+    }
+    if (!m_database.isOpen() && !m_database.open()) {
+        result.ok = false;
+        result.error = m_database.lastError().text();
+        emit processed(result);
+        return;
+    }
+
+    switch (job.kind) {
+    case QQmlSqlJob::Execute:
+        if (job.begin && !m_database.transaction()) {
+            result.ok = false;
+            result.error = m_database.lastError().text();
+            break;
+        }
+        for (int ii = 0; ii < job.statements.count(); ++ii) {
+            const QQmlSqlStatement &statement = job.statements.at(ii);
+            QQmlSqlStatementResult statementResult;
+
+            bool ok = false;
+            QSqlQuery query = m_statements->take(m_database, statement.sql, true, &ok);
+            if (ok) {
+                qmlsqldatabase_bind(&query, statement.bindings);
+                ok = query.exec();
+            }
+
+            if (ok) {
+                statementResult.ok = true;
+                statementResult.rowsAffected = query.numRowsAffected();
+                statementResult.insertId = query.lastInsertId().toString();
+                if (query.isSelect()) {
+                    while (query.next())
+                        statementResult.records.append(query.record());
+                }
+                m_statements->release(statement.sql, query);
+            } else {
+                statementResult.error = query.lastError().text();
+            }
+
+            result.results.append(statementResult);
+            if (!statementResult.ok)
+                break;
+        }
+        break;
+    case QQmlSqlJob::Commit:
+        if (!m_database.commit()) {
+            result.ok = false;
+            result.error = m_database.lastError().text();
+            m_database.rollback();
+        }
+        break;
+    case QQmlSqlJob::Rollback:
+        m_database.rollback();
+        break;
+    }
+
+    emit processed(result);
+}
+
+/*
+    Queues the asynchronous transactions of a database and runs them one at a time, sending
+    their statements to a QQmlSqlDatabaseWorker and calling back into JavaScript with the
+    results.
+*/
+class QQmlSqlAsyncDatabase : public QObject
+{
+    Q_OBJECT
+public:
+    QQmlSqlAsyncDatabase(QV8Engine *engine, const QString &connectionName, const QString &databaseName);
+    ~QQmlSqlAsyncDatabase();
+
+    void transaction(const ValueRef callback, const ValueRef errorCallback, const ValueRef successCallback, bool readOnly);
+    bool executeSql(int transactionId, const QQmlSqlStatement &statement, const ValueRef callback, const ValueRef errorCallback);
+
+Q_SIGNALS:
+    void process(const QQmlSqlJob &job);
+
+private Q_SLOTS:
+    void processTransactions();
+    void processed(const QQmlSqlJobResult &result);
+
+private:
+    struct Statement
+    {
+        QQmlSqlStatement statement;
+        PersistentValue callback;
+        PersistentValue errorCallback;
+    };
+
+    struct Transaction
+    {
+        Transaction() : id(0), readOnly(false), started(false), accepting(false), errorCode(0) {}
+
+        int id;
+        bool readOnly;
+        bool started;
+        bool accepting; // true while one of the transaction's callbacks is running
+        PersistentValue callback;
+        PersistentValue errorCallback;
+        PersistentValue successCallback;
+        PersistentValue query;
+        QList<Statement> statements;
+        QList<Statement> executing;
+        int errorCode;
+        QString error;
+    };
+
+    bool call(Transaction *transaction, const PersistentValue &function, CallData *callData, ReturnedValue *result = 0);
+    ReturnedValue newError(int code, const QString &message);
+    void sendStatements(Transaction *transaction, bool begin);
+    void send(Transaction *transaction, QQmlSqlJob::Kind kind);
+    void fail(Transaction *transaction, int code, const QString &message);
+    void finish(Transaction *transaction);
+
+    QV8Engine *m_engine;
+    QThread m_thread;
+    QList<Transaction> m_transactions;
+    int m_nextTransactionId;
+    bool m_busy;
+};
+
+QQmlSqlAsyncDatabase::QQmlSqlAsyncDatabase(QV8Engine *engine, const QString &connectionName, const QString &databaseName)
+    : m_engine(engine), m_nextTransactionId(1), m_busy(false)
+{
+    qRegisterMetaType<QQmlSqlJob>("QQmlSqlJob");
+    qRegisterMetaType<QQmlSqlJobResult>("QQmlSqlJobResult");
+
+    QQmlSqlDatabaseWorker *worker = new QQmlSqlDatabaseWorker(
+            connectionName + QLatin1String("_async"), databaseName);
+    worker->moveToThread(&m_thread);
+    connect(&m_thread, SIGNAL(finished()), worker, SLOT(deleteLater()));
+    connect(this, SIGNAL(process(QQmlSqlJob)), worker, SLOT(process(QQmlSqlJob)));
+    connect(worker, SIGNAL(processed(QQmlSqlJobResult)), this, SLOT(processed(QQmlSqlJobResult)));
+    m_thread.start();
+}
+
+QQmlSqlAsyncDatabase::~QQmlSqlAsyncDatabase()
+{
+    m_thread.quit();
+    m_thread.wait();
+}
+
+void QQmlSqlAsyncDatabase::transaction(const ValueRef callback, const ValueRef errorCallback, const ValueRef successCallback, bool readOnly)
+{
+    Transaction transaction;
+    transaction.id = m_nextTransactionId++;
+    transaction.readOnly = readOnly;
+    transaction.callback = callback;
+    transaction.errorCallback = errorCallback;
+    transaction.successCallback = successCallback;
+    m_transactions.append(transaction);
+
+    if (m_transactions.count() == 1)
+        QMetaObject::invokeMethod(this, "processTransactions", Qt::QueuedConnection);
+}
+
+bool QQmlSqlAsyncDatabase::executeSql(int transactionId, const QQmlSqlStatement &statement, const ValueRef callback, const ValueRef errorCallback)
+{
+    if (m_transactions.isEmpty())
+        return false;
+
+    Transaction &transaction = m_transactions.first();
+    if (transaction.id != transactionId || !transaction.accepting)
+        return false;
+
+    Statement pending;
+    pending.statement = statement;
+    pending.callback = callback;
+    pending.errorCallback = errorCallback;
+    transaction.statements.append(pending);
+    return true;
+}
+
+/*
+    Calls \a function, if there is one.  Returns false if it threw an exception, in which case
+    the exception becomes the error of \a transaction.
+*/
+bool QQmlSqlAsyncDatabase::call(Transaction *transaction, const PersistentValue &function, CallData *callData, ReturnedValue *result)
+{
+    ExecutionEngine *v4 = QV8Engine::getV4(m_engine);
+    Scope scope(v4);
+    Scoped<FunctionObject> f(scope, function.value());
+    if (!f)
+        return true;
+
+    ExecutionContext *ctx = v4->currentContext();
+    if (transaction)
+        transaction->accepting = true;
+    ScopedValue value(scope, f->call(callData));
+    if (transaction)
+        transaction->accepting = false;
+
+    if (v4->hasException) {
+        QQmlError error = QV4::ExecutionEngine::catchExceptionAsQmlError(ctx);
+        if (transaction) {
+            transaction->errorCode = SQLEXCEPTION_UNKNOWN_ERR;
+            transaction->error = error.description();
+        } else {
+            QQmlEnginePrivate::warning(QQmlEnginePrivate::get(m_engine->engine()), error);
+        }
+        return false;
+    }
+
+    if (result)
+        *result = value.asReturnedValue();
+    return true;
+}
+
+ReturnedValue QQmlSqlAsyncDatabase::newError(int code, const QString &message)
+{
+    ExecutionEngine *v4 = QV8Engine::getV4(m_engine);
+    Scope scope(v4);
+
+    Scoped<Object> error(scope, v4->newObject());
+    ScopedString s(scope);
+    ScopedValue v(scope);
+    error->put((s = v4->newIdentifier(QStringLiteral("code"))), (v = Primitive::fromInt32(code)));
+    error->put((s = v4->newIdentifier(QStringLiteral("message"))), (v = v4->newString(message)));
+    return error.asReturnedValue();
+}
+
+void QQmlSqlAsyncDatabase::sendStatements(Transaction *transaction, bool begin)
+{
+    QQmlSqlJob job;
+    job.transactionId = transaction->id;
+    job.kind = QQmlSqlJob::Execute;
+    job.begin = begin;
+
+    transaction->executing = transaction->statements;
+    transaction->statements.clear();
+    for (int ii = 0; ii < transaction->executing.count(); ++ii)
+        job.statements.append(transaction->executing.at(ii).statement);
+
+    m_busy = true;
+    emit process(job);
+}
+
+void QQmlSqlAsyncDatabase::send(Transaction *transaction, QQmlSqlJob::Kind kind)
+{
+    QQmlSqlJob job;
+    job.transactionId = transaction->id;
+    job.kind = kind;
+
+    m_busy = true;
+    emit process(job);
+}
+
+void QQmlSqlAsyncDatabase::fail(Transaction *transaction, int code, const QString &message)
+{
+    transaction->errorCode = code;
+    transaction->error = message;
+    transaction->statements.clear();
+    transaction->executing.clear();
+    send(transaction, QQmlSqlJob::Rollback);
+}
+
+void QQmlSqlAsyncDatabase::finish(Transaction *transaction)
+{
+    ExecutionEngine *v4 = QV8Engine::getV4(m_engine);
+    Scope scope(v4);
+
+    // Take the transaction off the queue first, so that its callbacks can start new ones.
+    Transaction finished = *transaction;
+    m_transactions.removeFirst();
+
+    if (finished.error.isEmpty()) {
+        ScopedCallData callData(scope, 0);
+        callData->thisObject = m_engine->global();
+        call(0, finished.successCallback, callData);
+    } else {
+        ScopedCallData callData(scope, 1);
+        callData->thisObject = m_engine->global();
+        callData->args[0] = newError(finished.errorCode, finished.error);
+        call(0, finished.errorCallback, callData);
+    }
+
+    if (!m_transactions.isEmpty())
+        QMetaObject::invokeMethod(this, "processTransactions", Qt::QueuedConnection);
+}
+
+void QQmlSqlAsyncDatabase::processTransactions()
+{
+    if (m_busy || m_transactions.isEmpty() || m_transactions.first().started)
+        return;
+
+    ExecutionEngine *v4 = QV8Engine::getV4(m_engine);
+    Scope scope(v4);
+
+    Transaction *transaction = &m_transactions.first();
+    transaction->started = true;
+
+    Scoped<QQmlSqlDatabaseWrapper> query(scope, new (v4->memoryManager) QQmlSqlDatabaseWrapper(m_engine));
+    ScopedObject p(scope, databaseData(m_engine)->asyncQueryProto.value());
+    query->setPrototype(p.getPointer());
+    query->type = QQmlSqlDatabaseWrapper::AsyncQuery;
+    query->readonly = transaction->readOnly;
+    query->asyncDatabase = this;
+    query->transactionId = transaction->id;
+    transaction->query = query;
+
+    ScopedCallData callData(scope, 1);
+    callData->thisObject = m_engine->global();
+    callData->args[0] = query;
+    if (!call(transaction, transaction->callback, callData)) {
+        // Nothing has been sent to the database yet.
+        finish(transaction);
+        return;
+    }
+
+    sendStatements(transaction, true);
+}
+
+void QQmlSqlAsyncDatabase::processed(const QQmlSqlJobResult &result)
+{
+    m_busy = false;
+    if (m_transactions.isEmpty() || m_transactions.first().id != result.transactionId)
+        return;
+
+    ExecutionEngine *v4 = QV8Engine::getV4(m_engine);
+    Scope scope(v4);
+    QV4::ExecutionContext *ctx = v4->currentContext();
+
+    Transaction *transaction = &m_transactions.first();
+
+    switch (result.kind) {
+    case QQmlSqlJob::Execute:
+        if (!result.ok) {
+            fail(transaction, SQLEXCEPTION_DATABASE_ERR, result.error);
+            return;
+        }
+
+        for (int ii = 0; ii < result.results.count(); ++ii) {
+            const QQmlSqlStatementResult &statementResult = result.results.at(ii);
+            const Statement &statement = transaction->executing.at(ii);
+
+            Scope scope(v4);
+            ScopedCallData callData(scope, 2);
+            callData->thisObject = m_engine->global();
+            callData->args[0] = transaction->query.value();
+
+            if (statementResult.ok) {
+                Scoped<QQmlSqlDatabaseWrapper> rows(scope, qmlsqldatabase_newRows(ctx, QSqlDatabase()));
+                rows->records = statementResult.records;
+                rows->hasRecords = true;
+                callData->args[1] = qmlsqldatabase_newResultSet(ctx, statementResult.rowsAffected, statementResult.insertId, rows);
+
+                if (!call(transaction, statement.callback, callData)) {
+                    fail(transaction, transaction->errorCode, transaction->error);
+                    return;
+                }
+            } else {
+                // The transaction only continues if the error callback returns false.
+                callData->args[1] = newError(SQLEXCEPTION_DATABASE_ERR, statementResult.error);
+                ReturnedValue handled = Encode::undefined();
+                if (!call(transaction, statement.errorCallback, callData, &handled)) {
+                    fail(transaction, transaction->errorCode, transaction->error);
+                    return;
+                }
+                ScopedValue value(scope, handled);
+                if (!value->isBoolean() || value->booleanValue()) {
+                    fail(transaction, SQLEXCEPTION_DATABASE_ERR, statementResult.error);
+                    return;
+                }
+            }
+        }
+
+        // Statements after a failed one which was handled haven't run yet and go before any
+        // queued by the callbacks.
+        for (int ii = transaction->executing.count() - 1; ii >= result.results.count(); --ii)
+            transaction->statements.prepend(transaction->executing.at(ii));
+        transaction->executing.clear();
+
+        if (!transaction->statements.isEmpty())
+            sendStatements(transaction, false);
+        else
+            send(transaction, QQmlSqlJob::Commit);
+        break;
+    case QQmlSqlJob::Commit:
+        if (!result.ok) {
+            transaction->errorCode = SQLEXCEPTION_UNKNOWN_ERR;
+            transaction->error = result.error;
+        }
+        finish(transaction);
+        break;
+    case QQmlSqlJob::Rollback:
+        finish(transaction);
+        break;
+    }
+}
+
+QQmlSqlAsyncDatabase *QQmlSqlDatabaseData::asyncDatabase(const QString &connectionName, const QString &databaseName)
+{
+    QQmlSqlAsyncDatabase *&database = m_asyncDatabases[connectionName];
+    if (!database)
+        database = new QQmlSqlAsyncDatabase(m_engine, connectionName, databaseName);
+    return database;
+}
+
+static ReturnedValue qmlsqldatabase_async_transaction_shared(CallContext *ctx, bool readOnly)
+{
+    QV4::Scope scope(ctx);
+    QV4::Scoped<QQmlSqlDatabaseWrapper> r(scope, ctx->callData->thisObject.as<QQmlSqlDatabaseWrapper>());
+    if (!r || r->type != QQmlSqlDatabaseWrapper::AsyncDatabase)
+        V4THROW_REFERENCE("Not a SQLDatabase object");
+
+    ScopedValue callback(scope, ctx->argument(0));
+    if (!callback->asFunctionObject())
+        V4THROW_SQL(SQLEXCEPTION_UNKNOWN_ERR, QQmlEngine::tr("transaction: missing callback"));
+
+    ScopedValue errorCallback(scope, ctx->argument(1));
+    ScopedValue successCallback(scope, ctx->argument(2));
+    r->asyncDatabase->transaction(callback, errorCallback, successCallback, readOnly);
+
+    return Encode::undefined();
+}
+
+static ReturnedValue qmlsqldatabase_async_transaction(CallContext *ctx)
+{
+    return qmlsqldatabase_async_transaction_shared(ctx, false);
+}
+
+static ReturnedValue qmlsqldatabase_async_read_transaction(CallContext *ctx)
+{
+    return qmlsqldatabase_async_transaction_shared(ctx, true);
+}
+
+static ReturnedValue qmlsqldatabase_async_executeSql(CallContext *ctx)
+{
+    QV4::Scope scope(ctx);
+    QV4::Scoped<QQmlSqlDatabaseWrapper> r(scope, ctx->callData->thisObject.as<QQmlSqlDatabaseWrapper>());
+    if (!r || r->type != QQmlSqlDatabaseWrapper::AsyncQuery)
+        V4THROW_REFERENCE("Not a SQLDatabase::Query object");
+
+    QV8Engine *engine = ctx->engine->v8Engine;
+
+    QQmlSqlStatement statement;
+    statement.sql = ctx->callData->argc ? ctx->callData->args[0].toQString() : QString();
+
+    if (r->readonly && !statement.sql.startsWith(QLatin1String("SELECT"),Qt::CaseInsensitive)) {
+        V4THROW_SQL(SQLEXCEPTION_SYNTAX_ERR, QQmlEngine::tr("Read-only Transaction"));
+    }
+
+    if (ctx->callData->argc > 1) {
+        ScopedValue values(scope, ctx->callData->args[1]);
+        qmlsqldatabase_bindings(engine, values, &statement.bindings);
+    }
+
+    ScopedValue callback(scope, ctx->argument(2));
+    ScopedValue errorCallback(scope, ctx->argument(3));
+    if (!r->asyncDatabase->executeSql(r->transactionId, statement, callback, errorCallback))
+        V4THROW_SQL(SQLEXCEPTION_DATABASE_ERR,QQmlEngine::tr("executeSql called outside transaction()"));
+
+    return Encode::undefined();
+}
+
 QQmlSqlDatabaseData::QQmlSqlDatabaseData(QV8Engine *engine)
+    : m_engine(engine)
 {
     ExecutionEngine *v4 = QV8Engine::getV4(engine);
     Scope scope(v4);
@@ -498,6 +1204,18 @@ QQmlSqlDatabaseData::QQmlSqlDatabaseData(QV8Engine *engine)
                                       qmlsqldatabase_rows_forwardOnly, qmlsqldatabase_rows_setForwardOnly);
         rowsProto = proto;
     }
+    {
+        Scoped<Object> proto(scope, v4->newObject());
+        proto->defineDefaultProperty(QStringLiteral("transaction"), qmlsqldatabase_async_transaction);
+        proto->defineDefaultProperty(QStringLiteral("readTransaction"), qmlsqldatabase_async_read_transaction);
+        proto->defineAccessorProperty(QStringLiteral("version"), qmlsqldatabase_version, 0);
+        asyncDatabaseProto = proto;
+    }
+    {
+        Scoped<Object> proto(scope, v4->newObject());
+        proto->defineDefaultProperty(QStringLiteral("executeSql"), qmlsqldatabase_async_executeSql);
+        asyncQueryProto = proto;
+    }
 }
 
 /*
@@ -521,6 +1239,7 @@ through the data.
 
     \list
     \li object \b{\l{#openDatabaseSync}{openDatabaseSync}}(string name, string version, string description, int estimated_size, jsobject callback(db))
+    \li object \b{\l{#openDatabase}{openDatabase}}(string name, string version, string description, int estimated_size, jsobject callback(db))
     \endlist
 
 
@@ -622,6 +1341,32 @@ It returns a results object, with the following properties:
 
 May throw exception with code property SQLException.DATABASE_ERR, SQLException.SYNTAX_ERR, or SQLException.UNKNOWN_ERR.
 
+Statements are prepared once and reused for later calls with the same \e statement.
+
+\section2 Asynchronous API
+
+A database opened with \c openDatabase() runs its transactions on a thread of its own, so that
+long running statements don't block the user interface. Transactions on the same database are
+run one after the other, in the order they were requested.
+
+\section3 db.transaction(callback(tx), errorCallback(error), successCallback())
+
+\section3 db.readTransaction(callback(tx), errorCallback(error), successCallback())
+
+These methods queue a read/write or read-only transaction, and return immediately. Once the
+transaction has started, \e callback is called with the transaction \e tx. If the transaction
+is committed, \e successCallback is called, otherwise \e errorCallback is called with an
+error object with \c code and \c message properties.
+
+\section3 tx.executeSql(statement, values, callback(tx, results), errorCallback(tx, error))
+
+This method queues a SQL \e statement to be run in the transaction, and may only be called from
+the callbacks of \e tx. When the statement has been executed, \e callback is called with the
+same results object \c executeSql() of the synchronous API returns. The JavaScript objects for
+the rows of the results are only created when they are accessed.
+
+If the statement fails, \e errorCallback is called. The transaction is rolled back unless
+\e errorCallback returns \c false.
 
 \section1 Method Documentation
 
@@ -642,6 +1387,14 @@ Opens or creates a local storage sql database by the given parameters.
 
 Returns the created database object.
 
+\target openDatabase
+\code
+object openDatabase(string name, string version, string description, int estimated_size, jsobject callback(db))
+\endcode
+
+Opens or creates a local storage sql database in the same way as \c openDatabaseSync(), and
+returns a database object using the \l{Asynchronous API}.
+
 */
 class QQuickLocalStorage : public QObject
 {
@@ -654,9 +1407,23 @@ public:
     }
 
    Q_INVOKABLE void openDatabaseSync(QQmlV4Function* args);
+   Q_INVOKABLE void openDatabase(QQmlV4Function* args);
+
+private:
+   void openDatabaseShared(QQmlV4Function *args, bool async);
 };
 
 void QQuickLocalStorage::openDatabaseSync(QQmlV4Function *args)
+{
+    openDatabaseShared(args, false);
+}
+
+void QQuickLocalStorage::openDatabase(QQmlV4Function *args)
+{
+    openDatabaseShared(args, true);
+}
+
+void QQuickLocalStorage::openDatabaseShared(QQmlV4Function *args, bool async)
 {
 #ifndef QT_NO_SETTINGS
     QV8Engine *engine = args->engine();
@@ -717,10 +1484,15 @@ void QQuickLocalStorage::openDatabaseSync(QQmlV4Function *args)
     }
 
     QV4::Scoped<QQmlSqlDatabaseWrapper> db(scope, new (ctx->engine->memoryManager) QQmlSqlDatabaseWrapper(engine));
-    QV4::ScopedObject p(scope, databaseData(engine)->databaseProto.value());
+    QV4::ScopedObject p(scope, async ? databaseData(engine)->asyncDatabaseProto.value()
+                                     : databaseData(engine)->databaseProto.value());
     db->setPrototype(p.getPointer());
     db->database = database;
     db->version = version;
+    if (async) {
+        db->type = QQmlSqlDatabaseWrapper::AsyncDatabase;
+        db->asyncDatabase = databaseData(engine)->asyncDatabase(dbid, database.databaseName());
+    }
 
     if (created && dbcreationCallback) {
         Scope scope(ctx);
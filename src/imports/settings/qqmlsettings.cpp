@@ -41,6 +41,7 @@
 
 #include "qqmlsettings_p.h"
 #include <qcoreevent.h>
+#include <qcoreapplication.h>
 #include <qsettings.h>
 #include <qpointer.h>
 #include <qdebug.h>
@@ -220,6 +221,15 @@ QT_BEGIN_NAMESPACE
     standard, INI text files are used. See \l QSettings documentation for
     more details.
 
+    \section1 Writing Settings
+
+    Changes are not written as they happen. They are collected in memory and
+    written together when the \l writeDelay has passed since the first of
+    them, so that a property changing continuously, for example one bound to a
+    slider, does not rewrite the settings storage for every change. Pending
+    changes are also written when the Settings object is destroyed, when the
+    application is about to quit and when \l flush() is called.
+
     \sa QSettings
 */
 
@@ -241,11 +251,13 @@ public:
 
     void load();
     void store();
+    void cache(const QMetaProperty &property);
 
     void _q_propertyChanged();
 
     QQmlSettings *q_ptr;
     int timerId;
+    int writeDelay;
     bool initialized;
     QString category;
     mutable QPointer<QSettings> settings;
@@ -253,7 +265,7 @@ public:
 };
 
 QQmlSettingsPrivate::QQmlSettingsPrivate()
-    : q_ptr(0), timerId(0), initialized(false)
+    : q_ptr(0), timerId(0), writeDelay(settingsWriteDelay), initialized(false)
 {
 }
 
@@ -308,7 +320,7 @@ void QQmlSettingsPrivate::load()
         // ensure that a non-existent setting gets written
         // even if the property wouldn't change later
         if (!instance()->contains(property.name()))
-            _q_propertyChanged();
+            cache(property);
 
         // setup change notifications on first load
         if (!initialized && property.hasNotifySignal()) {
@@ -320,32 +332,51 @@ void QQmlSettingsPrivate::load()
 
 void QQmlSettingsPrivate::store()
 {
+    QSettings *settings = instance();
+    bool changed = false;
     QHash<const char *, QVariant>::iterator it = changedProperties.begin();
     while (it != changedProperties.end()) {
-        instance()->setValue(it.key(), it.value());
+        // a value that was changed back needs no write
+        if (!settings->contains(it.key()) || settings->value(it.key()) != it.value()) {
+            settings->setValue(it.key(), it.value());
+            changed = true;
 #ifdef SETTINGS_DEBUG
-        qDebug() << "QQmlSettings: store" << it.key() << ":" << it.value();
+            qDebug() << "QQmlSettings: store" << it.key() << ":" << it.value();
 #endif
+        }
         it = changedProperties.erase(it);
     }
+
+    // write all the changes to the storage at once
+    if (changed)
+        settings->sync();
+}
+
+void QQmlSettingsPrivate::cache(const QMetaProperty &property)
+{
+    Q_Q(QQmlSettings);
+    changedProperties.insert(property.name(), property.read(q));
+#ifdef SETTINGS_DEBUG
+    qDebug() << "QQmlSettings: cache" << property.name() << ":" << property.read(q);
+#endif
+    // the timer is not restarted by later changes, so that continuous
+    // changes are still written once every writeDelay
+    if (timerId == 0)
+        timerId = q->startTimer(writeDelay);
 }
 
 void QQmlSettingsPrivate::_q_propertyChanged()
 {
     Q_Q(QQmlSettings);
+    const int signalIndex = q->senderSignalIndex();
     const QMetaObject *mo = q->metaObject();
     const int offset = mo->propertyOffset();
     const int count = mo->propertyCount();
     for (int i = offset; i < count; ++i) {
         const QMetaProperty &property = mo->property(i);
-        changedProperties.insert(property.name(), property.read(q));
-#ifdef SETTINGS_DEBUG
-        qDebug() << "QQmlSettings: cache" << property.name() << ":" << property.read(q);
-#endif
+        if (signalIndex == -1 || property.notifySignalIndex() == signalIndex)
+            cache(property);
     }
-    if (timerId != 0)
-        q->killTimer(timerId);
-    timerId = q->startTimer(settingsWriteDelay);
 }
 
 QQmlSettings::QQmlSettings(QObject *parent)
@@ -353,6 +384,8 @@ QQmlSettings::QQmlSettings(QObject *parent)
 {
     Q_D(QQmlSettings);
     d->q_ptr = this;
+    if (QCoreApplication *app = QCoreApplication::instance())
+        connect(app, SIGNAL(aboutToQuit()), this, SLOT(flush()));
 }
 
 QQmlSettings::~QQmlSettings()
@@ -385,6 +418,53 @@ void QQmlSettings::setCategory(const QString &category)
     }
 }
 
+/*!
+    \qmlproperty int Settings::writeDelay
+
+    This property holds the time in milliseconds that changed settings are
+    collected before they are written. The default value is 500.
+
+    Setting it to 0 writes the changes made while handling an event together
+    once control returns to the event loop.
+
+    \sa flush()
+*/
+int QQmlSettings::writeDelay() const
+{
+    Q_D(const QQmlSettings);
+    return d->writeDelay;
+}
+
+void QQmlSettings::setWriteDelay(int delay)
+{
+    Q_D(QQmlSettings);
+    delay = qMax(0, delay);
+    if (d->writeDelay != delay) {
+        d->writeDelay = delay;
+        if (d->timerId != 0) {
+            killTimer(d->timerId);
+            d->timerId = startTimer(delay);
+        }
+    }
+}
+
+/*!
+    \qmlmethod Settings::flush()
+
+    Writes the pending changes to the persistent settings right away, instead
+    of waiting for the \l writeDelay to pass.
+*/
+void QQmlSettings::flush()
+{
+    Q_D(QQmlSettings);
+    if (d->timerId != 0) {
+        killTimer(d->timerId);
+        d->timerId = 0;
+    }
+    if (d->initialized && !d->changedProperties.isEmpty())
+        d->store();
+}
+
 void QQmlSettings::classBegin()
 {
 }
@@ -398,14 +478,8 @@ void QQmlSettings::componentComplete()
 void QQmlSettings::timerEvent(QTimerEvent *event)
 {
     Q_D(QQmlSettings);
-    if (event->timerId() == d->timerId) {
-        if (d->changedProperties.isEmpty()) {
-            killTimer(d->timerId);
-            d->timerId = 0;
-        } else {
-            d->store();
-        }
-    }
+    if (event->timerId() == d->timerId)
+        flush();
     QObject::timerEvent(event);
 }
 
@@ -56,6 +56,7 @@ class QQmlSettings : public QObject, public QQmlParserStatus
     Q_OBJECT
     Q_INTERFACES(QQmlParserStatus)
     Q_PROPERTY(QString category READ category WRITE setCategory FINAL)
+    Q_PROPERTY(int writeDelay READ writeDelay WRITE setWriteDelay FINAL)
 
 public:
     explicit QQmlSettings(QObject *parent = 0);
@@ -64,6 +65,12 @@ public:
     QString category() const;
     void setCategory(const QString &category);
 
+    int writeDelay() const;
+    void setWriteDelay(int delay);
+
+public Q_SLOTS:
+    void flush();
+
 protected:
     void timerEvent(QTimerEvent *event);
 
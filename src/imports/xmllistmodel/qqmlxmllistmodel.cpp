@@ -60,6 +60,10 @@
 #include <QNetworkReply>
 #include <QTimer>
 #include <QMutex>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QXmlStreamReader>
+#include <qnumeric.h>
 
 #include <private/qabstractitemmodel_p.h>
 
@@ -73,6 +77,9 @@ typedef QPair<int, int> QQuickXmlListRange;
 
 #define XMLLISTMODEL_CLEAR_ID 0
 
+// The number of rows parsed by a streaming query before they are published to the model.
+#define XMLLISTMODEL_STREAM_BATCH_SIZE 256
+
 /*!
     \qmlmodule QtQuick.XmlListModel 2
     \title Qt Quick XmlListModel QML Types
@@ -156,6 +163,22 @@ typedef QPair<int, int> QQuickXmlListRange;
     \sa XmlListModel
 */
 
+/*
+    A role query simple enough to be answered while reading the document with QXmlStreamReader,
+    i.e. a relative path of element names optionally followed by an attribute, returning the first
+    match as a string() or number().
+*/
+struct XmlStreamRole
+{
+    XmlStreamRole() : isValid(false), isNumber(false), isKey(false) {}
+
+    QStringList steps;
+    QString attribute;
+    bool isValid;
+    bool isNumber;
+    bool isKey;
+};
+
 struct XmlQueryJob
 {
     int queryId;
@@ -167,8 +190,124 @@ struct XmlQueryJob
     QStringList keyRoleQueries;
     QStringList keyRoleResultsCache;
     QString prefix;
+
+    bool streamable;
+    QStringList streamSteps;
+    QList<XmlStreamRole> streamRoles;
 };
 
+static bool qt_isXmlStreamName(const QString &name)
+{
+    if (name.isEmpty())
+        return false;
+    for (int i = 0; i < name.length(); ++i) {
+        const QChar c = name.at(i);
+        if (c.isLetter() || c == QLatin1Char('_'))
+            continue;
+        if (i > 0 && (c.isDigit() || c == QLatin1Char('-') || c == QLatin1Char('.')))
+            continue;
+        return false;
+    }
+    return true;
+}
+
+static bool qt_parseXmlStreamSteps(const QString &path, QStringList *steps)
+{
+    *steps = path.split(QLatin1Char('/'));
+    for (int i = 0; i < steps->count(); ++i) {
+        if (!qt_isXmlStreamName(steps->at(i)))
+            return false;
+    }
+    return true;
+}
+
+/*
+    Splits a role query of the form "a/b/string()", "a/@attr/string()" or "@attr/number()"
+    into its steps.  Returns false if the query needs the full XPath engine.
+*/
+static bool qt_parseXmlStreamRole(const QString &query, XmlStreamRole *role)
+{
+    QString path;
+    if (query.endsWith(QLatin1String("string()"))) {
+        path = query.left(query.length() - 8);
+    } else if (query.endsWith(QLatin1String("number()"))) {
+        path = query.left(query.length() - 8);
+        role->isNumber = true;
+    } else {
+        return false;
+    }
+
+    if (!path.isEmpty()) {
+        if (!path.endsWith(QLatin1Char('/')))
+            return false;
+        path.chop(1);
+
+        const int attribute = path.lastIndexOf(QLatin1Char('@'));
+        if (attribute != -1) {
+            if (attribute != 0 && path.at(attribute - 1) != QLatin1Char('/'))
+                return false;
+            role->attribute = path.mid(attribute + 1);
+            if (!qt_isXmlStreamName(role->attribute))
+                return false;
+            path = path.left(qMax(0, attribute - 1));
+        }
+
+        if (!path.isEmpty() && !qt_parseXmlStreamSteps(path, &role->steps))
+            return false;
+    }
+
+    role->isValid = true;
+    return true;
+}
+
+class QQuickXmlRoleQueryTask : public QRunnable
+{
+public:
+    QQuickXmlRoleQueryTask(const QByteArray &data, const QString &query, int size)
+        : m_data(data), m_query(query), m_size(size), m_valid(true)
+    {
+        setAutoDelete(false);
+    }
+
+    void run();
+
+    bool isValid() const { return m_valid; }
+    const QList<QVariant> &results() const { return m_results; }
+
+private:
+    QByteArray m_data;
+    QString m_query;
+    int m_size;
+    bool m_valid;
+    QList<QVariant> m_results;
+};
+
+void QQuickXmlRoleQueryTask::run()
+{
+    if (!m_query.isEmpty()) {
+        QBuffer b(&m_data);
+        b.open(QIODevice::ReadOnly);
+
+        QXmlQuery subquery;
+        subquery.bindVariable(QLatin1String("inputDocument"), &b);
+        subquery.setQuery(m_query);
+        if (subquery.isValid()) {
+            QXmlResultItems resultItems;
+            subquery.evaluateTo(&resultItems);
+            QXmlItem item(resultItems.next());
+            while (!item.isNull()) {
+                m_results << item.toAtomicValue(); //### we used to trim strings
+                item = resultItems.next();
+            }
+        } else {
+            m_valid = false;
+        }
+    }
+    //### should warn here if things have gone wrong.
+    while (m_results.count() < m_size)
+        m_results << QVariant();
+}
+
 
 class QQuickXmlQueryEngine;
 class QQuickXmlQueryThreadObject : public QObject
@@ -201,6 +340,7 @@ public:
 
 signals:
     void queryCompleted(const QQuickXmlQueryResult &);
+    void rowsParsed(const QQuickXmlQueryResult &);
     void error(void*, const QString&);
 
 protected:
@@ -208,12 +348,17 @@ protected:
 
 private:
     void processQuery(XmlQueryJob *job);
+    bool doStreamQueryJob(XmlQueryJob *job, QQuickXmlQueryResult *currentResult);
+    bool readStreamItem(QXmlStreamReader *reader, const XmlQueryJob &job, QQuickXmlQueryResult *currentResult, QStringList *keyRoleResults) const;
     void doQueryJob(XmlQueryJob *job, QQuickXmlQueryResult *currentResult);
     void doSubQueryJob(XmlQueryJob *job, QQuickXmlQueryResult *currentResult);
     void getValuesOfKeyRoles(const XmlQueryJob& currentJob, QStringList *values, QXmlQuery *query) const;
+    void compareKeyRoleResults(const XmlQueryJob &currentJob, const QStringList &keyRoleResults, QQuickXmlQueryResult *currentResult) const;
     void addIndexToRangeList(QList<QQuickXmlListRange> *ranges, int index) const;
+    bool isCancelled(int queryId);
 
     QMutex m_mutex;
+    QThreadPool m_rolePool;
     QQuickXmlQueryThreadObject *m_threadObject;
     QList<XmlQueryJob> m_jobs;
     QSet<int> m_cancelledJobs;
@@ -287,15 +432,28 @@ int QQuickXmlQueryEngine::doQuery(QString query, QString namespaces, QByteArray
     job.namespaces = namespaces;
     job.keyRoleResultsCache = keyRoleResultsCache;
 
+    // Queries which are plain element paths can be answered in a single pass over the document
+    // without building the XPath data model.
+    job.streamable = namespaces.isEmpty()
+            && query.startsWith(QLatin1Char('/'))
+            && qt_parseXmlStreamSteps(query.mid(1), &job.streamSteps);
+
     for (int i=0; i<roleObjects->count(); i++) {
+        XmlStreamRole streamRole;
         if (!roleObjects->at(i)->isValid()) {
             job.roleQueries << QString();
+            job.streamRoles << streamRole;
             continue;
         }
         job.roleQueries << roleObjects->at(i)->query();
         job.roleQueryErrorId << static_cast<void*>(roleObjects->at(i));
         if (roleObjects->at(i)->isKey())
             job.keyRoleQueries << job.roleQueries.last();
+
+        streamRole.isKey = roleObjects->at(i)->isKey();
+        if (job.streamable && !qt_parseXmlStreamRole(job.roleQueries.last(), &streamRole))
+            job.streamable = false;
+        job.streamRoles << streamRole;
     }
 
     {
@@ -366,8 +524,10 @@ void QQuickXmlQueryEngine::processQuery(XmlQueryJob *job)
 {
     QQuickXmlQueryResult result;
     result.queryId = job->queryId;
-    doQueryJob(job, &result);
-    doSubQueryJob(job, &result);
+    if (!doStreamQueryJob(job, &result)) {
+        doQueryJob(job, &result);
+        doSubQueryJob(job, &result);
+    }
 
     {
         QMutexLocker ml(&m_mutex);
@@ -379,6 +539,182 @@ void QQuickXmlQueryEngine::processQuery(XmlQueryJob *job)
     }
 }
 
+bool QQuickXmlQueryEngine::isCancelled(int queryId)
+{
+    QMutexLocker ml(&m_mutex);
+    return m_cancelledJobs.contains(queryId);
+}
+
+/*
+    Evaluates a streamable job by reading the document once with QXmlStreamReader.
+
+    If no key roles are used, rows are published in batches with rowsParsed() as they are read
+    and the final result only adds what remains.  Returns false if the job isn't streamable or
+    the document couldn't be read, in which case the job is evaluated with XPath instead.
+*/
+bool QQuickXmlQueryEngine::doStreamQueryJob(XmlQueryJob *currentJob, QQuickXmlQueryResult *currentResult)
+{
+    Q_ASSERT(currentJob->queryId != -1);
+
+    if (!currentJob->streamable)
+        return false;
+
+    const int roleCount = currentJob->streamRoles.count();
+    const bool publishRows = currentJob->keyRoleQueries.isEmpty();
+
+    QQuickXmlQueryResult result;
+    result.queryId = currentJob->queryId;
+    result.size = 0;
+    for (int i = 0; i < roleCount; ++i)
+        result.data << QList<QVariant>();
+
+    QQuickXmlQueryResult batch = result;
+    QStringList keyRoleResults;
+
+    QXmlStreamReader reader(currentJob->data);
+    const QStringList &steps = currentJob->streamSteps;
+    int depth = 0;      // the depth of the current element
+    int matched = 0;    // the number of ancestors matching the query's steps
+
+    while (!reader.atEnd()) {
+        switch (reader.readNext()) {
+        case QXmlStreamReader::StartElement:
+            if (matched == depth && depth < steps.count()
+                    && reader.namespaceUri().isEmpty()
+                    && reader.name() == steps.at(depth)) {
+                ++matched;
+            }
+            ++depth;
+
+            if (matched == steps.count() && depth == matched) {
+                if (!readStreamItem(&reader, *currentJob, &result, &keyRoleResults))
+                    return false;
+                --depth;
+                --matched;
+
+                if (publishRows) {
+                    for (int i = 0; i < roleCount; ++i)
+                        batch.data[i] << result.data.at(i).last();
+                    if (++batch.size == XMLLISTMODEL_STREAM_BATCH_SIZE) {
+                        if (isCancelled(currentJob->queryId))
+                            return true;
+                        emit rowsParsed(batch);
+                        for (int i = 0; i < roleCount; ++i)
+                            batch.data[i].clear();
+                        batch.size = 0;
+                    }
+                }
+            }
+            break;
+        case QXmlStreamReader::EndElement:
+            if (matched == depth)
+                --matched;
+            --depth;
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (reader.hasError())
+        return false;
+
+    *currentResult = result;
+    compareKeyRoleResults(*currentJob, keyRoleResults, currentResult);
+    return true;
+}
+
+/*
+    Reads the item element the reader is positioned at, appending the value of each role to
+    \a currentResult.  The first matching element or attribute gives the value of a role.
+*/
+bool QQuickXmlQueryEngine::readStreamItem(QXmlStreamReader *reader, const XmlQueryJob &job, QQuickXmlQueryResult *currentResult, QStringList *keyRoleResults) const
+{
+    enum { Pending, Reading, Done };
+
+    const QList<XmlStreamRole> &roles = job.streamRoles;
+    const int roleCount = roles.count();
+    QVector<QString> values(roleCount);
+    QVector<int> states(roleCount, Pending);
+    QVector<int> depths(roleCount, 0);
+
+    QStringList path;
+    int depth = 0;
+    bool atStart = true;
+
+    while (depth >= 0) {
+        if (atStart) {
+            for (int i = 0; i < roleCount; ++i) {
+                const XmlStreamRole &role = roles.at(i);
+                if (!role.isValid || states.at(i) != Pending || role.steps != path)
+                    continue;
+                if (role.attribute.isEmpty()) {
+                    states[i] = Reading;
+                    depths[i] = depth;
+                } else if (reader->attributes().hasAttribute(QString(), role.attribute)) {
+                    values[i] = reader->attributes().value(QString(), role.attribute).toString();
+                    states[i] = Done;
+                }
+            }
+            atStart = false;
+        }
+
+        switch (reader->readNext()) {
+        case QXmlStreamReader::StartElement:
+            // Elements in a namespace never match an unprefixed step.
+            path << (reader->namespaceUri().isEmpty() ? reader->name().toString() : QString());
+            ++depth;
+            atStart = true;
+            break;
+        case QXmlStreamReader::EndElement:
+            for (int i = 0; i < roleCount; ++i) {
+                if (states.at(i) == Reading && depths.at(i) == depth)
+                    states[i] = Done;
+            }
+            if (depth > 0)
+                path.removeLast();
+            --depth;
+            break;
+        case QXmlStreamReader::Characters:
+            for (int i = 0; i < roleCount; ++i) {
+                if (states.at(i) == Reading)
+                    values[i] += reader->text();
+            }
+            break;
+        case QXmlStreamReader::Invalid:
+            return false;
+        default:
+            break;
+        }
+    }
+
+    QString key;
+    for (int i = 0; i < roleCount; ++i) {
+        const XmlStreamRole &role = roles.at(i);
+        if (!role.isValid) {
+            currentResult->data[i] << QVariant();
+            continue;
+        }
+
+        // As with the XPath queries, a missing value is an empty string even for number().
+        const QString &value = values.at(i);
+        if (role.isKey)
+            key += value;
+        if (role.isNumber && states.at(i) != Pending) {
+            bool ok;
+            const double number = value.trimmed().toDouble(&ok);
+            currentResult->data[i] << QVariant(ok ? number : qQNaN());
+        } else {
+            currentResult->data[i] << QVariant(value);
+        }
+    }
+    if (!job.keyRoleQueries.isEmpty())
+        keyRoleResults->append(key);
+
+    ++currentResult->size;
+    return true;
+}
+
 void QQuickXmlQueryEngine::doQueryJob(XmlQueryJob *currentJob, QQuickXmlQueryResult *currentResult)
 {
     Q_ASSERT(currentJob->queryId != -1);
@@ -438,6 +774,31 @@ void QQuickXmlQueryEngine::getValuesOfKeyRoles(const XmlQueryJob& currentJob, QS
     }
 }
 
+// See if any values of key roles have been inserted or removed.
+void QQuickXmlQueryEngine::compareKeyRoleResults(const XmlQueryJob &currentJob, const QStringList &keyRoleResults, QQuickXmlQueryResult *currentResult) const
+{
+    if (currentJob.keyRoleResultsCache.isEmpty()) {
+        currentResult->inserted << qMakePair(0, currentResult->size);
+    } else {
+        if (keyRoleResults != currentJob.keyRoleResultsCache) {
+            QStringList temp;
+            for (int i=0; i<currentJob.keyRoleResultsCache.count(); i++) {
+                if (!keyRoleResults.contains(currentJob.keyRoleResultsCache[i]))
+                    addIndexToRangeList(&currentResult->removed, i);
+                else
+                    temp << currentJob.keyRoleResultsCache[i];
+            }
+            for (int i=0; i<keyRoleResults.count(); i++) {
+                if (temp.count() == i || keyRoleResults[i] != temp[i]) {
+                    temp.insert(i, keyRoleResults[i]);
+                    addIndexToRangeList(&currentResult->inserted, i);
+                }
+            }
+        }
+    }
+    currentResult->keyRoleResultsCache = keyRoleResults;
+}
+
 void QQuickXmlQueryEngine::addIndexToRangeList(QList<QQuickXmlListRange> *ranges, int index) const {
     if (ranges->isEmpty())
         ranges->append(qMakePair(index, 1));
@@ -451,6 +812,18 @@ void QQuickXmlQueryEngine::doSubQueryJob(XmlQueryJob *currentJob, QQuickXmlQuery
 {
     Q_ASSERT(currentJob->queryId != -1);
 
+    // Evaluate the role queries in parallel, each on its own copy of the document, while the key
+    // role values are found on this thread.
+    const QStringList &queries = currentJob->roleQueries;
+    QList<QQuickXmlRoleQueryTask *> tasks;
+    for (int i = 0; i < queries.size(); ++i) {
+        QString query;
+        if (!queries[i].isEmpty())
+            query = currentJob->prefix + QLatin1String("(let $v := string(") + queries[i] + QLatin1String(") return if ($v) then ") + queries[i] + QLatin1String(" else \"\")");
+        tasks << new QQuickXmlRoleQueryTask(currentJob->data, query, currentResult->size);
+        m_rolePool.start(tasks.last());
+    }
+
     QBuffer b(&currentJob->data);
     b.open(QIODevice::ReadOnly);
 
@@ -459,55 +832,16 @@ void QQuickXmlQueryEngine::doSubQueryJob(XmlQueryJob *currentJob, QQuickXmlQuery
 
     QStringList keyRoleResults;
     getValuesOfKeyRoles(*currentJob, &keyRoleResults, &subquery);
+    compareKeyRoleResults(*currentJob, keyRoleResults, currentResult);
 
-    // See if any values of key roles have been inserted or removed.
-
-    if (currentJob->keyRoleResultsCache.isEmpty()) {
-        currentResult->inserted << qMakePair(0, currentResult->size);
-    } else {
-        if (keyRoleResults != currentJob->keyRoleResultsCache) {
-            QStringList temp;
-            for (int i=0; i<currentJob->keyRoleResultsCache.count(); i++) {
-                if (!keyRoleResults.contains(currentJob->keyRoleResultsCache[i]))
-                    addIndexToRangeList(&currentResult->removed, i);
-                else
-                    temp << currentJob->keyRoleResultsCache[i];
-            }
-            for (int i=0; i<keyRoleResults.count(); i++) {
-                if (temp.count() == i || keyRoleResults[i] != temp[i]) {
-                    temp.insert(i, keyRoleResults[i]);
-                    addIndexToRangeList(&currentResult->inserted, i);
-                }
-            }
-        }
-    }
-    currentResult->keyRoleResultsCache = keyRoleResults;
+    m_rolePool.waitForDone();
 
-    // Get the new values for each role.
-    //### we might be able to condense even further (query for everything in one go)
-    const QStringList &queries = currentJob->roleQueries;
-    for (int i = 0; i < queries.size(); ++i) {
-        QList<QVariant> resultList;
-        if (!queries[i].isEmpty()) {
-            subquery.setQuery(currentJob->prefix + QLatin1String("(let $v := string(") + queries[i] + QLatin1String(") return if ($v) then ") + queries[i] + QLatin1String(" else \"\")"));
-            if (subquery.isValid()) {
-                QXmlResultItems resultItems;
-                subquery.evaluateTo(&resultItems);
-                QXmlItem item(resultItems.next());
-                while (!item.isNull()) {
-                    resultList << item.toAtomicValue(); //### we used to trim strings
-                    item = resultItems.next();
-                }
-            } else {
-                emit error(currentJob->roleQueryErrorId.at(i), queries[i]);
-            }
-        }
-        //### should warn here if things have gone wrong.
-        while (resultList.count() < currentResult->size)
-            resultList << QVariant();
-        currentResult->data << resultList;
-        b.seek(0);
+    for (int i = 0; i < tasks.size(); ++i) {
+        if (!tasks.at(i)->isValid())
+            emit error(currentJob->roleQueryErrorId.at(i), queries[i]);
+        currentResult->data << tasks.at(i)->results();
     }
+    qDeleteAll(tasks);
 
     //this method is much slower, but works better for incremental loading
     /*for (int j = 0; j < m_size; ++j) {
@@ -545,7 +879,7 @@ public:
     QQuickXmlListModelPrivate()
         : isComponentComplete(true), size(0), highestRole(Qt::UserRole)
         , reply(0), status(QQuickXmlListModel::Null), progress(0.0)
-        , queryId(-1), roleObjects(), redirectCount(0) {}
+        , queryId(-1), streamedCount(-1), roleObjects(), redirectCount(0) {}
 
 
     void notifyQueryStarted(bool remoteSource) {
@@ -581,6 +915,7 @@ public:
     QString errorString;
     qreal progress;
     int queryId;
+    int streamedCount;
     QStringList keyRoleResultsCache;
     QList<QQuickXmlListModelRole *> roleObjects;
 
@@ -694,6 +1029,14 @@ void QQuickXmlListModelPrivate::clear_role(QQmlListProperty<QQuickXmlListModelRo
     Note this means when XmlListModel is used for a view, the view is not
     populated until the model is loaded.
 
+    If no namespaces are declared, the \l query is a plain path of element
+    names such as "/rss/channel/item" and every XmlRole query is a relative
+    path of element names, optionally ending in an attribute, followed by
+    \c string() or \c number(), the document is read in a single pass
+    instead of being evaluated with XPath. In this case, unless key roles
+    are used, rows are added to the model in batches as they are read.
+    Otherwise the role queries are evaluated in parallel.
+
 
     \section2 Using key XML roles
 
@@ -1002,6 +1345,8 @@ void QQuickXmlListModel::classBegin()
     QQuickXmlQueryEngine *queryEngine = QQuickXmlQueryEngine::instance(qmlEngine(this));
     connect(queryEngine, SIGNAL(queryCompleted(QQuickXmlQueryResult)),
             SLOT(queryCompleted(QQuickXmlQueryResult)));
+    connect(queryEngine, SIGNAL(rowsParsed(QQuickXmlQueryResult)),
+            SLOT(queryRowsParsed(QQuickXmlQueryResult)));
     connect(queryEngine, SIGNAL(error(void*,QString)),
             SLOT(queryError(void*,QString)));
 }
@@ -1035,6 +1380,7 @@ void QQuickXmlListModel::reload()
 
     QQuickXmlQueryEngine::instance(qmlEngine(this))->abort(d->queryId);
     d->queryId = -1;
+    d->streamedCount = -1;
 
     if (d->size < 0)
         d->size = 0;
@@ -1096,6 +1442,7 @@ void QQuickXmlListModel::requestFinished()
 
         d->status = Error;
         d->queryId = -1;
+        d->streamedCount = -1;
         emit statusChanged(d->status);
     } else {
         QByteArray data = d->reply->readAll();
@@ -1145,6 +1492,38 @@ void QQuickXmlListModel::queryError(void* object, const QString& error)
     qmlInfo(this) << QQuickXmlListModel::tr("invalid query: \"%1\"").arg(error);
 }
 
+/*
+    Appends rows a streaming query has read so far, replacing the previous contents of the model
+    when the first rows arrive.
+*/
+void QQuickXmlListModel::queryRowsParsed(const QQuickXmlQueryResult &result)
+{
+    Q_D(QQuickXmlListModel);
+    if (result.queryId != d->queryId || result.size == 0)
+        return;
+
+    if (d->streamedCount < 0) {
+        if (d->size > 0) {
+            beginRemoveRows(QModelIndex(), 0, d->size - 1);
+            d->data.clear();
+            d->size = 0;
+            endRemoveRows();
+        }
+        d->streamedCount = 0;
+    }
+
+    beginInsertRows(QModelIndex(), d->size, d->size + result.size - 1);
+    for (int i = 0; i < result.data.count(); ++i) {
+        if (d->data.count() == i)
+            d->data.append(QList<QVariant>());
+        d->data[i] += result.data.at(i);
+    }
+    d->size += result.size;
+    d->streamedCount = d->size;
+    endInsertRows();
+    emit countChanged();
+}
+
 void QQuickXmlListModel::queryCompleted(const QQuickXmlQueryResult &result)
 {
     Q_D(QQuickXmlListModel);
@@ -1153,6 +1532,7 @@ void QQuickXmlListModel::queryCompleted(const QQuickXmlQueryResult &result)
 
     int origCount = d->size;
     bool sizeChanged = result.size != d->size;
+    const int streamedCount = d->streamedCount;
 
     d->size = result.size;
     d->data = result.data;
@@ -1163,6 +1543,7 @@ void QQuickXmlListModel::queryCompleted(const QQuickXmlQueryResult &result)
         d->status = Ready;
     d->errorString.clear();
     d->queryId = -1;
+    d->streamedCount = -1;
 
     bool hasKeys = false;
     for (int i=0; i<d->roleObjects.count(); i++) {
@@ -1171,7 +1552,16 @@ void QQuickXmlListModel::queryCompleted(const QQuickXmlQueryResult &result)
             break;
         }
     }
-    if (!hasKeys) {
+    if (streamedCount >= 0) {
+        // The rows read so far are already in the model; only account for the difference.
+        if (d->size > streamedCount) {
+            beginInsertRows(QModelIndex(), streamedCount, d->size - 1);
+            endInsertRows();
+        } else if (d->size < streamedCount) {
+            beginRemoveRows(QModelIndex(), d->size, streamedCount - 1);
+            endRemoveRows();
+        }
+    } else if (!hasKeys) {
         if (origCount > 0) {
             beginRemoveRows(QModelIndex(), 0, origCount - 1);
             endRemoveRows();
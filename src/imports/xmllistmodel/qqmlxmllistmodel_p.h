@@ -139,6 +139,7 @@ private Q_SLOTS:
     void requestProgress(qint64,qint64);
     void dataCleared();
     void queryCompleted(const QQuickXmlQueryResult &);
+    void queryRowsParsed(const QQuickXmlQueryResult &);
     void queryError(void* object, const QString& error);
 
 private:
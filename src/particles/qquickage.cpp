@@ -84,6 +84,7 @@ QT_BEGIN_NAMESPACE
 QQuickAgeAffector::QQuickAgeAffector(QQuickItem *parent) :
     QQuickParticleAffector(parent), m_lifeLeft(0), m_advancePosition(true)
 {
+    m_threadSafeBatch = true;
 }
 
 
@@ -114,4 +115,12 @@ bool QQuickAgeAffector::affectParticle(QQuickParticleData *d, qreal dt)
     }
     return false;
 }
+
+void QQuickAgeAffector::affectBatch(QQuickParticleData *const *particles, bool *affected, int count, qreal dt)
+{
+    for (int i = 0; i < count; i++)
+        if (QQuickAgeAffector::affectParticle(particles[i], dt))
+            affected[i] = true;
+}
+
 QT_END_NAMESPACE
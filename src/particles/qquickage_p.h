@@ -66,6 +66,7 @@ public:
 
 protected:
     virtual bool affectParticle(QQuickParticleData *d, qreal dt);
+    virtual void affectBatch(QQuickParticleData *const *particles, bool *affected, int count, qreal dt);
 Q_SIGNALS:
     void lifeLeftChanged(int arg);
     void advancePositionChanged(bool arg);
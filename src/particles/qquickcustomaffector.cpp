@@ -45,6 +45,7 @@
 #include <private/qqmlglobal_p.h>
 #include <QQmlEngine>
 #include <QDebug>
+#include <QScopedPointer>
 QT_BEGIN_NAMESPACE
 
 //TODO: Move docs (and inheritence) to real base when docs can propagate. Currently this pretends to be the base class!
@@ -61,6 +62,17 @@ QT_BEGIN_NAMESPACE
     high-volume particle systems.
 */
 
+/*!
+    \qmlsignal QtQuick.Particles::Affector::onAffectParticleColumns(ParticleColumns columns, real dt)
+
+    This handler is called when particles are selected to be affected, like onAffectParticles.
+    Instead of an array of particle objects, columns holds one Float32Array per particle
+    attribute, which can be modified in place. This avoids creating an object for every
+    affected particle, which makes it the better choice for larger numbers of particles.
+
+    dt is the time since the last time it was affected.
+*/
+
 /*!
     \qmlproperty StochasticDirection QtQuick.Particles::Affector::position
 
@@ -106,6 +118,11 @@ bool QQuickCustomAffector::isAffectConnected()
     IS_SIGNAL_CONNECTED(this, QQuickCustomAffector, affectParticles, (QQmlV4Handle,qreal));
 }
 
+bool QQuickCustomAffector::isAffectColumnsConnected()
+{
+    IS_SIGNAL_CONNECTED(this, QQuickCustomAffector, affectParticleColumns, (QQmlV4Handle,qreal));
+}
+
 void QQuickCustomAffector::affectSystem(qreal dt)
 {
     //Acts a bit differently, just emits affected for everyone it might affect, when the only thing is connecting to affected(x,y)
@@ -113,7 +130,7 @@ void QQuickCustomAffector::affectSystem(qreal dt)
         && m_velocity == &m_nullVector
         && m_position == &m_nullVector
         && isAffectedConnected());
-    if (!isAffectConnected() && !justAffected) {
+    if (!isAffectConnected() && !isAffectColumnsConnected() && !justAffected) {
         QQuickParticleAffector::affectSystem(dt);
         return;
     }
@@ -147,14 +164,21 @@ void QQuickCustomAffector::affectSystem(qreal dt)
     QV4::ExecutionEngine *v4 = QV8Engine::getV4(qmlEngine->handle());
 
     QV4::Scope scope(v4);
-    QV4::Scoped<QV4::ArrayObject> array(scope, v4->newArrayObject(toAffect.size()));
-    QV4::ScopedValue v(scope);
-    for (int i=0; i<toAffect.size(); i++)
-        array->putIndexed(i, (v = toAffect[i]->v4Value()));
+    QV4::ScopedValue array(scope, QV4::Primitive::undefinedValue());
+    if (isAffectConnected()) {
+        QV4::Scoped<QV4::ArrayObject> particles(scope, v4->newArrayObject(toAffect.size()));
+        QV4::ScopedValue v(scope);
+        for (int i=0; i<toAffect.size(); i++)
+            particles->putIndexed(i, (v = toAffect[i]->v4Value()));
+        array = particles.asReturnedValue();
+    }
+    QScopedPointer<QQuickV4ParticleColumns> columns;
+    if (isAffectColumnsConnected())
+        columns.reset(new QQuickV4ParticleColumns(qmlEngine->handle(), toAffect));
 
     if (dt >= simulationCutoff || dt <= simulationDelta) {
         affectProperties(toAffect, dt);
-        emit affectParticles(QQmlV4Handle(array), dt);
+        emitAffect(toAffect, array, columns.data(), dt);
     } else {
         int realTime = m_system->timeInt;
         m_system->timeInt -= dt * 1000.0;
@@ -162,12 +186,12 @@ void QQuickCustomAffector::affectSystem(qreal dt)
             m_system->timeInt += simulationDelta * 1000.0;
             dt -= simulationDelta;
             affectProperties(toAffect, simulationDelta);
-            emit affectParticles(QQmlV4Handle(array), simulationDelta);
+            emitAffect(toAffect, array, columns.data(), simulationDelta);
         }
         m_system->timeInt = realTime;
         if (dt > 0.0) {
             affectProperties(toAffect, dt);
-            emit affectParticles(QQmlV4Handle(array), dt);
+            emitAffect(toAffect, array, columns.data(), dt);
         }
     }
 
@@ -176,6 +200,22 @@ void QQuickCustomAffector::affectSystem(qreal dt)
             postAffect(d);
 }
 
+void QQuickCustomAffector::emitAffect(const QList<QQuickParticleData*> &particles, QV4::ValueRef array,
+                                      QQuickV4ParticleColumns *columns, qreal dt)
+{
+    if (isAffectConnected())
+        emit affectParticles(QQmlV4Handle(array), dt);
+    if (columns) {
+        columns->load();
+        emit affectParticleColumns(columns->v4Value(), dt);
+        QVector<bool> changed;
+        columns->store(&changed);
+        for (int i = 0; i < particles.size(); i++)
+            if (changed.at(i))
+                particles.at(i)->update = 1.0;
+    }
+}
+
 bool QQuickCustomAffector::affectParticle(QQuickParticleData *d, qreal dt)
 {
     //This does the property based affecting, called by superclass if signal isn't hooked up.
@@ -47,6 +47,7 @@
 #include "qquickparticleextruder_p.h"
 #include "qquickparticleaffector_p.h"
 #include "qquickdirection_p.h"
+#include "qquickv4particledata_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -100,6 +101,7 @@ public:
 
 Q_SIGNALS:
     void affectParticles(QQmlV4Handle particles, qreal dt);
+    void affectParticleColumns(QQmlV4Handle columns, qreal dt);
 
     void positionChanged(QQuickDirection * arg);
 
@@ -144,9 +146,12 @@ public Q_SLOTS:
 
 protected:
     bool isAffectConnected();
+    bool isAffectColumnsConnected();
     virtual bool affectParticle(QQuickParticleData *d, qreal dt);
 private:
     void affectProperties(const QList<QQuickParticleData*> particles, qreal dt);
+    void emitAffect(const QList<QQuickParticleData*> &particles, QV4::ValueRef array,
+                    QQuickV4ParticleColumns *columns, qreal dt);
     QQuickDirection * m_position;
     QQuickDirection * m_velocity;
     QQuickDirection * m_acceleration;
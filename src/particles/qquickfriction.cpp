@@ -76,6 +76,7 @@ static const qreal epsilon = 0.00001;
 QQuickFrictionAffector::QQuickFrictionAffector(QQuickItem *parent) :
     QQuickParticleAffector(parent), m_factor(0.0), m_threshold(0.0)
 {
+    m_threadSafeBatch = true;
 }
 
 bool QQuickFrictionAffector::affectParticle(QQuickParticleData *d, qreal dt)
@@ -112,4 +113,12 @@ bool QQuickFrictionAffector::affectParticle(QQuickParticleData *d, qreal dt)
     d->setInstantaneousVY(newVY);
     return true;
 }
+
+void QQuickFrictionAffector::affectBatch(QQuickParticleData *const *particles, bool *affected, int count, qreal dt)
+{
+    for (int i = 0; i < count; i++)
+        if (QQuickFrictionAffector::affectParticle(particles[i], dt))
+            affected[i] = true;
+}
+
 QT_END_NAMESPACE
@@ -40,6 +40,8 @@
 ****************************************************************************/
 
 #include "qquickgravity_p.h"
+#include "qquickcustomaffector_p.h"
+#include "qquickparticlepainter_p.h"
 #include <cmath>
 QT_BEGIN_NAMESPACE
 const qreal CONV = 0.017453292520444443;
@@ -79,7 +81,108 @@ const qreal CONV = 0.017453292520444443;
 
 QQuickGravityAffector::QQuickGravityAffector(QQuickItem *parent) :
     QQuickParticleAffector(parent), m_magnitude(-10), m_angle(90), m_needRecalc(true)
+    , m_foldedDx(0), m_foldedDy(0)
 {
+    m_threadSafeBatch = true;
+}
+
+QQuickGravityAffector::~QQuickGravityAffector()
+{
+    unfoldAcceleration();
+}
+
+/*
+    A Gravity affector covering the whole system applies a constant acceleration, which can
+    be added to the acceleration of each particle once instead of rewriting its velocity
+    every frame. Painters then only reload a particle when it is first affected, and the
+    ImageParticle vertex shader does the rest of the motion on the GPU.
+
+    Set QT_QUICK_PARTICLES_FOLD_GRAVITY=0 to always update the particles on the CPU.
+*/
+bool QQuickGravityAffector::canFoldAcceleration()
+{
+    static bool enabled = qgetenv("QT_QUICK_PARTICLES_FOLD_GRAVITY") != "0";
+    if (!enabled || !m_system || !m_enabled || !m_magnitude || m_onceOff)
+        return false;
+    if (width() != 0 && height() != 0)
+        return false; //Particles leave the affected area
+    if (!whenCollidingWith().isEmpty() || isAffectedConnected())
+        return false;
+    //A custom Affector could replace the particle acceleration, dropping the folded part
+    foreach (QQuickParticleAffector *a, m_system->affectors())
+        if (qobject_cast<QQuickCustomAffector*>(a))
+            return false;
+    return true;
+}
+
+bool QQuickGravityAffector::isFolded(QQuickParticleData *d) const
+{
+    QHash<int, float>::const_iterator it = m_folded.constFind(d->systemIndex);
+    return it != m_folded.constEnd() && *it == d->t;
+}
+
+void QQuickGravityAffector::unfoldAcceleration()
+{
+    if (m_foldedSystem && !m_folded.isEmpty()) {
+        foreach (QQuickParticleGroupData* gd, m_foldedSystem->groupData) {
+            foreach (QQuickParticleData* d, gd->data) {
+                if (!d || !d->stillAlive() || !isFolded(d))
+                    continue;
+                d->setInstantaneousAX(d->ax - m_foldedDx);
+                d->setInstantaneousAY(d->ay - m_foldedDy);
+                foreach (QQuickParticlePainter* p, gd->painters)
+                    p->reload(d);
+            }
+        }
+    }
+    m_folded.clear();
+    m_foldedSystem = 0;
+}
+
+void QQuickGravityAffector::affectSystem(qreal dt)
+{
+    if (!canFoldAcceleration()) {
+        unfoldAcceleration();
+        QQuickParticleAffector::affectSystem(dt);
+        return;
+    }
+    if (m_foldedSystem != m_system)
+        unfoldAcceleration();
+    m_foldedSystem = m_system;
+
+    if (m_needRecalc) {
+        m_needRecalc = false;
+        m_dx = m_magnitude * std::cos(m_angle * CONV);
+        m_dy = m_magnitude * std::sin(m_angle * CONV);
+    }
+    bool changed = m_dx != m_foldedDx || m_dy != m_foldedDy;
+
+    foreach (QQuickParticleGroupData* gd, m_system->groupData) {
+        bool active = activeGroup(m_system->groupData.key(gd));
+        foreach (QQuickParticleData* d, gd->data) {
+            if (!d || d->systemIndex < 0 || !d->stillAlive())
+                continue;
+            bool folded = isFolded(d);
+            if (active && !folded) {
+                d->setInstantaneousAX(d->ax + m_dx);
+                d->setInstantaneousAY(d->ay + m_dy);
+                m_folded.insert(d->systemIndex, d->t);
+            } else if (active && changed) {
+                d->setInstantaneousAX(d->ax + m_dx - m_foldedDx);
+                d->setInstantaneousAY(d->ay + m_dy - m_foldedDy);
+            } else if (!active && folded) {
+                //Moved into a group this affector does not target
+                d->setInstantaneousAX(d->ax - m_foldedDx);
+                d->setInstantaneousAY(d->ay - m_foldedDy);
+                m_folded.remove(d->systemIndex);
+            } else {
+                continue;
+            }
+            m_system->needsReset << d;
+        }
+    }
+    m_foldedDx = m_dx;
+    m_foldedDy = m_dy;
 }
 
 bool QQuickGravityAffector::affectParticle(QQuickParticleData *d, qreal dt)
@@ -96,4 +199,27 @@ bool QQuickGravityAffector::affectParticle(QQuickParticleData *d, qreal dt)
     d->setInstantaneousVY(d->curVY() + m_dy*dt);
     return true;
 }
+
+void QQuickGravityAffector::affectBatch(QQuickParticleData *const *particles, bool *affected, int count, qreal dt)
+{
+    if (!m_magnitude)
+        return;
+    //Not cached in m_dx/m_dy, as batches may run concurrently on worker threads
+    const qreal dvx = m_magnitude * std::cos(m_angle * CONV) * dt;
+    const qreal dvy = m_magnitude * std::sin(m_angle * CONV) * dt;
+
+    //Equivalent to setInstantaneousV[XY](curV[XY]() + dv) per particle, with the
+    //terms which cancel out removed and the system time only converted once
+    const qreal now = m_system->timeInt / 1000.0;
+    for (int i = 0; i < count; i++) {
+        QQuickParticleData *d = particles[i];
+        qreal t = now - d->t;
+        d->vx += dvx;
+        d->x -= t * dvx;
+        d->vy += dvy;
+        d->y -= t * dvy;
+        affected[i] = true;
+    }
+}
+
 QT_END_NAMESPACE
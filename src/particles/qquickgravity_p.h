@@ -42,6 +42,8 @@
 #ifndef GRAVITYAFFECTOR_H
 #define GRAVITYAFFECTOR_H
 #include "qquickparticleaffector_p.h"
+#include <QtCore/QHash>
+#include <QtCore/QPointer>
 
 QT_BEGIN_NAMESPACE
 
@@ -53,6 +55,8 @@ class QQuickGravityAffector : public QQuickParticleAffector
     Q_PROPERTY(qreal angle READ angle WRITE setAngle NOTIFY angleChanged)
 public:
     explicit QQuickGravityAffector(QQuickItem *parent = 0);
+    ~QQuickGravityAffector();
+    virtual void affectSystem(qreal dt);
     qreal magnitude() const
     {
         return m_magnitude;
@@ -64,6 +68,7 @@ public:
     }
 protected:
     virtual bool affectParticle(QQuickParticleData *d, qreal dt);
+    virtual void affectBatch(QQuickParticleData *const *particles, bool *affected, int count, qreal dt);
 Q_SIGNALS:
 
     void magnitudeChanged(qreal arg);
@@ -106,6 +111,17 @@ private:
     bool m_needRecalc;
     qreal m_dx;
     qreal m_dy;
+
+    bool canFoldAcceleration();
+    bool isFolded(QQuickParticleData *d) const;
+    void unfoldAcceleration();
+
+    //Particles which carry this affector's acceleration in their own ax/ay,
+    //by system index and the birth time of the particle they were folded into
+    QHash<int, float> m_folded;
+    QPointer<QQuickParticleSystem> m_foldedSystem;
+    qreal m_foldedDx;
+    qreal m_foldedDy;
 };
 
 QT_END_NAMESPACE
@@ -740,6 +740,7 @@ QQuickImageParticle::QQuickImageParticle(QQuickItem* parent)
     , m_debugMode(false)
     , m_entryEffect(Fade)
     , m_startedImageLoading(0)
+    , m_pleaseGrow(false)
 {
     setFlag(ItemHasContents);
 }
@@ -1162,18 +1163,14 @@ QQuickParticleData* QQuickImageParticle::getShadowDatum(QQuickParticleData* datu
     if (datum->systemIndex == -1)
         return datum;
     QQuickParticleGroupData* gd = m_system->groupData[datum->group];
-    if (!m_shadowData.contains(datum->group)) {
-        QVector<QQuickParticleData*> data;
-        for (int i=0; i<gd->size(); i++){
-            QQuickParticleData* datum = new QQuickParticleData(m_system);
-            *datum = *(gd->data[i]);
-            data << datum;
-        }
-        m_shadowData.insert(datum->group, data);
+    QVector<QQuickParticleData*> &data = m_shadowData[datum->group];
+    while (data.size() < gd->size()) {//Also catches up with particles appended to the group
+        QQuickParticleData* shadow = new QQuickParticleData(m_system);
+        *shadow = *(gd->data[data.size()]);
+        data << shadow;
     }
-    //### If dynamic resize is added, remember to potentially resize the shadow data on out-of-bounds access request
 
-    return m_shadowData[datum->group][datum->index];
+    return data[datum->index];
 }
 
 bool QQuickImageParticle::loadingSomething()
@@ -1394,55 +1391,15 @@ void QQuickImageParticle::finishBuildParticleNodes(QSGNode** node)
         m_lastIdxStart += count;
 
         //Create Particle Geometry
-        int vCount = count * 4;
-        int iCount = count * 6;
-
-        QSGGeometry *g;
-        if (perfLevel == Sprites)
-            g = new QSGGeometry(SpriteParticle_AttributeSet, vCount, iCount);
-        else if (perfLevel == Tabled)
-            g = new QSGGeometry(DeformableParticle_AttributeSet, vCount, iCount);
-        else if (perfLevel == Deformable)
-            g = new QSGGeometry(DeformableParticle_AttributeSet, vCount, iCount);
-        else if (perfLevel == Colored)
-            g = new QSGGeometry(ColoredParticle_AttributeSet, count, 0);
-        else //Simple
-            g = new QSGGeometry(SimpleParticle_AttributeSet, count, 0);
-
+        QSGGeometry *g = createParticleGeometry(count);
         node->setGeometry(g);
-        if (perfLevel <= Colored){
-            g->setDrawingMode(GL_POINTS);
-            if (m_debugMode){
-                GLfloat pointSizeRange[2];
-                glGetFloatv(GL_ALIASED_POINT_SIZE_RANGE, pointSizeRange);
-                qDebug() << "Using point sprites, GL_ALIASED_POINT_SIZE_RANGE " <<pointSizeRange[0] << ":" << pointSizeRange[1];
-            }
-        }else
-            g->setDrawingMode(GL_TRIANGLES);
-
-        for (int p=0; p < count; ++p)
-            commit(gIdx, p);//commit sets geometry for the node, has its own perfLevel switch
-
-        if (perfLevel == Sprites)
-            initTexCoords<SpriteVertex>((SpriteVertex*)g->vertexData(), vCount);
-        else if (perfLevel == Tabled)
-            initTexCoords<DeformableVertex>((DeformableVertex*)g->vertexData(), vCount);
-        else if (perfLevel == Deformable)
-            initTexCoords<DeformableVertex>((DeformableVertex*)g->vertexData(), vCount);
-
-        if (perfLevel > Colored){
-            quint16 *indices = g->indexDataAsUShort();
-            for (int i=0; i < count; ++i) {
-                int o = i * 4;
-                indices[0] = o;
-                indices[1] = o + 1;
-                indices[2] = o + 2;
-                indices[3] = o + 1;
-                indices[4] = o + 3;
-                indices[5] = o + 2;
-                indices += 6;
-            }
+        if (perfLevel <= Colored && m_debugMode){
+            GLfloat pointSizeRange[2];
+            glGetFloatv(GL_ALIASED_POINT_SIZE_RANGE, pointSizeRange);
+            qDebug() << "Using point sprites, GL_ALIASED_POINT_SIZE_RANGE " <<pointSizeRange[0] << ":" << pointSizeRange[1];
         }
+
+        initParticleGeometry(gIdx, 0, count);
     }
 
     if (perfLevel == Sprites)
@@ -1459,8 +1416,117 @@ void QQuickImageParticle::finishBuildParticleNodes(QSGNode** node)
     update();
 }
 
+QSGGeometry *QQuickImageParticle::createParticleGeometry(int count)
+{
+    int vCount = count * 4;
+    int iCount = count * 6;
+
+    QSGGeometry *g;
+    if (perfLevel == Sprites)
+        g = new QSGGeometry(SpriteParticle_AttributeSet, vCount, iCount);
+    else if (perfLevel == Tabled)
+        g = new QSGGeometry(DeformableParticle_AttributeSet, vCount, iCount);
+    else if (perfLevel == Deformable)
+        g = new QSGGeometry(DeformableParticle_AttributeSet, vCount, iCount);
+    else if (perfLevel == Colored)
+        g = new QSGGeometry(ColoredParticle_AttributeSet, count, 0);
+    else //Simple
+        g = new QSGGeometry(SimpleParticle_AttributeSet, count, 0);
+
+    if (perfLevel <= Colored)
+        g->setDrawingMode(GL_POINTS);
+    else
+        g->setDrawingMode(GL_TRIANGLES);
+    return g;
+}
+
+/*
+    Fills in the vertices and indices of particles \a from to \a to - 1 of the group's node.
+*/
+void QQuickImageParticle::initParticleGeometry(int gIdx, int from, int to)
+{
+    QSGGeometry *g = m_nodes[gIdx]->geometry();
+    for (int p=from; p < to; ++p)
+        commit(gIdx, p);//commit sets geometry for the node, has its own perfLevel switch
+
+    int vFrom = from * 4;
+    int vCount = (to - from) * 4;
+    if (perfLevel == Sprites)
+        initTexCoords<SpriteVertex>((SpriteVertex*)g->vertexData() + vFrom, vCount);
+    else if (perfLevel == Tabled)
+        initTexCoords<DeformableVertex>((DeformableVertex*)g->vertexData() + vFrom, vCount);
+    else if (perfLevel == Deformable)
+        initTexCoords<DeformableVertex>((DeformableVertex*)g->vertexData() + vFrom, vCount);
+
+    if (perfLevel > Colored){
+        quint16 *indices = g->indexDataAsUShort() + from * 6;
+        for (int i=from; i < to; ++i) {
+            int o = i * 4;
+            indices[0] = o;
+            indices[1] = o + 1;
+            indices[2] = o + 2;
+            indices[3] = o + 1;
+            indices[4] = o + 3;
+            indices[5] = o + 2;
+            indices += 6;
+        }
+    }
+}
+
+bool QQuickImageParticle::countAppended()
+{
+    //Sprite indexes are laid out group after group, so growing one group moves the others
+    if (perfLevel == Unknown || perfLevel == Sprites)
+        return false;
+#ifdef QT_OPENGL_ES_2
+    if (m_count * 4 > 0xffff)
+        return false;//The rebuild prints the warning
+#endif
+    m_pleaseGrow = true;
+    update();
+    return true;
+}
+
+/*
+    Grows the geometry of each group's node to the current size of the group, keeping the
+    vertices of the existing particles, so that the material and textures survive bursts.
+    Returns false if the nodes have to be rebuilt instead.
+*/
+bool QQuickImageParticle::growParticleNodes()
+{
+    foreach (const QString &str, m_groups){
+        int gIdx = m_system->groupIds[str];
+        QSGGeometryNode *node = m_nodes.value(gIdx);
+        if (!node)
+            return false;
+        int count = m_system->groupData[gIdx]->size();
+        QSGGeometry *old = node->geometry();
+        int oldCount = perfLevel > Colored ? old->vertexCount() / 4 : old->vertexCount();
+        if (count == oldCount)
+            continue;
+        if (count < oldCount)
+            return false;
+
+        QSGGeometry *g = createParticleGeometry(count);
+        memcpy(g->vertexData(), old->vertexData(), old->vertexCount() * old->sizeOfVertex());
+        if (perfLevel > Colored)
+            memcpy(g->indexData(), old->indexData(), old->indexCount() * old->sizeOfIndex());
+        node->setGeometry(g);
+        delete old;
+
+        initParticleGeometry(gIdx, oldCount, count);
+    }
+    return true;
+}
+
 QSGNode *QQuickImageParticle::updatePaintNode(QSGNode *node, UpdatePaintNodeData *)
 {
+    if (m_pleaseGrow) {
+        m_pleaseGrow = false;
+        if (node && !m_pleaseReset && !growParticleNodes())
+            m_pleaseReset = true;
+    }
+
     if (m_pleaseReset){
         if (node)
             delete node;
@@ -341,6 +341,7 @@ protected:
     void reset();
     virtual void initialize(int gIdx, int pIdx);
     virtual void commit(int gIdx, int pIdx);
+    virtual bool countAppended();
 
     QSGNode *updatePaintNode(QSGNode *, UpdatePaintNodeData *);
     void prepareNextFrame(QSGNode**);
@@ -366,6 +367,10 @@ private:
     ImageData *m_opacityTable;
     bool loadingSomething();
 
+    QSGGeometry *createParticleGeometry(int count);
+    void initParticleGeometry(int gIdx, int from, int to);
+    bool growParticleNodes();
+
 
     QColor m_color;
     qreal m_color_variation;
@@ -438,6 +443,7 @@ private:
     EntryEffect m_entryEffect;
     Status m_status;
     int m_startedImageLoading;
+    bool m_pleaseGrow;
 };
 
 QT_END_NAMESPACE
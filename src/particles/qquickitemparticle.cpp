@@ -98,10 +98,26 @@ QT_BEGIN_NAMESPACE
 
     An instance of the delegate will be created for every logical
     particle, and moved along with it.
+
+    When a particle dies, its delegate instance is kept for reuse by a later particle rather
+    than destroyed, up to poolSize instances. Reused instances receive the
+    ItemParticle.detached signal when their particle dies, and the ItemParticle.attached
+    signal when they are given to a new one, which is the place to reset any state the
+    delegate changed.
+*/
+/*!
+    \qmlproperty int QtQuick.Particles::ItemParticle::poolSize
+
+    The maximum number of delegate instances kept for reuse after their particles die.
+
+    The default, -1, keeps as many as the painted particle groups can hold
+    alive at once. Once the system has reached that number of live particles,
+    no more delegates are created or destroyed.
+    Set it to 0 to destroy each delegate instance when its particle dies.
 */
 
 QQuickItemParticle::QQuickItemParticle(QQuickItem *parent) :
-    QQuickParticlePainter(parent), m_fade(true), m_delegate(0)
+    QQuickParticlePainter(parent), m_fade(true), m_delegate(0), m_poolSize(-1)
 {
     setFlag(QQuickItem::ItemHasContents);
     clock = new Clock(this);
@@ -111,6 +127,39 @@ QQuickItemParticle::QQuickItemParticle(QQuickItem *parent) :
 QQuickItemParticle::~QQuickItemParticle()
 {
     delete clock;
+    qDeleteAll(m_pool);
+}
+
+int QQuickItemParticle::poolLimit() const
+{
+    if (m_poolSize >= 0)
+        return m_poolSize;
+    if (!m_system)
+        return 0;
+    int limit = 0;
+    foreach (const QString &group, m_groups) {
+        QHash<QString, int>::const_iterator it = m_system->groupIds.constFind(group);
+        if (it != m_system->groupIds.constEnd() && m_system->groupData.contains(*it))
+            limit += m_system->groupData[*it]->size();
+    }
+    return limit;
+}
+
+void QQuickItemParticle::trimPool()
+{
+    int limit = poolLimit();
+    while (m_pool.size() > limit) {
+        QQuickItem *item = m_pool.takeLast();
+        m_created.remove(item);
+        delete item;
+    }
+}
+
+void QQuickItemParticle::clearPool()
+{
+    qDeleteAll(m_pool);
+    m_pool.clear();
+    m_created.clear();//Items of a previous delegate are deleted as their particles die
 }
 
 void QQuickItemParticle::freeze(QQuickItem* item)
@@ -157,8 +206,14 @@ void QQuickItemParticle::tick(int time)
         QQuickItemParticleAttached* mpa;
         if ((mpa = qobject_cast<QQuickItemParticleAttached*>(qmlAttachedPropertiesObject<QQuickItemParticle>(item))))
             mpa->detach();//reparent as well?
-        delete item;
         m_activeCount--;
+        if (m_created.contains(item) && m_pool.size() < poolLimit()) {
+            m_stasis.remove(item);
+            m_pool << item;
+        } else {
+            m_created.remove(item);
+            delete item;
+        }
     }
     m_deletables.clear();
 
@@ -172,8 +227,12 @@ void QQuickItemParticle::tick(int time)
         if (!m_pendingItems.isEmpty()){
             d->delegate = m_pendingItems.front();
             m_pendingItems.pop_front();
+        }else if (!m_pool.isEmpty()){
+            d->delegate = m_pool.takeLast();
         }else if (m_delegate){
             d->delegate = qobject_cast<QQuickItem*>(m_delegate->create(qmlContext(this)));
+            if (d->delegate)
+                m_created << d->delegate;
         }
         if (d->delegate && d){//###Data can be zero if creating an item leads to a reset - this screws things up.
             d->delegate->setX(d->curX() - d->delegate->width()/2);//TODO: adjust for system?
@@ -193,6 +252,12 @@ void QQuickItemParticle::tick(int time)
     m_loadables.clear();
 }
 
+bool QQuickItemParticle::countAppended()
+{
+    //New particles are queued as loadables when emitted, nothing else depends on the count
+    return true;
+}
+
 void QQuickItemParticle::reset()
 {
     QQuickParticlePainter::reset();
@@ -55,6 +55,7 @@ class QQuickItemParticle : public QQuickParticlePainter
     Q_OBJECT
     Q_PROPERTY(bool fade READ fade WRITE setFade NOTIFY fadeChanged)
     Q_PROPERTY(QQmlComponent* delegate READ delegate WRITE setDelegate NOTIFY delegateChanged)
+    Q_PROPERTY(int poolSize READ poolSize WRITE setPoolSize NOTIFY poolSizeChanged)
 public:
     explicit QQuickItemParticle(QQuickItem *parent = 0);
     ~QQuickItemParticle();
@@ -69,11 +70,18 @@ public:
         return m_delegate;
     }
 
+    int poolSize() const
+    {
+        return m_poolSize;
+    }
+
 Q_SIGNALS:
     void fadeChanged();
 
     void delegateChanged(QQmlComponent* arg);
 
+    void poolSizeChanged(int arg);
+
 public Q_SLOTS:
     //TODO: Add a follow mode, where moving the delegate causes the logical particle to go with it?
     void freeze(QQuickItem* item);
@@ -86,17 +94,31 @@ public Q_SLOTS:
     {
         if (m_delegate != arg) {
             m_delegate = arg;
+            clearPool();
             Q_EMIT delegateChanged(arg);
         }
     }
 
+    void setPoolSize(int arg)
+    {
+        if (m_poolSize != arg) {
+            m_poolSize = arg;
+            trimPool();
+            Q_EMIT poolSizeChanged(arg);
+        }
+    }
+
 protected:
     virtual void reset();
     virtual void commit(int gIdx, int pIdx);
     virtual void initialize(int gIdx, int pIdx);
+    virtual bool countAppended();
     void prepareNextFrame();
 private:
     void tick(int time = 0);
+    int poolLimit() const;
+    void trimPool();
+    void clearPool();
     QList<QQuickItem* > m_deletables;
     QList< QQuickParticleData* > m_loadables;
     bool m_fade;
@@ -107,6 +129,9 @@ private:
     qreal m_lastT;
     int m_activeCount;
     QQmlComponent* m_delegate;
+    int m_poolSize;
+    QSet<QQuickItem*> m_created;//Live items created from m_delegate, which may be recycled
+    QList<QQuickItem*> m_pool;
 
     typedef QTickAnimationProxy<QQuickItemParticle, &QQuickItemParticle::tick> Clock;
     Clock *clock;
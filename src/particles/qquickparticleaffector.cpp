@@ -42,6 +42,9 @@
 #include "qquickparticleaffector_p.h"
 #include <QDebug>
 #include <private/qqmlglobal_p.h>
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThreadPool>
 QT_BEGIN_NAMESPACE
 
 /*!
@@ -131,6 +134,7 @@ QT_BEGIN_NAMESPACE
 */
 QQuickParticleAffector::QQuickParticleAffector(QQuickItem *parent) :
     QQuickItem(parent), m_needsReset(false), m_ignoresTime(false), m_onceOff(false), m_enabled(true)
+    , m_threadSafeBatch(false)
     , m_system(0), m_updateIntSet(false), m_shape(new QQuickParticleExtruder(this))
 {
 }
@@ -187,6 +191,55 @@ void QQuickParticleAffector::postAffect(QQuickParticleData* d)
         emit affected(d->curX(), d->curY());
 }
 
+/*
+    Minimum number of particles in a batch before it is split across the global thread
+    pool. Threaded affecting is opt-in through QT_QUICK_PARTICLES_THREADED, as it changes
+    the order particles are affected in, which matters to affectors with side effects.
+*/
+static int qt_particles_thread_threshold()
+{
+    static int threshold = -1;
+    if (threshold < 0) {
+        threshold = 0;
+        if (qgetenv("QT_QUICK_PARTICLES_THREADED").toInt()) {
+            bool ok = false;
+            int value = qgetenv("QT_QUICK_PARTICLES_THREAD_THRESHOLD").toInt(&ok);
+            threshold = ok && value > 0 ? value : 2048;
+        }
+    }
+    return threshold;
+}
+
+class QQuickParticleAffectorJob : public QRunnable
+{
+public:
+    QQuickParticleAffectorJob(QQuickParticleAffector *affector, QQuickParticleData *const *particles,
+                              bool *affected, int count, qreal dt, QSemaphore *done)
+        : m_affector(affector)
+        , m_particles(particles)
+        , m_affected(affected)
+        , m_count(count)
+        , m_dt(dt)
+        , m_done(done)
+    {
+    }
+
+    void run()
+    {
+        m_affector->affectBatch(m_particles, m_affected, m_count, m_dt);
+        if (m_done)
+            m_done->release();
+    }
+
+private:
+    QQuickParticleAffector *m_affector;
+    QQuickParticleData *const *m_particles;
+    bool *m_affected;
+    int m_count;
+    qreal m_dt;
+    QSemaphore *m_done;
+};
+
 const qreal QQuickParticleAffector::simulationDelta = 0.020;
 const qreal QQuickParticleAffector::simulationCutoff = 1.000;//If this goes above 1.0, then m_once behaviour needs special codepath
 
@@ -194,36 +247,113 @@ void QQuickParticleAffector::affectSystem(qreal dt)
 {
     if (!m_enabled)
         return;
-    //If not reimplemented, calls affectParticle per particle
-    //But only on particles in targeted system/area
+    //If not reimplemented, collects the particles in targeted system/area for each group
+    //and hands them to affectBatch, which by default calls affectParticle per particle
     updateOffsets();//### Needed if an ancestor is transformed.
     if (m_onceOff)
         dt = 1.0;
     foreach (QQuickParticleGroupData* gd, m_system->groupData) {
-        if (activeGroup(m_system->groupData.key(gd))) {
-            foreach (QQuickParticleData* d, gd->data) {
-                if (shouldAffect(d)) {
-                    bool affected = false;
-                    qreal myDt = dt;
-                    if (!m_ignoresTime && myDt < simulationCutoff) {
-                        int realTime = m_system->timeInt;
-                        m_system->timeInt -= myDt * 1000.0;
-                        while (myDt > simulationDelta) {
-                            m_system->timeInt += simulationDelta * 1000.0;
-                            if (d->alive())//Only affect during the parts it was alive for
-                                affected = affectParticle(d, simulationDelta) || affected;
-                            myDt -= simulationDelta;
-                        }
-                        m_system->timeInt = realTime;
-                    }
-                    if (myDt > 0.0)
-                        affected = affectParticle(d, myDt) || affected;
-                    if (affected)
-                        postAffect(d);
-                }
+        if (!activeGroup(m_system->groupData.key(gd)))
+            continue;
+        m_batch.resize(0);
+        foreach (QQuickParticleData* d, gd->data)
+            if (shouldAffect(d))
+                m_batch << d;
+        if (m_batch.isEmpty())
+            continue;
+        m_batchAffected.fill(false, m_batch.size());
+
+        qreal myDt = dt;
+        if (!m_ignoresTime && myDt < simulationCutoff) {
+            int realTime = m_system->timeInt;
+            m_system->timeInt -= myDt * 1000.0;
+            while (myDt > simulationDelta) {
+                m_system->timeInt += simulationDelta * 1000.0;
+                affectAliveBatch(simulationDelta);//Only affect during the parts it was alive for
+                myDt -= simulationDelta;
             }
+            m_system->timeInt = realTime;
+        }
+        if (myDt > 0.0)
+            runBatch(m_batch.constData(), m_batchAffected.data(), m_batch.size(), myDt);
+
+        for (int i = 0; i < m_batch.size(); i++)
+            if (m_batchAffected.at(i))
+                postAffect(m_batch.at(i));
+    }
+}
+
+/*
+    Runs one simulation step over the particles of the current batch which are alive
+    at the current system time.
+*/
+void QQuickParticleAffector::affectAliveBatch(qreal dt)
+{
+    m_stepBatch.resize(0);
+    m_stepIndexes.resize(0);
+    for (int i = 0; i < m_batch.size(); i++) {
+        if (m_batch.at(i)->alive()) {
+            m_stepBatch << m_batch.at(i);
+            m_stepIndexes << i;
         }
     }
+    if (m_stepBatch.isEmpty())
+        return;
+    if (m_stepBatch.size() == m_batch.size()) {
+        runBatch(m_batch.constData(), m_batchAffected.data(), m_batch.size(), dt);
+        return;
+    }
+    m_stepAffected.fill(false, m_stepBatch.size());
+    runBatch(m_stepBatch.constData(), m_stepAffected.data(), m_stepBatch.size(), dt);
+    for (int i = 0; i < m_stepBatch.size(); i++)
+        if (m_stepAffected.at(i))
+            m_batchAffected[m_stepIndexes.at(i)] = true;
+}
+
+/*
+    Calls affectBatch, splitting large batches of thread safe affectors into chunks which
+    run on the global thread pool. The calling thread takes the last chunk and then waits
+    for the others, so the particle data is never accessed concurrently with the painters
+    or the rest of the system.
+*/
+void QQuickParticleAffector::runBatch(QQuickParticleData *const *particles, bool *affected, int count, qreal dt)
+{
+    int threshold = qt_particles_thread_threshold();
+    QThreadPool *pool = QThreadPool::globalInstance();
+    if (!m_threadSafeBatch || threshold <= 0 || count < 2 * threshold || pool->maxThreadCount() < 2) {
+        affectBatch(particles, affected, count, dt);
+        return;
+    }
+
+    int chunks = qMin(count / threshold, pool->maxThreadCount());
+    int chunkSize = (count + chunks - 1) / chunks;
+    QSemaphore done;
+    int started = 0;
+    int offset = 0;
+    for (; offset + chunkSize < count; offset += chunkSize) {
+        pool->start(new QQuickParticleAffectorJob(this, particles + offset, affected + offset, chunkSize, dt, &done));
+        ++started;
+    }
+    affectBatch(particles + offset, affected + offset, count - offset, dt);
+    done.acquire(started);
+}
+
+/*
+    Affects \a count particles of the same group by \a dt, setting the matching entry
+    of \a affected to true for each particle that changed. Entries are never reset to
+    false, as the same array accumulates the results of every simulation step.
+
+    The default implementation calls affectParticle for every particle. Affectors
+    which can update a whole batch more cheaply than one virtual call per particle
+    reimplement this. If the reimplementation only reads the affector's properties and
+    writes to the particles it is given, set m_threadSafeBatch so that large batches can
+    be split across worker threads.
+*/
+void QQuickParticleAffector::affectBatch(QQuickParticleData *const *particles, bool *affected, int count, qreal dt)
+{
+    for (int i = 0; i < count; i++)
+        if (affectParticle(particles[i], dt))
+            affected[i] = true;
 }
 
 bool QQuickParticleAffector::affectParticle(QQuickParticleData *, qreal )
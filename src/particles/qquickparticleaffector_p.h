@@ -165,10 +165,12 @@ public Q_SLOTS:
 protected:
     friend class QQuickParticleSystem;
     virtual bool affectParticle(QQuickParticleData *d, qreal dt);
+    virtual void affectBatch(QQuickParticleData *const *particles, bool *affected, int count, qreal dt);
     bool m_needsReset:1;//### What is this really saving?
     bool m_ignoresTime:1;
     bool m_onceOff:1;
     bool m_enabled:1;
+    bool m_threadSafeBatch:1;//affectBatch only touches the particles it is given, so batches may run on worker threads
 
     QQuickParticleSystem* m_system;
     QStringList m_groups;
@@ -191,6 +193,16 @@ private:
     QStringList m_whenCollidingWith;
 
     bool isColliding(QQuickParticleData* d);
+    void affectAliveBatch(qreal dt);
+    void runBatch(QQuickParticleData *const *particles, bool *affected, int count, qreal dt);
+    friend class QQuickParticleAffectorJob;
+
+    //Scratch space reused between frames to avoid reallocating per group
+    QVector<QQuickParticleData*> m_batch;
+    QVector<bool> m_batchAffected;
+    QVector<QQuickParticleData*> m_stepBatch;
+    QVector<bool> m_stepAffected;
+    QVector<int> m_stepIndexes;
 };
 
 QT_END_NAMESPACE
@@ -42,6 +42,7 @@
 #include "qquickparticleemitter_p.h"
 #include <private/qqmlengine_p.h>
 #include <private/qqmlglobal_p.h>
+#include "qquickv4particledata_p.h"
 QT_BEGIN_NAMESPACE
 
 
@@ -198,6 +199,14 @@ QT_BEGIN_NAMESPACE
     high-volume particle systems.
 */
 
+/*!
+    \qmlsignal QtQuick.Particles::Emitter::onEmitParticleColumns(ParticleColumns columns)
+
+    This handler is called when particles are emitted, like onEmitParticles. Instead of an
+    array of Particle objects, columns holds one Float32Array per particle attribute, which
+    can be modified in place without creating an object for every emitted particle.
+*/
+
 /*! \qmlmethod QtQuick.Particles::Emitter::burst(int count)
 
     Emits count particles from this emitter immediately.
@@ -259,6 +268,22 @@ bool QQuickParticleEmitter::isEmitConnected()
     IS_SIGNAL_CONNECTED(this, QQuickParticleEmitter, emitParticles, (QQmlV4Handle));
 }
 
+bool QQuickParticleEmitter::isEmitColumnsConnected()
+{
+    IS_SIGNAL_CONNECTED(this, QQuickParticleEmitter, emitParticleColumns, (QQmlV4Handle));
+}
+
+void QQuickParticleEmitter::emitColumns(const QList<QQuickParticleData*> &particles)
+{
+    if (particles.isEmpty() || !isEmitColumnsConnected())
+        return;
+    //As with emitParticles, the painters pick up the changes on their first reload
+    QQuickV4ParticleColumns columns(::qmlEngine(this)->handle(), particles);
+    columns.load();
+    emitParticleColumns(columns.v4Value());
+    columns.store();
+}
+
 void QQuickParticleEmitter::componentComplete()
 {
     if (!m_system && qobject_cast<QQuickParticleSystem*>(parentItem()))
@@ -492,6 +517,7 @@ void QQuickParticleEmitter::emitWindow(int timeStamp)
 
         emitParticles(QQmlV4Handle(array));//A chance for arbitrary JS changes
     }
+    emitColumns(toEmit);
 
     m_last_emission = pt;
 
@@ -120,6 +120,7 @@ public:
     virtual void componentComplete();
 Q_SIGNALS:
     void emitParticles(QQmlV4Handle particles);
+    void emitParticleColumns(QQmlV4Handle columns);
     void particlesPerSecondChanged(qreal);
     void particleDurationChanged(int);
     void enabledChanged(bool);
@@ -336,6 +337,8 @@ protected:
        QPointF m_last_last_last_emitter;
 
        bool isEmitConnected();
+       bool isEmitColumnsConnected();
+       void emitColumns(const QList<QQuickParticleData*> &particles);
 private:
        QQuickDirection m_nullVector;
 
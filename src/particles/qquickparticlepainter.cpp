@@ -135,6 +135,17 @@ void QQuickParticlePainter::setCount(int c)//### TODO: some resizeing so that pa
     reset();
 }
 
+void QQuickParticlePainter::appendCount(int delta)
+{
+    Q_ASSERT(delta >= 0);
+    if (!delta)
+        return;
+    m_count += delta;
+    emit countChanged();
+    if (m_pleaseReset || !countAppended())
+        reset();
+}
+
 int QQuickParticlePainter::count()
 {
     return m_count;
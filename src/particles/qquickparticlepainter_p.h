@@ -61,6 +61,7 @@ public:
     void load(QQuickParticleData*);
     void reload(QQuickParticleData*);
     void setCount(int c);
+    void appendCount(int delta);
     int count();
     void performPendingCommits();//Called from updatePaintNode
     QQuickParticleSystem* system() const
@@ -116,6 +117,13 @@ protected:
         Q_UNUSED(gIdx);
         Q_UNUSED(pIdx);
     }
+    /* Called when particles have been appended to the end of painted groups, after count()
+       has grown to include them. Return true to keep painting the existing particles, in which
+       case the new ones are simply loaded when emitted, or false to be reset.
+    */
+    virtual bool countAppended(){
+        return false;
+    }
 
     QQuickParticleSystem* m_system;
     friend class QQuickParticleSystem;
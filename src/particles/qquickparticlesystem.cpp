@@ -223,116 +223,7 @@ int roundedTime(qreal a)
     return (int)qRound(a*1000.0);
 }
 
-QQuickParticleDataHeap::QQuickParticleDataHeap()
-    : m_data(0)
-{
-    m_data.reserve(1000);
-    clear();
-}
-
-void QQuickParticleDataHeap::grow() //###Consider automatic growth vs resize() calls from GroupData
-{
-    m_data.resize(1 << ++m_size);
-}
-
-void QQuickParticleDataHeap::insert(QQuickParticleData* data)
-{
-    insertTimed(data, roundedTime(data->t + data->lifeSpan));
-}
-
-void QQuickParticleDataHeap::insertTimed(QQuickParticleData* data, int time)
-{
-    //TODO: Optimize 0 lifespan (or already dead) case
-    if (m_lookups.contains(time)) {
-        m_data[m_lookups[time]].data << data;
-        return;
-    }
-    if (m_end == (1 << m_size))
-        grow();
-    m_data[m_end].time = time;
-    m_data[m_end].data.clear();
-    m_data[m_end].data.insert(data);
-    m_lookups.insert(time, m_end);
-    bubbleUp(m_end++);
-}
-
-int QQuickParticleDataHeap::top()
-{
-    if (m_end == 0)
-        return 1 << 30;
-    return m_data[0].time;
-}
-
-QSet<QQuickParticleData*> QQuickParticleDataHeap::pop()
-{
-    if (!m_end)
-        return QSet<QQuickParticleData*> ();
-    QSet<QQuickParticleData*> ret = m_data[0].data;
-    m_lookups.remove(m_data[0].time);
-    if (m_end == 1) {
-        --m_end;
-    } else {
-        m_data[0] = m_data[--m_end];
-        bubbleDown(0);
-    }
-    return ret;
-}
-
-void QQuickParticleDataHeap::clear()
-{
-    m_size = 0;
-    m_end = 0;
-    //m_size is in powers of two. So to start at 0 we have one allocated
-    m_data.resize(1);
-    m_lookups.clear();
-}
-
-bool QQuickParticleDataHeap::contains(QQuickParticleData* d)
-{
-    for (int i=0; i<m_end; i++)
-        if (m_data[i].data.contains(d))
-            return true;
-    return false;
-}
-
-void QQuickParticleDataHeap::swap(int a, int b)
-{
-    m_tmp = m_data[a];
-    m_data[a] = m_data[b];
-    m_data[b] = m_tmp;
-    m_lookups[m_data[a].time] = a;
-    m_lookups[m_data[b].time] = b;
-}
-
-void QQuickParticleDataHeap::bubbleUp(int idx)//tends to be called once
-{
-    if (!idx)
-        return;
-    int parent = (idx-1)/2;
-    if (m_data[idx].time < m_data[parent].time) {
-        swap(idx, parent);
-        bubbleUp(parent);
-    }
-}
-
-void QQuickParticleDataHeap::bubbleDown(int idx)//tends to be called log n times
-{
-    int left = idx*2 + 1;
-    if (left >= m_end)
-        return;
-    int lesser = left;
-    int right = idx*2 + 2;
-    if (right < m_end) {
-        if (m_data[left].time > m_data[right].time)
-            lesser = right;
-    }
-    if (m_data[idx].time > m_data[lesser].time) {
-        swap(idx, lesser);
-        bubbleDown(lesser);
-    }
-}
-
-QQuickParticleGroupData::QQuickParticleGroupData(int id, QQuickParticleSystem* sys):index(id),m_size(0),m_system(sys)
+QQuickParticleGroupData::QQuickParticleGroupData(int id, QQuickParticleSystem* sys):index(id),m_size(0),m_system(sys),m_growth(10),m_lastGrowthTime(-1)
 {
     initList();
 }
@@ -359,21 +250,32 @@ void QQuickParticleGroupData::setSize(int newSize)
         return;
     Q_ASSERT(newSize > m_size);//XXX allow shrinking
     data.resize(newSize);
+    dataWheel.reserve(newSize);
+    m_isFree.resize(newSize);
     for (int i=m_size; i<newSize; i++) {
         data[i] = new QQuickParticleData(m_system);
         data[i]->group = index;
         data[i]->index = i;
-        reusableIndexes << i;
     }
+    for (int i=newSize-1; i>=m_size; i--)//Reversed, so that the lowest index is reused first
+        release(i);
     int delta = newSize - m_size;
     m_size = newSize;
     foreach (QQuickParticlePainter* p, painters)
-        p->setCount(p->count() + delta);
+        p->appendCount(delta);
+}
+
+void QQuickParticleGroupData::release(int idx)
+{
+    if (m_isFree.at(idx))
+        return;
+    m_isFree[idx] = true;
+    m_freeList << idx;
 }
 
 void QQuickParticleGroupData::initList()
 {
-    dataHeap.clear();
+    dataWheel.clear();
 }
 
 void QQuickParticleGroupData::kill(QQuickParticleData* d)
@@ -382,16 +284,18 @@ void QQuickParticleGroupData::kill(QQuickParticleData* d)
     d->lifeSpan = 0;//Kill off
     foreach (QQuickParticlePainter* p, painters)
         p->reload(d);
-    reusableIndexes << d->index;
+    dataWheel.remove(d->index);
+    release(d->index);
 }
 
 QQuickParticleData* QQuickParticleGroupData::newDatum(bool respectsLimits)
 {
     //recycle();//Extra recycler round to be sure?
 
-    while (!reusableIndexes.empty()) {
-        int idx = *(reusableIndexes.begin());
-        reusableIndexes.remove(idx);
+    while (!m_freeList.isEmpty()) {
+        int idx = m_freeList.last();
+        m_freeList.removeLast();
+        m_isFree[idx] = false;
         if (data[idx]->stillAlive()) {// ### This means resurrection of 'dead' particles. Is that allowed?
             prepareRecycler(data[idx]);
             continue;
@@ -401,36 +305,46 @@ QQuickParticleData* QQuickParticleGroupData::newDatum(bool respectsLimits)
     if (respectsLimits)
         return 0;
 
+    //Grow by doubling steps within a frame, so that bursts only resize the group and
+    //notify its painters a few times, while steady emission still grows in small steps
+    if (m_lastGrowthTime == m_system->timeInt)
+        m_growth *= 2;
+    else
+        m_growth = 10;
+    m_lastGrowthTime = m_system->timeInt;
     int oldSize = m_size;
-    setSize(oldSize + 10);//###+1,10%,+10? Choose something non-arbitrarily
-    reusableIndexes.remove(oldSize);
+    setSize(oldSize + m_growth);
+    Q_ASSERT(m_freeList.last() == oldSize);
+    m_freeList.removeLast();
+    m_isFree[oldSize] = false;
     return data[oldSize];
 }
 
 bool QQuickParticleGroupData::recycle()
 {
-    while (dataHeap.top() <= m_system->timeInt) {
-        foreach (QQuickParticleData* datum, dataHeap.pop()) {
-            if (!datum->stillAlive()) {
-                reusableIndexes << datum->index;
-            } else {
-                prepareRecycler(datum); //ttl has been altered mid-way, put it back
-            }
+    m_expired.resize(0);
+    dataWheel.advance(m_system->timeInt, &m_expired);
+    for (int i = 0; i < m_expired.size(); ++i) {
+        QQuickParticleData* datum = data.at(m_expired.at(i));
+        if (!datum->stillAlive()) {
+            release(datum->index);
+        } else {
+            prepareRecycler(datum); //ttl has been altered mid-way, put it back
         }
     }
 
     //TODO: If the data is clear, gc (consider shrinking stack size)?
-    return reusableIndexes.count() == m_size;
+    return m_freeList.count() == m_size;
 }
 
 void QQuickParticleGroupData::prepareRecycler(QQuickParticleData* d)
 {
     if (d->lifeSpan*1000 < m_system->maxLife) {
-        dataHeap.insert(d);
+        dataWheel.insert(d->index, roundedTime(d->t + d->lifeSpan));
     } else {
         while ((roundedTime(d->t) + 2*m_system->maxLife/3) <= m_system->timeInt)
             d->extendLife(m_system->maxLife/3000.0);
-        dataHeap.insertTimed(d, roundedTime(d->t) + 2*m_system->maxLife/3);
+        dataWheel.insert(d->index, roundedTime(d->t) + 2*m_system->maxLife/3);
     }
 }
 
@@ -52,6 +52,7 @@
 #include <QAbstractAnimation>
 #include <QtQml/qqml.h>
 #include <private/qv8engine_p.h> //For QQmlV4Handle
+#include <private/qquicktimingwheel_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -67,38 +68,6 @@ class QQuickV4ParticleData;
 class QQuickParticleGroup;
 class QQuickImageParticle;
 
-struct QQuickParticleDataHeapNode{
-    int time;//in ms
-    QSet<QQuickParticleData*> data;//Set ptrs instead?
-};
-
-class QQuickParticleDataHeap {
-    //Idea is to do a binary heap, but which also stores a set of int,Node* so that if the int already exists, you can
-    //add it to the data* list. Pops return the whole list at once.
-public:
-    QQuickParticleDataHeap();
-    void insert(QQuickParticleData* data);
-    void insertTimed(QQuickParticleData* data, int time);
-
-    int top();
-
-    QSet<QQuickParticleData*> pop();
-
-    void clear();
-
-    bool contains(QQuickParticleData*);//O(n), for debugging purposes only
-private:
-    void grow();
-    void swap(int, int);
-    void bubbleUp(int);
-    void bubbleDown(int);
-    int m_size;
-    int m_end;
-    QQuickParticleDataHeapNode m_tmp;
-    QVector<QQuickParticleDataHeapNode> m_data;
-    QHash<int,int> m_lookups;
-};
-
 class Q_AUTOTEST_EXPORT QQuickParticleGroupData {
 public:
     QQuickParticleGroupData(int id, QQuickParticleSystem* sys);
@@ -114,8 +83,7 @@ public:
 
     //TODO: Refactor particle data list out into a separate class
     QVector<QQuickParticleData*> data;
-    QQuickParticleDataHeap dataHeap;
-    QSet<int> reusableIndexes;
+    QQuickTimingWheel dataWheel;//Keyed on particle index, in ms
     bool recycle(); //Force recycling round, returns true if all indexes are now reusable
 
     void initList();
@@ -128,8 +96,15 @@ public:
     void prepareRecycler(QQuickParticleData* d);
 
 private:
+    void release(int idx);
+
     int m_size;
     QQuickParticleSystem* m_system;
+    QVector<int> m_expired;
+    QVector<int> m_freeList;//Stack of reusable indexes
+    QVector<bool> m_isFree;
+    int m_growth;
+    int m_lastGrowthTime;
 };
 
 struct Color4ub {
@@ -330,6 +305,11 @@ public:
         return m_empty;
     }
 
+    const QList<QPointer<QQuickParticleAffector> > &affectors() const
+    {
+        return m_affectors;
+    }
+
 private:
     void initializeSystem();
     void initGroups();
@@ -111,6 +111,7 @@ QQuickAttractorAffector::QQuickAttractorAffector(QQuickItem *parent) :
     QQuickParticleAffector(parent), m_strength(0.0), m_x(0), m_y(0)
   , m_physics(Velocity), m_proportionalToDistance(Linear)
 {
+    m_threadSafeBatch = true;
 }
 
 bool QQuickAttractorAffector::affectParticle(QQuickParticleData *d, qreal dt)
@@ -161,4 +162,70 @@ bool QQuickAttractorAffector::affectParticle(QQuickParticleData *d, qreal dt)
 
     return true;
 }
+
+void QQuickAttractorAffector::affectBatch(QQuickParticleData *const *particles, bool *affected, int count, qreal dt)
+{
+    if (m_strength == 0.0)
+        return;
+    //Same as affectParticle, but with the target and system time hoisted out of the loop
+    //and the setInstantaneous* calls expanded, as only the changed terms need updating
+    const qreal now = m_system->timeInt / 1000.0;
+    const qreal targetX = m_x + m_offset.x();
+    const qreal targetY = m_y + m_offset.y();
+    for (int i = 0; i < count; i++) {
+        QQuickParticleData *d = particles[i];
+        qreal t = now - d->t;
+        qreal dx = targetX - (d->x + d->vx * t + 0.5 * d->ax * t * t);
+        qreal dy = targetY - (d->y + d->vy * t + 0.5 * d->ay * t * t);
+        qreal r = std::sqrt((dx*dx) + (dy*dy));
+        qreal ds = 0;
+        switch (m_proportionalToDistance){
+        case InverseQuadratic:
+            ds = (m_strength / qMax<qreal>(1.,r*r));
+            break;
+        case InverseLinear:
+            ds = (m_strength / qMax<qreal>(1.,r));
+            break;
+        case Quadratic:
+            ds = (m_strength * qMax<qreal>(1.,r*r));
+            break;
+        case Linear:
+            ds = (m_strength * qMax<qreal>(1.,r));
+            break;
+        default: //also Constant
+            ds = m_strength;
+        }
+        ds *= dt;
+        //ds * (cos(theta), sin(theta)) without the atan2 round trip
+        if (r > 0) {
+            dx *= ds / r;
+            dy *= ds / r;
+        } else {
+            dx = ds;
+            dy = 0;
+        }
+        switch (m_physics){
+        case Position:
+            d->x = (d->x + dx);
+            d->y = (d->y + dy);
+            break;
+        case Acceleration:
+            d->ax += dx;
+            d->vx -= t * dx;
+            d->x += 0.5 * t * t * dx;
+            d->ay += dy;
+            d->vy -= t * dy;
+            d->y += 0.5 * t * t * dy;
+            break;
+        case Velocity: //also default
+        default:
+            d->vx += dx;
+            d->x -= t * dx;
+            d->vy += dy;
+            d->y -= t * dy;
+        }
+        affected[i] = true;
+    }
+}
+
 QT_END_NAMESPACE
@@ -152,6 +152,7 @@ void setProportionalToDistance(Proportion arg)
 
 protected:
     virtual bool affectParticle(QQuickParticleData *d, qreal dt);
+    virtual void affectBatch(QQuickParticleData *const *particles, bool *affected, int count, qreal dt);
 private:
 qreal m_strength;
 qreal m_x;
@@ -283,6 +283,7 @@ void QQuickTrailEmitter::emitWindow(int timeStamp)
             else if (isEmitConnected())
                 emitParticles(QQmlV4Handle(array));//A chance for arbitrary JS changes
         }
+        emitColumns(toEmit);
         m_lastEmission[d->index] = pt;
     }
 
@@ -43,6 +43,7 @@
 #include "qquickparticlepainter_p.h"//TODO: Why was this needed again?
 #include <cmath>
 #include <cstdlib>
+#include <qmath.h>
 #include <QDebug>
 QT_BEGIN_NAMESPACE
 
@@ -55,7 +56,9 @@ QT_BEGIN_NAMESPACE
     \brief Provides fluid-like forces from a noise image
 
     The Turbulence Element scales the noise source over the area it affects,
-    and uses the curl of that source to generate force vectors.
+    and uses the curl of that source to generate force vectors. The curl is computed
+    once at the resolution of the noise source and sampled smoothly between its pixels,
+    so resizing the element is cheap.
 
     Turbulence requires a fixed size. Unlike other affectors, a 0x0 Turbulence element
     will affect no particles.
@@ -79,30 +82,31 @@ QT_BEGIN_NAMESPACE
     The source should be a relatively smooth black and white noise image, such as perlin noise.
     A default image will be used if none is provided.
 */
+/*!
+    \qmlproperty real QtQuick.Particles::Turbulence::period
+
+    If set to a value greater than zero, the force vectors slowly change over time.
+    Over each period, in seconds, the field blends into a second field made from the
+    transposed noise source and back again.
+
+    The default value is 0, which keeps the field constant.
+*/
 
 QQuickTurbulenceAffector::QQuickTurbulenceAffector(QQuickItem *parent) :
     QQuickParticleAffector(parent),
-    m_strength(10), m_lastT(0), m_gridSize(0), m_field(0), m_vectorField(0), m_inited(false)
+    m_strength(10), m_period(0), m_gridSize(0), m_fieldSize(0), m_layerWeight(0), m_inited(false)
 {
+    m_threadSafeBatch = true;
 }
 
 void QQuickTurbulenceAffector::geometryChanged(const QRectF &, const QRectF &)
 {
-    initializeGrid();
+    //The field is scaled over the affector when sampled, so it does not need rebuilding
+    m_gridSize = qMax(width(), height());
 }
 
 QQuickTurbulenceAffector::~QQuickTurbulenceAffector()
 {
-    if (m_field) {
-        for (int i=0; i<m_gridSize; i++)
-            free(m_field[i]);
-        free(m_field);
-    }
-    if (m_vectorField) {
-        for (int i=0; i<m_gridSize; i++)
-            free(m_vectorField[i]);
-        free(m_vectorField);
-    }
 }
 
 void QQuickTurbulenceAffector::initializeGrid()
@@ -110,57 +114,54 @@ void QQuickTurbulenceAffector::initializeGrid()
     if (!m_inited)
         return;
 
-    int arg = qMax(width(), height());
-    if (m_gridSize != arg) {
-        if (m_field){ //deallocate and then reallocate grid
-            for (int i=0; i<m_gridSize; i++)
-                free(m_field[i]);
-            free(m_field);
-            m_system = 0;
-        }
-        if (m_vectorField) {
-            for (int i=0; i<m_gridSize; i++)
-                free(m_vectorField[i]);
-            free(m_vectorField);
-        }
-        m_gridSize = arg;
-    }
-
-    m_field = (qreal**)malloc(m_gridSize * sizeof(qreal*));
-    for (int i=0; i<m_gridSize; i++)
-        m_field[i] = (qreal*)malloc(m_gridSize * sizeof(qreal));
-    m_vectorField = (QPointF**)malloc(m_gridSize * sizeof(QPointF*));
-    for (int i=0; i<m_gridSize; i++)
-        m_vectorField[i] = (QPointF*)malloc(m_gridSize * sizeof(QPointF));
-
     QImage image;
     if (!m_noiseSource.isEmpty())
-        image = QImage(m_noiseSource.toLocalFile()).scaled(QSize(m_gridSize, m_gridSize));
+        image = QImage(m_noiseSource.toLocalFile());
     if (image.isNull())
-        image = QImage(QStringLiteral(":particleresources/noise.png")).scaled(QSize(m_gridSize, m_gridSize));
-
-    for (int i=0; i<m_gridSize; i++)
-        for (int j=0; j<m_gridSize; j++)
-            m_field[i][j] = qRed(image.pixel(QPoint(i,j)));//Red as proxy for Value
-    for (int i=0; i<m_gridSize; i++){
-        for (int j=0; j<m_gridSize; j++){
-            m_vectorField[i][j].setX(boundsRespectingField(i,j) - boundsRespectingField(i,j-1));
-            m_vectorField[i][j].setY(boundsRespectingField(i-1,j) - boundsRespectingField(i,j));
+        image = QImage(QStringLiteral(":particleresources/noise.png"));
+    m_fieldSize = qMax(image.width(), image.height());
+    if (image.width() != image.height())
+        image = image.scaled(QSize(m_fieldSize, m_fieldSize));
+    image = image.convertToFormat(QImage::Format_RGB32);
+
+    const int n = m_fieldSize;
+    QVector<float> values(n * n);
+    for (int j=0; j<n; j++) {
+        const QRgb *line = reinterpret_cast<const QRgb *>(image.constScanLine(j));
+        for (int i=0; i<n; i++)
+            values[j * n + i] = qRed(line[i]);//Red as proxy for Value
+    }
+
+    //The curl of the noise, using the neighbour above and to the left clamped at the edges
+    m_fieldX.resize(n * n);
+    m_fieldY.resize(n * n);
+    for (int j=0; j<n; j++) {
+        for (int i=0; i<n; i++) {
+            m_fieldX[j * n + i] = values.at(j * n + i) - values.at(qMax(j - 1, 0) * n + i);
+            m_fieldY[j * n + i] = values.at(j * n + qMax(i - 1, 0)) - values.at(j * n + i);
         }
     }
+    m_layerX.clear();
+    m_layerY.clear();
 }
 
-qreal QQuickTurbulenceAffector::boundsRespectingField(int x, int y)
+/*
+    The second layer is the curl of the transposed noise, so that blending towards it
+    moves the vortices without needing a second noise image.
+*/
+void QQuickTurbulenceAffector::initializeLayer()
 {
-    if (x < 0)
-        x = 0;
-    if (x >= m_gridSize)
-        x = m_gridSize - 1;
-    if (y < 0)
-        y = 0;
-    if (y >= m_gridSize)
-        y = m_gridSize - 1;
-    return m_field[x][y];
+    if (m_layerX.size() == m_fieldX.size())
+        return;
+    const int n = m_fieldSize;
+    m_layerX.resize(n * n);
+    m_layerY.resize(n * n);
+    for (int j=0; j<n; j++) {
+        for (int i=0; i<n; i++) {
+            m_layerX[j * n + i] = -m_fieldY.at(i * n + j);
+            m_layerY[j * n + i] = -m_fieldX.at(i * n + j);
+        }
+    }
 }
 
 void QQuickTurbulenceAffector::ensureInit()
@@ -168,6 +169,7 @@ void QQuickTurbulenceAffector::ensureInit()
     if (m_inited)
         return;
     m_inited = true;
+    m_gridSize = qMax(width(), height());
     initializeGrid();
 }
 
@@ -176,30 +178,69 @@ void QQuickTurbulenceAffector::affectSystem(qreal dt)
     if (!m_system || !m_enabled)
         return;
     ensureInit();
-    if (!m_gridSize)
+    if (!m_gridSize || !m_fieldSize)
         return;
 
-    updateOffsets();//### Needed if an ancestor is transformed.
+    m_layerWeight = 0;
+    if (m_period > 0) {
+        initializeLayer();
+        m_layerWeight = 0.5 - 0.5 * std::cos(2 * M_PI * (m_system->timeInt / 1000.0) / m_period);
+    }
+    QQuickParticleAffector::affectSystem(dt);
+}
 
-    QRect boundsRect(0,0,m_gridSize,m_gridSize);
-    foreach (QQuickParticleGroupData *gd, m_system->groupData){
-        if (!activeGroup(m_system->groupData.key(gd)))
+static inline float bilinear(const float *field, int i00, int i01, int i10, int i11, float ax, float ay)
+{
+    float top = field[i00] + ax * (field[i01] - field[i00]);
+    float bottom = field[i10] + ax * (field[i11] - field[i10]);
+    return top + ay * (bottom - top);
+}
+
+void QQuickTurbulenceAffector::affectBatch(QQuickParticleData *const *particles, bool *affected, int count, qreal dt)
+{
+    const int n = m_fieldSize;
+    const qreal edge = m_gridSize - 0.5;
+    //Differences between neighbouring field values are rescaled from the field's
+    //resolution to the pixels of the affector
+    const qreal scale = qreal(n) / m_gridSize;
+    const qreal strength = m_strength * scale * dt;
+    const float weight = m_layerWeight;
+    const float *fieldX = m_fieldX.constData();
+    const float *fieldY = m_fieldY.constData();
+    const float *layerX = m_layerX.constData();
+    const float *layerY = m_layerY.constData();
+
+    for (int i = 0; i < count; i++) {
+        QQuickParticleData *d = particles[i];
+        qreal px = d->curX() - m_offset.x();
+        qreal py = d->curY() - m_offset.y();
+        if (px < -0.5 || py < -0.5 || px >= edge || py >= edge)
             continue;
-        foreach (QQuickParticleData *d, gd->data){
-            if (!shouldAffect(d))
-                continue;
-            QPoint pos = (QPointF(d->curX(), d->curY()) - m_offset).toPoint();
-            if (!boundsRect.contains(pos,true))//Need to redo bounds checking due to quantization.
-                continue;
-            qreal fx = 0.0;
-            qreal fy = 0.0;
-            fx += m_vectorField[pos.x()][pos.y()].x() * m_strength;
-            fy += m_vectorField[pos.x()][pos.y()].y() * m_strength;
-            if (fx || fy){
-                d->setInstantaneousVX(d->curVX()+ fx * dt);
-                d->setInstantaneousVY(d->curVY()+ fy * dt);
-                postAffect(d);
-            }
+
+        //Sample between the centres of the field's cells, clamped at its edges
+        qreal u = qBound(qreal(0), (px + 0.5) * scale - 0.5, qreal(n - 1));
+        qreal v = qBound(qreal(0), (py + 0.5) * scale - 0.5, qreal(n - 1));
+        int x0 = int(u);
+        int y0 = int(v);
+        int x1 = qMin(x0 + 1, n - 1);
+        int y1 = qMin(y0 + 1, n - 1);
+        float ax = u - x0;
+        float ay = v - y0;
+        int i00 = y0 * n + x0;
+        int i01 = y0 * n + x1;
+        int i10 = y1 * n + x0;
+        int i11 = y1 * n + x1;
+
+        float fx = bilinear(fieldX, i00, i01, i10, i11, ax, ay);
+        float fy = bilinear(fieldY, i00, i01, i10, i11, ax, ay);
+        if (weight > 0) {
+            fx += weight * (bilinear(layerX, i00, i01, i10, i11, ax, ay) - fx);
+            fy += weight * (bilinear(layerY, i00, i01, i10, i11, ax, ay) - fy);
+        }
+        if (fx || fy) {
+            d->setInstantaneousVX(d->curVX() + fx * strength);
+            d->setInstantaneousVY(d->curVY() + fy * strength);
+            affected[i] = true;
         }
     }
 }
@@ -43,6 +43,7 @@
 #define TURBULENCEAFFECTOR_H
 #include "qquickparticleaffector_p.h"
 #include <QQmlListProperty>
+#include <QVector>
 
 QT_BEGIN_NAMESPACE
 
@@ -53,6 +54,7 @@ class QQuickTurbulenceAffector : public QQuickParticleAffector
     Q_OBJECT
     Q_PROPERTY(qreal strength READ strength WRITE setStrength NOTIFY strengthChanged)
     Q_PROPERTY(QUrl noiseSource READ noiseSource WRITE setNoiseSource NOTIFY noiseSourceChanged)
+    Q_PROPERTY(qreal period READ period WRITE setPeriod NOTIFY periodChanged)
     public:
     explicit QQuickTurbulenceAffector(QQuickItem *parent = 0);
     ~QQuickTurbulenceAffector();
@@ -67,12 +69,19 @@ class QQuickTurbulenceAffector : public QQuickParticleAffector
     {
         return m_noiseSource;
     }
+
+    qreal period() const
+    {
+        return m_period;
+    }
 Q_SIGNALS:
 
     void strengthChanged(qreal arg);
 
     void noiseSourceChanged(QUrl arg);
 
+    void periodChanged(qreal arg);
+
 public Q_SLOTS:
 
     void setStrength(qreal arg)
@@ -92,19 +101,31 @@ public Q_SLOTS:
         }
     }
 
+    void setPeriod(qreal arg)
+    {
+        if (m_period != arg) {
+            m_period = arg;
+            Q_EMIT periodChanged(arg);
+        }
+    }
+
 protected:
     virtual void geometryChanged(const QRectF &newGeometry,
                                  const QRectF &oldGeometry);
+    virtual void affectBatch(QQuickParticleData *const *particles, bool *affected, int count, qreal dt);
 private:
     void ensureInit();
-    void mapUpdate();
     void initializeGrid();
-    qreal boundsRespectingField(int x, int y);
+    void initializeLayer();
     qreal m_strength;
-    qreal m_lastT;
+    qreal m_period;
     int m_gridSize;
-    qreal** m_field;
-    QPointF** m_vectorField;
+    int m_fieldSize;
+    QVector<float> m_fieldX;//Row major, m_fieldSize squared
+    QVector<float> m_fieldY;
+    QVector<float> m_layerX;//The field transposed, blended in over m_period
+    QVector<float> m_layerY;
+    qreal m_layerWeight;
     bool m_inited;
     QUrl m_noiseSource;
 };
@@ -45,6 +45,7 @@
 #include <QDebug>
 #include <private/qv4engine_p.h>
 #include <private/qv4functionobject_p.h>
+#include <private/qv4typedarray_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -533,4 +534,163 @@ QQmlV4Handle QQuickV4ParticleData::v4Value()
     return QQmlV4Handle(m_v4Value.value());
 }
 
+/*!
+    \qmltype ParticleColumns
+    \inqmlmodule QtQuick.Particles 2
+    \brief Represents a batch of particles as arrays of their attributes
+    \ingroup qtquick-particles
+
+    ParticleColumns objects are passed to the affectParticleColumns signal of Affector and
+    the emitParticleColumns signal of Emitter. Instead of one Particle object per particle,
+    they hold one Float32Array per attribute, with one entry per particle in the batch.
+    Changing an entry in place changes the attribute of that particle, without creating any
+    objects per particle.
+
+    The arrays are only valid during the signal handler.
+*/
+/*!
+    \qmlproperty int QtQuick.Particles::ParticleColumns::count
+    The number of particles in the batch, and the length of each array.
+*/
+/*!
+    \qmlproperty Float32Array QtQuick.Particles::ParticleColumns::x
+    \qmlproperty Float32Array QtQuick.Particles::ParticleColumns::y
+    The current position of each particle, as the x and y properties of Particle.
+*/
+/*!
+    \qmlproperty Float32Array QtQuick.Particles::ParticleColumns::vx
+    \qmlproperty Float32Array QtQuick.Particles::ParticleColumns::vy
+    The current velocity of each particle, as the vx and vy properties of Particle.
+*/
+/*!
+    \qmlproperty Float32Array QtQuick.Particles::ParticleColumns::ax
+    \qmlproperty Float32Array QtQuick.Particles::ParticleColumns::ay
+    The current acceleration of each particle, as the ax and ay properties of Particle.
+*/
+/*!
+    \qmlproperty Float32Array QtQuick.Particles::ParticleColumns::t
+    \qmlproperty Float32Array QtQuick.Particles::ParticleColumns::lifeSpan
+    \qmlproperty Float32Array QtQuick.Particles::ParticleColumns::startSize
+    \qmlproperty Float32Array QtQuick.Particles::ParticleColumns::endSize
+    \qmlproperty Float32Array QtQuick.Particles::ParticleColumns::rotation
+    \qmlproperty Float32Array QtQuick.Particles::ParticleColumns::rotationVelocity
+    The matching properties of Particle for each particle.
+*/
+
+static const char *const qquickParticleColumnNames[QQuickV4ParticleColumns::ColumnCount] = {
+    "x", "y", "vx", "vy", "ax", "ay",
+    "t", "lifeSpan", "startSize", "endSize",
+    "rotation", "rotationVelocity"
+};
+
+QQuickV4ParticleColumns::QQuickV4ParticleColumns(QV8Engine* engine, const QList<QQuickParticleData*> &particles)
+    : m_particles(particles)
+    , m_v4(QV8Engine::getV4(engine))
+{
+    QV4::Scope scope(m_v4);
+    QV4::ScopedObject o(scope, m_v4->newObject());
+    QV4::ScopedString s(scope);
+    QV4::ScopedValue v(scope);
+    for (int c = 0; c < ColumnCount; ++c) {
+        v = m_v4->newTypedArray(QV4::TypedArrayType_Float32, particles.size());
+        o->put((s = m_v4->newString(QLatin1String(qquickParticleColumnNames[c]))), v);
+        m_columns[c] = v;
+    }
+    o->put((s = m_v4->newString(QStringLiteral("count"))), (v = QV4::Primitive::fromInt32(particles.size())));
+    m_v4Value = o;
+}
+
+QQuickV4ParticleColumns::~QQuickV4ParticleColumns()
+{
+}
+
+QQmlV4Handle QQuickV4ParticleColumns::v4Value()
+{
+    return QQmlV4Handle(m_v4Value.value());
+}
+
+float *QQuickV4ParticleColumns::column(QV4::ExecutionEngine *v4, int c)
+{
+    QV4::Scope scope(v4);
+    QV4::Scoped<QV4::TypedArray> array(scope, m_columns[c].value());
+    if (!array || array->length() < uint(m_particles.size()))
+        return 0;
+    return reinterpret_cast<float *>(array->data());
+}
+
+/*
+    Fills the arrays from the particles, taking the current position, velocity and
+    acceleration at the system time. Call this before each time the arrays are handed
+    to JS.
+*/
+void QQuickV4ParticleColumns::load()
+{
+    const int count = m_particles.size();
+    m_loaded.resize(count * ColumnCount);
+    float *loaded = m_loaded.data();
+    for (int i = 0; i < count; ++i) {
+        QQuickParticleData *d = m_particles.at(i);
+        float *row = loaded + i * ColumnCount;
+        row[X] = d->curX();
+        row[Y] = d->curY();
+        row[VX] = d->curVX();
+        row[VY] = d->curVY();
+        row[AX] = d->curAX();
+        row[AY] = d->curAY();
+        row[T] = d->t;
+        row[LifeSpan] = d->lifeSpan;
+        row[StartSize] = d->size;
+        row[EndSize] = d->endSize;
+        row[Rotation] = d->rotation;
+        row[RotationVelocity] = d->rotationVelocity;
+    }
+    for (int c = 0; c < ColumnCount; ++c) {
+        float *data = column(m_v4, c);
+        if (!data)
+            continue;
+        for (int i = 0; i < count; ++i)
+            data[i] = loaded[i * ColumnCount + c];
+    }
+}
+
+/*
+    Writes the entries changed since load() back to the particles. If \a changed is
+    given, it is resized to the number of particles and marks the ones written to.
+*/
+void QQuickV4ParticleColumns::store(QVector<bool> *changed)
+{
+    const int count = m_particles.size();
+    if (changed)
+        changed->fill(false, count);
+    const float *loaded = m_loaded.constData();
+    for (int c = 0; c < ColumnCount; ++c) {
+        const float *data = column(m_v4, c);
+        if (!data)
+            continue;
+        for (int i = 0; i < count; ++i) {
+            float value = data[i];
+            if (value == loaded[i * ColumnCount + c])
+                continue;
+            QQuickParticleData *d = m_particles.at(i);
+            //Each instantaneous setter keeps the position and velocity written before it
+            switch (c) {
+            case X: d->setInstantaneousX(value); break;
+            case Y: d->setInstantaneousY(value); break;
+            case VX: d->setInstantaneousVX(value); break;
+            case VY: d->setInstantaneousVY(value); break;
+            case AX: d->setInstantaneousAX(value); break;
+            case AY: d->setInstantaneousAY(value); break;
+            case T: d->t = value; break;
+            case LifeSpan: d->lifeSpan = value; break;
+            case StartSize: d->size = value; break;
+            case EndSize: d->endSize = value; break;
+            case Rotation: d->rotation = value; break;
+            case RotationVelocity: d->rotationVelocity = value; break;
+            }
+            if (changed)
+                (*changed)[i] = true;
+        }
+    }
+}
+
 QT_END_NAMESPACE
@@ -46,6 +46,9 @@
 
 #include <private/qv4value_p.h>
 
+#include <QtCore/QList>
+#include <QtCore/QVector>
+
 QT_BEGIN_NAMESPACE
 
 class QQuickParticleData;
@@ -58,6 +61,32 @@ private:
     QV4::PersistentValue m_v4Value;
 };
 
+class QQuickV4ParticleColumns {
+public:
+    QQuickV4ParticleColumns(QV8Engine*, const QList<QQuickParticleData*> &particles);
+    ~QQuickV4ParticleColumns();
+    QQmlV4Handle v4Value();
+
+    void load();
+    void store(QVector<bool> *changed = 0);
+
+    enum Column {
+        X, Y, VX, VY, AX, AY,
+        T, LifeSpan, StartSize, EndSize,
+        Rotation, RotationVelocity,
+        ColumnCount
+    };
+
+private:
+    float *column(QV4::ExecutionEngine *v4, int c);
+
+    const QList<QQuickParticleData*> &m_particles;
+    QV4::ExecutionEngine *m_v4;
+    QV4::PersistentValue m_v4Value;
+    QV4::PersistentValue m_columns[ColumnCount];
+    QVector<float> m_loaded;//What load() wrote, to find the entries changed from JS
+};
+
 
 QT_END_NAMESPACE
 
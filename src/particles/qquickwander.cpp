@@ -86,6 +86,7 @@ QQuickWanderAffector::QQuickWanderAffector(QQuickItem *parent) :
     , m_affectedParameter(Velocity)
 {
     m_needsReset = true;
+    m_threadSafeBatch = true;
 }
 
 QQuickWanderAffector::~QQuickWanderAffector()
@@ -180,4 +181,12 @@ bool QQuickWanderAffector::affectParticle(QQuickParticleData* data, qreal dt)
     }
     return true;
 }
+
+void QQuickWanderAffector::affectBatch(QQuickParticleData *const *particles, bool *affected, int count, qreal dt)
+{
+    for (int i = 0; i < count; i++)
+        if (QQuickWanderAffector::affectParticle(particles[i], dt))
+            affected[i] = true;
+}
+
 QT_END_NAMESPACE
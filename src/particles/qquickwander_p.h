@@ -97,6 +97,7 @@ public:
 
 protected:
     virtual bool affectParticle(QQuickParticleData *d, qreal dt);
+    virtual void affectBatch(QQuickParticleData *const *particles, bool *affected, int count, qreal dt);
 Q_SIGNALS:
 
     void xVarianceChanged(qreal arg);
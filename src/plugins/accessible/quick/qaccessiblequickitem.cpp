@@ -53,8 +53,39 @@ QT_BEGIN_NAMESPACE
 #ifndef QT_NO_ACCESSIBILITY
 
 QAccessibleQuickItem::QAccessibleQuickItem(QQuickItem *item)
-    : QQmlAccessible(item), m_doc(textDocument())
+    : QQmlAccessible(item), m_doc(textDocument()), m_childItemsDirty(true), m_listening(true)
 {
+    QQuickItemPrivate::get(item)->addItemChangeListener(this, QQuickItemPrivate::Children | QQuickItemPrivate::Destroyed);
+}
+
+QAccessibleQuickItem::~QAccessibleQuickItem()
+{
+    if (m_listening)
+        QQuickItemPrivate::get(item())->removeItemChangeListener(this, QQuickItemPrivate::Children | QQuickItemPrivate::Destroyed);
+}
+
+void QAccessibleQuickItem::itemChildAdded(QQuickItem *, QQuickItem *)
+{
+    m_childItemsDirty = true;
+}
+
+void QAccessibleQuickItem::itemChildRemoved(QQuickItem *, QQuickItem *)
+{
+    m_childItemsDirty = true;
+}
+
+void QAccessibleQuickItem::itemAccessibleChildrenChanged(QQuickItem *)
+{
+    m_childItemsDirty = true;
+}
+
+void QAccessibleQuickItem::itemDestroyed(QQuickItem *)
+{
+    // The item is going away; the interface is deleted once the
+    // object's destroyed() signal reaches the accessibility cache.
+    m_listening = false;
+    m_childItems.clear();
+    m_childItemsDirty = false;
 }
 
 int QAccessibleQuickItem::childCount() const
@@ -111,7 +142,7 @@ QAccessibleInterface *QAccessibleQuickItem::parent() const
 
 QAccessibleInterface *QAccessibleQuickItem::child(int index) const
 {
-    QList<QQuickItem *> children = childItems();
+    const QList<QQuickItem *> children = childItems();
 
     if (index < 0 || index >= children.count())
         return 0;
@@ -125,7 +156,7 @@ QAccessibleInterface *QAccessibleQuickItem::child(int index) const
 
 int QAccessibleQuickItem::indexOfChild(const QAccessibleInterface *iface) const
 {
-    QList<QQuickItem*> kids = childItems();
+    const QList<QQuickItem*> kids = childItems();
     return kids.indexOf(static_cast<QQuickItem*>(iface->object()));
 }
 
@@ -141,13 +172,18 @@ QList<QQuickItem *> QAccessibleQuickItem::childItems() const
             role() == QAccessible::ProgressBar)
         return QList<QQuickItem *>();
 
-    QList<QQuickItem *> items;
-    Q_FOREACH (QQuickItem *child, item()->childItems()) {
-        QQuickItemPrivate *itemPrivate = QQuickItemPrivate::get(child);
-        if (itemPrivate->isAccessible)
-            items.append(child);
+    // Screen readers walk the tree often; the filtered list is kept until
+    // the item reports a change to its children.
+    if (m_childItemsDirty) {
+        m_childItems.clear();
+        Q_FOREACH (QQuickItem *child, item()->childItems()) {
+            QQuickItemPrivate *itemPrivate = QQuickItemPrivate::get(child);
+            if (itemPrivate->isAccessible)
+                m_childItems.append(child);
+        }
+        m_childItemsDirty = false;
     }
-    return items;
+    return m_childItems;
 }
 
 QAccessible::State QAccessibleQuickItem::state() const
@@ -44,6 +44,7 @@
 
 #include <QtQuick/QQuickItem>
 #include <QtQuick/QQuickView>
+#include <QtQuick/private/qquickitemchangelistener_p.h>
 #include "qqmlaccessible.h"
 
 QT_BEGIN_NAMESPACE
@@ -52,10 +53,12 @@ QT_BEGIN_NAMESPACE
 
 class QTextDocument;
 
-class QAccessibleQuickItem : public QQmlAccessible, public QAccessibleValueInterface, public QAccessibleTextInterface
+class QAccessibleQuickItem : public QQmlAccessible, public QAccessibleValueInterface, public QAccessibleTextInterface,
+                             public QQuickItemChangeListener
 {
 public:
     QAccessibleQuickItem(QQuickItem *item);
+    ~QAccessibleQuickItem();
 
     QRect rect() const;
     QRect viewRect() const;
@@ -116,8 +119,17 @@ protected:
     QQuickItem *item() const { return static_cast<QQuickItem*>(object()); }
     void *interface_cast(QAccessible::InterfaceType t);
 
+    // QQuickItemChangeListener
+    void itemChildAdded(QQuickItem *, QQuickItem *);
+    void itemChildRemoved(QQuickItem *, QQuickItem *);
+    void itemAccessibleChildrenChanged(QQuickItem *);
+    void itemDestroyed(QQuickItem *);
+
 private:
     QTextDocument *m_doc;
+    mutable QList<QQuickItem *> m_childItems;
+    mutable bool m_childItemsDirty;
+    bool m_listening;
 };
 
 QRect itemScreenRect(QQuickItem *item);
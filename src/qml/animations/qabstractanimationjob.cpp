@@ -61,6 +61,10 @@ QAnimationJobChangeListener::~QAnimationJobChangeListener()
 {
 }
 
+QQmlAnimationTickListener::~QQmlAnimationTickListener()
+{
+}
+
 QQmlAnimationTimer::QQmlAnimationTimer() :
     QAbstractAnimationTimer(), lastTick(0),
     currentAnimationIdx(0), insideTick(false),
@@ -125,9 +129,23 @@ void QQmlAnimationTimer::updateAnimationsTime(qint64 delta)
         }
         insideTick = false;
         currentAnimationIdx = 0;
+
+        for (int i = 0; i < tickListeners.count(); ++i)
+            tickListeners.at(i)->animationTickFinished();
     }
 }
 
+void QQmlAnimationTimer::addTickListener(QQmlAnimationTickListener *listener)
+{
+    if (!tickListeners.contains(listener))
+        tickListeners.append(listener);
+}
+
+void QQmlAnimationTimer::removeTickListener(QQmlAnimationTickListener *listener)
+{
+    tickListeners.removeOne(listener);
+}
+
 void QQmlAnimationTimer::updateAnimationTimer()
 {
     QQmlAnimationTimer *inst = QQmlAnimationTimer::instance(false);
@@ -184,6 +184,13 @@ public:
     virtual void animationCurrentTimeChanged(QAbstractAnimationJob *, int) {}
 };
 
+class Q_QML_PRIVATE_EXPORT QQmlAnimationTickListener
+{
+public:
+    virtual ~QQmlAnimationTickListener();
+    virtual void animationTickFinished() = 0;
+};
+
 class Q_QML_PRIVATE_EXPORT QQmlAnimationTimer : public QAbstractAnimationTimer
 {
     Q_OBJECT
@@ -212,6 +219,14 @@ public:
     void restartAnimationTimer();
     void updateAnimationsTime(qint64 timeStep);
 
+    /*
+        listeners are notified once all running animations have been advanced
+        for a tick, which lets them apply work collected during the tick in bulk.
+    */
+    void addTickListener(QQmlAnimationTickListener *listener);
+    void removeTickListener(QQmlAnimationTickListener *listener);
+    bool isTicking() const { return insideTick; }
+
     //useful for profiling/debugging
     int runningAnimationCount() { return animations.count(); }
 
@@ -229,6 +244,7 @@ private:
     bool stopTimerPending;
 
     QList<QAbstractAnimationJob*> animations, animationsToStart;
+    QList<QQmlAnimationTickListener*> tickListeners;
 
     // this is the count of running animations that are not a group neither a pause animation
     int runningLeafAnimations;
@@ -1670,7 +1670,6 @@ JSCodeGen::JSCodeGen(const QString &fileName, const QString &sourceCode, QV4::IR
     , _contextObjectTemp(-1)
     , _scopeObjectTemp(-1)
     , _importedScriptsTemp(-1)
-    , _idArrayTemp(-1)
 {
     _module = jsModule;
     _module->setFileName(fileName);
@@ -1968,7 +1967,6 @@ void JSCodeGen::beginFunctionBodyHook()
     _contextObjectTemp = _block->newTemp();
     _scopeObjectTemp = _block->newTemp();
     _importedScriptsTemp = _block->newTemp();
-    _idArrayTemp = _block->newTemp();
 
 #ifndef V4_BOOTSTRAP
     QV4::IR::Temp *temp = _block->TEMP(_contextObjectTemp);
@@ -1980,7 +1978,6 @@ void JSCodeGen::beginFunctionBodyHook()
     move(temp, _block->NAME(QV4::IR::Name::builtin_qml_scope_object, 0, 0));
 
     move(_block->TEMP(_importedScriptsTemp), _block->NAME(QV4::IR::Name::builtin_qml_imported_scripts_object, 0, 0));
-    move(_block->TEMP(_idArrayTemp), _block->NAME(QV4::IR::Name::builtin_qml_id_array, 0, 0));
 #endif
 }
 
@@ -2006,7 +2003,9 @@ QV4::IR::Expr *JSCodeGen::fallbackNameLookup(const QString &name, int line, int
     foreach (const IdMapping &mapping, _idObjects)
         if (name == mapping.name) {
             _function->idObjectDependencies.insert(mapping.idIndex);
-            QV4::IR::Expr *s = subscript(_block->TEMP(_idArrayTemp), _block->CONST(QV4::IR::SInt32Type, mapping.idIndex));
+            // Load the object straight from the context's id values
+            QV4::IR::Name *s = _block->NAME(QV4::IR::Name::builtin_qml_id_object, line, col);
+            s->idObjectIndex = mapping.idIndex;
             QV4::IR::Temp *result = _block->TEMP(_block->newTemp());
             _block->MOVE(result, s);
             result = _block->TEMP(result->index);
@@ -494,7 +494,6 @@ private:
     int _contextObjectTemp;
     int _scopeObjectTemp;
     int _importedScriptsTemp;
-    int _idArrayTemp;
 };
 
 } // namespace QmlIR
@@ -41,6 +41,9 @@
 
 #include "qqmltypecompiler_p.h"
 
+#include <QtCore/qdatastream.h>
+#include <QtCore/qnumeric.h>
+
 #include <private/qqmlirbuilder_p.h>
 #include <private/qqmlobjectcreator_p.h>
 #include <private/qqmlcustomparser_p.h>
@@ -48,6 +51,11 @@
 #include <private/qqmlcomponent_p.h>
 #include <private/qqmlstringconverters_p.h>
 #include <private/qv4ssa_p.h>
+#include <private/qqmlglobal_p.h>
+
+#include <limits.h>
+
+DEFINE_BOOL_CONFIG_OPTION(qmlDisableBindingPrograms, QML_DISABLE_BINDING_PROGRAMS)
 
 #define COMPILE_EXCEPTION(token, desc) \
     { \
@@ -215,14 +223,23 @@ bool QQmlTypeCompiler::compile()
             sss.scan();
         }
 
-        QmlIR::JSCodeGen v4CodeGenerator(typeData->finalUrlString(), document->code, &document->jsModule, &document->jsParserEngine, document->program, compiledData->importCache, &document->jsGenerator.stringTable);
-        QQmlJSCodeGenerator jsCodeGen(this, &v4CodeGenerator);
-        if (!jsCodeGen.generateCodeForComponents())
-            return false;
+        {
+            QQmlLoadPhaseTimer phase(typeData->typeLoader(), QQmlDataLoader::IRBuilding);
+            QmlIR::JSCodeGen v4CodeGenerator(typeData->finalUrlString(), document->code, &document->jsModule, &document->jsParserEngine, document->program, compiledData->importCache, &document->jsGenerator.stringTable);
+            QQmlJSCodeGenerator jsCodeGen(this, &v4CodeGenerator);
+            if (!jsCodeGen.generateCodeForComponents())
+                return false;
 
-        QQmlJavaScriptBindingExpressionSimplificationPass pass(this);
-        pass.reduceTranslationBindings();
+            QQmlJavaScriptBindingExpressionSimplificationPass pass(this);
+            pass.simplifyBindings();
 
+            if (!engine->isDebugging && !qmlDisableBindingPrograms()) {
+                QQmlBindingProgramCompiler programCompiler(this);
+                compiledData->bindingPrograms = programCompiler.compile();
+            }
+        }
+
+        QQmlLoadPhaseTimer phase(typeData->typeLoader(), QQmlDataLoader::CodeGeneration);
         QV4::ExecutionEngine *v4 = engine->v4engine();
         QScopedPointer<QV4::EvalInstructionSelection> isel(v4->iselFactory->create(engine, v4->executableAllocator, &document->jsModule, &document->jsGenerator));
         isel->setUseFastLookups(false);
@@ -626,6 +643,10 @@ bool QQmlPropertyCacheCreator::createMetaObject(int objectIndex, const QmlIR::Ob
 
     cache->_dynamicClassName = newClassName;
 
+    // Describes the members appended to the base type cache, see the end
+    QByteArray signature;
+    QDataStream signatureStream(&signature, QIODevice::WriteOnly);
+
     int aliasCount = 0;
     int varPropCount = 0;
 
@@ -698,6 +719,7 @@ bool QQmlPropertyCacheCreator::createMetaObject(int objectIndex, const QmlIR::Ob
             seenSignals.insert(changedSigName);
 
             cache->appendSignal(changedSigName, flags, effectiveMethodIndex++);
+            signatureStream << changedSigName << flags;
         }
     }
 
@@ -756,6 +778,9 @@ bool QQmlPropertyCacheCreator::createMetaObject(int objectIndex, const QmlIR::Ob
 
         cache->appendSignal(signalName, flags, effectiveMethodIndex++,
                             paramCount?paramTypes.constData():0, names);
+        signatureStream << signalName << flags << names;
+        for (int i = 1; i < paramTypes.count(); ++i)
+            signatureStream << paramTypes.at(i);
     }
 
 
@@ -782,6 +807,7 @@ bool QQmlPropertyCacheCreator::createMetaObject(int objectIndex, const QmlIR::Ob
         }
 
         cache->appendMethod(slotName, flags, effectiveMethodIndex++, parameterNames);
+        signatureStream << slotName << flags << parameterNames;
     }
 
 
@@ -848,17 +874,21 @@ bool QQmlPropertyCacheCreator::createMetaObject(int objectIndex, const QmlIR::Ob
 
         if ((!p->flags & QV4::CompiledData::Property::IsReadOnly) && p->type != QV4::CompiledData::Property::CustomList)
             propertyFlags |= QQmlPropertyData::IsWritable;
+        propertyFlags |= QQmlPropertyData::IsVMEProperty;
 
 
         QString propertyName = stringAt(p->nameIndex);
         if (propertyIdx == obj->indexOfDefaultProperty) cache->_defaultPropertyName = propertyName;
         cache->appendProperty(propertyName, propertyFlags, effectivePropertyIndex++,
                               propertyType, effectiveSignalIndex);
+        signatureStream << propertyName << propertyFlags << propertyType;
 
         effectiveSignalIndex++;
 
         VMD *vmd = (QQmlVMEMetaData *)dynamicData.data();
-        (vmd->propertyData() + vmd->propertyCount)->propertyType = vmePropertyType;
+        VMD::PropertyData *propertyData = vmd->propertyData() + vmd->propertyCount;
+        propertyData->propertyType = vmePropertyType;
+        propertyData->storageOffset = vmd->allocateStorage(vmePropertyType);
         vmd->propertyCount++;
     }
 
@@ -882,6 +912,7 @@ bool QQmlPropertyCacheCreator::createMetaObject(int objectIndex, const QmlIR::Ob
         if (propertyIdx == obj->indexOfDefaultProperty) cache->_defaultPropertyName = propertyName;
         cache->appendProperty(propertyName, propertyFlags, effectivePropertyIndex++,
                               QMetaType::QVariant, effectiveSignalIndex);
+        signatureStream << propertyName << propertyFlags;
 
         effectiveSignalIndex++;
     }
@@ -909,6 +940,14 @@ bool QQmlPropertyCacheCreator::createMetaObject(int objectIndex, const QmlIR::Ob
         md = methodData;
     }
 
+    // Objects declaring the same members on the same base type share one
+    // cache. Aliases are resolved into the cache later, and the root object
+    // keeps its own cache because its class name identifies the type.
+    if (aliasCount == 0 && objectIndex != compiler->rootObjectIndex()) {
+        signatureStream << cache->_defaultPropertyName;
+        propertyCaches[objectIndex] = enginePrivate->sharedDerivedCache(baseTypeCache, signature, cache);
+    }
+
     return true;
 }
 
@@ -2574,32 +2613,49 @@ void QQmlDefaultPropertyMerger::mergeDefaultProperties(int objectIndex)
 QQmlJavaScriptBindingExpressionSimplificationPass::QQmlJavaScriptBindingExpressionSimplificationPass(QQmlTypeCompiler *typeCompiler)
     : QQmlCompilePass(typeCompiler)
     , qmlObjects(*typeCompiler->qmlObjects())
+    , propertyCaches(typeCompiler->propertyCaches())
+    , customParsers(typeCompiler->customParserCache())
     , jsModule(typeCompiler->jsIRModule())
 {
 
 }
 
-void QQmlJavaScriptBindingExpressionSimplificationPass::reduceTranslationBindings()
+void QQmlJavaScriptBindingExpressionSimplificationPass::simplifyBindings()
 {
     for (int i = 0; i < qmlObjects.count(); ++i)
-        reduceTranslationBindings(i);
+        simplifyBindings(i);
     if (!irFunctionsToRemove.isEmpty()) {
         QQmlIRFunctionCleanser cleanser(compiler, irFunctionsToRemove);
         cleanser.clean();
     }
 }
 
-void QQmlJavaScriptBindingExpressionSimplificationPass::reduceTranslationBindings(int objectIndex)
+void QQmlJavaScriptBindingExpressionSimplificationPass::simplifyBindings(int objectIndex)
 {
     const QmlIR::Object *obj = qmlObjects.at(objectIndex);
 
+    // Constant expressions are only turned into literals when we know the type of
+    // the property they are assigned to. Custom parsers interpret bindings themselves.
+    QQmlPropertyCache *propertyCache = propertyCaches.at(objectIndex);
+    if (customParsers.contains(obj->inheritedTypeNameIndex))
+        propertyCache = 0;
+    QmlIR::PropertyResolver resolver(propertyCache);
+
     for (QmlIR::Binding *binding = obj->firstBinding(); binding; binding = binding->next) {
         if (binding->type != QV4::CompiledData::Binding::Type_Script)
             continue;
 
+        const QQmlPropertyData *property = 0;
+        if (propertyCache && binding->propertyNameIndex != 0
+            && !(binding->flags & (QV4::CompiledData::Binding::IsSignalHandlerExpression
+                                   | QV4::CompiledData::Binding::IsBindingToAlias))) {
+            bool notInRevision = false;
+            property = resolver.property(stringAt(binding->propertyNameIndex), &notInRevision);
+        }
+
         const int irFunctionIndex = obj->runtimeFunctionIndices->at(binding->value.compiledScriptIndex);
         QV4::IR::Function *irFunction = jsModule->functions.at(irFunctionIndex);
-        if (simplifyBinding(irFunction, binding)) {
+        if (simplifyBinding(irFunction, property, binding)) {
             irFunctionsToRemove.append(irFunctionIndex);
             jsModule->functions[irFunctionIndex] = 0;
             delete irFunction;
@@ -2627,8 +2683,7 @@ void QQmlJavaScriptBindingExpressionSimplificationPass::visitMove(QV4::IR::Move
     }
 
     if (QV4::IR::Name *n = move->source->asName()) {
-        if (n->builtin == QV4::IR::Name::builtin_qml_id_array
-            || n->builtin == QV4::IR::Name::builtin_qml_imported_scripts_object
+        if (n->builtin == QV4::IR::Name::builtin_qml_imported_scripts_object
             || n->builtin == QV4::IR::Name::builtin_qml_context_object
             || n->builtin == QV4::IR::Name::builtin_qml_scope_object) {
             // these are free of side-effects
@@ -2643,6 +2698,8 @@ void QQmlJavaScriptBindingExpressionSimplificationPass::visitMove(QV4::IR::Move
         return;
     }
 
+    if (_temps.contains(target->index))
+        _hasReassignedTemps = true;
     _temps[target->index] = move->source;
 }
 
@@ -2693,9 +2750,10 @@ void QQmlJavaScriptBindingExpressionSimplificationPass::visitRet(QV4::IR::Ret *r
     _returnValueOfBindingExpression = target->index;
 }
 
-bool QQmlJavaScriptBindingExpressionSimplificationPass::simplifyBinding(QV4::IR::Function *function, QmlIR::Binding *binding)
+bool QQmlJavaScriptBindingExpressionSimplificationPass::simplifyBinding(QV4::IR::Function *function, const QQmlPropertyData *property, QmlIR::Binding *binding)
 {
     _canSimplify = true;
+    _hasReassignedTemps = false;
     _nameOfFunctionCalled = 0;
     _functionParameters.clear();
     _functionCallReturnValue = -1;
@@ -2727,6 +2785,7 @@ bool QQmlJavaScriptBindingExpressionSimplificationPass::simplifyBinding(QV4::IR:
                 return false;
             return detectTranslationCallAndConvertBinding(binding);
         }
+        return convertConstantExpressionBinding(property, binding);
     }
 
     return false;
@@ -2852,6 +2911,73 @@ bool QQmlJavaScriptBindingExpressionSimplificationPass::detectTranslationCallAnd
     return false;
 }
 
+bool QQmlJavaScriptBindingExpressionSimplificationPass::convertConstantExpressionBinding(const QQmlPropertyData *property, QmlIR::Binding *binding)
+{
+    // A temp assigned in more than one place may depend on control flow.
+    if (!property || _hasReassignedTemps)
+        return false;
+
+    if (property->isEnum() || property->isQList())
+        return false;
+
+    QV4::IR::Expr *value = _temps.value(_returnValueOfBindingExpression);
+    for (int i = 0; value && value->asTemp() && i < _temps.count(); ++i) {
+        QV4::IR::Temp *temp = value->asTemp();
+        if (temp->kind != QV4::IR::Temp::VirtualRegister)
+            return false;
+        value = _temps.value(temp->index);
+    }
+    if (!value)
+        return false;
+
+    // Only convert when the literal is accepted by the property exactly like the
+    // result of the expression would be, see QQmlPropertyValidator::validateLiteralBinding.
+    if (QV4::IR::Const *c = value->asConst()) {
+        if (c->type == QV4::IR::BoolType) {
+            if (property->propType != QMetaType::Bool)
+                return false;
+            binding->type = QV4::CompiledData::Binding::Type_Boolean;
+            binding->value.b = c->value != 0;
+            return true;
+        }
+
+        if (!(c->type & QV4::IR::NumberType))
+            return false;
+
+        // Converting NaN or a value out of range to an integer is undefined, so those
+        // are ruled out before the cast.
+        switch (property->propType) {
+        case QMetaType::Int:
+            if (!qIsFinite(c->value) || c->value < INT_MIN || c->value > INT_MAX
+                    || double(int(c->value)) != c->value)
+                return false;
+            break;
+        case QMetaType::UInt:
+            if (!qIsFinite(c->value) || c->value < 0 || c->value > UINT_MAX
+                    || double(uint(c->value)) != c->value)
+                return false;
+            break;
+        case QMetaType::Double:
+        case QMetaType::Float:
+            break;
+        default:
+            return false;
+        }
+
+        binding->type = QV4::CompiledData::Binding::Type_Number;
+        binding->value.d = c->value;
+        return true;
+    } else if (QV4::IR::String *s = value->asString()) {
+        if (property->propType != QMetaType::QString)
+            return false;
+        binding->type = QV4::CompiledData::Binding::Type_String;
+        binding->stringIndex = compiler->registerString(*s->value);
+        return true;
+    }
+
+    return false;
+}
+
 QQmlIRFunctionCleanser::QQmlIRFunctionCleanser(QQmlTypeCompiler *typeCompiler, const QVector<int> &functionsToRemove)
     : QQmlCompilePass(typeCompiler)
     , module(typeCompiler->jsIRModule())
@@ -2898,4 +3024,318 @@ void QQmlIRFunctionCleanser::visitClosure(QV4::IR::Closure *closure)
     closure->value = newFunctionIndices.at(closure->value);
 }
 
+QQmlBindingProgramCompiler::QQmlBindingProgramCompiler(QQmlTypeCompiler *typeCompiler)
+    : QQmlCompilePass(typeCompiler)
+    , qmlObjects(*typeCompiler->qmlObjects())
+    , jsModule(typeCompiler->jsIRModule())
+    , program(0)
+    , currentBlock(0)
+    , nextScratchRegister(0)
+{
+}
+
+QVector<QQmlBindingProgram *> QQmlBindingProgramCompiler::compile()
+{
+    QVector<QQmlBindingProgram *> programs;
+
+    for (int i = 0; i < qmlObjects.count(); ++i) {
+        const QmlIR::Object *obj = qmlObjects.at(i);
+        if (!obj->runtimeFunctionIndices)
+            continue;
+
+        for (QmlIR::Binding *binding = obj->firstBinding(); binding; binding = binding->next) {
+            if (binding->type != QV4::CompiledData::Binding::Type_Script
+                || binding->flags & QV4::CompiledData::Binding::IsSignalHandlerExpression)
+                continue;
+
+            const int functionIndex = obj->runtimeFunctionIndices->at(binding->value.compiledScriptIndex);
+            QV4::IR::Function *function = jsModule->functions.at(functionIndex);
+            if (!function || (functionIndex < programs.count() && programs.at(functionIndex)))
+                continue;
+
+            if (QQmlBindingProgram *compiled = compileFunction(function)) {
+                if (programs.count() <= functionIndex)
+                    programs.resize(functionIndex + 1);
+                programs[functionIndex] = compiled;
+            }
+        }
+    }
+
+    return programs;
+}
+
+QQmlBindingProgram *QQmlBindingProgramCompiler::compileFunction(QV4::IR::Function *function)
+{
+    // Anything beyond an expression reading properties is left to the function.
+    if (function->hasTry || function->hasWith || function->hasDirectEval
+        || function->usesArgumentsObject || function->insideWithOrCatch
+        || !function->formals.isEmpty() || !function->locals.isEmpty()
+        || !function->nestedFunctions.isEmpty())
+        return 0;
+
+    blockOrder.clear();
+    foreach (QV4::IR::BasicBlock *bb, function->basicBlocks()) {
+        if (bb->isRemoved())
+            continue;
+        if (bb->catchBlock)
+            return 0;
+        blockOrder.insert(bb, blockOrder.count());
+    }
+    if (blockOrder.count() > 16)
+        return 0;
+
+    program = new QQmlBindingProgram;
+    nextScratchRegister = function->tempCount;
+    blockStart.fill(0, blockOrder.count());
+    trueTargets.clear();
+    falseTargets.clear();
+    builtinTemps.clear();
+
+    bool ok = true;
+    currentBlock = 0;
+    foreach (QV4::IR::BasicBlock *bb, function->basicBlocks()) {
+        if (bb->isRemoved())
+            continue;
+        blockStart[currentBlock] = program->instructions.count();
+        foreach (QV4::IR::Stmt *s, bb->statements()) {
+            if (!compileStatement(s)) {
+                ok = false;
+                break;
+            }
+        }
+        if (!ok)
+            break;
+        ++currentBlock;
+    }
+
+    // Registers and jump targets are stored in 16 bits.
+    if (nextScratchRegister > 0xffff || program->instructions.count() > 0xffff)
+        ok = false;
+
+    if (!ok) {
+        program->release();
+        program = 0;
+        return 0;
+    }
+
+    for (int i = 0; i < trueTargets.count(); ++i)
+        program->instructions[trueTargets.at(i).first].index = blockStart.at(blockOrder.value(trueTargets.at(i).second));
+    for (int i = 0; i < falseTargets.count(); ++i)
+        program->instructions[falseTargets.at(i).first].b = blockStart.at(blockOrder.value(falseTargets.at(i).second));
+    program->registerCount = nextScratchRegister;
+
+    QQmlBindingProgram *result = program;
+    program = 0;
+    return result;
+}
+
+bool QQmlBindingProgramCompiler::compileStatement(QV4::IR::Stmt *s)
+{
+    if (QV4::IR::Move *move = s->asMove())
+        return compileMove(move);
+
+    if (QV4::IR::Jump *jump = s->asJump()) {
+        addInstruction(QQmlBindingProgram::Jump);
+        return jumpTo(jump->target);
+    }
+
+    if (QV4::IR::CJump *cjump = s->asCJump()) {
+        const int condition = operand(cjump->cond);
+        if (condition == -1)
+            return false;
+        addInstruction(QQmlBindingProgram::CJump, 0, condition);
+        return jumpTo(cjump->iftrue) && jumpTo(cjump->iffalse, /*falseTarget*/true);
+    }
+
+    if (QV4::IR::Ret *ret = s->asRet()) {
+        const int value = operand(ret->expr);
+        if (value == -1)
+            return false;
+        addInstruction(QQmlBindingProgram::Ret, 0, value);
+        return true;
+    }
+
+    return false;
+}
+
+bool QQmlBindingProgramCompiler::compileMove(QV4::IR::Move *move)
+{
+    QV4::IR::Temp *target = move->target->asTemp();
+    if (!target || target->kind != QV4::IR::Temp::VirtualRegister || move->swap)
+        return false;
+
+    builtinTemps.remove(target->index);
+
+    if (QV4::IR::Name *n = move->source->asName()) {
+        switch (n->builtin) {
+        case QV4::IR::Name::builtin_qml_scope_object:
+            addInstruction(QQmlBindingProgram::LoadScopeObject, target->index);
+            return true;
+        case QV4::IR::Name::builtin_qml_context_object:
+            addInstruction(QQmlBindingProgram::LoadContextObject, target->index);
+            return true;
+        case QV4::IR::Name::builtin_qml_id_object:
+            addInstruction(QQmlBindingProgram::LoadIdObject, target->index, 0, 0, n->idObjectIndex);
+            return true;
+        case QV4::IR::Name::builtin_qml_imported_scripts_object:
+            // Not usable by binding programs, see temp().
+            builtinTemps.insert(target->index, n->builtin);
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    return compileExpression(move->source, target->index);
+}
+
+bool QQmlBindingProgramCompiler::compileExpression(QV4::IR::Expr *e, int result)
+{
+    if (e->asTemp()) {
+        const int source = temp(e);
+        if (source == -1)
+            return false;
+        if (source != result)
+            addInstruction(QQmlBindingProgram::Move, result, source);
+        return true;
+    }
+
+    if (QV4::IR::Const *c = e->asConst())
+        return compileConst(c, result);
+
+    if (QV4::IR::String *s = e->asString()) {
+        addInstruction(QQmlBindingProgram::LoadString, result, 0, 0, string(*s->value));
+        return true;
+    }
+
+    if (QV4::IR::Unop *unop = e->asUnop()) {
+        switch (unop->op) {
+        case QV4::IR::OpIfTrue:
+        case QV4::IR::OpNot:
+        case QV4::IR::OpUMinus:
+        case QV4::IR::OpUPlus:
+        case QV4::IR::OpCompl:
+            break;
+        default:
+            return false;
+        }
+        const int a = operand(unop->expr);
+        if (a == -1)
+            return false;
+        addInstruction(QQmlBindingProgram::Unop, result, a, 0, 0, unop->op);
+        return true;
+    }
+
+    if (QV4::IR::Binop *binop = e->asBinop()) {
+        // instanceof, in and the logical operators are not supported.
+        if (binop->op < QV4::IR::OpBitAnd || binop->op > QV4::IR::OpStrictNotEqual)
+            return false;
+        const int a = operand(binop->left);
+        const int b = a == -1 ? -1 : operand(binop->right);
+        if (b == -1)
+            return false;
+        addInstruction(QQmlBindingProgram::Binop, result, a, b, 0, binop->op);
+        return true;
+    }
+
+    if (QV4::IR::Member *member = e->asMember()) {
+        if (member->kind == QV4::IR::Member::MemberOfEnum) {
+            addInstruction(QQmlBindingProgram::LoadNumber, result, 0, 0, program->numbers.count());
+            program->numbers.append(member->attachedPropertiesIdOrEnumValue);
+            return true;
+        }
+        if (member->attachedPropertiesIdOrEnumValue != 0)
+            return false;
+        const int base = temp(member->base);
+        if (base == -1)
+            return false;
+        if (member->property && !member->property->isFunction())
+            addInstruction(QQmlBindingProgram::LoadProperty, result, base, 0, member->property->coreIndex);
+        else
+            addInstruction(QQmlBindingProgram::LoadNamedProperty, result, base, 0, string(*member->name));
+        return true;
+    }
+
+    return false;
+}
+
+bool QQmlBindingProgramCompiler::compileConst(QV4::IR::Const *c, int result)
+{
+    switch (c->type) {
+    case QV4::IR::UndefinedType:
+        addInstruction(QQmlBindingProgram::LoadUndefined, result);
+        return true;
+    case QV4::IR::NullType:
+        addInstruction(QQmlBindingProgram::LoadNull, result);
+        return true;
+    case QV4::IR::BoolType:
+        addInstruction(QQmlBindingProgram::LoadBool, result, 0, 0, c->value != 0);
+        return true;
+    case QV4::IR::SInt32Type:
+    case QV4::IR::UInt32Type:
+    case QV4::IR::DoubleType:
+    case QV4::IR::NumberType:
+        addInstruction(QQmlBindingProgram::LoadNumber, result, 0, 0, program->numbers.count());
+        program->numbers.append(c->value);
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Returns the register holding the value of \a e, loading constants into
+// a scratch register.  Returns -1 if the expression is not supported.
+int QQmlBindingProgramCompiler::operand(QV4::IR::Expr *e)
+{
+    if (e->asTemp())
+        return temp(e);
+    const int scratch = nextScratchRegister++;
+    return compileExpression(e, scratch) ? scratch : -1;
+}
+
+int QQmlBindingProgramCompiler::temp(QV4::IR::Expr *e) const
+{
+    QV4::IR::Temp *t = e->asTemp();
+    if (!t || t->kind != QV4::IR::Temp::VirtualRegister || builtinTemps.contains(t->index))
+        return -1;
+    return t->index;
+}
+
+int QQmlBindingProgramCompiler::string(const QString &s)
+{
+    int index = program->strings.indexOf(s);
+    if (index == -1) {
+        index = program->strings.count();
+        program->strings.append(s);
+    }
+    return index;
+}
+
+void QQmlBindingProgramCompiler::addInstruction(QQmlBindingProgram::Opcode opcode, int result, int a, int b,
+                                                int index, int aluOp)
+{
+    QQmlBindingProgram::Instruction i;
+    i.opcode = opcode;
+    i.aluOp = aluOp;
+    i.result = result;
+    i.a = a;
+    i.b = b;
+    i.index = index;
+    program->instructions.append(i);
+}
+
+// Programs only jump forward, which rules out loops.
+bool QQmlBindingProgramCompiler::jumpTo(QV4::IR::BasicBlock *target, bool falseTarget)
+{
+    QHash<QV4::IR::BasicBlock *, int>::ConstIterator it = blockOrder.constFind(target);
+    if (it == blockOrder.constEnd() || *it <= currentBlock)
+        return false;
+    const int instruction = program->instructions.count() - 1;
+    if (falseTarget)
+        falseTargets.append(qMakePair(instruction, target));
+    else
+        trueTargets.append(qMakePair(instruction, target));
+    return true;
+}
+
 QT_END_NAMESPACE
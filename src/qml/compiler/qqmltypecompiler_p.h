@@ -348,10 +348,10 @@ class QQmlJavaScriptBindingExpressionSimplificationPass : public QQmlCompilePass
 public:
     QQmlJavaScriptBindingExpressionSimplificationPass(QQmlTypeCompiler *typeCompiler);
 
-    void reduceTranslationBindings();
+    void simplifyBindings();
 
 private:
-    void reduceTranslationBindings(int objectIndex);
+    void simplifyBindings(int objectIndex);
 
     virtual void visitMove(QV4::IR::Move *move);
     virtual void visitJump(QV4::IR::Jump *) {}
@@ -364,13 +364,17 @@ private:
 
     void discard() { _canSimplify = false; }
 
-    bool simplifyBinding(QV4::IR::Function *function, QmlIR::Binding *binding);
+    bool simplifyBinding(QV4::IR::Function *function, const QQmlPropertyData *property, QmlIR::Binding *binding);
     bool detectTranslationCallAndConvertBinding(QmlIR::Binding *binding);
+    bool convertConstantExpressionBinding(const QQmlPropertyData *property, QmlIR::Binding *binding);
 
     const QList<QmlIR::Object*> &qmlObjects;
+    const QVector<QQmlPropertyCache *> &propertyCaches;
+    const QHash<int, QQmlCustomParser*> &customParsers;
     QV4::IR::Module *jsModule;
 
     bool _canSimplify;
+    bool _hasReassignedTemps;
     const QString *_nameOfFunctionCalled;
     QVector<int> _functionParameters;
     int _functionCallReturnValue;
@@ -443,6 +447,43 @@ private:
     QVector<int> newFunctionIndices;
 };
 
+// Translates binding functions that only read properties and combine them
+// with operators into QQmlBindingProgram instances, see qqmlbindingprogram_p.h.
+class QQmlBindingProgramCompiler : public QQmlCompilePass
+{
+public:
+    QQmlBindingProgramCompiler(QQmlTypeCompiler *typeCompiler);
+
+    // Index is the runtime function index, functions that can't be
+    // translated have no program.
+    QVector<QQmlBindingProgram *> compile();
+
+private:
+    QQmlBindingProgram *compileFunction(QV4::IR::Function *function);
+    bool compileStatement(QV4::IR::Stmt *s);
+    bool compileMove(QV4::IR::Move *move);
+    bool compileExpression(QV4::IR::Expr *e, int result);
+    bool compileConst(QV4::IR::Const *c, int result);
+    int operand(QV4::IR::Expr *e);
+    int temp(QV4::IR::Expr *e) const;
+    int string(const QString &s);
+    void addInstruction(QQmlBindingProgram::Opcode opcode, int result = 0, int a = 0, int b = 0,
+                        int index = 0, int aluOp = 0);
+    bool jumpTo(QV4::IR::BasicBlock *target, bool falseTarget = false);
+
+    const QList<QmlIR::Object*> &qmlObjects;
+    QV4::IR::Module *jsModule;
+
+    QQmlBindingProgram *program;
+    int currentBlock;
+    int nextScratchRegister;
+    QHash<QV4::IR::BasicBlock *, int> blockOrder;
+    QVector<int> blockStart;
+    QVector<QPair<int, QV4::IR::BasicBlock *> > trueTargets; // instruction -> block
+    QVector<QPair<int, QV4::IR::BasicBlock *> > falseTargets;
+    QHash<unsigned, int> builtinTemps; // temp index -> QV4::IR::Name::Builtin
+};
+
 QT_END_NAMESPACE
 
 #endif // QQMLTYPECOMPILER_P_H
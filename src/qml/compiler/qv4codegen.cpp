@@ -58,6 +58,7 @@
 #endif
 
 #include <cmath>
+#include <algorithm>
 #include <iostream>
 
 #ifdef CONST
@@ -68,6 +69,42 @@ using namespace QV4;
 using namespace QQmlJS;
 using namespace AST;
 
+// Matches arguments.length and arguments[expr], the two forms that can be read
+// without materializing the arguments object.
+static bool isArgumentsRead(ExpressionNode *node)
+{
+    if (FieldMemberExpression *field = cast<FieldMemberExpression *>(node)) {
+        IdentifierExpression *id = cast<IdentifierExpression *>(field->base);
+        return id && id->name == QLatin1String("arguments") && field->name == QLatin1String("length");
+    }
+    if (ArrayMemberExpression *subscript = cast<ArrayMemberExpression *>(node)) {
+        IdentifierExpression *id = cast<IdentifierExpression *>(subscript->base);
+        return id && id->name == QLatin1String("arguments");
+    }
+    return false;
+}
+
+static bool isAssignmentOperator(int op)
+{
+    switch ((QSOperator::Op) op) {
+    case QSOperator::Assign:
+    case QSOperator::InplaceAnd:
+    case QSOperator::InplaceSub:
+    case QSOperator::InplaceDiv:
+    case QSOperator::InplaceAdd:
+    case QSOperator::InplaceLeftShift:
+    case QSOperator::InplaceMod:
+    case QSOperator::InplaceMul:
+    case QSOperator::InplaceOr:
+    case QSOperator::InplaceRightShift:
+    case QSOperator::InplaceURightShift:
+    case QSOperator::InplaceXor:
+        return true;
+    default:
+        return false;
+    }
+}
+
 Codegen::ScanFunctions::ScanFunctions(Codegen *cg, const QString &sourceCode, CompilationMode defaultProgramMode)
     : _cg(cg)
     , _sourceCode(sourceCode)
@@ -149,6 +186,17 @@ void Codegen::ScanFunctions::checkForArguments(AST::FormalParameterList *paramet
     }
 }
 
+void Codegen::ScanFunctions::checkAssignmentTarget(ExpressionNode *target)
+{
+    if (isArgumentsRead(target)) {
+        if (_env->usesArgumentsObject == Environment::ArgumentsObjectUnknown)
+            _env->usesArgumentsObject = Environment::ArgumentsObjectUsed;
+    } else if (IdentifierExpression *id = cast<IdentifierExpression *>(target)) {
+        if (_env->isFormal(id->name))
+            _env->assignsFormals = true;
+    }
+}
+
 bool Codegen::ScanFunctions::visit(Program *ast)
 {
     enterEnvironment(ast, defaultProgramMode);
@@ -163,6 +211,9 @@ void Codegen::ScanFunctions::endVisit(Program *)
 
 bool Codegen::ScanFunctions::visit(CallExpression *ast)
 {
+    // arguments[i]() passes the arguments object as this.
+    if (isArgumentsRead(ast->base) && _env->usesArgumentsObject == Environment::ArgumentsObjectUnknown)
+        _env->usesArgumentsObject = Environment::ArgumentsObjectUsed;
     if (! _env->hasDirectEval) {
         if (IdentifierExpression *id = cast<IdentifierExpression *>(ast->base)) {
             if (id->name == QStringLiteral("eval")) {
@@ -211,6 +262,8 @@ bool Codegen::ScanFunctions::visit(VariableDeclaration *ast)
     checkName(ast->name, ast->identifierToken);
     if (ast->name == QLatin1String("arguments"))
         _env->usesArgumentsObject = Environment::ArgumentsObjectNotUsed;
+    if (ast->expression && _env->isFormal(ast->name))
+        _env->assignsFormals = true;
     _env->enter(ast->name.toString(), ast->expression ? Environment::VariableDefinition : Environment::VariableDeclaration);
     return true;
 }
@@ -223,6 +276,62 @@ bool Codegen::ScanFunctions::visit(IdentifierExpression *ast)
     return true;
 }
 
+bool Codegen::ScanFunctions::visit(FieldMemberExpression *ast)
+{
+    if (isArgumentsRead(ast)) {
+        _env->readsArguments = true;
+        return false;
+    }
+    return true;
+}
+
+bool Codegen::ScanFunctions::visit(ArrayMemberExpression *ast)
+{
+    if (isArgumentsRead(ast)) {
+        _env->readsArguments = true;
+        Node::accept(ast->expression, this);
+        return false;
+    }
+    return true;
+}
+
+bool Codegen::ScanFunctions::visit(BinaryExpression *ast)
+{
+    if (isAssignmentOperator(ast->op))
+        checkAssignmentTarget(ast->left);
+    return true;
+}
+
+bool Codegen::ScanFunctions::visit(PreIncrementExpression *ast)
+{
+    checkAssignmentTarget(ast->expression);
+    return true;
+}
+
+bool Codegen::ScanFunctions::visit(PreDecrementExpression *ast)
+{
+    checkAssignmentTarget(ast->expression);
+    return true;
+}
+
+bool Codegen::ScanFunctions::visit(PostIncrementExpression *ast)
+{
+    checkAssignmentTarget(ast->base);
+    return true;
+}
+
+bool Codegen::ScanFunctions::visit(PostDecrementExpression *ast)
+{
+    checkAssignmentTarget(ast->base);
+    return true;
+}
+
+bool Codegen::ScanFunctions::visit(DeleteExpression *ast)
+{
+    checkAssignmentTarget(ast->expression);
+    return true;
+}
+
 bool Codegen::ScanFunctions::visit(ExpressionStatement *ast)
 {
     if (FunctionExpression* expr = AST::cast<AST::FunctionExpression*>(ast->expression)) {
@@ -309,6 +418,7 @@ bool Codegen::ScanFunctions::visit(WithStatement *ast)
         return false;
     }
 
+    _env->hasWithStatement = true;
     return true;
 }
 
@@ -344,6 +454,7 @@ bool Codegen::ScanFunctions::visit(LocalForStatement *ast) {
 }
 
 bool Codegen::ScanFunctions::visit(ForEachStatement *ast) {
+    checkAssignmentTarget(ast->initialiser);
     Node::accept(ast->initialiser, this);
     Node::accept(ast->expression, this);
 
@@ -1095,6 +1206,14 @@ bool Codegen::visit(ArrayMemberExpression *ast)
     if (hasError)
         return false;
 
+    if (_env->canReadArgumentsLazily() && isArgumentsRead(ast)) {
+        Result index = expression(ast->expression);
+        IR::ExprList *args = _function->New<IR::ExprList>();
+        args->init(argument(*index));
+        _expr.code = call(_block->NAME(IR::Name::builtin_argument_at, ast->lbracketToken.startLine, ast->lbracketToken.startColumn), args);
+        return false;
+    }
+
     Result base = expression(ast->base);
     Result index = expression(ast->expression);
     _expr.code = subscript(*base, *index);
@@ -1404,6 +1523,11 @@ bool Codegen::visit(FieldMemberExpression *ast)
     if (hasError)
         return false;
 
+    if (_env->canReadArgumentsLazily() && isArgumentsRead(ast)) {
+        _expr.code = call(_block->NAME(IR::Name::builtin_arguments_length, ast->dotToken.startLine, ast->dotToken.startColumn), 0);
+        return false;
+    }
+
     Result base = expression(ast->base);
     _expr.code = member(*base, _function->newString(ast->name.toString()));
     return false;
@@ -1950,7 +2074,9 @@ int Codegen::defineFunction(const QString &name, AST::Node *ast,
     IR::BasicBlock *entryBlock = function->newBasicBlock(groupStartBlock(), 0);
     IR::BasicBlock *exitBlock = function->newBasicBlock(groupStartBlock(), 0, IR::Function::DontInsertBlock);
     function->hasDirectEval = _env->hasDirectEval || _env->compilationMode == EvalCode;
-    function->usesArgumentsObject = _env->parent && (_env->usesArgumentsObject == Environment::ArgumentsObjectUsed);
+    function->usesArgumentsObject = _env->parent && (_env->usesArgumentsObject == Environment::ArgumentsObjectUsed
+                                                     || (_env->readsArguments && !_env->canReadArgumentsLazily()
+                                                         && _env->usesArgumentsObject == Environment::ArgumentsObjectUnknown));
     function->usesThis = _env->usesThis;
     function->maxNumberOfArguments = qMax(_env->maxNumberOfArguments, (int)QV4::Global::ReservedArgumentCount);
     function->isStrict = _env->isStrict;
@@ -2506,26 +2632,47 @@ bool Codegen::visit(SwitchStatement *ast)
         _block->JUMP(switchend);
 
         _block = switchcond;
-        for (CaseClauses *it = ast->block->clauses; it; it = it->next) {
-            CaseClause *clause = it->clause;
-            Result rhs = expression(clause->expression);
-            IR::BasicBlock *iftrue = blockMap[clause];
-            IR::BasicBlock *iffalse = _function->newBasicBlock(groupStartBlock(), exceptionHandler());
-            cjump(binop(IR::OpStrictEqual, *lhs, *rhs), iftrue, iffalse);
-            _block = iffalse;
-        }
 
-        for (CaseClauses *it = ast->block->moreClauses; it; it = it->next) {
-            CaseClause *clause = it->clause;
-            Result rhs = expression(clause->expression);
-            IR::BasicBlock *iftrue = blockMap[clause];
-            IR::BasicBlock *iffalse = _function->newBasicBlock(groupStartBlock(), exceptionHandler());
-            cjump(binop(IR::OpStrictEqual, *lhs, *rhs), iftrue, iffalse);
-            _block = iffalse;
-        }
+        QVector<SwitchCase> cases;
+        bool stringCases = false;
+        if (constantSwitchCases(ast->block, blockMap, &cases, &stringCases)) {
+            const unsigned value = _block->newTemp();
+            move(_block->TEMP(value), *lhs);
+
+            // Only a value of the type of the cases can match, and only for such a
+            // value the ordered compares of the dispatch are free of side effects.
+            IR::BasicBlock *fallback = ast->block->defaultClause ? blockMap[ast->block->defaultClause] : switchend;
+            IR::BasicBlock *dispatch = _function->newBasicBlock(groupStartBlock(), exceptionHandler());
+            IR::ExprList *args = _function->New<IR::ExprList>();
+            args->init(_block->TEMP(value));
+            IR::Expr *type = call(_block->NAME(IR::Name::builtin_typeof, ast->switchToken.startLine, ast->switchToken.startColumn), args);
+            const QString typeName = stringCases ? QStringLiteral("string") : QStringLiteral("number");
+            cjump(binop(IR::OpStrictEqual, type, _block->STRING(_function->newString(typeName))), dispatch, fallback);
+
+            _block = dispatch;
+            switchDispatch(value, cases, 0, cases.size(), stringCases, fallback);
+        } else {
+            for (CaseClauses *it = ast->block->clauses; it; it = it->next) {
+                CaseClause *clause = it->clause;
+                Result rhs = expression(clause->expression);
+                IR::BasicBlock *iftrue = blockMap[clause];
+                IR::BasicBlock *iffalse = _function->newBasicBlock(groupStartBlock(), exceptionHandler());
+                cjump(binop(IR::OpStrictEqual, *lhs, *rhs), iftrue, iffalse);
+                _block = iffalse;
+            }
 
-        if (ast->block->defaultClause) {
-            _block->JUMP(blockMap[ast->block->defaultClause]);
+            for (CaseClauses *it = ast->block->moreClauses; it; it = it->next) {
+                CaseClause *clause = it->clause;
+                Result rhs = expression(clause->expression);
+                IR::BasicBlock *iftrue = blockMap[clause];
+                IR::BasicBlock *iffalse = _function->newBasicBlock(groupStartBlock(), exceptionHandler());
+                cjump(binop(IR::OpStrictEqual, *lhs, *rhs), iftrue, iffalse);
+                _block = iffalse;
+            }
+
+            if (ast->block->defaultClause) {
+                _block->JUMP(blockMap[ast->block->defaultClause]);
+            }
         }
     }
 
@@ -2535,6 +2682,110 @@ bool Codegen::visit(SwitchStatement *ast)
     return false;
 }
 
+namespace {
+// Below this number of cases the chain of compares is as fast as the dispatch
+const int MinimumDispatchCases = 8;
+// Number of cases compared one by one at the leaves of the dispatch
+const int LinearDispatchCases = 3;
+
+bool caseConstant(ExpressionNode *expression, double *number, QString *string)
+{
+    if (NumericLiteral *literal = AST::cast<NumericLiteral *>(expression)) {
+        *number = literal->value;
+        return true;
+    }
+    if (UnaryMinusExpression *minus = AST::cast<UnaryMinusExpression *>(expression)) {
+        if (NumericLiteral *literal = AST::cast<NumericLiteral *>(minus->expression)) {
+            *number = -literal->value;
+            return true;
+        }
+    }
+    if (StringLiteral *literal = AST::cast<StringLiteral *>(expression)) {
+        // Non-null even if empty, a null string marks a number case
+        *string = literal->value.isEmpty() ? QString(QLatin1String("")) : literal->value.toString();
+        return true;
+    }
+    return false;
+}
+
+}
+
+/*
+    Collects the cases of a switch if they are all number or all string
+    literals, sorted by value. As evaluating them has no side effects, they
+    can then be tested in any order, which allows a binary search instead
+    of comparing the value with all cases in turn. Of duplicate cases, only
+    the first one can ever match.
+ */
+bool Codegen::constantSwitchCases(CaseBlock *ast, const QHash<Node *, IR::BasicBlock *> &blockMap,
+                                  QVector<SwitchCase> *cases, bool *stringCases)
+{
+    QList<CaseClause *> clauses;
+    for (CaseClauses *it = ast->clauses; it; it = it->next)
+        clauses.append(it->clause);
+    for (CaseClauses *it = ast->moreClauses; it; it = it->next)
+        clauses.append(it->clause);
+    if (clauses.size() < MinimumDispatchCases)
+        return false;
+
+    for (int i = 0; i < clauses.size(); ++i) {
+        SwitchCase c;
+        c.number = 0;
+        c.block = blockMap.value(clauses.at(i));
+        if (!caseConstant(clauses.at(i)->expression, &c.number, &c.string))
+            return false;
+        if (i == 0)
+            *stringCases = !c.string.isNull();
+        else if (*stringCases == c.string.isNull())
+            return false;
+
+        // NaN never matches anything
+        if (!*stringCases && c.number != c.number)
+            continue;
+        cases->append(c);
+    }
+
+    // A stable sort keeps duplicates in source order, so unique() keeps the first one
+    std::stable_sort(cases->begin(), cases->end());
+    cases->erase(std::unique(cases->begin(), cases->end()), cases->end());
+    return true;
+}
+
+/*
+    Emits a binary search for \a value over cases[begin, end), with a few
+    strict equality compares at the leaves, jumping to \a fallback if no
+    case matches. The value is known to be of the type of the cases.
+ */
+void Codegen::switchDispatch(unsigned value, const QVector<SwitchCase> &cases, int begin, int end, bool stringCases,
+                             IR::BasicBlock *fallback)
+{
+    if (end - begin <= LinearDispatchCases) {
+        for (int i = begin; i < end; ++i) {
+            const SwitchCase &c = cases.at(i);
+            IR::Expr *constant = stringCases ? _block->STRING(_function->newString(c.string))
+                                             : _block->CONST(IR::NumberType, c.number);
+            IR::BasicBlock *iffalse = _function->newBasicBlock(groupStartBlock(), exceptionHandler());
+            cjump(binop(IR::OpStrictEqual, _block->TEMP(value), constant), c.block, iffalse);
+            _block = iffalse;
+        }
+        _block->JUMP(fallback);
+        return;
+    }
+
+    const int mid = (begin + end) / 2;
+    const SwitchCase &pivot = cases.at(mid);
+    IR::Expr *constant = stringCases ? _block->STRING(_function->newString(pivot.string))
+                                     : _block->CONST(IR::NumberType, pivot.number);
+    IR::BasicBlock *lower = _function->newBasicBlock(groupStartBlock(), exceptionHandler());
+    IR::BasicBlock *upper = _function->newBasicBlock(groupStartBlock(), exceptionHandler());
+    cjump(binop(IR::OpLt, _block->TEMP(value), constant), lower, upper);
+
+    _block = lower;
+    switchDispatch(value, cases, begin, mid, stringCases, fallback);
+    _block = upper;
+    switchDispatch(value, cases, mid, end, stringCases, fallback);
+}
+
 bool Codegen::visit(ThrowStatement *ast)
 {
     if (hasError)
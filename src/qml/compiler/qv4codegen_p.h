@@ -158,6 +158,11 @@ protected:
         };
 
         UsesArgumentsObject usesArgumentsObject;
+        // arguments.length and arguments[i] are only ever read, never written, called
+        // through or otherwise escape; see canReadArgumentsLazily().
+        bool readsArguments;
+        bool assignsFormals;
+        bool hasWithStatement;
 
         CompilationMode compilationMode;
 
@@ -171,12 +176,32 @@ protected:
             , isNamedFunctionExpression(false)
             , usesThis(false)
             , usesArgumentsObject(ArgumentsObjectUnknown)
+            , readsArguments(false)
+            , assignsFormals(false)
+            , hasWithStatement(false)
             , compilationMode(mode)
         {
             if (parent && parent->isStrict)
                 isStrict = true;
         }
 
+        // The reads can then be served straight from the call data, without allocating
+        // an arguments object, and the function keeps its stack-allocated context.
+        bool canReadArgumentsLazily() const
+        {
+            return parent && readsArguments && usesArgumentsObject == ArgumentsObjectUnknown
+                    && !assignsFormals && !hasNestedFunctions && !hasWithStatement;
+        }
+
+        bool isFormal(const QStringRef &name) const
+        {
+            for (AST::FormalParameterList *it = formals; it; it = it->next) {
+                if (it->name == name)
+                    return true;
+            }
+            return false;
+        }
+
         int findMember(const QString &name) const
         {
             MemberMap::const_iterator it = members.find(name);
@@ -305,6 +330,21 @@ protected:
     void move(QV4::IR::Expr *target, QV4::IR::Expr *source, QV4::IR::AluOp op = QV4::IR::OpInvalid);
     void cjump(QV4::IR::Expr *cond, QV4::IR::BasicBlock *iftrue, QV4::IR::BasicBlock *iffalse);
 
+    struct SwitchCase {
+        double number;
+        QString string;
+        QV4::IR::BasicBlock *block;
+
+        bool operator<(const SwitchCase &other) const
+        { return string.isNull() ? number < other.number : string < other.string; }
+        bool operator==(const SwitchCase &other) const
+        { return string.isNull() ? number == other.number : string == other.string; }
+    };
+    bool constantSwitchCases(AST::CaseBlock *ast, const QHash<AST::Node *, QV4::IR::BasicBlock *> &blockMap,
+                             QVector<SwitchCase> *cases, bool *stringCases);
+    void switchDispatch(unsigned value, const QVector<SwitchCase> &cases, int begin, int end, bool stringCases,
+                        QV4::IR::BasicBlock *fallback);
+
     // Returns index in _module->functions
     int defineFunction(const QString &name, AST::Node *ast,
                        AST::FormalParameterList *formals,
@@ -488,6 +528,7 @@ protected:
 
         void checkName(const QStringRef &name, const AST::SourceLocation &loc);
         void checkForArguments(AST::FormalParameterList *parameters);
+        void checkAssignmentTarget(AST::ExpressionNode *target);
 
         virtual bool visit(AST::Program *ast);
         virtual void endVisit(AST::Program *);
@@ -497,6 +538,14 @@ protected:
         virtual bool visit(AST::ArrayLiteral *ast);
         virtual bool visit(AST::VariableDeclaration *ast);
         virtual bool visit(AST::IdentifierExpression *ast);
+        virtual bool visit(AST::FieldMemberExpression *ast);
+        virtual bool visit(AST::ArrayMemberExpression *ast);
+        virtual bool visit(AST::BinaryExpression *ast);
+        virtual bool visit(AST::PreIncrementExpression *ast);
+        virtual bool visit(AST::PreDecrementExpression *ast);
+        virtual bool visit(AST::PostIncrementExpression *ast);
+        virtual bool visit(AST::PostDecrementExpression *ast);
+        virtual bool visit(AST::DeleteExpression *ast);
         virtual bool visit(AST::ExpressionStatement *ast);
         virtual bool visit(AST::FunctionExpression *ast);
 
@@ -44,13 +44,26 @@
 #include <private/qv4value_inl_p.h>
 #ifndef V4_BOOTSTRAP
 #include <private/qv4engine_p.h>
+#include <private/qv4identifiertable_p.h>
 #include <private/qv4function_p.h>
 #include <private/qv4objectproto_p.h>
 #include <private/qv4lookup_p.h>
 #include <private/qv4regexpobject_p.h>
+#include <private/qv4instr_moth_p.h>
 #endif
 #include <private/qqmlirbuilder_p.h>
 #include <QCoreApplication>
+#ifndef V4_BOOTSTRAP
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QSaveFile>
+#include <QStandardPaths>
+#endif
 
 #include <algorithm>
 
@@ -61,9 +74,44 @@ namespace QV4 {
 namespace CompiledData {
 
 #ifndef V4_BOOTSTRAP
+// The unit data and code of a script, used by the units of all engines that load it.
+struct SharedUnit
+{
+    int refCount; // guarded by the table mutex
+    QString sourcePath;
+    qint64 sourceTimeStamp;
+    qint64 sourceSize;
+    Unit *data;
+    CompilationUnit *code; // never linked, only copied from
+    CompilationUnit::TierUpSource *tierUpSource;
+};
+
+typedef QHash<QString, SharedUnit *> SharedUnitTable;
+Q_GLOBAL_STATIC(SharedUnitTable, sharedUnitTable)
+Q_GLOBAL_STATIC(QMutex, sharedUnitTableMutex)
+
+static void releaseSharedUnit(SharedUnit *shared)
+{
+    QMutexLocker locker(sharedUnitTableMutex());
+    if (--shared->refCount)
+        return;
+    SharedUnitTable::Iterator it = sharedUnitTable()->find(shared->sourcePath);
+    if (it != sharedUnitTable()->end() && *it == shared)
+        sharedUnitTable()->erase(it);
+    locker.unlock();
+
+    free(shared->data);
+    delete shared->code;
+    delete shared->tierUpSource;
+    delete shared;
+}
+
 CompilationUnit::~CompilationUnit()
 {
     unlink();
+    delete tierUpSource;
+    if (tieredUnit)
+        tieredUnit->deref();
 }
 
 QV4::Function *CompilationUnit::linkToEngine(ExecutionEngine *engine)
@@ -76,8 +124,13 @@ QV4::Function *CompilationUnit::linkToEngine(ExecutionEngine *engine)
     runtimeStrings = (QV4::StringValue *)malloc(data->stringTableSize * sizeof(QV4::StringValue));
     // memset the strings to 0 in case a GC run happens while we're within the loop below
     memset(runtimeStrings, 0, data->stringTableSize * sizeof(QV4::StringValue));
-    for (uint i = 0; i < data->stringTableSize; ++i)
-        runtimeStrings[i] = engine->newIdentifier(data->stringAt(i));
+    for (uint i = 0; i < data->stringTableSize; ++i) {
+        const CompiledData::String *str = data->stringDataAt(i);
+        if (str->flags & CompiledData::String::IsArrayIndex)
+            runtimeStrings[i] = engine->newIdentifier(data->stringAt(i));
+        else
+            runtimeStrings[i] = engine->identifierTable->insertSharedString(data->stringAt(i), str->hash);
+    }
 
     runtimeRegularExpressions = new QV4::Value[data->regexpTableSize];
     // memset the regexps to 0 in case a GC run happens while we're within the loop below
@@ -156,8 +209,18 @@ void CompilationUnit::unlink()
     if (engine)
         engine->compilationUnits.erase(engine->compilationUnits.find(this));
     engine = 0;
-    if (data && !(data->flags & QV4::CompiledData::Unit::StaticData))
+    if (runtimeLookups) {
+        for (uint i = 0; i < data->lookupTableSize; ++i) {
+            if (data->lookupTable()[i].type_and_flags == CompiledData::Lookup::Type_Getter)
+                runtimeLookups[i].releaseCaches();
+        }
+    }
+    if (sharedUnit) {
+        releaseSharedUnit(sharedUnit);
+        sharedUnit = 0;
+    } else if (data && !(data->flags & QV4::CompiledData::Unit::StaticData)) {
         free(data);
+    }
     data = 0;
     free(runtimeStrings);
     runtimeStrings = 0;
@@ -185,6 +248,336 @@ void CompilationUnit::markObjects(QV4::ExecutionEngine *e)
     }
 }
 
+namespace {
+
+static const char cacheFileMagic[] = "qv4cache";
+enum { CacheFileVersion = 2 };
+
+struct CacheFileHeader
+{
+    enum Flags {
+        Precompiled = 0x1 // not tied to a particular version of the source file
+    };
+
+    char magic[8];
+    quint32 version;
+    quint32 unitSize;
+    quint32 flags;
+    char buildId[20]; // SHA-1 of the engine version and data format, see engineBuildId()
+    qint64 sourceTimeStamp;
+    qint64 sourceSize;
+};
+
+#define MOTH_INSTR_COUNT(I, FMT) + 1
+#define MOTH_INSTR_TOTAL_SIZE(I, FMT) + MOTH_INSTR_SIZE(I, FMT)
+enum {
+    MothInstructionCount = 0 FOR_EACH_MOTH_INSTR(MOTH_INSTR_COUNT),
+    MothInstructionSetSize = 0 FOR_EACH_MOTH_INSTR(MOTH_INSTR_TOTAL_SIZE)
+};
+#undef MOTH_INSTR_COUNT
+#undef MOTH_INSTR_TOTAL_SIZE
+
+// Cache files are only valid for the Qt version and compiled data format that wrote them.
+// CacheFileVersion has to be bumped when the format changes in a way the structure sizes and
+// the shape of the interpreter instruction set don't show. Nothing specific to a build goes in,
+// so reproducible builds of the same sources read each other's cache files.
+static QByteArray engineBuildId()
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QT_VERSION_STR);
+    const quint32 layout[] = { CacheFileVersion, sizeof(void*), sizeof(Unit), sizeof(QmlUnit), sizeof(Function),
+                               sizeof(String), Q_BYTE_ORDER, MothInstructionCount, MothInstructionSetSize };
+    hash.addData(reinterpret_cast<const char *>(layout), sizeof(layout));
+    return hash.result();
+}
+
+static bool sourceFileInfo(const QString &sourcePath, qint64 *timeStamp, qint64 *size)
+{
+    QFileInfo info(sourcePath);
+    if (!info.exists())
+        return false;
+    *timeStamp = info.lastModified().toMSecsSinceEpoch();
+    *size = info.size();
+    return true;
+}
+
+// Downloaded sources have no usable time stamp, so the stamp is taken from their content.
+static void sourceDataInfo(const QByteArray &source, qint64 *timeStamp, qint64 *size)
+{
+    const QByteArray hash = QCryptographicHash::hash(source, QCryptographicHash::Sha1);
+    memcpy(timeStamp, hash.constData(), sizeof(qint64));
+    *size = source.size();
+}
+
+static quint32 unitDataSize(const Unit *unit)
+{
+    if (unit->flags & Unit::IsQml)
+        return reinterpret_cast<const QmlUnit *>(unit)->qmlUnitSize;
+    return unit->unitSize;
+}
+
+}
+
+QString CompilationUnit::diskCacheDirectory()
+{
+    QString cacheDir = QString::fromLocal8Bit(qgetenv("QML_DISK_CACHE_PATH"));
+    if (cacheDir.isEmpty())
+        cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/qmlcache");
+    return cacheDir;
+}
+
+QString CompilationUnit::localCacheFilePath(const QString &sourcePath)
+{
+    const QByteArray pathHash = QCryptographicHash::hash(QFileInfo(sourcePath).absoluteFilePath().toUtf8(), QCryptographicHash::Sha1).toHex();
+    return diskCacheDirectory() + QLatin1Char('/') + QString::fromLatin1(pathHash) + QLatin1String(".qv4c");
+}
+
+bool CompilationUnit::saveToDisk(const QString &sourcePath, QString *errorString) const
+{
+    qint64 sourceStamp[2];
+    if (!sourceFileInfo(sourcePath, &sourceStamp[0], &sourceStamp[1])) {
+        *errorString = QStringLiteral("Source file %1 does not exist").arg(sourcePath);
+        return false;
+    }
+    return saveToFile(localCacheFilePath(sourcePath), sourceStamp, errorString);
+}
+
+bool CompilationUnit::loadFromDisk(const QString &sourcePath, QString *errorString)
+{
+    qint64 sourceStamp[2];
+    if (!sourceFileInfo(sourcePath, &sourceStamp[0], &sourceStamp[1])) {
+        *errorString = QStringLiteral("Cache file is out of date");
+        return false;
+    }
+    return loadFromFile(localCacheFilePath(sourcePath), sourceStamp, errorString);
+}
+
+QString CompilationUnit::remoteCacheFilePath(const QUrl &url)
+{
+    const QByteArray urlHash = QCryptographicHash::hash(url.toEncoded(), QCryptographicHash::Sha1).toHex();
+    return diskCacheDirectory() + QLatin1String("/remote/") + QString::fromLatin1(urlHash) + QLatin1String(".qv4c");
+}
+
+bool CompilationUnit::saveToDisk(const QUrl &url, const QByteArray &source, QString *errorString) const
+{
+    qint64 sourceStamp[2];
+    sourceDataInfo(source, &sourceStamp[0], &sourceStamp[1]);
+    return saveToFile(remoteCacheFilePath(url), sourceStamp, errorString);
+}
+
+bool CompilationUnit::loadFromDisk(const QUrl &url, const QByteArray &source, QString *errorString)
+{
+    qint64 sourceStamp[2];
+    sourceDataInfo(source, &sourceStamp[0], &sourceStamp[1]);
+    return loadFromFile(remoteCacheFilePath(url), sourceStamp, errorString);
+}
+
+QString CompilationUnit::scriptCacheFilePath(const QString &fileName)
+{
+    const QByteArray nameHash = QCryptographicHash::hash(fileName.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return diskCacheDirectory() + QLatin1String("/scripts/") + QString::fromLatin1(nameHash) + QLatin1String(".qv4c");
+}
+
+bool CompilationUnit::saveScriptToDisk(const QString &fileName, const QByteArray &key, QString *errorString) const
+{
+    qint64 sourceStamp[2];
+    sourceDataInfo(key, &sourceStamp[0], &sourceStamp[1]);
+    return saveToFile(scriptCacheFilePath(fileName), sourceStamp, errorString);
+}
+
+bool CompilationUnit::loadScriptFromDisk(const QString &fileName, const QByteArray &key, QString *errorString)
+{
+    qint64 sourceStamp[2];
+    sourceDataInfo(key, &sourceStamp[0], &sourceStamp[1]);
+    return loadFromFile(scriptCacheFilePath(fileName), sourceStamp, errorString);
+}
+
+QString CompilationUnit::precompiledFilePath(const QString &sourcePath)
+{
+    // foo.js -> foo.jsc
+    return sourcePath + QLatin1Char('c');
+}
+
+bool CompilationUnit::savePrecompiled(const QString &filePath, QString *errorString) const
+{
+    return saveToFile(filePath, 0, errorString);
+}
+
+bool CompilationUnit::loadPrecompiled(const QString &filePath, QString *errorString)
+{
+    return loadFromFile(filePath, 0, errorString);
+}
+
+bool CompilationUnit::saveToFile(const QString &cacheFilePath, const qint64 *sourceStamp, QString *errorString) const
+{
+    Q_ASSERT(data);
+
+    CacheFileHeader header;
+    memset(&header, 0, sizeof(header));
+    if (!sourceStamp) {
+        header.flags |= CacheFileHeader::Precompiled;
+    } else {
+        header.sourceTimeStamp = sourceStamp[0];
+        header.sourceSize = sourceStamp[1];
+    }
+    memcpy(header.magic, cacheFileMagic, sizeof(header.magic));
+    header.version = CacheFileVersion;
+    header.unitSize = unitDataSize(data);
+    const QByteArray buildId = engineBuildId();
+    memcpy(header.buildId, buildId.constData(), sizeof(header.buildId));
+
+    if (!QDir().mkpath(QFileInfo(cacheFilePath).absolutePath())) {
+        *errorString = QStringLiteral("Unable to create cache directory for %1").arg(cacheFilePath);
+        return false;
+    }
+
+    QSaveFile cacheFile(cacheFilePath);
+    if (!cacheFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        *errorString = cacheFile.errorString();
+        return false;
+    }
+
+    // The unit is written without the StaticData flag, as the loaded copy is heap allocated.
+    Unit unitHeader = *data;
+    unitHeader.flags &= ~Unit::StaticData;
+    if (cacheFile.write(reinterpret_cast<const char *>(&header), sizeof(header)) != qint64(sizeof(header))
+        || cacheFile.write(reinterpret_cast<const char *>(&unitHeader), sizeof(unitHeader)) != qint64(sizeof(unitHeader))
+        || cacheFile.write(reinterpret_cast<const char *>(data) + sizeof(Unit), header.unitSize - sizeof(Unit)) != qint64(header.unitSize - sizeof(Unit))) {
+        *errorString = cacheFile.errorString();
+        return false;
+    }
+
+    if (!saveCodeToDisk(&cacheFile, errorString)) {
+        cacheFile.cancelWriting();
+        return false;
+    }
+
+    if (!cacheFile.commit()) {
+        *errorString = cacheFile.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool CompilationUnit::loadFromFile(const QString &cacheFilePath, const qint64 *sourceStamp, QString *errorString)
+{
+    Q_ASSERT(!data);
+
+    QFile cacheFile(cacheFilePath);
+    if (!cacheFile.open(QIODevice::ReadOnly)) {
+        *errorString = cacheFile.errorString();
+        return false;
+    }
+
+    CacheFileHeader header;
+    if (cacheFile.read(reinterpret_cast<char *>(&header), sizeof(header)) != qint64(sizeof(header))
+        || memcmp(header.magic, cacheFileMagic, sizeof(header.magic)) != 0
+        || header.version != CacheFileVersion
+        || header.unitSize < sizeof(Unit)) {
+        *errorString = QStringLiteral("Invalid cache file header");
+        return false;
+    }
+
+    if (engineBuildId() != QByteArray::fromRawData(header.buildId, sizeof(header.buildId))) {
+        *errorString = QStringLiteral("Cache file was created by a different engine build");
+        return false;
+    }
+
+    if (!sourceStamp) {
+        if (!(header.flags & CacheFileHeader::Precompiled)) {
+            *errorString = QStringLiteral("Cache file is not a precompiled unit");
+            return false;
+        }
+    } else if ((header.flags & CacheFileHeader::Precompiled)
+               || sourceStamp[0] != header.sourceTimeStamp || sourceStamp[1] != header.sourceSize) {
+        *errorString = QStringLiteral("Cache file is out of date");
+        return false;
+    }
+
+    Unit *unit = reinterpret_cast<Unit *>(malloc(header.unitSize));
+    if (cacheFile.read(reinterpret_cast<char *>(unit), header.unitSize) != header.unitSize
+        || memcmp(unit->magic, magic_str, sizeof(unit->magic)) != 0
+        || unitDataSize(unit) != header.unitSize) {
+        free(unit);
+        *errorString = QStringLiteral("Truncated or corrupt compilation unit in cache file");
+        return false;
+    }
+    data = unit;
+
+    if (!loadCodeFromDisk(&cacheFile, errorString)) {
+        free(data);
+        data = 0;
+        return false;
+    }
+    return true;
+}
+
+void CompilationUnit::share(const QString &sourcePath)
+{
+    Q_ASSERT(data && !engine && !sharedUnit);
+    if (data->flags & Unit::StaticData)
+        return;
+
+    qint64 sourceTimeStamp = 0;
+    qint64 sourceSize = 0;
+    if (!sourceFileInfo(sourcePath, &sourceTimeStamp, &sourceSize))
+        return;
+
+    CompilationUnit *code = createCodeCopy();
+    if (!code)
+        return;
+
+    SharedUnit *shared = new SharedUnit;
+    shared->refCount = 1;
+    shared->sourcePath = sourcePath;
+    shared->sourceTimeStamp = sourceTimeStamp;
+    shared->sourceSize = sourceSize;
+    shared->data = data;
+    shared->code = code;
+    shared->tierUpSource = tierUpSource ? new TierUpSource(*tierUpSource) : 0;
+    sharedUnit = shared;
+
+    // An existing entry for an older version of the file stays alive for its users
+    QMutexLocker locker(sharedUnitTableMutex());
+    sharedUnitTable()->insert(sourcePath, shared);
+}
+
+CompilationUnit *CompilationUnit::createShared(const QString &sourcePath)
+{
+    qint64 sourceTimeStamp = 0;
+    qint64 sourceSize = 0;
+    if (!sourceFileInfo(sourcePath, &sourceTimeStamp, &sourceSize))
+        return 0;
+
+    QMutexLocker locker(sharedUnitTableMutex());
+    SharedUnit *shared = sharedUnitTable()->value(sourcePath);
+    if (!shared || shared->sourceTimeStamp != sourceTimeStamp || shared->sourceSize != sourceSize)
+        return 0;
+    ++shared->refCount;
+    locker.unlock();
+
+    CompilationUnit *unit = shared->code->createCodeCopy();
+    unit->data = shared->data;
+    unit->sharedUnit = shared;
+    if (shared->tierUpSource)
+        unit->tierUpSource = new TierUpSource(*shared->tierUpSource);
+    return unit;
+}
+
+bool CompilationUnit::saveCodeToDisk(QIODevice *device, QString *errorString) const
+{
+    Q_UNUSED(device);
+    *errorString = QStringLiteral("Saving code to disk is not supported by this backend");
+    return false;
+}
+
+bool CompilationUnit::loadCodeFromDisk(QIODevice *device, QString *errorString)
+{
+    Q_UNUSED(device);
+    *errorString = QStringLiteral("Loading code from disk is not supported by this backend");
+    return false;
+}
+
 #endif // V4_BOOTSTRAP
 
 Unit *CompilationUnit::createUnitData(QmlIR::Document *irDocument)
@@ -42,6 +42,7 @@
 #define QV4COMPILEDDATA_P_H
 
 #include <QtCore/qstring.h>
+#include <QtCore/qurl.h>
 #include <QVector>
 #include <QStringList>
 #include <QHash>
@@ -50,6 +51,8 @@
 
 QT_BEGIN_NAMESPACE
 
+class QIODevice;
+
 namespace QmlIR {
 struct Document;
 }
@@ -68,6 +71,7 @@ struct String;
 struct Function;
 struct Lookup;
 struct RegExp;
+struct SharedUnit;
 
 #if defined(Q_CC_MSVC) || defined(Q_CC_GNU)
 #pragma pack(push, 1)
@@ -131,8 +135,13 @@ struct JSClass
 
 struct String
 {
-    quint32 flags; // isArrayIndex
+    enum Flags {
+        IsArrayIndex = 0x1
+    };
+
+    quint32 flags;
     qint32 size;
+    quint32 hash; // String::createHashValue() of the characters, unless IsArrayIndex is set
     // uint16 strdata[]
 
     static int calculateSize(const QString &str) {
@@ -172,10 +181,14 @@ struct Unit
     qint32 indexOfRootFunction;
     quint32 sourceFileIndex;
 
-    QString stringAt(int idx) const {
+    const String *stringDataAt(int idx) const {
         const uint *offsetTable = reinterpret_cast<const uint*>((reinterpret_cast<const char *>(this)) + offsetToStringTable);
         const uint offset = offsetTable[idx];
-        const String *str = reinterpret_cast<const String*>(reinterpret_cast<const char *>(this) + offset);
+        return reinterpret_cast<const String*>(reinterpret_cast<const char *>(this) + offset);
+    }
+
+    QString stringAt(int idx) const {
+        const String *str = stringDataAt(idx);
         if (str->size == 0)
             return QString();
         const QChar *characters = reinterpret_cast<const QChar *>(str + 1);
@@ -584,6 +597,9 @@ struct Q_QML_PRIVATE_EXPORT CompilationUnit
         , runtimeLookups(0)
         , runtimeRegularExpressions(0)
         , runtimeClasses(0)
+        , tierUpSource(0)
+        , tieredUnit(0)
+        , sharedUnit(0)
     {}
     virtual ~CompilationUnit();
 #endif
@@ -607,6 +623,18 @@ struct Q_QML_PRIVATE_EXPORT CompilationUnit
     QV4::InternalClass **runtimeClasses;
     QVector<QV4::Function *> runtimeFunctions;
 
+    // Units compiled for the interpreter while the JIT is available keep their source around,
+    // so that they can be recompiled once one of their functions gets hot (see Script::tierUp).
+    struct TierUpSource {
+        QString sourceCode;
+        int line;
+        bool qmlMode;
+        bool strictMode;
+        bool useFastLookups;
+    };
+    TierUpSource *tierUpSource;
+    CompilationUnit *tieredUnit;
+
     QV4::Function *linkToEngine(QV4::ExecutionEngine *engine);
     void unlink();
 
@@ -614,8 +642,53 @@ struct Q_QML_PRIVATE_EXPORT CompilationUnit
 
     void markObjects(QV4::ExecutionEngine *e);
 
+    // Disk cache support. The cache file for a source file is only considered valid if it was
+    // written by the same engine build for the same source modification time and size.
+    static QString diskCacheDirectory();
+    static QString localCacheFilePath(const QString &sourcePath);
+    bool saveToDisk(const QString &sourcePath, QString *errorString) const;
+    bool loadFromDisk(const QString &sourcePath, QString *errorString);
+
+    // Scripts loaded over the network are cached by URL instead, and are valid for as long as
+    // the source that was downloaded (or revalidated by the HTTP cache) stays the same.
+    static QString remoteCacheFilePath(const QUrl &url);
+    bool saveToDisk(const QUrl &url, const QByteArray &source, QString *errorString) const;
+    bool loadFromDisk(const QUrl &url, const QByteArray &source, QString *errorString);
+
+    // Scripts evaluated from source text, such as libraries passed to QJSEngine::evaluate(), are
+    // cached by file name, and are valid for as long as the key stays the same. The key is the
+    // source followed by whatever else affects code generation.
+    static QString scriptCacheFilePath(const QString &fileName);
+    bool saveScriptToDisk(const QString &fileName, const QByteArray &key, QString *errorString) const;
+    bool loadScriptFromDisk(const QString &fileName, const QByteArray &key, QString *errorString);
+
+    // Precompiled units are written ahead of time by qmlcachegen next to their source (or in
+    // its place), and are valid for any source as long as the engine build matches.
+    static QString precompiledFilePath(const QString &sourcePath);
+    bool savePrecompiled(const QString &filePath, QString *errorString) const;
+    bool loadPrecompiled(const QString &filePath, QString *errorString);
+
+    // Units of local scripts are shared by all engines of the process. share() hands the unit
+    // data and the generated code of a freshly compiled, unlinked unit over to a process wide
+    // table, and createShared() returns a new unlinked unit using them, for as long as the
+    // source file is unchanged. Only the runtime tables are per engine.
+    void share(const QString &sourcePath);
+    static CompilationUnit *createShared(const QString &sourcePath);
+
 protected:
     virtual void linkBackendToEngine(QV4::ExecutionEngine *engine) = 0;
+    virtual bool saveCodeToDisk(QIODevice *device, QString *errorString) const;
+    virtual bool loadCodeFromDisk(QIODevice *device, QString *errorString);
+    // Returns a new unit of the same backend that refers to the code of this one, or 0 if
+    // the backend can't share its code (the JIT allocates it per engine).
+    virtual CompilationUnit *createCodeCopy() const { return 0; }
+
+private:
+    // A null sourceStamp (time stamp and size) writes or expects a precompiled file.
+    bool saveToFile(const QString &cacheFilePath, const qint64 *sourceStamp, QString *errorString) const;
+    bool loadFromFile(const QString &cacheFilePath, const qint64 *sourceStamp, QString *errorString);
+
+    SharedUnit *sharedUnit;
 #endif // V4_BOOTSTRAP
 };
 
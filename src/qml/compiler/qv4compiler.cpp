@@ -81,8 +81,11 @@ void QV4::Compiler::StringTableGenerator::serialize(uint *stringTable, char *dat
         const QString &qstr = strings.at(i);
 
         QV4::CompiledData::String *s = (QV4::CompiledData::String*)(stringData);
-        s->flags = 0; // ###
         s->size = qstr.length();
+        // Array indices are never turned into identifiers, so their hash isn't needed at run time.
+        const bool isArrayIndex = QV4::String::toArrayIndex(qstr) != UINT_MAX;
+        s->flags = isArrayIndex ? QV4::CompiledData::String::IsArrayIndex : 0;
+        s->hash = isArrayIndex ? 0 : QV4::String::createHashValue(qstr.constData(), qstr.length());
         memcpy(s + 1, qstr.constData(), (qstr.length() + 1)*sizeof(ushort));
 
         stringData += QV4::CompiledData::String::calculateSize(qstr);
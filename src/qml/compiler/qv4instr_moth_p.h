@@ -99,6 +99,8 @@ QT_BEGIN_NAMESPACE
     F(CallBuiltinDefineArray, callBuiltinDefineArray) \
     F(CallBuiltinDefineObjectLiteral, callBuiltinDefineObjectLiteral) \
     F(CallBuiltinSetupArgumentsObject, callBuiltinSetupArgumentsObject) \
+    F(CallBuiltinArgumentsLength, callBuiltinArgumentsLength) \
+    F(CallBuiltinArgumentAt, callBuiltinArgumentAt) \
     F(CallBuiltinConvertThisToObject, callBuiltinConvertThisToObject) \
     F(CreateValue, createValue) \
     F(CreateProperty, createProperty) \
@@ -108,6 +110,8 @@ QT_BEGIN_NAMESPACE
     F(Jump, jump) \
     F(JumpEq, jumpEq) \
     F(JumpNe, jumpNe) \
+    F(CompareJumpEq, compareJumpEq) \
+    F(CompareJumpNe, compareJumpNe) \
     F(UNot, unot) \
     F(UNotBool, unotBool) \
     F(UPlus, uplus) \
@@ -132,7 +136,7 @@ QT_BEGIN_NAMESPACE
     F(Sub, sub) \
     F(BinopContext, binopContext) \
     F(LoadThis, loadThis) \
-    F(LoadQmlIdArray, loadQmlIdArray) \
+    F(LoadQmlIdObject, loadQmlIdObject) \
     F(LoadQmlImportedScripts, loadQmlImportedScripts) \
     F(LoadQmlContextObject, loadQmlContextObject) \
     F(LoadQmlScopeObject, loadQmlScopeObject) \
@@ -502,6 +506,15 @@ union Instr
         MOTH_INSTR_HEADER
         Param result;
     };
+    struct instr_callBuiltinArgumentsLength {
+        MOTH_INSTR_HEADER
+        Param result;
+    };
+    struct instr_callBuiltinArgumentAt {
+        MOTH_INSTR_HEADER
+        Param index;
+        Param result;
+    };
     struct instr_callBuiltinConvertThisToObject {
         MOTH_INSTR_HEADER
     };
@@ -556,6 +569,20 @@ union Instr
         ptrdiff_t offset;
         Param condition;
     };
+    struct instr_compareJumpEq {
+        MOTH_INSTR_HEADER
+        ptrdiff_t offset;
+        QV4::Runtime::CompareOperation cmp;
+        Param lhs;
+        Param rhs;
+    };
+    struct instr_compareJumpNe {
+        MOTH_INSTR_HEADER
+        ptrdiff_t offset;
+        QV4::Runtime::CompareOperation cmp;
+        Param lhs;
+        Param rhs;
+    };
     struct instr_unot {
         MOTH_INSTR_HEADER
         Param source;
@@ -692,8 +719,9 @@ union Instr
         MOTH_INSTR_HEADER
         Param result;
     };
-    struct instr_loadQmlIdArray {
+    struct instr_loadQmlIdObject {
         MOTH_INSTR_HEADER
+        int index;
         Param result;
     };
     struct instr_loadQmlImportedScripts {
@@ -764,6 +792,8 @@ union Instr
     instr_callBuiltinDefineArray callBuiltinDefineArray;
     instr_callBuiltinDefineObjectLiteral callBuiltinDefineObjectLiteral;
     instr_callBuiltinSetupArgumentsObject callBuiltinSetupArgumentsObject;
+    instr_callBuiltinArgumentsLength callBuiltinArgumentsLength;
+    instr_callBuiltinArgumentAt callBuiltinArgumentAt;
     instr_callBuiltinConvertThisToObject callBuiltinConvertThisToObject;
     instr_createValue createValue;
     instr_createProperty createProperty;
@@ -773,6 +803,8 @@ union Instr
     instr_jump jump;
     instr_jumpEq jumpEq;
     instr_jumpNe jumpNe;
+    instr_compareJumpEq compareJumpEq;
+    instr_compareJumpNe compareJumpNe;
     instr_unot unot;
     instr_unotBool unotBool;
     instr_uplus uplus;
@@ -797,7 +829,7 @@ union Instr
     instr_sub sub;
     instr_binopContext binopContext;
     instr_loadThis loadThis;
-    instr_loadQmlIdArray loadQmlIdArray;
+    instr_loadQmlIdObject loadQmlIdObject;
     instr_loadQmlImportedScripts loadQmlImportedScripts;
     instr_loadQmlContextObject loadQmlContextObject;
     instr_loadQmlScopeObject loadQmlScopeObject;
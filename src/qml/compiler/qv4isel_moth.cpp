@@ -48,6 +48,7 @@
 #include <private/qv4regexpobject_p.h>
 #include <private/qv4compileddata_p.h>
 #include <private/qqmlengine_p.h>
+#include <QIODevice>
 
 #undef USE_TYPE_INFO
 
@@ -123,6 +124,30 @@ inline QV4::Runtime::BinaryOperation aluOpFunction(IR::AluOp op)
     }
 };
 
+inline QV4::Runtime::CompareOperation compareOpFunction(IR::AluOp op)
+{
+    switch (op) {
+    case IR::OpGt:
+        return QV4::Runtime::compareGreaterThan;
+    case IR::OpLt:
+        return QV4::Runtime::compareLessThan;
+    case IR::OpGe:
+        return QV4::Runtime::compareGreaterEqual;
+    case IR::OpLe:
+        return QV4::Runtime::compareLessEqual;
+    case IR::OpEqual:
+        return QV4::Runtime::compareEqual;
+    case IR::OpNotEqual:
+        return QV4::Runtime::compareNotEqual;
+    case IR::OpStrictEqual:
+        return QV4::Runtime::compareStrictEqual;
+    case IR::OpStrictNotEqual:
+        return QV4::Runtime::compareStrictNotEqual;
+    default:
+        return 0;
+    }
+}
+
 inline bool isNumberType(IR::Expr *e)
 {
     switch (e->type) {
@@ -570,9 +595,10 @@ void InstructionSelection::loadThisObject(IR::Temp *temp)
     addInstruction(load);
 }
 
-void InstructionSelection::loadQmlIdArray(IR::Temp *temp)
+void InstructionSelection::loadQmlIdObject(int index, IR::Temp *temp)
 {
-    Instruction::LoadQmlIdArray load;
+    Instruction::LoadQmlIdObject load;
+    load.index = index;
     load.result = getResultParam(temp);
     addInstruction(load);
 }
@@ -708,8 +734,9 @@ void InstructionSelection::setQObjectProperty(IR::Expr *source, IR::Expr *target
     addInstruction(store);
 }
 
-void InstructionSelection::getQObjectProperty(IR::Expr *base, int propertyIndex, bool captureRequired, int attachedPropertiesId, IR::Temp *target)
+void InstructionSelection::getQObjectProperty(IR::Expr *base, QQmlPropertyData *property, bool captureRequired, int attachedPropertiesId, IR::Temp *target)
 {
+    const int propertyIndex = property->coreIndex;
     if (attachedPropertiesId != 0) {
         Instruction::LoadAttachedQObjectProperty load;
         load.propertyIndex = propertyIndex;
@@ -1058,6 +1085,38 @@ void InstructionSelection::visitCJump(IR::CJump *s)
         addInstruction(debug);
     }
 
+    if (IR::Binop *b = s->cond->asBinop()) {
+        if (QV4::Runtime::CompareOperation cmp = compareOpFunction(b->op)) {
+            // Fuse the comparison with the branch, so that the boolean result never
+            // goes through a temp and the interpreter dispatches one instruction less.
+            if (s->iftrue == _nextBlock) {
+                Instruction::CompareJumpNe jump;
+                jump.offset = 0;
+                jump.cmp = cmp;
+                jump.lhs = getParam(b->left);
+                jump.rhs = getParam(b->right);
+                ptrdiff_t falseLoc = addInstruction(jump) + (((const char *)&jump.offset) - ((const char *)&jump));
+                _patches[s->iffalse].append(falseLoc);
+            } else {
+                Instruction::CompareJumpEq jump;
+                jump.offset = 0;
+                jump.cmp = cmp;
+                jump.lhs = getParam(b->left);
+                jump.rhs = getParam(b->right);
+                ptrdiff_t trueLoc = addInstruction(jump) + (((const char *)&jump.offset) - ((const char *)&jump));
+                _patches[s->iftrue].append(trueLoc);
+
+                if (s->iffalse != _nextBlock) {
+                    Instruction::Jump jump;
+                    jump.offset = 0;
+                    ptrdiff_t falseLoc = addInstruction(jump) + (((const char *)&jump.offset) - ((const char *)&jump));
+                    _patches[s->iffalse].append(falseLoc);
+                }
+            }
+            return;
+        }
+    }
+
     Param condition;
     if (IR::Temp *t = s->cond->asTemp()) {
         condition = getResultParam(t);
@@ -1404,6 +1463,21 @@ void InstructionSelection::callBuiltinSetupArgumentObject(IR::Temp *result)
     addInstruction(call);
 }
 
+void InstructionSelection::callBuiltinArgumentsLength(IR::Temp *result)
+{
+    Instruction::CallBuiltinArgumentsLength call;
+    call.result = getResultParam(result);
+    addInstruction(call);
+}
+
+void InstructionSelection::callBuiltinArgumentAt(IR::Expr *index, IR::Temp *result)
+{
+    Instruction::CallBuiltinArgumentAt call;
+    call.index = getParam(index);
+    call.result = getResultParam(result);
+    addInstruction(call);
+}
+
 
 void QV4::Moth::InstructionSelection::callBuiltinConvertThisToObject()
 {
@@ -1508,3 +1582,118 @@ void CompilationUnit::linkBackendToEngine(QV4::ExecutionEngine *engine)
         runtimeFunctions[i] = runtimeFunction;
     }
 }
+
+// The bytecode is never modified once compiled, so copies share it.
+QV4::CompiledData::CompilationUnit *CompilationUnit::createCodeCopy() const
+{
+    CompilationUnit *unit = new CompilationUnit;
+    unit->codeRefs = codeRefs;
+    return unit;
+}
+
+namespace {
+#define MOTH_COUNT_INSTR(I, FMT) + 1
+enum { InstructionCount = 0 FOR_EACH_MOTH_INSTR(MOTH_COUNT_INSTR) };
+#undef MOTH_COUNT_INSTR
+
+// With the threaded interpreter each instruction starts with the address of its handler, which
+// is only valid in this process. Cache files store the instruction type in its place instead.
+template <typename Callback>
+bool forEachInstruction(QByteArray &code, Callback callback)
+{
+    char *it = code.data();
+    char *end = it + code.size();
+    while (it < end) {
+        Instr *instr = reinterpret_cast<Instr *>(it);
+        const int size = callback(instr);
+        if (size <= 0)
+            return false;
+        it += size;
+    }
+    return it == end;
+}
+
+struct UnthreadInstruction
+{
+    QHash<void *, int> types;
+
+    UnthreadInstruction()
+    {
+#ifdef MOTH_THREADED_INTERPRETER
+        void **jumpTable = VME::instructionJumpTable();
+        for (int i = 0; i < InstructionCount; ++i)
+            types.insert(jumpTable[i], i);
+#endif
+    }
+
+    int operator()(Instr *instr) const
+    {
+#ifdef MOTH_THREADED_INTERPRETER
+        QHash<void *, int>::ConstIterator type = types.constFind(instr->common.code);
+        if (type == types.constEnd())
+            return 0;
+        instr->common.code = reinterpret_cast<void *>(quintptr(*type));
+        return Instr::size(static_cast<Instr::Type>(*type));
+#else
+        return Instr::size(static_cast<Instr::Type>(instr->common.instructionType));
+#endif
+    }
+};
+
+struct ThreadInstruction
+{
+    int operator()(Instr *instr) const
+    {
+#ifdef MOTH_THREADED_INTERPRETER
+        const quintptr type = reinterpret_cast<quintptr>(instr->common.code);
+        if (type >= InstructionCount)
+            return 0;
+        instr->common.code = VME::instructionJumpTable()[type];
+        return Instr::size(static_cast<Instr::Type>(type));
+#else
+        if (instr->common.instructionType >= InstructionCount)
+            return 0;
+        return Instr::size(static_cast<Instr::Type>(instr->common.instructionType));
+#endif
+    }
+};
+}
+
+bool CompilationUnit::saveCodeToDisk(QIODevice *device, QString *errorString) const
+{
+    const UnthreadInstruction unthread;
+    foreach (QByteArray code, codeRefs) {
+        if (!forEachInstruction(code, unthread)) {
+            *errorString = QStringLiteral("Unknown instruction in function bytecode");
+            return false;
+        }
+
+        const quint32 codeSize = code.size();
+        if (device->write(reinterpret_cast<const char *>(&codeSize), sizeof(codeSize)) != qint64(sizeof(codeSize))
+            || device->write(code) != code.size()) {
+            *errorString = device->errorString();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CompilationUnit::loadCodeFromDisk(QIODevice *device, QString *errorString)
+{
+    codeRefs.resize(data->functionTableSize);
+    for (uint i = 0; i < data->functionTableSize; ++i) {
+        quint32 codeSize = 0;
+        if (device->read(reinterpret_cast<char *>(&codeSize), sizeof(codeSize)) != qint64(sizeof(codeSize))) {
+            *errorString = QStringLiteral("Truncated bytecode in cache file");
+            return false;
+        }
+
+        QByteArray code = device->read(codeSize);
+        if (quint32(code.size()) != codeSize || !forEachInstruction(code, ThreadInstruction())) {
+            *errorString = QStringLiteral("Truncated or corrupt bytecode in cache file");
+            return false;
+        }
+        codeRefs[i] = code;
+    }
+    return true;
+}
@@ -59,6 +59,10 @@ struct CompilationUnit : public QV4::CompiledData::CompilationUnit
     virtual ~CompilationUnit();
     virtual void linkBackendToEngine(QV4::ExecutionEngine *engine);
 
+    virtual bool saveCodeToDisk(QIODevice *device, QString *errorString) const;
+    virtual bool loadCodeFromDisk(QIODevice *device, QString *errorString);
+    virtual QV4::CompiledData::CompilationUnit *createCodeCopy() const;
+
     QVector<QByteArray> codeRefs;
 
 };
@@ -101,6 +105,8 @@ protected:
     virtual void callBuiltinDefineArray(IR::Temp *result, IR::ExprList *args);
     virtual void callBuiltinDefineObjectLiteral(IR::Temp *result, int keyValuePairCount, IR::ExprList *keyValuePairs, IR::ExprList *arrayEntries, bool needSparseArray);
     virtual void callBuiltinSetupArgumentObject(IR::Temp *result);
+    virtual void callBuiltinArgumentsLength(IR::Temp *result);
+    virtual void callBuiltinArgumentAt(IR::Expr *index, IR::Temp *result);
     virtual void callBuiltinConvertThisToObject();
     virtual void callValue(IR::Temp *value, IR::ExprList *args, IR::Temp *result);
     virtual void callProperty(IR::Expr *base, const QString &name, IR::ExprList *args, IR::Temp *result);
@@ -110,7 +116,7 @@ protected:
     virtual void constructProperty(IR::Temp *base, const QString &name, IR::ExprList *args, IR::Temp *result);
     virtual void constructValue(IR::Temp *value, IR::ExprList *args, IR::Temp *result);
     virtual void loadThisObject(IR::Temp *temp);
-    virtual void loadQmlIdArray(IR::Temp *temp);
+    virtual void loadQmlIdObject(int index, IR::Temp *temp);
     virtual void loadQmlImportedScripts(IR::Temp *temp);
     virtual void loadQmlContextObject(IR::Temp *temp);
     virtual void loadQmlScopeObject(IR::Temp *temp);
@@ -124,7 +130,7 @@ protected:
     virtual void getProperty(IR::Expr *base, const QString &name, IR::Temp *target);
     virtual void setProperty(IR::Expr *source, IR::Expr *targetBase, const QString &targetName);
     virtual void setQObjectProperty(IR::Expr *source, IR::Expr *targetBase, int propertyIndex);
-    virtual void getQObjectProperty(IR::Expr *base, int propertyIndex, bool captureRequired, int attachedPropertiesId, IR::Temp *target);
+    virtual void getQObjectProperty(IR::Expr *base, QQmlPropertyData *property, bool captureRequired, int attachedPropertiesId, IR::Temp *target);
     virtual void getElement(IR::Expr *base, IR::Expr *index, IR::Temp *target);
     virtual void setElement(IR::Expr *source, IR::Expr *targetBase, IR::Expr *targetIndex);
     virtual void copyValue(IR::Temp *sourceTemp, IR::Temp *targetTemp);
@@ -196,6 +202,8 @@ public:
     { return new InstructionSelection(qmlEngine, execAllocator, module, jsGenerator); }
     virtual bool jitCompileRegexps() const
     { return false; }
+    virtual QV4::CompiledData::CompilationUnit *createUnitForLoading()
+    { return new CompilationUnit; }
 };
 
 template<int InstrT>
@@ -42,6 +42,7 @@
 #include "qv4jsir_p.h"
 #include "qv4isel_p.h"
 #include "qv4isel_util_p.h"
+#include "qv4ssa_p.h"
 #include <private/qv4value_inl_p.h>
 #ifndef V4_BOOTSTRAP
 #include <private/qqmlpropertycache_p.h>
@@ -81,6 +82,8 @@ EvalISelFactory::~EvalISelFactory()
 
 QV4::CompiledData::CompilationUnit *EvalInstructionSelection::compile(bool generateUnitData)
 {
+    IR::Optimizer::inlineFunctions(irModule);
+
     for (int i = 0; i < irModule->functions.size(); ++i)
         run(i);
 
@@ -101,8 +104,8 @@ void IRDecoder::visitMove(IR::Move *s)
         if (IR::Name *n = s->source->asName()) {
             if (n->id && *n->id == QStringLiteral("this")) // TODO: `this' should be a builtin.
                 loadThisObject(t);
-            else if (n->builtin == IR::Name::builtin_qml_id_array)
-                loadQmlIdArray(t);
+            else if (n->builtin == IR::Name::builtin_qml_id_object)
+                loadQmlIdObject(n->idObjectIndex, t);
             else if (n->builtin == IR::Name::builtin_qml_context_object)
                 loadQmlContextObject(t);
             else if (n->builtin == IR::Name::builtin_qml_scope_object)
@@ -162,7 +165,7 @@ void IRDecoder::visitMove(IR::Move *s)
                         captureRequired = false;
                     }
                 }
-                getQObjectProperty(m->base, m->property->coreIndex, captureRequired, attachedPropertiesId, t);
+                getQObjectProperty(m->base, m->property, captureRequired, attachedPropertiesId, t);
 #endif // V4_BOOTSTRAP
                 return;
             } else if (m->base->asTemp() || m->base->asConst()) {
@@ -393,6 +396,14 @@ void IRDecoder::callBuiltin(IR::Call *call, IR::Temp *result)
         callBuiltinSetupArgumentObject(result);
         return;
 
+    case IR::Name::builtin_arguments_length:
+        callBuiltinArgumentsLength(result);
+        return;
+
+    case IR::Name::builtin_argument_at:
+        callBuiltinArgumentAt(call->args->expr, result);
+        return;
+
     case IR::Name::builtin_convert_this_to_object:
         callBuiltinConvertThisToObject();
         return;
@@ -96,6 +96,9 @@ public:
     virtual ~EvalISelFactory() = 0;
     virtual EvalInstructionSelection *create(QQmlEnginePrivate *qmlEngine, QV4::ExecutableAllocator *execAllocator, IR::Module *module, QV4::Compiler::JSUnitGenerator *jsGenerator) = 0;
     virtual bool jitCompileRegexps() const = 0;
+    // Returns an empty compilation unit that can be populated through CompilationUnit::loadFromDisk,
+    // or 0 if the backend cannot restore its code from a cache file.
+    virtual QV4::CompiledData::CompilationUnit *createUnitForLoading() { return 0; }
 };
 
 namespace IR {
@@ -133,6 +136,8 @@ public: // to implement by subclasses:
     virtual void callBuiltinDefineArray(IR::Temp *result, IR::ExprList *args) = 0;
     virtual void callBuiltinDefineObjectLiteral(IR::Temp *result, int keyValuePairCount, IR::ExprList *keyValuePairs, IR::ExprList *arrayEntries, bool needSparseArray) = 0;
     virtual void callBuiltinSetupArgumentObject(IR::Temp *result) = 0;
+    virtual void callBuiltinArgumentsLength(IR::Temp *result) = 0;
+    virtual void callBuiltinArgumentAt(IR::Expr *index, IR::Temp *result) = 0;
     virtual void callBuiltinConvertThisToObject() = 0;
     virtual void callValue(IR::Temp *value, IR::ExprList *args, IR::Temp *result) = 0;
     virtual void callProperty(IR::Expr *base, const QString &name, IR::ExprList *args, IR::Temp *result) = 0;
@@ -142,7 +147,7 @@ public: // to implement by subclasses:
     virtual void constructProperty(IR::Temp *base, const QString &name, IR::ExprList *args, IR::Temp *result) = 0;
     virtual void constructValue(IR::Temp *value, IR::ExprList *args, IR::Temp *result) = 0;
     virtual void loadThisObject(IR::Temp *temp) = 0;
-    virtual void loadQmlIdArray(IR::Temp *temp) = 0;
+    virtual void loadQmlIdObject(int index, IR::Temp *temp) = 0;
     virtual void loadQmlImportedScripts(IR::Temp *temp) = 0;
     virtual void loadQmlContextObject(IR::Temp *temp) = 0;
     virtual void loadQmlScopeObject(IR::Temp *temp) = 0;
@@ -154,7 +159,7 @@ public: // to implement by subclasses:
     virtual void setActivationProperty(IR::Expr *source, const QString &targetName) = 0;
     virtual void initClosure(IR::Closure *closure, IR::Temp *target) = 0;
     virtual void getProperty(IR::Expr *base, const QString &name, IR::Temp *target) = 0;
-    virtual void getQObjectProperty(IR::Expr *base, int propertyIndex, bool captureRequired, int attachedPropertiesId, IR::Temp *targetTemp) = 0;
+    virtual void getQObjectProperty(IR::Expr *base, QQmlPropertyData *property, bool captureRequired, int attachedPropertiesId, IR::Temp *targetTemp) = 0;
     virtual void setProperty(IR::Expr *source, IR::Expr *targetBase, const QString &targetName) = 0;
     virtual void setQObjectProperty(IR::Expr *source, IR::Expr *targetBase, int propertyIndex) = 0;
     virtual void getElement(IR::Expr *base, IR::Expr *index, IR::Temp *target) = 0;
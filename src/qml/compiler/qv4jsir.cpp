@@ -383,6 +383,7 @@ void Name::initGlobal(const QString *id, quint32 line, quint32 column)
     this->global = true;
     this->qmlSingleton = false;
     this->freeOfSideEffects = false;
+    this->idObjectIndex = -1;
     this->line = line;
     this->column = column;
 }
@@ -394,6 +395,7 @@ void Name::init(const QString *id, quint32 line, quint32 column)
     this->global = false;
     this->qmlSingleton = false;
     this->freeOfSideEffects = false;
+    this->idObjectIndex = -1;
     this->line = line;
     this->column = column;
 }
@@ -405,6 +407,7 @@ void Name::init(Builtin builtin, quint32 line, quint32 column)
     this->global = false;
     this->qmlSingleton = false;
     this->freeOfSideEffects = false;
+    this->idObjectIndex = -1;
     this->line = line;
     this->column = column;
 }
@@ -442,10 +445,14 @@ static const char *builtin_to_string(Name::Builtin b)
         return "builtin_define_object_literal";
     case IR::Name::builtin_setup_argument_object:
         return "builtin_setup_argument_object";
+    case IR::Name::builtin_arguments_length:
+        return "builtin_arguments_length";
+    case IR::Name::builtin_argument_at:
+        return "builtin_argument_at";
     case IR::Name::builtin_convert_this_to_object:
         return "builtin_convert_this_to_object";
-    case IR::Name::builtin_qml_id_array:
-        return "builtin_qml_id_array";
+    case IR::Name::builtin_qml_id_object:
+        return "builtin_qml_id_object";
     case IR::Name::builtin_qml_imported_scripts_object:
         return "builtin_qml_imported_scripts_object";
     case IR::Name::builtin_qml_scope_object:
@@ -462,6 +469,8 @@ void Name::dump(QTextStream &out) const
         out << *id;
     else
         out << builtin_to_string(builtin);
+    if (builtin == builtin_qml_id_object)
+        out << '[' << idObjectIndex << ']';
 }
 
 void Temp::dump(QTextStream &out) const
@@ -354,8 +354,10 @@ struct Name: Expr {
         builtin_define_array,
         builtin_define_object_literal,
         builtin_setup_argument_object,
+        builtin_arguments_length,
+        builtin_argument_at,
         builtin_convert_this_to_object,
-        builtin_qml_id_array,
+        builtin_qml_id_object,
         builtin_qml_imported_scripts_object,
         builtin_qml_context_object,
         builtin_qml_scope_object
@@ -366,6 +368,8 @@ struct Name: Expr {
     bool global : 1;
     bool qmlSingleton : 1;
     bool freeOfSideEffects : 1;
+    // Index into QQmlContextData::idValues for builtin_qml_id_object, -1 otherwise.
+    int idObjectIndex;
     quint32 line;
     quint32 column;
 
@@ -1080,6 +1084,7 @@ public:
         newName->global = n->global;
         newName->qmlSingleton = n->qmlSingleton;
         newName->freeOfSideEffects = n->freeOfSideEffects;
+        newName->idObjectIndex = n->idObjectIndex;
         newName->line = n->line;
         newName->column = n->column;
         return newName;
@@ -3026,7 +3026,7 @@ private:
                     if (n2->id)
                         return *n1->id == *n2->id;
                 } else {
-                    return n1->builtin == n2->builtin;
+                    return n1->builtin == n2->builtin && n1->idObjectIndex == n2->idObjectIndex;
                 }
             }
         }
@@ -3474,6 +3474,208 @@ void optimizeSSA(IR::Function *function, DefUsesCalculator &defUses, DominatorTr
     W.cleanup(function);
 }
 
+/*
+ * Loop-invariant code motion: computations inside a loop that have no side-effects, and whose
+ * operands are all defined outside of that loop, are moved into the block that enters the loop.
+ * Loops are found through their back-edges (an edge to a block that dominates the source of the
+ * edge), and are processed inner loops first, so an invariant can travel out of several nested
+ * loops.
+ *
+ * Only expressions that cannot run any user code are moved: strict (in)equality on anything, and
+ * arithmetic, bitwise and comparison operators or conversions on values that are known to be
+ * numbers, booleans, null or undefined. Property and element loads stay where they are: even
+ * loading "length" can invoke a getter, or observe a change made by one.
+ */
+class LoopInvariantCodeMotion
+{
+    IR::Function *function;
+    DefUsesCalculator &defUses;
+    const DominatorTree &df;
+
+    struct Loop {
+        BasicBlock *header;
+        QBitArray body;
+        int size;
+
+        bool contains(BasicBlock *bb) const { return body.at(bb->index()); }
+        static bool lessThan(const Loop &l1, const Loop &l2) { return l1.size < l2.size; }
+    };
+
+public:
+    LoopInvariantCodeMotion(IR::Function *function, DefUsesCalculator &defUses, const DominatorTree &df)
+        : function(function)
+        , defUses(defUses)
+        , df(df)
+    {}
+
+    void run()
+    {
+        QVector<Loop> loops = findLoops();
+        std::sort(loops.begin(), loops.end(), Loop::lessThan);
+        foreach (const Loop &loop, loops) {
+            if (BasicBlock *preheader = preheaderOf(loop))
+                hoistInvariants(loop, preheader);
+        }
+    }
+
+private:
+    QVector<Loop> findLoops() const
+    {
+        QHash<BasicBlock *, int> loopForHeader;
+        QVector<Loop> loops;
+        foreach (BasicBlock *bb, function->basicBlocks()) {
+            if (bb->isRemoved())
+                continue;
+            foreach (BasicBlock *header, bb->out) {
+                if (header != bb && !df.dominates(header, bb))
+                    continue;
+
+                // bb -> header is a back-edge: everything that reaches bb without going through
+                // the header is part of the loop.
+                int loopIndex = loopForHeader.value(header, -1);
+                if (loopIndex == -1) {
+                    Loop loop;
+                    loop.header = header;
+                    loop.body = QBitArray(function->basicBlockCount());
+                    loop.body.setBit(header->index());
+                    loop.size = 1;
+                    loopIndex = loops.size();
+                    loopForHeader.insert(header, loopIndex);
+                    loops.append(loop);
+                }
+
+                Loop &loop = loops[loopIndex];
+                QVector<BasicBlock *> todo;
+                if (!loop.contains(bb)) {
+                    loop.body.setBit(bb->index());
+                    ++loop.size;
+                    todo.append(bb);
+                }
+                while (!todo.isEmpty()) {
+                    BasicBlock *member = todo.last();
+                    todo.removeLast();
+                    foreach (BasicBlock *pred, member->in) {
+                        if (pred->isRemoved() || loop.contains(pred))
+                            continue;
+                        loop.body.setBit(pred->index());
+                        ++loop.size;
+                        todo.append(pred);
+                    }
+                }
+            }
+        }
+        return loops;
+    }
+
+    // The loop must be entered through a single edge, from a block that only leads into the loop.
+    // After splitting the critical edges, that block is the only predecessor of the header that
+    // is not part of the loop.
+    static BasicBlock *preheaderOf(const Loop &loop)
+    {
+        BasicBlock *preheader = 0;
+        foreach (BasicBlock *pred, loop.header->in) {
+            if (pred->isRemoved() || loop.contains(pred))
+                continue;
+            if (preheader)
+                return 0;
+            preheader = pred;
+        }
+        if (!preheader || preheader->out.size() != 1 || preheader->catchBlock != loop.header->catchBlock)
+            return 0;
+        return preheader;
+    }
+
+    void hoistInvariants(const Loop &loop, BasicBlock *preheader)
+    {
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            foreach (BasicBlock *bb, function->basicBlocks()) {
+                if (bb->isRemoved() || !loop.contains(bb))
+                    continue;
+
+                for (int i = 0; i < bb->statementCount(); ) {
+                    Move *m = bb->statements().at(i)->asMove();
+                    Temp *target = m ? m->target->asTemp() : 0;
+                    if (!target || !unescapableTemp(target, function) || !isInvariant(m->source, loop)) {
+                        ++i;
+                        continue;
+                    }
+
+                    bb->removeStatement(i);
+                    preheader->insertStatementBeforeTerminator(m);
+                    defUses.addTemp(target, m, preheader);
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    static bool isPrimitive(Expr *e)
+    {
+        const int primitiveTypes = UndefinedType | NullType | BoolType | NumberType;
+        return e->type != UnknownType && (e->type & ~primitiveTypes) == 0;
+    }
+
+    bool isInvariant(Expr *e, const Loop &loop) const
+    {
+        if (e->asConst())
+            return true;
+
+        if (Temp *t = e->asTemp()) {
+            if (!unescapableTemp(t, function) || !defUses.defStmt(*t))
+                return false;
+            return !loop.contains(defUses.defStmtBlock(*t));
+        }
+
+        if (Convert *c = e->asConvert())
+            return isPrimitive(c->expr) && isInvariant(c->expr, loop);
+
+        if (Unop *u = e->asUnop()) {
+            switch (u->op) {
+            case OpNot:
+            case OpUMinus:
+            case OpUPlus:
+            case OpCompl:
+                return isPrimitive(u->expr) && isInvariant(u->expr, loop);
+            default:
+                return false;
+            }
+        }
+
+        if (Binop *b = e->asBinop()) {
+            switch (b->op) {
+            case OpStrictEqual:
+            case OpStrictNotEqual:
+                return isInvariant(b->left, loop) && isInvariant(b->right, loop);
+            case OpBitAnd:
+            case OpBitOr:
+            case OpBitXor:
+            case OpAdd:
+            case OpSub:
+            case OpMul:
+            case OpDiv:
+            case OpMod:
+            case OpLShift:
+            case OpRShift:
+            case OpURShift:
+            case OpGt:
+            case OpLt:
+            case OpGe:
+            case OpLe:
+            case OpEqual:
+            case OpNotEqual:
+                return isPrimitive(b->left) && isPrimitive(b->right)
+                        && isInvariant(b->left, loop) && isInvariant(b->right, loop);
+            default:
+                return false;
+            }
+        }
+
+        return false;
+    }
+};
+
 class InputOutputCollector: protected StmtVisitor, protected ExprVisitor {
     IR::Function *function;
 
@@ -3673,6 +3875,335 @@ void removeUnreachleBlocks(IR::Function *function)
     function->setScheduledBlocks(newSchedule);
     function->renumberBasicBlocks();
 }
+
+// Maps the temps of a cloned callee expression onto the caller: the arguments, locals and
+// virtual registers of the callee become fresh virtual registers of the caller, and references
+// to variables of enclosing functions get one scope closer.
+class InlinedTempRenamer: public ExprVisitor
+{
+    unsigned argumentBase;
+    unsigned localBase;
+    unsigned tempBase;
+
+public:
+    InlinedTempRenamer(unsigned argumentBase, unsigned localBase, unsigned tempBase)
+        : argumentBase(argumentBase)
+        , localBase(localBase)
+        , tempBase(tempBase)
+    {}
+
+    Expr *operator()(Expr *e)
+    {
+        e->accept(this);
+        return e;
+    }
+
+protected:
+    virtual void visitConst(Const *) {}
+    virtual void visitString(String *) {}
+    virtual void visitRegExp(RegExp *) {}
+    virtual void visitName(Name *) {}
+    virtual void visitTemp(Temp *t)
+    {
+        const unsigned isArgumentsOrEval = t->isArgumentsOrEval;
+        const unsigned isReadOnly = t->isReadOnly;
+        switch (t->kind) {
+        case Temp::Formal:
+            t->init(Temp::VirtualRegister, argumentBase + t->index, 0);
+            break;
+        case Temp::Local:
+            t->init(Temp::VirtualRegister, localBase + t->index, 0);
+            break;
+        case Temp::VirtualRegister:
+            t->init(Temp::VirtualRegister, tempBase + t->index, 0);
+            break;
+        case Temp::ScopedFormal:
+            t->init(t->scope == 1 ? Temp::Formal : Temp::ScopedFormal, t->index, t->scope - 1);
+            break;
+        case Temp::ScopedLocal:
+            t->init(t->scope == 1 ? Temp::Local : Temp::ScopedLocal, t->index, t->scope - 1);
+            break;
+        default:
+            Q_UNREACHABLE();
+        }
+        t->isArgumentsOrEval = isArgumentsOrEval;
+        t->isReadOnly = isReadOnly;
+    }
+    virtual void visitClosure(Closure *) {}
+    virtual void visitConvert(Convert *e) { e->expr->accept(this); }
+    virtual void visitUnop(Unop *e) { e->expr->accept(this); }
+    virtual void visitBinop(Binop *e) { e->left->accept(this); e->right->accept(this); }
+    virtual void visitCall(Call *e) {
+        e->base->accept(this);
+        for (ExprList *it = e->args; it; it = it->next)
+            it->expr->accept(this);
+    }
+    virtual void visitNew(New *e) {
+        e->base->accept(this);
+        for (ExprList *it = e->args; it; it = it->next)
+            it->expr->accept(this);
+    }
+    virtual void visitSubscript(Subscript *e) { e->base->accept(this); e->index->accept(this); }
+    virtual void visitMember(Member *e) { e->base->accept(this); }
+};
+
+/*
+ * Inlines calls to small function declarations into the function declaring them. A declared
+ * function is stored in a local at the start of its outer function, and calls to it show up as
+ * calls on that local. As the local can be rebound (by the function itself, by nested functions
+ * or through direct eval in a nested function), every inlined call site checks that the local
+ * still holds the function it was declared with, and falls back to a real call otherwise:
+ *
+ *         ...                                  ...
+ *         t = call local(a, b)      =>         cjump local === declared, prologue, fallback
+ *         ...                              prologue:
+ *                                              arg0 = a; arg1 = b; jump callee body
+ *                                          callee body:
+ *                                              ... t = returned value; jump continuation
+ *                                          fallback:
+ *                                              t = call local(a, b); jump continuation
+ *                                          continuation:
+ *                                              ...
+ *
+ * Only one level is inlined: calls in an inlined body are left alone, which also keeps
+ * recursive callees finite. This has to run on the whole module before any function in it is
+ * optimized, because the callee's body is copied from its unoptimized IR.
+ */
+class FunctionInliner
+{
+    enum {
+        MaximumCalleeStatements = 32,
+        MaximumInlinedCallsPerFunction = 16
+    };
+
+    struct Candidate {
+        IR::Function *callee;
+        Move *declaration;
+        int declaredFunctionTemp; // temp holding the declared function, -1 while unused
+    };
+    typedef QHash<unsigned, Candidate> Candidates; // by index of the local in the caller
+
+    Module *module;
+
+public:
+    FunctionInliner(Module *module)
+        : module(module)
+    {}
+
+    void run()
+    {
+        if (module->debugMode)
+            return;
+        foreach (IR::Function *caller, module->functions)
+            inlineCalls(caller);
+    }
+
+private:
+    static bool isInlinable(IR::Function *caller, IR::Function *callee)
+    {
+        if (callee->outer != caller || callee->hasDirectEval || callee->usesArgumentsObject
+                || callee->usesThis || callee->isNamedExpression || callee->hasTry || callee->hasWith
+                || !callee->nestedFunctions.isEmpty() || callee->isStrict != caller->isStrict)
+            return false;
+
+        int statementCount = 0;
+        foreach (BasicBlock *bb, callee->basicBlocks()) {
+            if (bb->isRemoved())
+                continue;
+            statementCount += bb->statementCount();
+            if (statementCount > MaximumCalleeStatements)
+                return false;
+        }
+        return true;
+    }
+
+    static Call *inlinableCall(Stmt *s, const Candidates &candidates, Temp **target)
+    {
+        Call *call = 0;
+        *target = 0;
+        if (Exp *e = s->asExp()) {
+            call = e->expr->asCall();
+        } else if (Move *m = s->asMove()) {
+            call = m->source->asCall();
+            *target = m->target->asTemp();
+            if (!*target)
+                return 0;
+        }
+        if (!call)
+            return 0;
+
+        Temp *base = call->base->asTemp();
+        if (!base || base->kind != Temp::Local || !candidates.contains(base->index))
+            return 0;
+        return call;
+    }
+
+    void inlineCalls(IR::Function *caller)
+    {
+        if (caller->nestedFunctions.isEmpty() || caller->hasTry || caller->hasWith || caller->hasDirectEval
+                || caller->basicBlockCount() == 0)
+            return;
+
+        // Function declarations are stored in their locals at the start of the entry block.
+        BasicBlock *entryBlock = caller->basicBlock(0);
+        Candidates candidates;
+        foreach (Stmt *s, entryBlock->statements()) {
+            Move *m = s->asMove();
+            if (!m)
+                continue;
+            Temp *local = m->target->asTemp();
+            Closure *closure = m->source->asClosure();
+            if (!local || local->kind != Temp::Local || !closure)
+                continue;
+            IR::Function *callee = module->functions.at(closure->value);
+            if (!isInlinable(caller, callee))
+                continue;
+            Candidate candidate = { callee, m, -1 };
+            candidates.insert(local->index, candidate);
+        }
+        if (candidates.isEmpty())
+            return;
+
+        // Keep a copy of every declared function that is called, to guard the call sites with.
+        int callCount = 0;
+        const QVector<BasicBlock *> blocks = caller->basicBlocks();
+        foreach (BasicBlock *bb, blocks) {
+            if (bb->isRemoved())
+                continue;
+            foreach (Stmt *s, bb->statements()) {
+                Temp *target;
+                Call *call = inlinableCall(s, candidates, &target);
+                if (!call || ++callCount > MaximumInlinedCallsPerFunction)
+                    continue;
+                Candidate &candidate = candidates[call->base->asTemp()->index];
+                if (candidate.declaredFunctionTemp != -1)
+                    continue;
+                candidate.declaredFunctionTemp = entryBlock->newTemp();
+                Move *copy = caller->New<Move>();
+                copy->init(entryBlock->TEMP(candidate.declaredFunctionTemp), CloneExpr::cloneTemp(candidate.declaration->target->asTemp(), caller));
+                entryBlock->insertStatementBefore(entryBlock->statements().indexOf(candidate.declaration) + 1, copy);
+            }
+        }
+        if (callCount == 0)
+            return;
+
+        int inlinedCalls = 0;
+        foreach (BasicBlock *bb, blocks) {
+            if (bb->isRemoved())
+                continue;
+            BasicBlock *current = bb;
+            while (current && inlinedCalls < MaximumInlinedCallsPerFunction) {
+                BasicBlock *continuation = 0;
+                for (int i = 0, ei = current->statementCount(); i != ei; ++i) {
+                    Temp *target;
+                    Call *call = inlinableCall(current->statements().at(i), candidates, &target);
+                    if (!call)
+                        continue;
+                    const Candidate &candidate = candidates.value(call->base->asTemp()->index);
+                    if (candidate.declaredFunctionTemp == -1)
+                        continue;
+                    continuation = inlineCall(caller, current, i, call, target, candidate);
+                    ++inlinedCalls;
+                    break;
+                }
+                current = continuation;
+            }
+        }
+    }
+
+    // Replaces the call at the given statement index in bb, and returns the block that holds the
+    // statements following the call.
+    static BasicBlock *inlineCall(IR::Function *caller, BasicBlock *bb, int callIndex, Call *call, Temp *target,
+                                  const Candidate &candidate)
+    {
+        IR::Function *callee = candidate.callee;
+        BasicBlock *group = bb->isGroupStart() ? bb : bb->containingGroup();
+        BasicBlock *catchBlock = bb->catchBlock;
+
+        BasicBlock *prologue = caller->newBasicBlock(group, catchBlock);
+        BasicBlock *fallback = caller->newBasicBlock(group, catchBlock);
+        BasicBlock *continuation = caller->newBasicBlock(group, catchBlock);
+
+        // Move everything after the call, including the outgoing edges, to the continuation.
+        Stmt *callStatement = bb->statements().at(callIndex);
+        for (int i = callIndex + 1, ei = bb->statementCount(); i != ei; ++i)
+            continuation->appendStatement(bb->statements().at(i));
+        while (bb->statementCount() > callIndex)
+            bb->removeStatement(bb->statementCount() - 1);
+        foreach (BasicBlock *out, bb->out) {
+            continuation->out.append(out);
+            out->in[out->in.indexOf(bb)] = continuation;
+        }
+        bb->out.clear();
+
+        Temp *local = call->base->asTemp();
+        bb->CJUMP(bb->BINOP(OpStrictEqual, CloneExpr::cloneTemp(local, caller), bb->TEMP(candidate.declaredFunctionTemp)),
+                  prologue, fallback);
+
+        fallback->appendStatement(callStatement);
+        fallback->JUMP(continuation);
+
+        const unsigned argumentBase = caller->tempCount;
+        const unsigned localBase = argumentBase + callee->formals.size();
+        const unsigned tempBase = localBase + callee->locals.size();
+        caller->tempCount = tempBase + callee->tempCount;
+        caller->maxNumberOfArguments = qMax(caller->maxNumberOfArguments, callee->maxNumberOfArguments);
+        caller->idObjectDependencies.unite(callee->idObjectDependencies);
+        caller->contextObjectPropertyDependencies.unite(callee->contextObjectPropertyDependencies);
+        caller->scopeObjectPropertyDependencies.unite(callee->scopeObjectPropertyDependencies);
+
+        ExprList *arg = call->args;
+        for (int i = 0, ei = callee->formals.size(); i != ei; ++i) {
+            Expr *value = arg ? static_cast<Expr *>(CloneExpr::cloneTemp(arg->expr->asTemp(), caller))
+                              : prologue->CONST(UndefinedType, 0);
+            prologue->MOVE(prologue->TEMP(argumentBase + i), value);
+            if (arg)
+                arg = arg->next;
+        }
+
+        QHash<BasicBlock *, BasicBlock *> clones;
+        foreach (BasicBlock *calleeBlock, callee->basicBlocks()) {
+            if (!calleeBlock->isRemoved())
+                clones.insert(calleeBlock, caller->newBasicBlock(group, catchBlock));
+        }
+
+        InlinedTempRenamer rename(argumentBase, localBase, tempBase);
+        foreach (BasicBlock *calleeBlock, callee->basicBlocks()) {
+            if (calleeBlock->isRemoved())
+                continue;
+            BasicBlock *clone = clones.value(calleeBlock);
+            if (BasicBlock *calleeGroup = calleeBlock->containingGroup())
+                clone->setContainingGroup(clones.value(calleeGroup, group));
+            if (calleeBlock->isGroupStart())
+                clone->markAsGroupStart();
+
+            CloneExpr cloneExpr(clone);
+            foreach (Stmt *s, calleeBlock->statements()) {
+                Stmt *cloned = 0;
+                if (Exp *e = s->asExp()) {
+                    cloned = clone->EXP(rename(cloneExpr(e->expr)));
+                } else if (Move *m = s->asMove()) {
+                    cloned = clone->MOVE(rename(cloneExpr(m->target)), rename(cloneExpr(m->source)));
+                } else if (Jump *j = s->asJump()) {
+                    cloned = clone->JUMP(clones.value(j->target));
+                } else if (CJump *c = s->asCJump()) {
+                    cloned = clone->CJUMP(rename(cloneExpr(c->cond)), clones.value(c->iftrue), clones.value(c->iffalse));
+                } else if (Ret *r = s->asRet()) {
+                    if (target)
+                        cloned = clone->MOVE(CloneExpr::cloneTemp(target, caller), rename(cloneExpr(r->expr)));
+                    clone->JUMP(continuation);
+                } else {
+                    Q_UNREACHABLE();
+                }
+                if (cloned)
+                    cloned->location = s->location;
+            }
+        }
+
+        prologue->JUMP(clones.value(callee->basicBlock(0)));
+        return continuation;
+    }
+};
 } // anonymous namespace
 
 void LifeTimeInterval::setFrom(Stmt *from) {
@@ -3823,6 +4354,13 @@ Optimizer::Optimizer(IR::Function *function)
     , inSSA(false)
 {}
 
+void Optimizer::inlineFunctions(Module *module)
+{
+    static bool doInlining = qgetenv("QV4_NO_INLINE").isEmpty();
+    if (doInlining)
+        FunctionInliner(module).run();
+}
+
 void Optimizer::run(QQmlEnginePrivate *qmlEngine)
 {
 #if defined(SHOW_SSA)
@@ -3879,6 +4417,10 @@ void Optimizer::run(QQmlEnginePrivate *qmlEngine)
 //            qout << "Running SSA optimization..." << endl;
             optimizeSSA(function, defUses, df);
 //            showMeTheCode(function);
+
+//            qout << "Hoisting loop invariants..." << endl;
+            LoopInvariantCodeMotion(function, defUses, df).run();
+//            showMeTheCode(function);
         }
 
 //        qout << "Doing block merging..." << endl;
@@ -143,6 +143,10 @@ class Q_QML_PRIVATE_EXPORT Optimizer
 public:
     Optimizer(Function *function);
 
+    // Inlines small function declarations into their callers, before the functions of the
+    // module are optimized one by one.
+    static void inlineFunctions(Module *module);
+
     void run(QQmlEnginePrivate *qmlEngine);
     void convertOutOfSSA();
 
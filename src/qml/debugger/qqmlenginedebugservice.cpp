@@ -75,6 +75,9 @@ QQmlEngineDebugService::QQmlEngineDebugService(QObject *parent)
     QObject::connect(m_watch, SIGNAL(propertyChanged(int,int,QMetaProperty,QVariant)),
                      this, SLOT(propertyChanged(int,int,QMetaProperty,QVariant)));
 
+    m_batchTimer.setSingleShot(true);
+    QObject::connect(&m_batchTimer, SIGNAL(timeout()), this, SLOT(sendPendingUpdates()));
+
     registerService();
 }
 
@@ -234,8 +237,6 @@ void QQmlEngineDebugService::buildObjectDump(QDataStream &message,
 
     message << childrenCount << recur;
 
-    QList<QQmlObjectProperty> fakeProperties;
-
     for (int ii = 0; ii < children.count(); ++ii) {
         QObject *child = children.at(ii);
         if (qobject_cast<QQmlContext*>(child))
@@ -251,6 +252,13 @@ void QQmlEngineDebugService::buildObjectDump(QDataStream &message,
         return;
     }
 
+    buildPropertyDump(message, object);
+}
+
+void QQmlEngineDebugService::buildPropertyDump(QDataStream &message, QObject *object)
+{
+    QList<QQmlObjectProperty> fakeProperties;
+
     QList<int> propertyIndexes;
     for (int ii = 0; ii < object->metaObject()->propertyCount(); ++ii) {
         if (object->metaObject()->property(ii).isScriptable())
@@ -262,10 +270,6 @@ void QQmlEngineDebugService::buildObjectDump(QDataStream &message,
         QQmlAbstractBoundSignal *signalHandler = ddata->signalHandlers;
 
         while (signalHandler) {
-            if (!dumpProperties) {
-                signalHandler = signalHandler->m_nextSignal;
-                continue;
-            }
             QQmlObjectProperty prop;
             prop.type = QQmlObjectProperty::SignalProperty;
             prop.hasNotifySignal = false;
@@ -296,6 +300,50 @@ void QQmlEngineDebugService::buildObjectDump(QDataStream &message,
         message << fakeProperties[ii];
 }
 
+/*
+    Like buildObjectDump(), but only descends \a depth levels and only dumps
+    \a childLimit children of each object, starting at \a childOffset for
+    \a object itself.  A negative limit dumps all children.  Each object is
+    followed by its total number of children, so that clients can fetch the
+    remaining ones page by page.
+*/
+void QQmlEngineDebugService::buildObjectPage(QDataStream &message, QObject *object, int depth,
+                                             int childOffset, int childLimit, bool dumpProperties)
+{
+    message << objectData(object);
+
+    const bool expand = depth > 0;
+    if (expand)
+        qmlExecuteDeferred(object);
+
+    QObjectList children;
+    foreach (QObject *child, object->children()) {
+        if (!qobject_cast<QQmlContext*>(child))
+            children << child;
+    }
+
+    childOffset = qBound(0, childOffset, children.count());
+    int pageCount = children.count() - childOffset;
+    if (childLimit >= 0)
+        pageCount = qMin(pageCount, childLimit);
+
+    message << children.count() << childOffset << pageCount << expand;
+
+    for (int ii = childOffset; ii < childOffset + pageCount; ++ii) {
+        if (expand)
+            buildObjectPage(message, children.at(ii), depth - 1, 0, childLimit, dumpProperties);
+        else
+            message << objectData(children.at(ii));
+    }
+
+    if (!dumpProperties) {
+        message << 0;
+        return;
+    }
+
+    buildPropertyDump(message, object);
+}
+
 void QQmlEngineDebugService::prepareDeferredObjects(QObject *obj)
 {
     qmlExecuteDeferred(obj);
@@ -476,6 +524,22 @@ void QQmlEngineDebugService::processMessage(const QByteArray &message)
             buildObjectDump(rs, object, recurse, dumpProperties);
         }
 
+    } else if (type == "FETCH_OBJECT_PAGE") {
+        int objectId;
+        int depth;
+        int childOffset;
+        int childLimit;
+        bool dumpProperties = true;
+
+        ds >> objectId >> depth >> childOffset >> childLimit >> dumpProperties;
+
+        QObject *object = QQmlDebugService::objectForId(objectId);
+
+        rs << QByteArray("FETCH_OBJECT_PAGE_R") << queryId;
+
+        if (object)
+            buildObjectPage(rs, object, depth, childOffset, childLimit, dumpProperties);
+
     } else if (type == "FETCH_OBJECTS_FOR_LOCATION") {
         QString file;
         int lineNumber;
@@ -514,6 +578,30 @@ void QQmlEngineDebugService::processMessage(const QByteArray &message)
 
         rs << QByteArray("WATCH_PROPERTY_R") << queryId << ok;
 
+    } else if (type == "WATCH_PROPERTIES_BATCHED") {
+        int objectId;
+        QList<QByteArray> properties;
+        int interval;
+
+        ds >> objectId >> properties >> interval;
+
+        // Registered first, the watcher reports the current values right away.
+        m_batchIntervals.insert(queryId, qMax(0, interval));
+        bool ok = true;
+        if (properties.isEmpty()) {
+            ok = m_watch->addWatch(queryId, objectId);
+        } else {
+            foreach (const QByteArray &property, properties)
+                ok = m_watch->addWatch(queryId, objectId, property) && ok;
+        }
+        if (!ok) {
+            m_watch->removeWatch(queryId);
+            m_batchIntervals.remove(queryId);
+            m_pendingUpdates.remove(queryId);
+        }
+
+        rs << QByteArray("WATCH_PROPERTIES_BATCHED_R") << queryId << ok;
+
     } else if (type == "WATCH_EXPR_OBJECT") {
         int debugId;
         QString expr;
@@ -525,6 +613,8 @@ void QQmlEngineDebugService::processMessage(const QByteArray &message)
 
     } else if (type == "NO_WATCH") {
         bool ok = m_watch->removeWatch(queryId);
+        m_batchIntervals.remove(queryId);
+        m_pendingUpdates.remove(queryId);
 
         rs << QByteArray("NO_WATCH_R") << queryId << ok;
 
@@ -751,6 +841,17 @@ bool QQmlEngineDebugService::setMethodBody(int objectId, const QString &method,
 
 void QQmlEngineDebugService::propertyChanged(int id, int objectId, const QMetaProperty &property, const QVariant &value)
 {
+    QHash<int, int>::ConstIterator interval = m_batchIntervals.constFind(id);
+    if (interval != m_batchIntervals.constEnd()) {
+        // Only the last value of each property within an interval is sent.
+        PendingUpdates &updates = m_pendingUpdates[id];
+        updates.objectId = objectId;
+        updates.values.insert(QByteArray(property.name()), valueContents(value));
+        if (!m_batchTimer.isActive() || m_batchTimer.remainingTime() > *interval)
+            m_batchTimer.start(*interval);
+        return;
+    }
+
     QByteArray reply;
     QQmlDebugStream rs(&reply, QIODevice::WriteOnly);
 
@@ -759,6 +860,34 @@ void QQmlEngineDebugService::propertyChanged(int id, int objectId, const QMetaPr
     sendMessage(reply);
 }
 
+void QQmlEngineDebugService::sendPendingUpdates()
+{
+    if (m_pendingUpdates.isEmpty())
+        return;
+
+    QByteArray reply;
+    QQmlDebugStream rs(&reply, QIODevice::WriteOnly);
+
+    int count = 0;
+    for (QMap<int, PendingUpdates>::ConstIterator it = m_pendingUpdates.constBegin();
+         it != m_pendingUpdates.constEnd(); ++it) {
+        count += it->values.count();
+    }
+
+    //unique queryId -1
+    rs << QByteArray("UPDATE_WATCHES") << -1 << count;
+    for (QMap<int, PendingUpdates>::ConstIterator it = m_pendingUpdates.constBegin();
+         it != m_pendingUpdates.constEnd(); ++it) {
+        for (QMap<QByteArray, QVariant>::ConstIterator value = it->values.constBegin();
+             value != it->values.constEnd(); ++value) {
+            rs << it.key() << it->objectId << value.key() << value.value();
+        }
+    }
+    m_pendingUpdates.clear();
+
+    sendMessage(reply);
+}
+
 void QQmlEngineDebugService::engineAboutToBeAdded(QQmlEngine *engine)
 {
     Q_ASSERT(engine);
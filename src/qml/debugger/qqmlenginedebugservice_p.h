@@ -57,6 +57,9 @@
 
 #include <QtCore/qurl.h>
 #include <QtCore/qvariant.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qmap.h>
+#include <QtCore/qtimer.h>
 #include <QtCore/QPointer>
 
 QT_BEGIN_NAMESPACE
@@ -110,12 +113,15 @@ protected:
 private Q_SLOTS:
     void processMessage(const QByteArray &msg);
     void propertyChanged(int id, int objectId, const QMetaProperty &property, const QVariant &value);
+    void sendPendingUpdates();
 
 private:
     void prepareDeferredObjects(QObject *);
     void buildObjectList(QDataStream &, QQmlContext *,
                          const QList<QPointer<QObject> > &instances);
     void buildObjectDump(QDataStream &, QObject *, bool, bool);
+    void buildObjectPage(QDataStream &, QObject *, int, int, int, bool);
+    void buildPropertyDump(QDataStream &, QObject *);
     void buildStatesList(bool cleanList, const QList<QPointer<QObject> > &instances);
     QQmlObjectData objectData(QObject *);
     QQmlObjectProperty propertyData(QObject *, int);
@@ -128,6 +134,15 @@ private:
     QList<QQmlEngine *> m_engines;
     QQmlWatcher *m_watch;
     QQmlDebugStatesDelegate *m_statesDelegate;
+
+    // Watches whose changes are sent in batches, by watch id
+    struct PendingUpdates {
+        int objectId;
+        QMap<QByteArray, QVariant> values;
+    };
+    QHash<int, int> m_batchIntervals;
+    QMap<int, PendingUpdates> m_pendingUpdates;
+    QTimer m_batchTimer;
 };
 Q_QML_PRIVATE_EXPORT QDataStream &operator<<(QDataStream &, const QQmlEngineDebugService::QQmlObjectData &);
 Q_QML_PRIVATE_EXPORT QDataStream &operator>>(QDataStream &, QQmlEngineDebugService::QQmlObjectData &);
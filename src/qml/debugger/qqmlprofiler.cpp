@@ -48,8 +48,12 @@ QT_BEGIN_NAMESPACE
 // convert to QByteArrays that can be sent to the debug client
 // use of QDataStream can skew results
 //     (see tst_qqmldebugtrace::trace() benchmark)
-void QQmlProfilerData::toByteArrays(QList<QByteArray> &messages) const
+void QQmlProfilerData::toByteArrays(const QVector<QQmlProfilerLocation> &locations,
+                                    QList<QByteArray> &messages) const
 {
+    static const QQmlProfilerLocation noLocation;
+    const QQmlProfilerLocation &loc = location < 0 ? noLocation : locations.at(location);
+
     QByteArray data;
     Q_ASSERT_X(((messageType | detailType) & (1 << 31)) == 0, Q_FUNC_INFO, "You can use at most 31 message types and 31 detail types.");
     for (uint decodedMessageType = 0; (messageType >> decodedMessageType) != 0; ++decodedMessageType) {
@@ -70,12 +74,18 @@ void QQmlProfilerData::toByteArrays(QList<QByteArray> &messages) const
                     ds << QQmlProfilerDefinitions::QmlBinding;
                 break;
             case QQmlProfilerDefinitions::RangeData:
-                ds << detailString;
+                ds << loc.name;
                 break;
             case QQmlProfilerDefinitions::RangeLocation:
-                ds << (detailUrl.isEmpty() ? detailString : detailUrl.toString()) << x << y;
+                ds << loc.fileName() << loc.line << loc.column;
                 break;
             case QQmlProfilerDefinitions::RangeEnd: break;
+            case QQmlProfilerDefinitions::MemoryAllocation:
+                // Heap samples have no location, they send the number of objects instead.
+                ds << loc.name << loc.fileName()
+                   << (decodedDetailType == (int)QQmlProfilerDefinitions::JavaScriptHeap ? count : loc.line)
+                   << loc.column << size;
+                break;
             default:
                 Q_ASSERT_X(false, Q_FUNC_INFO, "Invalid message type.");
                 break;
@@ -87,7 +97,7 @@ void QQmlProfilerData::toByteArrays(QList<QByteArray> &messages) const
 }
 
 QQmlProfilerAdapter::QQmlProfilerAdapter(QQmlProfilerService *service, QQmlEnginePrivate *engine) :
-    QQmlAbstractProfilerAdapter(service)
+    QQmlAbstractProfilerAdapter(service), next(0)
 {
     engine->enableProfiler();
     connect(this, SIGNAL(profilingEnabled()), engine->profiler, SLOT(startProfiling()));
@@ -99,52 +109,118 @@ QQmlProfilerAdapter::QQmlProfilerAdapter(QQmlProfilerService *service, QQmlEngin
     connect(this, SIGNAL(dataRequested()), engine->profiler, SLOT(reportData()));
     connect(this, SIGNAL(referenceTimeKnown(QElapsedTimer)),
             engine->profiler, SLOT(setTimer(QElapsedTimer)));
-    connect(engine->profiler, SIGNAL(dataReady(QList<QQmlProfilerData>)),
-            this, SLOT(receiveData(QList<QQmlProfilerData>)));
+    connect(engine->profiler,
+            SIGNAL(dataReady(QVector<QQmlProfilerData>,QVector<QQmlProfilerLocation>)),
+            this, SLOT(receiveData(QVector<QQmlProfilerData>,QVector<QQmlProfilerLocation>)));
 }
 
 qint64 QQmlProfilerAdapter::sendMessages(qint64 until, QList<QByteArray> &messages)
 {
-    while (!data.empty() && data.front().time <= until) {
-        data.front().toByteArrays(messages);
-        data.pop_front();
-    }
-    return data.empty() ? -1 : data.front().time;
+    while (next < data.size() && data.at(next).time <= until)
+        data.at(next++).toByteArrays(locations, messages);
+    if (next < data.size())
+        return data.at(next).time;
+
+    data.clear();
+    locations.clear();
+    next = 0;
+    return -1;
 }
 
-void QQmlProfilerAdapter::receiveData(const QList<QQmlProfilerData> &new_data)
+void QQmlProfilerAdapter::receiveData(const QVector<QQmlProfilerData> &new_data,
+                                      const QVector<QQmlProfilerLocation> &new_locations)
 {
     data = new_data;
+    locations = new_locations;
+    next = 0;
     service->dataReady(this);
 }
 
 
-QQmlProfiler::QQmlProfiler() : enabled(false)
+QQmlProfiler::QQmlProfiler(QV4::MemoryManager *memoryManager) : enabled(false),
+    memoryProfiling(!qgetenv("QML_PROFILE_MEMORY").isEmpty()),
+    m_memoryManager(memoryManager), m_attributedHeapBytes(0)
 {
-    static int metatype = qRegisterMetaType<QList<QQmlProfilerData> >();
+    static int metatype = qRegisterMetaType<QVector<QQmlProfilerData> >();
+    static int locationMetatype = qRegisterMetaType<QVector<QQmlProfilerLocation> >();
     Q_UNUSED(metatype);
+    Q_UNUSED(locationMetatype);
     m_timer.start();
+
+    connect(&m_heapSamplingTimer, SIGNAL(timeout()), this, SLOT(sampleHeap()));
+    bool ok = false;
+    int interval = qgetenv("QML_PROFILE_HEAP_SAMPLING_INTERVAL").toInt(&ok);
+    if (ok && interval > 0)
+        m_heapSamplingTimer.setInterval(interval);
 }
 
 void QQmlProfiler::startProfiling()
 {
+    // Start out with enough room for a busy second, so that events only rarely move.
+    m_data.reserve(1 << 16);
     enabled = true;
+    // We may be called from the debugger thread while the engine is waiting.
+    if (m_heapSamplingTimer.interval() > 0)
+        QMetaObject::invokeMethod(&m_heapSamplingTimer, "start", Qt::QueuedConnection);
 }
 
 void QQmlProfiler::stopProfiling()
 {
     enabled = false;
+    QMetaObject::invokeMethod(&m_heapSamplingTimer, "stop", Qt::QueuedConnection);
     reportData();
+    clearData();
+}
+
+int QQmlProfiler::addLocation(const LocationKey &key, const QQmlProfilerLocation &location)
+{
+    const int index = m_locations.size();
+    m_locations.append(location);
+    m_locationIndices.insert(key, index);
+    return index;
+}
+
+void QQmlProfiler::clearData()
+{
     m_data.clear();
+    m_locations.clear();
+    m_locationIndices.clear();
+    m_heapClassLocations.clear();
+}
+
+void QQmlProfiler::setHeapSamplingInterval(int msecs)
+{
+    // Only takes effect with the next start of profiling.
+    m_heapSamplingTimer.setInterval(qMax(0, msecs));
+}
+
+// Reports the live JS heap, by object class. This walks the whole heap, so it is only
+// done periodically. It includes garbage that hasn't been collected yet.
+void QQmlProfiler::sampleHeap()
+{
+    if (!enabled)
+        return;
+
+    const qint64 time = m_timer.nsecsElapsed();
+    const QV4::MemoryManager::HeapStatistics stats = m_memoryManager->heapStatistics();
+    typedef QHash<QString, QV4::MemoryManager::HeapStatistics::ClassUsage>::ConstIterator Iterator;
+    for (Iterator it = stats.liveObjects.constBegin(), end = stats.liveObjects.constEnd();
+         it != end; ++it) {
+        // The class names are new strings for every sample, so look them up by value.
+        QHash<QString, int>::ConstIterator location = m_heapClassLocations.constFind(it.key());
+        if (location == m_heapClassLocations.constEnd()) {
+            location = m_heapClassLocations.insert(it.key(), m_locations.size());
+            m_locations.append(QQmlProfilerLocation(it.key(), QString(), QUrl(), 0, 0));
+        }
+        m_data.append(QQmlProfilerData(time, 1 << MemoryAllocation, 1 << JavaScriptHeap,
+                                       location.value(), it->count, it->bytes));
+    }
 }
 
+// The events and locations are handed over as they are, implicit sharing avoids any copies.
 void QQmlProfiler::reportData()
 {
-    QList<QQmlProfilerData> result;
-    result.reserve(m_data.size());
-    for (int i = 0; i < m_data.size(); ++i)
-        result.append(m_data[i]);
-    emit dataReady(result);
+    emit dataReady(m_data, m_locations);
 }
 
 QT_END_NAMESPACE
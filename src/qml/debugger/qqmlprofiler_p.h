@@ -54,6 +54,7 @@
 //
 
 #include <private/qv4function_p.h>
+#include <private/qv4mm_p.h>
 #include <private/qqmlboundsignal_p.h>
 #include <private/qfinitestack_p.h>
 #include "qqmlprofilerdefinitions_p.h"
@@ -62,6 +63,9 @@
 
 #include <QUrl>
 #include <QString>
+#include <QTimer>
+#include <QHash>
+#include <QVector>
 
 QT_BEGIN_NAMESPACE
 
@@ -74,6 +78,28 @@ QT_BEGIN_NAMESPACE
 #define Q_QML_PROFILE(profiler, Method)\
     Q_QML_PROFILE_IF_ENABLED(profiler, profiler->Method)
 
+// Where an event happened. Locations are interned per profiling session, so events
+// only carry an index and the strings are copied once per location, not per event.
+struct Q_AUTOTEST_EXPORT QQmlProfilerLocation
+{
+    QQmlProfilerLocation() : line(0), column(0) {}
+
+    QQmlProfilerLocation(const QString &name, const QString &file, const QUrl &url, int line,
+                         int column) :
+        name(name), file(file), url(url), line(line), column(column) {}
+
+    QString name;           //used by RangeData and MemoryAllocation
+    QString file;           //used by RangeLocation and MemoryAllocation
+    QUrl url;               //overrides file
+
+    int line;
+    int column;
+
+    QString fileName() const { return url.isEmpty() ? file : url.toString(); }
+};
+
+Q_DECLARE_TYPEINFO(QQmlProfilerLocation, Q_MOVABLE_TYPE);
+
 // This struct is somewhat dangerous to use:
 // The messageType is a bit field. You can pack multiple messages into
 // one object, e.g. RangeStart and RangeLocation. Each one will be read
@@ -83,49 +109,38 @@ struct Q_AUTOTEST_EXPORT QQmlProfilerData
 {
     QQmlProfilerData() {}
 
-    QQmlProfilerData(qint64 time, int messageType, int detailType, const QUrl &url,
-                     int x = 0, int y = 0) :
-        time(time), messageType(messageType), detailType(detailType), detailUrl(url),
-        x(x), y(y) {}
-
-    QQmlProfilerData(qint64 time, int messageType, int detailType, const QString &str,
-                     int x = 0, int y = 0) :
-        time(time), messageType(messageType), detailType(detailType),detailString(str),
-        x(x), y(y) {}
-
-    QQmlProfilerData(qint64 time, int messageType, int detailType, const QString &str,
-                     const QUrl &url, int x = 0, int y = 0) :
-        time(time), messageType(messageType), detailType(detailType), detailString(str),
-        detailUrl(url), x(x), y(y) {}
-
-
-    QQmlProfilerData(qint64 time, int messageType, int detailType) :
-        time(time), messageType(messageType), detailType(detailType) {}
-
+    QQmlProfilerData(qint64 time, int messageType, int detailType, int location = -1,
+                     int count = 0, qint64 size = 0) :
+        time(time), messageType(messageType), detailType(detailType), location(location),
+        count(count), size(size) {}
 
     qint64 time;
     int messageType;        //bit field of QQmlProfilerService::Message
     int detailType;
 
-    QString detailString;   //used by RangeData and possibly by RangeLocation
-    QUrl detailUrl;         //used by RangeLocation, overrides detailString
-
-    int x;                  //used by RangeLocation
-    int y;                  //used by RangeLocation
+    int location;           //index into the session's locations, -1 if there is none
+    int count;              //used by MemoryAllocation, object count for heap samples
+    qint64 size;            //used by MemoryAllocation
 
-    void toByteArrays(QList<QByteArray> &messages) const;
+    void toByteArrays(const QVector<QQmlProfilerLocation> &locations,
+                      QList<QByteArray> &messages) const;
 };
 
-Q_DECLARE_TYPEINFO(QQmlProfilerData, Q_MOVABLE_TYPE);
+Q_DECLARE_TYPEINFO(QQmlProfilerData, Q_PRIMITIVE_TYPE);
 
-class QQmlProfiler : public QObject, public QQmlProfilerDefinitions {
+class Q_QML_PRIVATE_EXPORT QQmlProfiler : public QObject, public QQmlProfilerDefinitions {
     Q_OBJECT
 public:
-    void startBinding(const QString &fileName, int line, int column)
+    // If the binding graph is recorded, the trigger names the dependency that caused the
+    // evaluation, and is sent as RangeData.
+    void startBinding(const QString &fileName, int line, int column,
+                      const QString &trigger = QString())
     {
         m_data.append(QQmlProfilerData(m_timer.nsecsElapsed(),
-                                       (1 << RangeStart | 1 << RangeLocation), 1 << Binding,
-                                       fileName, line, column));
+                                       (1 << RangeStart | 1 << RangeLocation
+                                        | (trigger.isEmpty() ? 0 : 1 << RangeData)),
+                                       1 << Binding,
+                                       location(trigger, fileName, QUrl(), line, column)));
     }
 
     // Have toByteArrays() construct another RangeData event from the same QString later.
@@ -134,14 +149,15 @@ public:
     {
         m_data.append(QQmlProfilerData(m_timer.nsecsElapsed(),
                                        (1 << RangeStart | 1 << RangeLocation | 1 << RangeData),
-                                       1 << Compiling, name, 1, 1));
+                                       1 << Compiling, location(name, name, QUrl(), 1, 1)));
     }
 
     void startHandlingSignal(const QQmlSourceLocation &location)
     {
         m_data.append(QQmlProfilerData(m_timer.nsecsElapsed(),
                                        (1 << RangeStart | 1 << RangeLocation), 1 << HandlingSignal,
-                                       location.sourceFile, location.line, location.column));
+                                       this->location(QString(), location.sourceFile, QUrl(),
+                                                      location.line, location.column)));
     }
 
     void startCreating()
@@ -153,14 +169,16 @@ public:
     {
         m_data.append(QQmlProfilerData(m_timer.nsecsElapsed(),
                                        (1 << RangeStart | 1 << RangeLocation | 1 << RangeData),
-                                       1 << Creating, typeName, fileName, line, column));
+                                       1 << Creating,
+                                       location(typeName, QString(), fileName, line, column)));
     }
 
     void updateCreating(const QString &typeName, const QUrl &fileName, int line, int column)
     {
         m_data.append(QQmlProfilerData(m_timer.nsecsElapsed(),
                                        (1 << RangeLocation | 1 << RangeData),
-                                       1 << Creating, typeName, fileName, line, column));
+                                       1 << Creating,
+                                       location(typeName, QString(), fileName, line, column)));
     }
 
     template<RangeType Range>
@@ -169,22 +187,114 @@ public:
         m_data.append(QQmlProfilerData(m_timer.nsecsElapsed(), 1 << RangeEnd, 1 << Range));
     }
 
-    QQmlProfiler();
+    void allocateMemory(MemoryType type, const QString &typeName, const QUrl &url, int line,
+                        int column, qint64 size)
+    {
+        m_data.append(QQmlProfilerData(m_timer.nsecsElapsed(), 1 << MemoryAllocation, 1 << type,
+                                       location(typeName, QString(), url, line, column), 1, size));
+    }
+
+    void allocateMemory(MemoryType type, const QQmlSourceLocation &location, qint64 size)
+    {
+        m_data.append(QQmlProfilerData(m_timer.nsecsElapsed(), 1 << MemoryAllocation, 1 << type,
+                                       this->location(QString(), location.sourceFile, QUrl(),
+                                                      location.line, location.column),
+                                       1, size));
+    }
+
+    // Measures the JS heap allocated while it is open. What scopes opened inside of it
+    // have already reported is not counted again, so each allocation is attributed once.
+    class HeapScope {
+    public:
+        HeapScope() : profiler(0), allocatedBytes(0), attributedBytes(0) {}
+
+        void open(QQmlProfiler *p)
+        {
+            profiler = p;
+            allocatedBytes = profiler->m_memoryManager->allocatedBytes();
+            attributedBytes = profiler->m_attributedHeapBytes;
+        }
+
+        bool isOpen() const { return profiler != 0; }
+
+        qint64 close()
+        {
+            const quint64 total = profiler->m_memoryManager->allocatedBytes() - allocatedBytes;
+            const quint64 nested = profiler->m_attributedHeapBytes - attributedBytes;
+            const quint64 own = total > nested ? total - nested : 0;
+            profiler->m_attributedHeapBytes += own;
+            profiler = 0;
+            return own;
+        }
+
+    private:
+        QQmlProfiler *profiler;
+        quint64 allocatedBytes;
+        quint64 attributedBytes;
+    };
+
+    QQmlProfiler(QV4::MemoryManager *memoryManager);
 
     bool enabled;
+    bool memoryProfiling; // attribute allocations to types and locations, see HeapScope
 
 public slots:
     void startProfiling();
     void stopProfiling();
     void reportData();
     void setTimer(const QElapsedTimer &timer) { m_timer = timer; }
+    void setHeapSamplingInterval(int msecs);
 
 signals:
-    void dataReady(const QList<QQmlProfilerData> &);
+    void dataReady(const QVector<QQmlProfilerData> &, const QVector<QQmlProfilerLocation> &);
+
+private slots:
+    void sampleHeap();
 
 protected:
+    // Locations are looked up by the identity of their strings. As the table keeps a copy of
+    // each string, the data can't be freed and reused for a different string meanwhile.
+    struct LocationKey {
+        const void *name;
+        const void *file;
+        const void *url;
+        int line;
+        int column;
+
+        bool operator==(const LocationKey &other) const
+        {
+            return name == other.name && file == other.file && url == other.url
+                    && line == other.line && column == other.column;
+        }
+    };
+    friend uint qHash(const LocationKey &key, uint seed)
+    {
+        return qHash(key.name, seed) ^ qHash(key.file, seed) ^ qHash(key.url, seed)
+                ^ qHash((key.line << 16) ^ key.column, seed);
+    }
+
+    int location(const QString &name, const QString &file, const QUrl &url, int line, int column)
+    {
+        const LocationKey key = { name.constData(), file.constData(),
+                                  const_cast<QUrl &>(url).data_ptr(), line, column };
+        QHash<LocationKey, int>::ConstIterator it = m_locationIndices.constFind(key);
+        if (it != m_locationIndices.constEnd())
+            return it.value();
+        return addLocation(key, QQmlProfilerLocation(name, file, url, line, column));
+    }
+
+    int addLocation(const LocationKey &key, const QQmlProfilerLocation &location);
+    void clearData();
+
     QElapsedTimer m_timer;
-    QVarLengthArray<QQmlProfilerData> m_data;
+    QVector<QQmlProfilerData> m_data;
+    QVector<QQmlProfilerLocation> m_locations;
+    QHash<LocationKey, int> m_locationIndices;
+    QHash<QString, int> m_heapClassLocations;
+
+    QV4::MemoryManager *m_memoryManager;
+    quint64 m_attributedHeapBytes;
+    QTimer m_heapSamplingTimer; // samples the live JS heap while profiling, if it has an interval
 };
 
 class QQmlProfilerAdapter : public QQmlAbstractProfilerAdapter {
@@ -194,10 +304,13 @@ public:
     qint64 sendMessages(qint64 until, QList<QByteArray> &messages);
 
 public slots:
-    void receiveData(const QList<QQmlProfilerData> &new_data);
+    void receiveData(const QVector<QQmlProfilerData> &new_data,
+                     const QVector<QQmlProfilerLocation> &new_locations);
 
 private:
-    QList<QQmlProfilerData> data;
+    QVector<QQmlProfilerData> data;
+    QVector<QQmlProfilerLocation> locations;
+    int next;
 };
 
 //
@@ -207,22 +320,41 @@ private:
 struct QQmlProfilerHelper : public QQmlProfilerDefinitions {
     QQmlProfiler *profiler;
     QQmlProfilerHelper(QQmlProfiler *profiler) : profiler(profiler) {}
+
+    static void reportJavaScriptMemory(QQmlProfiler *profiler, QQmlProfiler::HeapScope *scope,
+                                       const QQmlSourceLocation &location)
+    {
+        const qint64 size = scope->close();
+        if (size > 0 && profiler->enabled)
+            profiler->allocateMemory(JavaScriptMemory, location, size);
+    }
 };
 
 struct QQmlBindingProfiler : public QQmlProfilerHelper {
-    QQmlBindingProfiler(QQmlProfiler *profiler, const QString &url, int line, int column) :
+    QQmlBindingProfiler(QQmlProfiler *profiler, const QString &url, int line, int column,
+                        const QString &trigger = QString()) :
         QQmlProfilerHelper(profiler)
         , m_systraceEvent("qml", qPrintable(QLatin1String("QQmlBinding::") + url + QLatin1String("::") + QString::number(line)))
     {
-        Q_QML_PROFILE(profiler, startBinding(url, line, column));
+        Q_QML_PROFILE_IF_ENABLED(profiler, {
+            profiler->startBinding(url, line, column, trigger);
+            if (profiler->memoryProfiling) {
+                m_location = QQmlSourceLocation(url, line, column);
+                m_heapScope.open(profiler);
+            }
+        });
     }
 
     ~QQmlBindingProfiler()
     {
         Q_QML_PROFILE(profiler, endRange<Binding>());
+        if (m_heapScope.isOpen())
+            reportJavaScriptMemory(profiler, &m_heapScope, m_location);
     }
 
     QSystraceEvent m_systraceEvent;
+    QQmlProfiler::HeapScope m_heapScope;
+    QQmlSourceLocation m_location;
 };
 
 struct QQmlHandlingSignalProfiler : public QQmlProfilerHelper {
@@ -230,15 +362,25 @@ struct QQmlHandlingSignalProfiler : public QQmlProfilerHelper {
         QQmlProfilerHelper(profiler)
         , m_systraceEvent("qml", qPrintable(QLatin1String("QQmlHandlingSignal::") + expression->sourceLocation().sourceFile + QLatin1String("::") + QString::number(expression->sourceLocation().line)))
     {
-        Q_QML_PROFILE(profiler, startHandlingSignal(expression->sourceLocation()));
+        Q_QML_PROFILE_IF_ENABLED(profiler, {
+            // The expression may be gone by the time the handler returns.
+            m_location = expression->sourceLocation();
+            profiler->startHandlingSignal(m_location);
+            if (profiler->memoryProfiling)
+                m_heapScope.open(profiler);
+        });
     }
 
     ~QQmlHandlingSignalProfiler()
     {
         Q_QML_PROFILE(profiler, endRange<QQmlProfiler::HandlingSignal>());
+        if (m_heapScope.isOpen())
+            reportJavaScriptMemory(profiler, &m_heapScope, m_location);
     }
 
     QSystraceEvent m_systraceEvent;
+    QQmlProfiler::HeapScope m_heapScope;
+    QQmlSourceLocation m_location;
 };
 
 struct QQmlCompilingProfiler : public QQmlProfilerHelper {
@@ -304,13 +446,35 @@ public:
 
     QQmlObjectCreationProfiler(QQmlProfiler *profiler) : profiler(profiler)
         , m_systraceEvent("qml", "QQmlObjectCreation") // TODO: can we track what kind of object?
+        , m_objectSize(0)
     {
-        Q_QML_PROFILE(profiler, startCreating());
+        Q_QML_PROFILE_IF_ENABLED(profiler, {
+            profiler->startCreating();
+            if (profiler->memoryProfiling)
+                m_heapScope.open(profiler);
+        });
     }
 
     ~QQmlObjectCreationProfiler()
     {
-        Q_QML_PROFILE(profiler, endRange<QQmlProfilerDefinitions::Creating>());
+        Q_QML_PROFILE_IF_ENABLED(profiler, {
+            profiler->endRange<QQmlProfilerDefinitions::Creating>();
+            if (m_objectSize > 0 && profiler->memoryProfiling)
+                profiler->allocateMemory(QQmlProfilerDefinitions::ObjectMemory, m_typeName, m_url,
+                                         m_line, m_column, m_objectSize);
+        });
+        if (m_heapScope.isOpen()) {
+            // Wrappers and binding closures of the object itself; children report their own.
+            const qint64 size = m_heapScope.close();
+            if (size > 0 && profiler->enabled)
+                profiler->allocateMemory(QQmlProfilerDefinitions::JavaScriptMemory, m_typeName,
+                                         m_url, m_line, m_column, size);
+        }
+    }
+
+    void setObjectSize(int size)
+    {
+        m_objectSize = size;
     }
 
     void update(const QString &typeName, const QUrl &url, int line, int column)
@@ -325,6 +489,8 @@ public:
 private:
     QQmlProfiler *profiler;
     QSystraceEvent m_systraceEvent;
+    QQmlProfiler::HeapScope m_heapScope;
+    int m_objectSize;
 };
 
 class QQmlObjectCompletionProfiler {
@@ -349,6 +515,7 @@ private:
 };
 
 QT_END_NAMESPACE
-Q_DECLARE_METATYPE(QList<QQmlProfilerData>)
+Q_DECLARE_METATYPE(QVector<QQmlProfilerData>)
+Q_DECLARE_METATYPE(QVector<QQmlProfilerLocation>)
 
 #endif // QQMLPROFILER_P_H
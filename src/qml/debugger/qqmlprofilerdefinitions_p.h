@@ -67,6 +67,8 @@ struct QQmlProfilerDefinitions {
         Complete, // end of transmission
         PixmapCacheEvent,
         SceneGraphFrame,
+        MemoryAllocation,
+        Batch, // several delta encoded messages, only sent if the client asked for it
 
         MaximumMessage
     };
@@ -123,9 +125,25 @@ struct QQmlProfilerDefinitions {
         SceneGraphWindowsRenderShow,
         SceneGraphWindowsAnimations,
         SceneGraphWindowsPolishFrame,
+        SceneGraphPolishItems,
 
         MaximumSceneGraphFrameType
     };
+
+    enum MemoryType {
+        ObjectMemory,       // C++ object created by the object creator
+        JavaScriptMemory,   // JS heap allocated while creating an object or running a binding
+        JavaScriptHeap,     // periodic sample of the live JS heap, per object class
+        JavaScriptAllocationSite, // node of the sampled JS allocation call tree
+
+        MaximumMemoryType
+    };
+
+    // Optional features a client can request when it starts or stops recording.
+    enum TransportFlag {
+        BatchedTransport    = 1 << 0,
+        CompressedTransport = 1 << 1
+    };
 };
 
 QT_END_NAMESPACE
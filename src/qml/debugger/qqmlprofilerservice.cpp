@@ -56,7 +56,7 @@ QT_BEGIN_NAMESPACE
 Q_GLOBAL_STATIC(QQmlProfilerService, profilerInstance)
 
 QQmlProfilerService::QQmlProfilerService()
-    : QQmlConfigurableDebugService(QStringLiteral("CanvasFrameRate"), 1)
+    : QQmlConfigurableDebugService(QStringLiteral("CanvasFrameRate"), 1), m_transportFlags(0)
 {
     m_timer.start();
 
@@ -342,9 +342,46 @@ void QQmlProfilerService::sendMessages()
     ds << (qint64)-1 << (int)Complete;
     messages << data;
 
+    if (m_transportFlags & BatchedTransport)
+        packMessages(messages);
+
     QQmlDebugService::sendMessages(messages);
 }
 
+/*
+    Pack the messages into as few Batch messages as possible. Every message starts with its
+    timestamp, which is replaced by the difference to the previous one. That keeps the high bytes
+    zero and makes the batches compress well.
+*/
+void QQmlProfilerService::packMessages(QList<QByteArray> &messages) const
+{
+    static const int maximumBatchSize = 1 << 20;
+    const bool compressed = m_transportFlags & CompressedTransport;
+
+    QList<QByteArray> batches;
+    QList<QByteArray>::ConstIterator i = messages.constBegin();
+    while (i != messages.constEnd()) {
+        QByteArray batch;
+        QQmlDebugStream batchStream(&batch, QIODevice::WriteOnly);
+        qint64 previousTime = 0;
+        for (; i != messages.constEnd() && batch.size() < maximumBatchSize; ++i) {
+            qint64 time;
+            QQmlDebugStream(*i) >> time;
+            batchStream << (time - previousTime)
+                        << QByteArray::fromRawData(i->constData() + sizeof(qint64),
+                                                   i->size() - int(sizeof(qint64)));
+            previousTime = time;
+        }
+
+        QByteArray packed;
+        QQmlDebugStream out(&packed, QIODevice::WriteOnly);
+        out << (qint64)-1 << (int)Batch << compressed << (compressed ? qCompress(batch) : batch);
+        batches << packed;
+    }
+
+    messages = batches;
+}
+
 void QQmlProfilerService::stateAboutToBeChanged(QQmlDebugService::State newState)
 {
     QMutexLocker lock(configMutex());
@@ -356,6 +393,8 @@ void QQmlProfilerService::stateAboutToBeChanged(QQmlDebugService::State newState
     if (newState != Enabled) {
         foreach (QQmlEngine *engine, m_engineProfilers.keys())
             stopProfiling(engine);
+        // The next client has to negotiate its transport again.
+        m_transportFlags = 0;
     }
 }
 
@@ -371,6 +410,8 @@ void QQmlProfilerService::messageReceived(const QByteArray &message)
     stream >> enabled;
     if (!stream.atEnd())
         stream >> engineId;
+    if (!stream.atEnd())
+        stream >> m_transportFlags;
 
     // If engineId == -1 objectForId() and then the cast will return 0.
     if (enabled)
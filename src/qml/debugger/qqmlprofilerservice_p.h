@@ -101,10 +101,12 @@ protected:
 private:
 
     void sendMessages();
+    void packMessages(QList<QByteArray> &messages) const;
     void addEngineProfiler(QQmlAbstractProfilerAdapter *profiler, QQmlEngine *engine);
     void removeProfilerFromStartTimes(const QQmlAbstractProfilerAdapter *profiler);
 
     QElapsedTimer m_timer;
+    int m_transportFlags;
 
     QList<QQmlAbstractProfilerAdapter *> m_globalProfilers;
     QMultiHash<QQmlEngine *, QQmlAbstractProfilerAdapter *> m_engineProfilers;
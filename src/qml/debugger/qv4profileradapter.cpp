@@ -58,6 +58,9 @@ QV4ProfilerAdapter::QV4ProfilerAdapter(QQmlProfilerService *service, QV4::Execut
     connect(this, SIGNAL(dataRequested()), engine->profiler, SLOT(reportData()));
     connect(this, SIGNAL(referenceTimeKnown(QElapsedTimer)),
             engine->profiler, SLOT(setTimer(QElapsedTimer)));
+    connect(engine->profiler,
+            SIGNAL(allocationsReady(QList<QV4::Profiling::AllocationSiteProperties>)),
+            this, SLOT(receiveAllocations(QList<QV4::Profiling::AllocationSiteProperties>)));
     connect(engine->profiler, SIGNAL(dataReady(QList<QV4::Profiling::FunctionCallProperties>)),
             this, SLOT(receiveData(QList<QV4::Profiling::FunctionCallProperties>)));
 }
@@ -95,8 +98,30 @@ qint64 QV4ProfilerAdapter::sendMessages(qint64 until, QList<QByteArray> &message
             data.pop_front();
         }
         if (stack.empty() && data.empty())
-            return -1;
+            break;
     }
+
+    // The allocation tree is sent after the calls, in pre-order, so that the client can rebuild
+    // it from the depths.
+    while (!allocations.empty()) {
+        const QV4::Profiling::AllocationSiteProperties &props = allocations.front();
+        if (props.time > until)
+            return props.time;
+        QQmlDebugStream d(&message, QIODevice::WriteOnly);
+        d << props.time << MemoryAllocation << JavaScriptAllocationSite << props.name
+          << props.file << props.line << props.column << props.bytes << props.samples
+          << props.depth << props.objectClass;
+        messages.append(message);
+        allocations.pop_front();
+    }
+    return -1;
+}
+
+void QV4ProfilerAdapter::receiveAllocations(
+        const QList<QV4::Profiling::AllocationSiteProperties> &new_allocations)
+{
+    // Always followed by receiveData(), which announces the data to the service.
+    allocations = new_allocations;
 }
 
 void QV4ProfilerAdapter::receiveData(const QList<QV4::Profiling::FunctionCallProperties> &new_data)
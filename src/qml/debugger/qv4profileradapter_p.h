@@ -71,9 +71,11 @@ public:
     virtual qint64 sendMessages(qint64 until, QList<QByteArray> &messages);
 
 public slots:
+    void receiveAllocations(const QList<QV4::Profiling::AllocationSiteProperties> &);
     void receiveData(const QList<QV4::Profiling::FunctionCallProperties> &);
 
 private:
+    QList<QV4::Profiling::AllocationSiteProperties> allocations;
     QList<QV4::Profiling::FunctionCallProperties> data;
     QStack<qint64> stack;
 };
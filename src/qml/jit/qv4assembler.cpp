@@ -49,6 +49,7 @@
 #include "qv4ssa_p.h"
 #include "qv4regalloc_p.h"
 #include "qv4assembler_p.h"
+#include "qv4debugging_p.h"
 
 #include <assembler/LinkBuffer.h>
 #include <WTFStubs.h>
@@ -68,6 +69,22 @@ CompilationUnit::~CompilationUnit()
 {
 }
 
+typedef ReturnedValue (*NativeCode)(QV4::ExecutionContext *, const uchar *);
+
+/* Runs code generated in debug mode between the same enteringFunction()/leavingFunction()
+   notifications the interpreter sends, so that stepping over and out of functions works
+   the same in both backends. */
+static ReturnedValue debugExec(QV4::ExecutionContext *ctx, const uchar *code)
+{
+    Debugging::Debugger *debugger = ctx->engine->debugger;
+    if (debugger)
+        debugger->enteringFunction();
+    ReturnedValue retVal = reinterpret_cast<NativeCode>(const_cast<uchar *>(code))(ctx, 0);
+    if (debugger)
+        debugger->leavingFunction(retVal);
+    return retVal;
+}
+
 void CompilationUnit::linkBackendToEngine(ExecutionEngine *engine)
 {
     runtimeFunctions.resize(data->functionTableSize);
@@ -75,8 +92,14 @@ void CompilationUnit::linkBackendToEngine(ExecutionEngine *engine)
     for (int i = 0 ;i < runtimeFunctions.size(); ++i) {
         const CompiledData::Function *compiledFunction = data->functionAt(i);
 
-        QV4::Function *runtimeFunction = new QV4::Function(engine, this, compiledFunction,
-                                                           (ReturnedValue (*)(QV4::ExecutionContext *, const uchar *)) codeRefs[i].code().executableAddress());
+        NativeCode code = (NativeCode) codeRefs[i].code().executableAddress();
+        QV4::Function *runtimeFunction;
+        if (debugMode) {
+            runtimeFunction = new QV4::Function(engine, this, compiledFunction, &debugExec);
+            runtimeFunction->codeData = reinterpret_cast<const uchar *>(code);
+        } else {
+            runtimeFunction = new QV4::Function(engine, this, compiledFunction, code);
+        }
         runtimeFunctions[i] = runtimeFunction;
     }
 }
@@ -140,6 +163,41 @@ static const Assembler::RegisterID calleeSavedRegisters[] = {
 
 const int Assembler::calleeSavedRegisterCount = sizeof(calleeSavedRegisters) / sizeof(calleeSavedRegisters[0]);
 
+#if CPU(ARM) && CPU(ARM_VFP)
+// AAPCS: d8-d15 (s16-s31) must be preserved across calls.
+static const Assembler::FPRegisterID calleeSavedFPRegisters[] = {
+    JSC::ARMRegisters::d8,
+    JSC::ARMRegisters::d9,
+    JSC::ARMRegisters::d10,
+    JSC::ARMRegisters::d11,
+    JSC::ARMRegisters::d12,
+    JSC::ARMRegisters::d13,
+    JSC::ARMRegisters::d14,
+    JSC::ARMRegisters::d15
+};
+
+const int Assembler::calleeSavedFPRegisterCount = sizeof(calleeSavedFPRegisters) / sizeof(calleeSavedFPRegisters[0]);
+
+Assembler::FPRegisterID Assembler::calleeSavedFPRegister(int index)
+{
+    Q_ASSERT(index >= 0 && index < calleeSavedFPRegisterCount);
+    return calleeSavedFPRegisters[index];
+}
+#else
+const int Assembler::calleeSavedFPRegisterCount = 0;
+
+Assembler::FPRegisterID Assembler::calleeSavedFPRegister(int)
+{
+    Q_UNREACHABLE();
+    return FPGpr0;
+}
+#endif
+
+static inline int calleeSavedFPRegisterOffset(int index)
+{
+    return -Assembler::calleeSavedRegisterCount * Assembler::RegisterSize - (index + 1) * int(sizeof(double));
+}
+
 /* End of platform/calling convention/architecture specific section */
 
 
@@ -294,12 +352,16 @@ void Assembler::enterStandardStackFrame()
 
     for (int i = 0; i < calleeSavedRegisterCount; ++i)
         storePtr(calleeSavedRegisters[i], Address(StackFrameRegister, -(i + 1) * sizeof(void*)));
+    for (int i = 0; i < calleeSavedFPRegisterCount; ++i)
+        storeDouble(calleeSavedFPRegister(i), Address(StackFrameRegister, calleeSavedFPRegisterOffset(i)));
 
 }
 
 void Assembler::leaveStandardStackFrame()
 {
     // restore the callee saved registers
+    for (int i = calleeSavedFPRegisterCount - 1; i >= 0; --i)
+        loadDouble(Address(StackFrameRegister, calleeSavedFPRegisterOffset(i)), calleeSavedFPRegister(i));
     for (int i = calleeSavedRegisterCount - 1; i >= 0; --i)
         loadPtr(Address(StackFrameRegister, -(i + 1) * sizeof(void*)), calleeSavedRegisters[i]);
 
@@ -72,6 +72,7 @@ class InstructionSelection;
 
 struct CompilationUnit : public QV4::CompiledData::CompilationUnit
 {
+    CompilationUnit() : debugMode(false) {}
     virtual ~CompilationUnit();
 
     virtual void linkBackendToEngine(QV4::ExecutionEngine *engine);
@@ -82,6 +83,9 @@ struct CompilationUnit : public QV4::CompiledData::CompilationUnit
 
     QVector<JSC::MacroAssemblerCodeRef> codeRefs;
     QList<QVector<QV4::Primitive> > constantValues;
+
+    // The code was generated with breakpoint checks, and runs through debugExec().
+    bool debugMode;
 };
 
 struct RelativeCall {
@@ -122,6 +126,10 @@ template <typename A, typename B, typename C>
 struct ExceptionCheck<void (*)(QV4::NoThrowContext *, A, B, C)> {
     enum { NeedsCheck = 0 };
 };
+template <typename A, typename B, typename C>
+struct ExceptionCheck<QV4::Bool (*)(QV4::NoThrowContext *, A, B, C)> {
+    enum { NeedsCheck = 0 };
+};
 
 class Assembler : public JSC::MacroAssembler
 {
@@ -265,6 +273,10 @@ public:
 #error The JIT needs to be ported to this platform.
 #endif
     static const int calleeSavedRegisterCount;
+    // Double registers that native calls preserve, so the register allocator can keep
+    // values in them across calls. Saved and restored in the standard stack frame.
+    static const int calleeSavedFPRegisterCount;
+    static FPRegisterID calleeSavedFPRegister(int index);
 
 #if CPU(X86) || CPU(X86_64)
     static const int StackAlignment = 16;
@@ -303,6 +315,9 @@ public:
     //   callee saved reg n
     //   ...
     //   callee saved reg 0
+    //   callee saved FP reg 0
+    //   ...
+    //   callee saved FP reg n
     //   saved reg arg 0
     //   ...
     //   saved reg arg n            <- SP
@@ -352,6 +367,7 @@ public:
 
             // space for the callee saved registers
             int frameSize = RegisterSize * calleeSavedRegisterCount;
+            frameSize += calleeSavedFPRegisterCount * sizeof(double);
             frameSize += savedRegCount * sizeof(QV4::Value); // these get written out as Values, not as native registers
 
             Q_ASSERT(frameSize + stackSpaceAllocatedOtherwise < INT_MAX);
@@ -404,7 +420,7 @@ public:
         int calleeSavedRegisterSpace() const
         {
             // plus 1 for the old FP
-            return RegisterSize * (calleeSavedRegCount + 1);
+            return RegisterSize * (calleeSavedRegCount + 1) + calleeSavedFPRegisterCount * sizeof(double);
         }
 
     private:
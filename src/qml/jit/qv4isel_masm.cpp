@@ -49,12 +49,15 @@
 #include "qv4ssa_p.h"
 #include "qv4regalloc_p.h"
 #include "qv4assembler_p.h"
+#include "qv4debugging_p.h"
 #include "qv4unop_p.h"
 #include "qv4binop_p.h"
+#include <private/qqmlpropertycache_p.h>
 
 #include <QtCore/QBuffer>
 
 #include <assembler/LinkBuffer.h>
+#include <private/qv4isel_moth_p.h>
 #include <WTFStubs.h>
 
 #include <iostream>
@@ -207,6 +210,7 @@ InstructionSelection::InstructionSelection(QQmlEnginePrivate *qmlEngine, QV4::Ex
 {
     compilationUnit = new CompilationUnit;
     compilationUnit->codeRefs.resize(module->functions.size());
+    compilationUnit->debugMode = module->debugMode;
 }
 
 InstructionSelection::~InstructionSelection()
@@ -267,6 +271,8 @@ static QVector<int> getIntRegisters()
 
 static QVector<int> getFpRegisters()
 {
+    // d7 is the fpTempRegister of MacroAssemblerARMv7, so it must never hold a value.
+    // The callee saved d8-d15 are added by getCalleeSavedFpRegisters().
     static const QVector<int> fpRegisters = QVector<int>()
             << JSC::ARMRegisters::d2
             << JSC::ARMRegisters::d3
@@ -298,6 +304,16 @@ static QVector<int> getFpRegisters()
 }
 #endif
 
+#ifdef REGALLOC_IS_SUPPORTED
+static QVector<int> getCalleeSavedFpRegisters()
+{
+    QVector<int> fpRegisters;
+    for (int i = 0; i < Assembler::calleeSavedFPRegisterCount; ++i)
+        fpRegisters << Assembler::calleeSavedFPRegister(i);
+    return fpRegisters;
+}
+#endif
+
 void InstructionSelection::run(int functionIndex)
 {
     IR::Function *function = irModule->functions[functionIndex];
@@ -310,7 +326,7 @@ void InstructionSelection::run(int functionIndex)
 #ifdef REGALLOC_IS_SUPPORTED
     static const bool withRegisterAllocator = qgetenv("QV4_NO_REGALLOC").isEmpty();
     if (opt.isInSSA() && withRegisterAllocator) {
-        RegisterAllocator(getIntRegisters(), getFpRegisters()).run(_function, opt);
+        RegisterAllocator(getIntRegisters(), getFpRegisters(), getCalleeSavedFpRegisters()).run(_function, opt);
     } else
 #endif // REGALLOC_IS_SUPPORTED
     {
@@ -354,6 +370,8 @@ void InstructionSelection::run(int functionIndex)
                     Assembler::Address lineAddr(Assembler::ContextRegister, qOffsetOf(QV4::ExecutionContext, lineNumber));
                     _as->store32(Assembler::TrustedImm32(s->location.startLine), lineAddr);
                     lastLine = s->location.startLine;
+                    if (irModule->debugMode)
+                        generateBreakCheck();
                 }
             }
             s->accept(this);
@@ -373,6 +391,21 @@ void InstructionSelection::run(int functionIndex)
     qSwap(_removableJumps, removableJumps);
 }
 
+// The equivalent of Moth's Debug instruction: a test of the debugger's pause flag that only
+// calls out when a breakpoint is set, a pause was requested or the debugger is stepping.
+// Without any of those a statement costs three loads and a branch more than in release mode.
+// Code is only generated in debug mode while a debugger is attached, and the debugger lives as
+// long as the engine.
+void InstructionSelection::generateBreakCheck()
+{
+    _as->loadPtr(Address(Assembler::ContextRegister, qOffsetOf(ExecutionContext, engine)), Assembler::ScratchRegister);
+    _as->loadPtr(Address(Assembler::ScratchRegister, qOffsetOf(ExecutionEngine, debugger)), Assembler::ScratchRegister);
+    _as->load32(Address(Assembler::ScratchRegister, Debugging::Debugger::pauseAtNextOpportunityOffset()), Assembler::ScratchRegister);
+    Assembler::Jump noBreak = _as->branch32(Assembler::Equal, Assembler::ScratchRegister, Assembler::TrustedImm32(0));
+    generateFunctionCall(Assembler::Void, Runtime::maybeBreakAtInstruction, Assembler::ContextRegister);
+    noBreak.link(_as);
+}
+
 const void *InstructionSelection::addConstantTable(QVector<Primitive> *values)
 {
     compilationUnit->constantValues.append(*values);
@@ -388,6 +421,15 @@ QV4::CompiledData::CompilationUnit *InstructionSelection::backendCompileStep()
     return compilationUnit;
 }
 
+// The generated machine code embeds absolute addresses of runtime functions, constant tables and
+// code labels, so it can't be written to disk. Cached units are restored as interpreter bytecode
+// instead, which saves the parsing, code generation and assembly at startup but runs the cached
+// functions in the interpreter. ExecutionEngine::diskCacheEnabled decides whether that is wanted.
+QV4::CompiledData::CompilationUnit *ISelFactory::createUnitForLoading()
+{
+    return new QV4::Moth::CompilationUnit;
+}
+
 void InstructionSelection::callBuiltinInvalid(IR::Name *func, IR::ExprList *args, IR::Temp *result)
 {
     prepareCallData(args, 0);
@@ -609,6 +651,17 @@ void InstructionSelection::callBuiltinSetupArgumentObject(IR::Temp *result)
     generateFunctionCall(result, Runtime::setupArgumentsObject, Assembler::ContextRegister);
 }
 
+void InstructionSelection::callBuiltinArgumentsLength(IR::Temp *result)
+{
+    generateFunctionCall(result, Runtime::argumentsLength, Assembler::ContextRegister);
+}
+
+void InstructionSelection::callBuiltinArgumentAt(IR::Expr *index, IR::Temp *result)
+{
+    generateFunctionCall(result, Runtime::argumentAt, Assembler::ContextRegister,
+                         Assembler::PointerToValue(index));
+}
+
 void InstructionSelection::callBuiltinConvertThisToObject()
 {
     generateFunctionCall(Assembler::Void, Runtime::convertThisToObject, Assembler::ContextRegister);
@@ -636,9 +689,9 @@ void InstructionSelection::loadThisObject(IR::Temp *temp)
 #endif
 }
 
-void InstructionSelection::loadQmlIdArray(IR::Temp *temp)
+void InstructionSelection::loadQmlIdObject(int index, IR::Temp *temp)
 {
-    generateFunctionCall(temp, Runtime::getQmlIdArray, Assembler::ContextRegister);
+    generateFunctionCall(temp, Runtime::getQmlIdObject, Assembler::ContextRegister, Assembler::TrustedImm32(index));
 }
 
 void InstructionSelection::loadQmlImportedScripts(IR::Temp *temp)
@@ -739,13 +792,39 @@ void InstructionSelection::getProperty(IR::Expr *base, const QString &name, IR::
     }
 }
 
-void InstructionSelection::getQObjectProperty(IR::Expr *base, int propertyIndex, bool captureRequired, int attachedPropertiesId, IR::Temp *target)
+// Properties with a QQmlAccessors read function and a plain int, bool or real type can be
+// read without going through the property cache at run-time: the accessor table is static
+// and the accessor data is an integer, so both can be embedded in the generated code.
+static int accessorReadType(const QQmlPropertyData *property)
+{
+    if (!property->hasAccessors() || property->isFunction() || property->isEnum())
+        return -1;
+    switch (property->propType) {
+    case QMetaType::Int: return Runtime::AccessorReadsInt;
+    case QMetaType::Bool: return Runtime::AccessorReadsBool;
+    case QMetaType::Float: return Runtime::AccessorReadsFloat;
+    case QMetaType::Double: return Runtime::AccessorReadsDouble;
+    default: return -1;
+    }
+}
+
+void InstructionSelection::getQObjectProperty(IR::Expr *base, QQmlPropertyData *property, bool captureRequired, int attachedPropertiesId, IR::Temp *target)
 {
-    if (attachedPropertiesId != 0)
+    const int propertyIndex = property->coreIndex;
+    const int accessorType = accessorReadType(property);
+    if (attachedPropertiesId != 0) {
         generateFunctionCall(target, Runtime::getQmlAttachedProperty, Assembler::ContextRegister, Assembler::TrustedImm32(attachedPropertiesId), Assembler::TrustedImm32(propertyIndex));
-    else
+    } else if (accessorType != -1) {
+        const int flags = accessorType
+                | (captureRequired ? Runtime::AccessorCaptureRequired : 0)
+                | ((property->notifyIndex + 1) << Runtime::AccessorNotifyIndexShift);
+        generateFunctionCall(target, Runtime::getQmlQObjectPropertyViaAccessor, Assembler::ContextRegister, Assembler::PointerToValue(base),
+                             Assembler::TrustedImmPtr(property->accessors), Assembler::TrustedImmPtr(reinterpret_cast<void *>(property->accessorData)),
+                             Assembler::TrustedImm32(propertyIndex), Assembler::TrustedImm32(flags));
+    } else {
         generateFunctionCall(target, Runtime::getQmlQObjectProperty, Assembler::ContextRegister, Assembler::PointerToValue(base), Assembler::TrustedImm32(propertyIndex),
                              Assembler::TrustedImm32(captureRequired));
+    }
 }
 
 void InstructionSelection::setProperty(IR::Expr *source, IR::Expr *targetBase,
@@ -944,12 +1023,51 @@ void InstructionSelection::binop(IR::AluOp oper, IR::Expr *leftSource, IR::Expr
     binop.generate(leftSource, rightSource, target);
 }
 
+static int intrinsicForCall(const QString &name, int argc)
+{
+    if (argc == 0) {
+        if (name == QLatin1String("now"))
+            return Runtime::Intrinsic_DateNow;
+    } else if (argc == 1) {
+        if (name == QLatin1String("abs"))
+            return Assembler::supportsFloatingPointAbs() ? Runtime::Intrinsic_MathAbs : -1;
+        if (name == QLatin1String("floor"))
+            return Assembler::supportsFloatingPointTruncate() ? Runtime::Intrinsic_MathFloor : -1;
+        if (name == QLatin1String("sqrt"))
+            return Assembler::supportsFloatingPointSqrt() ? Runtime::Intrinsic_MathSqrt : -1;
+        if (name == QLatin1String("charCodeAt"))
+            return Runtime::Intrinsic_StringCharCodeAt;
+    } else if (argc == 2) {
+        if (name == QLatin1String("min"))
+            return Runtime::Intrinsic_MathMin;
+        if (name == QLatin1String("max"))
+            return Runtime::Intrinsic_MathMax;
+    }
+    return -1;
+}
+
 void InstructionSelection::callProperty(IR::Expr *base, const QString &name, IR::ExprList *args,
                                         IR::Temp *result)
 {
     Q_ASSERT(base != 0);
 
-    prepareCallData(args, base);
+    int argc = prepareCallData(args, base);
+
+    // Calls to a few unmodified builtins such as Math.floor are done inline when
+    // the arguments allow it, anything else takes the regular call below.
+    Assembler::Jump done;
+    int intrinsic = result ? intrinsicForCall(name, argc) : -1;
+    if (intrinsic != -1) {
+        Assembler::JumpList fallback;
+        generateFunctionCall(Assembler::ReturnValueRegister, Runtime::isIntrinsicCall,
+                             Assembler::ContextRegister, Assembler::PointerToString(name),
+                             baseAddressForCallData(), Assembler::TrustedImm32(intrinsic));
+        fallback.append(_as->branch32(Assembler::Equal, Assembler::ReturnValueRegister,
+                                      Assembler::TrustedImm32(0)));
+        generateIntrinsic(intrinsic, result, &fallback);
+        done = _as->jump();
+        fallback.link(_as);
+    }
 
     if (useFastLookups) {
         uint index = registerGetterLookup(name);
@@ -962,6 +1080,9 @@ void InstructionSelection::callProperty(IR::Expr *base, const QString &name, IR:
                              Assembler::PointerToString(name),
                              baseAddressForCallData());
     }
+
+    if (done.isSet())
+        done.link(_as);
 }
 
 void InstructionSelection::callSubscript(IR::Expr *base, IR::Expr *index, IR::ExprList *args,
@@ -1581,6 +1702,99 @@ int InstructionSelection::prepareCallData(IR::ExprList* args, IR::Expr *thisObje
     return argc;
 }
 
+// Loads an argument that prepareCallData stored as a double. The returned jump is
+// taken when the argument is not a number.
+Assembler::Jump InstructionSelection::loadCallArgumentAsDouble(int index, Assembler::FPRegisterID dest)
+{
+    Pointer arg(_as->stackLayout().argumentAddressForCall(index));
+    Pointer tagAddr = arg;
+    tagAddr.offset += 4;
+    _as->load32(tagAddr, Assembler::ScratchRegister);
+
+    Assembler::Jump isNoInt = _as->branch32(Assembler::NotEqual, Assembler::ScratchRegister,
+                                            Assembler::TrustedImm32(Value::_Integer_Type));
+    _as->load32(arg, Assembler::ScratchRegister);
+    _as->convertInt32ToDouble(Assembler::ScratchRegister, dest);
+    Assembler::Jump intDone = _as->jump();
+
+    isNoInt.link(_as);
+#if QT_POINTER_SIZE == 8
+    _as->and32(Assembler::TrustedImm32(Value::IsDouble_Mask), Assembler::ScratchRegister);
+    Assembler::Jump isNoDbl = _as->branch32(Assembler::Equal, Assembler::ScratchRegister,
+                                            Assembler::TrustedImm32(0));
+#else
+    _as->and32(Assembler::TrustedImm32(Value::NotDouble_Mask), Assembler::ScratchRegister);
+    Assembler::Jump isNoDbl = _as->branch32(Assembler::Equal, Assembler::ScratchRegister,
+                                            Assembler::TrustedImm32(Value::NotDouble_Mask));
+#endif
+    _as->loadDouble(arg, dest);
+
+    intDone.link(_as);
+    return isNoDbl;
+}
+
+// Emits the body of an intrinsic once isIntrinsicCall has vouched for the callee.
+// Whenever the result would differ from what the builtin returns (non-numbers,
+// NaN, signed zeroes, int overflow) it jumps to the fallback.
+void InstructionSelection::generateIntrinsic(int intrinsic, IR::Temp *result, Assembler::JumpList *fallback)
+{
+    switch (intrinsic) {
+    case Runtime::Intrinsic_MathAbs:
+        fallback->append(loadCallArgumentAsDouble(0, Assembler::FPGpr0));
+        _as->absDouble(Assembler::FPGpr0, Assembler::FPGpr1);
+        _as->storeDouble(Assembler::FPGpr1, result);
+        break;
+    case Runtime::Intrinsic_MathSqrt:
+        fallback->append(loadCallArgumentAsDouble(0, Assembler::FPGpr0));
+        _as->sqrtDouble(Assembler::FPGpr0, Assembler::FPGpr0);
+        _as->storeDouble(Assembler::FPGpr0, result);
+        break;
+    case Runtime::Intrinsic_MathFloor: {
+        fallback->append(loadCallArgumentAsDouble(0, Assembler::FPGpr0));
+        fallback->append(_as->branchTruncateDoubleToInt32(Assembler::FPGpr0, Assembler::ReturnValueRegister));
+        _as->convertInt32ToDouble(Assembler::ReturnValueRegister, Assembler::FPGpr1);
+        // floor(-0) is -0, which the truncation loses
+        Assembler::Jump nonZero = _as->branchTest32(Assembler::NonZero, Assembler::ReturnValueRegister);
+        fallback->append(_as->branchDouble(Assembler::DoubleEqual, Assembler::FPGpr0, Assembler::FPGpr1));
+        nonZero.link(_as);
+        // truncation rounds negative numbers up
+        Assembler::Jump exact = _as->branchDouble(Assembler::DoubleLessThanOrEqual,
+                                                  Assembler::FPGpr1, Assembler::FPGpr0);
+        fallback->append(_as->branchSub32(Assembler::Overflow, Assembler::TrustedImm32(1),
+                                          Assembler::ReturnValueRegister));
+        _as->convertInt32ToDouble(Assembler::ReturnValueRegister, Assembler::FPGpr1);
+        exact.link(_as);
+        _as->storeDouble(Assembler::FPGpr1, result);
+        break;
+    }
+    case Runtime::Intrinsic_MathMin:
+    case Runtime::Intrinsic_MathMax: {
+        fallback->append(loadCallArgumentAsDouble(0, Assembler::FPGpr0));
+        fallback->append(loadCallArgumentAsDouble(1, Assembler::FPGpr1));
+        // leaves NaN and min(0, -0) to the builtin
+        fallback->append(_as->branchDouble(Assembler::DoubleEqualOrUnordered,
+                                           Assembler::FPGpr0, Assembler::FPGpr1));
+        Assembler::Jump keepFirst = _as->branchDouble(intrinsic == Runtime::Intrinsic_MathMin
+                                                      ? Assembler::DoubleLessThan
+                                                      : Assembler::DoubleGreaterThan,
+                                                      Assembler::FPGpr0, Assembler::FPGpr1);
+        _as->moveDouble(Assembler::FPGpr1, Assembler::FPGpr0);
+        keepFirst.link(_as);
+        _as->storeDouble(Assembler::FPGpr0, result);
+        break;
+    }
+    case Runtime::Intrinsic_StringCharCodeAt:
+        generateFunctionCall(result, Runtime::stringCharCodeAt, Assembler::ContextRegister,
+                             baseAddressForCallData());
+        break;
+    case Runtime::Intrinsic_DateNow:
+        generateFunctionCall(result, Runtime::dateNow, Assembler::ContextRegister);
+        break;
+    default:
+        Q_UNREACHABLE();
+    }
+}
+
 
 QT_BEGIN_NAMESPACE
 namespace QV4 {
@@ -74,6 +74,8 @@ public:
 
     const void *addConstantTable(QVector<QV4::Primitive> *values);
 protected:
+    void generateBreakCheck();
+
     virtual QV4::CompiledData::CompilationUnit *backendCompileStep();
 
     virtual void callBuiltinInvalid(IR::Name *func, IR::ExprList *args, IR::Temp *result);
@@ -97,13 +99,15 @@ protected:
     virtual void callBuiltinDefineArray(IR::Temp *result, IR::ExprList *args);
     virtual void callBuiltinDefineObjectLiteral(IR::Temp *result, int keyValuePairCount, IR::ExprList *keyValuePairs, IR::ExprList *arrayEntries, bool needSparseArray);
     virtual void callBuiltinSetupArgumentObject(IR::Temp *result);
+    virtual void callBuiltinArgumentsLength(IR::Temp *result);
+    virtual void callBuiltinArgumentAt(IR::Expr *index, IR::Temp *result);
     virtual void callBuiltinConvertThisToObject();
     virtual void callValue(IR::Temp *value, IR::ExprList *args, IR::Temp *result);
     virtual void callProperty(IR::Expr *base, const QString &name, IR::ExprList *args, IR::Temp *result);
     virtual void callSubscript(IR::Expr *base, IR::Expr *index, IR::ExprList *args, IR::Temp *result);
     virtual void convertType(IR::Temp *source, IR::Temp *target);
     virtual void loadThisObject(IR::Temp *temp);
-    virtual void loadQmlIdArray(IR::Temp *temp);
+    virtual void loadQmlIdObject(int index, IR::Temp *temp);
     virtual void loadQmlImportedScripts(IR::Temp *temp);
     virtual void loadQmlContextObject(IR::Temp *temp);
     virtual void loadQmlScopeObject(IR::Temp *temp);
@@ -117,7 +121,7 @@ protected:
     virtual void getProperty(IR::Expr *base, const QString &name, IR::Temp *target);
     virtual void setProperty(IR::Expr *source, IR::Expr *targetBase, const QString &targetName);
     virtual void setQObjectProperty(IR::Expr *source, IR::Expr *targetBase, int propertyIndex);
-    virtual void getQObjectProperty(IR::Expr *base, int propertyIndex, bool captureRequired, int attachedPropertiesId, IR::Temp *target);
+    virtual void getQObjectProperty(IR::Expr *base, QQmlPropertyData *property, bool captureRequired, int attachedPropertiesId, IR::Temp *target);
     virtual void getElement(IR::Expr *base, IR::Expr *index, IR::Temp *target);
     virtual void setElement(IR::Expr *source, IR::Expr *targetBase, IR::Expr *targetIndex);
     virtual void copyValue(IR::Temp *sourceTemp, IR::Temp *targetTemp);
@@ -218,6 +222,8 @@ private:
 
     int prepareVariableArguments(IR::ExprList* args);
     int prepareCallData(IR::ExprList* args, IR::Expr *thisObject);
+    Assembler::Jump loadCallArgumentAsDouble(int index, Assembler::FPRegisterID dest);
+    void generateIntrinsic(int intrinsic, IR::Temp *result, Assembler::JumpList *fallback);
 
     template <typename Retval, typename Arg1, typename Arg2, typename Arg3>
     void generateLookupCall(Retval retval, uint index, uint getterSetterOffset, Arg1 arg1, Arg2 arg2, Arg3 arg3)
@@ -259,6 +265,7 @@ public:
     { return new InstructionSelection(qmlEngine, execAllocator, module, jsGenerator); }
     virtual bool jitCompileRegexps() const
     { return true; }
+    virtual QV4::CompiledData::CompilationUnit *createUnitForLoading();
 };
 
 } // end of namespace JIT
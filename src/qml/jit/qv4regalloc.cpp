@@ -216,6 +216,8 @@ protected: // IRDecoder
     virtual void callBuiltinDefineArray(IR::Temp *, IR::ExprList *) {}
     virtual void callBuiltinDefineObjectLiteral(IR::Temp *, int, IR::ExprList *, IR::ExprList *, bool) {}
     virtual void callBuiltinSetupArgumentObject(IR::Temp *) {}
+    virtual void callBuiltinArgumentsLength(IR::Temp *) {}
+    virtual void callBuiltinArgumentAt(IR::Expr *, IR::Temp *) {}
     virtual void callBuiltinConvertThisToObject() {}
 
     virtual void callValue(IR::Temp *value, IR::ExprList *args, IR::Temp *result)
@@ -346,8 +348,9 @@ protected: // IRDecoder
         addDef(temp);
     }
 
-    virtual void loadQmlIdArray(IR::Temp *temp)
+    virtual void loadQmlIdObject(int index, IR::Temp *temp)
     {
+        Q_UNUSED(index);
         addDef(temp);
         addCall();
     }
@@ -443,7 +446,7 @@ protected: // IRDecoder
         addCall();
     }
 
-    virtual void getQObjectProperty(IR::Expr *base, int /*propertyIndex*/, bool /*captureRequired*/, int /*attachedPropertiesId*/, IR::Temp *target)
+    virtual void getQObjectProperty(IR::Expr *base, QQmlPropertyData * /*property*/, bool /*captureRequired*/, int /*attachedPropertiesId*/, IR::Temp *target)
     {
         addDef(target);
         addUses(base->asTemp(), Use::CouldHaveRegister);
@@ -1073,13 +1076,15 @@ protected:
 };
 } // anonymous namespace
 
-RegisterAllocator::RegisterAllocator(const QVector<int> &normalRegisters, const QVector<int> &fpRegisters)
+RegisterAllocator::RegisterAllocator(const QVector<int> &normalRegisters, const QVector<int> &fpRegisters,
+                                     const QVector<int> &calleeSavedFpRegisters)
     : _normalRegisters(normalRegisters)
-    , _fpRegisters(fpRegisters)
+    , _fpRegisters(fpRegisters + calleeSavedFpRegisters)
+    , _firstCalleeSavedFpRegister(fpRegisters.size())
 {
     Q_ASSERT(normalRegisters.size() >= 2);
     Q_ASSERT(fpRegisters.size() >= 2);
-    _active.reserve((normalRegisters.size() + fpRegisters.size()) * 2);
+    _active.reserve((normalRegisters.size() + _fpRegisters.size()) * 2);
     _inactive.reserve(_active.size());
 }
 
@@ -1180,10 +1185,14 @@ void RegisterAllocator::prepareRanges()
             _active.append(lti);
     }
 
+    // Callee saved registers survive calls, so values that live across a call can stay in
+    // them instead of being spilled and reloaded around it.
+    const LifeTimeInterval ltiWithoutCalls = createFixedInterval(0);
     const int fpRegCount = _fpRegisters.size();
     _fixedFPRegisterRanges.reserve(fpRegCount);
     for (int fpReg = 0; fpReg < fpRegCount; ++fpReg) {
-        LifeTimeInterval lti = cloneFixedInterval(fpReg, true, ltiWithCalls);
+        LifeTimeInterval lti = cloneFixedInterval(fpReg, true, fpReg < _firstCalleeSavedFpRegister
+                                                                ? ltiWithCalls : ltiWithoutCalls);
         _fixedFPRegisterRanges.append(lti);
         if (lti.isValid())
             _active.append(lti);
@@ -60,6 +60,7 @@ class RegisterAllocator
 
     QVector<int> _normalRegisters;
     QVector<int> _fpRegisters;
+    int _firstCalleeSavedFpRegister;
     QScopedPointer<RegAllocInfo> _info;
 
     QVector<LifeTimeInterval> _fixedRegisterRanges, _fixedFPRegisterRanges;
@@ -73,7 +74,8 @@ class RegisterAllocator
     Q_DISABLE_COPY(RegisterAllocator)
 
 public:
-    RegisterAllocator(const QVector<int> &normalRegisters, const QVector<int> &fpRegisters);
+    RegisterAllocator(const QVector<int> &normalRegisters, const QVector<int> &fpRegisters,
+                      const QVector<int> &calleeSavedFpRegisters = QVector<int>());
     ~RegisterAllocator();
 
     void run(IR::Function *function, const IR::Optimizer &opt);
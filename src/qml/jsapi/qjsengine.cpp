@@ -254,6 +254,13 @@ void QJSEngine::collectGarbage()
     the file name is accessible through the "fileName" property if it is
     provided with this function.
 
+    Larger programs that are given a \a fileName, such as libraries that are
+    evaluated on every start, are compiled once and then loaded from the QML
+    disk cache, for as long as the program text stays the same. Setting the
+    \c QML_DISABLE_DISK_CACHE environment variable turns this off. Cached
+    programs run in the interpreter, so engines that use the JIT only use the
+    cache when the \c QML_FORCE_DISK_CACHE environment variable is set.
+
     \note If an exception was thrown and the exception value is not an
     Error instance (i.e., QJSValue::isError() returns \c false), the
     exception value will still be returned, but there is currently no
@@ -268,9 +275,13 @@ QJSValue QJSEngine::evaluate(const QString& program, const QString& fileName, in
         ctx = v4->pushGlobalContext();
     QV4::ScopedValue result(scope);
 
+    // Compiling a small program is cheaper than looking it up on disk.
+    static const int minimumCachedProgramSize = 4096;
+
     QV4::Script script(ctx, program, fileName, lineNumber);
     script.strictMode = ctx->strictMode;
     script.inheritContext = true;
+    script.useDiskCache = !fileName.isEmpty() && program.size() >= minimumCachedProgramSize;
     script.parse();
     if (!scope.engine->hasException)
         result = script.run();
@@ -52,6 +52,7 @@
 #include "qv4runtime_p.h"
 #include "qv4variantobject_p.h"
 #include "qv4regexpobject_p.h"
+#include "qv4qobjectwrapper_p.h"
 #include "private/qv8engine_p.h"
 #include <private/qv4mm_p.h>
 #include <private/qv4scopedvalue_p.h>
@@ -644,6 +645,135 @@ QJSValue QJSValue::callAsConstructor(const QJSValueList &args)
     return new QJSValuePrivate(engine, result);
 }
 
+/*!
+  \internal
+
+  Prepares a call of \a function with \a argc arguments, all initially
+  undefined.  The global object is used as the \c this object unless
+  setThisObject() is called.
+*/
+QJSValueCall::QJSValueCall(QJSEngine *engine, const QJSValue &function, int argc)
+    : m_scope(QV8Engine::getV4(engine))
+    , m_function(m_scope)
+    , m_callData(m_scope, argc)
+    , m_result(m_scope)
+{
+    QJSValuePrivate *d = QJSValuePrivate::get(function);
+    if (d->checkEngine(m_scope.engine))
+        m_function = d->value.asFunctionObject();
+    else
+        qWarning("QJSValueCall: cannot call function created in a different engine");
+
+    m_callData->thisObject = m_scope.engine->globalObject->asReturnedValue();
+    for (int i = 0; i < argc; ++i)
+        m_callData->args[i] = Primitive::undefinedValue();
+}
+
+void QJSValueCall::setThisObject(const QJSValue &instance)
+{
+    QJSValuePrivate *d = QJSValuePrivate::get(instance);
+    if (!d->checkEngine(m_scope.engine)) {
+        qWarning("QJSValueCall: cannot call function with thisObject created in a different engine");
+        m_function = (FunctionObject *)0;
+        return;
+    }
+    m_callData->thisObject = d->getValue(m_scope.engine);
+}
+
+void QJSValueCall::setArgument(int index, int value)
+{
+    Q_ASSERT(index >= 0 && index < m_callData->argc);
+    m_callData->args[index] = Primitive::fromInt32(value);
+}
+
+void QJSValueCall::setArgument(int index, uint value)
+{
+    Q_ASSERT(index >= 0 && index < m_callData->argc);
+    m_callData->args[index] = Primitive::fromUInt32(value);
+}
+
+void QJSValueCall::setArgument(int index, double value)
+{
+    Q_ASSERT(index >= 0 && index < m_callData->argc);
+    m_callData->args[index] = Primitive::fromDouble(value);
+}
+
+void QJSValueCall::setArgument(int index, bool value)
+{
+    Q_ASSERT(index >= 0 && index < m_callData->argc);
+    m_callData->args[index] = Primitive::fromBoolean(value);
+}
+
+void QJSValueCall::setArgument(int index, const QString &value)
+{
+    Q_ASSERT(index >= 0 && index < m_callData->argc);
+    m_callData->args[index] = m_scope.engine->newString(value)->asReturnedValue();
+}
+
+void QJSValueCall::setArgument(int index, const QLatin1String &value)
+{
+    Q_ASSERT(index >= 0 && index < m_callData->argc);
+    m_callData->args[index] = m_scope.engine->newString(value)->asReturnedValue();
+}
+
+#ifndef QT_NO_CAST_FROM_ASCII
+void QJSValueCall::setArgument(int index, const char *value)
+{
+    Q_ASSERT(index >= 0 && index < m_callData->argc);
+    m_callData->args[index] = m_scope.engine->newString(QString::fromUtf8(value))->asReturnedValue();
+}
+#endif
+
+void QJSValueCall::setArgument(int index, QObject *value)
+{
+    Q_ASSERT(index >= 0 && index < m_callData->argc);
+    m_callData->args[index] = QObjectWrapper::wrap(m_scope.engine, value);
+}
+
+void QJSValueCall::setArgument(int index, const QJSValue &value)
+{
+    Q_ASSERT(index >= 0 && index < m_callData->argc);
+    QJSValuePrivate *d = QJSValuePrivate::get(value);
+    if (!d->checkEngine(m_scope.engine)) {
+        qWarning("QJSValueCall: cannot call function with argument created in a different engine");
+        m_function = (FunctionObject *)0;
+        return;
+    }
+    m_callData->args[index] = d->getValue(m_scope.engine);
+}
+
+/*!
+  \internal
+
+  Calls the function.  Returns false if this call is not valid or the
+  function threw an exception, in which case result() holds the exception.
+*/
+bool QJSValueCall::call()
+{
+    if (!m_function) {
+        m_result = Primitive::undefinedValue();
+        return false;
+    }
+
+    ExecutionContext *ctx = m_scope.engine->currentContext();
+    m_result = m_function->call(m_callData);
+    if (m_scope.hasException()) {
+        m_result = ctx->catchException();
+        return false;
+    }
+    return true;
+}
+
+/*!
+  \internal
+
+  Returns the result of the last call() as a QJSValue.
+*/
+QJSValue QJSValueCall::resultValue()
+{
+    return new QJSValuePrivate(m_scope.engine, m_result);
+}
+
 #ifdef QT_DEPRECATED
 
 /*!
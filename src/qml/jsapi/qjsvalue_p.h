@@ -59,6 +59,7 @@
 #include <private/qv4string_p.h>
 #include <private/qv4engine_p.h>
 #include <private/qv4object_p.h>
+#include <private/qv4scopedvalue_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -92,6 +93,59 @@ public:
     QString string;
 };
 
+/*!
+  \internal
+  \class QJSValueCall
+
+  Calls a script function from C++ without going through QJSValueList.  The
+  arguments are written directly into the engine's call data, and the result
+  stays on the JS stack until the QJSValueCall goes out of scope, so neither
+  needs a QJSValuePrivate.  Intended for callbacks that run at a high rate:
+
+  \code
+  QJSValueCall call(&engine, callback, 2);
+  call.setArgument(0, index);
+  call.setArgument(1, value);
+  if (call.call())
+      total += call.result()->toNumber();
+  \endcode
+*/
+class Q_QML_PRIVATE_EXPORT QJSValueCall
+{
+public:
+    QJSValueCall(QJSEngine *engine, const QJSValue &function, int argc);
+
+    bool isValid() const { return m_function; }
+
+    void setThisObject(const QJSValue &);
+    void setArgument(int, int);
+    void setArgument(int, uint);
+    void setArgument(int, double);
+    void setArgument(int, bool);
+    void setArgument(int, const QString &);
+    void setArgument(int, const QLatin1String &);
+#ifndef QT_NO_CAST_FROM_ASCII
+    QT_ASCII_CAST_WARN void setArgument(int, const char *);
+#endif
+    void setArgument(int, QObject *);
+    void setArgument(int, const QJSValue &);
+
+    // Returns false if the call failed; result() then holds the exception, if any
+    bool call();
+    QV4::ValueRef result() { return m_result; }
+    QJSValue resultValue();
+
+private:
+    Q_DISABLE_COPY(QJSValueCall)
+    // force compile error, prevent setArgument(int, bool) to be called with other pointers
+    void setArgument(int, void *) Q_DECL_EQ_DELETE;
+
+    QV4::Scope m_scope;
+    QV4::ScopedFunctionObject m_function;
+    QV4::ScopedCallData m_callData;
+    QV4::ScopedValue m_result;
+};
+
 QT_END_NAMESPACE
 
 #endif
@@ -0,0 +1,146 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQml module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qv4arraybuffer_p.h"
+#include "qv4typedarray_p.h"
+
+using namespace QV4;
+
+DEFINE_OBJECT_VTABLE(ArrayBufferCtor);
+DEFINE_OBJECT_VTABLE(ArrayBuffer);
+
+ArrayBufferCtor::ArrayBufferCtor(ExecutionContext *scope)
+    : FunctionObject(scope, QStringLiteral("ArrayBuffer"))
+{
+    setVTable(staticVTable());
+}
+
+ReturnedValue ArrayBufferCtor::construct(Managed *m, CallData *callData)
+{
+    ExecutionEngine *v4 = m->engine();
+
+    Scope scope(v4);
+    ScopedValue l(scope, callData->argument(0));
+    double dl = l->toInteger();
+    if (v4->hasException)
+        return Encode::undefined();
+    uint len = (uint)qBound(0., dl, (double)UINT_MAX);
+    if (len != dl || len > INT_MAX)
+        return v4->currentContext()->throwRangeError(QLatin1String("ArrayBuffer constructor: invalid length"));
+
+    return Encode(v4->newArrayBuffer((int)len));
+}
+
+
+ReturnedValue ArrayBufferCtor::call(Managed *that, CallData *)
+{
+    return that->engine()->currentContext()->throwTypeError();
+}
+
+ReturnedValue ArrayBufferCtor::method_isView(CallContext *ctx)
+{
+    QV4::Scope scope(ctx);
+    QV4::Scoped<TypedArray> a(scope, ctx->argument(0));
+    return Encode(!!a);
+}
+
+
+ArrayBuffer::ArrayBuffer(ExecutionEngine *v4, int length)
+    : Object(v4->arrayBufferClass)
+    , data(length, 0)
+{
+    setVTable(staticVTable());
+}
+
+ArrayBuffer::ArrayBuffer(ExecutionEngine *v4, const QByteArray &array)
+    : Object(v4->arrayBufferClass)
+    , data(array)
+{
+    setVTable(staticVTable());
+}
+
+void ArrayBuffer::destroy(Managed *m)
+{
+    static_cast<ArrayBuffer *>(m)->~ArrayBuffer();
+}
+
+
+void ArrayBufferPrototype::init(ExecutionEngine *engine, ObjectRef ctor)
+{
+    Scope scope(engine);
+    ScopedObject o(scope);
+    ctor->defineReadonlyProperty(engine->id_length, Primitive::fromInt32(1));
+    ctor->defineReadonlyProperty(engine->id_prototype, (o = this));
+    ctor->defineDefaultProperty(QStringLiteral("isView"), ArrayBufferCtor::method_isView, 1);
+    defineDefaultProperty(QStringLiteral("constructor"), (o = ctor));
+    defineAccessorProperty(QStringLiteral("byteLength"), method_get_byteLength, 0);
+    defineDefaultProperty(QStringLiteral("slice"), method_slice, 2);
+}
+
+ReturnedValue ArrayBufferPrototype::method_get_byteLength(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<ArrayBuffer> v(scope, ctx->callData->thisObject);
+    if (!v)
+        return ctx->throwTypeError();
+
+    return Encode(v->byteLength());
+}
+
+ReturnedValue ArrayBufferPrototype::method_slice(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<ArrayBuffer> a(scope, ctx->callData->thisObject);
+    if (!a)
+        return ctx->throwTypeError();
+
+    double start = ctx->callData->argc > 0 ? ctx->callData->args[0].toInteger() : 0;
+    double end = (ctx->callData->argc < 2 || ctx->callData->args[1].isUndefined()) ?
+                a->data.size() : ctx->callData->args[1].toInteger();
+    if (scope.engine->hasException)
+        return Encode::undefined();
+
+    double first = (start < 0) ? qMax(a->data.size() + start, 0.) : qMin(start, (double)a->data.size());
+    double last = (end < 0) ? qMax(a->data.size() + end, 0.) : qMin(end, (double)a->data.size());
+
+    int newLen = qMax(last - first, 0.);
+    return Encode(ctx->engine->newArrayBuffer(a->data.mid((int)first, newLen)));
+}
@@ -79,9 +79,28 @@ const ArrayVTable SparseArrayData::static_vtbl =
     SparseArrayData::length
 };
 
+const ArrayVTable PackedArrayData::static_vtbl =
+{
+    DEFINE_MANAGED_VTABLE_INT(PackedArrayData),
+    ArrayData::Int32,
+    PackedArrayData::reallocate,
+    PackedArrayData::get,
+    PackedArrayData::put,
+    PackedArrayData::putArray,
+    PackedArrayData::del,
+    PackedArrayData::setAttribute,
+    PackedArrayData::attribute,
+    PackedArrayData::push_front,
+    PackedArrayData::pop_front,
+    PackedArrayData::truncate,
+    PackedArrayData::length
+};
+
 
 void ArrayData::realloc(Object *o, Type newType, uint offset, uint alloc, bool enforceAttributes)
 {
+    if (o->arrayData && o->arrayData->isPacked())
+        PackedArrayData::unpack(o);
     ArrayData *d = o->arrayData;
 
     uint oldAlloc = 0;
@@ -421,6 +440,45 @@ uint SparseArrayData::allocate(Object *o, bool doubleSlot)
     }
 }
 
+// Arrays only become sparse because of a write far beyond their end, an
+// accessor or a huge length. Once the entries fill most of the index range
+// again, a simple array is both smaller and faster to index and iterate.
+static inline bool shouldDensify(uint entries, uint length)
+{
+    return length < 0x100000 && (length <= 0x1000 || 2*entries >= length);
+}
+
+bool SparseArrayData::densify(Object *o)
+{
+    Q_ASSERT(o->arrayData->type == ArrayData::Sparse);
+    SparseArrayData *d = static_cast<SparseArrayData *>(o->arrayData);
+    if (d->attrs || o->hasAccessorProperty)
+        return false;
+    if (o->isArrayObject() && o->getLength() >= 0x100000)
+        return false;
+
+    uint len = length(d);
+    if (!shouldDensify(d->sparse->nEntries(), len))
+        return false;
+
+    // keep the old data reachable while allocating the new one
+    Scope scope(o->engine());
+    ScopedValue old(scope, d->asReturnedValue());
+
+    o->arrayData = 0;
+    ArrayData::realloc(o, ArrayData::Simple, 0, len, false);
+    SimpleArrayData *dd = static_cast<SimpleArrayData *>(o->arrayData);
+    for (uint i = 0; i < len; ++i)
+        dd->data[i] = Primitive::emptyValue();
+    for (const SparseArrayNode *n = d->sparse->begin(); n != d->sparse->end(); n = n->nextNode())
+        dd->data[n->key()] = d->data[n->value];
+    dd->len = len;
+
+    delete d->sparse;
+    d->sparse = 0;
+    return true;
+}
+
 ReturnedValue SparseArrayData::get(const ArrayData *d, uint index)
 {
     SparseArrayNode *n = static_cast<const SparseArrayData *>(d)->sparse->findNode(index);
@@ -475,7 +533,9 @@ bool SparseArrayData::del(Object *o, uint index)
     }
 
     dd->freeList = pidx;
-    dd->sparse->erase(n);
+    // removing the last entry shrinks the index range the entries are spread over
+    if (dd->sparse->erase(n) == dd->sparse->end())
+        densify(o);
     return true;
 }
 
@@ -548,6 +608,7 @@ uint SparseArrayData::truncate(Object *o, uint newLen)
                 break;
             it = prev;
         }
+        densify(o);
     }
     return newLen;
 }
@@ -570,6 +631,228 @@ bool SparseArrayData::putArray(Object *o, uint index, Value *values, uint n)
 }
 
 
+ArrayData::Type PackedArrayData::packedType(const Value *values, uint n)
+{
+    Type type = Int32;
+    for (uint i = 0; i < n; ++i) {
+        if (values[i].isInteger())
+            continue;
+        if (!values[i].isNumber())
+            return Simple;
+        type = Double;
+    }
+    return type;
+}
+
+bool PackedArrayData::create(Object *o, const Value *values, uint n)
+{
+    Q_ASSERT(!o->arrayData);
+    if (!n || !o->isArrayObject())
+        return false;
+    Type type = packedType(values, n);
+    if (type == Simple)
+        return false;
+    reserve(o, type, n);
+    return true;
+}
+
+void PackedArrayData::reserve(Object *o, Type type, uint n)
+{
+    PackedArrayData *d = static_cast<PackedArrayData *>(o->arrayData);
+    Q_ASSERT(!d || d->isPacked());
+    Q_ASSERT(type == Int32 || type == Double);
+
+    uint alloc = qMax(n, 8u);
+    if (d) {
+        if (d->type == Double)
+            type = Double;
+        if (n <= d->alloc) {
+            if (type == d->type)
+                return;
+            alloc = d->alloc;
+        } else {
+            alloc = qMax(alloc, 2*d->alloc);
+        }
+    }
+
+    size_t size = sizeof(PackedArrayData) + alloc*elementSize(type);
+    PackedArrayData *newData = static_cast<PackedArrayData *>(o->engine()->memoryManager->allocManaged(size));
+    new (newData) PackedArrayData(o->engine());
+    newData->alloc = alloc;
+    newData->type = type;
+    newData->attrs = 0;
+    newData->data = 0;
+    newData->len = 0;
+    newData->intData = reinterpret_cast<int *>(newData + 1);
+
+    if (d) {
+        newData->len = d->len;
+        if (d->type == type) {
+            memcpy(newData->intData, d->intData, d->len*elementSize(type));
+        } else {
+            for (uint i = 0; i < d->len; ++i)
+                newData->doubleData[i] = d->intData[i];
+        }
+    }
+    o->arrayData = newData;
+}
+
+void PackedArrayData::unpack(Object *o, uint alloc)
+{
+    PackedArrayData *d = static_cast<PackedArrayData *>(o->arrayData);
+    Q_ASSERT(d && d->isPacked());
+
+    // keep the old data reachable while allocating the new one
+    Scope scope(o->engine());
+    ScopedValue old(scope, d->asReturnedValue());
+
+    o->arrayData = 0;
+    ArrayData::realloc(o, ArrayData::Simple, 0, qMax(alloc, d->alloc), false);
+    SimpleArrayData *dd = static_cast<SimpleArrayData *>(o->arrayData);
+    if (d->type == Int32) {
+        for (uint i = 0; i < d->len; ++i)
+            dd->data[i] = Primitive::fromInt32(d->intData[i]);
+    } else {
+        for (uint i = 0; i < d->len; ++i)
+            dd->data[i] = Primitive::fromDouble(d->doubleData[i]);
+    }
+    dd->len = d->len;
+}
+
+void PackedArrayData::destroy(Managed *)
+{
+}
+
+void PackedArrayData::markObjects(Managed *, ExecutionEngine *)
+{
+}
+
+ArrayData *PackedArrayData::reallocate(Object *o, uint n, bool enforceAttributes)
+{
+    if (enforceAttributes)
+        realloc(o, Simple, 0, n, true);
+    else
+        reserve(o, o->arrayData->type, n);
+    return o->arrayData;
+}
+
+ReturnedValue PackedArrayData::get(const ArrayData *d, uint index)
+{
+    const PackedArrayData *dd = static_cast<const PackedArrayData *>(d);
+    if (index >= dd->len)
+        return Primitive::emptyValue().asReturnedValue();
+    if (dd->type == Int32)
+        return Encode(dd->intData[index]);
+    return Encode(dd->doubleData[index]);
+}
+
+bool PackedArrayData::put(Object *o, uint index, ValueRef value)
+{
+    return putArray(o, index, value, 1);
+}
+
+bool PackedArrayData::putArray(Object *o, uint index, Value *values, uint n)
+{
+    PackedArrayData *dd = static_cast<PackedArrayData *>(o->arrayData);
+    Type type = index <= dd->len ? packedType(values, n) : Simple;
+    if (type == Simple) {
+        // a value that isn't a number or a hole in front of the new values
+        unpack(o, index + n);
+        return SimpleArrayData::putArray(o, index, values, n);
+    }
+
+    reserve(o, type, index + n);
+    dd = static_cast<PackedArrayData *>(o->arrayData);
+    if (dd->type == Int32) {
+        for (uint i = 0; i < n; ++i)
+            dd->intData[index + i] = values[i].integerValue();
+    } else {
+        for (uint i = 0; i < n; ++i)
+            dd->doubleData[index + i] = values[i].asDouble();
+    }
+    dd->len = qMax(dd->len, index + n);
+    return true;
+}
+
+bool PackedArrayData::del(Object *o, uint index)
+{
+    PackedArrayData *dd = static_cast<PackedArrayData *>(o->arrayData);
+    if (index >= dd->len)
+        return true;
+    // the storage doesn't need to cover the length of the array, so removing the last
+    // element doesn't leave a hole
+    if (index == dd->len - 1) {
+        --dd->len;
+        return true;
+    }
+    unpack(o);
+    return SimpleArrayData::del(o, index);
+}
+
+void PackedArrayData::setAttribute(Object *o, uint index, PropertyAttributes attrs)
+{
+    ArrayData::ensureAttributes(o);
+    o->arrayData->vtable()->setAttribute(o, index, attrs);
+}
+
+PropertyAttributes PackedArrayData::attribute(const ArrayData *, uint)
+{
+    return Attr_Data;
+}
+
+void PackedArrayData::push_front(Object *o, Value *values, uint n)
+{
+    PackedArrayData *dd = static_cast<PackedArrayData *>(o->arrayData);
+    Type type = packedType(values, n);
+    if (type == Simple) {
+        unpack(o);
+        SimpleArrayData::push_front(o, values, n);
+        return;
+    }
+
+    reserve(o, type, dd->len + n);
+    dd = static_cast<PackedArrayData *>(o->arrayData);
+    if (dd->type == Int32) {
+        memmove(dd->intData + n, dd->intData, dd->len*sizeof(int));
+        for (uint i = 0; i < n; ++i)
+            dd->intData[i] = values[i].integerValue();
+    } else {
+        memmove(dd->doubleData + n, dd->doubleData, dd->len*sizeof(double));
+        for (uint i = 0; i < n; ++i)
+            dd->doubleData[i] = values[i].asDouble();
+    }
+    dd->len += n;
+}
+
+ReturnedValue PackedArrayData::pop_front(Object *o)
+{
+    PackedArrayData *dd = static_cast<PackedArrayData *>(o->arrayData);
+    if (!dd->len)
+        return Encode::undefined();
+
+    ReturnedValue v = get(dd, 0);
+    --dd->len;
+    if (dd->type == Int32)
+        memmove(dd->intData, dd->intData + 1, dd->len*sizeof(int));
+    else
+        memmove(dd->doubleData, dd->doubleData + 1, dd->len*sizeof(double));
+    return v;
+}
+
+uint PackedArrayData::truncate(Object *o, uint newLen)
+{
+    PackedArrayData *dd = static_cast<PackedArrayData *>(o->arrayData);
+    if (newLen < dd->len)
+        dd->len = newLen;
+    return newLen;
+}
+
+uint PackedArrayData::length(const ArrayData *d)
+{
+    return static_cast<const PackedArrayData *>(d)->len;
+}
+
+
 uint ArrayData::append(Object *obj, const ArrayObject *otherObj, uint n)
 {
     Q_ASSERT(!obj->arrayData->hasAttributes());
@@ -600,6 +883,12 @@ uint ArrayData::append(Object *obj, const ArrayObject *otherObj, uint n)
                  it != static_cast<const SparseArrayData *>(other)->sparse->end(); it = it->nextNode())
                 obj->arraySet(oldSize + it->key(), ValueRef(other->data[it->value]));
         }
+    } else if (other->isPacked()) {
+        Scope scope(obj->engine());
+        ScopedValue v(scope);
+        uint len = qMin(n, other->length());
+        for (uint i = 0; i < len; ++i)
+            obj->arraySet(oldSize + i, (v = other->get(i)));
     } else {
         obj->arrayPut(oldSize, other->data, n);
     }
@@ -609,6 +898,18 @@ uint ArrayData::append(Object *obj, const ArrayObject *otherObj, uint n)
 
 Property *ArrayData::insert(Object *o, uint index, bool isAccessor)
 {
+    if (o->arrayData->isPacked())
+        PackedArrayData::unpack(o);
+
+    if (!isAccessor && o->arrayData->type == ArrayData::Sparse) {
+        // filling a hole; check the density whenever the entry count
+        // reaches a power of two to keep the cost amortized
+        SparseArrayData *d = static_cast<SparseArrayData *>(o->arrayData);
+        uint entries = d->sparse->nEntries() + 1;
+        if (!(entries & (entries - 1)) && index < SparseArrayData::length(d))
+            SparseArrayData::densify(o);
+    }
+
     if (!isAccessor && o->arrayData->type != ArrayData::Sparse) {
         SimpleArrayData *d = static_cast<SimpleArrayData *>(o->arrayData);
         if (index < 0x1000 || index < d->len + (d->len >> 2)) {
@@ -674,6 +975,43 @@ bool ArrayElementLessThan::operator()(const Value &v1, const Value &v2) const
     return p1s->toQString() < p2s->toQString();
 }
 
+// Writes the decimal representation of value into the end of buffer, which
+// has to be at least 12 characters large, and returns a pointer to it.
+static inline const char *int32ToDecimal(int value, char *buffer)
+{
+    char *p = buffer + 11;
+    *p = 0;
+    uint v = value < 0 ? 0u - uint(value) : uint(value);
+    do {
+        *--p = char('0' + v % 10);
+        v /= 10;
+    } while (v);
+    if (value < 0)
+        *--p = '-';
+    return p;
+}
+
+// Without a compare function, elements are sorted by their string values.
+// For arrays holding only integers that ordering can be computed on stack
+// buffers instead of allocating two strings for every comparison.
+class IntegerArrayElementLessThan
+{
+public:
+    inline bool operator()(const Value &v1, const Value &v2) const
+    {
+        return operator()(v1.integerValue(), v2.integerValue());
+    }
+
+    inline bool operator()(int i1, int i2) const
+    {
+        if (uint(i1) < 10 && uint(i2) < 10)
+            return i1 < i2;
+        char b1[12];
+        char b2[12];
+        return qstrcmp(int32ToDecimal(i1, b1), int32ToDecimal(i2, b2)) < 0;
+    }
+};
+
 template <typename RandomAccessIterator, typename T, typename LessThan>
 void sortHelper(RandomAccessIterator start, RandomAccessIterator end, const T &t, LessThan lessThan)
 {
@@ -744,6 +1082,19 @@ void ArrayData::sort(ExecutionContext *context, ObjectRef thisObject, const Valu
     // The spec says the sorting goes through a series of get,put and delete operations.
     // this implies that the attributes don't get sorted around.
 
+    if (thisObject->arrayData->isPacked()) {
+        PackedArrayData *d = static_cast<PackedArrayData *>(thisObject->arrayData);
+        if (d->type == ArrayData::Int32 && comparefn->isUndefined()) {
+            if (len > d->len)
+                len = d->len;
+            sortHelper(d->intData, d->intData + len, *d->intData, IntegerArrayElementLessThan());
+            return;
+        }
+        // anything else sorts boxed values, a compare function may even store other values
+        // in the array while sorting
+        PackedArrayData::unpack(thisObject.getPointer());
+    }
+
     if (thisObject->arrayData->type == ArrayData::Sparse) {
         // since we sort anyway, we can simply iterate over the entries in the sparse
         // array and append them one by one to a regular one.
@@ -816,10 +1167,18 @@ void ArrayData::sort(ExecutionContext *context, ObjectRef thisObject, const Valu
     }
 
 
-    ArrayElementLessThan lessThan(context, thisObject, comparefn);
-
     Value *begin = thisObject->arrayData->data;
-    sortHelper(begin, begin + len, *begin, lessThan);
+
+    bool allIntegers = !comparefn->isObject() && !thisObject->arrayData->attrs;
+    for (uint i = 0; allIntegers && i < len; ++i)
+        allIntegers = begin[i].isInteger();
+
+    if (allIntegers) {
+        sortHelper(begin, begin + len, *begin, IntegerArrayElementLessThan());
+    } else {
+        ArrayElementLessThan lessThan(context, thisObject, comparefn);
+        sortHelper(begin, begin + len, *begin, lessThan);
+    }
 
 #ifdef CHECK_SPARSE_ARRAYS
     thisObject->initSparseArray();
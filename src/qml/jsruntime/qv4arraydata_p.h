@@ -89,7 +89,9 @@ struct Q_QML_EXPORT ArrayData : public Managed
         Simple = 0,
         Complex = 1,
         Sparse = 2,
-        Custom = 3
+        Custom = 3,
+        Int32 = 4,
+        Double = 5
     };
 
     uint alloc;
@@ -99,6 +101,7 @@ struct Q_QML_EXPORT ArrayData : public Managed
 
     const ArrayVTable *vtable() const { return reinterpret_cast<const ArrayVTable *>(internalClass->vtable); }
     bool isSparse() const { return this && type == Sparse; }
+    bool isPacked() const { return this && type >= Int32; }
 
     uint length() const {
         if (!this)
@@ -177,6 +180,46 @@ struct Q_QML_EXPORT SparseArrayData : public ArrayData
 
     static uint allocate(Object *o, bool doubleSlot = false);
     static void free(ArrayData *d, uint idx);
+    static bool densify(Object *o);
+
+    static void destroy(Managed *d);
+    static void markObjects(Managed *d, ExecutionEngine *e);
+
+    static ArrayData *reallocate(Object *o, uint n, bool enforceAttributes);
+    static ReturnedValue get(const ArrayData *d, uint index);
+    static bool put(Object *o, uint index, ValueRef value);
+    static bool putArray(Object *o, uint index, Value *values, uint n);
+    static bool del(Object *o, uint index);
+    static void setAttribute(Object *o, uint index, PropertyAttributes attrs);
+    static PropertyAttributes attribute(const ArrayData *d, uint index);
+    static void push_front(Object *o, Value *values, uint n);
+    static ReturnedValue pop_front(Object *o);
+    static uint truncate(Object *o, uint newLen);
+    static uint length(const ArrayData *d);
+};
+
+// Arrays that only ever held numbers store them unboxed, as int or as double. Packed
+// storage has no holes and no attributes, anything else converts it to a SimpleArrayData.
+struct Q_QML_EXPORT PackedArrayData : public ArrayData
+{
+    V4_ARRAYDATA
+
+    PackedArrayData(ExecutionEngine *engine)
+        : ArrayData(engine->emptyClass)
+    { setVTable(staticVTable()); }
+
+    uint len;
+    union {
+        int *intData;
+        double *doubleData;
+    };
+
+    static uint elementSize(Type type) { return type == Int32 ? sizeof(int) : sizeof(double); }
+    static Type packedType(const Value *values, uint n);
+
+    static bool create(Object *o, const Value *values, uint n);
+    static void reserve(Object *o, Type type, uint n);
+    static void unpack(Object *o, uint alloc = 0);
 
     static void destroy(Managed *d);
     static void markObjects(Managed *d, ExecutionEngine *e);
@@ -199,7 +242,11 @@ inline Property *ArrayData::getProperty(uint index) const
 {
     if (!this)
         return 0;
-    if (type != Sparse) {
+    if (type >= Int32) {
+        // there is no Property to point to, callers handle packed elements themselves
+        Q_ASSERT(index >= static_cast<const PackedArrayData *>(this)->len);
+        return 0;
+    } else if (type != Sparse) {
         const SimpleArrayData *that = static_cast<const SimpleArrayData *>(this);
         if (index >= that->len || data[index].isEmpty())
             return 0;
@@ -280,6 +280,8 @@ ReturnedValue ArrayPrototype::method_push(CallContext *ctx)
     if (!instance)
         return Encode::undefined();
 
+    if (!instance->arrayData)
+        PackedArrayData::create(instance.getPointer(), ctx->callData->args, ctx->callData->argc);
     instance->arrayCreate();
 
     uint len = instance->getLength();
@@ -304,7 +306,8 @@ ReturnedValue ArrayPrototype::method_push(CallContext *ctx)
 
     if (!ctx->callData->argc) {
         ;
-    } else if (!instance->protoHasArray() && instance->arrayData->length() <= len && instance->arrayType() == ArrayData::Simple) {
+    } else if (!instance->protoHasArray() && instance->arrayData->length() <= len
+               && (instance->arrayType() == ArrayData::Simple || instance->arrayData->isPacked())) {
         instance->arrayData->vtable()->putArray(instance.getPointer(), len, ctx->callData->args, ctx->callData->argc);
         len = instance->arrayData->length();
     } else {
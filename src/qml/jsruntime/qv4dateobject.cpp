@@ -48,6 +48,7 @@
 #include <QtCore/QDateTime>
 #include <QtCore/QStringList>
 #include <QtCore/QDebug>
+#include <QtCore/QThreadStorage>
 #include <cmath>
 #include <qmath.h>
 #include <qnumeric.h>
@@ -287,7 +288,7 @@ static inline double MakeDate(double day, double time)
     return day * msPerDay + time;
 }
 
-static inline double DaylightSavingTA(double t)
+static double queryDaylightSavingTA(double t)
 {
     struct tm tmtm;
 #if defined(_MSC_VER) && _MSC_VER >= 1400
@@ -309,6 +310,95 @@ static inline double DaylightSavingTA(double t)
     return (tmtm.tm_isdst > 0) ? msPerHour : 0;
 }
 
+// Asking the C library for the DST offset takes a lock and is far too slow to do for
+// every conversion, so each thread remembers a few intervals over which the offset is
+// known not to change. Like other engines this assumes that the offset changes at
+// most once in any span of MaxDaylightSavingChange seconds: two queries that far apart
+// with the same offset cover the time in between.
+static QBasicAtomicInt timezoneGeneration = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+struct DaylightSavingCache
+{
+    enum { MaxDaylightSavingChange = 19 * 24 * 3600, IntervalCount = 8 };
+
+    struct Interval {
+        qint64 start;
+        qint64 end;
+        double offset;
+        uint lastUse;
+    };
+
+    DaylightSavingCache() : generation(-1), count(0), useCounter(0) {}
+
+    double offsetAt(double t);
+
+    int generation;
+    int count;
+    uint useCounter;
+    Interval intervals[IntervalCount];
+};
+
+double DaylightSavingCache::offsetAt(double t)
+{
+    int currentGeneration = timezoneGeneration.load();
+    if (generation != currentGeneration) {
+        generation = currentGeneration;
+        count = 0;
+    }
+
+    const qint64 seconds = qint64(::floor(t / msPerSecond));
+    for (int i = 0; i < count; ++i) {
+        Interval &interval = intervals[i];
+        if (interval.start <= seconds && seconds <= interval.end) {
+            interval.lastUse = ++useCounter;
+            return interval.offset;
+        }
+    }
+
+    const double offset = queryDaylightSavingTA(t);
+    for (int i = 0; i < count; ++i) {
+        Interval &interval = intervals[i];
+        if (interval.offset != offset)
+            continue;
+        if (seconds > interval.end && seconds - interval.end <= MaxDaylightSavingChange) {
+            interval.end = seconds;
+            interval.lastUse = ++useCounter;
+            return offset;
+        }
+        if (seconds < interval.start && interval.start - seconds <= MaxDaylightSavingChange) {
+            interval.start = seconds;
+            interval.lastUse = ++useCounter;
+            return offset;
+        }
+    }
+
+    int slot = count;
+    if (count < IntervalCount) {
+        ++count;
+    } else {
+        slot = 0;
+        for (int i = 1; i < count; ++i) {
+            if (intervals[i].lastUse < intervals[slot].lastUse)
+                slot = i;
+        }
+    }
+    Interval &interval = intervals[slot];
+    interval.start = seconds;
+    interval.end = seconds;
+    interval.offset = offset;
+    interval.lastUse = ++useCounter;
+    return offset;
+}
+
+static QThreadStorage<DaylightSavingCache> daylightSavingCache;
+
+static inline double DaylightSavingTA(double t)
+{
+    if (!qIsFinite(t))
+        return queryDaylightSavingTA(t);
+    return daylightSavingCache.localData().offsetAt(t);
+}
+
 static inline double LocalTime(double t)
 {
     return t + LocalTZA + DaylightSavingTA(t);
@@ -319,7 +409,7 @@ static inline double UTC(double t)
     return t - LocalTZA - DaylightSavingTA(t - LocalTZA);
 }
 
-static inline double currentTime()
+double DatePrototype::currentTime()
 {
 #ifndef Q_OS_WIN
     struct timeval tv;
@@ -668,7 +758,7 @@ ReturnedValue DateCtor::construct(Managed *m, CallData *callData)
     double t = 0;
 
     if (callData->argc == 0)
-        t = currentTime();
+        t = DatePrototype::currentTime();
 
     else if (callData->argc == 1) {
         Scope scope(m->engine());
@@ -703,7 +793,7 @@ ReturnedValue DateCtor::construct(Managed *m, CallData *callData)
 
 ReturnedValue DateCtor::call(Managed *m, CallData *)
 {
-    double t = currentTime();
+    double t = DatePrototype::currentTime();
     return m->engine()->newString(ToString(t))->asReturnedValue();
 }
 
@@ -1328,4 +1418,5 @@ ReturnedValue DatePrototype::method_toJSON(CallContext *ctx)
 void DatePrototype::timezoneUpdated()
 {
     LocalTZA = getLocalTZA();
+    timezoneGeneration.ref();
 }
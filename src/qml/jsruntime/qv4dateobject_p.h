@@ -84,6 +84,7 @@ struct DatePrototype: DateObject
     void init(ExecutionEngine *engine, ObjectRef ctor);
 
     static double getThisDate(ExecutionContext *ctx);
+    static double currentTime();
 
     static ReturnedValue method_parse(CallContext *ctx);
     static ReturnedValue method_UTC(CallContext *ctx);
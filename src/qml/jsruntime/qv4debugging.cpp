@@ -123,6 +123,7 @@ Debugger::Debugger(QV4::ExecutionEngine *engine)
     , m_returnedValue(Primitive::undefinedValue())
     , m_gatherSources(0)
     , m_runningJob(0)
+    , m_pauseAtNextOpportunity(0)
 {
     qMetaTypeId<Debugger*>();
     qMetaTypeId<PauseReason>();
@@ -161,6 +162,7 @@ void Debugger::gatherSources(int requestSequenceNr)
         delete m_gatherSources;
         m_gatherSources = 0;
     }
+    updatePauseAtNextOpportunity();
 }
 
 void Debugger::pause()
@@ -169,6 +171,7 @@ void Debugger::pause()
     if (m_state == Paused)
         return;
     m_pauseRequested = true;
+    updatePauseAtNextOpportunity();
 }
 
 void Debugger::resume(Speed speed)
@@ -182,6 +185,7 @@ void Debugger::resume(Speed speed)
 
     m_currentContext = m_engine->currentContext();
     m_stepping = speed;
+    updatePauseAtNextOpportunity();
     m_runningCondition.wakeAll();
 }
 
@@ -190,6 +194,7 @@ void Debugger::addBreakPoint(const QString &fileName, int lineNumber, const QStr
     QMutexLocker locker(&m_lock);
     m_breakPoints.insert(DebuggerBreakPoint(fileName.mid(fileName.lastIndexOf('/') + 1), lineNumber), condition);
     m_haveBreakPoints = true;
+    updatePauseAtNextOpportunity();
 }
 
 void Debugger::removeBreakPoint(const QString &fileName, int lineNumber)
@@ -197,6 +202,7 @@ void Debugger::removeBreakPoint(const QString &fileName, int lineNumber)
     QMutexLocker locker(&m_lock);
     m_breakPoints.remove(DebuggerBreakPoint(fileName.mid(fileName.lastIndexOf('/') + 1), lineNumber));
     m_haveBreakPoints = !m_breakPoints.isEmpty();
+    updatePauseAtNextOpportunity();
 }
 
 void Debugger::setBreakOnThrow(bool onoff)
@@ -456,6 +462,7 @@ void Debugger::maybeBreakAtInstruction()
         m_gatherSources->run();
         delete m_gatherSources;
         m_gatherSources = 0;
+        updatePauseAtNextOpportunity();
     }
 
     switch (m_stepping) {
@@ -473,6 +480,7 @@ void Debugger::maybeBreakAtInstruction()
 
     if (m_pauseRequested) { // Serve debugging requests from the agent
         m_pauseRequested = false;
+        updatePauseAtNextOpportunity();
         pauseAndWait(PauseRequest);
     } else if (m_haveBreakPoints && reallyHitTheBreakPoint(getFunction()->sourceFile(), lineNumber)) {
         pauseAndWait(BreakPoint);
@@ -498,6 +506,7 @@ void Debugger::leavingFunction(const ReturnedValue &retVal)
         m_currentContext = m_engine->currentContext()->parent;
         m_stepping = StepOver;
         m_returnedValue = retVal;
+        updatePauseAtNextOpportunity();
     }
 }
 
@@ -513,6 +522,11 @@ void Debugger::aboutToThrow()
     pauseAndWait(Throwing);
 }
 
+void Debugger::updatePauseAtNextOpportunity()
+{
+    m_pauseAtNextOpportunity = m_pauseRequested || m_haveBreakPoints || m_gatherSources || m_stepping >= StepOver;
+}
+
 Function *Debugger::getFunction() const
 {
     ExecutionContext *context = m_engine->currentContext();
@@ -170,9 +170,13 @@ public:
     ExecutionState currentExecutionState() const;
 
     bool pauseAtNextOpportunity() const {
-        return m_pauseRequested || m_haveBreakPoints || m_gatherSources || m_stepping >= StepOver;
+        return m_pauseAtNextOpportunity != 0;
     }
 
+    // JIT-generated code tests the flag behind pauseAtNextOpportunity() at every statement
+    // boundary and only calls out to maybeBreakAtInstruction() when it is set.
+    static size_t pauseAtNextOpportunityOffset() { return qOffsetOf(Debugger, m_pauseAtNextOpportunity); }
+
     QVector<StackFrame> stackTrace(int frameLimit = -1) const;
     void collectArgumentsInContext(Collector *collector, int frameNr = 0, int scopeNr = 0);
     void collectLocalsInContext(Collector *collector, int frameNr = 0, int scopeNr = 0);
@@ -197,6 +201,9 @@ private:
 
     bool reallyHitTheBreakPoint(const QString &filename, int linenr);
 
+    // requires lock to be held
+    void updatePauseAtNextOpportunity();
+
     void runInEngine(Job *job);
     void runInEngine_havingLock(Debugger::Job *job);
 
@@ -218,6 +225,8 @@ private:
     Job *m_gatherSources;
     Job *m_runningJob;
     QWaitCondition m_jobIsRunning;
+
+    quint32 m_pauseAtNextOpportunity;
 };
 
 class Q_QML_EXPORT DebuggerAgent : public QObject
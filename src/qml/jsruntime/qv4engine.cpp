@@ -69,8 +69,12 @@
 #include "qv4qobjectwrapper_p.h"
 #include "qv4qmlextensions_p.h"
 #include "qv4memberdata_p.h"
+#include "qv4lookup_p.h"
+#include "qv4arraybuffer_p.h"
+#include "qv4typedarray_p.h"
 
 #include <QtCore/QTextStream>
+#include <QtCore/QDebug>
 
 #ifdef V4_ENABLE_JIT
 #include "qv4isel_masm_p.h"
@@ -164,7 +168,9 @@ ExecutionEngine::ExecutionEngine(EvalISelFactory *factory)
     : current(0)
     , memoryManager(new QV4::MemoryManager)
     , executableAllocator(new QV4::ExecutableAllocator)
-    , regExpAllocator(new QV4::ExecutableAllocator)
+    , jitCallThreshold(0)
+    , jitBackEdgeThreshold(0)
+    , diskCacheEnabled(true)
     , bumperPointerAllocator(new WTF::BumpPointerAllocator)
     , jsStack(new WTF::PageAllocation)
     , debugger(0)
@@ -176,6 +182,7 @@ ExecutionEngine::ExecutionEngine(EvalISelFactory *factory)
     , nArgumentsAccessors(0)
     , m_engineId(engineSerial.fetchAndAddOrdered(1))
     , regExpCache(0)
+    , megamorphicLookupCache(0)
     , m_multiplyWrappedQObjects(0)
     , m_qmlExtensions(0)
 {
@@ -188,10 +195,22 @@ ExecutionEngine::ExecutionEngine(EvalISelFactory *factory)
 
 #ifdef V4_ENABLE_JIT
         static const bool forceMoth = !qgetenv("QV4_FORCE_INTERPRETER").isEmpty();
-        if (forceMoth)
+        if (forceMoth) {
             factory = new Moth::ISelFactory;
-        else
+        } else {
             factory = new JIT::ISelFactory;
+
+            static const bool forceDiskCache = !qgetenv("QML_FORCE_DISK_CACHE").isEmpty();
+            diskCacheEnabled = forceDiskCache;
+
+            static const int callThreshold = qgetenv("QV4_JIT_CALL_THRESHOLD").toInt();
+            if (callThreshold > 0) {
+                static const int backEdgeThreshold = qgetenv("QV4_JIT_BACKEDGE_THRESHOLD").toInt();
+                interpreterISelFactory.reset(new Moth::ISelFactory);
+                jitCallThreshold = callThreshold;
+                jitBackEdgeThreshold = backEdgeThreshold > 0 ? backEdgeThreshold : callThreshold * 100;
+            }
+        }
 #else // !V4_ENABLE_JIT
         factory = new Moth::ISelFactory;
 #endif // V4_ENABLE_JIT
@@ -331,6 +350,15 @@ ExecutionEngine::ExecutionEngine(EvalISelFactory *factory)
 
     sequencePrototype = new (memoryManager) SequencePrototype(arrayClass);
 
+    ArrayBufferPrototype *arrayBufferPrototype = new (memoryManager) ArrayBufferPrototype(objectClass);
+    arrayBufferClass = InternalClass::create(this, ArrayBuffer::staticVTable(), arrayBufferPrototype);
+
+    TypedArrayPrototype *typedArrayPrototypes[NTypedArrayTypes];
+    for (int i = 0; i < NTypedArrayTypes; ++i) {
+        typedArrayPrototypes[i] = new (memoryManager) TypedArrayPrototype(objectClass, (TypedArrayType)i);
+        typedArrayClasses[i] = InternalClass::create(this, TypedArray::staticVTable(), typedArrayPrototypes[i]);
+    }
+
     objectCtor = new (memoryManager) ObjectCtor(rootContext);
     stringCtor = new (memoryManager) StringCtor(rootContext);
     numberCtor = new (memoryManager) NumberCtor(rootContext);
@@ -346,6 +374,9 @@ ExecutionEngine::ExecutionEngine(EvalISelFactory *factory)
     syntaxErrorCtor = new (memoryManager) SyntaxErrorCtor(rootContext);
     typeErrorCtor = new (memoryManager) TypeErrorCtor(rootContext);
     uRIErrorCtor = new (memoryManager) URIErrorCtor(rootContext);
+    arrayBufferCtor = new (memoryManager) ArrayBufferCtor(rootContext);
+    for (int i = 0; i < NTypedArrayTypes; ++i)
+        typedArrayCtors[i] = new (memoryManager) TypedArrayCtor(rootContext, (TypedArrayType)i);
 
     objectPrototype->init(this, objectCtor);
     stringPrototype->init(this, stringCtor);
@@ -362,6 +393,9 @@ ExecutionEngine::ExecutionEngine(EvalISelFactory *factory)
     syntaxErrorPrototype->init(this, syntaxErrorCtor);
     typeErrorPrototype->init(this, typeErrorCtor);
     uRIErrorPrototype->init(this, uRIErrorCtor);
+    arrayBufferPrototype->init(this, arrayBufferCtor);
+    for (int i = 0; i < NTypedArrayTypes; ++i)
+        typedArrayPrototypes[i]->init(this, typedArrayCtors[i]);
 
     variantPrototype->init();
     static_cast<SequencePrototype *>(sequencePrototype.managed())->init();
@@ -389,6 +423,9 @@ ExecutionEngine::ExecutionEngine(EvalISelFactory *factory)
     globalObject->defineDefaultProperty(QStringLiteral("SyntaxError"), syntaxErrorCtor);
     globalObject->defineDefaultProperty(QStringLiteral("TypeError"), typeErrorCtor);
     globalObject->defineDefaultProperty(QStringLiteral("URIError"), uRIErrorCtor);
+    globalObject->defineDefaultProperty(QStringLiteral("ArrayBuffer"), arrayBufferCtor);
+    for (int i = 0; i < NTypedArrayTypes; ++i)
+        globalObject->defineDefaultProperty(QString::fromLatin1(TypedArray::operations[i].name), typedArrayCtors[i]);
     ScopedObject o(scope);
     globalObject->defineDefaultProperty(QStringLiteral("Math"), (o = new (memoryManager) MathObject(QV4::InternalClass::create(this, MathObject::staticVTable(), objectPrototype))));
     globalObject->defineDefaultProperty(QStringLiteral("JSON"), (o = new (memoryManager) JsonObject(QV4::InternalClass::create(this, JsonObject::staticVTable(), objectPrototype))));
@@ -424,6 +461,15 @@ ExecutionEngine::~ExecutionEngine()
     delete identifierTable;
     delete memoryManager;
 
+    static const bool dumpLookupStatistics = !qgetenv("QV4_LOOKUP_STATS").isEmpty();
+    if (dumpLookupStatistics) {
+        const LookupStatistics stats = lookupStatistics();
+        qDebug() << "Polymorphic lookups:" << stats.polymorphicSites << "sites," << stats.polymorphicHits << "hits,"
+                 << stats.polymorphicMisses << "misses";
+        qDebug() << "Megamorphic lookups:" << stats.megamorphicSites << "sites," << stats.megamorphicHits << "hits,"
+                 << stats.megamorphicMisses << "misses";
+    }
+
     QSet<QV4::CompiledData::CompilationUnit*> remainingUnits;
     qSwap(compilationUnits, remainingUnits);
     foreach (QV4::CompiledData::CompilationUnit *unit, remainingUnits)
@@ -434,24 +480,56 @@ ExecutionEngine::~ExecutionEngine()
     delete classPool;
     delete bumperPointerAllocator;
     delete regExpCache;
-    delete regExpAllocator;
+    delete megamorphicLookupCache;
     delete executableAllocator;
     jsStack->deallocate();
     delete jsStack;
     delete [] argumentsAccessors;
 }
 
+// Sums up the counters of the property lookups that went beyond two shapes.
+LookupStatistics ExecutionEngine::lookupStatistics() const
+{
+    LookupStatistics stats;
+    foreach (CompiledData::CompilationUnit *unit, compilationUnits) {
+        if (!unit->runtimeLookups)
+            continue;
+        for (uint i = 0; i < unit->data->lookupTableSize; ++i) {
+            const Lookup &l = unit->runtimeLookups[i];
+            if (unit->data->lookupTable()[i].type_and_flags != CompiledData::Lookup::Type_Getter)
+                continue;
+            if (l.getter == Lookup::getterPolymorphic) {
+                ++stats.polymorphicSites;
+                stats.polymorphicHits += l.polymorphicCache->hits;
+                stats.polymorphicMisses += l.polymorphicCache->misses;
+            } else if (l.getter == Lookup::getterMegamorphic) {
+                ++stats.megamorphicSites;
+            }
+        }
+    }
+    if (megamorphicLookupCache) {
+        stats.megamorphicHits = megamorphicLookupCache->hits;
+        stats.megamorphicMisses = megamorphicLookupCache->misses;
+    }
+    return stats;
+}
+
 void ExecutionEngine::enableDebugger()
 {
     Q_ASSERT(!debugger);
     debugger = new Debugging::Debugger(this);
-    iselFactory.reset(new Moth::ISelFactory);
+    // Code compiled from now on is generated in debug mode, which both backends support, so
+    // the JIT stays enabled. Tiering is switched off though, as it recompiles without debug
+    // mode.
+    interpreterISelFactory.reset();
+    jitCallThreshold = 0;
+    jitBackEdgeThreshold = 0;
 }
 
 void ExecutionEngine::enableProfiler()
 {
     Q_ASSERT(!profiler);
-    profiler = new QV4::Profiling::Profiler();
+    profiler = new QV4::Profiling::Profiler(this);
 }
 
 void ExecutionEngine::initRootContext()
@@ -511,6 +589,24 @@ Returned<String> *ExecutionEngine::newString(const QString &s)
     return (new (memoryManager) String(this, s))->asReturned<String>();
 }
 
+// Stores the characters with one byte each if they are all Latin-1. Meant for strings owned by
+// the engine alone; strings handed in from C++ are better off sharing the QString's data.
+Returned<String> *ExecutionEngine::newCompactString(const QString &s)
+{
+    const ushort *ch = s.utf16();
+    const ushort *end = ch + s.length();
+    for (; ch < end; ++ch) {
+        if (*ch > 0xff)
+            return newString(s);
+    }
+    return (new (memoryManager) String(this, s.toLatin1()))->asReturned<String>();
+}
+
+Returned<String> *ExecutionEngine::newCompactString(const QLatin1String &s)
+{
+    return (new (memoryManager) String(this, QByteArray(s.data(), s.size())))->asReturned<String>();
+}
+
 String *ExecutionEngine::newIdentifier(const QString &text)
 {
     return identifierTable->insertString(text);
@@ -658,6 +754,29 @@ Returned<Object> *ExecutionEngine::newVariantObject(const QVariant &v)
     return o->asReturned<Object>();
 }
 
+Returned<ArrayBuffer> *ExecutionEngine::newArrayBuffer(int length)
+{
+    ArrayBuffer *object = new (memoryManager) ArrayBuffer(this, length);
+    return object->asReturned<ArrayBuffer>();
+}
+
+Returned<ArrayBuffer> *ExecutionEngine::newArrayBuffer(const QByteArray &array)
+{
+    ArrayBuffer *object = new (memoryManager) ArrayBuffer(this, array);
+    return object->asReturned<ArrayBuffer>();
+}
+
+Returned<TypedArray> *ExecutionEngine::newTypedArray(TypedArrayType type, uint length)
+{
+    Scope scope(this);
+    Scoped<ArrayBuffer> buffer(scope, newArrayBuffer(int(length * TypedArray::operations[type].bytesPerElement)));
+    TypedArray *object = new (memoryManager) TypedArray(this, type);
+    object->buffer = buffer.getPointer();
+    object->byteLength = buffer->byteLength();
+    object->byteOffset = 0;
+    return object->asReturned<TypedArray>();
+}
+
 Returned<Object> *ExecutionEngine::newForEachIteratorObject(ExecutionContext *ctx, const ObjectRef o)
 {
     Object *obj = new (memoryManager) ForEachIteratorObject(ctx, o);
@@ -895,6 +1014,9 @@ void ExecutionEngine::markObjects()
     syntaxErrorCtor.mark(this);
     typeErrorCtor.mark(this);
     uRIErrorCtor.mark(this);
+    arrayBufferCtor.mark(this);
+    for (int i = 0; i < NTypedArrayTypes; ++i)
+        typedArrayCtors[i].mark(this);
     sequencePrototype.mark(this);
 
     exceptionValue.mark(this);
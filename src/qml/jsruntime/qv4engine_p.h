@@ -84,6 +84,8 @@ struct RegExpObject;
 struct ErrorObject;
 struct SyntaxErrorObject;
 struct ArgumentsObject;
+struct ArrayBuffer;
+struct TypedArray;
 struct ExecutionContext;
 struct ExecutionEngine;
 class MemoryManager;
@@ -113,6 +115,8 @@ struct InternalClassPool;
 class MultiplyWrappedQObjectMap;
 class RegExp;
 class RegExpCache;
+struct MegamorphicLookupCache;
+struct LookupStatistics;
 struct QmlExtensions;
 struct Exception;
 struct ExecutionContextSaver;
@@ -138,9 +142,17 @@ public:
 
     MemoryManager *memoryManager;
     ExecutableAllocator *executableAllocator;
-    ExecutableAllocator *regExpAllocator;
     QScopedPointer<EvalISelFactory> iselFactory;
 
+    // Tiered execution: when set, scripts are first compiled for the interpreter and promoted
+    // to iselFactory once a function was called or looped often enough.
+    QScopedPointer<EvalISelFactory> interpreterISelFactory;
+    quint32 jitCallThreshold;
+    quint32 jitBackEdgeThreshold;
+
+    // Only interpreter bytecode can be stored in the disk cache, so engines that use the JIT
+    // only cache scripts when QML_FORCE_DISK_CACHE is set.
+    bool diskCacheEnabled;
 
     Value *jsStackLimit;
     quintptr cStackLimit;
@@ -196,6 +208,8 @@ public:
     Value syntaxErrorCtor;
     Value typeErrorCtor;
     Value uRIErrorCtor;
+    Value arrayBufferCtor;
+    Value typedArrayCtors[NTypedArrayTypes];
     Value sequencePrototype;
 
     InternalClassPool *classPool;
@@ -232,6 +246,9 @@ public:
     InternalClass *variantClass;
     InternalClass *memberDataClass;
 
+    InternalClass *arrayBufferClass;
+    InternalClass *typedArrayClasses[NTypedArrayTypes];
+
     EvalFunction *evalFunction;
     FunctionObject *thrower;
 
@@ -276,6 +293,7 @@ public:
     quint32 m_engineId;
 
     RegExpCache *regExpCache;
+    MegamorphicLookupCache *megamorphicLookupCache;
 
     // Scarce resources are "exceptionally high cost" QVariant types where allowing the
     // normal JavaScript GC to clean them up is likely to lead to out-of-memory or other
@@ -299,6 +317,8 @@ public:
     ExecutionEngine(EvalISelFactory *iselFactory = 0);
     ~ExecutionEngine();
 
+    LookupStatistics lookupStatistics() const;
+
     void enableDebugger();
     void enableProfiler();
 
@@ -313,6 +333,8 @@ public:
     Returned<Object> *newObject(InternalClass *internalClass);
 
     Returned<String> *newString(const QString &s);
+    Returned<String> *newCompactString(const QString &s);
+    Returned<String> *newCompactString(const QLatin1String &s);
     String *newIdentifier(const QString &text);
 
     Returned<Object> *newStringObject(const ValueRef value);
@@ -341,6 +363,10 @@ public:
 
     Returned<Object> *newVariantObject(const QVariant &v);
 
+    Returned<ArrayBuffer> *newArrayBuffer(int length);
+    Returned<ArrayBuffer> *newArrayBuffer(const QByteArray &array);
+    Returned<TypedArray> *newTypedArray(TypedArrayType type, uint length);
+
     Returned<Object> *newForEachIteratorObject(ExecutionContext *ctx, const ObjectRef o);
 
     Returned<Object> *qmlContextObject() const;
@@ -46,6 +46,20 @@
 
 using namespace QV4;
 
+// Small functions are pooled into chunks of at least this many pages
+// instead of each mapping pages of its own.
+static const size_t MinimumChunkPages = 16;
+
+bool ExecutableAllocator::isWXExclusive()
+{
+#if ENABLE(ASSEMBLER_WX_EXCLUSIVE)
+    return true;
+#else
+    static const bool wxExclusive = !qgetenv("QV4_WX_EXCLUSIVE").isEmpty();
+    return wxExclusive;
+#endif
+}
+
 void *ExecutableAllocator::Allocation::start() const
 {
     return reinterpret_cast<void*>(addr);
@@ -165,17 +179,22 @@ ExecutableAllocator::Allocation *ExecutableAllocator::allocate(size_t size)
 
     // Code is best aligned to 16-byte boundaries.
     size = WTF::roundUpToMultipleOf(16, size);
+    if (isWXExclusive())
+        size = WTF::roundUpToMultipleOf(WTF::pageSize(), size);
 
+    ChunkOfPages *chunk = 0;
     QMultiMap<size_t, Allocation*>::Iterator it = freeAllocations.lowerBound(size);
     if (it != freeAllocations.end()) {
         allocation = *it;
         freeAllocations.erase(it);
+        chunk = findChunk(allocation->addr);
     }
 
     if (!allocation) {
-        ChunkOfPages *chunk = new ChunkOfPages;
-        size_t allocSize = WTF::roundUpToMultipleOf(WTF::pageSize(), size);
+        chunk = new ChunkOfPages;
+        size_t allocSize = WTF::roundUpToMultipleOf(WTF::pageSize(), qMax(size, MinimumChunkPages * WTF::pageSize()));
         chunk->pages = new WTF::PageAllocation(WTF::PageAllocation::allocate(allocSize, OSAllocator::JSJITCodePages));
+        chunk->decommittedPages.resize(allocSize / WTF::pageSize());
         chunks.insert(reinterpret_cast<quintptr>(chunk->pages->base()) - 1, chunk);
         allocation = new Allocation;
         allocation->addr = reinterpret_cast<quintptr>(chunk->pages->base());
@@ -196,6 +215,9 @@ ExecutableAllocator::Allocation *ExecutableAllocator::allocate(size_t size)
             freeAllocations.insert(remainder->size, remainder);
     }
 
+    Q_ASSERT(chunk);
+    commitPages(chunk, allocation);
+
     return allocation;
 }
 
@@ -215,25 +237,28 @@ void ExecutableAllocator::free(Allocation *allocation)
     Q_ASSERT(chunk->contains(allocation));
 
     bool merged = allocation->mergeNext(this);
-    merged |= allocation->mergePrevious(this);
+    Allocation *previous = allocation->prev;
+    if (allocation->mergePrevious(this)) {
+        // allocation was merged into the previous one and deleted
+        allocation = previous;
+        merged = true;
+    }
     if (!merged)
         freeAllocations.insert(allocation->size, allocation);
 
-    allocation = 0;
-
     if (!chunk->firstAllocation->next) {
         freeAllocations.remove(chunk->firstAllocation->size, chunk->firstAllocation);
         chunks.erase(it);
         delete chunk;
         return;
     }
+
+    decommitFreePages(chunk, allocation);
 }
 
-ExecutableAllocator::ChunkOfPages *ExecutableAllocator::chunkForAllocation(Allocation *allocation) const
+ExecutableAllocator::ChunkOfPages *ExecutableAllocator::findChunk(quintptr addr) const
 {
-    QMutexLocker locker(&mutex);
-
-    QMap<quintptr, ChunkOfPages*>::ConstIterator it = chunks.lowerBound(allocation->addr);
+    QMap<quintptr, ChunkOfPages*>::ConstIterator it = chunks.lowerBound(addr);
     if (it != chunks.begin())
         --it;
     if (it == chunks.end())
@@ -241,3 +266,79 @@ ExecutableAllocator::ChunkOfPages *ExecutableAllocator::chunkForAllocation(Alloc
     return *it;
 }
 
+// Recommits the pages of a new allocation that were handed back to the OS
+// while they were free. They come back writable; the JIT makes them
+// executable once the code is in place.
+void ExecutableAllocator::commitPages(ChunkOfPages *chunk, Allocation *allocation)
+{
+    const size_t pageSize = WTF::pageSize();
+    const quintptr base = reinterpret_cast<quintptr>(chunk->pages->base());
+    int page = (allocation->addr - base) / pageSize;
+    const int end = (allocation->addr + allocation->size - 1 - base) / pageSize + 1;
+    while (page < end) {
+        if (!chunk->decommittedPages.testBit(page)) {
+            ++page;
+            continue;
+        }
+        const int first = page;
+        while (page < end && chunk->decommittedPages.testBit(page))
+            chunk->decommittedPages.clearBit(page++);
+        OSAllocator::commit(reinterpret_cast<void *>(base + first * pageSize), (page - first) * pageSize, true, false);
+    }
+}
+
+// Hands the pages that lie completely inside a free allocation back to the
+// OS, so that a partially used chunk doesn't keep them resident.
+void ExecutableAllocator::decommitFreePages(ChunkOfPages *chunk, Allocation *allocation)
+{
+    Q_ASSERT(allocation->free);
+    const size_t pageSize = WTF::pageSize();
+    const quintptr base = reinterpret_cast<quintptr>(chunk->pages->base());
+    const quintptr start = WTF::roundUpToMultipleOf(pageSize, allocation->addr);
+    const quintptr stop = (allocation->addr + allocation->size) & ~(quintptr(pageSize) - 1);
+    if (start >= stop)
+        return;
+
+    int page = (start - base) / pageSize;
+    const int end = (stop - base) / pageSize;
+    while (page < end) {
+        if (chunk->decommittedPages.testBit(page)) {
+            ++page;
+            continue;
+        }
+        const int first = page;
+        while (page < end && !chunk->decommittedPages.testBit(page))
+            chunk->decommittedPages.setBit(page++);
+        OSAllocator::decommit(reinterpret_cast<void *>(base + first * pageSize), (page - first) * pageSize);
+    }
+}
+
+ExecutableAllocator::Statistics ExecutableAllocator::statistics() const
+{
+    QMutexLocker locker(&mutex);
+
+    Statistics stats;
+    const size_t pageSize = WTF::pageSize();
+    foreach (ChunkOfPages *chunk, chunks) {
+        ++stats.chunkCount;
+        stats.chunkBytes += chunk->pages->size();
+        stats.decommittedBytes += quint64(chunk->decommittedPages.count(true)) * pageSize;
+        for (Allocation *allocation = chunk->firstAllocation; allocation; allocation = allocation->next) {
+            if (!allocation->free) {
+                stats.usedBytes += allocation->size;
+                continue;
+            }
+            ++stats.freeAllocationCount;
+            stats.freeBytes += allocation->size;
+            stats.largestFreeAllocation = qMax(stats.largestFreeAllocation, quint64(allocation->size));
+        }
+    }
+    return stats;
+}
+
+ExecutableAllocator::ChunkOfPages *ExecutableAllocator::chunkForAllocation(Allocation *allocation) const
+{
+    QMutexLocker locker(&mutex);
+    return findChunk(allocation->addr);
+}
+
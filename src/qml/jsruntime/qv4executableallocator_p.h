@@ -48,6 +48,7 @@
 #include <QHash>
 #include <QVector>
 #include <QByteArray>
+#include <QBitArray>
 #include <QMutex>
 
 namespace WTF {
@@ -105,6 +106,27 @@ public:
     int freeAllocationCount() const { return freeAllocations.count(); }
     int chunkCount() const { return chunks.count(); }
 
+    struct Statistics
+    {
+        Statistics() : chunkCount(0), chunkBytes(0), usedBytes(0), freeBytes(0), decommittedBytes(0)
+          , freeAllocationCount(0), largestFreeAllocation(0) {}
+        uint chunkCount;
+        quint64 chunkBytes;
+        quint64 usedBytes;
+        quint64 freeBytes; // includes the decommitted bytes
+        quint64 decommittedBytes; // free pages handed back to the OS
+        uint freeAllocationCount;
+        quint64 largestFreeAllocation;
+    };
+
+    Statistics statistics() const;
+
+    // True if code pages are never writable and executable at the same time,
+    // either at build time (ASSEMBLER_WX_EXCLUSIVE) or with QV4_WX_EXCLUSIVE set.
+    // Allocations then get whole pages, so that making one writable while it is
+    // assembled never takes away the execute permission of code in use.
+    static bool isWXExclusive();
+
     struct ChunkOfPages
     {
         ChunkOfPages()
@@ -115,6 +137,7 @@ public:
 
         WTF::PageAllocation *pages;
         Allocation *firstAllocation;
+        QBitArray decommittedPages;
 
         bool contains(Allocation *alloc) const;
     };
@@ -122,6 +145,10 @@ public:
     ChunkOfPages *chunkForAllocation(Allocation *allocation) const;
 
 private:
+    ChunkOfPages *findChunk(quintptr addr) const;
+    void commitPages(ChunkOfPages *chunk, Allocation *allocation);
+    void decommitFreePages(ChunkOfPages *chunk, Allocation *allocation);
+
     QMultiMap<size_t, Allocation*> freeAllocations;
     QMap<quintptr, ChunkOfPages*> chunks;
     mutable QMutex mutex;
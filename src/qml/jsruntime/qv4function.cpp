@@ -56,6 +56,8 @@ Function::Function(ExecutionEngine *engine, CompiledData::CompilationUnit *unit,
         , compilationUnit(unit)
         , code(codePtr)
         , codeData(0)
+        , callCount(0)
+        , backEdgeCount(0)
 {
     Q_UNUSED(engine);
 
@@ -90,6 +90,10 @@ struct Q_QML_EXPORT Function {
     // first nArguments names in internalClass are the actual arguments
     InternalClass *internalClass;
 
+    // Execution counters of interpreted functions, used to decide when to tier up to the JIT
+    quint32 callCount;
+    quint32 backEdgeCount;
+
     Function(ExecutionEngine *engine, CompiledData::CompilationUnit *unit, const CompiledData::Function *function,
              ReturnedValue (*codePtr)(ExecutionContext *, const uchar *));
     ~Function();
@@ -483,6 +483,7 @@ ReturnedValue SimpleScriptFunction::construct(Managed *that, CallData *callData)
     ctx.lookups = ctx.compilationUnit->runtimeLookups;
     ctx.outer = f->scope;
     ctx.locals = v4->stackPush(f->varCount());
+    ctx.realArgumentCount = callData->argc;
     while (callData->argc < (int)f->formalParameterCount()) {
         callData->args[callData->argc] = Encode::undefined();
         ++callData->argc;
@@ -520,6 +521,7 @@ ReturnedValue SimpleScriptFunction::call(Managed *that, CallData *callData)
     ctx.lookups = ctx.compilationUnit->runtimeLookups;
     ctx.outer = f->scope;
     ctx.locals = v4->stackPush(f->varCount());
+    ctx.realArgumentCount = callData->argc;
     while (callData->argc < (int)f->formalParameterCount()) {
         callData->args[callData->argc] = Encode::undefined();
         ++callData->argc;
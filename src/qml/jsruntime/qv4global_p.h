@@ -179,6 +179,19 @@ namespace Global {
     };
 }
 
+enum TypedArrayType {
+    TypedArrayType_Int8,
+    TypedArrayType_UInt8,
+    TypedArrayType_UInt8Clamped,
+    TypedArrayType_Int16,
+    TypedArrayType_UInt16,
+    TypedArrayType_Int32,
+    TypedArrayType_UInt32,
+    TypedArrayType_Float32,
+    TypedArrayType_Float64,
+    NTypedArrayTypes
+};
+
 enum PropertyFlag {
     Attr_Data = 0,
     Attr_Accessor = 0x1,
@@ -55,6 +55,7 @@ struct Identifier
 {
     QString string;
     uint hashValue;
+    bool isShared; // owned by the process-wide table of compile-time identifiers
 };
 
 
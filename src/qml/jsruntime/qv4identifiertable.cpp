@@ -39,6 +39,7 @@
 **
 ****************************************************************************/
 #include "qv4identifiertable_p.h"
+#include <QtCore/qreadwritelock.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -55,6 +56,105 @@ static inline int primeForNumBits(int numBits)
 }
 
 
+namespace {
+
+// The identifiers of strings that come from compilation units are the same in every engine, so
+// they are kept in a single table for the whole process rather than recreated per engine.
+// Entries are never removed, lookups only take the read lock.
+struct SharedIdentifierTable
+{
+    SharedIdentifierTable()
+        : size(0)
+        , numBits(8)
+    {
+        alloc = primeForNumBits(numBits);
+        entries = (Identifier **)malloc(alloc*sizeof(Identifier *));
+        memset(entries, 0, alloc*sizeof(Identifier *));
+    }
+
+    ~SharedIdentifierTable()
+    {
+        for (int i = 0; i < alloc; ++i)
+            delete entries[i];
+        free(entries);
+    }
+
+    Identifier *find(const QString &s, uint hash) const
+    {
+        uint idx = hash % alloc;
+        while (Identifier *e = entries[idx]) {
+            if (e->hashValue == hash && e->string == s)
+                return e;
+            ++idx;
+            idx %= alloc;
+        }
+        return 0;
+    }
+
+    Identifier *insert(const QString &s, uint hash)
+    {
+        if (alloc <= size*2) {
+            ++numBits;
+            int newAlloc = primeForNumBits(numBits);
+            Identifier **newEntries = (Identifier **)malloc(newAlloc*sizeof(Identifier *));
+            memset(newEntries, 0, newAlloc*sizeof(Identifier *));
+            for (int i = 0; i < alloc; ++i) {
+                Identifier *e = entries[i];
+                if (!e)
+                    continue;
+                uint idx = e->hashValue % newAlloc;
+                while (newEntries[idx]) {
+                    ++idx;
+                    idx %= newAlloc;
+                }
+                newEntries[idx] = e;
+            }
+            free(entries);
+            entries = newEntries;
+            alloc = newAlloc;
+        }
+
+        Identifier *identifier = new Identifier;
+        // Always copy, the string may be raw data of a unit that goes away with its engine.
+        identifier->string = QString(s.constData(), s.length());
+        identifier->hashValue = hash;
+        identifier->isShared = true;
+
+        uint idx = hash % alloc;
+        while (entries[idx]) {
+            ++idx;
+            idx %= alloc;
+        }
+        entries[idx] = identifier;
+        ++size;
+        return identifier;
+    }
+
+    QReadWriteLock lock;
+    int alloc;
+    int size;
+    int numBits;
+    Identifier **entries;
+};
+
+}
+
+Q_GLOBAL_STATIC(SharedIdentifierTable, sharedIdentifierTable)
+
+static Identifier *sharedIdentifier(const QString &s, uint hash)
+{
+    SharedIdentifierTable *table = sharedIdentifierTable();
+    {
+        QReadLocker locker(&table->lock);
+        if (Identifier *identifier = table->find(s, hash))
+            return identifier;
+    }
+    QWriteLocker locker(&table->lock);
+    if (Identifier *identifier = table->find(s, hash))
+        return identifier;
+    return table->insert(s, hash);
+}
+
 IdentifierTable::IdentifierTable(ExecutionEngine *engine)
     : engine(engine)
     , size(0)
@@ -68,7 +168,7 @@ IdentifierTable::IdentifierTable(ExecutionEngine *engine)
 IdentifierTable::~IdentifierTable()
 {
     for (int i = 0; i < alloc; ++i)
-        if (entries[i])
+        if (entries[i] && !entries[i]->identifier->isShared)
             delete entries[i]->identifier;
     free(entries);
 }
@@ -83,7 +183,13 @@ void IdentifierTable::addEntry(String *str)
     str->identifier = new Identifier;
     str->identifier->string = str->toQString();
     str->identifier->hashValue = hash;
+    str->identifier->isShared = false;
 
+    insertEntry(str);
+}
+
+void IdentifierTable::insertEntry(String *str)
+{
     bool grow = (alloc <= size*2);
 
     if (grow) {
@@ -107,7 +213,7 @@ void IdentifierTable::addEntry(String *str)
         alloc = newAlloc;
     }
 
-    uint idx = hash % alloc;
+    uint idx = str->stringHash % alloc;
     while (entries[idx]) {
         ++idx;
         idx %= alloc;
@@ -134,6 +240,30 @@ String *IdentifierTable::insertString(const QString &s)
     return str;
 }
 
+// Like insertString(), but for strings of compilation units, whose hash is computed at compile
+// time. The identifier of the returned string is shared with all other engines in the process.
+String *IdentifierTable::insertSharedString(const QString &s, uint hash)
+{
+    // UINT_MAX is the hash of the one number that isn't an array index, see String::createHashValue()
+    if (hash == UINT_MAX)
+        return insertString(s);
+
+    uint idx = hash % alloc;
+    while (String *e = entries[idx]) {
+        if (e->stringHash == hash && e->toQString() == s)
+            return e;
+        ++idx;
+        idx %= alloc;
+    }
+
+    Identifier *identifier = sharedIdentifier(s, hash);
+    String *str = engine->newString(identifier->string)->getPointer();
+    str->stringHash = hash;
+    str->subtype = String::StringType_Regular;
+    str->identifier = identifier;
+    insertEntry(str);
+    return str;
+}
 
 Identifier *IdentifierTable::identifierImpl(const String *str)
 {
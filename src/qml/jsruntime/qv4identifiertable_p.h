@@ -60,6 +60,7 @@ struct IdentifierTable
     String **entries;
 
     void addEntry(String *str);
+    void insertEntry(String *str);
 
 public:
 
@@ -67,6 +68,7 @@ public:
     ~IdentifierTable();
 
     String *insertString(const QString &s);
+    String *insertSharedString(const QString &s, uint hash);
 
     Identifier *identifier(const String *str) {
         if (str->identifier)
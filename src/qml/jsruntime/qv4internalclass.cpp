@@ -125,6 +125,8 @@ InternalClass::InternalClass(ExecutionEngine *engine)
     , m_sealed(0)
     , m_frozen(0)
     , size(0)
+    , m_enumerableKeysValid(false)
+    , m_forInKeysValid(false)
 {
 }
 
@@ -140,6 +142,8 @@ InternalClass::InternalClass(const QV4::InternalClass &other)
     , m_sealed(0)
     , m_frozen(0)
     , size(other.size)
+    , m_enumerableKeysValid(false)
+    , m_forInKeysValid(false)
 {
 }
 
@@ -443,6 +447,86 @@ InternalClass *InternalClass::frozen()
     return m_frozen;
 }
 
+/*
+    Returns the names of the enumerable members of this class, in the order
+    Object::advanceIterator() visits them.
+ */
+QVector<String *> InternalClass::enumerableKeys()
+{
+    if (!m_enumerableKeysValid) {
+        m_enumerableKeys.reserve(size);
+        for (uint i = 0; i < size; ++i) {
+            // accessor properties have a dummy entry with no name
+            String *n = nameMap.at(i);
+            if (n && propertyData.at(i).isEnumerable())
+                m_enumerableKeys.append(n);
+        }
+        m_enumerableKeys.squeeze();
+        m_enumerableKeysValid = true;
+    }
+    return m_enumerableKeys;
+}
+
+/*
+    Returns the keys a for-in loop visits on \a object, which must have this
+    class. This is only possible if the object and all its prototypes are
+    plain objects without indexed properties, otherwise \a ok is set to false.
+    The keys are cached until one of the prototypes changes its class.
+ */
+QVector<String *> InternalClass::forInKeys(Object *object, bool *ok)
+{
+    Q_ASSERT(object->internalClass == this);
+
+    if (m_forInKeysValid) {
+        // The class of each level determines the next prototype, so the
+        // chain matches if the classes of all levels do.
+        int level = 0;
+        Object *o = object;
+        while (o && level < m_forInChain.size() && o->internalClass == m_forInChain.at(level) && !o->arrayData) {
+            o = o->prototype();
+            ++level;
+        }
+        if (!o && level == m_forInChain.size()) {
+            *ok = true;
+            return m_forInKeys;
+        }
+    }
+
+    m_forInKeysValid = false;
+    QVector<InternalClass *> chain;
+    for (Object *o = object; o; o = o->prototype()) {
+        if (!o->hasCacheableKeys()) {
+            *ok = false;
+            return QVector<String *>();
+        }
+        chain.append(o->internalClass);
+    }
+
+    // Assign rather than clear, iterators may still share the previous keys.
+    QVector<String *> keys;
+    for (int level = 0; level < chain.size(); ++level) {
+        const QVector<String *> own = chain.at(level)->enumerableKeys();
+        for (int i = 0; i < own.size(); ++i) {
+            String *key = own.at(i);
+            bool shadowed = false;
+            for (int j = 0; j < level; ++j) {
+                if (chain.at(j)->find(key) != UINT_MAX) {
+                    shadowed = true;
+                    break;
+                }
+            }
+            if (!shadowed)
+                keys.append(key);
+        }
+    }
+
+    m_forInChain = chain;
+    m_forInKeys = keys;
+    m_forInKeysValid = true;
+    *ok = true;
+    return m_forInKeys;
+}
+
 void InternalClass::destroy()
 {
     QList<InternalClass *> destroyStack;
@@ -467,6 +551,9 @@ void InternalClass::destroy()
         }
 
         next->transitions.~vector<Transition>();
+        next->m_enumerableKeys.~QVector<String *>();
+        next->m_forInKeys.~QVector<String *>();
+        next->m_forInChain.~QVector<InternalClass *>();
     }
 }
 
@@ -251,9 +251,21 @@ struct InternalClass : public QQmlJS::Managed {
     InternalClass *sealed();
     InternalClass *frozen();
 
+    QVector<String *> enumerableKeys();
+    QVector<String *> forInKeys(Object *object, bool *ok);
+
     void destroy();
 
 private:
+    // Enumeration cache. A class never changes its members, so the own keys
+    // stay valid for its lifetime. The for-in keys also depend on the classes
+    // of the prototype chain, which are recorded in m_forInChain.
+    QVector<String *> m_enumerableKeys;
+    QVector<String *> m_forInKeys;
+    QVector<InternalClass *> m_forInChain;
+    bool m_enumerableKeysValid;
+    bool m_forInKeysValid;
+
     InternalClass *addMemberImpl(String *string, PropertyAttributes data, uint *index);
     friend struct ExecutionEngine;
     InternalClass(ExecutionEngine *engine);
@@ -83,6 +83,7 @@ private:
     ReturnedValue parseArray();
     bool parseMember(ObjectRef o);
     bool parseString(QString *string);
+    String *parseKey();
     bool parseValue(ValueRef val);
     bool parseNumber(ValueRef val);
 
@@ -93,6 +94,12 @@ private:
 
     int nestingLevel;
     QJsonParseError::ParseError lastError;
+
+    // Member names repeat a lot in typical documents (arrays of records
+    // with the same keys), so identifiers are cached by the raw key text.
+    // Identifiers are kept alive by the identifier table.
+    enum { KeyCacheSize = 64 };
+    String *keyCache[KeyCacheSize];
 };
 
 static const int nestingLimit = 1024;
@@ -102,6 +109,7 @@ JsonParser::JsonParser(ExecutionContext *context, const QChar *json, int length)
     : context(context), head(json), json(json), nestingLevel(0), lastError(QJsonParseError::NoError)
 {
     end = json + length;
+    memset(keyCache, 0, sizeof(keyCache));
 }
 
 
@@ -273,8 +281,8 @@ bool JsonParser::parseMember(ObjectRef o)
     BEGIN << "parseMember";
     Scope scope(context);
 
-    QString key;
-    if (!parseString(&key))
+    ScopedString s(scope, parseKey());
+    if (!s)
         return false;
     QChar token = nextToken();
     if (token != NameSeparator) {
@@ -285,7 +293,6 @@ bool JsonParser::parseMember(ObjectRef o)
     if (!parseValue(val))
         return false;
 
-    ScopedString s(scope, context->engine->newIdentifier(key));
     uint idx = s->asArrayIndex();
     if (idx < UINT_MAX) {
         o->putIndexed(idx, val);
@@ -407,7 +414,7 @@ bool JsonParser::parseValue(ValueRef val)
             return false;
         DEBUG << "value: string";
         END;
-        val = context->engine->newString(value);
+        val = context->engine->newCompactString(value);
         return true;
     }
     case BeginArray: {
@@ -608,6 +615,15 @@ bool JsonParser::parseString(QString *string)
     BEGIN << "parse string stringPos=" << json;
 
     while (json < end) {
+        // copy runs of unescaped characters in one go
+        const QChar *run = json;
+        while (json < end && *json != '"' && *json != '\\' && json->unicode() > 0x1f)
+            ++json;
+        if (json != run)
+            string->append(run, json - run);
+        if (json >= end)
+            break;
+
         if (*json == '"')
             break;
         else if (*json == '\\') {
@@ -623,12 +639,8 @@ bool JsonParser::parseString(QString *string)
                 *string += QChar(ch);
             }
         } else {
-            if (json->unicode() <= 0x1f) {
-                lastError = QJsonParseError::IllegalEscapeSequence;
-                return false;
-            }
-            *string += *json;
-            ++json;
+            lastError = QJsonParseError::IllegalEscapeSequence;
+            return false;
         }
     }
     ++json;
@@ -642,6 +654,38 @@ bool JsonParser::parseString(QString *string)
     return true;
 }
 
+String *JsonParser::parseKey()
+{
+    // Keys without escape sequences are looked up in the cache via their raw text
+    const QChar *start = json;
+    uint h = 0;
+    while (json < end && *json != '"' && *json != '\\' && json->unicode() > 0x1f) {
+        h = 31 * h + json->unicode();
+        ++json;
+    }
+
+    if (json < end && *json == '"') {
+        const int length = json - start;
+        String *&cached = keyCache[(h ^ (h >> 16)) % KeyCacheSize];
+        if (cached) {
+            const QString &key = cached->toQString();
+            if (key.length() == length && !memcmp(key.constData(), start, length * sizeof(QChar))) {
+                ++json;
+                return cached;
+            }
+        }
+        ++json;
+        cached = context->engine->newIdentifier(QString(start, length));
+        return cached;
+    }
+
+    json = start;
+    QString key;
+    if (!parseString(&key))
+        return 0;
+    return context->engine->newIdentifier(key);
+}
+
 
 struct Stringify
 {
@@ -651,59 +695,119 @@ struct Stringify
     QString gap;
     QString indent;
 
+    // All output is appended to this buffer
+    QString result;
+
     QStack<Object *> stack;
 
     Stringify(ExecutionContext *ctx) : ctx(ctx), replacerFunction(0) {}
 
-    QString Str(const QString &key, ValueRef v);
-    QString JA(ArrayObjectRef a);
-    QString JO(ObjectRef o);
+    bool Str(const QString &key, ValueRef v);
+    void JA(ArrayObjectRef a);
+    void JO(ObjectRef o);
 
-    QString makeMember(const QString &key, ValueRef v);
+    bool makeMember(const QString &key, ValueRef v, bool first);
 };
 
-static QString quote(const QString &str)
+static void quote(QString *product, const QString &str)
 {
-    QString product = QStringLiteral("\"");
-    for (int i = 0; i < str.length(); ++i) {
-        QChar c = str.at(i);
-        switch (c.unicode()) {
+    product->reserve(product->size() + str.length() + 2);
+    *product += QLatin1Char('"');
+    const QChar *run = str.constData();
+    const QChar *end = run + str.length();
+    for (const QChar *c = run; c != end; ++c) {
+        ushort u = c->unicode();
+        if (u > 0x1f && u != '"' && u != '\\')
+            continue;
+
+        product->append(run, c - run);
+        run = c + 1;
+        switch (u) {
         case '"':
-            product += QStringLiteral("\\\"");
+            *product += QLatin1String("\\\"");
             break;
         case '\\':
-            product += QStringLiteral("\\\\");
+            *product += QLatin1String("\\\\");
             break;
         case '\b':
-            product += QStringLiteral("\\b");
+            *product += QLatin1String("\\b");
             break;
         case '\f':
-            product += QStringLiteral("\\f");
+            *product += QLatin1String("\\f");
             break;
         case '\n':
-            product += QStringLiteral("\\n");
+            *product += QLatin1String("\\n");
             break;
         case '\r':
-            product += QStringLiteral("\\r");
+            *product += QLatin1String("\\r");
             break;
         case '\t':
-            product += QStringLiteral("\\t");
+            *product += QLatin1String("\\t");
             break;
         default:
-            if (c.unicode() <= 0x1f) {
-                product += QStringLiteral("\\u00");
-                product += c.unicode() > 0xf ? QLatin1Char('1') : QLatin1Char('0');
-                product += QLatin1Char("0123456789abcdef"[c.unicode() & 0xf]);
-            } else {
-                product += c;
-            }
+            *product += QLatin1String("\\u00");
+            *product += u > 0xf ? QLatin1Char('1') : QLatin1Char('0');
+            *product += QLatin1Char("0123456789abcdef"[u & 0xf]);
         }
     }
-    product += QLatin1Char('"');
-    return product;
+    product->append(run, end - run);
+    *product += QLatin1Char('"');
 }
 
-QString Stringify::Str(const QString &key, ValueRef v)
+// Quotes one byte strings without widening them first.
+static void quote(QString *product, const String *str)
+{
+    if (!str->isLatin1()) {
+        quote(product, str->toQString());
+        return;
+    }
+
+    product->reserve(product->size() + str->length() + 2);
+    *product += QLatin1Char('"');
+    const char *run = str->latin1Data();
+    const char *end = run + str->length();
+    for (const char *c = run; c != end; ++c) {
+        uchar u = *c;
+        if (u > 0x1f && u != '"' && u != '\\')
+            continue;
+
+        product->append(QLatin1String(run, c - run));
+        run = c + 1;
+        switch (u) {
+        case '"':
+            *product += QLatin1String("\\\"");
+            break;
+        case '\\':
+            *product += QLatin1String("\\\\");
+            break;
+        case '\b':
+            *product += QLatin1String("\\b");
+            break;
+        case '\f':
+            *product += QLatin1String("\\f");
+            break;
+        case '\n':
+            *product += QLatin1String("\\n");
+            break;
+        case '\r':
+            *product += QLatin1String("\\r");
+            break;
+        case '\t':
+            *product += QLatin1String("\\t");
+            break;
+        default:
+            *product += QLatin1String("\\u00");
+            *product += u > 0xf ? QLatin1Char('1') : QLatin1Char('0');
+            *product += QLatin1Char("0123456789abcdef"[u & 0xf]);
+        }
+    }
+    product->append(QLatin1String(run, end - run));
+    *product += QLatin1Char('"');
+}
+
+// Appends the serialization of v to the result. Returns false if v does not
+// produce any output (undefined, functions).
+bool Stringify::Str(const QString &key, ValueRef v)
 {
     Scope scope(ctx);
 
@@ -740,16 +844,33 @@ QString Stringify::Str(const QString &key, ValueRef v)
             value = b->value;
     }
 
-    if (value->isNull())
-        return QStringLiteral("null");
-    if (value->isBoolean())
-        return value->booleanValue() ? QStringLiteral("true") : QStringLiteral("false");
-    if (value->isString())
-        return quote(value->stringValue()->toQString());
+    if (value->isNull()) {
+        result += QLatin1String("null");
+        return true;
+    }
+    if (value->isBoolean()) {
+        result += value->booleanValue() ? QLatin1String("true") : QLatin1String("false");
+        return true;
+    }
+    if (value->isString()) {
+        quote(&result, value->stringValue());
+        return true;
+    }
 
     if (value->isNumber()) {
-        double d = value->toNumber();
-        return std::isfinite(d) ? value->toString(ctx)->toQString() : QStringLiteral("null");
+        if (value->isInteger()) {
+            result += QString::number(value->integerValue());
+        } else {
+            double d = value->doubleValue();
+            if (std::isfinite(d)) {
+                QString n;
+                RuntimeHelpers::numberToString(&n, d);
+                result += n;
+            } else {
+                result += QLatin1String("null");
+            }
+        }
+        return true;
     }
 
     o = value.asReturnedValue();
@@ -757,44 +878,53 @@ QString Stringify::Str(const QString &key, ValueRef v)
         if (!o->asFunctionObject()) {
             if (o->asArrayObject()) {
                 ScopedArrayObject a(scope, o);
-                return JA(a);
+                JA(a);
             } else {
-                return JO(o);
+                JO(o);
             }
+            return true;
         }
     }
 
-    return QString();
+    return false;
 }
 
-QString Stringify::makeMember(const QString &key, ValueRef v)
+bool Stringify::makeMember(const QString &key, ValueRef v, bool first)
 {
-    QString strP = Str(key, v);
-    if (!strP.isEmpty()) {
-        QString member = quote(key) + QLatin1Char(':');
-        if (!gap.isEmpty())
-            member += QLatin1Char(' ');
-        member += strP;
-        return member;
+    const int position = result.size();
+    if (!first)
+        result += QLatin1Char(',');
+    if (!gap.isEmpty()) {
+        result += QLatin1Char('\n');
+        result += indent;
     }
-    return QString();
+    quote(&result, key);
+    result += QLatin1Char(':');
+    if (!gap.isEmpty())
+        result += QLatin1Char(' ');
+
+    if (!Str(key, v)) {
+        result.truncate(position);
+        return false;
+    }
+    return true;
 }
 
-QString Stringify::JO(ObjectRef o)
+void Stringify::JO(ObjectRef o)
 {
     if (stack.contains(o.getPointer())) {
         ctx->throwTypeError();
-        return QString();
+        return;
     }
 
     Scope scope(ctx);
 
-    QString result;
     stack.push(o.getPointer());
     QString stepback = indent;
     indent += gap;
 
-    QStringList partial;
+    result += QLatin1Char('{');
+    bool empty = true;
     if (propertyList.isEmpty()) {
         ObjectIterator it(scope, o, ObjectIterator::EnumerableOnly);
         ScopedValue name(scope);
@@ -802,84 +932,73 @@ QString Stringify::JO(ObjectRef o)
         ScopedValue val(scope);
         while (1) {
             name = it.nextPropertyNameAsString(val);
-            if (name->isNull())
+            if (name->isNull() || scope.engine->hasException)
                 break;
             QString key = name->toQString();
-            QString member = makeMember(key, val);
-            if (!member.isEmpty())
-                partial += member;
+            if (makeMember(key, val, empty))
+                empty = false;
         }
     } else {
         ScopedString s(scope);
-        for (int i = 0; i < propertyList.size(); ++i) {
+        for (int i = 0; i < propertyList.size() && !scope.engine->hasException; ++i) {
             bool exists;
             s = propertyList.at(i);
             ScopedValue v(scope, o->get(s, &exists));
             if (!exists)
                 continue;
-            QString member = makeMember(s->toQString(), v);
-            if (!member.isEmpty())
-                partial += member;
+            if (makeMember(s->toQString(), v, empty))
+                empty = false;
         }
     }
 
-    if (partial.isEmpty()) {
-        result = QStringLiteral("{}");
-    } else if (gap.isEmpty()) {
-        result = QStringLiteral("{") + partial.join(QLatin1Char(',')) + QStringLiteral("}");
-    } else {
-        QString separator = QStringLiteral(",\n") + indent;
-        result = QStringLiteral("{\n") + indent + partial.join(separator) + QStringLiteral("\n") + stepback + QStringLiteral("}");
+    if (!empty && !gap.isEmpty()) {
+        result += QLatin1Char('\n');
+        result += stepback;
     }
+    result += QLatin1Char('}');
 
     indent = stepback;
     stack.pop();
-    return result;
 }
 
-QString Stringify::JA(ArrayObjectRef a)
+void Stringify::JA(ArrayObjectRef a)
 {
     if (stack.contains(a.getPointer())) {
         ctx->throwTypeError();
-        return QString();
+        return;
     }
 
     Scope scope(a->engine());
 
-    QString result;
     stack.push(a.getPointer());
     QString stepback = indent;
     indent += gap;
 
-    QStringList partial;
+    result += QLatin1Char('[');
     uint len = a->getLength();
     ScopedValue v(scope);
-    for (uint i = 0; i < len; ++i) {
+    for (uint i = 0; i < len && !scope.engine->hasException; ++i) {
+        if (i)
+            result += QLatin1Char(',');
+        if (!gap.isEmpty()) {
+            result += QLatin1Char('\n');
+            result += indent;
+        }
+
         bool exists;
         v = a->getIndexed(i, &exists);
-        if (!exists) {
-            partial += QStringLiteral("null");
-            continue;
-        }
-        QString strP = Str(QString::number(i), v);
-        if (!strP.isEmpty())
-            partial += strP;
-        else
-            partial += QStringLiteral("null");
+        if (!exists || !Str(QString::number(i), v))
+            result += QLatin1String("null");
     }
 
-    if (partial.isEmpty()) {
-        result = QStringLiteral("[]");
-    } else if (gap.isEmpty()) {
-        result = QStringLiteral("[") + partial.join(QLatin1Char(',')) + QStringLiteral("]");
-    } else {
-        QString separator = QStringLiteral(",\n") + indent;
-        result = QStringLiteral("[\n") + indent + partial.join(separator) + QStringLiteral("\n") + stepback + QStringLiteral("]");
+    if (len && !gap.isEmpty()) {
+        result += QLatin1Char('\n');
+        result += stepback;
     }
+    result += QLatin1Char(']');
 
     indent = stepback;
     stack.pop();
-    return result;
 }
 
 
@@ -951,14 +1070,21 @@ ReturnedValue JsonObject::method_stringify(CallContext *ctx)
 
 
     ScopedValue arg0(scope, ctx->argument(0));
-    QString result = stringify.Str(QString(), arg0);
-    if (result.isEmpty() || scope.engine->hasException)
+    if (!stringify.Str(QString(), arg0) || scope.engine->hasException)
         return Encode::undefined();
-    return ctx->engine->newString(result)->asReturnedValue();
+    return ctx->engine->newString(stringify.result)->asReturnedValue();
 }
 
 
 
+ReturnedValue JsonObject::fromJson(ExecutionEngine *engine, const QByteArray &json, QJsonParseError *error)
+{
+    const QString text = QString::fromUtf8(json);
+    JsonParser parser(engine->currentContext(), text.constData(), text.length());
+    QJsonParseError e;
+    return parser.parse(error ? error : &e);
+}
+
 ReturnedValue JsonObject::fromJsonValue(ExecutionEngine *engine, const QJsonValue &value)
 {
     if (value.isString())
@@ -45,6 +45,7 @@
 #include <qjsonarray.h>
 #include <qjsonobject.h>
 #include <qjsonvalue.h>
+#include <qjsondocument.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -61,6 +62,8 @@ public:
     static ReturnedValue method_parse(CallContext *ctx);
     static ReturnedValue method_stringify(CallContext *ctx);
 
+    static ReturnedValue fromJson(ExecutionEngine *engine, const QByteArray &json, QJsonParseError *error = 0);
+
     static ReturnedValue fromJsonValue(ExecutionEngine *engine, const QJsonValue &value);
     static ReturnedValue fromJsonObject(ExecutionEngine *engine, const QJsonObject &object);
     static ReturnedValue fromJsonArray(ExecutionEngine *engine, const QJsonArray &array);
@@ -41,6 +41,7 @@
 #include "qv4lookup_p.h"
 #include "qv4functionobject_p.h"
 #include "qv4scopedvalue_p.h"
+#include "qv4typedarray_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -111,6 +112,10 @@ ReturnedValue Lookup::lookup(Object *obj, PropertyAttributes *attrs)
 ReturnedValue Lookup::indexedGetterGeneric(Lookup *l, const ValueRef object, const ValueRef index)
 {
     if (object->isObject() && index->asArrayIndex() < UINT_MAX) {
+        if (object->objectValue()->as<TypedArray>()) {
+            l->indexedGetter = indexedGetterTypedArray;
+            return indexedGetterTypedArray(l, object, index);
+        }
         l->indexedGetter = indexedGetterObjectInt;
         return indexedGetterObjectInt(l, object, index);
     }
@@ -180,10 +185,30 @@ ReturnedValue Lookup::indexedGetterObjectInt(Lookup *l, const ValueRef object, c
     return indexedGetterFallback(l, object, index);
 }
 
+ReturnedValue Lookup::indexedGetterTypedArray(Lookup *l, const ValueRef object, const ValueRef index)
+{
+    uint idx = index->asArrayIndex();
+    if (idx == UINT_MAX || !object->isObject())
+        return indexedGetterGeneric(l, object, index);
+
+    TypedArray *a = object->objectValue()->as<TypedArray>();
+    if (!a)
+        return indexedGetterGeneric(l, object, index);
+
+    if (idx < a->length())
+        return a->type->read(a->constData(), idx);
+    return Encode::undefined();
+}
+
 void Lookup::indexedSetterGeneric(Lookup *l, const ValueRef object, const ValueRef index, const ValueRef v)
 {
     if (object->isObject()) {
         Object *o = object->objectValue();
+        if (o->as<TypedArray>() && index->asArrayIndex() < UINT_MAX) {
+            l->indexedSetter = indexedSetterTypedArray;
+            indexedSetterTypedArray(l, object, index, v);
+            return;
+        }
         if (o->arrayData && o->arrayData->type == ArrayData::Simple && index->asArrayIndex() < UINT_MAX) {
             l->indexedSetter = indexedSetterObjectInt;
             indexedSetterObjectInt(l, object, index, v);
@@ -237,6 +262,30 @@ void Lookup::indexedSetterObjectInt(Lookup *l, const ValueRef object, const Valu
     indexedSetterFallback(l, object, index, v);
 }
 
+void Lookup::indexedSetterTypedArray(Lookup *l, const ValueRef object, const ValueRef index, const ValueRef v)
+{
+    uint idx = index->asArrayIndex();
+    if (idx == UINT_MAX || !object->isObject()) {
+        indexedSetterGeneric(l, object, index, v);
+        return;
+    }
+
+    TypedArray *a = object->objectValue()->as<TypedArray>();
+    if (!a) {
+        indexedSetterGeneric(l, object, index, v);
+        return;
+    }
+
+    // Numbers can be stored without calling out, everything else goes
+    // through the conversion in putIndexed
+    if (v->isNumber()) {
+        if (idx < a->length())
+            a->type->write(a->data(), idx, v->asDouble());
+        return;
+    }
+    static_cast<Object *>(a)->putIndexed(idx, v);
+}
+
 ReturnedValue Lookup::getterGeneric(QV4::Lookup *l, const ValueRef object)
 {
     if (Object *o = object->asObject())
@@ -389,8 +438,7 @@ ReturnedValue Lookup::getter0getter0(Lookup *l, const ValueRef object)
         if (l->classList[2] == o->internalClass)
             return o->memberData[l->index2].asReturnedValue();
     }
-    l->getter = getterFallback;
-    return getterFallback(l, object);
+    return startPolymorphic(l, object);
 }
 
 ReturnedValue Lookup::getter0getter1(Lookup *l, const ValueRef object)
@@ -405,8 +453,7 @@ ReturnedValue Lookup::getter0getter1(Lookup *l, const ValueRef object)
             l->classList[3] == o->prototype()->internalClass)
             return o->prototype()->memberData[l->index2].asReturnedValue();
     }
-    l->getter = getterFallback;
-    return getterFallback(l, object);
+    return startPolymorphic(l, object);
 }
 
 ReturnedValue Lookup::getter1getter1(Lookup *l, const ValueRef object)
@@ -421,12 +468,164 @@ ReturnedValue Lookup::getter1getter1(Lookup *l, const ValueRef object)
         if (l->classList[2] == o->internalClass &&
             l->classList[3] == o->prototype()->internalClass)
             return o->prototype()->memberData[l->index2].asReturnedValue();
+    }
+    return startPolymorphic(l, object);
+}
+
+
+PolymorphicLookupCache *PolymorphicLookupCache::create()
+{
+    const int alloc = maxShapes();
+    PolymorphicLookupCache *cache = (PolymorphicLookupCache *)malloc(sizeof(PolymorphicLookupCache) + (alloc - 1)*sizeof(Entry));
+    cache->count = 0;
+    cache->alloc = alloc;
+    cache->hits = 0;
+    cache->misses = 0;
+    return cache;
+}
+
+static int maxShapesFromEnvironment()
+{
+    bool ok;
+    const int shapes = qgetenv("QV4_LOOKUP_MAX_SHAPES").toInt(&ok);
+    return ok ? qBound(2, shapes, 16) : 8;
+}
+
+// The number of shapes an access site can see before it turns megamorphic, QV4_LOOKUP_MAX_SHAPES
+// can be used to tune it.
+int PolymorphicLookupCache::maxShapes()
+{
+    static const int shapes = maxShapesFromEnvironment();
+    return shapes;
+}
+
+// Called when a lookup that handles two shapes sees a third one: moves the shapes seen so far into
+// a polymorphic cache and adds the new one.
+ReturnedValue Lookup::startPolymorphic(Lookup *l, const ValueRef object)
+{
+    PolymorphicLookupCache *cache = PolymorphicLookupCache::create();
+    PolymorphicLookupCache::Entry *e = cache->entries;
+    const bool firstOnPrototype = l->getter == getter1getter1;
+    const bool secondOnPrototype = l->getter != getter0getter0;
+    e[0].objectClass = l->classList[0];
+    e[0].protoClass = firstOnPrototype ? l->classList[1] : 0;
+    e[0].index = l->index;
+    e[1].objectClass = l->classList[2];
+    e[1].protoClass = secondOnPrototype ? l->classList[3] : 0;
+    e[1].index = l->index2;
+    cache->count = 2;
+
+    l->polymorphicCache = cache;
+    l->getter = getterPolymorphic;
+    return polymorphicMiss(l, object);
+}
+
+ReturnedValue Lookup::getterPolymorphic(Lookup *l, const ValueRef object)
+{
+    if (object->isManaged()) {
+        // we can safely cast to a QV4::Object here. If object is actually a string,
+        // the internal class won't match
+        Object *o = object->objectValue();
+        PolymorphicLookupCache *cache = l->polymorphicCache;
+        for (int i = 0; i < cache->count; ++i) {
+            const PolymorphicLookupCache::Entry &e = cache->entries[i];
+            if (e.objectClass != o->internalClass)
+                continue;
+            if (!e.protoClass) {
+                ++cache->hits;
+                return o->memberData[e.index].asReturnedValue();
+            }
+            Object *proto = o->prototype();
+            if (proto->internalClass == e.protoClass) {
+                ++cache->hits;
+                return proto->memberData[e.index].asReturnedValue();
+            }
+        }
+    }
+    return polymorphicMiss(l, object);
+}
+
+ReturnedValue Lookup::polymorphicMiss(Lookup *l, const ValueRef object)
+{
+    PolymorphicLookupCache *cache = l->polymorphicCache;
+    ++cache->misses;
+
+    Object *o = object->asObject();
+    if (!o)
+        return getterFallback(l, object);
+
+    // Use a scratch lookup, as this one's class list is taken by the cache.
+    Lookup probe;
+    probe.name = l->name;
+    PropertyAttributes attrs;
+    ReturnedValue v = probe.lookup(o, &attrs);
+    if (v == Primitive::emptyValue().asReturnedValue())
+        return Encode::undefined();
+    if (!attrs.isData() || probe.level > 1)
+        return v;
+
+    if (cache->count == cache->alloc) {
+        free(cache);
+        l->getter = getterMegamorphic;
+        return getterMegamorphic(l, object);
+    }
+
+    PolymorphicLookupCache::Entry &e = cache->entries[cache->count++];
+    e.objectClass = probe.classList[0];
+    e.protoClass = probe.level == 1 ? probe.classList[1] : 0;
+    e.index = probe.index;
+    return v;
+}
+
+ReturnedValue Lookup::getterMegamorphic(Lookup *l, const ValueRef object)
+{
+    Object *o = object->asObject();
+    Identifier *identifier = l->name->identifier;
+    if (!o || !identifier)
         return getterFallback(l, object);
+
+    ExecutionEngine *engine = o->internalClass->engine;
+    if (!engine->megamorphicLookupCache)
+        engine->megamorphicLookupCache = new MegamorphicLookupCache;
+    MegamorphicLookupCache *cache = engine->megamorphicLookupCache;
+
+    MegamorphicLookupCache::Entry &e = cache->entries[MegamorphicLookupCache::hash(o->internalClass, identifier)];
+    if (e.objectClass == o->internalClass && e.identifier == identifier) {
+        if (!e.protoClass) {
+            ++cache->hits;
+            return o->memberData[e.index].asReturnedValue();
+        }
+        Object *proto = o->prototype();
+        if (proto->internalClass == e.protoClass) {
+            ++cache->hits;
+            return proto->memberData[e.index].asReturnedValue();
+        }
     }
-    l->getter = getterFallback;
-    return getterFallback(l, object);
+    ++cache->misses;
+
+    Lookup probe;
+    probe.name = l->name;
+    PropertyAttributes attrs;
+    ReturnedValue v = probe.lookup(o, &attrs);
+    if (v == Primitive::emptyValue().asReturnedValue())
+        return Encode::undefined();
+    if (attrs.isData() && probe.level <= 1) {
+        e.objectClass = probe.classList[0];
+        e.identifier = identifier;
+        e.protoClass = probe.level == 1 ? probe.classList[1] : 0;
+        e.index = probe.index;
+    }
+    return v;
 }
 
+void Lookup::releaseCaches()
+{
+    if (getter == getterPolymorphic) {
+        free(polymorphicCache);
+        polymorphicCache = 0;
+        getter = getterGeneric;
+    }
+}
 
 ReturnedValue Lookup::getterAccessor0(Lookup *l, const ValueRef object)
 {
@@ -52,6 +52,63 @@ QT_BEGIN_NAMESPACE
 
 namespace QV4 {
 
+// Shapes seen by an access site that went beyond two internal classes. Each entry caches a data
+// property either on the object itself or on its prototype.
+struct PolymorphicLookupCache
+{
+    struct Entry {
+        InternalClass *objectClass;
+        InternalClass *protoClass; // 0 for properties of the object itself
+        uint index;
+    };
+
+    int count;
+    int alloc;
+    quint64 hits;
+    quint64 misses;
+    Entry entries[1];
+
+    static PolymorphicLookupCache *create();
+    static int maxShapes();
+};
+
+// Per engine cache for access sites that have seen more shapes than fit into their polymorphic
+// cache. Entries are keyed on the internal class of the object and the identifier looked up.
+struct MegamorphicLookupCache
+{
+    enum { Size = 1024 };
+
+    struct Entry {
+        InternalClass *objectClass;
+        Identifier *identifier;
+        InternalClass *protoClass;
+        uint index;
+    };
+
+    MegamorphicLookupCache() : hits(0), misses(0) { memset(entries, 0, sizeof(entries)); }
+
+    static uint hash(const InternalClass *objectClass, const Identifier *identifier)
+    { return uint((quintptr(objectClass) >> 4) ^ (quintptr(identifier) >> 3)) % Size; }
+
+    quint64 hits;
+    quint64 misses;
+    Entry entries[Size];
+};
+
+struct LookupStatistics
+{
+    LookupStatistics()
+        : polymorphicSites(0), polymorphicHits(0), polymorphicMisses(0)
+        , megamorphicSites(0), megamorphicHits(0), megamorphicMisses(0) {}
+
+    int polymorphicSites;
+    quint64 polymorphicHits;
+    quint64 polymorphicMisses;
+    int megamorphicSites;
+    quint64 megamorphicHits;
+    quint64 megamorphicMisses;
+};
+
 struct Lookup {
     enum { Size = 4 };
     union {
@@ -63,6 +120,7 @@ struct Lookup {
     };
     union {
         ExecutionEngine *engine;
+        PolymorphicLookupCache *polymorphicCache;
         InternalClass *classList[Size];
         struct {
             void *dummy0;
@@ -81,14 +139,18 @@ struct Lookup {
     static ReturnedValue indexedGetterGeneric(Lookup *l, const ValueRef object, const ValueRef index);
     static ReturnedValue indexedGetterFallback(Lookup *l, const ValueRef object, const ValueRef index);
     static ReturnedValue indexedGetterObjectInt(Lookup *l, const ValueRef object, const ValueRef index);
+    static ReturnedValue indexedGetterTypedArray(Lookup *l, const ValueRef object, const ValueRef index);
 
     static void indexedSetterGeneric(Lookup *l, const ValueRef object, const ValueRef index, const ValueRef v);
     static void indexedSetterFallback(Lookup *l, const ValueRef object, const ValueRef index, const ValueRef value);
     static void indexedSetterObjectInt(Lookup *l, const ValueRef object, const ValueRef index, const ValueRef v);
+    static void indexedSetterTypedArray(Lookup *l, const ValueRef object, const ValueRef index, const ValueRef v);
 
     static ReturnedValue getterGeneric(Lookup *l, const ValueRef object);
     static ReturnedValue getterTwoClasses(Lookup *l, const ValueRef object);
     static ReturnedValue getterFallback(Lookup *l, const ValueRef object);
+    static ReturnedValue getterPolymorphic(Lookup *l, const ValueRef object);
+    static ReturnedValue getterMegamorphic(Lookup *l, const ValueRef object);
 
     static ReturnedValue getter0(Lookup *l, const ValueRef object);
     static ReturnedValue getter1(Lookup *l, const ValueRef object);
@@ -127,6 +189,10 @@ struct Lookup {
     ReturnedValue lookup(ValueRef thisObject, Object *obj, PropertyAttributes *attrs);
     ReturnedValue lookup(Object *obj, PropertyAttributes *attrs);
 
+    static ReturnedValue startPolymorphic(Lookup *l, const ValueRef object);
+    static ReturnedValue polymorphicMiss(Lookup *l, const ValueRef object);
+    void releaseCaches();
+
 };
 
 }
@@ -42,6 +42,7 @@
 #include "qv4managed_p.h"
 #include "qv4mm_p.h"
 #include "qv4errorobject_p.h"
+#include "qv4typedarray_p.h"
 
 using namespace QV4;
 
@@ -157,6 +158,12 @@ QString Managed::className() const
     case Type_MathObject:
         s = "Math";
         break;
+    case Type_ArrayBuffer:
+        s = "ArrayBuffer";
+        break;
+    case Type_TypedArray:
+        s = TypedArray::operations[subtype].name;
+        break;
 
     case Type_ExecutionContext:
         s = "__ExecutionContext";
@@ -234,6 +234,8 @@ public:
         Type_ArgumentsObject,
         Type_JsonObject,
         Type_MathObject,
+        Type_ArrayBuffer,
+        Type_TypedArray,
 
         Type_ExecutionContext,
         Type_ForeachIteratorObject,
@@ -313,7 +315,7 @@ public:
             uchar markBit :  1;
             uchar inUse   :  1;
             uchar extensible : 1; // used by Object
-            uchar _unused : 1;
+            mutable uchar latin1Text : 1; // used by String
             uchar needsActivation : 1; // used by FunctionObject
             uchar strictMode : 1; // used by FunctionObject
             uchar bindingKeyFlag : 1;
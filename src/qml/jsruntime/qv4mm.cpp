@@ -44,14 +44,26 @@
 #include "qv4objectproto_p.h"
 #include "qv4mm_p.h"
 #include "qv4qobjectwrapper_p.h"
+#include "qv4arraydata_p.h"
+#include "qv4memberdata_p.h"
+#include "qv4string_p.h"
+#include "qv4profiling_p.h"
+#include "qv4executableallocator_p.h"
 #include <qqmlengine.h>
 #include "PageAllocation.h"
 #include "StdLibExtras.h"
 
 #include <QTime>
+#include <QElapsedTimer>
+#include <QAtomicInt>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
 #include <QVector>
 #include <QVector>
 #include <QMap>
+#include <QVarLengthArray>
 
 #include <iostream>
 #include <cstdlib>
@@ -81,15 +93,23 @@ struct MemoryManager::Data
     bool gcBlocked;
     bool aggressiveGC;
     bool gcStats;
+    bool parallelSweep;
     ExecutionEngine *engine;
 
     enum { MaxItemSize = 512 };
+    enum { MinChunksForParallelSweep = 8 };
     Managed *smallItems[MaxItemSize/16];
     uint nChunks[MaxItemSize/16];
     uint availableItems[MaxItemSize/16];
     uint allocCount[MaxItemSize/16];
+    // Unused tail of the most recently allocated chunk for each size, handed out linearly
+    char *nurseryNext[MaxItemSize/16];
+    char *nurseryEnd[MaxItemSize/16];
     int totalItems;
     int totalAlloc;
+    quint64 allocatedBytes; // all bytes ever handed out, for attributing allocations
+    int lastGCDuration; // in milliseconds, -1 until the first collection
+    MemoryManager::GCStatistics gcStatistics;
     uint maxShift;
     std::size_t maxChunkSize;
     struct Chunk {
@@ -102,6 +122,7 @@ struct MemoryManager::Data
 
     struct LargeItem {
         LargeItem *next;
+        std::size_t size;
         void *data;
 
         Managed *managed() {
@@ -113,6 +134,9 @@ struct MemoryManager::Data
 
     GCDeletable *deletable;
 
+    // Sweeps nothing but the heap chunks, so a collection never waits behind application tasks.
+    QThreadPool *sweepPool;
+
     // statistics:
 #ifdef DETAILED_MM_STATS
     QVector<unsigned> allocSizeCounters;
@@ -123,17 +147,23 @@ struct MemoryManager::Data
         , engine(0)
         , totalItems(0)
         , totalAlloc(0)
+        , allocatedBytes(0)
+        , lastGCDuration(-1)
         , maxShift(6)
         , maxChunkSize(32*1024)
         , largeItems(0)
         , deletable(0)
+        , sweepPool(0)
     {
         memset(smallItems, 0, sizeof(smallItems));
         memset(nChunks, 0, sizeof(nChunks));
         memset(availableItems, 0, sizeof(availableItems));
         memset(allocCount, 0, sizeof(allocCount));
+        memset(nurseryNext, 0, sizeof(nurseryNext));
+        memset(nurseryEnd, 0, sizeof(nurseryEnd));
         aggressiveGC = !qgetenv("QV4_MM_AGGRESSIVE_GC").isEmpty();
         gcStats = !qgetenv("QV4_MM_STATS").isEmpty();
+        parallelSweep = qgetenv("QV4_MM_NO_PARALLEL_SWEEP").isEmpty() && QThread::idealThreadCount() > 1;
 
         QByteArray overrideMaxShift = qgetenv("QV4_MM_MAXBLOCK_SHIFT");
         bool ok;
@@ -149,6 +179,7 @@ struct MemoryManager::Data
 
     ~Data()
     {
+        delete sweepPool;
         for (QVector<Chunk>::iterator i = heapChunks.begin(), ei = heapChunks.end(); i != ei; ++i)
             i->memory.deallocate();
     }
@@ -165,7 +196,10 @@ bool operator<(const MemoryManager::Data::Chunk &a, const MemoryManager::Data::C
 } // namespace QV4
 
 MemoryManager::MemoryManager()
-    : m_d(new Data)
+    : m_allocationSampler(0)
+    , m_bytesUntilAllocationSample(0)
+    , m_allocationSamplingInterval(0)
+    , m_d(new Data)
     , m_persistentValues(0)
     , m_weakValues(0)
 {
@@ -185,6 +219,8 @@ Managed *MemoryManager::alloc(std::size_t size)
     Q_ASSERT(size >= 16);
     Q_ASSERT(size % 16 == 0);
 
+    m_d->allocatedBytes += size;
+
     size_t pos = size >> 4;
 
     // doesn't fit into a small bucket
@@ -193,6 +229,7 @@ Managed *MemoryManager::alloc(std::size_t size)
         MemoryManager::Data::LargeItem *item = static_cast<MemoryManager::Data::LargeItem *>(malloc(size + sizeof(MemoryManager::Data::LargeItem)));
         memset(item, 0, size + sizeof(MemoryManager::Data::LargeItem));
         item->next = m_d->largeItems;
+        item->size = size;
         m_d->largeItems = item;
         return item->managed();
     }
@@ -201,12 +238,17 @@ Managed *MemoryManager::alloc(std::size_t size)
     if (m)
         goto found;
 
+    if (m_d->nurseryNext[pos] && m_d->nurseryNext[pos] <= m_d->nurseryEnd[pos])
+        goto bump;
+
     // try to free up space, otherwise allocate
     if (m_d->allocCount[pos] > (m_d->availableItems[pos] >> 1) && m_d->totalAlloc > (m_d->totalItems >> 1) && !m_d->aggressiveGC) {
         runGC();
         m = m_d->smallItems[pos];
         if (m)
             goto found;
+        if (m_d->nurseryNext[pos] && m_d->nurseryNext[pos] <= m_d->nurseryEnd[pos])
+            goto bump;
     }
 
     // no free item available, allocate a new chunk
@@ -222,19 +264,12 @@ Managed *MemoryManager::alloc(std::size_t size)
         allocation.chunkSize = int(size);
         m_d->heapChunks.append(allocation);
         std::sort(m_d->heapChunks.begin(), m_d->heapChunks.end());
+        // Fresh pages are zero filled, so there is no need to thread the whole chunk into the
+        // free list up front. Items are handed out linearly and only touched when needed; the
+        // sweep skips the untouched tail as its items are not in use.
         char *chunk = (char *)allocation.memory.base();
-        char *end = chunk + allocation.memory.size() - size;
-
-        Managed **last = &m_d->smallItems[pos];
-        while (chunk <= end) {
-            Managed *o = reinterpret_cast<Managed *>(chunk);
-            o->_data = 0;
-            *last = o;
-            last = o->nextFreeRef();
-            chunk += size;
-        }
-        *last = 0;
-        m = m_d->smallItems[pos];
+        m_d->nurseryNext[pos] = chunk;
+        m_d->nurseryEnd[pos] = chunk + allocation.memory.size() - size;
         const size_t increase = allocation.memory.size()/size - 1;
         m_d->availableItems[pos] += uint(increase);
         m_d->totalItems += int(increase);
@@ -243,6 +278,16 @@ Managed *MemoryManager::alloc(std::size_t size)
 #endif
     }
 
+  bump:
+    m = reinterpret_cast<Managed *>(m_d->nurseryNext[pos]);
+    m_d->nurseryNext[pos] += size;
+#ifdef V4_USE_VALGRIND
+    VALGRIND_MEMPOOL_ALLOC(this, m, size);
+#endif
+    ++m_d->allocCount[pos];
+    ++m_d->totalAlloc;
+    return m;
+
   found:
 #ifdef V4_USE_VALGRIND
     VALGRIND_MEMPOOL_ALLOC(this, m, size);
@@ -355,6 +400,11 @@ void MemoryManager::sweep(bool lastSweep)
         }
     }
 
+#ifndef V4_USE_VALGRIND
+    if (m_d->parallelSweep && !lastSweep && m_d->heapChunks.size() >= Data::MinChunksForParallelSweep)
+        sweepChunksInParallel();
+    else
+#endif
     for (QVector<Data::Chunk>::iterator i = m_d->heapChunks.begin(), ei = m_d->heapChunks.end(); i != ei; ++i)
         sweep(reinterpret_cast<char*>(i->memory.base()), i->memory.size(), i->chunkSize);
 
@@ -428,6 +478,139 @@ void MemoryManager::sweep(char *chunkStart, std::size_t chunkSize, size_t size)
 #endif
 }
 
+namespace {
+
+typedef void (*DestroyFunction)(Managed *);
+
+// Destroy callbacks that only release memory owned by the object itself, and can therefore run
+// on any thread. Anything else, like QObject wrappers or functions holding on to compilation
+// units, is destroyed on the thread running the collection.
+static bool hasThreadSafeDestroy(DestroyFunction destroy)
+{
+    static const DestroyFunction threadSafe[] = {
+        MemberData::staticVTable()->destroy,
+        String::staticVTable()->destroy,
+        Object::staticVTable()->destroy,
+        SimpleArrayData::staticVTable()->destroy,
+        SparseArrayData::staticVTable()->destroy,
+        PackedArrayData::staticVTable()->destroy
+    };
+    for (uint i = 0; i < sizeof(threadSafe) / sizeof(threadSafe[0]); ++i) {
+        if (destroy == threadSafe[i])
+            return true;
+    }
+    return false;
+}
+
+// Result of sweeping one chunk on a worker thread. Garbage with a thread safe destroy callback is
+// freed right away into a chunk local free list, the rest is left for the collecting thread.
+struct ChunkSweep
+{
+    ChunkSweep() : chunkStart(0), chunkSize(0), itemSize(0), freeList(0), freeListTail(&freeList) {}
+
+    char *chunkStart;
+    std::size_t chunkSize;
+    std::size_t itemSize;
+    Managed *freeList;
+    Managed **freeListTail;
+    QVector<Managed *> needsDestroy;
+
+    void run()
+    {
+        for (char *chunk = chunkStart, *chunkEnd = chunk + chunkSize - itemSize; chunk <= chunkEnd; chunk += itemSize) {
+            Managed *m = reinterpret_cast<Managed *>(chunk);
+            if (!m->inUse)
+                continue;
+            if (m->markBit) {
+                m->markBit = 0;
+                continue;
+            }
+            DestroyFunction destroy = m->internalClass->vtable->destroy;
+            if (destroy && !hasThreadSafeDestroy(destroy)) {
+                needsDestroy.append(m);
+                continue;
+            }
+            if (destroy)
+                destroy(m);
+            memset(m, 0, itemSize);
+            *freeListTail = m;
+            freeListTail = m->nextFreeRef();
+        }
+    }
+};
+
+// Sweeps the chunks that nobody has taken yet, one at a time.
+class ChunkSweepTask : public QRunnable
+{
+public:
+    ChunkSweepTask(ChunkSweep *sweeps, int count, QAtomicInt *next, QSemaphore *done)
+        : m_sweeps(sweeps), m_count(count), m_next(next), m_done(done)
+    {}
+
+    void run()
+    {
+        for (int i = m_next->fetchAndAddRelaxed(1); i < m_count; i = m_next->fetchAndAddRelaxed(1))
+            m_sweeps[i].run();
+        if (m_done)
+            m_done->release();
+    }
+
+private:
+    ChunkSweep *m_sweeps;
+    int m_count;
+    QAtomicInt *m_next;
+    QSemaphore *m_done;
+};
+
+}
+
+// Shares the sweep of the small item chunks between a thread pool of the memory manager and the
+// calling thread. Nothing else may touch the heap at this point, so the workers only share the
+// chunk results.
+void MemoryManager::sweepChunksInParallel()
+{
+    const int chunkCount = m_d->heapChunks.size();
+    hasThreadSafeDestroy(0); // initialize the table before the workers use it
+    QVector<ChunkSweep> sweeps(chunkCount);
+    for (int i = 0; i < chunkCount; ++i) {
+        const Data::Chunk &chunk = m_d->heapChunks.at(i);
+        sweeps[i].chunkStart = reinterpret_cast<char *>(chunk.memory.base());
+        sweeps[i].chunkSize = chunk.memory.size();
+        sweeps[i].itemSize = chunk.chunkSize;
+    }
+
+    if (!m_d->sweepPool) {
+        m_d->sweepPool = new QThreadPool;
+        m_d->sweepPool->setMaxThreadCount(QThread::idealThreadCount() - 1);
+    }
+
+    // This thread takes chunks as well, so the sweep completes even if the workers are slow to
+    // start; they then find nothing left to do.
+    QAtomicInt next(0);
+    QSemaphore done;
+    const int workers = qMin(chunkCount - 1, m_d->sweepPool->maxThreadCount());
+    for (int i = 0; i < workers; ++i)
+        m_d->sweepPool->start(new ChunkSweepTask(sweeps.data(), chunkCount, &next, &done));
+    ChunkSweepTask(sweeps.data(), chunkCount, &next, 0).run();
+    done.acquire(workers);
+
+    for (int i = 0; i < chunkCount; ++i) {
+        ChunkSweep &result = sweeps[i];
+        Managed **f = &m_d->smallItems[result.itemSize >> 4];
+        for (QVector<Managed *>::ConstIterator it = result.needsDestroy.constBegin(), ei = result.needsDestroy.constEnd(); it != ei; ++it) {
+            Managed *m = *it;
+            m->internalClass->vtable->destroy(m);
+            memset(m, 0, result.itemSize);
+            m->setNextFree(*f);
+            *f = m;
+        }
+        if (result.freeList) {
+            *result.freeListTail = *f;
+            *f = result.freeList;
+        }
+    }
+}
+
 bool MemoryManager::isGCBlocked() const
 {
     return m_d->gcBlocked;
@@ -445,6 +628,12 @@ void MemoryManager::runGC()
         return;
     }
 
+    QElapsedTimer gcTimer;
+    gcTimer.start();
+
+    if (m_allocationSampler)
+        m_allocationSampler->resolvePendingAllocations();
+
     if (!m_d->gcStats) {
         mark();
         sweep();
@@ -471,10 +660,114 @@ void MemoryManager::runGC()
         qDebug() << "Used memory after GC:" << usedAfter;
         qDebug() << "Freed up bytes:" << (usedBefore - usedAfter);
         qDebug() << "======== End GC ========";
+        dumpStats();
     }
 
     memset(m_d->allocCount, 0, sizeof(m_d->allocCount));
     m_d->totalAlloc = 0;
+    m_d->lastGCDuration = int(gcTimer.elapsed());
+
+    const quint64 pauseTime = gcTimer.nsecsElapsed();
+    ++m_d->gcStatistics.collections;
+    m_d->gcStatistics.totalPauseTime += pauseTime;
+    m_d->gcStatistics.maxPauseTime = qMax(m_d->gcStatistics.maxPauseTime, pauseTime);
+}
+
+// Runs a collection ahead of time if the heap is halfway to triggering one from within alloc()
+// and the previous collection took no longer than msecs. This lets callers with idle time, such
+// as the frame loop, move collections out of the allocation path.
+bool MemoryManager::runGCWithin(int msecs)
+{
+    if (m_d->gcBlocked || m_d->lastGCDuration > msecs)
+        return false;
+    if (m_d->totalAlloc <= (m_d->totalItems >> 2))
+        return false;
+    runGC();
+    return true;
+}
+
+std::size_t MemoryManager::releaseFreeChunks()
+{
+    std::size_t released = 0;
+
+    // The free lists run across chunks, so they are rebuilt from the chunks that stay.
+    memset(m_d->smallItems, 0, sizeof(m_d->smallItems));
+
+    QVector<Data::Chunk> remaining;
+    remaining.reserve(m_d->heapChunks.size());
+
+#ifdef V4_USE_VALGRIND
+    VALGRIND_DISABLE_ERROR_REPORTING;
+#endif
+    for (QVector<Data::Chunk>::iterator i = m_d->heapChunks.begin(), ei = m_d->heapChunks.end(); i != ei; ++i) {
+        const std::size_t itemSize = i->chunkSize;
+        const std::size_t pos = itemSize >> 4;
+        char *chunkStart = reinterpret_cast<char *>(i->memory.base());
+        char *chunkEnd = chunkStart + i->memory.size() - itemSize;
+
+        // Items from the nursery pointer on have never been handed out and must not end up in
+        // the free list as well.
+        char *nursery = m_d->nurseryNext[pos];
+        const bool isNursery = nursery >= chunkStart && nursery <= chunkEnd;
+        char *freeEnd = isNursery ? nursery - itemSize : chunkEnd;
+
+        bool inUse = false;
+        for (char *chunk = chunkStart; chunk <= freeEnd; chunk += itemSize) {
+            if (reinterpret_cast<Managed *>(chunk)->inUse) {
+                inUse = true;
+                break;
+            }
+        }
+
+        if (!inUse) {
+            if (isNursery) {
+                m_d->nurseryNext[pos] = 0;
+                m_d->nurseryEnd[pos] = 0;
+            }
+            const std::size_t items = i->memory.size() / itemSize - 1;
+            m_d->availableItems[pos] -= uint(items);
+            m_d->totalItems -= int(items);
+            if (m_d->nChunks[pos])
+                --m_d->nChunks[pos];
+            released += i->memory.size();
+            i->memory.deallocate();
+            continue;
+        }
+
+        Managed **f = &m_d->smallItems[pos];
+        for (char *chunk = chunkStart; chunk <= freeEnd; chunk += itemSize) {
+            Managed *m = reinterpret_cast<Managed *>(chunk);
+            if (!m->inUse) {
+                m->setNextFree(*f);
+                *f = m;
+            }
+        }
+        remaining.append(*i);
+    }
+#ifdef V4_USE_VALGRIND
+    VALGRIND_ENABLE_ERROR_REPORTING;
+#endif
+
+    m_d->heapChunks = remaining;
+    return released;
+}
+
+void MemoryManager::setAllocationSampler(Profiling::Profiler *sampler, uint interval)
+{
+    m_allocationSampler = interval ? sampler : 0;
+    m_allocationSamplingInterval = interval;
+    m_bytesUntilAllocationSample = interval;
+}
+
+// A large allocation can span several intervals, which then all count towards its site.
+void MemoryManager::sampleAllocation(Managed *m)
+{
+    int samples = 0;
+    while (m_bytesUntilAllocationSample <= 0) {
+        m_bytesUntilAllocationSample += m_allocationSamplingInterval;
+        ++samples;
+    }
+    m_allocationSampler->sampleAllocation(m, samples);
 }
 
 uint MemoryManager::getUsedMem()
@@ -516,8 +809,82 @@ void MemoryManager::setExecutionEngine(ExecutionEngine *engine)
     m_d->engine = engine;
 }
 
+quint64 MemoryManager::allocatedBytes() const
+{
+    return m_d->allocatedBytes;
+}
+
+MemoryManager::HeapStatistics MemoryManager::heapStatistics() const
+{
+    HeapStatistics stats;
+    QVarLengthArray<HeapStatistics::SizeClass, Data::MaxItemSize/16> sizeClasses(Data::MaxItemSize/16);
+
+    for (QVector<Data::Chunk>::const_iterator i = m_d->heapChunks.constBegin(), ei = m_d->heapChunks.constEnd(); i != ei; ++i) {
+        HeapStatistics::SizeClass &sizeClass = sizeClasses[i->chunkSize >> 4];
+        sizeClass.itemSize = i->chunkSize;
+        ++sizeClass.chunkCount;
+        stats.chunkBytes += i->memory.size();
+
+        char *chunkStart = reinterpret_cast<char *>(i->memory.base());
+        char *chunkEnd = chunkStart + i->memory.size() - i->chunkSize;
+        for (char *chunk = chunkStart; chunk <= chunkEnd; chunk += i->chunkSize) {
+            ++sizeClass.totalItems;
+            Managed *m = reinterpret_cast<Managed *>(chunk);
+            if (!m->inUse)
+                continue;
+            ++sizeClass.usedItems;
+            stats.usedChunkBytes += i->chunkSize;
+            HeapStatistics::ClassUsage &usage = stats.liveObjects[QString::fromLatin1(m->internalClass->vtable->className)];
+            ++usage.count;
+            usage.bytes += i->chunkSize;
+        }
+    }
+
+    for (int i = 0; i < sizeClasses.size(); ++i) {
+        if (sizeClasses.at(i).chunkCount)
+            stats.sizeClasses.append(sizeClasses.at(i));
+    }
+
+    for (Data::LargeItem *i = m_d->largeItems; i; i = i->next) {
+        Managed *m = i->managed();
+        ++stats.largeItemCount;
+        stats.largeItemBytes += i->size;
+        HeapStatistics::ClassUsage &usage = stats.liveObjects[QString::fromLatin1(m->internalClass->vtable->className)];
+        ++usage.count;
+        usage.bytes += i->size;
+    }
+
+    return stats;
+}
+
+MemoryManager::GCStatistics MemoryManager::gcStatistics() const
+{
+    return m_d->gcStatistics;
+}
+
+void MemoryManager::resetGCStatistics()
+{
+    m_d->gcStatistics = GCStatistics();
+}
+
 void MemoryManager::dumpStats() const
 {
+    const HeapStatistics stats = heapStatistics();
+    qDebug() << "========== Heap ==========";
+    foreach (const HeapStatistics::SizeClass &sizeClass, stats.sizeClasses) {
+        qDebug().nospace() << sizeClass.itemSize << " byte items: " << sizeClass.usedItems << " of "
+                           << sizeClass.totalItems << " used in " << sizeClass.chunkCount << " chunks";
+    }
+    qDebug() << "Used" << stats.usedChunkBytes << "of" << stats.chunkBytes << "chunk bytes,"
+             << stats.largeItemCount << "large items using" << stats.largeItemBytes << "bytes";
+    for (QHash<QString, HeapStatistics::ClassUsage>::ConstIterator it = stats.liveObjects.constBegin(), end = stats.liveObjects.constEnd(); it != end; ++it)
+        qDebug().nospace() << "    " << qPrintable(it.key()) << ": " << it->count << " objects, " << it->bytes << " bytes";
+    const ExecutableAllocator::Statistics code = m_d->engine->executableAllocator->statistics();
+    qDebug() << "JIT code: used" << code.usedBytes << "of" << code.chunkBytes << "bytes in" << code.chunkCount << "chunks,"
+             << code.freeAllocationCount << "free blocks, largest" << code.largestFreeAllocation << "bytes,"
+             << code.decommittedBytes << "bytes decommitted";
+    qDebug() << "======== End Heap ========";
+
 #ifdef DETAILED_MM_STATS
     std::cerr << "=================" << std::endl;
     std::cerr << "Allocation stats:" << std::endl;
@@ -47,6 +47,8 @@
 #include "qv4value_inl_p.h"
 
 #include <QScopedPointer>
+#include <QHash>
+#include <QVector>
 
 //#define DETAILED_MM_STATS
 
@@ -59,6 +61,10 @@ struct ExecutionContext;
 struct Managed;
 struct GCDeletable;
 
+namespace Profiling {
+class Profiler;
+}
+
 class Q_QML_EXPORT MemoryManager
 {
     MemoryManager(const MemoryManager &);
@@ -100,15 +106,68 @@ public:
     {
         size = align(size);
         Managed *o = alloc(size);
+        if (m_allocationSampler && (m_bytesUntilAllocationSample -= qint64(size)) <= 0)
+            sampleAllocation(o);
         return o;
     }
 
+    // Reports about every (interval) bytes allocated to the profiler, or stops doing so
+    // if sampler is 0.
+    void setAllocationSampler(Profiling::Profiler *sampler, uint interval);
+
     bool isGCBlocked() const;
     void setGCBlocked(bool blockGC);
     void runGC();
+    bool runGCWithin(int msecs);
+    // Returns chunks that no longer hold any live item to the OS. Returns the number of bytes released.
+    std::size_t releaseFreeChunks();
 
     void setExecutionEngine(ExecutionEngine *engine);
 
+    struct HeapStatistics
+    {
+        HeapStatistics() : chunkBytes(0), usedChunkBytes(0), largeItemCount(0), largeItemBytes(0) {}
+
+        struct SizeClass
+        {
+            SizeClass() : itemSize(0), chunkCount(0), totalItems(0), usedItems(0) {}
+            uint itemSize;
+            uint chunkCount;
+            uint totalItems;
+            uint usedItems;
+        };
+        struct ClassUsage
+        {
+            ClassUsage() : count(0), bytes(0) {}
+            uint count;
+            quint64 bytes;
+        };
+
+        QVector<SizeClass> sizeClasses; // only size classes that have at least one chunk
+        quint64 chunkBytes;
+        quint64 usedChunkBytes;
+        uint largeItemCount;
+        quint64 largeItemBytes;
+        QHash<QString, ClassUsage> liveObjects; // by vtable class name, includes garbage that wasn't collected yet
+    };
+
+    HeapStatistics heapStatistics() const;
+
+    struct GCStatistics
+    {
+        GCStatistics() : collections(0), totalPauseTime(0), maxPauseTime(0) {}
+        uint collections;
+        quint64 totalPauseTime; // in nanoseconds
+        quint64 maxPauseTime; // in nanoseconds
+    };
+
+    // Counts the collections and the time spent in them since the memory manager was created
+    // or resetGCStatistics() was last called.
+    GCStatistics gcStatistics() const;
+    void resetGCStatistics();
+    // Monotonic count of the bytes allocated so far, unaffected by garbage collection.
+    // The difference between two readings is what was allocated in between.
+    quint64 allocatedBytes() const;
     void dumpStats() const;
 
     void registerDeletable(GCDeletable *d);
@@ -129,7 +188,13 @@ private:
     void mark();
     void sweep(bool lastSweep = false);
     void sweep(char *chunkStart, std::size_t chunkSize, size_t size);
+    void sweepChunksInParallel();
     uint getUsedMem();
+    void sampleAllocation(Managed *m);
+
+    Profiling::Profiler *m_allocationSampler;
+    qint64 m_bytesUntilAllocationSample;
+    qint64 m_allocationSamplingInterval;
 
 protected:
     QScopedPointer<Data> m_d;
@@ -270,6 +270,8 @@ Property *Object::__getOwnProperty__(const StringRef name, PropertyAttributes *a
 
 Property *Object::__getOwnProperty__(uint index, PropertyAttributes *attrs)
 {
+    if (arrayData->isPacked())
+        PackedArrayData::unpack(this);
     Property *p = arrayData->getProperty(index);
     if (p) {
         if (attrs)
@@ -315,6 +317,8 @@ Property *Object::__getPropertyDescriptor__(uint index, PropertyAttributes *attr
 {
     const Object *o = this;
     while (o) {
+        if (o->arrayData->isPacked())
+            PackedArrayData::unpack(const_cast<Object *>(o));
         Property *p = o->arrayData->getProperty(index);
         if (p) {
             if (attrs)
@@ -553,6 +557,9 @@ void Object::advanceIterator(Managed *m, ObjectIterator *it, StringRef name, uin
     if (o->arrayData) {
         if (!it->arrayIndex)
             it->arrayNode = o->sparseBegin();
+        else if (it->arrayNode && o->arrayType() != ArrayData::Sparse)
+            // the array was converted back to simple storage, continue at arrayIndex
+            it->arrayNode = 0;
 
         // sparse arrays
         if (it->arrayNode) {
@@ -573,18 +580,28 @@ void Object::advanceIterator(Managed *m, ObjectIterator *it, StringRef name, uin
             it->arrayNode = 0;
             it->arrayIndex = UINT_MAX;
         }
-        // dense arrays
-        while (it->arrayIndex < o->arrayData->length()) {
-            Value *val = o->arrayData->data + it->arrayIndex;
-            PropertyAttributes a = o->arrayData->attributes(it->arrayIndex);
-            ++it->arrayIndex;
-            if (!val->isEmpty()
-                && (!(it->flags & ObjectIterator::EnumerableOnly) || a.isEnumerable())) {
-                *index = it->arrayIndex - 1;
-                *attrs = a;
-                pd->value = *val;
+        if (o->arrayData->isPacked()) {
+            // packed arrays have no holes and only enumerable elements
+            if (it->arrayIndex < o->arrayData->length()) {
+                *index = it->arrayIndex++;
+                *attrs = Attr_Data;
+                pd->value = Value::fromReturnedValue(o->arrayData->get(*index));
                 return;
             }
+        } else {
+            // dense arrays
+            while (it->arrayIndex < o->arrayData->length()) {
+                Value *val = o->arrayData->data + it->arrayIndex;
+                PropertyAttributes a = o->arrayData->attributes(it->arrayIndex);
+                ++it->arrayIndex;
+                if (!val->isEmpty()
+                    && (!(it->flags & ObjectIterator::EnumerableOnly) || a.isEnumerable())) {
+                    *index = it->arrayIndex - 1;
+                    *attrs = a;
+                    pd->value = *val;
+                    return;
+                }
+            }
         }
     }
 
@@ -642,6 +659,11 @@ ReturnedValue Object::internalGetIndexed(uint index, bool *hasProperty)
     PropertyAttributes attrs;
     Object *o = this;
     while (o) {
+        if (o->arrayData->isPacked() && index < o->arrayData->length()) {
+            if (hasProperty)
+                *hasProperty = true;
+            return o->arrayData->get(index);
+        }
         Property *p = o->arrayData->getProperty(index);
         if (p) {
             pd = p;
@@ -760,6 +782,12 @@ void Object::internalPutIndexed(uint index, const ValueRef value)
     if (internalClass->engine->hasException)
         return;
 
+    // packed elements are always writable data properties
+    if (arrayData->isPacked() && index < arrayData->length()) {
+        arrayData->vtable()->put(this, index, value);
+        return;
+    }
+
     PropertyAttributes attrs;
 
     Property *pd = arrayData->getProperty(index);
@@ -948,6 +976,9 @@ bool Object::defineOwnProperty2(ExecutionContext *ctx, uint index, const Propert
 {
     Property *current = 0;
 
+    if (arrayData->isPacked())
+        PackedArrayData::unpack(this);
+
     // Clause 1
     {
         current = arrayData->getProperty(index);
@@ -1096,6 +1127,13 @@ void Object::copyArrayData(Object *other)
         }
     } else if (!other->arrayData) {
         ;
+    } else if (other->arrayData->isPacked()) {
+        Q_ASSERT(!arrayData);
+        const PackedArrayData *od = static_cast<const PackedArrayData *>(other->arrayData);
+        PackedArrayData::reserve(this, od->type, od->len);
+        PackedArrayData *dd = static_cast<PackedArrayData *>(arrayData);
+        memcpy(dd->intData, od->intData, od->len*PackedArrayData::elementSize(od->type));
+        dd->len = od->len;
     } else if (other->hasAccessorProperty && other->arrayData->attrs && other->arrayData->isSparse()){
         // do it the slow way
         ScopedValue v(scope);
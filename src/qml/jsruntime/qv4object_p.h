@@ -213,7 +213,10 @@ public:
     }
 
     inline void arrayReserve(uint n) {
-        ArrayData::realloc(this, ArrayData::Simple, 0, n, false);
+        if (arrayData && arrayData->isPacked())
+            arrayData->vtable()->reallocate(this, n, false);
+        else
+            ArrayData::realloc(this, ArrayData::Simple, 0, n, false);
     }
 
     void arrayCreate() {
@@ -262,6 +265,9 @@ public:
     { vtable()->setLookup(this, l, v); }
     void advanceIterator(ObjectIterator *it, StringRef name, uint *index, Property *p, PropertyAttributes *attributes)
     { vtable()->advanceIterator(this, it, name, index, p, attributes); }
+    // True if the enumerable keys can be taken from the InternalClass enumeration cache
+    bool hasCacheableKeys() const
+    { return internalClass->vtable->advanceIterator == &Object::advanceIterator && !arrayData; }
     uint getLength() const { return vtable()->getLength(this); }
 
     inline ReturnedValue construct(CallData *d)
@@ -390,12 +396,18 @@ inline void Object::arraySet(uint index, const Property &p, PropertyAttributes a
 
 inline void Object::arraySet(uint index, ValueRef value)
 {
+    if (!arrayData && !index && value)
+        PackedArrayData::create(this, value, 1);
     arrayCreate();
-    if (index > 0x1000 && index > 2*arrayData->alloc) {
-        initSparseArray();
+    if (arrayData->isPacked() && value && value->isNumber() && index <= arrayData->length()) {
+        arrayData->vtable()->put(this, index, value);
+    } else {
+        if (index > 0x1000 && index > 2*arrayData->alloc) {
+            initSparseArray();
+        }
+        Property *pd = ArrayData::insert(this, index);
+        pd->value = value ? *value : Primitive::undefinedValue();
     }
-    Property *pd = ArrayData::insert(this, index);
-    pd->value = value ? *value : Primitive::undefinedValue();
     if (isArrayObject() && index >= getLength())
         setArrayLengthUnchecked(index + 1);
 }
@@ -53,6 +53,9 @@ ObjectIterator::ObjectIterator(Value *scratch1, Value *scratch2, const ObjectRef
     , arrayIndex(0)
     , memberIndex(0)
     , flags(flags)
+    , keysClass(0)
+    , keyIndex(0)
+    , keysState(KeysUnknown)
 {
     object = o.getPointer();
     current = o.getPointer();
@@ -70,6 +73,9 @@ ObjectIterator::ObjectIterator(Scope &scope, const ObjectRef o, uint flags)
     , arrayIndex(0)
     , memberIndex(0)
     , flags(flags)
+    , keysClass(0)
+    , keyIndex(0)
+    , keysState(KeysUnknown)
 {
     object = o;
     current = o;
@@ -84,6 +90,8 @@ void ObjectIterator::next(StringRef name, uint *index, Property *pd, PropertyAtt
 {
     name = (String *)0;
     *index = UINT_MAX;
+    Q_ASSERT(keysState != KeysCached);
+    keysState = KeysUncached;
 
     if (!object) {
         *attrs = PropertyAttributes();
@@ -171,11 +179,57 @@ ReturnedValue ObjectIterator::nextPropertyNameAsString(ValueRef value)
     return Encode(object->engine()->newString(QString::number(index)));
 }
 
+/*
+    Takes the keys from the enumeration cache of the object's class, which
+    is possible for plain objects without indexed properties (and, when
+    iterating the prototype chain, plain prototypes). Iterating then only
+    steps through a shared copy of the cached array.
+ */
+bool ObjectIterator::initKeys()
+{
+    if (!(flags & EnumerableOnly))
+        return false;
+
+    keysClass = object->internalClass;
+    if (flags & WithProtoChain) {
+        bool ok = false;
+        keys = keysClass->forInKeys(object.getPointer(), &ok);
+        return ok;
+    }
+
+    if (!object->hasCacheableKeys())
+        return false;
+    keys = keysClass->enumerableKeys();
+    return true;
+}
+
+ReturnedValue ObjectIterator::nextCachedKey()
+{
+    while (keyIndex < keys.size()) {
+        String *key = keys.at(keyIndex++);
+        if (object->internalClass == keysClass)
+            return key->asReturnedValue();
+
+        // The object changed during the iteration. Properties deleted before
+        // they were visited must not show up (ES5 12.6.4).
+        Scope scope(object->engine());
+        ScopedString name(scope, key);
+        if ((flags & WithProtoChain) ? object->hasProperty(name) : object->hasOwnProperty(name))
+            return key->asReturnedValue();
+    }
+    return Encode::null();
+}
+
 ReturnedValue ObjectIterator::nextPropertyNameAsString()
 {
     if (!object)
         return Encode::null();
 
+    if (keysState == KeysUnknown)
+        keysState = initKeys() ? KeysCached : KeysUncached;
+    if (keysState == KeysCached)
+        return nextCachedKey();
+
     PropertyAttributes attrs;
     Property p;
     uint index;
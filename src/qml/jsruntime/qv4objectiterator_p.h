@@ -67,6 +67,12 @@ struct Q_QML_EXPORT ObjectIterator
         WithProtoChain = 0x2,
     };
 
+    enum KeysState {
+        KeysUnknown,
+        KeysCached,
+        KeysUncached
+    };
+
     ObjectRef object;
     ObjectRef current;
     SparseArrayNode *arrayNode;
@@ -74,12 +80,23 @@ struct Q_QML_EXPORT ObjectIterator
     uint memberIndex;
     uint flags;
 
+    // Snapshot of the enumeration cache of the object's class, used by
+    // nextPropertyNameAsString() when the object allows it.
+    QVector<String *> keys;
+    InternalClass *keysClass;
+    int keyIndex;
+    KeysState keysState;
+
     ObjectIterator(Value *scratch1, Value *scratch2, const ObjectRef o, uint flags);
     ObjectIterator(Scope &scope, const ObjectRef o, uint flags);
     void next(StringRef name, uint *index, Property *pd, PropertyAttributes *attributes = 0);
     ReturnedValue nextPropertyName(ValueRef value);
     ReturnedValue nextPropertyNameAsString(ValueRef value);
     ReturnedValue nextPropertyNameAsString();
+
+private:
+    bool initKeys();
+    ReturnedValue nextCachedKey();
 };
 
 struct ForEachIteratorObject: Object {
@@ -96,6 +113,7 @@ struct ForEachIteratorObject: Object {
 
 protected:
     static void markObjects(Managed *that, ExecutionEngine *e);
+    static void destroy(Managed *that) { static_cast<ForEachIteratorObject *>(that)->~ForEachIteratorObject(); }
 
     Value workArea[2];
 };
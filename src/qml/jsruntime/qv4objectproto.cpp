@@ -397,6 +397,17 @@ ReturnedValue ObjectPrototype::method_keys(CallContext *ctx)
 
     Scoped<ArrayObject> a(scope, ctx->engine->newArrayObject());
 
+    if (o->hasCacheableKeys()) {
+        // Same-shaped objects share their keys, copy them in one go
+        const QVector<String *> keys = o->internalClass->enumerableKeys();
+        a->arrayReserve(keys.size());
+        ScopedValue key(scope);
+        for (int i = 0; i < keys.size(); ++i)
+            a->arrayPut(i, (key = keys.at(i)));
+        a->setArrayLengthUnchecked(keys.size());
+        return a.asReturnedValue();
+    }
+
     ObjectIterator it(scope, o, ObjectIterator::EnumerableOnly);
     ScopedValue name(scope);
     while (1) {
@@ -40,9 +40,61 @@
 ****************************************************************************/
 
 #include "qv4profiling_p.h"
+#include "qv4context_p.h"
+#include "qv4functionobject_p.h"
+#include "qv4mm_p.h"
+
+#include <QThread>
+#include <QVarLengthArray>
 
 QT_BEGIN_NAMESPACE
 
+namespace QV4 {
+namespace Profiling {
+
+// Only raises a flag; the stack itself is walked on the engine thread, where the
+// contexts can be read safely.
+class Sampler : public QThread
+{
+public:
+    Sampler(QAtomicInt *samplePending, int interval)
+        : m_samplePending(samplePending), m_interval(interval)
+    {}
+
+    void stop()
+    {
+        m_stop.store(1);
+        wait();
+    }
+
+protected:
+    void run()
+    {
+        while (!m_stop.load()) {
+            QThread::usleep(m_interval);
+            m_samplePending->store(1);
+        }
+    }
+
+private:
+    QAtomicInt *m_samplePending;
+    int m_interval;
+    QAtomicInt m_stop;
+};
+
+// Collects the functions of the JS stack, innermost first.
+static void collectStack(ExecutionContext *ctx, QVarLengthArray<Function *, 64> &stack)
+{
+    for (ExecutionContext *c = ctx; c; c = c->parent) {
+        CallContext *callContext = c->asCallContext();
+        if (callContext && callContext->function && callContext->function->function)
+            stack.append(callContext->function->function);
+    }
+}
+
+}
+}
+
 using namespace QV4;
 using namespace QV4::Profiling;
 
@@ -60,11 +112,195 @@ FunctionCallProperties FunctionCall::resolve() const
 }
 
 
-Profiler::Profiler() : enabled(false)
+Profiler::Profiler(ExecutionEngine *engine)
+    : enabled(false)
+    , m_engine(engine)
+    , m_samplingInterval(0)
+    , m_sampler(0)
+    , m_samplingStart(0)
+    , m_allocationSamplingInterval(0)
 {
     static int metatype = qRegisterMetaType<QList<QV4::Profiling::FunctionCallProperties> >();
     Q_UNUSED(metatype);
+    static int allocationMetatype =
+            qRegisterMetaType<QList<QV4::Profiling::AllocationSiteProperties> >();
+    Q_UNUSED(allocationMetatype);
     m_timer.start();
+
+    bool ok = false;
+    int interval = qgetenv("QV4_PROFILE_SAMPLING_INTERVAL").toInt(&ok);
+    if (ok && interval > 0)
+        m_samplingInterval = interval;
+
+    interval = qgetenv("QV4_PROFILE_ALLOCATION_SAMPLING_INTERVAL").toInt(&ok);
+    if (ok && interval > 0)
+        m_allocationSamplingInterval = interval;
+}
+
+Profiler::~Profiler()
+{
+    if (m_sampler) {
+        m_sampler->stop();
+        delete m_sampler;
+    }
+    if (enabled && m_allocationSamplingInterval)
+        m_engine->memoryManager->setAllocationSampler(0, 0);
+    clearCallTree();
+    clearAllocationTree();
+}
+
+void Profiler::setSamplingInterval(int usecs)
+{
+    // Switching modes in the middle of a run would mix up the two kinds of data.
+    if (!enabled)
+        m_samplingInterval = qMax(0, usecs);
+}
+
+void Profiler::setAllocationSamplingInterval(int bytes)
+{
+    if (!enabled)
+        m_allocationSamplingInterval = qMax(0, bytes);
+}
+
+void Profiler::takeSample(ExecutionContext *ctx, Function *function)
+{
+    if (!m_samplePending.fetchAndStoreRelaxed(0))
+        return;
+
+    QVarLengthArray<Function *, 64> stack;
+    stack.append(function);
+    collectStack(ctx->parent, stack);
+
+    if (m_callTree.isEmpty()) {
+        CallTreeNode root = { 0, -1, -1, 0 };
+        m_callTree.append(root);
+    }
+
+    int node = 0;
+    ++m_callTree[0].totalSamples;
+    for (int i = stack.size() - 1; i >= 0; --i) {
+        int child = m_callTree.at(node).firstChild;
+        while (child != -1 && m_callTree.at(child).function != stack.at(i))
+            child = m_callTree.at(child).nextSibling;
+        if (child == -1) {
+            CallTreeNode n = { stack.at(i), -1, m_callTree.at(node).firstChild, 0 };
+            n.function->compilationUnit->ref();
+            child = m_callTree.size();
+            m_callTree.append(n);
+            m_callTree[node].firstChild = child;
+        }
+        ++m_callTree[child].totalSamples;
+        node = child;
+    }
+}
+
+void Profiler::clearCallTree()
+{
+    foreach (const CallTreeNode &node, m_callTree) {
+        if (node.function)
+            node.function->compilationUnit->deref();
+    }
+    m_callTree.clear();
+}
+
+void Profiler::reportCallTree(QList<FunctionCallProperties> &resolved, int node, qint64 start) const
+{
+    for (int child = m_callTree.at(node).firstChild; child != -1; child = m_callTree.at(child).nextSibling) {
+        const CallTreeNode &n = m_callTree.at(child);
+        qint64 duration = qint64(n.totalSamples) * m_samplingInterval * 1000;
+        resolved.append(FunctionCall(n.function, start, start + duration).resolve());
+        reportCallTree(resolved, child, start);
+        start += duration;
+    }
+}
+
+int Profiler::allocationTreeChild(int node, Function *function, const char *objectClass)
+{
+    int child = m_allocationTree.at(node).firstChild;
+    while (child != -1 && (m_allocationTree.at(child).function != function
+                           || m_allocationTree.at(child).objectClass != objectClass))
+        child = m_allocationTree.at(child).nextSibling;
+    if (child == -1) {
+        AllocationTreeNode n = { function, objectClass, -1, m_allocationTree.at(node).firstChild, 0 };
+        if (function)
+            function->compilationUnit->ref();
+        child = m_allocationTree.size();
+        m_allocationTree.append(n);
+        m_allocationTree[node].firstChild = child;
+    }
+    return child;
+}
+
+void Profiler::sampleAllocation(Managed *object, int samples)
+{
+    QVarLengthArray<Function *, 64> stack;
+    collectStack(m_engine->currentContext(), stack);
+
+    if (m_allocationTree.isEmpty()) {
+        AllocationTreeNode root = { 0, 0, -1, -1, 0 };
+        m_allocationTree.append(root);
+    }
+
+    int node = 0;
+    m_allocationTree[0].samples += samples;
+    for (int i = stack.size() - 1; i >= 0; --i) {
+        node = allocationTreeChild(node, stack.at(i), 0);
+        m_allocationTree[node].samples += samples;
+    }
+
+    PendingAllocation pending = { object, node, samples };
+    m_pendingAllocations.append(pending);
+}
+
+// Has to run before the objects can be collected, that is before each GC.
+void Profiler::resolvePendingAllocations()
+{
+    foreach (const PendingAllocation &pending, m_pendingAllocations) {
+        const char *className = pending.object->internalClass
+                ? pending.object->internalClass->vtable->className : "<unknown>";
+        int leaf = allocationTreeChild(pending.node, 0, className);
+        m_allocationTree[leaf].samples += pending.samples;
+    }
+    m_pendingAllocations.clear();
+}
+
+void Profiler::clearAllocationTree()
+{
+    foreach (const AllocationTreeNode &node, m_allocationTree) {
+        if (node.function)
+            node.function->compilationUnit->deref();
+    }
+    m_allocationTree.clear();
+    m_pendingAllocations.clear();
+}
+
+void Profiler::reportAllocationTree(QList<AllocationSiteProperties> &resolved, int node, int depth,
+                                    qint64 time) const
+{
+    for (int child = m_allocationTree.at(node).firstChild; child != -1;
+         child = m_allocationTree.at(child).nextSibling) {
+        const AllocationTreeNode &n = m_allocationTree.at(child);
+        AllocationSiteProperties props;
+        props.time = time;
+        props.depth = depth;
+        props.samples = n.samples;
+        props.bytes = qint64(n.samples) * m_allocationSamplingInterval;
+        if (n.function) {
+            FunctionCallProperties location = FunctionCall(n.function, time, time).resolve();
+            props.name = location.name;
+            props.file = location.file;
+            props.line = location.line;
+            props.column = location.column;
+            props.objectClass = false;
+        } else {
+            props.name = QString::fromLatin1(n.objectClass);
+            props.line = -1;
+            props.column = -1;
+            props.objectClass = true;
+        }
+        resolved.append(props);
+        reportAllocationTree(resolved, child, depth + 1, time);
+    }
 }
 
 struct FunctionCallComparator {
@@ -75,12 +311,34 @@ struct FunctionCallComparator {
 void Profiler::stopProfiling()
 {
     enabled = false;
+    if (m_sampler) {
+        m_sampler->stop();
+        delete m_sampler;
+        m_sampler = 0;
+    }
+    if (m_allocationSamplingInterval) {
+        m_engine->memoryManager->setAllocationSampler(0, 0);
+        resolvePendingAllocations();
+    }
     reportData();
 }
 
 void Profiler::reportData()
 {
+    if (!m_allocationTree.isEmpty()) {
+        QList<AllocationSiteProperties> allocations;
+        reportAllocationTree(allocations, 0, 0, m_timer.nsecsElapsed());
+        emit allocationsReady(allocations);
+    }
+
     QList<FunctionCallProperties> resolved;
+    if (!m_callTree.isEmpty()) {
+        // Pre-order traversal, so the calls come out sorted by start time already.
+        reportCallTree(resolved, 0, m_samplingStart);
+        emit dataReady(resolved);
+        return;
+    }
+
     resolved.reserve(m_data.size());
     FunctionCallComparator comp;
     foreach (const FunctionCall &call, m_data) {
@@ -94,6 +352,16 @@ void Profiler::startProfiling()
 {
     if (!enabled) {
         m_data.clear();
+        clearCallTree();
+        clearAllocationTree();
+        if (m_samplingInterval) {
+            m_samplingStart = m_timer.nsecsElapsed();
+            m_samplePending.store(0);
+            m_sampler = new Sampler(&m_samplePending, m_samplingInterval);
+            m_sampler->start();
+        }
+        if (m_allocationSamplingInterval)
+            m_engine->memoryManager->setAllocationSampler(this, m_allocationSamplingInterval);
         enabled = true;
     }
 }
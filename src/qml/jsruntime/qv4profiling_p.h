@@ -47,6 +47,7 @@
 #include "qv4function_p.h"
 
 #include <QElapsedTimer>
+#include <QAtomicInt>
 
 QT_BEGIN_NAMESPACE
 
@@ -63,6 +64,21 @@ struct FunctionCallProperties {
     int column;
 };
 
+// One node of the allocation call tree, in pre-order. Function nodes carry the location of the
+// function, leaves carry the class of the objects allocated there in objectClass. bytes is
+// estimated as samples * allocation sampling interval.
+struct AllocationSiteProperties {
+    qint64 time;
+    int depth;
+    QString name;
+    QString file;
+    int line;
+    int column;
+    bool objectClass;
+    int samples;
+    qint64 bytes;
+};
+
 class FunctionCall {
 public:
 
@@ -106,27 +122,89 @@ private:
         Profiling::FunctionCallProfiler::profileCall(engine->profiler, ctx, function) :\
         function->code(ctx, function->codeData))
 
+class Sampler;
+
 class Q_QML_EXPORT Profiler : public QObject {
     Q_OBJECT
     Q_DISABLE_COPY(Profiler)
 public:
-    Profiler();
+    Profiler(ExecutionEngine *engine);
+    ~Profiler();
 
     bool enabled;
 
+    // With a sampling interval set, calls are not traced individually. A sampler thread
+    // requests a sample every interval and the engine thread records its JS stack at the
+    // next function entry. The samples are aggregated into a call tree which is reported
+    // as nested calls, each lasting (number of samples) * interval.
+    int samplingInterval() const { return m_samplingInterval; }
+
+    // With an allocation sampling interval set, the memory manager calls sampleAllocation()
+    // about every (interval) bytes allocated. The JS stack of each sample is recorded in an
+    // allocation call tree; the class of the object is only looked up at the next GC or when
+    // profiling stops, as the object isn't constructed yet when it is sampled.
+    int allocationSamplingInterval() const { return m_allocationSamplingInterval; }
+    void sampleAllocation(Managed *object, int samples);
+    void resolvePendingAllocations();
+
 public slots:
     void stopProfiling();
     void startProfiling();
     void reportData();
     void setTimer(const QElapsedTimer &timer) { m_timer = timer; }
+    void setSamplingInterval(int usecs);
+    void setAllocationSamplingInterval(int bytes);
 
 signals:
+    // Emitted right before dataReady() if allocation sampling was active.
+    void allocationsReady(const QList<QV4::Profiling::AllocationSiteProperties> &);
     void dataReady(const QList<QV4::Profiling::FunctionCallProperties> &);
 
 private:
+    struct CallTreeNode {
+        Function *function;
+        int firstChild;
+        int nextSibling;
+        int totalSamples;
+    };
+
+    struct AllocationTreeNode {
+        Function *function;
+        const char *objectClass;
+        int firstChild;
+        int nextSibling;
+        int samples;
+    };
+
+    struct PendingAllocation {
+        Managed *object;
+        int node;
+        int samples;
+    };
+
+    void takeSample(ExecutionContext *ctx, Function *function);
+    void clearCallTree();
+    void reportCallTree(QList<FunctionCallProperties> &resolved, int node, qint64 start) const;
+
+    int allocationTreeChild(int node, Function *function, const char *objectClass);
+    void clearAllocationTree();
+    void reportAllocationTree(QList<AllocationSiteProperties> &resolved, int node, int depth,
+                              qint64 time) const;
+
+    ExecutionEngine *m_engine;
     QElapsedTimer m_timer;
     QVector<FunctionCall> m_data;
 
+    int m_samplingInterval; // in microseconds, 0 for tracing every call
+    QAtomicInt m_samplePending;
+    Sampler *m_sampler;
+    qint64 m_samplingStart;
+    QVector<CallTreeNode> m_callTree;
+
+    int m_allocationSamplingInterval; // in bytes, 0 for no allocation sampling
+    QVector<AllocationTreeNode> m_allocationTree;
+    QVector<PendingAllocation> m_pendingAllocations;
+
     friend class FunctionCallProfiler;
 };
 
@@ -147,6 +225,12 @@ public:
 
     static ReturnedValue profileCall(Profiler *profiler, ExecutionContext *ctx, Function *function)
     {
+        if (profiler->m_samplingInterval) {
+            if (profiler->m_samplePending.load())
+                profiler->takeSample(ctx, function);
+            return function->code(ctx, function->codeData);
+        }
+
         FunctionCallProfiler callProfiler(profiler, function);
         return function->code(ctx, function->codeData);
     }
@@ -161,9 +245,11 @@ public:
 } // namespace QV4
 
 Q_DECLARE_TYPEINFO(QV4::Profiling::FunctionCallProperties, Q_MOVABLE_TYPE);
+Q_DECLARE_TYPEINFO(QV4::Profiling::AllocationSiteProperties, Q_MOVABLE_TYPE);
 Q_DECLARE_TYPEINFO(QV4::Profiling::FunctionCall, Q_MOVABLE_TYPE);
 
 QT_END_NAMESPACE
 Q_DECLARE_METATYPE(QList<QV4::Profiling::FunctionCallProperties>)
+Q_DECLARE_METATYPE(QList<QV4::Profiling::AllocationSiteProperties>)
 
 #endif // QV4PROFILING_H
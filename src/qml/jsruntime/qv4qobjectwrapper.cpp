@@ -165,7 +165,7 @@ static QV4::ReturnedValue LoadProperty(QV8Engine *engine, QObject *object,
         ReadFunction(object, property, &rv, notifier);
         return QV4::QObjectWrapper::wrap(v4, rv);
     } else if (property.isQList()) {
-        return QmlListWrapper::create(engine, object, property.coreIndex, property.propType);
+        return QmlListWrapper::create(engine, object, property.coreIndex, property.propType, property.notifyIndex);
     } else if (property.propType == QMetaType::QReal) {
         qreal v = 0;
         ReadFunction(object, property, &v, notifier);
@@ -222,7 +222,7 @@ static QV4::ReturnedValue LoadProperty(QV8Engine *engine, QObject *object,
 
         // see if it's a sequence type
         bool succeeded = false;
-        QV4::ScopedValue retn(scope, QV4::SequencePrototype::newSequence(v4, property.propType, object, property.coreIndex, &succeeded));
+        QV4::ScopedValue retn(scope, QV4::SequencePrototype::newSequence(v4, property.propType, object, property.coreIndex, property.notifyIndex, &succeeded));
         if (succeeded)
             return retn.asReturnedValue();
     }
@@ -391,6 +391,13 @@ ReturnedValue QObjectWrapper::getProperty(QObject *object, ExecutionContext *ctx
         QQmlVMEMetaObject *vmemo = QQmlVMEMetaObject::get(object);
         Q_ASSERT(vmemo);
         return vmemo->vmeProperty(property->coreIndex);
+    } else if (property->isVMEProperty() && (property->propType == QMetaType::Int
+                                             || property->propType == QMetaType::Bool
+                                             || property->propType == QMetaType::Double)) {
+        // Read unboxed QML properties without a metacall
+        if (QQmlVMEMetaObject *vmemo = QQmlVMEMetaObject::get(object))
+            return vmemo->vmeUnboxedProperty(property->coreIndex);
+        return LoadProperty<ReadAccessor::Indirect>(ctx->engine->v8Engine, object, *property, 0);
     } else if (property->isDirect())  {
         return LoadProperty<ReadAccessor::Direct>(ctx->engine->v8Engine, object, *property, 0);
     } else {
@@ -632,6 +639,59 @@ ReturnedValue QObjectWrapper::getProperty(QObject *object, ExecutionContext *ctx
     return getProperty(object, ctx, property, captureRequired);
 }
 
+ReturnedValue QObjectWrapper::getPropertyViaAccessor(QObject *object, ExecutionContext *ctx, QQmlAccessors *accessors, qintptr accessorData,
+                                                    int propertyIndex, int notifyIndex, int propType, bool captureRequired)
+{
+    if (QQmlData::wasDeleted(object))
+        return QV4::Encode::null();
+    if (!QQmlData::get(object, /*create*/false))
+        return QV4::Encode::undefined();
+
+    QQmlData::flushPendingBinding(object, propertyIndex);
+
+    QQmlEnginePrivate *ep = ctx->engine->v8Engine->engine() ? QQmlEnginePrivate::get(ctx->engine->v8Engine->engine()) : 0;
+    QQmlNotifier *n = 0;
+
+    ReturnedValue result;
+    switch (propType) {
+    case QMetaType::Int: {
+        int v = 0;
+        accessors->read(object, accessorData, &v);
+        result = QV4::Encode(v);
+    } break;
+    case QMetaType::Bool: {
+        bool v = false;
+        accessors->read(object, accessorData, &v);
+        result = QV4::Encode(v);
+    } break;
+    case QMetaType::Float: {
+        float v = 0;
+        accessors->read(object, accessorData, &v);
+        result = QV4::Encode(double(v));
+    } break;
+    default: {
+        Q_ASSERT(propType == QMetaType::Double);
+        double v = 0;
+        accessors->read(object, accessorData, &v);
+        result = QV4::Encode(v);
+    } break;
+    }
+
+    if (captureRequired && ep) {
+        if (accessors->notifier) {
+            if (ep->propertyCapture) {
+                accessors->notifier(object, accessorData, &n);
+                if (n)
+                    ep->captureProperty(n);
+            }
+        } else {
+            ep->captureProperty(object, propertyIndex, notifyIndex);
+        }
+    }
+
+    return result;
+}
+
 void QObjectWrapper::setProperty(ExecutionContext *ctx, int propertyIndex, const ValueRef value)
 {
     if (QQmlData::wasDeleted(m_object))
@@ -1391,6 +1451,40 @@ static QV4::ReturnedValue CallPrecise(QObject *object, const QQmlPropertyData &d
     }
 }
 
+/*!
+    Computes a key for the overload cache from the kinds of the call arguments.
+    Returns false if an argument's match score depends on more than its kind
+    (see MatchScore()), in which case overload resolution cannot be cached.
+*/
+static bool OverloadSignature(QV4::CallData *callArgs, quint32 *signature)
+{
+    const int argc = callArgs->argc;
+    if (argc > 9)
+        return false;
+
+    quint32 s = quint32(argc) << 27;
+    for (int ii = 0; ii < argc; ++ii) {
+        const QV4::Value &v = callArgs->args[ii];
+        quint32 kind;
+        if (v.isNumber())
+            kind = 1;
+        else if (v.isString())
+            kind = 2;
+        else if (v.isBoolean())
+            kind = 3;
+        else if (v.isNull())
+            kind = 4;
+        else if (v.as<QV4::QObjectWrapper>())
+            kind = 5;
+        else
+            return false;
+        s |= kind << (3 * ii);
+    }
+
+    *signature = s;
+    return true;
+}
+
 /*!
 Resolve the overloaded method to call.  The algorithm works conceptually like this:
     1.  Resolve the set of overloads it is *possible* to call.
@@ -1403,10 +1497,23 @@ Resolve the overloaded method to call.  The algorithm works conceptually like th
     3.  Find the best remaining overload based on its match score.
         If two or more overloads have the same match score, call the last one.  The match
         score is constructed by adding the matchScore() result for each of the parameters.
+
+The result is remembered in the property cache, so calls with arguments of the same kinds
+go straight to the chosen overload.
 */
 static QV4::ReturnedValue CallOverloaded(QObject *object, const QQmlPropertyData &data,
                                             QV8Engine *engine, QV4::CallData *callArgs)
 {
+    quint32 signature = 0;
+    const bool cacheable = OverloadSignature(callArgs, &signature);
+    if (cacheable) {
+        int index = QQmlPropertyCache::cachedOverload(object, data.coreIndex, signature);
+        if (index != -1) {
+            if (const QQmlPropertyData *cached = QQmlData::get(object)->propertyCache->method(index))
+                return CallPrecise(object, *cached, engine, callArgs);
+        }
+    }
+
     int argumentCount = callArgs->argc;
 
     QQmlPropertyData best;
@@ -1468,6 +1575,8 @@ static QV4::ReturnedValue CallOverloaded(QObject *object, const QQmlPropertyData
     if (best.isValid()) {
         if (valueTypeObject)
             valueTypeObject->setValue(valueTypeValue);
+        if (cacheable)
+            QQmlPropertyCache::setCachedOverload(object, data.coreIndex, signature, best.coreIndex);
         return CallPrecise(object, best, engine, callArgs);
     } else {
         QString error = QLatin1String("Unable to determine callable overload.  Candidates are:");
@@ -1494,6 +1603,19 @@ CallArgument::~CallArgument()
 
 void CallArgument::cleanup()
 {
+    switch (type) {
+    case 0:
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::Bool:
+    case QMetaType::Double:
+    case QMetaType::Float:
+    case QMetaType::QObjectStar:
+        return;
+    default:
+        break;
+    }
+
     if (type == QMetaType::QString) {
         qstringPtr->~QString();
     } else if (type == -1 || type == QMetaType::QVariant) {
@@ -1523,23 +1645,33 @@ void *CallArgument::dataPtr()
 void CallArgument::initAsType(int callType)
 {
     if (type != 0) { cleanup(); type = 0; }
-    if (callType == QMetaType::UnknownType || callType == QMetaType::Void) return;
 
-    if (callType == qMetaTypeId<QJSValue>()) {
-        qjsValuePtr = new (&allocData) QJSValue();
-        type = callType;
-    } else if (callType == QMetaType::Int ||
-               callType == QMetaType::UInt ||
-               callType == QMetaType::Bool ||
-               callType == QMetaType::Double ||
-               callType == QMetaType::Float) {
+    switch (callType) {
+    case QMetaType::UnknownType:
+    case QMetaType::Void:
+        return;
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::Bool:
+    case QMetaType::Double:
+    case QMetaType::Float:
         type = callType;
-    } else if (callType == QMetaType::QObjectStar) {
+        return;
+    case QMetaType::QObjectStar:
         qobjectPtr = 0;
         type = callType;
-    } else if (callType == QMetaType::QString) {
+        return;
+    case QMetaType::QString:
         qstringPtr = new (&allocData) QString();
         type = callType;
+        return;
+    default:
+        break;
+    }
+
+    if (callType == qMetaTypeId<QJSValue>()) {
+        qjsValuePtr = new (&allocData) QJSValue();
+        type = callType;
     } else if (callType == QMetaType::QVariant) {
         type = callType;
         qvariantPtr = new (&allocData) QVariant();
@@ -1571,34 +1703,47 @@ void CallArgument::fromValue(int callType, QV8Engine *engine, const QV4::ValueRe
         type = 0;
     }
 
-    QV4::Scope scope(QV8Engine::getV4(engine));
-
-    bool queryEngine = false;
-    if (callType == qMetaTypeId<QJSValue>()) {
-        QV4::ExecutionEngine *v4 = QV8Engine::getV4(engine);
-        qjsValuePtr = new (&allocData) QJSValue(new QJSValuePrivate(v4, value));
-        type = qMetaTypeId<QJSValue>();
-    } else if (callType == QMetaType::Int) {
+    // The common primitive types are converted directly, without going
+    // through the meta type system
+    switch (callType) {
+    case QMetaType::Int:
         intValue = quint32(value->toInt32());
         type = callType;
-    } else if (callType == QMetaType::UInt) {
+        return;
+    case QMetaType::UInt:
         intValue = quint32(value->toUInt32());
         type = callType;
-    } else if (callType == QMetaType::Bool) {
+        return;
+    case QMetaType::Bool:
         boolValue = value->toBoolean();
         type = callType;
-    } else if (callType == QMetaType::Double) {
+        return;
+    case QMetaType::Double:
         doubleValue = double(value->toNumber());
         type = callType;
-    } else if (callType == QMetaType::Float) {
+        return;
+    case QMetaType::Float:
         floatValue = float(value->toNumber());
         type = callType;
-    } else if (callType == QMetaType::QString) {
+        return;
+    case QMetaType::QString:
         if (value->isNull() || value->isUndefined())
             qstringPtr = new (&allocData) QString();
         else
             qstringPtr = new (&allocData) QString(value->toQStringNoThrow());
         type = callType;
+        return;
+    default:
+        break;
+    }
+
+    QV4::Scope scope(QV8Engine::getV4(engine));
+
+    bool queryEngine = false;
+    if (callType == qMetaTypeId<QJSValue>()) {
+        QV4::ExecutionEngine *v4 = QV8Engine::getV4(engine);
+        qjsValuePtr = new (&allocData) QJSValue(new QJSValuePrivate(v4, value));
+        type = qMetaTypeId<QJSValue>();
     } else if (callType == QMetaType::QObjectStar) {
         qobjectPtr = 0;
         if (QV4::QObjectWrapper *qobjectWrapper = value->as<QV4::QObjectWrapper>())
@@ -1685,27 +1830,34 @@ void CallArgument::fromValue(int callType, QV8Engine *engine, const QV4::ValueRe
 QV4::ReturnedValue CallArgument::toValue(QV8Engine *engine)
 {
     QV4::ExecutionEngine *v4 = QV8Engine::getV4(engine);
-    QV4::Scope scope(v4);
 
-    if (type == qMetaTypeId<QJSValue>()) {
-        return QJSValuePrivate::get(*qjsValuePtr)->getValue(v4);
-    } else if (type == QMetaType::Int) {
+    switch (type) {
+    case QMetaType::Int:
         return QV4::Encode(int(intValue));
-    } else if (type == QMetaType::UInt) {
+    case QMetaType::UInt:
         return QV4::Encode((uint)intValue);
-    } else if (type == QMetaType::Bool) {
+    case QMetaType::Bool:
         return QV4::Encode(boolValue);
-    } else if (type == QMetaType::Double) {
+    case QMetaType::Double:
         return QV4::Encode(doubleValue);
-    } else if (type == QMetaType::Float) {
+    case QMetaType::Float:
         return QV4::Encode(floatValue);
-    } else if (type == QMetaType::QString) {
+    case QMetaType::QString:
         return engine->toString(*qstringPtr);
-    } else if (type == QMetaType::QObjectStar) {
+    case QMetaType::QObjectStar: {
         QObject *object = qobjectPtr;
         if (object)
             QQmlData::get(object, true)->setImplicitDestructible();
         return QV4::QObjectWrapper::wrap(v4, object);
+    }
+    default:
+        break;
+    }
+
+    QV4::Scope scope(v4);
+
+    if (type == qMetaTypeId<QJSValue>()) {
+        return QJSValuePrivate::get(*qjsValuePtr)->getValue(v4);
     } else if (type == qMetaTypeId<QList<QObject *> >()) {
         // XXX Can this be made more by using Array as a prototype and implementing
         // directly against QList<QObject*>?
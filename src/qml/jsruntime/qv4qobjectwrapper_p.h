@@ -71,6 +71,7 @@ class QObject;
 class QQmlData;
 class QQmlPropertyCache;
 class QQmlPropertyData;
+class QQmlAccessors;
 
 namespace QV4 {
 struct QObjectSlotDispatcher;
@@ -95,6 +96,9 @@ struct Q_QML_EXPORT QObjectWrapper : public QV4::Object
     using Object::get;
 
     static ReturnedValue getProperty(QObject *object, ExecutionContext *ctx, int propertyIndex, bool captureRequired);
+    // For properties resolved at compile time to an accessor of type int, bool, float or double.
+    static ReturnedValue getPropertyViaAccessor(QObject *object, ExecutionContext *ctx, QQmlAccessors *accessors, qintptr accessorData,
+                                                int propertyIndex, int notifyIndex, int propType, bool captureRequired);
     void setProperty(ExecutionContext *ctx, int propertyIndex, const ValueRef value);
 
 protected:
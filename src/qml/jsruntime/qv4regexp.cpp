@@ -42,9 +42,91 @@
 #include "qv4regexp_p.h"
 #include "qv4engine_p.h"
 #include "qv4scopedvalue_p.h"
+#include "qv4string_p.h"
+#include "qv4executableallocator_p.h"
+
+#include <QtCore/QCache>
+#include <QtCore/QMutex>
 
 using namespace QV4;
 
+#if ENABLE(YARR_JIT)
+namespace {
+
+// Compiling a pattern with the Yarr JIT is expensive, and applications with
+// several engines tend to use the same patterns in all of them. The generated
+// code is immutable and reentrant, so it is compiled once per process and kept
+// in an LRU cache. The interpreter bytecode stays per engine, as it allocates
+// from the engine's BumpPointerAllocator while matching.
+class SharedRegExpCodeCache
+{
+public:
+    SharedRegExpCodeCache()
+    {
+        bool ok = false;
+        int size = qgetenv("QV4_REGEXP_CODE_CACHE_SIZE").toInt(&ok);
+        cache.setMaxCost(ok && size >= 0 ? size : 256);
+    }
+
+    QMutex mutex;
+    // Declared before the cache, so it outlives all code it handed out
+    QV4::ExecutableAllocator allocator;
+    QCache<RegExpCacheKey, QExplicitlySharedDataPointer<RegExpJitCode> > cache;
+    RegExpCodeCacheStatistics statistics;
+};
+
+}
+
+Q_GLOBAL_STATIC(SharedRegExpCodeCache, sharedRegExpCodeCache)
+
+static QExplicitlySharedDataPointer<RegExpJitCode> sharedJitCode(JSC::Yarr::YarrPattern &yarrPattern, const RegExpCacheKey &key)
+{
+    SharedRegExpCodeCache *c = sharedRegExpCodeCache();
+    QMutexLocker locker(&c->mutex);
+
+    if (QExplicitlySharedDataPointer<RegExpJitCode> *code = c->cache.object(key)) {
+        ++c->statistics.hits;
+        return *code;
+    }
+
+    ++c->statistics.misses;
+    QExplicitlySharedDataPointer<RegExpJitCode> code(new RegExpJitCode);
+    JSC::JSGlobalData dummy(&c->allocator);
+    JSC::Yarr::jitCompile(yarrPattern, JSC::Yarr::Char16, &dummy, code->code);
+
+    if (c->cache.maxCost() > 0 && c->cache.size() >= c->cache.maxCost())
+        ++c->statistics.evictions;
+    c->cache.insert(key, new QExplicitlySharedDataPointer<RegExpJitCode>(code));
+    return code;
+}
+#endif
+
+RegExpCodeCacheStatistics RegExp::sharedCodeCacheStatistics()
+{
+#if ENABLE(YARR_JIT)
+    SharedRegExpCodeCache *c = sharedRegExpCodeCache();
+    QMutexLocker locker(&c->mutex);
+    RegExpCodeCacheStatistics statistics = c->statistics;
+    statistics.entries = c->cache.size();
+    return statistics;
+#else
+    return RegExpCodeCacheStatistics();
+#endif
+}
+
+int RegExp::clearSharedCodeCache()
+{
+#if ENABLE(YARR_JIT)
+    SharedRegExpCodeCache *c = sharedRegExpCodeCache();
+    QMutexLocker locker(&c->mutex);
+    const int entries = c->cache.size();
+    c->cache.clear();
+    return entries;
+#else
+    return 0;
+#endif
+}
+
 RegExpCache::~RegExpCache()
 {
     for (RegExpCache::Iterator it = begin(), e = end();
@@ -63,13 +145,33 @@ uint RegExp::match(const QString &string, int start, uint *matchOffsets)
     WTF::String s(string);
 
 #if ENABLE(YARR_JIT)
-    if (!m_jitCode.isFallBack() && m_jitCode.has16BitCode())
-        return m_jitCode.execute(s.characters16(), start, s.length(), (int*)matchOffsets).start;
+    if (m_jitCode && !m_jitCode->code.isFallBack() && m_jitCode->code.has16BitCode())
+        return m_jitCode->code.execute(s.characters16(), start, s.length(), (int*)matchOffsets).start;
 #endif
 
     return JSC::Yarr::interpret(m_byteCode.get(), s.characters16(), string.length(), start, matchOffsets);
 }
 
+// One byte strings are matched as they are by the interpreter. The JIT code is only generated
+// for UTF-16, so where it is available the string gets widened instead.
+uint RegExp::match(const String *string, int start, uint *matchOffsets)
+{
+    if (!isValid())
+        return JSC::Yarr::offsetNoMatch;
+
+#if ENABLE(YARR_JIT)
+    const bool useJit = m_jitCode && !m_jitCode->code.isFallBack() && m_jitCode->code.has16BitCode();
+#else
+    const bool useJit = false;
+#endif
+    if (!useJit && string->isLatin1()) {
+        return JSC::Yarr::interpret(m_byteCode.get(), reinterpret_cast<const LChar *>(string->latin1Data()),
+                                    string->length(), start, matchOffsets);
+    }
+
+    return match(string->toQString(), start, matchOffsets);
+}
+
 RegExp* RegExp::create(ExecutionEngine* engine, const QString& pattern, bool ignoreCase, bool multiline)
 {
     RegExpCacheKey key(pattern, ignoreCase, multiline);
@@ -108,10 +210,8 @@ RegExp::RegExp(ExecutionEngine* engine, const QString &pattern, bool ignoreCase,
     m_subPatternCount = yarrPattern.m_numSubpatterns;
     m_byteCode = JSC::Yarr::byteCompile(yarrPattern, engine->bumperPointerAllocator);
 #if ENABLE(YARR_JIT)
-    if (!yarrPattern.m_containsBackreferences && engine->iselFactory->jitCompileRegexps()) {
-        JSC::JSGlobalData dummy(engine->regExpAllocator);
-        JSC::Yarr::jitCompile(yarrPattern, JSC::Yarr::Char16, &dummy, m_jitCode);
-    }
+    if (!yarrPattern.m_containsBackreferences && engine->iselFactory->jitCompileRegexps())
+        m_jitCode = sharedJitCode(yarrPattern, RegExpCacheKey(pattern, ignoreCase, multiline));
 #endif
 }
 
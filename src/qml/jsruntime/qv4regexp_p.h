@@ -43,6 +43,7 @@
 
 #include <QString>
 #include <QVector>
+#include <QSharedData>
 
 #include <wtf/RefPtr.h>
 #include <wtf/FastAllocBase.h>
@@ -62,6 +63,7 @@ QT_BEGIN_NAMESPACE
 namespace QV4 {
 
 struct ExecutionEngine;
+struct String;
 
 struct RegExpCacheKey
 {
@@ -91,6 +93,24 @@ public:
     ~RegExpCache();
 };
 
+#if ENABLE(YARR_JIT)
+// JIT code for a pattern, shared by all engines in the process
+struct RegExpJitCode : public QSharedData
+{
+    JSC::Yarr::YarrCodeBlock code;
+};
+#endif
+
+struct RegExpCodeCacheStatistics
+{
+    RegExpCodeCacheStatistics() : hits(0), misses(0), evictions(0), entries(0) {}
+
+    int hits;
+    int misses;
+    int evictions;
+    int entries;
+};
+
 class RegExp : public Managed
 {
     V4_MANAGED
@@ -104,11 +124,16 @@ public:
     bool isValid() const { return m_byteCode.get(); }
 
     uint match(const QString& string, int start, uint *matchOffsets);
+    uint match(const String *string, int start, uint *matchOffsets);
 
     bool ignoreCase() const { return m_ignoreCase; }
     bool multiLine() const { return m_multiLine; }
     int captureCount() const { return m_subPatternCount + 1; }
 
+    static RegExpCodeCacheStatistics sharedCodeCacheStatistics();
+    // Drops the JIT code no live regular expression uses anymore. Returns the number of entries dropped.
+    static int clearSharedCodeCache();
+
 protected:
     static void destroy(Managed *that);
     static void markObjects(Managed *that, QV4::ExecutionEngine *e);
@@ -121,7 +146,7 @@ private:
     const QString m_pattern;
     OwnPtr<JSC::Yarr::BytecodePattern> m_byteCode;
 #if ENABLE(YARR_JIT)
-    JSC::Yarr::YarrCodeBlock m_jitCode;
+    QExplicitlySharedDataPointer<RegExpJitCode> m_jitCode;
 #endif
     RegExpCache *m_cache;
     int m_subPatternCount;
@@ -363,16 +363,16 @@ ReturnedValue RegExpPrototype::method_exec(CallContext *ctx)
     arg = RuntimeHelpers::toString(ctx, arg);
     if (scope.hasException())
         return Encode::undefined();
-    QString s = arg->stringValue()->toQString();
+    String *input = arg->stringValue();
 
     int offset = r->global ? r->lastIndexProperty(ctx)->value.toInt32() : 0;
-    if (offset < 0 || offset > s.length()) {
+    if (offset < 0 || offset > input->length()) {
         r->lastIndexProperty(ctx)->value = Primitive::fromInt32(0);
         return Encode::null();
     }
 
     uint* matchOffsets = (uint*)alloca(r->value->captureCount() * 2 * sizeof(uint));
-    const int result = r->value->match(s, offset, matchOffsets);
+    const int result = r->value->match(input, offset, matchOffsets);
 
     Scoped<RegExpCtor> regExpCtor(scope, ctx->engine->regExpCtor);
     regExpCtor->clearLastMatch();
@@ -387,10 +387,18 @@ ReturnedValue RegExpPrototype::method_exec(CallContext *ctx)
     int len = r->value->captureCount();
     array->arrayReserve(len);
     ScopedValue v(scope);
+    // Captures of one byte strings stay one byte strings
+    const bool latin1 = input->isLatin1();
+    const QString s = latin1 ? QString() : input->toQString();
     for (int i = 0; i < len; ++i) {
         int start = matchOffsets[i * 2];
         int end = matchOffsets[i * 2 + 1];
-        v = (start != -1 && end != -1) ? ctx->engine->newString(s.mid(start, end - start))->asReturnedValue() : Encode::undefined();
+        if (start == -1 || end == -1)
+            v = Encode::undefined();
+        else if (latin1)
+            v = ctx->engine->newCompactString(QLatin1String(input->latin1Data() + start, end - start));
+        else
+            v = ctx->engine->newString(s.mid(start, end - start));
         array->arrayPut(i, v);
     }
     array->setArrayLengthUnchecked(len);
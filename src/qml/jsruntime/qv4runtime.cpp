@@ -47,9 +47,12 @@
 #include "qv4objectproto_p.h"
 #include "qv4globalobject_p.h"
 #include "qv4stringobject_p.h"
+#include "qv4mathobject_p.h"
+#include "qv4dateobject_p.h"
 #include "qv4argumentsobject_p.h"
 #include "qv4lookup_p.h"
 #include "qv4function_p.h"
+#include "qv4debugging_p.h"
 #include "private/qlocale_tools_p.h"
 #include "qv4scopedvalue_p.h"
 #include <private/qqmlcontextwrapper_p.h>
@@ -949,6 +952,64 @@ ReturnedValue Runtime::callPropertyLookup(ExecutionContext *context, uint index,
     return v.objectValue()->call(callData);
 }
 
+// The JIT inlines calls to a few builtins. Before it takes the inline path it asks
+// whether the called property still holds the original builtin. No getters are run,
+// so any access it cannot answer directly is left to the regular call.
+Bool Runtime::isIntrinsicCall(NoThrowContext *ctx, const StringRef name, CallDataRef callData, int intrinsic)
+{
+    Object *o;
+    ReturnedValue (*code)(CallContext *);
+    switch (intrinsic) {
+    case Intrinsic_MathAbs: code = MathObject::method_abs; break;
+    case Intrinsic_MathFloor: code = MathObject::method_floor; break;
+    case Intrinsic_MathSqrt: code = MathObject::method_sqrt; break;
+    case Intrinsic_MathMin: code = MathObject::method_min; break;
+    case Intrinsic_MathMax: code = MathObject::method_max; break;
+    case Intrinsic_StringCharCodeAt: code = StringPrototype::method_charCodeAt; break;
+    case Intrinsic_DateNow: code = DatePrototype::method_now; break;
+    default: return false;
+    }
+
+    if (intrinsic == Intrinsic_StringCharCodeAt) {
+        if (!callData->thisObject.isString())
+            return false;
+        o = ctx->engine->stringObjectClass->prototype;
+    } else {
+        o = callData->thisObject.asObject();
+        if (!o)
+            return false;
+        if (intrinsic == Intrinsic_DateNow ? !o->as<DateCtor>() : !o->as<MathObject>())
+            return false;
+    }
+
+    uint idx = o->internalClass->find(name);
+    if (idx == UINT_MAX || o->internalClass->propertyData.at(idx).isAccessor())
+        return false;
+    BuiltinFunction *f = o->memberData[idx].as<BuiltinFunction>();
+    return f && f->code == code;
+}
+
+ReturnedValue Runtime::stringCharCodeAt(ExecutionContext *ctx, CallDataRef callData)
+{
+    Q_ASSERT(callData->thisObject.isString());
+    int pos = 0;
+    if (callData->argc > 0)
+        pos = (int) callData->args[0].toInteger();
+    if (ctx->engine->hasException)
+        return Encode::undefined();
+
+    const QString str = callData->thisObject.stringValue()->toQString();
+    if (pos >= 0 && pos < str.length())
+        return Encode(str.at(pos).unicode());
+
+    return Encode(qSNaN());
+}
+
+ReturnedValue Runtime::dateNow(NoThrowContext *)
+{
+    return Encode(DatePrototype::currentTime());
+}
+
 ReturnedValue Runtime::callElement(ExecutionContext *context, const ValueRef index, CallDataRef callData)
 {
     Scope scope(context);
@@ -1140,7 +1201,8 @@ ReturnedValue Runtime::arrayLiteral(ExecutionContext *ctx, Value *values, uint l
     Scoped<ArrayObject> a(scope, ctx->engine->newArrayObject());
 
     if (length) {
-        a->arrayReserve(length);
+        if (!PackedArrayData::create(a.getPointer(), values, length))
+            a->arrayReserve(length);
         a->arrayPut(0, values, length);
         a->setArrayLengthUnchecked(length);
     }
@@ -1192,6 +1254,42 @@ QV4::ReturnedValue Runtime::setupArgumentsObject(ExecutionContext *ctx)
     return (new (c->engine->memoryManager) ArgumentsObject(c))->asReturnedValue();
 }
 
+// Functions that only read arguments.length and arguments[i] never materialize the
+// arguments object; the compiler emits these two calls instead, which read straight
+// out of the call data and behave like the corresponding ArgumentsObject lookups.
+QV4::ReturnedValue Runtime::argumentsLength(ExecutionContext *ctx)
+{
+    assert(ctx->type >= ExecutionContext::Type_SimpleCallContext);
+    CallContext *c = static_cast<CallContext *>(ctx);
+    return Encode(c->realArgumentCount);
+}
+
+QV4::ReturnedValue Runtime::argumentAt(ExecutionContext *ctx, const ValueRef index)
+{
+    assert(ctx->type >= ExecutionContext::Type_SimpleCallContext);
+    CallContext *c = static_cast<CallContext *>(ctx);
+    ExecutionEngine *engine = ctx->engine;
+
+    uint idx = index->asArrayIndex();
+    if (idx < (uint)c->realArgumentCount)
+        return c->callData->args[idx].asReturnedValue();
+    if (idx != UINT_MAX)
+        return engine->objectClass->prototype->getIndexed(idx);
+
+    Scope scope(ctx);
+    ScopedString name(scope, index->toString(ctx));
+    if (scope.hasException())
+        return Encode::undefined();
+    if (name->equals(engine->id_length))
+        return Encode(c->realArgumentCount);
+    if (name->equals(engine->id_callee) || (c->strictMode && name->equals(engine->id_caller))) {
+        if (c->strictMode)
+            return ctx->throwTypeError();
+        return c->function->asReturnedValue();
+    }
+    return engine->objectClass->prototype->get(name);
+}
+
 #endif // V4_BOOTSTRAP
 
 QV4::ReturnedValue Runtime::increment(const QV4::ValueRef value)
@@ -1278,9 +1376,9 @@ ReturnedValue Runtime::regexpLiteral(ExecutionContext *ctx, int id)
     return ctx->compilationUnit->runtimeRegularExpressions[id].asReturnedValue();
 }
 
-ReturnedValue Runtime::getQmlIdArray(NoThrowContext *ctx)
+ReturnedValue Runtime::getQmlIdObject(NoThrowContext *ctx, int index)
 {
-    return ctx->engine->qmlContextObject()->getPointer()->as<QmlContextWrapper>()->idObjectsArray();
+    return ctx->engine->qmlContextObject()->getPointer()->as<QmlContextWrapper>()->idObject(index);
 }
 
 ReturnedValue Runtime::getQmlContextObject(NoThrowContext *ctx)
@@ -1309,6 +1407,27 @@ ReturnedValue Runtime::getQmlQObjectProperty(ExecutionContext *ctx, const ValueR
     return QV4::QObjectWrapper::getProperty(wrapper->object(), ctx, propertyIndex, captureRequired);
 }
 
+QV4::ReturnedValue Runtime::getQmlQObjectPropertyViaAccessor(ExecutionContext *ctx, const ValueRef object, QQmlAccessors *accessors,
+                                                             qintptr accessorData, int propertyIndex, int flags)
+{
+    QObjectWrapper *wrapper = object->as<QObjectWrapper>();
+    if (!wrapper) {
+        ctx->throwTypeError(QStringLiteral("Cannot read property of null"));
+        return Encode::undefined();
+    }
+
+    int propType;
+    switch (flags & AccessorReadTypeMask) {
+    case AccessorReadsInt: propType = QMetaType::Int; break;
+    case AccessorReadsBool: propType = QMetaType::Bool; break;
+    case AccessorReadsFloat: propType = QMetaType::Float; break;
+    default: propType = QMetaType::Double; break;
+    }
+    const int notifyIndex = (flags >> AccessorNotifyIndexShift) - 1;
+    return QV4::QObjectWrapper::getPropertyViaAccessor(wrapper->object(), ctx, accessors, accessorData, propertyIndex,
+                                                       notifyIndex, propType, flags & AccessorCaptureRequired);
+}
+
 QV4::ReturnedValue Runtime::getQmlAttachedProperty(ExecutionContext *ctx, int attachedPropertiesId, int propertyIndex)
 {
     Scope scope(ctx);
@@ -1357,6 +1476,12 @@ void Runtime::convertThisToObject(ExecutionContext *ctx)
     }
 }
 
+void Runtime::maybeBreakAtInstruction(ExecutionContext *ctx)
+{
+    if (Debugging::Debugger *debugger = ctx->engine->debugger)
+        debugger->maybeBreakAtInstruction();
+}
+
 #endif // V4_BOOTSTRAP
 
 } // namespace QV4
@@ -60,6 +60,8 @@
 
 QT_BEGIN_NAMESPACE
 
+class QQmlAccessors;
+
 #undef QV4_COUNT_RUNTIME_FUNCTIONS
 
 namespace QV4 {
@@ -104,6 +106,17 @@ struct NoThrowContext : public ExecutionContext
 };
 
 struct Q_QML_PRIVATE_EXPORT Runtime {
+    // builtins the JIT can inline at call sites
+    enum Intrinsic {
+        Intrinsic_MathAbs,
+        Intrinsic_MathFloor,
+        Intrinsic_MathSqrt,
+        Intrinsic_MathMin,
+        Intrinsic_MathMax,
+        Intrinsic_StringCharCodeAt,
+        Intrinsic_DateNow
+    };
+
     // call
     static ReturnedValue callGlobalLookup(ExecutionContext *context, uint index, CallDataRef callData);
     static ReturnedValue callActivationProperty(ExecutionContext *, const StringRef name, CallDataRef callData);
@@ -111,6 +124,9 @@ struct Q_QML_PRIVATE_EXPORT Runtime {
     static ReturnedValue callPropertyLookup(ExecutionContext *context, uint index, CallDataRef callData);
     static ReturnedValue callElement(ExecutionContext *context, const ValueRef index, CallDataRef callData);
     static ReturnedValue callValue(ExecutionContext *context, const ValueRef func, CallDataRef callData);
+    static Bool isIntrinsicCall(NoThrowContext *ctx, const StringRef name, CallDataRef callData, int intrinsic);
+    static ReturnedValue stringCharCodeAt(ExecutionContext *ctx, CallDataRef callData);
+    static ReturnedValue dateNow(NoThrowContext *ctx);
 
     // construct
     static ReturnedValue constructGlobalLookup(ExecutionContext *context, uint index, CallDataRef callData);
@@ -151,8 +167,13 @@ struct Q_QML_PRIVATE_EXPORT Runtime {
     // function header
     static void declareVar(ExecutionContext *ctx, bool deletable, const StringRef name);
     static ReturnedValue setupArgumentsObject(ExecutionContext *ctx);
+    static ReturnedValue argumentsLength(ExecutionContext *ctx);
+    static ReturnedValue argumentAt(ExecutionContext *ctx, const ValueRef index);
     static void convertThisToObject(ExecutionContext *ctx);
 
+    // debugging
+    static void maybeBreakAtInstruction(ExecutionContext *ctx);
+
     // literals
     static ReturnedValue arrayLiteral(ExecutionContext *ctx, Value *values, uint length);
     static ReturnedValue objectLiteral(ExecutionContext *ctx, const Value *args, int classId, int arrayValueCount, int arrayGetterSetterCountAndFlags);
@@ -222,13 +243,24 @@ struct Q_QML_PRIVATE_EXPORT Runtime {
     static unsigned doubleToUInt(const double &d);
 
     // qml
-    static ReturnedValue getQmlIdArray(NoThrowContext *ctx);
+    static ReturnedValue getQmlIdObject(NoThrowContext *ctx, int index);
     static ReturnedValue getQmlImportedScripts(NoThrowContext *ctx);
     static ReturnedValue getQmlContextObject(NoThrowContext *ctx);
     static ReturnedValue getQmlScopeObject(NoThrowContext *ctx);
     static ReturnedValue getQmlSingleton(NoThrowContext *ctx, const StringRef name);
     static ReturnedValue getQmlAttachedProperty(ExecutionContext *ctx, int attachedPropertiesId, int propertyIndex);
     static ReturnedValue getQmlQObjectProperty(ExecutionContext *ctx, const ValueRef object, int propertyIndex, bool captureRequired);
+    enum QObjectAccessorFlags {
+        AccessorReadsInt = 0,
+        AccessorReadsBool = 1,
+        AccessorReadsFloat = 2,
+        AccessorReadsDouble = 3,
+        AccessorReadTypeMask = 3,
+        AccessorCaptureRequired = 4,
+        AccessorNotifyIndexShift = 3 // the remaining bits hold notifyIndex + 1
+    };
+    static ReturnedValue getQmlQObjectPropertyViaAccessor(ExecutionContext *ctx, const ValueRef object, QQmlAccessors *accessors,
+                                                          qintptr accessorData, int propertyIndex, int flags);
     static void setQmlQObjectProperty(ExecutionContext *ctx, const ValueRef object, int propertyIndex, const ValueRef value);
 };
 
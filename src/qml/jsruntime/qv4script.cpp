@@ -55,6 +55,7 @@
 #include <qv4jsir_p.h>
 #include <qv4codegen_p.h>
 #include <private/qqmlcontextwrapper_p.h>
+#include <private/qv4isel_moth_p.h>
 
 #include <QtCore/QDebug>
 #include <QtCore/QString>
@@ -194,7 +195,7 @@ DEFINE_OBJECT_VTABLE(CompilationUnitHolder);
 
 Script::Script(ExecutionEngine *v4, ObjectRef qml, CompiledData::CompilationUnit *compilationUnit)
     : line(0), column(0), scope(v4->rootContext), strictMode(false), inheritContext(true), parsed(false)
-    , qml(qml.asReturnedValue()), vmFunction(0), parseAsBinding(true)
+    , qml(qml.asReturnedValue()), vmFunction(0), parseAsBinding(true), useDiskCache(false)
 {
     parsed = true;
 
@@ -212,6 +213,18 @@ Script::~Script()
 {
 }
 
+// Everything the generated code depends on besides the engine build.
+static QByteArray scriptCacheKey(const Script *script)
+{
+    QByteArray key = script->sourceCode.toUtf8();
+    key += '\0';
+    key += QByteArray::number(script->line);
+    key += script->strictMode ? "s" : "n";
+    key += script->parseAsBinding ? "b" : "p";
+    key += script->inheritContext ? "i" : "o";
+    return key;
+}
+
 void Script::parse()
 {
     if (parsed)
@@ -226,6 +239,29 @@ void Script::parse()
 
     MemoryManager::GCBlocker gcBlocker(v4->memoryManager);
 
+    // Inherited locals would be compiled into the code, so only global code is cached.
+    static const bool diskCacheDisabled = !qgetenv("QML_DISABLE_DISK_CACHE").isEmpty();
+    const bool cacheUnit = useDiskCache && !diskCacheDisabled && v4->diskCacheEnabled && !v4->debugger
+            && !sourceFile.isEmpty() && !scope->asCallContext();
+    QByteArray cacheKey;
+    if (cacheUnit) {
+        cacheKey = scriptCacheKey(this);
+        if (CompiledData::CompilationUnit *unit = v4->iselFactory->createUnitForLoading()) {
+            unit->ref();
+            QString error;
+            if (unit->loadScriptFromDisk(sourceFile, cacheKey, &error)) {
+                vmFunction = unit->linkToEngine(v4);
+                ScopedValue holder(valueScope, new (v4->memoryManager) CompilationUnitHolder(v4, unit));
+                compilationUnitHolder = holder.asReturnedValue();
+                unit->deref();
+                return;
+            }
+            unit->deref();
+        } else {
+            cacheKey.clear();
+        }
+    }
+
     IR::Module module(v4->debugger != 0);
 
     QQmlJS::Engine ee, *engine = &ee;
@@ -268,11 +304,34 @@ void Script::parse()
         if (v4->hasException)
             return;
 
+        // Scripts that run in a context of their own start out in the interpreter when tiered
+        // execution is enabled.
+        // Only interpreter bytecode can be stored in the disk cache.
+        static Moth::ISelFactory interpreterFactory;
+        const bool tiered = v4->interpreterISelFactory && !inheritContext && cacheKey.isEmpty();
+        EvalISelFactory *iselFactory = tiered ? v4->interpreterISelFactory.data()
+                                              : !cacheKey.isEmpty() ? &interpreterFactory
+                                                                    : v4->iselFactory.data();
+
         QV4::Compiler::JSUnitGenerator jsGenerator(&module);
-        QScopedPointer<EvalInstructionSelection> isel(v4->iselFactory->create(QQmlEnginePrivate::get(v4), v4->executableAllocator, &module, &jsGenerator));
+        QScopedPointer<EvalInstructionSelection> isel(iselFactory->create(QQmlEnginePrivate::get(v4), v4->executableAllocator, &module, &jsGenerator));
         if (inheritContext)
             isel->setUseFastLookups(false);
         QV4::CompiledData::CompilationUnit *compilationUnit = isel->compile();
+        if (tiered) {
+            CompiledData::CompilationUnit::TierUpSource *source = new CompiledData::CompilationUnit::TierUpSource;
+            source->sourceCode = sourceCode;
+            source->line = line;
+            source->qmlMode = parseAsBinding;
+            source->strictMode = strictMode;
+            source->useFastLookups = true;
+            compilationUnit->tierUpSource = source;
+        }
+        if (!cacheKey.isEmpty()) {
+            QString error;
+            if (!compilationUnit->saveScriptToDisk(sourceFile, cacheKey, &error))
+                qWarning() << "Error saving cached version of" << sourceFile << "to disk:" << error;
+        }
         vmFunction = compilationUnit->linkToEngine(v4);
         ScopedValue holder(valueScope, new (v4->memoryManager) CompilationUnitHolder(v4, compilationUnit));
         compilationUnitHolder = holder.asReturnedValue();
@@ -342,7 +401,7 @@ Function *Script::function()
     return vmFunction;
 }
 
-QV4::CompiledData::CompilationUnit *Script::precompile(IR::Module *module, Compiler::JSUnitGenerator *unitGenerator, ExecutionEngine *engine, const QUrl &url, const QString &source, QList<QQmlError> *reportedErrors)
+QV4::CompiledData::CompilationUnit *Script::precompile(IR::Module *module, Compiler::JSUnitGenerator *unitGenerator, ExecutionEngine *engine, const QUrl &url, const QString &source, QList<QQmlError> *reportedErrors, EvalISelFactory *iselFactory)
 {
     using namespace QQmlJS;
     using namespace QQmlJS::AST;
@@ -392,9 +451,83 @@ QV4::CompiledData::CompilationUnit *Script::precompile(IR::Module *module, Compi
         return 0;
     }
 
-    QScopedPointer<EvalInstructionSelection> isel(engine->iselFactory->create(QQmlEnginePrivate::get(engine), engine->executableAllocator, module, unitGenerator));
+    const bool tiered = !iselFactory && engine->interpreterISelFactory;
+    if (!iselFactory)
+        iselFactory = tiered ? engine->interpreterISelFactory.data() : engine->iselFactory.data();
+    QScopedPointer<EvalInstructionSelection> isel(iselFactory->create(QQmlEnginePrivate::get(engine), engine->executableAllocator, module, unitGenerator));
     isel->setUseFastLookups(false);
-    return isel->compile(/*generate unit data*/false);
+    QV4::CompiledData::CompilationUnit *compilationUnit = isel->compile(/*generate unit data*/false);
+    if (tiered) {
+        CompiledData::CompilationUnit::TierUpSource *tierUpSource = new CompiledData::CompilationUnit::TierUpSource;
+        tierUpSource->sourceCode = source;
+        tierUpSource->line = 1;
+        tierUpSource->qmlMode = true;
+        tierUpSource->strictMode = false;
+        tierUpSource->useFastLookups = false;
+        compilationUnit->tierUpSource = tierUpSource;
+    }
+    return compilationUnit;
+}
+
+// Calls the JIT compiled counterpart of an interpreted function, passed as code data.
+static ReturnedValue callTieredFunction(ExecutionContext *ctx, const uchar *data)
+{
+    Function *tiered = reinterpret_cast<Function *>(const_cast<uchar *>(data));
+    ctx->compilationUnit = tiered->compilationUnit;
+    ctx->lookups = tiered->compilationUnit->runtimeLookups;
+    return tiered->code(ctx, tiered->codeData);
+}
+
+// Recompiles an interpreted unit with the engine's JIT and redirects all of its functions to
+// the compiled code. Executions already running in the interpreter finish there, as there is
+// no on-stack replacement; their next invocation runs JIT code.
+void Script::tierUp(CompiledData::CompilationUnit *unit)
+{
+    using namespace QQmlJS;
+
+    QScopedPointer<CompiledData::CompilationUnit::TierUpSource> source(unit->tierUpSource);
+    unit->tierUpSource = 0;
+    ExecutionEngine *v4 = unit->engine;
+    if (!source || !v4 || unit->tieredUnit)
+        return;
+
+    MemoryManager::GCBlocker gcBlocker(v4->memoryManager);
+
+    QQmlJS::Engine ee;
+    Lexer lexer(&ee);
+    lexer.setCode(source->sourceCode, source->line, source->qmlMode);
+    Parser parser(&ee);
+    if (!parser.parseProgram())
+        return;
+    AST::Program *program = AST::cast<AST::Program *>(parser.rootNode());
+    if (!program)
+        return;
+
+    IR::Module module(/*debugMode*/false);
+    QQmlJS::Codegen cg(source->strictMode);
+    cg.generateFromProgram(unit->fileName(), source->sourceCode, program, &module, QQmlJS::Codegen::EvalCode);
+    if (!cg.qmlErrors().isEmpty())
+        return;
+
+    QV4::Compiler::JSUnitGenerator jsGenerator(&module);
+    QScopedPointer<EvalInstructionSelection> isel(v4->iselFactory->create(QQmlEnginePrivate::get(v4), v4->executableAllocator, &module, &jsGenerator));
+    isel->setUseFastLookups(source->useFastLookups);
+    CompiledData::CompilationUnit *jitUnit = isel->compile();
+    if (jitUnit->data->functionTableSize != unit->data->functionTableSize) {
+        delete jitUnit;
+        return;
+    }
+    jitUnit->linkToEngine(v4);
+    jitUnit->ref();
+    unit->tieredUnit = jitUnit;
+
+    for (int i = 0; i < unit->runtimeFunctions.size(); ++i) {
+        if (i == static_cast<int>(unit->data->indexOfRootFunction))
+            continue;
+        Function *f = unit->runtimeFunctions[i];
+        f->codeData = reinterpret_cast<const uchar *>(jitUnit->runtimeFunctions.at(i));
+        f->code = callTieredFunction;
+    }
 }
 
 ReturnedValue Script::qmlBinding()
@@ -78,11 +78,11 @@ struct Q_QML_EXPORT Script {
     Script(ExecutionContext *scope, const QString &sourceCode, const QString &source = QString(), int line = 1, int column = 0)
         : sourceFile(source), line(line), column(column), sourceCode(sourceCode)
         , scope(scope), strictMode(false), inheritContext(false), parsed(false)
-        , vmFunction(0), parseAsBinding(false) {}
+        , vmFunction(0), parseAsBinding(false), useDiskCache(false) {}
     Script(ExecutionEngine *engine, ObjectRef qml, const QString &sourceCode, const QString &source = QString(), int line = 1, int column = 0)
         : sourceFile(source), line(line), column(column), sourceCode(sourceCode)
         , scope(engine->rootContext), strictMode(false), inheritContext(true), parsed(false)
-        , qml(qml.asReturnedValue()), vmFunction(0), parseAsBinding(true) {}
+        , qml(qml.asReturnedValue()), vmFunction(0), parseAsBinding(true), useDiskCache(false) {}
     Script(ExecutionEngine *engine, ObjectRef qml, CompiledData::CompilationUnit *compilationUnit);
     ~Script();
     QString sourceFile;
@@ -97,6 +97,9 @@ struct Q_QML_EXPORT Script {
     QV4::PersistentValue compilationUnitHolder;
     Function *vmFunction;
     bool parseAsBinding;
+    // Keep the compiled script in the disk cache, keyed by sourceFile. Only takes effect for
+    // scripts with a file name that run in the global context, without the debugger.
+    bool useDiskCache;
 
     void parse();
     ReturnedValue run();
@@ -104,9 +107,11 @@ struct Q_QML_EXPORT Script {
 
     Function *function();
 
-    static QV4::CompiledData::CompilationUnit *precompile(IR::Module *module, Compiler::JSUnitGenerator *unitGenerator, ExecutionEngine *engine, const QUrl &url, const QString &source, QList<QQmlError> *reportedErrors = 0);
+    static QV4::CompiledData::CompilationUnit *precompile(IR::Module *module, Compiler::JSUnitGenerator *unitGenerator, ExecutionEngine *engine, const QUrl &url, const QString &source, QList<QQmlError> *reportedErrors = 0, EvalISelFactory *iselFactory = 0);
 
     static ReturnedValue evaluate(ExecutionEngine *engine, const QString &script, ObjectRef scopeObject);
+
+    static void tierUp(CompiledData::CompilationUnit *unit);
 };
 
 }
@@ -46,6 +46,7 @@
 #include <private/qv4functionobject_p.h>
 #include <private/qv4arrayobject_p.h>
 #include <private/qqmlengine_p.h>
+#include <private/qqmlnotifier_p.h>
 #include <private/qv4scopedvalue_p.h>
 #include <private/qv4internalclass_p.h>
 
@@ -162,6 +163,21 @@ template <> bool convertValueToElement(const ValueRef value)
     return value->toBoolean();
 }
 
+// Tracks whether the container cached by a reference sequence is still
+// current, by listening to the notify signal of the property it was read from.
+class QQmlSequenceReferenceEndpoint : public QQmlNotifierEndpoint
+{
+public:
+    QQmlSequenceReferenceEndpoint() : isValid(false) { setCallback(QV4SequenceReference); }
+
+    bool isValid;
+};
+
+void QV4SequenceReference_callback(QQmlNotifierEndpoint *e, void **)
+{
+    static_cast<QQmlSequenceReferenceEndpoint *>(e)->isValid = false;
+}
+
 template <typename Container>
 class QQmlSequence : public QV4::Object
 {
@@ -182,7 +198,7 @@ public:
         init();
     }
 
-    QQmlSequence(QV4::ExecutionEngine *engine, QObject *object, int propertyIndex)
+    QQmlSequence(QV4::ExecutionEngine *engine, QObject *object, int propertyIndex, int notifyIndex)
         : QV4::Object(InternalClass::create(engine, staticVTable(), engine->sequencePrototype.asObject()))
         , m_object(object)
         , m_propertyIndex(propertyIndex)
@@ -192,6 +208,11 @@ public:
         QV4::ScopedObject protectThis(scope, this);
         Q_UNUSED(protectThis);
         setArrayType(ArrayData::Custom);
+
+        // Without a notify signal the property has to be read on every access
+        if (notifyIndex != -1 && engine->v8Engine->engine())
+            m_referenceEndpoint.connect(object, notifyIndex, engine->v8Engine->engine());
+
         loadReference();
         init();
     }
@@ -481,8 +502,11 @@ private:
     {
         Q_ASSERT(m_object);
         Q_ASSERT(m_isReference);
+        if (m_referenceEndpoint.isValid)
+            return;
         void *a[] = { &m_container, 0 };
         QMetaObject::metacall(m_object, QMetaObject::ReadProperty, m_propertyIndex, a);
+        m_referenceEndpoint.isValid = m_referenceEndpoint.isConnected();
     }
 
     void storeReference()
@@ -493,12 +517,17 @@ private:
         QQmlPropertyPrivate::WriteFlags flags = QQmlPropertyPrivate::DontRemoveBinding;
         void *a[] = { &m_container, 0, &status, &flags };
         QMetaObject::metacall(m_object, QMetaObject::WriteProperty, m_propertyIndex, a);
+        // The setter may not have accepted the value as it is
+        m_referenceEndpoint.isValid = false;
     }
 
     mutable Container m_container;
     QPointer<QObject> m_object;
     int m_propertyIndex;
     bool m_isReference;
+    // The container is a shallow copy of the property value, so it is only
+    // re-read after the property has notified a change
+    mutable QQmlSequenceReferenceEndpoint m_referenceEndpoint;
 
     static QV4::ReturnedValue getIndexed(QV4::Managed *that, uint index, bool *hasProperty)
     { return static_cast<QQmlSequence<Container> *>(that)->containerGetIndexed(index, hasProperty); }
@@ -587,11 +616,11 @@ bool SequencePrototype::isSequenceType(int sequenceTypeId)
 
 #define NEW_REFERENCE_SEQUENCE(ElementType, ElementTypeName, SequenceType, unused) \
     if (sequenceType == qMetaTypeId<SequenceType>()) { \
-        QV4::Scoped<QV4::Object> obj(scope, new (engine->memoryManager) QQml##ElementTypeName##List(engine, object, propertyIndex)); \
+        QV4::Scoped<QV4::Object> obj(scope, new (engine->memoryManager) QQml##ElementTypeName##List(engine, object, propertyIndex, notifyIndex)); \
         return obj.asReturnedValue(); \
     } else
 
-ReturnedValue SequencePrototype::newSequence(QV4::ExecutionEngine *engine, int sequenceType, QObject *object, int propertyIndex, bool *succeeded)
+ReturnedValue SequencePrototype::newSequence(QV4::ExecutionEngine *engine, int sequenceType, QObject *object, int propertyIndex, int notifyIndex, bool *succeeded)
 {
     QV4::Scope scope(engine);
     // This function is called when the property is a QObject Q_PROPERTY of
@@ -77,7 +77,7 @@ struct SequencePrototype : public QV4::Object
     static ReturnedValue method_sort(QV4::CallContext *ctx);
 
     static bool isSequenceType(int sequenceTypeId);
-    static ReturnedValue newSequence(QV4::ExecutionEngine *engine, int sequenceTypeId, QObject *object, int propertyIndex, bool *succeeded);
+    static ReturnedValue newSequence(QV4::ExecutionEngine *engine, int sequenceTypeId, QObject *object, int propertyIndex, int notifyIndex, bool *succeeded);
     static ReturnedValue fromVariant(QV4::ExecutionEngine *engine, const QVariant& v, bool *succeeded);
     static int metaTypeForSequence(ObjectRef object);
     static QVariant toVariant(QV4::ObjectRef object);
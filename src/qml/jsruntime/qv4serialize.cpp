@@ -50,6 +50,8 @@
 #include <private/qv4regexpobject_p.h>
 #include <private/qv4sequenceobject_p.h>
 #include <private/qv4objectproto_p.h>
+#include <private/qv4arraybuffer_p.h>
+#include <private/qv4typedarray_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -67,6 +69,7 @@ using namespace QV4;
 //    + Number
 //    + Date
 //    + RegExp
+//    + ArrayBuffer and typed arrays
 // <quint8 type><quint24 size><data>
 
 enum Type {
@@ -84,7 +87,9 @@ enum Type {
     WorkerDate,
     WorkerRegexp,
     WorkerListModel,
-    WorkerSequence
+    WorkerSequence,
+    WorkerArrayBuffer,
+    WorkerTypedArray
 };
 
 static inline quint32 valueheader(Type type, quint32 size = 0)
@@ -147,8 +152,9 @@ static inline void *popPtr(const char *&data)
 // serialization/deserialization failures
 
 #define ALIGN(size) (((size) + 3) & ~3)
-void Serialize::serialize(QByteArray &data, const QV4::ValueRef v, QV8Engine *engine)
+void Serialize::serialize(Message &message, QVector<ArrayBuffer *> &sentBuffers, const QV4::ValueRef v, QV8Engine *engine)
 {
+    QByteArray &data = message.data;
     QV4::ExecutionEngine *v4 = QV8Engine::getV4(engine);
     QV4::Scope scope(v4);
 
@@ -192,7 +198,7 @@ void Serialize::serialize(QByteArray &data, const QV4::ValueRef v, QV8Engine *en
         push(data, valueheader(WorkerArray, length));
         ScopedValue val(scope);
         for (uint32_t ii = 0; ii < length; ++ii)
-            serialize(data, (val = array->getIndexed(ii)), engine);
+            serialize(message, sentBuffers, (val = array->getIndexed(ii)), engine);
     } else if (v->isInteger()) {
         reserve(data, 2 * sizeof(quint32));
         push(data, valueheader(WorkerInt32));
@@ -243,6 +249,23 @@ void Serialize::serialize(QByteArray &data, const QV4::ValueRef v, QV8Engine *en
         }
         // No other QObject's are allowed to be sent
         push(data, valueheader(WorkerUndefined));
+    } else if (ArrayBuffer *buffer = v->as<ArrayBuffer>()) {
+        // Every buffer is sent once, so that views on it stay views on the
+        // same buffer on the other side
+        int index = sentBuffers.indexOf(buffer);
+        if (index == -1) {
+            index = sentBuffers.size();
+            sentBuffers.append(buffer);
+            message.buffers.append(buffer->data);
+        }
+        push(data, valueheader(WorkerArrayBuffer, index));
+    } else if (TypedArray *typedArray = v->as<TypedArray>()) {
+        reserve(data, 3 * sizeof(quint32));
+        push(data, valueheader(WorkerTypedArray, typedArray->elementType()));
+        push(data, (quint32)typedArray->byteOffset);
+        push(data, (quint32)typedArray->byteLength);
+        ScopedValue bufferValue(scope, typedArray->buffer->asReturnedValue());
+        serialize(message, sentBuffers, bufferValue, engine);
     } else if (v->asObject()) {
         ScopedObject o(scope, v);
         if (o->isListType()) {
@@ -255,10 +278,10 @@ void Serialize::serialize(QByteArray &data, const QV4::ValueRef v, QV8Engine *en
             }
             reserve(data, sizeof(quint32) + length * sizeof(quint32));
             push(data, valueheader(WorkerSequence, length));
-            serialize(data, QV4::Primitive::fromInt32(QV4::SequencePrototype::metaTypeForSequence(o)), engine); // sequence type
+            serialize(message, sentBuffers, QV4::Primitive::fromInt32(QV4::SequencePrototype::metaTypeForSequence(o)), engine); // sequence type
             ScopedValue val(scope);
             for (uint32_t ii = 0; ii < seqLength; ++ii)
-                serialize(data, (val = o->getIndexed(ii)), engine); // sequence elements
+                serialize(message, sentBuffers, (val = o->getIndexed(ii)), engine); // sequence elements
 
             return;
         }
@@ -277,7 +300,7 @@ void Serialize::serialize(QByteArray &data, const QV4::ValueRef v, QV8Engine *en
         QV4::ScopedString str(scope);
         for (quint32 ii = 0; ii < length; ++ii) {
             s = properties->getIndexed(ii);
-            serialize(data, s, engine);
+            serialize(message, sentBuffers, s, engine);
 
             QV4::ExecutionContext *ctx = v4->currentContext();
             str = s;
@@ -285,7 +308,7 @@ void Serialize::serialize(QByteArray &data, const QV4::ValueRef v, QV8Engine *en
             if (scope.hasException())
                 ctx->catchException();
 
-            serialize(data, val, engine);
+            serialize(message, sentBuffers, val, engine);
         }
         return;
     } else {
@@ -293,7 +316,7 @@ void Serialize::serialize(QByteArray &data, const QV4::ValueRef v, QV8Engine *en
     }
 }
 
-ReturnedValue Serialize::deserialize(const char *&data, QV8Engine *engine)
+ReturnedValue Serialize::deserialize(const char *&data, const QVector<QByteArray> &buffers, Value *bufferObjects, QV8Engine *engine)
 {
     quint32 header = popUint32(data);
     Type type = headertype(header);
@@ -326,7 +349,7 @@ ReturnedValue Serialize::deserialize(const char *&data, QV8Engine *engine)
         Scoped<ArrayObject> a(scope, v4->newArrayObject());
         ScopedValue v(scope);
         for (quint32 ii = 0; ii < size; ++ii) {
-            v = deserialize(data, engine);
+            v = deserialize(data, buffers, bufferObjects, engine);
             a->putIndexed(ii, v);
         }
         return a.asReturnedValue();
@@ -339,8 +362,8 @@ ReturnedValue Serialize::deserialize(const char *&data, QV8Engine *engine)
         ScopedString n(scope);
         ScopedValue value(scope);
         for (quint32 ii = 0; ii < size; ++ii) {
-            name = deserialize(data, engine);
-            value = deserialize(data, engine);
+            name = deserialize(data, buffers, bufferObjects, engine);
+            value = deserialize(data, buffers, bufferObjects, engine);
             n = name.asReturnedValue();
             o->put(n, value);
         }
@@ -384,34 +407,98 @@ ReturnedValue Serialize::deserialize(const char *&data, QV8Engine *engine)
         bool succeeded = false;
         quint32 length = headersize(header);
         quint32 seqLength = length - 1;
-        value = deserialize(data, engine);
+        value = deserialize(data, buffers, bufferObjects, engine);
         int sequenceType = value->integerValue();
         Scoped<ArrayObject> array(scope, v4->newArrayObject());
         array->arrayReserve(seqLength);
         for (quint32 ii = 0; ii < seqLength; ++ii) {
-            value = deserialize(data, engine);
+            value = deserialize(data, buffers, bufferObjects, engine);
             array->arrayPut(ii, value);
         }
         array->setArrayLengthUnchecked(seqLength);
         QVariant seqVariant = QV4::SequencePrototype::toVariant(array, sequenceType, &succeeded);
         return QV4::SequencePrototype::fromVariant(v4, seqVariant, &succeeded);
     }
+    case WorkerArrayBuffer:
+    {
+        quint32 index = headersize(header);
+        Q_ASSERT(index < (quint32)buffers.size());
+        if (bufferObjects[index].isEmpty())
+            bufferObjects[index] = v4->newArrayBuffer(buffers.at(index));
+        return bufferObjects[index].asReturnedValue();
+    }
+    case WorkerTypedArray:
+    {
+        TypedArrayType elementType = (TypedArrayType)headersize(header);
+        quint32 byteOffset = popUint32(data);
+        quint32 byteLength = popUint32(data);
+        Scoped<ArrayBuffer> buffer(scope, deserialize(data, buffers, bufferObjects, engine));
+        Scoped<TypedArray> array(scope, new (v4->memoryManager) TypedArray(v4, elementType));
+        array->buffer = buffer.getPointer();
+        array->byteOffset = byteOffset;
+        array->byteLength = byteLength;
+        return array.asReturnedValue();
+    }
     }
     Q_ASSERT(!"Unreachable");
     return QV4::Encode::undefined();
 }
 
-QByteArray Serialize::serialize(const QV4::ValueRef value, QV8Engine *engine)
+Serialize::Message Serialize::serialize(const QV4::ValueRef value, QV8Engine *engine)
 {
-    QByteArray rv;
-    serialize(rv, value, engine);
+    Message rv;
+    QVector<ArrayBuffer *> sentBuffers;
+    serialize(rv, sentBuffers, value, engine);
     return rv;
 }
 
-ReturnedValue Serialize::deserialize(const QByteArray &data, QV8Engine *engine)
+// Serializes value and then neuters the ArrayBuffers listed in transfer.
+// The receiver then holds the only reference to their storage and can
+// write to it without detaching. Typed arrays in the list transfer the
+// buffer they are a view on.
+Serialize::Message Serialize::serialize(const QV4::ValueRef value, const QV4::ValueRef transfer, QV8Engine *engine)
 {
-    const char *stream = data.constData();
-    return deserialize(stream, engine);
+    QV4::ExecutionEngine *v4 = QV8Engine::getV4(engine);
+    QV4::Scope scope(v4);
+
+    QVector<ArrayBuffer *> transferred;
+    if (!transfer->isUndefined()) {
+        QV4::ScopedArrayObject list(scope, transfer);
+        if (!list) {
+            v4->currentContext()->throwTypeError(QStringLiteral("sendMessage: the transfer list must be an array"));
+            return Message();
+        }
+        QV4::ScopedValue item(scope);
+        for (uint ii = 0; ii < list->getLength(); ++ii) {
+            item = list->getIndexed(ii);
+            if (ArrayBuffer *buffer = item->as<ArrayBuffer>()) {
+                transferred.append(buffer);
+            } else if (TypedArray *typedArray = item->as<TypedArray>()) {
+                transferred.append(typedArray->buffer);
+            } else {
+                v4->currentContext()->throwTypeError(QStringLiteral("sendMessage: only ArrayBuffers and typed arrays can be transferred"));
+                return Message();
+            }
+        }
+    }
+
+    Message rv = serialize(value, engine);
+    for (int ii = 0; ii < transferred.size(); ++ii)
+        transferred.at(ii)->data = QByteArray();
+    return rv;
+}
+
+ReturnedValue Serialize::deserialize(const Message &message, QV8Engine *engine)
+{
+    QV4::ExecutionEngine *v4 = QV8Engine::getV4(engine);
+    QV4::Scope scope(v4);
+
+    Value *bufferObjects = scope.alloc(message.buffers.size());
+    for (int ii = 0; ii < message.buffers.size(); ++ii)
+        bufferObjects[ii] = Primitive::emptyValue();
+
+    const char *stream = message.data.constData();
+    return deserialize(stream, message.buffers, bufferObjects, engine);
 }
 
 QT_END_NAMESPACE
@@ -54,6 +54,7 @@
 //
 
 #include <QtCore/qbytearray.h>
+#include <QtCore/qvector.h>
 #include <private/qv4value_inl_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -62,15 +63,24 @@ class QV8Engine;
 
 namespace QV4 {
 
+struct ArrayBuffer;
+
 class Serialize {
 public:
+    // The contents of ArrayBuffers travel next to the serialized data and
+    // share their storage with the sender instead of being copied.
+    struct Message {
+        QByteArray data;
+        QVector<QByteArray> buffers;
+    };
 
-    static QByteArray serialize(const ValueRef, QV8Engine *);
-    static ReturnedValue deserialize(const QByteArray &, QV8Engine *);
+    static Message serialize(const ValueRef, QV8Engine *);
+    static Message serialize(const ValueRef, const ValueRef transfer, QV8Engine *);
+    static ReturnedValue deserialize(const Message &, QV8Engine *);
 
 private:
-    static void serialize(QByteArray &, const ValueRef, QV8Engine *);
-    static ReturnedValue deserialize(const char *&, QV8Engine *);
+    static void serialize(Message &, QVector<ArrayBuffer *> &, const ValueRef, QV8Engine *);
+    static ReturnedValue deserialize(const char *&, const QVector<QByteArray> &, Value *, QV8Engine *);
 };
 
 }
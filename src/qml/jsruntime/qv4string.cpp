@@ -148,7 +148,7 @@ ReturnedValue String::get(Managed *m, const StringRef name, bool *hasProperty)
     if (name->equals(v4->id_length)) {
         if (hasProperty)
             *hasProperty = true;
-        return Primitive::fromInt32(that->_text->size).asReturnedValue();
+        return Primitive::fromInt32(that->length()).asReturnedValue();
     }
     PropertyAttributes attrs;
     Property *pd = v4->stringObjectClass->prototype->__getPropertyDescriptor__(name, &attrs);
@@ -168,9 +168,11 @@ ReturnedValue String::getIndexed(Managed *m, uint index, bool *hasProperty)
     Scope scope(engine);
     ScopedString that(scope, static_cast<String *>(m));
 
-    if (index < static_cast<uint>(that->_text->size)) {
+    if (index < static_cast<uint>(that->length())) {
         if (hasProperty)
             *hasProperty = true;
+        if (that->isLatin1())
+            return Encode(engine->newString(QString(QLatin1Char(that->latin1Data()[index]))));
         return Encode(engine->newString(that->toQString().mid(index, 1)));
     }
     PropertyAttributes attrs;
@@ -217,7 +219,7 @@ PropertyAttributes String::query(const Managed *m, StringRef name)
 PropertyAttributes String::queryIndexed(const Managed *m, uint index)
 {
     const String *that = static_cast<const String *>(m);
-    return (index < static_cast<uint>(that->_text->size)) ? Attr_NotConfigurable|Attr_NotWritable : Attr_Invalid;
+    return (index < static_cast<uint>(that->length())) ? Attr_NotConfigurable|Attr_NotWritable : Attr_Invalid;
 }
 
 bool String::deleteProperty(Managed *, const StringRef)
@@ -247,7 +249,7 @@ bool String::isEqualTo(Managed *t, Managed *o)
     if (that->subtype >= StringType_UInt && that->subtype == other->subtype)
         return true;
 
-    return that->toQString() == other->toQString();
+    return that->equalsText(other);
 }
 
 
@@ -261,6 +263,17 @@ String::String(ExecutionEngine *engine, const QString &text)
     subtype = StringType_Unknown;
 }
 
+String::String(ExecutionEngine *engine, const QByteArray &latin1)
+    : Managed(engine->stringClass), _latin1(const_cast<QByteArray &>(latin1).data_ptr())
+    , identifier(0), stringHash(UINT_MAX)
+    , largestSubLength(0)
+{
+    _latin1->ref.ref();
+    len = _latin1->size;
+    latin1Text = true;
+    subtype = StringType_Unknown;
+}
+
 String::String(ExecutionEngine *engine, String *l, String *r)
     : Managed(engine->stringClass)
     , left(l), right(r)
@@ -308,7 +321,44 @@ bool String::equals(const StringRef other) const
     if (subtype >= StringType_UInt && subtype == other->subtype)
         return true;
 
-    return toQString() == other->toQString();
+    return equalsText(other.getPointer());
+}
+
+/*
+    Compares the characters of two flat strings, without widening one byte
+    strings.
+ */
+bool String::equalsText(const String *other) const
+{
+    Q_ASSERT(!largestSubLength && !other->largestSubLength);
+    if (len != other->len)
+        return false;
+
+    if (latin1Text && other->latin1Text)
+        return !memcmp(_latin1->data(), other->_latin1->data(), len);
+    if (!latin1Text && !other->latin1Text)
+        return !memcmp(_text->data(), other->_text->data(), len*sizeof(ushort));
+
+    const String *narrow = latin1Text ? this : other;
+    const String *wide = latin1Text ? other : this;
+    const uchar *l = reinterpret_cast<const uchar *>(narrow->_latin1->data());
+    const ushort *u = wide->_text->data();
+    for (uint i = 0; i < len; ++i) {
+        if (l[i] != u[i])
+            return false;
+    }
+    return true;
+}
+
+bool String::compare(const String *other)
+{
+    if (isLatin1() && other->isLatin1()) {
+        // Latin-1 code units sort like the UTF-16 ones
+        const uint l = qMin(len, other->len);
+        const int result = memcmp(_latin1->data(), other->_latin1->data(), l);
+        return result < 0 || (!result && len < other->len);
+    }
+    return toQString() < other->toQString();
 }
 
 void String::makeIdentifierImpl() const
@@ -319,25 +369,68 @@ void String::makeIdentifierImpl() const
     engine()->identifierTable->identifier(this);
 }
 
+/*
+    Flattens a concatenation. The result uses one byte per character when
+    all parts only hold Latin-1 characters, as the characters are copied
+    anyway.
+ */
 void String::simplifyString() const
 {
     Q_ASSERT(largestSubLength);
 
     int l = length();
-    QString result(l, Qt::Uninitialized);
-    QChar *ch = const_cast<QChar *>(result.constData());
-    recursiveAppend(ch);
-    _text = result.data_ptr();
-    _text->ref.ref();
+    if (fitsLatin1()) {
+        QByteArray result(l, Qt::Uninitialized);
+        recursiveAppendLatin1(result.data());
+        _latin1 = result.data_ptr();
+        _latin1->ref.ref();
+        latin1Text = true;
+    } else {
+        QString result(l, Qt::Uninitialized);
+        QChar *ch = const_cast<QChar *>(result.constData());
+        recursiveAppend(ch);
+        _text = result.data_ptr();
+        _text->ref.ref();
+    }
     identifier = 0;
     largestSubLength = 0;
 }
 
+void String::widen() const
+{
+    Q_ASSERT(latin1Text && !largestSubLength);
+    QString result = QString::fromLatin1(_latin1->data(), len);
+    if (!_latin1->ref.deref())
+        QByteArrayData::deallocate(_latin1);
+    _text = result.data_ptr();
+    _text->ref.ref();
+    latin1Text = false;
+}
+
+bool String::fitsLatin1() const
+{
+    if (largestSubLength)
+        return left->fitsLatin1() && right->fitsLatin1();
+    if (latin1Text)
+        return true;
+    const ushort *ch = _text->data();
+    const ushort *end = ch + _text->size;
+    for (; ch < end; ++ch) {
+        if (*ch > 0xff)
+            return false;
+    }
+    return true;
+}
+
 QChar *String::recursiveAppend(QChar *ch) const
 {
     if (largestSubLength) {
         ch = left->recursiveAppend(ch);
         ch = right->recursiveAppend(ch);
+    } else if (latin1Text) {
+        const uchar *l = reinterpret_cast<const uchar *>(_latin1->data());
+        for (uint i = 0; i < len; ++i)
+            *ch++ = QChar(l[i]);
     } else {
         memcpy(ch, _text->data(), _text->size*sizeof(QChar));
         ch += _text->size;
@@ -345,12 +438,52 @@ QChar *String::recursiveAppend(QChar *ch) const
     return ch;
 }
 
+char *String::recursiveAppendLatin1(char *ch) const
+{
+    if (largestSubLength) {
+        ch = left->recursiveAppendLatin1(ch);
+        ch = right->recursiveAppendLatin1(ch);
+    } else if (latin1Text) {
+        memcpy(ch, _latin1->data(), len);
+        ch += len;
+    } else {
+        const ushort *u = _text->data();
+        for (uint i = 0; i < len; ++i)
+            *ch++ = char(u[i]);
+    }
+    return ch;
+}
+
 
 void String::createHashValue() const
 {
     if (largestSubLength)
         simplifyString();
     Q_ASSERT(!largestSubLength);
+
+    if (latin1Text) {
+        // Same hash as for the UTF-16 characters, see createHashValue(const QChar *, int)
+        const char *ch = _latin1->data();
+        const char *end = ch + len;
+
+        bool ok;
+        stringHash = ::toArrayIndex(ch, end, &ok);
+        if (ok) {
+            subtype = (stringHash == UINT_MAX) ? StringType_UInt : StringType_ArrayIndex;
+            return;
+        }
+
+        uint h = 0xffffffff;
+        while (ch < end) {
+            h = 31 * h + uchar(*ch);
+            ++ch;
+        }
+
+        stringHash = h;
+        subtype = StringType_Regular;
+        return;
+    }
+
     const QChar *ch = reinterpret_cast<const QChar *>(_text->data());
     const QChar *end = ch + _text->size;
 
@@ -372,9 +505,9 @@ void String::createHashValue() const
     subtype = StringType_Regular;
 }
 
-uint String::createHashValue(const QChar *ch, int length)
+uint String::createHashValue(const char *ch, int length)
 {
-    const QChar *end = ch + length;
+    const char *end = ch + length;
 
     // array indices get their number as hash value
     bool ok;
@@ -384,16 +517,25 @@ uint String::createHashValue(const QChar *ch, int length)
 
     uint h = 0xffffffff;
     while (ch < end) {
-        h = 31 * h + ch->unicode();
+        if ((uchar)(*ch) >= 0x80)
+            return UINT_MAX;
+        h = 31 * h + *ch;
         ++ch;
     }
 
     return h;
 }
 
-uint String::createHashValue(const char *ch, int length)
+uint String::getLength(const Managed *m)
 {
-    const char *end = ch + length;
+    return static_cast<const String *>(m)->length();
+}
+
+#endif // V4_BOOTSTRAP
+
+uint String::createHashValue(const QChar *ch, int length)
+{
+    const QChar *end = ch + length;
 
     // array indices get their number as hash value
     bool ok;
@@ -403,22 +545,13 @@ uint String::createHashValue(const char *ch, int length)
 
     uint h = 0xffffffff;
     while (ch < end) {
-        if ((uchar)(*ch) >= 0x80)
-            return UINT_MAX;
-        h = 31 * h + *ch;
+        h = 31 * h + ch->unicode();
         ++ch;
     }
 
     return h;
 }
 
-uint String::getLength(const Managed *m)
-{
-    return static_cast<const String *>(m)->length();
-}
-
-#endif // V4_BOOTSTRAP
-
 uint String::toArrayIndex(const QString &str)
 {
     bool ok;
@@ -68,10 +68,17 @@ struct Q_QML_PRIVATE_EXPORT String : public Managed {
     };
 
     String(ExecutionEngine *engine, const QString &text);
+    String(ExecutionEngine *engine, const QByteArray &latin1);
     String(ExecutionEngine *engine, String *l, String *n);
     ~String() {
-        if (!largestSubLength && !_text->ref.deref())
-            QStringData::deallocate(_text);
+        if (!largestSubLength) {
+            if (latin1Text) {
+                if (!_latin1->ref.deref())
+                    QByteArrayData::deallocate(_latin1);
+            } else if (!_text->ref.deref()) {
+                QStringData::deallocate(_text);
+            }
+        }
         _data = 0;
     }
 
@@ -87,22 +94,36 @@ struct Q_QML_PRIVATE_EXPORT String : public Managed {
         if (subtype >= StringType_UInt && subtype == other->subtype)
             return true;
 
-        return toQString() == other->toQString();
+        return equalsText(other);
     }
+    bool equalsText(const String *other) const;
 
-    inline bool compare(const String *other) {
-        return toQString() < other->toQString();
-    }
+    bool compare(const String *other);
 
+    // Strings only holding Latin-1 characters may be stored with one byte per
+    // character. They are widened to UTF-16 the first time a QString is needed.
     inline QString toQString() const {
         if (largestSubLength)
             simplifyString();
+        if (latin1Text)
+            widen();
         QStringDataPtr ptr = { _text };
         _text->ref.ref();
         return QString(ptr);
     }
 
+    bool isLatin1() const {
+        if (largestSubLength)
+            simplifyString();
+        return latin1Text;
+    }
+    const char *latin1Data() const {
+        Q_ASSERT(latin1Text && !largestSubLength);
+        return _latin1->data();
+    }
+
     void simplifyString() const;
+    void widen() const;
 
     inline unsigned hashValue() const {
         if (subtype == StringType_Unknown)
@@ -130,22 +151,25 @@ struct Q_QML_PRIVATE_EXPORT String : public Managed {
     void makeIdentifierImpl() const;
 
     void createHashValue() const;
-    static uint createHashValue(const QChar *ch, int length);
     static uint createHashValue(const char *ch, int length);
 
     bool startsWithUpper() const {
         const String *l = this;
         while (l->largestSubLength)
             l = l->left;
-        return l->_text->size && QChar::isUpper(l->_text->data()[0]);
+        if (!l->len)
+            return false;
+        return l->latin1Text ? QChar::isUpper(uint(uchar(l->_latin1->data()[0]))) : QChar::isUpper(l->_text->data()[0]);
     }
     int length() const {
-        Q_ASSERT((largestSubLength && (len == left->len + right->len)) || len == (uint)_text->size);
+        Q_ASSERT((largestSubLength && (len == left->len + right->len))
+                 || len == uint(latin1Text ? _latin1->size : _text->size));
         return len;
     }
 
     union {
         mutable QStringData *_text;
+        mutable QByteArrayData *_latin1;
         mutable String *left;
     };
     union {
@@ -173,10 +197,13 @@ protected:
 
 private:
     QChar *recursiveAppend(QChar *ch) const;
+    char *recursiveAppendLatin1(char *ch) const;
+    bool fitsLatin1() const;
 #endif
 
 public:
     static uint toArrayIndex(const QString &str);
+    static uint createHashValue(const QChar *ch, int length);
 };
 
 #ifndef V4_BOOTSTRAP
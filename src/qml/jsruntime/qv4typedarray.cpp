@@ -0,0 +1,500 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQml module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qv4typedarray_p.h"
+
+#include <QtCore/qnumeric.h>
+#include <cmath>
+
+using namespace QV4;
+
+DEFINE_OBJECT_VTABLE(TypedArrayCtor);
+DEFINE_OBJECT_VTABLE(TypedArray);
+
+template <typename T>
+static ReturnedValue readValue(const char *data, uint index)
+{
+    return Encode(reinterpret_cast<const T *>(data)[index]);
+}
+
+template <>
+ReturnedValue readValue<qint8>(const char *data, uint index)
+{
+    return Encode((int)reinterpret_cast<const qint8 *>(data)[index]);
+}
+
+template <>
+ReturnedValue readValue<quint8>(const char *data, uint index)
+{
+    return Encode((int)reinterpret_cast<const quint8 *>(data)[index]);
+}
+
+template <>
+ReturnedValue readValue<qint16>(const char *data, uint index)
+{
+    return Encode((int)reinterpret_cast<const qint16 *>(data)[index]);
+}
+
+template <>
+ReturnedValue readValue<quint16>(const char *data, uint index)
+{
+    return Encode((int)reinterpret_cast<const quint16 *>(data)[index]);
+}
+
+template <>
+ReturnedValue readValue<float>(const char *data, uint index)
+{
+    // NaN payloads coming from memory could clash with the value encoding
+    double d = reinterpret_cast<const float *>(data)[index];
+    return Encode(qIsNaN(d) ? qQNaN() : d);
+}
+
+template <>
+ReturnedValue readValue<double>(const char *data, uint index)
+{
+    double d = reinterpret_cast<const double *>(data)[index];
+    return Encode(qIsNaN(d) ? qQNaN() : d);
+}
+
+template <typename T>
+static void writeValue(char *data, uint index, double value)
+{
+    reinterpret_cast<T *>(data)[index] = (T)Primitive::toInt32(value);
+}
+
+template <>
+void writeValue<quint32>(char *data, uint index, double value)
+{
+    reinterpret_cast<quint32 *>(data)[index] = Primitive::toUInt32(value);
+}
+
+template <>
+void writeValue<float>(char *data, uint index, double value)
+{
+    reinterpret_cast<float *>(data)[index] = (float)value;
+}
+
+template <>
+void writeValue<double>(char *data, uint index, double value)
+{
+    reinterpret_cast<double *>(data)[index] = value;
+}
+
+static void writeUInt8Clamped(char *data, uint index, double value)
+{
+    quint8 c;
+    if (!(value > 0)) { // also covers NaN
+        c = 0;
+    } else if (value >= 255) {
+        c = 255;
+    } else {
+        // round half to even
+        double f = std::floor(value);
+        double diff = value - f;
+        if (diff > 0.5 || (diff == 0.5 && (int(f) & 1)))
+            f += 1;
+        c = (quint8)f;
+    }
+    reinterpret_cast<quint8 *>(data)[index] = c;
+}
+
+const TypedArrayOperations TypedArray::operations[NTypedArrayTypes] = {
+    { sizeof(qint8), "Int8Array", readValue<qint8>, writeValue<qint8> },
+    { sizeof(quint8), "Uint8Array", readValue<quint8>, writeValue<quint8> },
+    { sizeof(quint8), "Uint8ClampedArray", readValue<quint8>, writeUInt8Clamped },
+    { sizeof(qint16), "Int16Array", readValue<qint16>, writeValue<qint16> },
+    { sizeof(quint16), "Uint16Array", readValue<quint16>, writeValue<quint16> },
+    { sizeof(qint32), "Int32Array", readValue<qint32>, writeValue<qint32> },
+    { sizeof(quint32), "Uint32Array", readValue<quint32>, writeValue<quint32> },
+    { sizeof(float), "Float32Array", readValue<float>, writeValue<float> },
+    { sizeof(double), "Float64Array", readValue<double>, writeValue<double> },
+};
+
+
+TypedArrayCtor::TypedArrayCtor(ExecutionContext *scope, TypedArrayType t)
+    : FunctionObject(scope, QString::fromLatin1(TypedArray::operations[t].name))
+    , type(t)
+{
+    setVTable(staticVTable());
+}
+
+ReturnedValue TypedArrayCtor::construct(Managed *m, CallData *callData)
+{
+    ExecutionEngine *v4 = m->engine();
+    Scope scope(v4);
+    const TypedArrayType type = static_cast<TypedArrayCtor *>(m)->type;
+    const int bytesPerElement = TypedArray::operations[type].bytesPerElement;
+
+    if (!callData->argc || !callData->args[0].isObject()) {
+        // ECMA 6 22.2.1.2
+        double l = callData->argc ? callData->args[0].toInteger() : 0;
+        if (scope.engine->hasException)
+            return Encode::undefined();
+        uint len = (uint)qBound(0., l, (double)UINT_MAX);
+        if (len != l || len > INT_MAX / bytesPerElement)
+            return v4->currentContext()->throwRangeError(QStringLiteral("%1: invalid length").arg(QLatin1String(TypedArray::operations[type].name)));
+
+        Scoped<ArrayBuffer> buffer(scope, v4->newArrayBuffer(int(len * bytesPerElement)));
+        Scoped<TypedArray> array(scope, new (v4->memoryManager) TypedArray(v4, type));
+        array->buffer = buffer.getPointer();
+        array->byteLength = buffer->byteLength();
+        array->byteOffset = 0;
+        return array.asReturnedValue();
+    }
+
+    Scoped<TypedArray> typedArray(scope, callData->argument(0));
+    if (!!typedArray) {
+        // ECMA 6 22.2.1.3
+        uint l = typedArray->length();
+        if (l > uint(INT_MAX / bytesPerElement))
+            return v4->currentContext()->throwRangeError(QStringLiteral("%1: invalid length").arg(QLatin1String(TypedArray::operations[type].name)));
+
+        Scoped<ArrayBuffer> buffer(scope, v4->newArrayBuffer(int(l * bytesPerElement)));
+        Scoped<TypedArray> array(scope, new (v4->memoryManager) TypedArray(v4, type));
+        array->buffer = buffer.getPointer();
+        array->byteLength = buffer->byteLength();
+        array->byteOffset = 0;
+
+        const char *src = typedArray->constData();
+        char *dest = array->data();
+        if (typedArray->elementType() == type) {
+            memcpy(dest, src, l * bytesPerElement);
+        } else {
+            TypedArrayRead read = typedArray->type->read;
+            TypedArrayWrite write = array->type->write;
+            ScopedValue val(scope);
+            for (uint i = 0; i < l; ++i) {
+                val = read(src, i);
+                write(dest, i, val->toNumber());
+            }
+        }
+        return array.asReturnedValue();
+    }
+
+    Scoped<ArrayBuffer> buffer(scope, callData->argument(0));
+    if (!!buffer) {
+        // ECMA 6 22.2.1.4
+        double dbyteOffset = callData->argc > 1 ? callData->args[1].toInteger() : 0;
+        if (scope.engine->hasException)
+            return Encode::undefined();
+        uint byteOffset = (uint)dbyteOffset;
+        if (dbyteOffset < 0 || byteOffset != dbyteOffset || byteOffset % bytesPerElement)
+            return v4->currentContext()->throwRangeError(QStringLiteral("%1: invalid byteOffset").arg(QLatin1String(TypedArray::operations[type].name)));
+
+        uint byteLength;
+        if (callData->argc < 3 || callData->args[2].isUndefined()) {
+            byteLength = buffer->byteLength() - byteOffset;
+            if (buffer->byteLength() < byteOffset || byteLength % bytesPerElement)
+                return v4->currentContext()->throwRangeError(QStringLiteral("%1: invalid length").arg(QLatin1String(TypedArray::operations[type].name)));
+        } else {
+            double l = qBound(0., callData->args[2].toInteger(), (double)UINT_MAX);
+            if (scope.engine->hasException)
+                return Encode::undefined();
+            l *= bytesPerElement;
+            l += byteOffset;
+            if (l > buffer->byteLength())
+                return v4->currentContext()->throwRangeError(QStringLiteral("%1: invalid length").arg(QLatin1String(TypedArray::operations[type].name)));
+            byteLength = (uint)l - byteOffset;
+        }
+
+        Scoped<TypedArray> array(scope, new (v4->memoryManager) TypedArray(v4, type));
+        array->buffer = buffer.getPointer();
+        array->byteLength = byteLength;
+        array->byteOffset = byteOffset;
+        return array.asReturnedValue();
+    }
+
+    // ECMA 6 22.2.1.3
+    ScopedObject o(scope, callData->argument(0));
+    uint l = (uint)qBound(0., ScopedValue(scope, o->get(v4->id_length))->toInteger(), (double)UINT_MAX);
+    if (scope.engine->hasException)
+        return Encode::undefined();
+    if (l > uint(INT_MAX / bytesPerElement))
+        return v4->currentContext()->throwRangeError(QStringLiteral("%1: invalid length").arg(QLatin1String(TypedArray::operations[type].name)));
+
+    Scoped<ArrayBuffer> newBuffer(scope, v4->newArrayBuffer(int(l * bytesPerElement)));
+    Scoped<TypedArray> array(scope, new (v4->memoryManager) TypedArray(v4, type));
+    array->buffer = newBuffer.getPointer();
+    array->byteLength = newBuffer->byteLength();
+    array->byteOffset = 0;
+
+    char *dest = array->data();
+    TypedArrayWrite write = array->type->write;
+    ScopedValue val(scope);
+    for (uint i = 0; i < l; ++i) {
+        val = o->getIndexed(i);
+        double d = val->toNumber();
+        if (scope.engine->hasException)
+            return Encode::undefined();
+        write(dest, i, d);
+    }
+
+    return array.asReturnedValue();
+}
+
+ReturnedValue TypedArrayCtor::call(Managed *that, CallData *callData)
+{
+    return construct(that, callData);
+}
+
+
+TypedArray::TypedArray(ExecutionEngine *v4, TypedArrayType t)
+    : Object(v4->typedArrayClasses[t])
+    , type(operations + t)
+    , buffer(0)
+    , byteLength(0)
+    , byteOffset(0)
+{
+    setVTable(staticVTable());
+    subtype = t;
+}
+
+void TypedArray::markObjects(Managed *that, ExecutionEngine *e)
+{
+    TypedArray *a = static_cast<TypedArray *>(that);
+    if (a->buffer)
+        a->buffer->mark(e);
+
+    Object::markObjects(that, e);
+}
+
+ReturnedValue TypedArray::getIndexed(Managed *m, uint index, bool *hasProperty)
+{
+    TypedArray *a = static_cast<TypedArray *>(m);
+    if (index >= a->length()) {
+        if (hasProperty)
+            *hasProperty = false;
+        return Encode::undefined();
+    }
+
+    if (hasProperty)
+        *hasProperty = true;
+    return a->type->read(a->constData(), index);
+}
+
+void TypedArray::putIndexed(Managed *m, uint index, const ValueRef value)
+{
+    ExecutionEngine *v4 = m->engine();
+    if (v4->hasException)
+        return;
+
+    TypedArray *a = static_cast<TypedArray *>(m);
+    // Convert first, valueOf() may run arbitrary code
+    double d = value->toNumber();
+    if (v4->hasException || index >= a->length())
+        return;
+
+    a->type->write(a->data(), index, d);
+}
+
+PropertyAttributes TypedArray::queryIndexed(const Managed *m, uint index)
+{
+    const TypedArray *a = static_cast<const TypedArray *>(m);
+    if (index >= a->length())
+        return Attr_Invalid;
+    PropertyAttributes attrs(Attr_Data);
+    attrs.setConfigurable(false);
+    return attrs;
+}
+
+bool TypedArray::deleteIndexedProperty(Managed *m, uint index)
+{
+    return index >= static_cast<TypedArray *>(m)->length();
+}
+
+uint TypedArray::getLength(const Managed *m)
+{
+    return static_cast<const TypedArray *>(m)->length();
+}
+
+
+void TypedArrayPrototype::init(ExecutionEngine *engine, ObjectRef ctor)
+{
+    Scope scope(engine);
+    ScopedObject o(scope);
+    const int bytesPerElement = TypedArray::operations[type].bytesPerElement;
+    ctor->defineReadonlyProperty(engine->id_length, Primitive::fromInt32(3));
+    ctor->defineReadonlyProperty(engine->id_prototype, (o = this));
+    ctor->defineReadonlyProperty(QStringLiteral("BYTES_PER_ELEMENT"), Primitive::fromInt32(bytesPerElement));
+    defineDefaultProperty(QStringLiteral("constructor"), (o = ctor));
+    defineAccessorProperty(QStringLiteral("buffer"), method_get_buffer, 0);
+    defineAccessorProperty(QStringLiteral("byteLength"), method_get_byteLength, 0);
+    defineAccessorProperty(QStringLiteral("byteOffset"), method_get_byteOffset, 0);
+    defineAccessorProperty(QStringLiteral("length"), method_get_length, 0);
+    defineReadonlyProperty(QStringLiteral("BYTES_PER_ELEMENT"), Primitive::fromInt32(bytesPerElement));
+
+    defineDefaultProperty(QStringLiteral("set"), method_set, 1);
+    defineDefaultProperty(QStringLiteral("subarray"), method_subarray, 0);
+}
+
+ReturnedValue TypedArrayPrototype::method_get_buffer(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<TypedArray> v(scope, ctx->callData->thisObject);
+    if (!v)
+        return ctx->throwTypeError();
+
+    return Encode(v->buffer->asReturnedValue());
+}
+
+ReturnedValue TypedArrayPrototype::method_get_byteLength(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<TypedArray> v(scope, ctx->callData->thisObject);
+    if (!v)
+        return ctx->throwTypeError();
+
+    return Encode(v->isNeutered() ? 0 : v->byteLength);
+}
+
+ReturnedValue TypedArrayPrototype::method_get_byteOffset(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<TypedArray> v(scope, ctx->callData->thisObject);
+    if (!v)
+        return ctx->throwTypeError();
+
+    return Encode(v->isNeutered() ? 0 : v->byteOffset);
+}
+
+ReturnedValue TypedArrayPrototype::method_get_length(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<TypedArray> v(scope, ctx->callData->thisObject);
+    if (!v)
+        return ctx->throwTypeError();
+
+    return Encode(v->length());
+}
+
+ReturnedValue TypedArrayPrototype::method_set(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<TypedArray> a(scope, ctx->callData->thisObject);
+    if (!a)
+        return ctx->throwTypeError();
+
+    double doffset = ctx->callData->argc > 1 ? ctx->callData->args[1].toInteger() : 0;
+    if (scope.engine->hasException)
+        return Encode::undefined();
+    if (doffset < 0 || doffset >= UINT_MAX)
+        return ctx->throwRangeError(QStringLiteral("TypedArray.set: out of range"));
+    uint offset = (uint)doffset;
+    const uint elementSize = a->type->bytesPerElement;
+
+    Scoped<TypedArray> srcTypedArray(scope, ctx->argument(0));
+    if (!srcTypedArray) {
+        // src is a normal array or array-like object
+        ScopedObject arg(scope, ctx->argument(0));
+        if (!arg)
+            return ctx->throwTypeError();
+
+        uint l = (uint)qBound(0., ScopedValue(scope, arg->get(scope.engine->id_length))->toInteger(), (double)UINT_MAX);
+        if (scope.engine->hasException)
+            return Encode::undefined();
+        if (offset > a->length() || l > a->length() - offset)
+            return ctx->throwRangeError(QStringLiteral("TypedArray.set: out of range"));
+
+        ScopedValue val(scope);
+        for (uint i = 0; i < l; ++i) {
+            val = arg->getIndexed(i);
+            double d = val->toNumber();
+            if (scope.engine->hasException)
+                return Encode::undefined();
+            a->type->write(a->data(), offset + i, d);
+        }
+        return Encode::undefined();
+    }
+
+    // src is a typed array
+    uint srcLength = srcTypedArray->length();
+    if (offset > a->length() || srcLength > a->length() - offset)
+        return ctx->throwRangeError(QStringLiteral("TypedArray.set: out of range"));
+
+    char *dest = a->data() + offset * elementSize;
+    if (srcTypedArray->elementType() == a->elementType()) {
+        // memmove, the two views can share the same buffer
+        memmove(dest, srcTypedArray->constData(), srcLength * elementSize);
+        return Encode::undefined();
+    }
+
+    // Different types: if the views overlap, read from a copy of the source
+    QByteArray srcCopy;
+    const char *src = srcTypedArray->constData();
+    if (srcTypedArray->buffer == a->buffer)
+        src = (srcCopy = QByteArray(src, srcLength * srcTypedArray->type->bytesPerElement)).constData();
+
+    TypedArrayRead read = srcTypedArray->type->read;
+    TypedArrayWrite write = a->type->write;
+    ScopedValue val(scope);
+    for (uint i = 0; i < srcLength; ++i) {
+        val = read(src, i);
+        write(dest, i, val->toNumber());
+    }
+
+    return Encode::undefined();
+}
+
+ReturnedValue TypedArrayPrototype::method_subarray(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<TypedArray> a(scope, ctx->callData->thisObject);
+    if (!a)
+        return ctx->throwTypeError();
+
+    double len = a->length();
+    double start = ctx->callData->argc > 0 ? ctx->callData->args[0].toInteger() : 0;
+    double end = (ctx->callData->argc < 2 || ctx->callData->args[1].isUndefined()) ?
+                len : ctx->callData->args[1].toInteger();
+    if (scope.engine->hasException)
+        return Encode::undefined();
+
+    double first = (start < 0) ? qMax(len + start, 0.) : qMin(start, len);
+    double last = (end < 0) ? qMax(len + end, 0.) : qMin(end, len);
+    uint newLen = (uint)qMax(last - first, 0.);
+
+    // Construct a view of the same type on the same buffer
+    Scoped<TypedArray> array(scope, new (scope.engine->memoryManager) TypedArray(scope.engine, a->elementType()));
+    array->buffer = a->buffer;
+    array->byteOffset = a->byteOffset + (uint)first * a->type->bytesPerElement;
+    array->byteLength = newLen * a->type->bytesPerElement;
+    return array.asReturnedValue();
+}
@@ -0,0 +1,127 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQml module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QV4TYPEDARRAY_H
+#define QV4TYPEDARRAY_H
+
+#include "qv4object_p.h"
+#include "qv4functionobject_p.h"
+#include "qv4arraybuffer_p.h"
+
+QT_BEGIN_NAMESPACE
+
+namespace QV4 {
+
+typedef ReturnedValue (*TypedArrayRead)(const char *data, uint index);
+typedef void (*TypedArrayWrite)(char *data, uint index, double value);
+
+struct TypedArrayOperations {
+    int bytesPerElement;
+    const char *name;
+    TypedArrayRead read;
+    TypedArrayWrite write;
+};
+
+struct Q_QML_PRIVATE_EXPORT TypedArray : Object
+{
+    V4_OBJECT
+    Q_MANAGED_TYPE(TypedArray)
+
+    TypedArray(ExecutionEngine *v4, TypedArrayType t);
+
+    const TypedArrayOperations *type;
+    ArrayBuffer *buffer;
+    uint byteLength;
+    uint byteOffset;
+
+    TypedArrayType elementType() const { return (TypedArrayType)subtype; }
+    // A view on a buffer that was transferred away no longer has any elements
+    bool isNeutered() const { return byteOffset + byteLength > buffer->byteLength(); }
+    uint length() const { return isNeutered() ? 0 : byteLength / type->bytesPerElement; }
+    const char *constData() const { return buffer->data.constData() + byteOffset; }
+    char *data() { return buffer->data.data() + byteOffset; }
+
+    static const TypedArrayOperations operations[NTypedArrayTypes];
+
+    static void markObjects(Managed *that, ExecutionEngine *e);
+    static ReturnedValue getIndexed(Managed *m, uint index, bool *hasProperty);
+    static void putIndexed(Managed *m, uint index, const ValueRef value);
+    static PropertyAttributes queryIndexed(const Managed *m, uint index);
+    static bool deleteIndexedProperty(Managed *m, uint index);
+    static uint getLength(const Managed *m);
+};
+
+struct TypedArrayCtor: FunctionObject
+{
+    V4_OBJECT
+
+    TypedArrayCtor(ExecutionContext *scope, TypedArrayType t);
+
+    static ReturnedValue construct(Managed *m, CallData *callData);
+    static ReturnedValue call(Managed *that, CallData *callData);
+
+    TypedArrayType type;
+};
+
+
+struct TypedArrayPrototype : Object
+{
+    TypedArrayPrototype(InternalClass *ic, TypedArrayType t)
+        : Object(ic)
+        , type(t)
+    {}
+    void init(ExecutionEngine *engine, ObjectRef ctor);
+
+    static ReturnedValue method_get_buffer(CallContext *ctx);
+    static ReturnedValue method_get_byteLength(CallContext *ctx);
+    static ReturnedValue method_get_byteOffset(CallContext *ctx);
+    static ReturnedValue method_get_length(CallContext *ctx);
+
+    static ReturnedValue method_set(CallContext *ctx);
+    static ReturnedValue method_subarray(CallContext *ctx);
+
+    TypedArrayType type;
+};
+
+} // namespace QV4
+
+QT_END_NAMESPACE
+
+#endif
@@ -46,6 +46,7 @@
 #include <private/qv4math_p.h>
 #include <private/qv4scopedvalue_p.h>
 #include <private/qv4lookup_p.h>
+#include <private/qv4script_p.h>
 #include <iostream>
 
 #include "qv4alloca_p.h"
@@ -157,6 +158,11 @@ Param traceParam(const Param &param)
 #define CHECK_EXCEPTION \
     if (engine->hasException) \
         goto catchException
+#define COUNT_BACK_EDGE(offset) \
+    if (tierUpFunction && (offset) < 0 && ++tierUpFunction->backEdgeCount >= engine->jitBackEdgeThreshold) { \
+        QV4::Script::tierUp(context->compilationUnit); \
+        tierUpFunction = 0; \
+    }
 
 QV4::ReturnedValue VME::run(QV4::ExecutionContext *context, const uchar *code
 #ifdef MOTH_THREADED_INTERPRETER
@@ -192,6 +198,17 @@ QV4::ReturnedValue VME::run(QV4::ExecutionContext *context, const uchar *code
     qDebug("Starting VME with context=%p and code=%p", context, code);
 #endif // DO_TRACE_INSTR
 
+    // Count calls and loop iterations of functions in units that can be recompiled with the JIT
+    QV4::Function *tierUpFunction = 0;
+    if (context->compilationUnit && context->compilationUnit->tierUpSource
+            && context->type >= QV4::ExecutionContext::Type_SimpleCallContext) {
+        tierUpFunction = static_cast<QV4::CallContext *>(context)->function->function;
+        if (tierUpFunction && ++tierUpFunction->callCount >= engine->jitCallThreshold) {
+            QV4::Script::tierUp(context->compilationUnit);
+            tierUpFunction = 0;
+        }
+    }
+
     QV4::StringValue * const runtimeStrings = context->compilationUnit->runtimeStrings;
 
     // setup lookup scopes
@@ -488,6 +505,14 @@ QV4::ReturnedValue VME::run(QV4::ExecutionContext *context, const uchar *code
         STOREVALUE(instr.result, Runtime::setupArgumentsObject(context));
     MOTH_END_INSTR(CallBuiltinSetupArgumentsObject)
 
+    MOTH_BEGIN_INSTR(CallBuiltinArgumentsLength)
+        STOREVALUE(instr.result, Runtime::argumentsLength(context));
+    MOTH_END_INSTR(CallBuiltinArgumentsLength)
+
+    MOTH_BEGIN_INSTR(CallBuiltinArgumentAt)
+        STOREVALUE(instr.result, Runtime::argumentAt(context, VALUEPTR(instr.index)));
+    MOTH_END_INSTR(CallBuiltinArgumentAt)
+
     MOTH_BEGIN_INSTR(CallBuiltinConvertThisToObject)
         Runtime::convertThisToObject(context);
         CHECK_EXCEPTION;
@@ -542,22 +567,47 @@ QV4::ReturnedValue VME::run(QV4::ExecutionContext *context, const uchar *code
 
     MOTH_BEGIN_INSTR(Jump)
         code = ((uchar *)&instr.offset) + instr.offset;
+        COUNT_BACK_EDGE(instr.offset);
     MOTH_END_INSTR(Jump)
 
     MOTH_BEGIN_INSTR(JumpEq)
         bool cond = VALUEPTR(instr.condition)->toBoolean();
         TRACE(condition, "%s", cond ? "TRUE" : "FALSE");
-        if (cond)
+        if (cond) {
             code = ((uchar *)&instr.offset) + instr.offset;
+            COUNT_BACK_EDGE(instr.offset);
+        }
     MOTH_END_INSTR(JumpEq)
 
     MOTH_BEGIN_INSTR(JumpNe)
         bool cond = VALUEPTR(instr.condition)->toBoolean();
         TRACE(condition, "%s", cond ? "TRUE" : "FALSE");
-        if (!cond)
+        if (!cond) {
             code = ((uchar *)&instr.offset) + instr.offset;
+            COUNT_BACK_EDGE(instr.offset);
+        }
     MOTH_END_INSTR(JumpNe)
 
+    MOTH_BEGIN_INSTR(CompareJumpEq)
+        bool cond = instr.cmp(VALUEPTR(instr.lhs), VALUEPTR(instr.rhs));
+        CHECK_EXCEPTION;
+        TRACE(condition, "%s", cond ? "TRUE" : "FALSE");
+        if (cond) {
+            code = ((uchar *)&instr.offset) + instr.offset;
+            COUNT_BACK_EDGE(instr.offset);
+        }
+    MOTH_END_INSTR(CompareJumpEq)
+
+    MOTH_BEGIN_INSTR(CompareJumpNe)
+        bool cond = instr.cmp(VALUEPTR(instr.lhs), VALUEPTR(instr.rhs));
+        CHECK_EXCEPTION;
+        TRACE(condition, "%s", cond ? "TRUE" : "FALSE");
+        if (!cond) {
+            code = ((uchar *)&instr.offset) + instr.offset;
+            COUNT_BACK_EDGE(instr.offset);
+        }
+    MOTH_END_INSTR(CompareJumpNe)
+
     MOTH_BEGIN_INSTR(UNot)
         STOREVALUE(instr.result, Runtime::uNot(VALUEPTR(instr.source)));
     MOTH_END_INSTR(UNot)
@@ -675,9 +725,9 @@ QV4::ReturnedValue VME::run(QV4::ExecutionContext *context, const uchar *code
         VALUE(instr.result) = context->callData->thisObject;
     MOTH_END_INSTR(LoadThis)
 
-    MOTH_BEGIN_INSTR(LoadQmlIdArray)
-        VALUE(instr.result) = Runtime::getQmlIdArray(static_cast<QV4::NoThrowContext*>(context));
-    MOTH_END_INSTR(LoadQmlIdArray)
+    MOTH_BEGIN_INSTR(LoadQmlIdObject)
+        VALUE(instr.result) = Runtime::getQmlIdObject(static_cast<QV4::NoThrowContext*>(context), instr.index);
+    MOTH_END_INSTR(LoadQmlIdObject)
 
     MOTH_BEGIN_INSTR(LoadQmlImportedScripts)
         VALUE(instr.result) = Runtime::getQmlImportedScripts(static_cast<QV4::NoThrowContext*>(context));
@@ -12,6 +12,7 @@ HEADERS +=  \
     $$PWD/qrecursionwatcher_p.h \
     $$PWD/qdeletewatcher_p.h \
     $$PWD/qrecyclepool_p.h \
+    $$PWD/qqmlsizeclasspool_p.h \
     $$PWD/qflagpointer_p.h \
     $$PWD/qqmltrace_p.h \
     $$PWD/qpointervaluepair_p.h \
@@ -21,6 +22,7 @@ SOURCES += \
     $$PWD/qintrusivelist.cpp \
     $$PWD/qhashedstring.cpp \
     $$PWD/qqmlpool.cpp \
+    $$PWD/qqmlsizeclasspool.cpp \
     $$PWD/qqmlthread.cpp \
     $$PWD/qqmltrace.cpp \
 
@@ -96,6 +96,7 @@ public:
     inline QFieldList();
     inline N *first() const;
     inline N *takeFirst();
+    inline N *takeNext(N *);
 
     inline void append(N *);
     inline void prepend(N *);
@@ -257,6 +258,26 @@ N *QFieldList<N, nextMember>::takeFirst()
     return value;
 }
 
+// Removes and returns the node following \a prev, or the first node if \a prev is 0
+template<class N, N *N::*nextMember>
+N *QFieldList<N, nextMember>::takeNext(N *prev)
+{
+    if (!prev)
+        return takeFirst();
+
+    N *value = next(prev);
+    if (value) {
+        prev->*nextMember = next(value);
+        if (_last == value) {
+            Q_ASSERT(prev->*nextMember == 0);
+            _last = prev;
+        }
+        value->*nextMember = 0;
+        --_count;
+    }
+    return value;
+}
+
 template<class N, N *N::*nextMember>
 void QFieldList<N, nextMember>::append(N *v)
 {
@@ -0,0 +1,181 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQml module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qqmlsizeclasspool_p.h"
+#include <stdlib.h>
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+enum {
+    Granularity = 16,
+    SizeClasses = 16,
+    MaxPooledSize = Granularity * SizeClasses,
+    BlocksPerPage = 64
+};
+
+// Precedes every block handed out, and keeps the block 16 byte aligned
+struct BlockHeader {
+    QQmlSizeClassPool::Data *pool; // 0 for unpooled blocks
+    size_t sizeClass;
+};
+
+// Overlays the payload of a block while it sits on a free list
+struct FreeBlock {
+    FreeBlock *next;
+};
+
+struct Page {
+    Page *next;
+    size_t padding;
+};
+
+}
+
+struct QQmlSizeClassPool::Data
+{
+    Data()
+    : held(true), outstanding(0), pages(0)
+    {
+        memset(freeLists, 0, sizeof(freeLists));
+    }
+
+    bool held;
+    int outstanding;
+    Page *pages;
+    FreeBlock *freeLists[SizeClasses];
+
+    void newPage(int sizeClass);
+    void releaseIfPossible();
+};
+
+void QQmlSizeClassPool::Data::newPage(int sizeClass)
+{
+    const size_t blockSize = sizeof(BlockHeader) + (sizeClass + 1) * Granularity;
+    Page *page = (Page *)malloc(sizeof(Page) + BlocksPerPage * blockSize);
+    Q_CHECK_PTR(page);
+    page->next = pages;
+    pages = page;
+
+    char *block = reinterpret_cast<char *>(page + 1);
+    for (int ii = 0; ii < BlocksPerPage; ++ii, block += blockSize) {
+        FreeBlock *free = reinterpret_cast<FreeBlock *>(block + sizeof(BlockHeader));
+        free->next = freeLists[sizeClass];
+        freeLists[sizeClass] = free;
+    }
+}
+
+void QQmlSizeClassPool::Data::releaseIfPossible()
+{
+    if (held || outstanding)
+        return;
+
+    Page *p = pages;
+    while (p) {
+        Page *n = p->next;
+        free(p);
+        p = n;
+    }
+
+    delete this;
+}
+
+QQmlSizeClassPool::QQmlSizeClassPool()
+: d(new Data)
+{
+}
+
+QQmlSizeClassPool::~QQmlSizeClassPool()
+{
+    d->held = false;
+    d->releaseIfPossible();
+}
+
+void *QQmlSizeClassPool::allocate(size_t size)
+{
+    if (!size || size > MaxPooledSize)
+        return allocateUnpooled(size);
+
+    const int sizeClass = int((size - 1) / Granularity);
+    if (!d->freeLists[sizeClass])
+        d->newPage(sizeClass);
+
+    FreeBlock *block = d->freeLists[sizeClass];
+    d->freeLists[sizeClass] = block->next;
+
+    BlockHeader *header = reinterpret_cast<BlockHeader *>(block) - 1;
+    header->pool = d;
+    header->sizeClass = sizeClass;
+    ++d->outstanding;
+    return block;
+}
+
+void *QQmlSizeClassPool::allocateUnpooled(size_t size)
+{
+    BlockHeader *header = (BlockHeader *)malloc(sizeof(BlockHeader) + size);
+    Q_CHECK_PTR(header);
+    header->pool = 0;
+    header->sizeClass = 0;
+    return header + 1;
+}
+
+void QQmlSizeClassPool::release(void *ptr)
+{
+    if (!ptr)
+        return;
+
+    BlockHeader *header = reinterpret_cast<BlockHeader *>(ptr) - 1;
+    Data *pool = header->pool;
+    if (!pool) {
+        free(header);
+        return;
+    }
+
+    FreeBlock *block = reinterpret_cast<FreeBlock *>(ptr);
+    block->next = pool->freeLists[header->sizeClass];
+    pool->freeLists[header->sizeClass] = block;
+    --pool->outstanding;
+    pool->releaseIfPossible();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,104 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQml module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QQMLSIZECLASSPOOL_P_H
+#define QQMLSIZECLASSPOOL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qtqmlglobal_p.h>
+
+QT_BEGIN_NAMESPACE
+
+// Recycles small blocks of memory by size class.  Unlike QQmlPool, blocks
+// are returned one at a time, so the objects allocated from it can have
+// independent lifetimes.  The pages backing a pool are only freed once the
+// pool itself has been destroyed and every block has been released.
+//
+// A pool is not thread safe; it must only be used from the thread that
+// owns it.
+class Q_QML_PRIVATE_EXPORT QQmlSizeClassPool
+{
+public:
+    QQmlSizeClassPool();
+    ~QQmlSizeClassPool();
+
+    void *allocate(size_t size);
+
+    // Allocates a block that is compatible with release(), but bypasses
+    // any pool.
+    static void *allocateUnpooled(size_t size);
+    static void release(void *);
+
+    struct Data;
+
+private:
+    Q_DISABLE_COPY(QQmlSizeClassPool)
+    Data *d;
+};
+
+// Gives a class operator new/delete overloads that can allocate its
+// instances from a QQmlSizeClassPool: "new (pool) Type(...)".  Instances
+// created with plain new still come from the general heap.
+#define Q_QML_SIZE_CLASS_POOLED \
+public: \
+    static void *operator new(size_t size) \
+    { return QQmlSizeClassPool::allocateUnpooled(size); } \
+    static void *operator new(size_t size, QQmlSizeClassPool *pool) \
+    { return pool ? pool->allocate(size) : QQmlSizeClassPool::allocateUnpooled(size); } \
+    static void operator delete(void *ptr) \
+    { QQmlSizeClassPool::release(ptr); } \
+    static void operator delete(void *ptr, QQmlSizeClassPool *) \
+    { QQmlSizeClassPool::release(ptr); } \
+private:
+
+QT_END_NAMESPACE
+
+#endif // QQMLSIZECLASSPOOL_P_H
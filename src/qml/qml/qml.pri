@@ -41,6 +41,7 @@ SOURCES += \
     $$PWD/qqmlnetworkaccessmanagerfactory.cpp \
     $$PWD/qqmlextensionplugin.cpp \
     $$PWD/qqmlimport.cpp \
+    $$PWD/qqmlimportindex.cpp \
     $$PWD/qqmllist.cpp \
     $$PWD/qqmllocale.cpp \
     $$PWD/qqmlabstractexpression.cpp \
@@ -53,6 +54,8 @@ SOURCES += \
     $$PWD/qqmlmemoryprofiler.cpp \
     $$PWD/qqmlplatform.cpp \
     $$PWD/qqmlbinding.cpp \
+    $$PWD/qqmlbindingprogram.cpp \
+    $$PWD/qqmlbindinggraph.cpp \
     $$PWD/qqmlabstracturlinterceptor.cpp \
     $$PWD/qqmlapplicationengine.cpp \
     $$PWD/qqmllistwrapper.cpp \
@@ -111,6 +114,7 @@ HEADERS += \
     $$PWD/qqmlnetworkaccessmanagerfactory.h \
     $$PWD/qqmlextensioninterface.h \
     $$PWD/qqmlimport_p.h \
+    $$PWD/qqmlimportindex_p.h \
     $$PWD/qqmlextensionplugin.h \
     $$PWD/qqmlnullablevalue_p_p.h \
     $$PWD/qqmlscriptstring_p.h \
@@ -125,6 +129,8 @@ HEADERS += \
     $$PWD/qqmlmemoryprofiler_p.h \
     $$PWD/qqmlplatform_p.h \
     $$PWD/qqmlbinding_p.h \
+    $$PWD/qqmlbindingprogram_p.h \
+    $$PWD/qqmlbindinggraph_p.h \
     $$PWD/qqmlextensionplugin_p.h \
     $$PWD/qqmlabstracturlinterceptor.h \
     $$PWD/qqmlapplicationengine_p.h \
@@ -47,6 +47,7 @@
 #include "qqmlcompiler_p.h"
 #include "qqmldata_p.h"
 #include <private/qqmlprofiler_p.h>
+#include <private/qqmlbindinggraph_p.h>
 #include <private/qqmltrace_p.h>
 #include <private/qqmlexpression_p.h>
 #include <private/qqmlscriptstring_p.h>
@@ -105,7 +106,8 @@ static QQmlJavaScriptExpression::VTable QQmlBinding_jsvtable = {
 };
 
 QQmlBinding::QQmlBinding(const QString &str, QObject *obj, QQmlContext *ctxt)
-: QQmlJavaScriptExpression(&QQmlBinding_jsvtable), QQmlAbstractBinding(Binding)
+: QQmlJavaScriptExpression(&QQmlBinding_jsvtable), QQmlAbstractBinding(Binding),
+  m_nextDeferred(0), m_prevDeferred(0)
 {
     setNotifyOnValueChanged(true);
     QQmlAbstractExpression::setContext(QQmlContextData::get(ctxt));
@@ -115,7 +117,8 @@ QQmlBinding::QQmlBinding(const QString &str, QObject *obj, QQmlContext *ctxt)
 }
 
 QQmlBinding::QQmlBinding(const QQmlScriptString &script, QObject *obj, QQmlContext *ctxt)
-: QQmlJavaScriptExpression(&QQmlBinding_jsvtable), QQmlAbstractBinding(Binding)
+: QQmlJavaScriptExpression(&QQmlBinding_jsvtable), QQmlAbstractBinding(Binding),
+  m_nextDeferred(0), m_prevDeferred(0)
 {
     if (ctxt && !ctxt->isValid())
         return;
@@ -155,7 +158,8 @@ QQmlBinding::QQmlBinding(const QQmlScriptString &script, QObject *obj, QQmlConte
 }
 
 QQmlBinding::QQmlBinding(const QString &str, QObject *obj, QQmlContextData *ctxt)
-: QQmlJavaScriptExpression(&QQmlBinding_jsvtable), QQmlAbstractBinding(Binding)
+: QQmlJavaScriptExpression(&QQmlBinding_jsvtable), QQmlAbstractBinding(Binding),
+  m_nextDeferred(0), m_prevDeferred(0)
 {
     setNotifyOnValueChanged(true);
     QQmlAbstractExpression::setContext(ctxt);
@@ -167,7 +171,8 @@ QQmlBinding::QQmlBinding(const QString &str, QObject *obj, QQmlContextData *ctxt
 QQmlBinding::QQmlBinding(const QString &str, QObject *obj,
                          QQmlContextData *ctxt,
                          const QString &url, quint16 lineNumber, quint16 columnNumber)
-: QQmlJavaScriptExpression(&QQmlBinding_jsvtable), QQmlAbstractBinding(Binding)
+: QQmlJavaScriptExpression(&QQmlBinding_jsvtable), QQmlAbstractBinding(Binding),
+  m_nextDeferred(0), m_prevDeferred(0)
 {
     Q_UNUSED(columnNumber);
     setNotifyOnValueChanged(true);
@@ -178,7 +183,8 @@ QQmlBinding::QQmlBinding(const QString &str, QObject *obj,
 }
 
 QQmlBinding::QQmlBinding(const QV4::ValueRef functionPtr, QObject *obj, QQmlContextData *ctxt)
-: QQmlJavaScriptExpression(&QQmlBinding_jsvtable), QQmlAbstractBinding(Binding)
+: QQmlJavaScriptExpression(&QQmlBinding_jsvtable), QQmlAbstractBinding(Binding),
+  m_nextDeferred(0), m_prevDeferred(0)
 {
     setNotifyOnValueChanged(true);
     QQmlAbstractExpression::setContext(ctxt);
@@ -189,6 +195,10 @@ QQmlBinding::QQmlBinding(const QV4::ValueRef functionPtr, QObject *obj, QQmlCont
 
 QQmlBinding::~QQmlBinding()
 {
+    if (m_prevDeferred) {
+        if (m_nextDeferred) m_nextDeferred->m_prevDeferred = m_prevDeferred;
+        *m_prevDeferred = m_nextDeferred;
+    }
 }
 
 void QQmlBinding::setNotifyOnValueChanged(bool v)
@@ -198,6 +208,10 @@ void QQmlBinding::setNotifyOnValueChanged(bool v)
 
 void QQmlBinding::update(QQmlPropertyPrivate::WriteFlags flags)
 {
+    // Any update satisfies a deferred one
+    if (m_prevDeferred)
+        removeFromDeferredList();
+
     if (!enabledFlag() || !context() || !context()->isValid())
         return;
 
@@ -236,7 +250,10 @@ void QQmlBinding::update(QQmlPropertyPrivate::WriteFlags flags)
     trace.addDetail("Column", columnNo);
 
     if (!updatingFlag()) {
-        QQmlBindingProfiler prof(ep->profiler, url, lineNo, columnNo);
+        QString trigger;
+        if (QQmlBindingGraph *graph = QQmlBindingGraph::instance())
+            trigger = graph->bindingUpdated(this, *m_coreObject, m_core.coreIndex);
+        QQmlBindingProfiler prof(ep->profiler, url, lineNo, columnNo, trigger);
         setUpdatingFlag(true);
 
         QQmlAbstractExpression::DeleteWatcher watcher(this);
@@ -256,7 +273,16 @@ void QQmlBinding::update(QQmlPropertyPrivate::WriteFlags flags)
 
             bool isUndefined = false;
 
-            QV4::ScopedValue result(scope, QQmlJavaScriptExpression::evaluate(context(), f, &isUndefined));
+            QV4::ScopedValue result(scope);
+            bool evaluated = false;
+            if (m_program) {
+                result = QQmlJavaScriptExpression::evaluate(context(), m_program.data(), &isUndefined, &evaluated);
+                // Values the program can't handle tend to come back, use the function from now on.
+                if (!evaluated && !watcher.wasDeleted())
+                    m_program = 0;
+            }
+            if (!evaluated && !watcher.wasDeleted())
+                result = QQmlJavaScriptExpression::evaluate(context(), f, &isUndefined);
 
             trace.event("writing binding result");
 
@@ -324,9 +350,50 @@ QString QQmlBinding::expressionIdentifier(QQmlJavaScriptExpression *e)
 void QQmlBinding::expressionChanged(QQmlJavaScriptExpression *e)
 {
     QQmlBinding *This = static_cast<QQmlBinding *>(e);
+
+    QQmlEnginePrivate *ep = This->context() ? QQmlEnginePrivate::get(This->context()->engine) : 0;
+    if (ep && ep->deferBindingUpdates && !ep->flushingDeferredBindings && !This->isSynchronous()) {
+        ep->deferBindingUpdate(This);
+        return;
+    }
+
     This->update();
 }
 
+void QQmlBinding::addToDeferredList(QQmlBinding **list)
+{
+    Q_ASSERT(!m_prevDeferred);
+    m_prevDeferred = list;
+    m_nextDeferred = *list;
+    if (m_nextDeferred) m_nextDeferred->m_prevDeferred = &m_nextDeferred;
+    *list = this;
+
+    // Mark the target property, so that reading it flushes this update first
+    // (see QQmlData::flushPendingBinding()).  Value type sub-properties are only
+    // updated when the whole queue is flushed.
+    int index = propertyIndex();
+    if (index == (index & 0xFFFF)) {
+        QObject *o = object();
+        if (QQmlData *data = QQmlData::get(o, true))
+            data->setPendingBindingBit(o, index);
+    }
+}
+
+void QQmlBinding::removeFromDeferredList()
+{
+    Q_ASSERT(m_prevDeferred);
+    if (m_nextDeferred) m_nextDeferred->m_prevDeferred = m_prevDeferred;
+    *m_prevDeferred = m_nextDeferred;
+    m_nextDeferred = 0;
+    m_prevDeferred = 0;
+
+    int index = propertyIndex();
+    if (index == (index & 0xFFFF)) {
+        if (QQmlData *data = QQmlData::get(object(), false))
+            data->clearPendingBindingBit(index);
+    }
+}
+
 void QQmlBinding::refresh()
 {
     update();
@@ -67,6 +67,8 @@
 #include <private/qqmlabstractbinding_p.h>
 #include <private/qqmlabstractexpression_p.h>
 #include <private/qqmljavascriptexpression_p.h>
+#include <private/qqmlsizeclasspool_p.h>
+#include <private/qqmlbindingprogram_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -75,6 +77,7 @@ class Q_QML_PRIVATE_EXPORT QQmlBinding : public QQmlJavaScriptExpression,
                                          public QQmlAbstractExpression,
                                          public QQmlAbstractBinding
 {
+    Q_QML_SIZE_CLASS_POOLED
 public:
     QQmlBinding(const QString &, QObject *, QQmlContext *);
     QQmlBinding(const QQmlScriptString &, QObject *, QQmlContext *);
@@ -109,6 +112,10 @@ public:
     int propertyIndex() const;
     void retargetBinding(QObject *, int);
 
+    // Evaluates the binding with the given program instead of its function,
+    // for as long as the program can produce the result.
+    void setProgram(QQmlBindingProgram *program) { m_program = program; }
+
     typedef int Identifier;
     static Identifier Invalid;
 
@@ -119,12 +126,22 @@ public:
     static QString expressionIdentifier(QQmlJavaScriptExpression *);
     static void expressionChanged(QQmlJavaScriptExpression *);
 
+    // Synchronous bindings are always updated as soon as a dependency changes,
+    // even if the engine defers binding updates.
+    inline bool isSynchronous() const;
+    inline void setSynchronous(bool);
+
+    inline bool isUpdateDeferred() const;
+    void addToDeferredList(QQmlBinding **);
+    void removeFromDeferredList();
+
 protected:
     friend class QQmlAbstractBinding;
     ~QQmlBinding();
 
 private:
     QV4::PersistentValue v4function;
+    QQmlRefPointer<QQmlBindingProgram> m_program;
 
     inline bool updatingFlag() const;
     inline void setUpdatingFlag(bool);
@@ -136,12 +153,17 @@ private:
         int targetProperty;
     };
 
-    QPointerValuePair<QObject, Retarget> m_coreObject;
-    QQmlPropertyData m_core;
     // We store some flag bits in the following flag pointers.
+    //    m_coreObject:flag1 - synchronous
     //    m_ctxt:flag1 - updatingFlag
     //    m_ctxt:flag2 - enabledFlag
+    QPointerValuePair<QObject, Retarget> m_coreObject;
+    QQmlPropertyData m_core;
     QFlagPointer<QQmlContextData> m_ctxt;
+
+    // Linked into QQmlEnginePrivate::deferredBindings while an update is queued
+    QQmlBinding  *m_nextDeferred;
+    QQmlBinding **m_prevDeferred;
 };
 
 bool QQmlBinding::updatingFlag() const
@@ -164,6 +186,21 @@ void QQmlBinding::setEnabledFlag(bool v)
     m_ctxt.setFlag2Value(v);
 }
 
+bool QQmlBinding::isSynchronous() const
+{
+    return m_coreObject.flag();
+}
+
+void QQmlBinding::setSynchronous(bool v)
+{
+    m_coreObject.setFlagValue(v);
+}
+
+bool QQmlBinding::isUpdateDeferred() const
+{
+    return m_prevDeferred != 0;
+}
+
 QT_END_NAMESPACE
 
 Q_DECLARE_METATYPE(QQmlBinding*)
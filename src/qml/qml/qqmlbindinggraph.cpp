@@ -0,0 +1,324 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQml module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qqmlbindinggraph_p.h"
+
+#include <private/qqmljavascriptexpression_p.h>
+
+#include <QtCore/qfile.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qmetaobject.h>
+
+QT_BEGIN_NAMESPACE
+
+QQmlBindingGraph *QQmlBindingGraph::fromEnvironment()
+{
+    const QString fileName = QString::fromLocal8Bit(qgetenv("QML_BINDING_GRAPH"));
+    return fileName.isEmpty() ? 0 : new QQmlBindingGraph(fileName);
+}
+
+// The graph is never deleted, so that expressions destroyed after the last engine don't
+// have to check for it.
+QQmlBindingGraph **QQmlBindingGraph::instancePointer()
+{
+    static QQmlBindingGraph *graph = fromEnvironment();
+    return &graph;
+}
+
+QQmlBindingGraph *QQmlBindingGraph::instance()
+{
+    return *instancePointer();
+}
+
+/*
+    Starts recording without writing the graph anywhere; use save(fileName) or the accessors.
+*/
+void QQmlBindingGraph::enable()
+{
+    QQmlBindingGraph **graph = instancePointer();
+    if (!*graph)
+        *graph = new QQmlBindingGraph(QString());
+}
+
+QQmlBindingGraph::QQmlBindingGraph(const QString &fileName)
+    : m_fileName(fileName)
+{
+}
+
+int QQmlBindingGraph::expressionNode(QQmlJavaScriptExpression *expression)
+{
+    QHash<QQmlJavaScriptExpression *, int>::ConstIterator it = m_expressions.constFind(expression);
+    if (it != m_expressions.constEnd())
+        return it.value();
+
+    const Node node = { ExpressionNode,
+                        expression->m_vtable->expressionIdentifier(expression), 0 };
+    m_nodes.append(node);
+    m_expressions.insert(expression, m_nodes.size() - 1);
+    return m_nodes.size() - 1;
+}
+
+int QQmlBindingGraph::propertyNode(QObject *object, int coreIndex)
+{
+    const PropertyKey key = { object, coreIndex };
+    const QMetaObject *metaObject = object->metaObject();
+    QHash<PropertyKey, PropertyInfo>::ConstIterator it = m_properties.constFind(key);
+    if (it != m_properties.constEnd() && it.value().metaObject == metaObject)
+        return it.value().node;
+
+    QString name = QString::fromUtf8(metaObject->className()) + QLatin1Char('(');
+    if (object->objectName().isEmpty())
+        name += QLatin1String("0x") + QString::number(quintptr(object), 16);
+    else
+        name += object->objectName();
+    name += QLatin1String(").") + QString::fromUtf8(metaObject->property(coreIndex).name());
+
+    const Node node = { PropertyNode, name, 0 };
+    m_nodes.append(node);
+    const PropertyInfo info = { m_nodes.size() - 1, metaObject };
+    m_properties.insert(key, info);
+    return info.node;
+}
+
+void QQmlBindingGraph::addDependency(int property, int expression,
+                                     QQmlJavaScriptExpressionGuard *guard)
+{
+    const QPair<int, int> key(property, expression);
+    int edge = m_dependencies.value(key, -1);
+    if (edge == -1) {
+        const Edge e = { property, expression, DependencyEdge, 0 };
+        m_edges.append(e);
+        edge = m_edges.size() - 1;
+        m_dependencies.insert(key, edge);
+    }
+    // Guards are recycled, so this replaces whatever the guard was connected to before.
+    m_guards.insert(guard, edge);
+}
+
+void QQmlBindingGraph::captureProperty(QQmlJavaScriptExpression *expression,
+                                       QQmlJavaScriptExpressionGuard *guard, QObject *object,
+                                       int coreIndex)
+{
+    QMutexLocker locker(&m_mutex);
+    addDependency(propertyNode(object, coreIndex), expressionNode(expression), guard);
+}
+
+void QQmlBindingGraph::captureProperty(QQmlJavaScriptExpression *expression,
+                                       QQmlJavaScriptExpressionGuard *guard,
+                                       QQmlNotifier *notifier)
+{
+    QMutexLocker locker(&m_mutex);
+    const PropertyKey key = { notifier, -1 };
+    QHash<PropertyKey, PropertyInfo>::ConstIterator it = m_properties.constFind(key);
+    int property;
+    if (it != m_properties.constEnd()) {
+        property = it.value().node;
+    } else {
+        const Node node = { NotifierNode, QLatin1String("QQmlNotifier(0x")
+                            + QString::number(quintptr(notifier), 16) + QLatin1Char(')'), 0 };
+        m_nodes.append(node);
+        property = m_nodes.size() - 1;
+        const PropertyInfo info = { property, 0 };
+        m_properties.insert(key, info);
+    }
+    addDependency(property, expressionNode(expression), guard);
+}
+
+void QQmlBindingGraph::startTrigger(QQmlJavaScriptExpressionGuard *guard)
+{
+    QMutexLocker locker(&m_mutex);
+    const int edge = m_guards.value(guard, -1);
+    if (edge == -1)
+        return;
+    ++m_edges[edge].triggers;
+    m_activeTriggers.insert(guard->expression, edge);
+}
+
+void QQmlBindingGraph::finishTrigger(QQmlJavaScriptExpression *expression)
+{
+    QMutexLocker locker(&m_mutex);
+    m_activeTriggers.remove(expression);
+}
+
+QString QQmlBindingGraph::bindingUpdated(QQmlJavaScriptExpression *binding, QObject *target,
+                                         int coreIndex)
+{
+    QMutexLocker locker(&m_mutex);
+    const int node = expressionNode(binding);
+    ++m_nodes[node].evaluations;
+
+    if (target && coreIndex != -1) {
+        const int property = propertyNode(target, coreIndex);
+        const QPair<int, int> key(node, property);
+        if (!m_writes.contains(key)) {
+            const Edge e = { node, property, WriteEdge, 0 };
+            m_edges.append(e);
+            m_writes.insert(key);
+        }
+    }
+
+    const int edge = m_activeTriggers.value(binding, -1);
+    return edge == -1 ? QString() : m_nodes.at(m_edges.at(edge).from).name;
+}
+
+void QQmlBindingGraph::expressionDestroyed(QQmlJavaScriptExpression *expression)
+{
+    QMutexLocker locker(&m_mutex);
+    m_expressions.remove(expression);
+    m_activeTriggers.remove(expression);
+}
+
+QVector<QQmlBindingGraph::Node> QQmlBindingGraph::nodes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_nodes;
+}
+
+QVector<QQmlBindingGraph::Edge> QQmlBindingGraph::edges() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_edges;
+}
+
+static const char *nodeKindName(QQmlBindingGraph::NodeKind kind)
+{
+    switch (kind) {
+    case QQmlBindingGraph::PropertyNode:
+        return "property";
+    case QQmlBindingGraph::NotifierNode:
+        return "notifier";
+    default:
+        return "expression";
+    }
+}
+
+QByteArray QQmlBindingGraph::toJson() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    QJsonArray nodes;
+    for (int i = 0; i < m_nodes.size(); ++i) {
+        const Node &n = m_nodes.at(i);
+        QJsonObject node;
+        node.insert(QStringLiteral("id"), i);
+        node.insert(QStringLiteral("kind"), QLatin1String(nodeKindName(n.kind)));
+        node.insert(QStringLiteral("name"), n.name);
+        if (n.kind == ExpressionNode)
+            node.insert(QStringLiteral("evaluations"), n.evaluations);
+        nodes.append(node);
+    }
+
+    QJsonArray edges;
+    foreach (const Edge &e, m_edges) {
+        QJsonObject edge;
+        edge.insert(QStringLiteral("from"), e.from);
+        edge.insert(QStringLiteral("to"), e.to);
+        if (e.kind == DependencyEdge) {
+            edge.insert(QStringLiteral("kind"), QStringLiteral("dependency"));
+            edge.insert(QStringLiteral("triggers"), e.triggers);
+        } else {
+            edge.insert(QStringLiteral("kind"), QStringLiteral("write"));
+        }
+        edges.append(edge);
+    }
+
+    QJsonObject graph;
+    graph.insert(QStringLiteral("nodes"), nodes);
+    graph.insert(QStringLiteral("edges"), edges);
+    return QJsonDocument(graph).toJson();
+}
+
+static QByteArray escapeDot(const QString &label)
+{
+    QByteArray escaped = label.toUtf8();
+    escaped.replace('\\', "\\\\");
+    escaped.replace('"', "\\\"");
+    return escaped;
+}
+
+QByteArray QQmlBindingGraph::toDot() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    QByteArray dot("digraph bindings {\n");
+    for (int i = 0; i < m_nodes.size(); ++i) {
+        const Node &n = m_nodes.at(i);
+        dot += "    n" + QByteArray::number(i) + " [label=\"" + escapeDot(n.name);
+        if (n.kind == ExpressionNode)
+            dot += "\\n" + QByteArray::number(n.evaluations) + " evaluations\" shape=box";
+        else
+            dot += '"';
+        dot += "];\n";
+    }
+    foreach (const Edge &e, m_edges) {
+        dot += "    n" + QByteArray::number(e.from) + " -> n" + QByteArray::number(e.to);
+        if (e.kind == DependencyEdge)
+            dot += " [label=\"" + QByteArray::number(e.triggers) + "\"]";
+        else
+            dot += " [style=dashed]";
+        dot += ";\n";
+    }
+    dot += "}\n";
+    return dot;
+}
+
+bool QQmlBindingGraph::save(const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    const bool dot = fileName.endsWith(QLatin1String(".dot"), Qt::CaseInsensitive);
+    return file.write(dot ? toDot() : toJson()) != -1;
+}
+
+/*
+    Writes the graph to the file named by QML_BINDING_GRAPH, if any. As the graph is shared by
+    all engines, the file always contains everything recorded so far.
+*/
+void QQmlBindingGraph::save() const
+{
+    if (!m_fileName.isEmpty() && !save(m_fileName))
+        qWarning("QQmlBindingGraph: Cannot write %s", qPrintable(m_fileName));
+}
+
+QT_END_NAMESPACE
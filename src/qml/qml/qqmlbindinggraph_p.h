@@ -0,0 +1,178 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQml module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QQMLBINDINGGRAPH_P_H
+#define QQMLBINDINGGRAPH_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qtqmlglobal_p.h>
+
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qpair.h>
+#include <QtCore/qset.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+class QObject;
+class QMetaObject;
+class QQmlNotifier;
+class QQmlJavaScriptExpression;
+class QQmlJavaScriptExpressionGuard;
+
+// Records which properties each expression captured, which properties bindings write and how
+// often each dependency caused a re-evaluation. Enabled by setting QML_BINDING_GRAPH to the
+// file the graph is written to whenever an engine is destroyed: as Graphviz DOT if the name
+// ends in ".dot", as JSON otherwise. This is meant for finding fan-out hotspots and binding
+// cycles, and it slows down every capture and binding update.
+//
+// Properties are identified by the address of their object, so a property of a deleted object
+// may be merged with one of a new object of the same class at the same address.
+class Q_QML_PRIVATE_EXPORT QQmlBindingGraph
+{
+public:
+    enum NodeKind {
+        PropertyNode,
+        NotifierNode,
+        ExpressionNode
+    };
+
+    enum EdgeKind {
+        DependencyEdge, // from a property to the expression that captured it
+        WriteEdge       // from a binding to its target property
+    };
+
+    struct Node {
+        NodeKind kind;
+        QString name;
+        int evaluations;    // expressions only
+    };
+
+    struct Edge {
+        int from;
+        int to;
+        EdgeKind kind;
+        int triggers;       // re-evaluations caused through a dependency edge
+    };
+
+    // 0 unless recording was enabled with QML_BINDING_GRAPH or enable().
+    static QQmlBindingGraph *instance();
+    static void enable();
+
+    void captureProperty(QQmlJavaScriptExpression *expression,
+                         QQmlJavaScriptExpressionGuard *guard, QObject *object, int coreIndex);
+    void captureProperty(QQmlJavaScriptExpression *expression,
+                         QQmlJavaScriptExpressionGuard *guard, QQmlNotifier *notifier);
+
+    // The guard of a dependency has fired; the expression is re-evaluated until the matching
+    // finishTrigger(). Triggers nest when the re-evaluation causes further notifications.
+    void startTrigger(QQmlJavaScriptExpressionGuard *guard);
+    void finishTrigger(QQmlJavaScriptExpression *expression);
+
+    // Counts an update of the binding and records its target. Returns the name of the
+    // dependency that triggered the update, or an empty string if it wasn't triggered by one.
+    QString bindingUpdated(QQmlJavaScriptExpression *binding, QObject *target, int coreIndex);
+
+    // Keeps the node, but a new expression at the same address gets a new one.
+    void expressionDestroyed(QQmlJavaScriptExpression *expression);
+
+    QVector<Node> nodes() const;
+    QVector<Edge> edges() const;
+
+    QByteArray toJson() const;
+    QByteArray toDot() const;
+    bool save(const QString &fileName) const;
+    void save() const;
+
+private:
+    struct PropertyKey {
+        const void *source;
+        int index;
+
+        bool operator==(const PropertyKey &other) const
+        { return source == other.source && index == other.index; }
+    };
+    friend uint qHash(const PropertyKey &key, uint seed)
+    { return qHash(key.source, seed) ^ qHash(key.index, seed); }
+
+    struct PropertyInfo {
+        int node;
+        const QMetaObject *metaObject;
+    };
+
+    QQmlBindingGraph(const QString &fileName);
+    static QQmlBindingGraph *fromEnvironment();
+    static QQmlBindingGraph **instancePointer();
+
+    int expressionNode(QQmlJavaScriptExpression *expression);
+    int propertyNode(QObject *object, int coreIndex);
+    void addDependency(int property, int expression, QQmlJavaScriptExpressionGuard *guard);
+
+    mutable QMutex m_mutex;
+    QString m_fileName;
+    QVector<Node> m_nodes;
+    QVector<Edge> m_edges;
+    QHash<PropertyKey, PropertyInfo> m_properties;
+    QHash<QQmlJavaScriptExpression *, int> m_expressions;
+    QHash<QPair<int, int>, int> m_dependencies; // (property, expression) -> edge
+    QSet<QPair<int, int> > m_writes;            // (binding, property)
+    QHash<QQmlJavaScriptExpressionGuard *, int> m_guards; // guard -> dependency edge
+    QHash<QQmlJavaScriptExpression *, int> m_activeTriggers; // expression -> dependency edge
+};
+
+Q_DECLARE_TYPEINFO(QQmlBindingGraph::Node, Q_MOVABLE_TYPE);
+Q_DECLARE_TYPEINFO(QQmlBindingGraph::Edge, Q_PRIMITIVE_TYPE);
+
+QT_END_NAMESPACE
+
+#endif // QQMLBINDINGGRAPH_P_H
@@ -0,0 +1,539 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQml module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qqmlbindingprogram_p.h"
+
+#include <private/qqmlengine_p.h>
+#include <private/qqmlcontext_p.h>
+#include <private/qqmldata_p.h>
+#include <private/qqmlpropertycache_p.h>
+#include <private/qqmlaccessors_p.h>
+#include <private/qv4engine_p.h>
+#include <private/qv4runtime_p.h>
+#include <private/qv4qobjectwrapper_p.h>
+#include <private/qv4jsir_p.h>
+
+#include <QtCore/qvarlengtharray.h>
+#include <QtCore/qnumeric.h>
+
+#include <limits.h>
+#include <math.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+struct Register
+{
+    enum Type { Undefined, Null, Boolean, Number, String, Object };
+
+    Register() : type(Undefined), boolean(false), number(0), object(0) {}
+
+    void setUndefined() { type = Undefined; }
+    void setNull() { type = Null; }
+    void setBoolean(bool b) { type = Boolean; boolean = b; }
+    void setNumber(double d) { type = Number; number = d; }
+    void setString(const QString &s) { type = String; string = s; }
+    void setObject(QObject *o)
+    {
+        // Mirrors QObjectWrapper::wrap(), for which deleted objects are null.
+        if (!o || QQmlData::wasDeleted(o)) {
+            type = Null;
+        } else {
+            type = Object;
+            object = o;
+        }
+    }
+
+    Type type;
+    bool boolean;
+    double number;
+    QString string;
+    QObject *object;
+};
+
+}
+
+static bool toBoolean(const Register &r)
+{
+    switch (r.type) {
+    case Register::Undefined:
+    case Register::Null:
+        return false;
+    case Register::Boolean:
+        return r.boolean;
+    case Register::Number:
+        return r.number != 0 && !qIsNaN(r.number);
+    case Register::String:
+        return !r.string.isEmpty();
+    case Register::Object:
+        return true;
+    }
+    return false;
+}
+
+// Objects would need ToPrimitive, which may call back into JavaScript.
+static bool toNumber(const Register &r, double *out)
+{
+    switch (r.type) {
+    case Register::Undefined:
+        *out = qSNaN();
+        return true;
+    case Register::Null:
+        *out = 0;
+        return true;
+    case Register::Boolean:
+        *out = r.boolean ? 1 : 0;
+        return true;
+    case Register::Number:
+        *out = r.number;
+        return true;
+    case Register::String:
+        *out = QV4::RuntimeHelpers::stringToNumber(r.string);
+        return true;
+    case Register::Object:
+        break;
+    }
+    return false;
+}
+
+static bool toString(const Register &r, QString *out)
+{
+    switch (r.type) {
+    case Register::Undefined:
+        *out = QStringLiteral("undefined");
+        return true;
+    case Register::Null:
+        *out = QStringLiteral("null");
+        return true;
+    case Register::Boolean:
+        *out = r.boolean ? QStringLiteral("true") : QStringLiteral("false");
+        return true;
+    case Register::Number:
+        QV4::RuntimeHelpers::numberToString(out, r.number);
+        return true;
+    case Register::String:
+        *out = r.string;
+        return true;
+    case Register::Object:
+        break;
+    }
+    return false;
+}
+
+static bool strictEqual(const Register &l, const Register &r)
+{
+    if (l.type != r.type)
+        return false;
+    switch (l.type) {
+    case Register::Undefined:
+    case Register::Null:
+        return true;
+    case Register::Boolean:
+        return l.boolean == r.boolean;
+    case Register::Number:
+        return l.number == r.number;
+    case Register::String:
+        return l.string == r.string;
+    case Register::Object:
+        return l.object == r.object;
+    }
+    return false;
+}
+
+static bool looseEqual(const Register &l, const Register &r, bool *out)
+{
+    if (l.type == r.type) {
+        *out = strictEqual(l, r);
+        return true;
+    }
+
+    const bool lNullish = l.type == Register::Undefined || l.type == Register::Null;
+    const bool rNullish = r.type == Register::Undefined || r.type == Register::Null;
+    if (lNullish || rNullish) {
+        *out = lNullish && rNullish;
+        return true;
+    }
+
+    // Booleans, numbers and strings of different types compare as numbers.
+    double a, b;
+    if (!toNumber(l, &a) || !toNumber(r, &b))
+        return false;
+    *out = a == b;
+    return true;
+}
+
+static bool compare(QV4::IR::AluOp op, const Register &l, const Register &r, Register *out)
+{
+    if (l.type == Register::String && r.type == Register::String) {
+        const int c = l.string.compare(r.string);
+        switch (op) {
+        case QV4::IR::OpGt: out->setBoolean(c > 0); break;
+        case QV4::IR::OpLt: out->setBoolean(c < 0); break;
+        case QV4::IR::OpGe: out->setBoolean(c >= 0); break;
+        case QV4::IR::OpLe: out->setBoolean(c <= 0); break;
+        default: return false;
+        }
+        return true;
+    }
+
+    double a, b;
+    if (!toNumber(l, &a) || !toNumber(r, &b))
+        return false;
+    switch (op) {
+    case QV4::IR::OpGt: out->setBoolean(a > b); break;
+    case QV4::IR::OpLt: out->setBoolean(a < b); break;
+    case QV4::IR::OpGe: out->setBoolean(a >= b); break;
+    case QV4::IR::OpLe: out->setBoolean(a <= b); break;
+    default: return false;
+    }
+    return true;
+}
+
+static bool unop(QV4::IR::AluOp op, const Register &in, Register *out)
+{
+    double d;
+    switch (op) {
+    case QV4::IR::OpIfTrue:
+        out->setBoolean(toBoolean(in));
+        return true;
+    case QV4::IR::OpNot:
+        out->setBoolean(!toBoolean(in));
+        return true;
+    case QV4::IR::OpUMinus:
+        if (!toNumber(in, &d))
+            return false;
+        out->setNumber(-d);
+        return true;
+    case QV4::IR::OpUPlus:
+        if (!toNumber(in, &d))
+            return false;
+        out->setNumber(d);
+        return true;
+    case QV4::IR::OpCompl:
+        if (!toNumber(in, &d))
+            return false;
+        out->setNumber(~QV4::Primitive::toInt32(d));
+        return true;
+    default:
+        break;
+    }
+    return false;
+}
+
+static bool binop(QV4::IR::AluOp op, const Register &l, const Register &r, Register *out)
+{
+    switch (op) {
+    case QV4::IR::OpAdd:
+        if (l.type == Register::Object || r.type == Register::Object)
+            return false;
+        if (l.type == Register::String || r.type == Register::String) {
+            QString a, b;
+            toString(l, &a);
+            toString(r, &b);
+            out->setString(a + b);
+            return true;
+        }
+        break;
+    case QV4::IR::OpGt:
+    case QV4::IR::OpLt:
+    case QV4::IR::OpGe:
+    case QV4::IR::OpLe:
+        return compare(op, l, r, out);
+    case QV4::IR::OpEqual:
+    case QV4::IR::OpNotEqual: {
+        bool equal;
+        if (!looseEqual(l, r, &equal))
+            return false;
+        out->setBoolean(op == QV4::IR::OpEqual ? equal : !equal);
+        return true;
+    }
+    case QV4::IR::OpStrictEqual:
+        out->setBoolean(strictEqual(l, r));
+        return true;
+    case QV4::IR::OpStrictNotEqual:
+        out->setBoolean(!strictEqual(l, r));
+        return true;
+    default:
+        break;
+    }
+
+    double a, b;
+    if (!toNumber(l, &a) || !toNumber(r, &b))
+        return false;
+
+    switch (op) {
+    case QV4::IR::OpAdd: out->setNumber(a + b); break;
+    case QV4::IR::OpSub: out->setNumber(a - b); break;
+    case QV4::IR::OpMul: out->setNumber(a * b); break;
+    case QV4::IR::OpDiv: out->setNumber(a / b); break;
+    case QV4::IR::OpMod: out->setNumber(::fmod(a, b)); break;
+    case QV4::IR::OpBitAnd:
+        out->setNumber(QV4::Primitive::toInt32(a) & QV4::Primitive::toInt32(b));
+        break;
+    case QV4::IR::OpBitOr:
+        out->setNumber(QV4::Primitive::toInt32(a) | QV4::Primitive::toInt32(b));
+        break;
+    case QV4::IR::OpBitXor:
+        out->setNumber(QV4::Primitive::toInt32(a) ^ QV4::Primitive::toInt32(b));
+        break;
+    case QV4::IR::OpLShift:
+        out->setNumber(QV4::Primitive::toInt32(a) << (QV4::Primitive::toUInt32(b) & 0x1f));
+        break;
+    case QV4::IR::OpRShift:
+        out->setNumber(QV4::Primitive::toInt32(a) >> (QV4::Primitive::toUInt32(b) & 0x1f));
+        break;
+    case QV4::IR::OpURShift:
+        out->setNumber(QV4::Primitive::toUInt32(a) >> (QV4::Primitive::toUInt32(b) & 0x1f));
+        break;
+    default:
+        return false;
+    }
+    return true;
+}
+
+// Reads a property the way QObjectWrapper::getProperty() does, restricted
+// to the types a register can hold.
+static bool readProperty(QQmlEnginePrivate *ep, QObject *object, const QQmlPropertyData &property,
+                         Register *out)
+{
+    if (property.isFunction() || property.isVarProperty() || property.isQList())
+        return false;
+
+    union {
+        QObject *o;
+        double d;
+        float f;
+        int i;
+        uint u;
+        bool b;
+    } storage;
+    QString string;
+    void *data = 0;
+
+    const int type = property.propType;
+    if (property.isQObject()) {
+        storage.o = 0;
+        data = &storage.o;
+    } else if (type == QMetaType::QReal || type == QMetaType::Double) {
+        storage.d = 0;
+        data = &storage.d;
+    } else if (type == QMetaType::Float) {
+        storage.f = 0;
+        data = &storage.f;
+    } else if (type == QMetaType::Int || property.isEnum()) {
+        storage.i = 0;
+        data = &storage.i;
+    } else if (type == QMetaType::UInt) {
+        storage.u = 0;
+        data = &storage.u;
+    } else if (type == QMetaType::Bool) {
+        storage.b = false;
+        data = &storage.b;
+    } else if (type == QMetaType::QString) {
+        data = &string;
+    } else {
+        return false;
+    }
+
+    QQmlData::flushPendingBinding(object, property.coreIndex);
+
+    if (property.hasAccessors()) {
+        property.accessors->read(object, property.accessorData, data);
+        if (ep->propertyCapture) {
+            if (property.accessors->notifier) {
+                QQmlNotifier *n = 0;
+                property.accessors->notifier(object, property.accessorData, &n);
+                if (n)
+                    ep->captureProperty(n);
+            } else {
+                ep->captureProperty(object, property.coreIndex, property.notifyIndex);
+            }
+        }
+    } else {
+        if (!property.isConstant())
+            ep->captureProperty(object, property.coreIndex, property.notifyIndex);
+
+        void *args[] = { data, 0 };
+        if (property.isDirect())
+            object->qt_metacall(QMetaObject::ReadProperty, property.coreIndex, args);
+        else
+            QMetaObject::metacall(object, QMetaObject::ReadProperty, property.coreIndex, args);
+    }
+
+    if (property.isQObject())
+        out->setObject(storage.o);
+    else if (type == QMetaType::QReal || type == QMetaType::Double)
+        out->setNumber(storage.d);
+    else if (type == QMetaType::Float)
+        out->setNumber(storage.f);
+    else if (type == QMetaType::Int || property.isEnum())
+        out->setNumber(storage.i);
+    else if (type == QMetaType::UInt)
+        out->setNumber(storage.u);
+    else if (type == QMetaType::Bool)
+        out->setBoolean(storage.b);
+    else
+        out->setString(string);
+    return true;
+}
+
+static QV4::ReturnedValue toReturnedValue(QV4::ExecutionEngine *v4, const Register &r)
+{
+    switch (r.type) {
+    case Register::Undefined:
+        break;
+    case Register::Null:
+        return QV4::Encode::null();
+    case Register::Boolean:
+        return QV4::Encode(r.boolean);
+    case Register::Number:
+        // Integral results are encoded as integers, as the function returns them.
+        if (r.number >= INT_MIN && r.number <= INT_MAX) {
+            const int i = static_cast<int>(r.number);
+            if (i == r.number && !(i == 0 && std::signbit(r.number)))
+                return QV4::Encode(i);
+        }
+        return QV4::Encode(r.number);
+    case Register::String:
+        return v4->newString(r.string)->asReturnedValue();
+    case Register::Object:
+        return QV4::QObjectWrapper::wrap(v4, r.object);
+    }
+    return QV4::Encode::undefined();
+}
+
+bool QQmlBindingProgram::run(QV4::ExecutionEngine *v4, QQmlContextData *context,
+                             QObject *scopeObject, QV4::ReturnedValue *result) const
+{
+    QQmlEnginePrivate *ep = QQmlEnginePrivate::get(context->engine);
+    QVarLengthArray<Register, 16> registers(registerCount);
+
+    const Instruction *code = instructions.constData();
+    const int count = instructions.count();
+    int pc = 0;
+    while (pc < count) {
+        const Instruction &i = code[pc++];
+        switch (i.opcode) {
+        case LoadUndefined:
+            registers[i.result].setUndefined();
+            break;
+        case LoadNull:
+            registers[i.result].setNull();
+            break;
+        case LoadBool:
+            registers[i.result].setBoolean(i.index != 0);
+            break;
+        case LoadNumber:
+            registers[i.result].setNumber(numbers.at(i.index));
+            break;
+        case LoadString:
+            registers[i.result].setString(strings.at(i.index));
+            break;
+        case LoadScopeObject:
+            registers[i.result].setObject(scopeObject);
+            break;
+        case LoadContextObject:
+            registers[i.result].setObject(context->contextObject);
+            break;
+        case LoadIdObject:
+            if (i.index >= context->idValueCount)
+                return false;
+            ep->captureProperty(&context->idValues[i.index].bindings);
+            registers[i.result].setObject(context->idValues[i.index].data());
+            break;
+        case LoadProperty: {
+            const Register &base = registers[i.a];
+            if (base.type != Register::Object || QQmlData::wasDeleted(base.object))
+                return false;
+            QQmlData *ddata = QQmlData::get(base.object);
+            if (!ddata || !ddata->propertyCache)
+                return false;
+            QQmlPropertyData *property = ddata->propertyCache->property(i.index);
+            if (!property || !readProperty(ep, base.object, *property, &registers[i.result]))
+                return false;
+            break;
+        }
+        case LoadNamedProperty: {
+            const Register &base = registers[i.a];
+            if (base.type != Register::Object || QQmlData::wasDeleted(base.object))
+                return false;
+            QQmlPropertyData local;
+            QQmlPropertyData *property = QQmlPropertyCache::property(context->engine, base.object,
+                                                                     strings.at(i.index),
+                                                                     context, local);
+            if (!property || !readProperty(ep, base.object, *property, &registers[i.result]))
+                return false;
+            break;
+        }
+        case Move:
+            if (i.result != i.a)
+                registers[i.result] = registers[i.a];
+            break;
+        case Unop: {
+            Register value;
+            if (!unop(QV4::IR::AluOp(i.aluOp), registers[i.a], &value))
+                return false;
+            registers[i.result] = value;
+            break;
+        }
+        case Binop: {
+            Register value;
+            if (!binop(QV4::IR::AluOp(i.aluOp), registers[i.a], registers[i.b], &value))
+                return false;
+            registers[i.result] = value;
+            break;
+        }
+        case Jump:
+            pc = i.index;
+            break;
+        case CJump:
+            pc = toBoolean(registers[i.a]) ? i.index : i.b;
+            break;
+        case Ret:
+            *result = toReturnedValue(v4, registers[i.a]);
+            return true;
+        }
+    }
+    return false;
+}
+
+QT_END_NAMESPACE
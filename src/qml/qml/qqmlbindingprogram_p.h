@@ -0,0 +1,121 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQml module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QQMLBINDINGPROGRAM_P_H
+#define QQMLBINDINGPROGRAM_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qqmlrefcount_p.h>
+#include <private/qv4value_p.h>
+
+#include <QtCore/qvector.h>
+#include <QtCore/qstring.h>
+
+QT_BEGIN_NAMESPACE
+
+class QObject;
+class QQmlContextData;
+
+// A binding expression that only reads properties and combines them with
+// operators, translated by the type compiler from the IR of the binding's
+// function.  Running it does not enter the JavaScript engine; the values
+// it reads are captured as dependencies just like the function would.
+//
+// Registers correspond to the temporaries of the IR function.  Programs
+// only ever read, so they can give up at any point, for example on a value
+// they cannot represent, and leave the evaluation to the function.
+class Q_QML_PRIVATE_EXPORT QQmlBindingProgram : public QQmlRefCount
+{
+public:
+    enum Opcode {
+        LoadUndefined,      // result
+        LoadNull,           // result
+        LoadBool,           // result, index: value
+        LoadNumber,         // result, index: into numbers
+        LoadString,         // result, index: into strings
+        LoadScopeObject,    // result
+        LoadContextObject,  // result
+        LoadIdObject,       // result, index: id index
+        LoadProperty,       // result, a: object, index: core index
+        LoadNamedProperty,  // result, a: object, index: name in strings
+        Move,               // result, a
+        Unop,               // result, a, aluOp
+        Binop,              // result, a, b, aluOp
+        Jump,               // index: target instruction
+        CJump,              // a: condition, index: target if true, b: target if false
+        Ret                 // a
+    };
+
+    struct Instruction {
+        quint8 opcode;
+        quint8 aluOp; // QV4::IR::AluOp
+        quint16 result;
+        quint16 a;
+        quint16 b;
+        int index;
+    };
+
+    QQmlBindingProgram() : registerCount(0) {}
+
+    QVector<Instruction> instructions;
+    QVector<double> numbers;
+    QVector<QString> strings;
+    int registerCount;
+
+    // Returns false if the program could not produce the result, in which
+    // case the binding has to be evaluated by its function instead.
+    bool run(QV4::ExecutionEngine *v4, QQmlContextData *context, QObject *scopeObject,
+             QV4::ReturnedValue *result) const;
+};
+
+QT_END_NAMESPACE
+
+#endif // QQMLBINDINGPROGRAM_P_H
@@ -262,27 +262,52 @@ void QQmlBoundSignalExpression::evaluate(void **a)
         int *argsTypes = QQmlPropertyCache::methodParameterTypes(m_target, methodIndex, dummy, 0);
         int argCount = argsTypes ? *argsTypes : 0;
 
+        // The conversions are cached in the property cache, so that the
+        // arguments are written straight into the call data
+        const uchar *conversions = argCount ? QQmlPropertyCache::signalArgumentConversions(ep, m_target, methodIndex, argsTypes) : 0;
+
         QV4::ScopedValue f(scope, m_v8function.value());
         QV4::ScopedCallData callData(scope, argCount);
         for (int ii = 0; ii < argCount; ++ii) {
             int type = argsTypes[ii + 1];
+            void *arg = a[ii + 1];
             //### ideally we would use metaTypeToJS, however it currently gives different results
             //    for several cases (such as QVariant type and QObject-derived types)
             //args[ii] = engine->metaTypeToJS(type, a[ii + 1]);
-            if (type == QMetaType::QVariant) {
-                callData->args[ii] = engine->fromVariant(*((QVariant *)a[ii + 1]));
-            } else if (type == QMetaType::Int) {
-                //### optimization. Can go away if we switch to metaTypeToJS, or be expanded otherwise
-                callData->args[ii] = QV4::Primitive::fromInt32(*reinterpret_cast<const int*>(a[ii + 1]));
-            } else if (type == qMetaTypeId<QQmlV4Handle>()) {
-                callData->args[ii] = *reinterpret_cast<QQmlV4Handle *>(a[ii + 1]);
-            } else if (ep->isQObject(type)) {
-                if (!*reinterpret_cast<void* const *>(a[ii + 1]))
+            switch (conversions ? conversions[ii] : QQmlPropertyCache::signalArgumentConversion(ep, type)) {
+            case QQmlPropertyCache::ConvertQVariant:
+                callData->args[ii] = engine->fromVariant(*reinterpret_cast<QVariant *>(arg));
+                break;
+            case QQmlPropertyCache::ConvertInt:
+                callData->args[ii] = QV4::Primitive::fromInt32(*reinterpret_cast<const int *>(arg));
+                break;
+            case QQmlPropertyCache::ConvertUInt:
+                callData->args[ii] = QV4::Encode(*reinterpret_cast<const uint *>(arg));
+                break;
+            case QQmlPropertyCache::ConvertBool:
+                callData->args[ii] = QV4::Primitive::fromBoolean(*reinterpret_cast<const bool *>(arg));
+                break;
+            case QQmlPropertyCache::ConvertDouble:
+                callData->args[ii] = QV4::Encode(*reinterpret_cast<const double *>(arg));
+                break;
+            case QQmlPropertyCache::ConvertFloat:
+                callData->args[ii] = QV4::Encode(*reinterpret_cast<const float *>(arg));
+                break;
+            case QQmlPropertyCache::ConvertString:
+                callData->args[ii] = ep->v4engine()->newString(*reinterpret_cast<const QString *>(arg));
+                break;
+            case QQmlPropertyCache::ConvertV4Handle:
+                callData->args[ii] = *reinterpret_cast<QQmlV4Handle *>(arg);
+                break;
+            case QQmlPropertyCache::ConvertQObject:
+                if (!*reinterpret_cast<void* const *>(arg))
                     callData->args[ii] = QV4::Primitive::nullValue();
                 else
-                    callData->args[ii] = QV4::QObjectWrapper::wrap(ep->v4engine(), *reinterpret_cast<QObject* const *>(a[ii + 1]));
-            } else {
-                callData->args[ii] = engine->fromVariant(QVariant(type, a[ii + 1]));
+                    callData->args[ii] = QV4::QObjectWrapper::wrap(ep->v4engine(), *reinterpret_cast<QObject* const *>(arg));
+                break;
+            default:
+                callData->args[ii] = engine->fromVariant(QVariant(type, arg));
+                break;
             }
         }
 
@@ -63,11 +63,13 @@
 #include <private/qqmlrefcount_p.h>
 #include <private/qqmlglobal_p.h>
 #include <private/qbitfield_p.h>
+#include <private/qqmlsizeclasspool_p.h>
 
 QT_BEGIN_NAMESPACE
 
 class Q_QML_PRIVATE_EXPORT QQmlBoundSignalExpression : public QQmlAbstractExpression, public QQmlJavaScriptExpression, public QQmlRefCount
 {
+    Q_QML_SIZE_CLASS_POOLED
 public:
     QQmlBoundSignalExpression(QObject *target, int index,
                               QQmlContextData *ctxt, QObject *scope, const QString &expression,
@@ -156,6 +158,7 @@ private:
 class Q_QML_PRIVATE_EXPORT QQmlBoundSignal : public QQmlAbstractBoundSignal,
                                              public QQmlNotifierEndpoint
 {
+    Q_QML_SIZE_CLASS_POOLED
 public:
     QQmlBoundSignal(QObject *target, int signal, QObject *owner, QQmlEngine *engine);
     virtual ~QQmlBoundSignal();
@@ -63,6 +63,13 @@ QQmlCompiledData::QQmlCompiledData(QQmlEngine *engine)
     Q_ASSERT(engine);
 }
 
+QQmlCompiledData::CreationPlan *QQmlCompiledData::creationPlan(int objectIndex)
+{
+    if (creationPlans.isEmpty())
+        creationPlans.resize(qmlUnit->nObjects);
+    return &creationPlans[objectIndex];
+}
+
 void QQmlCompiledData::destroy()
 {
     if (engine && hasEngine())
@@ -95,6 +102,10 @@ QQmlCompiledData::~QQmlCompiledData()
     for (int ii = 0; ii < scripts.count(); ++ii)
         scripts.at(ii)->release();
 
+    for (int ii = 0; ii < bindingPrograms.count(); ++ii)
+        if (bindingPrograms.at(ii))
+            bindingPrograms.at(ii)->release();
+
     if (importCache)
         importCache->release();
 
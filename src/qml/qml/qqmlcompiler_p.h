@@ -63,6 +63,7 @@
 #include "private/qv4identifier_p.h"
 #include <private/qqmljsastfwd_p.h>
 #include "qqmlcustomparser_p.h"
+#include "qqmlbindingprogram_p.h"
 
 #include <QtCore/qbytearray.h>
 #include <QtCore/qset.h>
@@ -144,10 +145,25 @@ public:
     QHash<int, CustomParserData> customParserData;
     QVector<int> customParserBindings; // index is binding identifier, value is compiled function index.
     QHash<int, QBitArray> deferredBindingsPerObject; // index is object index
+    QVector<QQmlBindingProgram *> bindingPrograms; // index is runtime function index
     int totalBindingsCount; // Number of bindings used in this type
     int totalParserStatusCount; // Number of instantiated types that are QQmlParserStatus subclasses
     int totalObjectCount; // Number of objects explicitly instantiated
 
+    // The properties that the id and the bindings of an object resolved to when it
+    // was first instantiated.  Later instantiations reuse them instead of looking up
+    // each property by name again.
+    struct CreationPlan {
+        CreationPlan() : recorded(false), idProperty(0) {}
+
+        bool recorded;
+        QQmlPropertyData *idProperty;
+        QVector<QQmlPropertyData *> bindingProperties; // index is binding index
+        QBitArray bindingLookups; // set if the property differs from the previous binding's
+    };
+    QVector<CreationPlan> creationPlans; // index is object index, filled on demand
+    CreationPlan *creationPlan(int objectIndex);
+
     bool isComponent(int objectIndex) const { return objectIndexToIdPerComponent.contains(objectIndex); }
     bool isCompositeType() const { return !metaObjects.at(qmlUnit->indexOfRootObject).isEmpty(); }
 
@@ -157,6 +173,9 @@ public:
     QV4::Function *functionForBindingId(int bindingId) const
     { return compilationUnit->runtimeFunctions[customParserBindings[bindingId]]; }
 
+    QQmlBindingProgram *bindingProgram(int functionIndex) const
+    { return functionIndex < bindingPrograms.count() ? bindingPrograms.at(functionIndex) : 0; }
+
 protected:
     virtual void destroy(); // From QQmlRefCount
     virtual void clear(); // From QQmlCleanup
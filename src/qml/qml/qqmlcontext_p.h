@@ -67,6 +67,7 @@
 #include <private/qobject_p.h>
 #include <private/qflagpointer_p.h>
 #include <private/qqmlguard_p.h>
+#include <private/qqmlsizeclasspool_p.h>
 
 #include <private/qv4identifier_p.h>
 
@@ -109,6 +110,7 @@ class QQmlComponentAttached;
 class QQmlGuardedContextData;
 class Q_QML_PRIVATE_EXPORT QQmlContextData
 {
+    Q_QML_SIZE_CLASS_POOLED
 public:
     QQmlContextData();
     QQmlContextData(QQmlContext *);
@@ -69,8 +69,6 @@ namespace CompiledData {
 struct Function;
 }
 
-struct QQmlIdObjectsArray;
-
 struct Q_QML_EXPORT QmlContextWrapper : Object
 {
     V4_OBJECT
@@ -92,11 +90,10 @@ struct Q_QML_EXPORT QmlContextWrapper : Object
     static ReturnedValue get(Managed *m, const StringRef name, bool *hasProperty);
     static void put(Managed *m, const StringRef name, const ValueRef value);
     static void destroy(Managed *that);
-    static void markObjects(Managed *m, ExecutionEngine *engine);
 
     static void registerQmlDependencies(ExecutionEngine *context, const CompiledData::Function *compiledFunction);
 
-    ReturnedValue idObjectsArray();
+    ReturnedValue idObject(int index);
     ReturnedValue qmlSingletonWrapper(QV8Engine *e, const StringRef &name);
 
     bool readOnly;
@@ -105,19 +102,6 @@ struct Q_QML_EXPORT QmlContextWrapper : Object
 
     QQmlGuardedContextData context;
     QPointer<QObject> scopeObject;
-private:
-    QQmlIdObjectsArray *idObjectsWrapper;
-};
-
-struct QQmlIdObjectsArray : public Object
-{
-    V4_OBJECT
-    QQmlIdObjectsArray(ExecutionEngine *engine, QmlContextWrapper *contextWrapper);
-
-    static ReturnedValue getIndexed(Managed *m, uint index, bool *hasProperty);
-    static void markObjects(Managed *that, ExecutionEngine *engine);
-
-    QmlContextWrapper *contextWrapper;
 };
 
 }
@@ -58,6 +58,7 @@
 
 #include <private/qv4value_inl_p.h>
 #include <private/qv4persistent_p.h>
+#include <private/qqmlsizeclasspool_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -79,6 +80,7 @@ class QQmlNotifierEndpoint;
 // Don't change anything here without first considering that case!
 class Q_QML_PRIVATE_EXPORT QQmlData : public QAbstractDeclarativeData
 {
+    Q_QML_SIZE_CLASS_POOLED
 public:
     QQmlData()
         : ownedByQml1(false), ownMemory(true), ownContext(false), indestructible(true), explicitIndestructibleSet(false),
@@ -192,7 +194,8 @@ public:
 
     QQmlGuardImpl *guards;
 
-    static QQmlData *get(const QObject *object, bool create = false) {
+    // When given, missing data is allocated from pool.
+    static QQmlData *get(const QObject *object, bool create = false, QQmlSizeClassPool *pool = 0) {
         QObjectPrivate *priv = QObjectPrivate::get(const_cast<QObject *>(object));
         if (priv->wasDeleted) {
             Q_ASSERT(!create);
@@ -200,7 +203,7 @@ public:
         } else if (priv->declarativeData) {
             return static_cast<QQmlData *>(priv->declarativeData);
         } else if (create) {
-            priv->declarativeData = new QQmlData;
+            priv->declarativeData = new (pool) QQmlData;
             return static_cast<QQmlData *>(priv->declarativeData);
         } else {
             return 0;
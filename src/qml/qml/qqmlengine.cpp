@@ -70,6 +70,10 @@
 #include "qqmlincubator.h"
 #include "qqmlabstracturlinterceptor.h"
 #include <private/qqmlboundsignal_p.h>
+#include <private/qqmlbindinggraph_p.h>
+#include <private/qqmlbinding_p.h>
+#include <private/qv4mm_p.h>
+#include <private/qv4regexp_p.h>
 
 #include <QtCore/qstandardpaths.h>
 #include <QtCore/qsettings.h>
@@ -81,6 +85,7 @@
 #include <QtCore/qdir.h>
 #include <QtCore/qmutex.h>
 #include <QtCore/qthread.h>
+#include <QtCore/qthreadstorage.h>
 #include <private/qthread_p.h>
 #include <QtNetwork/qnetworkconfigmanager.h>
 
@@ -553,11 +558,18 @@ the same object as is returned from the Qt.include() call.
 */
 // Qt.include() is implemented in qv4include.cpp
 
+DEFINE_BOOL_CONFIG_OPTION(qmlDeferBindingUpdates, QML_DEFER_BINDING_UPDATES);
+
+// Engines living in the current thread that have deferred binding updates queued
+static QThreadStorage<QList<QQmlEnginePrivate *> > enginesWithDeferredBindings;
+
 QQmlEnginePrivate::QQmlEnginePrivate(QQmlEngine *e)
 : propertyCapture(0), rootContext(0), isDebugging(false),
   profiler(0), outputWarningsToStdErr(true),
   cleanup(0), erroredBindings(0), inProgressCreations(0),
-  workerScriptEngine(0),
+  deferBindingUpdates(qmlDeferBindingUpdates()), flushingDeferredBindings(false),
+  deferredBindings(0),
+  nextWorkerScriptEngine(0),
   activeObjectCreator(0),
   networkAccessManager(0), networkAccessManagerFactory(0), urlInterceptor(0),
   scarceResourcesRefCount(0), typeLoader(e), importDatabase(e), uniqueId(1),
@@ -568,6 +580,9 @@ QQmlEnginePrivate::QQmlEnginePrivate(QQmlEngine *e)
 
 QQmlEnginePrivate::~QQmlEnginePrivate()
 {
+    if (QQmlBindingGraph *graph = QQmlBindingGraph::instance())
+        graph->save();
+
     if (inProgressCreations)
         qWarning() << QQmlEngine::tr("There are still \"%1\" items in the process of being created at engine destruction.").arg(inProgressCreations);
 
@@ -582,6 +597,11 @@ QQmlEnginePrivate::~QQmlEnginePrivate()
 
     doDeleteInEngineThread();
 
+    while (deferredBindings)
+        deferredBindings->removeFromDeferredList();
+    if (enginesWithDeferredBindings.hasLocalData())
+        enginesWithDeferredBindings.localData().removeOne(this);
+
     if (incubationController) incubationController->d = 0;
     incubationController = 0;
 
@@ -592,6 +612,8 @@ QQmlEnginePrivate::~QQmlEnginePrivate()
         (*iter)->release();
     for(QHash<QPair<QQmlType *, int>, QQmlPropertyCache *>::Iterator iter = typePropertyCache.begin(); iter != typePropertyCache.end(); ++iter)
         (*iter)->release();
+    for (QHash<QPair<QQmlPropertyCache *, QByteArray>, QQmlPropertyCache *>::Iterator iter = derivedPropertyCaches.begin(); iter != derivedPropertyCaches.end(); ++iter)
+        (*iter)->release();
     for (QHash<int, QQmlCompiledData *>::Iterator iter = m_compositeTypes.begin(); iter != m_compositeTypes.end(); ++iter)
         iter.value()->isRegisteredWithEngine = false;
     delete profiler;
@@ -599,7 +621,7 @@ QQmlEnginePrivate::~QQmlEnginePrivate()
 
 void QQmlEnginePrivate::enableProfiler()
 {
-    profiler = new QQmlProfiler();
+    profiler = new QQmlProfiler(v4engine()->memoryManager);
 }
 
 void QQmlPrivate::qdeclarativeelement_destructor(QObject *o)
@@ -784,11 +806,70 @@ void QQmlData::flushPendingBindingImpl(int coreIndex)
     while (b && *b->m_mePtr && b->propertyIndex() != coreIndex)
         b = b->nextBinding();
 
-    if (b && b->propertyIndex() == coreIndex) {
+    if (b && *b->m_mePtr && b->propertyIndex() == coreIndex) {
         b->clear();
         b->setEnabled(true, QQmlPropertyPrivate::BypassInterceptor |
                             QQmlPropertyPrivate::DontRemoveBinding);
+        return;
+    }
+
+    // Otherwise the binding has a deferred update queued.  Run it now, so that
+    // the property is up to date before it is read.
+    for (b = bindings; b; b = b->nextBinding()) {
+        if (b->bindingType() == QQmlAbstractBinding::Binding && b->propertyIndex() == coreIndex) {
+            QQmlBinding *binding = static_cast<QQmlBinding *>(b);
+            if (binding->isUpdateDeferred())
+                binding->update();
+            break;
+        }
+    }
+}
+
+void QQmlEnginePrivate::deferBindingUpdate(QQmlBinding *b)
+{
+    if (b->isUpdateDeferred())
+        return;
+
+    QList<QQmlEnginePrivate *> &engines = enginesWithDeferredBindings.localData();
+    if (!engines.contains(this)) {
+        Q_Q(QQmlEngine);
+        engines.append(this);
+        QCoreApplication::postEvent(q, new QEvent(QEvent::Type(QEvent::User + 1)));
     }
+
+    b->addToDeferredList(&deferredBindings);
+}
+
+/*! \internal
+    Runs all queued binding updates.  Bindings that become dirty while the queue
+    is flushed are updated immediately, so binding loops are still detected.
+
+    Each binding reads its dependencies through QQmlData::flushPendingBinding(),
+    which brings queued dependencies up to date first.  The effective order is
+    therefore topological, and no binding sees an intermediate value.
+*/
+void QQmlEnginePrivate::flushDeferredBindingUpdates()
+{
+    if (flushingDeferredBindings)
+        return;
+
+    if (enginesWithDeferredBindings.hasLocalData())
+        enginesWithDeferredBindings.localData().removeOne(this);
+
+    flushingDeferredBindings = true;
+    while (QQmlBinding *b = deferredBindings)
+        b->update();
+    flushingDeferredBindings = false;
+}
+
+void QQmlEnginePrivate::flushDeferredBindingUpdatesForThread()
+{
+    if (!enginesWithDeferredBindings.hasLocalData())
+        return;
+
+    const QList<QQmlEnginePrivate *> engines = enginesWithDeferredBindings.localData();
+    for (int ii = 0; ii < engines.count(); ++ii)
+        engines.at(ii)->flushDeferredBindingUpdates();
 }
 
 bool QQmlEnginePrivate::baseModulesUninitialized = true;
@@ -830,12 +911,24 @@ void QQmlEnginePrivate::init()
     }
 }
 
+static int workerScriptThreadCount()
+{
+    bool ok = false;
+    int count = qgetenv("QML_WORKER_SCRIPT_THREADS").toInt(&ok);
+    return ok && count > 0 ? count : 1;
+}
+
 QQuickWorkerScriptEngine *QQmlEnginePrivate::getWorkerScriptEngine()
 {
     Q_Q(QQmlEngine);
-    if (!workerScriptEngine)
-        workerScriptEngine = new QQuickWorkerScriptEngine(q);
-    return workerScriptEngine;
+    static const int threadCount = workerScriptThreadCount();
+    if (workerScriptEngines.size() < threadCount) {
+        workerScriptEngines.append(new QQuickWorkerScriptEngine(q));
+        return workerScriptEngines.last();
+    }
+    QQuickWorkerScriptEngine *engine = workerScriptEngines.at(nextWorkerScriptEngine);
+    nextWorkerScriptEngine = (nextWorkerScriptEngine + 1) % workerScriptEngines.size();
+    return engine;
 }
 
 /*!
@@ -952,6 +1045,7 @@ void QQmlEngine::clearComponentCache()
 {
     Q_D(QQmlEngine);
     d->typeLoader.clearCache();
+    d->trimDerivedCaches();
 }
 
 /*!
@@ -970,6 +1064,51 @@ void QQmlEngine::trimComponentCache()
 {
     Q_D(QQmlEngine);
     d->typeLoader.trimCache();
+    d->trimDerivedCaches();
+}
+
+/*!
+  \enum QQmlEngine::ReleaseLevel
+  \since 5.3
+
+  This enum describes how much releaseResources() gives up.
+
+  \value GracefulRelease Only drop what is cheap to rebuild and not in use:
+  unused components, images in the cache that no item shows, pooled
+  delegates and JavaScript heap memory that is already free.
+  \value AggressiveRelease In addition, run the garbage collector, drop the
+  compiled code of regular expressions, and release the scene graphs of the
+  windows showing this engine's items, unless they are persistent.
+*/
+
+/*!
+  \since 5.3
+
+  Releases memory held by the engine and the caches of the modules using it,
+  to the extent given by \a level, and returns roughly how many bytes were
+  released. Caches that cannot tell their size are not accounted for, so the
+  result is a lower bound.
+
+  This function is a slot, so that it can be connected to whatever low memory
+  notification the platform provides.
+
+  \sa trimComponentCache(), QQuickWindow::releaseResources()
+*/
+qint64 QQmlEngine::releaseResources(ReleaseLevel level)
+{
+    Q_D(QQmlEngine);
+    // Pooled delegates and other objects created by the other modules hold on
+    // to components and JavaScript objects, so let them go first.
+    qint64 released = QQml_guiProvider()->releaseResources(this, level);
+
+    QV4::ExecutionEngine *v4 = QV8Engine::getV4(d->v8engine());
+    if (level == AggressiveRelease) {
+        v4->memoryManager->runGC();
+        QV4::RegExp::clearSharedCodeCache();
+    }
+    trimComponentCache();
+    released += v4->memoryManager->releaseFreeChunks();
+    return released;
 }
 
 /*!
@@ -1329,6 +1468,8 @@ bool QQmlEngine::event(QEvent *e)
     Q_D(QQmlEngine);
     if (e->type() == QEvent::User)
         d->doDeleteInEngineThread();
+    else if (e->type() == QEvent::User + 1)
+        d->flushDeferredBindingUpdates();
 
     return QJSEngine::event(e);
 }
@@ -2242,6 +2383,45 @@ QQmlPropertyCache *QQmlEnginePrivate::rawPropertyCacheForType(int t)
     }
 }
 
+/*!
+Returns the cache to use for an object that declares the members described by
+\a signature on top of \a base, sharing one instance between all such objects
+of this engine. Takes over the reference to \a cache, which is returned if no
+equivalent cache has been created yet. The returned cache is referenced.
+*/
+QQmlPropertyCache *QQmlEnginePrivate::sharedDerivedCache(QQmlPropertyCache *base, const QByteArray &signature,
+                                                         QQmlPropertyCache *cache)
+{
+    Locker locker(this);
+    const QPair<QQmlPropertyCache *, QByteArray> key(base, signature);
+    QQmlPropertyCache *shared = derivedPropertyCaches.value(key);
+    if (shared) {
+        cache->release();
+        shared->addref();
+        return shared;
+    }
+    cache->addref();
+    derivedPropertyCaches.insert(key, cache);
+    return cache;
+}
+
+/*!
+Drops the shared derived caches that are no longer used by any compiled type.
+*/
+void QQmlEnginePrivate::trimDerivedCaches()
+{
+    Locker locker(this);
+    QHash<QPair<QQmlPropertyCache *, QByteArray>, QQmlPropertyCache *>::Iterator iter = derivedPropertyCaches.begin();
+    while (iter != derivedPropertyCaches.end()) {
+        if ((*iter)->count() == 1) {
+            (*iter)->release();
+            iter = derivedPropertyCaches.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+}
+
 void QQmlEnginePrivate::registerInternalCompositeType(QQmlCompiledData *data)
 {
     QByteArray name = data->rootPropertyCache->className();
@@ -145,6 +145,12 @@ public:
     enum ObjectOwnership { CppOwnership, JavaScriptOwnership };
     static void setObjectOwnership(QObject *, ObjectOwnership);
     static ObjectOwnership objectOwnership(QObject *);
+
+    enum ReleaseLevel { GracefulRelease, AggressiveRelease };
+
+public Q_SLOTS:
+    qint64 releaseResources(ReleaseLevel level = GracefulRelease);
+
 protected:
     QQmlEngine(QQmlEnginePrivate &dd, QObject *p);
     virtual bool event(QEvent *);
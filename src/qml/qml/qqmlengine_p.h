@@ -69,9 +69,11 @@
 #include "qqmldirparser_p.h"
 #include <private/qintrusivelist_p.h>
 #include <private/qrecyclepool_p.h>
+#include <private/qqmlsizeclasspool_p.h>
 #include <private/qfieldlist_p.h>
 
 #include <QtCore/qlist.h>
+#include <QtCore/qvector.h>
 #include <QtCore/qpair.h>
 #include <QtCore/qstack.h>
 #include <QtCore/qmutex.h>
@@ -94,6 +96,7 @@ class QNetworkReply;
 class QNetworkAccessManager;
 class QQmlNetworkAccessManagerFactory;
 class QQmlAbstractBinding;
+class QQmlBinding;
 class QQmlTypeNameCache;
 class QQmlComponentAttached;
 class QQmlCleanup;
@@ -143,6 +146,9 @@ public:
     inline void captureProperty(QObject *, int, int);
 
     QRecyclePool<QQmlJavaScriptExpressionGuard> jsExpressionGuardPool;
+    // Backs the QQmlData, contexts, bindings and signal handlers that
+    // QQmlObjectCreator allocates for each instantiated object.
+    QQmlSizeClassPool bookkeepingPool;
 
     QQmlContext *rootContext;
     bool isDebugging;
@@ -159,11 +165,24 @@ public:
     QQmlDelayedError *erroredBindings;
     int inProgressCreations;
 
+    // When set, bindings whose dependencies change are queued instead of being
+    // re-evaluated immediately, and the queue is flushed once before the next
+    // polish (or from the event loop).  Enabled by QML_DEFER_BINDING_UPDATES.
+    bool deferBindingUpdates;
+    bool flushingDeferredBindings;
+    QQmlBinding *deferredBindings;
+    void deferBindingUpdate(QQmlBinding *);
+    void flushDeferredBindingUpdates();
+    static void flushDeferredBindingUpdatesForThread();
+
     QV8Engine *v8engine() const { return q_func()->handle(); }
     QV4::ExecutionEngine *v4engine() const { return QV8Engine::getV4(q_func()->handle()); }
 
+    // Worker scripts are spread over a pool of QML_WORKER_SCRIPT_THREADS
+    // threads, which are started on demand.
     QQuickWorkerScriptEngine *getWorkerScriptEngine();
-    QQuickWorkerScriptEngine *workerScriptEngine;
+    QVector<QQuickWorkerScriptEngine *> workerScriptEngines;
+    int nextWorkerScriptEngine;
 
     QUrl baseUrl;
 
@@ -231,6 +250,9 @@ public:
     QQmlMetaObject metaObjectForType(int) const;
     QQmlPropertyCache *propertyCacheForType(int);
     QQmlPropertyCache *rawPropertyCacheForType(int);
+    QQmlPropertyCache *sharedDerivedCache(QQmlPropertyCache *base, const QByteArray &signature,
+                                          QQmlPropertyCache *cache);
+    void trimDerivedCaches();
     void registerInternalCompositeType(QQmlCompiledData *);
     void unregisterInternalCompositeType(QQmlCompiledData *);
 
@@ -303,6 +325,7 @@ private:
     // the threaded loader.  Only access them through their respective accessor methods.
     QHash<const QMetaObject *, QQmlPropertyCache *> propertyCache;
     QHash<QPair<QQmlType *, int>, QQmlPropertyCache *> typePropertyCache;
+    QHash<QPair<QQmlPropertyCache *, QByteArray>, QQmlPropertyCache *> derivedPropertyCaches;
     QHash<int, int> m_qmlLists;
     QHash<int, QQmlCompiledData *> m_compositeTypes;
     QHash<QUrl, QByteArray> debugChangesHash;
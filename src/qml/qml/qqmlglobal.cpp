@@ -361,6 +361,7 @@ QQmlGuiProvider::~QQmlGuiProvider() {}
 QObject *QQmlGuiProvider::application(QObject *) { return new QQmlApplication(); }
 QStringList QQmlGuiProvider::fontFamilies() { return QStringList(); }
 bool QQmlGuiProvider::openUrlExternally(QUrl &) { return false; }
+qint64 QQmlGuiProvider::releaseResources(QQmlEngine *, QQmlEngine::ReleaseLevel) { return 0; }
 
 #ifndef QT_NO_IM
 QObject *QQmlGuiProvider::inputMethod()
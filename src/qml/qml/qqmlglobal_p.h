@@ -44,6 +44,7 @@
 
 #include <private/qtqmlglobal_p.h>
 #include <QtCore/QObject>
+#include <QtQml/qqmlengine.h>
 #include <private/qqmlpropertycache_p.h>
 #include <private/qmetaobject_p.h>
 #include <private/qv8engine_p.h>
@@ -308,6 +309,7 @@ public:
 #endif
     virtual QStringList fontFamilies();
     virtual bool openUrlExternally(QUrl &);
+    virtual qint64 releaseResources(QQmlEngine *engine, QQmlEngine::ReleaseLevel level);
 };
 
 Q_QML_PRIVATE_EXPORT QQmlGuiProvider *QQml_setGuiProvider(QQmlGuiProvider *);
@@ -44,6 +44,7 @@
 #include <QtCore/qdebug.h>
 #include <QtCore/qdir.h>
 #include <QtQml/qqmlfile.h>
+#include <QtCore/qfile.h>
 #include <QtCore/qfileinfo.h>
 #include <QtCore/qpluginloader.h>
 #include <QtCore/qlibraryinfo.h>
@@ -52,9 +53,14 @@
 #include <QtQml/qqmlextensionplugin.h>
 #include <private/qqmlextensionplugin_p.h>
 #include <private/qqmlglobal_p.h>
+#include <private/qqmlimportindex_p.h>
 #include <private/qqmltypenamecache_p.h>
 #include <private/qqmlengine_p.h>
 #include <private/qfieldlist_p.h>
+#include <private/qqmljsengine_p.h>
+#include <private/qqmljslexer_p.h>
+#include <private/qqmljsparser_p.h>
+#include <private/qqmljsast_p.h>
 #include <QtCore/qjsonobject.h>
 #include <QtCore/qjsonarray.h>
 
@@ -64,6 +70,7 @@ QT_BEGIN_NAMESPACE
 
 DEFINE_BOOL_CONFIG_OPTION(qmlImportTrace, QML_IMPORT_TRACE)
 DEFINE_BOOL_CONFIG_OPTION(qmlCheckTypes, QML_CHECK_TYPES)
+DEFINE_BOOL_CONFIG_OPTION(qmlDeferPlugins, QML_DEFER_PLUGINS)
 
 static const QLatin1Char Dot('.');
 static const QLatin1Char Slash('/');
@@ -289,6 +296,12 @@ public:
                          const QQmlTypeLoader::QmldirContent *qmldir,
                          QList<QQmlError> *errors);
 
+    static bool loadPlugins(QQmlTypeLoader *typeLoader, const QString &qmldirFilePath,
+                            const QString &uri, int vmaj, int vmin,
+                            QQmlImportDatabase *database, const QString &typeNamespace,
+                            const QList<QQmlDirParser::Plugin> &qmldirPlugins,
+                            QList<QQmlError> *errors);
+
     bool getQmldirContent(const QString &qmldirIdentifier, const QString &uri,
                           const QQmlTypeLoader::QmldirContent **qmldir, QList<QQmlError> *errors);
 
@@ -299,7 +312,7 @@ public:
                                                       int vmaj, int vmin, QV4::CompiledData::Import::ImportType type,
                                                       QList<QQmlError> *errors, bool lowPrecedence = false);
 
-   bool populatePluginPairVector(QVector<StaticPluginPair> &result, const QString &uri,
+   static bool populatePluginPairVector(QVector<StaticPluginPair> &result, const QString &uri,
                                      const QString &qmldirPath, QList<QQmlError> *errors);
 };
 
@@ -362,11 +375,19 @@ void QQmlImports::populateCache(QQmlTypeNameCache *cache) const
 {
     const QQmlImportNamespace &set = d->unqualifiedset;
 
+    QQmlImportDatabase *database = 0;
+    if (qmlDeferPlugins()) {
+        database = &QQmlEnginePrivate::get(d->typeLoader->engine())->importDatabase;
+        cache->m_importDatabase = database;
+    }
+
     for (int ii = set.imports.count() - 1; ii >= 0; --ii) {
         const QQmlImportNamespace::Import *import = set.imports.at(ii);
         QQmlTypeModule *module = QQmlMetaType::typeModule(import->uri, import->majversion);
         if (module) {
             cache->m_anonymousImports.append(QQmlTypeModuleVersion(module, import->minversion));
+        } else if (database && database->hasDeferredPlugin(import->uri)) {
+            cache->m_anonymousDeferredImports.append(QQmlTypeNameCache::DeferredImport(import->uri, import->majversion, import->minversion));
         }
     }
 
@@ -380,6 +401,9 @@ void QQmlImports::populateCache(QQmlTypeNameCache *cache) const
             if (module) {
                 QQmlTypeNameCache::Import &typeimport = cache->m_namedImports[set.prefix];
                 typeimport.modules.append(QQmlTypeModuleVersion(module, import->minversion));
+            } else if (database && database->hasDeferredPlugin(import->uri)) {
+                QQmlTypeNameCache::Import &typeimport = cache->m_namedImports[set.prefix];
+                typeimport.deferredImports.append(QQmlTypeNameCache::DeferredImport(import->uri, import->majversion, import->minversion));
             }
         }
     }
@@ -614,6 +638,11 @@ bool QQmlImportNamespace::Import::resolveType(QQmlTypeLoader *typeLoader,
                                               QQmlType** type_return, QString *base, bool *typeRecursionDetected) const
 {
     if (majversion >= 0 && minversion >= 0) {
+        if (isLibrary && qmlDeferPlugins()) {
+            QQmlImportDatabase *database = &QQmlEnginePrivate::get(typeLoader->engine())->importDatabase;
+            database->resolveDeferredPlugin(uri, type.toString());
+        }
+
         QQmlType *t = QQmlMetaType::qmlType(type, uri, majversion, minversion);
         if (t) {
             if (vmajor) *vmajor = majversion;
@@ -870,10 +899,84 @@ bool QQmlImportsPrivate::populatePluginPairVector(QVector<StaticPluginPair> &res
     return true;
 }
 
+/*!
+    \internal
+    Returns the names of the types which the \a typeInfos files in \a qmldirPath
+    export into the module \a uri. \a versionFound is set if one of the exports
+    provides version \a vmaj.\a vmin of the module.
+
+    An empty set is returned if any of the files can't be read or parsed, as an
+    incomplete list can't be used to decide when the module's plugins are needed.
+*/
+static QSet<QString> typeInfoExports(const QString &qmldirPath, const QList<QQmlDirParser::TypeInfo> &typeInfos,
+                                     const QString &uri, int vmaj, int vmin, bool *versionFound)
+{
+    using namespace QQmlJS;
+
+    QSet<QString> typeNames;
+    *versionFound = false;
+
+    foreach (const QQmlDirParser::TypeInfo &typeInfo, typeInfos) {
+        QFile file(qmldirPath + Slash + typeInfo.fileName);
+        if (!file.open(QFile::ReadOnly))
+            return QSet<QString>();
+
+        const QString code = QString::fromUtf8(file.readAll());
+        Engine engine;
+        Lexer lexer(&engine);
+        lexer.setCode(code, /*line*/ 1, /*qmlMode*/ true);
+        Parser parser(&engine);
+        if (!parser.parse() || !parser.ast())
+            return QSet<QString>();
+
+        // Module { Component { exports: ["uri/Name major.minor", ...] } }
+        for (AST::UiObjectMemberList *it = parser.ast()->members; it; it = it->next) {
+            AST::UiObjectDefinition *module = AST::cast<AST::UiObjectDefinition *>(it->member);
+            if (!module || !module->initializer)
+                continue;
+            for (AST::UiObjectMemberList *cit = module->initializer->members; cit; cit = cit->next) {
+                AST::UiObjectDefinition *component = AST::cast<AST::UiObjectDefinition *>(cit->member);
+                if (!component || !component->initializer)
+                    continue;
+                for (AST::UiObjectMemberList *bit = component->initializer->members; bit; bit = bit->next) {
+                    AST::UiScriptBinding *binding = AST::cast<AST::UiScriptBinding *>(bit->member);
+                    if (!binding || !binding->qualifiedId || binding->qualifiedId->next
+                            || binding->qualifiedId->name != QLatin1String("exports"))
+                        continue;
+                    AST::ExpressionStatement *statement = AST::cast<AST::ExpressionStatement *>(binding->statement);
+                    AST::ArrayLiteral *array = statement ? AST::cast<AST::ArrayLiteral *>(statement->expression) : 0;
+                    for (AST::ElementList *element = array ? array->elements : 0; element; element = element->next) {
+                        AST::StringLiteral *literal = AST::cast<AST::StringLiteral *>(element->expression);
+                        if (!literal)
+                            continue;
+                        const QString exported = literal->value.toString();
+                        const int slash = exported.lastIndexOf(Slash);
+                        const int space = exported.indexOf(QLatin1Char(' '), slash + 1);
+                        if (slash <= 0 || space < 0 || exported.leftRef(slash) != uri)
+                            continue;
+                        typeNames.insert(exported.mid(slash + 1, space - slash - 1));
+
+                        const QString version = exported.mid(space + 1);
+                        const int dot = version.indexOf(Dot);
+                        if (dot > 0 && version.left(dot).toInt() == vmaj && version.mid(dot + 1).toInt() <= vmin)
+                            *versionFound = true;
+                    }
+                }
+            }
+        }
+    }
+
+    return typeNames;
+}
+
 /*!
 Import an extension defined by a qmldir file.
 
 \a qmldirFilePath is either a raw file path, or a bundle url.
+
+If QML_DEFER_PLUGINS is set and the qmldir file lists a typeinfo file, the
+plugins are not loaded yet. They are loaded by QQmlImportDatabase::resolveDeferredPlugin()
+as soon as one of the types exported by the module is looked up.
 */
 bool QQmlImportsPrivate::importExtension(const QString &qmldirFilePath,
                                          const QString &uri,
@@ -889,7 +992,64 @@ bool QQmlImportsPrivate::importExtension(const QString &qmldirFilePath,
         qDebug().nospace() << "QQmlImports(" << qPrintable(base) << ")::importExtension: "
                            << "loaded " << qmldirFilePath;
 
-    int qmldirPluginCount = qmldir->plugins().count();
+    if (qmldir->plugins().isEmpty())
+        return true;
+
+    if (database->qmlDirFilesForWhichPluginsHaveBeenLoaded.contains(qmldirFilePath))
+        return true;
+
+    if (qmlDeferPlugins() && vmaj >= 0 && vmin >= 0 && !qmldir->typeInfos().isEmpty()
+            && !QQmlMetaType::typeModule(uri, vmaj)) {
+        QMutexLocker lock(&database->deferredPluginsMutex);
+        QHash<QString, QQmlImportDatabase::DeferredPlugin>::ConstIterator it = database->deferredPlugins.constFind(uri);
+        if (it != database->deferredPlugins.constEnd()) {
+            if (it->qmldirFilePath == qmldirFilePath)
+                return true;
+        } else {
+            QString qmldirPath = qmldirFilePath;
+            int slash = qmldirPath.lastIndexOf(Slash);
+            if (slash > 0)
+                qmldirPath.truncate(slash);
+
+            bool versionFound = false;
+            QSet<QString> typeNames = typeInfoExports(qmldirPath, qmldir->typeInfos(), uri, vmaj, vmin, &versionFound);
+            if (versionFound) {
+                QQmlImportDatabase::DeferredPlugin plugin;
+                plugin.qmldirFilePath = qmldirFilePath;
+                plugin.typeNamespace = qmldir->typeNamespace();
+                plugin.plugins = qmldir->plugins();
+                plugin.typeNames = typeNames;
+                plugin.vmaj = vmaj;
+                plugin.vmin = vmin;
+                database->deferredPlugins.insert(uri, plugin);
+
+                if (qmlImportTrace())
+                    qDebug().nospace() << "QQmlImports(" << qPrintable(base) << ")::importExtension: "
+                                       << "deferred plugins of " << uri;
+                return true;
+            }
+        }
+    }
+
+    return loadPlugins(typeLoader, qmldirFilePath, uri, vmaj, vmin, database,
+                       qmldir->typeNamespace(), qmldir->plugins(), errors);
+#else
+    return false;
+#endif // QT_NO_LIBRARY
+}
+
+/*!
+    \internal
+    Loads the plugins \a qmldirPlugins listed by the qmldir file at \a qmldirFilePath.
+*/
+bool QQmlImportsPrivate::loadPlugins(QQmlTypeLoader *typeLoader, const QString &qmldirFilePath,
+                                     const QString &uri, int vmaj, int vmin,
+                                     QQmlImportDatabase *database, const QString &typeNamespace,
+                                     const QList<QQmlDirParser::Plugin> &qmldirPlugins,
+                                     QList<QQmlError> *errors)
+{
+#if !defined(QT_NO_LIBRARY)
+    int qmldirPluginCount = qmldirPlugins.count();
     if (qmldirPluginCount == 0)
         return true;
 
@@ -900,7 +1060,6 @@ bool QQmlImportsPrivate::importExtension(const QString &qmldirFilePath,
         // listed plugin inside qmldir. And for this reason, mixing dynamic and static plugins inside a
         // single module is not recommended.
 
-        QString typeNamespace = qmldir->typeNamespace();
         QString qmldirPath = qmldirFilePath;
         int slash = qmldirPath.lastIndexOf(Slash);
         if (slash > 0)
@@ -910,7 +1069,7 @@ bool QQmlImportsPrivate::importExtension(const QString &qmldirFilePath,
         int staticPluginsFound = 0;
 
 #if defined(QT_SHARED)
-        foreach (const QQmlDirParser::Plugin &plugin, qmldir->plugins()) {
+        foreach (const QQmlDirParser::Plugin &plugin, qmldirPlugins) {
             QString resolvedFilePath = database->resolvePlugin(typeLoader, qmldirPath, plugin.path, plugin.name);
             if (!resolvedFilePath.isEmpty()) {
                 dynamicPluginsFound++;
@@ -974,7 +1133,7 @@ bool QQmlImportsPrivate::importExtension(const QString &qmldirFilePath,
                 if (qmldirPluginCount > 1 && staticPluginsFound > 0)
                     error.setDescription(QQmlImportDatabase::tr("could not resolve all plugins for module \"%1\"").arg(uri));
                 else
-                    error.setDescription(QQmlImportDatabase::tr("module \"%1\" plugin \"%2\" not found").arg(uri).arg(qmldir->plugins()[dynamicPluginsFound].name));
+                    error.setDescription(QQmlImportDatabase::tr("module \"%1\" plugin \"%2\" not found").arg(uri).arg(qmldirPlugins[dynamicPluginsFound].name));
                 error.setUrl(QUrl::fromLocalFile(qmldirFilePath));
                 errors->prepend(error);
             }
@@ -1090,34 +1249,48 @@ bool QQmlImportsPrivate::locateQmldir(const QString &uri, int vmaj, int vmin, QQ
 
     QStringList localImportPaths = database->importPathList(QQmlImportDatabase::Local);
 
-    // Search local import paths for a matching version
-    for (int version = QQmlImports::FullyVersioned; version <= QQmlImports::Unversioned; ++version) {
-        foreach (const QString &path, localImportPaths) {
-            QString qmldirPath = QQmlImports::completeQmldirPath(uri, path, vmaj, vmin, static_cast<QQmlImports::ImportVersion>(version));
-
-            QString absoluteFilePath = typeLoader.absoluteFilePath(qmldirPath);
-            if (!absoluteFilePath.isEmpty()) {
-                QString url;
-                QString absolutePath = absoluteFilePath.left(absoluteFilePath.lastIndexOf(Slash)+1);
-                if (absolutePath.at(0) == Colon)
-                    url = QLatin1String("qrc://") + absolutePath.mid(1);
-                else
-                    url = QUrl::fromLocalFile(absolutePath).toString();
+    // Then the index of earlier searches, which may even come from a previous run
+    QQmlImportIndex *index = QQmlImportIndex::instance();
+    const QString indexKey = uri + QLatin1Char(' ') + QString::number(vmaj) + Dot + QString::number(vmin)
+                             + QLatin1Char('\n') + localImportPaths.join(QLatin1Char('\n'));
+
+    QString absoluteFilePath;
+    if (!index->location(indexKey, &absoluteFilePath)) {
+        // Search local import paths for a matching version
+        QStringList searchedPaths;
+        for (int version = QQmlImports::FullyVersioned; version <= QQmlImports::Unversioned && absoluteFilePath.isEmpty(); ++version) {
+            foreach (const QString &path, localImportPaths) {
+                QString qmldirPath = QQmlImports::completeQmldirPath(uri, path, vmaj, vmin, static_cast<QQmlImports::ImportVersion>(version));
+
+                searchedPaths.append(qmldirPath);
+                absoluteFilePath = typeLoader.absoluteFilePath(qmldirPath);
+                if (!absoluteFilePath.isEmpty())
+                    break;
+            }
+        }
+        index->setLocation(indexKey, absoluteFilePath, searchedPaths);
+    }
 
-                QQmlImportDatabase::QmldirCache *cache = new QQmlImportDatabase::QmldirCache;
-                cache->versionMajor = vmaj;
-                cache->versionMinor = vmin;
-                cache->qmldirFilePath = absoluteFilePath;
-                cache->qmldirPathUrl = url;
-                cache->next = cacheHead;
-                database->qmldirCache.insert(uri, cache);
+    if (!absoluteFilePath.isEmpty()) {
+        QString url;
+        QString absolutePath = absoluteFilePath.left(absoluteFilePath.lastIndexOf(Slash)+1);
+        if (absolutePath.at(0) == Colon)
+            url = QLatin1String("qrc://") + absolutePath.mid(1);
+        else
+            url = QUrl::fromLocalFile(absolutePath).toString();
 
-                *outQmldirFilePath = absoluteFilePath;
-                *outQmldirPathUrl = url;
+        QQmlImportDatabase::QmldirCache *cache = new QQmlImportDatabase::QmldirCache;
+        cache->versionMajor = vmaj;
+        cache->versionMinor = vmin;
+        cache->qmldirFilePath = absoluteFilePath;
+        cache->qmldirPathUrl = url;
+        cache->next = cacheHead;
+        database->qmldirCache.insert(uri, cache);
 
-                return true;
-            }
-        }
+        *outQmldirFilePath = absoluteFilePath;
+        *outQmldirPathUrl = url;
+
+        return true;
     }
 
     QQmlImportDatabase::QmldirCache *cache = new QQmlImportDatabase::QmldirCache;
@@ -1268,7 +1441,7 @@ bool QQmlImportsPrivate::addLibraryImport(const QString& uri, const QString &pre
         }
 
         // Ensure that we are actually providing something
-        if ((vmaj < 0) || (vmin < 0) || !QQmlMetaType::isModule(uri, vmaj, vmin)) {
+        if ((vmaj < 0) || (vmin < 0) || (!QQmlMetaType::isModule(uri, vmaj, vmin) && !database->hasDeferredPlugin(uri))) {
             if (inserted->qmlDirComponents.isEmpty() && inserted->qmlDirScripts.isEmpty()) {
                 QQmlError error;
                 if (QQmlMetaType::isAnyModule(uri))
@@ -1582,6 +1755,10 @@ QQmlImportDatabase::QQmlImportDatabase(QQmlEngine *e)
 QQmlImportDatabase::~QQmlImportDatabase()
 {
     clearDirCache();
+
+    // The index may already be gone for engines destroyed on exit
+    if (QQmlImportIndex *index = QQmlImportIndex::instance())
+        index->save();
 }
 
 /*!
@@ -1603,6 +1780,15 @@ QString QQmlImportDatabase::resolvePlugin(QQmlTypeLoader *typeLoader,
     if (!qmldirPluginPathIsRelative)
         searchPaths.prepend(qmldirPluginPath);
 
+    QQmlImportIndex *index = QQmlImportIndex::instance();
+    const QString indexKey = QLatin1String("plugin:") + qmldirPath + QLatin1Char('\n') + qmldirPluginPath
+                             + QLatin1Char('\n') + prefix + baseName + QLatin1Char('\n') + suffixes.join(QLatin1Char(' '))
+                             + QLatin1Char('\n') + searchPaths.join(QLatin1Char('\n'));
+    QString indexedPath;
+    if (index->location(indexKey, &indexedPath) && !indexedPath.isEmpty())
+        return indexedPath;
+
+    QStringList searchedPaths;
     foreach (const QString &pluginPath, searchPaths) {
 
         QString resolvedPath;
@@ -1631,9 +1817,12 @@ QString QQmlImportDatabase::resolvePlugin(QQmlTypeLoader *typeLoader,
             pluginFileName += baseName;
             pluginFileName += suffix;
 
+            searchedPaths.append(resolvedPath + pluginFileName);
             QString absolutePath = typeLoader->absoluteFilePath(resolvedPath + pluginFileName);
-            if (!absolutePath.isEmpty())
+            if (!absolutePath.isEmpty()) {
+                index->setLocation(indexKey, absolutePath, searchedPaths);
                 return absolutePath;
+            }
         }
     }
 
@@ -2030,6 +2219,52 @@ bool QQmlImportDatabase::importDynamicPlugin(const QString &filePath, const QStr
 #endif
 }
 
+/*!
+    \internal
+    Returns true if the plugins of the module \a uri have been deferred and not loaded yet.
+*/
+bool QQmlImportDatabase::hasDeferredPlugin(const QString &uri)
+{
+    QMutexLocker lock(&deferredPluginsMutex);
+    return deferredPlugins.contains(uri);
+}
+
+/*!
+    \internal
+    Loads the deferred plugins of the module \a uri if they provide the type \a typeName.
+*/
+void QQmlImportDatabase::resolveDeferredPlugin(const QString &uri, const QString &typeName)
+{
+#ifndef QT_NO_LIBRARY
+    DeferredPlugin plugin;
+    {
+        // The plugin must not be loaded with the lock held: initializing the engine
+        // may block on the main thread, which could be waiting for the lock itself.
+        QMutexLocker lock(&deferredPluginsMutex);
+        QHash<QString, DeferredPlugin>::Iterator it = deferredPlugins.find(uri);
+        if (it == deferredPlugins.end() || !it->typeNames.contains(typeName))
+            return;
+        plugin = *it;
+        deferredPlugins.erase(it);
+    }
+
+    if (qmlImportTrace())
+        qDebug().nospace() << "QQmlImportDatabase::resolveDeferredPlugin: loading plugins of "
+                           << uri << " for type " << typeName;
+
+    QList<QQmlError> errors;
+    if (!QQmlImportsPrivate::loadPlugins(&QQmlEnginePrivate::get(engine)->typeLoader, plugin.qmldirFilePath,
+                                         uri, plugin.vmaj, plugin.vmin, this, plugin.typeNamespace,
+                                         plugin.plugins, &errors)) {
+        foreach (const QQmlError &error, errors)
+            qWarning().nospace() << qPrintable(error.toString());
+    }
+#else
+    Q_UNUSED(uri);
+    Q_UNUSED(typeName);
+#endif
+}
+
 void QQmlImportDatabase::clearDirCache()
 {
     QStringHash<QmldirCache *>::ConstIterator itr = qmldirCache.begin();
@@ -45,6 +45,7 @@
 #include <QtCore/qurl.h>
 #include <QtCore/qcoreapplication.h>
 #include <QtCore/qset.h>
+#include <QtCore/qmutex.h>
 #include <QtCore/qstringlist.h>
 #include <private/qqmldirparser_p.h>
 #include <private/qqmlmetatype_p.h>
@@ -153,6 +154,9 @@ public:
 
     bool importDynamicPlugin(const QString &filePath, const QString &uri, const QString &importNamespace, QList<QQmlError> *errors);
 
+    bool hasDeferredPlugin(const QString &uri);
+    void resolveDeferredPlugin(const QString &uri, const QString &typeName);
+
     QStringList importPathList(PathType type = LocalOrRemote) const;
     void setImportPathList(const QStringList &paths);
     void addImportPath(const QString& dir);
@@ -193,6 +197,20 @@ private:
 
     QSet<QString> qmlDirFilesForWhichPluginsHaveBeenLoaded;
     QSet<QString> initializedPlugins;
+
+    // Plugins of modules imported with QML_DEFER_PLUGINS set, which are
+    // only loaded once one of the types listed in their typeinfo is used.
+    struct DeferredPlugin {
+        QString qmldirFilePath;
+        QString typeNamespace;
+        QList<QQmlDirParser::Plugin> plugins;
+        QSet<QString> typeNames;
+        int vmaj;
+        int vmin;
+    };
+    QHash<QString, DeferredPlugin> deferredPlugins; // keyed by module uri
+    QMutex deferredPluginsMutex;
+
     QQmlEngine *engine;
 };
 
@@ -0,0 +1,257 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQml module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qqmlimportindex_p.h"
+
+#include <QtCore/qdatastream.h>
+#include <QtCore/qdatetime.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qsavefile.h>
+
+QT_BEGIN_NAMESPACE
+
+Q_GLOBAL_STATIC(QQmlImportIndex, importIndex)
+
+static const quint32 importIndexMagic = 0x514d4c49; // "QMLI"
+static const quint32 importIndexVersion = 1;
+
+QQmlImportIndex *QQmlImportIndex::instance()
+{
+    return importIndex();
+}
+
+QQmlImportIndex::QQmlImportIndex()
+    : dirty(false)
+{
+    fileName = QFile::decodeName(qgetenv("QML_IMPORT_INDEX"));
+    if (!fileName.isEmpty())
+        load();
+}
+
+/*!
+Returns true and sets \a result if \a key was resolved before and none of
+the directories searched at the time has changed since.  \a result is
+empty if nothing was found.
+*/
+bool QQmlImportIndex::location(const QString &key, QString *result)
+{
+    QMutexLocker locker(&mutex);
+
+    QHash<QString, Location>::Iterator it = locations.find(key);
+    if (it == locations.end())
+        return false;
+
+    for (int ii = 0; ii < it->directories.count(); ++ii) {
+        const DirectoryStamp &directory = it->directories.at(ii);
+        qint64 modified;
+        if (!stat(directory.path, &modified) || modified != directory.modified) {
+            locations.erase(it);
+            dirty = true;
+            return false;
+        }
+    }
+
+    *result = it->result;
+    return true;
+}
+
+/*!
+Records that \a key resolved to \a result after looking for each of
+\a searchedPaths in turn.
+
+For every searched path the closest existing parent directory is
+remembered, as creating or removing the path changes its modification
+time.
+*/
+void QQmlImportIndex::setLocation(const QString &key, const QString &result, const QStringList &searchedPaths)
+{
+    Location location;
+    location.result = result;
+
+    QHash<QString, bool> seen;
+    foreach (const QString &path, searchedPaths) {
+        QString directory = path.left(path.lastIndexOf(QLatin1Char('/')));
+        while (!directory.isEmpty() && !seen.contains(directory)) {
+            seen.insert(directory, true);
+
+            DirectoryStamp stamp;
+            if (stat(directory, &stamp.modified)) {
+                stamp.path = directory;
+                location.directories.append(stamp);
+                break;
+            }
+
+            const int slash = directory.lastIndexOf(QLatin1Char('/'));
+            if (slash <= 0)
+                break;
+            directory.truncate(slash);
+        }
+    }
+
+    QMutexLocker locker(&mutex);
+    locations.insert(key, location);
+    dirty = true;
+}
+
+/*!
+Returns true and sets \a content if the qmldir file at \a filePath was
+read before and has not been modified since.
+*/
+bool QQmlImportIndex::qmldirContent(const QString &filePath, QString *content)
+{
+    QMutexLocker locker(&mutex);
+
+    QHash<QString, QmldirContent>::Iterator it = qmldirs.find(filePath);
+    if (it == qmldirs.end())
+        return false;
+
+    qint64 modified, size;
+    if (!stat(filePath, &modified, &size) || modified != it->modified || size != it->size) {
+        qmldirs.erase(it);
+        dirty = true;
+        return false;
+    }
+
+    *content = it->content;
+    return true;
+}
+
+void QQmlImportIndex::setQmldirContent(const QString &filePath, const QString &content)
+{
+    QmldirContent qmldir;
+    if (!stat(filePath, &qmldir.modified, &qmldir.size))
+        return;
+    qmldir.content = content;
+
+    QMutexLocker locker(&mutex);
+    qmldirs.insert(filePath, qmldir);
+    dirty = true;
+}
+
+/*!
+Writes the index to the file named by QML_IMPORT_INDEX, if it changed.
+*/
+void QQmlImportIndex::save()
+{
+    QMutexLocker locker(&mutex);
+    if (!dirty || fileName.isEmpty())
+        return;
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << importIndexMagic << importIndexVersion;
+
+    stream << quint32(locations.count());
+    for (QHash<QString, Location>::ConstIterator it = locations.constBegin(); it != locations.constEnd(); ++it) {
+        stream << it.key() << it->result << quint32(it->directories.count());
+        for (int ii = 0; ii < it->directories.count(); ++ii)
+            stream << it->directories.at(ii).path << it->directories.at(ii).modified;
+    }
+
+    stream << quint32(qmldirs.count());
+    for (QHash<QString, QmldirContent>::ConstIterator it = qmldirs.constBegin(); it != qmldirs.constEnd(); ++it)
+        stream << it.key() << it->content << it->modified << it->size;
+
+    if (file.commit())
+        dirty = false;
+}
+
+void QQmlImportIndex::load()
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic, version;
+    stream >> magic >> version;
+    if (magic != importIndexMagic || version != importIndexVersion)
+        return;
+
+    quint32 count;
+    stream >> count;
+    for (quint32 ii = 0; ii < count && stream.status() == QDataStream::Ok; ++ii) {
+        QString key;
+        Location location;
+        quint32 directoryCount;
+        stream >> key >> location.result >> directoryCount;
+        for (quint32 jj = 0; jj < directoryCount && stream.status() == QDataStream::Ok; ++jj) {
+            DirectoryStamp stamp;
+            stream >> stamp.path >> stamp.modified;
+            location.directories.append(stamp);
+        }
+        locations.insert(key, location);
+    }
+
+    stream >> count;
+    for (quint32 ii = 0; ii < count && stream.status() == QDataStream::Ok; ++ii) {
+        QString filePath;
+        QmldirContent qmldir;
+        stream >> filePath >> qmldir.content >> qmldir.modified >> qmldir.size;
+        qmldirs.insert(filePath, qmldir);
+    }
+
+    // Don't trust any of a truncated or otherwise damaged index
+    if (stream.status() != QDataStream::Ok) {
+        locations.clear();
+        qmldirs.clear();
+    }
+}
+
+bool QQmlImportIndex::stat(const QString &path, qint64 *modified, qint64 *size)
+{
+    QFileInfo info(path);
+    if (!info.exists())
+        return false;
+    *modified = info.lastModified().toMSecsSinceEpoch();
+    if (size)
+        *size = info.size();
+    return true;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,116 @@
+/****************************************************************************
+**
+** Copyright (C) 2013 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQml module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QQMLIMPORTINDEX_P_H
+#define QQMLIMPORTINDEX_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qstringlist.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+// Remembers where modules and plugins were found on disk, or that they
+// were not found, and the contents of the qmldir files read.  The index is
+// shared by all engines in the process.  If QML_IMPORT_INDEX names a file,
+// it is also loaded from and saved to that file, so that following runs
+// don't have to search the import paths again.
+//
+// Entries are validated against the modification times of the directories
+// that were searched, so adding or removing a module invalidates them.
+class QQmlImportIndex
+{
+public:
+    static QQmlImportIndex *instance();
+
+    QQmlImportIndex();
+
+    bool location(const QString &key, QString *result);
+    void setLocation(const QString &key, const QString &result, const QStringList &searchedPaths);
+
+    bool qmldirContent(const QString &filePath, QString *content);
+    void setQmldirContent(const QString &filePath, const QString &content);
+
+    void save();
+
+private:
+    struct DirectoryStamp {
+        QString path;
+        qint64 modified;
+    };
+
+    struct Location {
+        QString result;
+        QVector<DirectoryStamp> directories;
+    };
+
+    struct QmldirContent {
+        QString content;
+        qint64 modified;
+        qint64 size;
+    };
+
+    static bool stat(const QString &path, qint64 *modified, qint64 *size = 0);
+    void load();
+
+    QMutex mutex;
+    QString fileName;
+    bool dirty;
+    QHash<QString, Location> locations;
+    QHash<QString, QmldirContent> qmldirs;
+};
+
+QT_END_NAMESPACE
+
+#endif // QQMLIMPORTINDEX_P_H
@@ -134,7 +134,7 @@ QQmlIncubationController *QQmlEngine::incubationController() const
 
 QQmlIncubatorPrivate::QQmlIncubatorPrivate(QQmlIncubator *q, QQmlIncubator::IncubationMode m)
     : q(q), status(QQmlIncubator::Null), mode(m), isAsynchronous(false), progress(Execute),
-      result(0), compiledData(0), waitingOnMe(0)
+      preload(false), result(0), compiledData(0), waitingOnMe(0)
 {
 }
 
@@ -389,6 +389,18 @@ finishIncubate:
     }
 }
 
+// Incubators that preload content are only scheduled once nothing else waits.
+static QQmlIncubatorPrivate *nextIncubator(QQmlEnginePrivate *d)
+{
+    for (QIntrusiveList<QQmlEnginePrivate::Incubator, &QQmlEnginePrivate::Incubator::next>::iterator it
+             = d->incubatorList.begin(); it != d->incubatorList.end(); ++it) {
+        QQmlIncubatorPrivate *p = static_cast<QQmlIncubatorPrivate*>(*it);
+        if (!p->preload)
+            return p;
+    }
+    return static_cast<QQmlIncubatorPrivate*>(d->incubatorList.first());
+}
+
 /*!
 Incubate objects for \a msecs, or until there are no more objects to incubate.
 */
@@ -400,7 +412,7 @@ void QQmlIncubationController::incubateFor(int msecs)
     QQmlInstantiationInterrupt i(msecs * 1000000);
     i.reset();
     do {
-        static_cast<QQmlIncubatorPrivate*>(d->incubatorList.first())->incubate(i);
+        nextIncubator(d)->incubate(i);
     } while (d && d->incubatorCount != 0 && !i.shouldInterrupt());
 }
 
@@ -419,7 +431,7 @@ void QQmlIncubationController::incubateWhile(volatile bool *flag, int msecs)
     QQmlInstantiationInterrupt i(flag, msecs * 1000000);
     i.reset();
     do {
-        static_cast<QQmlIncubatorPrivate*>(d->incubatorList.first())->incubate(i);
+        nextIncubator(d)->incubate(i);
     } while (d && d->incubatorCount != 0 && !i.shouldInterrupt());
 }
 
@@ -79,6 +79,9 @@ public:
 
     QQmlIncubator::IncubationMode mode;
     bool isAsynchronous;
+    // Preloads content that is not needed yet; only incubated when no other
+    // incubator is waiting
+    bool preload;
 
     QList<QQmlError> errors;
 
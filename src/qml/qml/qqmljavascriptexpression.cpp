@@ -43,6 +43,8 @@
 
 #include <private/qqmlexpression_p.h>
 #include <private/qqmlcontextwrapper_p.h>
+#include <private/qqmlbindingprogram_p.h>
+#include <private/qqmlbindinggraph_p.h>
 #include <private/qv4value_inl_p.h>
 #include <private/qv4functionobject_p.h>
 #include <private/qv4script_p.h>
@@ -98,6 +100,8 @@ QQmlJavaScriptExpression::QQmlJavaScriptExpression(VTable *v)
 QQmlJavaScriptExpression::~QQmlJavaScriptExpression()
 {
     clearGuards();
+    if (QQmlBindingGraph *graph = QQmlBindingGraph::instance())
+        graph->expressionDestroyed(this);
     if (m_scopeObject.isT2()) // notify DeleteWatcher of our deletion.
         m_scopeObject.asT2()->_s = 0;
 }
@@ -194,6 +198,57 @@ QV4::ReturnedValue QQmlJavaScriptExpression::evaluate(QQmlContextData *context,
     return result.asReturnedValue();
 }
 
+// Same as above, except that the expression is evaluated by \a program.
+// If the program gives up, \a ok is set to false and the result (and any
+// warning produced so far) must be discarded.
+QV4::ReturnedValue QQmlJavaScriptExpression::evaluate(QQmlContextData *context,
+                                   const QQmlBindingProgram *program,
+                                   bool *isUndefined, bool *ok)
+{
+    Q_ASSERT(context && context->engine);
+
+    QQmlEnginePrivate *ep = QQmlEnginePrivate::get(context->engine);
+
+    // All code that follows must check with watcher before it accesses data members
+    // incase we have been deleted.
+    DeleteWatcher watcher(this);
+
+    Q_ASSERT(notifyOnValueChanged() || activeGuards.isEmpty());
+    GuardCapture capture(context->engine, this, &watcher);
+
+    QQmlEnginePrivate::PropertyCapture *lastPropertyCapture = ep->propertyCapture;
+    ep->propertyCapture = notifyOnValueChanged()?&capture:0;
+
+
+    if (notifyOnValueChanged())
+        capture.guards.copyAndClearPrepend(activeGuards);
+
+    QV4::ExecutionEngine *v4 = QV8Engine::getV4(ep->v8engine());
+    QV4::ReturnedValue result = QV4::Encode::undefined();
+    *ok = program->run(v4, context, scopeObject(), &result);
+    if (*ok) {
+        if (isUndefined)
+            *isUndefined = result == QV4::Encode::undefined();
+
+        if (!watcher.wasDeleted() && hasDelayedError())
+            delayedError()->clearError();
+    }
+
+    if (capture.errorString) {
+        for (int ii = 0; *ok && ii < capture.errorString->count(); ++ii)
+            qWarning("%s", qPrintable(capture.errorString->at(ii)));
+        delete capture.errorString;
+        capture.errorString = 0;
+    }
+
+    while (Guard *g = capture.guards.takeFirst())
+        g->Delete();
+
+    ep->propertyCapture = lastPropertyCapture;
+
+    return result;
+}
+
 void QQmlJavaScriptExpression::GuardCapture::captureProperty(QQmlNotifier *n)
 {
     if (watcher->wasDeleted())
@@ -201,22 +256,66 @@ void QQmlJavaScriptExpression::GuardCapture::captureProperty(QQmlNotifier *n)
 
     Q_ASSERT(expression);
     // Try and find a matching guard
-    while (!guards.isEmpty() && !guards.first()->isConnected(n))
-        guards.takeFirst()->Delete();
-
     Guard *g = 0;
-    if (!guards.isEmpty()) {
+    if (!guards.isEmpty() && guards.first()->isConnected(n)) {
+        addCaptured(n, -1);
         g = guards.takeFirst();
+    } else {
+        // Dependencies that were already captured during this evaluation
+        // need no second guard
+        if (!addCaptured(n, -1))
+            return;
+
+        // The dependencies may have been read in a different order than
+        // last time, so look further ahead before creating a new guard
+        Guard *prev = guards.first();
+        while (prev && prev->next && !prev->next->isConnected(n))
+            prev = prev->next;
+        if (prev && prev->next)
+            g = guards.takeNext(prev);
+    }
+
+    if (g) {
         g->cancelNotify();
         Q_ASSERT(g->isConnected(n));
     } else {
         g = Guard::New(expression, engine);
         g->connect(n);
+        if (QQmlBindingGraph *graph = QQmlBindingGraph::instance())
+            graph->captureProperty(expression, g, n);
     }
 
     expression->activeGuards.prepend(g);
 }
 
+/*! \internal
+
+    Records that \a sender, a notifier or an object together with
+    \a signalIndex, got a guard during this evaluation. Returns false if it
+    already had one.
+*/
+bool QQmlJavaScriptExpression::GuardCapture::addCaptured(const void *sender, int signalIndex)
+{
+    const Captured key(sender, signalIndex);
+    if (captured.size() < MaxScannedCaptures) {
+        for (int ii = 0; ii < captured.size(); ++ii) {
+            if (captured.at(ii) == key)
+                return false;
+        }
+        captured.append(key);
+        return true;
+    }
+
+    if (capturedSet.isEmpty()) {
+        for (int ii = 0; ii < captured.size(); ++ii)
+            capturedSet.insert(captured.at(ii));
+    }
+    if (capturedSet.contains(key))
+        return false;
+    capturedSet.insert(key);
+    return true;
+}
+
 /*! \internal
 
     \a n is in the signal index range (see QObjectPrivate::signalIndex()).
@@ -247,17 +346,29 @@ void QQmlJavaScriptExpression::GuardCapture::captureProperty(QObject *o, int c,
     } else {
 
         // Try and find a matching guard
-        while (!guards.isEmpty() && !guards.first()->isConnected(o, n))
-            guards.takeFirst()->Delete();
-
         Guard *g = 0;
-        if (!guards.isEmpty()) {
+        if (!guards.isEmpty() && guards.first()->isConnected(o, n)) {
+            addCaptured(o, n);
             g = guards.takeFirst();
+        } else {
+            if (!addCaptured(o, n))
+                return;
+
+            Guard *prev = guards.first();
+            while (prev && prev->next && !prev->next->isConnected(o, n))
+                prev = prev->next;
+            if (prev && prev->next)
+                g = guards.takeNext(prev);
+        }
+
+        if (g) {
             g->cancelNotify();
             Q_ASSERT(g->isConnected(o, n));
         } else {
             g = Guard::New(expression, engine);
             g->connect(o, n, engine);
+            if (QQmlBindingGraph *graph = QQmlBindingGraph::instance())
+                graph->captureProperty(expression, g, o, c);
         }
 
         expression->activeGuards.prepend(g);
@@ -365,10 +476,19 @@ void QQmlJavaScriptExpression::clearGuards()
 
 void QQmlJavaScriptExpressionGuard_callback(QQmlNotifierEndpoint *e, void **)
 {
-    QQmlJavaScriptExpression *expression =
-        static_cast<QQmlJavaScriptExpressionGuard *>(e)->expression;
+    QQmlJavaScriptExpressionGuard *guard = static_cast<QQmlJavaScriptExpressionGuard *>(e);
+    QQmlJavaScriptExpression *expression = guard->expression;
+
+    QQmlBindingGraph *graph = QQmlBindingGraph::instance();
+    if (!graph) {
+        expression->m_vtable->expressionChanged(expression);
+        return;
+    }
 
+    // The guard may be gone after the expression is re-evaluated, and the expression as well.
+    graph->startTrigger(guard);
     expression->m_vtable->expressionChanged(expression);
+    graph->finishTrigger(expression);
 }
 
 QT_END_NAMESPACE
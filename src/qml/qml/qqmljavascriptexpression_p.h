@@ -54,6 +54,9 @@
 //
 
 #include <QtCore/qglobal.h>
+#include <QtCore/qpair.h>
+#include <QtCore/qset.h>
+#include <QtCore/qvarlengtharray.h>
 #include <QtQml/qqmlerror.h>
 #include <private/qqmlengine_p.h>
 #include <private/qpointervaluepair_p.h>
@@ -64,6 +67,8 @@ namespace QV4 {
 struct ExecutionContext;
 }
 
+class QQmlBindingProgram;
+
 class QQmlDelayedError
 {
 public:
@@ -116,6 +121,7 @@ public:
 
     QV4::ReturnedValue evaluate(QQmlContextData *, const QV4::ValueRef function, bool *isUndefined);
     QV4::ReturnedValue evaluate(QQmlContextData *, const QV4::ValueRef function, QV4::CallData *callData, bool *isUndefined);
+    QV4::ReturnedValue evaluate(QQmlContextData *, const QQmlBindingProgram *program, bool *isUndefined, bool *ok);
 
     inline bool notifyOnValueChanged() const;
 
@@ -159,6 +165,7 @@ protected:
 private:
     typedef QQmlJavaScriptExpressionGuard Guard;
     friend void QQmlJavaScriptExpressionGuard_callback(QQmlNotifierEndpoint *, void **);
+    friend class QQmlBindingGraph;
 
     struct GuardCapture : public QQmlEnginePrivate::PropertyCapture {
         GuardCapture(QQmlEngine *engine, QQmlJavaScriptExpression *e, DeleteWatcher *w)
@@ -172,11 +179,20 @@ private:
         virtual void captureProperty(QQmlNotifier *);
         virtual void captureProperty(QObject *, int, int);
 
+        bool addCaptured(const void *sender, int signalIndex);
+
         QQmlEngine *engine;
         QQmlJavaScriptExpression *expression;
         DeleteWatcher *watcher;
         QFieldList<Guard, &Guard::next> guards;
         QStringList *errorString;
+
+        // The notifiers and signals that got a guard during this evaluation.
+        // The first few are scanned, beyond that they are looked up in the set.
+        typedef QPair<const void *, int> Captured;
+        enum { MaxScannedCaptures = 8 };
+        QVarLengthArray<Captured, MaxScannedCaptures> captured;
+        QSet<Captured> capturedSet;
     };
 
     QPointerValuePair<VTable, QQmlDelayedError> m_vtable;
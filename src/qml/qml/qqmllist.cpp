@@ -414,6 +414,17 @@ will be neither designable nor alterable by the debugger. It is recommended to p
 pointers for all functions.
 */
 
+/*!
+\fn QQmlListProperty::QQmlListProperty(QObject *object, void *data, AppendFunction append,
+                                     CountFunction count, AtFunction at,
+                                     ClearFunction clear, ToArrayFunction toArray)
+\since 5.3
+
+Construct a QQmlListProperty from a set of operation functions, including a
+\a toArray function which reads all elements at once.  Otherwise this is the
+same as the constructor above.
+*/
+
 /*!
 \typedef QQmlListProperty::AppendFunction
 
@@ -452,4 +463,19 @@ Synonym for \c {void (*)(QQmlListProperty<T> *property)}.
 Clear the list \a property.
 */
 
+/*!
+\typedef QQmlListProperty::ToArrayFunction
+\since 5.3
+
+Synonym for \c {void (*)(QQmlListProperty<T> *property, T **array)}.
+
+Copy all elements of the list \a property into \a array, which has room for
+as many elements as the count function returns.
+
+This function is optional.  The QML engine uses it when JavaScript iterates
+over the list, which avoids calling the at function for every element.  It is
+worth providing when the at function is not constant time, for example when
+the list is computed from other data.
+*/
+
 QT_END_NAMESPACE
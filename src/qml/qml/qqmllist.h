@@ -61,17 +61,21 @@ public:
     typedef int (*CountFunction)(QQmlListProperty<T> *);
     typedef T *(*AtFunction)(QQmlListProperty<T> *, int);
     typedef void (*ClearFunction)(QQmlListProperty<T> *);
+    typedef void (*ToArrayFunction)(QQmlListProperty<T> *, T **);
 
     QQmlListProperty()
-        : object(0), data(0), append(0), count(0), at(0), clear(0), dummy1(0), dummy2(0) {}
+        : object(0), data(0), append(0), count(0), at(0), clear(0), toArray(0), dummy2(0) {}
     QQmlListProperty(QObject *o, QList<T *> &list)
         : object(o), data(&list), append(qlist_append), count(qlist_count), at(qlist_at),
-          clear(qlist_clear), dummy1(0), dummy2(0) {}
+          clear(qlist_clear), toArray(qlist_toArray), dummy2(0) {}
     QQmlListProperty(QObject *o, void *d, AppendFunction a, CountFunction c, AtFunction t,
                     ClearFunction r )
-        : object(o), data(d), append(a), count(c), at(t), clear(r), dummy1(0), dummy2(0) {}
+        : object(o), data(d), append(a), count(c), at(t), clear(r), toArray(0), dummy2(0) {}
+    QQmlListProperty(QObject *o, void *d, AppendFunction a, CountFunction c, AtFunction t,
+                    ClearFunction r, ToArrayFunction ta)
+        : object(o), data(d), append(a), count(c), at(t), clear(r), toArray(ta), dummy2(0) {}
     QQmlListProperty(QObject *o, void *d, CountFunction c, AtFunction t)
-        : object(o), data(d), append(0), count(c), at(t), clear(0), dummy1(0), dummy2(0) {}
+        : object(o), data(d), append(0), count(c), at(t), clear(0), toArray(0), dummy2(0) {}
     bool operator==(const QQmlListProperty &o) const {
         return object == o.object &&
                data == o.data &&
@@ -91,7 +95,7 @@ public:
 
     ClearFunction clear;
 
-    void *dummy1;
+    ToArrayFunction toArray;
     void *dummy2;
 
 private:
@@ -107,6 +111,11 @@ private:
     static void qlist_clear(QQmlListProperty *p) {
         return reinterpret_cast<QList<T *> *>(p->data)->clear();
     }
+    static void qlist_toArray(QQmlListProperty *p, T **array) {
+        const QList<T *> *list = reinterpret_cast<QList<T *> *>(p->data);
+        for (int i = 0; i < list->count(); ++i)
+            array[i] = list->at(i);
+    }
 };
 #endif
 
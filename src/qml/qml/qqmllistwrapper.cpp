@@ -52,9 +52,17 @@ using namespace QV4;
 
 DEFINE_OBJECT_VTABLE(QmlListWrapper);
 
+void QV4ListWrapper_callback(QQmlNotifierEndpoint *e, void **)
+{
+    static_cast<QQmlListWrapperEndpoint *>(e)->isValid = false;
+}
+
 QmlListWrapper::QmlListWrapper(QV8Engine *engine)
     : Object(QV8Engine::getV4(engine)),
-      v8(engine)
+      v8(engine),
+      propertyType(0),
+      cachedCount(-1),
+      indexedAccess(false)
 {
     setVTable(staticVTable());
     QV4::Scope scope(QV8Engine::getV4(engine));
@@ -67,7 +75,7 @@ QmlListWrapper::~QmlListWrapper()
 {
 }
 
-ReturnedValue QmlListWrapper::create(QV8Engine *v8, QObject *object, int propId, int propType)
+ReturnedValue QmlListWrapper::create(QV8Engine *v8, QObject *object, int propId, int propType, int notifyIndex)
 {
     if (!object || propId == -1)
         return Encode::null();
@@ -80,6 +88,8 @@ ReturnedValue QmlListWrapper::create(QV8Engine *v8, QObject *object, int propId,
     r->propertyType = propType;
     void *args[] = { &r->property, 0 };
     QMetaObject::metacall(object, QMetaObject::ReadProperty, propId, args);
+    if (notifyIndex != -1 && v8->engine())
+        r->endpoint.connect(object, notifyIndex, v8->engine());
     return r.asReturnedValue();
 }
 
@@ -103,6 +113,47 @@ QVariant QmlListWrapper::toVariant() const
     return QVariant::fromValue(QQmlListReferencePrivate::init(property, propertyType, v8->engine()));
 }
 
+void QmlListWrapper::validateCache()
+{
+    if (endpoint.isValid)
+        return;
+    cachedCount = -1;
+    indexedAccess = false;
+    cachedElements.clear();
+    endpoint.isValid = endpoint.isConnected();
+}
+
+quint32 QmlListWrapper::count()
+{
+    validateCache();
+    if (cachedCount < 0)
+        cachedCount = property.count ? property.count(&property) : 0;
+    return cachedCount;
+}
+
+QObject *QmlListWrapper::at(quint32 index)
+{
+    if (index >= count())
+        return 0;
+    if (cachedElements.isEmpty() && indexedAccess && endpoint.isValid) {
+        // The wrapper is being iterated, so read all elements at once rather
+        // than calling the at function, which may not be constant time, for
+        // every one of them.
+        if (property.toArray) {
+            cachedElements.resize(cachedCount);
+            property.toArray(&property, cachedElements.data());
+        } else if (property.at) {
+            cachedElements.reserve(cachedCount);
+            for (int i = 0; i < cachedCount; ++i)
+                cachedElements.append(property.at(&property, i));
+        }
+    }
+    if (!cachedElements.isEmpty())
+        return cachedElements.at(index);
+    indexedAccess = true;
+    return property.at ? property.at(&property, index) : 0;
+}
+
 
 ReturnedValue QmlListWrapper::get(Managed *m, const StringRef name, bool *hasProperty)
 {
@@ -111,10 +162,8 @@ ReturnedValue QmlListWrapper::get(Managed *m, const StringRef name, bool *hasPro
     if (!w)
         return v4->currentContext()->throwTypeError();
 
-    if (name->equals(v4->id_length) && !w->object.isNull()) {
-        quint32 count = w->property.count ? w->property.count(&w->property) : 0;
-        return Primitive::fromUInt32(count).asReturnedValue();
-    }
+    if (name->equals(v4->id_length) && !w->object.isNull())
+        return Primitive::fromUInt32(w->count()).asReturnedValue();
 
     uint idx = name->asArrayIndex();
     if (idx != UINT_MAX)
@@ -135,11 +184,10 @@ ReturnedValue QmlListWrapper::getIndexed(Managed *m, uint index, bool *hasProper
         return e->currentContext()->throwTypeError();
     }
 
-    quint32 count = w->property.count ? w->property.count(&w->property) : 0;
-    if (index < count && w->property.at) {
+    if (!w->object.isNull() && index < w->count() && w->property.at) {
         if (hasProperty)
             *hasProperty = true;
-        return QV4::QObjectWrapper::wrap(e, w->property.at(&w->property, index));
+        return QV4::QObjectWrapper::wrap(e, w->at(index));
     }
 
     if (hasProperty)
@@ -166,12 +214,11 @@ void QmlListWrapper::advanceIterator(Managed *m, ObjectIterator *it, StringRef n
     name = (String *)0;
     *index = UINT_MAX;
     QmlListWrapper *w = m->as<QmlListWrapper>();
-    quint32 count = w->property.count ? w->property.count(&w->property) : 0;
-    if (it->arrayIndex < count) {
+    if (!w->object.isNull() && it->arrayIndex < w->count()) {
         *index = it->arrayIndex;
         ++it->arrayIndex;
         *attrs = QV4::Attr_Data;
-        p->value = QV4::QObjectWrapper::wrap(w->engine(), w->property.at(&w->property, *index));
+        p->value = QV4::QObjectWrapper::wrap(w->engine(), w->at(*index));
         return;
     }
     return QV4::Object::advanceIterator(m, it, name, index, p, attrs);
@@ -55,9 +55,11 @@
 
 #include <QtCore/qglobal.h>
 #include <QtCore/qpointer.h>
+#include <QtCore/qvector.h>
 
 #include <QtQml/qqmllist.h>
 
+#include <private/qqmlnotifier_p.h>
 #include <private/qv4value_inl_p.h>
 #include <private/qv4object_p.h>
 
@@ -65,6 +67,16 @@ QT_BEGIN_NAMESPACE
 
 class QV8Engine;
 
+// Tracks whether the elements cached by a list wrapper are still current, by
+// listening to the notify signal of the list property.
+class QQmlListWrapperEndpoint : public QQmlNotifierEndpoint
+{
+public:
+    QQmlListWrapperEndpoint() : isValid(false) { setCallback(QV4ListWrapper); }
+
+    bool isValid;
+};
+
 namespace QV4 {
 
 struct Q_QML_EXPORT QmlListWrapper : Object
@@ -76,7 +88,7 @@ protected:
 
 public:
 
-    static ReturnedValue create(QV8Engine *v8, QObject *object, int propId, int propType);
+    static ReturnedValue create(QV8Engine *v8, QObject *object, int propId, int propType, int notifyIndex = -1);
     static ReturnedValue create(QV8Engine *v8, const QQmlListProperty<QObject> &prop, int propType);
 
     QVariant toVariant() const;
@@ -88,11 +100,22 @@ public:
     static void destroy(Managed *that);
 
 private:
+    void validateCache();
+    quint32 count();
+    QObject *at(quint32 index);
+
     QV8Engine *v8;
     QPointer<QObject> object;
     QQmlListProperty<QObject> property;
     int propertyType;
 
+    // The count, and once the list is read more than once by index all of
+    // its elements, are kept until the list property notifies a change.
+    // Lists without a notify signal are read on every access.
+    QQmlListWrapperEndpoint endpoint;
+    int cachedCount;
+    bool indexedAccess;
+    QVector<QObject *> cachedElements;
 };
 
 }
@@ -52,6 +52,8 @@
 #include <private/qv4numberobject_p.h>
 #include <private/qv4stringobject_p.h>
 
+#include <cmath>
+
 QT_BEGIN_NAMESPACE
 
 DEFINE_OBJECT_VTABLE(QQmlLocaleData);
@@ -351,6 +353,48 @@ QV4::ReturnedValue QQmlDateExtension::method_timeZoneUpdated(QV4::CallContext *c
 //-----------------
 // Number extension
 
+// Fast path for toLocaleString(locale, 'f', prec) on integral values, the
+// common case for counts and amounts in tables. Writes the digits, group
+// separators and sign into a single preallocated string, producing the same
+// result as QLocale::toString() without going through the generic double
+// conversion. Returns false for values it doesn't handle.
+static bool integralToLocaleString(const QLocale &locale, double number, int prec, QString *result)
+{
+    if (prec < 0 || prec > 16 || !(qAbs(number) < 9007199254740992.0) || number != std::floor(number))
+        return false;
+    if (number == 0 && 1 / number < 0) // -0
+        return false;
+
+    const bool negative = number < 0;
+    quint64 value = quint64(negative ? -number : number);
+
+    const ushort zero = locale.zeroDigit().unicode();
+    ushort digits[20];
+    int count = 0;
+    do {
+        digits[count++] = zero + value % 10;
+        value /= 10;
+    } while (value);
+
+    const bool group = !(locale.numberOptions() & QLocale::OmitGroupSeparator);
+    const QChar groupSeparator = locale.groupSeparator();
+
+    result->reserve(1 + count + (group ? count / 3 : 0) + (prec ? prec + 1 : 0));
+    if (negative)
+        result->append(locale.negativeSign());
+    for (int i = count - 1; i >= 0; --i) {
+        result->append(QChar(digits[i]));
+        if (group && i && !(i % 3))
+            result->append(groupSeparator);
+    }
+    if (prec) {
+        result->append(locale.decimalPoint());
+        for (int i = 0; i < prec; ++i)
+            result->append(QChar(zero));
+    }
+    return true;
+}
+
 void QQmlNumberExtension::registerExtension(QV4::ExecutionEngine *engine)
 {
     engine->numberClass->prototype->defineDefaultProperty(QStringLiteral("toLocaleString"), method_toLocaleString);
@@ -393,7 +437,10 @@ QV4::ReturnedValue QQmlNumberExtension::method_toLocaleString(QV4::CallContext *
          prec = ctx->callData->args[2].toInt32();
     }
 
-    return ctx->engine->newString(r->locale.toString(number, (char)format, prec))->asReturnedValue();
+    QString formatted;
+    if (format != 'f' || !integralToLocaleString(r->locale, number, prec, &formatted))
+        formatted = r->locale.toString(number, (char)format, prec);
+    return ctx->engine->newString(formatted)->asReturnedValue();
 }
 
 QV4::ReturnedValue QQmlNumberExtension::method_toLocaleCurrencyString(QV4::CallContext *ctx)
@@ -656,6 +703,8 @@ public:
     ~QV8LocaleDataDeletable();
 
     QV4::PersistentValue prototype;
+    // Locale objects handed out by Qt.locale(), by locale name
+    QHash<QString, QV4::PersistentValue> locales;
 };
 
 QV8LocaleDataDeletable::QV8LocaleDataDeletable(QV8Engine *engine)
@@ -803,10 +852,28 @@ QQmlLocale::~QQmlLocale()
 
 QV4::ReturnedValue QQmlLocale::locale(QV8Engine *v8engine, const QString &localeName)
 {
+    // A locale object carries nothing but its QLocale, so each name maps to
+    // one shared object instead of a new QLocale and wrapper per call.
+    QV8LocaleDataDeletable *d = localeV8Data(v8engine);
+    QV4::Scope scope(QV8Engine::getV4(v8engine));
+    QHash<QString, QV4::PersistentValue>::Iterator it = d->locales.find(localeName);
+    if (it != d->locales.end()) {
+        QV4::Scoped<QQmlLocaleData> cached(scope, it->value());
+        // the default locale may have been changed since
+        if (cached && (!localeName.isEmpty() || cached->locale == QLocale()))
+            return cached.asReturnedValue();
+    }
+
     QLocale qlocale;
     if (!localeName.isEmpty())
         qlocale = localeName;
-    return wrap(v8engine, qlocale);
+    QV4::ScopedValue wrapper(scope, wrap(v8engine, qlocale));
+
+    // names are usually a handful of constants; don't let generated ones pile up
+    if (d->locales.count() >= 64)
+        d->locales.clear();
+    d->locales.insert(localeName, QV4::PersistentValue(wrapper.asReturnedValue()));
+    return wrapper.asReturnedValue();
 }
 
 QV4::ReturnedValue QQmlLocale::wrap(QV8Engine *engine, const QLocale &locale)
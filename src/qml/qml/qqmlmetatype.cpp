@@ -52,6 +52,7 @@
 #include <QtCore/qmetaobject.h>
 #include <QtCore/qbitarray.h>
 #include <QtCore/qreadwritelock.h>
+#include <QtCore/qatomic.h>
 #include <QtCore/private/qmetaobject_p.h>
 
 #include <qmetatype.h>
@@ -67,23 +68,33 @@
 
 QT_BEGIN_NAMESPACE
 
-struct QQmlMetaTypeData
+// The tables that the hot lookups read. Published snapshots of them are
+// read without taking metaTypeDataLock, see QQmlMetaTypeTablesReader.
+struct QQmlMetaTypeTables
 {
-    QQmlMetaTypeData();
-    ~QQmlMetaTypeData();
     QList<QQmlType *> types;
     typedef QHash<int, QQmlType *> Ids;
     Ids idToType;
     typedef QHash<QHashedStringRef,QQmlType *> Names;
     Names nameToType;
+    typedef QHash<const QMetaObject *, QQmlType *> MetaObjects;
+    MetaObjects metaObjectToType;
+
+    QBitArray objects;
+    QBitArray interfaces;
+    QBitArray lists;
+};
+
+struct QQmlMetaTypeData : QQmlMetaTypeTables
+{
+    QQmlMetaTypeData();
+    ~QQmlMetaTypeData();
     typedef QHash<QUrl, QQmlType *> Files; //For file imported composite types only
     Files urlToType;
     Files urlToNonFileImportType; // For non-file imported composite and composite
                                   // singleton types. This way we can locate any
                                   // of them by url, even if it was registered as
                                   // a module via qmlRegisterCompositeType.
-    typedef QHash<const QMetaObject *, QQmlType *> MetaObjects;
-    MetaObjects metaObjectToType;
     typedef QHash<int, QQmlMetaType::StringConverter> StringConverters;
     StringConverters stringConverters;
 
@@ -101,10 +112,6 @@ struct QQmlMetaTypeData
     typedef QHash<VersionedUri, QQmlTypeModule *> TypeModules;
     TypeModules uriToModule;
 
-    QBitArray objects;
-    QBitArray interfaces;
-    QBitArray lists;
-
     QList<QQmlPrivate::AutoParentFunction> parentFunctions;
     QVector<QQmlPrivate::QmlUnitCacheLookupFunction> lookupCachedQmlUnit;
 
@@ -112,6 +119,20 @@ struct QQmlMetaTypeData
 
     QString typeRegistrationNamespace;
     QStringList typeRegistrationFailures;
+
+    // Copy of the tables for lock-free reads, published once lookups have
+    // not seen a registration for a while. The containers are implicitly
+    // shared with the live ones, so this costs little until the next
+    // registration detaches them. Retired snapshots may still be in use by
+    // readers, they are deleted by the next registration that finds no
+    // reader registered in snapshotReaders.
+    QAtomicPointer<QQmlMetaTypeTables> snapshot;
+    QAtomicInt lockedReads;
+    QAtomicInt snapshotReaders;
+    QList<QQmlMetaTypeTables *> retiredSnapshots;
+
+    // Caller must hold a QWriteLocker on metaTypeDataLock()
+    void invalidateSnapshot();
 };
 
 class QQmlTypeModulePrivate
@@ -148,6 +169,9 @@ QQmlMetaTypeData::QQmlMetaTypeData()
 
 QQmlMetaTypeData::~QQmlMetaTypeData()
 {
+    delete snapshot.load();
+    qDeleteAll(retiredSnapshots);
+
     for (int i = 0; i < types.count(); ++i)
         delete types.at(i);
 
@@ -156,6 +180,81 @@ QQmlMetaTypeData::~QQmlMetaTypeData()
         delete *i;
 }
 
+void QQmlMetaTypeData::invalidateSnapshot()
+{
+    lockedReads.store(0);
+    if (QQmlMetaTypeTables *tables = snapshot.fetchAndStoreOrdered(0))
+        retiredSnapshots.append(tables);
+
+    // Readers register before they load the snapshot, and no new snapshot can
+    // be published while the write lock is held. So if nobody is registered
+    // now, nobody can be using a retired snapshot any more.
+    if (!retiredSnapshots.isEmpty() && snapshotReaders.fetchAndAddOrdered(0) == 0) {
+        qDeleteAll(retiredSnapshots);
+        retiredSnapshots.clear();
+    }
+}
+
+// Number of lookups that have to go through the lock without a registration
+// in between before a snapshot is published
+static const int snapshotThreshold = 64;
+
+static const QQmlMetaTypeTables *metaTypeSnapshot()
+{
+    QQmlMetaTypeData *data = metaTypeData();
+    if (const QQmlMetaTypeTables *tables = data->snapshot.loadAcquire())
+        return tables;
+    if (data->lockedReads.fetchAndAddRelaxed(1) < snapshotThreshold)
+        return 0;
+
+    // Publish while holding the lock, so that no registration can slip in
+    // between taking the copy and publishing it
+    QReadLocker lock(metaTypeDataLock());
+    QQmlMetaTypeTables *tables = new QQmlMetaTypeTables(*data);
+    if (!data->snapshot.testAndSetOrdered(0, tables)) {
+        delete tables;
+        return data->snapshot.loadAcquire();
+    }
+    return tables;
+}
+
+// Returns the published snapshot registered as in use, or 0 if the lock has
+// to be taken instead
+static const QQmlMetaTypeTables *acquireMetaTypeSnapshot()
+{
+    QQmlMetaTypeData *data = metaTypeData();
+    data->snapshotReaders.ref();
+    const QQmlMetaTypeTables *tables = metaTypeSnapshot();
+    if (!tables)
+        data->snapshotReaders.deref();
+    return tables;
+}
+
+// Gives read access to the lookup tables, through the published snapshot
+// if there is one and through the locked live data otherwise.
+class QQmlMetaTypeTablesReader
+{
+public:
+    QQmlMetaTypeTablesReader()
+        : m_snapshot(acquireMetaTypeSnapshot())
+        , m_lock(m_snapshot ? 0 : metaTypeDataLock())
+    {}
+    ~QQmlMetaTypeTablesReader()
+    {
+        if (m_snapshot)
+            metaTypeData()->snapshotReaders.deref();
+    }
+
+    const QQmlMetaTypeTables *operator->() const
+    { return m_snapshot ? m_snapshot : metaTypeData(); }
+
+    void unlock() { m_lock.unlock(); }
+
+private:
+    const QQmlMetaTypeTables *m_snapshot;
+    QReadLocker m_lock;
+};
+
 class QQmlTypePrivate
 {
 public:
@@ -1097,6 +1196,7 @@ void qmlClearTypeRegistrations() // Declared in qqml.h
     //Only cleans global static, assumed no running engine
     QWriteLocker lock(metaTypeDataLock());
     QQmlMetaTypeData *data = metaTypeData();
+    data->invalidateSnapshot();
 
     for (int i = 0; i < data->types.count(); ++i)
         delete data->types.at(i);
@@ -1134,6 +1234,7 @@ int registerInterface(const QQmlPrivate::RegisterInterface &interface)
 
     QWriteLocker lock(metaTypeDataLock());
     QQmlMetaTypeData *data = metaTypeData();
+    data->invalidateSnapshot();
 
     int index = data->types.count();
 
@@ -1224,6 +1325,8 @@ bool checkRegistration(QQmlType::RegistrationType typeType, QQmlMetaTypeData *da
 // NOTE: caller must hold a QWriteLocker on "data"
 void addTypeToData(QQmlType* type, QQmlMetaTypeData *data)
 {
+    data->invalidateSnapshot();
+
     if (!type->elementName().isEmpty())
         data->nameToType.insertMulti(type->elementName(), type);
 
@@ -1523,8 +1626,7 @@ bool QQmlMetaType::isQObject(int userType)
     if (userType == QMetaType::QObjectStar)
         return true;
 
-    QReadLocker lock(metaTypeDataLock());
-    QQmlMetaTypeData *data = metaTypeData();
+    QQmlMetaTypeTablesReader data;
     return userType >= 0 && userType < data->objects.size() && data->objects.testBit(userType);
 }
 
@@ -1533,8 +1635,7 @@ bool QQmlMetaType::isQObject(int userType)
  */
 int QQmlMetaType::listType(int id)
 {
-    QReadLocker lock(metaTypeDataLock());
-    QQmlMetaTypeData *data = metaTypeData();
+    QQmlMetaTypeTablesReader data;
     QQmlType *type = data->idToType.value(id);
     if (type && type->qListTypeId() == id)
         return type->typeId();
@@ -1544,8 +1645,7 @@ int QQmlMetaType::listType(int id)
 
 int QQmlMetaType::attachedPropertiesFuncId(const QMetaObject *mo)
 {
-    QReadLocker lock(metaTypeDataLock());
-    QQmlMetaTypeData *data = metaTypeData();
+    QQmlMetaTypeTablesReader data;
 
     QQmlType *type = data->metaObjectToType.value(mo);
     if (type && type->attachedPropertiesFunction())
@@ -1558,8 +1658,7 @@ QQmlAttachedPropertiesFunc QQmlMetaType::attachedPropertiesFuncById(int id)
 {
     if (id < 0)
         return 0;
-    QReadLocker lock(metaTypeDataLock());
-    QQmlMetaTypeData *data = metaTypeData();
+    QQmlMetaTypeTablesReader data;
     return data->types.at(id)->attachedPropertiesFunction();
 }
 
@@ -1622,8 +1721,7 @@ QQmlMetaType::TypeCategory QQmlMetaType::typeCategory(int userType)
     if (userType == QMetaType::QObjectStar)
         return Object;
 
-    QReadLocker lock(metaTypeDataLock());
-    QQmlMetaTypeData *data = metaTypeData();
+    QQmlMetaTypeTablesReader data;
     if (userType < data->objects.size() && data->objects.testBit(userType))
         return Object;
     else if (userType < data->lists.size() && data->lists.testBit(userType))
@@ -1634,17 +1732,15 @@ QQmlMetaType::TypeCategory QQmlMetaType::typeCategory(int userType)
 
 bool QQmlMetaType::isInterface(int userType)
 {
-    QReadLocker lock(metaTypeDataLock());
-    QQmlMetaTypeData *data = metaTypeData();
+    QQmlMetaTypeTablesReader data;
     return userType >= 0 && userType < data->interfaces.size() && data->interfaces.testBit(userType);
 }
 
 const char *QQmlMetaType::interfaceIId(int userType)
 {
-    QReadLocker lock(metaTypeDataLock());
-    QQmlMetaTypeData *data = metaTypeData();
+    QQmlMetaTypeTablesReader data;
     QQmlType *type = data->idToType.value(userType);
-    lock.unlock();
+    data.unlock();
     if (type && type->isInterface() && type->typeId() == userType)
         return type->interfaceIId();
     else
@@ -1653,8 +1749,7 @@ const char *QQmlMetaType::interfaceIId(int userType)
 
 bool QQmlMetaType::isList(int userType)
 {
-    QReadLocker lock(metaTypeDataLock());
-    QQmlMetaTypeData *data = metaTypeData();
+    QQmlMetaTypeTablesReader data;
     return userType >= 0 && userType < data->lists.size() && data->lists.testBit(userType);
 }
 
@@ -1718,8 +1813,7 @@ QQmlType *QQmlMetaType::qmlType(const QString &qualifiedName, int version_major,
 QQmlType *QQmlMetaType::qmlType(const QHashedStringRef &name, const QHashedStringRef &module, int version_major, int version_minor)
 {
     Q_ASSERT(version_major >= 0 && version_minor >= 0);
-    QReadLocker lock(metaTypeDataLock());
-    QQmlMetaTypeData *data = metaTypeData();
+    QQmlMetaTypeTablesReader data;
 
     QQmlMetaTypeData::Names::ConstIterator it = data->nameToType.constFind(name);
     while (it != data->nameToType.end() && it.key() == name) {
@@ -1738,8 +1832,7 @@ QQmlType *QQmlMetaType::qmlType(const QHashedStringRef &name, const QHashedStrin
 */
 QQmlType *QQmlMetaType::qmlType(const QMetaObject *metaObject)
 {
-    QReadLocker lock(metaTypeDataLock());
-    QQmlMetaTypeData *data = metaTypeData();
+    QQmlMetaTypeTablesReader data;
 
     return data->metaObjectToType.value(metaObject);
 }
@@ -1752,8 +1845,7 @@ QQmlType *QQmlMetaType::qmlType(const QMetaObject *metaObject)
 QQmlType *QQmlMetaType::qmlType(const QMetaObject *metaObject, const QHashedStringRef &module, int version_major, int version_minor)
 {
     Q_ASSERT(version_major >= 0 && version_minor >= 0);
-    QReadLocker lock(metaTypeDataLock());
-    QQmlMetaTypeData *data = metaTypeData();
+    QQmlMetaTypeTablesReader data;
 
     QQmlMetaTypeData::MetaObjects::const_iterator it = data->metaObjectToType.constFind(metaObject);
     while (it != data->metaObjectToType.end() && it.key() == metaObject) {
@@ -1772,8 +1864,7 @@ QQmlType *QQmlMetaType::qmlType(const QMetaObject *metaObject, const QHashedStri
 */
 QQmlType *QQmlMetaType::qmlType(int userType)
 {
-    QReadLocker lock(metaTypeDataLock());
-    QQmlMetaTypeData *data = metaTypeData();
+    QQmlMetaTypeTablesReader data;
 
     QQmlType *type = data->idToType.value(userType);
     if (type && type->typeId() == userType)
@@ -1810,8 +1901,7 @@ QQmlType *QQmlMetaType::qmlType(const QUrl &url, bool includeNonFileImports /* =
 */
 QQmlType *QQmlMetaType::qmlTypeFromIndex(int idx)
 {
-    QReadLocker lock(metaTypeDataLock());
-    QQmlMetaTypeData *data = metaTypeData();
+    QQmlMetaTypeTablesReader data;
 
     if (idx < 0 || idx >= data->types.count())
             return 0;
@@ -51,12 +51,17 @@ typedef void (*Callback)(QQmlNotifierEndpoint *, void **);
 void QQmlBoundSignal_callback(QQmlNotifierEndpoint *, void **);
 void QQmlJavaScriptExpressionGuard_callback(QQmlNotifierEndpoint *, void **);
 void QQmlVMEMetaObjectEndpoint_callback(QQmlNotifierEndpoint *, void **);
+void QV4SequenceReference_callback(QQmlNotifierEndpoint *, void **);
+void QV4ListWrapper_callback(QQmlNotifierEndpoint *, void **);
 
 static Callback QQmlNotifier_callbacks[] = {
     0,
     QQmlBoundSignal_callback,
     QQmlJavaScriptExpressionGuard_callback,
-    QQmlVMEMetaObjectEndpoint_callback
+    QQmlVMEMetaObjectEndpoint_callback,
+    0,
+    QV4SequenceReference_callback,
+    QV4ListWrapper_callback
 };
 
 void QQmlNotifier::emitNotify(QQmlNotifierEndpoint *endpoint, void **a)
@@ -81,7 +81,9 @@ public:
         QQmlBoundSignal = 1,
         QQmlJavaScriptExpressionGuard = 2,
         QQmlVMEMetaObjectEndpoint = 3,
-        QV4BindingsSubscription = 4
+        QV4BindingsSubscription = 4,
+        QV4SequenceReference = 5,
+        QV4ListWrapper = 6
     };
 
     inline void setCallback(Callback c) { callback = c; }
@@ -101,6 +103,9 @@ private:
     friend class QQmlData;
     friend class QQmlNotifier;
 
+    QQmlNotifierEndpoint  *next;
+    QQmlNotifierEndpoint **prev;
+
     // Contains either the QObject*, or the QQmlNotifier* that this
     // endpoint is connected to.  While the endpoint is notifying, the
     // senderPtr points to another qintptr that contains this value.
@@ -108,13 +113,13 @@ private:
     inline QObject *senderAsObject() const;
     inline QQmlNotifier *senderAsNotifier() const;
 
+    // The callback and signal index share the last word, so that on 64-bit
+    // platforms the padding after it can be reused by the members of
+    // derived endpoints instead of leaving a hole in the middle.
     Callback callback:4;
     // The index is in the range returned by QObjectPrivate::signalIndex().
     // This is different from QMetaMethod::methodIndex().
     signed int sourceSignal:28;
-
-    QQmlNotifierEndpoint  *next;
-    QQmlNotifierEndpoint **prev;
 };
 
 QQmlNotifier::QQmlNotifier()
@@ -146,7 +151,7 @@ void QQmlNotifier::notify()
 }
 
 QQmlNotifierEndpoint::QQmlNotifierEndpoint()
-: senderPtr(0), callback(None), sourceSignal(-1), next(0), prev(0)
+: next(0), prev(0), senderPtr(0), callback(None), sourceSignal(-1)
 {
 }
 
@@ -71,6 +71,11 @@ struct ActiveOCRestorer
 };
 }
 
+static inline QQmlSizeClassPool *bookkeepingPool(QQmlEngine *engine)
+{
+    return &QQmlEnginePrivate::get(engine)->bookkeepingPool;
+}
+
 static void removeBindingOnProperty(QObject *o, int index)
 {
     int coreIndex = index & 0x0000FFFF;
@@ -136,6 +141,7 @@ void QQmlObjectCreator::init(QQmlContextData *providedParentContext)
     _ddata = 0;
     _propertyCache = 0;
     _vmeMetaObject = 0;
+    _creationPlan = 0;
     _qmlContext = 0;
 }
 
@@ -182,7 +188,7 @@ QObject *QQmlObjectCreator::create(int subComponentIndex, QObject *parent, QQmlI
         objectToCreate = compObj->bindingTable()->value.objectIndex;
     }
 
-    context = new QQmlContextData;
+    context = new (bookkeepingPool(engine)) QQmlContextData;
     context->isInternal = true;
     context->url = compiledData->url;
     context->urlString = compiledData->name;
@@ -661,12 +667,22 @@ void QQmlObjectCreator::setupBindings(const QBitArray &bindingsToSkip)
     QQmlListProperty<void> savedList;
     qSwap(_currentList, savedList);
 
+    // Replay the property lookups of the first instantiation, if there was one
+    QQmlCompiledData::CreationPlan *plan = _creationPlan;
+    const bool replay = plan && plan->recorded;
+    if (plan && !replay) {
+        plan->idProperty = 0;
+        plan->bindingProperties.fill(0, _compiledObject->nBindings);
+        plan->bindingLookups.fill(false, _compiledObject->nBindings);
+    }
+
     QQmlPropertyData *property = 0;
     QQmlPropertyData *defaultProperty = _compiledObject->indexOfDefaultProperty != -1 ? _propertyCache->parent()->defaultProperty() : _propertyCache->defaultProperty();
 
-    QString id = stringAt(_compiledObject->idIndex);
-    if (!id.isEmpty()) {
-        QQmlPropertyData *idProperty = _propertyCache->property(QStringLiteral("id"), _qobject, context);
+    if (replay ? plan->idProperty != 0 : !stringAt(_compiledObject->idIndex).isEmpty()) {
+        QQmlPropertyData *idProperty = replay ? plan->idProperty : _propertyCache->property(QStringLiteral("id"), _qobject, context);
+        if (plan && !replay)
+            plan->idProperty = idProperty;
         if (idProperty && idProperty->isWritable() && idProperty->propType == QMetaType::QString) {
             QV4::CompiledData::Binding idBinding;
             idBinding.propertyNameIndex = 0; // Not used
@@ -709,23 +725,37 @@ void QQmlObjectCreator::setupBindings(const QBitArray &bindingsToSkip)
     const QV4::CompiledData::Binding *binding = _compiledObject->bindingTable();
     for (quint32 i = 0; i < _compiledObject->nBindings; ++i, ++binding) {
 
-        QString name = stringAt(binding->propertyNameIndex);
-        if (name.isEmpty())
-            property = 0;
-
-        if (!property
-            || (i > 0 && ((binding - 1)->propertyNameIndex != binding->propertyNameIndex
-                          || (binding - 1)->flags != binding->flags))
-           ) {
-            if (!name.isEmpty()) {
-                if (binding->flags & QV4::CompiledData::Binding::IsSignalHandlerExpression
-                    || binding->flags & QV4::CompiledData::Binding::IsSignalHandlerObject)
-                    property = QmlIR::PropertyResolver(_propertyCache).signal(name, /*notInRevision*/0, _qobject, context);
-                else
-                    property = _propertyCache->property(name, _qobject, context);
-            } else
-                property = defaultProperty;
+        bool lookup;
+        if (replay) {
+            lookup = plan->bindingLookups.testBit(i);
+            if (lookup)
+                property = plan->bindingProperties.at(i);
+        } else {
+            QString name = stringAt(binding->propertyNameIndex);
+            if (name.isEmpty())
+                property = 0;
 
+            lookup = !property
+                     || (i > 0 && ((binding - 1)->propertyNameIndex != binding->propertyNameIndex
+                                   || (binding - 1)->flags != binding->flags));
+            if (lookup) {
+                if (!name.isEmpty()) {
+                    if (binding->flags & QV4::CompiledData::Binding::IsSignalHandlerExpression
+                        || binding->flags & QV4::CompiledData::Binding::IsSignalHandlerObject)
+                        property = QmlIR::PropertyResolver(_propertyCache).signal(name, /*notInRevision*/0, _qobject, context);
+                    else
+                        property = _propertyCache->property(name, _qobject, context);
+                } else
+                    property = defaultProperty;
+            }
+
+            if (plan) {
+                plan->bindingProperties[i] = property;
+                plan->bindingLookups.setBit(i, lookup);
+            }
+        }
+
+        if (lookup) {
             if (property && property->isQList()) {
                 void *argv[1] = { (void*)&_currentList };
                 QMetaObject::metacall(_qobject, QMetaObject::ReadProperty, property->coreIndex, argv);
@@ -741,6 +771,9 @@ void QQmlObjectCreator::setupBindings(const QBitArray &bindingsToSkip)
             return;
     }
 
+    if (plan)
+        plan->recorded = true;
+
     qSwap(_currentList, savedList);
 }
 
@@ -840,13 +873,15 @@ bool QQmlObjectCreator::setPropertyBinding(QQmlPropertyData *property, const QV4
 
         if (binding->flags & QV4::CompiledData::Binding::IsSignalHandlerExpression) {
             int signalIndex = _propertyCache->methodIndexToSignalIndex(property->coreIndex);
-            QQmlBoundSignal *bs = new QQmlBoundSignal(_bindingTarget, signalIndex, _scopeObject, engine);
-            QQmlBoundSignalExpression *expr = new QQmlBoundSignalExpression(_bindingTarget, signalIndex,
-                                                                            context, _scopeObject, function);
+            QQmlSizeClassPool *pool = bookkeepingPool(engine);
+            QQmlBoundSignal *bs = new (pool) QQmlBoundSignal(_bindingTarget, signalIndex, _scopeObject, engine);
+            QQmlBoundSignalExpression *expr = new (pool) QQmlBoundSignalExpression(_bindingTarget, signalIndex,
+                                                                                   context, _scopeObject, function);
 
             bs->takeExpression(expr);
         } else {
-            QQmlBinding *qmlBinding = new QQmlBinding(function, _scopeObject, context);
+            QQmlBinding *qmlBinding = new (bookkeepingPool(engine)) QQmlBinding(function, _scopeObject, context);
+            qmlBinding->setProgram(compiledData->bindingProgram(binding->value.compiledScriptIndex));
 
             // When writing bindings to grouped properties implemented as value types,
             // such as point.x: { someExpression; }, then the binding is installed on
@@ -1054,9 +1089,10 @@ QObject *QQmlObjectCreator::createInstance(int index, QObject *parent, bool isCo
         QQmlComponent *component = new QQmlComponent(engine, compiledData, index, parent);
         Q_QML_OC_PROFILE(sharedState->profiler, profiler.update(QStringLiteral("<component>"),
                 context->url, obj->location.line, obj->location.column));
+        Q_QML_OC_PROFILE(sharedState->profiler, profiler.setObjectSize(sizeof(QQmlComponent)));
         QQmlComponentPrivate::get(component)->creationContext = context;
         instance = component;
-        ddata = QQmlData::get(instance, /*create*/true);
+        ddata = QQmlData::get(instance, /*create*/true, bookkeepingPool(engine));
     } else {
         QQmlCompiledData::TypeReference *typeRef = resolvedTypes.value(obj->inheritedTypeNameIndex);
         Q_ASSERT(typeRef);
@@ -1070,6 +1106,7 @@ QObject *QQmlObjectCreator::createInstance(int index, QObject *parent, bool isCo
                 recordError(obj->location, tr("Unable to create object of type %1").arg(stringAt(obj->inheritedTypeNameIndex)));
                 return 0;
             }
+            Q_QML_OC_PROFILE(sharedState->profiler, profiler.setObjectSize(type->createSize()));
 
             const int parserStatusCast = type->parserStatusCast();
             if (parserStatusCast != -1)
@@ -1078,7 +1115,7 @@ QObject *QQmlObjectCreator::createInstance(int index, QObject *parent, bool isCo
             customParser = type->customParser();
 
             if (sharedState->rootContext && sharedState->rootContext->isRootObjectInCreation) {
-                QQmlData *ddata = QQmlData::get(instance, /*create*/true);
+                QQmlData *ddata = QQmlData::get(instance, /*create*/true, bookkeepingPool(engine));
                 ddata->rootObjectInCreation = true;
                 sharedState->rootContext->isRootObjectInCreation = false;
             }
@@ -1104,7 +1141,7 @@ QObject *QQmlObjectCreator::createInstance(int index, QObject *parent, bool isCo
         if (parent)
             QQml_setParent_noEvent(instance, parent);
 
-        ddata = QQmlData::get(instance, /*create*/true);
+        ddata = QQmlData::get(instance, /*create*/true, bookkeepingPool(engine));
         ddata->lineNumber = obj->location.line;
         ddata->columnNumber = obj->location.column;
     }
@@ -1284,7 +1321,7 @@ bool QQmlObjectCreator::populateInstance(int index, QObject *instance, QObject *
 {
     const QV4::CompiledData::Object *obj = qmlUnit->objectAt(index);
 
-    QQmlData *declarativeData = QQmlData::get(instance, /*create*/true);
+    QQmlData *declarativeData = QQmlData::get(instance, /*create*/true, bookkeepingPool(engine));
 
     qSwap(_qobject, instance);
     qSwap(_valueTypeProperty, valueTypeProperty);
@@ -1315,8 +1352,11 @@ bool QQmlObjectCreator::populateInstance(int index, QObject *instance, QObject *
 
     registerObjectWithContextById(index, _qobject);
 
+    QQmlCompiledData::CreationPlan *creationPlan = compiledData->creationPlan(index);
+
     qSwap(_propertyCache, cache);
     qSwap(_vmeMetaObject, vmeMetaObject);
+    qSwap(_creationPlan, creationPlan);
 
     QBitArray bindingSkipList = bindingsToSkip;
     {
@@ -1340,6 +1380,7 @@ bool QQmlObjectCreator::populateInstance(int index, QObject *instance, QObject *
     setupFunctions();
     setupBindings(bindingSkipList);
 
+    qSwap(_creationPlan, creationPlan);
     qSwap(_vmeMetaObject, vmeMetaObject);
     qSwap(_bindingTarget, bindingTarget);
     qSwap(_ddata, declarativeData);
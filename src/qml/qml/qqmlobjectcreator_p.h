@@ -146,6 +146,7 @@ private:
     QQmlData *_ddata;
     QQmlRefPointer<QQmlPropertyCache> _propertyCache;
     QQmlVMEMetaObject *_vmeMetaObject;
+    QQmlCompiledData::CreationPlan *_creationPlan;
     QQmlListProperty<void> _currentList;
     QV4::ExecutionContext *_qmlContext;
 
@@ -78,6 +78,14 @@ public:
     int argumentsValid:1;
 
     QList<QByteArray> *names;
+
+    // The SignalArgumentConversion of each argument, see signalArgumentConversions()
+    uchar *signalArgumentConversions;
+
+    // The overload chosen for the last call signature, see cachedOverload()
+    quint32 overloadSignature;
+    int overloadIndex;
+
     int arguments[0];
 };
 
@@ -272,6 +280,7 @@ QQmlPropertyCache::~QQmlPropertyCache()
         QQmlPropertyCacheMethodArguments *next = args->next;
         if (args->signalParameterStringForJS) delete args->signalParameterStringForJS;
         if (args->names) delete args->names;
+        delete [] args->signalArgumentConversions;
         free(args);
         args = next;
     }
@@ -1085,6 +1094,9 @@ QQmlPropertyCacheMethodArguments *QQmlPropertyCache::createArgumentsObject(int a
     args->signalParameterStringForJS = 0;
     args->parameterError = false;
     args->names = argc ? new QList<QByteArray>(names) : 0;
+    args->signalArgumentConversions = 0;
+    args->overloadSignature = 0;
+    args->overloadIndex = -1;
     args->next = argumentsCache;
     argumentsCache = args;
     return args;
@@ -1255,6 +1267,94 @@ int *QQmlPropertyCache::methodParameterTypes(QObject *object, int index,
     }
 }
 
+uchar QQmlPropertyCache::signalArgumentConversion(QQmlEnginePrivate *engine, int type)
+{
+    switch (type) {
+    case QMetaType::QVariant:
+        return ConvertQVariant;
+    case QMetaType::Int:
+        return ConvertInt;
+    case QMetaType::UInt:
+        return ConvertUInt;
+    case QMetaType::Bool:
+        return ConvertBool;
+    case QMetaType::Double:
+        return ConvertDouble;
+    case QMetaType::Float:
+        return ConvertFloat;
+    case QMetaType::QString:
+        return ConvertString;
+    default:
+        break;
+    }
+
+    if (type == qMetaTypeId<QQmlV4Handle>())
+        return ConvertV4Handle;
+    if (engine->isQObject(type))
+        return ConvertQObject;
+    return ConvertVariant;
+}
+
+/*! \internal
+    Returns the SignalArgumentConversion of each argument of the method \a index,
+    whose argument \a types were returned by methodParameterTypes().
+
+    The conversions are worked out on the first call and kept with the argument
+    types, so that emitting the signal again does not need to look up the
+    types. Returns 0 if \a object has no property cache to keep them in.
+*/
+const uchar *QQmlPropertyCache::signalArgumentConversions(QQmlEnginePrivate *engine, QObject *object,
+                                                          int index, const int *types)
+{
+    typedef QQmlPropertyCacheMethodArguments A;
+
+    A *args = methodArguments(object, index);
+    if (!args || args->arguments != types)
+        return 0;
+
+    if (!args->signalArgumentConversions) {
+        const int argc = types[0];
+        uchar *conversions = new uchar[argc];
+        for (int ii = 0; ii < argc; ++ii)
+            conversions[ii] = signalArgumentConversion(engine, types[ii + 1]);
+        args->signalArgumentConversions = conversions;
+    }
+    return args->signalArgumentConversions;
+}
+
+QQmlPropertyCacheMethodArguments *QQmlPropertyCache::methodArguments(QObject *object, int index)
+{
+    QQmlData *ddata = QQmlData::get(object, false);
+    if (!ddata || !ddata->propertyCache)
+        return 0;
+
+    QQmlPropertyCache *c = ddata->propertyCache;
+    while (index < c->methodIndexCacheStart)
+        c = c->_parent;
+
+    return static_cast<QQmlPropertyCacheMethodArguments *>(c->methodIndexCache.at(index - c->methodIndexCacheStart).arguments);
+}
+
+int QQmlPropertyCache::cachedOverload(QObject *object, int index, quint32 signature)
+{
+    QQmlPropertyCacheMethodArguments *args = methodArguments(object, index);
+    if (args && args->overloadIndex != -1 && args->overloadSignature == signature)
+        return args->overloadIndex;
+    return -1;
+}
+
+void QQmlPropertyCache::setCachedOverload(QObject *object, int index, quint32 signature, int overloadIndex)
+{
+    // Make sure the arguments object exists
+    QVarLengthArray<int, 9> dummy;
+    methodParameterTypes(object, index, dummy, 0);
+
+    if (QQmlPropertyCacheMethodArguments *args = methodArguments(object, index)) {
+        args->overloadSignature = signature;
+        args->overloadIndex = overloadIndex;
+    }
+}
+
 // Returns the return type of the method.
 int QQmlPropertyCache::methodReturnType(QObject *object, const QQmlPropertyData &data,
                                         QByteArray *unknownTypeError)
@@ -120,6 +120,7 @@ public:
 
         // Internal QQmlPropertyCache flags
         NotFullyResolved   = 0x04000000, // True if the type data is to be lazily resolved
+        IsVMEProperty      = 0x08000000, // Property was declared in QML and is stored by the VMEMO
 
         // Flags that are set based on the propType field
         PropTypeFlagMask = IsQObjectDerived | IsEnumType | IsQList | IsQmlBinding | IsQJSValue |
@@ -158,6 +159,7 @@ public:
     bool isSignalHandler() const { return flags & IsSignalHandler; }
     bool isOverload() const { return flags & IsOverload; }
     bool isCloned() const { return flags & IsCloned; }
+    bool isVMEProperty() const { return flags & IsVMEProperty; }
 
     bool hasOverride() const { return !(flags & IsValueTypeVirtual) &&
                                       !(flags & HasAccessors) &&
@@ -312,6 +314,28 @@ public:
     static int methodReturnType(QObject *, const QQmlPropertyData &data,
                                 QByteArray *unknownTypeError);
 
+    // How a signal argument is passed to a QML signal handler
+    enum SignalArgumentConversion {
+        ConvertVariant,    // Through a QVariant and QV8Engine::fromVariant()
+        ConvertQVariant,
+        ConvertInt,
+        ConvertUInt,
+        ConvertBool,
+        ConvertDouble,
+        ConvertFloat,
+        ConvertString,
+        ConvertV4Handle,
+        ConvertQObject
+    };
+    static uchar signalArgumentConversion(QQmlEnginePrivate *, int type);
+    static const uchar *signalArgumentConversions(QQmlEnginePrivate *, QObject *, int index,
+                                                  const int *types);
+
+    // Remembers the overload last chosen for a call of the method \a index with
+    // arguments matching \a signature.  Returns -1 if there is no match.
+    static int cachedOverload(QObject *, int index, quint32 signature);
+    static void setCachedOverload(QObject *, int index, quint32 signature, int overloadIndex);
+
     //see QMetaObjectPrivate::originalClone
     int originalClone(int index);
     static int originalClone(QObject *, int index);
@@ -352,6 +376,7 @@ private:
 
     QQmlPropertyCacheMethodArguments *createArgumentsObject(int count,
                                                             const QList<QByteArray> &names);
+    static QQmlPropertyCacheMethodArguments *methodArguments(QObject *, int index);
     QQmlPropertyData *signal(int, QQmlPropertyCache **) const;
 
     typedef QVector<QQmlPropertyData> IndexCache;
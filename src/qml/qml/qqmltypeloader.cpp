@@ -46,22 +46,32 @@
 
 #include <private/qqmlengine_p.h>
 #include <private/qqmlglobal_p.h>
+#include <private/qqmlimportindex_p.h>
 #include <private/qqmlthread_p.h>
 #include <private/qqmlcompiler_p.h>
 #include <private/qqmlcomponent_p.h>
 #include <private/qqmlprofiler_p.h>
 #include <private/qqmlmemoryprofiler_p.h>
 #include <private/qqmltypecompiler_p.h>
+#include <private/qv4isel_moth_p.h>
 
 #include <QtCore/qdir.h>
 #include <QtCore/qfile.h>
 #include <QtCore/qdebug.h>
+#include <QtCore/qlibrary.h>
 #include <QtCore/qmutex.h>
 #include <QtCore/qthread.h>
+#include <QtCore/qrunnable.h>
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qthreadpool.h>
+#include <QtCore/qthreadstorage.h>
 #include <QtQml/qqmlfile.h>
 #include <QtCore/qdiriterator.h>
 #include <QtQml/qqmlcomponent.h>
 #include <QtCore/qwaitcondition.h>
+#ifndef QT_NO_NETWORKDISKCACHE
+#include <QtNetwork/qnetworkdiskcache.h>
+#endif
 #include <QtQml/qqmlextensioninterface.h>
 
 #if defined (Q_OS_UNIX)
@@ -100,6 +110,9 @@
 #endif
 
 DEFINE_BOOL_CONFIG_OPTION(dumpErrors, QML_DUMP_ERRORS);
+DEFINE_BOOL_CONFIG_OPTION(disableDiskCache, QML_DISABLE_DISK_CACHE);
+DEFINE_BOOL_CONFIG_OPTION(disableUnitSharing, QML_DISABLE_UNIT_SHARING);
+DEFINE_BOOL_CONFIG_OPTION(disableNetworkCache, QML_DISABLE_NETWORK_CACHE);
 
 QT_BEGIN_NAMESPACE
 
@@ -743,6 +756,16 @@ QNetworkAccessManager *QQmlDataLoaderThread::networkAccessManager() const
     if (!m_networkAccessManager) {
         m_networkAccessManager = QQmlEnginePrivate::get(m_loader->engine())->createNetworkAccessManager(0);
         m_networkReplyProxy = new QQmlDataLoaderNetworkReplyProxy(m_loader);
+
+#ifndef QT_NO_NETWORKDISKCACHE
+        // Unless the application set up caching itself, keep downloaded documents around so
+        // that following runs only have to revalidate them (ETag, If-Modified-Since).
+        if (!m_networkAccessManager->cache() && !disableNetworkCache()) {
+            QNetworkDiskCache *cache = new QNetworkDiskCache(m_networkAccessManager);
+            cache->setCacheDirectory(QV4::CompiledData::CompilationUnit::diskCacheDirectory() + QLatin1String("/network"));
+            m_networkAccessManager->setCache(cache);
+        }
+#endif
     }
 
     return m_networkAccessManager;
@@ -890,8 +913,10 @@ Thus QQmlDataBlob::done() will always eventually be called, even if the blob has
 Create a new QQmlDataLoader for \a engine.
 */
 QQmlDataLoader::QQmlDataLoader(QQmlEngine *engine)
-: m_engine(engine), m_thread(new QQmlDataLoaderThread(this))
+: m_engine(engine), m_thread(new QQmlDataLoaderThread(this)), m_prefetchManifestRead(false)
 {
+    for (int i = 0; i < LoadPhaseCount; ++i)
+        m_loadPhaseTimes[i] = 0;
 }
 
 /*! \internal */
@@ -911,6 +936,9 @@ void QQmlDataLoader::invalidate()
         delete m_thread;
         m_thread = 0;
     }
+
+    // Owned by the network access manager, which is gone now
+    m_prefetchReplies.clear();
 }
 
 void QQmlDataLoader::lock()
@@ -1059,8 +1087,15 @@ void QQmlDataLoader::loadThread(QQmlDataBlob *blob)
         }
     }
 
+    if (!m_prefetchManifestRead)
+        prefetchThread(blob->m_url);
+
     if (QQmlFile::isSynchronous(blob->m_url)) {
-        QQmlFile file(m_engine, blob->m_url);
+        QQmlFile file;
+        {
+            QQmlLoadPhaseTimer phase(this, FileIO);
+            file.load(m_engine, blob->m_url);
+        }
 
         if (file.isError()) {
             QQmlError error;
@@ -1078,7 +1113,9 @@ void QQmlDataLoader::loadThread(QQmlDataBlob *blob)
 
     } else {
 
-        QNetworkReply *reply = m_thread->networkAccessManager()->get(QNetworkRequest(blob->m_url));
+        QNetworkReply *reply = m_prefetchReplies.take(blob->m_url);
+        if (!reply)
+            reply = m_thread->networkAccessManager()->get(QNetworkRequest(blob->m_url));
         QQmlDataLoaderNetworkReplyProxy *nrp = m_thread->networkReplyProxy();
         blob->addref();
         m_networkReplies.insert(reply, blob);
@@ -1099,6 +1136,102 @@ void QQmlDataLoader::loadThread(QQmlDataBlob *blob)
     }
 }
 
+#ifndef QT_NO_LIBRARY
+class QQmlPluginPreloadTask : public QRunnable
+{
+public:
+    QQmlPluginPreloadTask(const QString &path) : m_path(path) {}
+
+    void run()
+    {
+        // The library stays loaded, so the plugin loader later finds it resolved
+        // and initialized.
+        QLibrary library(m_path);
+        library.load();
+    }
+
+private:
+    QString m_path;
+};
+#endif
+
+/*!
+\internal
+
+Requests all files listed in the file named by QML_PREFETCH_MANIFEST at once,
+when the first document is loaded.  Otherwise the imports of a document are
+only requested after it was loaded and parsed, so the latency adds up with the
+depth of the imports.
+
+The manifest lists one URL per line, relative ones are resolved against
+\a rootUrl, the URL of the first document.  Empty lines and lines starting
+with # are ignored.  A line may start with the kind of the file, one of
+\c qml, \c js, \c qmldir or \c plugin, as written by qmlimportscanner
+-prefetchManifest.  Remote files are requested from the network.  Local QML
+documents are parsed ahead on the thread pool, see prefetchLocalDocuments(),
+and local plugins are loaded ahead on the thread pool.
+*/
+void QQmlDataLoader::prefetchThread(const QUrl &rootUrl)
+{
+    m_prefetchManifestRead = true;
+
+    const QString manifestPath = QFile::decodeName(qgetenv("QML_PREFETCH_MANIFEST"));
+    if (manifestPath.isEmpty())
+        return;
+
+    QFile manifest(manifestPath);
+    if (!manifest.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning() << "QQmlDataLoader: Cannot read prefetch manifest" << manifestPath;
+        return;
+    }
+
+    QList<QUrl> localDocuments;
+    while (!manifest.atEnd()) {
+        QString line = QString::fromUtf8(manifest.readLine()).trimmed();
+        if (line.isEmpty() || line.startsWith(QLatin1Char('#')))
+            continue;
+
+        QString kind;
+        const int space = line.indexOf(QLatin1Char(' '));
+        if (space > 0) {
+            kind = line.left(space);
+            if (kind == QLatin1String("qml") || kind == QLatin1String("js")
+                || kind == QLatin1String("qmldir") || kind == QLatin1String("plugin")) {
+                line = line.mid(space + 1).trimmed();
+            } else {
+                kind.clear();
+            }
+        }
+
+        const QUrl url = rootUrl.resolved(QUrl(line));
+        if (url == rootUrl)
+            continue;
+
+        if (kind == QLatin1String("plugin")) {
+#ifndef QT_NO_LIBRARY
+            const QString path = QQmlFile::urlToLocalFileOrQrc(url);
+            if (!path.isEmpty() && !path.startsWith(QLatin1Char(':')))
+                QThreadPool::globalInstance()->start(new QQmlPluginPreloadTask(path));
+#endif
+            continue;
+        }
+
+        if (QQmlFile::isSynchronous(url)) {
+            if (kind == QLatin1String("qml")
+                || (kind.isEmpty() && url.path().endsWith(QLatin1String(".qml"))))
+                localDocuments << url;
+            continue;
+        }
+
+        if (m_prefetchReplies.contains(url))
+            continue;
+        m_prefetchReplies.insert(url, m_thread->networkAccessManager()->get(QNetworkRequest(url)));
+    }
+
+    if (!localDocuments.isEmpty())
+        prefetchLocalDocuments(localDocuments);
+}
+
 #define DATALOADER_MAXIMUM_REDIRECT_RECURSION 16
 
 void QQmlDataLoader::networkReplyFinished(QNetworkReply *reply)
@@ -1311,6 +1444,7 @@ bool QQmlTypeLoader::Blob::updateQmldir(QQmlQmldirData *data, const QV4::Compile
 bool QQmlTypeLoader::Blob::addImport(const QV4::CompiledData::Import *import, QList<QQmlError> *errors)
 {
     Q_ASSERT(errors);
+    QQmlLoadPhaseTimer phase(typeLoader(), QQmlDataLoader::ImportResolution);
 
     QQmlImportDatabase *importDatabase = typeLoader()->importDatabase();
 
@@ -1484,6 +1618,7 @@ void QQmlTypeLoader::Blob::dependencyComplete(QQmlDataBlob *blob)
 
 bool QQmlTypeLoader::Blob::qmldirDataAvailable(QQmlQmldirData *data, QList<QQmlError> *errors)
 {
+    QQmlLoadPhaseTimer phase(typeLoader(), QQmlDataLoader::ImportResolution);
     bool resolve = true;
 
     const QV4::CompiledData::Import *import = data->import();
@@ -1635,6 +1770,146 @@ QQmlTypeData *QQmlTypeLoader::getType(const QByteArray &data, const QUrl &url)
     return typeData;
 }
 
+Q_GLOBAL_STATIC(QThreadStorage<QQmlLoadPhaseTimer *>, activeLoadPhaseTimer)
+
+QQmlLoadPhaseTimer::QQmlLoadPhaseTimer(QQmlDataLoader *loader, QQmlDataLoader::LoadPhase phase)
+    : m_loader(loader), m_phase(phase), m_outer(activeLoadPhaseTimer()->localData()), m_time(0)
+{
+    if (m_outer)
+        m_outer->m_time += m_outer->m_timer.nsecsElapsed();
+    activeLoadPhaseTimer()->setLocalData(this);
+    m_timer.start();
+}
+
+QQmlLoadPhaseTimer::~QQmlLoadPhaseTimer()
+{
+    m_loader->addLoadPhaseTime(m_phase, m_time + m_timer.nsecsElapsed());
+    activeLoadPhaseTimer()->setLocalData(m_outer);
+    if (m_outer)
+        m_outer->m_timer.start();
+}
+
+/*!
+\internal
+
+A QML document that is being parsed ahead of time on the global thread pool.
+*/
+struct QQmlTypeLoader::PrefetchedDocument
+{
+    PrefetchedDocument(bool debugMode)
+        : document(new QmlIR::Document(debugMode)), parsed(false), fileTime(0), parseTime(0) {}
+    ~PrefetchedDocument() { delete document; }
+
+    QmlIR::Document *document;
+    QByteArray source;
+    bool parsed;
+    // Accounted to the loader once the document is taken, as the loader may be gone before.
+    qint64 fileTime;
+    qint64 parseTime;
+    QSemaphore done;
+};
+
+class QQmlDocumentPrefetchTask : public QRunnable
+{
+public:
+    QQmlDocumentPrefetchTask(const QSharedPointer<QQmlTypeLoader::PrefetchedDocument> &prefetch,
+                             const QUrl &url, const QSet<QString> &illegalNames)
+        : m_prefetch(prefetch), m_url(url), m_illegalNames(illegalNames) {}
+
+    void run()
+    {
+        QElapsedTimer timer;
+        timer.start();
+        QFile file(QQmlFile::urlToLocalFileOrQrc(m_url));
+        if (file.open(QFile::ReadOnly)) {
+            m_prefetch->source = file.readAll();
+            m_prefetch->fileTime = timer.nsecsElapsed();
+            const QString urlString = m_url.toString();
+            QmlIR::IRBuilder compiler(m_illegalNames);
+            m_prefetch->parsed = compiler.generateFromQml(QString::fromUtf8(m_prefetch->source),
+                                                          urlString, urlString, m_prefetch->document);
+            m_prefetch->parseTime = timer.nsecsElapsed() - m_prefetch->fileTime;
+        }
+        m_prefetch->done.release();
+    }
+
+private:
+    QSharedPointer<QQmlTypeLoader::PrefetchedDocument> m_prefetch;
+    QUrl m_url;
+    QSet<QString> m_illegalNames;
+};
+
+/*!
+\internal
+
+Starts parsing the QML documents at \a urls on the global thread pool, so that
+the independent types a document depends on are parsed concurrently while the
+loader thread resolves them one by one.  Only local documents that have not
+been loaded yet, and are not available as cached compilation units, are
+prefetched.  Type compilation remains on the loader thread.
+*/
+void QQmlTypeLoader::prefetchDocuments(const QList<QUrl> &urls)
+{
+    if (QThreadPool::globalInstance()->maxThreadCount() < 2)
+        return;
+
+    QList<QUrl> pending;
+    foreach (const QUrl &url, urls) {
+        if (!QQmlFile::isSynchronous(url) || m_typeCache.contains(url) || m_prefetchCache.contains(url)
+            || pending.contains(url) || QQmlMetaType::findCachedCompilationUnit(url))
+            continue;
+        pending << url;
+    }
+
+    // A single document is parsed just as fast on the loader thread itself.
+    if (pending.count() < 2)
+        return;
+
+    QV8Engine *v8engine = QV8Engine::get(engine());
+    const bool debugMode = QV8Engine::getV4(v8engine)->debugger != 0;
+    foreach (const QUrl &url, pending) {
+        QSharedPointer<PrefetchedDocument> prefetch(new PrefetchedDocument(debugMode));
+        m_prefetchCache.insert(url, prefetch);
+        QThreadPool::globalInstance()->start(new QQmlDocumentPrefetchTask(prefetch, url, v8engine->illegalNames()));
+    }
+}
+
+void QQmlTypeLoader::prefetchLocalDocuments(const QList<QUrl> &urls)
+{
+    prefetchDocuments(urls);
+}
+
+/*!
+\internal
+
+Returns the document prefetched for \a url, waiting for it to be parsed if
+necessary, or 0 if there is none.  The document is only returned if it was
+parsed without errors from exactly \a source; the caller takes ownership.
+*/
+QmlIR::Document *QQmlTypeLoader::takePrefetchedDocument(const QUrl &url, const QByteArray &source)
+{
+    QSharedPointer<PrefetchedDocument> prefetch = m_prefetchCache.take(url);
+    if (!prefetch)
+        return 0;
+
+    prefetch->done.acquire();
+    addLoadPhaseTime(FileIO, prefetch->fileTime);
+    addLoadPhaseTime(Parsing, prefetch->parseTime);
+    if (!prefetch->parsed || prefetch->source != source)
+        return 0;
+
+    QmlIR::Document *document = prefetch->document;
+    prefetch->document = 0;
+    return document;
+}
+
+static bool isPrecompiledOnly(const QUrl &url)
+{
+    const QString sourcePath = QQmlFile::urlToLocalFileOrQrc(url);
+    return !sourcePath.isEmpty() && !QFile::exists(sourcePath)
+            && QFile::exists(QV4::CompiledData::CompilationUnit::precompiledFilePath(sourcePath));
+}
+
 /*!
 Return a QQmlScriptBlob for \a url.  The QQmlScriptData may be cached.
 */
@@ -1654,6 +1929,9 @@ QQmlScriptBlob *QQmlTypeLoader::getScript(const QUrl &url)
 
         if (const QQmlPrivate::CachedQmlUnit *cachedUnit = QQmlMetaType::findCachedCompilationUnit(url)) {
             QQmlDataLoader::loadWithCachedUnit(scriptBlob, cachedUnit);
+        } else if (isPrecompiledOnly(url)) {
+            // Shipped without the source, QQmlScriptBlob::dataReceived() picks up the precompiled unit.
+            QQmlDataLoader::loadWithStaticData(scriptBlob, QByteArray());
         } else {
             QQmlDataLoader::load(scriptBlob);
         }
@@ -1923,8 +2201,11 @@ const QQmlTypeLoader::QmldirContent *QQmlTypeLoader::qmldirContent(const QString
         } else {
 
             QFile file(filePath);
+            QString content;
             if (!QQml_isFileCaseCorrect(filePath)) {
                 ERROR(CASE_MISMATCH_ERROR.arg(filePath));
+            } else if (QQmlImportIndex::instance()->qmldirContent(filePath, &content)) {
+                qmldir->setContent(filePath, content);
             } else if (file.open(QFile::ReadOnly)) {
                 QByteArray data = file.read(QQmlBundle::bundleHeaderLength());
 
@@ -1944,7 +2225,9 @@ const QQmlTypeLoader::QmldirContent *QQmlTypeLoader::qmldirContent(const QString
                     }
                 } else {
                     data += file.readAll();
-                    qmldir->setContent(filePath, QString::fromUtf8(data));
+                    content = QString::fromUtf8(data);
+                    qmldir->setContent(filePath, content);
+                    QQmlImportIndex::instance()->setQmldirContent(filePath, content);
                 }
             } else {
                 ERROR(NOT_READABLE_ERROR.arg(filePath));
@@ -1998,6 +2281,7 @@ void QQmlTypeLoader::clearCache()
     m_qmldirCache.clear();
     m_importDirCache.clear();
     m_importQmlDirCache.clear();
+    m_prefetchCache.clear();
 }
 
 void QQmlTypeLoader::trimCache()
@@ -2213,10 +2497,21 @@ void QQmlTypeData::dataReceived(const Data &data)
 
     if (data.isFile()) preparseData = data.asFile()->metaData(QLatin1String("qml:preparse"));
 
+    if (QmlIR::Document *prefetched = typeLoader()->takePrefetchedDocument(url(), QByteArray::fromRawData(data.data(), data.size()))) {
+        m_document.reset(prefetched);
+        continueLoadFromIR();
+        return;
+    }
+
     QQmlEngine *qmlEngine = typeLoader()->engine();
     m_document.reset(new QmlIR::Document(QV8Engine::getV4(qmlEngine)->debugger != 0));
     QmlIR::IRBuilder compiler(QV8Engine::get(qmlEngine)->illegalNames());
-    if (!compiler.generateFromQml(code, finalUrlString(), finalUrlString(), m_document.data())) {
+    bool parsed;
+    {
+        QQmlLoadPhaseTimer phase(typeLoader(), QQmlDataLoader::Parsing);
+        parsed = compiler.generateFromQml(code, finalUrlString(), finalUrlString(), m_document.data());
+    }
+    if (!parsed) {
         QList<QQmlError> errors;
         foreach (const QQmlJS::DiagnosticMessage &msg, compiler.errors) {
             QQmlError e;
@@ -2318,7 +2613,10 @@ void QQmlTypeData::allDependenciesDone()
             return;
         }
 
-        resolveTypes();
+        {
+            QQmlLoadPhaseTimer phase(typeLoader(), QQmlDataLoader::ImportResolution);
+            resolveTypes();
+        }
         m_typesResolved = true;
     }
 }
@@ -2345,6 +2643,7 @@ void QQmlTypeData::compile()
     m_compiledData->name = finalUrlString();
 
     QQmlCompilingProfiler prof(QQmlEnginePrivate::get(typeLoader()->engine())->profiler, m_compiledData->name);
+    QQmlLoadPhaseTimer phase(typeLoader(), QQmlDataLoader::TypeCompilation);
 
     QQmlTypeCompiler compiler(QQmlEnginePrivate::get(typeLoader()->engine()), m_compiledData, this, m_document.data());
     if (!compiler.compile()) {
@@ -2403,6 +2702,7 @@ void QQmlTypeData::resolveTypes()
         }
     }
 
+    QList<int> compositeTypes;
     for (QV4::CompiledData::TypeReferenceMap::ConstIterator unresolvedRef = m_document->typeReferences.constBegin(), end = m_document->typeReferences.constEnd();
          unresolvedRef != end; ++unresolvedRef) {
 
@@ -2457,10 +2757,8 @@ void QQmlTypeData::resolveTypes()
             return;
         }
 
-        if (ref.type && ref.type->isComposite()) {
-            ref.typeData = typeLoader()->getType(ref.type->sourceUrl());
-            addDependency(ref.typeData);
-        }
+        if (ref.type && ref.type->isComposite())
+            compositeTypes << unresolvedRef.key();
         ref.majorVersion = majorVersion;
         ref.minorVersion = minorVersion;
 
@@ -2471,6 +2769,19 @@ void QQmlTypeData::resolveTypes()
 
         m_resolvedTypes.insert(unresolvedRef.key(), ref);
     }
+
+    // Parse the documents of all composite types up front, so that they are
+    // available by the time each of them is loaded below.
+    QList<QUrl> compositeUrls;
+    foreach (int key, compositeTypes)
+        compositeUrls << m_resolvedTypes.value(key).type->sourceUrl();
+    typeLoader()->prefetchDocuments(compositeUrls);
+
+    foreach (int key, compositeTypes) {
+        TypeReference &ref = m_resolvedTypes[key];
+        ref.typeData = typeLoader()->getType(ref.type->sourceUrl());
+        addDependency(ref.typeData);
+    }
 }
 
 bool QQmlTypeData::resolveType(const QString &typeName, int &majorVersion, int &minorVersion, TypeReference &ref)
@@ -2685,11 +2996,107 @@ QQmlScriptData *QQmlScriptBlob::scriptData() const
     return m_scriptData;
 }
 
+/*!
+\internal
+
+Loads the unit written by qmlcachegen for this script, if there is one.  A
+precompiled unit next to a local source file is ignored when the source has
+been modified since.
+*/
+QV4::CompiledData::CompilationUnit *QQmlScriptBlob::loadPrecompiledUnit(QString *errorString)
+{
+    const QString sourcePath = QQmlFile::urlToLocalFileOrQrc(finalUrl());
+    if (sourcePath.isEmpty())
+        return 0;
+
+    QFileInfo precompiledInfo(QV4::CompiledData::CompilationUnit::precompiledFilePath(sourcePath));
+    if (!precompiledInfo.exists())
+        return 0;
+
+    if (finalUrl().isLocalFile()) {
+        QFileInfo sourceInfo(sourcePath);
+        if (sourceInfo.exists() && sourceInfo.lastModified() > precompiledInfo.lastModified())
+            return 0;
+    }
+
+    QV4::ExecutionEngine *v4 = QV8Engine::getV4(m_typeLoader->engine());
+    QV4::CompiledData::CompilationUnit *unit = v4->iselFactory->createUnitForLoading();
+    if (!unit) {
+        *errorString = QQmlTypeLoader::tr("Precompiled scripts are not supported by this engine");
+        return 0;
+    }
+    unit->ref();
+    if (!unit->loadPrecompiled(precompiledInfo.filePath(), errorString)) {
+        unit->deref();
+        return 0;
+    }
+    return unit;
+}
+
 void QQmlScriptBlob::dataReceived(const Data &data)
 {
+    QV4::ExecutionEngine *v4 = QV8Engine::getV4(m_typeLoader->engine());
+
+    // Precompiled units aren't instrumented for the debugger, use the source instead if there is one.
+    if (!v4->debugger || isPrecompiledOnly(finalUrl())) {
+        QString error;
+        if (QV4::CompiledData::CompilationUnit *unit = loadPrecompiledUnit(&error)) {
+            initializeFromCompilationUnit(unit);
+            unit->deref();
+            return;
+        }
+        if (!error.isEmpty()) {
+            if (data.size() == 0 && isPrecompiledOnly(finalUrl())) {
+                QQmlError e;
+                e.setUrl(finalUrl());
+                e.setDescription(error);
+                setError(e);
+                return;
+            }
+            qWarning() << "Error loading precompiled version of" << finalUrlString() << ":" << error;
+        }
+    }
+
+    // Another engine of this process may have compiled the script already. Like cached
+    // units, shared ones can't be used with the debugger.
+    const bool shareUnit = !disableUnitSharing() && !v4->debugger && finalUrl().isLocalFile();
+    if (shareUnit) {
+        if (QV4::CompiledData::CompilationUnit *unit = QV4::CompiledData::CompilationUnit::createShared(finalUrl().toLocalFile())) {
+            unit->ref();
+            initializeFromCompilationUnit(unit);
+            unit->deref();
+            return;
+        }
+    }
+
+    // The debugger instruments the generated code, so cached units can't be used with it.
+    // Downloaded scripts are cached by URL, for as long as the server sends the same source.
+    const bool isRemote = !finalUrl().isLocalFile() && !QQmlFile::isSynchronous(finalUrl());
+    bool useDiskCache = !disableDiskCache() && v4->diskCacheEnabled && !v4->debugger
+            && (finalUrl().isLocalFile() || isRemote);
+    if (useDiskCache) {
+        QV4::CompiledData::CompilationUnit *unit = v4->iselFactory->createUnitForLoading();
+        if (unit) {
+            unit->ref();
+            QString error;
+            const bool loaded = isRemote ? unit->loadFromDisk(finalUrl(), data.asByteArray(), &error)
+                                         : unit->loadFromDisk(finalUrl().toLocalFile(), &error);
+            if (loaded) {
+                if (shareUnit)
+                    unit->share(finalUrl().toLocalFile());
+                initializeFromCompilationUnit(unit);
+            }
+            unit->deref();
+            if (loaded)
+                return;
+        } else {
+            // The backend can't restore its code from disk, so there's no point writing the cache.
+            useDiskCache = false;
+        }
+    }
+
     QString source = QString::fromUtf8(data.data(), data.size());
 
-    QV4::ExecutionEngine *v4 = QV8Engine::getV4(m_typeLoader->engine());
     QmlIR::Document irUnit(v4->debugger != 0);
     QQmlJS::DiagnosticMessage metaDataError;
     irUnit.extractScriptMetaData(source, &metaDataError);
@@ -2704,7 +3111,17 @@ void QQmlScriptBlob::dataReceived(const Data &data)
     }
 
     QList<QQmlError> errors;
-    QV4::CompiledData::CompilationUnit *unit = QV4::Script::precompile(&irUnit.jsModule, &irUnit.jsGenerator, v4, finalUrl(), source, &errors);
+    // Only interpreter bytecode can be stored in the disk cache, so scripts that are going to be
+    // cached are compiled for the interpreter even when the engine uses the JIT. That only
+    // happens in JIT engines that opted in through QML_FORCE_DISK_CACHE.
+    static QV4::Moth::ISelFactory interpreterFactory;
+    QV4::CompiledData::CompilationUnit *unit;
+    {
+        // Scripts are parsed and compiled in one go.
+        QQmlLoadPhaseTimer phase(typeLoader(), QQmlDataLoader::CodeGeneration);
+        unit = QV4::Script::precompile(&irUnit.jsModule, &irUnit.jsGenerator, v4, finalUrl(), source, &errors,
+                                       useDiskCache ? &interpreterFactory : 0);
+    }
     if (unit)
         unit->ref();
     source.clear();
@@ -2723,6 +3140,17 @@ void QQmlScriptBlob::dataReceived(const Data &data)
     // The js unit owns the data and will free the qml unit.
     unit->data = &qmlUnit->header;
 
+    if (useDiskCache) {
+        QString error;
+        const bool saved = isRemote ? unit->saveToDisk(finalUrl(), data.asByteArray(), &error)
+                                    : unit->saveToDisk(finalUrl().toLocalFile(), &error);
+        if (!saved)
+            qWarning() << "Error saving cached version of" << finalUrlString() << "to disk:" << error;
+    }
+
+    if (shareUnit)
+        unit->share(finalUrl().toLocalFile());
+
     initializeFromCompilationUnit(unit);
     unit->deref();
 }
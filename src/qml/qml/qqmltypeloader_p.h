@@ -55,6 +55,9 @@
 
 #include <QtCore/qobject.h>
 #include <QtCore/qatomic.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qsharedpointer.h>
 #include <QtNetwork/qnetworkreply.h>
 #include <QtQml/qqmlerror.h>
 #include <QtQml/qqmlengine.h>
@@ -235,9 +238,43 @@ public:
     void initializeEngine(QQmlExtensionInterface *, const char *);
     void invalidate();
 
+    // The phases of loading a document, see QQmlLoadPhaseTimer. Object creation is not a part of
+    // loading and isn't counted.
+    enum LoadPhase {
+        FileIO,
+        Parsing,            // parsing and building the QML IR
+        ImportResolution,   // qmldir files, plugins and type name lookup
+        TypeCompilation,    // property caches, aliases and validation
+        IRBuilding,         // JavaScript IR for bindings and functions
+        CodeGeneration,     // instruction selection, including the JIT
+        LoadPhaseCount
+    };
+
+    // Returns the nanoseconds spent in a phase by all threads loading for this loader since it
+    // was created or resetLoadPhaseTimes() was last called.
+    qint64 loadPhaseTime(LoadPhase phase) const
+    {
+        QMutexLocker locker(&m_loadPhaseMutex);
+        return m_loadPhaseTimes[phase];
+    }
+    void resetLoadPhaseTimes()
+    {
+        QMutexLocker locker(&m_loadPhaseMutex);
+        for (int i = 0; i < LoadPhaseCount; ++i)
+            m_loadPhaseTimes[i] = 0;
+    }
+    void addLoadPhaseTime(LoadPhase phase, qint64 nsecs)
+    {
+        QMutexLocker locker(&m_loadPhaseMutex);
+        m_loadPhaseTimes[phase] += nsecs;
+    }
+
 protected:
     void shutdownThread();
 
+    // Called with the local QML documents listed in the prefetch manifest
+    virtual void prefetchLocalDocuments(const QList<QUrl> &) {}
+
 private:
     friend class QQmlDataBlob;
     friend class QQmlDataLoaderThread;
@@ -248,6 +285,7 @@ private:
     void loadWithCachedUnitThread(QQmlDataBlob *blob, const QQmlPrivate::CachedQmlUnit *unit);
     void networkReplyFinished(QNetworkReply *);
     void networkReplyProgress(QNetworkReply *, qint64, qint64);
+    void prefetchThread(const QUrl &);
 
     typedef QHash<QNetworkReply *, QQmlDataBlob *> NetworkReplies;
 
@@ -259,6 +297,29 @@ private:
     QQmlEngine *m_engine;
     QQmlDataLoaderThread *m_thread;
     NetworkReplies m_networkReplies;
+    // Requests issued ahead of time, waiting for a blob to claim them
+    QHash<QUrl, QNetworkReply *> m_prefetchReplies;
+    bool m_prefetchManifestRead;
+
+    mutable QMutex m_loadPhaseMutex;
+    qint64 m_loadPhaseTimes[LoadPhaseCount];
+};
+
+// Adds the time until it goes out of scope to a phase of a loader. Timers nest on a thread: the
+// time spent in an inner timer, such as loading a dependency synchronously while resolving the
+// imports, only counts for the inner phase.
+class Q_QML_PRIVATE_EXPORT QQmlLoadPhaseTimer
+{
+public:
+    QQmlLoadPhaseTimer(QQmlDataLoader *loader, QQmlDataLoader::LoadPhase phase);
+    ~QQmlLoadPhaseTimer();
+
+private:
+    QQmlDataLoader *m_loader;
+    QQmlDataLoader::LoadPhase m_phase;
+    QQmlLoadPhaseTimer *m_outer;
+    QElapsedTimer m_timer;
+    qint64 m_time;
 };
 
 class QQmlBundleData : public QQmlBundle,
@@ -360,7 +421,16 @@ public:
     bool isTypeLoaded(const QUrl &url) const;
     bool isScriptLoaded(const QUrl &url) const;
 
+    void prefetchDocuments(const QList<QUrl> &urls);
+    QmlIR::Document *takePrefetchedDocument(const QUrl &url, const QByteArray &source);
+
+protected:
+    void prefetchLocalDocuments(const QList<QUrl> &urls);
+
 private:
+    struct PrefetchedDocument;
+    friend class QQmlDocumentPrefetchTask;
+
     void addBundleNoLock(const QString &, const QString &);
     QString bundleIdForQmldir(const QString &qmldir, const QString &uriHint);
 
@@ -388,6 +458,7 @@ private:
     typedef QStringHash<QmldirContent *> ImportQmlDirCache;
     typedef QStringHash<QQmlBundleData *> BundleCache;
     typedef QStringHash<QString> QmldirBundleIdCache;
+    typedef QHash<QUrl, QSharedPointer<PrefetchedDocument> > PrefetchCache;
 
     TypeCache m_typeCache;
     ScriptCache m_scriptCache;
@@ -396,6 +467,7 @@ private:
     ImportQmlDirCache m_importQmlDirCache;
     BundleCache m_bundleCache;
     QmldirBundleIdCache m_qmldirBundleIdCache;
+    PrefetchCache m_prefetchCache;
 };
 
 class Q_AUTOTEST_EXPORT QQmlTypeData : public QQmlTypeLoader::Blob
@@ -556,6 +628,7 @@ protected:
 private:
     virtual void scriptImported(QQmlScriptBlob *blob, const QV4::CompiledData::Location &location, const QString &qualifier, const QString &nameSpace);
     void initializeFromCompilationUnit(QV4::CompiledData::CompilationUnit *unit);
+    QV4::CompiledData::CompilationUnit *loadPrecompiledUnit(QString *errorString);
 
     QList<ScriptReference> m_scripts;
     QQmlScriptData *m_scriptData;
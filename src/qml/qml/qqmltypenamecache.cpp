@@ -42,10 +42,13 @@
 #include "qqmltypenamecache_p.h"
 
 #include "qqmlengine_p.h"
+#include "qqmlimport_p.h"
+#include <private/qv4string_p.h>
 
 QT_BEGIN_NAMESPACE
 
 QQmlTypeNameCache::QQmlTypeNameCache()
+    : m_importDatabase(0)
 {
 }
 
@@ -93,6 +96,9 @@ QQmlTypeNameCache::Result QQmlTypeNameCache::query(const QHashedStringRef &name)
     if (!result.isValid())
         result = typeSearch(m_anonymousImports, name);
 
+    if (!result.isValid())
+        result = deferredTypeSearch(m_anonymousDeferredImports, name);
+
     if (!result.isValid())
         result = query(m_anonymousCompositeSingletons, name);
 
@@ -108,6 +114,9 @@ QQmlTypeNameCache::Result QQmlTypeNameCache::query(const QHashedStringRef &name,
 
     Result result = typeSearch(i->modules, name);
 
+    if (!result.isValid())
+        result = deferredTypeSearch(i->deferredImports, name);
+
     if (!result.isValid())
         result = query(i->compositeSingletons, name);
 
@@ -121,6 +130,9 @@ QQmlTypeNameCache::Result QQmlTypeNameCache::query(const QV4::String *name)
     if (!result.isValid())
         result = typeSearch(m_anonymousImports, name);
 
+    if (!result.isValid())
+        result = deferredTypeSearch(m_anonymousDeferredImports, name);
+
     if (!result.isValid())
         result = query(m_anonymousCompositeSingletons, name);
 
@@ -142,11 +154,51 @@ QQmlTypeNameCache::Result QQmlTypeNameCache::query(const QV4::String *name, cons
 
     Result r = typeSearch(i->modules, name);
 
+    if (!r.isValid())
+        r = deferredTypeSearch(i->deferredImports, name);
+
     if (!r.isValid())
         r = query(i->compositeSingletons, name);
 
     return r;
 }
 
+QQmlTypeNameCache::Result QQmlTypeNameCache::deferredTypeSearch(const QVector<DeferredImport> &imports,
+                                                                const QHashedStringRef &name)
+{
+    if (imports.isEmpty())
+        return Result();
+    return deferredTypeSearch(imports, name.toString());
+}
+
+QQmlTypeNameCache::Result QQmlTypeNameCache::deferredTypeSearch(const QVector<DeferredImport> &imports,
+                                                                const QV4::String *name)
+{
+    if (imports.isEmpty())
+        return Result();
+    return deferredTypeSearch(imports, name->toQString());
+}
+
+// Loads the plugins of a deferred import the first time one of its types is named
+QQmlTypeNameCache::Result QQmlTypeNameCache::deferredTypeSearch(const QVector<DeferredImport> &imports,
+                                                                const QString &name)
+{
+    Q_ASSERT(m_importDatabase);
+    QVector<DeferredImport>::const_iterator end = imports.constEnd();
+    for (QVector<DeferredImport>::const_iterator it = imports.constBegin(); it != end; ++it) {
+        QQmlTypeModule *module = QQmlMetaType::typeModule(it->uri, it->majversion);
+        if (!module) {
+            m_importDatabase->resolveDeferredPlugin(it->uri, name);
+            module = QQmlMetaType::typeModule(it->uri, it->majversion);
+        }
+        if (module) {
+            if (QQmlType *type = QQmlTypeModuleVersion(module, it->minversion).type(QHashedStringRef(name)))
+                return Result(type);
+        }
+    }
+
+    return Result();
+}
+
 QT_END_NAMESPACE
 
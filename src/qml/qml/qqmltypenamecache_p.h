@@ -65,6 +65,7 @@ QT_BEGIN_NAMESPACE
 
 class QQmlType;
 class QQmlEngine;
+class QQmlImportDatabase;
 class QQmlTypeNameCache : public QQmlRefCount
 {
 public:
@@ -97,10 +98,22 @@ public:
 private:
     friend class QQmlImports;
 
+    // Module whose plugins haven't been loaded yet, see QQmlImportDatabase::resolveDeferredPlugin()
+    struct DeferredImport {
+        DeferredImport() : majversion(-1), minversion(-1) {}
+        DeferredImport(const QString &uri, int majversion, int minversion)
+            : uri(uri), majversion(majversion), minversion(minversion) {}
+
+        QString uri;
+        int majversion;
+        int minversion;
+    };
+
     struct Import {
         inline Import();
         // Imported module
         QVector<QQmlTypeModuleVersion> modules;
+        QVector<DeferredImport> deferredImports;
 
         // Or, imported script
         int scriptIndex;
@@ -149,9 +162,15 @@ private:
         return Result();
     }
 
+    Result deferredTypeSearch(const QVector<DeferredImport> &imports, const QHashedStringRef &name);
+    Result deferredTypeSearch(const QVector<DeferredImport> &imports, const QV4::String *name);
+    Result deferredTypeSearch(const QVector<DeferredImport> &imports, const QString &name);
+
     QStringHash<Import> m_namedImports;
     QMap<const Import *, QStringHash<Import> > m_namespacedImports;
     QVector<QQmlTypeModuleVersion> m_anonymousImports;
+    QVector<DeferredImport> m_anonymousDeferredImports;
+    QQmlImportDatabase *m_importDatabase;
     QStringHash<QUrl> m_anonymousCompositeSingletons;
 };
 
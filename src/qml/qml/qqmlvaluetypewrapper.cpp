@@ -66,6 +66,7 @@ public:
 
     QPointer<QObject> object;
     int property;
+    bool isVariantReference; // the property is a QVariant holding the value type
 };
 
 class QmlValueTypeCopy : public QmlValueTypeWrapper
@@ -88,7 +89,7 @@ QmlValueTypeWrapper::~QmlValueTypeWrapper()
 }
 
 QmlValueTypeReference::QmlValueTypeReference(QV8Engine *engine)
-: QmlValueTypeWrapper(engine, Reference)
+: QmlValueTypeWrapper(engine, Reference), property(-1), isVariantReference(false)
 {
 }
 
@@ -102,8 +103,7 @@ static bool readReferenceValue(const QmlValueTypeReference *reference)
 {
     // A reference resource may be either a "true" reference (eg, to a QVector3D property)
     // or a "variant" reference (eg, to a QVariant property which happens to contain a value-type).
-    QMetaProperty writebackProperty = reference->object->metaObject()->property(reference->property);
-    if (writebackProperty.userType() == QMetaType::QVariant) {
+    if (reference->isVariantReference) {
         // variant-containing-value-type reference
         QVariant variantReferenceValue;
         reference->type->readVariantValue(reference->object, reference->property, &variantReferenceValue);
@@ -130,6 +130,55 @@ static bool readReferenceValue(const QmlValueTypeReference *reference)
     return true;
 }
 
+static QQmlPropertyData *valueTypeProperty(const QmlValueTypeWrapper *r, const StringRef name, QQmlPropertyData &local)
+{
+    QQmlData *ddata = QQmlData::get(r->type, false);
+    if (ddata && ddata->propertyCache)
+        return ddata->propertyCache->property(name.getPointer(), 0, 0);
+    return QQmlPropertyCache::property(r->v8->engine(), r->type, name, 0, local);
+}
+
+// Writes the most common member types (the coordinates and sizes of
+// point, size, rect, vectors, ...) with a typed metacall instead of
+// converting the value to a QVariant first. Returns false for anything
+// that needs the generic conversion.
+static bool writeValueTypeProperty(QQmlValueType *type, const QQmlPropertyData *property, const ValueRef value)
+{
+    if (property->isEnum())
+        return false;
+
+    int status = -1;
+    int flags = 0;
+    switch (property->propType) {
+    case QMetaType::QReal: {
+        if (!value->isNumber())
+            return false;
+        qreal v = value->toNumber();
+        void *a[] = { &v, 0, &status, &flags };
+        type->qt_metacall(QMetaObject::WriteProperty, property->coreIndex, a);
+        return true;
+    }
+    case QMetaType::Int: {
+        if (!value->isInteger())
+            return false;
+        int v = value->integerValue();
+        void *a[] = { &v, 0, &status, &flags };
+        type->qt_metacall(QMetaObject::WriteProperty, property->coreIndex, a);
+        return true;
+    }
+    case QMetaType::Bool: {
+        if (!value->isBoolean())
+            return false;
+        bool v = value->booleanValue();
+        void *a[] = { &v, 0, &status, &flags };
+        type->qt_metacall(QMetaObject::WriteProperty, property->coreIndex, a);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
 void QmlValueTypeWrapper::initProto(ExecutionEngine *v4)
 {
     if (v4->qmlExtensions()->valueTypeWrapperPrototype)
@@ -150,6 +199,7 @@ ReturnedValue QmlValueTypeWrapper::create(QV8Engine *v8, QObject *object, int pr
     Scoped<QmlValueTypeReference> r(scope, new (v4->memoryManager) QmlValueTypeReference(v8));
     r->setPrototype(v4->qmlExtensions()->valueTypeWrapperPrototype);
     r->type = type; r->object = object; r->property = property;
+    r->isVariantReference = object->metaObject()->property(property).userType() == QMetaType::QVariant;
     return r.asReturnedValue();
 }
 
@@ -215,14 +265,7 @@ PropertyAttributes QmlValueTypeWrapper::query(const Managed *m, StringRef name)
     }
 
     QQmlPropertyData local;
-    QQmlPropertyData *result = 0;
-    {
-        QQmlData *ddata = QQmlData::get(r->type, false);
-        if (ddata && ddata->propertyCache)
-            result = ddata->propertyCache->property(name.getPointer(), 0, 0);
-        else
-            result = QQmlPropertyCache::property(r->v8->engine(), r->type, name.getPointer(), 0, local);
-    }
+    QQmlPropertyData *result = valueTypeProperty(r, name, local);
     return result ? Attr_Data : Attr_Invalid;
 }
 
@@ -292,15 +335,7 @@ ReturnedValue QmlValueTypeWrapper::get(Managed *m, const StringRef name, bool *h
     }
 
     QQmlPropertyData local;
-    QQmlPropertyData *result = 0;
-    {
-        QQmlData *ddata = QQmlData::get(r->type, false);
-        if (ddata && ddata->propertyCache)
-            result = ddata->propertyCache->property(name.getPointer(), 0, 0);
-        else
-            result = QQmlPropertyCache::property(r->v8->engine(), r->type, name, 0, local);
-    }
-
+    QQmlPropertyData *result = valueTypeProperty(r, name, local);
     if (!result)
         return Object::get(m, name, hasProperty);
 
@@ -344,19 +379,21 @@ void QmlValueTypeWrapper::put(Managed *m, const StringRef name, const ValueRef v
         return;
     }
 
-    QByteArray propName = name->toQString().toUtf8();
+    QQmlPropertyData local;
     if (r->objectType == QmlValueTypeWrapper::Reference) {
         QmlValueTypeReference *reference = static_cast<QmlValueTypeReference *>(r.getPointer());
+        if (!reference->object)
+            return;
         QMetaProperty writebackProperty = reference->object->metaObject()->property(reference->property);
 
-        if (!reference->object || !writebackProperty.isWritable() || !readReferenceValue(reference))
+        if (!writebackProperty.isWritable() || !readReferenceValue(reference))
             return;
 
         // we lookup the index after readReferenceValue() since it can change the reference->type.
-        int index = r->type->metaObject()->indexOfProperty(propName.constData());
-        if (index == -1)
+        QQmlPropertyData *property = valueTypeProperty(r.getPointer(), name, local);
+        if (!property || property->isFunction())
             return;
-        QMetaProperty p = r->type->metaObject()->property(index);
+        int index = property->coreIndex;
 
         QQmlBinding *newBinding = 0;
 
@@ -379,7 +416,7 @@ void QmlValueTypeWrapper::put(Managed *m, const StringRef name, const ValueRef v
             cacheData.coreIndex = reference->property;
             cacheData.valueTypeFlags = 0;
             cacheData.valueTypeCoreIndex = index;
-            cacheData.valueTypePropType = p.userType();
+            cacheData.valueTypePropType = property->propType;
 
             QV4::Scoped<QQmlBindingFunction> bindingFunction(scope, f);
             bindingFunction->initBindingLocation();
@@ -394,14 +431,17 @@ void QmlValueTypeWrapper::put(Managed *m, const StringRef name, const ValueRef v
             oldBinding->destroy();
 
         if (!f) {
-            QVariant v = r->v8->toVariant(value, -1);
+            if (!writeValueTypeProperty(reference->type, property, value)) {
+                QVariant v = r->v8->toVariant(value, -1);
 
-            if (p.isEnumType() && (QMetaType::Type)v.type() == QMetaType::Double)
-                v = v.toInt();
+                QMetaProperty p = r->type->metaObject()->property(index);
+                if (p.isEnumType() && (QMetaType::Type)v.type() == QMetaType::Double)
+                    v = v.toInt();
 
-            p.write(reference->type, v);
+                p.write(reference->type, v);
+            }
 
-            if (writebackProperty.userType() == QMetaType::QVariant) {
+            if (reference->isVariantReference) {
                 QVariant variantReferenceValue = r->type->value();
                 reference->type->writeVariantValue(reference->object, reference->property, 0, &variantReferenceValue);
             } else {
@@ -414,15 +454,16 @@ void QmlValueTypeWrapper::put(Managed *m, const StringRef name, const ValueRef v
 
         QmlValueTypeCopy *copy = static_cast<QmlValueTypeCopy *>(r.getPointer());
 
-        int index = r->type->metaObject()->indexOfProperty(propName.constData());
-        if (index == -1)
+        QQmlPropertyData *property = valueTypeProperty(r.getPointer(), name, local);
+        if (!property || property->isFunction())
             return;
 
-        QVariant v = r->v8->toVariant(value, -1);
-
         r->type->setValue(copy->value);
-        QMetaProperty p = r->type->metaObject()->property(index);
-        p.write(r->type, v);
+        if (!writeValueTypeProperty(r->type, property, value)) {
+            QVariant v = r->v8->toVariant(value, -1);
+            QMetaProperty p = r->type->metaObject()->property(property->coreIndex);
+            p.write(r->type, v);
+        }
         copy->value = r->type->value();
     }
 }
@@ -507,6 +507,40 @@ void QQmlVMEVariant::ensureValueType(int t)
     }
 }
 
+QQmlVMEVariant &QQmlVMEMetaObject::variant(int id) const
+{
+    return *static_cast<QQmlVMEVariant *>(storage(id));
+}
+
+bool QQmlVMEMetaData::hasUnboxedStorage(int propertyType)
+{
+    return propertyType == QMetaType::Int || propertyType == QMetaType::Bool
+            || propertyType == QMetaType::Double
+            || propertyType == qMetaTypeId<QQmlListProperty<QObject> >();
+}
+
+/*
+    Lays out the storage of the next property at compile time and returns its
+    offset. Unboxed values only take their own size instead of a whole
+    QQmlVMEVariant.
+*/
+int QQmlVMEMetaData::allocateStorage(int propertyType)
+{
+    int size = sizeof(QQmlVMEVariant);
+    int alignment = Q_ALIGNOF(QQmlVMEVariant);
+    if (propertyType == QMetaType::Bool) {
+        size = alignment = sizeof(bool);
+    } else if (propertyType == QMetaType::Double) {
+        size = alignment = sizeof(double);
+    } else if (hasUnboxedStorage(propertyType)) {
+        size = alignment = sizeof(int);
+    }
+
+    const int offset = (storageSize + alignment - 1) & ~(alignment - 1);
+    storageSize = offset + size;
+    return offset;
+}
+
 QQmlVMEMetaObjectEndpoint::QQmlVMEMetaObjectEndpoint()
 {
     setCallback(QQmlNotifierEndpoint::QQmlVMEMetaObjectEndpoint);
@@ -578,7 +612,7 @@ QQmlVMEMetaObject::QQmlVMEMetaObject(QObject *obj,
     op->metaObject = this;
     QQmlData::get(obj)->hasVMEMetaObject = true;
 
-    data = new QQmlVMEVariant[metaData->propertyCount - metaData->varPropertyCount];
+    data = metaData->storageSize ? new char[metaData->storageSize]() : 0;
 
     aConnected.resize(metaData->aliasCount);
     int list_type = qMetaTypeId<QQmlListProperty<QObject> >();
@@ -592,9 +626,11 @@ QQmlVMEMetaObject::QQmlVMEMetaObject(QObject *obj,
     // ### Optimize
     for (int ii = 0; ii < metaData->propertyCount - metaData->varPropertyCount; ++ii) {
         int t = (metaData->propertyData() + ii)->propertyType;
+        if (!QQmlVMEMetaData::hasUnboxedStorage(t))
+            new (storage(ii)) QQmlVMEVariant;
         if (t == list_type) {
             listProperties.append(List(methodOffset() + ii, this));
-            data[ii].setValue(listProperties.count() - 1);
+            *static_cast<int *>(storage(ii)) = listProperties.count() - 1;
         } else if (!needsJSWrapper && (t == qobject_type || t == variant_type)) {
             needsJSWrapper = true;
         }
@@ -624,6 +660,10 @@ QQmlVMEMetaObject::QQmlVMEMetaObject(QObject *obj,
 QQmlVMEMetaObject::~QQmlVMEMetaObject()
 {
     if (parent.isT1()) parent.asT1()->objectDestroyed(object);
+    for (int ii = 0; ii < metaData->propertyCount - metaData->varPropertyCount; ++ii) {
+        if (!QQmlVMEMetaData::hasUnboxedStorage((metaData->propertyData() + ii)->propertyType))
+            variant(ii).~QQmlVMEVariant();
+    }
     delete [] data;
     delete [] aliasEndpoints;
     delete [] v8methods;
@@ -737,47 +777,48 @@ int QQmlVMEMetaObject::metaCall(QMetaObject::Call c, int _id, void **a)
                     if (c == QMetaObject::ReadProperty) {
                         switch(t) {
                         case QVariant::Int:
-                            *reinterpret_cast<int *>(a[0]) = data[id].asInt();
+                            *reinterpret_cast<int *>(a[0]) = *static_cast<int *>(storage(id));
                             break;
                         case QVariant::Bool:
-                            *reinterpret_cast<bool *>(a[0]) = data[id].asBool();
+                            *reinterpret_cast<bool *>(a[0]) = *static_cast<bool *>(storage(id));
                             break;
                         case QVariant::Double:
-                            *reinterpret_cast<double *>(a[0]) = data[id].asDouble();
+                            *reinterpret_cast<double *>(a[0]) = *static_cast<double *>(storage(id));
                             break;
                         case QVariant::String:
-                            *reinterpret_cast<QString *>(a[0]) = data[id].asQString();
+                            *reinterpret_cast<QString *>(a[0]) = variant(id).asQString();
                             break;
                         case QVariant::Url:
-                            *reinterpret_cast<QUrl *>(a[0]) = data[id].asQUrl();
+                            *reinterpret_cast<QUrl *>(a[0]) = variant(id).asQUrl();
                             break;
                         case QVariant::Date:
-                            *reinterpret_cast<QDate *>(a[0]) = data[id].asQDate();
+                            *reinterpret_cast<QDate *>(a[0]) = variant(id).asQDate();
                             break;
                         case QVariant::DateTime:
-                            *reinterpret_cast<QDateTime *>(a[0]) = data[id].asQDateTime();
+                            *reinterpret_cast<QDateTime *>(a[0]) = variant(id).asQDateTime();
                             break;
                         case QVariant::RectF:
-                            *reinterpret_cast<QRectF *>(a[0]) = data[id].asQRectF();
+                            *reinterpret_cast<QRectF *>(a[0]) = variant(id).asQRectF();
                             break;
                         case QVariant::SizeF:
-                            *reinterpret_cast<QSizeF *>(a[0]) = data[id].asQSizeF();
+                            *reinterpret_cast<QSizeF *>(a[0]) = variant(id).asQSizeF();
                             break;
                         case QVariant::PointF:
-                            *reinterpret_cast<QPointF *>(a[0]) = data[id].asQPointF();
+                            *reinterpret_cast<QPointF *>(a[0]) = variant(id).asQPointF();
                             break;
                         case QMetaType::QObjectStar:
-                            *reinterpret_cast<QObject **>(a[0]) = data[id].asQObject();
+                            *reinterpret_cast<QObject **>(a[0]) = variant(id).asQObject();
                             break;
                         case QMetaType::QVariant:
                             *reinterpret_cast<QVariant *>(a[0]) = readPropertyAsVariant(id);
                             break;
                         default:
-                            QQml_valueTypeProvider()->readValueType(data[id].dataType(), data[id].dataPtr(), data->dataSize(), t, a[0]);
+                            if (!QQmlVMEMetaData::hasUnboxedStorage(t))
+                                QQml_valueTypeProvider()->readValueType(variant(id).dataType(), variant(id).dataPtr(), variant(id).dataSize(), t, a[0]);
                             break;
                         }
                         if (t == qMetaTypeId<QQmlListProperty<QObject> >()) {
-                            int listIndex = data[id].asInt();
+                            int listIndex = *static_cast<int *>(storage(id));
                             const List *list = &listProperties.at(listIndex);
                             *reinterpret_cast<QQmlListProperty<QObject> *>(a[0]) =
                                 QQmlListProperty<QObject>(object, (void *)list,
@@ -789,56 +830,58 @@ int QQmlVMEMetaObject::metaCall(QMetaObject::Call c, int _id, void **a)
 
                         switch(t) {
                         case QVariant::Int:
-                            needActivate = *reinterpret_cast<int *>(a[0]) != data[id].asInt();
-                            data[id].setValue(*reinterpret_cast<int *>(a[0]));
+                            needActivate = *reinterpret_cast<int *>(a[0]) != *static_cast<int *>(storage(id));
+                            *static_cast<int *>(storage(id)) = *reinterpret_cast<int *>(a[0]);
                             break;
                         case QVariant::Bool:
-                            needActivate = *reinterpret_cast<bool *>(a[0]) != data[id].asBool();
-                            data[id].setValue(*reinterpret_cast<bool *>(a[0]));
+                            needActivate = *reinterpret_cast<bool *>(a[0]) != *static_cast<bool *>(storage(id));
+                            *static_cast<bool *>(storage(id)) = *reinterpret_cast<bool *>(a[0]);
                             break;
                         case QVariant::Double:
-                            needActivate = *reinterpret_cast<double *>(a[0]) != data[id].asDouble();
-                            data[id].setValue(*reinterpret_cast<double *>(a[0]));
+                            needActivate = *reinterpret_cast<double *>(a[0]) != *static_cast<double *>(storage(id));
+                            *static_cast<double *>(storage(id)) = *reinterpret_cast<double *>(a[0]);
                             break;
                         case QVariant::String:
-                            needActivate = *reinterpret_cast<QString *>(a[0]) != data[id].asQString();
-                            data[id].setValue(*reinterpret_cast<QString *>(a[0]));
+                            needActivate = *reinterpret_cast<QString *>(a[0]) != variant(id).asQString();
+                            variant(id).setValue(*reinterpret_cast<QString *>(a[0]));
                             break;
                         case QVariant::Url:
-                            needActivate = *reinterpret_cast<QUrl *>(a[0]) != data[id].asQUrl();
-                            data[id].setValue(*reinterpret_cast<QUrl *>(a[0]));
+                            needActivate = *reinterpret_cast<QUrl *>(a[0]) != variant(id).asQUrl();
+                            variant(id).setValue(*reinterpret_cast<QUrl *>(a[0]));
                             break;
                         case QVariant::Date:
-                            needActivate = *reinterpret_cast<QDate *>(a[0]) != data[id].asQDate();
-                            data[id].setValue(*reinterpret_cast<QDate *>(a[0]));
+                            needActivate = *reinterpret_cast<QDate *>(a[0]) != variant(id).asQDate();
+                            variant(id).setValue(*reinterpret_cast<QDate *>(a[0]));
                             break;
                         case QVariant::DateTime:
-                            needActivate = *reinterpret_cast<QDateTime *>(a[0]) != data[id].asQDateTime();
-                            data[id].setValue(*reinterpret_cast<QDateTime *>(a[0]));
+                            needActivate = *reinterpret_cast<QDateTime *>(a[0]) != variant(id).asQDateTime();
+                            variant(id).setValue(*reinterpret_cast<QDateTime *>(a[0]));
                             break;
                         case QVariant::RectF:
-                            needActivate = *reinterpret_cast<QRectF *>(a[0]) != data[id].asQRectF();
-                            data[id].setValue(*reinterpret_cast<QRectF *>(a[0]));
+                            needActivate = *reinterpret_cast<QRectF *>(a[0]) != variant(id).asQRectF();
+                            variant(id).setValue(*reinterpret_cast<QRectF *>(a[0]));
                             break;
                         case QVariant::SizeF:
-                            needActivate = *reinterpret_cast<QSizeF *>(a[0]) != data[id].asQSizeF();
-                            data[id].setValue(*reinterpret_cast<QSizeF *>(a[0]));
+                            needActivate = *reinterpret_cast<QSizeF *>(a[0]) != variant(id).asQSizeF();
+                            variant(id).setValue(*reinterpret_cast<QSizeF *>(a[0]));
                             break;
                         case QVariant::PointF:
-                            needActivate = *reinterpret_cast<QPointF *>(a[0]) != data[id].asQPointF();
-                            data[id].setValue(*reinterpret_cast<QPointF *>(a[0]));
+                            needActivate = *reinterpret_cast<QPointF *>(a[0]) != variant(id).asQPointF();
+                            variant(id).setValue(*reinterpret_cast<QPointF *>(a[0]));
                             break;
                         case QMetaType::QObjectStar:
-                            needActivate = *reinterpret_cast<QObject **>(a[0]) != data[id].asQObject();
-                            data[id].setValue(*reinterpret_cast<QObject **>(a[0]), this, id);
+                            needActivate = *reinterpret_cast<QObject **>(a[0]) != variant(id).asQObject();
+                            variant(id).setValue(*reinterpret_cast<QObject **>(a[0]), this, id);
                             break;
                         case QMetaType::QVariant:
                             writeProperty(id, *reinterpret_cast<QVariant *>(a[0]));
                             break;
                         default:
-                            data[id].ensureValueType(t);
-                            needActivate = !QQml_valueTypeProvider()->equalValueType(t, a[0], data[id].dataPtr(), data[id].dataSize());
-                            QQml_valueTypeProvider()->writeValueType(t, a[0], data[id].dataPtr(), data[id].dataSize());
+                            if (QQmlVMEMetaData::hasUnboxedStorage(t))
+                                break;
+                            variant(id).ensureValueType(t);
+                            needActivate = !QQml_valueTypeProvider()->equalValueType(t, a[0], variant(id).dataPtr(), variant(id).dataSize());
+                            QQml_valueTypeProvider()->writeValueType(t, a[0], variant(id).dataPtr(), variant(id).dataSize());
                             break;
                         }
                     }
@@ -1017,10 +1060,10 @@ QVariant QQmlVMEMetaObject::readPropertyAsVariant(int id)
         }
         return QVariant();
     } else {
-        if (data[id].dataType() == QMetaType::QObjectStar) {
-            return QVariant::fromValue(data[id].asQObject());
+        if (variant(id).dataType() == QMetaType::QObjectStar) {
+            return QVariant::fromValue(variant(id).asQObject());
         } else {
-            return data[id].asQVariant();
+            return variant(id).asQVariant();
         }
     }
 }
@@ -1100,13 +1143,13 @@ void QQmlVMEMetaObject::writeProperty(int id, const QVariant &value)
         bool needActivate = false;
         if (value.userType() == QMetaType::QObjectStar) {
             QObject *o = *(QObject **)value.data();
-            needActivate = (data[id].dataType() != QMetaType::QObjectStar || data[id].asQObject() != o);
-            data[id].setValue(o, this, id);
+            needActivate = (variant(id).dataType() != QMetaType::QObjectStar || variant(id).asQObject() != o);
+            variant(id).setValue(o, this, id);
         } else {
-            needActivate = (data[id].dataType() != qMetaTypeId<QVariant>() ||
-                            data[id].asQVariant().userType() != value.userType() ||
-                            data[id].asQVariant() != value);
-            data[id].setValue(value);
+            needActivate = (variant(id).dataType() != qMetaTypeId<QVariant>() ||
+                            variant(id).asQVariant().userType() != value.userType() ||
+                            variant(id).asQVariant() != value);
+            variant(id).setValue(value);
         }
 
         if (needActivate)
@@ -1214,6 +1257,32 @@ void QQmlVMEMetaObject::setVMEProperty(int index, const QV4::ValueRef v)
     return writeVarProperty(index - propOffset(), v);
 }
 
+/*
+    Reads an int, bool or real property straight from the storage instead of
+    going through a metacall.
+*/
+QV4::ReturnedValue QQmlVMEMetaObject::vmeUnboxedProperty(int index)
+{
+    if (index < propOffset()) {
+        Q_ASSERT(parentVMEMetaObject());
+        return parentVMEMetaObject()->vmeUnboxedProperty(index);
+    }
+
+    const int id = index - propOffset();
+    Q_ASSERT(id < firstVarPropertyIndex);
+    switch ((metaData->propertyData() + id)->propertyType) {
+    case QMetaType::Int:
+        return QV4::Encode(*static_cast<int *>(storage(id)));
+    case QMetaType::Bool:
+        return QV4::Encode(*static_cast<bool *>(storage(id)));
+    case QMetaType::Double:
+        return QV4::Encode(*static_cast<double *>(storage(id)));
+    default:
+        Q_ASSERT(!"QQmlVMEMetaObject::vmeUnboxedProperty: not an unboxed property");
+        return QV4::Encode::undefined();
+    }
+}
+
 bool QQmlVMEMetaObject::ensureVarPropertiesAllocated()
 {
     if (!varPropertiesInitialized)
@@ -1241,9 +1310,11 @@ void QQmlVMEMetaObject::mark(QV4::ExecutionEngine *e)
     // add references created by VMEVariant properties
     int maxDataIdx = metaData->propertyCount - metaData->varPropertyCount;
     for (int ii = 0; ii < maxDataIdx; ++ii) { // XXX TODO: optimize?
-        if (data[ii].dataType() == QMetaType::QObjectStar) {
+        if (QQmlVMEMetaData::hasUnboxedStorage((metaData->propertyData() + ii)->propertyType))
+            continue;
+        if (variant(ii).dataType() == QMetaType::QObjectStar) {
             // possible QObject reference.
-            QObject *ref = data[ii].asQObject();
+            QObject *ref = variant(ii).asQObject();
             if (ref) {
                 QQmlData *ddata = QQmlData::get(ref);
                 if (ddata)
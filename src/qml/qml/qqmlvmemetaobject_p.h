@@ -86,6 +86,7 @@ struct QQmlVMEMetaData
     short methodCount;
     short dummyForAlignment; // Add padding to ensure that the following
                              // AliasData/PropertyData/MethodData is int aligned.
+    int storageSize; // Bytes of property storage each object needs
 
     struct AliasData {
         int contextIdx;
@@ -116,6 +117,7 @@ struct QQmlVMEMetaData
 
     struct PropertyData {
         int propertyType;
+        int storageOffset; // Where the value lives in the object's storage
     };
 
     struct MethodData {
@@ -135,6 +137,11 @@ struct QQmlVMEMetaData
     MethodData *methodData() const {
         return (MethodData *)(aliasData() + aliasCount);
     }
+
+    // int, bool and real properties, and the index of list properties, are
+    // stored unboxed in a few bytes. Everything else needs a QQmlVMEVariant.
+    static bool hasUnboxedStorage(int propertyType);
+    int allocateStorage(int propertyType);
 };
 
 class QQmlVMEMetaObject;
@@ -169,6 +176,7 @@ public:
     void setVmeMethod(int index, QV4::ValueRef function);
     QV4::ReturnedValue vmeProperty(int index);
     void setVMEProperty(int index, const QV4::ValueRef v);
+    QV4::ReturnedValue vmeUnboxedProperty(int index);
 
     void connectAliasSignal(int index, bool indexInSignalRange);
 
@@ -201,7 +209,9 @@ public:
     inline int signalCount() const;
 
     bool hasAssignedMetaObjectData;
-    QQmlVMEVariant *data;
+    char *data;
+    inline void *storage(int id) const;
+    inline QQmlVMEVariant &variant(int id) const;
     QQmlVMEMetaObjectEndpoint *aliasEndpoints;
 
     QV4::WeakValue varProperties;
@@ -267,6 +277,11 @@ QQmlVMEMetaObject *QQmlVMEMetaObject::get(QObject *obj)
     return 0;
 }
 
+void *QQmlVMEMetaObject::storage(int id) const
+{
+    return data + (metaData->propertyData() + id)->storageOffset;
+}
+
 int QQmlVMEMetaObject::propOffset() const
 {
     return cache->propertyOffset();
@@ -61,10 +61,11 @@
 #include <QtNetwork/qnetworkreply.h>
 #include <QtCore/qtextcodec.h>
 #include <QtCore/qxmlstream.h>
-#include <QtCore/qstack.h>
 #include <QtCore/qdebug.h>
 
 #include <private/qv4objectproto_p.h>
+#include <private/qv4arraybuffer_p.h>
+#include <private/qv4jsonobject_p.h>
 #include <private/qv4scopedvalue_p.h>
 
 using namespace QV4;
@@ -125,7 +126,7 @@ class DocumentImpl;
 class NodeImpl
 {
 public:
-    NodeImpl() : type(Element), document(0), parent(0) {}
+    NodeImpl() : type(Element), document(0), parent(0), offset(-1), length(0), childrenRead(true) {}
     virtual ~NodeImpl() {
         for (int ii = 0; ii < children.count(); ++ii)
             delete children.at(ii);
@@ -161,10 +162,30 @@ public:
     DocumentImpl *document;
     NodeImpl *parent;
 
+    // The children of an element are only read from the document text the
+    // first time they are asked for. offset and length locate the element in
+    // the text, and namespaces are the declarations in scope from its
+    // ancestors.
+    int offset;
+    int length;
+    bool childrenRead;
+    QXmlStreamNamespaceDeclarations namespaces;
+
+    const QList<NodeImpl *> &childNodes();
+
     QList<NodeImpl *> children;
     QList<NodeImpl *> attributes;
 };
 
+class EntityResolver : public QXmlStreamEntityResolver
+{
+public:
+    virtual QString resolveUndeclaredEntity(const QString &name) { return entities.value(name); }
+
+    // Entities declared in the DTD, which element fragments do not see
+    QHash<QString, QString> entities;
+};
+
 class DocumentImpl : public QQmlRefCount, public NodeImpl
 {
 public:
@@ -179,8 +200,20 @@ public:
 
     NodeImpl *root;
 
+    QString text;
+    EntityResolver entityResolver;
+
+    NodeImpl *createElement(QXmlStreamReader &reader, int offset, NodeImpl *parent,
+                            const QXmlStreamNamespaceDeclarations &namespaces);
+    void readChildren(NodeImpl *node);
+    QList<NodeImpl *> elementsByTagName(NodeImpl *node, const QString &name);
+
     void addref() { QQmlRefCount::addref(); }
     void release() { QQmlRefCount::release(); }
+
+private:
+    void startReading(QXmlStreamReader &reader, NodeImpl *node);
+    NodeImpl *findElement(QVector<NodeImpl *> &path, QVector<int> &cursors, int offset);
 };
 
 class NamedNodeMap : public Object
@@ -344,6 +377,9 @@ DEFINE_OBJECT_VTABLE(Node);
 class Element : public Node
 {
 public:
+    // JS API
+    static ReturnedValue method_getElementsByTagName(CallContext *ctx);
+
     // C++ API
     static ReturnedValue prototype(ExecutionEngine *);
 };
@@ -417,6 +453,178 @@ void NodeImpl::release()
     document->release();
 }
 
+const QList<NodeImpl *> &NodeImpl::childNodes()
+{
+    if (!childrenRead)
+        document->readChildren(this);
+    return children;
+}
+
+/*
+    Creates the element the reader is positioned at, which starts at offset
+    in the document text. Its children are only read when needed.
+*/
+NodeImpl *DocumentImpl::createElement(QXmlStreamReader &reader, int offset, NodeImpl *parent,
+                                      const QXmlStreamNamespaceDeclarations &namespaces)
+{
+    NodeImpl *node = new NodeImpl;
+    node->document = this;
+    node->namespaceUri = reader.namespaceUri().toString();
+    node->name = reader.name().toString();
+    node->parent = parent;
+    node->offset = offset;
+    node->childrenRead = false;
+    node->namespaces = namespaces;
+
+    foreach (const QXmlStreamAttribute &a, reader.attributes()) {
+        NodeImpl *attr = new NodeImpl;
+        attr->document = this;
+        attr->type = NodeImpl::Attr;
+        attr->namespaceUri = a.namespaceUri().toString();
+        attr->name = a.name().toString();
+        attr->data = a.value().toString();
+        attr->parent = node;
+        node->attributes.append(attr);
+    }
+    return node;
+}
+
+/*
+    Positions reader on the start tag of node, reading the document text from
+    there on.
+*/
+void DocumentImpl::startReading(QXmlStreamReader &reader, NodeImpl *node)
+{
+    if (!entityResolver.entities.isEmpty())
+        reader.setEntityResolver(&entityResolver);
+    reader.addExtraNamespaceDeclarations(node->namespaces);
+    while (!reader.atEnd() && reader.readNext() != QXmlStreamReader::StartElement) {}
+}
+
+void DocumentImpl::readChildren(NodeImpl *node)
+{
+    Q_ASSERT(!node->childrenRead);
+    node->childrenRead = true;
+
+    QXmlStreamReader reader(QString::fromRawData(text.constData() + node->offset, node->length));
+    startReading(reader, node);
+
+    // The declarations refer to the reader's buffer, so they are copied.
+    QXmlStreamNamespaceDeclarations namespaces = node->namespaces;
+    foreach (const QXmlStreamNamespaceDeclaration &ns, reader.namespaceDeclarations())
+        namespaces.append(QXmlStreamNamespaceDeclaration(ns.prefix().toString(), ns.namespaceUri().toString()));
+
+    while (!reader.atEnd()) {
+        switch (reader.readNext()) {
+        case QXmlStreamReader::StartElement:
+        {
+            const int end = node->offset + int(reader.characterOffset());
+            NodeImpl *child = createElement(reader, text.lastIndexOf(QLatin1Char('<'), end - 1), node, namespaces);
+            node->children.append(child);
+            reader.skipCurrentElement();
+            child->length = node->offset + int(reader.characterOffset()) - child->offset;
+        }
+            break;
+        case QXmlStreamReader::EndElement:
+            return;
+        case QXmlStreamReader::Characters:
+        {
+            NodeImpl *child = new NodeImpl;
+            child->document = this;
+            child->type = reader.isCDATA()?NodeImpl::CDATA:NodeImpl::Text;
+            child->parent = node;
+            child->data = reader.text().toString();
+            node->children.append(child);
+        }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+/*
+    Returns the element starting at offset, descending from the last element
+    of path. Matches are looked up in document order, so cursors remembers
+    how far the children of each element on the path have been searched.
+*/
+NodeImpl *DocumentImpl::findElement(QVector<NodeImpl *> &path, QVector<int> &cursors, int offset)
+{
+    for (int level = 0; level < path.count(); ++level) {
+        const QList<NodeImpl *> &children = path.at(level)->childNodes();
+        int &cursor = cursors[level];
+        for (int ii = cursor + 1; ii < children.count(); ++ii) {
+            if (children.at(ii)->type != NodeImpl::Element)
+                continue;
+            if (children.at(ii)->offset > offset)
+                break;
+            cursor = ii;
+        }
+        if (cursor < 0)
+            return 0;
+
+        NodeImpl *child = children.at(cursor);
+        if (child->offset == offset)
+            return child;
+        if (level + 1 < path.count() && path.at(level + 1) == child)
+            continue;
+        path.resize(level + 1);
+        cursors.resize(level + 1);
+        path.append(child);
+        cursors.append(-1);
+    }
+    return 0;
+}
+
+/*
+    Returns the elements below node with the given tag name, in document
+    order. The document text is scanned without building the tree, which
+    is only read along the way to the matching elements.
+*/
+QList<NodeImpl *> DocumentImpl::elementsByTagName(NodeImpl *node, const QString &name)
+{
+    QList<NodeImpl *> result;
+    const bool all = name == QLatin1String("*");
+
+    NodeImpl *scope = node;
+    if (node->type == NodeImpl::Document) {
+        scope = root;
+        if (scope && (all || scope->name == name))
+            result.append(scope);
+    }
+    if (!scope || scope->type != NodeImpl::Element)
+        return result;
+
+    QXmlStreamReader reader(QString::fromRawData(text.constData() + scope->offset, scope->length));
+    startReading(reader, scope);
+
+    QVector<NodeImpl *> path;
+    QVector<int> cursors;
+    path.append(scope);
+    cursors.append(-1);
+
+    int depth = 0;
+    while (!reader.atEnd()) {
+        switch (reader.readNext()) {
+        case QXmlStreamReader::StartElement:
+            ++depth;
+            if (all || reader.name() == name) {
+                const int end = scope->offset + int(reader.characterOffset());
+                if (NodeImpl *element = findElement(path, cursors, text.lastIndexOf(QLatin1Char('<'), end - 1)))
+                    result.append(element);
+            }
+            break;
+        case QXmlStreamReader::EndElement:
+            if (--depth < 0)
+                return result;
+            break;
+        default:
+            break;
+        }
+    }
+    return result;
+}
+
 ReturnedValue NodePrototype::method_get_nodeName(CallContext *ctx)
 {
     Scope scope(ctx);
@@ -507,10 +715,11 @@ ReturnedValue NodePrototype::method_get_firstChild(CallContext *ctx)
 
     QV8Engine *engine = ctx->engine->v8Engine;
 
-    if (r->d->children.isEmpty())
+    const QList<NodeImpl *> &children = r->d->childNodes();
+    if (children.isEmpty())
         return Encode::null();
     else
-        return Node::create(engine, r->d->children.first());
+        return Node::create(engine, children.first());
 }
 
 ReturnedValue NodePrototype::method_get_lastChild(CallContext *ctx)
@@ -522,10 +731,11 @@ ReturnedValue NodePrototype::method_get_lastChild(CallContext *ctx)
 
     QV8Engine *engine = ctx->engine->v8Engine;
 
-    if (r->d->children.isEmpty())
+    const QList<NodeImpl *> &children = r->d->childNodes();
+    if (children.isEmpty())
         return Encode::null();
     else
-        return Node::create(engine, r->d->children.last());
+        return Node::create(engine, children.last());
 }
 
 ReturnedValue NodePrototype::method_get_previousSibling(CallContext *ctx)
@@ -540,12 +750,13 @@ ReturnedValue NodePrototype::method_get_previousSibling(CallContext *ctx)
     if (!r->d->parent)
         return Encode::null();
 
-    for (int ii = 0; ii < r->d->parent->children.count(); ++ii) {
-        if (r->d->parent->children.at(ii) == r->d) {
+    const QList<NodeImpl *> &siblings = r->d->parent->childNodes();
+    for (int ii = 0; ii < siblings.count(); ++ii) {
+        if (siblings.at(ii) == r->d) {
             if (ii == 0)
                 return Encode::null();
             else
-                return Node::create(engine, r->d->parent->children.at(ii - 1));
+                return Node::create(engine, siblings.at(ii - 1));
         }
     }
 
@@ -564,12 +775,13 @@ ReturnedValue NodePrototype::method_get_nextSibling(CallContext *ctx)
     if (!r->d->parent)
         return Encode::null();
 
-    for (int ii = 0; ii < r->d->parent->children.count(); ++ii) {
-        if (r->d->parent->children.at(ii) == r->d) {
-            if ((ii + 1) == r->d->parent->children.count())
+    const QList<NodeImpl *> &siblings = r->d->parent->childNodes();
+    for (int ii = 0; ii < siblings.count(); ++ii) {
+        if (siblings.at(ii) == r->d) {
+            if ((ii + 1) == siblings.count())
                 return Encode::null();
             else
-                return Node::create(engine, r->d->parent->children.at(ii + 1));
+                return Node::create(engine, siblings.at(ii + 1));
         }
     }
 
@@ -647,12 +859,35 @@ ReturnedValue Element::prototype(ExecutionEngine *engine)
         ScopedObject pp(scope);
         p->setPrototype((pp = NodePrototype::getProto(engine)).getPointer());
         p->defineAccessorProperty(QStringLiteral("tagName"), NodePrototype::method_get_nodeName, 0);
+        p->defineDefaultProperty(QStringLiteral("getElementsByTagName"), method_getElementsByTagName, 1);
         d->elementPrototype = p;
         engine->v8Engine->freezeObject(p);
     }
     return d->elementPrototype.value();
 }
 
+ReturnedValue Element::method_getElementsByTagName(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<Node> r(scope, ctx->callData->thisObject.as<Node>());
+    if (!r)
+        return ctx->throwTypeError();
+    if (ctx->callData->argc < 1)
+        V4THROW_DOM(DOMEXCEPTION_SYNTAX_ERR, "Incorrect argument count");
+
+    QV8Engine *engine = ctx->engine->v8Engine;
+    const QString name = ctx->callData->args[0].toQStringNoThrow();
+    const QList<NodeImpl *> elements = r->d->document->elementsByTagName(r->d, name);
+
+    Scoped<ArrayObject> result(scope, ctx->engine->newArrayObject());
+    result->arrayReserve(elements.count());
+    ScopedValue v(scope);
+    for (int ii = 0; ii < elements.count(); ++ii)
+        result->arrayPut(ii, (v = Node::create(engine, elements.at(ii))));
+    result->setArrayLengthUnchecked(elements.count());
+    return result.asReturnedValue();
+}
+
 ReturnedValue Attr::prototype(ExecutionEngine *engine)
 {
     QQmlXMLHttpRequestData *d = xhrdata(engine->v8Engine);
@@ -793,6 +1028,7 @@ ReturnedValue Document::prototype(ExecutionEngine *v4)
         p->defineAccessorProperty(QStringLiteral("xmlEncoding"), method_xmlEncoding, 0);
         p->defineAccessorProperty(QStringLiteral("xmlStandalone"), method_xmlStandalone, 0);
         p->defineAccessorProperty(QStringLiteral("documentElement"), method_documentElement, 0);
+        p->defineDefaultProperty(QStringLiteral("getElementsByTagName"), Element::method_getElementsByTagName, 1);
         d->documentPrototype = p;
         v4->v8Engine->freezeObject(p);
     }
@@ -805,17 +1041,29 @@ ReturnedValue Document::load(QV8Engine *engine, const QByteArray &data)
     ExecutionEngine *v4 = QV8Engine::getV4(engine);
     Scope scope(v4);
 
+    // The reply is decoded once, and the children of each element are read
+    // from the text on demand. This first pass only checks that the document
+    // is well-formed and creates the root element.
+    QString text;
+#ifndef QT_NO_TEXTCODEC
+    {
+        QXmlStreamReader reader(data);
+        reader.readNext();
+        QTextCodec *codec = QTextCodec::codecForName(reader.documentEncoding().toString().toUtf8());
+        if (!codec)
+            codec = QTextCodec::codecForName("UTF-8");
+        text = QTextCodec::codecForUtfText(data, codec)->toUnicode(data);
+    }
+#else
+    text = QString::fromUtf8(data);
+#endif
+
     DocumentImpl *document = 0;
-    QStack<NodeImpl *> nodeStack;
 
-    QXmlStreamReader reader(data);
+    QXmlStreamReader reader(text);
 
     while (!reader.atEnd()) {
         switch (reader.readNext()) {
-        case QXmlStreamReader::NoToken:
-            break;
-        case QXmlStreamReader::Invalid:
-            break;
         case QXmlStreamReader::StartDocument:
             Q_ASSERT(!document);
             document = new DocumentImpl;
@@ -824,55 +1072,25 @@ ReturnedValue Document::load(QV8Engine *engine, const QByteArray &data)
             document->encoding = reader.documentEncoding().toString();
             document->isStandalone = reader.isStandaloneDocument();
             break;
-        case QXmlStreamReader::EndDocument:
-            break;
-        case QXmlStreamReader::StartElement:
-        {
+        case QXmlStreamReader::DTD:
             Q_ASSERT(document);
-            NodeImpl *node = new NodeImpl;
-            node->document = document;
-            node->namespaceUri = reader.namespaceUri().toString();
-            node->name = reader.name().toString();
-            if (nodeStack.isEmpty()) {
-                document->root = node;
-            } else {
-                node->parent = nodeStack.top();
-                node->parent->children.append(node);
+            foreach (const QXmlStreamEntityDeclaration &e, reader.entityDeclarations()) {
+                if (!e.value().isNull())
+                    document->entityResolver.entities.insert(e.name().toString(), e.value().toString());
             }
-            nodeStack.append(node);
-
-            foreach (const QXmlStreamAttribute &a, reader.attributes()) {
-                NodeImpl *attr = new NodeImpl;
-                attr->document = document;
-                attr->type = NodeImpl::Attr;
-                attr->namespaceUri = a.namespaceUri().toString();
-                attr->name = a.name().toString();
-                attr->data = a.value().toString();
-                attr->parent = node;
-                node->attributes.append(attr);
-            }
-        }
             break;
-        case QXmlStreamReader::EndElement:
-            nodeStack.pop();
-            break;
-        case QXmlStreamReader::Characters:
+        case QXmlStreamReader::StartElement:
         {
-            NodeImpl *node = new NodeImpl;
-            node->document = document;
-            node->type = reader.isCDATA()?NodeImpl::CDATA:NodeImpl::Text;
-            node->parent = nodeStack.top();
-            node->parent->children.append(node);
-            node->data = reader.text().toString();
+            Q_ASSERT(document);
+            const int end = int(reader.characterOffset());
+            NodeImpl *root = document->createElement(reader, text.lastIndexOf(QLatin1Char('<'), end - 1),
+                                                     0, QXmlStreamNamespaceDeclarations());
+            document->root = root;
+            reader.skipCurrentElement();
+            root->length = int(reader.characterOffset()) - root->offset;
         }
             break;
-        case QXmlStreamReader::Comment:
-            break;
-        case QXmlStreamReader::DTD:
-            break;
-        case QXmlStreamReader::EntityReference:
-            break;
-        case QXmlStreamReader::ProcessingInstruction:
+        default:
             break;
         }
     }
@@ -883,6 +1101,8 @@ ReturnedValue Document::load(QV8Engine *engine, const QByteArray &data)
         return Encode::null();
     }
 
+    document->text = text;
+
     ScopedObject instance(scope, new (v4->memoryManager) Node(v4, document));
     ScopedObject p(scope);
     instance->setPrototype((p = Document::prototype(v4)).getPointer());
@@ -971,10 +1191,11 @@ ReturnedValue NodeList::getIndexed(Managed *m, uint index, bool *hasProperty)
 
     QV8Engine *engine = v4->v8Engine;
 
-    if ((int)index < r->d->children.count()) {
+    const QList<NodeImpl *> &children = r->d->childNodes();
+    if ((int)index < children.count()) {
         if (hasProperty)
             *hasProperty = true;
-        return Node::create(engine, r->d->children.at(index));
+        return Node::create(engine, children.at(index));
     }
     if (hasProperty)
         *hasProperty = false;
@@ -991,7 +1212,7 @@ ReturnedValue NodeList::get(Managed *m, const StringRef name, bool *hasProperty)
     name->makeIdentifier();
 
     if (name->equals(v4->id_length))
-        return Primitive::fromInt32(r->d->children.count()).asReturnedValue();
+        return Primitive::fromInt32(r->d->childNodes().count()).asReturnedValue();
     return Object::get(m, name, hasProperty);
 }
 
@@ -1076,6 +1297,12 @@ public:
     QString responseBody();
     const QByteArray & rawResponseBody() const;
     bool receivedXml() const;
+
+    QString responseType() const;
+    void setResponseType(const QString &type);
+
+    ReturnedValue cachedResponse() const;
+    void setCachedResponse(const ValueRef response);
 private slots:
     void readyRead();
     void error(QNetworkReply::NetworkError);
@@ -1083,6 +1310,8 @@ private slots:
 
 private:
     void requestFromUrl(const QUrl &url);
+    void readResponseData();
+    void clearResponse();
 
     ExecutionEngine *v4;
     State m_state;
@@ -1104,10 +1333,16 @@ private:
     QByteArray m_charset;
     QTextCodec *m_textCodec;
 #ifndef QT_NO_TEXTCODEC
+    QTextDecoder *m_textDecoder;
     QTextCodec* findTextCodec() const;
 #endif
     void readEncoding();
 
+    QString m_responseType;
+    QString m_responseText;
+    int m_decodedLength;
+    PersistentValue m_response;
+
     ReturnedValue getMe() const;
     void setMe(const ValueRef me);
     PersistentValue m_me;
@@ -1129,13 +1364,20 @@ private:
 QQmlXMLHttpRequest::QQmlXMLHttpRequest(QV8Engine *engine, QNetworkAccessManager *manager)
     : v4(QV8Engine::getV4(engine))
     , m_state(Unsent), m_errorFlag(false), m_sendFlag(false)
-    , m_redirectCount(0), m_gotXml(false), m_textCodec(0), m_network(0), m_nam(manager)
+    , m_redirectCount(0), m_gotXml(false), m_textCodec(0)
+#ifndef QT_NO_TEXTCODEC
+    , m_textDecoder(0)
+#endif
+    , m_decodedLength(0), m_network(0), m_nam(manager)
 {
 }
 
 QQmlXMLHttpRequest::~QQmlXMLHttpRequest()
 {
     destroyNetwork();
+#ifndef QT_NO_TEXTCODEC
+    delete m_textDecoder;
+#endif
 }
 
 bool QQmlXMLHttpRequest::sendFlag() const
@@ -1168,7 +1410,7 @@ ReturnedValue QQmlXMLHttpRequest::open(const ValueRef me, const QString &method,
     destroyNetwork();
     m_sendFlag = false;
     m_errorFlag = false;
-    m_responseEntityBody = QByteArray();
+    clearResponse();
     m_method = method;
     m_url = url;
     m_state = Opened;
@@ -1305,7 +1547,7 @@ ReturnedValue QQmlXMLHttpRequest::send(const ValueRef me, const QByteArray &data
 ReturnedValue QQmlXMLHttpRequest::abort(const ValueRef me)
 {
     destroyNetwork();
-    m_responseEntityBody = QByteArray();
+    clearResponse();
     m_errorFlag = true;
     m_request = QNetworkRequest();
 
@@ -1347,11 +1589,19 @@ void QQmlXMLHttpRequest::readyRead()
     if (m_state < HeadersReceived) {
         m_state = HeadersReceived;
         fillHeadersList ();
+        readEncoding();
+
+        // Size the buffer up front so large responses aren't repeatedly reallocated as they
+        // arrive.
+        const qint64 length = m_network->header(QNetworkRequest::ContentLengthHeader).toLongLong();
+        if (length > 0 && length < INT_MAX)
+            m_responseEntityBody.reserve(int(length));
+
         dispatchCallback(me);
     }
 
     bool wasEmpty = m_responseEntityBody.isEmpty();
-    m_responseEntityBody.append(m_network->readAll());
+    readResponseData();
     if (wasEmpty && !m_responseEntityBody.isEmpty())
         m_state = Loading;
 
@@ -1400,7 +1650,7 @@ void QQmlXMLHttpRequest::error(QNetworkReply::NetworkError error)
         dispatchCallback(me);
     } else {
         m_errorFlag = true;
-        m_responseEntityBody = QByteArray();
+        clearResponse();
     }
 
     m_state = Done;
@@ -1439,7 +1689,7 @@ void QQmlXMLHttpRequest::finished()
         fillHeadersList ();
         dispatchCallback(m_me);
     }
-    m_responseEntityBody.append(m_network->readAll());
+    readResponseData();
     readEncoding();
 
     if (xhrDump()) {
@@ -1523,16 +1773,66 @@ QTextCodec* QQmlXMLHttpRequest::findTextCodec() const
 #endif
 
 
+/*
+    Reads the available reply data directly into the end of the response body, avoiding the
+    temporary copy readAll() would allocate.
+*/
+void QQmlXMLHttpRequest::readResponseData()
+{
+    const qint64 available = m_network->bytesAvailable();
+    if (available <= 0)
+        return;
+
+    const int size = m_responseEntityBody.size();
+    m_responseEntityBody.resize(size + int(available));
+    const qint64 read = m_network->read(m_responseEntityBody.data() + size, available);
+    m_responseEntityBody.resize(size + int(qMax<qint64>(read, 0)));
+}
+
+void QQmlXMLHttpRequest::clearResponse()
+{
+    m_responseEntityBody = QByteArray();
+    m_responseText = QString();
+    m_decodedLength = 0;
+    m_textCodec = 0;
+#ifndef QT_NO_TEXTCODEC
+    delete m_textDecoder;
+    m_textDecoder = 0;
+#endif
+    m_response.clear();
+}
+
+/*
+    Returns the response body decoded as text.
+
+    The decoded text is kept and only data which has arrived since the last call is decoded, so
+    reading responseText repeatedly while the response is loading doesn't decode all of it every
+    time.
+*/
 QString QQmlXMLHttpRequest::responseBody()
 {
+    if (m_decodedLength == m_responseEntityBody.size())
+        return m_responseText;
+
 #ifndef QT_NO_TEXTCODEC
-    if (!m_textCodec)
-        m_textCodec = findTextCodec();
-    if (m_textCodec)
-        return m_textCodec->toUnicode(m_responseEntityBody);
+    if (!m_textDecoder) {
+        if (!m_textCodec)
+            m_textCodec = findTextCodec();
+        if (m_textCodec)
+            m_textDecoder = m_textCodec->makeDecoder();
+    }
+    if (m_textDecoder) {
+        m_responseText += m_textDecoder->toUnicode(
+                m_responseEntityBody.constData() + m_decodedLength,
+                m_responseEntityBody.size() - m_decodedLength);
+        m_decodedLength = m_responseEntityBody.size();
+        return m_responseText;
+    }
 #endif
 
-    return QString::fromUtf8(m_responseEntityBody);
+    m_responseText = QString::fromUtf8(m_responseEntityBody);
+    m_decodedLength = m_responseEntityBody.size();
+    return m_responseText;
 }
 
 const QByteArray &QQmlXMLHttpRequest::rawResponseBody() const
@@ -1540,6 +1840,26 @@ const QByteArray &QQmlXMLHttpRequest::rawResponseBody() const
     return m_responseEntityBody;
 }
 
+QString QQmlXMLHttpRequest::responseType() const
+{
+    return m_responseType;
+}
+
+void QQmlXMLHttpRequest::setResponseType(const QString &type)
+{
+    m_responseType = type;
+}
+
+ReturnedValue QQmlXMLHttpRequest::cachedResponse() const
+{
+    return m_response.value();
+}
+
+void QQmlXMLHttpRequest::setCachedResponse(const ValueRef response)
+{
+    m_response = response;
+}
+
 void QQmlXMLHttpRequest::dispatchCallbackImpl(const ValueRef me)
 {
     ExecutionContext *ctx = v4->currentContext();
@@ -1691,6 +2011,9 @@ struct QQmlXMLHttpRequestCtor : public FunctionObject
     static ReturnedValue method_get_statusText(CallContext *ctx);
     static ReturnedValue method_get_responseText(CallContext *ctx);
     static ReturnedValue method_get_responseXML(CallContext *ctx);
+    static ReturnedValue method_get_responseType(CallContext *ctx);
+    static ReturnedValue method_set_responseType(CallContext *ctx);
+    static ReturnedValue method_get_response(CallContext *ctx);
 
 
     Object *proto;
@@ -1719,6 +2042,10 @@ void QQmlXMLHttpRequestCtor::setupProto()
     proto->defineAccessorProperty(QStringLiteral("statusText"),method_get_statusText, 0);
     proto->defineAccessorProperty(QStringLiteral("responseText"),method_get_responseText, 0);
     proto->defineAccessorProperty(QStringLiteral("responseXML"),method_get_responseXML, 0);
+    proto->defineAccessorProperty(QStringLiteral("response"),method_get_response, 0);
+
+    // Read-write properties
+    proto->defineAccessorProperty(QStringLiteral("responseType"),method_get_responseType, method_set_responseType);
 
     // State values
     proto->defineReadonlyProperty(QStringLiteral("UNSENT"), Primitive::fromInt32(0));
@@ -1963,6 +2290,9 @@ ReturnedValue QQmlXMLHttpRequestCtor::method_get_responseText(CallContext *ctx)
 
     QV8Engine *engine = ctx->engine->v8Engine;
 
+    if (!r->responseType().isEmpty() && r->responseType() != QLatin1String("text"))
+        V4THROW_DOM(DOMEXCEPTION_INVALID_STATE_ERR, "Invalid state");
+
     if (r->readyState() != QQmlXMLHttpRequest::Loading &&
         r->readyState() != QQmlXMLHttpRequest::Done)
         return engine->toString(QString());
@@ -1978,6 +2308,9 @@ ReturnedValue QQmlXMLHttpRequestCtor::method_get_responseXML(CallContext *ctx)
         V4THROW_REFERENCE("Not an XMLHttpRequest object");
     QQmlXMLHttpRequest *r = w->request;
 
+    if (!r->responseType().isEmpty())
+        V4THROW_DOM(DOMEXCEPTION_INVALID_STATE_ERR, "Invalid state");
+
     if (!r->receivedXml() ||
         (r->readyState() != QQmlXMLHttpRequest::Loading &&
          r->readyState() != QQmlXMLHttpRequest::Done)) {
@@ -1987,6 +2320,85 @@ ReturnedValue QQmlXMLHttpRequestCtor::method_get_responseXML(CallContext *ctx)
     }
 }
 
+ReturnedValue QQmlXMLHttpRequestCtor::method_get_responseType(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<QQmlXMLHttpRequestWrapper> w(scope, ctx->callData->thisObject.as<QQmlXMLHttpRequestWrapper>());
+    if (!w)
+        V4THROW_REFERENCE("Not an XMLHttpRequest object");
+    QQmlXMLHttpRequest *r = w->request;
+
+    return ctx->engine->v8Engine->toString(r->responseType());
+}
+
+ReturnedValue QQmlXMLHttpRequestCtor::method_set_responseType(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<QQmlXMLHttpRequestWrapper> w(scope, ctx->callData->thisObject.as<QQmlXMLHttpRequestWrapper>());
+    if (!w)
+        V4THROW_REFERENCE("Not an XMLHttpRequest object");
+    QQmlXMLHttpRequest *r = w->request;
+
+    if (ctx->callData->argc < 1)
+        V4THROW_DOM(DOMEXCEPTION_SYNTAX_ERR, "Incorrect argument count");
+
+    if (r->readyState() == QQmlXMLHttpRequest::Loading ||
+        r->readyState() == QQmlXMLHttpRequest::Done)
+        V4THROW_DOM(DOMEXCEPTION_INVALID_STATE_ERR, "Invalid state");
+
+    // Unsupported types are ignored, as specified.
+    const QString type = ctx->callData->args[0].toQStringNoThrow();
+    if (type.isEmpty()
+            || type == QLatin1String("text")
+            || type == QLatin1String("arraybuffer")
+            || type == QLatin1String("json")) {
+        r->setResponseType(type);
+    }
+    return Encode::undefined();
+}
+
+/*
+    Returns the response as an object of the type selected by responseType.
+
+    An "arraybuffer" response shares the received bytes rather than copying them, and a "json"
+    response is parsed directly from the received bytes.  Both are only created once the request
+    is done and the same object is returned on subsequent reads.
+*/
+ReturnedValue QQmlXMLHttpRequestCtor::method_get_response(CallContext *ctx)
+{
+    Scope scope(ctx);
+    Scoped<QQmlXMLHttpRequestWrapper> w(scope, ctx->callData->thisObject.as<QQmlXMLHttpRequestWrapper>());
+    if (!w)
+        V4THROW_REFERENCE("Not an XMLHttpRequest object");
+    QQmlXMLHttpRequest *r = w->request;
+
+    const QString type = r->responseType();
+    if (type.isEmpty() || type == QLatin1String("text")) {
+        if (r->readyState() != QQmlXMLHttpRequest::Loading &&
+            r->readyState() != QQmlXMLHttpRequest::Done)
+            return ctx->engine->v8Engine->toString(QString());
+        return ctx->engine->v8Engine->toString(r->responseBody());
+    }
+
+    if (r->readyState() != QQmlXMLHttpRequest::Done || r->errorFlag())
+        return Encode::null();
+
+    ScopedValue response(scope, r->cachedResponse());
+    if (!response->isUndefined())
+        return response.asReturnedValue();
+
+    if (type == QLatin1String("arraybuffer")) {
+        response = ctx->engine->newArrayBuffer(r->rawResponseBody());
+    } else {
+        QJsonParseError error;
+        response = JsonObject::fromJson(ctx->engine, r->rawResponseBody(), &error);
+        if (error.error != QJsonParseError::NoError)
+            response = Primitive::nullValue();
+    }
+    r->setCachedResponse(response);
+    return response.asReturnedValue();
+}
+
 void qt_rem_qmlxmlhttprequest(QV8Engine * /* engine */, void *d)
 {
     QQmlXMLHttpRequestData *data = (QQmlXMLHttpRequestData *)d;
@@ -231,7 +231,7 @@ QQmlDelegateModel::~QQmlDelegateModel()
 {
     Q_D(QQmlDelegateModel);
 
-    foreach (QQmlDelegateModelItem *cacheItem, d->m_cache) {
+    foreach (QQmlDelegateModelItem *cacheItem, d->m_cache + d->m_reusableItemsPool) {
         if (cacheItem->object) {
             delete cacheItem->object;
 
@@ -343,6 +343,9 @@ void QQmlDelegateModel::setModel(const QVariant &model)
     if (d->m_complete)
         _q_itemsRemoved(0, d->m_count);
 
+    // Pooled items belong to the data type of the previous model
+    d->drainReusableItemsPool(0);
+
     d->m_adaptorModel.setModel(model, this, d->m_context->engine());
     d->m_adaptorModel.replaceWatchedRoles(QList<QByteArray>(), d->m_watchedRoles);
     for (int i = 0; d->m_parts && i < d->m_parts->models.count(); ++i) {
@@ -380,6 +383,7 @@ void QQmlDelegateModel::setDelegate(QQmlComponent *delegate)
     bool wasValid = d->m_delegate != 0;
     d->m_delegate = delegate;
     d->m_delegateValidated = false;
+    d->drainReusableItemsPool(0);
     if (wasValid && d->m_complete) {
         for (int i = 1; i < d->m_groupCount; ++i) {
             QQmlDelegateModelGroupPrivate::get(d->m_groups[i])->changeSet.remove(
@@ -455,6 +459,40 @@ void QQmlDelegateModel::setRootIndex(const QVariant &root)
     }
 }
 
+/*!
+    \qmlproperty bool QtQml.Models::DelegateModel::cacheItemData
+
+    This property holds whether role values read from a QAbstractItemModel are cached by the
+    delegate items.
+
+    By default every read of a role by a delegate binding calls QAbstractItemModel::data().  If
+    this property is true the value returned is kept with the item until the model emits
+    dataChanged() for the role, so re-evaluated bindings don't re-enter models which are
+    expensive to query.
+
+    Independent of this property, if the model has a slot or invokable method with the signature
+    \c {prefetchRows(QModelIndex parent, int first, int last)} it is called with blocks of rows
+    ahead of those that delegates are being created for, allowing the model to fetch the rows
+    from its backing store together.  While a view is flicking it is also called with the rows
+    the flick is heading towards.
+
+    This property only affects models of type QAbstractItemModel.  The default value is false.
+*/
+bool QQmlDelegateModel::cacheItemData() const
+{
+    Q_D(const QQmlDelegateModel);
+    return d->m_adaptorModel.cacheItemData;
+}
+
+void QQmlDelegateModel::setCacheItemData(bool cache)
+{
+    Q_D(QQmlDelegateModel);
+    if (d->m_adaptorModel.cacheItemData != cache) {
+        d->m_adaptorModel.cacheItemData = cache;
+        emit cacheItemDataChanged();
+    }
+}
+
 /*!
     \qmlmethod QModelIndex QtQml.Models::DelegateModel::modelIndex(int index)
 
@@ -503,7 +541,7 @@ int QQmlDelegateModel::count() const
     return d->m_compositor.count(d->m_compositorGroup);
 }
 
-QQmlDelegateModel::ReleaseFlags QQmlDelegateModelPrivate::release(QObject *object)
+QQmlDelegateModel::ReleaseFlags QQmlDelegateModelPrivate::release(QObject *object, QQmlInstanceModel::ReusableFlag reusableFlag)
 {
     QQmlDelegateModel::ReleaseFlags stat = 0;
     if (!object)
@@ -511,6 +549,9 @@ QQmlDelegateModel::ReleaseFlags QQmlDelegateModelPrivate::release(QObject *objec
 
     if (QQmlDelegateModelItem *cacheItem = QQmlDelegateModelItem::dataForObject(object)) {
         if (cacheItem->releaseObject()) {
+            if (reusableFlag == QQmlInstanceModel::Reusable && addToReusableItemsPool(cacheItem))
+                return QQmlInstanceModel::Pooled;
+
             cacheItem->destroyObject();
             emitDestroyingItem(object);
             if (cacheItem->incubationTask) {
@@ -526,17 +567,125 @@ QQmlDelegateModel::ReleaseFlags QQmlDelegateModelPrivate::release(QObject *objec
     return stat;
 }
 
+/*
+  Moves a released item into the reuse pool, detaching it from the cache so it no
+  longer tracks a model index.  Items referenced from script, still incubating or
+  instantiated from a Package are not pooled.
+*/
+bool QQmlDelegateModelPrivate::addToReusableItemsPool(QQmlDelegateModelItem *cacheItem)
+{
+    if (!cacheItem->isReusable()
+            || !cacheItem->object
+            || cacheItem->incubationTask
+            || cacheItem->scriptRef != 1
+            || (cacheItem->groups & Compositor::UnresolvedFlag)
+            || qmlobject_cast<QQuickPackage *>(cacheItem->object)) {
+        return false;
+    }
+
+    removeCacheItem(cacheItem);
+    cacheItem->poolTime = 0;
+    m_reusableItemsPool.append(cacheItem);
+
+    if (cacheItem->attached)
+        emit cacheItem->attached->pooled();
+    return true;
+}
+
+QQmlDelegateModelItem *QQmlDelegateModelPrivate::takeFromReusableItemsPool(Compositor::iterator it)
+{
+    if (m_reusableItemsPool.isEmpty())
+        return 0;
+
+    QQmlDelegateModelItem *cacheItem = m_reusableItemsPool.takeLast();
+    cacheItem->groups = it->flags;
+
+    m_cache.insert(it.cacheIndex, cacheItem);
+    m_compositor.setFlags(it, 1, Compositor::CacheFlag);
+    Q_ASSERT(m_cache.count() == m_compositor.count(Compositor::Cache));
+
+    cacheItem->reuse(m_adaptorModel, it.modelIndex());
+
+    if (QQmlDelegateModelAttached *attached = cacheItem->attached) {
+        for (int i = 1; i < m_groupCount; ++i)
+            attached->m_currentIndex[i] = it.index[i];
+        attached->emitChanges();
+        emit attached->reused();
+    }
+    return cacheItem;
+}
+
+void QQmlDelegateModelPrivate::destroyPooledItem(QQmlDelegateModelItem *cacheItem)
+{
+    QObject *object = cacheItem->object;
+    cacheItem->destroyObject();
+    emitDestroyingItem(object);
+    cacheItem->Dispose();
+}
+
+/*
+  Destroys the pooled items that have not been reused within \a maxPoolTime calls.
+*/
+void QQmlDelegateModelPrivate::drainReusableItemsPool(int maxPoolTime)
+{
+    for (int i = 0; i < m_reusableItemsPool.count();) {
+        QQmlDelegateModelItem *cacheItem = m_reusableItemsPool.at(i);
+        if (++cacheItem->poolTime <= maxPoolTime) {
+            ++i;
+            continue;
+        }
+        m_reusableItemsPool.removeAt(i);
+        destroyPooledItem(cacheItem);
+    }
+}
+
 /*
   Returns ReleaseStatus flags.
+
+  If \a reusableFlag is Reusable the delegate instance may be kept in a pool instead
+  of being destroyed, and handed out again by a later call to object() for another
+  index.  In that case Pooled is returned.
 */
 
-QQmlDelegateModel::ReleaseFlags QQmlDelegateModel::release(QObject *item)
+QQmlDelegateModel::ReleaseFlags QQmlDelegateModel::release(QObject *item, ReusableFlag reusableFlag)
 {
     Q_D(QQmlDelegateModel);
-    QQmlInstanceModel::ReleaseFlags stat = d->release(item);
+    QQmlInstanceModel::ReleaseFlags stat = d->release(item, reusableFlag);
     return stat;
 }
 
+void QQmlDelegateModel::drainReusableItemsPool(int maxPoolTime)
+{
+    Q_D(QQmlDelegateModel);
+    d->drainReusableItemsPool(maxPoolTime);
+}
+
+/*
+    Hints that the items from \a first to \a last are likely to be requested soon, so that
+    the model can fetch their data ahead of time.
+*/
+void QQmlDelegateModel::prefetch(int first, int last)
+{
+    Q_D(QQmlDelegateModel);
+    const int count = d->m_compositor.count(d->m_compositorGroup);
+    first = qMax(0, first);
+    last = qMin(count - 1, last);
+    if (!d->m_delegate || first > last)
+        return;
+
+    Compositor::iterator firstIt = d->m_compositor.find(d->m_compositorGroup, first);
+    Compositor::iterator lastIt = d->m_compositor.find(d->m_compositorGroup, last);
+    // Only model rows can be fetched, not items inserted into the groups directly.
+    if (firstIt.list<QQmlAdaptorModel>() && lastIt.list<QQmlAdaptorModel>())
+        d->m_adaptorModel.prefetch(firstIt.modelIndex(), lastIt.modelIndex());
+}
+
+int QQmlDelegateModel::poolSize()
+{
+    Q_D(QQmlDelegateModel);
+    return d->m_reusableItemsPool.count();
+}
+
 // Cancel a requested async item
 void QQmlDelegateModel::cancel(int index)
 {
@@ -911,6 +1060,9 @@ QObject *QQmlDelegateModelPrivate::object(Compositor::Group group, int index, bo
 
     QQmlDelegateModelItem *cacheItem = it->inCache() ? m_cache.at(it.cacheIndex) : 0;
 
+    if (!cacheItem)
+        cacheItem = takeFromReusableItemsPool(it);
+
     if (!cacheItem) {
         cacheItem = m_adaptorModel.createItem(m_cacheMetaType, m_context->engine(), it.modelIndex());
         if (!cacheItem)
@@ -941,6 +1093,9 @@ QObject *QQmlDelegateModelPrivate::object(Compositor::Group group, int index, bo
         cacheItem->incubationTask = new QQDMIncubationTask(this, asynchronous ? QQmlIncubator::Asynchronous : QQmlIncubator::AsynchronousIfNested);
         cacheItem->incubationTask->incubating = cacheItem;
         cacheItem->incubationTask->clear();
+        // Asynchronous requests come from views filling their cache buffer; delegates
+        // that are about to become visible take precedence over them.
+        QQmlIncubatorPrivate::get(cacheItem->incubationTask)->preload = asynchronous;
 
         for (int i = 1; i < m_groupCount; ++i)
             cacheItem->incubationTask->index[i] = it.index[i];
@@ -1885,6 +2040,7 @@ QQmlDelegateModelItem::QQmlDelegateModelItem(
     , scriptRef(0)
     , groups(0)
     , index(modelIndex)
+    , poolTime(0)
 {
     metaType->addref();
 }
@@ -2153,6 +2309,27 @@ bool QQmlDelegateModelAttached::isUnresolved() const
     return m_cacheItem->groups & Compositor::UnresolvedFlag;
 }
 
+/*!
+    \qmlattachedsignal QtQml.Models::DelegateModel::pooled()
+
+    This signal is emitted after a delegate instance has been released by a view
+    that reuses its delegates, such as a ListView with \l {ListView::}{reuseItems}
+    set, and added to the reuse pool instead of being destroyed.
+
+    It is attached to each instance of the delegate.
+*/
+
+/*!
+    \qmlattachedsignal QtQml.Models::DelegateModel::reused()
+
+    This signal is emitted after a pooled delegate instance has been taken from
+    the reuse pool and assigned to a new model item.  The \c index and model role
+    properties already refer to the new item; a handler can be used to reset any
+    other state the delegate holds.
+
+    It is attached to each instance of the delegate.
+*/
+
 /*!
     \qmlattachedproperty int QtQml.Models::DelegateModel::inItems
 
@@ -3144,7 +3321,7 @@ QObject *QQmlPartsModel::object(int index, bool asynchronous)
     return 0;
 }
 
-QQmlInstanceModel::ReleaseFlags QQmlPartsModel::release(QObject *item)
+QQmlInstanceModel::ReleaseFlags QQmlPartsModel::release(QObject *item, ReusableFlag)
 {
     QQmlInstanceModel::ReleaseFlags flags = 0;
 
@@ -78,6 +78,7 @@ class Q_QML_PRIVATE_EXPORT QQmlDelegateModel : public QQmlInstanceModel, public
     Q_PROPERTY(QQmlListProperty<QQmlDelegateModelGroup> groups READ groups CONSTANT)
     Q_PROPERTY(QObject *parts READ parts CONSTANT)
     Q_PROPERTY(QVariant rootIndex READ rootIndex WRITE setRootIndex NOTIFY rootIndexChanged)
+    Q_PROPERTY(bool cacheItemData READ cacheItemData WRITE setCacheItemData NOTIFY cacheItemDataChanged)
     Q_CLASSINFO("DefaultProperty", "delegate")
     Q_INTERFACES(QQmlParserStatus)
 public:
@@ -97,14 +98,20 @@ public:
     QVariant rootIndex() const;
     void setRootIndex(const QVariant &root);
 
+    bool cacheItemData() const;
+    void setCacheItemData(bool cache);
+
     Q_INVOKABLE QVariant modelIndex(int idx) const;
     Q_INVOKABLE QVariant parentModelIndex() const;
 
     int count() const;
     bool isValid() const { return delegate() != 0; }
     QObject *object(int index, bool asynchronous=false);
-    ReleaseFlags release(QObject *object);
+    ReleaseFlags release(QObject *object, ReusableFlag reusableFlag = NotReusable);
     void cancel(int index);
+    void drainReusableItemsPool(int maxPoolTime);
+    void prefetch(int first, int last);
+    int poolSize();
     virtual QString stringValue(int index, const QString &role);
     virtual void setWatchedRoles(QList<QByteArray> roles);
 
@@ -127,6 +134,7 @@ Q_SIGNALS:
     void filterGroupChanged();
     void defaultGroupsChanged();
     void rootIndexChanged();
+    void cacheItemDataChanged();
 
 private Q_SLOTS:
     void _q_itemsChanged(int index, int count, const QVector<int> &roles);
@@ -218,6 +226,8 @@ public:
 Q_SIGNALS:
     void groupsChanged();
     void unresolvedChanged();
+    void pooled();
+    void reused();
 
 public:
     QQmlDelegateModelItem *m_cacheItem;
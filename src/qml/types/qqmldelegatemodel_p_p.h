@@ -133,6 +133,11 @@ public:
     virtual void setValue(const QString &role, const QVariant &value) { Q_UNUSED(role); Q_UNUSED(value); }
     virtual bool resolveIndex(const QQmlAdaptorModel &, int) { return false; }
 
+    // Items whose data is looked up by index can be handed a new index instead of
+    // having their delegate recreated
+    virtual bool isReusable() const { return false; }
+    virtual void reuse(const QQmlAdaptorModel &, int idx) { setModelIndex(idx); }
+
     static QV4::ReturnedValue get_model(QV4::CallContext *ctx);
     static QV4::ReturnedValue get_groups(QV4::CallContext *ctx);
     static QV4::ReturnedValue set_groups(QV4::CallContext *ctx);
@@ -150,6 +155,7 @@ public:
     int scriptRef;
     int groups;
     int index;
+    int poolTime;
 
 
 Q_SIGNALS:
@@ -255,7 +261,11 @@ public:
     void connectModel(QQmlAdaptorModel *model);
 
     QObject *object(Compositor::Group group, int index, bool asynchronous);
-    QQmlDelegateModel::ReleaseFlags release(QObject *object);
+    QQmlDelegateModel::ReleaseFlags release(QObject *object, QQmlInstanceModel::ReusableFlag reusableFlag = QQmlInstanceModel::NotReusable);
+    bool addToReusableItemsPool(QQmlDelegateModelItem *cacheItem);
+    QQmlDelegateModelItem *takeFromReusableItemsPool(Compositor::iterator it);
+    void destroyPooledItem(QQmlDelegateModelItem *cacheItem);
+    void drainReusableItemsPool(int maxPoolTime);
     QString stringValue(Compositor::Group group, int index, const QString &name);
     void emitCreatedPackage(QQDMIncubationTask *incubationTask, QQuickPackage *package);
     void emitInitPackage(QQDMIncubationTask *incubationTask, QQuickPackage *package);
@@ -308,6 +318,7 @@ public:
     QQmlDelegateModelGroupEmitterList m_pendingParts;
 
     QList<QQmlDelegateModelItem *> m_cache;
+    QList<QQmlDelegateModelItem *> m_reusableItemsPool;
     QList<QQDMIncubationTask *> m_finishedIncubating;
     QList<QByteArray> m_watchedRoles;
 
@@ -352,7 +363,7 @@ public:
     int count() const;
     bool isValid() const;
     QObject *object(int index, bool asynchronous=false);
-    ReleaseFlags release(QObject *item);
+    ReleaseFlags release(QObject *item, ReusableFlag reusableFlag = NotReusable);
     QString stringValue(int index, const QString &role);
     QList<QByteArray> watchedRoles() const { return m_watchedRoles; }
     void setWatchedRoles(QList<QByteArray> roles);
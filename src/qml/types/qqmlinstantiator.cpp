@@ -76,8 +76,11 @@ void QQmlInstantiatorPrivate::clear()
         return;
 
     for (int i=0; i < objects.count(); i++) {
-        q->objectRemoved(i, objects[i]);
-        instanceModel->release(objects[i]);
+        QObject *object = objects.at(i);
+        if (!object) // still incubating, or destroyed by someone else
+            continue;
+        q->objectRemoved(i, object);
+        instanceModel->release(object);
     }
     objects.clear();
     q->objectChanged();
@@ -99,7 +102,12 @@ void QQmlInstantiatorPrivate::regenerate()
         return;
     }
 
-    for (int i = 0; i < instanceModel->count(); i++) {
+    // Reserve a slot for every row up front, so that objects incubated
+    // asynchronously can be stored at their index in whatever order they
+    // complete. Slots stay null until their object has been created.
+    const int count = instanceModel->count();
+    objects.resize(count);
+    for (int i = 0; i < count; i++) {
         QObject *object = instanceModel->object(i, async);
         // If the item was already created we won't get a createdItem
         if (object)
@@ -112,11 +120,18 @@ void QQmlInstantiatorPrivate::regenerate()
 void QQmlInstantiatorPrivate::_q_createdItem(int idx, QObject* item)
 {
     Q_Q(QQmlInstantiator);
-    if (objects.contains(item)) //Case when it was created synchronously in regenerate
+    if (idx < 0 || idx >= objects.count())
         return;
+    if (objects.at(idx) == item) //Case when it was created synchronously in regenerate
+        return;
+    if (objects.at(idx)) {
+        // An incubation that was overtaken by a model change
+        instanceModel->release(item);
+        return;
+    }
     item->setParent(q);
-    objects.insert(idx, item);
-    if (objects.count() == 1)
+    objects[idx] = item;
+    if (idx == 0)
         q->objectChanged();
     q->objectAdded(idx, item);
 }
@@ -148,9 +163,10 @@ void QQmlInstantiatorPrivate::_q_modelUpdated(const QQmlChangeSet &changeSet, bo
         } else while (count--) {
             QObject *obj = objects.at(index);
             objects.remove(index);
-            q->objectRemoved(index, obj);
-            if (obj)
+            if (obj) {
+                q->objectRemoved(index, obj);
                 instanceModel->release(obj);
+            }
         }
 
         difference -= remove.count;
@@ -161,11 +177,14 @@ void QQmlInstantiatorPrivate::_q_modelUpdated(const QQmlChangeSet &changeSet, bo
         if (insert.isMove()) {
             QVector<QPointer<QObject> > movedObjects = moved.value(insert.moveId);
             objects = objects.mid(0, index) + movedObjects + objects.mid(index);
-        } else for (int i = 0; i < insert.count; ++i) {
-            int modelIndex = index + i;
-            QObject* obj = instanceModel->object(modelIndex, async);
-            if (obj)
-                _q_createdItem(modelIndex, obj);
+        } else {
+            objects.insert(index, insert.count, QPointer<QObject>());
+            for (int i = 0; i < insert.count; ++i) {
+                int modelIndex = index + i;
+                QObject* obj = instanceModel->object(modelIndex, async);
+                if (obj)
+                    _q_createdItem(modelIndex, obj);
+            }
         }
         difference += insert.count;
     }
@@ -265,7 +284,14 @@ void QQmlInstantiator::setActive(bool newVal)
     asynchronously. This means that objects may not be available immediately,
     even if active is set to true.
 
-    You can use the objectAdded signal to respond to items being created.
+    Asynchronous objects are incubated by the engine's incubation controller,
+    which spreads their creation over several frames, so that large models
+    don't block the user interface while they are being populated. Without an
+    incubation controller objects are created synchronously.
+
+    The \l count already includes objects that are still being created, and
+    objectAt() returns null for them until they are ready. You can use the
+    objectAdded signal to respond to items being created.
 
     Default is false.
 */
@@ -289,6 +315,9 @@ void QQmlInstantiator::setAsync(bool newVal)
     \qmlproperty int QtQml::Instantiator::count
 
     The number of objects the Instantiator is currently managing.
+
+    When \l asynchronous is true, this includes the objects which are still
+    being created.
 */
 
 int QQmlInstantiator::count() const
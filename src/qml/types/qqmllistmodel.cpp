@@ -328,6 +328,112 @@ void ListModel::sync(ListModel *src, ListModel *target, QHash<int, ListModel *>
     }
 }
 
+bool ListModel::syncChanges(ListModel *src, ListModel *target, const QList<QQmlListModelWorkerAgent::Change> &changes)
+{
+    typedef QQmlListModelWorkerAgent::Change Change;
+
+    // Only changes made directly to this model can be replayed, anything
+    // touching a nested model needs a full sync
+    if (src->m_uid != target->m_uid)
+        return false;
+    for (int i=0 ; i < changes.count() ; ++i) {
+        if (changes.at(i).modelUid != src->m_uid)
+            return false;
+    }
+
+    // Replay the change log on a copy of the target element list, with
+    // null entries standing in for rows inserted by the worker. Nothing is
+    // modified until the result is known to match the source.
+    QVector<ListElement *> rows;
+    QVector<bool> dirty;
+    QVector<ListElement *> removed;
+    rows.reserve(target->elements.count());
+    for (int i=0 ; i < target->elements.count() ; ++i)
+        rows.append(target->elements.at(i));
+    dirty.fill(false, rows.count());
+
+    for (int i=0 ; i < changes.count() ; ++i) {
+        const Change &change = changes.at(i);
+        int index = change.index;
+        int count = change.count;
+
+        switch (change.type) {
+        case Change::Inserted:
+            if (index < 0 || index > rows.count())
+                return false;
+            rows.insert(index, count, 0);
+            dirty.insert(index, count, true);
+            break;
+        case Change::Removed:
+            if (index < 0 || index + count > rows.count())
+                return false;
+            for (int j=index ; j < index + count ; ++j) {
+                if (rows.at(j))
+                    removed.append(rows.at(j));
+            }
+            rows.remove(index, count);
+            dirty.remove(index, count);
+            break;
+        case Change::Moved: {
+            if (index < 0 || change.to < 0 || index + count > rows.count() || change.to + count > rows.count())
+                return false;
+            QVector<ListElement *> movedRows = rows.mid(index, count);
+            QVector<bool> movedDirty = dirty.mid(index, count);
+            rows.remove(index, count);
+            dirty.remove(index, count);
+            for (int j=0 ; j < count ; ++j) {
+                rows.insert(change.to + j, movedRows.at(j));
+                dirty.insert(change.to + j, movedDirty.at(j));
+            }
+            break;
+        }
+        case Change::Changed:
+            if (index < 0 || index + count > rows.count())
+                return false;
+            for (int j=index ; j < index + count ; ++j)
+                dirty[j] = true;
+            break;
+        }
+    }
+
+    if (rows.count() != src->elements.count())
+        return false;
+    for (int i=0 ; i < rows.count() ; ++i) {
+        if (rows.at(i) && rows.at(i)->getUid() != src->elements.at(i)->getUid())
+            return false;
+    }
+
+    ListLayout::sync(src->m_layout, target->m_layout);
+
+    for (int i=0 ; i < removed.count() ; ++i) {
+        removed.at(i)->destroy(target->m_layout);
+        delete removed.at(i);
+    }
+
+    // Only rows the worker touched are copied across
+    target->elements.clear();
+    target->elements.reserve(rows.count());
+    for (int i=0 ; i < rows.count() ; ++i) {
+        ListElement *srcElement = src->elements.at(i);
+        ListElement *targetElement = rows.at(i);
+        if (targetElement == 0)
+            targetElement = new ListElement(srcElement->getUid());
+        if (dirty.at(i))
+            ListElement::sync(srcElement, src->m_layout, targetElement, target->m_layout, 0);
+        target->elements.append(targetElement);
+    }
+
+    target->updateCacheIndices();
+
+    for (int i=0 ; i < target->elements.count() ; ++i) {
+        ListElement *e = target->elements[i];
+        if (dirty.at(i) && e->m_objectCache)
+            e->m_objectCache->updateValues();
+    }
+
+    return true;
+}
+
 ListModel::ListModel(ListLayout *layout, QQmlListModel *modelCache, int uid) : m_layout(layout), m_modelCache(modelCache)
 {
     if (uid == -1)
@@ -358,6 +464,17 @@ void ListModel::insertElement(int index)
     updateCacheIndices();
 }
 
+void ListModel::insertElements(int index, int count)
+{
+    elements.insertBlank(index, count);
+    for (int i=0 ; i < count ; ++i)
+        elements[index+i] = new ListElement;
+
+    // Appending leaves the indices of existing cached objects untouched
+    if (index + count < elements.count())
+        updateCacheIndices();
+}
+
 void ListModel::move(int from, int to, int n)
 {
     if (from > to) {
@@ -615,6 +732,42 @@ int ListModel::setOrCreateProperty(int elementIndex, const QString &key, const Q
     return roleIndex;
 }
 
+int ListModel::setColumn(int elementIndex, const QString &key, const QVariantList &values)
+{
+    // The role is resolved once for the whole column, from its first valid value
+    int first = 0;
+    while (first < values.count() && !values.at(first).isValid())
+        ++first;
+
+    int count = qMin(values.count(), elements.count() - elementIndex);
+    if (elementIndex < 0 || first >= count)
+        return -1;
+
+    const ListLayout::Role *r = m_layout->getRoleOrCreate(key, values.at(first));
+    if (!r)
+        return -1;
+
+    int roleIndex = -1;
+    QVector<int> roles;
+
+    for (int i=first ; i < count ; ++i) {
+        const QVariant &data = values.at(i);
+        if (!data.isValid())
+            continue;
+
+        ListElement *e = elements[elementIndex+i];
+        roleIndex = e->setVariantProperty(*r, data);
+
+        if (roleIndex != -1 && e->m_objectCache) {
+            roles.clear();
+            roles << roleIndex;
+            e->m_objectCache->updateValues(roles);
+        }
+    }
+
+    return roleIndex;
+}
+
 int ListModel::setExistingProperty(int elementIndex, const QString &key, const QV4::ValueRef data, QV8Engine *eng)
 {
     int roleIndex = -1;
@@ -1983,13 +2136,15 @@ void QQmlListModel::insert(QQmlV4Function *args)
 
             int objectArrayLength = objectArray->getLength();
             emitItemsAboutToBeInserted(index, objectArrayLength);
+            if (!m_dynamicRoles)
+                m_listModel->insertElements(index, objectArrayLength);
             for (int i=0 ; i < objectArrayLength ; ++i) {
                 argObject = objectArray->getIndexed(i);
 
                 if (m_dynamicRoles) {
                     m_modelObjects.insert(index+i, DynamicRoleModelNode::create(args->engine()->variantMapFromJS(argObject), this));
                 } else {
-                    m_listModel->insert(index+i, argObject, args->engine());
+                    m_listModel->set(index+i, argObject, args->engine());
                 }
             }
             emitItemsInserted(index, objectArrayLength);
@@ -2093,13 +2248,18 @@ void QQmlListModel::append(QQmlV4Function *args)
             int index = count();
             emitItemsAboutToBeInserted(index, objectArrayLength);
 
+            if (m_dynamicRoles)
+                m_modelObjects.reserve(index + objectArrayLength);
+            else
+                m_listModel->insertElements(index, objectArrayLength);
+
             for (int i=0 ; i < objectArrayLength ; ++i) {
                 argObject = objectArray->getIndexed(i);
 
                 if (m_dynamicRoles) {
                     m_modelObjects.append(DynamicRoleModelNode::create(args->engine()->variantMapFromJS(argObject), this));
                 } else {
-                    m_listModel->append(argObject, args->engine());
+                    m_listModel->set(index+i, argObject, args->engine());
                 }
             }
 
@@ -2126,6 +2286,117 @@ void QQmlListModel::append(QQmlV4Function *args)
     }
 }
 
+/*!
+    \qmlmethod ListModel::appendRows(list<string> roles, array rows)
+
+    Adds the rows in \a rows to the end of the list model. Each row is an
+    array holding one value per role, in the order given by \a roles.
+
+    \code
+        logModel.appendRows(["time", "level", "message"],
+                            [[1001, "info", "started"],
+                             [1002, "warning", "disk almost full"]])
+    \endcode
+
+    The roles are resolved once per column rather than once per item, and
+    the view is notified of all new rows at once, which makes this
+    considerably faster than append() for large data sets.
+
+    \sa appendColumns(), append()
+*/
+void QQmlListModel::appendRows(const QStringList &roles, const QVariantList &rows)
+{
+    QList<QVariantList> columns;
+    columns.reserve(roles.count());
+    for (int j=0 ; j < roles.count() ; ++j) {
+        columns.append(QVariantList());
+        columns.last().reserve(rows.count());
+    }
+
+    for (int i=0 ; i < rows.count() ; ++i) {
+        const QVariant &rowData = rows.at(i);
+        if (rowData.type() != QVariant::List) {
+            qmlInfo(this) << tr("appendRows: row %1 is not an array").arg(i);
+            return;
+        }
+
+        const QVariantList row = rowData.toList();
+        for (int j=0 ; j < roles.count() ; ++j)
+            columns[j].append(j < row.count() ? row.at(j) : QVariant());
+    }
+
+    appendColumnData(roles, columns, rows.count());
+}
+
+/*!
+    \qmlmethod ListModel::appendColumns(jsobject columns)
+
+    Adds items to the end of the list model from \a columns, which maps
+    each role name to an array of values, one per new item. All arrays
+    must have the same length.
+
+    \code
+        logModel.appendColumns({"time": [1001, 1002],
+                                "message": ["started", "disk almost full"]})
+    \endcode
+
+    \sa appendRows(), append()
+*/
+void QQmlListModel::appendColumns(const QVariantMap &columns)
+{
+    QStringList roles;
+    QList<QVariantList> columnData;
+    int rowCount = -1;
+
+    QVariantMap::const_iterator it = columns.constBegin();
+    for (; it != columns.constEnd() ; ++it) {
+        if (it.value().type() != QVariant::List) {
+            qmlInfo(this) << tr("appendColumns: column %1 is not an array").arg(it.key());
+            return;
+        }
+
+        const QVariantList column = it.value().toList();
+        if (rowCount != -1 && column.count() != rowCount) {
+            qmlInfo(this) << tr("appendColumns: columns differ in length");
+            return;
+        }
+
+        rowCount = column.count();
+        roles.append(it.key());
+        columnData.append(column);
+    }
+
+    appendColumnData(roles, columnData, rowCount);
+}
+
+void QQmlListModel::appendColumnData(const QStringList &roles, const QList<QVariantList> &columns, int rowCount)
+{
+    if (rowCount <= 0)
+        return;
+
+    int index = count();
+    emitItemsAboutToBeInserted(index, rowCount);
+
+    if (m_dynamicRoles) {
+        m_modelObjects.reserve(index + rowCount);
+        for (int i=0 ; i < rowCount ; ++i) {
+            QVariantMap row;
+            for (int j=0 ; j < roles.count() ; ++j) {
+                const QVariant &data = columns.at(j).at(i);
+                if (data.isValid())
+                    row.insert(roles.at(j), data);
+            }
+            m_modelObjects.append(DynamicRoleModelNode::create(row, this));
+        }
+    } else {
+        m_listModel->insertElements(index, rowCount);
+        for (int j=0 ; j < roles.count() ; ++j)
+            m_listModel->setColumn(index, roles.at(j), columns.at(j));
+    }
+
+    emitItemsInserted(index, rowCount);
+}
+
 /*!
     \qmlmethod object ListModel::get(int index)
 
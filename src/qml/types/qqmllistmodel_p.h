@@ -84,6 +84,8 @@ public:
     Q_INVOKABLE void remove(QQmlV4Function *args);
     Q_INVOKABLE void append(QQmlV4Function *args);
     Q_INVOKABLE void insert(QQmlV4Function *args);
+    Q_INVOKABLE void appendRows(const QStringList &roles, const QVariantList &rows);
+    Q_INVOKABLE void appendColumns(const QVariantMap &columns);
     Q_INVOKABLE QQmlV4Handle get(int index) const;
     Q_INVOKABLE void set(int index, const QQmlV4Handle &);
     Q_INVOKABLE void setProperty(int index, const QString& property, const QVariant& value);
@@ -114,6 +116,8 @@ private:
 
     QV8Engine *engine() const;
 
+    void appendColumnData(const QStringList &roles, const QList<QVariantList> &columns, int rowCount);
+
     inline bool canMove(int from, int to, int n) const { return !(from+n > count() || to+n > count() || from < 0 || to < 0 || n < 0); }
 
     QQmlListModelWorkerAgent *m_agent;
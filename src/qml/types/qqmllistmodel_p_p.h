@@ -54,6 +54,7 @@
 //
 
 #include "qqmllistmodel_p.h"
+#include "qqmllistmodelworkeragent_p.h"
 #include <private/qqmlengine_p.h>
 #include <private/qqmlopenmetaobject_p.h>
 #include <qqml.h>
@@ -308,6 +309,7 @@ public:
     void destroy();
 
     int setOrCreateProperty(int elementIndex, const QString &key, const QVariant &data);
+    int setColumn(int elementIndex, const QString &key, const QVariantList &values);
     int setExistingProperty(int uid, const QString &key, const QV4::ValueRef data, QV8Engine *eng);
 
     QVariant getProperty(int elementIndex, int roleIndex, const QQmlListModel *owner, QV8Engine *eng);
@@ -344,12 +346,14 @@ public:
 
     int appendElement();
     void insertElement(int index);
+    void insertElements(int index, int count);
 
     void move(int from, int to, int n);
 
     int getUid() const { return m_uid; }
 
     static void sync(ListModel *src, ListModel *target, QHash<int, ListModel *> *srcModelHash);
+    static bool syncChanges(ListModel *src, ListModel *target, const QList<QQmlListModelWorkerAgent::Change> &changes);
 
     ModelObject *getOrCreateModelObject(QQmlListModel *model, int elementIndex);
 
@@ -197,6 +197,8 @@ bool QQmlListModelWorkerAgent::event(QEvent *e)
             Q_ASSERT(m_orig->m_dynamicRoles == s->list->m_dynamicRoles);
             if (m_orig->m_dynamicRoles)
                 QQmlListModel::sync(s->list, m_orig, &targetModelDynamicHash);
+            else if (ListModel::syncChanges(s->list->m_listModel, m_orig->m_listModel, changes))
+                targetModelStaticHash.insert(m_orig->m_listModel->getUid(), m_orig->m_listModel);
             else
                 ListModel::sync(s->list->m_listModel, m_orig->m_listModel, &targetModelStaticHash);
 
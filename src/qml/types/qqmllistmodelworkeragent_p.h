@@ -113,6 +113,7 @@ protected:
 private:
     friend class QQuickWorkerScriptEnginePrivate;
     friend class QQmlListModel;
+    friend class ListModel;
 
     struct Change
     {
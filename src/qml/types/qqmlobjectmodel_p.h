@@ -60,14 +60,18 @@ class Q_QML_PRIVATE_EXPORT QQmlInstanceModel : public QObject
 public:
     virtual ~QQmlInstanceModel() {}
 
-    enum ReleaseFlag { Referenced = 0x01, Destroyed = 0x02 };
+    enum ReleaseFlag { Referenced = 0x01, Destroyed = 0x02, Pooled = 0x04 };
     Q_DECLARE_FLAGS(ReleaseFlags, ReleaseFlag)
+    enum ReusableFlag { NotReusable, Reusable };
 
     virtual int count() const = 0;
     virtual bool isValid() const = 0;
     virtual QObject *object(int index, bool asynchronous=false) = 0;
-    virtual ReleaseFlags release(QObject *object) = 0;
+    virtual ReleaseFlags release(QObject *object, ReusableFlag reusableFlag = NotReusable) = 0;
     virtual void cancel(int) {}
+    virtual void drainReusableItemsPool(int maxPoolTime) { Q_UNUSED(maxPoolTime); }
+    virtual int poolSize() { return 0; }
+    virtual void prefetch(int first, int last) { Q_UNUSED(first); Q_UNUSED(last); }
     virtual QString stringValue(int, const QString &) = 0;
     virtual void setWatchedRoles(QList<QByteArray> roles) = 0;
 
@@ -105,7 +109,7 @@ public:
     virtual int count() const;
     virtual bool isValid() const;
     virtual QObject *object(int index, bool asynchronous=false);
-    virtual ReleaseFlags release(QObject *object);
+    virtual ReleaseFlags release(QObject *object, ReusableFlag reusableFlag = NotReusable);
     virtual QString stringValue(int index, const QString &role);
     virtual void setWatchedRoles(QList<QByteArray>) {}
 
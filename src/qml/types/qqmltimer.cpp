@@ -42,11 +42,15 @@
 #include "qqmltimer_p.h"
 
 #include <QtCore/qcoreapplication.h>
+#include <QtCore/qmap.h>
+#include <QtCore/qthreadstorage.h>
 #include "private/qpauseanimationjob_p.h"
 #include <qdebug.h>
 
 #include <private/qobject_p.h>
 
+#include <limits.h>
+
 QT_BEGIN_NAMESPACE
 
 namespace {
@@ -54,16 +58,55 @@ namespace {
     const QEvent::Type QEvent_Triggered = QEvent::Type(QEvent::User + 2);
 }
 
-class QQmlTimerPrivate : public QObjectPrivate, public QAnimationJobChangeListener
+class QQmlTimerPrivate;
+
+/*
+    All running timers of a thread share a single pause animation job, so
+    that the animation timer only tracks one animation no matter how many
+    timers there are.  The timers are kept ordered by their deadline; the
+    job's duration is set to the time until the closest one, so that the
+    animation timer can sleep until then, and a tick only visits the timers
+    that have expired.
+
+    The queue time is the job's current time plus a base, which is advanced
+    whenever the job is rewound to keep the duration in sync with the
+    closest deadline.
+*/
+class QQmlTimerQueue : public QPauseAnimationJob
+{
+public:
+    QQmlTimerQueue();
+    ~QQmlTimerQueue();
+
+    static QQmlTimerQueue *instance();
+
+    qint64 now() const { return base + currentTime(); }
+
+    void add(QQmlTimerPrivate *timer, qint64 deadline);
+    void remove(QQmlTimerPrivate *timer);
+
+protected:
+    void updateCurrentTime(int);
+
+private:
+    void rewind();
+
+    QMultiMap<qint64, QQmlTimerPrivate *> timers;
+    qint64 base;
+};
+
+Q_GLOBAL_STATIC(QThreadStorage<QQmlTimerQueue *>, timerQueue)
+
+class QQmlTimerPrivate : public QObjectPrivate
 {
     Q_DECLARE_PUBLIC(QQmlTimer)
 public:
     QQmlTimerPrivate()
-        : interval(1000), running(false), repeating(false), triggeredOnStart(false)
-        , classBegun(false), componentComplete(false), firstTick(true), awaitingTick(false) {}
-
-    virtual void animationFinished(QAbstractAnimationJob *);
-    virtual void animationCurrentLoopChanged(QAbstractAnimationJob *)  { maybeTick(); }
+        : interval(1000), queue(0), startTime(0), deadline(0)
+        , running(false), repeating(false), triggeredOnStart(false)
+        , classBegun(false), componentComplete(false), firstTick(true), awaitingTick(false)
+        , scheduled(false) {}
+    ~QQmlTimerPrivate() { unschedule(); }
 
     void maybeTick() {
         Q_Q(QQmlTimer);
@@ -73,8 +116,15 @@ public:
         }
     }
 
+    void schedule();
+    void unschedule();
+    void expired(qint64 now);
+    qint64 elapsed() const { return queue ? queue->now() - startTime : 0; }
+
     int interval;
-    QPauseAnimationJob pause;
+    QQmlTimerQueue *queue;
+    qint64 startTime;
+    qint64 deadline;
     bool running : 1;
     bool repeating : 1;
     bool triggeredOnStart : 1;
@@ -82,8 +132,128 @@ public:
     bool componentComplete : 1;
     bool firstTick : 1;
     bool awaitingTick : 1;
+    bool scheduled : 1;
 };
 
+QQmlTimerQueue::QQmlTimerQueue()
+    : QPauseAnimationJob(1), base(0)
+{
+    setLoopCount(-1);
+}
+
+QQmlTimerQueue::~QQmlTimerQueue()
+{
+    // The thread is going away; forget the timers that are still waiting
+    for (QMultiMap<qint64, QQmlTimerPrivate *>::ConstIterator it = timers.constBegin(); it != timers.constEnd(); ++it) {
+        it.value()->queue = 0;
+        it.value()->scheduled = false;
+    }
+}
+
+QQmlTimerQueue *QQmlTimerQueue::instance()
+{
+    QThreadStorage<QQmlTimerQueue *> *storage = timerQueue();
+    if (!storage)
+        return 0;
+    if (!storage->hasLocalData())
+        storage->setLocalData(new QQmlTimerQueue);
+    return storage->localData();
+}
+
+void QQmlTimerQueue::add(QQmlTimerPrivate *timer, qint64 deadline)
+{
+    const bool earliest = timers.isEmpty() || deadline < timers.constBegin().key();
+    timers.insert(deadline, timer);
+    if (isStopped()) {
+        rewind();
+        start();
+    } else if (earliest) {
+        rewind();
+        QQmlAnimationTimer::updateAnimationTimer();
+    }
+}
+
+void QQmlTimerQueue::remove(QQmlTimerPrivate *timer)
+{
+    QMultiMap<qint64, QQmlTimerPrivate *>::Iterator it = timers.find(timer->deadline);
+    while (it != timers.end() && it.key() == timer->deadline) {
+        if (it.value() == timer) {
+            timers.erase(it);
+            break;
+        }
+        ++it;
+    }
+    // The job is stopped by the next tick if no timer is left; timers are
+    // often restarted right away, which would otherwise restart the job too.
+}
+
+void QQmlTimerQueue::updateCurrentTime(int)
+{
+    const qint64 time = now();
+    while (!timers.isEmpty() && timers.constBegin().key() <= time) {
+        QQmlTimerPrivate *timer = timers.constBegin().value();
+        timers.erase(timers.begin());
+        timer->scheduled = false;
+        timer->expired(time);
+    }
+
+    rewind();
+    if (timers.isEmpty())
+        stop();
+}
+
+// Moves the job's time into the base and makes the job's duration end at
+// the closest deadline.
+void QQmlTimerQueue::rewind()
+{
+    base += currentTime();
+    m_totalCurrentTime = m_currentTime = 0;
+    m_currentLoop = 0;
+    if (!timers.isEmpty())
+        setDuration(int(qBound<qint64>(1, timers.constBegin().key() - base, INT_MAX)));
+}
+
+void QQmlTimerPrivate::schedule()
+{
+    if (!queue)
+        queue = QQmlTimerQueue::instance();
+    if (!queue)
+        return;
+    // Bring the queue up to date in case the animation timer is sleeping
+    QQmlAnimationTimer::ensureTimerUpdate();
+    startTime = queue->now();
+    deadline = startTime + qMax(1, interval);
+    scheduled = true;
+    queue->add(this, deadline);
+}
+
+void QQmlTimerPrivate::unschedule()
+{
+    if (scheduled) {
+        scheduled = false;
+        queue->remove(this);
+    }
+}
+
+void QQmlTimerPrivate::expired(qint64 now)
+{
+    Q_Q(QQmlTimer);
+    if (repeating) {
+        // A tick that covers several intervals only triggers once
+        const qint64 step = qMax(1, interval);
+        deadline += ((now - deadline) / step + 1) * step;
+        scheduled = true;
+        queue->add(this, deadline);
+        maybeTick();
+        return;
+    }
+
+    running = false;
+    firstTick = false;
+    QCoreApplication::postEvent(q, new QEvent(QEvent_Triggered));
+    emit q->runningChanged();
+}
+
 /*!
     \qmltype Timer
     \instantiates QQmlTimer
@@ -127,10 +297,6 @@ public:
 QQmlTimer::QQmlTimer(QObject *parent)
     : QObject(*(new QQmlTimerPrivate), parent)
 {
-    Q_D(QQmlTimer);
-    d->pause.addAnimationChangeListener(d, QAbstractAnimationJob::Completion | QAbstractAnimationJob::CurrentLoop);
-    d->pause.setLoopCount(1);
-    d->pause.setDuration(d->interval);
 }
 
 /*!
@@ -287,12 +453,9 @@ void QQmlTimer::update()
     Q_D(QQmlTimer);
     if (d->classBegun && !d->componentComplete)
         return;
-    d->pause.stop();
+    d->unschedule();
     if (d->running) {
-        d->pause.setCurrentTime(0);
-        d->pause.setLoopCount(d->repeating ? -1 : 1);
-        d->pause.setDuration(d->interval);
-        d->pause.start();
+        d->schedule();
         if (d->triggeredOnStart && d->firstTick)
             d->maybeTick();
     }
@@ -321,7 +484,7 @@ void QQmlTimer::componentComplete()
 void QQmlTimer::ticked()
 {
     Q_D(QQmlTimer);
-    if (d->running && (d->pause.currentTime() > 0 || (d->triggeredOnStart && d->firstTick)))
+    if (d->running && (d->elapsed() > 0 || (d->triggeredOnStart && d->firstTick)))
         emit triggered();
     d->firstTick = false;
 }
@@ -343,15 +506,4 @@ bool QQmlTimer::event(QEvent *e)
     return QObject::event(e);
 }
 
-void QQmlTimerPrivate::animationFinished(QAbstractAnimationJob *)
-{
-    Q_Q(QQmlTimer);
-    if (repeating || !running)
-        return;
-    running = false;
-    firstTick = false;
-    QCoreApplication::postEvent(q, new QEvent(QEvent_Triggered));
-    emit q->runningChanged();
-}
-
 QT_END_NAMESPACE
@@ -74,15 +74,15 @@ class WorkerDataEvent : public QEvent
 public:
     enum Type { WorkerData = QEvent::User };
 
-    WorkerDataEvent(int workerId, const QByteArray &data);
+    WorkerDataEvent(int workerId, const QV4::Serialize::Message &data);
     virtual ~WorkerDataEvent();
 
     int workerId() const;
-    QByteArray data() const;
+    QV4::Serialize::Message data() const;
 
 private:
     int m_id;
-    QByteArray m_data;
+    QV4::Serialize::Message m_data;
 };
 
 class WorkerLoadEvent : public QEvent
@@ -190,7 +190,7 @@ protected:
     virtual bool event(QEvent *);
 
 private:
-    void processMessage(int, const QByteArray &);
+    void processMessage(int, const QV4::Serialize::Message &);
     void processLoad(int, const QUrl &);
     void reportScriptException(WorkerScript *, const QQmlError &error);
 };
@@ -222,8 +222,8 @@ void QQuickWorkerScriptEnginePrivate::WorkerEngine::init()
 #define SEND_MESSAGE_CREATE_SCRIPT \
     "(function(method, engine) { "\
         "return (function(id) { "\
-            "return (function(message) { "\
-                "if (arguments.length) method(engine, id, message); "\
+            "return (function(message, transfer) { "\
+                "if (arguments.length) method(engine, id, message, transfer); "\
             "}); "\
         "}); "\
     "})"
@@ -289,7 +289,10 @@ QV4::ReturnedValue QQuickWorkerScriptEnginePrivate::method_sendMessage(QV4::Call
 
     QV4::Scope scope(ctx);
     QV4::ScopedValue v(scope, ctx->callData->argument(2));
-    QByteArray data = QV4::Serialize::serialize(v, engine);
+    QV4::ScopedValue transfer(scope, ctx->callData->argument(3));
+    QV4::Serialize::Message data = QV4::Serialize::serialize(v, transfer, engine);
+    if (scope.hasException())
+        return QV4::Encode::undefined();
 
     QMutexLocker locker(&engine->p->m_lock);
     WorkerScript *script = engine->p->workers.value(id);
@@ -351,7 +354,7 @@ bool QQuickWorkerScriptEnginePrivate::event(QEvent *event)
     }
 }
 
-void QQuickWorkerScriptEnginePrivate::processMessage(int id, const QByteArray &data)
+void QQuickWorkerScriptEnginePrivate::processMessage(int id, const QV4::Serialize::Message &data)
 {
     WorkerScript *script = workers.value(id);
     if (!script)
@@ -433,7 +436,7 @@ void QQuickWorkerScriptEnginePrivate::reportScriptException(WorkerScript *script
         QCoreApplication::postEvent(script->owner, new WorkerErrorEvent(error));
 }
 
-WorkerDataEvent::WorkerDataEvent(int workerId, const QByteArray &data)
+WorkerDataEvent::WorkerDataEvent(int workerId, const QV4::Serialize::Message &data)
 : QEvent((QEvent::Type)WorkerData), m_id(workerId), m_data(data)
 {
 }
@@ -447,7 +450,7 @@ int WorkerDataEvent::workerId() const
     return m_id;
 }
 
-QByteArray WorkerDataEvent::data() const
+QV4::Serialize::Message WorkerDataEvent::data() const
 {
     return m_data;
 }
@@ -555,7 +558,7 @@ void QQuickWorkerScriptEngine::executeUrl(int id, const QUrl &url)
     QCoreApplication::postEvent(d, new WorkerLoadEvent(id, url));
 }
 
-void QQuickWorkerScriptEngine::sendMessage(int id, const QByteArray &data)
+void QQuickWorkerScriptEngine::sendMessage(int id, const QV4::Serialize::Message &data)
 {
     QCoreApplication::postEvent(d, new WorkerDataEvent(id, data));
 }
@@ -591,6 +594,10 @@ void QQuickWorkerScriptEngine::run()
     This is useful for running operations in the background so
     that the main GUI thread is not blocked.
 
+    The worker scripts of an engine share a pool of threads. By default
+    the pool holds a single thread; set the \c QML_WORKER_SCRIPT_THREADS
+    environment variable to let more worker scripts run in parallel.
+
     Messages can be passed between the new thread and the parent thread
     using \l sendMessage() and the \c onMessage() handler.
 
@@ -661,7 +668,7 @@ void QQuickWorkerScript::setSource(const QUrl &source)
 }
 
 /*!
-    \qmlmethod WorkerScript::sendMessage(jsobject message)
+    \qmlmethod WorkerScript::sendMessage(jsobject message, array transfer)
 
     Sends the given \a message to a worker script handler in another
     thread. The other worker script handler can receive this message
@@ -673,12 +680,20 @@ void QQuickWorkerScript::setSource(const QUrl &source)
     \list
     \li boolean, number, string
     \li JavaScript objects and arrays
+    \li ArrayBuffer and typed array objects
     \li ListModel objects (any other type of QObject* is not allowed)
     \endlist
 
     All objects and arrays are copied to the \c message. With the exception
     of ListModel objects, any modifications by the other thread to an object
     passed in \c message will not be reflected in the original object.
+
+    The contents of ArrayBuffers are not copied when the message is sent; both
+    threads share them until one side writes to its buffer. ArrayBuffers and
+    typed arrays listed in the optional \a transfer array are moved to the
+    other thread instead: they are empty on the sending side afterwards, so
+    the receiver owns the data outright. The same applies to
+    \tt WorkerScript.sendMessage() in the worker script.
 */
 void QQuickWorkerScript::sendMessage(QQmlV4Function *args)
 {
@@ -689,10 +704,17 @@ void QQuickWorkerScript::sendMessage(QQmlV4Function *args)
 
     QV4::Scope scope(args->v4engine());
     QV4::ScopedValue argument(scope, QV4::Primitive::undefinedValue());
+    QV4::ScopedValue transfer(scope, QV4::Primitive::undefinedValue());
     if (args->length() != 0)
         argument = (*args)[0];
+    if (args->length() > 1)
+        transfer = (*args)[1];
+
+    QV4::Serialize::Message data = QV4::Serialize::serialize(argument, transfer, args->engine());
+    if (scope.hasException())
+        return;
 
-    m_engine->sendMessage(m_scriptId, QV4::Serialize::serialize(argument, args->engine()));
+    m_engine->sendMessage(m_scriptId, data);
 }
 
 void QQuickWorkerScript::classBegin()
@@ -60,6 +60,8 @@
 #include <QtQml/qjsvalue.h>
 #include <QtCore/qurl.h>
 
+#include <private/qv4serialize_p.h>
+
 QT_BEGIN_NAMESPACE
 
 
@@ -75,7 +77,7 @@ public:
     int registerWorkerScript(QQuickWorkerScript *);
     void removeWorkerScript(int);
     void executeUrl(int, const QUrl &);
-    void sendMessage(int, const QByteArray &);
+    void sendMessage(int, const QV4::Serialize::Message &);
 
 protected:
     virtual void run();
@@ -51,6 +51,9 @@
 
 QT_BEGIN_NAMESPACE
 
+// Number of rows requested from a model's prefetchRows() hook at a time.
+#define QML_ADAPTORMODEL_PREFETCH_ROWS 32
+
 class QQmlAdaptorModelEngineData : public QV8Engine::Deletable
 {
 public:
@@ -108,6 +111,9 @@ public:
     void setValue(const QString &role, const QVariant &value);
     bool resolveIndex(const QQmlAdaptorModel &model, int idx);
 
+    bool isReusable() const { return index != -1; }
+    void reuse(const QQmlAdaptorModel &model, int idx);
+
     static QV4::ReturnedValue get_property(QV4::CallContext *ctx, uint propertyId);
     static QV4::ReturnedValue set_property(QV4::CallContext *ctx, uint propertyId);
 
@@ -340,6 +346,16 @@ bool QQmlDMCachedModelData::resolveIndex(const QQmlAdaptorModel &, int idx)
     }
 }
 
+void QQmlDMCachedModelData::reuse(const QQmlAdaptorModel &, int idx)
+{
+    index = idx;
+    emit modelIndexChanged();
+    const QMetaObject *meta = metaObject();
+    const int propertyCount = type->propertyRoles.count();
+    for (int i = 0; i < propertyCount; ++i)
+        QMetaObject::activate(this, meta, i, 0);
+}
+
 QV4::ReturnedValue QQmlDMCachedModelData::get_property(QV4::CallContext *ctx, uint propertyId)
 {
     QV4::Scope scope(ctx);
@@ -392,13 +408,14 @@ QV4::ReturnedValue QQmlDMCachedModelData::set_property(QV4::CallContext *ctx, ui
 class QQmlDMAbstractItemModelData : public QQmlDMCachedModelData
 {
     Q_OBJECT
-    Q_PROPERTY(bool hasModelChildren READ hasModelChildren CONSTANT)
+    Q_PROPERTY(bool hasModelChildren READ hasModelChildren NOTIFY hasModelChildrenChanged)
 public:
     QQmlDMAbstractItemModelData(
             QQmlDelegateModelItemMetaType *metaType,
             VDMModelDelegateDataType *dataType,
             int index)
         : QQmlDMCachedModelData(metaType, dataType, index)
+        , cachedRolesIndex(-1)
     {
     }
 
@@ -414,15 +431,46 @@ public:
 
     QVariant value(int role) const
     {
-        return type->model->aim()->index(index, 0, type->model->rootIndex).data(role);
+        if (!type->model->cacheItemData)
+            return type->model->aim()->index(index, 0, type->model->rootIndex).data(role);
+
+        // The cache belongs to the row the item was at when it was filled, if the item has been
+        // moved or reused since start again.
+        if (cachedRolesIndex != index) {
+            cachedRoles.clear();
+            cachedRolesIndex = index;
+        }
+        QHash<int, QVariant>::const_iterator it = cachedRoles.constFind(role);
+        if (it != cachedRoles.constEnd())
+            return *it;
+        const QVariant value = type->model->aim()->index(index, 0, type->model->rootIndex).data(role);
+        cachedRoles.insert(role, value);
+        return value;
+    }
+
+    void invalidateValues(const QVector<int> &roles)
+    {
+        if (roles.isEmpty()) {
+            cachedRoles.clear();
+        } else {
+            for (int i = 0; i < roles.count(); ++i)
+                cachedRoles.remove(roles.at(i));
+        }
     }
 
     void setValue(int role, const QVariant &value)
     {
+        cachedRoles.remove(role);
         type->model->aim()->setData(
                 type->model->aim()->index(index, 0, type->model->rootIndex), value, role);
     }
 
+    void reuse(const QQmlAdaptorModel &model, int idx)
+    {
+        QQmlDMCachedModelData::reuse(model, idx);
+        emit hasModelChildrenChanged();
+    }
+
     QV4::ReturnedValue get()
     {
         if (type->prototype.isUndefined()) {
@@ -436,6 +484,13 @@ public:
         ++scriptRef;
         return o.asReturnedValue();
     }
+
+Q_SIGNALS:
+    void hasModelChildrenChanged();
+
+private:
+    mutable QHash<int, QVariant> cachedRoles;
+    mutable int cachedRolesIndex;
 };
 
 class VDMAbstractItemModelDataType : public VDMModelDelegateDataType
@@ -443,6 +498,11 @@ class VDMAbstractItemModelDataType : public VDMModelDelegateDataType
 public:
     VDMAbstractItemModelDataType(QQmlAdaptorModel *model)
         : VDMModelDelegateDataType(model)
+        , prefetchMethodIndex(model->aim()->metaObject()->indexOfMethod(
+                "prefetchRows(QModelIndex,int,int)"))
+        , prefetchFirst(0)
+        , prefetchLast(-1)
+        , prefetchRowCount(-1)
     {
     }
 
@@ -476,6 +536,82 @@ public:
         const_cast<VDMAbstractItemModelDataType *>(this)->release();
     }
 
+    bool notify(
+            const QQmlAdaptorModel &model,
+            const QList<QQmlDelegateModelItem *> &items,
+            int index,
+            int count,
+            const QVector<int> &roles) const
+    {
+        // Invalidate cached values even if caching is disabled so they're current if it's
+        // enabled again.
+        for (int i = 0, c = items.count(); i < c; ++i) {
+            QQmlDMAbstractItemModelData *item = static_cast<QQmlDMAbstractItemModelData *>(items.at(i));
+            const int idx = item->modelIndex();
+            if (idx >= index && idx < index + count)
+                item->invalidateValues(roles);
+        }
+        return VDMModelDelegateDataType::notify(model, items, index, count, roles);
+    }
+
+    void prefetch(QQmlAdaptorModel &model, int index) const
+    {
+        if (prefetchMethodIndex == -1)
+            return;
+
+        // Request rows in blocks ahead of the direction that items are being created in so the
+        // model can fetch their data together rather than one row at a time.
+        VDMAbstractItemModelDataType *dataType = const_cast<VDMAbstractItemModelDataType *>(this);
+        const int rowCount = model.aim()->rowCount(model.rootIndex);
+        if (rowCount != prefetchRowCount) {
+            dataType->prefetchFirst = 0;
+            dataType->prefetchLast = -1;
+            dataType->prefetchRowCount = rowCount;
+        }
+        if (index >= prefetchFirst && index <= prefetchLast)
+            return;
+
+        if (prefetchLast >= prefetchFirst && index < prefetchFirst)
+            requestRows(model, qMax(0, index - QML_ADAPTORMODEL_PREFETCH_ROWS + 1), index);
+        else
+            requestRows(model, index, qMin(rowCount - 1, index + QML_ADAPTORMODEL_PREFETCH_ROWS - 1));
+    }
+
+    // Rows the view expects to need soon, e.g. the area a flick will end in.
+    void prefetch(QQmlAdaptorModel &model, int first, int last) const
+    {
+        if (prefetchMethodIndex == -1 || !model)
+            return;
+
+        const int rowCount = model.aim()->rowCount(model.rootIndex);
+        if (rowCount != prefetchRowCount) {
+            VDMAbstractItemModelDataType *dataType = const_cast<VDMAbstractItemModelDataType *>(this);
+            dataType->prefetchFirst = 0;
+            dataType->prefetchLast = -1;
+            dataType->prefetchRowCount = rowCount;
+        }
+        first = qMax(0, first);
+        last = qMin(rowCount - 1, last);
+        if (first > last || (first >= prefetchFirst && last <= prefetchLast))
+            return;
+
+        requestRows(model, first, last);
+    }
+
+    void requestRows(QQmlAdaptorModel &model, int first, int last) const
+    {
+        VDMAbstractItemModelDataType *dataType = const_cast<VDMAbstractItemModelDataType *>(this);
+        dataType->prefetchFirst = first;
+        dataType->prefetchLast = last;
+
+        model.aim()->metaObject()->method(prefetchMethodIndex).invoke(
+                model.aim(),
+                Qt::DirectConnection,
+                Q_ARG(QModelIndex, QModelIndex(model.rootIndex)),
+                Q_ARG(int, prefetchFirst),
+                Q_ARG(int, prefetchLast));
+    }
+
     QVariant value(const QQmlAdaptorModel &model, int index, const QString &role) const
     {
         QHash<QByteArray, int>::const_iterator it = roleNames.find(role.toUtf8());
@@ -522,6 +658,8 @@ public:
         VDMAbstractItemModelDataType *dataType = const_cast<VDMAbstractItemModelDataType *>(this);
         if (!metaObject)
             dataType->initializeMetaType(model, engine);
+        if (index >= 0)
+            prefetch(model, index);
         return new QQmlDMAbstractItemModelData(metaType, dataType, index);
     }
 
@@ -552,6 +690,11 @@ public:
         *static_cast<QMetaObject *>(this) = *metaObject;
         propertyCache = new QQmlPropertyCache(engine, metaObject);
     }
+
+    int prefetchMethodIndex;
+    int prefetchFirst;
+    int prefetchLast;
+    int prefetchRowCount;
 };
 
 //-----------------------------------------------------------------
@@ -635,6 +778,16 @@ public:
         }
     }
 
+    bool isReusable() const { return index != -1; }
+
+    void reuse(const QQmlAdaptorModel &model, int idx)
+    {
+        index = idx;
+        cachedData = model.list.at(idx);
+        emit modelIndexChanged();
+        emit modelDataChanged();
+    }
+
 
 Q_SIGNALS:
     void modelDataChanged();
@@ -891,6 +1044,7 @@ QQmlAdaptorModel::Accessors::~Accessors()
 
 QQmlAdaptorModel::QQmlAdaptorModel()
     : accessors(&qt_vdm_null_accessors)
+    , cacheItemData(false)
 {
 }
 
@@ -92,11 +92,13 @@ public:
             return QVariant(); }
         virtual bool canFetchMore(const QQmlAdaptorModel &) const { return false; }
         virtual void fetchMore(QQmlAdaptorModel &) const {}
+        virtual void prefetch(QQmlAdaptorModel &, int, int) const {}
     };
 
     const Accessors *accessors;
     QPersistentModelIndex rootIndex;
     QQmlListAccessor list;
+    bool cacheItemData;
 
     QQmlAdaptorModel();
     ~QQmlAdaptorModel();
@@ -132,6 +134,7 @@ public:
     inline QVariant parentModelIndex() const { return accessors->parentModelIndex(*this); }
     inline bool canFetchMore() const { return accessors->canFetchMore(*this); }
     inline void fetchMore() { return accessors->fetchMore(*this); }
+    inline void prefetch(int first, int last) { accessors->prefetch(*this, first, last); }
 
 protected:
     void objectDestroyed(QObject *);
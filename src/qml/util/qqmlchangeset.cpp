@@ -41,6 +41,8 @@
 
 #include "qqmlchangeset_p.h"
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 
@@ -69,6 +71,7 @@ QT_BEGIN_NAMESPACE
 
 QQmlChangeSet::QQmlChangeSet()
     : m_difference(0)
+    , m_accumulating(false)
 {
 }
 
@@ -80,7 +83,9 @@ QQmlChangeSet::QQmlChangeSet(const QQmlChangeSet &changeSet)
     : m_removes(changeSet.m_removes)
     , m_inserts(changeSet.m_inserts)
     , m_changes(changeSet.m_changes)
+    , m_pending(changeSet.m_pending)
     , m_difference(changeSet.m_difference)
+    , m_accumulating(changeSet.m_accumulating)
 {
 }
 
@@ -101,17 +106,47 @@ QQmlChangeSet &QQmlChangeSet::operator =(const QQmlChangeSet &changeSet)
     m_removes = changeSet.m_removes;
     m_inserts = changeSet.m_inserts;
     m_changes = changeSet.m_changes;
+    m_pending = changeSet.m_pending;
     m_difference = changeSet.m_difference;
+    m_accumulating = changeSet.m_accumulating;
     return *this;
 }
 
+/*!
+    \fn bool QQmlChangeSet::isAccumulating() const
+
+    Returns true if notifications appended to the change set are buffered and only merged when
+    the set is read.
+*/
+
+/*!
+    Sets whether a change set buffers appended notifications to \a accumulating.
+
+    Merging a notification into a change set has a cost proportional to the number of
+    notifications already in the set, which adds up when a model emits a large number of small
+    notifications between reads of the set.  An accumulating change set instead appends
+    notifications to a buffer, coalescing continuous inserts and removes and collecting
+    consecutive changes as it goes.  The buffer is compacted and merged the first time the
+    contents of the set are read, or a notification which can't be buffered is appended.
+*/
+
+void QQmlChangeSet::setAccumulating(bool accumulating)
+{
+    if (!accumulating)
+        compact();
+    m_accumulating = accumulating;
+}
+
 /*!
     Appends a notification that \a count items were inserted at \a index.
 */
 
 void QQmlChangeSet::insert(int index, int count)
 {
-    insert(QVector<Insert>() << Insert(index, count));
+    if (m_accumulating)
+        accumulate(QVector<Remove>(), QVector<Insert>() << Insert(index, count), QVector<Change>());
+    else
+        insert(QVector<Insert>() << Insert(index, count));
 }
 
 /*!
@@ -122,7 +157,10 @@ void QQmlChangeSet::remove(int index, int count)
 {
     QVector<Remove> removes;
     removes.append(Remove(index, count));
-    remove(&removes, 0);
+    if (m_accumulating)
+        accumulate(removes, QVector<Insert>(), QVector<Change>());
+    else
+        remove(&removes, 0);
 }
 
 /*!
@@ -134,6 +172,7 @@ void QQmlChangeSet::remove(int index, int count)
 
 void QQmlChangeSet::move(int from, int to, int count, int moveId)
 {
+    compact();
     QVector<Remove> removes;
     removes.append(Remove(from, count, moveId));
     QVector<Insert> inserts;
@@ -150,7 +189,10 @@ void QQmlChangeSet::change(int index, int count)
 {
     QVector<Change> changes;
     changes.append(Change(index, count));
-    change(changes);
+    if (m_accumulating)
+        accumulate(QVector<Remove>(), QVector<Insert>(), changes);
+    else
+        change(&changes);
 }
 
 /*!
@@ -159,12 +201,106 @@ void QQmlChangeSet::change(int index, int count)
 
 void QQmlChangeSet::apply(const QQmlChangeSet &changeSet)
 {
-    QVector<Remove> r = changeSet.m_removes;
-    QVector<Insert> i = changeSet.m_inserts;
-    QVector<Change> c = changeSet.m_changes;
+    if (m_accumulating) {
+        accumulate(changeSet.removes(), changeSet.inserts(), changeSet.changes());
+        return;
+    }
+    QVector<Remove> r = changeSet.removes();
+    QVector<Insert> i = changeSet.inserts();
+    QVector<Change> c = changeSet.changes();
     remove(&r, &i);
     insert(i);
-    change(c);
+    change(&c);
+}
+
+/*!
+    Appends a set of \a removes, \a inserts and \a changes to the buffer of an accumulating
+    change set.
+
+    A continuous insert or remove is added to the previous buffered notification of the same type
+    and a change is added to the batch ahead of it.  Anything else starts a new batch.
+*/
+
+void QQmlChangeSet::accumulate(
+        const QVector<Remove> &removes, const QVector<Insert> &inserts, const QVector<Change> &changes)
+{
+    if (!m_pending.isEmpty()) {
+        Batch &last = m_pending.last();
+        if (removes.isEmpty() && inserts.isEmpty()) {
+            last.changes += changes;
+            return;
+        } else if (last.changes.isEmpty() && changes.isEmpty()) {
+            if (removes.isEmpty() && inserts.count() == 1 && last.removes.isEmpty()
+                    && last.inserts.count() == 1) {
+                const Insert &insert = inserts.first();
+                Insert &previous = last.inserts.first();
+                if (!insert.isMove() && !previous.isMove()
+                        && insert.index >= previous.index && insert.index <= previous.end()) {
+                    previous.count += insert.count;
+                    return;
+                }
+            } else if (inserts.isEmpty() && removes.count() == 1 && last.inserts.isEmpty()
+                    && last.removes.count() == 1) {
+                const Remove &remove = removes.first();
+                Remove &previous = last.removes.first();
+                if (!remove.isMove() && !previous.isMove()) {
+                    if (remove.index == previous.index) {
+                        previous.count += remove.count;
+                        return;
+                    } else if (remove.end() == previous.index) {
+                        previous.index = remove.index;
+                        previous.count += remove.count;
+                        return;
+                    }
+                }
+            }
+        }
+    }
+
+    Batch batch;
+    batch.removes = removes;
+    batch.inserts = inserts;
+    batch.changes = changes;
+    m_pending.append(batch);
+}
+
+static bool qt_changeLessThan(const QQmlChangeSet::Change &left, const QQmlChangeSet::Change &right)
+{
+    return left.index < right.index;
+}
+
+/*!
+    \internal
+    Merges the buffered notifications of an accumulating change set.
+
+    The changes collected for each batch are sorted and overlapping changes combined in a single
+    sweep so they can be merged with the set in one pass.
+*/
+
+void QQmlChangeSet::flush()
+{
+    QVector<Batch> pending;
+    pending.swap(m_pending);
+
+    for (QVector<Batch>::iterator batch = pending.begin(); batch != pending.end(); ++batch) {
+        if (!batch->removes.isEmpty())
+            remove(&batch->removes, &batch->inserts);
+        if (!batch->inserts.isEmpty())
+            insert(batch->inserts);
+        if (!batch->changes.isEmpty()) {
+            std::sort(batch->changes.begin(), batch->changes.end(), qt_changeLessThan);
+            QVector<Change>::iterator last = batch->changes.begin();
+            for (QVector<Change>::iterator it = last + 1; it != batch->changes.end(); ++it) {
+                if (it->index <= last->end()) {
+                    last->count = qMax(last->end(), it->end()) - last->index;
+                } else {
+                    *(++last) = *it;
+                }
+            }
+            batch->changes.erase(last + 1, batch->changes.end());
+            change(&batch->changes);
+        }
+    }
 }
 
 /*!
@@ -176,6 +312,7 @@ void QQmlChangeSet::apply(const QQmlChangeSet &changeSet)
 
 void QQmlChangeSet::remove(const QVector<Remove> &removes, QVector<Insert> *inserts)
 {
+    compact();
     QVector<Remove> r = removes;
     remove(&r, inserts);
 }
@@ -397,6 +534,7 @@ void QQmlChangeSet::remove(QVector<Remove> *removes, QVector<Insert> *inserts)
 
 void QQmlChangeSet::insert(const QVector<Insert> &inserts)
 {
+    compact();
     int insertCount = 0;
     QVector<Insert>::iterator insert = m_inserts.begin();
     QVector<Change>::iterator change = m_changes.begin();
@@ -489,6 +627,7 @@ void QQmlChangeSet::insert(const QVector<Insert> &inserts)
 
 void QQmlChangeSet::move(const QVector<Remove> &removes, const QVector<Insert> &inserts)
 {
+    compact();
     QVector<Remove> r = removes;
     QVector<Insert> i = inserts;
     remove(&r, &i);
@@ -501,14 +640,19 @@ void QQmlChangeSet::move(const QVector<Remove> &removes, const QVector<Insert> &
 
 void QQmlChangeSet::change(const QVector<Change> &changes)
 {
+    if (m_accumulating) {
+        accumulate(QVector<Remove>(), QVector<Insert>(), changes);
+        return;
+    }
     QVector<Change> c = changes;
     change(&c);
 }
 
 void QQmlChangeSet::change(QVector<Change> *changes)
 {
+    // Remove any portion of a change which intersects an insert, the inserted items are new
+    // regardless.
     QVector<Insert>::iterator insert = m_inserts.begin();
-    QVector<Change>::iterator change = m_changes.begin();
     for (QVector<Change>::iterator cit = changes->begin(); cit != changes->end(); ++cit) {
         for (; insert != m_inserts.end() && insert->end() < cit->index; ++insert) {}
         for (; insert != m_inserts.end() && insert->index < cit->end(); ++insert) {
@@ -523,34 +667,34 @@ void QQmlChangeSet::change(QVector<Change> *changes)
                 cit->count = offset;
             }
         }
+    }
 
-        for (; change != m_changes.end() && change->index + change->count < cit->index; ++change) {}
-        if (change == m_changes.end() || change->index > cit->index + cit->count) {
-            if (cit->count > 0) {
-                change = m_changes.insert(change, *cit);
-                ++change;
-            }
+    // Merge the new and existing changes in a single pass, combining any which overlap or are
+    // adjacent.
+    QVector<Change> merged;
+    merged.reserve(m_changes.count() + changes->count());
+    QVector<Change>::const_iterator change = m_changes.constBegin();
+    QVector<Change>::const_iterator cit = changes->constBegin();
+    while (change != m_changes.constEnd() || cit != changes->constEnd()) {
+        Change next;
+        if (cit == changes->constEnd()
+                || (change != m_changes.constEnd() && change->index <= cit->index)) {
+            next = *change++;
+        } else if (cit->count > 0) {
+            next = *cit++;
         } else {
-            if (cit->index < change->index) {
-                change->count += change->index - cit->index;
-                change->index = cit->index;
-            }
+            ++cit;
+            continue;
+        }
 
-            if (cit->index + cit->count > change->index + change->count) {
-                change->count = cit->index + cit->count - change->index;
-                QVector<Change>::iterator cbegin = change;
-                QVector<Change>::iterator cend = ++cbegin;
-                for (; cend != m_changes.end() && cend->index <= change->index + change->count; ++cend) {
-                    if (cend->index + cend->count > change->index + change->count)
-                        change->count = cend->index + cend->count - change->index;
-                }
-                if (cbegin != cend) {
-                    change = m_changes.erase(cbegin, cend);
-                    --change;
-                }
-            }
+        if (!merged.isEmpty() && merged.last().end() >= next.index) {
+            Change &previous = merged.last();
+            previous.count = qMax(previous.end(), next.end()) - previous.index;
+        } else {
+            merged.append(next);
         }
     }
+    m_changes = merged;
 }
 
 /*!
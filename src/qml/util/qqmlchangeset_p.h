@@ -111,9 +111,9 @@ public:
 
     QQmlChangeSet &operator =(const QQmlChangeSet &changeSet);
 
-    const QVector<Remove> &removes() const { return m_removes; }
-    const QVector<Insert> &inserts() const { return m_inserts; }
-    const QVector<Change> &changes() const { return m_changes; }
+    const QVector<Remove> &removes() const { compact(); return m_removes; }
+    const QVector<Insert> &inserts() const { compact(); return m_inserts; }
+    const QVector<Change> &changes() const { compact(); return m_changes; }
 
     void insert(int index, int count);
     void remove(int index, int count);
@@ -126,26 +126,45 @@ public:
     void change(const QVector<Change> &changes);
     void apply(const QQmlChangeSet &changeSet);
 
-    bool isEmpty() const { return m_removes.empty() && m_inserts.empty() && m_changes.isEmpty(); }
+    bool isEmpty() const {
+        compact(); return m_removes.empty() && m_inserts.empty() && m_changes.isEmpty(); }
 
     void clear()
     {
         m_removes.clear();
         m_inserts.clear();
         m_changes.clear();
+        m_pending.clear();
         m_difference = 0;
     }
 
-    int difference() const { return m_difference; }
+    int difference() const { compact(); return m_difference; }
+
+    bool isAccumulating() const { return m_accumulating; }
+    void setAccumulating(bool accumulating);
+
+    void compact() const { if (!m_pending.isEmpty()) const_cast<QQmlChangeSet *>(this)->flush(); }
 
 private:
+    struct Batch
+    {
+        QVector<Remove> removes;
+        QVector<Insert> inserts;
+        QVector<Change> changes;
+    };
+
     void remove(QVector<Remove> *removes, QVector<Insert> *inserts);
     void change(QVector<Change> *changes);
 
+    void accumulate(const QVector<Remove> &removes, const QVector<Insert> &inserts, const QVector<Change> &changes);
+    void flush();
+
     QVector<Remove> m_removes;
     QVector<Insert> m_inserts;
     QVector<Change> m_changes;
+    QVector<Batch> m_pending;
     int m_difference;
+    bool m_accumulating;
 };
 
 Q_DECLARE_TYPEINFO(QQmlChangeSet::Change, Q_PRIMITIVE_TYPE);
@@ -293,6 +293,7 @@ QQmlListCompositor::QQmlListCompositor()
     , m_defaultFlags(PrependFlag | DefaultFlag)
     , m_removeFlags(AppendFlag | PrependFlag | GroupMask)
     , m_moveId(0)
+    , m_checkpointsComplete(false)
 {
 }
 
@@ -344,6 +345,8 @@ void QQmlListCompositor::setGroupCount(int count)
     m_groupCount = count;
     m_end = iterator(&m_ranges, 0, Default, m_groupCount);
     m_cacheIt = m_end;
+    m_checkpoints.clear();
+    m_checkpointsComplete = false;
 }
 
 /*!
@@ -365,14 +368,8 @@ QQmlListCompositor::iterator QQmlListCompositor::find(Group group, int index)
 {
     QT_QML_TRACE_LISTCOMPOSITOR(<< group << index)
     Q_ASSERT(index >=0 && index < count(group));
-    if (m_cacheIt == m_end) {
-        m_cacheIt = iterator(m_ranges.next, 0, group, m_groupCount);
-        m_cacheIt += index;
-    } else {
-        const int offset = index - m_cacheIt.index[group];
-        m_cacheIt.setGroup(group);
-        m_cacheIt += offset;
-    }
+    seek(&m_cacheIt, group, index);
+    m_cacheIt += index - m_cacheIt.index[group];
     Q_ASSERT(m_cacheIt.index[group] == index);
     Q_ASSERT(m_cacheIt->inGroup(group));
     QT_QML_VERIFY_LISTCOMPOSITOR
@@ -390,6 +387,124 @@ QQmlListCompositor::iterator QQmlListCompositor::find(Group group, int index) co
     return const_cast<QQmlListCompositor *>(this)->find(group, index);
 }
 
+/*
+    The number of ranges between consecutive checkpoints.  A lookup walks at most this many ranges
+    past the checkpoint it starts from.
+*/
+
+static const int qt_listCompositorCheckpointInterval = 16;
+
+/*!
+    \internal
+    Returns an iterator positioned at the start of the last indexed range which begins before the
+    item at \a index in a \a group.
+
+    The index of range start positions is only extended as far as a lookup requires, starting
+    from the last position that was still valid after the compositor was modified, and is
+    searched with a binary search so a lookup far from the cached iterator doesn't need to walk
+    every range in between.
+*/
+
+QQmlListCompositor::iterator QQmlListCompositor::checkpoint(Group group, int index)
+{
+    if (!m_checkpointsComplete
+            && (m_checkpoints.isEmpty() || m_checkpoints.last().index[group] < index)) {
+        iterator it(m_ranges.next, 0, Default, m_groupCount);
+        int i = 0;
+        if (!m_checkpoints.isEmpty()) {
+            it = m_checkpoints.last();
+            it.incrementIndexes(it->count);
+            *it = it->next;
+            i = 1;
+        }
+        for (; *it != &m_ranges; *it = it->next, ++i) {
+            if (i % qt_listCompositorCheckpointInterval == 0) {
+                m_checkpoints.append(it);
+                if (it.index[group] >= index)
+                    break;
+            }
+            it.incrementIndexes(it->count);
+        }
+        m_checkpointsComplete = *it == &m_ranges;
+    }
+
+    int lower = 0;
+    int upper = m_checkpoints.count();
+    while (lower < upper) {
+        const int middle = (lower + upper) / 2;
+        if (m_checkpoints.at(middle).index[group] < index)
+            lower = middle + 1;
+        else
+            upper = middle;
+    }
+
+    iterator it = lower > 0
+            ? m_checkpoints.at(lower - 1)
+            : iterator(m_ranges.next, 0, group, m_groupCount);
+    it.setGroup(group);
+    return it;
+}
+
+/*!
+    \internal
+    Discards the indexed range start positions which may be affected by modifying the range
+    \a it points to.
+
+    Modifications may split, grow or merge with the range preceding the modified one, so only the
+    positions of ranges in front of that one are kept.  A range is in front of another if it
+    starts before it in at least one group.
+*/
+
+void QQmlListCompositor::invalidateCheckpoints(const iterator &it)
+{
+    m_checkpointsComplete = false;
+    if (m_checkpoints.isEmpty())
+        return;
+
+    iterator start = it;
+    start.decrementIndexes(start.offset);
+    if (*start != m_ranges.next)
+        start.decrementIndexes(start->previous->count, start->previous->flags);
+
+    int lower = 0;
+    int upper = m_checkpoints.count();
+    while (lower < upper) {
+        const int middle = (lower + upper) / 2;
+        const iterator &checkpoint = m_checkpoints.at(middle);
+        bool before = false;
+        for (int i = 0; !before && i < m_groupCount; ++i)
+            before = checkpoint.index[i] < start.index[i];
+        if (before)
+            lower = middle + 1;
+        else
+            upper = middle;
+    }
+    m_checkpoints.resize(lower);
+}
+
+/*!
+    \internal
+    Moves \a it to the nearest known position from which the item at \a index in a \a group can be
+    reached, which is either its current position or an indexed range start.
+
+    The iterator group is set to \a group, the caller is responsible for advancing the iterator
+    the remaining distance.
+*/
+
+void QQmlListCompositor::seek(iterator *it, Group group, int index)
+{
+    const bool cached = *it != m_end;
+    const int distance = cached ? qAbs(index - it->index[group]) : index;
+    if (distance > qt_listCompositorCheckpointInterval) {
+        const iterator start = checkpoint(group, index);
+        if (!cached || index - start.index[group] < distance)
+            *it = start;
+    } else if (!cached) {
+        *it = iterator(m_ranges.next, 0, group, m_groupCount);
+    }
+    it->setGroup(group);
+}
+
 /*!
     Returns an iterator representing an insert position in front of the item at \a index in a
     \a group.
@@ -406,16 +521,9 @@ QQmlListCompositor::insert_iterator QQmlListCompositor::findInsertPosition(Group
 {
     QT_QML_TRACE_LISTCOMPOSITOR(<< group << index)
     Q_ASSERT(index >=0 && index <= count(group));
-    insert_iterator it;
-    if (m_cacheIt == m_end) {
-        it = iterator(m_ranges.next, 0, group, m_groupCount);
-        it += index;
-    } else {
-        const int offset = index - m_cacheIt.index[group];
-        it = m_cacheIt;
-        it.setGroup(group);
-        it += offset;
-    }
+    insert_iterator it = m_cacheIt;
+    seek(&it, group, index);
+    it += index - it.index[group];
     Q_ASSERT(it.index[group] == index);
     return it;
 }
@@ -462,6 +570,7 @@ QQmlListCompositor::iterator QQmlListCompositor::insert(
         iterator before, void *list, int index, int count, uint flags, QVector<Insert> *inserts)
 {
     QT_QML_TRACE_LISTCOMPOSITOR(<< before << list << index << count << flags)
+    invalidateCheckpoints(before);
     if (inserts) {
         inserts->append(Insert(before, count, flags & GroupMask));
     }
@@ -533,6 +642,8 @@ void QQmlListCompositor::setFlags(
     if (!flags || !count)
         return;
 
+    invalidateCheckpoints(from);
+
     if (from != group) {
         // Skip to the next full range if the start one is not a member of the target group.
         from.incrementIndexes(from->count - from.offset);
@@ -643,6 +754,8 @@ void QQmlListCompositor::clearFlags(
     if (!flags || !count)
         return;
 
+    invalidateCheckpoints(from);
+
     const bool clearCache = flags & CacheFlag;
 
     if (from != group) {
@@ -782,6 +895,7 @@ void QQmlListCompositor::move(
 
     // Find the position of the first item to move.
     iterator fromIt = find(fromGroup, from);
+    invalidateCheckpoints(fromIt);
 
     if (fromIt != moveGroup) {
         // If the range at the from index doesn't contain items from the move group; skip
@@ -880,6 +994,7 @@ void QQmlListCompositor::move(
 
     const int difference = to - toIt.index[toGroup];
     toIt += difference;
+    invalidateCheckpoints(toIt);
 
     // If the insert position is part way through a range; split it and move the iterator to the
     // start of the second range.
@@ -946,6 +1061,8 @@ void QQmlListCompositor::clear()
     for (Range *range = m_ranges.next; range != &m_ranges; range = erase(range)) {}
     m_end = iterator(m_ranges.next, 0, Default, m_groupCount);
     m_cacheIt = m_end;
+    m_checkpoints.clear();
+    m_checkpointsComplete = false;
 }
 
 void QQmlListCompositor::listItemsInserted(
@@ -972,6 +1089,7 @@ void QQmlListCompositor::listItemsInserted(
                     || (offset == 0 && it->prepend())
                     || (offset == it->count && it->append())) {
                 // The insert index is within the current range.
+                invalidateCheckpoints(it);
                 if (it->prepend()) {
                     // The range has the prepend flag set so we insert new items into the range.
                     uint flags = m_defaultFlags;
@@ -1093,6 +1211,7 @@ void QQmlListCompositor::listItemsRemoved(
             int itemsRemoved = removal->count;
             if (relativeIndex + removal->count > 0 && relativeIndex < it->count) {
                 // If the current range intersects the remove; remove the intersecting items.
+                invalidateCheckpoints(it);
                 const int offset = qMax(0, relativeIndex);
                 int removeCount = qMin(it->count, relativeIndex + removal->count) - offset;
                 it->count -= removeCount;
@@ -1214,6 +1333,7 @@ void QQmlListCompositor::listItemsRemoved(
                         && it->previous->end() == it->index
                         && it->previous->flags == (it->flags & ~AppendFlag)) {
                     // Compress ranges made continuous by the removal of separating ranges.
+                    invalidateCheckpoints(it);
                     it.decrementIndexes(it->previous->count);
                     it->previous->count += it->count;
                     it->previous->flags = it->flags;
@@ -1223,6 +1343,7 @@ void QQmlListCompositor::listItemsRemoved(
         }
         if (it->flags == CacheFlag && it->next->flags == CacheFlag && it->next->list == it->list) {
             // Compress consecutive cache only ranges.
+            invalidateCheckpoints(it);
             it.index[Cache] += it->next->count;
             it->count += it->next->count;
             erase(it->next);
@@ -274,10 +274,16 @@ private:
     int m_defaultFlags;
     int m_removeFlags;
     int m_moveId;
+    QVector<iterator> m_checkpoints;
+    bool m_checkpointsComplete;
 
     inline Range *insert(Range *before, void *list, int index, int count, uint flags);
     inline Range *erase(Range *range);
 
+    iterator checkpoint(Group group, int index);
+    void invalidateCheckpoints(const iterator &it);
+    void seek(iterator *it, Group group, int index);
+
     struct MovedFlags
     {
         MovedFlags() {}
@@ -42,6 +42,7 @@
 #include "quicktest.h"
 #include "quicktestresult_p.h"
 #include <QtTest/qtestsystem.h>
+#include <QtTest/private/qtestlog_p.h>
 #include "qtestoptions_p.h"
 #include <QtQml/qqml.h>
 #include <QtQml/qqmlengine.h>
@@ -57,10 +58,16 @@
 #include <QtCore/qdiriterator.h>
 #include <QtCore/qfile.h>
 #include <QtCore/qdebug.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qvector.h>
 #include <QtCore/qeventloop.h>
+#include <QtCore/qprocess.h>
+#include <QtCore/qthread.h>
 #include <QtCore/qtextstream.h>
+#include <QtCore/qxmlstream.h>
 #include <QtGui/qtextdocument.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <QtGui/QGuiApplication>
 #include <QtCore/QTranslator>
 #include <QtTest/QSignalSpy>
@@ -196,15 +203,248 @@ bool qWaitForSignal(QObject *obj, const char* signal, int timeout = 5000)
     return spy.size();
 }
 
+static void readTestLogEntry(QXmlStreamReader &xml, QString *dataTag, QString *description)
+{
+    while (xml.readNextStartElement()) {
+        if (xml.name() == QLatin1String("DataTag"))
+            *dataTag = xml.readElementText();
+        else if (xml.name() == QLatin1String("Description"))
+            *description = xml.readElementText();
+        else
+            xml.skipCurrentElement();
+    }
+}
+
+/*
+    Feeds the XML test log written by a worker process into the loggers of
+    this process, so that the results end up in the requested formats as if
+    the tests were run here.  Durations are not replayed and benchmark
+    results are logged as information.  Returns false if the log is
+    incomplete, e.g. because the worker crashed.
+*/
+static bool replayTestLog(const QFileInfo &fi, const QByteArray &log, const QString &error)
+{
+    QuickTestResult results;
+    QXmlStreamReader xml(log);
+    QString currentDataTag;
+    bool inFunction = false;
+    bool complete = false;
+
+    while (!xml.atEnd()) {
+        xml.readNext();
+        if (xml.isEndElement()) {
+            if (xml.name() == QLatin1String("TestFunction") && inFunction) {
+                results.setDataTag(QString());
+                results.clearTestTable();
+                results.finishTestFunction();
+                currentDataTag.clear();
+                inFunction = false;
+            } else if (xml.name() == QLatin1String("TestCase")) {
+                complete = true;
+            }
+            continue;
+        }
+        if (!xml.isStartElement())
+            continue;
+
+        const QXmlStreamAttributes attributes = xml.attributes();
+        if (xml.name() == QLatin1String("TestFunction")) {
+            results.initTestTable();
+            results.setFunctionName(attributes.value(QLatin1String("name")).toString());
+            inFunction = true;
+        } else if (inFunction && (xml.name() == QLatin1String("Incident")
+                                  || xml.name() == QLatin1String("Message"))) {
+            const bool incident = xml.name() == QLatin1String("Incident");
+            const QString type = attributes.value(QLatin1String("type")).toString();
+            const QByteArray file = attributes.value(QLatin1String("file")).toString().toLatin1();
+            const int line = attributes.value(QLatin1String("line")).toString().toInt();
+            QString dataTag;
+            QString description;
+            readTestLogEntry(xml, &dataTag, &description);
+
+            if (dataTag != currentDataTag) {
+                results.setDataTag(dataTag);
+                currentDataTag = dataTag;
+            }
+
+            const QByteArray message = description.toLatin1();
+            const char *fileName = file.isEmpty() ? 0 : file.constData();
+            if (incident && type == QLatin1String("pass"))
+                QTestLog::addPass(message.constData());
+            else if (incident && type == QLatin1String("fail"))
+                QTestLog::addFail(message.constData(), fileName, line);
+            else if (incident && type == QLatin1String("xfail"))
+                QTestLog::addXFail(message.constData(), fileName, line);
+            else if (incident && type == QLatin1String("xpass"))
+                QTestLog::addXPass(message.constData(), fileName, line);
+            else if (type == QLatin1String("skip"))
+                QTestLog::addSkip(message.constData(), fileName, line);
+            else if (type == QLatin1String("info"))
+                QTestLog::info(message.constData(), fileName, line);
+            else if (type == QLatin1String("qdebug"))
+                QMessageLogger(fileName, line, 0).debug("%s", message.constData());
+            else if (type == QLatin1String("qwarn"))
+                QMessageLogger(fileName, line, 0).warning("%s", message.constData());
+            else if (type == QLatin1String("system"))
+                QMessageLogger(fileName, line, 0).critical("%s", message.constData());
+            else
+                QTestLog::warn(message.constData(), fileName, line);
+        } else if (inFunction && xml.name() == QLatin1String("BenchmarkResult")) {
+            const QString result = QString::fromLatin1("%1 %2: %3 per iteration (iterations: %4)")
+                    .arg(attributes.value(QLatin1String("tag")).toString(),
+                         attributes.value(QLatin1String("metric")).toString(),
+                         attributes.value(QLatin1String("value")).toString(),
+                         attributes.value(QLatin1String("iterations")).toString());
+            QTestLog::info(result.trimmed().toLatin1().constData(), 0, 0);
+        }
+    }
+
+    if (complete && !xml.hasError())
+        return true;
+
+    // The worker died, flag the failure in the function it was running.
+    if (!inFunction) {
+        results.setTestCaseName(fi.baseName());
+        results.setFunctionName(QLatin1String("run"));
+    }
+    results.fail(error, QUrl::fromLocalFile(fi.absoluteFilePath()), 0);
+    results.setDataTag(QString());
+    results.clearTestTable();
+    results.finishTestFunction();
+    results.setFunctionName(QString());
+    return false;
+}
+
+/*
+    Runs each test file in a separate worker process, -jobs of them at a
+    time.  The workers write XML logs, which are replayed in the order of
+    the files as soon as all of the preceding files are done, so the output
+    does not depend on the scheduling of the workers.
+*/
+class QuickTestJobRunner : public QObject
+{
+    Q_OBJECT
+public:
+    QuickTestJobRunner(const QStringList &files, const QStringList &arguments, int jobs)
+        : m_files(files), m_arguments(arguments), m_jobs(jobs), m_started(0), m_replayed(0), m_running(0)
+    {
+        m_logs.resize(files.count());
+        m_errors.resize(files.count());
+        m_done.fill(false, files.count());
+    }
+
+    void run()
+    {
+        while (m_running < m_jobs && startNext()) {}
+        replayFinished();
+        if (m_replayed < m_files.count())
+            m_eventLoop.exec();
+    }
+
+private Q_SLOTS:
+    void finished(int exitCode, QProcess::ExitStatus exitStatus)
+    {
+        QProcess *process = qobject_cast<QProcess *>(sender());
+        const int index = m_processes.take(process);
+        m_logs[index] = process->readAllStandardOutput();
+        // Only reported if the log is incomplete
+        if (exitStatus == QProcess::CrashExit)
+            m_errors[index] = QLatin1String("The test process crashed");
+        else
+            m_errors[index] = QString::fromLatin1("The test process exited with code %1 before finishing").arg(exitCode);
+        // Forwarded along with the log, what the worker wrote outside of it
+        m_stderr.insert(index, process->readAllStandardError());
+        m_done[index] = true;
+        process->deleteLater();
+        --m_running;
+
+        while (m_running < m_jobs && startNext()) {}
+        replayFinished();
+        if (m_replayed == m_files.count())
+            m_eventLoop.quit();
+    }
+
+private:
+    bool startNext()
+    {
+        if (m_started == m_files.count())
+            return false;
+        const int index = m_started++;
+
+        QProcess *process = new QProcess(this);
+        QStringList arguments = m_arguments;
+        arguments << QStringLiteral("-o") << QStringLiteral("-,xml")
+                  << QStringLiteral("-input") << m_files.at(index);
+        connect(process, SIGNAL(finished(int,QProcess::ExitStatus)),
+                this, SLOT(finished(int,QProcess::ExitStatus)));
+        process->start(QCoreApplication::applicationFilePath(), arguments);
+        if (!process->waitForStarted()) {
+            m_errors[index] = QString::fromLatin1("Cannot start the test process: %1").arg(process->errorString());
+            m_done[index] = true;
+            delete process;
+            return true;
+        }
+        m_processes.insert(process, index);
+        ++m_running;
+        return true;
+    }
+
+    void replayFinished()
+    {
+        while (m_replayed < m_files.count() && m_done.at(m_replayed)) {
+            const int index = m_replayed++;
+            const QByteArray stderrOutput = m_stderr.take(index);
+            if (!stderrOutput.isEmpty())
+                fwrite(stderrOutput.constData(), 1, stderrOutput.size(), stderr);
+            replayTestLog(QFileInfo(m_files.at(index)), m_logs.at(index), m_errors.at(index));
+            m_logs[index].clear();
+        }
+    }
+
+    QStringList m_files;
+    QStringList m_arguments;
+    int m_jobs;
+    int m_started;
+    int m_replayed;
+    int m_running;
+    QVector<QByteArray> m_logs;
+    QVector<QString> m_errors;
+    QVector<bool> m_done;
+    QHash<int, QByteArray> m_stderr;
+    QHash<QProcess *, int> m_processes;
+    QEventLoop m_eventLoop;
+};
+
+// Returns the test library options, without those selecting the output,
+// to pass on to the worker processes.
+static QStringList workerTestArguments(int argc, char **argv)
+{
+    QStringList arguments;
+    for (int index = 1; index < argc; ++index) {
+        const char *arg = argv[index];
+        if (strcmp(arg, "-o") == 0) {
+            ++index;
+        } else if (strcmp(arg, "-txt") != 0 && strcmp(arg, "-xml") != 0
+                   && strcmp(arg, "-lightxml") != 0 && strcmp(arg, "-xunitxml") != 0
+                   && strcmp(arg, "-csv") != 0 && strcmp(arg, "-silent") != 0) {
+            arguments << QString::fromLocal8Bit(arg);
+        }
+    }
+    return arguments;
+}
+
 int quick_test_main(int argc, char **argv, const char *name, const char *sourceDir)
 {
     // Look for QML-specific command-line options.
     //      -import dir         Specify an import directory.
     //      -input dir          Specify the input directory for test cases.
     //      -translation file   Specify the translation file.
+    //      -jobs n             Run the test files in n worker processes.
     QStringList imports;
     QString testPath;
     QString translationFile;
+    QStringList workerArguments;
+    int jobs = 1;
 #ifdef QT_QMLTEST_WITH_WIDGETS
     bool withWidgets = false;
 #endif
@@ -213,6 +453,7 @@ int quick_test_main(int argc, char **argv, const char *name, const char *sourceD
     while (index < argc) {
         if (strcmp(argv[index], "-import") == 0 && (index + 1) < argc) {
             imports += stripQuotes(QString::fromLocal8Bit(argv[index + 1]));
+            workerArguments << QStringLiteral("-import") << imports.last();
             index += 2;
         } else if (strcmp(argv[index], "-input") == 0 && (index + 1) < argc) {
             testPath = stripQuotes(QString::fromLocal8Bit(argv[index + 1]));
@@ -222,10 +463,18 @@ int quick_test_main(int argc, char **argv, const char *name, const char *sourceD
 #ifdef QT_QMLTEST_WITH_WIDGETS
         } else if (strcmp(argv[index], "-widgets") == 0) {
             withWidgets = true;
+            workerArguments << QStringLiteral("-widgets");
             ++index;
 #endif
         } else if (strcmp(argv[index], "-translation") == 0 && (index + 1) < argc) {
             translationFile = stripQuotes(QString::fromLocal8Bit(argv[index + 1]));
+            workerArguments << QStringLiteral("-translation") << translationFile;
+            index += 2;
+        } else if (strcmp(argv[index], "-jobs") == 0 && (index + 1) < argc) {
+            // 0 uses one worker per core
+            jobs = atoi(argv[index + 1]);
+            if (jobs <= 0)
+                jobs = QThread::idealThreadCount();
             index += 2;
         } else if (outargc != index) {
             argv[outargc++] = argv[index++];
@@ -314,6 +563,18 @@ int quick_test_main(int argc, char **argv, const char *name, const char *sourceD
         return 1;
     }
 
+    // Each view needs the GUI thread, so parallel runs use worker processes.
+    if (jobs > 1 && files.count() > 1 && !QTest::printAvailableFunctions) {
+        workerArguments += workerTestArguments(argc, argv);
+        QuickTestResult results;
+        results.startLogging();
+        QuickTestJobRunner runner(files, workerArguments, qMin(jobs, files.count()));
+        runner.run();
+        QuickTestResult::setProgramName(0);
+        delete app;
+        return QuickTestResult::exitCode();
+    }
+
     // Register the test object
     qmlRegisterSingletonType<QTestRootObject>("Qt.test.qtestroot", 1, 0, "QTestRootObject", testRootObject);
     // Scan through all of the "tst_*.qml" files and run each of them
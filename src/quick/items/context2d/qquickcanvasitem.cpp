@@ -221,8 +221,8 @@ QQuickCanvasItemPrivate::~QQuickCanvasItemPrivate()
 
     \section1 Threaded Rendering and Render Target
 
-    The Canvas item supports two render targets: \c Canvas.Image and
-    \c Canvas.FramebufferObject.
+    The Canvas item supports three render targets: \c Canvas.Image,
+    \c Canvas.FramebufferObject and \c Canvas.Geometry.
 
     The \c Canvas.Image render target is a \a QImage object.  This render
     target supports background thread rendering, allowing complex or long
@@ -236,6 +236,16 @@ QQuickCanvasItemPrivate::~QQuickCanvasItemPrivate()
     graphics memory when rendering strategy is anything other than
     Canvas.Cooperative.
 
+    The Canvas.Geometry render target does not paint pixels at all. Fills and
+    strokes are tessellated into triangles which are drawn by the scene graph,
+    shapes of the same color are drawn together, and a shape drawn again with
+    the same path, transform and line style reuses the triangles of the
+    previous paint. This suits canvases which redraw many simple shapes, such
+    as charts, often. Only solid colors with the default composite operation
+    are supported; images, gradients, patterns, shadows and clipping are
+    ignored with a warning. Antialiasing relies on the multisampling of the
+    window, and translucent strokes may show where their segments overlap.
+
     The default render target is Canvas.Image and the default renderStrategy is
     Canvas.Immediate.
 
@@ -469,6 +479,7 @@ void QQuickCanvasItem::setCanvasWindow(const QRectF& rect)
     \list
     \li Canvas.Image  - render to an in memory image buffer.
     \li Canvas.FramebufferObject - render to an OpenGL frame buffer
+    \li Canvas.Geometry - tessellate paths into scene graph geometry
     \endlist
 
     This hint is supplied along with renderStrategy to the graphics context to
@@ -703,6 +714,16 @@ QSGNode *QQuickCanvasItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData
         return 0;
     }
 
+    if (d->renderStrategy == QQuickCanvasItem::Cooperative) {
+        d->context->prepare(d->canvasSize.toSize(), d->tileSize, d->canvasWindow.toRect(), d->dirtyRect.toRect(), d->smooth, antialiasing());
+        d->context->flush();
+    }
+
+    QQuickContext2D *ctx = qobject_cast<QQuickContext2D *>(d->context);
+    QQuickContext2DTexture *factory = ctx->texture();
+    if (factory->renderTarget() == QQuickCanvasItem::Geometry)
+        return static_cast<QQuickContext2DGeometryTexture *>(factory)->updateNode(oldNode);
+
     QQuickCanvasNode *node = static_cast<QQuickCanvasNode*>(oldNode);
     if (!node)
         node = new QQuickCanvasNode();
@@ -712,13 +733,6 @@ QSGNode *QQuickCanvasItem::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData
     else
         node->setFiltering(QSGTexture::Nearest);
 
-    if (d->renderStrategy == QQuickCanvasItem::Cooperative) {
-        d->context->prepare(d->canvasSize.toSize(), d->tileSize, d->canvasWindow.toRect(), d->dirtyRect.toRect(), d->smooth, antialiasing());
-        d->context->flush();
-    }
-
-    QQuickContext2D *ctx = qobject_cast<QQuickContext2D *>(d->context);
-    QQuickContext2DTexture *factory = ctx->texture();
     QSGTexture *texture = factory->textureForNextFrame(node->texture());
     if (!texture) {
         delete node;
@@ -91,7 +91,8 @@ class QQuickCanvasItem : public QQuickItem
 public:
     enum RenderTarget {
         Image,
-        FramebufferObject
+        FramebufferObject,
+        Geometry
     };
 
     enum RenderStrategy {
@@ -4133,8 +4133,8 @@ QQuickContext2D::~QQuickContext2D()
             }
         }
     } else {
-        // Image based does not have GL resources, but must still be deleted
-        // on its designated thread after it has completed whatever it might
+        // Image and geometry based do not have GL resources, but must still be deleted
+        // on their designated thread after they have completed whatever they might
         // currently be doing.
         m_texture->deleteLater();
     }
@@ -4177,6 +4177,9 @@ void QQuickContext2D::init(QQuickCanvasItem *canvasItem, const QVariantMap &args
     case QQuickCanvasItem::FramebufferObject:
         m_texture = new QQuickContext2DFBOTexture;
         break;
+    case QQuickCanvasItem::Geometry:
+        m_texture = new QQuickContext2DGeometryTexture;
+        break;
     }
 
     m_texture->setItem(canvasItem);
@@ -255,12 +255,120 @@ static void qt_drawImage(QPainter *p, QQuickContext2D::State& state, QImage imag
     p->endNativePainting();
 }
 
-void QQuickContext2DCommandBuffer::replay(QPainter* p, QQuickContext2D::State& state, const QVector2D &scaleFactor)
+/*
+    Records the bounds of every command which draws, so that replay() can skip
+    the commands which don't touch the region it paints. \a initialState is the
+    state the buffer will be replayed with.
+*/
+void QQuickContext2DCommandBuffer::computeBounds(const QQuickContext2D::State& initialState)
+{
+    QQuickContext2D::State state = initialState;
+    reset();
+    bounds.fill(QRectF(), commands.size());
+
+    while (hasNext()) {
+        const int index = cmdIdx;
+        QRectF r;
+        switch (takeNextCommand()) {
+        case QQuickContext2D::UpdateMatrix:
+            state.matrix = takeMatrix();
+            continue;
+        case QQuickContext2D::ClearRect:
+            bounds[index] = state.matrix.mapRect(takeRect()).adjusted(-1, -1, 1, 1);
+            continue;
+        case QQuickContext2D::FillRect:
+            r = takeRect().normalized();
+            break;
+        case QQuickContext2D::Fill:
+            r = takePath().controlPointRect();
+            break;
+        case QQuickContext2D::Stroke:
+        {
+            // Miter joins reach out up to miterLimit half widths, square caps sqrt(2).
+            qreal d = state.lineWidth / 2;
+            d *= (state.lineJoin == Qt::MiterJoin) ? qMax(state.miterLimit, qreal(1.5)) : qreal(1.5);
+            r = takePath().controlPointRect().adjusted(-d, -d, d, d);
+            break;
+        }
+        case QQuickContext2D::DrawImage:
+            takeRect();
+            r = takeRect();
+            takeImage();
+            break;
+        case QQuickContext2D::DrawPixmap:
+            takeRect();
+            r = takeRect();
+            // resolve the image here, replay() may run on several threads at once
+            takePixmap()->image();
+            break;
+        case QQuickContext2D::ShadowColor:
+            state.shadowColor = takeColor();
+            continue;
+        case QQuickContext2D::ShadowBlur:
+            state.shadowBlur = takeShadowBlur();
+            continue;
+        case QQuickContext2D::ShadowOffsetX:
+            state.shadowOffsetX = takeShadowOffsetX();
+            continue;
+        case QQuickContext2D::ShadowOffsetY:
+            state.shadowOffsetY = takeShadowOffsetY();
+            continue;
+        case QQuickContext2D::FillStyle:
+            takeFillStyle();
+            takeBool();
+            takeBool();
+            continue;
+        case QQuickContext2D::StrokeStyle:
+            takeStrokeStyle();
+            takeBool();
+            takeBool();
+            continue;
+        case QQuickContext2D::LineWidth:
+            state.lineWidth = takeLineWidth();
+            continue;
+        case QQuickContext2D::LineCap:
+            takeLineCap();
+            continue;
+        case QQuickContext2D::LineJoin:
+            state.lineJoin = takeLineJoin();
+            continue;
+        case QQuickContext2D::MiterLimit:
+            state.miterLimit = takeMiterLimit();
+            continue;
+        case QQuickContext2D::Clip:
+            takePath();
+            continue;
+        case QQuickContext2D::GlobalAlpha:
+            takeGlobalAlpha();
+            continue;
+        case QQuickContext2D::GlobalCompositeOperation:
+            takeGlobalCompositeOperation();
+            continue;
+        default:
+            continue;
+        }
+
+        if (HAS_SHADOW(state.shadowOffsetX, state.shadowOffsetY, state.shadowBlur, state.shadowColor)) {
+            const qreal blur = 2 * state.shadowBlur;
+            r |= r.translated(state.shadowOffsetX, state.shadowOffsetY).adjusted(-blur, -blur, blur, blur);
+        }
+        // leave room for antialiasing
+        bounds[index] = state.matrix.mapRect(r).adjusted(-1, -1, 1, 1);
+    }
+    reset();
+}
+
+/*
+    Replays the commands with \a p. If \a region is valid, the commands known
+    by computeBounds() to draw outside of it only update the state.
+*/
+void QQuickContext2DCommandBuffer::replay(QPainter* p, QQuickContext2D::State& state, const QVector2D &scaleFactor, const QRectF &region)
 {
     if (!p)
         return;
 
     reset();
+    const bool cull = region.isValid() && bounds.size() == commands.size();
 
     p->scale(scaleFactor.x(), scaleFactor.y());
     QTransform originMatrix = p->worldTransform();
@@ -269,6 +377,7 @@ void QQuickContext2DCommandBuffer::replay(QPainter* p, QQuickContext2D::State& s
     setPainterState(p, state, pen);
 
     while (hasNext()) {
+        const bool culled = cull && !bounds.at(cmdIdx).intersects(region);
         QQuickContext2D::PaintCommand cmd = takeNextCommand();
         switch (cmd) {
         case QQuickContext2D::UpdateMatrix:
@@ -279,15 +388,20 @@ void QQuickContext2DCommandBuffer::replay(QPainter* p, QQuickContext2D::State& s
         }
         case QQuickContext2D::ClearRect:
         {
+            QRectF r = takeRect();
+            if (culled)
+                break;
             QPainter::CompositionMode  cm = p->compositionMode();
             p->setCompositionMode(QPainter::CompositionMode_Clear);
-            p->fillRect(takeRect(), Qt::white);
+            p->fillRect(r, Qt::white);
             p->setCompositionMode(cm);
             break;
         }
         case QQuickContext2D::FillRect:
         {
             QRectF r = takeRect();
+            if (culled)
+                break;
             if (HAS_SHADOW(state.shadowOffsetX, state.shadowOffsetY, state.shadowBlur, state.shadowColor))
                 fillRectShadow(p, r, state.shadowOffsetX, state.shadowOffsetY, state.shadowBlur, state.shadowColor);
             else
@@ -371,6 +485,8 @@ void QQuickContext2DCommandBuffer::replay(QPainter* p, QQuickContext2D::State& s
         case QQuickContext2D::Fill:
         {
             QPainterPath path = takePath();
+            if (culled)
+                break;
             path.closeSubpath();
             if (HAS_SHADOW(state.shadowOffsetX, state.shadowOffsetY, state.shadowBlur, state.shadowColor))
                 fillShadowPath(p,path, state.shadowOffsetX, state.shadowOffsetY, state.shadowBlur, state.shadowColor);
@@ -380,10 +496,13 @@ void QQuickContext2DCommandBuffer::replay(QPainter* p, QQuickContext2D::State& s
         }
         case QQuickContext2D::Stroke:
         {
+            QPainterPath path = takePath();
+            if (culled)
+                break;
             if (HAS_SHADOW(state.shadowOffsetX, state.shadowOffsetY, state.shadowBlur, state.shadowColor))
-                strokeShadowPath(p,takePath(), state.shadowOffsetX, state.shadowOffsetY, state.shadowBlur, state.shadowColor);
+                strokeShadowPath(p, path, state.shadowOffsetX, state.shadowOffsetY, state.shadowBlur, state.shadowColor);
             else
-                p->strokePath(takePath(), p->pen());
+                p->strokePath(path, p->pen());
             break;
         }
         case QQuickContext2D::Clip:
@@ -409,7 +528,10 @@ void QQuickContext2DCommandBuffer::replay(QPainter* p, QQuickContext2D::State& s
         {
             QRectF sr = takeRect();
             QRectF dr = takeRect();
-            qt_drawImage(p, state, takeImage(), sr, dr, HAS_SHADOW(state.shadowOffsetX, state.shadowOffsetY, state.shadowBlur, state.shadowColor));
+            const QImage &image = takeImage();
+            if (culled)
+                break;
+            qt_drawImage(p, state, image, sr, dr, HAS_SHADOW(state.shadowOffsetX, state.shadowOffsetY, state.shadowBlur, state.shadowColor));
             break;
         }
         case QQuickContext2D::DrawPixmap:
@@ -419,6 +541,8 @@ void QQuickContext2DCommandBuffer::replay(QPainter* p, QQuickContext2D::State& s
 
             QQmlRefPointer<QQuickCanvasPixmap> pix = takePixmap();
             Q_ASSERT(!pix.isNull());
+            if (culled)
+                break;
 
             const bool hasShadow = HAS_SHADOW(state.shadowOffsetX, state.shadowOffsetY, state.shadowBlur, state.shadowColor);
             //TODO: generate shadow blur with shaders
@@ -459,6 +583,37 @@ QQuickContext2DCommandBuffer::QQuickContext2DCommandBuffer()
 }
 
 
+/*
+    Shares the recorded commands of \a other, so that it can be replayed by
+    several threads at once.
+*/
+QQuickContext2DCommandBuffer::QQuickContext2DCommandBuffer(const QQuickContext2DCommandBuffer &other)
+    : cmdIdx(0)
+    , intIdx(0)
+    , boolIdx(0)
+    , realIdx(0)
+    , rectIdx(0)
+    , colorIdx(0)
+    , matrixIdx(0)
+    , brushIdx(0)
+    , pathIdx(0)
+    , imageIdx(0)
+    , pixmapIdx(0)
+    , commands(other.commands)
+    , ints(other.ints)
+    , bools(other.bools)
+    , reals(other.reals)
+    , rects(other.rects)
+    , colors(other.colors)
+    , matrixes(other.matrixes)
+    , brushes(other.brushes)
+    , pathes(other.pathes)
+    , images(other.images)
+    , pixmaps(other.pixmaps)
+    , bounds(other.bounds)
+{
+}
+
 QQuickContext2DCommandBuffer::~QQuickContext2DCommandBuffer()
 {
 }
@@ -476,6 +631,7 @@ void QQuickContext2DCommandBuffer::clear()
     pathes.clear();
     images.clear();
     pixmaps.clear();
+    bounds.clear();
     reset();
 }
 
@@ -49,14 +49,29 @@
 
 #include <QOpenGLFramebufferObject>
 #include <QOpenGLFramebufferObjectFormat>
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
 #include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/qmath.h>
 #include <QtGui/QGuiApplication>
+#include <QtGui/private/qtriangulator_p.h>
+#include <QtGui/private/qtriangulatingstroker_p.h>
+#include <QtGui/private/qvectorpath_p.h>
+#include <QtQuick/qsgnode.h>
+#include <QtQuick/qsgflatcolormaterial.h>
 #include <private/qsystrace_p.h>
 
 QT_BEGIN_NAMESPACE
 
 #define QT_MINIMUM_FBO_SIZE 64
 
+// How many batches back a shape may join a batch of the same color, provided
+// that it overlaps none of the batches in between.
+#define QT_CANVAS_BATCH_LOOKBACK 8
+
+#define HAS_SHADOW(offsetX, offsetY, blur, color) (color.isValid() && color.alpha() && (blur || offsetX || offsetY))
+
 static inline int qt_next_power_of_two(int v)
 {
     v--;
@@ -89,6 +104,48 @@ struct GLAcquireContext {
     QOpenGLContext *ctx;
 };
 
+namespace {
+
+class QQuickContext2DTilePainter : public QRunnable
+{
+public:
+    QQuickContext2DTilePainter(QQuickContext2DTile *tile, const QQuickContext2DCommandBuffer &commands,
+                               const QQuickContext2D::State &state, const QVector2D &scaleFactor,
+                               bool smooth, bool antialiasing, QSemaphore *done)
+        : state(state)
+        , m_tile(tile)
+        , m_commands(commands)
+        , m_scaleFactor(scaleFactor)
+        , m_smooth(smooth)
+        , m_antialiasing(antialiasing)
+        , m_done(done)
+    {
+    }
+
+    void run()
+    {
+        // Only cull when the tile is painted in canvas coordinates.
+        const QRectF region = m_scaleFactor == QVector2D(1, 1) ? QRectF(m_tile->rect()) : QRectF();
+        m_commands.replay(m_tile->createPainter(m_smooth, m_antialiasing), state, m_scaleFactor, region);
+        m_tile->drawFinished();
+        m_tile->markDirty(false);
+        if (m_done)
+            m_done->release();
+    }
+
+    QQuickContext2D::State state;
+
+private:
+    QQuickContext2DTile *m_tile;
+    QQuickContext2DCommandBuffer m_commands;
+    QVector2D m_scaleFactor;
+    bool m_smooth;
+    bool m_antialiasing;
+    QSemaphore *m_done;
+};
+
+}
+
 QQuickContext2DTexture::QQuickContext2DTexture()
     : m_context(0)
     , m_gl(0)
@@ -276,17 +333,39 @@ void QQuickContext2DTexture::paint(QQuickContext2DCommandBuffer *ccb)
         }
 
         if (beginPainting()) {
-            QQuickContext2D::State oldState = m_state;
+            QList<QQuickContext2DTile*> dirtyTiles;
             foreach (QQuickContext2DTile* tile, m_tiles) {
-                if (tile->dirty()) {
-                    ccb->replay(tile->createPainter(m_smooth, m_antialiasing), oldState, scaleFactor());
-                    tile->drawFinished();
-                    tile->markDirty(false);
+                if (tile->dirty())
+                    dirtyTiles.append(tile);
+            }
+
+            // Each tile only replays the commands which draw into it.
+            ccb->computeBounds(m_state);
+            const QVector2D sf = scaleFactor();
+            QQuickContext2D::State state = m_state;
+
+            if (renderTarget() == QQuickCanvasItem::Image && dirtyTiles.size() > 1) {
+                // Image tiles share nothing but the commands, so all but the last one
+                // are painted in the thread pool while this thread paints the last.
+                QSemaphore done;
+                for (int i = 0; i < dirtyTiles.size() - 1; ++i)
+                    QThreadPool::globalInstance()->start(new QQuickContext2DTilePainter(dirtyTiles.at(i), *ccb, m_state, sf, m_smooth, m_antialiasing, &done));
+                QQuickContext2DTilePainter last(dirtyTiles.last(), *ccb, m_state, sf, m_smooth, m_antialiasing, &done);
+                last.run();
+                done.acquire(dirtyTiles.size());
+                state = last.state;
+            } else {
+                foreach (QQuickContext2DTile* tile, dirtyTiles) {
+                    QQuickContext2DTilePainter painter(tile, *ccb, m_state, sf, m_smooth, m_antialiasing, 0);
+                    painter.run();
+                    state = painter.state;
                 }
-                compositeTile(tile);
             }
+
+            foreach (QQuickContext2DTile* tile, m_tiles)
+                compositeTile(tile);
             endPainting();
-            m_state = oldState;
+            m_state = state;
             markDirtyTexture();
         }
     }
@@ -743,4 +822,514 @@ void QQuickContext2DImageTexture::compositeTile(QQuickContext2DTile* tile)
     }
 }
 
+static inline uint qt_hash_real(qreal r)
+{
+    if (r == 0)
+        return 0; // 0.0 and -0.0
+    uint h = 0;
+    const uchar *p = reinterpret_cast<const uchar *>(&r);
+    for (uint i = 0; i < sizeof(qreal); ++i)
+        h = 31 * h + p[i];
+    return h;
+}
+
+uint QQuickContext2DGeometryTexture::Shape::geometryHash() const
+{
+    uint h = kind * 2 + path.fillRule();
+    if (kind == Stroke) {
+        h = 31 * h + qt_hash_real(pen.widthF());
+        h = 31 * h + pen.capStyle() + pen.joinStyle();
+    }
+    h = 31 * h + qt_hash_real(matrix.m11());
+    h = 31 * h + qt_hash_real(matrix.m12());
+    h = 31 * h + qt_hash_real(matrix.m21());
+    h = 31 * h + qt_hash_real(matrix.m22());
+    h = 31 * h + qt_hash_real(matrix.dx());
+    h = 31 * h + qt_hash_real(matrix.dy());
+    const int count = path.elementCount();
+    for (int i = 0; i < count; ++i) {
+        const QPainterPath::Element &e = path.elementAt(i);
+        h = 31 * h + e.type;
+        h = 31 * h + qt_hash_real(e.x);
+        h = 31 * h + qt_hash_real(e.y);
+    }
+    return h;
+}
+
+bool QQuickContext2DGeometryTexture::Shape::hasSameGeometry(const Shape &other) const
+{
+    if (kind != other.kind || matrix != other.matrix)
+        return false;
+    if (kind == Stroke && (pen.widthF() != other.pen.widthF()
+                           || pen.capStyle() != other.pen.capStyle()
+                           || pen.joinStyle() != other.pen.joinStyle()
+                           || pen.miterLimit() != other.pen.miterLimit()))
+        return false;
+    return path == other.path;
+}
+
+QQuickContext2DGeometryTexture::QQuickContext2DGeometryTexture()
+    : QQuickContext2DTexture()
+    , m_paintCount(0)
+    , m_warned(false)
+{
+}
+
+QQuickContext2DGeometryTexture::~QQuickContext2DGeometryTexture()
+{
+}
+
+QQuickCanvasItem::RenderTarget QQuickContext2DGeometryTexture::renderTarget() const
+{
+    return QQuickCanvasItem::Geometry;
+}
+
+QQuickContext2DTile* QQuickContext2DGeometryTexture::createTile() const
+{
+    return 0;
+}
+
+void QQuickContext2DGeometryTexture::compositeTile(QQuickContext2DTile *)
+{
+}
+
+QSGTexture *QQuickContext2DGeometryTexture::textureForNextFrame(QSGTexture *)
+{
+    return 0;
+}
+
+void QQuickContext2DGeometryTexture::warnUnsupported(const char *what)
+{
+    if (m_warned)
+        return;
+    m_warned = true;
+    qWarning("Canvas: the Geometry render target does not support %s, ignoring", what);
+}
+
+/*
+    Turns the path of \a shape into triangles in canvas coordinates, reusing the
+    triangles of a shape with the same geometry from the current or the last paint.
+*/
+void QQuickContext2DGeometryTexture::tessellate(Shape *shape)
+{
+    const uint hash = shape->geometryHash();
+    for (QMultiHash<uint, Shape>::iterator it = m_cache.find(hash); it != m_cache.end() && it.key() == hash; ++it) {
+        if (it->hasSameGeometry(*shape)) {
+            it->lastUsed = m_paintCount;
+            shape->vertices = it->vertices;
+            shape->bounds = it->bounds;
+            return;
+        }
+    }
+
+    QVector<QSGGeometry::Point2D> vertices;
+    if (shape->kind == Shape::Stroke) {
+        QTriangulatingStroker stroker;
+        const qreal scale = qSqrt(qAbs(shape->matrix.determinant()));
+        if (scale > 0)
+            stroker.setInvScale(1 / scale);
+        stroker.process(qtVectorPathForPath(shape->path), shape->pen, QRectF(), QPainter::RenderHints());
+
+        // The stroker produces one triangle strip. Split it into triangles, dropping
+        // the degenerate ones which join its pieces, so that strokes can be batched
+        // with fills.
+        const float *v = stroker.vertices();
+        const int count = stroker.vertexCount() / 2;
+        vertices.reserve(qMax(0, count - 2) * 3);
+        QPointF a, b;
+        for (int i = 0; i < count; ++i) {
+            const QPointF c = shape->matrix.map(QPointF(v[2 * i], v[2 * i + 1]));
+            if (i >= 2 && a != b && b != c && a != c) {
+                QSGGeometry::Point2D p[3];
+                p[0].set(a.x(), a.y());
+                p[1].set(b.x(), b.y());
+                p[2].set(c.x(), c.y());
+                vertices.append(p[0]);
+                vertices.append(p[1]);
+                vertices.append(p[2]);
+            }
+            a = b;
+            b = c;
+        }
+    } else {
+        const QTriangleSet triangles = qTriangulate(shape->path, shape->matrix, 1);
+        const int count = triangles.indices.size();
+        vertices.resize(count);
+        QSGGeometry::Point2D *dst = vertices.data();
+        const qreal *src = triangles.vertices.constData();
+        if (triangles.indices.type() == QVertexIndexVector::UnsignedInt) {
+            const quint32 *indices = static_cast<const quint32 *>(triangles.indices.data());
+            for (int i = 0; i < count; ++i)
+                dst[i].set(src[2 * indices[i]], src[2 * indices[i] + 1]);
+        } else {
+            const quint16 *indices = static_cast<const quint16 *>(triangles.indices.data());
+            for (int i = 0; i < count; ++i)
+                dst[i].set(src[2 * indices[i]], src[2 * indices[i] + 1]);
+        }
+    }
+
+    QRectF bounds;
+    if (!vertices.isEmpty()) {
+        float x1 = vertices.at(0).x;
+        float y1 = vertices.at(0).y;
+        float x2 = x1;
+        float y2 = y1;
+        for (int i = 1; i < vertices.size(); ++i) {
+            const QSGGeometry::Point2D &p = vertices.at(i);
+            x1 = qMin(x1, p.x);
+            y1 = qMin(y1, p.y);
+            x2 = qMax(x2, p.x);
+            y2 = qMax(y2, p.y);
+        }
+        bounds = QRectF(QPointF(x1, y1), QPointF(x2, y2));
+    }
+
+    shape->vertices = vertices;
+    shape->bounds = bounds;
+    shape->lastUsed = m_paintCount;
+    m_cache.insert(hash, *shape);
+}
+
+/*
+    Adds \a shape to the last batch of its color, unless a batch of another color
+    drawn after that one overlaps it.
+*/
+void QQuickContext2DGeometryTexture::addShape(const Shape &shape)
+{
+    if (shape.vertices.isEmpty())
+        return;
+
+    int index = m_batches.size();
+    for (int i = m_batches.size() - 1; i >= qMax(0, m_batches.size() - QT_CANVAS_BATCH_LOOKBACK); --i) {
+        const Batch &batch = m_batches.at(i);
+        if (batch.color == shape.color) {
+            index = i;
+            break;
+        }
+        if (batch.bounds.intersects(shape.bounds))
+            break;
+    }
+
+    if (index == m_batches.size()) {
+        m_batches.append(Batch());
+        m_batches.last().color = shape.color;
+    }
+
+    Batch &batch = m_batches[index];
+    batch.shapes.append(shape);
+    batch.bounds |= shape.bounds;
+    batch.vertexCount += shape.vertices.size();
+    batch.dirty = true;
+}
+
+/*
+    Removes the shapes which lie inside \a rect. Geometry can't be cut, so shapes
+    which \a rect only partly covers are kept.
+*/
+void QQuickContext2DGeometryTexture::clearShapes(const QRectF &rect)
+{
+    bool empty = true;
+    bool partial = false;
+    for (int i = 0; i < m_batches.size(); ++i) {
+        Batch &batch = m_batches[i];
+        if (batch.bounds.intersects(rect)) {
+            QList<Shape>::iterator it = batch.shapes.begin();
+            while (it != batch.shapes.end()) {
+                if (rect.contains(it->bounds)) {
+                    batch.vertexCount -= it->vertices.size();
+                    batch.dirty = true;
+                    it = batch.shapes.erase(it);
+                } else {
+                    if (rect.intersects(it->bounds))
+                        partial = true;
+                    ++it;
+                }
+            }
+            if (batch.shapes.isEmpty())
+                batch.bounds = QRectF();
+        }
+        if (!batch.shapes.isEmpty())
+            empty = false;
+    }
+
+    if (empty)
+        m_batches.clear();
+    if (partial)
+        warnUnsupported("clearRect() over part of a shape");
+}
+
+void QQuickContext2DGeometryTexture::paint(QQuickContext2DCommandBuffer *ccb)
+{
+    QSystraceEvent systrace("graphics", "QQuickContext2DGeometryTexture::paint");
+    QQuickContext2D::mutex.lock();
+    if (canvasDestroyed()) {
+        delete ccb;
+        QQuickContext2D::mutex.unlock();
+        return;
+    }
+    QQuickContext2D::mutex.unlock();
+
+    ++m_paintCount;
+
+    // Tessellate first, the batches are only locked for merging the results.
+    QList<Shape> shapes;
+    QQuickContext2D::State &state = m_state;
+    ccb->reset();
+    while (ccb->hasNext()) {
+        Shape::Kind kind = Shape::Fill;
+        QPainterPath path;
+        switch (ccb->takeNextCommand()) {
+        case QQuickContext2D::UpdateMatrix:
+            state.matrix = ccb->takeMatrix();
+            continue;
+        case QQuickContext2D::ClearRect:
+        {
+            const QRectF rect = ccb->takeRect();
+            if (state.matrix.type() > QTransform::TxScale) {
+                warnUnsupported("clearRect() with a rotated or sheared transform");
+                continue;
+            }
+            Shape clear;
+            clear.kind = Shape::Clear;
+            clear.bounds = state.matrix.mapRect(rect);
+            shapes.append(clear);
+            continue;
+        }
+        case QQuickContext2D::FillRect:
+            path.addRect(ccb->takeRect());
+            break;
+        case QQuickContext2D::Fill:
+            path = ccb->takePath();
+            path.closeSubpath();
+            break;
+        case QQuickContext2D::Stroke:
+            kind = Shape::Stroke;
+            path = ccb->takePath();
+            break;
+        case QQuickContext2D::ShadowColor:
+            state.shadowColor = ccb->takeColor();
+            continue;
+        case QQuickContext2D::ShadowBlur:
+            state.shadowBlur = ccb->takeShadowBlur();
+            continue;
+        case QQuickContext2D::ShadowOffsetX:
+            state.shadowOffsetX = ccb->takeShadowOffsetX();
+            continue;
+        case QQuickContext2D::ShadowOffsetY:
+            state.shadowOffsetY = ccb->takeShadowOffsetY();
+            continue;
+        case QQuickContext2D::FillStyle:
+            state.fillStyle = ccb->takeFillStyle();
+            state.fillPatternRepeatX = ccb->takeBool();
+            state.fillPatternRepeatY = ccb->takeBool();
+            continue;
+        case QQuickContext2D::StrokeStyle:
+            state.strokeStyle = ccb->takeStrokeStyle();
+            state.strokePatternRepeatX = ccb->takeBool();
+            state.strokePatternRepeatY = ccb->takeBool();
+            continue;
+        case QQuickContext2D::LineWidth:
+            state.lineWidth = ccb->takeLineWidth();
+            continue;
+        case QQuickContext2D::LineCap:
+            state.lineCap = ccb->takeLineCap();
+            continue;
+        case QQuickContext2D::LineJoin:
+            state.lineJoin = ccb->takeLineJoin();
+            continue;
+        case QQuickContext2D::MiterLimit:
+            state.miterLimit = ccb->takeMiterLimit();
+            continue;
+        case QQuickContext2D::Clip:
+            state.clipPath = ccb->takePath();
+            warnUnsupported("clip()");
+            continue;
+        case QQuickContext2D::GlobalAlpha:
+            state.globalAlpha = ccb->takeGlobalAlpha();
+            continue;
+        case QQuickContext2D::GlobalCompositeOperation:
+            state.globalCompositeOperation = ccb->takeGlobalCompositeOperation();
+            continue;
+        case QQuickContext2D::DrawImage:
+            ccb->takeRect();
+            ccb->takeRect();
+            ccb->takeImage();
+            warnUnsupported("drawImage()");
+            continue;
+        case QQuickContext2D::DrawPixmap:
+            ccb->takeRect();
+            ccb->takeRect();
+            ccb->takePixmap();
+            warnUnsupported("drawImage()");
+            continue;
+        default:
+            continue;
+        }
+
+        const QBrush &brush = kind == Shape::Stroke ? state.strokeStyle : state.fillStyle;
+        if (brush.style() != Qt::SolidPattern) {
+            warnUnsupported("gradients and patterns");
+            continue;
+        }
+        if (state.globalCompositeOperation != QPainter::CompositionMode_SourceOver) {
+            warnUnsupported("composite operations other than source-over");
+            continue;
+        }
+        if (HAS_SHADOW(state.shadowOffsetX, state.shadowOffsetY, state.shadowBlur, state.shadowColor))
+            warnUnsupported("shadows");
+
+        Shape shape;
+        shape.kind = kind;
+        shape.path = path;
+        shape.matrix = state.matrix;
+        shape.color = brush.color();
+        shape.color.setAlphaF(shape.color.alphaF() * state.globalAlpha);
+        if (!shape.color.alpha())
+            continue;
+        if (kind == Shape::Stroke) {
+            shape.pen.setWidthF(state.lineWidth);
+            shape.pen.setCapStyle(state.lineCap);
+            shape.pen.setJoinStyle(state.lineJoin);
+            shape.pen.setMiterLimit(state.miterLimit);
+        }
+        tessellate(&shape);
+        shapes.append(shape);
+    }
+    delete ccb;
+
+    if (m_onCustomThread)
+        m_mutex.lock();
+    foreach (const Shape &shape, shapes) {
+        if (shape.kind == Shape::Clear)
+            clearShapes(shape.bounds);
+        else
+            addShape(shape);
+    }
+    if (m_onCustomThread)
+        m_mutex.unlock();
+
+    // Keep the triangles of the shapes drawn by this and the last paint only.
+    QMultiHash<uint, Shape>::iterator it = m_cache.begin();
+    while (it != m_cache.end()) {
+        if (m_paintCount - it->lastUsed > 1)
+            it = m_cache.erase(it);
+        else
+            ++it;
+    }
+
+    markDirtyTexture();
+}
+
+QSGNode *QQuickContext2DGeometryTexture::updateNode(QSGNode *oldNode)
+{
+    QSGClipNode *clipNode = static_cast<QSGClipNode *>(oldNode);
+    QSGTransformNode *transformNode;
+    if (!clipNode) {
+        clipNode = new QSGClipNode;
+        clipNode->setIsRectangular(true);
+        clipNode->setGeometry(new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 4));
+        clipNode->setFlag(QSGNode::OwnsGeometry);
+        transformNode = new QSGTransformNode;
+        clipNode->appendChildNode(transformNode);
+    } else {
+        transformNode = static_cast<QSGTransformNode *>(clipNode->firstChild());
+    }
+
+    if (m_onCustomThread)
+        m_mutex.lock();
+
+    const QRectF rect(QPointF(0, 0), m_canvasWindow.size());
+    if (clipNode->clipRect() != rect) {
+        QSGGeometry::updateRectGeometry(clipNode->geometry(), rect);
+        clipNode->setClipRect(rect);
+        clipNode->markDirty(QSGNode::DirtyGeometry);
+    }
+    QMatrix4x4 matrix;
+    matrix.translate(-m_canvasWindow.x(), -m_canvasWindow.y());
+    if (transformNode->matrix() != matrix)
+        transformNode->setMatrix(matrix);
+
+    // There is one node per batch, and only the batches which changed are uploaded again.
+    QSGNode *child = transformNode->firstChild();
+    for (int i = 0; i < m_batches.size(); ++i) {
+        Batch &batch = m_batches[i];
+        QSGGeometryNode *node = static_cast<QSGGeometryNode *>(child);
+        if (!node) {
+            node = new QSGGeometryNode;
+            QSGGeometry *geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0);
+            geometry->setDrawingMode(GL_TRIANGLES);
+            node->setGeometry(geometry);
+            node->setMaterial(new QSGFlatColorMaterial);
+            node->setFlags(QSGNode::OwnsGeometry | QSGNode::OwnsMaterial);
+            transformNode->appendChildNode(node);
+            batch.dirty = true;
+        }
+        child = node->nextSibling();
+        if (!batch.dirty)
+            continue;
+
+        QSGFlatColorMaterial *material = static_cast<QSGFlatColorMaterial *>(node->material());
+        if (material->color() != batch.color) {
+            material->setColor(batch.color);
+            node->markDirty(QSGNode::DirtyMaterial);
+        }
+
+        QSGGeometry *geometry = node->geometry();
+        geometry->allocate(batch.vertexCount);
+        QSGGeometry::Point2D *vertices = geometry->vertexDataAsPoint2D();
+        foreach (const Shape &shape, batch.shapes) {
+            memcpy(vertices, shape.vertices.constData(), shape.vertices.size() * sizeof(QSGGeometry::Point2D));
+            vertices += shape.vertices.size();
+        }
+        node->markDirty(QSGNode::DirtyGeometry);
+        batch.dirty = false;
+    }
+
+    while (child) {
+        QSGNode *next = child->nextSibling();
+        transformNode->removeChildNode(child);
+        delete child;
+        child = next;
+    }
+
+    if (m_onCustomThread)
+        m_mutex.unlock();
+
+    return clipNode;
+}
+
+void QQuickContext2DGeometryTexture::grabImage(const QRectF& rf)
+{
+    Q_ASSERT(rf.isValid());
+    QQuickContext2D::mutex.lock();
+    if (m_context) {
+        QImage image(m_canvasWindow.size(), QImage::Format_ARGB32_Premultiplied);
+        image.fill(0x00000000);
+
+        QPainter p(&image);
+        p.setRenderHint(QPainter::Antialiasing, m_antialiasing);
+        p.translate(-m_canvasWindow.topLeft());
+        const QTransform originMatrix = p.transform();
+
+        // A shape only joins an earlier batch when nothing in between overlaps it,
+        // so drawing batch by batch gives the same picture as the draw order.
+        foreach (const Batch &batch, m_batches) {
+            foreach (const Shape &shape, batch.shapes) {
+                p.setTransform(shape.matrix * originMatrix);
+                if (shape.kind == Shape::Stroke) {
+                    QPen pen = shape.pen;
+                    pen.setColor(shape.color);
+                    p.strokePath(shape.path, pen);
+                } else {
+                    p.fillPath(shape.path, shape.color);
+                }
+            }
+        }
+        p.end();
+
+        m_context->setGrabbedImage(image.copy(rf.toRect()));
+    }
+    QQuickContext2D::mutex.unlock();
+}
+
 QT_END_NAMESPACE
@@ -43,12 +43,14 @@
 #define QQUICKCONTEXT2DTEXTURE_P_H
 
 #include <QtQuick/qsgtexture.h>
+#include <QtQuick/qsggeometry.h>
 #include "qquickcanvasitem_p.h"
 #include "qquickcontext2d_p.h"
 
 #include <QOpenGLContext>
 #include <QOpenGLFramebufferObject>
 
+#include <QtCore/QHash>
 #include <QtCore/QMutex>
 #include <QtCore/QWaitCondition>
 #include <QtCore/QThread>
@@ -123,7 +125,7 @@ Q_SIGNALS:
 
 public Q_SLOTS:
     void canvasChanged(const QSize& canvasSize, const QSize& tileSize, const QRect& canvasWindow, const QRect& dirtyRect, bool smooth, bool antialiasing);
-    void paint(QQuickContext2DCommandBuffer *ccb);
+    virtual void paint(QQuickContext2DCommandBuffer *ccb);
     void markDirtyTexture();
     void setItem(QQuickCanvasItem* item);
     virtual void grabImage(const QRectF& region = QRectF()) = 0;
@@ -228,6 +230,65 @@ private:
     QPainter m_painter;
 };
 
+class QSGNode;
+class QQuickContext2DGeometryTexture : public QQuickContext2DTexture
+{
+    Q_OBJECT
+
+public:
+    QQuickContext2DGeometryTexture();
+    ~QQuickContext2DGeometryTexture();
+
+    virtual QQuickCanvasItem::RenderTarget renderTarget() const;
+
+    virtual QQuickContext2DTile* createTile() const;
+    virtual void compositeTile(QQuickContext2DTile* tile);
+
+    virtual QSGTexture *textureForNextFrame(QSGTexture *lastFrame);
+
+    // Called during sync() on the scene graph thread while GUI is blocked.
+    QSGNode *updateNode(QSGNode *oldNode);
+
+public Q_SLOTS:
+    virtual void paint(QQuickContext2DCommandBuffer *ccb);
+    virtual void grabImage(const QRectF& region = QRectF());
+
+private:
+    struct Shape {
+        enum Kind { Fill, Stroke, Clear };
+        Shape() : kind(Fill), lastUsed(0) {}
+        uint geometryHash() const;
+        bool hasSameGeometry(const Shape &other) const;
+        QPainterPath path;
+        QTransform matrix;
+        QPen pen;
+        QColor color;
+        QRectF bounds;
+        QVector<QSGGeometry::Point2D> vertices;
+        Kind kind;
+        uint lastUsed;
+    };
+
+    struct Batch {
+        Batch() : vertexCount(0), dirty(true) {}
+        QColor color;
+        QRectF bounds;
+        QList<Shape> shapes;
+        int vertexCount;
+        bool dirty;
+    };
+
+    void tessellate(Shape *shape);
+    void addShape(const Shape &shape);
+    void clearShapes(const QRectF &rect);
+    void warnUnsupported(const char *what);
+
+    QList<Batch> m_batches;
+    QMultiHash<uint, Shape> m_cache;
+    uint m_paintCount;
+    bool m_warned;
+};
+
 QT_END_NAMESPACE
 
 #endif // QQUICKCONTEXT2DTEXTURE_P_H
@@ -177,12 +177,17 @@ void QQuickAnchorsPrivate::fillChanged()
 
         qreal horizontalMargin = q->mirrored() ? rightMargin : leftMargin;
 
+        Geometry geometry(item);
         if (fill == item->parentItem()) {                         //child-parent
-            setItemPos(QPointF(horizontalMargin, topMargin));
+            geometry.setX(horizontalMargin);
+            geometry.setY(topMargin);
         } else if (fill->parentItem() == item->parentItem()) {   //siblings
-            setItemPos(QPointF(fill->x()+horizontalMargin, fill->y()+topMargin));
+            geometry.setX(fill->x()+horizontalMargin);
+            geometry.setY(fill->y()+topMargin);
         }
-        setItemSize(QSizeF(fill->width()-leftMargin-rightMargin, fill->height()-topMargin-bottomMargin));
+        geometry.setWidth(fill->width()-leftMargin-rightMargin);
+        geometry.setHeight(fill->height()-topMargin-bottomMargin);
+        setItemGeometry(geometry);
 
         --updatingFill;
     } else {
@@ -202,16 +207,15 @@ void QQuickAnchorsPrivate::centerInChanged()
         ++updatingCenterIn;
 
         qreal effectiveHCenterOffset = q->mirrored() ? -hCenterOffset : hCenterOffset;
+        Geometry geometry(item);
         if (centerIn == item->parentItem()) {
-            QPointF p(hcenter(item->parentItem()) - hcenter(item) + effectiveHCenterOffset,
-                      vcenter(item->parentItem()) - vcenter(item) + vCenterOffset);
-            setItemPos(p);
-
+            geometry.setX(hcenter(item->parentItem()) - hcenter(item) + effectiveHCenterOffset);
+            geometry.setY(vcenter(item->parentItem()) - vcenter(item) + vCenterOffset);
         } else if (centerIn->parentItem() == item->parentItem()) {
-            QPointF p(centerIn->x() + hcenter(centerIn) - hcenter(item) + effectiveHCenterOffset,
-                      centerIn->y() + vcenter(centerIn) - vcenter(item) + vCenterOffset);
-            setItemPos(p);
+            geometry.setX(centerIn->x() + hcenter(centerIn) - hcenter(item) + effectiveHCenterOffset);
+            geometry.setY(centerIn->y() + vcenter(centerIn) - vcenter(item) + vCenterOffset);
         }
+        setItemGeometry(geometry);
 
         --updatingCenterIn;
     } else {
@@ -367,45 +371,44 @@ void QQuickAnchors::componentComplete()
     d->componentComplete = true;
 }
 
-void QQuickAnchorsPrivate::setItemHeight(qreal v)
+QQuickAnchorsPrivate::Geometry::Geometry(QQuickItem *item)
+    : rect(item->x(), item->y(), item->width(), item->height())
+    , components(QQuickItemPrivate::NoChange)
 {
-    updatingMe = true;
-    item->setHeight(v);
-    updatingMe = false;
 }
 
-void QQuickAnchorsPrivate::setItemWidth(qreal v)
+void QQuickAnchorsPrivate::Geometry::setX(qreal x)
 {
-    updatingMe = true;
-    item->setWidth(v);
-    updatingMe = false;
+    rect.moveLeft(x);
+    components |= QQuickItemPrivate::XChange;
 }
 
-void QQuickAnchorsPrivate::setItemX(qreal v)
+void QQuickAnchorsPrivate::Geometry::setY(qreal y)
 {
-    updatingMe = true;
-    item->setX(v);
-    updatingMe = false;
+    rect.moveTop(y);
+    components |= QQuickItemPrivate::YChange;
 }
 
-void QQuickAnchorsPrivate::setItemY(qreal v)
+void QQuickAnchorsPrivate::Geometry::setWidth(qreal w)
 {
-    updatingMe = true;
-    item->setY(v);
-    updatingMe = false;
+    rect.setWidth(w);
+    components |= QQuickItemPrivate::WidthChange;
 }
 
-void QQuickAnchorsPrivate::setItemPos(const QPointF &v)
+void QQuickAnchorsPrivate::Geometry::setHeight(qreal h)
 {
-    updatingMe = true;
-    item->setPosition(v);
-    updatingMe = false;
+    rect.setHeight(h);
+    components |= QQuickItemPrivate::HeightChange;
 }
 
-void QQuickAnchorsPrivate::setItemSize(const QSizeF &v)
+void QQuickAnchorsPrivate::setItemGeometry(const Geometry &geometry)
 {
+    if (!geometry.components)
+        return;
+
     updatingMe = true;
-    item->setSize(v);
+    QQuickItemPrivate::get(item)->setGeometry(geometry.rect,
+            QQuickItemPrivate::GeometryChangeTypes(geometry.components));
     updatingMe = false;
 }
 
@@ -438,20 +441,16 @@ void QQuickAnchorsPrivate::update()
 {
     fillChanged();
     centerInChanged();
-    if (usedAnchors & QQuickAnchorLine::Horizontal_Mask)
-        updateHorizontalAnchors();
-    if (usedAnchors & QQuickAnchorLine::Vertical_Mask)
-        updateVerticalAnchors();
+    updateAnchors(usedAnchors & QQuickAnchorLine::Horizontal_Mask,
+                  usedAnchors & QQuickAnchorLine::Vertical_Mask);
 }
 
 void QQuickAnchorsPrivate::itemGeometryChanged(QQuickItem *, const QRectF &newG, const QRectF &oldG)
 {
     fillChanged();
     centerInChanged();
-    if ((usedAnchors & QQuickAnchorLine::Horizontal_Mask) && (newG.x() != oldG.x() || newG.width() != oldG.width()))
-        updateHorizontalAnchors();
-    if ((usedAnchors & QQuickAnchorLine::Vertical_Mask) && (newG.y() != oldG.y() || newG.height() != oldG.height()))
-        updateVerticalAnchors();
+    updateAnchors((usedAnchors & QQuickAnchorLine::Horizontal_Mask) && (newG.x() != oldG.x() || newG.width() != oldG.width()),
+                  (usedAnchors & QQuickAnchorLine::Vertical_Mask) && (newG.y() != oldG.y() || newG.height() != oldG.height()));
 }
 
 QQuickItem *QQuickAnchors::fill() const
@@ -555,70 +554,101 @@ bool QQuickAnchorsPrivate::calcStretch(const QQuickAnchorLine &edge1,
     return invalid;
 }
 
-void QQuickAnchorsPrivate::updateVerticalAnchors()
+/*
+    Updates the horizontal and/or vertical anchors. Both directions are collected into one
+    geometry and applied together, so that an item anchored on all sides notifies the items
+    anchored to it once, not once per direction and component.
+*/
+void QQuickAnchorsPrivate::updateAnchors(bool horizontal, bool vertical)
 {
     if (fill || centerIn || !isItemComplete())
         return;
 
-    if (updatingVerticalAnchor < 2) {
+    if (horizontal && updatingHorizontalAnchor >= 3) {
+        // ### Make this certain :)
+        qmlInfo(item) << QQuickAnchors::tr("Possible anchor loop detected on horizontal anchor.");
+        horizontal = false;
+    }
+    if (vertical && updatingVerticalAnchor >= 2) {
+        // ### Make this certain :)
+        qmlInfo(item) << QQuickAnchors::tr("Possible anchor loop detected on vertical anchor.");
+        vertical = false;
+    }
+    if (!horizontal && !vertical)
+        return;
+
+    Geometry geometry(item);
+    if (horizontal) {
+        ++updatingHorizontalAnchor;
+        horizontalGeometry(geometry);
+    }
+    if (vertical) {
         ++updatingVerticalAnchor;
-        if (usedAnchors & QQuickAnchors::TopAnchor) {
-            //Handle stretching
-            bool invalid = true;
+        verticalGeometry(geometry);
+    }
+
+    setItemGeometry(geometry);
+
+    if (horizontal)
+        --updatingHorizontalAnchor;
+    if (vertical)
+        --updatingVerticalAnchor;
+}
+
+void QQuickAnchorsPrivate::verticalGeometry(Geometry &geometry)
+{
+    if (usedAnchors & QQuickAnchors::TopAnchor) {
+        //Handle stretching
+        bool invalid = true;
+        qreal height = 0.0;
+        if (usedAnchors & QQuickAnchors::BottomAnchor) {
+            invalid = calcStretch(top, bottom, topMargin, -bottomMargin, QQuickAnchorLine::Top, height);
+        } else if (usedAnchors & QQuickAnchors::VCenterAnchor) {
+            invalid = calcStretch(top, vCenter, topMargin, vCenterOffset, QQuickAnchorLine::Top, height);
+            height *= 2;
+        }
+        if (!invalid)
+            geometry.setHeight(height);
+
+        //Handle top
+        if (top.item == item->parentItem()) {
+            geometry.setY(adjustedPosition(top.item, top.anchorLine) + topMargin);
+        } else if (top.item->parentItem() == item->parentItem()) {
+            geometry.setY(position(top.item, top.anchorLine) + topMargin);
+        }
+    } else if (usedAnchors & QQuickAnchors::BottomAnchor) {
+        //Handle stretching (top + bottom case is handled above)
+        if (usedAnchors & QQuickAnchors::VCenterAnchor) {
             qreal height = 0.0;
-            if (usedAnchors & QQuickAnchors::BottomAnchor) {
-                invalid = calcStretch(top, bottom, topMargin, -bottomMargin, QQuickAnchorLine::Top, height);
-            } else if (usedAnchors & QQuickAnchors::VCenterAnchor) {
-                invalid = calcStretch(top, vCenter, topMargin, vCenterOffset, QQuickAnchorLine::Top, height);
-                height *= 2;
-            }
+            bool invalid = calcStretch(vCenter, bottom, vCenterOffset, -bottomMargin,
+                                          QQuickAnchorLine::Top, height);
             if (!invalid)
-                setItemHeight(height);
-
-            //Handle top
-            if (top.item == item->parentItem()) {
-                setItemY(adjustedPosition(top.item, top.anchorLine) + topMargin);
-            } else if (top.item->parentItem() == item->parentItem()) {
-                setItemY(position(top.item, top.anchorLine) + topMargin);
-            }
-        } else if (usedAnchors & QQuickAnchors::BottomAnchor) {
-            //Handle stretching (top + bottom case is handled above)
-            if (usedAnchors & QQuickAnchors::VCenterAnchor) {
-                qreal height = 0.0;
-                bool invalid = calcStretch(vCenter, bottom, vCenterOffset, -bottomMargin,
-                                              QQuickAnchorLine::Top, height);
-                if (!invalid)
-                    setItemHeight(height*2);
-            }
-
-            //Handle bottom
-            if (bottom.item == item->parentItem()) {
-                setItemY(adjustedPosition(bottom.item, bottom.anchorLine) - item->height() - bottomMargin);
-            } else if (bottom.item->parentItem() == item->parentItem()) {
-                setItemY(position(bottom.item, bottom.anchorLine) - item->height() - bottomMargin);
-            }
-        } else if (usedAnchors & QQuickAnchors::VCenterAnchor) {
-            //(stetching handled above)
-
-            //Handle vCenter
-            if (vCenter.item == item->parentItem()) {
-                setItemY(adjustedPosition(vCenter.item, vCenter.anchorLine)
-                              - vcenter(item) + vCenterOffset);
-            } else if (vCenter.item->parentItem() == item->parentItem()) {
-                setItemY(position(vCenter.item, vCenter.anchorLine) - vcenter(item) + vCenterOffset);
-            }
-        } else if (usedAnchors & QQuickAnchors::BaselineAnchor) {
-            //Handle baseline
-            if (baseline.item == item->parentItem()) {
-                setItemY(adjustedPosition(baseline.item, baseline.anchorLine) - item->baselineOffset() + baselineOffset);
-            } else if (baseline.item->parentItem() == item->parentItem()) {
-                setItemY(position(baseline.item, baseline.anchorLine) - item->baselineOffset() + baselineOffset);
-            }
+                geometry.setHeight(height*2);
+        }
+
+        //Handle bottom
+        if (bottom.item == item->parentItem()) {
+            geometry.setY(adjustedPosition(bottom.item, bottom.anchorLine) - geometry.rect.height() - bottomMargin);
+        } else if (bottom.item->parentItem() == item->parentItem()) {
+            geometry.setY(position(bottom.item, bottom.anchorLine) - geometry.rect.height() - bottomMargin);
+        }
+    } else if (usedAnchors & QQuickAnchors::VCenterAnchor) {
+        //(stetching handled above)
+
+        //Handle vCenter
+        if (vCenter.item == item->parentItem()) {
+            geometry.setY(adjustedPosition(vCenter.item, vCenter.anchorLine)
+                          - vcenter(item) + vCenterOffset);
+        } else if (vCenter.item->parentItem() == item->parentItem()) {
+            geometry.setY(position(vCenter.item, vCenter.anchorLine) - vcenter(item) + vCenterOffset);
+        }
+    } else if (usedAnchors & QQuickAnchors::BaselineAnchor) {
+        //Handle baseline
+        if (baseline.item == item->parentItem()) {
+            geometry.setY(adjustedPosition(baseline.item, baseline.anchorLine) - item->baselineOffset() + baselineOffset);
+        } else if (baseline.item->parentItem() == item->parentItem()) {
+            geometry.setY(position(baseline.item, baseline.anchorLine) - item->baselineOffset() + baselineOffset);
         }
-        --updatingVerticalAnchor;
-    } else {
-        // ### Make this certain :)
-        qmlInfo(item) << QQuickAnchors::tr("Possible anchor loop detected on vertical anchor.");
     }
 }
 
@@ -633,87 +663,77 @@ inline QQuickAnchorLine::AnchorLine reverseAnchorLine(QQuickAnchorLine::AnchorLi
     }
 }
 
-void QQuickAnchorsPrivate::updateHorizontalAnchors()
+void QQuickAnchorsPrivate::horizontalGeometry(Geometry &geometry)
 {
     Q_Q(QQuickAnchors);
-    if (fill || centerIn || !isItemComplete())
-        return;
+    qreal effectiveRightMargin, effectiveLeftMargin, effectiveHorizontalCenterOffset;
+    QQuickAnchorLine effectiveLeft, effectiveRight, effectiveHorizontalCenter;
+    QQuickAnchors::Anchor effectiveLeftAnchor, effectiveRightAnchor;
+    if (q->mirrored()) {
+        effectiveLeftAnchor = QQuickAnchors::RightAnchor;
+        effectiveRightAnchor = QQuickAnchors::LeftAnchor;
+        effectiveLeft.item = right.item;
+        effectiveLeft.anchorLine = reverseAnchorLine(right.anchorLine);
+        effectiveRight.item = left.item;
+        effectiveRight.anchorLine = reverseAnchorLine(left.anchorLine);
+        effectiveHorizontalCenter.item = hCenter.item;
+        effectiveHorizontalCenter.anchorLine = reverseAnchorLine(hCenter.anchorLine);
+        effectiveLeftMargin = rightMargin;
+        effectiveRightMargin = leftMargin;
+        effectiveHorizontalCenterOffset = -hCenterOffset;
+    } else {
+        effectiveLeftAnchor = QQuickAnchors::LeftAnchor;
+        effectiveRightAnchor = QQuickAnchors::RightAnchor;
+        effectiveLeft = left;
+        effectiveRight = right;
+        effectiveHorizontalCenter = hCenter;
+        effectiveLeftMargin = leftMargin;
+        effectiveRightMargin = rightMargin;
+        effectiveHorizontalCenterOffset = hCenterOffset;
+    }
 
-    if (updatingHorizontalAnchor < 3) {
-        ++updatingHorizontalAnchor;
-        qreal effectiveRightMargin, effectiveLeftMargin, effectiveHorizontalCenterOffset;
-        QQuickAnchorLine effectiveLeft, effectiveRight, effectiveHorizontalCenter;
-        QQuickAnchors::Anchor effectiveLeftAnchor, effectiveRightAnchor;
-        if (q->mirrored()) {
-            effectiveLeftAnchor = QQuickAnchors::RightAnchor;
-            effectiveRightAnchor = QQuickAnchors::LeftAnchor;
-            effectiveLeft.item = right.item;
-            effectiveLeft.anchorLine = reverseAnchorLine(right.anchorLine);
-            effectiveRight.item = left.item;
-            effectiveRight.anchorLine = reverseAnchorLine(left.anchorLine);
-            effectiveHorizontalCenter.item = hCenter.item;
-            effectiveHorizontalCenter.anchorLine = reverseAnchorLine(hCenter.anchorLine);
-            effectiveLeftMargin = rightMargin;
-            effectiveRightMargin = leftMargin;
-            effectiveHorizontalCenterOffset = -hCenterOffset;
-        } else {
-            effectiveLeftAnchor = QQuickAnchors::LeftAnchor;
-            effectiveRightAnchor = QQuickAnchors::RightAnchor;
-            effectiveLeft = left;
-            effectiveRight = right;
-            effectiveHorizontalCenter = hCenter;
-            effectiveLeftMargin = leftMargin;
-            effectiveRightMargin = rightMargin;
-            effectiveHorizontalCenterOffset = hCenterOffset;
+    if (usedAnchors & effectiveLeftAnchor) {
+        //Handle stretching
+        bool invalid = true;
+        qreal width = 0.0;
+        if (usedAnchors & effectiveRightAnchor) {
+            invalid = calcStretch(effectiveLeft, effectiveRight, effectiveLeftMargin, -effectiveRightMargin, QQuickAnchorLine::Left, width);
+        } else if (usedAnchors & QQuickAnchors::HCenterAnchor) {
+            invalid = calcStretch(effectiveLeft, effectiveHorizontalCenter, effectiveLeftMargin, effectiveHorizontalCenterOffset, QQuickAnchorLine::Left, width);
+            width *= 2;
         }
-
-        if (usedAnchors & effectiveLeftAnchor) {
-            //Handle stretching
-            bool invalid = true;
+        if (!invalid)
+            geometry.setWidth(width);
+
+        //Handle left
+        if (effectiveLeft.item == item->parentItem()) {
+            geometry.setX(adjustedPosition(effectiveLeft.item, effectiveLeft.anchorLine) + effectiveLeftMargin);
+        } else if (effectiveLeft.item->parentItem() == item->parentItem()) {
+            geometry.setX(position(effectiveLeft.item, effectiveLeft.anchorLine) + effectiveLeftMargin);
+        }
+    } else if (usedAnchors & effectiveRightAnchor) {
+        //Handle stretching (left + right case is handled in updateLeftAnchor)
+        if (usedAnchors & QQuickAnchors::HCenterAnchor) {
             qreal width = 0.0;
-            if (usedAnchors & effectiveRightAnchor) {
-                invalid = calcStretch(effectiveLeft, effectiveRight, effectiveLeftMargin, -effectiveRightMargin, QQuickAnchorLine::Left, width);
-            } else if (usedAnchors & QQuickAnchors::HCenterAnchor) {
-                invalid = calcStretch(effectiveLeft, effectiveHorizontalCenter, effectiveLeftMargin, effectiveHorizontalCenterOffset, QQuickAnchorLine::Left, width);
-                width *= 2;
-            }
+            bool invalid = calcStretch(effectiveHorizontalCenter, effectiveRight, effectiveHorizontalCenterOffset, -effectiveRightMargin,
+                                          QQuickAnchorLine::Left, width);
             if (!invalid)
-                setItemWidth(width);
-
-            //Handle left
-            if (effectiveLeft.item == item->parentItem()) {
-                setItemX(adjustedPosition(effectiveLeft.item, effectiveLeft.anchorLine) + effectiveLeftMargin);
-            } else if (effectiveLeft.item->parentItem() == item->parentItem()) {
-                setItemX(position(effectiveLeft.item, effectiveLeft.anchorLine) + effectiveLeftMargin);
-            }
-        } else if (usedAnchors & effectiveRightAnchor) {
-            //Handle stretching (left + right case is handled in updateLeftAnchor)
-            if (usedAnchors & QQuickAnchors::HCenterAnchor) {
-                qreal width = 0.0;
-                bool invalid = calcStretch(effectiveHorizontalCenter, effectiveRight, effectiveHorizontalCenterOffset, -effectiveRightMargin,
-                                              QQuickAnchorLine::Left, width);
-                if (!invalid)
-                    setItemWidth(width*2);
-            }
-
-            //Handle right
-            if (effectiveRight.item == item->parentItem()) {
-                setItemX(adjustedPosition(effectiveRight.item, effectiveRight.anchorLine) - item->width() - effectiveRightMargin);
-            } else if (effectiveRight.item->parentItem() == item->parentItem()) {
-                setItemX(position(effectiveRight.item, effectiveRight.anchorLine) - item->width() - effectiveRightMargin);
-            }
-        } else if (usedAnchors & QQuickAnchors::HCenterAnchor) {
-            //Handle hCenter
-            if (effectiveHorizontalCenter.item == item->parentItem()) {
-                setItemX(adjustedPosition(effectiveHorizontalCenter.item, effectiveHorizontalCenter.anchorLine) - hcenter(item) + effectiveHorizontalCenterOffset);
-            } else if (effectiveHorizontalCenter.item->parentItem() == item->parentItem()) {
-                setItemX(position(effectiveHorizontalCenter.item, effectiveHorizontalCenter.anchorLine) - hcenter(item) + effectiveHorizontalCenterOffset);
-            }
+                geometry.setWidth(width*2);
+        }
+
+        //Handle right
+        if (effectiveRight.item == item->parentItem()) {
+            geometry.setX(adjustedPosition(effectiveRight.item, effectiveRight.anchorLine) - geometry.rect.width() - effectiveRightMargin);
+        } else if (effectiveRight.item->parentItem() == item->parentItem()) {
+            geometry.setX(position(effectiveRight.item, effectiveRight.anchorLine) - geometry.rect.width() - effectiveRightMargin);
+        }
+    } else if (usedAnchors & QQuickAnchors::HCenterAnchor) {
+        //Handle hCenter
+        if (effectiveHorizontalCenter.item == item->parentItem()) {
+            geometry.setX(adjustedPosition(effectiveHorizontalCenter.item, effectiveHorizontalCenter.anchorLine) - hcenter(item) + effectiveHorizontalCenterOffset);
+        } else if (effectiveHorizontalCenter.item->parentItem() == item->parentItem()) {
+            geometry.setX(position(effectiveHorizontalCenter.item, effectiveHorizontalCenter.anchorLine) - hcenter(item) + effectiveHorizontalCenterOffset);
         }
-        --updatingHorizontalAnchor;
-    } else {
-        // ### Make this certain :)
-        qmlInfo(item) << QQuickAnchors::tr("Possible anchor loop detected on horizontal anchor.");
     }
 }
 
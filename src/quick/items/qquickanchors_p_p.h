@@ -122,12 +122,20 @@ public:
     uint updatingFill:2;
     uint updatingCenterIn:2;
 
-    void setItemHeight(qreal);
-    void setItemWidth(qreal);
-    void setItemX(qreal);
-    void setItemY(qreal);
-    void setItemPos(const QPointF &);
-    void setItemSize(const QSizeF &);
+    // The geometry one anchor update wants to give the item. It is applied with a single
+    // geometry change, so that items anchored to this one are only updated once.
+    struct Geometry {
+        Geometry(QQuickItem *item);
+
+        void setX(qreal x);
+        void setY(qreal y);
+        void setWidth(qreal w);
+        void setHeight(qreal h);
+
+        QRectF rect;
+        int components; // QQuickItemPrivate::GeometryChangeTypes
+    };
+    void setItemGeometry(const Geometry &);
 
     void update();
     void updateOnComplete();
@@ -144,8 +152,11 @@ public:
     bool calcStretch(const QQuickAnchorLine &edge1, const QQuickAnchorLine &edge2, qreal offset1, qreal offset2, QQuickAnchorLine::AnchorLine line, qreal &stretch);
 
     bool isMirrored() const;
-    void updateHorizontalAnchors();
-    void updateVerticalAnchors();
+    void updateHorizontalAnchors() { updateAnchors(true, false); }
+    void updateVerticalAnchors() { updateAnchors(false, true); }
+    void updateAnchors(bool horizontal, bool vertical);
+    void horizontalGeometry(Geometry &);
+    void verticalGeometry(Geometry &);
     void fillChanged();
     void centerInChanged();
 
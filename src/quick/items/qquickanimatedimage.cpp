@@ -47,11 +47,296 @@
 #include <QtQml/qqmlinfo.h>
 #include <QtQml/qqmlfile.h>
 #include <QtQml/qqmlengine.h>
-#include <QtGui/qmovie.h>
+#include <QtGui/qimagereader.h>
 #include <QtNetwork/qnetworkrequest.h>
 #include <QtNetwork/qnetworkreply.h>
+#include <QtCore/qabstractanimation.h>
+#include <QtCore/qbuffer.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qmap.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qrunnable.h>
+#include <QtCore/qthreadpool.h>
 
 QT_BEGIN_NAMESPACE
+
+// Number of frames decoded ahead of the one shown.
+#ifndef QML_ANIMATEDIMAGE_PREFETCH_FRAMES
+#define QML_ANIMATEDIMAGE_PREFETCH_FRAMES 3
+#endif
+
+// Animations whose decoded frames take up to this many bytes keep all of them, and their
+// textures, after the first loop.  Larger animations are decoded again on every loop.
+#ifndef QML_ANIMATEDIMAGE_CACHE_SIZE
+#define QML_ANIMATEDIMAGE_CACHE_SIZE (4 * 1024 * 1024)
+#endif
+
+/*
+    Decodes the frames of an animation with a QImageReader.  The frames following the one
+    shown are decoded ahead in a thread of the global thread pool, only frames which are
+    needed straight away, like the first one or the target of a jump, are decoded in the
+    GUI thread.
+
+    The reader is guarded by readerMutex and the decoded frames by mutex, so that taking a
+    ready frame never waits for a frame being decoded.
+*/
+class QQuickAnimatedImageDecoder
+{
+public:
+    enum Result { Ready, Pending, End };
+
+    struct Frame {
+        Frame() : delay(0) {}
+        QImage image;
+        int delay;
+    };
+
+    QQuickAnimatedImageDecoder(const QString &fileName, const QByteArray &data)
+        : frameCount(0), loopCount(0), fileName(fileName), data(data), nextIndex(0), endIndex(-1)
+        , prefetchFrom(0), prefetchCount(0), running(false), cancelled(false)
+    {
+    }
+
+    bool open();
+    Result frame(int index, Frame *frame, bool wait);
+    bool prefetch(int index);
+    void cancel();
+    void run();
+
+    int frameCount;
+    int loopCount;
+    QSize size;
+
+private:
+    Result decode(int index, Frame *frame);
+    bool isWanted(int index) const;
+    int nextWanted() const;
+
+    const QString fileName;
+    QByteArray data;
+
+    QMutex readerMutex;
+    QScopedPointer<QIODevice> device;
+    QScopedPointer<QImageReader> reader;
+    QByteArray format;
+    int nextIndex;
+
+    QMutex mutex;
+    QMap<int, Frame> frames;
+    int endIndex;
+    int prefetchFrom;
+    int prefetchCount;
+    bool running;
+    bool cancelled;
+};
+
+namespace {
+
+class AnimatedImageDecodeRunnable : public QRunnable
+{
+public:
+    AnimatedImageDecodeRunnable(const QSharedPointer<QQuickAnimatedImageDecoder> &decoder) : decoder(decoder) {}
+    void run() { decoder->run(); }
+
+private:
+    QSharedPointer<QQuickAnimatedImageDecoder> decoder;
+};
+
+}
+
+/*
+    Opens the animation and reads its header, returns false if it can't be read.  Called in
+    the GUI thread before any frame is decoded.
+*/
+bool QQuickAnimatedImageDecoder::open()
+{
+    if (!fileName.isEmpty())
+        device.reset(new QFile(fileName));
+    else
+        device.reset(new QBuffer(&data));
+    if (!device->open(QIODevice::ReadOnly))
+        return false;
+
+    reader.reset(new QImageReader(device.data()));
+    format = reader->format();
+    if (!reader->canRead())
+        return false;
+
+    frameCount = reader->imageCount();
+    loopCount = reader->loopCount();
+    size = reader->size();
+    return true;
+}
+
+/*
+    Returns frame \a index in \a frame if it has been decoded ahead.  Otherwise the frame is
+    decoded straight away if \a wait is true, or Pending is returned.  End is returned for
+    frames past the end of the animation.
+*/
+QQuickAnimatedImageDecoder::Result QQuickAnimatedImageDecoder::frame(int index, Frame *frame, bool wait)
+{
+    {
+        QMutexLocker locker(&mutex);
+        QMap<int, Frame>::iterator it = frames.find(index);
+        if (it != frames.end()) {
+            *frame = it.value();
+            frames.erase(it);
+            return Ready;
+        }
+        if (endIndex >= 0 && index >= endIndex)
+            return End;
+        if (!wait)
+            return Pending;
+    }
+
+    QMutexLocker readerLocker(&readerMutex);
+    {
+        // decoded by the worker while waiting for the reader
+        QMutexLocker locker(&mutex);
+        QMap<int, Frame>::iterator it = frames.find(index);
+        if (it != frames.end()) {
+            *frame = it.value();
+            frames.erase(it);
+            return Ready;
+        }
+    }
+    return decode(index, frame);
+}
+
+// must be called with readerMutex locked
+QQuickAnimatedImageDecoder::Result QQuickAnimatedImageDecoder::decode(int index, Frame *frame)
+{
+    if (index < nextIndex) {
+        // Most animation formats can only be read from the start.
+        device->seek(0);
+        reader.reset(new QImageReader(device.data(), format));
+        nextIndex = 0;
+    }
+
+    while (nextIndex <= index) {
+        Frame decoded;
+        if (reader->canRead())
+            decoded.image = reader->read();
+        if (decoded.image.isNull()) {
+            QMutexLocker locker(&mutex);
+            endIndex = nextIndex;
+            return End;
+        }
+        decoded.delay = reader->nextImageDelay();
+
+        // Convert to a format textures are created from without another conversion.
+        if (decoded.image.format() != QImage::Format_RGB32
+                && decoded.image.format() != QImage::Format_ARGB32_Premultiplied) {
+            decoded.image = decoded.image.convertToFormat(decoded.image.hasAlphaChannel()
+                    ? QImage::Format_ARGB32_Premultiplied
+                    : QImage::Format_RGB32);
+        }
+
+        const int decodedIndex = nextIndex++;
+        if (decodedIndex == index && frame) {
+            *frame = decoded;
+            return Ready;
+        }
+
+        QMutexLocker locker(&mutex);
+        if (isWanted(decodedIndex))
+            frames.insert(decodedIndex, decoded);
+    }
+    return Ready;
+}
+
+// must be called with mutex locked
+bool QQuickAnimatedImageDecoder::isWanted(int index) const
+{
+    const int count = endIndex >= 0 ? endIndex : frameCount;
+    for (int i = 0; i < prefetchCount; ++i) {
+        const int wanted = count > 0 ? (prefetchFrom + i) % count : prefetchFrom + i;
+        if (wanted == index)
+            return true;
+    }
+    return false;
+}
+
+// must be called with mutex locked
+int QQuickAnimatedImageDecoder::nextWanted() const
+{
+    const int count = endIndex >= 0 ? endIndex : frameCount;
+    if (count == 0 && endIndex == 0)
+        return -1;
+    for (int i = 0; i < prefetchCount; ++i) {
+        const int index = count > 0 ? (prefetchFrom + i) % count : prefetchFrom + i;
+        if (endIndex >= 0 && index >= endIndex)
+            return -1;
+        if (!frames.contains(index))
+            return index;
+    }
+    return -1;
+}
+
+/*
+    Starts decoding the frames from \a index on ahead and drops the frames decoded earlier
+    which are no longer needed.  Returns true if a worker needs to be started for it.
+*/
+bool QQuickAnimatedImageDecoder::prefetch(int index)
+{
+    QMutexLocker locker(&mutex);
+    prefetchFrom = index;
+    prefetchCount = QML_ANIMATEDIMAGE_PREFETCH_FRAMES;
+    for (QMap<int, Frame>::iterator it = frames.begin(); it != frames.end();) {
+        if (isWanted(it.key()))
+            ++it;
+        else
+            it = frames.erase(it);
+    }
+
+    if (running || cancelled || nextWanted() == -1)
+        return false;
+    running = true;
+    return true;
+}
+
+void QQuickAnimatedImageDecoder::cancel()
+{
+    QMutexLocker locker(&mutex);
+    cancelled = true;
+    frames.clear();
+}
+
+void QQuickAnimatedImageDecoder::run()
+{
+    forever {
+        int index;
+        {
+            QMutexLocker locker(&mutex);
+            index = cancelled ? -1 : nextWanted();
+            if (index == -1) {
+                running = false;
+                return;
+            }
+        }
+
+        QMutexLocker readerLocker(&readerMutex);
+        decode(index, 0);
+    }
+}
+
+class QQuickAnimatedImageClock : public QAbstractAnimation
+{
+public:
+    QQuickAnimatedImageClock(QQuickAnimatedImagePrivate *image, QObject *parent)
+        : QAbstractAnimation(parent), image(image)
+    {
+    }
+
+    int duration() const { return -1; }
+
+protected:
+    void updateCurrentTime(int time) { image->advance(time); }
+
+private:
+    QQuickAnimatedImagePrivate *image;
+};
+
 /*!
     \qmltype AnimatedImage
     \instantiates QQuickAnimatedImage
@@ -69,7 +354,7 @@ QT_BEGIN_NAMESPACE
     start, pause and stop the animation by changing the values of the \l playing
     and \l paused properties.
 
-    The full list of supported formats can be determined with QMovie::supportedFormats().
+    The full list of supported formats can be determined with QImageReader::supportedImageFormats().
 
     \section1 Example Usage
 
@@ -110,7 +395,177 @@ QQuickAnimatedImage::~QQuickAnimatedImage()
     Q_D(QQuickAnimatedImage);
     if (d->reply)
         d->reply->deleteLater();
-    delete d->_movie;
+    d->resetAnimation();
+}
+
+void QQuickAnimatedImagePrivate::resetAnimation()
+{
+    if (decoder) {
+        decoder->cancel();
+        decoder.clear();
+    }
+    if (clock)
+        clock->stop();
+    qDeleteAll(frames);
+    frames.clear();
+    frameDelays.clear();
+    frameSize = QSize();
+
+    state = NotRunning;
+    currentFrameNumber = -1;
+    nextFrameNumber = 0;
+    nextDelay = 0;
+    playCounter = -1;
+    isFirstIteration = true;
+    cacheFrames = false;
+}
+
+void QQuickAnimatedImagePrivate::setState(State newState)
+{
+    Q_Q(QQuickAnimatedImage);
+    if (state == newState)
+        return;
+    state = newState;
+
+    if (state == Running) {
+        if (!clock)
+            clock = new QQuickAnimatedImageClock(this, q);
+        // the clock calls advance(0) when it starts
+        frameDue = qMax(nextDelay, 1);
+        clock->start();
+    } else if (clock) {
+        clock->stop();
+    }
+
+    if ((state != NotRunning) != playing) {
+        playing = (state != NotRunning);
+        emit q->playingChanged();
+    }
+    if ((state == Paused) != paused) {
+        paused = (state == Paused);
+        emit q->pausedChanged();
+    }
+}
+
+/*
+    Shows the next frame if it is available, and loops back to the first one at the end of
+    the animation as often as the animation asks for.  Returns false if there is no next
+    frame, or if it is still being decoded and \a wait is false, in which case \a pending is
+    set to true.
+*/
+bool QQuickAnimatedImagePrivate::nextFrame(bool wait, bool *pending)
+{
+    QQuickAnimatedImageDecoder::Frame frame;
+    QQuickAnimatedImageDecoder::Result result;
+    QQuickPixmap *cached = frames.value(nextFrameNumber);
+    if (cached)
+        result = QQuickAnimatedImageDecoder::Ready;
+    else if (decoder->frameCount > 0 && nextFrameNumber >= decoder->frameCount)
+        result = QQuickAnimatedImageDecoder::End;
+    else
+        result = decoder->frame(nextFrameNumber, &frame, wait);
+
+    if (result == QQuickAnimatedImageDecoder::Pending) {
+        prefetch(nextFrameNumber);
+        *pending = true;
+        return false;
+    }
+
+    if (result == QQuickAnimatedImageDecoder::End) {
+        // No frames could be read at all.
+        if (nextFrameNumber == 0)
+            return false;
+        // End of the first iteration, initialize the play counter
+        if (isFirstIteration) {
+            playCounter = decoder->loopCount;
+            isFirstIteration = false;
+        }
+        if (playCounter != 0) {
+            if (playCounter != -1)
+                playCounter--;
+            nextFrameNumber = 0;
+            return nextFrame(wait, pending);
+        }
+        return false;
+    }
+
+    currentFrameNumber = nextFrameNumber++;
+    if (!cached && cacheFrames) {
+        // Keeping the pixmap keeps its texture factory, and so the texture it was uploaded to.
+        cached = new QQuickPixmap(url, frame.image);
+        if (frames.count() <= currentFrameNumber) {
+            frames.resize(currentFrameNumber + 1);
+            frameDelays.resize(currentFrameNumber + 1);
+        }
+        frames[currentFrameNumber] = cached;
+        frameDelays[currentFrameNumber] = frame.delay;
+    }
+
+    if (cached) {
+        setPixmap(*cached);
+        nextDelay = frameDelays.at(currentFrameNumber);
+    } else {
+        setImage(frame.image);
+        nextDelay = frame.delay;
+    }
+    frameSize = pix.implicitSize();
+
+    prefetch(nextFrameNumber);
+    return true;
+}
+
+void QQuickAnimatedImagePrivate::loadNextFrame(bool starting, bool wait)
+{
+    Q_Q(QQuickAnimatedImage);
+    bool pending = false;
+    if (nextFrame(wait, &pending)) {
+        if (starting && state == NotRunning)
+            setState(Running);
+        else if (state == Running)
+            frameDue = clock->currentTime() + nextDelay;
+        emit q->frameChanged();
+    } else if (!pending && state != Paused) {
+        // Graceful finish
+        nextFrameNumber = 0;
+        isFirstIteration = false;
+        playCounter = -1;
+        setState(NotRunning);
+    }
+}
+
+/*
+    Called by the clock, which is driven by the animation driver of the scene graph, so
+    that frames change in step with the rendering.  A frame that isn't decoded in time stays
+    due and is shown on the first tick after it is ready.
+*/
+void QQuickAnimatedImagePrivate::advance(int time)
+{
+    if (state != Running || time < frameDue)
+        return;
+
+    bool pending = false;
+    const int due = frameDue;
+    if (nextFrame(false, &pending)) {
+        // Keep the pace of the animation, unless it fell behind by more than a frame.
+        frameDue = qMax(due + nextDelay, time);
+        emit q_func()->frameChanged();
+    } else if (!pending) {
+        nextFrameNumber = 0;
+        isFirstIteration = false;
+        playCounter = -1;
+        setState(NotRunning);
+    }
+}
+
+void QQuickAnimatedImagePrivate::prefetch(int frame)
+{
+    if (decoder->frameCount > 0)
+        frame %= decoder->frameCount;
+    // frames which have been kept don't need to be decoded again
+    if (frames.value(frame))
+        return;
+    if (decoder->prefetch(frame))
+        QThreadPool::globalInstance()->start(new AnimatedImageDecodeRunnable(decoder));
 }
 
 /*!
@@ -124,9 +579,9 @@ QQuickAnimatedImage::~QQuickAnimatedImage()
 bool QQuickAnimatedImage::isPaused() const
 {
     Q_D(const QQuickAnimatedImage);
-    if (!d->_movie)
+    if (!d->decoder)
         return d->paused;
-    return d->_movie->state()==QMovie::Paused;
+    return d->state == QQuickAnimatedImagePrivate::Paused;
 }
 
 void QQuickAnimatedImage::setPaused(bool pause)
@@ -134,11 +589,14 @@ void QQuickAnimatedImage::setPaused(bool pause)
     Q_D(QQuickAnimatedImage);
     if (pause == d->paused)
         return;
-    if (!d->_movie) {
+    if (!d->decoder) {
         d->paused = pause;
         emit pausedChanged();
+    } else if (pause) {
+        if (d->state != QQuickAnimatedImagePrivate::NotRunning)
+            d->setState(QQuickAnimatedImagePrivate::Paused);
     } else {
-        d->_movie->setPaused(pause);
+        d->setState(QQuickAnimatedImagePrivate::Running);
     }
 }
 
@@ -163,9 +621,9 @@ void QQuickAnimatedImage::setPaused(bool pause)
 bool QQuickAnimatedImage::isPlaying() const
 {
     Q_D(const QQuickAnimatedImage);
-    if (!d->_movie)
+    if (!d->decoder)
         return d->playing;
-    return d->_movie->state()!=QMovie::NotRunning;
+    return d->state != QQuickAnimatedImagePrivate::NotRunning;
 }
 
 void QQuickAnimatedImage::setPlaying(bool play)
@@ -173,15 +631,21 @@ void QQuickAnimatedImage::setPlaying(bool play)
     Q_D(QQuickAnimatedImage);
     if (play == d->playing)
         return;
-    if (!d->_movie) {
+    if (!d->decoder) {
         d->playing = play;
         emit playingChanged();
         return;
     }
-    if (play)
-        d->_movie->start();
-    else
-        d->_movie->stop();
+    if (play) {
+        if (d->state == QQuickAnimatedImagePrivate::NotRunning)
+            d->loadNextFrame(true, true);
+        else if (d->state == QQuickAnimatedImagePrivate::Paused)
+            d->setState(QQuickAnimatedImagePrivate::Running);
+    } else if (d->state != QQuickAnimatedImagePrivate::NotRunning) {
+        // starting again restarts from the first frame
+        d->setState(QQuickAnimatedImagePrivate::NotRunning);
+        d->nextFrameNumber = 0;
+    }
 }
 
 /*!
@@ -197,27 +661,30 @@ void QQuickAnimatedImage::setPlaying(bool play)
 int QQuickAnimatedImage::currentFrame() const
 {
     Q_D(const QQuickAnimatedImage);
-    if (!d->_movie)
+    if (!d->decoder)
         return d->preset_currentframe;
-    return d->_movie->currentFrameNumber();
+    return d->currentFrameNumber;
 }
 
 void QQuickAnimatedImage::setCurrentFrame(int frame)
 {
     Q_D(QQuickAnimatedImage);
-    if (!d->_movie) {
+    if (!d->decoder) {
         d->preset_currentframe = frame;
         return;
     }
-    d->_movie->jumpToFrame(frame);
+    if (frame < 0 || frame == d->currentFrameNumber)
+        return;
+    d->nextFrameNumber = frame;
+    d->loadNextFrame(false, true);
 }
 
 int QQuickAnimatedImage::frameCount() const
 {
     Q_D(const QQuickAnimatedImage);
-    if (!d->_movie)
+    if (!d->decoder)
         return 0;
-    return d->_movie->frameCount();
+    return d->decoder->frameCount;
 }
 
 void QQuickAnimatedImage::setSource(const QUrl &url)
@@ -232,10 +699,7 @@ void QQuickAnimatedImage::setSource(const QUrl &url)
     }
 
     d->oldPlaying = isPlaying();
-    if (d->_movie) {
-        delete d->_movie;
-        d->_movie = 0;
-    }
+    d->resetAnimation();
 
     d->url = url;
     emit sourceChanged(d->url);
@@ -267,7 +731,7 @@ void QQuickAnimatedImage::load()
     } else {
         QString lf = QQmlFile::urlToLocalFileOrQrc(d->url);
         if (!lf.isEmpty()) {
-            d->_movie = new QMovie(lf);
+            d->decoder = QSharedPointer<QQuickAnimatedImageDecoder>(new QQuickAnimatedImageDecoder(lf, QByteArray()));
             movieRequestFinished();
         } else {
             if (d->status != Loading) {
@@ -309,13 +773,12 @@ void QQuickAnimatedImage::movieRequestFinished()
         }
 
         d->redirectCount=0;
-        d->_movie = new QMovie(d->reply);
+        d->decoder = QSharedPointer<QQuickAnimatedImageDecoder>(new QQuickAnimatedImageDecoder(QString(), d->reply->readAll()));
     }
 
-    if (!d->_movie->isValid()) {
+    if (!d->decoder->open()) {
         qmlInfo(this) << "Error Reading Animated Image File " << d->url.toString();
-        delete d->_movie;
-        d->_movie = 0;
+        d->decoder.clear();
         d->setImage(QImage());
         if (d->progress != 0) {
             d->progress = 0;
@@ -333,11 +796,9 @@ void QQuickAnimatedImage::movieRequestFinished()
         return;
     }
 
-    connect(d->_movie, SIGNAL(stateChanged(QMovie::MovieState)),
-            this, SLOT(playingStatusChanged()));
-    connect(d->_movie, SIGNAL(frameChanged(int)),
-            this, SLOT(movieUpdate()));
-    d->_movie->setCacheMode(QMovie::CacheAll);
+    const QSize size = d->decoder->size;
+    d->cacheFrames = d->decoder->frameCount > 1
+            && qint64(d->decoder->frameCount) * size.width() * size.height() * 4 <= QML_ANIMATEDIMAGE_CACHE_SIZE;
 
     d->status = Ready;
     emit statusChanged(d->status);
@@ -348,16 +809,17 @@ void QQuickAnimatedImage::movieRequestFinished()
     }
 
     bool pausedAtStart = d->paused;
-    if (d->playing) {
-        d->_movie->start();
-    }
-    if (pausedAtStart)
-        d->_movie->setPaused(true);
+    if (d->playing)
+        d->loadNextFrame(true, true);
+    if (pausedAtStart && d->state != QQuickAnimatedImagePrivate::NotRunning)
+        d->setState(QQuickAnimatedImagePrivate::Paused);
     if (d->paused || !d->playing) {
-        d->_movie->jumpToFrame(d->preset_currentframe);
+        if (d->preset_currentframe >= 0 && d->preset_currentframe != d->currentFrameNumber) {
+            d->nextFrameNumber = d->preset_currentframe;
+            d->loadNextFrame(false, true);
+        }
         d->preset_currentframe = 0;
     }
-    d->setImage(d->_movie->currentPixmap().toImage());
 
     if (isPlaying() != d->oldPlaying)
         emit playingChanged();
@@ -367,36 +829,12 @@ void QQuickAnimatedImage::movieRequestFinished()
     }
 }
 
-void QQuickAnimatedImage::movieUpdate()
-{
-    Q_D(QQuickAnimatedImage);
-
-    if (d->_movie) {
-        d->setImage(d->_movie->currentPixmap().toImage());
-        emit frameChanged();
-    }
-}
-
-void QQuickAnimatedImage::playingStatusChanged()
-{
-    Q_D(QQuickAnimatedImage);
-
-    if ((d->_movie->state() != QMovie::NotRunning) != d->playing) {
-        d->playing = (d->_movie->state() != QMovie::NotRunning);
-        emit playingChanged();
-    }
-    if ((d->_movie->state() == QMovie::Paused) != d->paused) {
-        d->paused = (d->_movie->state() == QMovie::Paused);
-        emit pausedChanged();
-    }
-}
-
 QSize QQuickAnimatedImage::sourceSize()
 {
     Q_D(QQuickAnimatedImage);
-    if (!d->_movie)
+    if (!d->decoder)
         return QSize(0, 0);
-    return QSize(d->_movie->currentPixmap().size());
+    return d->frameSize;
 }
 
 void QQuickAnimatedImage::componentComplete()
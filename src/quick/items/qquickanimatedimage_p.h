@@ -48,7 +48,6 @@
 
 QT_BEGIN_NAMESPACE
 
-class QMovie;
 class QQuickAnimatedImagePrivate;
 
 class Q_AUTOTEST_EXPORT QQuickAnimatedImage : public QQuickImage
@@ -89,9 +88,7 @@ Q_SIGNALS:
     void sourceSizeChanged();
 
 private Q_SLOTS:
-    void movieUpdate();
     void movieRequestFinished();
-    void playingStatusChanged();
 
 protected:
     virtual void load();
@@ -55,30 +55,62 @@
 
 #include "qquickimage_p_p.h"
 
+#include <QtCore/qsharedpointer.h>
+#include <QtCore/qvector.h>
+
 #ifndef QT_NO_MOVIE
 
 QT_BEGIN_NAMESPACE
 
-class QMovie;
 class QNetworkReply;
+class QQuickAnimatedImageDecoder;
+class QQuickAnimatedImageClock;
 
 class QQuickAnimatedImagePrivate : public QQuickImagePrivate
 {
     Q_DECLARE_PUBLIC(QQuickAnimatedImage)
 
 public:
+    // The states of QMovie, which the animation used to be played with.
+    enum State { NotRunning, Paused, Running };
+
     QQuickAnimatedImagePrivate()
-      : playing(true), paused(false), preset_currentframe(0), _movie(0), reply(0), redirectCount(0), oldPlaying(false)
+      : playing(true), paused(false), preset_currentframe(0), reply(0), redirectCount(0), oldPlaying(false)
+      , clock(0), state(NotRunning), currentFrameNumber(-1), nextFrameNumber(0), nextDelay(0), frameDue(0)
+      , playCounter(-1), isFirstIteration(true), cacheFrames(false)
     {
+        // Every frame is a new image, deferring their upload would flicker.
+        deferTextureUpload = false;
     }
 
+    void resetAnimation();
+    void setState(State state);
+    void loadNextFrame(bool starting, bool wait);
+    bool nextFrame(bool wait, bool *pending);
+    void advance(int time);
+    void prefetch(int frame);
+
     bool playing;
     bool paused;
     int preset_currentframe;
-    QMovie *_movie;
     QNetworkReply *reply;
     int redirectCount;
     bool oldPlaying;
+
+    QSharedPointer<QQuickAnimatedImageDecoder> decoder;
+    QQuickAnimatedImageClock *clock;
+    QVector<QQuickPixmap *> frames;
+    QVector<int> frameDelays;
+    QSize frameSize;
+
+    State state;
+    int currentFrameNumber;
+    int nextFrameNumber;
+    int nextDelay;
+    int frameDue;
+    int playCounter;
+    bool isFirstIteration;
+    bool cacheFrames;
 };
 
 QT_END_NAMESPACE
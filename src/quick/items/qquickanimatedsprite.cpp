@@ -43,6 +43,7 @@
 #include "qquicksprite_p.h"
 #include "qquickspriteengine_p.h"
 #include <QtQuick/private/qsgcontext_p.h>
+#include <QtQuick/private/qquickitem_p.h>
 #include <private/qsgadaptationlayer_p.h>
 #include <private/qqmlglobal_p.h>
 #include <QtQuick/qsgnode.h>
@@ -70,6 +71,7 @@ public:
     }
 
     QSGTexture *texture;
+    QSharedPointer<QQuickTextureFactory> factory;
 
     float animT;
     float animX1;
@@ -95,7 +97,7 @@ QQuickAnimatedSpriteMaterial::QQuickAnimatedSpriteMaterial()
 
 QQuickAnimatedSpriteMaterial::~QQuickAnimatedSpriteMaterial()
 {
-    delete texture;
+    // the texture is owned by the render context and released with factory
 }
 
 class AnimatedSpriteMaterialData : public QSGMaterialShader
@@ -497,7 +499,13 @@ QSGGeometryNode* QQuickAnimatedSprite::buildNode()
     if (image.isNull())
         return 0;
     m_sheetSize = QSizeF(image.size());
-    m_material->texture = window()->createTextureFromImage(image);
+    m_material->factory = m_spriteEngine->textureFactory();
+    m_material->texture = QQuickItemPrivate::get(this)->sceneGraphRenderContext()->textureForFactory(m_material->factory.data(), window());
+    if (!m_material->texture) {
+        delete m_material;
+        m_material = 0;
+        return 0;
+    }
     m_material->texture->setFiltering(QSGTexture::Linear);
     m_spriteEngine->start(0);
     m_material->animT = 0;
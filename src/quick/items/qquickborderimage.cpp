@@ -552,7 +552,14 @@ QSGNode *QQuickBorderImage::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeDat
 {
     Q_D(QQuickBorderImage);
 
-    QSGTexture *texture = d->sceneGraphRenderContext()->textureForFactory(d->pix.textureFactory(), window());
+    // Asynchronous images don't need to be visible right away, so their
+    // upload may happen in the background.
+    bool uploadPending = false;
+    QSGTexture *texture = d->sceneGraphRenderContext()->textureForFactory(d->pix.textureFactory(), window(),
+                                                                           d->async ? &uploadPending : 0);
+
+    if (uploadPending)
+        update();
 
     if (!texture || width() <= 0 || height() <= 0) {
         delete oldNode;
@@ -620,7 +627,9 @@ QSGNode *QQuickBorderImage::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeDat
     node->setMirror(d->mirror);
 
     node->setFiltering(d->smooth ? QSGTexture::Linear : QSGTexture::Nearest);
-    if (innerSourceRect == QRectF(0, 0, 1, 1) && (vTiles > 1 || hTiles > 1)) {
+    // Atlas textures are tiled in the geometry, which keeps them in the atlas
+    // and batched with the other images in it.
+    if (innerSourceRect == QRectF(0, 0, 1, 1) && (vTiles > 1 || hTiles > 1) && !texture->isAtlasTexture()) {
         node->setHorizontalWrapMode(QSGTexture::Repeat);
         node->setVerticalWrapMode(QSGTexture::Repeat);
     } else {
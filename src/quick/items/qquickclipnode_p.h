@@ -44,9 +44,11 @@
 
 #include <private/qtquickglobal_p.h>
 #include <QtQuick/qsgnode.h>
+#include <private/qsgblockpool_p.h>
 
 class Q_QUICK_PRIVATE_EXPORT QQuickDefaultClipNode : public QSGClipNode
 {
+    QSG_DECLARE_POOLED_ALLOCATION
 public:
     QQuickDefaultClipNode(const QRectF &);
 
@@ -47,6 +47,7 @@
 #include "qquickevents_p_p.h"
 
 #include <QtQuick/private/qquicktransition_p.h>
+#include <QtQuick/private/qquickanimatorjob_p.h>
 #include <private/qqmlglobal_p.h>
 
 #include <QtQml/qqmlinfo.h>
@@ -212,6 +213,7 @@ private:
 QQuickFlickablePrivate::AxisData::~AxisData()
 {
     delete transitionToBounds;
+    delete asyncFlick;
 }
 
 
@@ -221,7 +223,7 @@ QQuickFlickablePrivate::QQuickFlickablePrivate()
     , vData(this, &QQuickFlickablePrivate::setViewportY)
     , hMoved(false), vMoved(false)
     , stealMouse(false), pressed(false), interactive(true), calcVelocity(false)
-    , pixelAligned(false), replayingPressEvent(false)
+    , pixelAligned(false), replayingPressEvent(false), asynchronousFlicking(false)
     , lastPosTime(-1)
     , lastPressTime(0)
     , deceleration(QML_FLICK_DEFAULTDECELERATION)
@@ -347,10 +349,13 @@ bool QQuickFlickablePrivate::flick(AxisData &data, qreal minExtent, qreal maxExt
         accel = v2 / (2.0f * qAbs(dist));
 
         resetTimeline(data);
-        if (boundsBehavior == QQuickFlickable::DragAndOvershootBounds)
+        if (boundsBehavior == QQuickFlickable::DragAndOvershootBounds) {
             timeline.accel(data.move, v, accel);
-        else
+            startAsyncFlick(data, minExtent, maxExtent, v, accel);
+        } else {
             timeline.accel(data.move, v, accel, maxDistance);
+            startAsyncFlick(data, minExtent, maxExtent, v, accel, maxDistance);
+        }
         timeline.callback(QQuickTimeLineCallback(&data.move, fixupCallback, this));
 
         if (&data == &hData)
@@ -421,6 +426,7 @@ void QQuickFlickablePrivate::adjustContentPos(AxisData &data, qreal toPos)
 void QQuickFlickablePrivate::resetTimeline(AxisData &data)
 {
     timeline.reset(data.move);
+    stopAsyncFlick(data);
     if (data.transitionToBounds)
         data.transitionToBounds->stopTransition();
 }
@@ -428,12 +434,74 @@ void QQuickFlickablePrivate::resetTimeline(AxisData &data)
 void QQuickFlickablePrivate::clearTimeline()
 {
     timeline.clear();
+    stopAsyncFlick(hData);
+    stopAsyncFlick(vData);
     if (hData.transitionToBounds)
         hData.transitionToBounds->stopTransition();
     if (vData.transitionToBounds)
         vData.transitionToBounds->stopTransition();
 }
 
+/*
+    Mirrors a fling that \a timeline has just been given for \a data with a
+    render thread animation of the content item, so that the content keeps
+    moving while the GUI thread is blocked. The GUI thread remains in charge
+    of the content position and catches up whenever it gets to run.
+
+    Only the part of the fling that stays within the extents is run on the
+    render thread; overshooting and the rebound are left to the GUI thread.
+*/
+void QQuickFlickablePrivate::startAsyncFlick(AxisData &data, qreal minExtent, qreal maxExtent,
+                                             qreal velocity, qreal accel, qreal maxDistance)
+{
+    Q_Q(QQuickFlickable);
+    stopAsyncFlick(data);
+    if (!asynchronousFlicking || !q->window() || qFuzzyIsNull(velocity) || accel <= 0)
+        return;
+
+    const qreal from = data.move.value();
+    if ((velocity > 0 && from >= minExtent) || (velocity < 0 && from <= maxExtent))
+        return;
+
+    // Same adjustment as QQuickTimeLine::accel() makes to honor maxDistance
+    if (maxDistance > 0)
+        accel = qMax(accel, velocity * velocity / (2 * maxDistance));
+
+    const qreal speed = qAbs(velocity);
+    const qreal room = velocity > 0 ? minExtent - from : from - maxExtent;
+    qreal distance = speed * speed / (2 * accel);
+    qreal time = speed / accel;
+    if (distance > room) {
+        time = (speed - qSqrt(speed * speed - 2 * accel * room)) / accel;
+        distance = room;
+    }
+    const int duration = static_cast<int>(1000 * time);
+    if (duration <= 0)
+        return;
+
+    QQuickFlickAnimatorJob *job = new QQuickFlickAnimatorJob;
+    job->setTarget(contentItem);
+    job->setOrientation(&data == &hData ? Qt::Horizontal : Qt::Vertical);
+    job->setFrom(from);
+    job->setTo(velocity > 0 ? from + distance : from - distance);
+    job->setVelocity(velocity);
+    job->setAcceleration(velocity > 0 ? -accel : accel);
+    job->setDuration(duration);
+    job->setPixelAligned(pixelAligned);
+
+    data.asyncFlick = new QQuickAnimatorProxyJob(job, q);
+    data.asyncFlick->start();
+}
+
+void QQuickFlickablePrivate::stopAsyncFlick(AxisData &data)
+{
+    if (data.asyncFlick) {
+        data.asyncFlick->stop();
+        delete data.asyncFlick;
+        data.asyncFlick = 0;
+    }
+}
+
 void QQuickFlickablePrivate::fixup(AxisData &data, qreal minExtent, qreal maxExtent)
 {
     if (data.move.value() > minExtent || maxExtent > minExtent) {
@@ -683,6 +751,9 @@ QQuickFlickable::QQuickFlickable(QQuickFlickablePrivate &dd, QQuickItem *parent)
 
 QQuickFlickable::~QQuickFlickable()
 {
+    Q_D(QQuickFlickable);
+    d->stopAsyncFlick(d->hData);
+    d->stopAsyncFlick(d->vData);
 }
 
 /*!
@@ -914,6 +985,44 @@ void QQuickFlickable::setPixelAligned(bool align)
     }
 }
 
+/*!
+    \qmlproperty bool QtQuick::Flickable::asynchronousFlicking
+    \since 5.3
+
+    This property holds whether flicks are also animated on the scene graph
+    render thread.
+
+    When enabled, the content keeps moving smoothly during a flick even if
+    the GUI thread is temporarily blocked, for example by JavaScript or by
+    delegates being created. \l contentX and \l contentY, and views filling
+    in new delegates, catch up as soon as the GUI thread gets to run again.
+    Overshooting the bounds and returning to them is always animated on the
+    GUI thread.
+
+    This only makes a difference when the scene graph renders on its own
+    thread.
+
+    The default is \c false.
+*/
+bool QQuickFlickable::asynchronousFlicking() const
+{
+    Q_D(const QQuickFlickable);
+    return d->asynchronousFlicking;
+}
+
+void QQuickFlickable::setAsynchronousFlicking(bool async)
+{
+    Q_D(QQuickFlickable);
+    if (async == d->asynchronousFlicking)
+        return;
+    d->asynchronousFlicking = async;
+    if (!async) {
+        d->stopAsyncFlick(d->hData);
+        d->stopAsyncFlick(d->vData);
+    }
+    emit asynchronousFlickingChanged();
+}
+
 qint64 QQuickFlickablePrivate::computeCurrentTime(QInputEvent *event)
 {
     if (0 != event->timestamp())
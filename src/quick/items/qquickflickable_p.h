@@ -96,6 +96,7 @@ class Q_QUICK_PRIVATE_EXPORT QQuickFlickable : public QQuickItem
     Q_PROPERTY(QQuickFlickableVisibleArea *visibleArea READ visibleArea CONSTANT)
 
     Q_PROPERTY(bool pixelAligned READ pixelAligned WRITE setPixelAligned NOTIFY pixelAlignedChanged)
+    Q_PROPERTY(bool asynchronousFlicking READ asynchronousFlicking WRITE setAsynchronousFlicking NOTIFY asynchronousFlickingChanged REVISION 1)
 
     Q_PROPERTY(QQmlListProperty<QObject> flickableData READ flickableData)
     Q_PROPERTY(QQmlListProperty<QQuickItem> flickableChildren READ flickableChildren)
@@ -184,6 +185,9 @@ public:
     bool pixelAligned() const;
     void setPixelAligned(bool align);
 
+    bool asynchronousFlicking() const;
+    void setAsynchronousFlicking(bool async);
+
     Q_INVOKABLE void resizeContent(qreal w, qreal h, QPointF center);
     Q_INVOKABLE void returnToBounds();
     Q_INVOKABLE void flick(qreal xVelocity, qreal yVelocity);
@@ -226,6 +230,7 @@ Q_SIGNALS:
     void dragStarted();
     void dragEnded();
     void pixelAlignedChanged();
+    Q_REVISION(1) void asynchronousFlickingChanged();
 
 protected:
     virtual bool childMouseEventFilter(QQuickItem *, QEvent *);
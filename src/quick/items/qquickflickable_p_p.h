@@ -73,6 +73,7 @@ const qreal MinimumFlickVelocity = 75.0;
 class QQuickFlickableVisibleArea;
 class QQuickTransition;
 class QQuickFlickableReboundTransition;
+class QQuickAnimatorProxyJob;
 
 class Q_AUTOTEST_EXPORT QQuickFlickablePrivate : public QQuickItemPrivate, public QQuickItemChangeListener
 {
@@ -100,7 +101,7 @@ public:
     struct AxisData {
         AxisData(QQuickFlickablePrivate *fp, void (QQuickFlickablePrivate::*func)(qreal))
             : move(fp, func)
-            , transitionToBounds(0)
+            , transitionToBounds(0), asyncFlick(0)
             , viewSize(-1), lastPos(0), startMargin(0), endMargin(0)
             , origin(0)
             , transitionTo(0)
@@ -137,6 +138,7 @@ public:
 
         QQuickTimeLineValueProxy<QQuickFlickablePrivate> move;
         QQuickFlickableReboundTransition *transitionToBounds;
+        QQuickAnimatorProxyJob *asyncFlick;
         qreal viewSize;
         qreal pressPos;
         qreal lastPos;
@@ -181,6 +183,10 @@ public:
     void resetTimeline(AxisData &data);
     void clearTimeline();
 
+    void startAsyncFlick(AxisData &data, qreal minExtent, qreal maxExtent,
+                         qreal velocity, qreal accel, qreal maxDistance = -1);
+    void stopAsyncFlick(AxisData &data);
+
     void updateBeginningEnd();
 
     bool isInnermostPressDelay(QQuickItem *item) const;
@@ -215,6 +221,7 @@ public:
     bool calcVelocity : 1;
     bool pixelAligned : 1;
     bool replayingPressEvent : 1;
+    bool asynchronousFlicking : 1;
     QElapsedTimer timer;
     qint64 lastPosTime;
     qint64 lastPressTime;
@@ -42,23 +42,141 @@
 #include "qquickframebufferobject.h"
 
 #include <QtGui/QOpenGLFramebufferObject>
+#include <QtGui/QOpenGLContext>
+#include <QtGui/QOpenGLFunctions>
+#include <QtGui/QOffscreenSurface>
+
+#include <QtCore/QMutex>
+#include <QtCore/QPointer>
+#include <QtCore/QThread>
+#include <QtCore/QWaitCondition>
 
 #include <private/qquickitem_p.h>
 
 #include <QSGSimpleTextureNode>
 
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#endif
+#ifndef GL_SYNC_FLUSH_COMMANDS_BIT
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#endif
+#ifndef GL_ALREADY_SIGNALED
+#define GL_ALREADY_SIGNALED 0x911A
+#endif
+#ifndef GL_CONDITION_SATISFIED
+#define GL_CONDITION_SATISFIED 0x911C
+#endif
+#ifndef GL_TIMEOUT_IGNORED
+#define GL_TIMEOUT_IGNORED 0xFFFFFFFFFFFFFFFFull
+#endif
+
 QT_BEGIN_NAMESPACE
 
+typedef void *(QOPENGLF_APIENTRYP FenceSyncFunction)(GLenum condition, GLbitfield flags);
+typedef GLenum (QOPENGLF_APIENTRYP ClientWaitSyncFunction)(void *sync, GLbitfield flags, quint64 timeout);
+typedef void (QOPENGLF_APIENTRYP WaitSyncFunction)(void *sync, GLbitfield flags, quint64 timeout);
+typedef void (QOPENGLF_APIENTRYP DeleteSyncFunction)(void *sync);
+
+struct QSGFramebufferObjectSyncFunctions
+{
+    QSGFramebufferObjectSyncFunctions()
+        : fenceSync(0)
+        , clientWaitSync(0)
+        , waitSync(0)
+        , deleteSync(0)
+    {
+    }
+
+    void resolve(QOpenGLContext *context)
+    {
+        const QSurfaceFormat format = context->format();
+        const QPair<int, int> version = qMakePair(format.majorVersion(), format.minorVersion());
+        if (context->isOpenGLES() ? version < qMakePair(3, 0)
+                                  : version < qMakePair(3, 2) && !context->hasExtension(QByteArrayLiteral("GL_ARB_sync"))) {
+            return;
+        }
+        fenceSync = reinterpret_cast<FenceSyncFunction>(context->getProcAddress("glFenceSync"));
+        clientWaitSync = reinterpret_cast<ClientWaitSyncFunction>(context->getProcAddress("glClientWaitSync"));
+        waitSync = reinterpret_cast<WaitSyncFunction>(context->getProcAddress("glWaitSync"));
+        deleteSync = reinterpret_cast<DeleteSyncFunction>(context->getProcAddress("glDeleteSync"));
+        if (!isValid())
+            fenceSync = 0;
+    }
+
+    bool isValid() const { return fenceSync && clientWaitSync && waitSync && deleteSync; }
+
+    FenceSyncFunction fenceSync;
+    ClientWaitSyncFunction clientWaitSync;
+    WaitSyncFunction waitSync;
+    DeleteSyncFunction deleteSync;
+};
+
+/*
+    Lives on the GUI thread and outlives the render thread side of an
+    asynchronously rendered item: it owns the offscreen surface the worker
+    thread renders with and turns finished frames into updates.
+ */
+class QQuickFramebufferObjectNotifier : public QObject
+{
+    Q_OBJECT
+public:
+    QQuickFramebufferObjectNotifier(QQuickFramebufferObject *i, const QSurfaceFormat &format)
+        : item(i)
+        , surface(new QOffscreenSurface)
+        , syncPending(0)
+    {
+        surface->setParent(this);
+        surface->setFormat(format);
+        surface->create();
+    }
+
+    QPointer<QQuickFramebufferObject> item;
+    QOffscreenSurface *surface;
+    QAtomicInt syncPending;
+
+public Q_SLOTS:
+    void frameReady()
+    {
+        // A frame only needs a render pass to be shown, unless a sync had to be
+        // skipped while the renderer was busy.
+        if (!item)
+            return;
+        if (syncPending.testAndSetOrdered(1, 0))
+            item->update();
+        else if (item->window())
+            item->window()->update();
+    }
+};
+
 class QQuickFramebufferObjectPrivate : public QQuickItemPrivate
 {
     Q_DECLARE_PUBLIC(QQuickFramebufferObject)
 public:
     QQuickFramebufferObjectPrivate()
         : followsItemSize(true)
+        , asynchronous(false)
+        , notifier(0)
+    {
+    }
+
+    ~QQuickFramebufferObjectPrivate()
     {
+        delete notifier;
+    }
+
+    void ensureNotifier()
+    {
+        Q_Q(QQuickFramebufferObject);
+        if (asynchronous && !notifier && window)
+            notifier = new QQuickFramebufferObjectNotifier(q, window->requestedFormat());
     }
 
     bool followsItemSize;
+    bool asynchronous;
+
+    // Handed over to the node once it starts rendering asynchronously.
+    QQuickFramebufferObjectNotifier *notifier;
 };
 
 /*!
@@ -138,6 +256,56 @@ bool QQuickFramebufferObject::textureFollowsItemSize() const
     return d->followsItemSize;
 }
 
+/*!
+ * \property QQuickFramebufferObject::asynchronousRendering
+ * \since 5.4
+ *
+ * This property controls whether the renderer draws on a thread of its own.
+ *
+ * When enabled, Renderer::render() is called on a dedicated thread with an
+ * OpenGL context that shares resources with the scene graph, and renders
+ * into one of three FBOs. The scene graph keeps showing the last completed
+ * frame while the next one is being rendered, so an expensive renderer
+ * no longer holds back the rest of the scene. Renderer::synchronize() is
+ * still called while the GUI thread is blocked, but only in between two
+ * calls to render(); while a frame is in progress, the synchronization is
+ * postponed until it has completed.
+ *
+ * Completed frames are presented once the GPU has finished them when the
+ * OpenGL implementation supports sync objects, and after a glFinish()
+ * otherwise.
+ *
+ * The default value is \c {false}.
+ */
+bool QQuickFramebufferObject::asynchronousRendering() const
+{
+    Q_D(const QQuickFramebufferObject);
+    return d->asynchronous;
+}
+
+void QQuickFramebufferObject::setAsynchronousRendering(bool asynchronous)
+{
+    Q_D(QQuickFramebufferObject);
+    if (d->asynchronous == asynchronous)
+        return;
+    d->asynchronous = asynchronous;
+    d->ensureNotifier();
+    update();
+    emit asynchronousRenderingChanged(d->asynchronous);
+}
+
+/*!
+ * \internal
+ */
+void QQuickFramebufferObject::itemChange(ItemChange change, const ItemChangeData &value)
+{
+    QQuickItem::itemChange(change, value);
+
+    Q_D(QQuickFramebufferObject);
+    if (change == ItemSceneChange && value.window)
+        d->ensureNotifier();
+}
+
 /*!
  * \internal
  */
@@ -150,6 +318,224 @@ void QQuickFramebufferObject::geometryChanged(const QRectF &newGeometry, const Q
         update();
 }
 
+/*
+    Runs an asynchronous Renderer. Three buffers rotate between the roles
+    back (being rendered into by this thread), ready (the last completed
+    frame) and front (shown by the scene graph). Each buffer carries a fence
+    for the commands last issued against it by the other side.
+ */
+class QSGFramebufferObjectWorker : public QThread
+{
+public:
+    struct Buffer
+    {
+        Buffer() : fbo(0), msDisplayFbo(0), fence(0), generation(-1) { }
+
+        GLuint texture() const { return msDisplayFbo ? msDisplayFbo->texture() : fbo->texture(); }
+
+        QOpenGLFramebufferObject *fbo;
+        QOpenGLFramebufferObject *msDisplayFbo;
+        void *fence;
+        int generation;
+        QSize requestedSize;    // passed to createFramebufferObject(), the FBO may differ
+    };
+
+    QSGFramebufferObjectWorker(QQuickFramebufferObject::Renderer *r, QQuickFramebufferObjectNotifier *n)
+        : renderer(r)
+        , notifier(n)
+        , context(0)
+        , front(&buffers[0])
+        , ready(&buffers[1])
+        , back(&buffers[2])
+        , generation(0)
+        , readyFresh(false)
+        , renderRequested(false)
+        , synchronizing(false)
+        , busy(false)
+        , quit(false)
+    {
+        QOpenGLContext *shareContext = QOpenGLContext::currentContext();
+        sync.resolve(shareContext);
+        context = new QOpenGLContext;
+        context->setShareContext(shareContext);
+        context->setFormat(shareContext->format());
+        context->create();
+        context->moveToThread(this);
+        start();
+    }
+
+    ~QSGFramebufferObjectWorker()
+    {
+        mutex.lock();
+        quit = true;
+        condition.wakeAll();
+        mutex.unlock();
+        wait();
+        delete context;
+    }
+
+    // Called on the render thread while the GUI thread is blocked. Returns
+    // false if a frame is in progress and synchronize() must not be called.
+    bool beginSync()
+    {
+        QMutexLocker locker(&mutex);
+        if (busy)
+            return false;
+        synchronizing = true;
+        return true;
+    }
+
+    void endSync(const QSize &size)
+    {
+        QMutexLocker locker(&mutex);
+        requestedSize = size;
+        synchronizing = false;
+        renderRequested = true;
+        condition.wakeAll();
+    }
+
+    void requestRender()
+    {
+        QMutexLocker locker(&mutex);
+        renderRequested = true;
+        condition.wakeAll();
+    }
+
+    void invalidate()
+    {
+        QMutexLocker locker(&mutex);
+        ++generation;
+    }
+
+    bool hasFrame() const { return front->fbo != 0; }
+
+    QOpenGLFramebufferObject *currentFbo() const { return back->fbo; }
+
+    /*
+        Makes the last completed frame the front buffer once the GPU is
+        done with it. With \a block, waits for a frame to be completed.
+        Called on the render thread before rendering.
+     */
+    bool swapBuffers(bool block)
+    {
+        QMutexLocker locker(&mutex);
+        while (block && !readyFresh && !quit)
+            condition.wait(&mutex);
+        if (!readyFresh)
+            return false;
+        if (ready->fence) {
+            GLenum status = sync.clientWaitSync(ready->fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                                block ? GL_TIMEOUT_IGNORED : 0);
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+                return false;
+            sync.deleteSync(ready->fence);
+        }
+        qSwap(front, ready);
+        readyFresh = false;
+        // The scene graph may still be sampling the old front buffer.
+        ready->fence = sync.isValid() ? sync.fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) : 0;
+        return true;
+    }
+
+    QSize frontSize() const { return front->fbo->size(); }
+    GLuint frontTexture() const { return front->texture(); }
+
+protected:
+    void run() Q_DECL_OVERRIDE
+    {
+        context->makeCurrent(notifier->surface);
+        QOpenGLFunctions *gl = context->functions();
+
+        QMutexLocker locker(&mutex);
+        forever {
+            while (!quit && (!renderRequested || synchronizing))
+                condition.wait(&mutex);
+            if (quit)
+                break;
+            renderRequested = false;
+            busy = true;
+            Buffer *target = back;
+            const QSize size = requestedSize;
+            const int currentGeneration = generation;
+            locker.unlock();
+
+            if (target->fence) {
+                sync.waitSync(target->fence, 0, GL_TIMEOUT_IGNORED);
+                sync.deleteSync(target->fence);
+                target->fence = 0;
+            }
+
+            if (!target->fbo || target->generation != currentGeneration || target->requestedSize != size) {
+                delete target->fbo;
+                delete target->msDisplayFbo;
+                target->msDisplayFbo = 0;
+                target->fbo = renderer->createFramebufferObject(size);
+                if (target->fbo->format().samples() > 0)
+                    target->msDisplayFbo = new QOpenGLFramebufferObject(target->fbo->size());
+                target->generation = currentGeneration;
+                target->requestedSize = size;
+            }
+
+            target->fbo->bind();
+            gl->glViewport(0, 0, target->fbo->width(), target->fbo->height());
+            renderer->render();
+            target->fbo->bindDefault();
+
+            if (target->msDisplayFbo)
+                QOpenGLFramebufferObject::blitFramebuffer(target->msDisplayFbo, target->fbo);
+
+            void *fence = 0;
+            if (sync.isValid())
+                fence = sync.fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            else
+                gl->glFinish();
+            gl->glFlush();
+
+            locker.relock();
+            target->fence = fence;
+            qSwap(back, ready);
+            readyFresh = true;
+            busy = false;
+            condition.wakeAll();
+            QMetaObject::invokeMethod(notifier, "frameReady", Qt::QueuedConnection);
+        }
+        locker.unlock();
+
+        for (int i = 0; i < 3; ++i) {
+            if (buffers[i].fence)
+                sync.deleteSync(buffers[i].fence);
+            delete buffers[i].fbo;
+            delete buffers[i].msDisplayFbo;
+        }
+        context->doneCurrent();
+        context->moveToThread(thread());
+    }
+
+public:
+    QQuickFramebufferObject::Renderer *renderer;
+    QQuickFramebufferObjectNotifier *notifier;
+
+private:
+    QOpenGLContext *context;
+    QSGFramebufferObjectSyncFunctions sync;
+
+    QMutex mutex;
+    QWaitCondition condition;
+
+    Buffer buffers[3];
+    Buffer *front;
+    Buffer *ready;
+    Buffer *back;
+
+    QSize requestedSize;
+    int generation;
+    bool readyFresh;
+    bool renderRequested;
+    bool synchronizing;
+    bool busy;
+    bool quit;
+};
+
 class QSGFramebufferObjectNode : public QObject, public QSGSimpleTextureNode
 {
     Q_OBJECT
@@ -160,6 +546,7 @@ public:
         , fbo(0)
         , msDisplayFbo(0)
         , renderer(0)
+        , worker(0)
         , renderPending(true)
         , invalidatePending(false)
     {
@@ -168,21 +555,42 @@ public:
 
     ~QSGFramebufferObjectNode()
     {
+        QQuickFramebufferObjectNotifier *notifier = worker ? worker->notifier : 0;
+        delete worker;
         delete renderer;
         delete texture();
         delete fbo;
         delete msDisplayFbo;
+        if (notifier)
+            notifier->deleteLater();
     }
 
     void scheduleRender()
     {
+        if (worker) {
+            worker->requestRender();
+            return;
+        }
         renderPending = true;
         window->update();
     }
 
+    void updateTexture()
+    {
+        delete texture();
+        setTexture(window->createTextureFromId(worker->frontTexture(),
+                                               worker->frontSize(),
+                                               QQuickWindow::TextureHasAlphaChannel));
+    }
+
 public Q_SLOTS:
     void render()
     {
+        if (worker) {
+            if (worker->swapBuffers(false))
+                updateTexture();
+            return;
+        }
         if (renderPending) {
             renderPending = false;
             fbo->bind();
@@ -200,6 +608,8 @@ public:
     QOpenGLFramebufferObject *fbo;
     QOpenGLFramebufferObject *msDisplayFbo;
     QQuickFramebufferObject::Renderer *renderer;
+    QSGFramebufferObjectWorker *worker;
+    QSize asyncSize;
 
     bool renderPending;
     bool invalidatePending;
@@ -222,6 +632,14 @@ QSGNode *QQuickFramebufferObject::updatePaintNode(QSGNode *node, UpdatePaintNode
 
     Q_D(QQuickFramebufferObject);
 
+    // Switching between synchronous and asynchronous rendering starts over
+    // with a new renderer.
+    const bool asynchronous = d->asynchronous && (d->notifier || (n && n->worker));
+    if (n && asynchronous != bool(n->worker)) {
+        delete n;
+        n = 0;
+    }
+
     if (!n) {
         n = new QSGFramebufferObjectNode;
         n->window = window();
@@ -231,6 +649,35 @@ QSGNode *QQuickFramebufferObject::updatePaintNode(QSGNode *node, UpdatePaintNode
         n->renderer = createRenderer();
         n->renderer->data = n;
         connect(window(), SIGNAL(beforeRendering()), n, SLOT(render()));
+        if (asynchronous) {
+            n->worker = new QSGFramebufferObjectWorker(n->renderer, d->notifier);
+            d->notifier = 0;
+        }
+    }
+
+    if (n->worker) {
+        if (!n->worker->beginSync()) {
+            // The renderer is busy; try again once its frame is done.
+            n->worker->notifier->syncPending.storeRelease(1);
+            return n;
+        }
+
+        n->renderer->synchronize(this);
+
+        if (d->followsItemSize || !n->asyncSize.isValid()) {
+            QSize minFboSize = d->sceneGraphContext()->minimumFBOSize();
+            n->asyncSize = QSize(qMax<int>(minFboSize.width(), width()),
+                                 qMax<int>(minFboSize.height(), height()));
+        }
+        n->worker->endSync(n->asyncSize);
+
+        // Nothing can be shown before the first frame is complete.
+        if (!n->worker->hasFrame() && n->worker->swapBuffers(true))
+            n->updateTexture();
+
+        n->setFiltering(d->smooth ? QSGTexture::Linear : QSGTexture::Nearest);
+        n->setRect(0, 0, width(), height());
+        return n;
     }
 
     n->renderer->synchronize(this);
@@ -314,7 +761,10 @@ QQuickFramebufferObject::Renderer::~Renderer()
  */
 QOpenGLFramebufferObject *QQuickFramebufferObject::Renderer::framebufferObject() const
 {
-    return data ? ((QSGFramebufferObjectNode *) data)->fbo : 0;
+    if (!data)
+        return 0;
+    QSGFramebufferObjectNode *node = (QSGFramebufferObjectNode *) data;
+    return node->worker ? node->worker->currentFbo() : node->fbo;
 }
 
 /*!
@@ -353,8 +803,13 @@ void QQuickFramebufferObject::Renderer::synchronize(QQuickFramebufferObject *ite
  */
 void QQuickFramebufferObject::Renderer::invalidateFramebufferObject()
 {
-    if (data)
-        ((QSGFramebufferObjectNode *) data)->invalidatePending = true;
+    if (!data)
+        return;
+    QSGFramebufferObjectNode *node = (QSGFramebufferObjectNode *) data;
+    if (node->worker)
+        node->worker->invalidate();
+    else
+        node->invalidatePending = true;
 }
 
 /*!
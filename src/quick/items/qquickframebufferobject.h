@@ -57,6 +57,7 @@ class Q_QUICK_EXPORT QQuickFramebufferObject : public QQuickItem
     Q_DECLARE_PRIVATE(QQuickFramebufferObject)
 
     Q_PROPERTY(bool textureFollowsItemSize READ textureFollowsItemSize WRITE setTextureFollowsItemSize NOTIFY textureFollowsItemSizeChanged)
+    Q_PROPERTY(bool asynchronousRendering READ asynchronousRendering WRITE setAsynchronousRendering NOTIFY asynchronousRenderingChanged)
 
 public:
 
@@ -72,6 +73,7 @@ public:
         void invalidateFramebufferObject();
     private:
         friend class QSGFramebufferObjectNode;
+        friend class QSGFramebufferObjectWorker;
         friend class QQuickFramebufferObject;
         void *data;
     };
@@ -81,16 +83,21 @@ public:
     bool textureFollowsItemSize() const;
     void setTextureFollowsItemSize(bool follows);
 
+    bool asynchronousRendering() const;
+    void setAsynchronousRendering(bool asynchronous);
+
     virtual Renderer *createRenderer() const = 0;
 
 protected:
     void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry);
+    void itemChange(ItemChange change, const ItemChangeData &value) Q_DECL_OVERRIDE;
 
 protected:
     QSGNode *updatePaintNode(QSGNode *, UpdatePaintNodeData *) Q_DECL_OVERRIDE;
 
 Q_SIGNALS:
     void textureFollowsItemSizeChanged(bool);
+    void asynchronousRenderingChanged(bool);
 };
 
 QT_END_NAMESPACE
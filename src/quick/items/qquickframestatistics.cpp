@@ -0,0 +1,147 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qquickframestatistics_p.h"
+
+#include <QtCore/qvariant.h>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+static const int qquick_bucket_limits[QQuickFrameStatistics::BucketCount - 1] = { 1, 2, 4, 8, 16, 33, 66 };
+
+static const char *const qquick_phase_names[QQuickFrameStatistics::PhaseCount] = {
+    "polish", "animations", "sync", "render", "swap"
+};
+
+static const char *const qquick_counter_names[QQuickFrameStatistics::CounterCount] = {
+    "batches", "drawCalls", "uploadedBytes"
+};
+
+/*
+    Collects how long the phases of the frames of a window took, and what
+    the renderer did for them. Times are added from both the GUI and the
+    render thread, so all access is serialized. The work per frame is a few
+    additions, which keeps the statistics cheap enough to always collect.
+ */
+QQuickFrameStatistics::QQuickFrameStatistics()
+{
+    reset();
+}
+
+void QQuickFrameStatistics::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    memset(m_times, 0, sizeof(m_times));
+    memset(m_counters, 0, sizeof(m_counters));
+    m_frames = 0;
+    m_missedVsyncs = 0;
+}
+
+void QQuickFrameStatistics::addTime(Phase phase, qint64 nsecs)
+{
+    int bucket = 0;
+    while (bucket < BucketCount - 1 && nsecs >= qint64(qquick_bucket_limits[bucket]) * 1000000)
+        ++bucket;
+
+    QMutexLocker locker(&m_mutex);
+    Histogram &h = m_times[phase];
+    ++h.buckets[bucket];
+    ++h.count;
+    h.total += nsecs;
+    h.maximum = qMax(h.maximum, nsecs);
+}
+
+/*
+    Records that a frame was swapped, with the renderer \a counters of the
+    frame, indexed by Counter, and the number of vsyncs it missed.
+ */
+void QQuickFrameStatistics::addFrame(const qint64 *counters, int missedVsyncs)
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_frames;
+    m_missedVsyncs += missedVsyncs;
+    for (int i = 0; i < CounterCount; ++i) {
+        CounterStatistics &c = m_counters[i];
+        c.last = counters[i];
+        c.total += counters[i];
+        c.maximum = qMax(c.maximum, counters[i]);
+    }
+}
+
+QVariantMap QQuickFrameStatistics::toVariantMap() const
+{
+    QMutexLocker locker(&m_mutex);
+    QVariantMap map;
+    map.insert(QStringLiteral("frames"), m_frames);
+    map.insert(QStringLiteral("missedVsyncs"), m_missedVsyncs);
+
+    QVariantList limits;
+    for (int i = 0; i < BucketCount - 1; ++i)
+        limits.append(qquick_bucket_limits[i]);
+    map.insert(QStringLiteral("histogramLimits"), limits);
+
+    for (int i = 0; i < PhaseCount; ++i) {
+        const Histogram &h = m_times[i];
+        QVariantList buckets;
+        for (int b = 0; b < BucketCount; ++b)
+            buckets.append(h.buckets[b]);
+        QVariantMap phase;
+        phase.insert(QStringLiteral("count"), h.count);
+        phase.insert(QStringLiteral("average"), h.count ? h.total / 1000000.0 / h.count : 0.0);
+        phase.insert(QStringLiteral("maximum"), h.maximum / 1000000.0);
+        phase.insert(QStringLiteral("histogram"), buckets);
+        map.insert(QLatin1String(qquick_phase_names[i]), phase);
+    }
+
+    for (int i = 0; i < CounterCount; ++i) {
+        const CounterStatistics &c = m_counters[i];
+        QVariantMap counter;
+        counter.insert(QStringLiteral("last"), double(c.last));
+        counter.insert(QStringLiteral("average"), m_frames ? double(c.total) / m_frames : 0.0);
+        counter.insert(QStringLiteral("maximum"), double(c.maximum));
+        map.insert(QLatin1String(qquick_counter_names[i]), counter);
+    }
+    return map;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,141 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QQUICKGLREADBACK_P_H
+#define QQUICKGLREADBACK_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtGui/QOpenGLContext>
+#include <QtGui/QOpenGLFunctions>
+
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#endif
+#ifndef GL_STREAM_READ
+#define GL_STREAM_READ 0x88E1
+#endif
+#ifndef GL_MAP_READ_BIT
+#define GL_MAP_READ_BIT 0x0001
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#endif
+#ifndef GL_SYNC_FLUSH_COMMANDS_BIT
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#endif
+#ifndef GL_ALREADY_SIGNALED
+#define GL_ALREADY_SIGNALED 0x911A
+#endif
+#ifndef GL_CONDITION_SATISFIED
+#define GL_CONDITION_SATISFIED 0x911C
+#endif
+#ifndef GL_TIMEOUT_IGNORED
+#define GL_TIMEOUT_IGNORED Q_UINT64_C(0xFFFFFFFFFFFFFFFF)
+#endif
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Resolves the entry points needed to read pixels into a pixel buffer
+    object behind a fence, so that the read does not stall the pipeline.
+    The functions are resolved against the current context and are only
+    available on OpenGL ES 3.0, OpenGL 3.2 or with the matching ARB
+    extensions; isValid() returns false otherwise.
+ */
+struct QQuickGLReadbackFunctions
+{
+    typedef void *(QOPENGLF_APIENTRYP MapBufferRangeFunction)(GLenum target, qopengl_GLintptr offset,
+                                                              qopengl_GLsizeiptr length, GLbitfield access);
+    typedef GLboolean (QOPENGLF_APIENTRYP UnmapBufferFunction)(GLenum target);
+    typedef void *(QOPENGLF_APIENTRYP FenceSyncFunction)(GLenum condition, GLbitfield flags);
+    typedef GLenum (QOPENGLF_APIENTRYP ClientWaitSyncFunction)(void *sync, GLbitfield flags, quint64 timeout);
+    typedef void (QOPENGLF_APIENTRYP DeleteSyncFunction)(void *sync);
+
+    QQuickGLReadbackFunctions()
+        : mapBufferRange(0)
+        , unmapBuffer(0)
+        , fenceSync(0)
+        , clientWaitSync(0)
+        , deleteSync(0)
+    {
+        QOpenGLContext *context = QOpenGLContext::currentContext();
+        if (!context)
+            return;
+        const QSurfaceFormat format = context->format();
+        const QPair<int, int> version = qMakePair(format.majorVersion(), format.minorVersion());
+        if (context->isOpenGLES()) {
+            if (version < qMakePair(3, 0))
+                return;
+        } else if (version < qMakePair(3, 2)
+                   && !(context->hasExtension(QByteArrayLiteral("GL_ARB_sync"))
+                        && context->hasExtension(QByteArrayLiteral("GL_ARB_pixel_buffer_object"))
+                        && context->hasExtension(QByteArrayLiteral("GL_ARB_map_buffer_range")))) {
+            return;
+        }
+        mapBufferRange = reinterpret_cast<MapBufferRangeFunction>(context->getProcAddress("glMapBufferRange"));
+        unmapBuffer = reinterpret_cast<UnmapBufferFunction>(context->getProcAddress("glUnmapBuffer"));
+        fenceSync = reinterpret_cast<FenceSyncFunction>(context->getProcAddress("glFenceSync"));
+        clientWaitSync = reinterpret_cast<ClientWaitSyncFunction>(context->getProcAddress("glClientWaitSync"));
+        deleteSync = reinterpret_cast<DeleteSyncFunction>(context->getProcAddress("glDeleteSync"));
+    }
+
+    bool isValid() const { return mapBufferRange && unmapBuffer && fenceSync && clientWaitSync && deleteSync; }
+
+    MapBufferRangeFunction mapBufferRange;
+    UnmapBufferFunction unmapBuffer;
+    FenceSyncFunction fenceSync;
+    ClientWaitSyncFunction clientWaitSync;
+    DeleteSyncFunction deleteSync;
+};
+
+QT_END_NAMESPACE
+
+#endif // QQUICKGLREADBACK_P_H
@@ -472,6 +472,9 @@ void QQuickGridViewPrivate::initializeViewItem(FxViewItem *item)
 
 bool QQuickGridViewPrivate::addVisibleItems(qreal fillFrom, qreal fillTo, qreal bufferFrom, qreal bufferTo, bool doBuffer)
 {
+    // The delegates are incubated asynchronously in the cacheBuffer area, and
+    // while flicking also in the visible area (see QQuickItemViewPrivate::refill())
+    const bool asynchronous = doBuffer || incubateVisibleItems;
     qreal colPos = colPosAt(visibleIndex);
     qreal rowPos = rowPosAt(visibleIndex);
     if (visibleItems.count()) {
@@ -515,7 +518,7 @@ bool QQuickGridViewPrivate::addVisibleItems(qreal fillFrom, qreal fillTo, qreal
 #ifdef DEBUG_DELEGATE_LIFECYCLE
         qDebug() << "refill: append item" << modelIndex << colPos << rowPos;
 #endif
-        if (!(item = static_cast<FxGridItemSG*>(createItem(modelIndex, doBuffer))))
+        if (!(item = static_cast<FxGridItemSG*>(createItem(modelIndex, asynchronous))))
             break;
         if (!transitioner || !transitioner->canTransition(QQuickItemViewTransitioner::PopulateTransition, true)) // pos will be set by layoutVisibleItems()
             item->setPosition(colPos, rowPos, true);
@@ -530,7 +533,7 @@ bool QQuickGridViewPrivate::addVisibleItems(qreal fillFrom, qreal fillTo, qreal
         changed = true;
     }
 
-    if (doBuffer && requestedIndex != -1) // already waiting for an item
+    if (asynchronous && requestedIndex != -1) // already waiting for an item
         return changed;
 
     // Find first column
@@ -552,7 +555,7 @@ bool QQuickGridViewPrivate::addVisibleItems(qreal fillFrom, qreal fillTo, qreal
 #ifdef DEBUG_DELEGATE_LIFECYCLE
         qDebug() << "refill: prepend item" << visibleIndex-1 << "top pos" << rowPos << colPos;
 #endif
-        if (!(item = static_cast<FxGridItemSG*>(createItem(visibleIndex-1, doBuffer))))
+        if (!(item = static_cast<FxGridItemSG*>(createItem(visibleIndex-1, asynchronous))))
             break;
         --visibleIndex;
         if (!transitioner || !transitioner->canTransition(QQuickItemViewTransitioner::PopulateTransition, true)) // pos will be set by layoutVisibleItems()
@@ -974,7 +977,7 @@ void QQuickGridViewPrivate::fixup(AxisData &data, qreal minExtent, qreal maxExte
 
         qreal dist = qAbs(data.move + pos);
         if (dist > 0) {
-            timeline.reset(data.move);
+            resetTimeline(data);
             if (fixupMode != Immediate) {
                 timeline.move(data.move, -pos, QEasingCurve(QEasingCurve::InOutQuad), fixupDuration/2);
                 data.fixingUp = true;
@@ -993,7 +996,7 @@ void QQuickGridViewPrivate::fixup(AxisData &data, qreal minExtent, qreal maxExte
                 viewPos = pos - highlightRangeStart;
             if (isContentFlowReversed())
                 viewPos = -viewPos-size();
-            timeline.reset(data.move);
+            resetTimeline(data);
             if (viewPos != position()) {
                 if (fixupMode != Immediate) {
                     timeline.move(data.move, -viewPos, QEasingCurve(QEasingCurve::InOutQuad), fixupDuration/2);
@@ -1108,12 +1111,13 @@ bool QQuickGridViewPrivate::flick(AxisData &data, qreal minExtent, qreal maxExte
             data.flickTarget = velocity > 0 ? minExtent : maxExtent;
             overshootDist = overShoot ? overShootDistance(vSize) : 0;
         }
-        timeline.reset(data.move);
+        resetTimeline(data);
         timeline.accel(data.move, v, accel, maxDistance + overshootDist);
+        startAsyncFlick(data, minExtent, maxExtent, v, accel, maxDistance + overshootDist);
         timeline.callback(QQuickTimeLineCallback(&data.move, fixupCallback, this));
         return true;
     } else {
-        timeline.reset(data.move);
+        resetTimeline(data);
         fixup(data, minExtent, maxExtent);
         return false;
     }
@@ -1535,10 +1539,35 @@ void QQuickGridView::setHighlightFollowsCurrentItem(bool autoHighlight)
     delegates; the fewer objects and bindings in a delegate, the faster a view may be
     scrolled.
 
+    While the view is flicking, the buffer in the direction of the flick is
+    extended by the distance the flick is expected to travel, up to the size of
+    the view, and the buffer behind it is halved.
+
     The cacheBuffer operates outside of any display margins specified by
     displayMarginBeginning or displayMarginEnd.
 */
 
+/*!
+    \qmlproperty bool QtQuick::GridView::reuseItems
+
+    This property enables the reuse of delegate instances.
+
+    When true, delegates that are moved out of the view and outside of the
+    cacheBuffer are not destroyed but kept in a pool, and handed out again
+    when a delegate is needed for another index.  Instead of a new delegate
+    being created, the \c index and model role properties of the pooled
+    delegate are updated to the new model item.  Any other state held in the
+    delegate, for example properties set from JavaScript, is left untouched;
+    use the DelegateModel::pooled() and DelegateModel::reused() attached
+    signals to reset it.
+
+    Delegates are only reused for models whose items are accessed by index,
+    such as ListModel, QAbstractItemModel subclasses, JavaScript arrays and
+    integers.
+
+    The default value is false.
+*/
+
 /*!
     \qmlproperty int QtQuick::GridView::displayMarginBeginning
     \qmlproperty int QtQuick::GridView::displayMarginEnd
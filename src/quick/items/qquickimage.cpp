@@ -86,6 +86,7 @@ QQuickImagePrivate::QQuickImagePrivate()
     , paintedWidth(0)
     , paintedHeight(0)
     , pixmapChanged(false)
+    , deferTextureUpload(true)
     , hAlign(QQuickImage::AlignHCenter)
     , vAlign(QQuickImage::AlignVCenter)
     , provider(0)
@@ -188,6 +189,17 @@ void QQuickImagePrivate::setImage(const QImage &image)
     q->update();
 }
 
+void QQuickImagePrivate::setPixmap(const QQuickPixmap &pixmap)
+{
+    Q_Q(QQuickImage);
+    pix.setPixmap(pixmap);
+
+    q->pixmapChange();
+    status = pix.isNull() ? QQuickImageBase::Null : QQuickImageBase::Ready;
+
+    q->update();
+}
+
 /*!
     \qmlproperty enumeration QtQuick::Image::fillMode
 
@@ -454,6 +466,10 @@ qreal QQuickImage::paintedHeight() const
     Note that this property is only valid for images read from the
     local filesystem.  Images loaded via a network resource (e.g. HTTP)
     are always loaded asynchronously.
+
+    Large asynchronous images are also uploaded to the graphics memory
+    on a helper thread where possible, so they may appear a frame or two
+    after they have finished loading.
 */
 
 /*!
@@ -581,7 +597,11 @@ QSGNode *QQuickImage::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
 {
     Q_D(QQuickImage);
 
-    QSGTexture *texture = d->sceneGraphRenderContext()->textureForFactory(d->pix.textureFactory(), window());
+    // Asynchronous images don't need to be visible right away, so their
+    // upload may happen in the background.
+    bool uploadPending = false;
+    QSGTexture *texture = d->sceneGraphRenderContext()->textureForFactory(d->pix.textureFactory(), window(),
+                                                                           d->async && d->deferTextureUpload ? &uploadPending : 0);
 
     // Copy over the current texture state into the texture provider...
     if (d->provider) {
@@ -589,6 +609,9 @@ QSGNode *QQuickImage::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
         d->provider->m_texture = texture;
     }
 
+    if (uploadPending)
+        update();
+
     if (!texture || width() <= 0 || height() <= 0) {
         delete oldNode;
         return 0;
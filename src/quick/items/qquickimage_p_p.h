@@ -71,8 +71,10 @@ public:
     qreal paintedWidth;
     qreal paintedHeight;
     void setImage(const QImage &img);
+    void setPixmap(const QQuickPixmap &pixmap);
 
     bool pixmapChanged : 1;
+    bool deferTextureUpload : 1;
     QQuickImage::HAlignment hAlign;
     QQuickImage::VAlignment vAlign;
 
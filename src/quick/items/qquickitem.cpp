@@ -62,6 +62,7 @@
 
 #include <private/qqmlglobal_p.h>
 #include <private/qqmlengine_p.h>
+#include <private/qqmlprofiler_p.h>
 #include <QtQuick/private/qquickstategroup_p.h>
 #include <private/qqmlopenmetaobject_p.h>
 #include <QtQuick/private/qquickstate_p.h>
@@ -179,7 +180,7 @@ QQuickTransform::~QQuickTransform()
     Q_D(QQuickTransform);
     for (int ii = 0; ii < d->items.count(); ++ii) {
         QQuickItemPrivate *p = QQuickItemPrivate::get(d->items.at(ii));
-        p->transforms.removeOne(this);
+        p->extra->transforms.removeOne(this);
         p->dirty(QQuickItemPrivate::Transform);
     }
 }
@@ -1538,6 +1539,26 @@ void QQuickItemPrivate::setAccessibleFlagAndListener()
 
         item->d_func()->isAccessible = true;
         item = item->d_func()->parentItem;
+        // The set of accessible children of the parent now includes the item.
+        if (item)
+            item->d_func()->accessibleChildrenChanged();
+    }
+}
+
+/*!
+    \internal
+
+    Notifies Children listeners that the accessible children of this item
+    have changed in a way not covered by itemChildAdded() and itemChildRemoved(),
+    i.e. a child became accessible or the children were restacked.
+*/
+void QQuickItemPrivate::accessibleChildrenChanged()
+{
+    Q_Q(QQuickItem);
+    for (int ii = 0; ii < changeListeners.count(); ++ii) {
+        const QQuickItemPrivate::ChangeListener &change = changeListeners.at(ii);
+        if (change.types & QQuickItemPrivate::Children)
+            change.listener->itemAccessibleChildrenChanged(q);
     }
 }
 
@@ -2096,10 +2117,10 @@ QQuickItem::~QQuickItem()
     if (d->extra.isAllocated()) {
         delete d->extra->contents; d->extra->contents = 0;
         delete d->extra->layer; d->extra->layer = 0;
+        delete d->extra->stateGroup; d->extra->stateGroup = 0;
     }
 
     delete d->_anchors; d->_anchors = 0;
-    delete d->_stateGroup; d->_stateGroup = 0;
 }
 
 /*!
@@ -2445,6 +2466,7 @@ void QQuickItem::stackBefore(const QQuickItem *sibling)
 
     parentPrivate->dirty(QQuickItemPrivate::ChildrenStackingChanged);
     parentPrivate->markSortedChildrenDirty(this);
+    parentPrivate->accessibleChildrenChanged();
 
     for (int ii = qMin(siblingIndex, myIndex); ii < parentPrivate->childItems.count(); ++ii)
         QQuickItemPrivate::get(parentPrivate->childItems.at(ii))->siblingOrderChanged();
@@ -2481,6 +2503,7 @@ void QQuickItem::stackAfter(const QQuickItem *sibling)
 
     parentPrivate->dirty(QQuickItemPrivate::ChildrenStackingChanged);
     parentPrivate->markSortedChildrenDirty(this);
+    parentPrivate->accessibleChildrenChanged();
 
     for (int ii = qMin(myIndex, siblingIndex + 1); ii < parentPrivate->childItems.count(); ++ii)
         QQuickItemPrivate::get(parentPrivate->childItems.at(ii))->siblingOrderChanged();
@@ -2654,6 +2677,7 @@ void QQuickItemPrivate::derefWindow()
     }
 #endif
     c->hoverItems.removeAll(q);
+    c->invalidatePointerIndex();
     if (itemNodeInstance)
         c->cleanup(itemNodeInstance);
     if (!parentItem)
@@ -2712,10 +2736,10 @@ void QQuickItemPrivate::itemToParentTransform(QTransform &t) const
     if (x || y)
         t.translate(x, y);
 
-    if (!transforms.isEmpty()) {
+    if (hasTransforms()) {
         QMatrix4x4 m(t);
-        for (int ii = transforms.count() - 1; ii >= 0; --ii)
-            transforms.at(ii)->applyTo(&m);
+        for (int ii = extra->transforms.count() - 1; ii >= 0; --ii)
+            extra->transforms.at(ii)->applyTo(&m);
         t = m.toTransform();
     }
 
@@ -2745,7 +2769,6 @@ bool QQuickItem::isComponentComplete() const
 
 QQuickItemPrivate::QQuickItemPrivate()
     : _anchors(0)
-    , _stateGroup(0)
     , flags(0)
     , widthValid(false)
     , heightValid(false)
@@ -3033,12 +3056,22 @@ QQuickItem *QQuickItemPrivate::visibleChildren_at(QQmlListProperty<QQuickItem> *
     return 0;
 }
 
+void QQuickItemPrivate::visibleChildren_toArray(QQmlListProperty<QQuickItem> *prop, QQuickItem **array)
+{
+    QQuickItemPrivate *p = QQuickItemPrivate::get(static_cast<QQuickItem *>(prop->object));
+    const int childCount = p->childItems.count();
+    for (int i = 0; i < childCount; i++) {
+        if (p->childItems.at(i)->isVisible())
+            *array++ = p->childItems.at(i);
+    }
+}
+
 int QQuickItemPrivate::transform_count(QQmlListProperty<QQuickTransform> *prop)
 {
     QQuickItem *that = static_cast<QQuickItem *>(prop->object);
     QQuickItemPrivate *p = QQuickItemPrivate::get(that);
 
-    return p->transforms.count();
+    return p->extra.isAllocated() ? p->extra->transforms.count() : 0;
 }
 
 void QQuickTransform::appendToItem(QQuickItem *item)
@@ -3048,12 +3081,13 @@ void QQuickTransform::appendToItem(QQuickItem *item)
         return;
 
     QQuickItemPrivate *p = QQuickItemPrivate::get(item);
+    QList<QQuickTransform *> &transforms = p->extra.value().transforms;
 
-    if (!d->items.isEmpty() && !p->transforms.isEmpty() && p->transforms.contains(this)) {
-        p->transforms.removeOne(this);
-        p->transforms.append(this);
+    if (!d->items.isEmpty() && !transforms.isEmpty() && transforms.contains(this)) {
+        transforms.removeOne(this);
+        transforms.append(this);
     } else {
-        p->transforms.append(this);
+        transforms.append(this);
         d->items.append(item);
     }
 
@@ -3067,12 +3101,13 @@ void QQuickTransform::prependToItem(QQuickItem *item)
         return;
 
     QQuickItemPrivate *p = QQuickItemPrivate::get(item);
+    QList<QQuickTransform *> &transforms = p->extra.value().transforms;
 
-    if (!d->items.isEmpty() && !p->transforms.isEmpty() && p->transforms.contains(this)) {
-        p->transforms.removeOne(this);
-        p->transforms.prepend(this);
+    if (!d->items.isEmpty() && !transforms.isEmpty() && transforms.contains(this)) {
+        transforms.removeOne(this);
+        transforms.prepend(this);
     } else {
-        p->transforms.prepend(this);
+        transforms.prepend(this);
         d->items.append(item);
     }
 
@@ -3093,10 +3128,10 @@ QQuickTransform *QQuickItemPrivate::transform_at(QQmlListProperty<QQuickTransfor
     QQuickItem *that = static_cast<QQuickItem *>(prop->object);
     QQuickItemPrivate *p = QQuickItemPrivate::get(that);
 
-    if (idx < 0 || idx >= p->transforms.count())
+    if (!p->extra.isAllocated() || idx < 0 || idx >= p->extra->transforms.count())
         return 0;
     else
-        return p->transforms.at(idx);
+        return p->extra->transforms.at(idx);
 }
 
 void QQuickItemPrivate::transform_clear(QQmlListProperty<QQuickTransform> *prop)
@@ -3104,13 +3139,16 @@ void QQuickItemPrivate::transform_clear(QQmlListProperty<QQuickTransform> *prop)
     QQuickItem *that = static_cast<QQuickItem *>(prop->object);
     QQuickItemPrivate *p = QQuickItemPrivate::get(that);
 
-    for (int ii = 0; ii < p->transforms.count(); ++ii) {
-        QQuickTransform *t = p->transforms.at(ii);
+    if (!p->extra.isAllocated())
+        return;
+
+    for (int ii = 0; ii < p->extra->transforms.count(); ++ii) {
+        QQuickTransform *t = p->extra->transforms.at(ii);
         QQuickTransformPrivate *tp = QQuickTransformPrivate::get(t);
         tp->items.removeOne(that);
     }
 
-    p->transforms.clear();
+    p->extra->transforms.clear();
 
     p->dirty(QQuickItemPrivate::Transform);
 }
@@ -4216,9 +4254,12 @@ QQmlListProperty<QQuickItem> QQuickItemPrivate::children()
 QQmlListProperty<QQuickItem> QQuickItemPrivate::visibleChildren()
 {
     return QQmlListProperty<QQuickItem>(q_func(),
+                                        0,
                                         0,
                                         QQuickItemPrivate::visibleChildren_count,
-                                        QQuickItemPrivate::visibleChildren_at);
+                                        QQuickItemPrivate::visibleChildren_at,
+                                        0,
+                                        QQuickItemPrivate::visibleChildren_toArray);
 
 }
 
@@ -4306,10 +4347,10 @@ QQmlListProperty<QQuickTransition> QQuickItemPrivate::transitions()
 
 QString QQuickItemPrivate::state() const
 {
-    if (!_stateGroup)
-        return QString();
+    if (QQuickStateGroup *group = stateGroup())
+        return group->state();
     else
-        return _stateGroup->state();
+        return QString();
 }
 
 void QQuickItemPrivate::setState(const QString &state)
@@ -4381,8 +4422,8 @@ void QQuickItem::classBegin()
 {
     Q_D(QQuickItem);
     d->componentComplete = false;
-    if (d->_stateGroup)
-        d->_stateGroup->classBegin();
+    if (QQuickStateGroup *group = d->stateGroup())
+        group->classBegin();
     if (d->_anchors)
         d->_anchors->classBegin();
     if (d->extra.isAllocated() && d->extra->layer)
@@ -4398,8 +4439,8 @@ void QQuickItem::componentComplete()
 {
     Q_D(QQuickItem);
     d->componentComplete = true;
-    if (d->_stateGroup)
-        d->_stateGroup->componentComplete();
+    if (QQuickStateGroup *group = d->stateGroup())
+        group->componentComplete();
     if (d->_anchors) {
         d->_anchors->componentComplete();
         QQuickAnchorsPrivate::get(d->_anchors)->updateOnComplete();
@@ -4418,20 +4459,54 @@ void QQuickItem::componentComplete()
         d->addToDirtyList();
         QQuickWindowPrivate::get(d->window)->dirtyItem(this);
     }
+
+    // The object creator only knows the size of the public item, report the private side.
+    QQmlData *ddata = QQmlData::get(this);
+    if (ddata && ddata->outerContext && ddata->outerContext->engine) {
+        QQmlProfiler *profiler = QQmlEnginePrivate::get(ddata->outerContext->engine)->profiler;
+        Q_QML_PROFILE_IF_ENABLED(profiler, {
+            if (profiler->memoryProfiling)
+                profiler->allocateMemory(QQmlProfiler::ObjectMemory,
+                                         QString::fromUtf8(metaObject()->className()),
+                                         ddata->outerContext->url, ddata->lineNumber,
+                                         ddata->columnNumber, d->memoryFootprint());
+        });
+    }
+}
+
+/*!
+    \internal
+
+    Returns the number of bytes held by the item's private data and its lazily
+    created side structures.
+*/
+qint64 QQuickItemPrivate::memoryFootprint() const
+{
+    qint64 size = sizeof(QQuickItemPrivate);
+    if (extra.isAllocated()) {
+        size += sizeof(ExtraData);
+        if (extra->stateGroup)
+            size += sizeof(QQuickStateGroup);
+    }
+    if (_anchors)
+        size += sizeof(QQuickAnchors) + sizeof(QQuickAnchorsPrivate);
+    size += changeListeners.count() * sizeof(ChangeListener);
+    return size;
 }
 
 QQuickStateGroup *QQuickItemPrivate::_states()
 {
     Q_Q(QQuickItem);
-    if (!_stateGroup) {
-        _stateGroup = new QQuickStateGroup;
+    QQuickStateGroup *&group = extra.value().stateGroup;
+    if (!group) {
+        group = new QQuickStateGroup;
         if (!componentComplete)
-            _stateGroup->classBegin();
-        qmlobject_connect(_stateGroup, QQuickStateGroup, SIGNAL(stateChanged(QString)),
+            group->classBegin();
+        qmlobject_connect(group, QQuickStateGroup, SIGNAL(stateChanged(QString)),
                           q, QQuickItem, SIGNAL(stateChanged(QString)))
     }
 
-    return _stateGroup;
+    return group;
 }
 
 QPointF QQuickItemPrivate::computeTransformOrigin() const
@@ -5283,7 +5358,7 @@ bool QQuickItemPrivate::calcEffectiveVisible() const
     return explicitVisible && (!parentItem || QQuickItemPrivate::get(parentItem)->effectiveVisible);
 }
 
-bool QQuickItemPrivate::setEffectiveVisibleRecur(bool newEffectiveVisible)
+bool QQuickItemPrivate::setEffectiveVisibleRecur(bool newEffectiveVisible, bool notifyAccessibility)
 {
     Q_Q(QQuickItem);
 
@@ -5309,11 +5384,13 @@ bool QQuickItemPrivate::setEffectiveVisibleRecur(bool newEffectiveVisible)
 
     bool childVisibilityChanged = false;
     for (int ii = 0; ii < childItems.count(); ++ii)
-        childVisibilityChanged |= QQuickItemPrivate::get(childItems.at(ii))->setEffectiveVisibleRecur(newEffectiveVisible);
+        childVisibilityChanged |= QQuickItemPrivate::get(childItems.at(ii))->setEffectiveVisibleRecur(newEffectiveVisible, notifyAccessibility && !isAccessible);
 
     itemChange(QQuickItem::ItemVisibleHasChanged, effectiveVisible);
 #ifndef QT_NO_ACCESSIBILITY
-    if (isAccessible) {
+    // Only the topmost item whose visibility changed reports it; the event
+    // implies the same change for the whole accessible subtree.
+    if (isAccessible && notifyAccessibility) {
         QAccessibleEvent ev(q, effectiveVisible ? QAccessible::ObjectShow : QAccessible::ObjectHide);
         QAccessible::updateAccessibility(&ev);
     }
@@ -5422,6 +5499,10 @@ void QQuickItemPrivate::dirty(DirtyType type)
     if (type & (TransformOrigin | Transform | BasicTransform | Position | Size))
         transformChanged();
 
+    if (window && (type & (TransformOrigin | Transform | BasicTransform | Position | Size
+                           | ChildrenChanged | ParentChanged | Window | Visible)))
+        QQuickWindowPrivate::get(window)->invalidatePointerIndex();
+
     if (!(dirtyAttributes & type) || (window && !prevDirtyItem)) {
         dirtyAttributes |= type;
         if (window && componentComplete) {
@@ -5820,6 +5901,50 @@ void QQuickItem::setY(qreal v)
                     QRectF(x(), oldy, width(), height()));
 }
 
+/*!
+    \internal
+
+    Sets the \a components of the item's geometry from \a geometry with a single
+    geometryChanged() call. Setting the width or height makes it valid, as with
+    setWidth() and setHeight().
+  */
+void QQuickItemPrivate::setGeometry(const QRectF &geometry, GeometryChangeTypes components)
+{
+    Q_Q(QQuickItem);
+    const QRectF oldGeometry(x, y, width, height);
+    QRectF newGeometry(oldGeometry);
+
+    if (components & XChange)
+        newGeometry.moveLeft(geometry.x());
+    if (components & YChange)
+        newGeometry.moveTop(geometry.y());
+    if ((components & WidthChange) && !qIsNaN(geometry.width())) {
+        widthValid = true;
+        newGeometry.setWidth(geometry.width());
+    }
+    if ((components & HeightChange) && !qIsNaN(geometry.height())) {
+        heightValid = true;
+        newGeometry.setHeight(geometry.height());
+    }
+
+    const bool positionChanged = newGeometry.x() != x || newGeometry.y() != y;
+    const bool sizeChanged = newGeometry.width() != width || newGeometry.height() != height;
+    if (!positionChanged && !sizeChanged)
+        return;
+
+    x = newGeometry.x();
+    y = newGeometry.y();
+    width = newGeometry.width();
+    height = newGeometry.height();
+
+    if (positionChanged)
+        dirty(Position);
+    if (sizeChanged)
+        dirty(Size);
+
+    q->geometryChanged(newGeometry, oldGeometry);
+}
+
 /*!
     \internal
   */
@@ -6447,6 +6572,9 @@ void QQuickItem::setAcceptedMouseButtons(Qt::MouseButtons buttons)
     buttons &= ~Qt::LeftButton;
     if (buttons || d->extra.isAllocated())
         d->extra.value().acceptedMouseButtons = buttons;
+
+    if (d->window)
+        QQuickWindowPrivate::get(d->window)->invalidatePointerIndex();
 }
 
 /*!
@@ -6513,6 +6641,9 @@ void QQuickItem::setAcceptHoverEvents(bool enabled)
 {
     Q_D(QQuickItem);
     d->hoverEnabled = enabled;
+
+    if (d->window)
+        QQuickWindowPrivate::get(d->window)->invalidatePointerIndex();
 }
 
 void QQuickItemPrivate::setHasCursorInChild(bool hasCursor)
@@ -7154,6 +7285,7 @@ QQuickItemLayer::QQuickItemLayer(QQuickItem *item)
     , m_enabled(false)
     , m_mipmap(false)
     , m_smooth(false)
+    , m_partialUpdates(true)
     , m_componentComplete(true)
     , m_wrapMode(QQuickShaderEffectSource::ClampToEdge)
     , m_format(QQuickShaderEffectSource::RGBA)
@@ -7230,6 +7362,7 @@ void QQuickItemLayer::activate()
     m_effectSource->setTextureSize(m_size);
     m_effectSource->setSourceRect(m_sourceRect);
     m_effectSource->setMipmap(m_mipmap);
+    m_effectSource->setPartialUpdates(m_partialUpdates);
     m_effectSource->setWrapMode(m_wrapMode);
     m_effectSource->setFormat(m_format);
 
@@ -7359,6 +7492,30 @@ void QQuickItemLayer::setMipmap(bool mipmap)
 }
 
 
+/*!
+    \qmlproperty bool QtQuick::Item::layer.partialUpdates
+    \since 5.4
+
+    If this property is true, only the parts of the texture which changed
+    since the last frame are rendered again. Set it to false if the
+    \l {Item::layer.effect}{layer.effect} needs the texture to be fully
+    redrawn on every update. The default value is true.
+
+    \sa ShaderEffectSource::partialUpdates
+ */
+
+void QQuickItemLayer::setPartialUpdates(bool partial)
+{
+    if (partial == m_partialUpdates)
+        return;
+    m_partialUpdates = partial;
+
+    if (m_effectSource)
+        m_effectSource->setPartialUpdates(m_partialUpdates);
+
+    emit partialUpdatesChanged(partial);
+}
+
 /*!
     \qmlproperty enumeration QtQuick::Item::layer.format
 
@@ -7584,7 +7741,10 @@ void QQuickItemLayer::updateMatrix()
     QQuickItemPrivate *ld = QQuickItemPrivate::get(l);
     l->setScale(m_item->scale());
     l->setRotation(m_item->rotation());
-    ld->transforms = QQuickItemPrivate::get(m_item)->transforms;
+    QQuickItemPrivate *d = QQuickItemPrivate::get(m_item);
+    if (d->hasTransforms() || ld->hasTransforms())
+        ld->extra.value().transforms = d->extra.isAllocated() ? d->extra->transforms
+                                                              : QList<QQuickTransform *>();
     if (ld->origin() != QQuickItemPrivate::get(m_item)->origin())
         ld->extra.value().origin = QQuickItemPrivate::get(m_item)->origin();
     ld->dirty(QQuickItemPrivate::Transform);
@@ -7595,7 +7755,7 @@ QQuickItemPrivate::ExtraData::ExtraData()
   contents(0), screenAttached(0), layoutDirectionAttached(0),
   keyHandler(0), layer(0),
   effectRefCount(0), hideRefCount(0),
-  opacityNode(0), clipNode(0), rootNode(0),
+  opacityNode(0), clipNode(0), rootNode(0), stateGroup(0),
   acceptedMouseButtons(0), origin(QQuickItem::Center),
   transparentForPositioner(false)
 {
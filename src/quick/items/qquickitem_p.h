@@ -146,6 +146,7 @@ class QQuickItemLayer : public QObject, public QQuickItemChangeListener
     Q_PROPERTY(QRectF sourceRect READ sourceRect WRITE setSourceRect NOTIFY sourceRectChanged)
     Q_PROPERTY(bool mipmap READ mipmap WRITE setMipmap NOTIFY mipmapChanged)
     Q_PROPERTY(bool smooth READ smooth WRITE setSmooth NOTIFY smoothChanged)
+    Q_PROPERTY(bool partialUpdates READ partialUpdates WRITE setPartialUpdates NOTIFY partialUpdatesChanged)
     Q_PROPERTY(QQuickShaderEffectSource::WrapMode wrapMode READ wrapMode WRITE setWrapMode NOTIFY wrapModeChanged)
     Q_PROPERTY(QQuickShaderEffectSource::Format format READ format WRITE setFormat NOTIFY formatChanged)
     Q_PROPERTY(QByteArray samplerName READ name WRITE setName NOTIFY nameChanged)
@@ -166,6 +167,9 @@ public:
     bool smooth() const { return m_smooth; }
     void setSmooth(bool s);
 
+    bool partialUpdates() const { return m_partialUpdates; }
+    void setPartialUpdates(bool partial);
+
     QSize size() const { return m_size; }
     void setSize(const QSize &size);
 
@@ -205,6 +209,7 @@ Q_SIGNALS:
     void nameChanged(const QByteArray &name);
     void effectChanged(QQmlComponent *component);
     void smoothChanged(bool smooth);
+    void partialUpdatesChanged(bool partialUpdates);
     void formatChanged(QQuickShaderEffectSource::Format format);
     void sourceRectChanged(const QRectF &sourceRect);
 
@@ -221,6 +226,7 @@ private:
     bool m_enabled;
     bool m_mipmap;
     bool m_smooth;
+    bool m_partialUpdates;
     bool m_componentComplete;
     QQuickShaderEffectSource::WrapMode m_wrapMode;
     QQuickShaderEffectSource::Format m_format;
@@ -289,6 +295,7 @@ public:
     static void visibleChildren_append(QQmlListProperty<QQuickItem> *prop, QQuickItem *o);
     static int visibleChildren_count(QQmlListProperty<QQuickItem> *prop);
     static QQuickItem *visibleChildren_at(QQmlListProperty<QQuickItem> *prop, int index);
+    static void visibleChildren_toArray(QQmlListProperty<QQuickItem> *prop, QQuickItem **array);
 
     // transform property
     static int transform_count(QQmlListProperty<QQuickTransform> *list);
@@ -361,6 +368,8 @@ public:
         QSGRootNode *rootNode;
 
         QObjectList resourcesList;
+        QList<QQuickTransform *> transforms;
+        QQuickStateGroup *stateGroup;
 
         // Although acceptedMouseButtons is inside ExtraData, we actually store
         // the LeftButton flag in the extra.flag() bit.  This is because it is
@@ -388,7 +397,7 @@ public:
     void updateOrRemoveGeometryChangeListener(QQuickItemChangeListener *listener, GeometryChangeTypes types);
 
     QQuickStateGroup *_states();
-    QQuickStateGroup *_stateGroup;
+    QQuickStateGroup *stateGroup() const { return extra.isAllocated()?extra->stateGroup:0; }
 
     inline QQuickItem::TransformOrigin origin() const;
 
@@ -510,7 +519,9 @@ public:
 
     qreal baselineOffset;
 
-    QList<QQuickTransform *> transforms;
+    void setGeometry(const QRectF &geometry, GeometryChangeTypes components);
+
+    bool hasTransforms() const { return extra.isAllocated() && !extra->transforms.isEmpty(); }
 
     inline qreal z() const { return extra.isAllocated()?extra->z:0; }
     inline qreal scale() const { return extra.isAllocated()?extra->scale:1; }
@@ -518,6 +529,7 @@ public:
     inline qreal opacity() const { return extra.isAllocated()?extra->opacity:1; }
 
     void setAccessibleFlagAndListener();
+    void accessibleChildrenChanged();
 
     virtual qreal getImplicitWidth() const;
     virtual qreal getImplicitHeight() const;
@@ -548,7 +560,7 @@ public:
     void setTransparentForPositioner(bool trans);
 
     bool calcEffectiveVisible() const;
-    bool setEffectiveVisibleRecur(bool);
+    bool setEffectiveVisibleRecur(bool, bool notifyAccessibility = true);
     bool calcEffectiveEnable() const;
     void setEffectiveEnableRecur(QQuickItem *scope, bool);
 
@@ -584,6 +596,8 @@ public:
 
     void setHasCursorInChild(bool hasCursor);
 
+    qint64 memoryFootprint() const;
+
     // recursive helper to let a visual parent mark its visual children
     void markObjects(QV4::ExecutionEngine *e);
 };
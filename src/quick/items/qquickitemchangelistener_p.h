@@ -72,6 +72,7 @@ public:
     virtual void itemDestroyed(QQuickItem *) {}
     virtual void itemChildAdded(QQuickItem *, QQuickItem *) {}
     virtual void itemChildRemoved(QQuickItem *, QQuickItem *) {}
+    virtual void itemAccessibleChildrenChanged(QQuickItem *) {}
     virtual void itemParentChanged(QQuickItem *, QQuickItem *) {}
     virtual void itemRotationChanged(QQuickItem *) {}
     virtual void itemImplicitWidthChanged(QQuickItem *) {}
@@ -44,9 +44,19 @@
 #include "qquickwindow.h"
 #include "qquickitem.h"
 #include "qquickshadereffectsource_p.h"
+#include "qquickglreadback_p.h"
 
 #include <QtQml/QQmlEngine>
 
+#include <QtGui/QOpenGLContext>
+#include <QtGui/QOpenGLFunctions>
+#include <QtGui/QOpenGLFramebufferObject>
+
+#include <QtCore/QMutex>
+#include <QtCore/QRunnable>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QThreadPool>
+
 #include <private/qquickpixmapcache_p.h>
 #include <private/qquickitem_p.h>
 #include <private/qsgcontext_p.h>
@@ -54,6 +64,91 @@
 QT_BEGIN_NAMESPACE
 
 const QEvent::Type Event_Grab_Completed = static_cast<QEvent::Type>(QEvent::User + 1);
+const QEvent::Type Event_Grab_Converted = static_cast<QEvent::Type>(QEvent::User + 2);
+
+// Number of frames to wait for the GPU before mapping the pixel buffer anyway
+static const int MaximumReadbackFrames = 3;
+
+namespace {
+
+/*
+    State of an asynchronous readback, shared between the grab result on
+    the GUI thread, the render thread that owns the pixel buffer and the
+    worker thread converting the pixels. The mutex guards \c result and the
+    GL objects, which are only touched on the render thread.
+ */
+struct GrabReadback
+{
+    GrabReadback()
+        : result(0)
+        , buffer(0)
+        , fence(0)
+        , frames(0)
+    {
+    }
+
+    void release()
+    {
+        QOpenGLContext::currentContext()->functions()->glDeleteBuffers(1, &buffer);
+        gl.deleteSync(fence);
+        buffer = 0;
+        fence = 0;
+    }
+
+    QMutex mutex;
+    QQuickItemGrabResult *result;
+    QQuickGLReadbackFunctions gl;
+    GLuint buffer;
+    void *fence;
+    QSize size;
+    int frames;
+};
+
+class GrabConvertedEvent : public QEvent
+{
+public:
+    GrabConvertedEvent(const QImage &i) : QEvent(Event_Grab_Converted), image(i) { }
+    QImage image;
+};
+
+class GrabConversion : public QRunnable
+{
+public:
+    GrabConversion(const QSharedPointer<GrabReadback> &r, const QImage &p)
+        : readback(r)
+        , pixels(p)
+    {
+    }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        // Same result as QOpenGLFramebufferObject::toImage() on an RGBA target.
+        QImage image = pixels.convertToFormat(QImage::Format_ARGB32_Premultiplied).mirrored();
+        QMutexLocker locker(&readback->mutex);
+        if (readback->result)
+            QCoreApplication::postEvent(readback->result, new GrabConvertedEvent(image));
+    }
+
+    QSharedPointer<GrabReadback> readback;
+    QImage pixels;
+};
+
+class GrabReadbackCleanup : public QRunnable
+{
+public:
+    GrabReadbackCleanup(const QSharedPointer<GrabReadback> &r) : readback(r) { }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        QMutexLocker locker(&readback->mutex);
+        if (readback->buffer)
+            readback->release();
+    }
+
+    QSharedPointer<GrabReadback> readback;
+};
+
+}
 
 class QQuickItemGrabResultPrivate : public QObjectPrivate
 {
@@ -81,6 +176,9 @@ public:
 
     static QQuickItemGrabResult *create(QQuickItem *item, const QSize &size);
 
+    bool startReadback();
+    bool finishReadback();
+
     QImage image;
 
     mutable QUrl url;
@@ -94,8 +192,82 @@ public:
     QQuickShaderEffectTexture *texture;
     QSizeF itemSize;
     QSize textureSize;
+
+    QSharedPointer<GrabReadback> readback;
 };
 
+/*
+    Reads the rendered texture into a pixel buffer object and places a fence
+    behind the read, so that the pixels can be picked up a frame or two later
+    without stalling the pipeline. Returns false if the GL implementation
+    lacks pixel buffers or sync objects, in which case the caller falls back
+    to a synchronous read.
+ */
+bool QQuickItemGrabResultPrivate::startReadback()
+{
+    QOpenGLFramebufferObject *fbo = texture->framebufferObject();
+    if (!fbo)
+        return false;
+
+    GrabReadback *r = readback.data();
+    QMutexLocker locker(&r->mutex);
+    r->gl = QQuickGLReadbackFunctions();
+    if (!r->gl.isValid())
+        return false;
+
+    QOpenGLFunctions *gl = QOpenGLContext::currentContext()->functions();
+    r->size = fbo->size();
+
+    GLint previousFbo = 0;
+    gl->glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFbo);
+    fbo->bind();
+
+    gl->glGenBuffers(1, &r->buffer);
+    gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, r->buffer);
+    gl->glBufferData(GL_PIXEL_PACK_BUFFER, r->size.width() * r->size.height() * 4, 0, GL_STREAM_READ);
+    gl->glReadPixels(0, 0, r->size.width(), r->size.height(), GL_RGBA, GL_UNSIGNED_BYTE, 0);
+    gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, previousFbo);
+
+    r->fence = r->gl.fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    return true;
+}
+
+/*
+    Called after each following frame. Once the fence has been passed, or
+    after MaximumReadbackFrames frames, the buffer is mapped and copied and
+    the conversion into the final image format is handed to a worker thread.
+ */
+bool QQuickItemGrabResultPrivate::finishReadback()
+{
+    GrabReadback *r = readback.data();
+    QMutexLocker locker(&r->mutex);
+    if (!r->buffer)
+        return true;
+
+    GLenum status = r->gl.clientWaitSync(r->fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED
+            && ++r->frames < MaximumReadbackFrames) {
+        return false;
+    }
+
+    QOpenGLFunctions *gl = QOpenGLContext::currentContext()->functions();
+    QImage pixels(r->size, QImage::Format_RGBA8888_Premultiplied);
+    gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, r->buffer);
+    const int byteCount = r->size.width() * r->size.height() * 4;
+    if (const void *data = r->gl.mapBufferRange(GL_PIXEL_PACK_BUFFER, 0, byteCount, GL_MAP_READ_BIT)) {
+        memcpy(pixels.bits(), data, byteCount);
+        r->gl.unmapBuffer(GL_PIXEL_PACK_BUFFER);
+    } else {
+        pixels = QImage();
+    }
+    gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    r->release();
+
+    QThreadPool::globalInstance()->start(new GrabConversion(readback, pixels));
+    return true;
+}
+
 /*!
  * \qmlproperty url QtQuick::ItemGrabResult::url
  *
@@ -171,6 +343,22 @@ QQuickItemGrabResult::QQuickItemGrabResult(QObject *parent)
 {
 }
 
+/*!
+ * Destroys the grab result.
+ */
+QQuickItemGrabResult::~QQuickItemGrabResult()
+{
+    Q_D(QQuickItemGrabResult);
+    if (!d->readback)
+        return;
+    // A pending conversion must not post to us anymore, and a pixel buffer
+    // still in flight is released on the render thread.
+    QMutexLocker locker(&d->readback->mutex);
+    d->readback->result = 0;
+    if (d->readback->buffer && d->window)
+        d->window->scheduleRenderJob(new GrabReadbackCleanup(d->readback), QQuickWindow::NoStage);
+}
+
 /*!
  * \qmlmethod bool QtQuick::ItemGrabResult::saveToFile(fileName)
  *
@@ -207,7 +395,9 @@ QImage QQuickItemGrabResult::image() const
 bool QQuickItemGrabResult::event(QEvent *e)
 {
     Q_D(QQuickItemGrabResult);
-    if (e->type() == Event_Grab_Completed) {
+    if (e->type() == Event_Grab_Converted)
+        d->image = static_cast<GrabConvertedEvent *>(e)->image;
+    if (e->type() == Event_Grab_Completed || e->type() == Event_Grab_Converted) {
         // JS callback
         if (d->qmlEngine && d->callback.isCallable())
             d->callback.call(QJSValueList() << d->qmlEngine->newQObject(this));
@@ -236,8 +426,15 @@ void QQuickItemGrabResult::setup()
 void QQuickItemGrabResult::render()
 {
     Q_D(QQuickItemGrabResult);
-    if (!d->texture)
+    if (!d->texture) {
+        if (d->readback->buffer) {
+            if (d->finishReadback())
+                disconnect(d->window.data(), &QQuickWindow::afterRendering, this, &QQuickItemGrabResult::render);
+            else
+                d->window->update();
+        }
         return;
+    }
 
     d->texture->setRect(QRectF(0, d->itemSize.height(), d->itemSize.width(), -d->itemSize.height()));
     QSGContext *sg = QSGRenderContext::from(QOpenGLContext::currentContext())->sceneGraphContext();
@@ -246,6 +443,17 @@ void QQuickItemGrabResult::render()
                               qMax(minSize.height(), d->textureSize.height())));
     d->texture->scheduleUpdate();
     d->texture->updateTexture();
+
+    if (d->startReadback()) {
+        delete d->texture;
+        d->texture = 0;
+        // Keep listening to afterRendering and make sure there is a next frame
+        // to pick up the pixels in.
+        disconnect(d->window.data(), &QQuickWindow::beforeSynchronizing, this, &QQuickItemGrabResult::setup);
+        d->window->update();
+        return;
+    }
+
     d->image =  d->texture->toImage();
 
     delete d->texture;
@@ -282,6 +490,8 @@ QQuickItemGrabResult *QQuickItemGrabResultPrivate::create(QQuickItem *item, cons
     d->item = item;
     d->window = item->window();
     d->textureSize = size;
+    d->readback = QSharedPointer<GrabReadback>(new GrabReadback);
+    d->readback->result = result;
 
     QQuickItemPrivate::get(item)->refFromEffectItem(false);
 
@@ -307,6 +517,10 @@ QQuickItemGrabResult *QQuickItemGrabResultPrivate::create(QQuickItem *item, cons
  * be quite costly. For "live" preview, use \l {QtQuick::Item::layer.enabled} {layers}
  * or ShaderEffectSource.
  *
+ * When the OpenGL implementation supports pixel buffer objects and sync
+ * objects, the copy is done asynchronously and the image is typically
+ * delivered one or two frames after the item was rendered.
+ *
  * \sa QQuickWindow::grabWindow()
  */
 QSharedPointer<QQuickItemGrabResult> QQuickItem::grabToImage(const QSize &targetSize)
@@ -350,6 +564,10 @@ QSharedPointer<QQuickItemGrabResult> QQuickItem::grabToImage(const QSize &target
  * copy that surface from the GPU's memory into the CPU's memory, which can
  * be quite costly. For "live" preview, use \l {QtQuick::Item::layer.enabled} {layers}
  * or ShaderEffectSource.
+ *
+ * When the OpenGL implementation supports pixel buffer objects and sync
+ * objects, the copy is done asynchronously and the image is typically
+ * delivered one or two frames after the item was rendered.
  */
 
 /*!
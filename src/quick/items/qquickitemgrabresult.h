@@ -63,6 +63,8 @@ class Q_QUICK_EXPORT QQuickItemGrabResult : public QObject
     Q_PROPERTY(QImage image READ image CONSTANT)
     Q_PROPERTY(QUrl url READ url CONSTANT)
 public:
+    ~QQuickItemGrabResult();
+
     QImage image() const;
     QUrl url() const;
 
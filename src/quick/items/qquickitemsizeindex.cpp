@@ -0,0 +1,208 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include "qquickitemsizeindex_p.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QQuickItemSizeIndex
+    \internal
+
+    Remembers the size along the flow of every item of a view, so that the
+    view can map between model indexes and content positions without
+    extrapolating from the average size of the items it currently has.
+
+    Sizes are kept in a Fenwick tree, which makes setSize(), extent(),
+    position() and indexAt() O(log n).  Items which have not been measured
+    yet count as the estimate passed to the queries.  Insertions and removals
+    are O(n) and only mark the tree dirty; it is rebuilt on the next query.
+ */
+
+QQuickItemSizeIndex::QQuickItemSizeIndex()
+    : m_dirty(false)
+{
+}
+
+int QQuickItemSizeIndex::knownCount() const
+{
+    return prefix(m_sizes.count()).count;
+}
+
+void QQuickItemSizeIndex::reset(int count)
+{
+    m_sizes.fill(-1, count);
+    m_tree.fill(Node(), count + 1);
+    m_dirty = false;
+}
+
+void QQuickItemSizeIndex::clear()
+{
+    m_sizes.clear();
+    m_tree.clear();
+    m_dirty = false;
+}
+
+void QQuickItemSizeIndex::setSize(int index, qreal size)
+{
+    Q_ASSERT(index >= 0 && index < m_sizes.count());
+    size = qMax(size, qreal(0));
+    const qreal old = m_sizes.at(index);
+    if (old == size)
+        return;
+    m_sizes[index] = size;
+    if (!m_dirty)
+        add(index, old >= 0 ? size - old : size, old >= 0 ? 0 : 1);
+}
+
+void QQuickItemSizeIndex::insert(int index, int count)
+{
+    Q_ASSERT(index >= 0 && index <= m_sizes.count());
+    if (count <= 0)
+        return;
+    m_sizes.insert(index, count, -1);
+    m_dirty = true;
+}
+
+void QQuickItemSizeIndex::remove(int index, int count)
+{
+    Q_ASSERT(index >= 0 && index + count <= m_sizes.count());
+    if (count <= 0)
+        return;
+    m_sizes.remove(index, count);
+    m_dirty = true;
+}
+
+/*
+    Returns the total size of the items in [from, to), not including any
+    spacing between them.
+*/
+qreal QQuickItemSizeIndex::extent(int from, int to, qreal estimate) const
+{
+    from = qBound(0, from, m_sizes.count());
+    to = qBound(0, to, m_sizes.count());
+    if (to <= from)
+        return 0;
+    const Node start = prefix(from);
+    const Node end = prefix(to);
+    return end.sum - start.sum + (to - from - (end.count - start.count)) * estimate;
+}
+
+/*
+    Returns the position of the item at \a index relative to the first item.
+*/
+qreal QQuickItemSizeIndex::position(int index, qreal estimate, qreal spacing) const
+{
+    index = qBound(0, index, m_sizes.count());
+    return extent(0, index, estimate) + index * spacing;
+}
+
+/*
+    Returns the index of the item at \a pos relative to the first item, that
+    is the last item whose position() is not greater than \a pos.
+*/
+int QQuickItemSizeIndex::indexAt(qreal pos, qreal estimate, qreal spacing) const
+{
+    const int n = m_sizes.count();
+    if (!n || pos <= 0)
+        return 0;
+    if (m_dirty)
+        rebuild();
+
+    int step = 1;
+    while (step * 2 <= n)
+        step *= 2;
+
+    int index = 0;
+    for (; step; step /= 2) {
+        const int next = index + step;
+        if (next > n)
+            continue;
+        const Node &node = m_tree.at(next);
+        const qreal extent = node.sum + (step - node.count) * estimate + step * spacing;
+        if (extent <= pos) {
+            pos -= extent;
+            index = next;
+        }
+    }
+    return qMin(index, n - 1);
+}
+
+QQuickItemSizeIndex::Node QQuickItemSizeIndex::prefix(int index) const
+{
+    if (m_dirty)
+        rebuild();
+    Node result;
+    for (; index > 0; index &= index - 1) {
+        result.sum += m_tree.at(index).sum;
+        result.count += m_tree.at(index).count;
+    }
+    return result;
+}
+
+void QQuickItemSizeIndex::add(int index, qreal size, int count)
+{
+    const int n = m_sizes.count();
+    for (++index; index <= n; index += index & -index) {
+        m_tree[index].sum += size;
+        m_tree[index].count += count;
+    }
+}
+
+void QQuickItemSizeIndex::rebuild() const
+{
+    const int n = m_sizes.count();
+    m_tree.fill(Node(), n + 1);
+    for (int i = 1; i <= n; ++i) {
+        const qreal size = m_sizes.at(i - 1);
+        if (size >= 0) {
+            m_tree[i].sum += size;
+            m_tree[i].count += 1;
+        }
+        const int parent = i + (i & -i);
+        if (parent <= n) {
+            m_tree[parent].sum += m_tree.at(i).sum;
+            m_tree[parent].count += m_tree.at(i).count;
+        }
+    }
+    m_dirty = false;
+}
+
+QT_END_NAMESPACE
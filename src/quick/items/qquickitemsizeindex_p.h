@@ -0,0 +1,103 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QQUICKITEMSIZEINDEX_P_H
+#define QQUICKITEMSIZEINDEX_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick/qtquickglobal.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+class Q_QUICK_PRIVATE_EXPORT QQuickItemSizeIndex
+{
+public:
+    QQuickItemSizeIndex();
+
+    int count() const { return m_sizes.count(); }
+    int knownCount() const;
+
+    void reset(int count);
+    void clear();
+
+    qreal size(int index) const { return m_sizes.at(index); }
+    bool isKnown(int index) const { return m_sizes.at(index) >= 0; }
+    void setSize(int index, qreal size);
+
+    void insert(int index, int count);
+    void remove(int index, int count);
+
+    qreal extent(int from, int to, qreal estimate) const;
+    qreal position(int index, qreal estimate, qreal spacing) const;
+    int indexAt(qreal pos, qreal estimate, qreal spacing) const;
+
+private:
+    struct Node {
+        Node() : sum(0), count(0) {}
+        qreal sum;
+        int count;
+    };
+
+    Node prefix(int index) const;
+    void add(int index, qreal size, int count);
+    void rebuild() const;
+
+    // Sizes of the items, -1 for an item that has not been measured.
+    QVector<qreal> m_sizes;
+    // Fenwick tree over m_sizes, rebuilt lazily after insertions and removals.
+    mutable QVector<Node> m_tree;
+    mutable bool m_dirty;
+};
+
+QT_END_NAMESPACE
+
+#endif // QQUICKITEMSIZEINDEX_P_H
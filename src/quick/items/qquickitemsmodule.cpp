@@ -260,6 +260,11 @@ static void qt_quickitems_defineModule(const char *uri, int major, int minor)
 
     qmlRegisterType<QQuickText, 2>(uri, 2, 2, "Text");
     qmlRegisterType<QQuickTextEdit, 2>(uri, 2, 2, "TextEdit");
+    qmlRegisterType<QQuickShaderEffectSource, 1>(uri, 2, 2, "ShaderEffectSource");
+
+    qmlRegisterType<QQuickLoader, 1>(uri, 2, 3, "Loader");
+    qmlRegisterType<QQuickRepeater, 1>(uri, 2, 3, "Repeater");
+    qmlRegisterType<QQuickFlickable, 1>(uri, 2, 3, "Flickable");
 }
 
 static void initResources()
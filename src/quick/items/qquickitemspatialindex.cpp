@@ -0,0 +1,221 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qquickitemspatialindex_p.h"
+#include "qquickitem_p.h"
+
+#include <QtCore/qvarlengtharray.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QQuickItemSpatialIndex
+    \internal
+
+    A bounding volume hierarchy over the scene bounding rects of the items
+    of a window which accept mouse or hover events. It is used to find the
+    items which may be under a point without mapping the point into every
+    item of the scene. The index is rebuilt lazily after it has been
+    invalidated by a geometry, visibility or hierarchy change.
+
+    The rects are conservative, so the candidates still need the exact
+    contains() test, which is done in delivery order by QQuickWindow.
+ */
+
+static const int qquick_spatial_index_leaf_size = 4;
+
+namespace {
+    struct EntryCenterLessThan
+    {
+        EntryCenterLessThan(bool horizontal) : horizontal(horizontal) { }
+        template <typename T> bool operator()(const T &a, const T &b) const
+        {
+            return horizontal ? a.rect.center().x() < b.rect.center().x()
+                              : a.rect.center().y() < b.rect.center().y();
+        }
+        bool horizontal;
+    };
+}
+
+QQuickItemSpatialIndex::QQuickItemSpatialIndex()
+    : m_valid(false)
+{
+}
+
+void QQuickItemSpatialIndex::rebuild(QQuickItem *root)
+{
+    m_entries.clear();
+    m_nodes.clear();
+    m_valid = true;
+
+    if (!root)
+        return;
+
+    collect(root, QTransform());
+    if (m_entries.isEmpty())
+        return;
+
+    m_nodes.reserve(2 * (m_entries.size() / qquick_spatial_index_leaf_size) + 1);
+    m_nodes.resize(1);
+    build(0, 0, m_entries.size());
+}
+
+void QQuickItemSpatialIndex::collect(QQuickItem *item, const QTransform &parentTransform)
+{
+    QQuickItemPrivate *itemPrivate = QQuickItemPrivate::get(item);
+    QTransform transform = parentTransform;
+    itemPrivate->itemToParentTransform(transform);
+
+    int filter = 0;
+    if (itemPrivate->acceptedMouseButtons())
+        filter |= AcceptsMouse;
+    if (itemPrivate->hoverEnabled)
+        filter |= AcceptsHover;
+
+    if (filter) {
+        // Grow the rect a little, so that rounding in the mapping can not
+        // drop an item whose edge is exactly under the point.
+        QRectF local = QRectF(0, 0, itemPrivate->width, itemPrivate->height).normalized();
+        Entry entry;
+        entry.rect = transform.mapRect(local).adjusted(-1, -1, 1, 1);
+        entry.item = item;
+        entry.filter = filter;
+        m_entries.append(entry);
+    }
+
+    // Hidden items are skipped by event delivery, and becoming visible
+    // invalidates the index.
+    for (int i = 0; i < itemPrivate->childItems.count(); ++i) {
+        QQuickItem *child = itemPrivate->childItems.at(i);
+        if (child->isVisible())
+            collect(child, transform);
+    }
+}
+
+void QQuickItemSpatialIndex::build(int node, int first, int count)
+{
+    qreal left = m_entries.at(first).rect.left();
+    qreal top = m_entries.at(first).rect.top();
+    qreal right = m_entries.at(first).rect.right();
+    qreal bottom = m_entries.at(first).rect.bottom();
+    qreal centerLeft = m_entries.at(first).rect.center().x();
+    qreal centerTop = m_entries.at(first).rect.center().y();
+    qreal centerRight = centerLeft;
+    qreal centerBottom = centerTop;
+    int filter = 0;
+    for (int i = first; i < first + count; ++i) {
+        const Entry &e = m_entries.at(i);
+        QPointF center = e.rect.center();
+        left = qMin(left, e.rect.left());
+        top = qMin(top, e.rect.top());
+        right = qMax(right, e.rect.right());
+        bottom = qMax(bottom, e.rect.bottom());
+        centerLeft = qMin(centerLeft, center.x());
+        centerTop = qMin(centerTop, center.y());
+        centerRight = qMax(centerRight, center.x());
+        centerBottom = qMax(centerBottom, center.y());
+        filter |= e.filter;
+    }
+
+    Node &n = m_nodes[node];
+    n.bounds = QRectF(QPointF(left, top), QPointF(right, bottom));
+    n.filter = filter;
+
+    if (count <= qquick_spatial_index_leaf_size) {
+        n.first = first;
+        n.count = count;
+        return;
+    }
+
+    // Split at the median of the entry centers along the longer axis.
+    int half = count / 2;
+    bool horizontal = centerRight - centerLeft >= centerBottom - centerTop;
+    Entry *begin = m_entries.data() + first;
+    std::nth_element(begin, begin + half, begin + count, EntryCenterLessThan(horizontal));
+
+    int child = m_nodes.size();
+    n.first = child;
+    n.count = 0;
+    m_nodes.resize(child + 2); // invalidates 'n'
+    build(child, first, half);
+    build(child + 1, first + half, count - half);
+}
+
+static inline bool qquick_rect_contains(const QRectF &rect, const QPointF &p)
+{
+    return p.x() >= rect.left() && p.x() <= rect.right()
+            && p.y() >= rect.top() && p.y() <= rect.bottom();
+}
+
+/*!
+    Appends the items matching \a filter, whose scene bounding rect may
+    contain \a scenePos, to \a items, in no particular order.
+ */
+void QQuickItemSpatialIndex::itemsAt(const QPointF &scenePos, int filter, QVector<QQuickItem *> *items) const
+{
+    if (m_nodes.isEmpty())
+        return;
+
+    QVarLengthArray<int, 64> stack;
+    stack.append(0);
+    while (!stack.isEmpty()) {
+        const Node &n = m_nodes.at(stack.last());
+        stack.removeLast();
+        if (!(n.filter & filter) || !qquick_rect_contains(n.bounds, scenePos))
+            continue;
+
+        if (n.count == 0) {
+            stack.append(n.first);
+            stack.append(n.first + 1);
+            continue;
+        }
+
+        for (int i = n.first; i < n.first + n.count; ++i) {
+            const Entry &e = m_entries.at(i);
+            if ((e.filter & filter) && qquick_rect_contains(e.rect, scenePos))
+                items->append(e.item);
+        }
+    }
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,107 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QQUICKITEMSPATIALINDEX_P_H
+#define QQUICKITEMSPATIALINDEX_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick/qtquickglobal.h>
+#include <QtCore/qrect.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+class QQuickItem;
+class QTransform;
+
+class Q_QUICK_PRIVATE_EXPORT QQuickItemSpatialIndex
+{
+public:
+    enum ItemFilter {
+        AcceptsMouse = 0x1,
+        AcceptsHover = 0x2
+    };
+
+    QQuickItemSpatialIndex();
+
+    bool isValid() const { return m_valid; }
+    void invalidate() { m_valid = false; }
+
+    void rebuild(QQuickItem *root);
+    void itemsAt(const QPointF &scenePos, int filter, QVector<QQuickItem *> *items) const;
+
+private:
+    struct Entry {
+        QRectF rect;
+        QQuickItem *item;
+        int filter;
+    };
+
+    // A leaf holds 'count' entries starting at 'first'. An inner node has
+    // count == 0 and its children at 'first' and 'first + 1'.
+    struct Node {
+        QRectF bounds;
+        int filter;
+        int first;
+        int count;
+    };
+
+    void collect(QQuickItem *item, const QTransform &parentTransform);
+    void build(int node, int first, int count);
+
+    QVector<Entry> m_entries;
+    QVector<Node> m_nodes;
+    bool m_valid;
+};
+
+QT_END_NAMESPACE
+
+#endif // QQUICKITEMSPATIALINDEX_P_H
@@ -42,10 +42,20 @@
 #include "qquickitemview_p_p.h"
 #include <QtQuick/private/qquicktransition_p.h>
 #include <QtQml/QQmlInfo>
+#include <QtCore/qmath.h>
 #include "qplatformdefs.h"
 
 QT_BEGIN_NAMESPACE
 
+// Number of refills a released delegate is kept for reuse.
+#define QML_VIEW_MAXPOOLTIME 2
+
+// Time in ms the visible area may wait for asynchronously incubated
+// delegates while flicking before they are created synchronously.
+#ifndef QML_VIEW_ASYNCFILLTIME
+#define QML_VIEW_ASYNCFILLTIME 32
+#endif
+
 // Default cacheBuffer for all views.
 #ifndef QML_VIEW_DEFAULTCACHEBUFFER
 #define QML_VIEW_DEFAULTCACHEBUFFER 320
@@ -159,6 +169,9 @@ void FxViewItem::startTransition(QQuickItemViewTransitioner *transitioner)
 QQuickItemViewChangeSet::QQuickItemViewChangeSet()
     : active(false)
 {
+    // Model changes are only consumed when the view is next laid out, buffer them until then
+    // rather than merging each one as it arrives.
+    pendingChanges.setAccumulating(true);
     reset();
 }
 
@@ -496,6 +509,23 @@ void QQuickItemView::setDisplayMarginEnd(int margin)
     }
 }
 
+bool QQuickItemView::reuseItems() const
+{
+    Q_D(const QQuickItemView);
+    return d->reuseItems;
+}
+
+void QQuickItemView::setReuseItems(bool reuse)
+{
+    Q_D(QQuickItemView);
+    if (d->reuseItems != reuse) {
+        d->reuseItems = reuse;
+        if (!reuse && d->model)
+            d->model->drainReusableItemsPool(0);
+        emit reuseItemsChanged();
+    }
+}
+
 Qt::LayoutDirection QQuickItemView::layoutDirection() const
 {
     Q_D(const QQuickItemView);
@@ -1496,7 +1526,8 @@ QQuickItemViewPrivate::QQuickItemViewPrivate()
     , inLayout(false), inViewportMoved(false), forceLayout(false), currentIndexCleared(false)
     , haveHighlightRange(false), autoHighlight(true), highlightRangeStartValid(false), highlightRangeEndValid(false)
     , fillCacheBuffer(false), inRequest(false)
-    , runDelayedRemoveTransition(false), delegateValidated(false)
+    , runDelayedRemoveTransition(false), delegateValidated(false), reuseItems(false)
+    , incubateVisibleItems(false)
 {
     bufferPause.addAnimationChangeListener(this, QAbstractAnimationJob::Completion);
     bufferPause.setLoopCount(1);
@@ -1672,7 +1703,7 @@ void QQuickItemViewPrivate::updateCurrent(int modelIndex)
 void QQuickItemViewPrivate::clear()
 {
     currentChanges.reset();
-    timeline.clear();
+    clearTimeline();
 
     for (int i = 0; i < visibleItems.count(); ++i)
         releaseItem(visibleItems.at(i));
@@ -1735,14 +1766,49 @@ void QQuickItemViewPrivate::refill(qreal from, qreal to)
 
     int prevCount = itemCount;
     itemCount = model->count();
-    qreal bufferFrom = from - buffer;
-    qreal bufferTo = to + buffer;
+    qreal bufferBefore = buffer;
+    qreal bufferAfter = buffer;
+    // While flicking, extend the buffer by the distance the flick is expected to
+    // travel and shrink it behind the flick, where items are not needed again.
+    const bool flickBuffer = buffer && q->isFlicking()
+            && (bufferMode == BufferBefore || bufferMode == BufferAfter);
+    if (flickBuffer) {
+        if (bufferMode == BufferAfter) {
+            bufferAfter += flickDistance();
+            bufferBefore /= 2;
+        } else {
+            bufferBefore += flickDistance();
+            bufferAfter /= 2;
+        }
+    }
+    qreal bufferFrom = from - bufferBefore;
+    qreal bufferTo = to + bufferAfter;
     qreal fillFrom = from;
     qreal fillTo = to;
 
+    // While flicking, the delegates entering the view are incubated
+    // asynchronously too, so that heavy delegates don't stall the flick.
+    // Where they are still missing, items not yet created are laid out
+    // using the estimated item size. If the view has waited for them longer
+    // than QML_VIEW_ASYNCFILLTIME they are created synchronously.
+    incubateVisibleItems = q->isFlicking()
+            && !(asyncFillTimer.isValid() && asyncFillTimer.elapsed() > QML_VIEW_ASYNCFILLTIME);
     bool added = addVisibleItems(fillFrom, fillTo, bufferFrom, bufferTo, false);
+    if (incubateVisibleItems && requestedIndex != -1) {
+        if (!asyncFillTimer.isValid())
+            asyncFillTimer.start();
+    } else {
+        asyncFillTimer.invalidate();
+    }
+    incubateVisibleItems = false;
+
     bool removed = removeNonVisibleItems(bufferFrom, bufferTo);
 
+    // Delegates released by the previous refills that are still unused are not
+    // needed for the current scrolling direction
+    if (reuseItems)
+        model->drainReusableItemsPool(QML_VIEW_MAXPOOLTIME);
+
     if (requestedIndex == -1 && buffer && bufferMode != NoBuffer) {
         if (added) {
             // We've already created a new delegate this frame.
@@ -1757,6 +1823,9 @@ void QQuickItemViewPrivate::refill(qreal from, qreal to)
         }
     }
 
+    if (flickBuffer)
+        prefetch(bufferFrom, bufferTo);
+
     if (added || removed) {
         markExtentsDirty();
         updateBeginningEnd();
@@ -1770,6 +1839,48 @@ void QQuickItemViewPrivate::refill(qreal from, qreal to)
         emit q->countChanged();
 }
 
+/*
+    Returns the distance the view will still travel before the current flick stops,
+    limited to one page.
+*/
+qreal QQuickItemViewPrivate::flickDistance() const
+{
+    const AxisData &data = layoutOrientation() == Qt::Vertical ? vData : hData;
+    if (!data.flicking || deceleration <= 0)
+        return 0;
+    const qreal velocity = data.smoothVelocity.value();
+    return qMin(velocity * velocity / (2 * deceleration), size());
+}
+
+/*
+    Tells the model which items the buffer area in the direction of the current flick
+    will need, so that it can fetch their data before the delegates are created.
+*/
+void QQuickItemViewPrivate::prefetch(qreal bufferFrom, qreal bufferTo)
+{
+    const int lastIndex = findLastVisibleIndex();
+    if (lastIndex < visibleIndex || visibleItems.isEmpty())
+        return;
+
+    // Estimate the number of items needed from the size of the items that exist.
+    const FxViewItem *firstItem = visibleItems.first();
+    const FxViewItem *lastItem = visibleItems.last();
+    const qreal extent = lastItem->endPosition() - firstItem->position();
+    if (extent <= 0)
+        return;
+    const qreal itemsPerPixel = (lastIndex - visibleIndex + 1) / extent;
+
+    if (bufferMode == BufferAfter) {
+        const int count = qCeil((bufferTo - lastItem->endPosition()) * itemsPerPixel);
+        if (count > 0)
+            model->prefetch(lastIndex + 1, lastIndex + count);
+    } else {
+        const int count = qCeil((firstItem->position() - bufferFrom) * itemsPerPixel);
+        if (count > 0)
+            model->prefetch(visibleIndex - count, visibleIndex - 1);
+    }
+}
+
 void QQuickItemViewPrivate::regenerate()
 {
     Q_Q(QQuickItemView);
@@ -1909,6 +2020,7 @@ bool QQuickItemViewPrivate::applyModelChanges(ChangeResult *totalInsertionResult
     }
 
     updateUnrequestedIndexes();
+    prepareModelChanges(currentChanges.pendingChanges);
     moveReason = QQuickItemViewPrivate::Other;
 
     FxViewItem *prevVisibleItemsFirst = visibleItems.count() ? *visibleItems.constBegin() : 0;
@@ -2337,13 +2449,17 @@ bool QQuickItemViewPrivate::releaseItem(FxViewItem *item)
         trackedItem = 0;
     item->trackGeometry(false);
 
-    QQmlInstanceModel::ReleaseFlags flags = model->release(item->item);
+    QQmlInstanceModel::ReleaseFlags flags = model->release(
+                item->item, reuseItems ? QQmlInstanceModel::Reusable : QQmlInstanceModel::NotReusable);
     if (flags == 0) {
         // item was not destroyed, and we no longer reference it.
         QQuickItemPrivate::get(item->item)->setCulled(true);
         unrequestedItems.insert(item->item, model->indexOf(item->item, q));
     } else if (flags & QQmlInstanceModel::Destroyed) {
         item->item->setParentItem(0);
+    } else if (flags & QQmlInstanceModel::Pooled) {
+        // the model keeps the item for a later request, possibly for another index
+        QQuickItemPrivate::get(item->item)->setCulled(true);
     }
     delete item;
     return flags != QQmlInstanceModel::Referenced;
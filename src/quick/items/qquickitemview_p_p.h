@@ -48,6 +48,7 @@
 #include <QtQml/private/qqmlobjectmodel_p.h>
 #include <QtQml/private/qqmldelegatemodel_p.h>
 #include <QtQml/private/qqmlchangeset_p.h>
+#include <QtCore/qelapsedtimer.h>
 
 
 QT_BEGIN_NAMESPACE
@@ -189,6 +190,8 @@ public:
     virtual void animationFinished(QAbstractAnimationJob *);
     void refill();
     void refill(qreal from, qreal to);
+    qreal flickDistance() const;
+    void prefetch(qreal bufferFrom, qreal bufferTo);
     void mirrorChange();
 
     FxViewItem *createItem(int modelIndex, bool asynchronous = false);
@@ -274,6 +277,7 @@ public:
     QQuickItemViewChangeSet currentChanges;
     QQuickItemViewChangeSet bufferedChanges;
     QPauseAnimationJob bufferPause;
+    QElapsedTimer asyncFillTimer;
 
     QQmlComponent *highlightComponent;
     FxViewItem *highlight;
@@ -313,6 +317,8 @@ public:
     bool inRequest : 1;
     bool runDelayedRemoveTransition : 1;
     bool delegateValidated : 1;
+    bool reuseItems : 1;
+    bool incubateVisibleItems : 1;
 
 protected:
     virtual Qt::Orientation layoutOrientation() const = 0;
@@ -354,6 +360,7 @@ protected:
                 QList<FxViewItem *> *newItems, QList<MovedItem> *movingIntoView) = 0;
 
     virtual bool needsRefillForAddedOrRemovedIndex(int) const { return false; }
+    virtual void prepareModelChanges(const QQmlChangeSet &) {}
     virtual void translateAndTransitionItemsAfter(int afterIndex, const ChangeResult &insertionResult, const ChangeResult &removalResult) = 0;
 
     virtual void initializeViewItem(FxViewItem *) {}
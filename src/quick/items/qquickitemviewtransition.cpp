@@ -117,13 +117,22 @@ void QQuickItemViewTransitionJob::startTransition(QQuickItemViewTransitionableIt
         attached->m_index = index;
         attached->m_item = item->item;
         attached->m_destination = to;
-        attached->m_targetIndexes = m_transitioner->targetIndexes(type);
-        attached->m_targetItems = m_transitioner->targetItems(type);
         emit attached->indexChanged();
         emit attached->itemChanged();
         emit attached->destinationChanged();
-        emit attached->targetIndexesChanged();
-        emit attached->targetItemsChanged();
+
+        // All items transitioned by the same layout share the target lists, which makes
+        // comparing them cheap and saves re-evaluating bindings on them for every item.
+        const QList<int> &targetIndexes = m_transitioner->targetIndexes(type);
+        if (attached->m_targetIndexes != targetIndexes) {
+            attached->m_targetIndexes = targetIndexes;
+            emit attached->targetIndexesChanged();
+        }
+        const QList<QObject *> &targetItems = m_transitioner->targetItems(type);
+        if (attached->m_targetItems != targetItems) {
+            attached->m_targetItems = targetItems;
+            emit attached->targetItemsChanged();
+        }
     }
 
     QQuickStateOperation::ActionList actions;
@@ -498,10 +507,10 @@ void QQuickItemViewTransitionableItem::startTransition(QQuickItemViewTransitione
         return;
     }
 
-    if (!transition || transition->m_type != nextTransitionType || transition->m_isTarget != isTransitionTarget) {
-        delete transition;
+    // The job is reused for transitions of other types as well, starting it cancels
+    // whatever it was running before without reporting that transition as finished.
+    if (!transition)
         transition = new QQuickItemViewTransitionJob;
-    }
 
     transition->startTransition(this, index, transitioner, nextTransitionType, nextTransitionTo, isTransitionTarget);
     clearCurrentScheduledTransition();
@@ -634,6 +643,12 @@ QQuickViewTransitionAttached::QQuickViewTransitionAttached(QObject *parent)
     above. These attributes merely provide extra details that are useful for customising view
     transitions.
 
+    As a transition is run for every item that is affected by an operation, large displacements
+    can run hundreds of transitions at once. Transitions which only animate the position, opacity
+    or scale of the items can use \l XAnimator, \l YAnimator, \l OpacityAnimator and
+    \l ScaleAnimator instead of NumberAnimation, so that they run on the render thread and don't
+    have to update the item properties on the GUI thread for every frame.
+
     Following is an introduction to view transitions and the ways in which the ViewTransition
     attached property can be used to augment view transitions.
 
@@ -41,6 +41,7 @@
 
 #include "qquicklistview_p.h"
 #include "qquickitemview_p_p.h"
+#include "qquickitemsizeindex_p.h"
 
 #include <private/qqmlobjectmodel_p.h>
 #include <QtQml/qqmlexpression.h>
@@ -131,6 +132,13 @@ public:
 
     void updateAverage();
 
+    bool hasSizeIndex() const { return cacheItemSizes && itemCount > 0 && sizeIndex.count() == itemCount; }
+    qreal sizeIndexEstimate() const;
+    qreal sizeFromRole(int modelIndex) const;
+    void syncSizeIndex();
+    void updateSizeIndex();
+    virtual void prepareModelChanges(const QQmlChangeSet &changes);
+
     void itemGeometryChanged(QQuickItem *item, const QRectF &newGeometry, const QRectF &oldGeometry);
     virtual void fixupPosition();
     virtual void fixup(AxisData &data, qreal minExtent, qreal maxExtent);
@@ -161,9 +169,13 @@ public:
     QString lastVisibleSection;
     QString nextSection;
 
+    QQuickItemSizeIndex sizeIndex;
+    QString sizeRole;
+
     qreal overshootDist;
     bool correctFlick : 1;
     bool inFlickCorrection : 1;
+    bool cacheItemSizes : 1;
 
     QQuickListViewPrivate()
         : orient(QQuickListView::Vertical)
@@ -173,7 +185,7 @@ public:
         , highlightPosAnimator(0), highlightWidthAnimator(0), highlightHeightAnimator(0)
         , highlightMoveVelocity(400), highlightResizeVelocity(400), highlightResizeDuration(-1)
         , sectionCriteria(0), currentSectionItem(0), nextSectionItem(0)
-        , overshootDist(0.0), correctFlick(false), inFlickCorrection(false)
+        , overshootDist(0.0), correctFlick(false), inFlickCorrection(false), cacheItemSizes(false)
     {
         highlightMoveDuration = -1; //override default value set in base class
     }
@@ -422,8 +434,12 @@ qreal QQuickListViewPrivate::originPosition() const
     qreal pos = 0;
     if (!visibleItems.isEmpty()) {
         pos = (*visibleItems.constBegin())->position();
-        if (visibleIndex > 0)
-            pos -= visibleIndex * (averageSize + spacing);
+        if (visibleIndex > 0) {
+            if (hasSizeIndex())
+                pos -= sizeIndex.position(visibleIndex, sizeIndexEstimate(), spacing);
+            else
+                pos -= visibleIndex * (averageSize + spacing);
+        }
     }
     return pos;
 }
@@ -433,15 +449,24 @@ qreal QQuickListViewPrivate::lastPosition() const
     qreal pos = 0;
     if (!visibleItems.isEmpty()) {
         int invisibleCount = visibleItems.count() - visibleIndex;
+        int lastIndex = -1;
         for (int i = visibleItems.count()-1; i >= 0; --i) {
             if (visibleItems.at(i)->index != -1) {
-                invisibleCount = model->count() - visibleItems.at(i)->index - 1;
+                lastIndex = visibleItems.at(i)->index;
+                invisibleCount = model->count() - lastIndex - 1;
                 break;
             }
         }
-        pos = (*(--visibleItems.constEnd()))->endPosition() + invisibleCount * (averageSize + spacing);
+        pos = (*(--visibleItems.constEnd()))->endPosition();
+        if (lastIndex != -1 && hasSizeIndex())
+            pos += sizeIndex.extent(lastIndex + 1, itemCount, sizeIndexEstimate()) + invisibleCount * spacing;
+        else
+            pos += invisibleCount * (averageSize + spacing);
     } else if (model && model->count()) {
-        pos = (model->count() * averageSize + (model->count()-1) * spacing);
+        if (hasSizeIndex())
+            pos = sizeIndex.position(itemCount, sizeIndexEstimate(), spacing) - spacing;
+        else
+            pos = (model->count() * averageSize + (model->count()-1) * spacing);
     }
     return pos;
 }
@@ -452,6 +477,17 @@ qreal QQuickListViewPrivate::positionAt(int modelIndex) const
         return item->position();
     }
     if (!visibleItems.isEmpty()) {
+        if (hasSizeIndex()) {
+            const qreal estimate = sizeIndexEstimate();
+            if (modelIndex < visibleIndex) {
+                return (*visibleItems.constBegin())->position()
+                        - sizeIndex.extent(modelIndex, visibleIndex, estimate) - (visibleIndex - modelIndex) * spacing;
+            } else {
+                int lastIndex = findLastVisibleIndex(visibleIndex);
+                return (*(--visibleItems.constEnd()))->endPosition() + spacing
+                        + sizeIndex.extent(lastIndex + 1, modelIndex, estimate) + (modelIndex - lastIndex - 1) * spacing;
+            }
+        }
         if (modelIndex < visibleIndex) {
             int count = visibleIndex - modelIndex;
             qreal cs = 0;
@@ -473,6 +509,17 @@ qreal QQuickListViewPrivate::endPositionAt(int modelIndex) const
     if (FxViewItem *item = visibleItem(modelIndex))
         return item->endPosition();
     if (!visibleItems.isEmpty()) {
+        if (hasSizeIndex()) {
+            const qreal estimate = sizeIndexEstimate();
+            if (modelIndex < visibleIndex) {
+                return (*visibleItems.constBegin())->position()
+                        - sizeIndex.extent(modelIndex + 1, visibleIndex, estimate) - (visibleIndex - modelIndex) * spacing;
+            } else {
+                int lastIndex = findLastVisibleIndex(visibleIndex);
+                return (*(--visibleItems.constEnd()))->endPosition()
+                        + sizeIndex.extent(lastIndex + 1, modelIndex + 1, estimate) + (modelIndex - lastIndex) * spacing;
+            }
+        }
         if (modelIndex < visibleIndex) {
             int count = visibleIndex - modelIndex;
             return (*visibleItems.constBegin())->position() - (count - 1) * (averageSize + spacing) - spacing;
@@ -555,6 +602,7 @@ void QQuickListViewPrivate::clear()
     releaseSectionItem(nextSectionItem);
     nextSectionItem = 0;
     lastVisibleSection = QString();
+    sizeIndex.clear();
     QQuickItemViewPrivate::clear();
 }
 
@@ -628,6 +676,10 @@ bool QQuickListViewPrivate::releaseItem(FxViewItem *item)
 
 bool QQuickListViewPrivate::addVisibleItems(qreal fillFrom, qreal fillTo, qreal bufferFrom, qreal bufferTo, bool doBuffer)
 {
+    // The delegates are incubated asynchronously in the cacheBuffer area, and
+    // while flicking also in the visible area (see QQuickItemViewPrivate::refill())
+    const bool asynchronous = doBuffer || incubateVisibleItems;
+    syncSizeIndex();
     qreal itemEnd = visiblePos;
     if (visibleItems.count()) {
         visiblePos = (*visibleItems.constBegin())->position();
@@ -642,16 +694,25 @@ bool QQuickListViewPrivate::addVisibleItems(qreal fillFrom, qreal fillTo, qreal
         || bufferTo < visiblePos - averageSize - spacing)) {
         // We've jumped more than a page.  Estimate which items are now
         // visible and fill from there.
-        int count = (fillFrom - itemEnd) / (averageSize + spacing);
-        int newModelIdx = qBound(0, modelIndex + count, model->count());
-        count = newModelIdx - modelIndex;
-        if (count) {
+        int newModelIdx;
+        qreal newVisiblePos;
+        if (hasSizeIndex()) {
+            const qreal estimate = sizeIndexEstimate();
+            const qreal itemEndPos = sizeIndex.position(modelIndex, estimate, spacing);
+            newModelIdx = sizeIndex.indexAt(itemEndPos + fillFrom - itemEnd, estimate, spacing);
+            newVisiblePos = itemEnd + sizeIndex.position(newModelIdx, estimate, spacing) - itemEndPos;
+        } else {
+            int count = (fillFrom - itemEnd) / (averageSize + spacing);
+            newModelIdx = qBound(0, modelIndex + count, model->count());
+            newVisiblePos = itemEnd + (newModelIdx - modelIndex) * (averageSize + spacing);
+        }
+        if (newModelIdx != modelIndex) {
             for (int i = 0; i < visibleItems.count(); ++i)
                 releaseItem(visibleItems.at(i));
             visibleItems.clear();
             modelIndex = newModelIdx;
             visibleIndex = modelIndex;
-            visiblePos = itemEnd + count * (averageSize + spacing);
+            visiblePos = newVisiblePos;
             itemEnd = visiblePos;
         }
     }
@@ -663,7 +724,7 @@ bool QQuickListViewPrivate::addVisibleItems(qreal fillFrom, qreal fillTo, qreal
 #ifdef DEBUG_DELEGATE_LIFECYCLE
         qDebug() << "refill: append item" << modelIndex << "pos" << pos << "buffer" << doBuffer;
 #endif
-        if (!(item = static_cast<FxListItemSG*>(createItem(modelIndex, doBuffer))))
+        if (!(item = static_cast<FxListItemSG*>(createItem(modelIndex, asynchronous))))
             break;
         if (!transitioner || !transitioner->canTransition(QQuickItemViewTransitioner::PopulateTransition, true)) // pos will be set by layoutVisibleItems()
             item->setPosition(pos, true);
@@ -674,14 +735,14 @@ bool QQuickListViewPrivate::addVisibleItems(qreal fillFrom, qreal fillTo, qreal
         changed = true;
     }
 
-    if (doBuffer && requestedIndex != -1) // already waiting for an item
+    if (asynchronous && requestedIndex != -1) // already waiting for an item
         return changed;
 
     while (visibleIndex > 0 && visibleIndex <= model->count() && visiblePos > fillFrom) {
 #ifdef DEBUG_DELEGATE_LIFECYCLE
         qDebug() << "refill: prepend item" << visibleIndex-1 << "current top pos" << visiblePos << "buffer" << doBuffer;
 #endif
-        if (!(item = static_cast<FxListItemSG*>(createItem(visibleIndex-1, doBuffer))))
+        if (!(item = static_cast<FxListItemSG*>(createItem(visibleIndex-1, asynchronous))))
             break;
         --visibleIndex;
         visiblePos -= item->size() + spacing;
@@ -797,6 +858,7 @@ void QQuickListViewPrivate::layoutVisibleItems(int fromModelIndex)
             fixedCurrent = fixedCurrent || (currentItem && item->item == currentItem->item);
         }
         averageSize = qRound(sum / visibleItems.count());
+        updateSizeIndex();
 
         // move current item if it is not a visible item.
         if (currentIndex >= 0 && currentItem && !fixedCurrent)
@@ -1276,6 +1338,86 @@ void QQuickListViewPrivate::updateAverage()
     for (int i = 0; i < visibleItems.count(); ++i)
         sum += visibleItems.at(i)->size();
     averageSize = qRound(sum / visibleItems.count());
+    updateSizeIndex();
+}
+
+qreal QQuickListViewPrivate::sizeIndexEstimate() const
+{
+    // Prefer the average of every item measured so far, which changes much
+    // less while scrolling than the average of the visible items.
+    const int known = sizeIndex.knownCount();
+    return known ? sizeIndex.extent(0, sizeIndex.count(), 0) / known : averageSize;
+}
+
+qreal QQuickListViewPrivate::sizeFromRole(int modelIndex) const
+{
+    bool ok = false;
+    qreal size = model->stringValue(modelIndex, sizeRole).toDouble(&ok);
+    return ok ? size : -1;
+}
+
+void QQuickListViewPrivate::syncSizeIndex()
+{
+    if (!cacheItemSizes || sizeIndex.count() == itemCount)
+        return;
+    sizeIndex.reset(itemCount);
+    if (!sizeRole.isEmpty()) {
+        for (int i = 0; i < itemCount; ++i) {
+            qreal size = sizeFromRole(i);
+            if (size >= 0)
+                sizeIndex.setSize(i, size);
+        }
+    }
+    updateSizeIndex();
+}
+
+void QQuickListViewPrivate::updateSizeIndex()
+{
+    if (!hasSizeIndex())
+        return;
+    for (int i = 0; i < visibleItems.count(); ++i) {
+        const FxViewItem *item = visibleItems.at(i);
+        if (item->index >= 0 && item->index < itemCount)
+            sizeIndex.setSize(item->index, item->size());
+    }
+    if (currentItem && currentItem->index >= 0 && currentItem->index < itemCount)
+        sizeIndex.setSize(currentItem->index, currentItem->size());
+}
+
+void QQuickListViewPrivate::prepareModelChanges(const QQmlChangeSet &changes)
+{
+    if (!hasSizeIndex())
+        return;
+
+    // Keep the sizes of moved items, everything else that is inserted is
+    // unknown until it is measured or read from the size role.
+    QHash<QQmlChangeSet::MoveKey, qreal> movedSizes;
+    const QVector<QQmlChangeSet::Remove> &removals = changes.removes();
+    for (int i = 0; i < removals.count(); ++i) {
+        const QQmlChangeSet::Remove &removal = removals.at(i);
+        if (removal.isMove()) {
+            for (int j = removal.index; j < removal.index + removal.count; ++j) {
+                if (sizeIndex.isKnown(j))
+                    movedSizes.insert(removal.moveKey(j), sizeIndex.size(j));
+            }
+        }
+        sizeIndex.remove(removal.index, removal.count);
+    }
+
+    const QVector<QQmlChangeSet::Insert> &insertions = changes.inserts();
+    for (int i = 0; i < insertions.count(); ++i) {
+        const QQmlChangeSet::Insert &insertion = insertions.at(i);
+        sizeIndex.insert(insertion.index, insertion.count);
+        for (int j = insertion.index; j < insertion.index + insertion.count; ++j) {
+            qreal size = -1;
+            if (insertion.isMove())
+                size = movedSizes.value(insertion.moveKey(j), -1);
+            if (size < 0 && !sizeRole.isEmpty())
+                size = sizeFromRole(j);
+            if (size >= 0)
+                sizeIndex.setSize(j, size);
+        }
+    }
 }
 
 qreal QQuickListViewPrivate::headerSize() const
@@ -1469,7 +1611,7 @@ void QQuickListViewPrivate::fixup(AxisData &data, qreal minExtent, qreal maxExte
 
         qreal dist = qAbs(data.move + pos);
         if (dist > 0) {
-            timeline.reset(data.move);
+            resetTimeline(data);
             if (fixupMode != Immediate) {
                 timeline.move(data.move, -pos, QEasingCurve(QEasingCurve::InOutQuad), fixupDuration/2);
                 data.fixingUp = true;
@@ -1488,7 +1630,7 @@ void QQuickListViewPrivate::fixup(AxisData &data, qreal minExtent, qreal maxExte
         if (isContentFlowReversed())
             viewPos = -viewPos-size();
 
-        timeline.reset(data.move);
+        resetTimeline(data);
         if (viewPos != position()) {
             if (fixupMode != Immediate) {
                 timeline.move(data.move, -viewPos, QEasingCurve(QEasingCurve::InOutQuad), fixupDuration/2);
@@ -1615,8 +1757,9 @@ bool QQuickListViewPrivate::flick(AxisData &data, qreal minExtent, qreal maxExte
                     data.flickTarget -= overshootDist;
                 }
             }
-            timeline.reset(data.move);
+            resetTimeline(data);
             timeline.accel(data.move, v, accel, maxDistance + overshootDist);
+            startAsyncFlick(data, minExtent, maxExtent, v, accel, maxDistance + overshootDist);
             timeline.callback(QQuickTimeLineCallback(&data.move, fixupCallback, this));
             correctFlick = true;
             return true;
@@ -1641,18 +1784,19 @@ bool QQuickListViewPrivate::flick(AxisData &data, qreal minExtent, qreal maxExte
             qreal dist = -newtarget + data.move.value();
             if ((v < 0 && dist < 0) || (v > 0 && dist > 0)) {
                 correctFlick = false;
-                timeline.reset(data.move);
+                resetTimeline(data);
                 fixup(data, minExtent, maxExtent);
                 return false;
             }
-            timeline.reset(data.move);
+            resetTimeline(data);
             timeline.accelDistance(data.move, v, -dist);
+            startAsyncFlick(data, minExtent, maxExtent, v, v * v / (2 * qAbs(dist)));
             timeline.callback(QQuickTimeLineCallback(&data.move, fixupCallback, this));
             return false;
         }
     } else {
         correctFlick = false;
-        timeline.reset(data.move);
+        resetTimeline(data);
         fixup(data, minExtent, maxExtent);
         return false;
     }
@@ -2146,10 +2290,35 @@ void QQuickListView::setOrientation(QQuickListView::Orientation orientation)
     delegates; the fewer objects and bindings in a delegate, the faster a view can be
     scrolled.
 
+    While the view is flicking, the buffer in the direction of the flick is
+    extended by the distance the flick is expected to travel, up to the size of
+    the view, and the buffer behind it is halved.
+
     The cacheBuffer operates outside of any display margins specified by
     displayMarginBeginning or displayMarginEnd.
 */
 
+/*!
+    \qmlproperty bool QtQuick::ListView::reuseItems
+
+    This property enables the reuse of delegate instances.
+
+    When true, delegates that are moved out of the view and outside of the
+    cacheBuffer are not destroyed but kept in a pool, and handed out again
+    when a delegate is needed for another index.  Instead of a new delegate
+    being created, the \c index and model role properties of the pooled
+    delegate are updated to the new model item.  Any other state held in the
+    delegate, for example properties set from JavaScript, is left untouched;
+    use the DelegateModel::pooled() and DelegateModel::reused() attached
+    signals to reset it.
+
+    Delegates are only reused for models whose items are accessed by index,
+    such as ListModel, QAbstractItemModel subclasses, JavaScript arrays and
+    integers.
+
+    The default value is false.
+*/
+
 /*!
     \qmlproperty int QtQuick::ListView::displayMarginBeginning
     \qmlproperty int QtQuick::ListView::displayMarginEnd
@@ -2380,6 +2549,69 @@ void QQuickListView::setSnapMode(SnapMode mode)
     }
 }
 
+/*!
+    \qmlproperty bool QtQuick::ListView::cacheItemSizes
+    \qmlproperty string QtQuick::ListView::sizeRole
+    \since QtQuick 2.3
+
+    These properties make the list remember the size of every item.
+
+    Normally the list only knows the sizes of the delegates it has created,
+    and estimates the position of every other item, and with it contentHeight
+    or contentWidth, from the average size of those delegates.  If the
+    delegates differ in size this estimate changes as the list is scrolled,
+    which makes scroll bars jump and positionViewAtIndex() less accurate.
+
+    When \c cacheItemSizes is true, the size of each delegate is recorded when
+    it is laid out and is used for the item's position from then on, also
+    after the delegate has been destroyed.  Items which have not been seen yet
+    are estimated from the average of the recorded sizes.  Moved items keep
+    their size; the sizes are forgotten when the model is reset.
+
+    If \c sizeRole is also set, the size of items which have not been created
+    yet is read from that model role.  It should give the size of the whole
+    item along the flow of the list, including any section header.  The role
+    is read for every item when the cache is filled, so it should be cheap for
+    the model to provide.
+
+    Positions are looked up in the cache in logarithmic time, which keeps the
+    list responsive for very large models.  The cache needs memory for every
+    item in the model, so it is disabled by default.
+*/
+bool QQuickListView::cacheItemSizes() const
+{
+    Q_D(const QQuickListView);
+    return d->cacheItemSizes;
+}
+
+void QQuickListView::setCacheItemSizes(bool cache)
+{
+    Q_D(QQuickListView);
+    if (d->cacheItemSizes != cache) {
+        d->cacheItemSizes = cache;
+        d->sizeIndex.clear();
+        d->forceLayoutPolish();
+        emit cacheItemSizesChanged();
+    }
+}
+
+QString QQuickListView::sizeRole() const
+{
+    Q_D(const QQuickListView);
+    return d->sizeRole;
+}
+
+void QQuickListView::setSizeRole(const QString &role)
+{
+    Q_D(QQuickListView);
+    if (d->sizeRole != role) {
+        d->sizeRole = role;
+        d->sizeIndex.clear();
+        d->forceLayoutPolish();
+        emit sizeRoleChanged();
+    }
+}
+
 
 /*!
     \qmlproperty Component QtQuick::ListView::footer
@@ -112,6 +112,9 @@ class Q_AUTOTEST_EXPORT QQuickListView : public QQuickItemView
 
     Q_PROPERTY(SnapMode snapMode READ snapMode WRITE setSnapMode NOTIFY snapModeChanged)
 
+    Q_PROPERTY(bool cacheItemSizes READ cacheItemSizes WRITE setCacheItemSizes NOTIFY cacheItemSizesChanged)
+    Q_PROPERTY(QString sizeRole READ sizeRole WRITE setSizeRole NOTIFY sizeRoleChanged)
+
     Q_ENUMS(Orientation)
     Q_ENUMS(SnapMode)
     Q_CLASSINFO("DefaultProperty", "data")
@@ -147,6 +150,12 @@ public:
     SnapMode snapMode() const;
     void setSnapMode(SnapMode mode);
 
+    bool cacheItemSizes() const;
+    void setCacheItemSizes(bool cache);
+
+    QString sizeRole() const;
+    void setSizeRole(const QString &role);
+
     static QQuickListViewAttached *qmlAttachedProperties(QObject *);
 
 public Q_SLOTS:
@@ -161,6 +170,8 @@ Q_SIGNALS:
     void highlightResizeVelocityChanged();
     void highlightResizeDurationChanged();
     void snapModeChanged();
+    void cacheItemSizesChanged();
+    void sizeRoleChanged();
 
 protected:
     virtual void viewportMoved(Qt::Orientations orient);
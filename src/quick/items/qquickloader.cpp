@@ -47,15 +47,33 @@
 #include <private/qqmlglobal_p.h>
 
 #include <private/qqmlcomponent_p.h>
+#include <private/qv8engine_p.h>
 
 QT_BEGIN_NAMESPACE
 
 static const QQuickItemPrivate::ChangeTypes watchedChanges
     = QQuickItemPrivate::Geometry | QQuickItemPrivate::ImplicitWidth | QQuickItemPrivate::ImplicitHeight;
 
+/*
+    Components loaded from a url are shared by all the Loaders of an engine,
+    so that switching back and forth between pages does not have to resolve
+    the type and build a new component every time.
+*/
+class QQuickLoaderComponentCache : public QV8Engine::Deletable
+{
+public:
+    QQuickLoaderComponentCache(QV8Engine *) {}
+    ~QQuickLoaderComponentCache() { qDeleteAll(components); }
+
+    QHash<QUrl, QQmlComponent *> components;
+};
+
+V8_DEFINE_EXTENSION(QQuickLoaderComponentCache, loaderComponentCache)
+
 QQuickLoaderPrivate::QQuickLoaderPrivate()
-    : item(0), object(0), component(0), itemContext(0), incubator(0), updatingSize(false),
-      active(true), loadingFromSource(false), asynchronous(false)
+    : item(0), object(0), component(0), itemContext(0), incubator(0), keepAlive(0),
+      preloadComponent(0), preloadContext(0), preloadIncubator(0), updatingSize(false),
+      active(true), loadingFromSource(false), asynchronous(false), objectHasInitialProperties(false)
 {
 }
 
@@ -64,6 +82,8 @@ QQuickLoaderPrivate::~QQuickLoaderPrivate()
     delete itemContext;
     itemContext = 0;
     delete incubator;
+    delete preloadIncubator;
+    delete preloadContext;
     disposeInitialPropertyValues();
 }
 
@@ -98,20 +118,55 @@ void QQuickLoaderPrivate::clear()
     itemContext = 0;
 
     if (loadingFromSource && component) {
-        // disconnect since we deleteLater
+        // the component is shared through the cache, so only disconnect
         QObject::disconnect(component, SIGNAL(statusChanged(QQmlComponent::Status)),
                 q, SLOT(_q_sourceLoaded()));
         QObject::disconnect(component, SIGNAL(progressChanged(qreal)),
                 q, SIGNAL(progressChanged()));
-        component->deleteLater();
         component = 0;
     }
     componentStrongReference.clear();
+
+    releaseObject(loadingFromSource ? source : QUrl());
     source = QUrl();
+}
+
+QQmlComponent *QQuickLoaderPrivate::cachedComponent(const QUrl &url, QQmlComponent::CompilationMode mode)
+{
+    Q_Q(QQuickLoader);
+    QQmlEngine *engine = qmlEngine(q);
+    QQuickLoaderComponentCache *cache = loaderComponentCache(QQmlEnginePrivate::getV8Engine(engine));
+
+    QQmlComponent *c = cache->components.value(url);
+    if (c) {
+        // Drop components that failed to load, and those that outlived a
+        // QQmlEngine::clearComponentCache(), so that they are loaded again.
+        if (c->isError()
+            || (c->isReady() && !QQmlEnginePrivate::get(engine)->typeLoader.isTypeLoaded(c->url()))) {
+            cache->components.remove(url);
+            c->deleteLater();
+            c = 0;
+        }
+    }
+
+    if (!c) {
+        c = new QQmlComponent(engine, url, mode);
+        cache->components.insert(url, c);
+    }
+    return c;
+}
+
+// Detaches the loaded object from the Loader. Objects created from \a url
+// are kept for reuse if keepAlive allows it, everything else is destroyed.
+void QQuickLoaderPrivate::releaseObject(const QUrl &url)
+{
+    bool keep = object && keepAlive > 0 && !url.isEmpty() && !objectHasInitialProperties;
+    bool visible = true;
 
     if (item) {
         QQuickItemPrivate *p = QQuickItemPrivate::get(item);
         p->removeItemChangeListener(this, watchedChanges);
+        visible = p->explicitVisible;
 
         // We can't delete immediately because our item may have triggered
         // the Loader to load a different item.
@@ -120,9 +175,184 @@ void QQuickLoaderPrivate::clear()
         item = 0;
     }
     if (object) {
-        object->deleteLater();
+        if (keep) {
+            keptObjects.prepend(KeptObject(url, object, visible));
+            trimKeptObjects();
+        } else {
+            object->deleteLater();
+        }
         object = 0;
     }
+    objectHasInitialProperties = false;
+}
+
+bool QQuickLoaderPrivate::restoreKeptObject()
+{
+    Q_Q(QQuickLoader);
+    if (!initialPropertyValues.isUndefined())
+        return false;
+
+    KeptObject kept;
+    if (prepared.object && prepared.url == source) {
+        kept = prepared;
+        prepared = KeptObject();
+    } else {
+        for (int ii = 0; ii < keptObjects.count(); ++ii) {
+            if (keptObjects.at(ii).object && keptObjects.at(ii).url == source) {
+                kept = keptObjects.takeAt(ii);
+                break;
+            }
+        }
+    }
+    if (!kept.object)
+        return false;
+
+    object = kept.object;
+    item = qmlobject_cast<QQuickItem*>(object);
+    if (item) {
+        if (widthValid && !QQuickItemPrivate::get(item)->widthValid)
+            item->setWidth(q->width());
+        if (heightValid && !QQuickItemPrivate::get(item)->heightValid)
+            item->setHeight(q->height());
+        item->setParentItem(q);
+        item->setVisible(kept.visible);
+    }
+
+    emit q->itemChanged();
+    initResize();
+    emit q->sourceChanged();
+    emit q->statusChanged();
+    emit q->progressChanged();
+    emit q->loaded();
+    return true;
+}
+
+void QQuickLoaderPrivate::trimKeptObjects()
+{
+    while (keptObjects.count() > keepAlive) {
+        KeptObject kept = keptObjects.takeLast();
+        if (kept.object)
+            kept.object->deleteLater();
+    }
+}
+
+void QQuickLoaderPrivate::startPreload()
+{
+    Q_Q(QQuickLoader);
+    if (preload.isEmpty())
+        return;
+
+    preloadComponent = cachedComponent(preload, QQmlComponent::Asynchronous);
+
+    // Without asynchronous instantiation, preparing the page only compiles it.
+    if (!asynchronous)
+        return;
+
+    if (preloadComponent->isLoading()) {
+        QObject::connect(preloadComponent, SIGNAL(statusChanged(QQmlComponent::Status)),
+                q, SLOT(_q_preloadSourceLoaded()));
+    } else {
+        _q_preloadSourceLoaded();
+    }
+}
+
+void QQuickLoaderPrivate::cancelPreload()
+{
+    Q_Q(QQuickLoader);
+    if (preloadIncubator)
+        preloadIncubator->clear();
+    delete preloadContext;
+    preloadContext = 0;
+
+    if (preloadComponent) {
+        QObject::disconnect(preloadComponent, SIGNAL(statusChanged(QQmlComponent::Status)),
+                q, SLOT(_q_preloadSourceLoaded()));
+        preloadComponent = 0;
+    }
+
+    // A prepared object that was never shown is treated like an unloaded one.
+    if (prepared.object) {
+        if (QQuickItem *preparedItem = qmlobject_cast<QQuickItem*>(prepared.object))
+            preparedItem->setParentItem(0);
+        keptObjects.prepend(prepared);
+        trimKeptObjects();
+    }
+    prepared = KeptObject();
+}
+
+void QQuickLoaderPrivate::_q_preloadSourceLoaded()
+{
+    Q_Q(QQuickLoader);
+    if (!preloadComponent || preloadComponent->isLoading())
+        return;
+
+    QObject::disconnect(preloadComponent, SIGNAL(statusChanged(QQmlComponent::Status)),
+            q, SLOT(_q_preloadSourceLoaded()));
+
+    // errors are reported once the page is actually loaded
+    if (!preloadComponent->isReady() || (object && source == preload))
+        return;
+
+    QQmlContext *creationContext = preloadComponent->creationContext();
+    if (!creationContext) creationContext = qmlContext(q);
+    delete preloadContext;
+    preloadContext = new QQmlContext(creationContext);
+    preloadContext->setContextObject(q);
+
+    delete preloadIncubator;
+    preloadIncubator = new QQuickLoaderPreloadIncubator(this);
+
+    preloadComponent->create(*preloadIncubator, preloadContext);
+}
+
+void QQuickLoaderPreloadIncubator::setInitialState(QObject *o)
+{
+    loader->setPreloadInitialState(o);
+}
+
+void QQuickLoaderPrivate::setPreloadInitialState(QObject *obj)
+{
+    Q_Q(QQuickLoader);
+
+    // Keep the prepared item in the Loader, but hidden, so that bindings
+    // to its parent are already resolved when it is shown.
+    QQuickItem *preloadItem = qmlobject_cast<QQuickItem*>(obj);
+    prepared.visible = true;
+    if (preloadItem) {
+        prepared.visible = QQuickItemPrivate::get(preloadItem)->explicitVisible;
+        if (widthValid && !QQuickItemPrivate::get(preloadItem)->widthValid)
+            preloadItem->setWidth(q->width());
+        if (heightValid && !QQuickItemPrivate::get(preloadItem)->heightValid)
+            preloadItem->setHeight(q->height());
+        preloadItem->setParentItem(q);
+        preloadItem->setVisible(false);
+    }
+    if (obj) {
+        QQml_setParent_noEvent(preloadContext, obj);
+        QQml_setParent_noEvent(obj, q);
+        preloadContext = 0;
+    }
+}
+
+void QQuickLoaderPreloadIncubator::statusChanged(Status status)
+{
+    loader->preloadStateChanged(status);
+}
+
+void QQuickLoaderPrivate::preloadStateChanged(QQmlIncubator::Status status)
+{
+    Q_Q(QQuickLoader);
+    if (status == QQmlIncubator::Ready) {
+        prepared.url = preload;
+        prepared.object = preloadIncubator->object();
+        preloadIncubator->clear();
+    } else if (status == QQmlIncubator::Error) {
+        if (!preloadIncubator->errors().isEmpty())
+            QQmlEnginePrivate::warning(qmlEngine(q), preloadIncubator->errors());
+        delete preloadContext;
+        preloadContext = 0;
+        delete preloadIncubator->object();
+    }
 }
 
 void QQuickLoaderPrivate::initResize()
@@ -352,19 +582,8 @@ void QQuickLoader::setActive(bool newVal)
             d->itemContext = 0;
         }
 
-        if (d->item) {
-            QQuickItemPrivate *p = QQuickItemPrivate::get(d->item);
-            p->removeItemChangeListener(d, watchedChanges);
-
-            // We can't delete immediately because our item may have triggered
-            // the Loader to load a different item.
-            d->item->setParentItem(0);
-            d->item->setVisible(false);
-            d->item = 0;
-        }
         if (d->object) {
-            d->object->deleteLater();
-            d->object = 0;
+            d->releaseObject(d->loadingFromSource ? d->source : QUrl());
             emit itemChanged();
         }
         emit statusChanged();
@@ -428,8 +647,9 @@ void QQuickLoader::loadFromSource()
 
     if (isComponentComplete()) {
         QQmlComponent::CompilationMode mode = d->asynchronous ? QQmlComponent::Asynchronous : QQmlComponent::PreferSynchronous;
-        d->component = new QQmlComponent(qmlEngine(this), d->source, mode, this);
-        d->load();
+        d->component = d->cachedComponent(d->source, mode);
+        if (!d->restoreKeptObject())
+            d->load();
     }
 }
 
@@ -648,6 +868,7 @@ void QQuickLoaderPrivate::setInitialState(QObject *obj)
     if (initialPropertyValues.isUndefined())
         return;
 
+    objectHasInitialProperties = true;
     QQmlComponentPrivate *d = QQmlComponentPrivate::get(component);
     Q_ASSERT(d && d->engine);
     QV4::ExecutionEngine *v4 = qmlGlobalForIpv.engine();
@@ -809,10 +1030,11 @@ void QQuickLoader::componentComplete()
     if (active()) {
         if (d->loadingFromSource) {
             QQmlComponent::CompilationMode mode = d->asynchronous ? QQmlComponent::Asynchronous : QQmlComponent::PreferSynchronous;
-            d->component = new QQmlComponent(qmlEngine(this), d->source, mode, this);
+            d->component = d->cachedComponent(d->source, mode);
         }
         d->load();
     }
+    d->startPreload();
 }
 
 /*!
@@ -888,6 +1110,75 @@ void QQuickLoader::setAsynchronous(bool a)
     emit asynchronousChanged();
 }
 
+/*!
+    \qmlproperty url QtQuick::Loader::preload
+    \since 5.3
+
+    This property holds the URL of a QML component that is likely to be
+    loaded next, for example the next page of a wizard.
+
+    The component is compiled in the background as soon as this property is
+    set. If \l asynchronous is \c true, an object is also created from it
+    asynchronously and kept hidden, so that setting \l source to the same URL
+    shows it immediately, without instantiating the component again.
+
+    \sa source, asynchronous, keepAlive
+*/
+QUrl QQuickLoader::preload() const
+{
+    Q_D(const QQuickLoader);
+    return d->preload;
+}
+
+void QQuickLoader::setPreload(const QUrl &url)
+{
+    Q_D(QQuickLoader);
+    if (d->preload == url)
+        return;
+
+    d->cancelPreload();
+    d->preload = url;
+    if (isComponentComplete())
+        d->startPreload();
+    emit preloadChanged();
+}
+
+/*!
+    \qmlproperty int QtQuick::Loader::keepAlive
+    \since 5.3
+
+    This property holds the number of unloaded objects the Loader keeps
+    instead of destroying them.
+
+    When \l source changes, or the Loader becomes inactive, the loaded object
+    is detached and kept, hidden, for later use. Loading the same URL again
+    shows the kept object as it was left instead of creating a new one. Only
+    the \c keepAlive most recently unloaded objects are kept. Objects created
+    with initial property values passed to setSource() and objects created
+    from \l sourceComponent are never kept.
+
+    The default value is 0, meaning unloaded objects are always destroyed.
+
+    \sa source, preload
+*/
+int QQuickLoader::keepAlive() const
+{
+    Q_D(const QQuickLoader);
+    return d->keepAlive;
+}
+
+void QQuickLoader::setKeepAlive(int count)
+{
+    Q_D(QQuickLoader);
+    count = qMax(0, count);
+    if (d->keepAlive == count)
+        return;
+
+    d->keepAlive = count;
+    d->trimKeptObjects();
+    emit keepAliveChanged();
+}
+
 void QQuickLoaderPrivate::_q_updateSize(bool loaderGeometryChanged)
 {
     Q_Q(QQuickLoader);
@@ -59,6 +59,8 @@ class Q_AUTOTEST_EXPORT QQuickLoader : public QQuickImplicitSizeItem
     Q_PROPERTY(Status status READ status NOTIFY statusChanged)
     Q_PROPERTY(qreal progress READ progress NOTIFY progressChanged)
     Q_PROPERTY(bool asynchronous READ asynchronous WRITE setAsynchronous NOTIFY asynchronousChanged)
+    Q_PROPERTY(QUrl preload READ preload WRITE setPreload NOTIFY preloadChanged REVISION 1)
+    Q_PROPERTY(int keepAlive READ keepAlive WRITE setKeepAlive NOTIFY keepAliveChanged REVISION 1)
 
 public:
     QQuickLoader(QQuickItem *parent = 0);
@@ -83,6 +85,12 @@ public:
     bool asynchronous() const;
     void setAsynchronous(bool a);
 
+    QUrl preload() const;
+    void setPreload(const QUrl &);
+
+    int keepAlive() const;
+    void setKeepAlive(int);
+
     QObject *item() const;
 
 Q_SIGNALS:
@@ -94,6 +102,8 @@ Q_SIGNALS:
     void progressChanged();
     void loaded();
     void asynchronousChanged();
+    Q_REVISION(1) void preloadChanged();
+    Q_REVISION(1) void keepAliveChanged();
 
 protected:
     void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry);
@@ -106,6 +116,7 @@ private:
     Q_DISABLE_COPY(QQuickLoader)
     Q_DECLARE_PRIVATE(QQuickLoader)
     Q_PRIVATE_SLOT(d_func(), void _q_sourceLoaded())
+    Q_PRIVATE_SLOT(d_func(), void _q_preloadSourceLoaded())
     Q_PRIVATE_SLOT(d_func(), void _q_updateSize())
 };
 
@@ -57,6 +57,9 @@
 #include "qquickimplicitsizeitem_p_p.h"
 #include "qquickitemchangelistener_p.h"
 #include <qqmlincubator.h>
+#include <qqmlcomponent.h>
+
+#include <QtCore/qpointer.h>
 
 #include <private/qv4value_p.h>
 
@@ -77,6 +80,19 @@ private:
     QQuickLoaderPrivate *loader;
 };
 
+class QQuickLoaderPreloadIncubator : public QQmlIncubator
+{
+public:
+    QQuickLoaderPreloadIncubator(QQuickLoaderPrivate *l) : QQmlIncubator(Asynchronous), loader(l) {}
+
+protected:
+    virtual void statusChanged(Status);
+    virtual void setInitialState(QObject *);
+
+private:
+    QQuickLoaderPrivate *loader;
+};
+
 class QQmlContext;
 class QQuickLoaderPrivate : public QQuickImplicitSizeItemPrivate, public QQuickItemChangeListener
 {
@@ -93,6 +109,15 @@ public:
     void initResize();
     void load();
 
+    QQmlComponent *cachedComponent(const QUrl &url, QQmlComponent::CompilationMode mode);
+    void releaseObject(const QUrl &url);
+    bool restoreKeptObject();
+    void trimKeptObjects();
+    void startPreload();
+    void cancelPreload();
+    void preloadStateChanged(QQmlIncubator::Status status);
+    void setPreloadInitialState(QObject *o);
+
     void incubatorStateChanged(QQmlIncubator::Status status);
     void setInitialState(QObject *o);
     void disposeInitialPropertyValues();
@@ -105,18 +130,39 @@ public:
     QUrl source;
     QQuickItem *item;
     QObject *object;
-    QQmlComponent *component;
+    QPointer<QQmlComponent> component;
     QV4::PersistentValue componentStrongReference; // To ensure GC doesn't delete components created by Qt.createComponent
     QQmlContext *itemContext;
     QQuickLoaderIncubator *incubator;
     QV4::PersistentValue initialPropertyValues;
     QV4::PersistentValue qmlGlobalForIpv;
+
+    // Objects that were unloaded, or prepared ahead of time, and can be
+    // shown again without being recreated.
+    struct KeptObject {
+        KeptObject() : visible(true) {}
+        KeptObject(const QUrl &u, QObject *o, bool v) : url(u), object(o), visible(v) {}
+        QUrl url;
+        QPointer<QObject> object;
+        bool visible;
+    };
+    QList<KeptObject> keptObjects; // most recently unloaded first
+    KeptObject prepared;
+    int keepAlive;
+
+    QUrl preload;
+    QPointer<QQmlComponent> preloadComponent;
+    QQmlContext *preloadContext;
+    QQuickLoaderPreloadIncubator *preloadIncubator;
+
     bool updatingSize: 1;
     bool active : 1;
     bool loadingFromSource : 1;
     bool asynchronous : 1;
+    bool objectHasInitialProperties : 1;
 
     void _q_sourceLoaded();
+    void _q_preloadSourceLoaded();
     void _q_updateSize(bool loaderGeometryChanged = true);
 };
 
@@ -192,8 +192,7 @@ void QQuickPathView::initItem(int index, QObject *object)
             att->m_view = this;
             qreal percent = d->positionOfIndex(index);
             if (percent < 1.0 && d->path) {
-                foreach (const QString &attr, d->path->attributes())
-                    att->setValue(attr.toUtf8(), d->path->attributeAt(attr, percent));
+                d->setAttributes(att, percent);
                 item->setZ(d->requestedZ);
             }
             att->setOnPath(percent < 1.0);
@@ -426,6 +425,14 @@ void QQuickPathView::pathUpdated()
 }
 
 void QQuickPathViewPrivate::updateItem(QQuickItem *item, qreal percent)
+{
+    if (!path)
+        return;
+    updateItem(item, percent, path->pointAt(qMin(percent, qreal(1.0))));
+}
+
+// point is the point on the path at percent, e.g. from a QQuickPath::pointsAt() batch.
+void QQuickPathViewPrivate::updateItem(QQuickItem *item, qreal percent, const QPointF &point)
 {
     if (!path)
         return;
@@ -433,14 +440,25 @@ void QQuickPathViewPrivate::updateItem(QQuickItem *item, qreal percent)
         if (qFuzzyCompare(att->m_percent, percent))
             return;
         att->m_percent = percent;
-        foreach (const QString &attr, path->attributes())
-            att->setValue(attr.toUtf8(), path->attributeAt(attr, percent));
+        setAttributes(att, percent);
         att->setOnPath(percent < 1.0);
     }
     QQuickItemPrivate::get(item)->setCulled(percent >= 1.0);
-    QPointF pf = path->pointAt(qMin(percent, qreal(1.0)));
-    item->setX(pf.x() - item->width()/2);
-    item->setY(pf.y() - item->height()/2);
+    item->setPosition(QPointF(point.x() - item->width()/2, point.y() - item->height()/2));
+}
+
+void QQuickPathViewPrivate::setAttributes(QQuickPathViewAttached *att, qreal percent)
+{
+    const QStringList attributes = path->attributes();
+    if (attributes.isEmpty())
+        return;
+
+    QVarLengthArray<qreal, 8> values(attributes.count());
+    for (int i = 0; i < values.count(); ++i)
+        values[i] = 0;
+    path->attributesAt(percent, values.data());
+    for (int i = 0; i < attributes.count(); ++i)
+        att->setValue(attributes.at(i).toUtf8(), values.at(i));
 }
 
 void QQuickPathViewPrivate::regenerate()
@@ -1867,21 +1885,33 @@ void QQuickPathView::refill()
     bool currentVisible = false;
     int count = d->pathItems == -1 ? d->modelCount : qMin(d->pathItems, d->modelCount);
 
+    // Locate all existing items on the path together
+    QVarLengthArray<qreal, 64> positions(d->items.count());
+    QVarLengthArray<QPointF, 64> points(d->items.count());
+    for (int i = 0, idx = d->firstIndex; i < positions.count(); ++i) {
+        positions[i] = qMin(d->positionOfIndex(idx), qreal(1.0));
+        if (++idx >= d->modelCount)
+            idx = 0;
+    }
+    d->path->pointsAt(positions.constData(), points.data(), points.count());
+
     // first move existing items and remove items off path
     int idx = d->firstIndex;
+    int itemIndex = 0;
     QList<QQuickItem*>::iterator it = d->items.begin();
     while (it != d->items.end()) {
         qreal pos = d->positionOfIndex(idx);
         QQuickItem *item = *it;
+        const QPointF point = points.at(itemIndex++);
         if (pos < 1.0) {
-            d->updateItem(item, pos);
+            d->updateItem(item, pos, point);
             if (idx == d->currentIndex) {
                 currentVisible = true;
                 d->currentItemOffset = pos;
             }
             ++it;
         } else {
-            d->updateItem(item, pos);
+            d->updateItem(item, pos, point);
             if (QQuickPathViewAttached *att = d->attached(item))
                 att->setOnPath(pos < 1.0);
             if (!d->isInBound(pos, d->mappedRange - d->mappedCache, 1.0 + d->mappedCache)) {
@@ -122,6 +122,8 @@ public:
     void setAdjustedOffset(qreal offset);
     void regenerate();
     void updateItem(QQuickItem *, qreal);
+    void updateItem(QQuickItem *, qreal, const QPointF &);
+    void setAttributes(QQuickPathViewAttached *att, qreal percent);
     void snapToIndex(int index);
     QPointF pointNear(const QPointF &point, qreal *nearPercent=0) const;
     void addVelocitySample(qreal v);
@@ -301,7 +301,11 @@ void QQuickBasePositioner::prePositioning()
     for (int ii = 0; ii < unpositionedItems.count(); ii++)
         oldItems.append(unpositionedItems[ii]);
     unpositionedItems.clear();
+    positionedItems.reserve(children.count());
     int addedIndex = -1;
+    // The children are usually still in the order of the previous pass, so look where the last
+    // one was found first, to avoid scanning all old items for every child.
+    int nextOldIndex = 0;
 
     for (int ii = 0; ii < children.count(); ++ii) {
         QQuickItem *child = children.at(ii);
@@ -309,7 +313,10 @@ void QQuickBasePositioner::prePositioning()
             continue;
         QQuickItemPrivate *childPrivate = QQuickItemPrivate::get(child);
         PositionedItem posItem(child);
-        int wIdx = oldItems.find(posItem);
+        int wIdx = nextOldIndex < oldItems.count() && oldItems.at(nextOldIndex) == posItem
+                ? nextOldIndex : oldItems.find(posItem);
+        if (wIdx >= 0)
+            nextOldIndex = wIdx + 1;
         if (wIdx < 0) {
             d->watchChanges(child);
             posItem.isNew = true;
@@ -0,0 +1,389 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qquickrendercontrol.h"
+#include "qquickrendercontrol_p.h"
+
+#include "qquickwindow.h"
+#include "qquickwindow_p.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtGui/QOpenGLContext>
+#include <QtGui/QOpenGLFunctions>
+
+#include <private/qsgcontext_p.h>
+
+QT_BEGIN_NAMESPACE
+
+extern Q_GUI_EXPORT QImage qt_gl_read_framebuffer(const QSize &size, bool alpha_format, bool include_alpha);
+
+/*!
+    \class QQuickRenderControl
+    \inmodule QtQuick
+    \since 5.3
+
+    \brief The QQuickRenderControl class provides a mechanism for rendering
+    Qt Quick scenes into an offscreen target without a render loop.
+
+    A QQuickWindow constructed with a render control is never shown and is
+    not driven by the scene graph render loop. Instead the application
+    drives each frame by calling polishItems(), sync() and render(), with an
+    OpenGL context of its own choosing current. The scene is rendered into
+    the window's \l{QQuickWindow::setRenderTarget()}{render target}, usually
+    a QOpenGLFramebufferObject provided by the application.
+
+    All windows constructed with the same render control share one OpenGL
+    context and one scene graph context, so the glyph caches, shaders and
+    textures created for one scene are reused by the next. This makes it
+    possible to render large numbers of scenes, for instance thumbnails or
+    reports on a server, without the cost of a context per window.
+
+    The pixels can be read back with grab(). When several scenes are
+    rendered in sequence, beginGrab() and endGrab() allow the readback of
+    one scene to overlap with the rendering of the next:
+
+    \code
+    control.render(first);
+    control.beginGrab(first);
+    control.render(second);
+    QImage image = control.endGrab(first);
+    \endcode
+
+    The render control must outlive the windows constructed with it, and
+    the OpenGL context passed to initialize() must be current whenever the
+    control or its windows are used for rendering.
+
+    \sa QQuickWindow::QQuickWindow(QQuickRenderControl *)
+ */
+
+/*!
+    \fn void QQuickRenderControl::renderRequested(QQuickWindow *window)
+
+    This signal is emitted when \a window needs to be rendered again without
+    changes to the scene, for instance after QQuickWindow::update(). The
+    signal is emitted at most once until the next call to render().
+ */
+
+/*!
+    \fn void QQuickRenderControl::sceneChanged(QQuickWindow *window)
+
+    This signal is emitted when the scene in \a window has changed and
+    needs to be polished, synchronized and rendered again. The signal is
+    emitted at most once until the next call to sync().
+ */
+
+QQuickRenderControlPrivate::QQuickRenderControlPrivate()
+    : sg(QSGContext::createDefaultContext())
+    , rc(0)
+    , gl(0)
+    , surface(0)
+{
+    rc = sg->createRenderContext();
+}
+
+/*
+    Cleaning up after a window or invalidating the scene graph releases GL
+    resources, which needs the context the scene graph was initialized with.
+ */
+bool QQuickRenderControlPrivate::makeCurrent()
+{
+    if (!gl)
+        return false;
+    if (QOpenGLContext::currentContext() == gl)
+        return true;
+    return gl->makeCurrent(surface);
+}
+
+void QQuickRenderControlPrivate::releaseReadback(Readback *readback)
+{
+    if (readback->buffer) {
+        gl->functions()->glDeleteBuffers(1, &readback->buffer);
+        readbackFunctions.deleteSync(readback->fence);
+    }
+    *readback = Readback();
+}
+
+void QQuickRenderControlPrivate::update(QQuickWindow *window)
+{
+    Q_Q(QQuickRenderControl);
+    if (pendingRenders.contains(window))
+        return;
+    pendingRenders.insert(window);
+    emit q->renderRequested(window);
+}
+
+void QQuickRenderControlPrivate::maybeUpdate(QQuickWindow *window)
+{
+    Q_Q(QQuickRenderControl);
+    if (pendingSyncs.contains(window))
+        return;
+    pendingSyncs.insert(window);
+    emit q->sceneChanged(window);
+}
+
+void QQuickRenderControlPrivate::windowDestroyed(QQuickWindow *window)
+{
+    pendingRenders.remove(window);
+    pendingSyncs.remove(window);
+
+    if (!makeCurrent()) {
+        readbacks.remove(window);
+        return;
+    }
+
+    QHash<QQuickWindow *, Readback>::iterator it = readbacks.find(window);
+    if (it != readbacks.end()) {
+        releaseReadback(&it.value());
+        readbacks.erase(it);
+    }
+    QQuickWindowPrivate::get(window)->cleanupNodesOnShutdown();
+}
+
+/*!
+    Constructs a render control with the given \a parent.
+ */
+QQuickRenderControl::QQuickRenderControl(QObject *parent)
+    : QObject(*(new QQuickRenderControlPrivate), parent)
+{
+}
+
+/*!
+    Destroys the render control, invalidating the scene graph if it is
+    still initialized.
+ */
+QQuickRenderControl::~QQuickRenderControl()
+{
+    Q_D(QQuickRenderControl);
+    invalidate();
+    delete d->rc;
+    delete d->sg;
+}
+
+/*!
+    Initializes the scene graph with the OpenGL context \a context, which
+    must be current. The context is used by all windows constructed with
+    this render control until invalidate() is called.
+ */
+void QQuickRenderControl::initialize(QOpenGLContext *context)
+{
+    Q_D(QQuickRenderControl);
+    if (d->gl) {
+        qWarning("QQuickRenderControl::initialize: scene graph already initialized");
+        return;
+    }
+    if (!context || QOpenGLContext::currentContext() != context) {
+        qWarning("QQuickRenderControl::initialize: context must be current");
+        return;
+    }
+
+    d->gl = context;
+    d->surface = context->surface();
+    d->readbackFunctions = QQuickGLReadbackFunctions();
+    d->rc->initialize(context);
+}
+
+/*!
+    Releases the scene graph nodes and the OpenGL resources of all windows
+    constructed with this render control. The sceneGraphInvalidated()
+    signal of each window is emitted with the context current.
+
+    The render control can be initialized again afterwards.
+ */
+void QQuickRenderControl::invalidate()
+{
+    Q_D(QQuickRenderControl);
+    if (!d->gl)
+        return;
+
+    d->makeCurrent();
+    for (QHash<QQuickWindow *, QQuickRenderControlPrivate::Readback>::iterator it = d->readbacks.begin();
+         it != d->readbacks.end(); ++it) {
+        d->releaseReadback(&it.value());
+    }
+    d->readbacks.clear();
+
+    d->rc->invalidate();
+    QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+    d->gl = 0;
+    d->surface = 0;
+}
+
+/*!
+    Returns the OpenGL context the render control was initialized with, or
+    0 if it is not initialized.
+ */
+QOpenGLContext *QQuickRenderControl::openglContext() const
+{
+    Q_D(const QQuickRenderControl);
+    return d->gl;
+}
+
+/*!
+    Polishes the items in \a window. This is the first step of a frame and
+    runs the updatePolish() of all items which requested it.
+ */
+void QQuickRenderControl::polishItems(QQuickWindow *window)
+{
+    QQuickWindowPrivate::get(window)->polishItems();
+}
+
+/*!
+    Synchronizes the QML scene of \a window with the scene graph. The
+    render control must be initialized.
+ */
+void QQuickRenderControl::sync(QQuickWindow *window)
+{
+    Q_D(QQuickRenderControl);
+    if (!d->gl) {
+        qWarning("QQuickRenderControl::sync: scene graph not initialized");
+        return;
+    }
+    d->pendingSyncs.remove(window);
+    QQuickWindowPrivate::get(window)->syncSceneGraph();
+}
+
+/*!
+    Renders the scene graph of \a window into its render target, or into
+    the default framebuffer of the current surface if it has none. The
+    scene must have been synchronized with sync() first.
+ */
+void QQuickRenderControl::render(QQuickWindow *window)
+{
+    Q_D(QQuickRenderControl);
+    if (!d->gl) {
+        qWarning("QQuickRenderControl::render: scene graph not initialized");
+        return;
+    }
+    d->pendingRenders.remove(window);
+    QQuickWindowPrivate::get(window)->renderSceneGraph(window->size());
+}
+
+/*!
+    Starts reading back the pixels last rendered into the render target of
+    \a window. Where the OpenGL implementation supports pixel buffer objects
+    and sync objects, the read is queued behind the rendering and this
+    function returns without waiting for it, so that the next scene can be
+    rendered while the pixels are transferred. Otherwise the pixels are
+    read immediately.
+
+    Call endGrab() to retrieve the image.
+ */
+void QQuickRenderControl::beginGrab(QQuickWindow *window)
+{
+    Q_D(QQuickRenderControl);
+    if (!d->gl) {
+        qWarning("QQuickRenderControl::beginGrab: scene graph not initialized");
+        return;
+    }
+
+    QQuickWindowPrivate *cd = QQuickWindowPrivate::get(window);
+    QQuickRenderControlPrivate::Readback &r = d->readbacks[window];
+    d->releaseReadback(&r);
+    r.size = cd->renderTargetId ? cd->renderTargetSize : window->size() * window->devicePixelRatio();
+
+    QOpenGLFunctions *gl = d->gl->functions();
+    GLint previousFbo = 0;
+    gl->glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFbo);
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, cd->renderTargetId);
+
+    if (d->readbackFunctions.isValid()) {
+        gl->glGenBuffers(1, &r.buffer);
+        gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, r.buffer);
+        gl->glBufferData(GL_PIXEL_PACK_BUFFER, r.size.width() * r.size.height() * 4, 0, GL_STREAM_READ);
+        gl->glReadPixels(0, 0, r.size.width(), r.size.height(), GL_RGBA, GL_UNSIGNED_BYTE, 0);
+        gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        r.fence = d->readbackFunctions.fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    } else {
+        r.image = qt_gl_read_framebuffer(r.size, true, true);
+    }
+
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, previousFbo);
+}
+
+/*!
+    Returns the pixels of the readback started with beginGrab() for
+    \a window, waiting for the transfer to complete if necessary. Returns a
+    null image if no readback was started.
+ */
+QImage QQuickRenderControl::endGrab(QQuickWindow *window)
+{
+    Q_D(QQuickRenderControl);
+    QHash<QQuickWindow *, QQuickRenderControlPrivate::Readback>::iterator it = d->readbacks.find(window);
+    if (it == d->readbacks.end())
+        return QImage();
+
+    QQuickRenderControlPrivate::Readback r = it.value();
+    d->readbacks.erase(it);
+    if (!r.buffer)
+        return r.image;
+
+    d->readbackFunctions.clientWaitSync(r.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+
+    QOpenGLFunctions *gl = d->gl->functions();
+    QImage pixels(r.size, QImage::Format_RGBA8888_Premultiplied);
+    gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, r.buffer);
+    const int byteCount = r.size.width() * r.size.height() * 4;
+    if (const void *data = d->readbackFunctions.mapBufferRange(GL_PIXEL_PACK_BUFFER, 0, byteCount, GL_MAP_READ_BIT)) {
+        memcpy(pixels.bits(), data, byteCount);
+        d->readbackFunctions.unmapBuffer(GL_PIXEL_PACK_BUFFER);
+    } else {
+        pixels = QImage();
+    }
+    gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    d->releaseReadback(&r);
+
+    // Same result as qt_gl_read_framebuffer() with an alpha channel.
+    return pixels.convertToFormat(QImage::Format_ARGB32_Premultiplied).mirrored();
+}
+
+/*!
+    Reads back the pixels last rendered into the render target of
+    \a window and returns them, blocking until the read has completed.
+
+    \sa beginGrab(), endGrab()
+ */
+QImage QQuickRenderControl::grab(QQuickWindow *window)
+{
+    beginGrab(window);
+    return endGrab(window);
+}
+
+QT_END_NAMESPACE
@@ -49,10 +49,12 @@
 
 #include <QtQml/QQmlInfo>
 
+#include <QtCore/qset.h>
+
 QT_BEGIN_NAMESPACE
 
 QQuickRepeaterPrivate::QQuickRepeaterPrivate()
-    : model(0), ownModel(false), inRequest(false), dataSourceIsObject(false), delegateValidated(false), itemCount(0), createFrom(-1)
+    : model(0), ownModel(false), inRequest(false), dataSourceIsObject(false), delegateValidated(false), asynchronous(false), itemCount(0), createFrom(-1)
 {
 }
 
@@ -311,6 +313,37 @@ int QQuickRepeater::count() const
     return 0;
 }
 
+/*!
+    \qmlproperty bool QtQuick::Repeater::asynchronous
+    \since 5.3
+
+    This property holds whether the delegates are created asynchronously.
+
+    When \c true, the Repeater incubates its items one after the other
+    across multiple frames instead of creating all of them at once, so that
+    populating a large model does not block the user interface. The
+    \l count reflects the model immediately; items are added to the parent
+    as they become ready, and \l itemAt() returns \c null for items that
+    have not been created yet.
+
+    The default value is \c false.
+*/
+bool QQuickRepeater::asynchronous() const
+{
+    Q_D(const QQuickRepeater);
+    return d->asynchronous;
+}
+
+void QQuickRepeater::setAsynchronous(bool a)
+{
+    Q_D(QQuickRepeater);
+    if (d->asynchronous == a)
+        return;
+
+    d->asynchronous = a;
+    emit asynchronousChanged();
+}
+
 /*!
     \qmlmethod Item QtQuick::Repeater::itemAt(index)
 
@@ -380,15 +413,87 @@ void QQuickRepeater::regenerate()
     d->createItems();
 }
 
+/*
+    Places the runs of newly created items in the parent's stacking order:
+    each run goes directly after the item preceding it in the repeater, or
+    before the item following it (or the repeater itself) if it starts the
+    list. Doing this once per batch rather than with stackBefore() and
+    stackAfter() for every item keeps populating a large model linear, and
+    notifies the siblings of the new order only once.
+*/
+void QQuickRepeaterPrivate::stackCreatedItems(const QVector<CreatedRun> &runs)
+{
+    Q_Q(QQuickRepeater);
+    QQuickItem *parent = q->parentItem();
+    if (runs.isEmpty() || !parent)
+        return;
+
+    QQuickItemPrivate *parentPrivate = QQuickItemPrivate::get(parent);
+
+    QSet<QQuickItem *> created;
+    QHash<QQuickItem *, int> runsAfter;
+    QHash<QQuickItem *, int> runsBefore;
+    for (int ii = 0; ii < runs.count(); ++ii) {
+        const CreatedRun &run = runs.at(ii);
+        for (int jj = 0; jj < run.items.count(); ++jj)
+            created.insert(run.items.at(jj));
+        if (run.after)
+            runsAfter.insert(run.after, ii);
+        else
+            runsBefore.insert(run.before, ii);
+    }
+
+    QList<QQuickItem *> children;
+    children.reserve(parentPrivate->childItems.count());
+    QVector<bool> placed(runs.count(), false);
+    for (int ii = 0; ii < parentPrivate->childItems.count(); ++ii) {
+        QQuickItem *child = parentPrivate->childItems.at(ii);
+        if (created.contains(child))
+            continue;
+        QHash<QQuickItem *, int>::ConstIterator it = runsBefore.constFind(child);
+        if (it != runsBefore.constEnd()) {
+            children += runs.at(*it).items;
+            placed[*it] = true;
+        }
+        children.append(child);
+        it = runsAfter.constFind(child);
+        if (it != runsAfter.constEnd()) {
+            children += runs.at(*it).items;
+            placed[*it] = true;
+        }
+    }
+    for (int ii = 0; ii < runs.count(); ++ii) {
+        if (!placed.at(ii))
+            children += runs.at(ii).items;
+    }
+
+    int firstChanged = 0;
+    const int count = qMin(children.count(), parentPrivate->childItems.count());
+    while (firstChanged < count && children.at(firstChanged) == parentPrivate->childItems.at(firstChanged))
+        ++firstChanged;
+    if (firstChanged == children.count() && children.count() == parentPrivate->childItems.count())
+        return;
+
+    parentPrivate->childItems = children;
+    parentPrivate->dirty(QQuickItemPrivate::ChildrenStackingChanged);
+    foreach (QQuickItem *item, created)
+        parentPrivate->markSortedChildrenDirty(item);
+    parentPrivate->accessibleChildrenChanged();
+
+    for (int ii = firstChanged; ii < parentPrivate->childItems.count(); ++ii)
+        QQuickItemPrivate::get(parentPrivate->childItems.at(ii))->siblingOrderChanged();
+}
+
 void QQuickRepeaterPrivate::createItems()
 {
     Q_Q(QQuickRepeater);
     if (createFrom == -1)
         return;
     inRequest = true;
+    QVector<CreatedRun> runs;
     for (int ii = createFrom; ii < itemCount; ++ii) {
         if (!deletables.at(ii)) {
-            QObject *object = model->object(ii, false);
+            QObject *object = model->object(ii, asynchronous);
             QQuickItem *item = qmlobject_cast<QQuickItem*>(object);
             if (!item) {
                 if (object) {
@@ -402,23 +507,33 @@ void QQuickRepeaterPrivate::createItems()
                 createFrom = ii;
                 break;
             }
-            deletables[ii] = item;
             item->setParentItem(q->parentItem());
-            if (ii > 0 && deletables.at(ii-1)) {
-                item->stackAfter(deletables.at(ii-1));
-            } else {
-                QQuickItem *after = q;
-                for (int si = ii+1; si < itemCount; ++si) {
-                    if (deletables.at(si)) {
-                        after = deletables.at(si);
-                        break;
+            if (runs.isEmpty() || runs.last().end != ii) {
+                CreatedRun run;
+                if (ii > 0 && deletables.at(ii-1)) {
+                    run.after = deletables.at(ii-1);
+                } else {
+                    run.before = q;
+                    for (int si = ii+1; si < itemCount; ++si) {
+                        if (deletables.at(si)) {
+                            run.before = deletables.at(si);
+                            break;
+                        }
                     }
                 }
-                item->stackBefore(after);
+                runs.append(run);
             }
-            emit q->itemAdded(ii, item);
+            runs.last().items.append(item);
+            runs.last().end = ii + 1;
+            deletables[ii] = item;
         }
     }
+    stackCreatedItems(runs);
+    for (int ii = 0; ii < runs.count(); ++ii) {
+        const CreatedRun &run = runs.at(ii);
+        for (int jj = 0; jj < run.items.count(); ++jj)
+            emit q->itemAdded(run.end - run.items.count() + jj, run.items.at(jj));
+    }
     inRequest = false;
 }
 
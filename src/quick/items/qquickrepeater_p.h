@@ -56,6 +56,7 @@ class Q_AUTOTEST_EXPORT QQuickRepeater : public QQuickItem
     Q_PROPERTY(QVariant model READ model WRITE setModel NOTIFY modelChanged)
     Q_PROPERTY(QQmlComponent *delegate READ delegate WRITE setDelegate NOTIFY delegateChanged)
     Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(bool asynchronous READ asynchronous WRITE setAsynchronous NOTIFY asynchronousChanged REVISION 1)
     Q_CLASSINFO("DefaultProperty", "delegate")
 
 public:
@@ -70,12 +71,16 @@ public:
 
     int count() const;
 
+    bool asynchronous() const;
+    void setAsynchronous(bool);
+
     Q_INVOKABLE QQuickItem *itemAt(int index) const;
 
 Q_SIGNALS:
     void modelChanged();
     void delegateChanged();
     void countChanged();
+    Q_REVISION(1) void asynchronousChanged();
 
     void itemAdded(int index, QQuickItem *item);
     void itemRemoved(int index, QQuickItem *item);
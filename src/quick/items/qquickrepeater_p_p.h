@@ -71,7 +71,16 @@ public:
     ~QQuickRepeaterPrivate();
 
 private:
+    struct CreatedRun {
+        CreatedRun() : after(0), before(0), end(0) {}
+        QQuickItem *after;
+        QQuickItem *before;
+        int end;
+        QList<QQuickItem *> items;
+    };
+
     void createItems();
+    void stackCreatedItems(const QVector<CreatedRun> &runs);
 
     QPointer<QQmlInstanceModel> model;
     QVariant dataSource;
@@ -80,6 +89,7 @@ private:
     bool inRequest : 1;
     bool dataSourceIsObject : 1;
     bool delegateValidated : 1;
+    bool asynchronous : 1;
     int itemCount;
     int createFrom;
 
@@ -47,6 +47,7 @@
 #include "qquickitem_p.h"
 
 #include <QtQuick/private/qsgcontext_p.h>
+#include <QtQuick/private/qsggeometry_p.h>
 #include <QtQuick/qsgtextureprovider.h>
 #include "qquickwindow.h"
 
@@ -936,17 +937,19 @@ QSGNode *QQuickShaderEffect::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeDa
 
     if (m_dirtyMesh) {
         node->setGeometry(0);
+        node->setMeshGeometry(0);
         m_dirtyMesh = false;
         m_dirtyGeometry = true;
     }
 
     if (m_dirtyGeometry) {
-        node->setFlag(QSGNode::OwnsGeometry, false);
-        QSGGeometry *geometry = node->geometry();
         QRectF rect(0, 0, width(), height());
         QQuickShaderEffectMesh *mesh = m_mesh ? m_mesh : &m_defaultMesh;
 
-        geometry = mesh->updateGeometry(geometry, m_common.attributes, rect);
+        // The mesh is updated in place in the node's own copy, which effects
+        // of the same size and mesh then share, see QSGSharedGeometry.
+        QSGGeometry *geometry = mesh->updateGeometry(node->meshGeometry(), m_common.attributes, rect);
+        node->setMeshGeometry(geometry);
         if (!geometry) {
             QString log = mesh->log();
             if (!log.isNull()) {
@@ -961,7 +964,7 @@ QSGNode *QQuickShaderEffect::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeDa
             return 0;
         }
 
-        node->setGeometry(geometry);
+        node->setGeometry(QSGSharedGeometry::share(geometry));
         node->setFlag(QSGNode::OwnsGeometry, true);
 
         m_dirtyGeometry = false;
@@ -69,6 +69,23 @@ QQuickGridMesh::QQuickGridMesh(QObject *parent)
 {
 }
 
+void QQuickGridMesh::updatePositions(QSGGeometry *geometry, int attrCount, int positionIndex, const QRectF &dstRect)
+{
+    int vmesh = m_resolution.height();
+    int hmesh = m_resolution.width();
+
+    QSGGeometry::Point2D *vdata = static_cast<QSGGeometry::Point2D *>(geometry->vertexData()) + positionIndex;
+    for (int iy = 0; iy <= vmesh; ++iy) {
+        float y = float(dstRect.top()) + iy / float(vmesh) * float(dstRect.height());
+        for (int ix = 0; ix <= hmesh; ++ix) {
+            vdata->x = float(dstRect.left()) + ix / float(hmesh) * float(dstRect.width());
+            vdata->y = y;
+            vdata += attrCount;
+        }
+    }
+    geometry->markVertexDataDirty();
+}
+
 QSGGeometry *QQuickGridMesh::updateGeometry(QSGGeometry *geometry, const QVector<QByteArray> &attributes, const QRectF &dstRect)
 {
     int vmesh = m_resolution.height();
@@ -118,6 +135,12 @@ QSGGeometry *QQuickGridMesh::updateGeometry(QSGGeometry *geometry, const QVector
                                    (vmesh + 1) * (hmesh + 1), vmesh * 2 * (hmesh + 2),
                                    GL_UNSIGNED_SHORT);
 
+    } else if (geometry->vertexCount() == (vmesh + 1) * (hmesh + 1)
+               && geometry->indexCount() == vmesh * 2 * (hmesh + 2)) {
+        // Same resolution, so only the positions depend on the new size.
+        if (positionIndex >= 0)
+            updatePositions(geometry, attrCount, positionIndex, dstRect);
+        return geometry;
     } else {
         geometry->allocate((vmesh + 1) * (hmesh + 1), vmesh * 2 * (hmesh + 2));
     }
@@ -41,7 +41,7 @@
 
 #include "qqmlparserstatus.h"
 
-#include <QtQuick/qtquickglobal.h>
+#include <private/qtquickglobal_p.h>
 #include <QtGui/qcolor.h>
 #include <QtCore/qobject.h>
 #include <QtCore/qsize.h>
@@ -56,7 +56,7 @@ QT_BEGIN_NAMESPACE
 class QSGGeometry;
 class QRectF;
 
-class QQuickShaderEffectMesh : public QObject
+class Q_QUICK_PRIVATE_EXPORT QQuickShaderEffectMesh : public QObject
 {
     Q_OBJECT
 public:
@@ -71,7 +71,7 @@ Q_SIGNALS:
     void geometryChanged();
 };
 
-class QQuickGridMesh : public QQuickShaderEffectMesh
+class Q_QUICK_PRIVATE_EXPORT QQuickGridMesh : public QQuickShaderEffectMesh
 {
     Q_OBJECT
     Q_PROPERTY(QSize resolution READ resolution WRITE setResolution NOTIFY resolutionChanged)
@@ -87,6 +87,8 @@ Q_SIGNALS:
     void resolutionChanged();
 
 private:
+    void updatePositions(QSGGeometry *geometry, int attrCount, int positionIndex, const QRectF &dstRect);
+
     QSize m_resolution;
     QString m_log;
 };
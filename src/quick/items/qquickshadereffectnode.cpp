@@ -248,6 +248,12 @@ void QQuickCustomMaterialShader::compile()
     Q_ASSERT_X(!program()->isLinked(), "QQuickCustomMaterialShader::compile()", "Compile called multiple times!");
 
     m_log.clear();
+    const QByteArray binaryKey = QSGShaderSourceBuilder::programBinaryKey(vertexShader(), fragmentShader(), attributeNames());
+    if (QSGShaderSourceBuilder::loadProgramBinary(program(), binaryKey)) {
+        m_compiled = true;
+        return;
+    }
+
     m_compiled = true;
     if (!program()->addShaderFromSourceCode(QOpenGLShader::Vertex, vertexShader())) {
         m_log += QLatin1String("*** Vertex shader ***\n");
@@ -287,6 +293,8 @@ void QQuickCustomMaterialShader::compile()
         }
         m_compiled = program()->link();
         m_log += program()->log();
+        if (m_compiled)
+            QSGShaderSourceBuilder::saveProgramBinary(program(), binaryKey);
     }
 
     if (!m_compiled) {
@@ -398,6 +406,7 @@ void QQuickShaderEffectMaterial::invalidateTextureProvider(QSGTextureProvider *p
 
 
 QQuickShaderEffectNode::QQuickShaderEffectNode()
+    : m_meshGeometry(0)
 {
     QSGNode::setFlag(UsePreprocess, true);
 
@@ -408,6 +417,14 @@ QQuickShaderEffectNode::QQuickShaderEffectNode()
 
 QQuickShaderEffectNode::~QQuickShaderEffectNode()
 {
+    delete m_meshGeometry;
+}
+
+void QQuickShaderEffectNode::setMeshGeometry(QSGGeometry *geometry)
+{
+    if (geometry != m_meshGeometry)
+        delete m_meshGeometry;
+    m_meshGeometry = geometry;
 }
 
 void QQuickShaderEffectNode::markDirtyTexture()
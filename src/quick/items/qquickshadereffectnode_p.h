@@ -135,12 +135,19 @@ public:
 
     virtual void preprocess();
 
+    // The mesh is built into this geometry, which the node then shares.
+    QSGGeometry *meshGeometry() const { return m_meshGeometry; }
+    void setMeshGeometry(QSGGeometry *geometry);
+
 Q_SIGNALS:
     void logAndStatusChanged(const QString &, int status);
 
 private Q_SLOTS:
     void markDirtyTexture();
     void textureProviderDestroyed(QObject *object);
+
+private:
+    QSGGeometry *m_meshGeometry;
 };
 
 QT_END_NAMESPACE
@@ -45,6 +45,7 @@
 #include "qquickwindow_p.h"
 #include <private/qsgadaptationlayer_p.h>
 #include <QtQuick/private/qsgrenderer_p.h>
+#include <QtQuick/private/qsgdamagetracker_p.h>
 #include <qsgsimplerectnode.h>
 
 #include "qopenglframebufferobject.h"
@@ -154,6 +155,8 @@ QQuickShaderEffectTexture::QQuickShaderEffectTexture(QQuickItem *shaderSource)
     , m_multisamplingChecked(false)
     , m_multisampling(false)
     , m_grab(false)
+    , m_partialUpdates(true)
+    , m_fullUpdate(true)
 {
 }
 
@@ -177,6 +180,8 @@ void QQuickShaderEffectTexture::invalidated()
         glDeleteTextures(1, &m_transparentTexture);
         m_transparentTexture = 0;
     }
+    m_damageTracker.reset();
+    m_fullUpdate = true;
 }
 
 int QQuickShaderEffectTexture::textureId() const
@@ -234,7 +239,7 @@ void QQuickShaderEffectTexture::setHasMipmaps(bool mipmap)
         return;
     m_mipmap = mipmap;
     if (m_mipmap && m_fbo && !m_fbo->format().mipmap())
-        markDirtyTexture();
+        markFullUpdate();
 }
 
 
@@ -251,7 +256,7 @@ void QQuickShaderEffectTexture::setItem(QSGNode *item)
         m_depthStencilBuffer.clear();
     }
 
-    markDirtyTexture();
+    markFullUpdate();
 }
 
 void QQuickShaderEffectTexture::setRect(const QRectF &rect)
@@ -259,7 +264,7 @@ void QQuickShaderEffectTexture::setRect(const QRectF &rect)
     if (rect == m_rect)
         return;
     m_rect = rect;
-    markDirtyTexture();
+    markFullUpdate();
 }
 
 void QQuickShaderEffectTexture::setSize(const QSize &size)
@@ -275,7 +280,7 @@ void QQuickShaderEffectTexture::setSize(const QSize &size)
         m_depthStencilBuffer.clear();
     }
 
-    markDirtyTexture();
+    markFullUpdate();
 }
 
 void QQuickShaderEffectTexture::setFormat(GLenum format)
@@ -283,7 +288,7 @@ void QQuickShaderEffectTexture::setFormat(GLenum format)
     if (format == m_format)
         return;
     m_format = format;
-    markDirtyTexture();
+    markFullUpdate();
 }
 
 void QQuickShaderEffectTexture::setLive(bool live)
@@ -299,7 +304,7 @@ void QQuickShaderEffectTexture::setLive(bool live)
         m_depthStencilBuffer.clear();
     }
 
-    markDirtyTexture();
+    markFullUpdate();
 }
 
 void QQuickShaderEffectTexture::scheduleUpdate()
@@ -313,9 +318,22 @@ void QQuickShaderEffectTexture::scheduleUpdate()
 
 void QQuickShaderEffectTexture::setRecursive(bool recursive)
 {
+    if (recursive != m_recursive)
+        m_fullUpdate = true;
     m_recursive = recursive;
 }
 
+void QQuickShaderEffectTexture::setPartialUpdates(bool partial)
+{
+    if (partial == m_partialUpdates)
+        return;
+    m_partialUpdates = partial;
+    if (m_renderer)
+        m_renderer->setTrackChangedNodes(m_partialUpdates);
+    m_damageTracker.reset();
+    markFullUpdate();
+}
+
 void QQuickShaderEffectTexture::markDirtyTexture()
 {
     m_dirtyTexture = true;
@@ -323,6 +341,40 @@ void QQuickShaderEffectTexture::markDirtyTexture()
         emit updateRequested();
 }
 
+void QQuickShaderEffectTexture::markFullUpdate()
+{
+    m_fullUpdate = true;
+    markDirtyTexture();
+}
+
+/*
+    Computes the part of the texture which changed since the last grab, in
+    framebuffer coordinates. Returns false if it cannot be bounded.
+ */
+bool QQuickShaderEffectTexture::computeDamage(QSGNode *root, QRect *rect)
+{
+    QRectF damage;
+    bool bounded = m_damageTracker.update(root, m_renderer->takeChangedNodes(), &damage);
+
+    if (!bounded || m_rect.isEmpty())
+        return false;
+
+    *rect = QRect();
+    if (damage.isEmpty())
+        return true;
+
+    // Leave room for antialiasing, which may extend the geometry in the shader.
+    const int margin = 2;
+    qreal sx = m_size.width() / m_rect.width();
+    qreal sy = m_size.height() / m_rect.height();
+    int x1 = qFloor((damage.left() - m_rect.left()) * sx) - margin;
+    int y1 = qFloor((damage.top() - m_rect.top()) * sy) - margin;
+    int x2 = qCeil((damage.right() - m_rect.left()) * sx) + margin;
+    int y2 = qCeil((damage.bottom() - m_rect.top()) * sy) + margin;
+    *rect = QRect(x1, y1, x2 - x1, y2 - y1) & QRect(QPoint(), m_size);
+    return true;
+}
+
 void QQuickShaderEffectTexture::grab()
 {
     if (!m_item || m_size.isNull()) {
@@ -341,7 +393,10 @@ void QQuickShaderEffectTexture::grab()
 
     if (!m_renderer) {
         m_renderer = m_context->createRenderer();
+        m_renderer->setTrackChangedNodes(m_partialUpdates);
         connect(m_renderer, SIGNAL(sceneGraphChanged()), this, SLOT(markDirtyTexture()));
+        m_damageTracker.reset();
+        m_fullUpdate = true;
     }
     m_renderer->setDevicePixelRatio(m_device_pixel_ratio);
     m_renderer->setRootNode(static_cast<QSGRootNode *>(root));
@@ -350,6 +405,7 @@ void QQuickShaderEffectTexture::grab()
     if (!m_fbo || m_fbo->size() != m_size || m_fbo->format().internalTextureFormat() != m_format
         || (!m_fbo->format().mipmap() && m_mipmap))
     {
+        m_fullUpdate = true;
         if (!m_multisamplingChecked) {
             if (m_context->openglContext()->format().samples() <= 1) {
                 m_multisampling = false;
@@ -403,6 +459,23 @@ void QQuickShaderEffectTexture::grab()
         updateBindOptions(true);
     }
 
+    // Only render the part of the texture which changed. Recursive sources
+    // alternate between two textures, so they are always rendered in full.
+    QRect scissorRect;
+    if (m_partialUpdates) {
+        QRect damage;
+        bool bounded = computeDamage(root, &damage);
+        if (bounded && !m_fullUpdate && !m_recursive && !qmlFboOverlay()) {
+            if (damage.isEmpty()) {
+                m_dirtyTexture = false;
+                return;
+            }
+            scissorRect = damage;
+        }
+    }
+    m_fullUpdate = false;
+    m_renderer->setScissorRect(scissorRect);
+
     // Render texture.
     root->markDirty(QSGNode::DirtyForceUpdate); // Force matrix, clip and opacity update.
     m_renderer->nodeChanged(root, QSGNode::DirtyForceUpdate); // Force render list update.
@@ -599,6 +672,7 @@ QQuickShaderEffectSource::QQuickShaderEffectSource(QQuickItem *parent)
     , m_hideSource(false)
     , m_mipmap(false)
     , m_recursive(false)
+    , m_partialUpdates(true)
     , m_grab(true)
 {
     setFlag(ItemHasContents);
@@ -942,6 +1016,40 @@ void QQuickShaderEffectSource::setRecursive(bool enabled)
     emit recursiveChanged();
 }
 
+/*!
+    \qmlproperty bool QtQuick::ShaderEffectSource::partialUpdates
+    \since 5.4
+
+    This property holds whether only the changed parts of the texture are
+    rendered again when the \l sourceItem changes.
+
+    The scene graph keeps track of the bounds of the nodes in the source
+    item's subtree and restricts rendering to the area which changed, such as
+    a blinking text cursor, leaving the rest of the texture untouched. When
+    the change cannot be bounded, for instance because of a perspective
+    transform or a custom render node, or when the ShaderEffectSource is
+    \l recursive, the whole texture is rendered.
+
+    Set this property to false if the effect relies on the texture being
+    fully redrawn every time it is updated.
+
+    The default value is true.
+*/
+
+bool QQuickShaderEffectSource::partialUpdates() const
+{
+    return m_partialUpdates;
+}
+
+void QQuickShaderEffectSource::setPartialUpdates(bool enabled)
+{
+    if (enabled == m_partialUpdates)
+        return;
+    m_partialUpdates = enabled;
+    update();
+    emit partialUpdatesChanged();
+}
+
 /*!
     \qmlmethod QtQuick::ShaderEffectSource::scheduleUpdate()
 
@@ -1027,6 +1135,7 @@ QSGNode *QQuickShaderEffectSource::updatePaintNode(QSGNode *oldNode, UpdatePaint
     m_texture->setDevicePixelRatio(d->window->devicePixelRatio());
     m_texture->setSize(textureSize);
     m_texture->setRecursive(m_recursive);
+    m_texture->setPartialUpdates(m_partialUpdates);
     m_texture->setFormat(GLenum(m_format));
     m_texture->setHasMipmaps(m_mipmap);
 
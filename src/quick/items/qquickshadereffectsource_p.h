@@ -47,6 +47,7 @@
 #include <private/qsgadaptationlayer_p.h>
 #include <QtQuick/private/qsgcontext_p.h>
 #include <private/qsgdefaultimagenode_p.h>
+#include <private/qsgdamagetracker_p.h>
 #include <private/qquickitemchangelistener_p.h>
 
 #include "qpointer.h"
@@ -112,11 +113,15 @@ public:
     bool recursive() const { return bool(m_recursive); }
     void setRecursive(bool recursive);
 
+    bool partialUpdates() const { return bool(m_partialUpdates); }
+    void setPartialUpdates(bool partial);
+
     void setDevicePixelRatio(qreal ratio) { m_device_pixel_ratio = ratio; }
 
     void scheduleUpdate();
 
     QImage toImage() const;
+    QOpenGLFramebufferObject *framebufferObject() const { return m_fbo; }
 
 Q_SIGNALS:
     void updateRequested();
@@ -128,6 +133,8 @@ public Q_SLOTS:
 
 private:
     void grab();
+    void markFullUpdate();
+    bool computeDamage(QSGNode *root, QRect *rect);
 
     QSGNode *m_item;
     QRectF m_rect;
@@ -148,6 +155,8 @@ private:
 
     QSGRenderContext *m_context;
 
+    QSGDamageTracker m_damageTracker;
+
     uint m_mipmap : 1;
     uint m_live : 1;
     uint m_recursive : 1;
@@ -155,6 +164,8 @@ private:
     uint m_multisamplingChecked : 1;
     uint m_multisampling : 1;
     uint m_grab : 1;
+    uint m_partialUpdates : 1;
+    uint m_fullUpdate : 1;
 };
 
 class Q_QUICK_PRIVATE_EXPORT QQuickShaderEffectSource : public QQuickItem, public QQuickItemChangeListener
@@ -169,6 +180,7 @@ class Q_QUICK_PRIVATE_EXPORT QQuickShaderEffectSource : public QQuickItem, publi
     Q_PROPERTY(bool hideSource READ hideSource WRITE setHideSource NOTIFY hideSourceChanged)
     Q_PROPERTY(bool mipmap READ mipmap WRITE setMipmap NOTIFY mipmapChanged)
     Q_PROPERTY(bool recursive READ recursive WRITE setRecursive NOTIFY recursiveChanged)
+    Q_PROPERTY(bool partialUpdates READ partialUpdates WRITE setPartialUpdates NOTIFY partialUpdatesChanged REVISION 1)
 
     Q_ENUMS(Format WrapMode)
 public:
@@ -215,6 +227,9 @@ public:
     bool recursive() const;
     void setRecursive(bool enabled);
 
+    bool partialUpdates() const;
+    void setPartialUpdates(bool enabled);
+
     bool isTextureProvider() const { return true; }
     QSGTextureProvider *textureProvider() const;
 
@@ -230,6 +245,7 @@ Q_SIGNALS:
     void hideSourceChanged();
     void mipmapChanged();
     void recursiveChanged();
+    Q_REVISION(1) void partialUpdatesChanged();
 
     void scheduledUpdateCompleted();
 
@@ -258,6 +274,7 @@ private:
     uint m_hideSource : 1;
     uint m_mipmap : 1;
     uint m_recursive : 1;
+    uint m_partialUpdates : 1;
     uint m_grab : 1;
 };
 
@@ -47,6 +47,8 @@
 #include <QPainter>
 #include <QSet>
 #include <QtGui>
+#include <QMutex>
+#include <QSharedPointer>
 
 QT_BEGIN_NAMESPACE
 
@@ -120,6 +122,75 @@ QQuickSpriteEngine::QQuickSpriteEngine(QList<QQuickSprite*> sprites, QObject *pa
 
 QQuickSpriteEngine::~QQuickSpriteEngine()
 {
+    releaseSheet();
+}
+
+/*
+    Sprite sheets are assembled from the sprite definitions alone, so engines
+    with identical definitions share one assembled image, and one texture
+    factory, for as long as any of them uses it. The scene graph caches the
+    texture per factory, so the sheet is also uploaded only once per window.
+*/
+namespace {
+struct SharedSpriteSheet
+{
+    SharedSpriteSheet() : ref(0) {}
+    QImage image;
+    QSharedPointer<QQuickTextureFactory> factory;
+    int ref;
+};
+}
+
+typedef QHash<QString, SharedSpriteSheet> SharedSpriteSheets;
+Q_GLOBAL_STATIC(SharedSpriteSheets, sharedSpriteSheets)
+Q_GLOBAL_STATIC(QMutex, sharedSpriteSheetsMutex)
+
+QString QQuickSpriteEngine::sheetKey(int maxSize) const
+{
+    QString key = QString::number(maxSize);
+    foreach (QQuickSprite *state, m_sprites) {
+        key += QString::fromLatin1("|%1:%2:%3,%4,%5,%6,%7")
+                .arg(state->source().toString())
+                .arg(state->m_pix.image().cacheKey())
+                .arg(state->m_frames)
+                .arg(state->m_frameX)
+                .arg(state->m_frameY)
+                .arg(state->m_frameWidth)
+                .arg(state->m_frameHeight);
+    }
+    return key;
+}
+
+void QQuickSpriteEngine::releaseSheet()
+{
+    if (m_sheetKey.isEmpty())
+        return;
+
+    QMutexLocker locker(sharedSpriteSheetsMutex());
+    SharedSpriteSheets::Iterator it = sharedSpriteSheets()->find(m_sheetKey);
+    if (it != sharedSpriteSheets()->end() && --it->ref == 0)
+        sharedSpriteSheets()->erase(it);
+    m_sheetKey.clear();
+}
+
+/*
+    Returns a texture factory for the image last returned by assembledImage().
+    Pass it to QSGRenderContext::textureForFactory() to get the shared texture;
+    the texture belongs to the render context and lives as long as the factory,
+    so users need to hold on to the returned pointer while they draw with it.
+*/
+QSharedPointer<QQuickTextureFactory> QQuickSpriteEngine::textureFactory()
+{
+    if (m_sheetKey.isEmpty())
+        return QSharedPointer<QQuickTextureFactory>();
+
+    QMutexLocker locker(sharedSpriteSheetsMutex());
+    SharedSpriteSheets::Iterator it = sharedSpriteSheets()->find(m_sheetKey);
+    if (it == sharedSpriteSheets()->end())
+        return QSharedPointer<QQuickTextureFactory>();
+    if (!it->factory)
+        it->factory = QSharedPointer<QQuickTextureFactory>(new QQuickDefaultTextureFactory(it->image));
+    return it->factory;
 }
 
 
@@ -429,17 +500,43 @@ QImage QQuickSpriteEngine::assembledImage()
         }
     }
 
+    if (h > maxSize){
+        qWarning() << "SpriteEngine: Too many animations to fit in one texture...";
+        qWarning() << "SpriteEngine: Your texture max size today is " << maxSize;
+        return QImage();
+    }
+
+    // The layout of the sheet still has to be recorded on the sprites below,
+    // but the pixels only need to be painted if no other engine did so.
+    const QString key = sheetKey(maxSize);
+    QImage image;
+    {
+        QMutexLocker locker(sharedSpriteSheetsMutex());
+        SharedSpriteSheets::Iterator it = sharedSpriteSheets()->find(key);
+        if (it != sharedSpriteSheets()->end()) {
+            image = it->image;
+            if (m_sheetKey != key)
+                ++it->ref;
+        }
+    }
+    const bool paint = image.isNull();
+
     //maxFrames is max number in a line of the texture
-    QImage image(w, h, QImage::Format_ARGB32_Premultiplied);
-    image.fill(0);
-    QPainter p(&image);
+    if (paint) {
+        image = QImage(w, h, QImage::Format_ARGB32_Premultiplied);
+        image.fill(0);
+    }
+    QPainter p;
+    if (paint)
+        p.begin(&image);
     int y = 0;
     foreach (QQuickSprite* state, m_sprites){
         QImage img(state->m_pix.image());
         int frameWidth = state->m_frameWidth;
         int frameHeight = state->m_frameHeight;
         if (img.height() == frameHeight && img.width() <  maxSize){//Simple case
-            p.drawImage(0,y,img.copy(state->m_frameX,0,state->m_frames * frameWidth, frameHeight));
+            if (paint)
+                p.drawImage(0,y,img.copy(state->m_frameX,0,state->m_frames * frameWidth, frameHeight));
             state->m_rowStartX = 0;
             state->m_rowY = y;
             y += frameHeight;
@@ -454,7 +551,8 @@ QImage QQuickSpriteEngine::assembledImage()
                 if (image.width() - x + curX <= img.width()){//finish a row in image (dest)
                     int copied = image.width() - x;
                     framesLeft -= copied/frameWidth;
-                    p.drawImage(x,y,img.copy(curX,curY,copied,frameHeight));
+                    if (paint)
+                        p.drawImage(x,y,img.copy(curX,curY,copied,frameHeight));
                     y += frameHeight;
                     curX += copied;
                     x = 0;
@@ -465,7 +563,8 @@ QImage QQuickSpriteEngine::assembledImage()
                 }else{//finish a row in img (src)
                     int copied = img.width() - curX;
                     framesLeft -= copied/frameWidth;
-                    p.drawImage(x,y,img.copy(curX,curY,copied,frameHeight));
+                    if (paint)
+                        p.drawImage(x,y,img.copy(curX,curY,copied,frameHeight));
                     curY += frameHeight;
                     x += copied;
                     curX = 0;
@@ -476,10 +575,21 @@ QImage QQuickSpriteEngine::assembledImage()
         }
     }
 
-    if (image.height() > maxSize){
-        qWarning() << "SpriteEngine: Too many animations to fit in one texture...";
-        qWarning() << "SpriteEngine: Your texture max size today is " << maxSize;
-        return QImage();
+    if (paint) {
+        p.end();
+
+        QMutexLocker locker(sharedSpriteSheetsMutex());
+        SharedSpriteSheet &sheet = (*sharedSpriteSheets())[key];
+        if (sheet.image.isNull())
+            sheet.image = image;
+        else
+            image = sheet.image; // assembled concurrently by another engine
+        if (m_sheetKey != key)
+            ++sheet.ref;
+    }
+    if (m_sheetKey != key) {
+        releaseSheet();
+        m_sheetKey = key;
     }
 
 #ifdef SPRITE_IMAGE_DEBUG
@@ -502,6 +612,7 @@ void QQuickStochasticEngine::setCount(int c)
     m_goals.resize(c);
     m_duration.resize(c);
     m_startTimes.resize(c);
+    m_stateUpdates.reserve(c);
 }
 
 void QQuickStochasticEngine::start(int index, int state)
@@ -523,8 +634,7 @@ void QQuickStochasticEngine::stop(int index)
     if (index >= m_things.count())
         return;
     //Will never change until start is called again with a new state (or manually advanced) - this is not a 'pause'
-    for (int i=0; i<m_stateUpdates.count(); i++)
-        m_stateUpdates[i].second.removeAll(index);
+    m_stateUpdates.remove(index);
 }
 
 void QQuickStochasticEngine::restart(int index)
@@ -536,8 +646,7 @@ void QQuickStochasticEngine::restart(int index)
     if (randomStart)
         m_startTimes[index] -= qrand() % m_duration[index];
     int time = m_duration[index] + m_startTimes[index];
-    for (int i=0; i<m_stateUpdates.count(); i++)
-        m_stateUpdates[i].second.removeAll(index);
+    m_stateUpdates.remove(index);
     if (m_duration[index] >= 0)
         addToUpdateList(time, index);
 }
@@ -562,8 +671,7 @@ void QQuickSpriteEngine::restart(int index) //Reimplemented to recognize and han
                 time += spriteDuration(index);
         }
 
-        for (int i=0; i<m_stateUpdates.count(); i++)
-            m_stateUpdates[i].second.removeAll(index);
+        m_stateUpdates.remove(index);
         addToUpdateList(time, index);
     }
 }
@@ -655,17 +763,18 @@ uint QQuickStochasticEngine::updateSprites(uint time)//### would returning a lis
     //Sprite State Update;
     m_timeOffset = time;
     m_addAdvance = false;
-    while (!m_stateUpdates.isEmpty() && time >= m_stateUpdates.first().first){
-        foreach (int idx, m_stateUpdates.first().second)
-            advance(idx);
-        m_stateUpdates.pop_front();
-    }
+    do {//Advancing can schedule further updates which are already due
+        m_expiredUpdates.resize(0);
+        m_stateUpdates.advance(time, &m_expiredUpdates);
+        for (int i = 0; i < m_expiredUpdates.size(); ++i)
+            advance(m_expiredUpdates.at(i));
+    } while (!m_expiredUpdates.isEmpty());
 
     m_advanceTime.start();
     m_addAdvance = true;
     if (m_stateUpdates.isEmpty())
         return uint(-1);
-    return m_stateUpdates.first().first;
+    return m_stateUpdates.nextTime();
 }
 
 int QQuickStochasticEngine::goalSeek(int curIdx, int spriteIdx, int dist)
@@ -745,20 +854,7 @@ int QQuickStochasticEngine::goalSeek(int curIdx, int spriteIdx, int dist)
 
 void QQuickStochasticEngine::addToUpdateList(uint t, int idx)
 {
-    for (int i=0; i<m_stateUpdates.count(); i++){
-        if (m_stateUpdates[i].first==t){
-            m_stateUpdates[i].second << idx;
-            return;
-        }else if (m_stateUpdates[i].first > t){
-            QList<int> tmpList;
-            tmpList << idx;
-            m_stateUpdates.insert(i, qMakePair(t, tmpList));
-            return;
-        }
-    }
-    QList<int> tmpList;
-    tmpList << idx;
-    m_stateUpdates << qMakePair(t, tmpList);
+    m_stateUpdates.insert(idx, t);
 }
 
 QT_END_NAMESPACE
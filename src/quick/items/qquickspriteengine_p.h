@@ -50,7 +50,9 @@
 #include <QQmlListProperty>
 #include <QImage>
 #include <QPair>
+#include <QSharedPointer>
 #include <private/qquickpixmapcache_p.h>
+#include <private/qquicktimingwheel_p.h>
 #include <private/qtquickglobal_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -241,7 +243,8 @@ protected:
     QVector<int> m_goals;
     QVector<int> m_duration;
     QVector<int> m_startTimes;
-    QList<QPair<uint, QList<int> > > m_stateUpdates;//### This could be done faster - priority queue?
+    QQuickTimingWheel m_stateUpdates;
+    QVector<int> m_expiredUpdates;
 
     QTime m_advanceTime;
     uint m_timeOffset;
@@ -287,10 +290,14 @@ public:
     QQuickPixmap::Status status();//Composed status of all Sprites
     void startAssemblingImage();
     QImage assembledImage();
+    QSharedPointer<QQuickTextureFactory> textureFactory();
 
 private:
     int pseudospriteProgress(int,int,int*rd=0);
+    QString sheetKey(int maxSize) const;
+    void releaseSheet();
     QList<QQuickSprite*> m_sprites;
+    QString m_sheetKey;
     bool m_startedImageAssembly;
     bool m_loaded;
     bool m_errorsPrinted;
@@ -43,6 +43,7 @@
 #include "qquicksprite_p.h"
 #include "qquickspriteengine_p.h"
 #include <QtQuick/private/qsgcontext_p.h>
+#include <QtQuick/private/qquickitem_p.h>
 #include <private/qsgadaptationlayer_p.h>
 #include <QtQuick/qsgnode.h>
 #include <QtQuick/qsgtexturematerial.h>
@@ -69,6 +70,7 @@ public:
     }
 
     QSGTexture *texture;
+    QSharedPointer<QQuickTextureFactory> factory;
 
     float animT;
     float animX1;
@@ -94,7 +96,7 @@ QQuickSpriteSequenceMaterial::QQuickSpriteSequenceMaterial()
 
 QQuickSpriteSequenceMaterial::~QQuickSpriteSequenceMaterial()
 {
-    delete texture;
+    // the texture is owned by the render context and released with factory
 }
 
 class SpriteSequenceMaterialData : public QSGMaterialShader
@@ -323,7 +325,13 @@ QSGGeometryNode* QQuickSpriteSequence::buildNode()
     if (image.isNull())
         return 0;
     m_sheetSize = QSizeF(image.size());
-    m_material->texture = window()->createTextureFromImage(image);
+    m_material->factory = m_spriteEngine->textureFactory();
+    m_material->texture = QQuickItemPrivate::get(this)->sceneGraphRenderContext()->textureForFactory(m_material->factory.data(), window());
+    if (!m_material->texture) {
+        delete m_material;
+        m_material = 0;
+        return 0;
+    }
     m_material->texture->setFiltering(QSGTexture::Linear);
     m_spriteEngine->start(0);
     m_material->animT = 0;
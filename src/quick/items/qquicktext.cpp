@@ -60,16 +60,277 @@
 #include <QtGui/qtextcursor.h>
 #include <QtGui/qguiapplication.h>
 #include <QtGui/qinputmethod.h>
+#include <QtGui/qfontdatabase.h>
 
 #include <private/qtextengine_p.h>
 #include <private/qquickstyledtext_p.h>
 #include <QtQuick/private/qquickpixmapcache_p.h>
 
+#include <QtCore/qcache.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qrunnable.h>
+#include <QtCore/qthreadpool.h>
+
 #include <qmath.h>
 #include <limits.h>
 
 QT_BEGIN_NAMESPACE
 
+// Number of single line layouts shared between Text items with the same text and font.
+// QML_TEXT_LAYOUT_CACHE_SIZE=0 disables sharing.
+#ifndef QML_TEXT_LAYOUT_CACHE_SIZE
+#define QML_TEXT_LAYOUT_CACHE_SIZE 512
+#endif
+
+namespace {
+
+struct TextLayoutKey
+{
+    QString text;
+    QFont font;
+    int alignment;
+    bool designMetrics;
+    qreal lineWidth;
+    qreal lineHeight;
+    int lineHeightMode;
+
+    bool operator==(const TextLayoutKey &other) const
+    {
+        return text == other.text
+                && alignment == other.alignment
+                && designMetrics == other.designMetrics
+                && lineWidth == other.lineWidth
+                && lineHeight == other.lineHeight
+                && lineHeightMode == other.lineHeightMode
+                && font == other.font;
+    }
+};
+
+inline uint qHash(const TextLayoutKey &key, uint seed = 0)
+{
+    return qHash(key.text, seed) ^ qHash(key.font.key()) ^ uint(key.alignment)
+            ^ (uint(key.designMetrics) << 8) ^ (uint(key.lineHeightMode) << 9);
+}
+
+struct TextLayoutEntry
+{
+    QSharedPointer<QTextLayout> layout;
+    QRectF rect;
+    qreal naturalWidth;
+    qreal naturalHeight;
+    qreal baseline;
+};
+
+/*
+    Laid out single line text shared by all Text items in the GUI thread. Thousands of
+    delegates typically show the same few labels in the same font, and shaping and laying
+    out the text is the most expensive part of creating a Text.
+*/
+class TextLayoutCache
+{
+public:
+    TextLayoutCache()
+        : cache(qgetenv("QML_TEXT_LAYOUT_CACHE_SIZE").isEmpty()
+                ? QML_TEXT_LAYOUT_CACHE_SIZE
+                : qgetenv("QML_TEXT_LAYOUT_CACHE_SIZE").toInt())
+    {
+    }
+
+    bool isEnabled() const { return cache.maxCost() > 0; }
+    TextLayoutEntry *find(const TextLayoutKey &key) { return cache.object(key); }
+    void insert(const TextLayoutKey &key, TextLayoutEntry *entry) { cache.insert(key, entry); }
+
+private:
+    QCache<TextLayoutKey, TextLayoutEntry> cache;
+};
+
+}
+
+Q_GLOBAL_STATIC(TextLayoutCache, textLayoutCache)
+
+// Plain text with at least this many characters is laid out in a worker thread when
+// Text.asynchronous is set.  Shorter text is always laid out synchronously.
+#ifndef QML_TEXT_ASYNC_LAYOUT_THRESHOLD
+#define QML_TEXT_ASYNC_LAYOUT_THRESHOLD 8192
+#endif
+
+// Approximate number of characters in each block of an asynchronous layout.  Blocks end at
+// line breaks and are shown as soon as they have been laid out.
+#ifndef QML_TEXT_ASYNC_BLOCK_LENGTH
+#define QML_TEXT_ASYNC_BLOCK_LENGTH 4096
+#endif
+
+/*
+    Lays out plain text in a thread of the global thread pool, one block of paragraphs at a
+    time.  Finished blocks are collected by the Text item in the GUI thread, which is notified
+    with a queued call to q_asyncLayoutProgress().
+*/
+class QQuickTextAsyncLayout
+{
+public:
+    QQuickTextAsyncLayout(QObject *receiver, const QString &text, const QFont &font,
+                          Qt::Alignment alignment, QTextOption::WrapMode wrapMode, bool designMetrics,
+                          qreal lineWidth, qreal lineHeight, QQuickText::LineHeightMode lineHeightMode)
+        : text(text), font(font), alignment(alignment), wrapMode(wrapMode), designMetrics(designMetrics)
+        , lineWidth(lineWidth), lineHeight(lineHeight), lineHeightMode(lineHeightMode)
+        , receiver(receiver), finished(false), notified(false)
+    {
+        // Detach from the font of the item, font engines are cached per thread.
+        this->font.setKerning(font.kerning());
+    }
+
+    bool matches(const QString &otherText, const QFont &otherFont, Qt::Alignment otherAlignment,
+                 QTextOption::WrapMode otherWrapMode, bool otherDesignMetrics, qreal otherLineWidth,
+                 qreal otherLineHeight, QQuickText::LineHeightMode otherLineHeightMode) const
+    {
+        return lineWidth == otherLineWidth
+                && alignment == otherAlignment
+                && wrapMode == otherWrapMode
+                && designMetrics == otherDesignMetrics
+                && lineHeight == otherLineHeight
+                && lineHeightMode == otherLineHeightMode
+                && font == otherFont
+                && text == otherText;
+    }
+
+    void run();
+    void cancel();
+    QVector<QQuickTextPrivate::LayoutBlock> takeBlocks(bool *isFinished);
+
+    static void layoutLines(QTextLayout *layout, QQuickTextPrivate::LayoutBlock *block,
+                            qreal lineWidth, qreal lineHeight, QQuickText::LineHeightMode lineHeightMode);
+
+    const QString text;
+    QFont font;
+    const Qt::Alignment alignment;
+    const QTextOption::WrapMode wrapMode;
+    const bool designMetrics;
+    const qreal lineWidth;
+    const qreal lineHeight;
+    const QQuickText::LineHeightMode lineHeightMode;
+
+private:
+    bool publish(const QQuickTextPrivate::LayoutBlock *block);
+
+    QMutex mutex;
+    QObject *receiver;
+    QVector<QQuickTextPrivate::LayoutBlock> blocks;
+    bool finished;
+    bool notified;
+};
+
+namespace {
+
+class TextLayoutRunnable : public QRunnable
+{
+public:
+    TextLayoutRunnable(const QSharedPointer<QQuickTextAsyncLayout> &layout) : layout(layout) {}
+    void run() { layout->run(); }
+
+private:
+    QSharedPointer<QQuickTextAsyncLayout> layout;
+};
+
+}
+
+void QQuickTextAsyncLayout::layoutLines(
+        QTextLayout *layout, QQuickTextPrivate::LayoutBlock *block,
+        qreal lineWidth, qreal lineHeight, QQuickText::LineHeightMode lineHeightMode)
+{
+    block->rect = QRectF();
+    block->height = 0;
+    block->lineCount = 0;
+
+    layout->beginLayout();
+    for (QTextLine line = layout->createLine(); line.isValid(); line = layout->createLine()) {
+        line.setLineWidth(lineWidth);
+        line.setPosition(QPointF(line.position().x(), block->height));
+        if (block->lineCount++ == 0)
+            block->baseline = line.ascent();
+        block->height += lineHeightMode == QQuickText::FixedHeight
+                ? lineHeight
+                : line.height() * lineHeight;
+        block->rect = block->rect.united(line.naturalTextRect());
+    }
+    layout->endLayout();
+
+    block->rect.setTop(0);
+    block->rect.setHeight(block->height);
+    block->naturalWidth = layout->maximumWidth();
+}
+
+void QQuickTextAsyncLayout::run()
+{
+    QTextOption option;
+    // Unwrapped text without a width is aligned once the widest line is known.
+    option.setAlignment(lineWidth == FLT_MAX ? Qt::AlignLeft : alignment);
+    option.setWrapMode(wrapMode);
+    option.setUseDesignMetrics(designMetrics);
+
+    for (int start = 0; start <= text.length();) {
+        int end = start + QML_TEXT_ASYNC_BLOCK_LENGTH < text.length()
+                ? text.indexOf(QChar::LineSeparator, start + QML_TEXT_ASYNC_BLOCK_LENGTH)
+                : -1;
+        if (end == -1)
+            end = text.length();
+
+        QQuickTextPrivate::LayoutBlock block;
+        block.layout = QSharedPointer<QTextLayout>(new QTextLayout(text.mid(start, end - start), font));
+        block.layout->setCacheEnabled(true);
+        block.layout->setTextOption(option);
+        block.y = 0;
+        block.baseline = 0;
+
+        // The implicit width of wrapped text is the width of its widest paragraph.
+        qreal naturalWidth = 0;
+        if (wrapMode != QTextOption::NoWrap && lineWidth != FLT_MAX) {
+            layoutLines(block.layout.data(), &block, FLT_MAX, lineHeight, lineHeightMode);
+            naturalWidth = block.naturalWidth;
+        }
+        layoutLines(block.layout.data(), &block, lineWidth, lineHeight, lineHeightMode);
+        block.naturalWidth = qMax(block.naturalWidth, naturalWidth);
+
+        if (!publish(&block))
+            return;
+        start = end + 1;
+    }
+    publish(0);
+}
+
+bool QQuickTextAsyncLayout::publish(const QQuickTextPrivate::LayoutBlock *block)
+{
+    QMutexLocker locker(&mutex);
+    if (!receiver)
+        return false;
+    if (block)
+        blocks.append(*block);
+    else
+        finished = true;
+    if (!notified) {
+        notified = true;
+        QMetaObject::invokeMethod(receiver, "q_asyncLayoutProgress", Qt::QueuedConnection);
+    }
+    return true;
+}
+
+// Once this returns the layout thread no longer touches the receiver, publish() holds the
+// same lock while posting.
+void QQuickTextAsyncLayout::cancel()
+{
+    QMutexLocker locker(&mutex);
+    receiver = 0;
+}
+
+QVector<QQuickTextPrivate::LayoutBlock> QQuickTextAsyncLayout::takeBlocks(bool *isFinished)
+{
+    QMutexLocker locker(&mutex);
+    QVector<QQuickTextPrivate::LayoutBlock> taken;
+    taken.swap(blocks);
+    *isFinished = finished;
+    notified = false;
+    return taken;
+}
+
 
 const QChar QQuickTextPrivate::elideChar = QChar(0x2026);
 
@@ -87,6 +348,7 @@ QQuickTextPrivate::QQuickTextPrivate()
     , requireImplicitSize(false), implicitWidthValid(false), implicitHeightValid(false)
     , truncated(false), hAlignImplicit(true), rightToLeftText(false)
     , layoutTextElided(false), textHasChanged(true), needToUpdateLayout(false), formatModifiesFontSize(false)
+    , asynchronous(false)
 {
 }
 
@@ -396,6 +658,12 @@ void QQuickText::imageDownloadFinished()
     }
 }
 
+void QQuickText::q_asyncLayoutProgress()
+{
+    Q_D(QQuickText);
+    d->updateAsyncTextLayout();
+}
+
 void QQuickTextPrivate::updateBaseline(qreal baseline, qreal dy)
 {
     Q_Q(QQuickText);
@@ -441,6 +709,7 @@ void QQuickTextPrivate::updateSize()
                     ? lineHeight()
                     : fontHeight * lineHeight();
         }
+        clearAsyncTextLayout();
         updateBaseline(fm.ascent(), q->height() - fontHeight);
         q->setImplicitSize(0, fontHeight);
         layedOutTextRect = QRectF(0, 0, 0, fontHeight);
@@ -455,6 +724,12 @@ void QQuickTextPrivate::updateSize()
 
     //setup instance of QTextLayout for all cases other than richtext
     if (!richText) {
+        if (canLayoutAsynchronously(layout.text())) {
+            setupAsyncTextLayout(layout.text());
+            return;
+        }
+        clearAsyncTextLayout();
+
         qreal baseline = 0;
         QRectF textRect = setupTextLayout(&baseline);
 
@@ -465,6 +740,7 @@ void QQuickTextPrivate::updateSize()
         size = textRect.size();
         updateBaseline(baseline, q->height() - size.height());
     } else {
+        clearAsyncTextLayout();
         widthExceeded = true; // always relayout rich text on width changes..
         heightExceeded = false; // rich text layout isn't affected by height changes.
         ensureDoc();
@@ -692,6 +968,7 @@ QRectF QQuickTextPrivate::setupTextLayout(qreal *const baseline)
     if ((!requireImplicitSize || (implicitWidthValid && implicitHeightValid))
             && ((singlelineElide && q->width() <= 0.) || (multilineElide && q->heightValid() && q->height() <= 0.))) {
         // we are elided and we have a zero width or height
+        sharedLayout.clear();
         widthExceeded = q->widthValid() && q->width() <= 0.;
         heightExceeded = q->heightValid() && q->height() <= 0.;
 
@@ -712,6 +989,7 @@ QRectF QQuickTextPrivate::setupTextLayout(qreal *const baseline)
 
     bool shouldUseDesignMetrics = renderType != QQuickText::NativeRendering;
 
+    sharedLayout.clear();
     layout.setCacheEnabled(true);
     QTextOption textOption = layout.textOption();
     if (textOption.alignment() != q->effectiveHAlign()
@@ -742,6 +1020,12 @@ QRectF QQuickTextPrivate::setupTextLayout(qreal *const baseline)
     const bool pixelSize = font.pixelSize() != -1;
     QString layoutText = layout.text();
 
+    if (canShareTextLayout(layoutText)) {
+        QRectF rect;
+        if (setupSharedTextLayout(layoutText, baseline, &rect))
+            return rect;
+    }
+
     int largeFont = pixelSize ? font.pixelSize() : font.pointSize();
     int smallFont = fontSizeMode() != QQuickText::FixedSize
             ? qMin(pixelSize ? minimumPixelSize() : minimumPointSize(), largeFont)
@@ -1106,6 +1390,259 @@ QRectF QQuickTextPrivate::setupTextLayout(qreal *const baseline)
     return br;
 }
 
+/*
+    Returns true if the layout of the text depends only on the text, font and line width, so
+    that it can be shared with other Text items: a single line of unformatted text without
+    wrapping, eliding, font fitting or custom line geometry.
+*/
+bool QQuickTextPrivate::canShareTextLayout(const QString &layoutText)
+{
+    return !layoutText.isEmpty()
+            && wrapMode == QQuickText::NoWrap
+            && elideMode == QQuickText::ElideNone
+            && fontSizeMode() == QQuickText::FixedSize
+            && !maximumLineCountValid
+            && multilengthEos == -1
+            && imgTags.isEmpty()
+            && layout.additionalFormats().isEmpty()
+            && !isLineLaidOutConnected()
+            && !layoutText.contains(QChar::LineSeparator)
+            && textLayoutCache()->isEnabled();
+}
+
+/*
+    Takes the layout of the text from the shared cache, laying it out first if necessary,
+    with the same result as the first pass of setupTextLayout().  Returns false if a second
+    pass is needed, in which case setupTextLayout() lays out the text itself.
+*/
+bool QQuickTextPrivate::setupSharedTextLayout(const QString &layoutText, qreal *const baseline, QRectF *rect)
+{
+    Q_Q(QQuickText);
+
+    TextLayoutKey key;
+    key.text = layoutText;
+    key.font = font;
+    key.alignment = layout.textOption().alignment();
+    key.designMetrics = layout.textOption().useDesignMetrics();
+    key.lineWidth = lineWidth;
+    key.lineHeight = lineHeight();
+    key.lineHeightMode = lineHeightMode();
+
+    TextLayoutCache *cache = textLayoutCache();
+    TextLayoutEntry *entry = cache->find(key);
+    if (!entry) {
+        QSharedPointer<QTextLayout> textLayout(new QTextLayout(layoutText, font));
+        textLayout->setCacheEnabled(true);
+        textLayout->setTextOption(layout.textOption());
+        textLayout->beginLayout();
+        QTextLine line = textLayout->createLine();
+        qreal height = 0;
+        setLineGeometry(line, lineWidth, height);
+        const bool singleLine = !textLayout->createLine().isValid();
+        textLayout->endLayout();
+        if (!singleLine)
+            return false;
+
+        entry = new TextLayoutEntry;
+        entry->layout = textLayout;
+        entry->rect = line.naturalTextRect();
+        entry->naturalWidth = textLayout->maximumWidth();
+        entry->naturalHeight = height;
+        entry->baseline = line.y() + line.ascent();
+        cache->insert(key, entry);
+    }
+    // Keep the entry alive even if setting the implicit size evicts it from the cache.
+    const TextLayoutEntry result = *entry;
+
+    bool wasInLayout = internalWidthUpdate;
+    internalWidthUpdate = true;
+    q->setImplicitSize(result.naturalWidth, result.naturalHeight);
+    internalWidthUpdate = wasInLayout;
+
+    // The cases in which setupTextLayout() lays out the text a second time.
+    const qreal oldWidth = lineWidth;
+    lineWidth = q->widthValid() && q->width() > 0 ? q->width() : result.naturalWidth;
+    if (q->effectiveHAlign() != QQuickText::AlignLeft
+            && (lineWidth < qMin(oldWidth, result.naturalWidth) || (!implicitWidthValid && lineCount > 1))) {
+        lineWidth = oldWidth;
+        return false;
+    }
+
+    const bool wasTruncated = truncated;
+    truncated = false;
+    widthExceeded = false;
+    heightExceeded = false;
+    implicitWidthValid = true;
+    implicitHeightValid = true;
+
+    delete elideLayout;
+    elideLayout = 0;
+    layout.clearLayout();
+    sharedLayout = result.layout;
+
+    *baseline = result.baseline;
+    *rect = result.rect;
+    rect->moveTop(0);
+    rect->setHeight(result.naturalHeight);
+
+    if (lineCount != 1) {
+        lineCount = 1;
+        emit q->lineCountChanged();
+    }
+    if (truncated != wasTruncated)
+        emit q->truncatedChanged();
+
+    return true;
+}
+
+/*
+    Returns true if the text is long enough to be worth laying out in a worker thread and its
+    layout does not depend on anything that can only be resolved in the GUI thread.
+*/
+bool QQuickTextPrivate::canLayoutAsynchronously(const QString &layoutText)
+{
+    return asynchronous
+            && layoutText.length() >= QML_TEXT_ASYNC_LAYOUT_THRESHOLD
+            && !styledText
+            && elideMode == QQuickText::ElideNone
+            && fontSizeMode() == QQuickText::FixedSize
+            && !maximumLineCountValid
+            && multilengthEos == -1
+            && layout.additionalFormats().isEmpty()
+            && !isLineLaidOutConnected()
+            && QFontDatabase::supportsThreadedFontRendering();
+}
+
+/*
+    Starts laying out the text in a worker thread unless the same text is already being or has
+    been laid out with the same options.  The text stays empty until the first block arrives in
+    updateAsyncTextLayout().
+*/
+void QQuickTextPrivate::setupAsyncTextLayout(const QString &layoutText)
+{
+    Q_Q(QQuickText);
+
+    const Qt::Alignment alignment = Qt::Alignment(q->effectiveHAlign());
+    const QTextOption::WrapMode textWrapMode = QTextOption::WrapMode(wrapMode);
+    const bool designMetrics = renderType != QQuickText::NativeRendering;
+    const qreal width = q->widthValid() && q->width() > 0 ? q->width() : FLT_MAX;
+
+    if (asyncLayout && asyncLayout->matches(layoutText, font, alignment, textWrapMode,
+                                            designMetrics, width, lineHeight(), lineHeightMode())) {
+        return;
+    }
+
+    clearAsyncTextLayout();
+    sharedLayout.clear();
+    delete elideLayout;
+    elideLayout = 0;
+    layout.clearLayout();
+
+    // Wrapped text is laid out again whenever the width changes, the height never matters.
+    widthExceeded = wrapMode != QQuickText::NoWrap;
+    heightExceeded = false;
+    lineWidth = width != FLT_MAX ? width : 0;
+
+    asyncLayout = QSharedPointer<QQuickTextAsyncLayout>(new QQuickTextAsyncLayout(
+            q, layoutText, font, alignment, textWrapMode, designMetrics,
+            width, lineHeight(), lineHeightMode()));
+    QThreadPool::globalInstance()->start(new TextLayoutRunnable(asyncLayout));
+
+    if (truncated) {
+        truncated = false;
+        emit q->truncatedChanged();
+    }
+    if (lineCount != 0) {
+        lineCount = 0;
+        emit q->lineCountChanged();
+    }
+    if (!layedOutTextRect.isNull()) {
+        layedOutTextRect = QRectF();
+        emit q->contentSizeChanged();
+    }
+    updateType = UpdatePaintNode;
+    q->update();
+}
+
+/*
+    Appends the blocks laid out by the worker thread since the last call.  The implicit size
+    is only set once all of the text has been laid out.
+*/
+void QQuickTextPrivate::updateAsyncTextLayout()
+{
+    Q_Q(QQuickText);
+    if (!asyncLayout)
+        return;
+
+    bool finished = false;
+    const QVector<LayoutBlock> blocks = asyncLayout->takeBlocks(&finished);
+    if (blocks.isEmpty() && !finished)
+        return;
+
+    const int previousLineCount = lineCount;
+    const QSizeF previousSize = layedOutTextRect.size();
+
+    qreal height = layedOutTextRect.height();
+    foreach (LayoutBlock block, blocks) {
+        block.y = height;
+        block.rect.translate(0, height);
+        height += block.height;
+        layedOutTextRect = layedOutTextRect.united(block.rect);
+        lineCount += block.lineCount;
+        layoutBlocks.append(block);
+    }
+
+    qreal naturalWidth = 0;
+    foreach (const LayoutBlock &block, layoutBlocks)
+        naturalWidth = qMax(naturalWidth, block.naturalWidth);
+    if (asyncLayout->lineWidth == FLT_MAX)
+        lineWidth = naturalWidth;
+
+    if (finished) {
+        if (asyncLayout->lineWidth == FLT_MAX && asyncLayout->alignment != Qt::AlignLeft) {
+            // Align the lines now that the widest line is known.  The shaped text is cached
+            // in the layouts, so this only breaks the lines again.
+            layedOutTextRect = QRectF();
+            for (int i = 0; i < layoutBlocks.count(); ++i) {
+                LayoutBlock &block = layoutBlocks[i];
+                QTextOption option = block.layout->textOption();
+                option.setAlignment(asyncLayout->alignment);
+                block.layout->setTextOption(option);
+                QQuickTextAsyncLayout::layoutLines(block.layout.data(), &block, lineWidth,
+                                                   asyncLayout->lineHeight, asyncLayout->lineHeightMode);
+                block.rect.translate(0, block.y);
+                layedOutTextRect = layedOutTextRect.united(block.rect);
+            }
+        }
+
+        bool wasInLayout = internalWidthUpdate;
+        internalWidthUpdate = true;
+        q->setImplicitSize(naturalWidth, height);
+        internalWidthUpdate = wasInLayout;
+        implicitWidthValid = true;
+        implicitHeightValid = true;
+    }
+
+    if (!layoutBlocks.isEmpty())
+        updateBaseline(layoutBlocks.first().baseline, q->height() - height);
+
+    if (lineCount != previousLineCount)
+        emit q->lineCountChanged();
+    if (layedOutTextRect.size() != previousSize)
+        emit q->contentSizeChanged();
+    updateType = UpdatePaintNode;
+    q->update();
+}
+
+void QQuickTextPrivate::clearAsyncTextLayout()
+{
+    if (asyncLayout) {
+        asyncLayout->cancel();
+        asyncLayout.clear();
+    }
+    layoutBlocks.clear();
+}
+
 void QQuickTextPrivate::setLineGeometry(QTextLine &line, qreal lineWidth, qreal &height)
 {
     Q_Q(QQuickText);
@@ -1239,6 +1776,10 @@ QQuickText::QQuickText(QQuickItem *parent)
 
 QQuickText::~QQuickText()
 {
+    Q_D(QQuickText);
+    // The layout thread posts to this object, so it has to be stopped while the object is
+    // still whole. cancel() waits for a notification that is being posted.
+    d->clearAsyncTextLayout();
 }
 
 /*!
@@ -2211,6 +2752,12 @@ QSGNode *QQuickText::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data
         const qreal dx = QQuickTextUtil::alignedX(d->layedOutTextRect.width(), width(), effectiveHAlign());
         d->ensureDoc();
         node->addTextDocument(QPointF(dx, dy), d->extra->doc, color, d->style, styleColor, linkColor);
+    } else if (!d->layoutBlocks.isEmpty()) {
+        const qreal dx = QQuickTextUtil::alignedX(d->lineWidth, width(), effectiveHAlign());
+        foreach (const QQuickTextPrivate::LayoutBlock &block, d->layoutBlocks) {
+            node->addTextLayout(QPointF(dx, dy + block.y), block.layout.data(),
+                                color, d->style, styleColor, linkColor);
+        }
     } else if (d->layedOutTextRect.width() > 0) {
         const qreal dx = QQuickTextUtil::alignedX(d->lineWidth, width(), effectiveHAlign());
         int unelidedLineCount = d->lineCount;
@@ -2219,7 +2766,7 @@ QSGNode *QQuickText::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data
         if (unelidedLineCount > 0) {
             node->addTextLayout(
                         QPointF(dx, dy),
-                        &d->layout,
+                        d->currentLayout(),
                         color, d->style, styleColor, linkColor,
                         QColor(), QColor(), -1, -1,
                         0, unelidedLineCount);
@@ -2483,7 +3030,7 @@ QString QQuickTextPrivate::anchorAt(const QPointF &mousePos) const
     QPointF translatedMousePos = mousePos;
     translatedMousePos.ry() -= QQuickTextUtil::alignedY(layedOutTextRect.height(), q->height(), vAlign);
     if (styledText) {
-        QString link = anchorAt(&layout, translatedMousePos);
+        QString link = anchorAt(currentLayout(), translatedMousePos);
         if (link.isEmpty() && elideLayout)
             link = anchorAt(elideLayout, translatedMousePos);
         return link;
@@ -2659,6 +3206,42 @@ void QQuickText::setRenderType(QQuickText::RenderType renderType)
         d->updateLayout();
 }
 
+/*!
+    \qmlproperty bool QtQuick::Text::asynchronous
+
+    Specifies that long plain text should be laid out in a separate thread.  The default
+    value is false.
+
+    Laying out a large amount of text, such as the contents of a log file, can block the user
+    interface for a noticeable amount of time.  When this property is true, plain text of more
+    than a few thousand characters is laid out in a worker thread instead, and shown block by
+    block as the layout progresses.  The \l implicitWidth and \l implicitHeight of the item
+    are updated once all of the text has been laid out, while \l contentWidth,
+    \l contentHeight and \l lineCount grow with the shown text.
+
+    Styled and rich text, elided text, text with a \l maximumLineCount or \l fontSizeMode
+    and text with a handler for \l lineLaidOut are always laid out synchronously, as is all
+    text on platforms that do not support rendering fonts outside of the GUI thread.
+*/
+bool QQuickText::asynchronous() const
+{
+    Q_D(const QQuickText);
+    return d->asynchronous;
+}
+
+void QQuickText::setAsynchronous(bool asynchronous)
+{
+    Q_D(QQuickText);
+    if (d->asynchronous == asynchronous)
+        return;
+
+    d->asynchronous = asynchronous;
+    emit asynchronousChanged();
+
+    if (isComponentComplete())
+        d->updateSize();
+}
+
 /*!
     \qmlmethod QtQuick::Text::doLayout()
 
@@ -59,6 +59,8 @@
 #include <QtQml/qqml.h>
 #include <QtGui/qabstracttextdocumentlayout.h>
 #include <QtGui/qtextlayout.h>
+#include <QtCore/qsharedpointer.h>
+#include <QtCore/qvector.h>
 #include <private/qquickstyledtext_p.h>
 #include <private/qlazilyallocated_p.h>
 
@@ -66,6 +68,7 @@ QT_BEGIN_NAMESPACE
 
 class QTextLayout;
 class QQuickTextDocumentWithImageResources;
+class QQuickTextAsyncLayout;
 
 class Q_AUTOTEST_EXPORT QQuickTextPrivate : public QQuickImplicitSizeItemPrivate
 {
@@ -83,6 +86,12 @@ public:
     void mirrorChange();
     bool isLineLaidOutConnected();
     void setLineGeometry(QTextLine &line, qreal lineWidth, qreal &height);
+    bool canShareTextLayout(const QString &layoutText);
+    bool setupSharedTextLayout(const QString &layoutText, qreal *const baseline, QRectF *rect);
+    bool canLayoutAsynchronously(const QString &layoutText);
+    void setupAsyncTextLayout(const QString &layoutText);
+    void updateAsyncTextLayout();
+    void clearAsyncTextLayout();
 
     QString elidedText(qreal lineWidth, const QTextLine &line, QTextLine *nextLine = 0) const;
     void elideFormats(int start, int length, int offset, QList<QTextLayout::FormatRange> *elidedFormats);
@@ -116,8 +125,24 @@ public:
 
     QTextLayout layout;
     QTextLayout *elideLayout;
+    QSharedPointer<QTextLayout> sharedLayout;   // replaces layout where set
+
+    QTextLayout *currentLayout() { return sharedLayout ? sharedLayout.data() : &layout; }
+    const QTextLayout *currentLayout() const { return sharedLayout ? sharedLayout.data() : &layout; }
     QQuickTextLine *textLine;
 
+    struct LayoutBlock {
+        QSharedPointer<QTextLayout> layout;
+        QRectF rect;
+        qreal y;
+        qreal height;
+        qreal naturalWidth;
+        qreal baseline;
+        int lineCount;
+    };
+    QSharedPointer<QQuickTextAsyncLayout> asyncLayout;
+    QVector<LayoutBlock> layoutBlocks;          // replaces layout where set
+
     qreal lineWidth;
 
     QRgb color;
@@ -159,6 +184,7 @@ public:
     bool textHasChanged:1;
     bool needToUpdateLayout:1;
     bool formatModifiesFontSize:1;
+    bool asynchronous:1;
 
     static const QChar elideChar;
 
@@ -48,6 +48,7 @@
 #include "qquicktextnode_p.h"
 #include "qquicktextnodeengine_p.h"
 #include "qquicktextutil_p.h"
+#include "qquickflickable_p.h"
 #include <QtQuick/qsgsimplerectnode.h>
 
 #include <QtQml/qqmlinfo.h>
@@ -1267,6 +1268,8 @@ void QQuickTextEdit::geometryChanged(const QRectF &newGeometry,
         updateSize();
         updateWholeDocument();
         moveCursorDelegate();
+    } else if (clip() && newGeometry.size() != oldGeometry.size()) {
+        q_viewportChanged();
     }
     QQuickImplicitSizeItem::geometryChanged(newGeometry, oldGeometry);
 
@@ -1281,6 +1284,7 @@ void QQuickTextEdit::componentComplete()
     Q_D(QQuickTextEdit);
     QQuickImplicitSizeItem::componentComplete();
 
+    d->updateFlickable();
     d->document->setBaseUrl(baseUrl(), d->richText);
 #ifndef QT_NO_TEXTHTML_PARSER
     if (d->richText)
@@ -1777,6 +1781,23 @@ QSGNode *QQuickTextEdit::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *
     while (nodeIterator != d->textNodeMap.end() && !(*nodeIterator)->dirty())
         ++nodeIterator;
 
+    QRectF viewport;
+    const bool virtualised = d->viewport(&viewport);
+    if ((virtualised || !d->renderedRegion.isNull()) && nodeIterator != d->textNodeMap.end()) {
+        // Nodes outside of the rendered region have no content, if the changed blocks move the
+        // nodes after them some of those could come into view.  Create them all again instead.
+        TextNodeIterator cleanIterator = nodeIterator;
+        while (cleanIterator != d->textNodeMap.end() && (*cleanIterator)->dirty())
+            ++cleanIterator;
+        if (!virtualised || (cleanIterator != d->textNodeMap.end()
+                && (*cleanIterator)->textNode()->matrix().map(QPointF(0, 0))
+                    != d->document->documentLayout()->blockBoundingRect(
+                        d->document->findBlock((*cleanIterator)->startPos())).topLeft())) {
+            Q_FOREACH (TextNode *node, d->textNodeMap)
+                node->setDirty();
+            nodeIterator = d->textNodeMap.begin();
+        }
+    }
 
     if (!oldNode || nodeIterator < d->textNodeMap.end()) {
 
@@ -1794,6 +1815,14 @@ QSGNode *QQuickTextEdit::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *
             } while (nodeIterator != d->textNodeMap.end() && (*nodeIterator)->dirty());
         }
 
+        // Only create the nodes of blocks which are in view or close to it when all nodes are
+        // created again, partial updates keep to the region of the other nodes.
+        if (d->textNodeMap.isEmpty()) {
+            d->renderedRegion = virtualised
+                    ? viewport.adjusted(-viewport.width(), -viewport.height(), viewport.width(), viewport.height())
+                    : QRectF();
+        }
+
         // FIXME: the text decorations could probably be handled separately (only updated for affected textFrames)
         rootNode->resetFrameDecorations(d->createTextNode());
 
@@ -1844,6 +1873,9 @@ QSGNode *QQuickTextEdit::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *
                     frameBoundaries.append(frame->firstPosition());
                 std::sort(frameBoundaries.begin(), frameBoundaries.end());
 
+                // Consecutive blocks outside of the rendered region share one empty placeholder
+                // node, so that edits within them still mark a node dirty.
+                bool placeholder = false;
                 QTextFrame::iterator it = textFrame->begin();
                 while (!it.atEnd()) {
                     QTextBlock block = it.currentBlock();
@@ -1851,20 +1883,39 @@ QSGNode *QQuickTextEdit::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *
                     if (block.position() < firstDirtyPos)
                         continue;
 
-                    if (!node->m_engine->hasContents()) {
-                        nodeOffset = d->document->documentLayout()->blockBoundingRect(block).topLeft();
-                        updateNodeTransform(node, nodeOffset);
-                        nodeStart = block.position();
+                    const QRectF blockRect = d->document->documentLayout()->blockBoundingRect(block);
+                    if (!d->renderedRegion.isNull() && !d->renderedRegion.intersects(blockRect.translated(basePosition))) {
+                        if (!placeholder && !node->m_engine->hasContents()) {
+                            placeholder = true;
+                            updateNodeTransform(node, blockRect.topLeft());
+                            nodeStart = block.position();
+                        }
+                    } else {
+                        if (placeholder) {
+                            placeholder = false;
+                            currentNodeSize = 0;
+                            d->addCurrentTextNodeToRoot(rootNode, node, nodeIterator, nodeStart);
+                            node = d->createTextNode();
+                        }
+                        if (!node->m_engine->hasContents()) {
+                            nodeOffset = blockRect.topLeft();
+                            updateNodeTransform(node, nodeOffset);
+                            nodeStart = block.position();
+                        }
+
+                        node->m_engine->addTextBlock(d->document, block, basePosition - nodeOffset, d->color, QColor(), selectionStart(), selectionEnd() - 1);
+                        currentNodeSize += block.length();
                     }
 
-                    node->m_engine->addTextBlock(d->document, block, basePosition - nodeOffset, d->color, QColor(), selectionStart(), selectionEnd() - 1);
-                    currentNodeSize += block.length();
-
                     if ((it.atEnd()) || (firstCleanNode && block.next().position() >= firstCleanNode->startPos())) // last node that needed replacing or last block of the frame
                         break;
 
                     QList<int>::const_iterator lowerBound = std::lower_bound(frameBoundaries.constBegin(), frameBoundaries.constEnd(), block.next().position());
-                    if (currentNodeSize > nodeBreakingSize || lowerBound == frameBoundaries.constEnd() || *lowerBound > nodeStart) {
+                    const bool breakNode = placeholder
+                            ? lowerBound != frameBoundaries.constEnd() && *lowerBound == block.next().position()
+                            : currentNodeSize > nodeBreakingSize || lowerBound == frameBoundaries.constEnd() || *lowerBound > nodeStart;
+                    if (breakNode) {
+                        placeholder = false;
                         currentNodeSize = 0;
                         d->addCurrentTextNodeToRoot(rootNode, node, nodeIterator, nodeStart);
                         node = d->createTextNode();
@@ -2359,6 +2410,68 @@ void QQuickTextEditPrivate::handleFocusEvent(QFocusEvent *event)
     }
 }
 
+/*
+    Finds the closest Flickable the text edit is in, when flicking it changes the part of the
+    document which is visible.
+*/
+void QQuickTextEditPrivate::updateFlickable()
+{
+    Q_Q(QQuickTextEdit);
+    QQuickFlickable *ancestor = 0;
+    for (QQuickItem *item = q->parentItem(); item && !ancestor; item = item->parentItem())
+        ancestor = qobject_cast<QQuickFlickable *>(item);
+    if (ancestor == flickable)
+        return;
+
+    if (flickable)
+        QObject::disconnect(flickable, 0, q, SLOT(q_viewportChanged()));
+    flickable = ancestor;
+    if (flickable) {
+        qmlobject_connect(flickable, QQuickFlickable, SIGNAL(contentXChanged()), q, QQuickTextEdit, SLOT(q_viewportChanged()));
+        qmlobject_connect(flickable, QQuickFlickable, SIGNAL(contentYChanged()), q, QQuickTextEdit, SLOT(q_viewportChanged()));
+        qmlobject_connect(flickable, QQuickFlickable, SIGNAL(widthChanged()), q, QQuickTextEdit, SLOT(q_viewportChanged()));
+        qmlobject_connect(flickable, QQuickFlickable, SIGNAL(heightChanged()), q, QQuickTextEdit, SLOT(q_viewportChanged()));
+    }
+    q->q_viewportChanged();
+}
+
+/*
+    Sets \a rect to the part of the text edit which can be visible, the area of its Flickable
+    and its own area if it clips, and returns true.  Returns false if all of it may be visible.
+*/
+bool QQuickTextEditPrivate::viewport(QRectF *rect) const
+{
+    Q_Q(const QQuickTextEdit);
+    if (!flickable && !q->clip())
+        return false;
+
+    if (flickable)
+        *rect = flickable->mapRectToItem(q, flickable->boundingRect());
+    if (q->clip())
+        *rect = flickable ? rect->intersected(q->clipRect()) : q->clipRect();
+    return true;
+}
+
+void QQuickTextEdit::q_viewportChanged()
+{
+    Q_D(QQuickTextEdit);
+    QRectF viewport;
+    if (d->viewport(&viewport)
+            ? viewport.isEmpty() || d->renderedRegion.contains(viewport)
+            : d->renderedRegion.isNull()) {
+        return;
+    }
+    updateWholeDocument();
+}
+
+void QQuickTextEdit::itemChange(ItemChange change, const ItemChangeData &value)
+{
+    Q_D(QQuickTextEdit);
+    if (change == ItemParentHasChanged && isComponentComplete())
+        d->updateFlickable();
+    QQuickImplicitSizeItem::itemChange(change, value);
+}
+
 void QQuickTextEditPrivate::addCurrentTextNodeToRoot(QSGTransformNode *root, QQuickTextNode *node, TextNodeIterator &it, int startPos)
 {
     node->m_engine->addToSceneGraph(node, QQuickText::Normal, QColor());
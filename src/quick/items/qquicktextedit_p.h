@@ -328,6 +328,7 @@ private Q_SLOTS:
     void q_updateAlignment();
     void updateSize();
     void triggerPreprocess();
+    void q_viewportChanged();
 
 private:
     void markDirtyNodesForRange(int start, int end, int charDelta);
@@ -336,6 +337,7 @@ private:
 protected:
     virtual void geometryChanged(const QRectF &newGeometry,
                                  const QRectF &oldGeometry);
+    void itemChange(ItemChange change, const ItemChangeData &value);
 
     bool event(QEvent *);
     void keyPressEvent(QKeyEvent *);
@@ -59,6 +59,7 @@
 
 #include <QtQml/qqml.h>
 #include <QtCore/qlist.h>
+#include <QtCore/qpointer.h>
 
 QT_BEGIN_NAMESPACE
 class QTextLayout;
@@ -66,6 +67,7 @@ class QQuickTextDocumentWithImageResources;
 class QQuickTextControl;
 class QQuickTextNode;
 class QSGSimpleRectNode;
+class QQuickFlickable;
 class QQuickTextEditPrivate : public QQuickImplicitSizeItemPrivate
 {
 public:
@@ -129,6 +131,8 @@ public:
     void handleFocusEvent(QFocusEvent *event);
     void addCurrentTextNodeToRoot(QSGTransformNode *, QQuickTextNode*, TextNodeIterator&, int startPos);
     QQuickTextNode* createTextNode();
+    void updateFlickable();
+    bool viewport(QRectF *rect) const;
 
 #ifndef QT_NO_IM
     Qt::InputMethodHints effectiveInputMethodHints() const;
@@ -155,6 +159,8 @@ public:
     QQuickTextControl *control;
     QQuickTextDocument *quickDocument;
     QList<Node*> textNodeMap;
+    QPointer<QQuickFlickable> flickable;
+    QRectF renderedRegion;   // text nodes are only created inside, unless null
 
     int lastSelectionStart;
     int lastSelectionEnd;
@@ -1126,6 +1126,7 @@ void QQuickTextInput::setValidator(QValidator* v)
     }
 
     d->m_validator = v;
+    d->invalidateValidation();
 
     if (d->m_validator) {
         qmlobject_connect(
@@ -1142,9 +1143,37 @@ void QQuickTextInput::setValidator(QValidator* v)
 void QQuickTextInput::q_validatorChanged()
 {
     Q_D(QQuickTextInput);
+    d->invalidateValidation();
     d->checkIsValid();
 }
 
+/*!
+    \internal
+
+    Runs the validator on \a text, unless the same text and \a cursor were
+    validated last, in which case the previous outcome is returned. Finishing
+    an edit, checking for acceptable input and fixing up the text all validate
+    the same string in turn, and a validator that modifies the text causes
+    the result to be validated again.
+*/
+QValidator::State QQuickTextInputPrivate::validate(QString &text, int &cursor) const
+{
+    if (cursor == m_lastValidation.cursor && text == m_lastValidation.text) {
+        text = m_lastValidation.validatedText;
+        cursor = m_lastValidation.validatedCursor;
+        return m_lastValidation.state;
+    }
+
+    ValidationResult result;
+    result.text = text;
+    result.cursor = cursor;
+    result.state = m_validator->validate(text, cursor);
+    result.validatedText = text;
+    result.validatedCursor = cursor;
+    m_lastValidation = result;
+    return result.state;
+}
+
 #endif // QT_NO_VALIDATOR
 
 void QQuickTextInputPrivate::checkIsValid()
@@ -2747,14 +2776,23 @@ void QQuickTextInputPrivate::updateDisplayText(bool forceUpdate)
 
     // replace certain non-printable characters with spaces (to avoid
     // drawing boxes when using fonts that don't have glyphs for such
-    // characters)
-    QChar* uc = str.data();
+    // characters). Only detach from m_text if there is something to replace.
+    const QChar *cuc = str.constData();
     for (int i = 0; i < (int)str.length(); ++i) {
-        if ((uc[i] < 0x20 && uc[i] != 0x09)
-            || uc[i] == QChar::LineSeparator
-            || uc[i] == QChar::ParagraphSeparator
-            || uc[i] == QChar::ObjectReplacementCharacter)
-            uc[i] = QChar(0x0020);
+        if ((cuc[i] < 0x20 && cuc[i] != 0x09)
+            || cuc[i] == QChar::LineSeparator
+            || cuc[i] == QChar::ParagraphSeparator
+            || cuc[i] == QChar::ObjectReplacementCharacter) {
+            QChar *uc = str.data();
+            for (; i < (int)str.length(); ++i) {
+                if ((uc[i] < 0x20 && uc[i] != 0x09)
+                    || uc[i] == QChar::LineSeparator
+                    || uc[i] == QChar::ParagraphSeparator
+                    || uc[i] == QChar::ObjectReplacementCharacter)
+                    uc[i] = QChar(0x0020);
+            }
+            break;
+        }
     }
 
     if (str != orig || forceUpdate) {
@@ -2819,8 +2857,10 @@ void QQuickTextInputPrivate::updateLayout()
     m_textLayout.beginLayout();
 
     QTextLine line = m_textLayout.createLine();
+    bool laidOutUnbounded = false;
     if (requireImplicitWidth) {
         line.setLineWidth(INT_MAX);
+        laidOutUnbounded = true;
         const bool wasInLayout = inLayout;
         inLayout = true;
         q->setImplicitWidth(qCeil(line.naturalTextWidth()));
@@ -2832,7 +2872,10 @@ void QQuickTextInputPrivate::updateLayout()
     qreal height = 0;
     qreal width = 0;
     do {
-        line.setLineWidth(lineWidth);
+        // don't lay out the first line a second time at the same width
+        if (!laidOutUnbounded || lineWidth != INT_MAX)
+            line.setLineWidth(lineWidth);
+        laidOutUnbounded = false;
         line.setPosition(QPointF(0, height));
 
         height += line.height();
@@ -3100,7 +3143,7 @@ bool QQuickTextInputPrivate::fixup() // this function assumes that validate curr
         QString textCopy = m_text;
         int cursorCopy = m_cursor;
         m_validator->fixup(textCopy);
-        if (m_validator->validate(textCopy, cursorCopy) == QValidator::Acceptable) {
+        if (validate(textCopy, cursorCopy) == QValidator::Acceptable) {
             if (textCopy != m_text || cursorCopy != m_cursor)
                 internalSetText(textCopy, cursorCopy);
             return true;
@@ -3322,7 +3365,7 @@ bool QQuickTextInputPrivate::finishChange(int validateFromState, bool update, bo
         if (m_validator) {
             QString textCopy = m_text;
             int cursorCopy = m_cursor;
-            QValidator::State state = m_validator->validate(textCopy, cursorCopy);
+            QValidator::State state = validate(textCopy, cursorCopy);
             m_validInput = state != QValidator::Invalid;
             m_acceptableInput = state == QValidator::Acceptable;
             if (m_validInput) {
@@ -3779,7 +3822,7 @@ QQuickTextInputPrivate::ValidatorState QQuickTextInputPrivate::hasAcceptableInpu
     QString textCopy = str;
     int cursorCopy = m_cursor;
     if (m_validator) {
-        QValidator::State state = m_validator->validate(textCopy, cursorCopy);
+        QValidator::State state = validate(textCopy, cursorCopy);
         if (state != QValidator::Acceptable)
             return ValidatorState(state);
     }
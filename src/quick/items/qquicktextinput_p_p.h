@@ -192,6 +192,21 @@ public:
     QPointer<QQmlComponent> cursorComponent;
 #ifndef QT_NO_VALIDATOR
     QPointer<QValidator> m_validator;
+
+    // The outcome of the last validation, reused while the text, the cursor
+    // and the validator stay the same.
+    struct ValidationResult {
+        ValidationResult() : cursor(-1), validatedCursor(-1), state(QValidator::Invalid) {}
+        QString text;
+        int cursor;
+        QString validatedText;
+        int validatedCursor;
+        QValidator::State state;
+    };
+    mutable ValidationResult m_lastValidation;
+
+    QValidator::State validate(QString &text, int &cursor) const;
+    void invalidateValidation() { m_lastValidation = ValidationResult(); }
 #endif
 
     qreal hscroll;
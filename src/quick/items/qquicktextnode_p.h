@@ -43,6 +43,7 @@
 #define QQUICKTEXTNODE_P_H
 
 #include <QtQuick/qsgnode.h>
+#include <private/qsgblockpool_p.h>
 #include "qquicktext_p.h"
 #include <qglyphrun.h>
 
@@ -67,6 +68,7 @@ class QQuickTextNodeEngine;
 
 class QQuickTextNode : public QSGTransformNode
 {
+    QSG_DECLARE_POOLED_ALLOCATION
 public:
     enum Decoration {
         NoDecoration = 0x0,
@@ -45,8 +45,10 @@
 #include "qquickitem.h"
 #include "qquickitem_p.h"
 #include "qquickevents_p_p.h"
+#include "qquickrendercontrol_p.h"
 
 #include <private/qquickdrag_p.h>
+#include <private/qquickitemview_p_p.h>
 
 #include <QtQuick/private/qsgrenderer_p.h>
 #include <QtQuick/private/qsgtexture_p.h>
@@ -63,16 +65,27 @@
 #include <QtGui/qevent.h>
 #include <QtGui/qmatrix4x4.h>
 #include <QtGui/qstylehints.h>
+#include <QtGui/qscreen.h>
+#include <QtGui/qpa/qplatformnativeinterface.h>
 #include <QtCore/qvarlengtharray.h>
+#include <QtCore/qmath.h>
 #include <QtCore/qabstractanimation.h>
 #include <QtCore/QRunnable>
 #include <QtQml/qqmlincubator.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qvector.h>
+#include <private/qv8engine_p.h>
+#include <private/qqmlengine_p.h>
+#include <private/qv4mm_p.h>
 
 #include <QtQuick/private/qquickpixmapcache_p.h>
+#include <QtQuick/private/qquickprofiler_p.h>
 
 #include <private/qqmlprofilerservice_p.h>
 #include <private/qqmlmemoryprofiler_p.h>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 extern Q_GUI_EXPORT QImage qt_gl_read_framebuffer(const QSize &size, bool alpha_format, bool include_alpha);
@@ -100,10 +113,13 @@ public:
     QQuickWindowIncubationController(QSGRenderLoop *loop)
         : m_renderLoop(loop), m_timer(0)
     {
-        // Allow incubation for 1/3 of a frame.
-        m_incubation_time = qMax(1, int(1000 / QGuiApplication::primaryScreen()->refreshRate()) / 3);
+        m_frame_interval = qMax(1, int(1000 / QGuiApplication::primaryScreen()->refreshRate()));
+        // Without frame timings, allow incubation for 1/3 of a frame.
+        m_incubation_time = qMax(1, m_frame_interval / 3);
 
-        m_animation_driver = m_renderLoop->animationDriver();
+        // Windows driven by a QQuickRenderControl have no render loop and
+        // incubate on the timer alone.
+        m_animation_driver = m_renderLoop ? m_renderLoop->animationDriver() : 0;
         if (m_animation_driver) {
             connect(m_animation_driver, SIGNAL(stopped()), this, SLOT(animationStopped()));
             connect(m_renderLoop, SIGNAL(timeToIncubate()), this, SLOT(incubate()));
@@ -115,7 +131,7 @@ protected:
     {
         killTimer(m_timer);
         m_timer = 0;
-        incubate();
+        incubateWithin(m_incubation_time);
     }
 
     void incubateAgain() {
@@ -126,30 +142,54 @@ protected:
         }
     }
 
-public slots:
-    void incubate() {
+    // Fit the slice into what the GUI thread has left of the frame it just
+    // prepared, keeping a third of that in reserve for event delivery. Always
+    // allow one millisecond, so incubation progresses when frames run long.
+    bool interleaveIncubation() const { return m_renderLoop && m_renderLoop->interleaveIncubation(); }
+
+    int frameBudget() const
+    {
+        const int idle = m_frame_interval - m_renderLoop->lastFrameTime();
+        return qMax(1, idle * 2 / 3);
+    }
+
+    void incubateWithin(int msecs) {
+        QElapsedTimer timer;
+        timer.start();
         if (incubatingObjectCount()) {
-            if (m_renderLoop->interleaveIncubation()) {
-                incubateFor(m_incubation_time);
+            if (interleaveIncubation()) {
+                incubateFor(msecs);
             } else {
-                incubateFor(m_incubation_time * 2);
+                incubateFor(msecs * 2);
                 if (incubatingObjectCount())
                     incubateAgain();
             }
         }
+
+        // Hand what's left of the slot to the garbage collector, so that collections happen
+        // between frames rather than in the middle of an animation tick.
+        const int remaining = msecs - int(timer.elapsed());
+        if (remaining > 0 && engine())
+            QV8Engine::getV4(engine())->memoryManager->runGCWithin(remaining);
+    }
+
+public slots:
+    void incubate() {
+        incubateWithin(interleaveIncubation() ? frameBudget() : m_incubation_time);
     }
 
-    void animationStopped() { incubate(); }
+    void animationStopped() { incubateWithin(m_incubation_time); }
 
 protected:
     virtual void incubatingObjectCountChanged(int count)
     {
-        if (count && !m_renderLoop->interleaveIncubation())
+        if (count && !interleaveIncubation())
             incubateAgain();
     }
 
 private:
     QSGRenderLoop *m_renderLoop;
+    int m_frame_interval;
     int m_incubation_time;
     QAnimationDriver *m_animation_driver;
     int m_timer;
@@ -256,25 +296,97 @@ void QQuickWindow::focusInEvent(QFocusEvent *ev)
 }
 
 
+// Children are polished before their parents by default, set QML_POLISH_PARENTS_FIRST to reverse.
+static bool qquickwindow_polish_parents_first = qEnvironmentVariableIsSet("QML_POLISH_PARENTS_FIRST");
+// Time in milliseconds after which the remaining polish passes are left for the next frame.
+static int qquickwindow_polish_budget = qgetenv("QML_POLISH_BUDGET").toInt();
+
+static bool deeperItemFirst(const QPair<int, QQuickItem *> &a, const QPair<int, QQuickItem *> &b)
+{
+    return a.first > b.first;
+}
+
+static bool shallowerItemFirst(const QPair<int, QQuickItem *> &a, const QPair<int, QQuickItem *> &b)
+{
+    return a.first < b.first;
+}
+
 void QQuickWindowPrivate::polishItems()
 {
+    Q_Q(QQuickWindow);
     int maxPolishCycles = 100000;
+    int iterations = 0;
 
-    while (!itemsToPolish.isEmpty() && --maxPolishCycles > 0) {
-        QSet<QQuickItem *> itms = itemsToPolish;
-        itemsToPolish.clear();
+    QElapsedTimer budgetTimer;
+    if (qquickwindow_polish_budget > 0)
+        budgetTimer.start();
+
+    // Polish time and number of polished items per item type, only collected when profiling
+    QHash<const QMetaObject *, QPair<int, qint64> > polishStatistics;
+    QElapsedTimer polishTimer;
+    const qint64 polishStart = frameTimer.nsecsElapsed();
 
-        for (QSet<QQuickItem *>::iterator it = itms.begin(); it != itms.end(); ++it) {
-            QQuickItem *item = *it;
+    // Bring deferred bindings up to date, so that items are polished only once
+    QQmlEnginePrivate::flushDeferredBindingUpdatesForThread();
+
+    QVector<QPair<int, QQuickItem *> > itms;
+    while (!itemsToPolish.isEmpty() && --maxPolishCycles > 0) {
+        // Polish children before their parents. Positioners and layouts then see the final
+        // implicit sizes of their children, and a parent that gets polished again by one of
+        // its children is still pending in this round, so it lays out only once.
+        itms.clear();
+        itms.reserve(itemsToPolish.count());
+        for (QSet<QQuickItem *>::const_iterator it = itemsToPolish.constBegin();
+             it != itemsToPolish.constEnd(); ++it) {
+            int depth = 0;
+            for (QQuickItem *parent = (*it)->parentItem(); parent; parent = parent->parentItem())
+                ++depth;
+            itms.append(qMakePair(depth, *it));
+        }
+        std::sort(itms.begin(), itms.end(),
+                  qquickwindow_polish_parents_first ? shallowerItemFirst : deeperItemFirst);
+        ++iterations;
+
+        // The set stays populated during the pass, so that an item which is removed from the
+        // window or deleted by another item's updatePolish() is dropped from it and skipped here.
+        for (int i = 0; i < itms.count(); ++i) {
+            QQuickItem *item = itms.at(i).second;
+            if (!itemsToPolish.remove(item))
+                continue;
             QQuickItemPrivate::get(item)->polishScheduled = false;
-            item->updatePolish();
+            if (QQuickProfiler::enabled) {
+                polishTimer.start();
+                item->updatePolish();
+                QPair<int, qint64> &statistics = polishStatistics[item->metaObject()];
+                ++statistics.first;
+                statistics.second += polishTimer.nsecsElapsed();
+            } else {
+                item->updatePolish();
+            }
+        }
+
+        QQmlEnginePrivate::flushDeferredBindingUpdatesForThread();
+
+        if (budgetTimer.isValid() && !itemsToPolish.isEmpty()
+                && budgetTimer.elapsed() >= qquickwindow_polish_budget) {
+            q->maybeUpdate();
+            break;
         }
     }
 
     if (maxPolishCycles == 0)
         qWarning("QQuickWindow: possible QQuickItem::polish() loop");
 
+    for (QHash<const QMetaObject *, QPair<int, qint64> >::const_iterator it = polishStatistics.constBegin();
+         it != polishStatistics.constEnd(); ++it) {
+        Q_QUICK_PROFILE(polishedItems(QString::fromUtf8(it.key()->className()), it.value().first,
+                                      it.value().second, iterations));
+    }
+
     updateFocusItemTransform();
+
+    if (iterations > 0)
+        frameStatistics.addTime(QQuickFrameStatistics::Polish, frameTimer.nsecsElapsed() - polishStart);
 }
 
 /*!
@@ -289,6 +401,8 @@ void QQuickWindow::update()
     Q_D(QQuickWindow);
     if (d->windowManager)
         d->windowManager->update(this);
+    else if (d->renderControl)
+        QQuickRenderControlPrivate::get(d->renderControl)->update(this);
 }
 
 void forcePolishHelper(QQuickItem *item)
@@ -329,6 +443,15 @@ void QQuickWindowPrivate::syncSceneGraph()
     QML_MEMORY_SCOPE_STRING("SceneGraph");
     Q_Q(QQuickWindow);
 
+    // Frames which start within a vsync of the previous swap are meant to
+    // follow it directly, so the time past that is missed vsyncs.
+    const qint64 syncStart = frameTimer.nsecsElapsed();
+    continuousFrame = lastSwapTime >= 0 && syncStart - lastSwapTime < vsyncInterval;
+    if (QScreen *screen = q->screen()) {
+        if (screen->refreshRate() > 1)
+            vsyncInterval = qint64(1000000000 / screen->refreshRate());
+    }
+
     animationController->beforeNodeSync();
 
     emit q->beforeSynchronizing();
@@ -356,13 +479,152 @@ void QQuickWindowPrivate::syncSceneGraph()
     renderer->setCustomRenderMode(customRenderMode);
     runAndClearJobs(&afterSynchronizingJobs);
     context->endSync();
+
+    frameStatistics.addTime(QQuickFrameStatistics::Sync, frameTimer.nsecsElapsed() - syncStart);
+}
+
+
+#ifndef EGL_EXTENSIONS
+#define EGL_EXTENSIONS 0x3055
+#endif
+#ifndef EGL_DRAW
+#define EGL_DRAW 0x3059
+#endif
+#ifndef EGL_BUFFER_AGE_EXT
+#define EGL_BUFFER_AGE_EXT 0x313D
+#endif
+
+static bool qquickwindow_no_partial_update = qEnvironmentVariableIsSet("QSG_NO_PARTIAL_UPDATE");
+
+/*
+    Queries how many frames ago the back buffer of the window surface was
+    rendered, through EGL_EXT_buffer_age. Only contexts which the platform
+    reports as EGL contexts are trusted with the EGL entry points.
+
+    Buffers are swapped by the platform plugin, so the damage cannot be
+    passed on with EGL_KHR_swap_buffers_with_damage.
+ */
+class QQuickWindowBufferAge
+{
+public:
+    explicit QQuickWindowBufferAge(QOpenGLContext *context);
+
+    bool isValid() const { return querySurface != 0; }
+    int age() const;
+
+private:
+    typedef const char *(QOPENGLF_APIENTRYP QueryString)(void *display, int name);
+    typedef void *(QOPENGLF_APIENTRYP GetCurrentSurface)(int readdraw);
+    typedef unsigned int (QOPENGLF_APIENTRYP QuerySurface)(void *display, void *surface, int attribute, int *value);
+
+    void *display;
+    GetCurrentSurface getCurrentSurface;
+    QuerySurface querySurface;
+};
+
+QQuickWindowBufferAge::QQuickWindowBufferAge(QOpenGLContext *context)
+    : display(0)
+    , getCurrentSurface(0)
+    , querySurface(0)
+{
+    QPlatformNativeInterface *native = QGuiApplication::platformNativeInterface();
+    if (!context || !native || !native->nativeResourceForContext("eglcontext", context))
+        return;
+    display = native->nativeResourceForContext("egldisplay", context);
+    if (!display)
+        display = native->nativeResourceForIntegration("egldisplay");
+    QueryString queryString = reinterpret_cast<QueryString>(context->getProcAddress("eglQueryString"));
+    if (!display || !queryString)
+        return;
+    QList<QByteArray> extensions = QByteArray(queryString(display, EGL_EXTENSIONS)).split(' ');
+    if (!extensions.contains("EGL_EXT_buffer_age"))
+        return;
+    getCurrentSurface = reinterpret_cast<GetCurrentSurface>(context->getProcAddress("eglGetCurrentSurface"));
+    if (getCurrentSurface)
+        querySurface = reinterpret_cast<QuerySurface>(context->getProcAddress("eglQuerySurface"));
+}
+
+/*
+    Returns the age of the current back buffer, or 0 if its contents are
+    undefined.
+ */
+int QQuickWindowBufferAge::age() const
+{
+    void *surface = getCurrentSurface(EGL_DRAW);
+    int age = 0;
+    if (!surface || !querySurface(display, surface, EGL_BUFFER_AGE_EXT, &age))
+        return 0;
+    return age;
 }
 
+/*
+    Returns the part of the window, in framebuffer coordinates, which needs
+    to be rendered for a frame of \a deviceSize pixels, or an invalid rect if
+    all of it does. The back buffer still holds the frame from a few swaps ago,
+    so only the area damaged in the frames since then is rendered again.
+ */
+QRect QQuickWindowPrivate::partialUpdateRect(const QSize &deviceSize)
+{
+    Q_Q(QQuickWindow);
+    if (qquickwindow_no_partial_update)
+        return QRect();
+    if (!bufferAge) {
+        bufferAge = new QQuickWindowBufferAge(context->openglContext());
+        renderer->setTrackChangedNodes(bufferAge->isValid());
+        damageTracker.reset();
+        damageHistory.clear();
+    }
+    if (!bufferAge->isValid())
+        return QRect();
+
+    const QRect fullRect(QPoint(), deviceSize);
+    QRectF changed;
+    bool bounded = damageTracker.update(renderer->rootNode(), renderer->takeChangedNodes(), &changed);
+
+    QRect damage = fullRect;
+    if (bounded && !damageHistory.isEmpty() && deviceSize == damageSize && clearColor == damageClearColor
+        && customRenderMode.isEmpty()) {
+        damage = QRect();
+        if (!changed.isEmpty()) {
+            // Leave room for antialiasing. GL has its origin at the bottom.
+            const int margin = 2;
+            const qreal dpr = q->devicePixelRatio();
+            int x1 = qFloor(changed.left() * dpr) - margin;
+            int x2 = qCeil(changed.right() * dpr) + margin;
+            int y1 = deviceSize.height() - qCeil(changed.bottom() * dpr) - margin;
+            int y2 = deviceSize.height() - qFloor(changed.top() * dpr) + margin;
+            damage = QRect(x1, y1, x2 - x1, y2 - y1) & fullRect;
+        }
+    }
+    damageSize = deviceSize;
+    damageClearColor = clearColor;
+    damageHistory.prepend(damage);
+    if (damageHistory.size() > MaximumBufferAge)
+        damageHistory.resize(MaximumBufferAge);
+
+    // Custom OpenGL drawing may touch any part of the window.
+    if (q->isSignalConnected(QMetaMethod::fromSignal(&QQuickWindow::beforeRendering))
+        || q->isSignalConnected(QMetaMethod::fromSignal(&QQuickWindow::afterRendering)))
+        return QRect();
+
+    int age = bufferAge->age();
+    if (age < 1 || age > damageHistory.size())
+        return QRect();
+    QRect rect;
+    for (int i = 0; i < age; ++i)
+        rect |= damageHistory.at(i);
+    // Frames are only rendered when something changed, so an empty rect is
+    // rare and not worth special casing.
+    if (rect.isEmpty() || rect == fullRect)
+        return QRect();
+    return rect;
+}
 
 void QQuickWindowPrivate::renderSceneGraph(const QSize &size)
 {
     QML_MEMORY_SCOPE_STRING("SceneGraph");
     Q_Q(QQuickWindow);
+    const qint64 renderStart = frameTimer.nsecsElapsed();
     animationController->advance();
     emit q->beforeRendering();
     runAndClearJobs(&beforeRenderingJobs);
@@ -379,11 +641,50 @@ void QQuickWindowPrivate::renderSceneGraph(const QSize &size)
         renderer->setProjectionMatrixToRect(QRect(QPoint(0, 0), size));
         renderer->setDevicePixelRatio(q->devicePixelRatio());
 
+        QRect scissorRect;
+        if (!renderTargetId)
+            scissorRect = partialUpdateRect(size * devicePixelRatio);
+        renderer->setScissorRect(scissorRect);
+
         context->renderNextFrame(renderer, fboId);
+
+        if (scissorRect.isValid())
+            glDisable(GL_SCISSOR_TEST);
     }
 
     emit q->afterRendering();
     runAndClearJobs(&afterRenderingJobs);
+
+    renderEndTime = frameTimer.nsecsElapsed();
+    frameStatistics.addTime(QQuickFrameStatistics::Render, renderEndTime - renderStart);
+}
+
+/*
+    Records the swap time and the renderer counters of the frame which was
+    just swapped.
+ */
+void QQuickWindowPrivate::recordFrameSwapped()
+{
+    const qint64 now = frameTimer.nsecsElapsed();
+    if (renderEndTime >= 0)
+        frameStatistics.addTime(QQuickFrameStatistics::Swap, now - renderEndTime);
+
+    int missedVsyncs = 0;
+    if (continuousFrame && lastSwapTime >= 0)
+        missedVsyncs = qMax(0, qRound(double(now - lastSwapTime) / vsyncInterval) - 1);
+
+    qint64 counters[QQuickFrameStatistics::CounterCount] = { 0, 0, 0 };
+    if (renderer) {
+        const QSGRenderer::FrameStatistics &rendered = renderer->frameStatistics();
+        counters[QQuickFrameStatistics::Batches] = rendered.batches;
+        counters[QQuickFrameStatistics::DrawCalls] = rendered.drawCalls;
+        counters[QQuickFrameStatistics::UploadedBytes] = rendered.uploadedBytes;
+    }
+    frameStatistics.addFrame(counters, missedVsyncs);
+
+    lastSwapTime = now;
+    renderEndTime = -1;
+    continuousFrame = false;
 }
 
 QQuickWindowPrivate::QQuickWindowPrivate()
@@ -402,6 +703,7 @@ QQuickWindowPrivate::QQuickWindowPrivate()
     , context(0)
     , renderer(0)
     , windowManager(0)
+    , renderControl(0)
     , touchRecursionGuard(0)
     , customRenderStage(0)
     , clearColor(Qt::white)
@@ -413,7 +715,15 @@ QQuickWindowPrivate::QQuickWindowPrivate()
     , renderTarget(0)
     , renderTargetId(0)
     , incubationController(0)
+    , pointerIndex(0)
+    , hitTestPath(0)
+    , bufferAge(0)
+    , lastSwapTime(-1)
+    , renderEndTime(-1)
+    , vsyncInterval(16666667)
+    , continuousFrame(false)
 {
+    frameTimer.start();
 #ifndef QT_NO_DRAGANDDROP
     dragGrabber = new QQuickDragGrabber;
 #endif
@@ -422,9 +732,56 @@ QQuickWindowPrivate::QQuickWindowPrivate()
 QQuickWindowPrivate::~QQuickWindowPrivate()
 {
     delete customRenderStage;
+    delete pointerIndex;
+    delete bufferAge;
+}
+
+/*
+    Collects the items which may be under \a scenePos according to the
+    spatial index, together with their ancestors. Delivery then only
+    descends into children in \a path, and the exact contains() tests and
+    the paint order are applied to those.
+ */
+void QQuickWindowPrivate::buildHitTestPath(const QPointF &scenePos, int filter, QSet<QQuickItem *> *path)
+{
+    if (!pointerIndex->isValid())
+        pointerIndex->rebuild(contentItem);
+
+    QVector<QQuickItem *> candidates;
+    pointerIndex->itemsAt(scenePos, filter, &candidates);
+    for (int i = 0; i < candidates.count(); ++i) {
+        for (QQuickItem *item = candidates.at(i); item && item != contentItem; item = item->parentItem()) {
+            if (path->contains(item))
+                break;
+            path->insert(item);
+        }
+    }
+}
+
+namespace {
+    // Restricts delivery to the hit test path for the duration of a scope.
+    class HitTestScope
+    {
+    public:
+        HitTestScope(QQuickWindowPrivate *d, const QPointF &scenePos, int filter)
+            : d(d)
+            , previous(d->hitTestPath)
+        {
+            if (d->pointerIndex) {
+                d->buildHitTestPath(scenePos, filter, &path);
+                d->hitTestPath = &path;
+            }
+        }
+        ~HitTestScope() { d->hitTestPath = previous; }
+
+    private:
+        QQuickWindowPrivate *d;
+        const QSet<QQuickItem *> *previous;
+        QSet<QQuickItem *> path;
+    };
 }
 
-void QQuickWindowPrivate::init(QQuickWindow *c)
+void QQuickWindowPrivate::init(QQuickWindow *c, QQuickRenderControl *control)
 {
     q_ptr = c;
 
@@ -438,10 +795,22 @@ void QQuickWindowPrivate::init(QQuickWindow *c)
     contentItemPrivate->flags |= QQuickItem::ItemIsFocusScope;
 
     customRenderMode = qgetenv("QSG_VISUALIZE");
-    windowManager = QSGRenderLoop::instance();
-    windowManager->addWindow(q);
-    QSGContext *sg = windowManager->sceneGraphContext();
-    context = windowManager->createRenderContext(sg);
+
+    if (qgetenv("QML_SPATIAL_HIT_TEST").toInt())
+        pointerIndex = new QQuickItemSpatialIndex;
+    QSGContext *sg;
+    if (control) {
+        // Driven by the application; no render loop is involved.
+        QQuickRenderControlPrivate *rcd = QQuickRenderControlPrivate::get(control);
+        renderControl = control;
+        sg = rcd->sg;
+        context = rcd->rc;
+    } else {
+        windowManager = QSGRenderLoop::instance();
+        windowManager->addWindow(q);
+        sg = windowManager->sceneGraphContext();
+        context = windowManager->createRenderContext(sg);
+    }
     q->setSurfaceType(QWindow::OpenGLSurface);
     q->setFormat(sg->defaultSurfaceFormat());
 
@@ -606,6 +975,7 @@ bool QQuickWindowPrivate::translateTouchToMouse(QQuickItem *item, QTouchEvent *e
                     lastMousePosition = me->windowPos();
 
                     bool accepted = me->isAccepted();
+                    HitTestScope scope(this, me->windowPos(), QQuickItemSpatialIndex::AcceptsHover);
                     bool delivered = deliverHoverEvent(contentItem, me->windowPos(), last, me->modifiers(), accepted);
                     if (!delivered) {
                         //take care of any exits
@@ -1050,6 +1420,27 @@ QQuickWindow::QQuickWindow(QWindow *parent)
 
 
 
+/*!
+    \since 5.3
+
+    Constructs a window for rendering a QML scene offscreen under the control
+    of \a renderControl. The window is not driven by the scene graph render
+    loop and is never shown; frames are produced by calling
+    QQuickRenderControl::polishItems(), QQuickRenderControl::sync() and
+    QQuickRenderControl::render(). All windows constructed with the same
+    render control share its OpenGL context and scene graph context.
+
+    The render control must outlive the window.
+
+    \sa QQuickRenderControl, setRenderTarget()
+*/
+QQuickWindow::QQuickWindow(QQuickRenderControl *renderControl)
+    : QWindow(*(new QQuickWindowPrivate), 0)
+{
+    Q_D(QQuickWindow);
+    d->init(this, renderControl);
+}
+
 /*!
     \internal
 */
@@ -1071,6 +1462,8 @@ QQuickWindow::~QQuickWindow()
     if (d->windowManager) {
         d->windowManager->removeWindow(this);
         d->windowManager->windowDestroyed(this);
+    } else if (d->renderControl) {
+        QQuickRenderControlPrivate::get(d->renderControl)->windowDestroyed(this);
     }
 
     QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
@@ -1124,6 +1517,41 @@ void QQuickWindow::releaseResources()
 
 
 
+static void qquickwindow_drain_delegate_pools(QQuickItem *item, QQmlEngine *engine, bool *usesEngine)
+{
+    if (qmlEngine(item) == engine) {
+        *usesEngine = true;
+        if (QQuickItemView *view = qobject_cast<QQuickItemView *>(item)) {
+            QQuickItemViewPrivate *viewPrivate = QQuickItemViewPrivate::get(view);
+            if (viewPrivate->model)
+                viewPrivate->model->drainReusableItemsPool(0);
+        }
+    }
+    foreach (QQuickItem *child, QQuickItemPrivate::get(item)->childItems)
+        qquickwindow_drain_delegate_pools(child, engine, usesEngine);
+}
+
+/*!
+    \internal
+
+    Releases what the items of \a engine in this window hold on to, for
+    QQmlEngine::releaseResources(). Pooled delegates always go; for
+    QQmlEngine::AggressiveRelease the scene graph is released as well, which
+    takes the atlas textures and glyph caches with it.
+
+    Returns the number of bytes released that can be accounted for.
+*/
+qint64 QQuickWindowPrivate::releaseResources(QQmlEngine *engine, QQmlEngine::ReleaseLevel level)
+{
+    Q_Q(QQuickWindow);
+    bool usesEngine = false;
+    qquickwindow_drain_delegate_pools(contentItem, engine, &usesEngine);
+
+    if (usesEngine && level == QQmlEngine::AggressiveRelease && windowManager)
+        windowManager->releaseResources(q);
+    return 0;
+}
+
 /*!
     Sets whether the OpenGL context can be released to \a
     persistent. The default value is true.
@@ -1400,6 +1828,8 @@ bool QQuickWindowPrivate::deliverInitialMousePressEvent(QQuickItem *item, QMouse
         QQuickItem *child = children.at(ii);
         if (!child->isVisible() || !child->isEnabled() || QQuickItemPrivate::get(child)->culled)
             continue;
+        if (isOutsideHitTestPath(child))
+            continue;
         if (deliverInitialMousePressEvent(child, event))
             return true;
     }
@@ -1431,6 +1861,7 @@ bool QQuickWindowPrivate::deliverMouseEvent(QMouseEvent *event)
     if (!mouseGrabberItem &&
          event->type() == QEvent::MouseButtonPress &&
          (event->buttons() & event->button()) == event->buttons()) {
+        HitTestScope scope(this, event->windowPos(), QQuickItemSpatialIndex::AcceptsMouse);
         if (deliverInitialMousePressEvent(contentItem, event))
             event->accept();
         else
@@ -1489,6 +1920,7 @@ void QQuickWindow::mouseDoubleClickEvent(QMouseEvent *event)
 #endif
 
     if (!d->mouseGrabberItem && (event->buttons() & event->button()) == event->buttons()) {
+        HitTestScope scope(d, event->windowPos(), QQuickItemSpatialIndex::AcceptsMouse);
         if (d->deliverInitialMousePressEvent(d->contentItem, event))
             event->accept();
         else
@@ -1534,6 +1966,7 @@ void QQuickWindow::mouseMoveEvent(QMouseEvent *event)
         d->lastMousePosition = event->windowPos();
 
         bool accepted = event->isAccepted();
+        HitTestScope scope(d, event->windowPos(), QQuickItemSpatialIndex::AcceptsHover);
         bool delivered = d->deliverHoverEvent(d->contentItem, event->windowPos(), last, event->modifiers(), accepted);
         if (!delivered) {
             //take care of any exits
@@ -1563,6 +1996,8 @@ bool QQuickWindowPrivate::deliverHoverEvent(QQuickItem *item, const QPointF &sce
         QQuickItem *child = children.at(ii);
         if (!child->isVisible() || !child->isEnabled() || QQuickItemPrivate::get(child)->culled)
             continue;
+        if (isOutsideHitTestPath(child))
+            continue;
         if (deliverHoverEvent(child, scenePos, lastScenePos, modifiers, accepted))
             return true;
     }
@@ -1728,8 +2163,7 @@ void QQuickWindowPrivate::deliverTouchEvent(QTouchEvent *event)
         if (!delayedTouch) {
             delayedTouch = new QTouchEvent(event->type(), event->device(), event->modifiers(), event->touchPointStates(), event->touchPoints());
             delayedTouch->setTimestamp(event->timestamp());
-            if (windowManager)
-                windowManager->maybeUpdate(q);
+            q->maybeUpdate();
             return;
         } else {
             // check if this looks like the last touch event
@@ -2606,8 +3040,11 @@ void QQuickWindowPrivate::updateDirtyNode(QQuickItem *item)
         if (itemPriv->x != 0. || itemPriv->y != 0.)
             matrix.translate(itemPriv->x, itemPriv->y);
 
-        for (int ii = itemPriv->transforms.count() - 1; ii >= 0; --ii)
-            itemPriv->transforms.at(ii)->applyTo(&matrix);
+        if (itemPriv->hasTransforms()) {
+            const QList<QQuickTransform *> &transforms = itemPriv->extra->transforms;
+            for (int ii = transforms.count() - 1; ii >= 0; --ii)
+                transforms.at(ii)->applyTo(&matrix);
+        }
 
         if (itemPriv->scale() != 1. || itemPriv->rotation() != 0.) {
             QPointF origin = item->transformOriginPoint();
@@ -2849,6 +3286,8 @@ void QQuickWindow::maybeUpdate()
     Q_D(QQuickWindow);
     if (d->windowManager)
         d->windowManager->maybeUpdate(this);
+    else if (d->renderControl)
+        QQuickRenderControlPrivate::get(d->renderControl)->maybeUpdate(this);
 }
 
 void QQuickWindow::cleanupSceneGraph()
@@ -2861,6 +3300,8 @@ void QQuickWindow::cleanupSceneGraph()
     delete d->renderer->rootNode();
     delete d->renderer;
     d->renderer = 0;
+    delete d->bufferAge;
+    d->bufferAge = 0;
 
     d->runAndClearJobs(&d->beforeSynchronizingJobs);
     d->runAndClearJobs(&d->afterSynchronizingJobs);
@@ -3082,10 +3523,17 @@ QOpenGLFramebufferObject *QQuickWindow::renderTarget() const
     \warning Calling this function will cause performance problems.
 
     \warning This function can only be called from the GUI thread.
+
+    \note This function blocks until the pixels have been read back. For
+    periodic captures, QQuickItem::grabToImage() on the contentItem() reads
+    the pixels back asynchronously where the OpenGL implementation allows it.
  */
 QImage QQuickWindow::grabWindow()
 {
     Q_D(QQuickWindow);
+    if (d->renderControl)
+        return d->renderControl->grab(this);
+
     if (!isVisible()) {
 
         if (d->context->openglContext()) {
@@ -3695,6 +4143,102 @@ void QQuickWindow::scheduleRenderJob(QRunnable *job, RenderStage stage)
     d->renderJobMutex.unlock();
 }
 
+/*!
+    \since 5.4
+
+    Compiles the shaders for \a materials ahead of time, so that the scene
+    graph does not need to compile them when the materials are first
+    rendered.
+
+    The shaders are compiled on a separate thread, using an OpenGL context
+    which shares resources with the context used for rendering this window.
+    Calling this function while a splash screen is shown lets the
+    compilation overlap with the rest of the application's startup. If the
+    scene graph is not initialized yet, compilation starts as soon as it is.
+
+    The window takes ownership over the materials. They are only used to
+    create and compile their shaders and are deleted afterwards. Both the
+    shader used by the renderer for opaque batches and the one used for all
+    other batches are compiled, unless the material has the
+    QSGMaterial::CustomCompileStep flag set.
+
+    Precompiled shaders are discarded when the scene graph is invalidated.
+    Materials whose shaders are not ready by the time they are first used
+    are compiled on the rendering thread as usual.
+
+    This function must be called from the GUI thread.
+
+    \note On Windows, this function only deletes the materials.
+
+    \sa sceneGraphInitialized()
+ */
+
+void QQuickWindow::precompileMaterials(const QList<QSGMaterial *> &materials)
+{
+    Q_D(QQuickWindow);
+    d->context->precompileMaterials(materials, this);
+}
+
+/*!
+    \qmlmethod object Window::frameStatistics()
+    \since 5.4
+
+    Returns statistics about the frames rendered so far, see
+    QQuickWindow::frameStatistics(). This method was introduced in
+    QtQuick.Window 2.2.
+ */
+
+/*!
+    \since 5.4
+
+    Returns statistics about the frames this window rendered since it was
+    created or resetFrameStatistics() was last called.
+
+    The map holds the number of \c frames swapped and \c missedVsyncs, the
+    number of vsync intervals lost by frames which were started right after
+    the previous one. For each of the \c polish, \c animations, \c sync,
+    \c render and \c swap phases of a frame, it holds a map with the \c
+    count of measurements, the \c average and \c maximum times in
+    milliseconds and a \c histogram, a list of how many measurements fell
+    into each of the ranges split at the limits in \c histogramLimits. For
+    the \c batches, \c drawCalls and \c uploadedBytes of vertex and index
+    data of the renderer, it holds a map with the value of the \c last
+    frame, and the \c average and \c maximum per frame.
+
+    Polish times are only counted when items were polished. Animation times
+    are the time spent advancing animations after a frame, which is only
+    measured by the threaded and the windows render loops.
+
+    The statistics are always collected and cost a few additions per frame.
+    This function can be called from any thread.
+
+    \sa resetFrameStatistics()
+ */
+QVariantMap QQuickWindow::frameStatistics() const
+{
+    Q_D(const QQuickWindow);
+    return d->frameStatistics.toVariantMap();
+}
+
+/*!
+    \qmlmethod Window::resetFrameStatistics()
+    \since 5.4
+
+    Clears the statistics returned by frameStatistics(). This method was
+    introduced in QtQuick.Window 2.2.
+ */
+
+/*!
+    \since 5.4
+
+    Clears the statistics returned by frameStatistics().
+ */
+void QQuickWindow::resetFrameStatistics()
+{
+    Q_D(QQuickWindow);
+    d->frameStatistics.reset();
+}
+
 void QQuickWindowPrivate::runAndClearJobs(QList<QRunnable *> *jobs)
 {
     renderJobMutex.lock();
@@ -44,6 +44,7 @@
 
 #include <QtQuick/qtquickglobal.h>
 #include <QtCore/qmetatype.h>
+#include <QtCore/qvariant.h>
 #include <QtGui/qopengl.h>
 #include <QtGui/qwindow.h>
 #include <QtGui/qevent.h>
@@ -53,12 +54,14 @@ QT_BEGIN_NAMESPACE
 class QRunnable;
 class QQuickItem;
 class QSGTexture;
+class QSGMaterial;
 class QInputMethodEvent;
 class QQuickWindowPrivate;
 class QOpenGLFramebufferObject;
 class QQmlIncubationController;
 class QInputMethodEvent;
 class QQuickCloseEvent;
+class QQuickRenderControl;
 
 class Q_QUICK_EXPORT QQuickWindow : public QWindow
 {
@@ -88,6 +91,7 @@ public:
     Q_DECLARE_FLAGS(CreateTextureOptions, CreateTextureOption)
 
     QQuickWindow(QWindow *parent = 0);
+    explicit QQuickWindow(QQuickRenderControl *renderControl);
 
     virtual ~QQuickWindow();
 
@@ -141,6 +145,11 @@ public:
 
     void scheduleRenderJob(QRunnable *job, RenderStage schedule);
 
+    void precompileMaterials(const QList<QSGMaterial *> &materials);
+
+    Q_REVISION(2) Q_INVOKABLE QVariantMap frameStatistics() const;
+    Q_REVISION(2) Q_INVOKABLE void resetFrameStatistics();
+
 Q_SIGNALS:
     void frameSwapped();
     void sceneGraphInitialized();
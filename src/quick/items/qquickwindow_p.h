@@ -55,13 +55,19 @@
 
 #include "qquickitem.h"
 #include "qquickwindow.h"
+#include "qquickitemspatialindex_p.h"
+#include "qquickframestatistics_p.h"
 
 #include <QtQuick/private/qsgcontext_p.h>
 #include <private/qsgbatchrenderer_p.h>
+#include <private/qsgdamagetracker_p.h>
+
+#include <QtQml/qqmlengine.h>
 
 #include <QtCore/qthread.h>
 #include <QtCore/qmutex.h>
 #include <QtCore/qwaitcondition.h>
+#include <QtCore/qelapsedtimer.h>
 #include <private/qwindow_p.h>
 #include <private/qopengl_p.h>
 #include <qopenglcontext.h>
@@ -74,6 +80,7 @@ QT_BEGIN_NAMESPACE
 
 class QQuickAnimatorController;
 class QSGRenderLoop;
+class QQuickRenderControl;
 class QQuickDragGrabber;
 
 class QQuickRootItem : public QQuickItem
@@ -91,6 +98,7 @@ class QQuickWindowPrivate;
 
 class QTouchEvent;
 class QQuickWindowRenderLoop;
+class QQuickWindowBufferAge;
 class QQuickWindowIncubationController;
 
 class QOpenGLVertexArrayObjectHelper;
@@ -113,7 +121,7 @@ public:
     QQuickWindowPrivate();
     virtual ~QQuickWindowPrivate();
 
-    void init(QQuickWindow *);
+    void init(QQuickWindow *, QQuickRenderControl *control = 0);
     void initContentItem();//Currently only used if items added in QML
 
     QQuickRootItem *contentItem;
@@ -171,6 +179,15 @@ public:
 #endif
 
     QList<QQuickItem*> hoverItems;
+
+    // Optional index used to skip subtrees without candidates during mouse
+    // press and hover delivery, enabled with QML_SPATIAL_HIT_TEST=1.
+    QQuickItemSpatialIndex *pointerIndex;
+    const QSet<QQuickItem *> *hitTestPath;
+    void buildHitTestPath(const QPointF &scenePos, int filter, QSet<QQuickItem *> *path);
+    inline bool isOutsideHitTestPath(QQuickItem *item) const { return hitTestPath && !hitTestPath->contains(item); }
+    inline void invalidatePointerIndex() { if (pointerIndex) pointerIndex->invalidate(); }
+
     enum FocusOption {
         DontChangeFocusProperty = 0x01,
         DontChangeSubFocusItem  = 0x02
@@ -190,6 +207,7 @@ public:
     void polishItems();
     void syncSceneGraph();
     void renderSceneGraph(const QSize &size);
+    QRect partialUpdateRect(const QSize &deviceSize);
 
     bool isRenderable() const;
 
@@ -203,17 +221,20 @@ public:
     void updateDirtyNodes();
     void cleanupNodes();
     void cleanupNodesOnShutdown();
+    qint64 releaseResources(QQmlEngine *engine, QQmlEngine::ReleaseLevel level);
     bool updateEffectiveOpacity(QQuickItem *);
     void updateEffectiveOpacityRoot(QQuickItem *, qreal);
     void updateDirtyNode(QQuickItem *);
 
-    void fireFrameSwapped() { Q_EMIT q_func()->frameSwapped(); }
+    void fireFrameSwapped() { recordFrameSwapped(); Q_EMIT q_func()->frameSwapped(); }
+    void recordFrameSwapped();
 
     QSGRenderContext *context;
     QSGRenderer *renderer;
     QByteArray customRenderMode; // Default renderer supports "clip", "overdraw", "changes", "batches" and blank.
 
     QSGRenderLoop *windowManager;
+    QQuickRenderControl *renderControl;
     QQuickAnimatorController *animationController;
     QTouchEvent *delayedTouch;
     int touchRecursionGuard;
@@ -235,6 +256,22 @@ public:
     uint renderTargetId;
     QSize renderTargetSize;
 
+    // Partial updates of the window, see partialUpdateRect()
+    enum { MaximumBufferAge = 4 };
+    QQuickWindowBufferAge *bufferAge;
+    QSGDamageTracker damageTracker;
+    QVector<QRect> damageHistory;
+    QSize damageSize;
+    QColor damageClearColor;
+
+    // Always collected, see QQuickWindow::frameStatistics()
+    QQuickFrameStatistics frameStatistics;
+    QElapsedTimer frameTimer;
+    qint64 lastSwapTime;
+    qint64 renderEndTime;
+    qint64 vsyncInterval;
+    bool continuousFrame;
+
     // Keeps track of which touch point (int) was last accepted by which item
     QHash<int, QQuickItem *> itemForTouchPointId;
     QSet<int> touchMouseIdCandidates;
@@ -150,6 +150,8 @@ void QQuickWindowModule::defineModule()
     qmlRegisterRevision<QWindow,1>(uri, 2, 1);
     qmlRegisterRevision<QQuickWindow,1>(uri, 2, 1);//Type moved to a subclass, but also has new members
     qmlRegisterType<QQuickWindowQmlImpl>(uri, 2, 1, "Window");
+    qmlRegisterRevision<QQuickWindow,2>(uri, 2, 2);
+    qmlRegisterType<QQuickWindowQmlImpl>(uri, 2, 2, "Window");
     qmlRegisterUncreatableType<QQuickScreen>(uri, 2, 0, "Screen", QStringLiteral("Screen can only be used via the attached property."));
 }
 
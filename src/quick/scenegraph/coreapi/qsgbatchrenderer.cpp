@@ -49,6 +49,10 @@
 
 #include <QtCore/QElapsedTimer>
 #include <QtCore/QtNumeric>
+#include <QtCore/QRunnable>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <private/qsimd_p.h>
 
 #include <QtGui/QGuiApplication>
 #include <QtGui/QOpenGLFramebufferObject>
@@ -58,15 +62,35 @@
 #include <private/qsystrace_p.h>
 #include "qsgmaterialshader_p.h"
 
+#include <QtQuick/qsgflatcolormaterial.h>
+#include <QtQuick/qsgtexturematerial.h>
+#include <QtQuick/qsgvertexcolormaterial.h>
+#include <private/qsgdefaultimagenode_p.h>
+#include <private/qsgdefaultrectanglenode_p.h>
+
 #include <algorithm>
 
 #ifndef GL_DOUBLE
    #define GL_DOUBLE 0x140A
 #endif
 
+#ifndef GL_MAP_WRITE_BIT
+   #define GL_MAP_WRITE_BIT 0x0002
+#endif
+
+#ifndef GL_MAP_INVALIDATE_RANGE_BIT
+   #define GL_MAP_INVALIDATE_RANGE_BIT 0x0004
+#endif
+
+#ifndef GL_MAP_UNSYNCHRONIZED_BIT
+   #define GL_MAP_UNSYNCHRONIZED_BIT 0x0020
+#endif
+
 QT_BEGIN_NAMESPACE
 
 extern QByteArray qsgShaderRewriter_insertZAttributes(const char *input, QSurfaceFormat::OpenGLContextProfile profile);
+extern QByteArray qsgShaderRewriter_insertInstanceTransform(const char *input, QSurfaceFormat::OpenGLContextProfile profile);
+extern QByteArray qsgShaderRewriter_insertPaletteTransform(const char *input, QSurfaceFormat::OpenGLContextProfile profile, int paletteSize);
 
 namespace QSGBatchRenderer
 {
@@ -80,6 +104,7 @@ const bool debug_dump       = qgetenv("QSG_RENDERER_DEBUG").contains("dump");
 const bool debug_noalpha    = qgetenv("QSG_RENDERER_DEBUG").contains("noalpha");
 const bool debug_noopaque   = qgetenv("QSG_RENDERER_DEBUG").contains("noopaque");
 const bool debug_noclip     = qgetenv("QSG_RENDERER_DEBUG").contains("noclip");
+const bool debug_noculling  = qgetenv("QSG_RENDERER_DEBUG").contains("noculling");
 
 static QElapsedTimer qsg_renderer_timer;
 
@@ -136,26 +161,26 @@ ShaderManager::Shader *ShaderManager::prepareMaterial(QSGMaterial *material)
     if (QSG_LOG_TIME_COMPILATION().isDebugEnabled() || QQuickProfiler::enabled)
         qsg_renderer_timer.start();
 
-    QSGMaterialShader *s = material->createShader();
-    QOpenGLContext *ctx = QOpenGLContext::currentContext();
-    QSurfaceFormat::OpenGLContextProfile profile = ctx->format().profile();
+    QSGMaterialShader *s = context->takePrecompiledShader(type, true);
+    if (!s)
+        s = compileShader(context, material, true);
+    context->initialize(s);
 
     QOpenGLShaderProgram *p = s->program();
-    char const *const *attr = s->attributeNames();
-    int i;
-    for (i = 0; attr[i]; ++i) {
-        if (*attr[i])
-            p->bindAttributeLocation(attr[i], i);
-    }
-    p->bindAttributeLocation("_qt_order", i);
-    context->compile(s, material, qsgShaderRewriter_insertZAttributes(s->vertexShader(), profile), 0);
-    context->initialize(s);
     if (!p->isLinked())
         return 0;
 
+    char const *const *attr = s->attributeNames();
+    int i = 0;
+    while (attr[i])
+        ++i;
+
     shader = new Shader;
     shader->program = s;
     shader->pos_order = i;
+    shader->pos_instanceMatrix = -1;
+    shader->pos_paletteIndex = -1;
+    shader->id_palette = -1;
     shader->id_zRange = p->uniformLocation("_qt_zRange");
     shader->lastOpacity = 0;
 
@@ -182,14 +207,18 @@ ShaderManager::Shader *ShaderManager::prepareMaterialNoRewrite(QSGMaterial *mate
     if (QSG_LOG_TIME_COMPILATION().isDebugEnabled() || QQuickProfiler::enabled)
         qsg_renderer_timer.start();
 
-    QSGMaterialShader *s = static_cast<QSGMaterialShader *>(material->createShader());
-    context->compile(s, material);
+    QSGMaterialShader *s = context->takePrecompiledShader(type, false);
+    if (!s)
+        s = compileShader(context, material, false);
     context->initialize(s);
 
     shader = new Shader();
     shader->program = s;
     shader->id_zRange = -1;
     shader->pos_order = -1;
+    shader->pos_instanceMatrix = -1;
+    shader->pos_paletteIndex = -1;
+    shader->id_palette = -1;
     shader->lastOpacity = 0;
 
     stockShaders[type] = shader;
@@ -201,12 +230,153 @@ ShaderManager::Shader *ShaderManager::prepareMaterialNoRewrite(QSGMaterial *mate
     return shader;
 }
 
+/*
+    Returns the material's shader with a per-instance matrix attribute,
+    which is applied to gl_Position, placed after its own attributes.
+ */
+ShaderManager::Shader *ShaderManager::prepareMaterialInstanced(QSGMaterial *material)
+{
+    QSGMaterialType *type = material->type();
+    Shader *shader = instancedShaders.value(type, 0);
+    if (shader)
+        return shader;
+
+    QSystraceEvent systrace("graphics", "ShaderManager::prepareMaterialInstanced");
+    if (QSG_LOG_TIME_COMPILATION().isDebugEnabled() || QQuickProfiler::enabled)
+        qsg_renderer_timer.start();
+
+    QOpenGLContext *ctx = QOpenGLContext::currentContext();
+    QSurfaceFormat::OpenGLContextProfile profile = ctx->format().profile();
+
+    QSGMaterialShader *s = material->createShader();
+    QOpenGLShaderProgram *p = s->program();
+    char const *const *attr = s->attributeNames();
+    int i;
+    for (i = 0; attr[i]; ++i) {
+        if (*attr[i])
+            p->bindAttributeLocation(attr[i], i);
+    }
+    p->bindAttributeLocation("_qt_instanceMatrix", i);
+    context->compile(s, material, qsgShaderRewriter_insertInstanceTransform(s->vertexShader(), profile), 0);
+    context->initialize(s);
+
+    if (!p->isLinked()) {
+        delete s;
+        return 0;
+    }
+
+    shader = new Shader();
+    shader->program = s;
+    shader->id_zRange = -1;
+    shader->pos_order = -1;
+    shader->pos_instanceMatrix = i;
+    shader->pos_paletteIndex = -1;
+    shader->id_palette = -1;
+    shader->lastOpacity = 0;
+
+    instancedShaders[type] = shader;
+
+    qCDebug(QSG_LOG_TIME_COMPILATION, "shader compiled in %dms (instanced)", (int) qsg_renderer_timer.elapsed());
+
+    Q_QUICK_SG_PROFILE1(QQuickProfiler::SceneGraphContextFrame, (
+            qsg_renderer_timer.nsecsElapsed()));
+    return shader;
+}
+
+/*
+    Returns the material's shader for merged batches drawn with a matrix
+    palette, with the z attribute followed by the palette index placed
+    after its own attributes.
+ */
+ShaderManager::Shader *ShaderManager::prepareMaterialPalette(QSGMaterial *material, int paletteSize)
+{
+    QSGMaterialType *type = material->type();
+    Shader *shader = paletteShaders.value(type, 0);
+    if (shader)
+        return shader;
+
+    QSystraceEvent systrace("graphics", "ShaderManager::prepareMaterialPalette");
+    if (QSG_LOG_TIME_COMPILATION().isDebugEnabled() || QQuickProfiler::enabled)
+        qsg_renderer_timer.start();
+
+    QOpenGLContext *ctx = QOpenGLContext::currentContext();
+    QSurfaceFormat::OpenGLContextProfile profile = ctx->format().profile();
+
+    QSGMaterialShader *s = material->createShader();
+    QOpenGLShaderProgram *p = s->program();
+    char const *const *attr = s->attributeNames();
+    int i;
+    for (i = 0; attr[i]; ++i) {
+        if (*attr[i])
+            p->bindAttributeLocation(attr[i], i);
+    }
+    p->bindAttributeLocation("_qt_order", i);
+    p->bindAttributeLocation("_qt_paletteIndex", i + 1);
+    context->compile(s, material, qsgShaderRewriter_insertPaletteTransform(s->vertexShader(), profile, paletteSize), 0);
+    context->initialize(s);
+
+    if (!p->isLinked()) {
+        delete s;
+        return 0;
+    }
+
+    shader = new Shader();
+    shader->program = s;
+    shader->pos_order = i;
+    shader->pos_instanceMatrix = -1;
+    shader->pos_paletteIndex = i + 1;
+    shader->id_zRange = p->uniformLocation("_qt_zRange");
+    shader->id_palette = p->uniformLocation("_qt_palette");
+    shader->lastOpacity = 0;
+
+    paletteShaders[type] = shader;
+
+    qCDebug(QSG_LOG_TIME_COMPILATION, "shader compiled in %dms (palette)", (int) qsg_renderer_timer.elapsed());
+
+    Q_QUICK_SG_PROFILE1(QQuickProfiler::SceneGraphContextFrame, (
+            qsg_renderer_timer.nsecsElapsed()));
+    return shader;
+}
+
+/*
+    Creates and compiles, but does not initialize, the shader for \a material.
+    When \a rewrite is set the vertex shader gets the z attribute used by the
+    opaque batches. This is also used by QSGRenderContext to compile shaders
+    ahead of time on its helper thread.
+ */
+QSGMaterialShader *ShaderManager::compileShader(QSGRenderContext *context, QSGMaterial *material, bool rewrite)
+{
+    QSGMaterialShader *s = material->createShader();
+    if (!rewrite) {
+        context->compile(s, material);
+        return s;
+    }
+
+    QOpenGLContext *ctx = QOpenGLContext::currentContext();
+    QSurfaceFormat::OpenGLContextProfile profile = ctx->format().profile();
+
+    QOpenGLShaderProgram *p = s->program();
+    char const *const *attr = s->attributeNames();
+    int i;
+    for (i = 0; attr[i]; ++i) {
+        if (*attr[i])
+            p->bindAttributeLocation(attr[i], i);
+    }
+    p->bindAttributeLocation("_qt_order", i);
+    context->compile(s, material, qsgShaderRewriter_insertZAttributes(s->vertexShader(), profile), 0);
+    return s;
+}
+
 void ShaderManager::invalidated()
 {
     qDeleteAll(stockShaders.values());
     stockShaders.clear();
     qDeleteAll(rewrittenShaders.values());
     rewrittenShaders.clear();
+    qDeleteAll(instancedShaders.values());
+    instancedShaders.clear();
+    qDeleteAll(paletteShaders.values());
+    paletteShaders.clear();
     delete blitProgram;
     blitProgram = 0;
 }
@@ -750,6 +920,20 @@ Renderer::Renderer(QSGRenderContext *ctx)
     , m_zRange(0)
     , m_renderOrderRebuildLower(-1)
     , m_renderOrderRebuildUpper(-1)
+    , m_vertexBufferPool(0)
+#ifdef QSG_SEPARATE_INDEX_BUFFER
+    , m_indexBufferPool(0)
+#endif
+    , m_mergedUploads(64)
+    , m_uploadPool(0)
+    , m_paletteMatrices(256)
+    , m_culling(false)
+    , m_occluders(16)
+    , m_vertexAttribDivisor(0)
+    , m_drawArraysInstanced(0)
+    , m_drawElementsInstanced(0)
+    , m_instanceBuffer(0)
+    , m_instanceMatrices(1024)
     , m_currentMaterial(0)
     , m_currentShader(0)
     , m_currentClip(0)
@@ -777,6 +961,9 @@ Renderer::Renderer(QSGRenderContext *ctx)
         m_bufferStrategy = GL_DYNAMIC_DRAW;
     } else if (strategy == "stream") {
         m_bufferStrategy = GL_STREAM_DRAW;
+    } else if (strategy == "pooled") {
+        // Set up below, once we know what the context supports
+        m_bufferStrategy = GL_DYNAMIC_DRAW;
     }
 
     m_batchNodeThreshold = 64;
@@ -796,8 +983,48 @@ Renderer::Renderer(QSGRenderContext *ctx)
         if (ok)
             m_batchVertexThreshold = threshold;
     }
+
+    m_instanceThreshold = 8;
+    alternateThreshold = qgetenv("QSG_RENDERER_INSTANCE_THRESHOLD");
+    if (alternateThreshold.length() > 0) {
+        bool ok = false;
+        int threshold = alternateThreshold.toInt(&ok);
+        if (ok)
+            m_instanceThreshold = threshold;
+    }
+
+    // Only the stock materials are known to draw within the bounds of
+    // their geometry. The smooth ones reach slightly beyond it, which is
+    // what the cull margin is for, but their edges can't occlude.
+    {
+        QSGFlatColorMaterial flatColor;
+        QSGVertexColorMaterial vertexColor;
+        QSGOpaqueTextureMaterial opaqueTexture;
+        QSGTextureMaterial texture;
+        QSGSmoothColorMaterial smoothColor;
+        QSGSmoothTextureMaterial smoothTexture;
+        m_cullableMaterialTypes[0] = flatColor.type();
+        m_cullableMaterialTypes[1] = vertexColor.type();
+        m_cullableMaterialTypes[2] = opaqueTexture.type();
+        m_cullableMaterialTypes[3] = texture.type();
+        m_cullableMaterialTypes[4] = smoothColor.type();
+        m_cullableMaterialTypes[5] = smoothTexture.type();
+    }
+
+    // The render thread does its share of a parallel upload too,
+    // so leave one core for it.
+    m_uploadThreadCount = qBound(0, QThread::idealThreadCount() - 1, 3);
+    QByteArray uploadThreads = qgetenv("QSG_RENDERER_UPLOAD_THREADS");
+    if (uploadThreads.length() > 0) {
+        bool ok = false;
+        int threads = uploadThreads.toInt(&ok);
+        if (ok)
+            m_uploadThreadCount = qMax(0, threads);
+    }
+
     if (Q_UNLIKELY(debug_build || debug_render)) {
         qDebug() << "Batch thresholds: nodes:" << m_batchNodeThreshold << " vertices:" << m_batchVertexThreshold;
+        qDebug() << "Upload threads:" << m_uploadThreadCount;
         qDebug() << "Using buffer strategy:" << (m_bufferStrategy == GL_STATIC_DRAW ? "static" : (m_bufferStrategy == GL_DYNAMIC_DRAW ? "dynamic" : "stream"));
     }
 
@@ -809,11 +1036,80 @@ Renderer::Renderer(QSGRenderContext *ctx)
     }
 
     m_useDepthBuffer = ctx->openglContext()->format().depthBufferSize() > 0;
+
+    QOpenGLContext *gl = ctx->openglContext();
+
+    // With 32-bit indices a merged batch is drawn in one go regardless of its
+    // size. Desktop OpenGL always has them, OpenGL ES 2.0 only through
+    // GL_OES_element_index_uint.
+    m_mergedIndexType = GL_UNSIGNED_SHORT;
+    if (!gl->isOpenGLES() || gl->format().majorVersion() >= 3 || gl->hasExtension("GL_OES_element_index_uint"))
+        m_mergedIndexType = GL_UNSIGNED_INT;
+    if (qgetenv("QSG_RENDERER_UINT_INDICES") == "0")
+        m_mergedIndexType = GL_UNSIGNED_SHORT;
+    m_mergedIndexSize = m_mergedIndexType == GL_UNSIGNED_INT ? sizeof(quint32) : sizeof(quint16);
+
+    // Sixteen matrices fit in the 128 vertex uniform vectors OpenGL ES 2.0
+    // guarantees, with plenty to spare for the material's own uniforms.
+    m_paletteSize = 16;
+    if (qgetenv("QSG_RENDERER_MATRIX_PALETTE") == "0")
+        m_paletteSize = 0;
+
+    // Instanced arrays are core in OpenGL 3.3 and OpenGL ES 3.0, and available
+    // through extensions in older versions.
+    const char *suffix = 0;
+    if (gl->isOpenGLES() ? gl->format().majorVersion() >= 3 : gl->format().version() >= qMakePair(3, 3))
+        suffix = "";
+    else if (gl->hasExtension("GL_ARB_instanced_arrays") && gl->hasExtension("GL_ARB_draw_instanced"))
+        suffix = "ARB";
+    else if (gl->hasExtension("GL_EXT_instanced_arrays"))
+        suffix = "EXT";
+    else if (gl->hasExtension("GL_ANGLE_instanced_arrays"))
+        suffix = "ANGLE";
+    if (suffix && m_instanceThreshold > 0) {
+        m_vertexAttribDivisor = (QSGVertexAttribDivisorFunc) gl->getProcAddress(QByteArray("glVertexAttribDivisor") + suffix);
+        m_drawArraysInstanced = (QSGDrawArraysInstancedFunc) gl->getProcAddress(QByteArray("glDrawArraysInstanced") + suffix);
+        m_drawElementsInstanced = (QSGDrawElementsInstancedFunc) gl->getProcAddress(QByteArray("glDrawElementsInstanced") + suffix);
+        if (!m_vertexAttribDivisor || !m_drawArraysInstanced || !m_drawElementsInstanced) {
+            m_vertexAttribDivisor = 0;
+            m_drawArraysInstanced = 0;
+            m_drawElementsInstanced = 0;
+        }
+    }
+    if (Q_UNLIKELY(debug_build || debug_render))
+        qDebug() << "Instanced rendering:" << (m_vertexAttribDivisor != 0) << "threshold:" << m_instanceThreshold;
+
+    // Writing into the pool through an unsynchronized mapping skips the
+    // driver's check for pending reads, which the pool makes sure of itself.
+    // Without glMapBufferRange, the pool falls back to glBufferSubData.
+    if (strategy == "pooled" && !m_context->hasBrokenIndexBufferObjects()) {
+        QSGMapBufferRangeFunc mapBufferRange = 0;
+        QSGUnmapBufferFunc unmapBuffer = 0;
+        if (gl->isOpenGLES() ? gl->format().majorVersion() >= 3 : (gl->format().majorVersion() >= 3 || gl->hasExtension("GL_ARB_map_buffer_range"))) {
+            mapBufferRange = (QSGMapBufferRangeFunc) gl->getProcAddress("glMapBufferRange");
+            unmapBuffer = (QSGUnmapBufferFunc) gl->getProcAddress("glUnmapBuffer");
+        } else if (gl->hasExtension("GL_EXT_map_buffer_range") && gl->hasExtension("GL_OES_mapbuffer")) {
+            mapBufferRange = (QSGMapBufferRangeFunc) gl->getProcAddress("glMapBufferRangeEXT");
+            unmapBuffer = (QSGUnmapBufferFunc) gl->getProcAddress("glUnmapBufferOES");
+        }
+        if (!mapBufferRange || !unmapBuffer) {
+            mapBufferRange = 0;
+            unmapBuffer = 0;
+        }
+        m_vertexBufferPool = new BufferPool(GL_ARRAY_BUFFER, this, mapBufferRange, unmapBuffer);
+#ifdef QSG_SEPARATE_INDEX_BUFFER
+        m_indexBufferPool = new BufferPool(GL_ELEMENT_ARRAY_BUFFER, this, mapBufferRange, unmapBuffer);
+#endif
+        if (Q_UNLIKELY(debug_build || debug_render))
+            qDebug() << "Pooled buffers, mapped:" << (mapBufferRange != 0);
+    }
 }
 
 static void qsg_wipeBuffer(Buffer *buffer, QOpenGLFunctions *funcs)
 {
-    funcs->glDeleteBuffers(1, &buffer->id);
+    // Pooled buffer objects are shared, and deleted along with their pool.
+    if (!buffer->page)
+        funcs->glDeleteBuffers(1, &buffer->id);
     // The free here is ok because we're in one of two situations.
     // 1. We're using the upload pool in which case unmap will have set the
     //    data pointer to 0 and calling free on 0 is ok.
@@ -833,10 +1129,18 @@ static void qsg_wipeBatch(Batch *batch, QOpenGLFunctions *funcs)
 
 Renderer::~Renderer()
 {
+    delete m_uploadPool;
+    if (m_instanceBuffer)
+        glDeleteBuffers(1, &m_instanceBuffer);
+
     // Clean up batches and buffers
     for (int i=0; i<m_opaqueBatches.size(); ++i) qsg_wipeBatch(m_opaqueBatches.at(i), this);
     for (int i=0; i<m_alphaBatches.size(); ++i) qsg_wipeBatch(m_alphaBatches.at(i), this);
     for (int i=0; i<m_batchPool.size(); ++i) qsg_wipeBatch(m_batchPool.at(i), this);
+    delete m_vertexBufferPool;
+#ifdef QSG_SEPARATE_INDEX_BUFFER
+    delete m_indexBufferPool;
+#endif
 
     foreach (Node *n, m_nodes.values())
         m_nodeAllocator.release(n);
@@ -872,6 +1176,10 @@ void Renderer::invalidateAndRecycleBatch(Batch *b)
  */
 void Renderer::map(Buffer *buffer, int byteSize, bool isIndexBuf)
 {
+    // A pooled range is never written to again, the new data gets a new one.
+    if (buffer->page)
+        bufferPool(isIndexBuf)->release(buffer);
+
     if (!m_context->hasBrokenIndexBufferObjects() && m_visualizeMode == VisualizeNothing) {
         // Common case, use a shared memory pool for uploading vertex data to avoid
         // excessive reevaluation
@@ -894,17 +1202,191 @@ void Renderer::map(Buffer *buffer, int byteSize, bool isIndexBuf)
 
 void Renderer::unmap(Buffer *buffer, bool isIndexBuf)
 {
+    if (m_vertexBufferPool && m_visualizeMode == VisualizeNothing) {
+        // Left over from a visualization mode
+        if (buffer->id)
+            glDeleteBuffers(1, &buffer->id);
+        bufferPool(isIndexBuf)->upload(buffer);
+        m_frame_statistics.uploadedBytes += buffer->size;
+        buffer->data = 0;
+        return;
+    }
+
     if (buffer->id == 0)
         glGenBuffers(1, &buffer->id);
     GLenum target = isIndexBuf ? GL_ELEMENT_ARRAY_BUFFER : GL_ARRAY_BUFFER;
     glBindBuffer(target, buffer->id);
     glBufferData(target, buffer->size, buffer->data, m_bufferStrategy);
+    m_frame_statistics.uploadedBytes += buffer->size;
 
     if (!m_context->hasBrokenIndexBufferObjects() && m_visualizeMode == VisualizeNothing) {
         buffer->data = 0;
     }
 }
 
+BufferPool *Renderer::bufferPool(bool isIndexBuf) const
+{
+#ifdef QSG_SEPARATE_INDEX_BUFFER
+    return isIndexBuf ? m_indexBufferPool : m_vertexBufferPool;
+#else
+    Q_UNUSED(isIndexBuf);
+    return m_vertexBufferPool;
+#endif
+}
+
+// Most batches are much smaller than this, so a handful of pages serves a scene.
+static const int qsg_bufferPageSize = 1024 * 1024;
+
+// Ranges given back are kept this many frames before being reused, so that
+// the GPU is done reading from them. Drivers queue at most this many frames.
+static const uint qsg_bufferFramesInFlight = 3;
+
+BufferPool::BufferPool(GLenum target, QOpenGLFunctions *funcs, QSGMapBufferRangeFunc mapBufferRange, QSGUnmapBufferFunc unmapBuffer)
+    : m_target(target)
+    , m_funcs(funcs)
+    , m_mapBufferRange(mapBufferRange)
+    , m_unmapBuffer(unmapBuffer)
+    , m_frame(0)
+{
+}
+
+BufferPool::~BufferPool()
+{
+    for (int i=0; i<m_pages.size(); ++i) {
+        m_funcs->glDeleteBuffers(1, &m_pages.at(i)->id);
+        delete m_pages.at(i);
+    }
+}
+
+/* Finds room for size bytes with first-fit, adding a page when none has
+ * enough space left. Batches larger than a page get a page of their own.
+ */
+BufferPage *BufferPool::allocate(int size, int *offset)
+{
+    for (int i=0; i<m_pages.size(); ++i) {
+        BufferPage *page = m_pages.at(i);
+        if (page->size - page->used < size)
+            continue;
+        for (int j=0; j<page->free.size(); ++j) {
+            QPair<int, int> &range = page->free[j];
+            if (range.second < size)
+                continue;
+            *offset = range.first;
+            range.first += size;
+            range.second -= size;
+            if (range.second == 0)
+                page->free.remove(j);
+            page->used += size;
+            return page;
+        }
+    }
+
+    BufferPage *page = new BufferPage;
+    page->size = qMax(size, qsg_bufferPageSize);
+    page->used = size;
+    if (size < page->size)
+        page->free << qMakePair(size, page->size - size);
+    m_funcs->glGenBuffers(1, &page->id);
+    m_funcs->glBindBuffer(m_target, page->id);
+    m_funcs->glBufferData(m_target, page->size, 0, GL_DYNAMIC_DRAW);
+    m_pages << page;
+    *offset = 0;
+    return page;
+}
+
+void BufferPool::free(BufferPage *page, int offset, int size)
+{
+    page->used -= size;
+
+    // Insert sorted and merge with the neighbours
+    int i = 0;
+    while (i < page->free.size() && page->free.at(i).first < offset)
+        ++i;
+    page->free.insert(i, qMakePair(offset, size));
+    if (i + 1 < page->free.size() && offset + size == page->free.at(i + 1).first) {
+        page->free[i].second += page->free.at(i + 1).second;
+        page->free.remove(i + 1);
+    }
+    if (i > 0 && page->free.at(i - 1).first + page->free.at(i - 1).second == offset) {
+        page->free[i - 1].second += page->free.at(i).second;
+        page->free.remove(i);
+    }
+}
+
+/* Places buffer->size bytes from buffer->data in the pool and points
+ * buffer at them. The range is always fresh, so nothing can be reading
+ * from it and it is fine to write to it without synchronizing.
+ */
+void BufferPool::upload(Buffer *buffer)
+{
+    Q_ASSERT(!buffer->page);
+    if (buffer->size == 0)
+        return;
+
+    // Keep ranges aligned for the vertex attributes placed in them
+    const int size = (buffer->size + 15) & ~15;
+    int offset;
+    BufferPage *page = allocate(size, &offset);
+
+    m_funcs->glBindBuffer(m_target, page->id);
+    void *mapped = m_mapBufferRange
+            ? m_mapBufferRange(m_target, offset, buffer->size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT)
+            : 0;
+    if (mapped) {
+        memcpy(mapped, buffer->data, buffer->size);
+        m_unmapBuffer(m_target);
+    } else {
+        m_funcs->glBufferSubData(m_target, offset, buffer->size, buffer->data);
+    }
+
+    buffer->id = page->id;
+    buffer->page = page;
+    buffer->offset = offset;
+}
+
+void BufferPool::release(Buffer *buffer)
+{
+    Q_ASSERT(buffer->page);
+    RetiredRange r = { buffer->page, buffer->offset, (buffer->size + 15) & ~15, m_frame };
+    m_retired << r;
+    buffer->id = 0;
+    buffer->page = 0;
+    buffer->offset = 0;
+}
+
+/* Called once per frame, after the frame's draw calls have been issued.
+ * Makes ranges which are no longer in use available again and drops pages
+ * which have been left empty, keeping one around for the next upload.
+ */
+void BufferPool::endFrame()
+{
+    ++m_frame;
+
+    int kept = 0;
+    for (int i=0; i<m_retired.size(); ++i) {
+        const RetiredRange &r = m_retired.at(i);
+        if (m_frame - r.frame >= qsg_bufferFramesInFlight)
+            free(r.page, r.offset, r.size);
+        else
+            m_retired[kept++] = r;
+    }
+    m_retired.resize(kept);
+
+    for (int i=m_pages.size() - 1; i>=0 && m_pages.size() > 1; --i) {
+        BufferPage *page = m_pages.at(i);
+        if (page->used > 0)
+            continue;
+        bool retired = false;
+        for (int j=0; j<m_retired.size() && !retired; ++j)
+            retired = m_retired.at(j).page == page;
+        if (retired)
+            continue;
+        m_funcs->glDeleteBuffers(1, &page->id);
+        delete page;
+        m_pages.remove(i);
+    }
+}
+
 BatchRootInfo *Renderer::batchRootInfo(Node *node)
 {
     BatchRootInfo *info = node->rootInfo();
@@ -986,7 +1468,11 @@ void Renderer::nodeWasTransformed(Node *node, int *vertexCount)
                 if (!e->batch->isOpaque) {
                     invalidateBatchAndOverlappingRenderOrders(e->batch);
                 } else if (e->batch->merged) {
-                    e->batch->needsUpload = true;
+                    // Only the palette changes, unless the batch has to
+                    // switch to it first, see uploadBatch().
+                    e->animated = true;
+                    if (!e->batch->palette)
+                        e->batch->needsUpload = true;
                 }
             }
         }
@@ -1641,7 +2127,48 @@ void Renderer::prepareAlphaBatches()
  * iBase: The starting index for this element in the batch
  */
 
-void Renderer::uploadMergedElement(Element *e, int vaOffset, char **vertexData, char **zData, char **indexData, quint16 *iBase, int *indexCount)
+template <typename Index, typename SourceIndex>
+static inline void qsg_rebaseIndices(Index *indices, const SourceIndex *srcIndices, int count, quint32 iBase)
+{
+    for (int i=0; i<count; ++i)
+        indices[i] = iBase + srcIndices[i];
+}
+
+/* Writes the indices of \a g, offset by \a iBase, into the merged index
+ * type \a Index. Triangle strips get degenerate triangles around them.
+ * Returns the number of indices written.
+ */
+template <typename Index>
+static int qsg_rebaseIndices(const QSGGeometry *g, Index *indices, quint32 iBase)
+{
+    const bool strip = g->drawingMode() == GL_TRIANGLE_STRIP;
+    int iCount = g->indexCount();
+
+    if (iCount == 0) {
+        if (strip)
+            *indices++ = iBase;
+        iCount = g->vertexCount();
+        for (int i=0; i<iCount; ++i)
+            indices[i] = iBase + i;
+    } else if (g->indexType() == GL_UNSIGNED_INT) {
+        const quint32 *srcIndices = g->indexDataAsUInt();
+        if (strip)
+            *indices++ = iBase + srcIndices[0];
+        qsg_rebaseIndices(indices, srcIndices, iCount, iBase);
+    } else {
+        const quint16 *srcIndices = g->indexDataAsUShort();
+        if (strip)
+            *indices++ = iBase + srcIndices[0];
+        qsg_rebaseIndices(indices, srcIndices, iCount, iBase);
+    }
+    if (strip) {
+        indices[iCount] = indices[iCount - 1];
+        iCount += 2;
+    }
+    return iCount;
+}
+
+void Renderer::uploadMergedElement(Element *e, int vaOffset, char **vertexData, char **zData, char **indexData, quint32 *iBase, int *indexCount, char *paletteData, int paletteIndex)
 {
     if (Q_UNLIKELY(debug_upload)) qDebug() << "  - uploading element:" << e << e->node << (void *) *vertexData << (qintptr) (*zData - *vertexData) << (qintptr) (*indexData - *vertexData);
     QSGGeometry *g = e->node->geometry();
@@ -1652,9 +2179,13 @@ void Renderer::uploadMergedElement(Element *e, int vaOffset, char **vertexData,
     const int vSize = g->sizeOfVertex();
     memcpy(*vertexData, g->vertexData(), vSize * vCount);
 
-    // apply vertex transform..
+    // apply vertex transform, or leave it to the palette..
     char *vdata = *vertexData + vaOffset;
-    if (((const QMatrix4x4_Accessor &) localx).flagBits == 1) {
+    if (paletteIndex >= 0) {
+        float *vpalette = (float *) paletteData;
+        for (int i=0; i<vCount; ++i)
+            vpalette[i] = paletteIndex;
+    } else if (((const QMatrix4x4_Accessor &) localx).flagBits == 1) {
         for (int i=0; i<vCount; ++i) {
             Pt *p = (Pt *) vdata;
             p->x += ((QMatrix4x4_Accessor &) localx).m[3][0];
@@ -1662,10 +2193,36 @@ void Renderer::uploadMergedElement(Element *e, int vaOffset, char **vertexData,
             vdata += vSize;
         }
     } else if (((const QMatrix4x4_Accessor &) localx).flagBits > 1) {
+        // Same as Pt::map(), with the x/y pair in one register.
+        const float *m = localx.constData();
+#if defined(__SSE2__)
+        const __m128 c0 = _mm_castpd_ps(_mm_load_sd((const double *) m));
+        const __m128 c1 = _mm_castpd_ps(_mm_load_sd((const double *) (m + 4)));
+        const __m128 c3 = _mm_castpd_ps(_mm_load_sd((const double *) (m + 12)));
+        for (int i=0; i<vCount; ++i) {
+            const __m128 p = _mm_castpd_ps(_mm_load_sd((const double *) vdata));
+            const __m128 x = _mm_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 0, 0));
+            const __m128 y = _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1));
+            const __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, c0), _mm_mul_ps(y, c1)), c3);
+            _mm_store_sd((double *) vdata, _mm_castps_pd(r));
+            vdata += vSize;
+        }
+#elif defined(__ARM_NEON__)
+        const float32x2_t c0 = vld1_f32(m);
+        const float32x2_t c1 = vld1_f32(m + 4);
+        const float32x2_t c3 = vld1_f32(m + 12);
+        for (int i=0; i<vCount; ++i) {
+            const float32x2_t p = vld1_f32((const float *) vdata);
+            vst1_f32((float *) vdata, vmla_lane_f32(vmla_lane_f32(c3, c0, p, 0), c1, p, 1));
+            vdata += vSize;
+        }
+#else
+        Q_UNUSED(m);
         for (int i=0; i<vCount; ++i) {
             ((Pt *) vdata)->map(localx);
             vdata += vSize;
         }
+#endif
     }
 
     if (m_useDepthBuffer) {
@@ -1676,33 +2233,174 @@ void Renderer::uploadMergedElement(Element *e, int vaOffset, char **vertexData,
         *zData += vCount * sizeof(float);
     }
 
-    int iCount = g->indexCount();
-    quint16 *indices = (quint16 *) *indexData;
-
-    if (iCount == 0) {
-        if (g->drawingMode() == GL_TRIANGLE_STRIP)
-            *indices++ = *iBase;
-        iCount = vCount;
-        for (int i=0; i<iCount; ++i)
-            indices[i] = *iBase + i;
-    } else {
-        const quint16 *srcIndices = g->indexDataAsUShort();
-        if (g->drawingMode() == GL_TRIANGLE_STRIP)
-            *indices++ = *iBase + srcIndices[0];
-        for (int i=0; i<iCount; ++i)
-            indices[i] = *iBase + srcIndices[i];
-    }
-    if (g->drawingMode() == GL_TRIANGLE_STRIP) {
-        indices[iCount] = indices[iCount - 1];
-        iCount += 2;
-    }
+    int iCount;
+    if (m_mergedIndexType == GL_UNSIGNED_INT)
+        iCount = qsg_rebaseIndices(g, (quint32 *) *indexData, *iBase);
+    else
+        iCount = qsg_rebaseIndices(g, (quint16 *) *indexData, *iBase);
 
     *vertexData += vCount * vSize;
-    *indexData += iCount * sizeof(quint16);
+    *indexData += iCount * m_mergedIndexSize;
     *iBase += vCount;
     *indexCount += iCount;
 }
 
+class MergedUploadRunnable : public QRunnable
+{
+public:
+    MergedUploadRunnable(Renderer *renderer, int vaOffset, int from, int to)
+        : m_renderer(renderer)
+        , m_vaOffset(vaOffset)
+        , m_from(from)
+        , m_to(to)
+    {
+    }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        m_renderer->uploadMergedRange(m_vaOffset, m_from, m_to);
+    }
+
+private:
+    Renderer *m_renderer;
+    int m_vaOffset;
+    int m_from;
+    int m_to;
+};
+
+void Renderer::uploadMergedRange(int vaOffset, int from, int to)
+{
+    for (int i=from; i<to; ++i) {
+        const MergedUpload &u = m_mergedUploads.at(i);
+        char *vertexData = u.vertexData;
+        char *zData = u.zData;
+        char *indexData = u.indexData;
+        quint32 iBase = u.iBase;
+        int indexCount = 0;
+        uploadMergedElement(u.element, vaOffset, &vertexData, &zData, &indexData, &iBase, &indexCount, u.paletteData, u.paletteIndex);
+    }
+}
+
+/* Uploads the elements laid out in m_mergedUploads. The destinations do not
+ * overlap, so large batches are split in contiguous ranges which are handled
+ * by the upload pool and the render thread in parallel.
+ */
+void Renderer::uploadMergedElements(int vaOffset, int vertexCount)
+{
+    const int count = m_mergedUploads.size();
+    int jobs = 1;
+    if (m_uploadThreadCount > 0 && vertexCount >= 4 * m_batchVertexThreshold)
+        jobs = qMin(m_uploadThreadCount + 1, count);
+
+    if (jobs > 1 && !m_uploadPool) {
+        m_uploadPool = new QThreadPool();
+        m_uploadPool->setMaxThreadCount(m_uploadThreadCount);
+    }
+
+    int from = 0;
+    for (int j=1; j<jobs; ++j) {
+        int to = count * j / jobs;
+        m_uploadPool->start(new MergedUploadRunnable(this, vaOffset, from, to));
+        from = to;
+    }
+    uploadMergedRange(vaOffset, from, count);
+
+    if (jobs > 1)
+        m_uploadPool->waitForDone();
+}
+
+/* Returns true if the batch has at least \a minimumCount elements and they
+ * all have the same geometry, so that they can be drawn as instances.
+ */
+static bool qsg_hasIdenticalGeometry(const Batch *b, int minimumCount)
+{
+    const QSGGeometry *g = b->first->node->geometry();
+    const int vbs = g->vertexCount() * g->sizeOfVertex();
+    const int ibs = g->indexCount() * g->sizeOfIndex();
+    if (vbs == 0)
+        return false;
+
+    int count = 1;
+    for (const Element *e = b->first->nextInBatch; e; e = e->nextInBatch) {
+        const QSGGeometry *eg = e->node->geometry();
+        if (eg != g) {
+            if (eg->vertexCount() != g->vertexCount()
+                    || eg->indexCount() != g->indexCount()
+                    || eg->sizeOfVertex() != g->sizeOfVertex()
+                    || eg->indexType() != g->indexType()
+                    || eg->drawingMode() != g->drawingMode()
+                    || eg->lineWidth() != g->lineWidth()
+                    || eg->attributeCount() != g->attributeCount()
+                    || memcmp(eg->attributes(), g->attributes(), g->attributeCount() * sizeof(QSGGeometry::Attribute)) != 0
+                    || memcmp(eg->vertexData(), g->vertexData(), vbs) != 0
+                    || (ibs && memcmp(eg->indexData(), g->indexData(), ibs) != 0))
+                return false;
+        }
+        ++count;
+    }
+    return count >= minimumCount;
+}
+
+/* The part of the merging criteria which depends on the transforms of the
+ * elements, which may change without the batch being rebuilt.
+ */
+static bool qsg_isMergeSafe(Batch *b, QSGMaterial::Flags flags)
+{
+    for (Element *e = b->first; e; e = e->nextInBatch)
+        e->ensureBoundsValid();
+    return ((flags & QSGMaterial::RequiresFullMatrixExceptTranslate) == 0 || b->isTranslateOnlyToRoot())
+        && b->isSafeToBatch();
+}
+
+static bool qsg_hasAnimatedElement(const Batch *b)
+{
+    for (Element *e = b->first; e; e = e->nextInBatch) {
+        if (e->animated)
+            return true;
+    }
+    return false;
+}
+
+/* Returns true if the element is an axis aligned rectangle, which its
+ * material fills completely, so that it hides everything behind it.
+ */
+static bool qsg_isFilledRect(Element *e)
+{
+    QSGGeometryNode *gn = e->node;
+    QSGGeometry *g = gn->geometry();
+    if (g->drawingMode() != GL_TRIANGLE_STRIP || g->vertexCount() != 4 || g->indexCount() != 0
+        || gn->clipList() || !QMatrix4x4_Accessor::isScale(*gn->matrix()))
+        return false;
+
+    int offset = qsg_positionAttribute(g);
+    if (offset < 0)
+        return false;
+
+    Pt p[4];
+    Rect r;
+    r.set(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+    const char *vd = (const char *) g->vertexData() + offset;
+    for (int i=0; i<4; ++i) {
+        p[i] = *(const Pt *) vd;
+        r |= p[i];
+        vd += g->sizeOfVertex();
+    }
+    if (r.tl.x == r.br.x || r.tl.y == r.br.y)
+        return false;
+
+    for (int i=0; i<4; ++i) {
+        if ((p[i].x != r.tl.x && p[i].x != r.br.x) || (p[i].y != r.tl.y && p[i].y != r.br.y))
+            return false;
+    }
+
+    // The two triangles of the strip share the 1-2 edge, so for them to
+    // cover the rectangle, that edge and the 0-3 pair must be diagonals.
+    return p[0].x != p[3].x && p[0].y != p[3].y
+        && p[1].x != p[2].x && p[1].y != p[2].y
+        && (p[1].x != p[0].x || p[1].y != p[0].y)
+        && (p[1].x != p[3].x || p[1].y != p[3].y);
+}
+
 static QMatrix4x4 qsg_matrixForRoot(Node *node)
 {
     if (node->type() == QSGNode::TransformNodeType)
@@ -1714,6 +2412,14 @@ static QMatrix4x4 qsg_matrixForRoot(Node *node)
 
 void Renderer::uploadBatch(Batch *b)
 {
+        // A batch drawn with a matrix palette is only uploaded again when its
+        // elements have moved in a way that rules out merging them.
+        if (!b->needsUpload && b->palette && b->first
+            && !qsg_isMergeSafe(b, b->first->node->activeMaterial()->flags())) {
+            if (Q_UNLIKELY(debug_upload)) qDebug() << " Batch:" << b << "can no longer use its palette...";
+            b->needsUpload = true;
+        }
+
         // Early out if nothing has changed in this batch..
         if (!b->needsUpload) {
             if (Q_UNLIKELY(debug_upload)) qDebug() << " Batch:" << b << "already uploaded...";
@@ -1739,21 +2445,43 @@ void Renderer::uploadBatch(Batch *b)
         QSGMaterial::Flags flags = gn->activeMaterial()->flags();
         bool canMerge = (g->drawingMode() == GL_TRIANGLES || g->drawingMode() == GL_TRIANGLE_STRIP)
                         && b->positionAttribute >= 0
-                        && g->indexType() == GL_UNSIGNED_SHORT
+                        && (g->indexType() == GL_UNSIGNED_SHORT || g->indexType() == m_mergedIndexType)
                         && (flags & (QSGMaterial::CustomCompileStep | QSGMaterial_FullMatrix)) == 0
-                        && ((flags & QSGMaterial::RequiresFullMatrixExceptTranslate) == 0 || b->isTranslateOnlyToRoot())
-                        && b->isSafeToBatch();
-
-        b->merged = canMerge;
+                        && qsg_isMergeSafe(b, flags);
+
+        // Many elements with the same geometry are better drawn as instances
+        // of the first one than merged. This needs a material which only
+        // uses the matrix for gl_Position.
+        b->instanced = m_vertexAttribDivisor
+                       && (flags & (QSGMaterial::CustomCompileStep | QSGMaterial::RequiresDeterminant)) == 0
+                       && qsg_hasIdenticalGeometry(b, m_instanceThreshold);
+        b->merged = canMerge && !b->instanced;
+
+        // Opaque merged batches with elements which move on their own are
+        // better off transforming on the GPU, so moving them does not require
+        // a new upload. The vertex shader then sees untransformed positions,
+        // which only the stock materials are known not to care about.
+        b->palette = b->merged && b->isOpaque && m_useDepthBuffer && m_paletteSize > 0
+                     && m_visualizeMode == VisualizeNothing
+                     && isCullableMaterial(gn->activeMaterial(), false)
+                     && qsg_hasAnimatedElement(b);
 
         // Figure out how much memory we need...
         b->vertexCount = 0;
         b->indexCount = 0;
         int unmergedIndexSize = 0;
         Element *e = b->first;
+        const QSGGeometry *previous = 0;
 
         while (e) {
             QSGGeometry *eg = e->node->geometry();
+            // Unmerged elements which share their geometry with the previous
+            // element are drawn from its vertex and index data.
+            if (!b->merged && eg == previous) {
+                e = e->nextInBatch;
+                continue;
+            }
+            previous = eg;
             b->vertexCount += eg->vertexCount();
             int iCount = eg->indexCount();
             if (b->merged) {
@@ -1791,9 +2519,11 @@ void Renderer::uploadBatch(Batch *b)
         int bufferSize =  b->vertexCount * g->sizeOfVertex();
         int ibufferSize = 0;
         if (b->merged) {
-            ibufferSize = b->indexCount * sizeof(quint16);
+            ibufferSize = b->indexCount * m_mergedIndexSize;
             if (m_useDepthBuffer)
                 bufferSize += b->vertexCount * sizeof(float);
+            if (b->palette)
+                bufferSize += b->vertexCount * sizeof(float);
         } else {
             ibufferSize = unmergedIndexSize;
         }
@@ -1812,16 +2542,18 @@ void Renderer::uploadBatch(Batch *b)
         if (b->merged) {
             char *vertexData = b->vbo.data;
             char *zData = vertexData + b->vertexCount * g->sizeOfVertex();
+            char *paletteData = zData + (m_useDepthBuffer ? b->vertexCount * sizeof(float) : 0);
 #ifdef QSG_SEPARATE_INDEX_BUFFER
             char *indexData = b->ibo.data;
 #else
-            char *indexData = zData + (m_useDepthBuffer ? b->vertexCount * sizeof(float) : 0);
+            char *indexData = paletteData + (b->palette ? b->vertexCount * sizeof(float) : 0);
 #endif
 
-            quint16 iOffset = 0;
+            quint32 iOffset = 0;
             e = b->first;
             int verticesInSet = 0;
             int indicesInSet = 0;
+            int elementsInSet = 0;
             b->drawSets.reset();
 #ifdef QSG_SEPARATE_INDEX_BUFFER
             int drawSetIndices = 0;
@@ -1829,10 +2561,42 @@ void Renderer::uploadBatch(Batch *b)
             int drawSetIndices = indexData - vertexData;
 #endif
             b->drawSets << DrawSet(0, zData - vertexData, drawSetIndices);
+            b->drawSets.last().palette = paletteData - vertexData;
+            m_mergedUploads.reset();
+
+            // Bounds for culling the batch as a whole, see isCulled(). The
+            // elements of a palette batch move without it being uploaded.
+            const bool cullable = !b->palette && isCullableMaterial(gn->activeMaterial(), false);
+            const bool occluding = cullable && b->isOpaque && isCullableMaterial(gn->activeMaterial(), true);
+            float occluderArea = 0;
+            b->bounds.set(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+            b->occluderOrder = -1;
+
             while (e) {
-                verticesInSet  += e->node->geometry()->vertexCount();
-                if (verticesInSet > 0xffff) {
+                QSGGeometry *eg = e->node->geometry();
+                const int vCount = eg->vertexCount();
+
+                e->ensureBoundsValid();
+                if (cullable && QMatrix4x4_Accessor::is2DSafe(*e->node->matrix()))
+                    b->bounds |= e->bounds;
+                else
+                    b->bounds.set(-FLT_MAX, -FLT_MAX, FLT_MAX, FLT_MAX);
+                if (occluding && qsg_isFilledRect(e)) {
+                    float area = (e->bounds.br.x - e->bounds.tl.x) * (e->bounds.br.y - e->bounds.tl.y);
+                    if (area > occluderArea) {
+                        occluderArea = area;
+                        b->occluder = e->bounds;
+                        b->occluderOrder = e->order;
+                    }
+                }
+
+                verticesInSet  += vCount;
+                // 16-bit indices can only address 64K vertices per draw set,
+                // and each draw set has a palette of its own.
+                if ((m_mergedIndexType == GL_UNSIGNED_SHORT && verticesInSet > 0xffff)
+                    || (b->palette && elementsInSet == m_paletteSize)) {
                     b->drawSets.last().indexCount = indicesInSet;
+                    b->drawSets.last().elementCount = elementsInSet;
 #ifdef QSG_SEPARATE_INDEX_BUFFER
                     drawSetIndices = indexData - b->ibo.data;
 #else
@@ -1841,14 +2605,37 @@ void Renderer::uploadBatch(Batch *b)
                     b->drawSets << DrawSet(vertexData - b->vbo.data,
                                            zData - b->vbo.data,
                                            drawSetIndices);
+                    b->drawSets.last().palette = paletteData - b->vbo.data;
                     iOffset = 0;
-                    verticesInSet = e->node->geometry()->vertexCount();
+                    verticesInSet = vCount;
                     indicesInSet = 0;
+                    elementsInSet = 0;
                 }
-                uploadMergedElement(e, b->positionAttribute, &vertexData, &zData, &indexData, &iOffset, &indicesInSet);
+
+                // Lay out the element here, the actual upload follows below.
+                MergedUpload u = { e, vertexData, zData, indexData, iOffset,
+                                   paletteData, b->palette ? elementsInSet : -1 };
+                m_mergedUploads.add(u);
+
+                int iCount = eg->indexCount();
+                if (iCount == 0)
+                    iCount = vCount;
+                if (eg->drawingMode() == GL_TRIANGLE_STRIP)
+                    iCount += 2;
+                vertexData += vCount * eg->sizeOfVertex();
+                if (m_useDepthBuffer)
+                    zData += vCount * sizeof(float);
+                if (b->palette)
+                    paletteData += vCount * sizeof(float);
+                indexData += iCount * m_mergedIndexSize;
+                iOffset += vCount;
+                indicesInSet += iCount;
+                ++elementsInSet;
                 e = e->nextInBatch;
             }
             b->drawSets.last().indexCount = indicesInSet;
+            b->drawSets.last().elementCount = elementsInSet;
+            uploadMergedElements(b->positionAttribute, b->vertexCount);
         } else {
             char *vboData = b->vbo.data;
 #ifdef QSG_SEPARATE_INDEX_BUFFER
@@ -1857,8 +2644,14 @@ void Renderer::uploadBatch(Batch *b)
             char *iboData = vboData + b->vertexCount * g->sizeOfVertex();
 #endif
             Element *e = b->first;
+            const QSGGeometry *previous = 0;
             while (e) {
                 QSGGeometry *g = e->node->geometry();
+                if (g == previous) {
+                    e = e->nextInBatch;
+                    continue;
+                }
+                previous = g;
                 int vbs = g->vertexCount() * g->sizeOfVertex();
                 memcpy(vboData, g->vertexData(), vbs);
                 vboData = vboData + vbs;
@@ -1902,16 +2695,20 @@ void Renderer::uploadBatch(Batch *b)
                 vd += g->sizeOfVertex();
             }
 
-            const quint16 *id = (const quint16 *) (b->vbo.data
-                                                   + b->vertexCount * g->sizeOfVertex()
-                                                   + (b->merged ? b->vertexCount * sizeof(float) : 0));
+            const char *id = b->vbo.data
+                             + b->vertexCount * g->sizeOfVertex()
+                             + (b->merged ? b->vertexCount * sizeof(float) : 0);
+            const bool uintIndices = b->merged ? m_mergedIndexType == GL_UNSIGNED_INT : g->indexType() == GL_UNSIGNED_INT;
             {
                 QDebug iDump = qDebug();
                 iDump << "  -- Index Data, count:" << b->indexCount;
                 for (int i=0; i<b->indexCount; ++i) {
                     if ((i % 24) == 0)
                        iDump << endl << "  --- ";
-                 iDump << id[i];
+                 if (uintIndices)
+                     iDump << ((const quint32 *) id)[i];
+                 else
+                     iDump << ((const quint16 *) id)[i];
                 }
             }
 
@@ -1934,6 +2731,111 @@ void Renderer::uploadBatch(Batch *b)
             b->uploadedThisFrame = true;
 }
 
+bool Renderer::isCullableMaterial(const QSGMaterial *material, bool occluder) const
+{
+    const QSGMaterialType *type = material->type();
+    for (int i = 0; i < (occluder ? 4 : 6); ++i) {
+        if (m_cullableMaterialTypes[i] == type)
+            return true;
+    }
+    return false;
+}
+
+/* Maps a rectangle in GL window coordinates, as passed to glScissor(), to
+ * normalized device coordinates, the same way updateStencilClip() maps
+ * the other way.
+ */
+static Rect qsg_deviceToNormalized(const QRect &r, const QRect &deviceRect)
+{
+    Rect n;
+    n.set(r.x() * 2.0f / deviceRect.width() - 1.0f,
+          r.y() * 2.0f / deviceRect.height() - 1.0f,
+          (r.x() + r.width()) * 2.0f / deviceRect.width() - 1.0f,
+          (r.y() + r.height()) * 2.0f / deviceRect.height() - 1.0f);
+    return n;
+}
+
+static inline Rect qsg_intersected(const Rect &a, const Rect &b)
+{
+    Rect r;
+    r.set(qMax(a.tl.x, b.tl.x), qMax(a.tl.y, b.tl.y), qMin(a.br.x, b.br.x), qMin(a.br.y, b.br.y));
+    return r;
+}
+
+/* Sets up the visible area and the list of occluders for this frame.
+ * Occluders are the largest filled rectangle in each opaque merged
+ * batch, as long as it covers a reasonable part of the viewport. The
+ * opaque batches are drawn before everything they occlude, so whatever
+ * is completely behind one of them can be skipped.
+ */
+void Renderer::prepareCulling()
+{
+    m_occluders.reset();
+    m_culling = Q_LIKELY(!debug_noculling) && m_visualizeMode == VisualizeNothing
+                && deviceRect().width() > 0 && deviceRect().height() > 0;
+    if (!m_culling)
+        return;
+
+    m_cullRect.set(-1, -1, 1, 1);
+    if (m_scissor_rect.isValid())
+        m_cullRect = qsg_intersected(m_cullRect, qsg_deviceToNormalized(m_scissor_rect, deviceRect()));
+
+    // The smooth materials extend their geometry by about a pixel.
+    m_cullMargin.set(4.0f / deviceRect().width(), 4.0f / deviceRect().height());
+
+    if (Q_UNLIKELY(debug_noopaque))
+        return;
+
+    const QMatrix4x4 projection = projectionMatrix();
+    for (int i=0; i<m_opaqueBatches.size(); ++i) {
+        const Batch *b = m_opaqueBatches.at(i);
+        if (!b->merged || b->occluderOrder < 0 || !b->first)
+            continue;
+        const QMatrix4x4 m = b->root ? projection * qsg_matrixForRoot(b->root) : projection;
+        if (!QMatrix4x4_Accessor::isScale(m))
+            continue;
+        Occluder o;
+        o.rect = b->occluder;
+        o.rect.map(m);
+        o.order = b->occluderOrder;
+        // Small occluders rarely hide anything and only make the test slower
+        if (o.rect.isFinite() && (o.rect.br.x - o.rect.tl.x) * (o.rect.br.y - o.rect.tl.y) >= 0.25f)
+            m_occluders.add(o);
+    }
+
+    if (Q_UNLIKELY(debug_render))
+        qDebug() << " - culling with" << m_occluders.size() << "occluders";
+}
+
+/* Returns true if the rectangle, mapped to normalized device coordinates
+ * by matrix, lies outside the visible area or behind an occluder which
+ * is in front of order. The caller checks that matrix is 2D.
+ */
+bool Renderer::isCulled(const Rect &bounds, const QMatrix4x4 &matrix, int order) const
+{
+    Rect r = bounds;
+    r.map(matrix);
+    if (!r.isFinite())
+        return false;
+    r.tl.x -= m_cullMargin.x;
+    r.tl.y -= m_cullMargin.y;
+    r.br.x += m_cullMargin.x;
+    r.br.y += m_cullMargin.y;
+
+    Rect visible = m_cullRect;
+    if (m_currentClipType & ScissorClip)
+        visible = qsg_intersected(visible, qsg_deviceToNormalized(m_current_scissor_rect, deviceRect()));
+    if (!visible.intersects(r))
+        return true;
+
+    for (int i=0; i<m_occluders.size(); ++i) {
+        const Occluder &o = m_occluders.at(i);
+        if (o.order > order && o.rect.contains(r))
+            return true;
+    }
+    return false;
+}
+
 void Renderer::updateClip(const QSGClipNode *clipList, const Batch *batch)
 {
     if (clipList != m_currentClip && Q_LIKELY(!debug_noclip)) {
@@ -1954,6 +2856,24 @@ void Renderer::updateClip(const QSGClipNode *clipList, const Batch *batch)
     }
 }
 
+/* The attribute arrays of a shader are the material's own ones followed by
+ * the injected z attribute and palette index, when the shader has them.
+ */
+static int qsg_attributeArrayCount(QSGMaterialShader *program, const ShaderManager::Shader *shader)
+{
+    if (!program)
+        return 0;
+    if (shader && shader->pos_paletteIndex >= 0)
+        return shader->pos_paletteIndex + 1;
+    if (shader && shader->pos_order >= 0)
+        return shader->pos_order + 1;
+    const char * const *names = program->attributeNames();
+    int count = 0;
+    while (names[count])
+        ++count;
+    return count;
+}
+
 /*!
  * Look at the attribute arrays and potentially the injected z attribute to figure out
  * which vertex attribute arrays need to be enabled and not. Then update the current
@@ -1961,40 +2881,13 @@ void Renderer::updateClip(const QSGClipNode *clipList, const Batch *batch)
  */
 void Renderer::setActiveShader(QSGMaterialShader *program, ShaderManager::Shader *shader)
 {
-    const char * const *c = m_currentProgram ? m_currentProgram->attributeNames() : 0;
-    const char * const *n = program ? program->attributeNames() : 0;
-
-    int cza = m_currentShader ? m_currentShader->pos_order : -1;
-    int nza = shader ? shader->pos_order : -1;
+    const int c = qsg_attributeArrayCount(m_currentProgram, m_currentShader);
+    const int n = qsg_attributeArrayCount(program, shader);
 
-    int i = 0;
-    while (c || n) {
-
-        bool was = c;
-        if (cza == i) {
-            was = true;
-            c = 0;
-        } else if (c && !c[i]) { // end of the attribute array names
-            c = 0;
-            was = false;
-        }
-
-        bool is = n;
-        if (nza == i) {
-            is = true;
-            n = 0;
-        } else if (n && !n[i]) {
-            n = 0;
-            is = false;
-        }
-
-        if (is && !was)
-            glEnableVertexAttribArray(i);
-        else if (was && !is)
-            glDisableVertexAttribArray(i);
-
-        ++i;
-    }
+    for (int i = n; i < c; ++i)
+        glDisableVertexAttribArray(i);
+    for (int i = c; i < n; ++i)
+        glEnableVertexAttribArray(i);
 
     if (m_currentProgram)
         m_currentProgram->deactivate();
@@ -2048,6 +2941,16 @@ void Renderer::renderMergedBatch(const Batch *batch)
     // updateClip() uses m_current_projection_matrix.
     updateClip(gn->clipList(), batch);
 
+    if (m_culling) {
+        const QMatrix4x4 m = m_current_projection_matrix * m_current_model_view_matrix;
+        int order = batch->isOpaque ? e->order : batch->lastOrderInBatch;
+        if (QMatrix4x4_Accessor::is2DSafe(m) && isCulled(batch->bounds, m, order)) {
+            if (Q_UNLIKELY(debug_render))
+                qDebug() << "   culled";
+            return;
+        }
+    }
+
     glBindBuffer(GL_ARRAY_BUFFER, batch->vbo.id);
 
     char *indexBase = 0;
@@ -2060,12 +2963,28 @@ void Renderer::renderMergedBatch(const Batch *batch)
         indexBase = indexBuf->data;
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     } else {
+        indexBase = (char *) (qintptr) indexBuf->offset;
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuf->id);
     }
 
 
+    // The palette maps positions computed for the batch root to those of the
+    // elements, so it works with whatever the material's shader does with
+    // qt_Matrix: C * M * C^-1, where C is the root's combined matrix.
+    QMatrix4x4 paletteBase;
+    QMatrix4x4 paletteBaseInverse;
+    if (batch->palette) {
+        paletteBase = m_current_projection_matrix * m_current_model_view_matrix;
+        bool invertible = false;
+        paletteBaseInverse = paletteBase.inverted(&invertible);
+        if (!invertible)
+            return; // the root collapses everything, there is nothing to see
+    }
+
     QSGMaterial *material = gn->activeMaterial();
-    ShaderManager::Shader *sms = m_useDepthBuffer ? m_shaderManager->prepareMaterial(material) : m_shaderManager->prepareMaterialNoRewrite(material);
+    ShaderManager::Shader *sms = batch->palette
+            ? m_shaderManager->prepareMaterialPalette(material, m_paletteSize)
+            : (m_useDepthBuffer ? m_shaderManager->prepareMaterial(material) : m_shaderManager->prepareMaterialNoRewrite(material));
     if (!sms)
         return;
     QSGMaterialShader *program = sms->program;
@@ -2100,7 +3019,7 @@ void Renderer::renderMergedBatch(const Batch *batch)
     char const *const *attrNames = program->attributeNames();
     for (int i=0; i<batch->drawSets.size(); ++i) {
         const DrawSet &draw = batch->drawSets.at(i);
-        int offset = 0;
+        int offset = batch->vbo.offset;
         for (int j = 0; attrNames[j]; ++j) {
             if (!*attrNames[j])
                 continue;
@@ -2110,9 +3029,23 @@ void Renderer::renderMergedBatch(const Batch *batch)
             offset += a.tupleSize * size_of_type(a.type);
         }
         if (m_useDepthBuffer)
-            glVertexAttribPointer(sms->pos_order, 1, GL_FLOAT, false, 0, (void *) (qintptr) (draw.zorders));
+            glVertexAttribPointer(sms->pos_order, 1, GL_FLOAT, false, 0, (void *) (qintptr) (batch->vbo.offset + draw.zorders));
+
+        if (batch->palette) {
+            m_paletteMatrices.reset();
+            for (int k=0; k<draw.elementCount; ++k) {
+                const QMatrix4x4 m = paletteBase * *e->node->matrix() * paletteBaseInverse;
+                const float *d = m.constData();
+                for (int c=0; c<16; ++c)
+                    m_paletteMatrices.add(d[c]);
+                e = e->nextInBatch;
+            }
+            glUniformMatrix4fv(sms->id_palette, draw.elementCount, GL_FALSE, m_paletteMatrices.data());
+            glVertexAttribPointer(sms->pos_paletteIndex, 1, GL_FLOAT, false, 0, (void *) (qintptr) (batch->vbo.offset + draw.palette));
+        }
 
-        glDrawElements(g->drawingMode(), draw.indexCount, GL_UNSIGNED_SHORT, (void *) (qintptr) (indexBase + draw.indices));
+        glDrawElements(g->drawingMode(), draw.indexCount, m_mergedIndexType, (void *) (qintptr) (indexBase + draw.indices));
+        ++m_frame_statistics.drawCalls;
     }
 }
 
@@ -2130,7 +3063,7 @@ void Renderer::renderUnmergedBatch(const Batch *batch)
                  << (batch->uploadedThisFrame ? "[  upload]" : "[retained]")
                  << (e->node->clipList() ? "[  clip]" : "[noclip]")
                  << (batch->isOpaque ? "[opaque]" : "[ alpha]")
-                 << "[unmerged]"
+                 << (batch->instanced ? "[instanced]" : "[unmerged]")
                  << " Nodes:" << QString::fromLatin1("%1").arg(qsg_countNodesInBatch(batch), 4).toLatin1().constData()
                  << " Vertices:" << QString::fromLatin1("%1").arg(batch->vertexCount, 5).toLatin1().constData()
                  << " Indices:" << QString::fromLatin1("%1").arg(batch->indexCount, 5).toLatin1().constData()
@@ -2156,10 +3089,14 @@ void Renderer::renderUnmergedBatch(const Batch *batch)
             indexBase = indexBuf->data;
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
         } else {
+            indexBase = (char *) (qintptr) indexBuf->offset;
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuf->id);
         }
     }
 
+    if (batch->instanced && renderInstancedBatch(batch, indexBase))
+        return;
+
     // We always have dirty matrix as all batches are at a unique z range.
     QSGMaterialShader::RenderState::DirtyStates dirty = QSGMaterialShader::RenderState::DirtyMatrix;
 
@@ -2178,7 +3115,7 @@ void Renderer::renderUnmergedBatch(const Batch *batch)
         sms->lastOpacity = m_current_opacity;
     }
 
-    int vOffset = 0;
+    int vOffset = batch->vbo.offset;
 #ifdef QSG_SEPARATE_INDEX_BUFFER
     char *iOffset = indexBase;
 #else
@@ -2187,8 +3124,32 @@ void Renderer::renderUnmergedBatch(const Batch *batch)
 
     QMatrix4x4 rootMatrix = batch->root ? qsg_matrixForRoot(batch->root) : QMatrix4x4();
 
+    // Elements are culled one by one, their bounds are relative to the root.
+    const QMatrix4x4 cullMatrix = projectionMatrix() * rootMatrix;
+    const bool culling = m_culling && QMatrix4x4_Accessor::is2DSafe(cullMatrix)
+                         && isCullableMaterial(material, false);
+
+    const QSGGeometry *previous = 0;
     while (e) {
         gn = e->node;
+        QSGGeometry* g = gn->geometry();
+
+        // Shared geometry is only present once, see uploadBatch().
+        if (previous && g != previous) {
+            vOffset += previous->sizeOfVertex() * previous->vertexCount();
+            iOffset += previous->indexCount() * previous->sizeOfIndex();
+        }
+        previous = g;
+
+        if (culling && QMatrix4x4_Accessor::is2DSafe(*gn->matrix())
+            && (g->drawingMode() == GL_TRIANGLES || g->drawingMode() == GL_TRIANGLE_STRIP
+                || g->drawingMode() == GL_TRIANGLE_FAN)) {
+            e->ensureBoundsValid();
+            if (isCulled(e->bounds, cullMatrix, e->order)) {
+                e = e->nextInBatch;
+                continue;
+            }
+        }
 
         m_current_model_view_matrix = rootMatrix * *gn->matrix();
         m_current_determinant = m_current_model_view_matrix.determinant();
@@ -2215,7 +3176,6 @@ void Renderer::renderUnmergedBatch(const Batch *batch)
         // are all identical (compare==0) since they are in the same batch.
         m_currentMaterial = material;
 
-        QSGGeometry* g = gn->geometry();
         char const *const *attrNames = program->attributeNames();
         int offset = 0;
         for (int j = 0; attrNames[j]; ++j) {
@@ -2238,9 +3198,7 @@ void Renderer::renderUnmergedBatch(const Batch *batch)
             glDrawElements(g->drawingMode(), g->indexCount(), g->indexType(), iOffset);
         else
             glDrawArrays(g->drawingMode(), 0, g->vertexCount());
-
-        vOffset += g->sizeOfVertex() * g->vertexCount();
-        iOffset += g->indexCount() * g->sizeOfIndex();
+        ++m_frame_statistics.drawCalls;
 
         // We only need to push this on the very first iteration...
         dirty &= ~QSGMaterialShader::RenderState::DirtyOpacity;
@@ -2249,6 +3207,126 @@ void Renderer::renderUnmergedBatch(const Batch *batch)
     }
 }
 
+/* Draws all elements of the batch as instances of the first one, which is
+ * at the start of the batch's buffers. The material is set up for the first
+ * element, and the per-instance matrix maps its clip space position to
+ * that of the other elements. Returns false, without drawing anything,
+ * when the elements can't be drawn this way this frame.
+ */
+bool Renderer::renderInstancedBatch(const Batch *batch, char *indexBase)
+{
+    Element *e = batch->first;
+    QSGGeometryNode *gn = e->node;
+
+    // The opacity is a uniform, so it must be the same for all instances.
+    const float opacity = gn->inheritedOpacity();
+    int instanceCount = 0;
+    for (const Element *i = e; i; i = i->nextInBatch) {
+        if (i->node->inheritedOpacity() != opacity)
+            return false;
+        ++instanceCount;
+    }
+
+    QMatrix4x4 rootMatrix = batch->root ? qsg_matrixForRoot(batch->root) : QMatrix4x4();
+
+    m_current_model_view_matrix = rootMatrix * *gn->matrix();
+    m_current_determinant = m_current_model_view_matrix.determinant();
+    m_current_projection_matrix = projectionMatrix();
+    if (m_useDepthBuffer) {
+        m_current_projection_matrix(2, 2) = m_zRange;
+        m_current_projection_matrix(2, 3) = 1.0f - e->order * m_zRange;
+    }
+
+    bool invertible = false;
+    const QMatrix4x4 inverse = (m_current_projection_matrix * m_current_model_view_matrix).inverted(&invertible);
+    if (!invertible)
+        return false;
+
+    QSGMaterial *material = gn->activeMaterial();
+    ShaderManager::Shader *sms = m_shaderManager->prepareMaterialInstanced(material);
+    if (!sms)
+        return false;
+
+    m_instanceMatrices.resize(instanceCount * 16);
+    float *instanceData = m_instanceMatrices.data();
+    for (const Element *i = e; i; i = i->nextInBatch) {
+        QMatrix4x4 projection = projectionMatrix();
+        if (m_useDepthBuffer) {
+            projection(2, 2) = m_zRange;
+            projection(2, 3) = 1.0f - i->order * m_zRange;
+        }
+        const QMatrix4x4 instanceMatrix = projection * rootMatrix * *i->node->matrix() * inverse;
+        memcpy(instanceData, instanceMatrix.constData(), 16 * sizeof(float));
+        instanceData += 16;
+    }
+
+    QSGMaterialShader *program = sms->program;
+    if (sms != m_currentShader)
+        setActiveShader(program, sms);
+
+    QSGMaterialShader::RenderState::DirtyStates dirty = QSGMaterialShader::RenderState::DirtyMatrix;
+    m_current_opacity = opacity;
+    if (sms->lastOpacity != m_current_opacity) {
+        dirty |= QSGMaterialShader::RenderState::DirtyOpacity;
+        sms->lastOpacity = m_current_opacity;
+    }
+
+    program->updateState(state(dirty), material, m_currentMaterial);
+    m_currentMaterial = material;
+
+    QSGGeometry *g = gn->geometry();
+    char const *const *attrNames = program->attributeNames();
+    int offset = batch->vbo.offset;
+    for (int j = 0; attrNames[j]; ++j) {
+        if (!*attrNames[j])
+            continue;
+        const QSGGeometry::Attribute &a = g->attributes()[j];
+        GLboolean normalize = a.type != GL_FLOAT && a.type != GL_DOUBLE;
+        glVertexAttribPointer(a.position, a.tupleSize, a.type, normalize, g->sizeOfVertex(), (void *) (qintptr) offset);
+        offset += a.tupleSize * size_of_type(a.type);
+    }
+
+    if (!m_instanceBuffer)
+        glGenBuffers(1, &m_instanceBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, instanceCount * 16 * sizeof(float), m_instanceMatrices.data(), GL_STREAM_DRAW);
+    m_frame_statistics.uploadedBytes += instanceCount * 16 * sizeof(float);
+
+    // A mat4 attribute takes four consecutive locations, one per column.
+    const int location = sms->pos_instanceMatrix;
+    for (int c = 0; c < 4; ++c) {
+        glEnableVertexAttribArray(location + c);
+        glVertexAttribPointer(location + c, 4, GL_FLOAT, false, 16 * sizeof(float), (void *) (qintptr) (c * 4 * sizeof(float)));
+        m_vertexAttribDivisor(location + c, 1);
+    }
+
+    if (g->drawingMode() == GL_LINE_STRIP || g->drawingMode() == GL_LINE_LOOP || g->drawingMode() == GL_LINES)
+        glLineWidth(g->lineWidth());
+#if !defined(QT_OPENGL_ES_2)
+    else if (!QOpenGLContext::currentContext()->isOpenGLES() && g->drawingMode() == GL_POINTS)
+        glPointSize(g->lineWidth());
+#endif
+
+#ifdef QSG_SEPARATE_INDEX_BUFFER
+    char *iOffset = indexBase;
+#else
+    char *iOffset = indexBase + batch->vertexCount * g->sizeOfVertex();
+#endif
+    if (g->indexCount())
+        m_drawElementsInstanced(g->drawingMode(), g->indexCount(), g->indexType(), iOffset, instanceCount);
+    else
+        m_drawArraysInstanced(g->drawingMode(), 0, g->vertexCount(), instanceCount);
+    ++m_frame_statistics.drawCalls;
+
+    for (int c = 0; c < 4; ++c) {
+        m_vertexAttribDivisor(location + c, 0);
+        glDisableVertexAttribArray(location + c);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, batch->vbo.id);
+
+    return true;
+}
+
 void Renderer::renderBatches()
 {
     if (Q_UNLIKELY(debug_render)) {
@@ -2277,7 +3355,7 @@ void Renderer::renderBatches()
     }
     glDisable(GL_CULL_FACE);
     glColorMask(true, true, true, true);
-    glDisable(GL_SCISSOR_TEST);
+    enableScissorRect();
     glDisable(GL_STENCIL_TEST);
 
     bindable()->clear(clearMode());
@@ -2287,10 +3365,15 @@ void Renderer::renderBatches()
     m_currentShader = 0;
     m_currentProgram = 0;
     m_currentClip = 0;
+    m_currentClipType = NoClip;
 
     bool renderOpaque = !debug_noopaque;
     bool renderAlpha = !debug_noalpha;
 
+    m_frame_statistics.batches += m_opaqueBatches.size() + m_alphaBatches.size();
+
+    prepareCulling();
+
     if (Q_LIKELY(renderOpaque)) {
         for (int i=0; i<m_opaqueBatches.size(); ++i) {
             Batch *b = m_opaqueBatches.at(i);
@@ -2492,6 +3575,13 @@ void Renderer::render()
 
     renderBatches();
 
+    if (m_vertexBufferPool) {
+        m_vertexBufferPool->endFrame();
+#ifdef QSG_SEPARATE_INDEX_BUFFER
+        m_indexBufferPool->endFrame();
+#endif
+    }
+
     m_rebuild = 0;
     m_renderOrderRebuildLower = -1;
     m_renderOrderRebuildUpper = -1;
@@ -2656,18 +3746,21 @@ void Renderer::visualizeBatch(Batch *b)
         for (int ds=0; ds<b->drawSets.size(); ++ds) {
             const DrawSet &set = b->drawSets.at(ds);
             glVertexAttribPointer(a.position, 2, a.type, false, g->sizeOfVertex(), (void *) (qintptr) (set.vertices));
-            glDrawElements(g->drawingMode(), set.indexCount, GL_UNSIGNED_SHORT, (void *) (qintptr) (b->vbo.data + set.indices));
+            glDrawElements(g->drawingMode(), set.indexCount, m_mergedIndexType, (void *) (qintptr) (b->vbo.data + set.indices));
         }
     } else {
         Element *e = b->first;
-        int offset = 0;
+        int offset = b->vbo.offset;
+        const QSGGeometry *previous = 0;
         while (e) {
             gn = e->node;
             g = gn->geometry();
+            if (previous && g != previous)
+                offset += previous->sizeOfVertex() * previous->vertexCount();
+            previous = g;
             shader->setUniformValue(shader->matrix, matrix * *gn->matrix());
             glVertexAttribPointer(a.position, a.tupleSize, a.type, false, g->sizeOfVertex(), (void *) (qintptr) offset);
             glDrawElements(g->drawingMode(), g->indexCount(), g->indexType(), g->indexData());
-            offset += g->sizeOfVertex() * g->vertexCount();
             e = e->nextInBatch;
         }
     }
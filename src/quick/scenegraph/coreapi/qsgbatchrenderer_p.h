@@ -49,10 +49,12 @@
 #include <private/qsgrendernode_p.h>
 
 #include <QtCore/QBitArray>
+#include <QtCore/QVector>
 
 QT_BEGIN_NAMESPACE
 
 class QOpenGLVertexArrayObject;
+class QThreadPool;
 
 namespace QSGBatchRenderer
 {
@@ -62,6 +64,7 @@ namespace QSGBatchRenderer
 struct Vec;
 struct Rect;
 struct Buffer;
+struct BufferPage;
 struct Chunk;
 struct Batch;
 struct Node;
@@ -241,12 +244,20 @@ struct Rect {
         br.set(right, bottom);
     }
 
-    bool intersects(const Rect &r) {
+    bool intersects(const Rect &r) const {
         bool xOverlap = r.tl.x < br.x && r.br.x > tl.x;
         bool yOverlap = r.tl.y < br.y && r.br.y > tl.y;
         return xOverlap && yOverlap;
     }
 
+    bool contains(const Rect &r) const {
+        return r.tl.x >= tl.x && r.br.x <= br.x && r.tl.y >= tl.y && r.br.y <= br.y;
+    }
+
+    bool isFinite() const {
+        return qIsFinite(tl.x) && qIsFinite(tl.y) && qIsFinite(br.x) && qIsFinite(br.y);
+    }
+
     bool isOutsideFloatRange() const {
         return tl.x < -QSG_RENDERER_COORD_LIMIT
                 || tl.y < -QSG_RENDERER_COORD_LIMIT
@@ -263,6 +274,10 @@ inline QDebug operator << (QDebug d, const Rect &r) {
 struct Buffer {
     GLuint id;
     int size;
+    // With the pooled buffer strategy, the data lives at offset in a buffer
+    // object owned by a BufferPool and shared with other batches.
+    BufferPage *page;
+    int offset;
     // Data is only valid while preparing the upload. Exception is if we are using the
     // broken IBO workaround or we are using a visualization mode.
     char *data;
@@ -283,6 +298,7 @@ struct Element {
         , orphaned(false)
         , isRenderNode(false)
         , isMaterialBlended(false)
+        , animated(false)
     {
     }
 
@@ -313,6 +329,7 @@ struct Element {
     uint orphaned : 1;
     uint isRenderNode : 1;
     uint isMaterialBlended : 1;
+    uint animated : 1; // has had its transform changed inside a merged batch
 };
 
 struct RenderNodeElement : public Element {
@@ -347,13 +364,31 @@ struct DrawSet
         , zorders(z)
         , indices(i)
         , indexCount(0)
+        , palette(0)
+        , elementCount(0)
     {
     }
-    DrawSet() : vertices(0), zorders(0), indices(0), indexCount(0) {}
+    DrawSet() : vertices(0), zorders(0), indices(0), indexCount(0), palette(0), elementCount(0) {}
     int vertices;
     int zorders;
     int indices;
     int indexCount;
+    int palette; // palette indices, only for batches using a matrix palette
+    int elementCount;
+};
+
+/* Destination of one element in a merged batch, laid out up front so
+   that the elements can be transformed and copied in parallel.
+ */
+struct MergedUpload
+{
+    Element *element;
+    char *vertexData;
+    char *zData;
+    char *indexData;
+    quint32 iBase;
+    char *paletteData;
+    int paletteIndex; // -1 when the vertices are transformed here instead
 };
 
 enum BatchCompatibility
@@ -382,6 +417,9 @@ struct Batch
         isOpaque = false;
         needsUpload = false;
         merged = false;
+        instanced = false;
+        palette = false;
+        occluderOrder = -1;
         positionAttribute = -1;
         uploadedThisFrame = false;
         isRenderNode = false;
@@ -400,6 +438,8 @@ struct Batch
     uint isOpaque : 1;
     uint needsUpload : 1;
     uint merged : 1;
+    uint instanced : 1; // unmerged, drawn as instances of its first element
+    uint palette : 1; // merged, vertices left untransformed and drawn with a matrix palette
     uint isRenderNode : 1;
 
     mutable uint uploadedThisFrame : 1; // solely for debugging purposes
@@ -410,6 +450,17 @@ struct Batch
 #endif
 
     QDataBuffer<DrawSet> drawSets;
+
+    // Set up by uploadBatch() for merged batches, relative to the root.
+    Rect bounds;
+    Rect occluder; // largest filled, opaque rectangle in the batch
+    int occluderOrder; // -1 when there is none
+};
+
+struct Occluder
+{
+    Rect rect; // in normalized device coordinates
+    int order;
 };
 
 struct Node
@@ -496,6 +547,9 @@ public:
         ~Shader() { delete program; }
         int id_zRange;
         int pos_order;
+        int pos_instanceMatrix;
+        int pos_paletteIndex;
+        int id_palette;
         QSGMaterialShader *program;
 
         float lastOpacity;
@@ -505,6 +559,8 @@ public:
     ~ShaderManager() {
         qDeleteAll(rewrittenShaders.values());
         qDeleteAll(stockShaders.values());
+        qDeleteAll(instancedShaders.values());
+        qDeleteAll(paletteShaders.values());
     }
 
 public Q_SLOTS:
@@ -513,15 +569,73 @@ public Q_SLOTS:
 public:
     Shader *prepareMaterial(QSGMaterial *material);
     Shader *prepareMaterialNoRewrite(QSGMaterial *material);
+    Shader *prepareMaterialInstanced(QSGMaterial *material);
+    Shader *prepareMaterialPalette(QSGMaterial *material, int paletteSize);
+
+    static QSGMaterialShader *compileShader(QSGRenderContext *context, QSGMaterial *material, bool rewrite);
 
     QHash<QSGMaterialType *, Shader *> rewrittenShaders;
     QHash<QSGMaterialType *, Shader *> stockShaders;
+    QHash<QSGMaterialType *, Shader *> instancedShaders;
+    QHash<QSGMaterialType *, Shader *> paletteShaders;
 
     QOpenGLShaderProgram *blitProgram;
     QOpenGLShaderProgram *visualizeProgram;
     QSGRenderContext *context;
 };
 
+typedef void *(QOPENGLF_APIENTRYP QSGMapBufferRangeFunc)(GLenum target, qopengl_GLintptr offset, qopengl_GLsizeiptr length, GLbitfield access);
+typedef GLboolean (QOPENGLF_APIENTRYP QSGUnmapBufferFunc)(GLenum target);
+
+struct BufferPage
+{
+    GLuint id;
+    int size;
+    int used;
+    QVector<QPair<int, int> > free; // offset and size, sorted by offset
+};
+
+/* Sub-allocates batch data from a few large buffer objects, so that
+ * re-uploading a batch never respecifies a buffer. A range which is given
+ * back is only reused once the frames which may still read from it have
+ * been completed.
+ */
+class BufferPool
+{
+public:
+    BufferPool(GLenum target, QOpenGLFunctions *funcs, QSGMapBufferRangeFunc mapBufferRange, QSGUnmapBufferFunc unmapBuffer);
+    ~BufferPool();
+
+    void upload(Buffer *buffer);
+    void release(Buffer *buffer);
+    void endFrame();
+
+    int pageCount() const { return m_pages.size(); }
+
+private:
+    struct RetiredRange {
+        BufferPage *page;
+        int offset;
+        int size;
+        uint frame;
+    };
+
+    BufferPage *allocate(int size, int *offset);
+    void free(BufferPage *page, int offset, int size);
+
+    GLenum m_target;
+    QOpenGLFunctions *m_funcs;
+    QSGMapBufferRangeFunc m_mapBufferRange;
+    QSGUnmapBufferFunc m_unmapBuffer;
+    QVector<BufferPage *> m_pages;
+    QVector<RetiredRange> m_retired;
+    uint m_frame;
+};
+
+typedef void (QOPENGLF_APIENTRYP QSGVertexAttribDivisorFunc)(GLuint index, GLuint divisor);
+typedef void (QOPENGLF_APIENTRYP QSGDrawArraysInstancedFunc)(GLenum mode, GLint first, GLsizei count, GLsizei primcount);
+typedef void (QOPENGLF_APIENTRYP QSGDrawElementsInstancedFunc)(GLenum mode, GLsizei count, GLenum type, const GLvoid *indices, GLsizei primcount);
+
 class Q_QUICK_PRIVATE_EXPORT Renderer : public QSGRenderer
 {
 public:
@@ -542,6 +656,8 @@ protected:
     void render();
 
 private:
+    friend class MergedUploadRunnable;
+
     enum RebuildFlag {
         BuildRenderListsForTaggedRoots      = 0x0001,
         BuildRenderLists                    = 0x0002,
@@ -553,6 +669,7 @@ private:
 
     void map(Buffer *buffer, int size, bool isIndexBuf = false);
     void unmap(Buffer *buffer, bool isIndexBuf = false);
+    BufferPool *bufferPool(bool isIndexBuf) const;
 
     void buildRenderListsFromScratch();
     void buildRenderListsForTaggedRoots();
@@ -567,11 +684,17 @@ private:
     void invalidateBatchAndOverlappingRenderOrders(Batch *batch);
 
     void uploadBatch(Batch *b);
-    void uploadMergedElement(Element *e, int vaOffset, char **vertexData, char **zData, char **indexData, quint16 *iBase, int *indexCount);
+    void uploadMergedElement(Element *e, int vaOffset, char **vertexData, char **zData, char **indexData, quint32 *iBase, int *indexCount, char *paletteData, int paletteIndex);
+    void uploadMergedElements(int vaOffset, int vertexCount);
+    void uploadMergedRange(int vaOffset, int from, int to);
 
     void renderBatches();
     void renderMergedBatch(const Batch *batch);
     void renderUnmergedBatch(const Batch *batch);
+    bool renderInstancedBatch(const Batch *batch, char *indexBase);
+    void prepareCulling();
+    bool isCulled(const Rect &bounds, const QMatrix4x4 &matrix, int order) const;
+    bool isCullableMaterial(const QSGMaterial *material, bool occluder) const;
     void updateClip(const QSGClipNode *clipList, const Batch *batch);
     const QMatrix4x4 &matrixForRoot(Node *node);
     void renderRenderNode(Batch *batch);
@@ -625,9 +748,39 @@ private:
     int m_renderOrderRebuildUpper;
 
     GLuint m_bufferStrategy;
+    BufferPool *m_vertexBufferPool; // only with QSG_RENDERER_BUFFER_STRATEGY=pooled
+#ifdef QSG_SEPARATE_INDEX_BUFFER
+    BufferPool *m_indexBufferPool;
+#endif
     int m_batchNodeThreshold;
     int m_batchVertexThreshold;
 
+    GLenum m_mergedIndexType;
+    int m_mergedIndexSize;
+
+    QDataBuffer<MergedUpload> m_mergedUploads;
+    QThreadPool *m_uploadPool;
+    int m_uploadThreadCount;
+
+    // Matrix palette for merged batches with animated elements
+    int m_paletteSize;
+    QDataBuffer<float> m_paletteMatrices;
+
+    // Culling, set up at the start of each frame
+    bool m_culling;
+    Rect m_cullRect;
+    Pt m_cullMargin;
+    QDataBuffer<Occluder> m_occluders;
+    QSGMaterialType *m_cullableMaterialTypes[6]; // the first four can occlude
+
+    // Instanced rendering, resolved when the context supports it
+    int m_instanceThreshold;
+    QSGVertexAttribDivisorFunc m_vertexAttribDivisor;
+    QSGDrawArraysInstancedFunc m_drawArraysInstanced;
+    QSGDrawElementsInstancedFunc m_drawElementsInstanced;
+    GLuint m_instanceBuffer;
+    QDataBuffer<float> m_instanceMatrices;
+
     // Stuff used during rendering only...
     ShaderManager *m_shaderManager;
     QSGMaterial *m_currentMaterial;
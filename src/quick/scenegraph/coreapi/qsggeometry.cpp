@@ -42,6 +42,12 @@
 #include "qsggeometry.h"
 #include "qsggeometry_p.h"
 
+#include <private/qsgblockpool_p.h>
+#include "qsgnode.h"
+
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+
 #include <qopenglcontext.h>
 #include <qopenglfunctions.h>
 #include <private/qopenglextensions_p.h>
@@ -404,6 +410,7 @@ QSGGeometry::QSGGeometry(const QSGGeometry::AttributeSet &attributes,
     , m_owns_data(false)
     , m_index_usage_pattern(AlwaysUploadPattern)
     , m_vertex_usage_pattern(AlwaysUploadPattern)
+    , m_is_shared(false)
     , m_line_width(1.0)
 {
     Q_UNUSED(m_reserved_bits);
@@ -447,6 +454,15 @@ QSGGeometry::QSGGeometry(const QSGGeometry::AttributeSet &attributes,
     \c GL_UNSIGNED_INT with the value \c 4 is also supported.
  */
 
+/*
+    Returns the size of the vertex and index data block owned by a geometry.
+ */
+static inline size_t qsg_dataByteSize(int stride, int vertexCount, int indexType, int indexCount)
+{
+    const int indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(quint16) : sizeof(quint32);
+    return size_t(stride) * vertexCount + size_t(qMax(indexCount, 0)) * indexSize;
+}
+
 /*!
     Destroys the geometry object and the vertex and index data it has allocated.
  */
@@ -454,7 +470,8 @@ QSGGeometry::QSGGeometry(const QSGGeometry::AttributeSet &attributes,
 QSGGeometry::~QSGGeometry()
 {
     if (m_owns_data)
-        free(m_data);
+        QSGBlockPool::release(m_data, qsg_dataByteSize(m_attributes.stride, m_vertex_count,
+                                                       m_index_type, m_index_count));
 
     if (m_server_data)
         delete m_server_data;
@@ -578,23 +595,26 @@ void QSGGeometry::allocate(int vertexCount, int indexCount)
     if (vertexCount == m_vertex_count && indexCount == m_index_count)
         return;
 
+    if (m_owns_data)
+        QSGBlockPool::release(m_data, qsg_dataByteSize(m_attributes.stride, m_vertex_count,
+                                                       m_index_type, m_index_count));
+
     m_vertex_count = vertexCount;
     m_index_count = indexCount;
 
     bool canUsePrealloc = m_index_count <= 0;
     int vertexByteSize = m_attributes.stride * m_vertex_count;
 
-    if (m_owns_data)
-        free(m_data);
-
     if (canUsePrealloc && vertexByteSize <= (int) sizeof(m_prealloc)) {
         m_data = (void *) &m_prealloc[0];
         m_index_data_offset = -1;
         m_owns_data = false;
     } else {
         Q_ASSERT(m_index_type == GL_UNSIGNED_INT || m_index_type == GL_UNSIGNED_SHORT);
-        int indexByteSize = indexCount * (m_index_type == GL_UNSIGNED_SHORT ? sizeof(quint16) : sizeof(quint32));
-        m_data = (void *) malloc(vertexByteSize + indexByteSize);
+        // Vertex and index data is taken from the block pool, so the small
+        // geometries created and destroyed with delegates reuse storage.
+        m_data = QSGBlockPool::allocate(qsg_dataByteSize(m_attributes.stride, m_vertex_count,
+                                                         m_index_type, m_index_count));
         m_index_data_offset = vertexByteSize;
         m_owns_data = true;
     }
@@ -771,4 +791,165 @@ void QSGGeometry::markVertexDataDirty()
 }
 
 
+/*!
+    \class QSGSharedGeometry
+    \internal
+
+    A reference counted, immutable geometry which several nodes can point to.
+
+    Nodes with identical geometry, such as images of the same size or
+    nine-patches with the same layout, end up pointing to the same object.
+    The batch renderer recognizes these by identity: they are uploaded once
+    per unmerged batch and are drawn as instances without comparing the
+    vertex data.
+
+    A node holding a shared geometry with QSGNode::OwnsGeometry set releases
+    its reference instead of deleting the geometry. A node which needs to
+    change the geometry calls detach() first, which gives it a copy of its own
+    if the geometry is still referenced elsewhere.
+
+    Shared geometries may be rendered from several threads, so they must use
+    QSGGeometry::AlwaysUploadPattern.
+ */
+
+static uint qsg_geometryHash(const QSGGeometry *g)
+{
+    uint h = qHash(g->vertexCount()) ^ (qHash(g->indexCount()) << 1)
+             ^ (qHash(g->drawingMode()) << 2) ^ qHash(quintptr(g->attributes()));
+    h ^= qHash(QByteArray::fromRawData((const char *) g->vertexData(),
+                                       g->vertexCount() * g->sizeOfVertex()));
+    if (g->indexCount())
+        h ^= qHash(QByteArray::fromRawData((const char *) g->indexData(),
+                                           g->indexCount() * g->sizeOfIndex())) << 3;
+    return h;
+}
+
+static bool qsg_geometryEquals(const QSGGeometry *a, const QSGGeometry *b)
+{
+    return a->attributes() == b->attributes()
+        && a->sizeOfVertex() == b->sizeOfVertex()
+        && a->vertexCount() == b->vertexCount()
+        && a->indexCount() == b->indexCount()
+        && a->indexType() == b->indexType()
+        && a->drawingMode() == b->drawingMode()
+        && a->lineWidth() == b->lineWidth()
+        && memcmp(a->vertexData(), b->vertexData(), a->vertexCount() * a->sizeOfVertex()) == 0
+        && (a->indexCount() == 0
+            || memcmp(a->indexData(), b->indexData(), a->indexCount() * a->sizeOfIndex()) == 0);
+}
+
+static void qsg_copyGeometry(QSGGeometry *dst, const QSGGeometry *src)
+{
+    dst->setDrawingMode(src->drawingMode());
+    dst->setLineWidth(src->lineWidth());
+    memcpy(dst->vertexData(), src->vertexData(), src->vertexCount() * src->sizeOfVertex());
+    if (src->indexCount())
+        memcpy(dst->indexData(), src->indexData(), src->indexCount() * src->sizeOfIndex());
+}
+
+class QSGSharedGeometryCache
+{
+public:
+    QMutex mutex;
+    QMultiHash<uint, QSGSharedGeometry *> geometries;
+
+    void remove(QSGSharedGeometry *g)
+    {
+        if (g->m_cached) {
+            geometries.remove(g->m_hash, g);
+            g->m_cached = false;
+        }
+    }
+};
+
+Q_GLOBAL_STATIC(QSGSharedGeometryCache, qsg_sharedGeometryCache)
+
+QSGSharedGeometry::QSGSharedGeometry(const QSGGeometry *source, uint hash)
+    : QSGGeometry(source->m_attributes, source->vertexCount(), source->indexCount(), source->indexType())
+    , m_ref(1)
+    , m_hash(hash)
+    , m_cached(true)
+{
+    m_is_shared = true;
+    qsg_copyGeometry(this, source);
+}
+
+/*!
+    Returns a reference to a shared geometry with the same contents as
+     geometry. The reference is owned by the caller, typically by setting
+    the geometry on a node together with QSGNode::OwnsGeometry.
+ */
+QSGSharedGeometry *QSGSharedGeometry::share(const QSGGeometry *geometry)
+{
+    Q_ASSERT(geometry->vertexDataPattern() == AlwaysUploadPattern);
+    const uint hash = qsg_geometryHash(geometry);
+
+    QSGSharedGeometryCache *cache = qsg_sharedGeometryCache();
+    QMutexLocker lock(&cache->mutex);
+    QMultiHash<uint, QSGSharedGeometry *>::const_iterator it = cache->geometries.constFind(hash);
+    for (; it != cache->geometries.constEnd() && it.key() == hash; ++it) {
+        if (qsg_geometryEquals(it.value(), geometry))
+            return it.value()->ref();
+    }
+
+    QSGSharedGeometry *shared = new QSGSharedGeometry(geometry, hash);
+    cache->geometries.insert(hash, shared);
+    return shared;
+}
+
+/*!
+    Makes the geometry of  node safe to modify and returns it. If the node
+    shares its geometry with other nodes, it gets a copy of its own. The node
+    must own its geometry.
+ */
+QSGGeometry *QSGSharedGeometry::detach(QSGBasicGeometryNode *node)
+{
+    QSGGeometry *g = node->geometry();
+    if (!isShared(g))
+        return g;
+    Q_ASSERT(node->flags() & QSGNode::OwnsGeometry);
+
+    QSGSharedGeometry *shared = static_cast<QSGSharedGeometry *>(g);
+    {
+        // The last reference can be modified in place, as long as nobody
+        // else can find it anymore.
+        QSGSharedGeometryCache *cache = qsg_sharedGeometryCache();
+        QMutexLocker lock(&cache->mutex);
+        if (shared->refCount() == 1) {
+            cache->remove(shared);
+            return shared;
+        }
+    }
+
+    QSGGeometry *copy = new QSGGeometry(g->m_attributes, g->vertexCount(), g->indexCount(), g->indexType());
+    qsg_copyGeometry(copy, g);
+    copy->setIndexDataPattern(g->indexDataPattern());
+    node->setGeometry(copy);
+    return copy;
+}
+
+/*!
+    Releases one reference to the shared  geometry, deleting it when it
+    was the last one.
+ */
+void QSGSharedGeometry::release(QSGGeometry *geometry)
+{
+    Q_ASSERT(isShared(geometry));
+    QSGSharedGeometry *shared = static_cast<QSGSharedGeometry *>(geometry);
+
+    QSGSharedGeometryCache *cache = qsg_sharedGeometryCache();
+    if (!cache) {
+        // Shutdown, the cache is gone already.
+        if (!shared->m_ref.deref())
+            delete shared;
+        return;
+    }
+
+    QMutexLocker lock(&cache->mutex);
+    if (!shared->m_ref.deref()) {
+        cache->remove(shared);
+        delete shared;
+    }
+}
+
 QT_END_NAMESPACE
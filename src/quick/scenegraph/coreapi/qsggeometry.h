@@ -164,6 +164,7 @@ public:
 
 private:
     friend class QSGGeometryData;
+    friend class QSGSharedGeometry;
 
     int m_drawing_mode;
     int m_vertex_count;
@@ -180,7 +181,8 @@ private:
     uint m_vertex_usage_pattern : 2;
     uint m_dirty_index_data : 1;
     uint m_dirty_vertex_data : 1;
-    uint m_reserved_bits : 25;
+    uint m_is_shared : 1;
+    uint m_reserved_bits : 24;
 
     float m_prealloc[16];
 
@@ -44,8 +44,12 @@
 
 #include "qsggeometry.h"
 
+#include <QtCore/qatomic.h>
+
 QT_BEGIN_NAMESPACE
 
+class QSGBasicGeometryNode;
+
 class QSGGeometryData
 {
 public:
@@ -68,6 +72,29 @@ public:
 
 };
 
+class Q_QUICK_PRIVATE_EXPORT QSGSharedGeometry : public QSGGeometry
+{
+public:
+    static QSGSharedGeometry *share(const QSGGeometry *geometry);
+    static QSGGeometry *detach(QSGBasicGeometryNode *node);
+    static void release(QSGGeometry *geometry);
+
+    static bool isShared(const QSGGeometry *g) { return g && g->m_is_shared; }
+
+    QSGSharedGeometry *ref() { m_ref.ref(); return this; }
+    int refCount() const { return m_ref.load(); }
+
+private:
+    QSGSharedGeometry(const QSGGeometry *source, uint hash);
+    ~QSGSharedGeometry() { }
+
+    friend class QSGSharedGeometryCache;
+
+    QAtomicInt m_ref;
+    uint m_hash;
+    bool m_cached;
+};
+
 QT_END_NAMESPACE
 
 #endif // QSGGEOMETRY_P_H
@@ -355,6 +355,10 @@ void QSGMaterialShader::compile()
 {
     Q_ASSERT_X(!m_program.isLinked(), "QSGSMaterialShader::compile()", "Compile called multiple times!");
 
+    const QByteArray binaryKey = QSGShaderSourceBuilder::programBinaryKey(vertexShader(), fragmentShader(), attributeNames());
+    if (QSGShaderSourceBuilder::loadProgramBinary(program(), binaryKey))
+        return;
+
     program()->addShaderFromSourceCode(QOpenGLShader::Vertex, vertexShader());
     program()->addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentShader());
 
@@ -383,6 +387,8 @@ void QSGMaterialShader::compile()
     if (!program()->link()) {
         qWarning("QSGMaterialShader: Shader compilation failed:");
         qWarning() << program()->log();
+    } else {
+        QSGShaderSourceBuilder::saveProgramBinary(program(), binaryKey);
     }
 }
 
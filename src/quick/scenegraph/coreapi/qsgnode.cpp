@@ -44,6 +44,7 @@
 #include "qsgrenderer_p.h"
 #include "qsgnodeupdater_p.h"
 #include "qsgmaterial.h"
+#include "qsggeometry_p.h"
 
 #include "limits.h"
 
@@ -728,6 +729,18 @@ QSGBasicGeometryNode::QSGBasicGeometryNode(QSGBasicGeometryNodePrivate &dd, Node
 }
 
 
+/*
+    Shared geometries are reference counted and only go away with their
+    last owner, see QSGSharedGeometry.
+ */
+static inline void qsg_deleteGeometry(QSGGeometry *geometry)
+{
+    if (QSGSharedGeometry::isShared(geometry))
+        QSGSharedGeometry::release(geometry);
+    else
+        delete geometry;
+}
+
 /*!
     Deletes this QSGBasicGeometryNode.
 
@@ -738,7 +751,7 @@ QSGBasicGeometryNode::QSGBasicGeometryNode(QSGBasicGeometryNodePrivate &dd, Node
 QSGBasicGeometryNode::~QSGBasicGeometryNode()
 {
     if (flags() & OwnsGeometry)
-        delete m_geometry;
+        qsg_deleteGeometry(m_geometry);
 }
 
 
@@ -791,8 +804,11 @@ QSGBasicGeometryNode::~QSGBasicGeometryNode()
 
 void QSGBasicGeometryNode::setGeometry(QSGGeometry *geometry)
 {
-    if (flags() & OwnsGeometry)
-        delete m_geometry;
+    // A shared geometry comes with a reference of its own, even when the node
+    // already points to it.
+    if ((flags() & OwnsGeometry)
+        && (geometry != m_geometry || QSGSharedGeometry::isShared(geometry)))
+        qsg_deleteGeometry(m_geometry);
     m_geometry = geometry;
     markDirty(DirtyGeometry);
 }
@@ -147,6 +147,7 @@ QSGRenderer::QSGRenderer(QSGRenderContext *context)
     , m_changed_emitted(false)
     , m_mirrored(false)
     , m_is_rendering(false)
+    , m_track_changed_nodes(false)
     , m_vertex_buffer_bound(false)
     , m_index_buffer_bound(false)
 {
@@ -189,6 +190,51 @@ void QSGRenderer::setNodeUpdater(QSGNodeUpdater *updater)
 }
 
 
+/*!
+    \fn void QSGRenderer::setScissorRect(const QRect &rect)
+
+    Restricts rendering, including clearing, to \a rect, given in framebuffer
+    coordinates as passed to glScissor(). Clip nodes are intersected with it.
+    An invalid rect, which is the default, renders the whole viewport.
+ */
+
+/*!
+    Enables or disables recording of the nodes whose geometry, material,
+    matrix or opacity changed, or which were added, depending on \a track.
+
+    This is used by layers to find out which parts of their texture need
+    to be rendered again.
+
+    \sa takeChangedNodes()
+ */
+void QSGRenderer::setTrackChangedNodes(bool track)
+{
+    m_track_changed_nodes = track;
+    if (!track)
+        m_changed_nodes.clear();
+}
+
+/*!
+    Returns the nodes recorded since the last call and clears the record.
+
+    Removed nodes may be part of the set, so the pointers must only be used
+    for lookups.
+ */
+QSet<QSGNode *> QSGRenderer::takeChangedNodes()
+{
+    QSet<QSGNode *> nodes;
+    qSwap(nodes, m_changed_nodes);
+    return nodes;
+}
+
+/*!
+    \fn const QSGRenderer::FrameStatistics &QSGRenderer::frameStatistics() const
+
+    Returns the number of batches and draw calls of the last call to
+    renderScene(), and the number of bytes of vertex and index data it
+    uploaded.
+ */
+
 void QSGRenderer::setRootNode(QSGRootNode *node)
 {
     if (m_root_node == node)
@@ -222,7 +268,7 @@ void QSGRenderer::renderScene(const QSGBindable &bindable)
         return;
 
     m_is_rendering = true;
-
+    m_frame_statistics = FrameStatistics();
 
     bool profileFrames = QSG_LOG_TIME_RENDERER().isDebugEnabled() || QQuickProfiler::enabled;
     if (profileFrames)
@@ -328,6 +374,11 @@ void QSGRenderer::setClearColor(const QColor &color)
 
 void QSGRenderer::nodeChanged(QSGNode *node, QSGNode::DirtyState state)
 {
+    if (m_track_changed_nodes
+        && (state & (QSGNode::DirtyGeometry | QSGNode::DirtyMaterial | QSGNode::DirtyMatrix
+                     | QSGNode::DirtyNodeAdded | QSGNode::DirtyOpacity))) {
+        m_changed_nodes.insert(node);
+    }
     if (state & QSGNode::DirtyNodeAdded)
         addNodesToPreprocess(node);
     if (state & QSGNode::DirtyNodeRemoved)
@@ -398,6 +449,21 @@ void QSGRenderer::removeNodesToPreprocess(QSGNode *node)
 }
 
 
+/*!
+    Enables the scissor test for the rect set with setScissorRect(), or
+    disables it if there is none.
+ */
+
+void QSGRenderer::enableScissorRect()
+{
+    if (m_scissor_rect.isValid()) {
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(m_scissor_rect.x(), m_scissor_rect.y(), m_scissor_rect.width(), m_scissor_rect.height());
+    } else {
+        glDisable(GL_SCISSOR_TEST);
+    }
+}
+
 /*!
     Convenience function to set up the stencil buffer for clipping based on \a clip.
 
@@ -409,13 +475,13 @@ QSGRenderer::ClipType QSGRenderer::updateStencilClip(const QSGClipNode *clip)
 {
     if (!clip) {
         glDisable(GL_STENCIL_TEST);
-        glDisable(GL_SCISSOR_TEST);
+        enableScissorRect();
         return NoClip;
     }
 
     ClipType clipType = NoClip;
 
-    glDisable(GL_SCISSOR_TEST);
+    enableScissorRect();
 
     m_current_stencil_value = 0;
     m_current_scissor_rect = QRect();
@@ -459,6 +525,8 @@ QSGRenderer::ClipType QSGRenderer::updateStencilClip(const QSGClipNode *clip)
 
             if (!(clipType & ScissorClip)) {
                 m_current_scissor_rect = QRect(ix1, iy1, ix2 - ix1, iy2 - iy1);
+                if (m_scissor_rect.isValid())
+                    m_current_scissor_rect &= m_scissor_rect;
                 glEnable(GL_SCISSOR_TEST);
                 clipType |= ScissorClip;
             } else {
@@ -701,6 +769,7 @@ void QSGRenderer::draw(const QSGMaterialShader *shader, const QSGGeometry *g)
     }
 
     // draw the stuff...
+    ++m_frame_statistics.drawCalls;
     if (g->indexCount()) {
         glDrawElements(g->drawingMode(), g->indexCount(), g->indexType(), indexData);
     } else {
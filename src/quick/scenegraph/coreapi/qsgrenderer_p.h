@@ -139,6 +139,20 @@ public:
 
     void clearChangedFlag() { m_changed_emitted = false; }
 
+    void setScissorRect(const QRect &rect) { m_scissor_rect = rect; }
+    QRect scissorRect() const { return m_scissor_rect; }
+
+    void setTrackChangedNodes(bool track);
+    QSet<QSGNode *> takeChangedNodes();
+
+    struct FrameStatistics {
+        FrameStatistics() : batches(0), drawCalls(0), uploadedBytes(0) { }
+        int batches;
+        int drawCalls;
+        qint64 uploadedBytes;
+    };
+    const FrameStatistics &frameStatistics() const { return m_frame_statistics; }
+
 Q_SIGNALS:
     void sceneGraphChanged(); // Add, remove, ChangeFlags changes...
 
@@ -147,6 +161,7 @@ protected:
 
     virtual void render() = 0;
     QSGRenderer::ClipType updateStencilClip(const QSGClipNode *clip);
+    void enableScissorRect();
 
     const QSGBindable *bindable() const { return m_bindable; }
 
@@ -165,7 +180,9 @@ protected:
     qreal m_current_determinant;
     qreal m_device_pixel_ratio;
     QRect m_current_scissor_rect;
+    QRect m_scissor_rect;
     int m_current_stencil_value;
+    FrameStatistics m_frame_statistics;
 
     QSGRenderContext *m_context;
 
@@ -177,6 +194,7 @@ private:
     QRect m_viewport_rect;
 
     QSet<QSGNode *> m_nodes_to_preprocess;
+    QSet<QSGNode *> m_changed_nodes;
 
     QMatrix4x4 m_projection_matrix;
     QOpenGLShaderProgram m_clip_program;
@@ -187,6 +205,7 @@ private:
     uint m_changed_emitted : 1;
     uint m_mirrored : 1;
     uint m_is_rendering : 1;
+    uint m_track_changed_nodes : 1;
 
     uint m_vertex_buffer_bound : 1;
     uint m_index_buffer_bound : 1;
@@ -174,7 +174,11 @@ Tokenizer::Token Tokenizer::next()
 
 using namespace QSGShaderRewriter;
 
-QByteArray qsgShaderRewriter_insertZAttributes(const char *input, QSurfaceFormat::OpenGLContextProfile profile)
+/*
+    Inserts \a declarations in front of main() and appends \a statement
+    at the end of its body.
+ */
+static QByteArray qsg_rewriteMain(const char *input, const QByteArray &declarations, const QByteArray &statement)
 {
     Tokenizer tok;
     tok.initialize(input);
@@ -197,18 +201,7 @@ QByteArray qsgShaderRewriter_insertZAttributes(const char *input, QSurfaceFormat
     QByteArray result;
     result.reserve(1024);
     result += QByteArray::fromRawData(input, voidPos - input);
-    switch (profile) {
-    case QSurfaceFormat::NoProfile:
-    case QSurfaceFormat::CompatibilityProfile:
-        result += QByteArrayLiteral("attribute highp float _qt_order;\n");
-        result += QByteArrayLiteral("uniform highp float _qt_zRange;\n");
-        break;
-
-    case QSurfaceFormat::CoreProfile:
-        result += QByteArrayLiteral("in float _qt_order;\n");
-        result += QByteArrayLiteral("uniform float _qt_zRange;\n");
-        break;
-    }
+    result += declarations;
 
     // Find first brace '{'
     while (t != Tokenizer::Token_EOF && t != Tokenizer::Token_OpenBrace) t = tok.next();
@@ -222,7 +215,7 @@ QByteArray qsgShaderRewriter_insertZAttributes(const char *input, QSurfaceFormat
             braceDepth--;
             if (braceDepth == 0) {
                 result += QByteArray::fromRawData(voidPos, tok.pos - 1 - voidPos);
-                result += QByteArrayLiteral("    gl_Position.z = (gl_Position.z * _qt_zRange + _qt_order) * gl_Position.w;\n");
+                result += statement;
                 result += QByteArray(tok.pos - 1);
                 return result;
             }
@@ -238,6 +231,78 @@ QByteArray qsgShaderRewriter_insertZAttributes(const char *input, QSurfaceFormat
     return QByteArray();
 }
 
+QByteArray qsgShaderRewriter_insertZAttributes(const char *input, QSurfaceFormat::OpenGLContextProfile profile)
+{
+    QByteArray declarations;
+    switch (profile) {
+    case QSurfaceFormat::NoProfile:
+    case QSurfaceFormat::CompatibilityProfile:
+        declarations += QByteArrayLiteral("attribute highp float _qt_order;\n");
+        declarations += QByteArrayLiteral("uniform highp float _qt_zRange;\n");
+        break;
+
+    case QSurfaceFormat::CoreProfile:
+        declarations += QByteArrayLiteral("in float _qt_order;\n");
+        declarations += QByteArrayLiteral("uniform float _qt_zRange;\n");
+        break;
+    }
+    return qsg_rewriteMain(input, declarations,
+                           QByteArrayLiteral("    gl_Position.z = (gl_Position.z * _qt_zRange + _qt_order) * gl_Position.w;\n"));
+}
+
+/*
+    Rewrites the vertex shader for instanced rendering. The per-instance
+    matrix maps the position computed for the first instance to the
+    position of the current instance.
+ */
+QByteArray qsgShaderRewriter_insertInstanceTransform(const char *input, QSurfaceFormat::OpenGLContextProfile profile)
+{
+    QByteArray declarations;
+    switch (profile) {
+    case QSurfaceFormat::NoProfile:
+    case QSurfaceFormat::CompatibilityProfile:
+        declarations += QByteArrayLiteral("attribute highp mat4 _qt_instanceMatrix;\n");
+        break;
+
+    case QSurfaceFormat::CoreProfile:
+        declarations += QByteArrayLiteral("in mat4 _qt_instanceMatrix;\n");
+        break;
+    }
+    return qsg_rewriteMain(input, declarations,
+                           QByteArrayLiteral("    gl_Position = _qt_instanceMatrix * gl_Position;\n"));
+}
+
+/*
+    Rewrites the vertex shader for merged batches drawn with a matrix
+    palette. Each vertex selects the matrix of its element, which maps the
+    position computed for the batch root to that of the element. The z
+    attributes are added too, as for qsgShaderRewriter_insertZAttributes.
+ */
+QByteArray qsgShaderRewriter_insertPaletteTransform(const char *input, QSurfaceFormat::OpenGLContextProfile profile, int paletteSize)
+{
+    const QByteArray size = QByteArray::number(paletteSize);
+    QByteArray declarations;
+    switch (profile) {
+    case QSurfaceFormat::NoProfile:
+    case QSurfaceFormat::CompatibilityProfile:
+        declarations += QByteArrayLiteral("attribute highp float _qt_order;\n");
+        declarations += QByteArrayLiteral("attribute highp float _qt_paletteIndex;\n");
+        declarations += QByteArrayLiteral("uniform highp float _qt_zRange;\n");
+        declarations += "uniform highp mat4 _qt_palette[" + size + "];\n";
+        break;
+
+    case QSurfaceFormat::CoreProfile:
+        declarations += QByteArrayLiteral("in float _qt_order;\n");
+        declarations += QByteArrayLiteral("in float _qt_paletteIndex;\n");
+        declarations += QByteArrayLiteral("uniform float _qt_zRange;\n");
+        declarations += "uniform mat4 _qt_palette[" + size + "];\n";
+        break;
+    }
+    return qsg_rewriteMain(input, declarations,
+                           QByteArrayLiteral("    gl_Position = _qt_palette[int(_qt_paletteIndex)] * gl_Position;\n"
+                                             "    gl_Position.z = (gl_Position.z * _qt_zRange + _qt_order) * gl_Position.w;\n"));
+}
+
 #ifdef QSGSHADERREWRITER_STANDALONE
 
 const char *selftest =
@@ -43,8 +43,11 @@
 
 #include <qmath.h>
 #include <QtQuick/private/qsgdistancefieldutil_p.h>
+#include <QtQuick/private/qsgdistancefielddiskcache_p.h>
+#include <QtQuick/private/qsgdistancefieldgenerator_p.h>
 #include <QtQuick/private/qsgdistancefieldglyphnode_p.h>
 #include <QtQuick/private/qsgcontext_p.h>
+#include <QtQuick/qquickitem.h>
 #include <private/qrawfont_p.h>
 #include <QtGui/qguiapplication.h>
 #include <qdir.h>
@@ -62,6 +65,8 @@ QSGDistanceFieldGlyphCache::Texture QSGDistanceFieldGlyphCache::s_emptyTexture;
 QSGDistanceFieldGlyphCache::QSGDistanceFieldGlyphCache(QSGDistanceFieldGlyphCacheManager *man, QOpenGLContext *c, const QRawFont &font)
     : m_manager(man)
     , m_pendingGlyphs(64)
+    , m_diskCache(0)
+    , m_generator(0)
 {
     Q_ASSERT(font.isValid());
 
@@ -75,10 +80,20 @@ QSGDistanceFieldGlyphCache::QSGDistanceFieldGlyphCache(QSGDistanceFieldGlyphCach
     Q_ASSERT(m_referenceFont.isValid());
 
     m_coreProfile = (c->format().profile() == QSurfaceFormat::CoreProfile);
+
+    // Glyphs generated by earlier runs, or other processes, are loaded from
+    // disk rather than generated again.
+    m_diskCache = QSGDistanceFieldDiskCache::create(m_referenceFont, m_doubleGlyphResolution);
+
+    // Large batches of new glyphs are generated on worker threads so that
+    // they don't stall the render thread for several frames.
+    m_generator = QSGDistanceFieldGenerator::create(m_doubleGlyphResolution);
 }
 
 QSGDistanceFieldGlyphCache::~QSGDistanceFieldGlyphCache()
 {
+    delete m_generator;
+    delete m_diskCache;
 }
 
 QSGDistanceFieldGlyphCache::GlyphData &QSGDistanceFieldGlyphCache::glyphData(glyph_t glyph)
@@ -159,6 +174,9 @@ void QSGDistanceFieldGlyphCache::update()
 {
     m_populatingGlyphs.clear();
 
+    if (m_generator)
+        storeGeneratedGlyphs();
+
     if (m_pendingGlyphs.isEmpty())
         return;
 
@@ -168,10 +186,47 @@ void QSGDistanceFieldGlyphCache::update()
     QSystrace::begin("graphics", "QSGDFGC::update::render", "");
 
     QList<QDistanceField> distanceFields;
+    QVector<glyph_t> glyphIds;
+    QVector<glyph_t> missingGlyphs;
+    glyphIds.reserve(m_pendingGlyphs.size());
+    int loadedCount = 0;
     for (int i = 0; i < m_pendingGlyphs.size(); ++i) {
-        distanceFields.append(QDistanceField(m_referenceFont,
-                                             m_pendingGlyphs.at(i),
-                                             m_doubleGlyphResolution));
+        const glyph_t glyph = m_pendingGlyphs.at(i);
+        QDistanceField field;
+        if (m_diskCache && m_diskCache->load(glyph, &field)) {
+            distanceFields.append(field);
+            glyphIds.append(glyph);
+            ++loadedCount;
+        } else {
+            missingGlyphs.append(glyph);
+        }
+    }
+
+    int deferredCount = 0;
+    if (m_generator && missingGlyphs.size() >= m_generator->threshold()) {
+        // The outlines come from the font engine, which is only safe to use
+        // from this thread. The glyphs keep the empty texture, and are
+        // therefore not drawn, until their distance field has been stored.
+        QRawFont renderFont = m_referenceFont;
+        renderFont.setPixelSize(QT_DISTANCEFIELD_BASEFONTSIZE(m_doubleGlyphResolution)
+                                * QT_DISTANCEFIELD_SCALE(m_doubleGlyphResolution));
+        QList<QPainterPath> paths;
+        paths.reserve(missingGlyphs.size());
+        for (int i = 0; i < missingGlyphs.size(); ++i) {
+            paths.append(renderFont.pathForGlyph(missingGlyphs.at(i)));
+            m_generatingGlyphs.insert(missingGlyphs.at(i));
+        }
+        m_generator->generate(missingGlyphs, paths);
+        deferredCount = missingGlyphs.size();
+    } else {
+        for (int i = 0; i < missingGlyphs.size(); ++i) {
+            const glyph_t glyph = missingGlyphs.at(i);
+            QDistanceField field(m_referenceFont, glyph, m_doubleGlyphResolution);
+            if (m_diskCache)
+                m_diskCache->store(glyph, field);
+            distanceFields.append(field);
+            glyphIds.append(glyph);
+        }
     }
 
     qint64 renderTime = 0;
@@ -185,17 +240,23 @@ void QSGDistanceFieldGlyphCache::update()
     m_pendingGlyphs.reset();
 
     QSystrace::begin("graphics", "QSGDFGC::update::store", "");
-    storeGlyphs(distanceFields);
+    if (!glyphIds.isEmpty())
+        storeGlyphs(glyphIds, distanceFields);
     QSystrace::end("graphics", "QSGDFGC::update::store", "");
 
+    if (m_diskCache)
+        m_diskCache->flush();
+
     if (QSG_LOG_TIME_GLYPH().isDebugEnabled()) {
         quint64 now = qsg_render_timer.elapsed();
         qCDebug(QSG_LOG_TIME_GLYPH,
-                "distancefield: %d glyphs prepared in %dms, rendering=%d, upload=%d",
+                "distancefield: %d glyphs prepared in %dms, rendering=%d, upload=%d, from disk=%d, threaded=%d",
                 count,
                 (int) now,
                 int(renderTime / 1000000),
-                int((now - (renderTime / 1000000))));
+                int((now - (renderTime / 1000000))),
+                loadedCount,
+                deferredCount);
     }
     Q_QUICK_SG_PROFILE1(QQuickProfiler::SceneGraphAdaptationLayerFrame, (
             count,
@@ -203,6 +264,51 @@ void QSGDistanceFieldGlyphCache::update()
             qsg_render_timer.nsecsElapsed() - renderTime));
 }
 
+/*
+    Uploads the distance fields the worker threads have finished since the
+    last frame. Glyphs that were evicted while being generated are dropped,
+    since their area in the texture may already belong to another glyph.
+ */
+void QSGDistanceFieldGlyphCache::storeGeneratedGlyphs()
+{
+    QVector<glyph_t> generatedGlyphs;
+    QList<QDistanceField> generatedFields;
+    if (!m_generator->takeResults(&generatedGlyphs, &generatedFields))
+        return;
+
+    QVector<glyph_t> glyphIds;
+    QList<QDistanceField> distanceFields;
+    for (int i = 0; i < generatedGlyphs.size(); ++i) {
+        const glyph_t glyph = generatedGlyphs.at(i);
+        if (!m_generatingGlyphs.remove(glyph))
+            continue;
+        if (m_diskCache)
+            m_diskCache->store(glyph, generatedFields.at(i));
+        glyphIds.append(glyph);
+        distanceFields.append(generatedFields.at(i));
+    }
+
+    if (glyphIds.isEmpty())
+        return;
+
+    storeGlyphs(glyphIds, distanceFields);
+    if (m_diskCache)
+        m_diskCache->flush();
+
+    // The glyphs had the empty texture until now, so setGlyphsTexture() did
+    // not tell the nodes about them.
+    QVector<quint32> invalidatedGlyphs;
+    invalidatedGlyphs.reserve(glyphIds.size());
+    for (int i = 0; i < glyphIds.size(); ++i)
+        invalidatedGlyphs.append(glyphIds.at(i));
+
+    QLinkedList<QSGDistanceFieldGlyphConsumer *>::iterator it = m_registeredNodes.begin();
+    while (it != m_registeredNodes.end()) {
+        (*it)->invalidateGlyphs(invalidatedGlyphs);
+        ++it;
+    }
+}
+
 void QSGDistanceFieldGlyphCache::setGlyphsPosition(const QList<GlyphPosition> &glyphs)
 {
     QVector<quint32> invalidatedGlyphs;
@@ -234,12 +340,30 @@ void QSGDistanceFieldGlyphCache::setGlyphsPosition(const QList<GlyphPosition> &g
 
 void QSGDistanceFieldGlyphCache::registerOwnerElement(QQuickItem *ownerElement)
 {
-    Q_UNUSED(ownerElement);
+    // The owners schedule a new frame when threaded glyph generation has
+    // results to upload.
+    if (!m_generator)
+        return;
+
+    OwnerElement &owner = m_ownerElements[ownerElement];
+    if (owner.ref == 0) {
+        owner.item = ownerElement;
+
+        bool ok = QObject::connect(m_generator, SIGNAL(glyphsReady()), ownerElement, SLOT(triggerPreprocess()));
+        Q_ASSERT_X(ok, Q_FUNC_INFO, "QML element that owns a glyph node must have triggerPreprocess() slot");
+        Q_UNUSED(ok);
+    }
+    ++owner.ref;
 }
 
 void QSGDistanceFieldGlyphCache::unregisterOwnerElement(QQuickItem *ownerElement)
 {
-    Q_UNUSED(ownerElement);
+    QHash<QQuickItem *, OwnerElement>::iterator it = m_ownerElements.find(ownerElement);
+    if (it != m_ownerElements.end() && --it->ref <= 0) {
+        if (it->item)
+            QObject::disconnect(m_generator, SIGNAL(glyphsReady()), ownerElement, SLOT(triggerPreprocess()));
+        m_ownerElements.erase(it);
+    }
 }
 
 void QSGDistanceFieldGlyphCache::processPendingGlyphs()
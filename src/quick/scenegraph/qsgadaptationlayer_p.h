@@ -45,6 +45,7 @@
 #include <QtQuick/qsgnode.h>
 #include <QtQuick/qsgtexture.h>
 #include <QtCore/qobject.h>
+#include <QtCore/qpointer.h>
 #include <QtCore/qrect.h>
 #include <QtGui/qbrush.h>
 #include <QtGui/qcolor.h>
@@ -147,6 +148,9 @@ public:
     virtual void invalidateGlyphs(const QVector<quint32> &glyphs) = 0;
 };
 
+class QSGDistanceFieldDiskCache;
+class QSGDistanceFieldGenerator;
+
 class Q_QUICK_PRIVATE_EXPORT QSGDistanceFieldGlyphCache
 {
 public:
@@ -231,7 +235,7 @@ protected:
     };
 
     virtual void requestGlyphs(const QSet<glyph_t> &glyphs) = 0;
-    virtual void storeGlyphs(const QList<QDistanceField> &glyphs) = 0;
+    virtual void storeGlyphs(const QVector<glyph_t> &glyphIds, const QList<QDistanceField> &glyphs) = 0;
     virtual void referenceGlyphs(const QSet<glyph_t> &glyphs) = 0;
     virtual void releaseGlyphs(const QSet<glyph_t> &glyphs) = 0;
 
@@ -250,6 +254,15 @@ protected:
     inline bool isCoreProfile() const { return m_coreProfile; }
 
 private:
+    struct OwnerElement {
+        OwnerElement() : ref(0) { }
+
+        QPointer<QQuickItem> item;
+        int ref;
+    };
+
+    void storeGeneratedGlyphs();
+
     QSGDistanceFieldGlyphCacheManager *m_manager;
 
     QRawFont m_referenceFont;
@@ -264,6 +277,12 @@ private:
     QSet<glyph_t> m_populatingGlyphs;
     QLinkedList<QSGDistanceFieldGlyphConsumer*> m_registeredNodes;
 
+    QSGDistanceFieldDiskCache *m_diskCache;
+
+    QSGDistanceFieldGenerator *m_generator;
+    QSet<glyph_t> m_generatingGlyphs;
+    QHash<QQuickItem *, OwnerElement> m_ownerElements;
+
     static Texture s_emptyTexture;
 };
 
@@ -282,6 +301,7 @@ inline void QSGDistanceFieldGlyphCache::removeGlyph(glyph_t glyph)
     GlyphData &gd = glyphData(glyph);
     gd.texCoord = TexCoord();
     gd.texture = &s_emptyTexture;
+    m_generatingGlyphs.remove(glyph);
 }
 
 inline bool QSGDistanceFieldGlyphCache::containsGlyph(glyph_t glyph)
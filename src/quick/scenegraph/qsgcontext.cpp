@@ -51,6 +51,7 @@
 #include <QtQuick/private/qsgshareddistancefieldglyphcache_p.h>
 #include <QtQuick/private/qsgatlastexture_p.h>
 #include <QtQuick/private/qsgrenderloop_p.h>
+#include <QtQuick/private/qsgshadersourcebuilder_p.h>
 
 #include <QtQuick/private/qsgtexture_p.h>
 #include <QtQuick/private/qquickpixmapcache_p.h>
@@ -58,6 +59,7 @@
 #include <QGuiApplication>
 #include <QScreen>
 #include <QOpenGLContext>
+#include <QOffscreenSurface>
 #include <QQuickWindow>
 #include <QtGui/qopenglframebufferobject.h>
 
@@ -72,6 +74,8 @@
 
 #include <private/qobject_p.h>
 #include <qmutex.h>
+#include <qthread.h>
+#include <qmath.h>
 
 #include <private/qqmlprofilerservice_p.h>
 
@@ -175,6 +179,7 @@ public:
         , m_time(0)
         , m_vsync(0)
         , m_mode(VSyncMode)
+        , m_presentation(0)
         , m_lag(0)
         , m_bad(0)
         , m_good(0)
@@ -198,6 +203,7 @@ public:
     void start() Q_DECL_OVERRIDE
     {
         m_time = 0;
+        m_presentation = 0;
         m_timer.start();
         m_wallTime.restart();
         QAnimationDriver::start();
@@ -205,9 +211,25 @@ public:
 
     qint64 elapsed() const Q_DECL_OVERRIDE
     {
-        return m_mode == VSyncMode
-                ? qint64(m_time)
-                : qint64(m_time) + m_wallTime.elapsed();
+        if (m_mode == VSyncMode)
+            return qint64(m_time);
+        return qint64(m_time) + qMax<qint64>(qint64(m_presentation), m_wallTime.elapsed());
+    }
+
+    /*
+        In timer mode, the frame being prepared will not reach the screen
+        before the next vsync. Step the animations to that point in time
+        rather than to the current wall time, so that the values on screen
+        match the moment they are displayed instead of lagging up to one
+        refresh interval behind. The prediction never moves backwards.
+     */
+    void predictPresentationTime()
+    {
+        if (m_vsync <= 0)
+            return;
+        qint64 wall = m_wallTime.elapsed();
+        float next = (qFloor(wall / m_vsync) + 1) * m_vsync;
+        m_presentation = qMax(m_presentation, next);
     }
 
     void advance() Q_DECL_OVERRIDE
@@ -242,6 +264,7 @@ public:
                     m_mode = TimerMode;
                     qCDebug(QSG_LOG_INFO, "animation driver switched to timer mode");
                     m_wallTime.restart();
+                    m_presentation = 0;
                 }
             } else {
                 m_lag = 0;
@@ -264,6 +287,8 @@ public:
                 m_bad = 0;
                 m_lag = 0;
                 qCDebug(QSG_LOG_INFO, "animation driver switched to vsync mode");
+            } else {
+                predictPresentationTime();
             }
         }
 
@@ -273,6 +298,7 @@ public:
     float m_time;
     float m_vsync;
     Mode m_mode;
+    float m_presentation;
     QElapsedTimer m_timer;
     QElapsedTimer m_wallTime;
     float m_lag;
@@ -513,20 +539,272 @@ QAnimationDriver *QSGContext::createAnimationDriver(QObject *parent)
     return new QSGAnimationDriver(parent);
 }
 
+/*
+    Compiles the shaders of the materials registered through
+    QQuickWindow::precompileMaterials() on a GL context which is shared with
+    the render context. The finished shaders are handed to the renderer's
+    shader manager the first time the material shows up in a batch, which
+    then only needs to initialize them.
+ */
+class QSGShaderPrecompiler : public QThread
+{
+public:
+    QSGShaderPrecompiler(QSGRenderContext *context, QQuickWindow *window)
+        : renderContext(context)
+        , gl(0)
+        , renderThread(0)
+        , surface(new QOffscreenSurface)
+        , idle(true)
+        , cancelled(false)
+    {
+        surface->setFormat(window->format());
+        surface->create();
+    }
+
+    ~QSGShaderPrecompiler()
+    {
+        mutex.lock();
+        cancelled = true;
+        mutex.unlock();
+        wait();
+
+        qDeleteAll(pending);
+        qDeleteAll(shaders.values());
+        qDeleteAll(rewrittenShaders.values());
+        delete gl;
+        // The surface belongs to the GUI thread.
+        surface->deleteLater();
+    }
+
+    void run();
+    void compileNext(QSGMaterial *material);
+
+    QSGRenderContext *renderContext;
+    QOpenGLContext *gl;
+    QThread *renderThread;
+    QOffscreenSurface *surface;
+
+    QMutex mutex;
+    QList<QSGMaterial *> pending;
+    QHash<QSGMaterialType *, QSGMaterialShader *> shaders;
+    QHash<QSGMaterialType *, QSGMaterialShader *> rewrittenShaders;
+    bool idle;
+    bool cancelled;
+};
+
+void QSGShaderPrecompiler::run()
+{
+    if (!gl->makeCurrent(surface)) {
+        qWarning("QSGShaderPrecompiler: failed to make the shared context current, shaders will be compiled on first use");
+        mutex.lock();
+        idle = true;
+        mutex.unlock();
+        return;
+    }
+
+    forever {
+        mutex.lock();
+        if (pending.isEmpty() || cancelled) {
+            idle = true;
+            mutex.unlock();
+            break;
+        }
+        QSGMaterial *material = pending.takeFirst();
+        mutex.unlock();
+
+        compileNext(material);
+        delete material;
+    }
+
+    gl->doneCurrent();
+}
+
+void QSGShaderPrecompiler::compileNext(QSGMaterial *material)
+{
+    QElapsedTimer timer;
+    if (QSG_LOG_TIME_COMPILATION().isDebugEnabled())
+        timer.start();
+
+    QSGMaterialType *type = material->type();
+    QSGMaterialShader *stock = QSGBatchRenderer::ShaderManager::compileShader(renderContext, material, false);
+    QSGMaterialShader *rewritten = 0;
+    if (!(material->flags() & QSGMaterial::CustomCompileStep))
+        rewritten = QSGBatchRenderer::ShaderManager::compileShader(renderContext, material, true);
+
+    // The programs are used from the render context, so make sure
+    // they are complete before they are handed over.
+    glFinish();
+
+    stock->program()->moveToThread(renderThread);
+    if (rewritten)
+        rewritten->program()->moveToThread(renderThread);
+
+    mutex.lock();
+    if (!shaders.contains(type))
+        shaders.insert(type, stock);
+    else
+        delete stock;
+    if (rewritten && !rewrittenShaders.contains(type))
+        rewrittenShaders.insert(type, rewritten);
+    else
+        delete rewritten;
+    mutex.unlock();
+
+    qCDebug(QSG_LOG_TIME_COMPILATION, "shader precompiled in %dms", (int) timer.elapsed());
+}
+
+/*
+    Uploads large images to textures on a GL context which is shared with
+    the render context, so that an image appearing doesn't stall the render
+    thread for the duration of its upload. Items which opt in get no texture
+    until the upload is complete, and then pick up the finished texture in
+    a later frame.
+ */
+class QSGTextureUploader : public QThread
+{
+public:
+    QSGTextureUploader(const QSurfaceFormat &format, int threshold)
+        : gl(0)
+        , renderThread(0)
+        , surface(new QOffscreenSurface)
+        , threshold(threshold)
+        , idle(true)
+        , cancelled(false)
+        , failed(false)
+    {
+        surface->setFormat(format);
+        surface->create();
+    }
+
+    ~QSGTextureUploader()
+    {
+        reset();
+        // The surface belongs to the GUI thread.
+        surface->deleteLater();
+    }
+
+    void run();
+    void reset();
+
+    QOpenGLContext *gl;
+    QThread *renderThread;
+    QOffscreenSurface *surface;
+    int threshold;
+
+    QMutex mutex;
+    QList<QPair<QQuickTextureFactory *, QImage> > pending;
+    QSet<QQuickTextureFactory *> inFlight;
+    QHash<QQuickTextureFactory *, QSGTexture *> uploaded;
+    bool idle;
+    bool cancelled;
+    bool failed;
+};
+
+void QSGTextureUploader::run()
+{
+    if (!gl->makeCurrent(surface)) {
+        qWarning("QSGTextureUploader: failed to make the shared context current, textures will be uploaded on the render thread");
+        mutex.lock();
+        idle = true;
+        failed = true;
+        pending.clear();
+        inFlight.clear();
+        mutex.unlock();
+        return;
+    }
+
+    forever {
+        mutex.lock();
+        if (pending.isEmpty() || cancelled) {
+            idle = true;
+            mutex.unlock();
+            break;
+        }
+        QPair<QQuickTextureFactory *, QImage> job = pending.takeFirst();
+        mutex.unlock();
+
+        QElapsedTimer timer;
+        if (QSG_LOG_TIME_TEXTURE().isDebugEnabled())
+            timer.start();
+
+        QSGPlainTexture *texture = new QSGPlainTexture();
+        texture->setImage(job.second);
+        texture->bind();
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        // The texture is used from the render context, so make sure
+        // the upload is complete before it is handed over.
+        glFinish();
+
+        mutex.lock();
+        if (inFlight.remove(job.first)) {
+            texture->moveToThread(renderThread);
+            uploaded.insert(job.first, texture);
+            texture = 0;
+        }
+        mutex.unlock();
+
+        // The factory was destroyed while we were uploading.
+        delete texture;
+
+        qCDebug(QSG_LOG_TIME_TEXTURE, "texture uploaded on helper thread in %dms, size: %dx%d",
+                (int) timer.elapsed(), job.second.width(), job.second.height());
+    }
+
+    gl->doneCurrent();
+}
+
+/*
+    Stops the helper thread and drops everything it has done. Called on the
+    render thread, with the render context current, when it is invalidated.
+ */
+void QSGTextureUploader::reset()
+{
+    mutex.lock();
+    cancelled = true;
+    mutex.unlock();
+    wait();
+
+    qDeleteAll(uploaded.values());
+    uploaded.clear();
+    pending.clear();
+    inFlight.clear();
+    delete gl;
+    gl = 0;
+    idle = true;
+    cancelled = false;
+}
+
 QSGRenderContext::QSGRenderContext(QSGContext *context)
     : m_gl(0)
     , m_sg(context)
     , m_atlasManager(0)
     , m_depthStencilManager(0)
     , m_distanceFieldCacheManager(0)
+    , m_precompiler(0)
+    , m_uploader(0)
     , m_brokenIBOs(false)
     , m_serializedRender(false)
 {
+#ifndef Q_OS_WIN
+    // Setting up sharing requires the render context to be unbound, which
+    // we cannot guarantee on Windows. Elsewhere, the offscreen surface has
+    // to be created here since this is the only time we are on the GUI
+    // thread.
+    bool ok = false;
+    int threshold = qgetenv("QSG_TEXTURE_ASYNC_THRESHOLD").toInt(&ok);
+    if (!ok || threshold < 0)
+        threshold = 512 * 512;
+    if (threshold > 0)
+        m_uploader = new QSGTextureUploader(m_sg->defaultSurfaceFormat(), threshold);
+#endif
 }
 
 QSGRenderContext::~QSGRenderContext()
 {
     invalidate();
+    delete m_precompiler;
+    delete m_uploader;
 }
 
 void QSGRenderContext::endSync()
@@ -633,6 +911,11 @@ void QSGRenderContext::initialize(QOpenGLContext *context)
     m_gl->setProperty(QSG_RENDERCONTEXT_PROPERTY, QVariant::fromValue(this));
     m_sg->renderContextInitialized(this);
 
+    m_mutex.lock();
+    if (m_precompiler)
+        startPrecompiler();
+    m_mutex.unlock();
+
 #ifdef Q_OS_LINUX
     const char *vendor = (const char *) glGetString(GL_VENDOR);
     if (strstr(vendor, "nouveau"))
@@ -652,6 +935,14 @@ void QSGRenderContext::invalidate()
     if (!m_gl)
         return;
 
+    m_mutex.lock();
+    delete m_precompiler;
+    m_precompiler = 0;
+    m_mutex.unlock();
+
+    if (m_uploader)
+        m_uploader->reset();
+
     qDeleteAll(m_texturesToDelete);
     m_texturesToDelete.clear();
 
@@ -770,8 +1061,19 @@ QSGRenderer *QSGRenderContext::createRenderer()
     return new QSGBatchRenderer::Renderer(this);
 }
 
-QSGTexture *QSGRenderContext::textureForFactory(QQuickTextureFactory *factory, QQuickWindow *window)
+/*!
+    Returns the texture for \a factory, creating it the first time it is asked for.
+
+    If \a uploadPending is non-null, large images may be uploaded on a helper
+    thread instead. The function then returns 0 and sets \a uploadPending to
+    true until the texture is ready, and the caller needs to ask again in a
+    later frame.
+ */
+QSGTexture *QSGRenderContext::textureForFactory(QQuickTextureFactory *factory, QQuickWindow *window, bool *uploadPending)
 {
+    if (uploadPending)
+        *uploadPending = false;
+
     if (!factory)
         return 0;
 
@@ -780,27 +1082,111 @@ QSGTexture *QSGRenderContext::textureForFactory(QQuickTextureFactory *factory, Q
     m_mutex.unlock();
 
     if (!texture) {
-        if (QQuickDefaultTextureFactory *dtf = qobject_cast<QQuickDefaultTextureFactory *>(factory))
-            texture = createTexture(dtf->image());
-        else
+        if (QQuickDefaultTextureFactory *dtf = qobject_cast<QQuickDefaultTextureFactory *>(factory)) {
+            if (uploadPending) {
+                texture = takeUploadedTexture(dtf, uploadPending);
+                if (*uploadPending)
+                    return 0;
+            }
+            if (!texture)
+                texture = createTexture(dtf->image());
+        } else {
             texture = factory->createTexture(window);
+        }
 
         m_mutex.lock();
         m_textures.insert(factory, texture);
         m_mutex.unlock();
 
-        connect(factory, SIGNAL(destroyed(QObject *)), this, SLOT(textureFactoryDestroyed(QObject *)), Qt::DirectConnection);
+        connect(factory, SIGNAL(destroyed(QObject *)), this, SLOT(textureFactoryDestroyed(QObject *)),
+                Qt::ConnectionType(Qt::DirectConnection | Qt::UniqueConnection));
     }
     return texture;
 }
 
 void QSGRenderContext::textureFactoryDestroyed(QObject *o)
 {
+    QQuickTextureFactory *factory = static_cast<QQuickTextureFactory *>(o);
+
     m_mutex.lock();
-    m_texturesToDelete << m_textures.take(static_cast<QQuickTextureFactory *>(o));
+    m_texturesToDelete << m_textures.take(factory);
+
+    if (m_uploader) {
+        QMutexLocker uploaderLocker(&m_uploader->mutex);
+        m_uploader->inFlight.remove(factory);
+        for (int i = m_uploader->pending.size() - 1; i >= 0; --i) {
+            if (m_uploader->pending.at(i).first == factory)
+                m_uploader->pending.removeAt(i);
+        }
+        if (QSGTexture *texture = m_uploader->uploaded.take(factory))
+            m_texturesToDelete << texture;
+    }
     m_mutex.unlock();
 }
 
+/*
+    Returns the texture uploaded for \a factory on the helper thread. If the
+    upload has not finished, it is scheduled if needed and \a uploadPending
+    is set. Returns 0 without setting \a uploadPending for images which are
+    small enough, or go into the atlas, and are created by the caller.
+ */
+QSGTexture *QSGRenderContext::takeUploadedTexture(QQuickDefaultTextureFactory *factory, bool *uploadPending)
+{
+    if (!m_uploader)
+        return 0;
+
+    const QImage image = factory->image();
+    if (image.width() * image.height() < m_uploader->threshold)
+        return 0;
+
+    m_uploader->mutex.lock();
+    bool usable = !m_uploader->failed;
+    QSGTexture *texture = usable ? m_uploader->uploaded.take(factory) : 0;
+    bool schedule = usable && !texture && !m_uploader->inFlight.contains(factory);
+    m_uploader->mutex.unlock();
+
+    if (!usable || texture)
+        return texture;
+
+    if (schedule) {
+        if (!m_uploader->gl) {
+            QOpenGLContext *gl = new QOpenGLContext;
+            gl->setFormat(m_gl->format());
+            gl->setShareContext(m_gl);
+            if (!gl->create()) {
+                qWarning("QSGRenderContext: failed to create a shared context for texture uploads");
+                delete gl;
+                m_uploader->mutex.lock();
+                m_uploader->failed = true;
+                m_uploader->mutex.unlock();
+                return 0;
+            }
+            gl->moveToThread(m_uploader);
+            m_uploader->gl = gl;
+            m_uploader->renderThread = m_gl->thread();
+        }
+
+        connect(factory, SIGNAL(destroyed(QObject *)), this, SLOT(textureFactoryDestroyed(QObject *)),
+                Qt::ConnectionType(Qt::DirectConnection | Qt::UniqueConnection));
+
+        m_uploader->mutex.lock();
+        m_uploader->inFlight.insert(factory);
+        m_uploader->pending.append(qMakePair(static_cast<QQuickTextureFactory *>(factory), image));
+        bool running = !m_uploader->idle;
+        if (!running)
+            m_uploader->idle = false;
+        m_uploader->mutex.unlock();
+
+        if (!running) {
+            m_uploader->wait();
+            m_uploader->start(QThread::LowPriority);
+        }
+    }
+
+    *uploadPending = true;
+    return 0;
+}
+
 /*!
     Compile \a shader, optionally using \a vertexCode and \a fragmentCode as
     replacement for the source code supplied by \a shader.
@@ -820,11 +1206,18 @@ void QSGRenderContext::compile(QSGMaterialShader *shader, QSGMaterial *material,
                    "QSGRenderContext::compile()",
                    "materials with custom compile step cannot have custom vertex/fragment code");
         QOpenGLShaderProgram *p = shader->program();
-        p->addShaderFromSourceCode(QOpenGLShader::Vertex, vertexCode ? vertexCode : shader->vertexShader());
-        p->addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentCode ? fragmentCode : shader->fragmentShader());
+        const char *vs = vertexCode ? vertexCode : shader->vertexShader();
+        const char *fs = fragmentCode ? fragmentCode : shader->fragmentShader();
+        const QByteArray binaryKey = QSGShaderSourceBuilder::programBinaryKey(vs, fs, shader->attributeNames());
+        if (QSGShaderSourceBuilder::loadProgramBinary(p, binaryKey))
+            return;
+        p->addShaderFromSourceCode(QOpenGLShader::Vertex, vs);
+        p->addShaderFromSourceCode(QOpenGLShader::Fragment, fs);
         p->link();
         if (!p->isLinked())
             qWarning() << "shader compilation failed:" << endl << p->log();
+        else
+            QSGShaderSourceBuilder::saveProgramBinary(p, binaryKey);
     } else {
         shader->compile();
     }
@@ -835,6 +1228,83 @@ void QSGRenderContext::initialize(QSGMaterialShader *shader)
     shader->initialize();
 }
 
+/*!
+    Schedules the shaders of \a materials to be compiled on a helper thread,
+    using a GL context which shares resources with this render context.
+    The render context takes ownership of the materials, which are only
+    used to create the shaders.
+
+    This function is called from the GUI thread. If the render context
+    is not initialized yet, compilation starts as soon as it is.
+ */
+void QSGRenderContext::precompileMaterials(const QList<QSGMaterial *> &materials, QQuickWindow *window)
+{
+#ifdef Q_OS_WIN
+    // Setting up sharing requires the render context to be unbound, which
+    // we cannot guarantee here. Shaders are compiled on first use instead.
+    Q_UNUSED(window);
+    qDeleteAll(materials);
+#else
+    QMutexLocker locker(&m_mutex);
+    if (!m_precompiler)
+        m_precompiler = new QSGShaderPrecompiler(this, window);
+
+    m_precompiler->mutex.lock();
+    m_precompiler->pending += materials;
+    m_precompiler->mutex.unlock();
+
+    if (m_gl)
+        startPrecompiler();
+#endif
+}
+
+/*
+    Starts the helper thread if it is not already working through the
+    pending materials. Called with m_mutex locked.
+ */
+void QSGRenderContext::startPrecompiler()
+{
+    if (!m_precompiler->gl) {
+        QOpenGLContext *gl = new QOpenGLContext;
+        gl->setFormat(m_gl->format());
+        gl->setShareContext(m_gl);
+        if (!gl->create()) {
+            qWarning("QSGRenderContext: failed to create a shared context for shader precompilation");
+            delete gl;
+            return;
+        }
+        gl->moveToThread(m_precompiler);
+        m_precompiler->gl = gl;
+        m_precompiler->renderThread = m_gl->thread();
+    }
+
+    m_precompiler->mutex.lock();
+    bool running = !m_precompiler->idle;
+    if (!running)
+        m_precompiler->idle = false;
+    m_precompiler->mutex.unlock();
+
+    if (!running) {
+        m_precompiler->wait();
+        m_precompiler->start(QThread::LowPriority);
+    }
+}
+
+/*!
+    Returns the shader compiled ahead of time for materials of \a type, or 0
+    if there is none. Set \a rewritten to get the variant with the z
+    attribute which is used by the batch renderer for opaque batches. The
+    caller takes ownership of the shader and needs to initialize it.
+ */
+QSGMaterialShader *QSGRenderContext::takePrecompiledShader(QSGMaterialType *type, bool rewritten)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_precompiler)
+        return 0;
+    QMutexLocker precompilerLocker(&m_precompiler->mutex);
+    return rewritten ? m_precompiler->rewrittenShaders.take(type) : m_precompiler->shaders.take(type);
+}
+
 #include "qsgcontext.moc"
 
 QT_END_NAMESPACE
@@ -71,12 +71,16 @@ class QQuickWindow;
 class QSGTexture;
 class QSGMaterial;
 class QSGMaterialShader;
+class QSGMaterialType;
 class QSGRenderLoop;
+class QSGShaderPrecompiler;
+class QSGTextureUploader;
 
 class QOpenGLContext;
 class QOpenGLFramebufferObject;
 
 class QQuickTextureFactory;
+class QQuickDefaultTextureFactory;
 class QSGDistanceFieldGlyphCacheManager;
 class QSGContext;
 
@@ -109,7 +113,7 @@ public:
     QSGDepthStencilBufferManager *depthStencilBufferManager();
 
     virtual QSGDistanceFieldGlyphCache *distanceFieldGlyphCache(const QRawFont &font);
-    QSGTexture *textureForFactory(QQuickTextureFactory *factory, QQuickWindow *window);
+    QSGTexture *textureForFactory(QQuickTextureFactory *factory, QQuickWindow *window, bool *uploadPending = 0);
 
     virtual QSGTexture *createTexture(const QImage &image) const;
     virtual QSGTexture *createTextureNoAtlas(const QImage &image) const;
@@ -118,6 +122,9 @@ public:
     virtual void compile(QSGMaterialShader *shader, QSGMaterial *material, const char *vertexCode = 0, const char *fragmentCode = 0);
     virtual void initialize(QSGMaterialShader *shader);
 
+    void precompileMaterials(const QList<QSGMaterial *> &materials, QQuickWindow *window);
+    QSGMaterialShader *takePrecompiledShader(QSGMaterialType *type, bool rewritten);
+
     void registerFontengineForCleanup(QFontEngine *engine);
 
     static QSGRenderContext *from(QOpenGLContext *context);
@@ -132,6 +139,9 @@ public Q_SLOTS:
     void textureFactoryDestroyed(QObject *o);
 
 protected:
+    void startPrecompiler();
+    QSGTexture *takeUploadedTexture(QQuickDefaultTextureFactory *factory, bool *uploadPending);
+
     QOpenGLContext *m_gl;
     QSGContext *m_sg;
 
@@ -145,6 +155,9 @@ protected:
 
     QSet<QFontEngine *> m_fontEnginesToClean;
 
+    QSGShaderPrecompiler *m_precompiler;
+    QSGTextureUploader *m_uploader;
+
     bool m_brokenIBOs;
     bool m_serializedRender;
 };
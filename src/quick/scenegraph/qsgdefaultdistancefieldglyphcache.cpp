@@ -84,7 +84,19 @@ QSGDefaultDistanceFieldGlyphCache::QSGDefaultDistanceFieldGlyphCache(QSGDistance
     m_blitTextureCoordinateArray[6] = 0.0f;
     m_blitTextureCoordinateArray[7] = 1.0f;
 
-    m_areaAllocator = new QSGAreaAllocator(QSize(maxTextureSize(), m_maxTextureCount * maxTextureSize()));
+    // The textures only ever grow, so a budget is enforced by limiting the
+    // area glyphs can be allocated in. Unused glyphs are evicted, least
+    // recently used first, once that area is full.
+    int height = m_maxTextureCount * maxTextureSize();
+    bool ok = false;
+    int budgetKb = qgetenv("QSG_DISTANCEFIELD_TEXTURE_BUDGET").toInt(&ok);
+    if (ok && budgetKb > 0) {
+        const int minimumHeight = QT_DISTANCEFIELD_TILESIZE(doubleGlyphResolution());
+        const qint64 budgetHeight = qint64(budgetKb) * 1024 / maxTextureSize();
+        height = qBound<int>(minimumHeight, budgetHeight, height);
+    }
+
+    m_areaAllocator = new QSGAreaAllocator(QSize(maxTextureSize(), height));
 }
 
 QSGDefaultDistanceFieldGlyphCache::~QSGDefaultDistanceFieldGlyphCache()
@@ -113,19 +125,8 @@ void QSGDefaultDistanceFieldGlyphCache::requestGlyphs(const QSet<glyph_t> &glyph
 
         if (alloc.isNull()) {
             // Unallocate unused glyphs until we can allocated the new glyph
-            while (alloc.isNull() && !m_unusedGlyphs.isEmpty()) {
-                glyph_t unusedGlyph = *m_unusedGlyphs.constBegin();
-
-                TexCoord unusedCoord = glyphTexCoord(unusedGlyph);
-                int unusedGlyphWidth = qCeil(glyphData(unusedGlyph).boundingRect.width()) + distanceFieldRadius() * 2;
-                m_areaAllocator->deallocate(QRect(unusedCoord.x, unusedCoord.y, unusedGlyphWidth, QT_DISTANCEFIELD_TILESIZE(doubleGlyphResolution())));
-
-                m_unusedGlyphs.remove(unusedGlyph);
-                m_glyphsTexture.remove(unusedGlyph);
-                removeGlyph(unusedGlyph);
-
+            while (alloc.isNull() && evictUnusedGlyph())
                 alloc = m_areaAllocator->allocate(glyphSize);
-            }
 
             // Not enough space left for this glyph... skip to the next one
             if (alloc.isNull())
@@ -149,7 +150,7 @@ void QSGDefaultDistanceFieldGlyphCache::requestGlyphs(const QSet<glyph_t> &glyph
     markGlyphsToRender(glyphsToRender);
 }
 
-void QSGDefaultDistanceFieldGlyphCache::storeGlyphs(const QList<QDistanceField> &glyphs)
+void QSGDefaultDistanceFieldGlyphCache::storeGlyphs(const QVector<glyph_t> &glyphIds, const QList<QDistanceField> &glyphs)
 {
     QHash<TextureInfo *, QVector<glyph_t> > glyphTextures;
 
@@ -161,7 +162,7 @@ void QSGDefaultDistanceFieldGlyphCache::storeGlyphs(const QList<QDistanceField>
 
     for (int i = 0; i < glyphs.size(); ++i) {
         QDistanceField glyph = glyphs.at(i);
-        glyph_t glyphIndex = glyph.glyph();
+        glyph_t glyphIndex = glyphIds.at(i);
         TexCoord c = glyphTexCoord(glyphIndex);
         TextureInfo *texInfo = m_glyphsTexture.value(glyphIndex);
 
@@ -218,12 +219,49 @@ void QSGDefaultDistanceFieldGlyphCache::storeGlyphs(const QList<QDistanceField>
 
 void QSGDefaultDistanceFieldGlyphCache::referenceGlyphs(const QSet<glyph_t> &glyphs)
 {
-    m_unusedGlyphs -= glyphs;
+    for (QSet<glyph_t>::const_iterator it = glyphs.constBegin(); it != glyphs.constEnd(); ++it) {
+        QHash<glyph_t, QLinkedList<glyph_t>::iterator>::iterator unused = m_unusedGlyphsLookup.find(*it);
+        if (unused != m_unusedGlyphsLookup.end()) {
+            m_unusedGlyphs.erase(unused.value());
+            m_unusedGlyphsLookup.erase(unused);
+        }
+    }
 }
 
 void QSGDefaultDistanceFieldGlyphCache::releaseGlyphs(const QSet<glyph_t> &glyphs)
 {
-    m_unusedGlyphs += glyphs;
+    for (QSet<glyph_t>::const_iterator it = glyphs.constBegin(); it != glyphs.constEnd(); ++it) {
+        if (!m_unusedGlyphsLookup.contains(*it))
+            m_unusedGlyphsLookup.insert(*it, m_unusedGlyphs.insert(m_unusedGlyphs.end(), *it));
+    }
+}
+
+/*
+    Frees the texture area of the least recently used glyph that is no
+    longer referenced by any node. Returns false if there was none.
+ */
+bool QSGDefaultDistanceFieldGlyphCache::evictUnusedGlyph()
+{
+    if (m_unusedGlyphs.isEmpty())
+        return false;
+
+    glyph_t unusedGlyph = m_unusedGlyphs.takeFirst();
+    m_unusedGlyphsLookup.remove(unusedGlyph);
+
+    // The texture coordinates are relative to the glyph's texture, while the
+    // allocator spans all of them stacked vertically.
+    TexCoord unusedCoord = glyphTexCoord(unusedGlyph);
+    TextureInfo *texInfo = m_glyphsTexture.take(unusedGlyph);
+    int textureIndex = 0;
+    while (textureIndex < m_textures.count() && &m_textures[textureIndex] != texInfo)
+        ++textureIndex;
+
+    int unusedGlyphWidth = qCeil(glyphData(unusedGlyph).boundingRect.width()) + distanceFieldRadius() * 2;
+    m_areaAllocator->deallocate(QRect(unusedCoord.x, unusedCoord.y + textureIndex * maxTextureSize(),
+                                      unusedGlyphWidth, QT_DISTANCEFIELD_TILESIZE(doubleGlyphResolution())));
+
+    removeGlyph(unusedGlyph);
+    return true;
 }
 
 void QSGDefaultDistanceFieldGlyphCache::createTexture(TextureInfo *texInfo, int width, int height)
@@ -47,6 +47,7 @@
 #include <qopenglshaderprogram.h>
 #include <QtGui/private/qopenglengineshadersource_p.h>
 #include <private/qsgareaallocator_p.h>
+#include <QtCore/qlinkedlist.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -62,7 +63,7 @@ public:
     virtual ~QSGDefaultDistanceFieldGlyphCache();
 
     void requestGlyphs(const QSet<glyph_t> &glyphs);
-    void storeGlyphs(const QList<QDistanceField> &glyphs);
+    void storeGlyphs(const QVector<glyph_t> &glyphIds, const QList<QDistanceField> &glyphs);
     void referenceGlyphs(const QSet<glyph_t> &glyphs);
     void releaseGlyphs(const QSet<glyph_t> &glyphs);
 
@@ -84,6 +85,8 @@ private:
         { }
     };
 
+    bool evictUnusedGlyph();
+
     void createTexture(TextureInfo * texInfo, int width, int height);
     void resizeTexture(TextureInfo * texInfo, int width, int height);
 
@@ -128,7 +131,10 @@ private:
 
     QList<TextureInfo> m_textures;
     QHash<glyph_t, TextureInfo *> m_glyphsTexture;
-    QSet<glyph_t> m_unusedGlyphs;
+
+    // Unreferenced glyphs, least recently released first
+    QLinkedList<glyph_t> m_unusedGlyphs;
+    QHash<glyph_t, QLinkedList<glyph_t>::iterator> m_unusedGlyphsLookup;
 
     QSGAreaAllocator *m_areaAllocator;
 
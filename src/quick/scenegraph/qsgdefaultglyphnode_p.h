@@ -44,6 +44,7 @@
 
 #include <private/qsgadaptationlayer_p.h>
 #include <QtQuick/qsgnode.h>
+#include <private/qsgblockpool_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -51,6 +52,7 @@ class QGlyphs;
 class QSGTextMaskMaterial;
 class QSGDefaultGlyphNode: public QSGGlyphNode
 {
+    QSG_DECLARE_POOLED_ALLOCATION
 public:
     QSGDefaultGlyphNode();
     virtual ~QSGDefaultGlyphNode();
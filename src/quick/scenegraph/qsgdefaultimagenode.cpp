@@ -41,6 +41,7 @@
 
 #include "qsgdefaultimagenode_p.h"
 #include <private/qsgmaterialshader_p.h>
+#include <private/qsggeometry_p.h>
 
 #include <QtCore/qvarlengtharray.h>
 #include <QtCore/qmath.h>
@@ -320,15 +321,21 @@ namespace {
     struct Y { float y, ty; };
 }
 
+/*
+    Nine-patches and tiles are drawn as one triangle strip, with degenerate
+    triangles between the quads. This gives them the same drawing mode as
+    plain images, so the renderer can merge both kinds into one batch when
+    they use the same atlas.
+ */
 static inline void appendQuad(quint16 **indices, quint16 topLeft, quint16 topRight,
                               quint16 bottomLeft, quint16 bottomRight)
 {
     *(*indices)++ = topLeft;
+    *(*indices)++ = topLeft;
+    *(*indices)++ = topRight;
     *(*indices)++ = bottomLeft;
     *(*indices)++ = bottomRight;
     *(*indices)++ = bottomRight;
-    *(*indices)++ = topRight;
-    *(*indices)++ = topLeft;
 }
 
 void QSGDefaultImageNode::updateGeometry()
@@ -336,7 +343,7 @@ void QSGDefaultImageNode::updateGeometry()
     Q_ASSERT(!m_targetRect.isEmpty());
     const QSGTexture *t = m_material.texture();
     if (!t) {
-        QSGGeometry *g = geometry();
+        QSGGeometry *g = m_antialiasing ? geometry() : &m_geometry;
         g->allocate(4);
         g->setDrawingMode(GL_TRIANGLE_STRIP);
         memset(g->vertexData(), 0, g->sizeOfVertex() * 4);
@@ -527,7 +534,7 @@ void QSGDefaultImageNode::updateGeometry()
 
                 g->allocate(hCells * vCells * 4 + (hCells + vCells - 1) * 4,
                             hCells * vCells * 6 + (hCells + vCells) * 12);
-                g->setDrawingMode(GL_TRIANGLES);
+                g->setDrawingMode(GL_TRIANGLE_STRIP);
                 SmoothVertex *vertices = reinterpret_cast<SmoothVertex *>(g->vertexData());
                 memset(vertices, 0, g->vertexCount() * g->sizeOfVertex());
                 quint16 *indices = g->indexDataAsUShort();
@@ -638,7 +645,7 @@ void QSGDefaultImageNode::updateGeometry()
                 Q_ASSERT(indices - g->indexCount() == g->indexData());
             } else {
                 m_geometry.allocate(hCells * vCells * 4, hCells * vCells * 6);
-                m_geometry.setDrawingMode(GL_TRIANGLES);
+                m_geometry.setDrawingMode(GL_TRIANGLE_STRIP);
                 QSGGeometry::TexturedPoint2D *vertices = m_geometry.vertexDataAsTexturedPoint2D();
                 ys = yData.data();
                 for (int j = 0; j < vCells; ++j, ys += 2) {
@@ -664,6 +671,15 @@ void QSGDefaultImageNode::updateGeometry()
             }
         }
     }
+
+    // Images with the same size and source rectangle share their geometry,
+    // which m_geometry is only the staging area for.
+    if (!m_antialiasing) {
+        setGeometry(QSGSharedGeometry::share(&m_geometry));
+        setFlag(OwnsGeometry, true);
+        m_geometry.allocate(4);
+    }
+
     markDirty(DirtyGeometry);
     m_dirtyGeometry = false;
 }
@@ -45,6 +45,7 @@
 
 #include <private/qsgadaptationlayer_p.h>
 #include <QtQuick/qsgtexturematerial.h>
+#include <private/qsgblockpool_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -62,6 +63,7 @@ protected:
 
 class Q_QUICK_PRIVATE_EXPORT QSGDefaultImageNode : public QSGImageNode
 {
+    QSG_DECLARE_POOLED_ALLOCATION
 public:
     QSGDefaultImageNode();
     virtual void setTargetRect(const QRectF &rect);
@@ -49,6 +49,8 @@
 
 #include <QtQuick/private/qsgcontext_p.h>
 
+#include <QtGui/qopenglcontext.h>
+
 #include <QtCore/qmath.h>
 #include <QtCore/qvarlengtharray.h>
 
@@ -105,6 +107,39 @@ namespace
         static QSGGeometry::AttributeSet attrs = { 3, sizeof(SmoothVertex), data };
         return attrs;
     }
+
+    struct ShadedVertex
+    {
+        float x, y;
+        float dx, dy;
+        void set(float nx, float ny, float ndx, float ndy)
+        {
+            x = nx; y = ny; dx = ndx; dy = ndy;
+        }
+    };
+
+    const QSGGeometry::AttributeSet &shadedAttributeSet()
+    {
+        static QSGGeometry::Attribute data[] = {
+            QSGGeometry::Attribute::create(0, 2, GL_FLOAT, true),
+            QSGGeometry::Attribute::create(1, 2, GL_FLOAT, false)
+        };
+        static QSGGeometry::AttributeSet attrs = { 2, sizeof(ShadedVertex), data };
+        return attrs;
+    }
+
+    /* Rounded rects and gradients are drawn with QSGRoundedRectangleMaterial
+       unless QSG_RECTANGLE_GEOMETRY is set, which brings back the tessellated
+       geometry, for instance for drivers with poor fragment shader precision. */
+    bool useShadedRectangles()
+    {
+        static bool shaded = qgetenv("QSG_RECTANGLE_GEOMETRY").toInt() == 0;
+        return shaded;
+    }
+
+    // Number of texels per gradient and number of gradients in the atlas.
+    const int GRADIENT_WIDTH = 256;
+    const int GRADIENT_ROWS = 256;
 }
 
 class SmoothColorMaterialShader : public QSGMaterialShader
@@ -186,6 +221,280 @@ QSGMaterialShader *QSGSmoothColorMaterial::createShader() const
 }
 
 
+class RoundedRectangleMaterialShader : public QSGMaterialShader
+{
+public:
+    RoundedRectangleMaterialShader();
+
+    virtual void updateState(const RenderState &state, QSGMaterial *newEffect, QSGMaterial *oldEffect);
+    virtual char const *const *attributeNames() const;
+
+private:
+    virtual void initialize();
+
+    int m_matrixLoc;
+    int m_opacityLoc;
+    int m_pixelSizeLoc;
+    int m_rectLoc;
+    int m_radiusLoc;
+    int m_penWidthLoc;
+    int m_smoothnessLoc;
+    int m_colorLoc;
+    int m_borderColorLoc;
+    int m_useGradientLoc;
+    int m_gradientRowLoc;
+};
+
+RoundedRectangleMaterialShader::RoundedRectangleMaterialShader()
+    : QSGMaterialShader()
+{
+    setShaderSourceFile(QOpenGLShader::Vertex, QStringLiteral(":/scenegraph/shaders/roundedrect.vert"));
+    setShaderSourceFile(QOpenGLShader::Fragment, QStringLiteral(":/scenegraph/shaders/roundedrect.frag"));
+}
+
+static inline QVector4D qsg_premultiplied(const QColor &c)
+{
+    float a = c.alphaF();
+    return QVector4D(c.redF() * a, c.greenF() * a, c.blueF() * a, a);
+}
+
+void RoundedRectangleMaterialShader::updateState(const RenderState &state, QSGMaterial *newEffect, QSGMaterial *oldEffect)
+{
+    QSGRoundedRectangleMaterial *m = static_cast<QSGRoundedRectangleMaterial *>(newEffect);
+    QSGRoundedRectangleMaterial *old = static_cast<QSGRoundedRectangleMaterial *>(oldEffect);
+
+    if (state.isOpacityDirty())
+        program()->setUniformValue(m_opacityLoc, state.opacity());
+
+    if (state.isMatrixDirty()) {
+        program()->setUniformValue(m_matrixLoc, state.combinedMatrix());
+        QRect r = state.viewportRect();
+        program()->setUniformValue(m_pixelSizeLoc, 2.0f / r.width(), 2.0f / r.height());
+    }
+
+    if (old == 0 || m->compare(old) != 0) {
+        QRectF r = m->rect();
+        program()->setUniformValue(m_rectLoc, QVector4D(r.x(), r.y(), r.width(), r.height()));
+        program()->setUniformValue(m_radiusLoc, m->radius());
+        program()->setUniformValue(m_penWidthLoc, m->penWidth());
+        program()->setUniformValue(m_smoothnessLoc, m->antialiasing() ? 1.0f : 0.001f);
+        program()->setUniformValue(m_colorLoc, qsg_premultiplied(m->color()));
+        program()->setUniformValue(m_borderColorLoc, qsg_premultiplied(m->borderColor()));
+        program()->setUniformValue(m_useGradientLoc, m->gradientStops().isEmpty() ? 0.0f : 1.0f);
+    }
+
+    // Other materials may have bound their own textures in between.
+    if (!m->gradientStops().isEmpty()) {
+        float row = QSGGradientCache::cacheForCurrentContext()->bindGradient(m->gradientKey(), m->gradientStops());
+        program()->setUniformValue(m_gradientRowLoc, row);
+    }
+}
+
+char const *const *RoundedRectangleMaterialShader::attributeNames() const
+{
+    static char const *const attributes[] = {
+        "vertex",
+        "vertexOffset",
+        0
+    };
+    return attributes;
+}
+
+void RoundedRectangleMaterialShader::initialize()
+{
+    m_matrixLoc = program()->uniformLocation("matrix");
+    m_opacityLoc = program()->uniformLocation("opacity");
+    m_pixelSizeLoc = program()->uniformLocation("pixelSize");
+    m_rectLoc = program()->uniformLocation("rect");
+    m_radiusLoc = program()->uniformLocation("radius");
+    m_penWidthLoc = program()->uniformLocation("penWidth");
+    m_smoothnessLoc = program()->uniformLocation("smoothness");
+    m_colorLoc = program()->uniformLocation("color");
+    m_borderColorLoc = program()->uniformLocation("borderColor");
+    m_useGradientLoc = program()->uniformLocation("useGradient");
+    m_gradientRowLoc = program()->uniformLocation("gradientRow");
+    program()->setUniformValue("gradientTexture", 0); // GL_TEXTURE0
+}
+
+/*!
+    \class QSGRoundedRectangleMaterial
+    \internal
+
+    Draws a rectangle with rounded corners, a border and an optional vertical
+    gradient from a single quad. The coverage of the fill and the border is
+    computed from the distance to the rounded rect in the fragment shader, so
+    changing the size or the radius only changes uniform values. Gradients are
+    looked up in a texture atlas shared by all rectangles of a GL context.
+ */
+
+QSGRoundedRectangleMaterial::QSGRoundedRectangleMaterial()
+    : m_radius(0)
+    , m_penWidth(0)
+    , m_antialiasing(false)
+{
+    // The shader works in item coordinates, so nodes using this material
+    // cannot be merged into batches.
+    setFlag(RequiresFullMatrix, true);
+    setFlag(Blending, true);
+}
+
+void QSGRoundedRectangleMaterial::setGradientStops(const QGradientStops &stops)
+{
+    m_gradientStops = stops;
+    m_gradientKey.clear();
+    m_gradientKey.reserve(stops.size() * (sizeof(float) + sizeof(QRgb)));
+    for (int i = 0; i < stops.size(); ++i) {
+        float position = stops.at(i).first;
+        QRgb rgba = stops.at(i).second.rgba();
+        m_gradientKey.append(reinterpret_cast<const char *>(&position), sizeof(float));
+        m_gradientKey.append(reinterpret_cast<const char *>(&rgba), sizeof(QRgb));
+    }
+}
+
+template <typename T> static inline int qsg_compare(T a, T b)
+{
+    return a < b ? -1 : (b < a ? 1 : 0);
+}
+
+int QSGRoundedRectangleMaterial::compare(const QSGMaterial *other) const
+{
+    const QSGRoundedRectangleMaterial *o = static_cast<const QSGRoundedRectangleMaterial *>(other);
+    if (int c = qsg_compare(m_rect.x(), o->m_rect.x()))
+        return c;
+    if (int c = qsg_compare(m_rect.y(), o->m_rect.y()))
+        return c;
+    if (int c = qsg_compare(m_rect.width(), o->m_rect.width()))
+        return c;
+    if (int c = qsg_compare(m_rect.height(), o->m_rect.height()))
+        return c;
+    if (int c = qsg_compare(m_radius, o->m_radius))
+        return c;
+    if (int c = qsg_compare(m_penWidth, o->m_penWidth))
+        return c;
+    if (int c = qsg_compare(m_color.rgba(), o->m_color.rgba()))
+        return c;
+    if (int c = qsg_compare(m_borderColor.rgba(), o->m_borderColor.rgba()))
+        return c;
+    if (int c = qsg_compare(m_antialiasing, o->m_antialiasing))
+        return c;
+    return qsg_compare(m_gradientKey, o->m_gradientKey);
+}
+
+QSGMaterialType *QSGRoundedRectangleMaterial::type() const
+{
+    static QSGMaterialType type;
+    return &type;
+}
+
+QSGMaterialShader *QSGRoundedRectangleMaterial::createShader() const
+{
+    return new RoundedRectangleMaterialShader;
+}
+
+/*!
+    \class QSGGradientCache
+    \internal
+
+    Holds the gradients of the rectangles rendered with a GL context in a
+    texture with one row of GRADIENT_WIDTH texels per set of gradient stops.
+    When the atlas is full, it starts over from the first row.
+ */
+
+QSGGradientCache::QSGGradientCache(QObject *parent)
+    : QObject(parent)
+    , m_texture(0)
+    , m_nextRow(0)
+{
+    setObjectName(QStringLiteral("__qt_GradientCache"));
+}
+
+QSGGradientCache::~QSGGradientCache()
+{
+    invalidate();
+}
+
+/*!
+    Returns the gradient cache of the current GL context, creating it if needed.
+ */
+QSGGradientCache *QSGGradientCache::cacheForCurrentContext()
+{
+    QOpenGLContext *gl = QOpenGLContext::currentContext();
+    QSGRenderContext *renderContext = QSGRenderContext::from(gl);
+    QObject *owner = renderContext ? static_cast<QObject *>(renderContext) : static_cast<QObject *>(gl);
+    QSGGradientCache *cache = owner->findChild<QSGGradientCache *>(QStringLiteral("__qt_GradientCache"));
+    if (!cache) {
+        cache = new QSGGradientCache(owner);
+        if (renderContext)
+            connect(renderContext, SIGNAL(invalidated()), cache, SLOT(invalidate()), Qt::DirectConnection);
+        else
+            connect(gl, SIGNAL(aboutToBeDestroyed()), cache, SLOT(invalidate()), Qt::DirectConnection);
+    }
+    return cache;
+}
+
+void QSGGradientCache::invalidate()
+{
+    if (m_texture && QOpenGLContext::currentContext())
+        glDeleteTextures(1, &m_texture);
+    m_texture = 0;
+    m_rows.clear();
+    m_nextRow = 0;
+}
+
+/*!
+    Binds the gradient atlas and returns the texture coordinate of the row
+    holding the gradient described by \a stops, which is identified by \a key.
+ */
+float QSGGradientCache::bindGradient(const QByteArray &key, const QGradientStops &stops)
+{
+    if (!m_texture) {
+        glGenTextures(1, &m_texture);
+        glBindTexture(GL_TEXTURE_2D, m_texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, GRADIENT_WIDTH, GRADIENT_ROWS, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    } else {
+        glBindTexture(GL_TEXTURE_2D, m_texture);
+    }
+
+    QHash<QByteArray, int>::const_iterator it = m_rows.constFind(key);
+    if (it != m_rows.constEnd())
+        return (it.value() + 0.5f) / GRADIENT_ROWS;
+
+    if (m_nextRow == GRADIENT_ROWS) {
+        m_rows.clear();
+        m_nextRow = 0;
+    }
+    int row = m_nextRow++;
+    m_rows.insert(key, row);
+
+    // Interpolate premultiplied colors, like the vertex colors of the
+    // tessellated rectangle do.
+    Color4ub texels[GRADIENT_WIDTH];
+    int next = 0;
+    for (int i = 0; i < GRADIENT_WIDTH; ++i) {
+        float t = i / float(GRADIENT_WIDTH - 1);
+        while (next < stops.size() && stops.at(next).first <= t)
+            ++next;
+        if (next == 0) {
+            texels[i] = colorToColor4ub(stops.first().second);
+        } else if (next == stops.size()) {
+            texels[i] = colorToColor4ub(stops.last().second);
+        } else {
+            const QGradientStop &prev = stops.at(next - 1);
+            const QGradientStop &stop = stops.at(next);
+            float f = (t - prev.first) / (stop.first - prev.first);
+            texels[i] = colorToColor4ub(prev.second) * (1 - f) + colorToColor4ub(stop.second) * f;
+        }
+    }
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, row, GRADIENT_WIDTH, 1, GL_RGBA, GL_UNSIGNED_BYTE, texels);
+
+    return (row + 0.5f) / GRADIENT_ROWS;
+}
+
+
 QSGDefaultRectangleNode::QSGDefaultRectangleNode()
     : m_radius(0)
     , m_pen_width(0)
@@ -193,6 +502,7 @@ QSGDefaultRectangleNode::QSGDefaultRectangleNode()
     , m_antialiasing(false)
     , m_gradient_is_opaque(true)
     , m_dirty_geometry(false)
+    , m_mode(PlainMode)
     , m_geometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0)
 {
     setGeometry(&m_geometry);
@@ -264,15 +574,6 @@ void QSGDefaultRectangleNode::setAntialiasing(bool antialiasing)
     if (antialiasing == m_antialiasing)
         return;
     m_antialiasing = antialiasing;
-    if (m_antialiasing) {
-        setMaterial(&m_smoothMaterial);
-        setGeometry(new QSGGeometry(smoothAttributeSet(), 0));
-        setFlag(OwnsGeometry, true);
-    } else {
-        setMaterial(&m_material);
-        setGeometry(&m_geometry);
-        setFlag(OwnsGeometry, false);
-    }
     m_dirty_geometry = true;
 }
 
@@ -287,10 +588,19 @@ void QSGDefaultRectangleNode::setAligned(bool aligned)
 void QSGDefaultRectangleNode::update()
 {
     if (m_dirty_geometry) {
-        updateGeometry();
+        QSGNode::DirtyState state = QSGNode::DirtyGeometry;
+
+        Mode oldMode = Mode(m_mode);
+        updateMode();
+        if (m_mode != oldMode)
+            state |= QSGNode::DirtyMaterial;
+
+        if (m_mode == ShadedMode)
+            updateShadedGeometry();
+        else
+            updateGeometry();
         m_dirty_geometry = false;
 
-        QSGNode::DirtyState state = QSGNode::DirtyGeometry;
         // smoothed material is always blended, so no change in material state
         if (material() == &m_material) {
             bool wasBlending = (m_material.flags() & QSGMaterial::Blending);
@@ -307,6 +617,78 @@ void QSGDefaultRectangleNode::update()
     }
 }
 
+/* Picks the material for the current state. Rounded and gradient rectangles
+   are drawn by QSGRoundedRectangleMaterial from a single quad, so resizing
+   them or changing the radius does not tessellate the corners again. Plain
+   rectangles keep the vertex color materials, which can be merged.
+ */
+void QSGDefaultRectangleNode::updateMode()
+{
+    Mode mode;
+    if (useShadedRectangles() && (m_radius > 0 || !m_gradient_stops.isEmpty()))
+        mode = ShadedMode;
+    else if (m_antialiasing)
+        mode = SmoothMode;
+    else
+        mode = PlainMode;
+
+    if (mode == m_mode)
+        return;
+    m_mode = mode;
+
+    switch (mode) {
+    case PlainMode:
+        setMaterial(&m_material);
+        setGeometry(&m_geometry);
+        setFlag(OwnsGeometry, false);
+        break;
+    case SmoothMode:
+        setMaterial(&m_smoothMaterial);
+        setGeometry(new QSGGeometry(smoothAttributeSet(), 0));
+        setFlag(OwnsGeometry, true);
+        break;
+    case ShadedMode:
+        setMaterial(&m_shadedMaterial);
+        setGeometry(new QSGGeometry(shadedAttributeSet(), 4));
+        setFlag(OwnsGeometry, true);
+        break;
+    }
+}
+
+void QSGDefaultRectangleNode::updateShadedGeometry()
+{
+    float width = float(m_rect.width());
+    float height = float(m_rect.height());
+    float penWidth = qMin(qMin(width, height) * 0.5f, float(m_pen_width));
+    float radius = qMin(qMin(width, height) * 0.5f, float(m_radius));
+
+    if (m_aligned)
+        penWidth = qRound(penWidth);
+
+    m_shadedMaterial.setRect(m_rect);
+    m_shadedMaterial.setRadius(qMax(radius, 0.0f));
+    m_shadedMaterial.setPenWidth(qMax(penWidth, 0.0f));
+    m_shadedMaterial.setColor(m_color);
+    m_shadedMaterial.setBorderColor(m_border_color);
+    m_shadedMaterial.setAntialiasing(m_antialiasing);
+    if (m_shadedMaterial.gradientStops().constData() != m_gradient_stops.constData())
+        m_shadedMaterial.setGradientStops(m_gradient_stops);
+
+    // The vertex shader moves the corners out by one pixel along the offsets
+    // so that the antialiased edges are not cut off.
+    QSGGeometry *g = geometry();
+    g->setDrawingMode(GL_TRIANGLE_STRIP);
+    ShadedVertex *vertices = reinterpret_cast<ShadedVertex *>(g->vertexData());
+    float left = float(m_rect.left());
+    float top = float(m_rect.top());
+    float right = float(m_rect.right());
+    float bottom = float(m_rect.bottom());
+    vertices[0].set(left, top, -1, -1);
+    vertices[1].set(right, top, 1, -1);
+    vertices[2].set(left, bottom, -1, 1);
+    vertices[3].set(right, bottom, 1, 1);
+}
+
 void QSGDefaultRectangleNode::updateGeometry()
 {
     float width = float(m_rect.width());
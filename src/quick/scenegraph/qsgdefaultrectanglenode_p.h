@@ -47,6 +47,10 @@
 
 #include <QtQuick/qsgvertexcolormaterial.h>
 
+#include <QtCore/qhash.h>
+#include <QtCore/qobject.h>
+#include <private/qsgblockpool_p.h>
+
 QT_BEGIN_NAMESPACE
 
 class QSGContext;
@@ -63,8 +67,74 @@ protected:
     virtual QSGMaterialShader *createShader() const;
 };
 
+class Q_QUICK_PRIVATE_EXPORT QSGRoundedRectangleMaterial : public QSGMaterial
+{
+public:
+    QSGRoundedRectangleMaterial();
+
+    int compare(const QSGMaterial *other) const;
+
+    void setRect(const QRectF &rect) { m_rect = rect; }
+    QRectF rect() const { return m_rect; }
+
+    void setRadius(float radius) { m_radius = radius; }
+    float radius() const { return m_radius; }
+
+    void setPenWidth(float width) { m_penWidth = width; }
+    float penWidth() const { return m_penWidth; }
+
+    void setColor(const QColor &color) { m_color = color; }
+    QColor color() const { return m_color; }
+
+    void setBorderColor(const QColor &color) { m_borderColor = color; }
+    QColor borderColor() const { return m_borderColor; }
+
+    void setAntialiasing(bool antialiasing) { m_antialiasing = antialiasing; }
+    bool antialiasing() const { return m_antialiasing; }
+
+    void setGradientStops(const QGradientStops &stops);
+    const QGradientStops &gradientStops() const { return m_gradientStops; }
+    const QByteArray &gradientKey() const { return m_gradientKey; }
+
+protected:
+    virtual QSGMaterialType *type() const;
+    virtual QSGMaterialShader *createShader() const;
+
+private:
+    QRectF m_rect;
+    float m_radius;
+    float m_penWidth;
+    QColor m_color;
+    QColor m_borderColor;
+    QGradientStops m_gradientStops;
+    QByteArray m_gradientKey;
+    bool m_antialiasing;
+};
+
+class QSGGradientCache : public QObject
+{
+    Q_OBJECT
+public:
+    ~QSGGradientCache();
+
+    static QSGGradientCache *cacheForCurrentContext();
+
+    float bindGradient(const QByteArray &key, const QGradientStops &stops);
+
+public Q_SLOTS:
+    void invalidate();
+
+private:
+    QSGGradientCache(QObject *parent);
+
+    QHash<QByteArray, int> m_rows;
+    GLuint m_texture;
+    int m_nextRow;
+};
+
 class Q_QUICK_PRIVATE_EXPORT QSGDefaultRectangleNode : public QSGRectangleNode
 {
+    QSG_DECLARE_POOLED_ALLOCATION
 public:
     QSGDefaultRectangleNode();
 
@@ -79,11 +149,20 @@ public:
     virtual void update();
 
 private:
+    enum Mode {
+        PlainMode,
+        SmoothMode,
+        ShadedMode
+    };
+
+    void updateMode();
     void updateGeometry();
+    void updateShadedGeometry();
     void updateGradientTexture();
 
     QSGVertexColorMaterial m_material;
     QSGSmoothColorMaterial m_smoothMaterial;
+    QSGRoundedRectangleMaterial m_shadedMaterial;
 
     QRectF m_rect;
     QGradientStops m_gradient_stops;
@@ -96,6 +175,7 @@ private:
     uint m_antialiasing : 1;
     uint m_gradient_is_opaque : 1;
     uint m_dirty_geometry : 1;
+    uint m_mode : 2;
 
     QSGGeometry m_geometry;
 };
@@ -46,6 +46,30 @@
 
 QT_BEGIN_NAMESPACE
 
+struct QSGDistanceFieldColoredPoint2D {
+    float x, y;
+    float tx, ty;
+    unsigned char r, g, b, a;
+};
+
+static const QSGGeometry::AttributeSet &qsg_vertexColorTextAttributes()
+{
+    static QSGGeometry::Attribute data[] = {
+        QSGGeometry::Attribute::create(0, 2, GL_FLOAT, true),
+        QSGGeometry::Attribute::create(1, 2, GL_FLOAT),
+        QSGGeometry::Attribute::create(2, 4, GL_UNSIGNED_BYTE)
+    };
+    static QSGGeometry::AttributeSet attrs = { 3, sizeof(QSGDistanceFieldColoredPoint2D), data };
+    return attrs;
+}
+
+/* Plain text can take its color from the vertices, see updateMaterial() */
+static bool qsg_useVertexColorText()
+{
+    static bool use = qgetenv("QSG_DISTANCEFIELD_VERTEX_COLOR") != "0";
+    return use;
+}
+
 QSGDistanceFieldGlyphNode::QSGDistanceFieldGlyphNode(QSGRenderContext *context)
     : m_glyphNodeType(RootGlyphNode)
     , m_context(context)
@@ -89,6 +113,8 @@ void QSGDistanceFieldGlyphNode::setColor(const QColor &color)
     if (m_material != 0) {
         m_material->setColor(color);
         markDirty(DirtyMaterial);
+        if (geometry() != &m_geometry)
+            updateVertexColors();
     } else {
         m_dirtyMaterial = true;
     }
@@ -107,6 +133,7 @@ void QSGDistanceFieldGlyphNode::setGlyphs(const QPointF &position, const QGlyphR
     QRawFont font = glyphs.rawFont();
     m_originalPosition = position;
     m_position = QPointF(position.x(), position.y() - font.ascent());
+    const QVector<quint32> oldGlyphIndexes = m_glyphs.glyphIndexes();
     m_glyphs = glyphs;
 
     m_dirtyGeometry = true;
@@ -129,7 +156,13 @@ void QSGDistanceFieldGlyphNode::setGlyphs(const QPointF &position, const QGlyphR
     }
     m_glyph_cache->populate(glyphs.glyphIndexes());
 
+    // Release the previous glyphs only after referencing the new ones, so
+    // that glyphs present in both never become candidates for eviction.
+    if (oldCache)
+        oldCache->release(oldGlyphIndexes);
+
     const QVector<quint32> glyphIndexes = m_glyphs.glyphIndexes();
+    m_allGlyphIndexesLookup.clear();
     for (int i = 0; i < glyphIndexes.count(); ++i)
         m_allGlyphIndexesLookup.insert(glyphIndexes.at(i));
 }
@@ -324,7 +357,18 @@ void QSGDistanceFieldGlyphNode::updateGeometry()
     }
 
     g->allocate(vp.size(), ip.size());
-    memcpy(g->vertexDataAsTexturedPoint2D(), vp.constData(), vp.size() * sizeof(QSGGeometry::TexturedPoint2D));
+    if (g != &m_geometry) {
+        QSGDistanceFieldColoredPoint2D *v = static_cast<QSGDistanceFieldColoredPoint2D *>(g->vertexData());
+        for (int i = 0; i < vp.size(); ++i) {
+            v[i].x = vp.at(i).x;
+            v[i].y = vp.at(i).y;
+            v[i].tx = vp.at(i).tx;
+            v[i].ty = vp.at(i).ty;
+        }
+        updateVertexColors();
+    } else {
+        memcpy(g->vertexDataAsTexturedPoint2D(), vp.constData(), vp.size() * sizeof(QSGGeometry::TexturedPoint2D));
+    }
     memcpy(g->indexDataAsUShort(), ip.constData(), ip.size() * sizeof(quint16));
 
     setBoundingRect(m_boundingRect);
@@ -338,6 +382,11 @@ void QSGDistanceFieldGlyphNode::updateMaterial()
 {
     delete m_material;
 
+    // Plain gray antialiased text takes its color from the vertices, which
+    // lets text runs in different colors share a batch. The styled and
+    // subpixel materials need the color as a uniform.
+    bool vertexColor = false;
+
     if (m_style == QQuickText::Normal) {
         switch (m_antialiasingMode) {
         case HighQualitySubPixelAntialiasing:
@@ -348,7 +397,11 @@ void QSGDistanceFieldGlyphNode::updateMaterial()
             break;
         case GrayAntialiasing:
         default:
-            m_material = new QSGDistanceFieldTextMaterial;
+            vertexColor = qsg_useVertexColorText();
+            if (vertexColor)
+                m_material = new QSGDistanceFieldVertexColorTextMaterial;
+            else
+                m_material = new QSGDistanceFieldTextMaterial;
             break;
         }
     } else {
@@ -372,7 +425,51 @@ void QSGDistanceFieldGlyphNode::updateMaterial()
         m_material->setFontScale(m_glyph_cache->fontScale(m_glyphs.rawFont().pixelSize()));
     m_material->setColor(m_color);
     setMaterial(m_material);
+    setUseVertexColor(vertexColor);
     m_dirtyMaterial = false;
 }
 
+/*
+    Switches between the plain textured geometry and one with a color per
+    vertex, which the vertex color material needs.
+ */
+void QSGDistanceFieldGlyphNode::setUseVertexColor(bool use)
+{
+    if (use == (geometry() != &m_geometry))
+        return;
+
+    if (use) {
+        QSGGeometry *g = new QSGGeometry(qsg_vertexColorTextAttributes(), 0);
+        g->setDrawingMode(GL_TRIANGLES);
+        setGeometry(g);
+        setFlag(OwnsGeometry);
+    } else {
+        setGeometry(&m_geometry);
+        setFlag(OwnsGeometry, false);
+    }
+    m_dirtyGeometry = true;
+}
+
+void QSGDistanceFieldGlyphNode::updateVertexColors()
+{
+    QSGGeometry *g = geometry();
+    if (!g->vertexCount())
+        return;
+
+    const qreal alpha = m_color.alphaF();
+    const uchar r = uchar(qRound(m_color.redF() * alpha * 255));
+    const uchar gr = uchar(qRound(m_color.greenF() * alpha * 255));
+    const uchar b = uchar(qRound(m_color.blueF() * alpha * 255));
+    const uchar a = uchar(m_color.alpha());
+
+    QSGDistanceFieldColoredPoint2D *v = static_cast<QSGDistanceFieldColoredPoint2D *>(g->vertexData());
+    for (int i = 0; i < g->vertexCount(); ++i) {
+        v[i].r = r;
+        v[i].g = gr;
+        v[i].b = b;
+        v[i].a = a;
+    }
+    markDirty(DirtyGeometry);
+}
+
 QT_END_NAMESPACE
@@ -252,6 +252,76 @@ int QSGDistanceFieldTextMaterial::compare(const QSGMaterial *o) const
 }
 
 
+/*
+    Takes the text color from the vertices rather than from a uniform, so
+    that text in different colors can be merged into a single batch.
+ */
+class QSGDistanceFieldVertexColorTextMaterialShader : public QSGDistanceFieldTextMaterialShader
+{
+public:
+    QSGDistanceFieldVertexColorTextMaterialShader();
+
+    virtual void updateState(const RenderState &state, QSGMaterial *newEffect, QSGMaterial *oldEffect);
+    virtual char const *const *attributeNames() const;
+
+protected:
+    virtual void initialize();
+
+    int m_opacity_id;
+};
+
+char const *const *QSGDistanceFieldVertexColorTextMaterialShader::attributeNames() const {
+    static char const *const attr[] = { "vCoord", "tCoord", "vColor", 0 };
+    return attr;
+}
+
+QSGDistanceFieldVertexColorTextMaterialShader::QSGDistanceFieldVertexColorTextMaterialShader()
+    : QSGDistanceFieldTextMaterialShader()
+{
+    setShaderSourceFile(QOpenGLShader::Vertex, QStringLiteral(":/scenegraph/shaders/distancefieldvertexcolortext.vert"));
+    setShaderSourceFile(QOpenGLShader::Fragment, QStringLiteral(":/scenegraph/shaders/distancefieldvertexcolortext.frag"));
+}
+
+void QSGDistanceFieldVertexColorTextMaterialShader::initialize()
+{
+    QSGDistanceFieldTextMaterialShader::initialize();
+    m_opacity_id = program()->uniformLocation("opacity");
+}
+
+void QSGDistanceFieldVertexColorTextMaterialShader::updateState(const RenderState &state, QSGMaterial *newEffect, QSGMaterial *oldEffect)
+{
+    QSGDistanceFieldTextMaterialShader::updateState(state, newEffect, oldEffect);
+
+    if (oldEffect == 0 || state.isOpacityDirty())
+        program()->setUniformValue(m_opacity_id, GLfloat(state.opacity()));
+}
+
+QSGMaterialType *QSGDistanceFieldVertexColorTextMaterial::type() const
+{
+    static QSGMaterialType type;
+    return &type;
+}
+
+QSGMaterialShader *QSGDistanceFieldVertexColorTextMaterial::createShader() const
+{
+    return new QSGDistanceFieldVertexColorTextMaterialShader;
+}
+
+int QSGDistanceFieldVertexColorTextMaterial::compare(const QSGMaterial *o) const
+{
+    Q_ASSERT(o && type() == o->type());
+    const QSGDistanceFieldVertexColorTextMaterial *other = static_cast<const QSGDistanceFieldVertexColorTextMaterial *>(o);
+    if (m_glyph_cache != other->m_glyph_cache)
+        return m_glyph_cache - other->m_glyph_cache;
+    if (m_fontScale != other->m_fontScale) {
+        return int(other->m_fontScale < m_fontScale) - int(m_fontScale < other->m_fontScale);
+    }
+    int t0 = m_texture ? m_texture->textureId : 0;
+    int t1 = other->m_texture ? other->m_texture->textureId : 0;
+    return t0 - t1;
+}
+
+
 class DistanceFieldStyledTextMaterialShader : public QSGDistanceFieldTextMaterialShader
 {
 public:
@@ -46,6 +46,7 @@
 #include <QtQuick/qsgtexture.h>
 
 #include <QtQuick/private/qquicktext_p.h>
+#include <private/qsgblockpool_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -54,6 +55,7 @@ class QSGDistanceFieldGlyphCacheManager;
 class QSGDistanceFieldTextMaterial;
 class QSGDistanceFieldGlyphNode: public QSGGlyphNode, public QSGDistanceFieldGlyphConsumer
 {
+    QSG_DECLARE_POOLED_ALLOCATION
 public:
     QSGDistanceFieldGlyphNode(QSGRenderContext *context);
     ~QSGDistanceFieldGlyphNode();
@@ -82,6 +84,8 @@ private:
 
     void setGlyphNodeType(DistanceFieldGlyphNodeType type) { m_glyphNodeType = type; }
     void updateMaterial();
+    void setUseVertexColor(bool use);
+    void updateVertexColors();
 
     DistanceFieldGlyphNodeType m_glyphNodeType;
     QColor m_color;
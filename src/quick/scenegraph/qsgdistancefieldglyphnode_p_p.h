@@ -82,6 +82,14 @@ protected:
     qreal m_fontScale;
 };
 
+class Q_QUICK_PRIVATE_EXPORT QSGDistanceFieldVertexColorTextMaterial : public QSGDistanceFieldTextMaterial
+{
+public:
+    virtual QSGMaterialType *type() const;
+    virtual QSGMaterialShader *createShader() const;
+    virtual int compare(const QSGMaterial *other) const;
+};
+
 class Q_QUICK_PRIVATE_EXPORT QSGDistanceFieldStyledTextMaterial : public QSGDistanceFieldTextMaterial
 {
 public:
@@ -58,6 +58,7 @@ class Q_QUICK_PRIVATE_EXPORT QSGRenderLoop : public QObject
     Q_OBJECT
 
 public:
+    QSGRenderLoop() : m_lastFrameTime(0) {}
     virtual ~QSGRenderLoop();
 
     virtual void show(QQuickWindow *window) = 0;
@@ -89,6 +90,11 @@ public:
 
     virtual bool interleaveIncubation() const { return false; }
 
+    // Milliseconds the GUI thread spent on the last frame. Loops that
+    // interleave incubation update it before emitting timeToIncubate(), so
+    // that incubation can be fitted into the rest of the frame.
+    int lastFrameTime() const { return m_lastFrameTime; }
+
     static void cleanup();
 
 Q_SIGNALS:
@@ -97,6 +103,8 @@ Q_SIGNALS:
 protected:
     void handleContextCreationFailure(QQuickWindow *window, bool isEs);
 
+    int m_lastFrameTime;
+
 private:
     static QSGRenderLoop *s_instance;
 
@@ -301,7 +301,7 @@ void QSGSharedDistanceFieldGlyphCache::waitForGlyphs()
     }
 }
 
-void QSGSharedDistanceFieldGlyphCache::storeGlyphs(const QList<QDistanceField> &glyphs)
+void QSGSharedDistanceFieldGlyphCache::storeGlyphs(const QVector<glyph_t> &glyphIds, const QList<QDistanceField> &glyphs)
 {
     {
         QMutexLocker locker(&m_pendingGlyphsMutex);
@@ -311,12 +311,10 @@ void QSGSharedDistanceFieldGlyphCache::storeGlyphs(const QList<QDistanceField> &
 #endif
 
         int glyphCount = glyphs.size();
-        QVector<quint32> glyphIds(glyphCount);
         QVector<QImage> images(glyphCount);
         for (int i = 0; i < glyphs.size(); ++i) {
             const QDistanceField &df = glyphs.at(i);
-            m_requestedGlyphsThatHaveNotBeenReturned.insert(df.glyph());
-            glyphIds[i] = df.glyph();
+            m_requestedGlyphsThatHaveNotBeenReturned.insert(glyphIds.at(i));
             // ### TODO: Handle QDistanceField in QPlatformSharedGraphicsCache
             images[i] = df.toImage(QImage::Format_Indexed8);
         }
@@ -386,6 +384,8 @@ void QSGSharedDistanceFieldGlyphCache::releaseGlyphs(const QSet<glyph_t> &glyphs
 
 void QSGSharedDistanceFieldGlyphCache::registerOwnerElement(QQuickItem *ownerElement)
 {
+    QSGDistanceFieldGlyphCache::registerOwnerElement(ownerElement);
+
     Owner &owner = m_registeredOwners[ownerElement];
     if (owner.ref == 0) {
         owner.item = ownerElement;
@@ -399,6 +399,8 @@ void QSGSharedDistanceFieldGlyphCache::registerOwnerElement(QQuickItem *ownerEle
 
 void QSGSharedDistanceFieldGlyphCache::unregisterOwnerElement(QQuickItem *ownerElement)
 {
+    QSGDistanceFieldGlyphCache::unregisterOwnerElement(ownerElement);
+
     QHash<QQuickItem *, Owner>::iterator it = m_registeredOwners.find(ownerElement);
     if (it != m_registeredOwners.end() && --it->ref <= 0) {
         if (it->item)
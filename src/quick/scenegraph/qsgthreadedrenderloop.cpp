@@ -108,6 +108,27 @@
    windows have disabled persistency). Especially for multiprocess,
    low-end systems, this should be quite important.
 
+   ---
+
+   With QSG_PIPELINED_SYNC=1, the GUI thread does not block in
+   polishAndSync() while the render thread is still rendering or
+   swapping the previous frame. It defers the sync instead and goes on
+   processing events, timers and JavaScript. The render thread posts
+   WM_ReadyForSync when it is done, and the GUI thread then polishes
+   and blocks only for the sync itself. The items hold the state which
+   updatePaintNode() reads, so the sync itself cannot overlap with the
+   GUI thread.
+
+   ---
+
+   With QSG_SHARED_RENDER_THREAD=1, all windows are rendered by a single
+   render thread with a single OpenGL context and render context, so
+   textures, atlases and glyph caches are shared between them. The GUI
+   thread syncs all windows which are waiting for a frame together, and
+   the render thread then renders and swaps them back to back. The
+   shared thread is never deleted, as every window holds on to its
+   render context.
+
  */
 
 QT_BEGIN_NAMESPACE
@@ -164,6 +185,10 @@ const QEvent::Type WM_TryRelease        = QEvent::Type(QEvent::User + 4);
 // called.
 const QEvent::Type WM_Grab              = QEvent::Type(QEvent::User + 5);
 
+// Passed by the RT to the RL when it finished a frame while the GUI
+// thread deferred a sync to it, in pipelined mode.
+const QEvent::Type WM_ReadyForSync      = QEvent::Type(QEvent::User + 6);
+
 template <typename T> T *windowFor(const QList<T> list, QQuickWindow *window)
 {
     for (int i=0; i<list.size(); ++i) {
@@ -234,6 +259,14 @@ public:
         mutex.unlock();
     }
 
+    void addEvents(const QList<QEvent *> &events) {
+        mutex.lock();
+        append(events);
+        if (waiting)
+            condition.wakeOne();
+        mutex.unlock();
+    }
+
     QEvent *takeEvent(bool wait) {
         mutex.lock();
         if (size() == 0 && wait) {
@@ -269,12 +302,12 @@ public:
         , gl(0)
         , sgrc(renderContext)
         , animatorDriver(0)
-        , pendingUpdate(0)
         , sleeping(false)
         , syncResultedInChanges(false)
         , active(false)
-        , window(0)
         , stopEventProcessing(false)
+        , rendering(0)
+        , syncWanted(0)
     {
 #if defined(Q_OS_QNX) && !defined(Q_OS_BLACKBERRY) && defined(Q_PROCESSOR_X86)
         // The SDP 6.6.0 x86 MESA driver requires a larger stack than the default.
@@ -296,18 +329,20 @@ public:
 
     void syncAndRender();
     void sync(bool inExpose);
+    void frameDone();
 
-    void requestRepaint()
+    void requestRepaint(QQuickWindow *window)
     {
         if (sleeping)
             stopEventProcessing = true;
-        if (window)
-            pendingUpdate |= RepaintRequest;
+        if (WindowData *wd = windowData(window))
+            wd->pendingUpdate |= RepaintRequest;
     }
 
     void processEventsAndWaitForMore();
     void processEvents();
     void postEvent(QEvent *e);
+    void postEvents(const QList<QEvent *> &events);
 
 public slots:
     void sceneGraphChanged() {
@@ -322,13 +357,40 @@ public:
         ExposeRequest       = 0x04 | RepaintRequest | SyncRequest
     };
 
+    // The exposed windows rendered by this thread. There is one, unless
+    // the thread is shared by all windows.
+    struct WindowData {
+        QQuickWindow *window;
+        QSize size;
+        uint pendingUpdate;
+        uint request; // pendingUpdate taken for the current frame
+        bool render;
+    };
+
+    WindowData *windowData(QQuickWindow *window)
+    {
+        for (int i = 0; i < windows.size(); ++i) {
+            if (windows.at(i).window == window)
+                return &windows[i];
+        }
+        return 0;
+    }
+
+    bool hasPendingUpdate() const
+    {
+        for (int i = 0; i < windows.size(); ++i) {
+            if (windows.at(i).pendingUpdate)
+                return true;
+        }
+        return false;
+    }
+
     QSGThreadedRenderLoop *wm;
     QOpenGLContext *gl;
     QSGRenderContext *sgrc;
 
     QAnimationDriver *animatorDriver;
 
-    uint pendingUpdate;
     bool sleeping;
     bool syncResultedInChanges;
 
@@ -341,12 +403,16 @@ public:
 
     QElapsedTimer m_timer;
 
-    QQuickWindow *window; // Will be 0 when window is not exposed
-    QSize windowSize;
+    QList<WindowData> windows; // Empty when no window is exposed
 
     // Local event queue stuff...
     bool stopEventProcessing;
     QSGRenderThreadEventQueue eventQueue;
+
+    // Pipelined sync: set while a frame is being rendered, and by the GUI
+    // thread when it deferred a sync until the frame is done.
+    QAtomicInt rendering;
+    QAtomicInt syncWanted;
 };
 
 bool QSGRenderThread::event(QEvent *e)
@@ -356,13 +422,16 @@ bool QSGRenderThread::event(QEvent *e)
     case WM_Obscure: {
         qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "WM_Obscure";
 
-        Q_ASSERT(!window || window == static_cast<WMWindowEvent *>(e)->window);
+        QQuickWindow *window = static_cast<WMWindowEvent *>(e)->window;
 
         mutex.lock();
-        if (window) {
-            qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- window removed";
-            gl->doneCurrent();
-            window = 0;
+        for (int i = 0; i < windows.size(); ++i) {
+            if (windows.at(i).window == window) {
+                qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- window removed";
+                gl->doneCurrent();
+                windows.removeAt(i);
+                break;
+            }
         }
         waitCondition.wakeOne();
         mutex.unlock();
@@ -374,17 +443,22 @@ bool QSGRenderThread::event(QEvent *e)
         WMSyncEvent *se = static_cast<WMSyncEvent *>(e);
         if (sleeping)
             stopEventProcessing = true;
-        window = se->window;
-        windowSize = se->size;
+        WindowData *wd = windowData(se->window);
+        if (!wd) {
+            WindowData data = { se->window, QSize(), 0, 0, false };
+            windows << data;
+            wd = &windows.last();
+        }
+        wd->size = se->size;
 
-        pendingUpdate |= SyncRequest;
+        wd->pendingUpdate |= SyncRequest;
         if (se->syncInExpose) {
             qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- triggered from expose";
-            pendingUpdate |= ExposeRequest;
+            wd->pendingUpdate |= ExposeRequest;
         }
         if (se->forceRenderPass) {
             qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- repaint regardless";
-            pendingUpdate |= RepaintRequest;
+            wd->pendingUpdate |= RepaintRequest;
         }
         return true; }
 
@@ -393,11 +467,11 @@ bool QSGRenderThread::event(QEvent *e)
         mutex.lock();
         wm->m_lockedForSync = true;
         WMTryReleaseEvent *wme = static_cast<WMTryReleaseEvent *>(e);
-        if (!window || wme->inDestructor) {
+        if (!windowData(wme->window) || wme->inDestructor) {
             qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- setting exit flag and invalidating OpenGL";
             invalidateOpenGL(wme->window, wme->inDestructor, wme->fallbackSurface);
             active = gl;
-            Q_ASSERT_X(!wme->inDestructor || !active, "QSGRenderThread::invalidateOpenGL()", "Thread's active state is not set to false when shutting down");
+            Q_ASSERT_X(!wme->inDestructor || !active || !windows.isEmpty(), "QSGRenderThread::invalidateOpenGL()", "Thread's active state is not set to false when shutting down");
             if (sleeping)
                 stopEventProcessing = true;
         } else {
@@ -412,9 +486,12 @@ bool QSGRenderThread::event(QEvent *e)
     case WM_Grab: {
         qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "WM_Grab";
         WMGrabEvent *ce = static_cast<WMGrabEvent *>(e);
-        Q_ASSERT(ce->window == window);
+        QQuickWindow *window = ce->window;
+        WindowData *wd = windowData(window);
+        Q_ASSERT(wd);
         mutex.lock();
-        if (window) {
+        if (wd) {
+            QSize windowSize = wd->size;
             gl->makeCurrent(window);
 
             qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- sync scene graph";
@@ -437,7 +514,8 @@ bool QSGRenderThread::event(QEvent *e)
         qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "WM_RequestPaint";
         // When GUI posts this event, it is followed by a polishAndSync, so we mustn't
         // exit the event loop yet.
-        pendingUpdate |= RepaintRequest;
+        for (int i = 0; i < windows.size(); ++i)
+            windows[i].pendingUpdate |= RepaintRequest;
         break;
 
     default:
@@ -478,6 +556,16 @@ void QSGRenderThread::invalidateOpenGL(QQuickWindow *window, bool inDestructor,
         return;
     }
 
+    // A shared render thread keeps the context, and the atlases and glyph
+    // caches in it, for as long as it still renders other windows.
+    if (!windows.isEmpty()) {
+        qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- other windows still exposed, keeping OpenGL";
+        QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+        if (current)
+            gl->doneCurrent();
+        return;
+    }
+
     sgrc->invalidate();
     QCoreApplication::processEvents();
     QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
@@ -505,30 +593,42 @@ void QSGRenderThread::sync(bool inExpose)
 
     Q_ASSERT_X(wm->m_lockedForSync, "QSGRenderThread::sync()", "sync triggered on bad terms as gui is not already locked...");
 
-    bool current = false;
-    if (windowSize.width() > 0 && windowSize.height() > 0)
-        current = gl->makeCurrent(window);
-    if (current) {
-        QQuickWindowPrivate *d = QQuickWindowPrivate::get(window);
-        bool hadRenderer = d->renderer != 0;
-        // If the scene graph was touched since the last sync() make sure it sends the
-        // changed signal.
-        if (d->renderer)
-            d->renderer->clearChangedFlag();
-        d->syncSceneGraph();
-        if (!hadRenderer && d->renderer) {
-            qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- renderer was created";
-            syncResultedInChanges = true;
-            connect(d->renderer, SIGNAL(sceneGraphChanged()), this, SLOT(sceneGraphChanged()), Qt::DirectConnection);
+    bool synced = false;
+    for (int i = 0; i < windows.size(); ++i) {
+        WindowData &wd = windows[i];
+        if (!(wd.request & SyncRequest))
+            continue;
+
+        bool current = false;
+        if (wd.size.width() > 0 && wd.size.height() > 0)
+            current = gl->makeCurrent(wd.window);
+        if (current) {
+            QQuickWindowPrivate *d = QQuickWindowPrivate::get(wd.window);
+            bool hadRenderer = d->renderer != 0;
+            // If the scene graph was touched since the last sync() make sure it sends the
+            // changed signal.
+            if (d->renderer)
+                d->renderer->clearChangedFlag();
+            syncResultedInChanges = false;
+            d->syncSceneGraph();
+            if (!hadRenderer && d->renderer) {
+                qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- renderer was created";
+                syncResultedInChanges = true;
+                connect(d->renderer, SIGNAL(sceneGraphChanged()), this, SLOT(sceneGraphChanged()), Qt::DirectConnection);
+            }
+            if (syncResultedInChanges)
+                wd.render = true;
+            synced = true;
+        } else {
+            qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- window has bad size, sync aborted";
         }
+    }
 
-        // Process deferred deletes now, directly after the sync as
-        // deleteLater on the GUI must now also have resulted in SG changes
-        // and the delete is a safe operation.
+    // Process deferred deletes now, directly after the sync as
+    // deleteLater on the GUI must now also have resulted in SG changes
+    // and the delete is a safe operation.
+    if (synced)
         QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
-    } else {
-        qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- window has bad size, sync aborted";
-    }
 
     if (!inExpose) {
         qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- sync complete, waking Gui";
@@ -550,24 +650,34 @@ void QSGRenderThread::syncAndRender()
 
     qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "syncAndRender()";
 
-    syncResultedInChanges = false;
-    QQuickWindowPrivate *d = QQuickWindowPrivate::get(window);
-
-    bool repaintRequested = (pendingUpdate & RepaintRequest) || d->customRenderStage;
-    bool syncRequested = pendingUpdate & SyncRequest;
-    bool exposeRequested = (pendingUpdate & ExposeRequest) == ExposeRequest;
-    pendingUpdate = 0;
+    rendering.fetchAndStoreOrdered(1);
+
+    bool syncRequested = false;
+    bool exposeRequested = false;
+    for (int i = 0; i < windows.size(); ++i) {
+        WindowData &wd = windows[i];
+        wd.request = wd.pendingUpdate;
+        wd.pendingUpdate = 0;
+        wd.render = (wd.request & RepaintRequest) || QQuickWindowPrivate::get(wd.window)->customRenderStage;
+        syncRequested |= bool(wd.request & SyncRequest);
+        exposeRequested |= (wd.request & ExposeRequest) == ExposeRequest;
+    }
 
     if (syncRequested) {
         qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- updatePending, doing sync";
         sync(exposeRequested);
     }
 
-    if (!syncResultedInChanges && !repaintRequested) {
+    bool renderRequested = false;
+    for (int i = 0; i < windows.size(); ++i)
+        renderRequested |= windows.at(i).render;
+
+    if (!renderRequested) {
         qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- no changes, render aborted";
         int waitTime = vsyncDelta - (int) waitTimer.elapsed();
         if (waitTime > 0)
             msleep(waitTime);
+        frameDone();
         return;
     }
 
@@ -577,31 +687,44 @@ void QSGRenderThread::syncAndRender()
     qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- rendering started";
 
 
+    // All windows of a shared render thread are advanced in one step, so
+    // render thread animators stay in step across them.
     if (animatorDriver->isRunning()) {
-        d->animationController->lock();
+        for (int i = 0; i < windows.size(); ++i)
+            QQuickWindowPrivate::get(windows.at(i).window)->animationController->lock();
         animatorDriver->advance();
-        d->animationController->unlock();
+        for (int i = windows.size() - 1; i >= 0; --i)
+            QQuickWindowPrivate::get(windows.at(i).window)->animationController->unlock();
     }
 
-    bool current = false;
-    if (d->renderer && windowSize.width() > 0 && windowSize.height() > 0)
-        current = gl->makeCurrent(window);
-    if (current) {
-        {
-            QSystraceEvent systrace("graphics", "QSGRT::renderSceneGraph");
-            d->renderSceneGraph(windowSize);
-        }
-        if (profileFrames)
-            renderTime = threadTimer.nsecsElapsed();
-
-        {
-            QSystraceEvent systrace("graphics", "QSGRT::swapBuffers");
-            if (!d->customRenderStage || !d->customRenderStage->swap())
-                gl->swapBuffers(window);
-            d->fireFrameSwapped();
+    // The windows are rendered and swapped back to back, so that with a
+    // shared render thread they all present in the same vsync interval.
+    for (int i = 0; i < windows.size(); ++i) {
+        const WindowData &wd = windows.at(i);
+        if (!wd.render)
+            continue;
+        QQuickWindowPrivate *d = QQuickWindowPrivate::get(wd.window);
+
+        bool current = false;
+        if (d->renderer && wd.size.width() > 0 && wd.size.height() > 0)
+            current = gl->makeCurrent(wd.window);
+        if (current) {
+            {
+                QSystraceEvent systrace("graphics", "QSGRT::renderSceneGraph");
+                d->renderSceneGraph(wd.size);
+            }
+            if (profileFrames)
+                renderTime = threadTimer.nsecsElapsed();
+
+            {
+                QSystraceEvent systrace("graphics", "QSGRT::swapBuffers");
+                if (!d->customRenderStage || !d->customRenderStage->swap())
+                    gl->swapBuffers(wd.window);
+                d->fireFrameSwapped();
+            }
+        } else {
+            qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- window not ready, skipping render";
         }
-    } else {
-        qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- window not ready, skipping render";
     }
 
     qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- rendering done";
@@ -629,6 +752,24 @@ void QSGRenderThread::syncAndRender()
                 syncTime,
                 renderTime - syncTime,
                 threadTimer.nsecsElapsed() - renderTime));
+
+    frameDone();
+}
+
+/*
+    Marks the end of a frame and tells the GUI thread if it deferred a sync
+    to it.
+ */
+void QSGRenderThread::frameDone()
+{
+    rendering.fetchAndStoreOrdered(0);
+    if (syncWanted.fetchAndStoreOrdered(0)) {
+        qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "- waking Gui for deferred sync";
+        // A shared render thread has just rendered all its windows, and the
+        // GUI thread picks up every window it deferred.
+        QQuickWindow *window = wm->m_shared_thread || windows.isEmpty() ? 0 : windows.first().window;
+        QCoreApplication::postEvent(wm, new WMWindowEvent(window, WM_ReadyForSync));
+    }
 }
 
 
@@ -638,6 +779,15 @@ void QSGRenderThread::postEvent(QEvent *e)
     eventQueue.addEvent(e);
 }
 
+/*
+    Posts the events in one go, so that the render thread handles all of
+    them before its next frame.
+ */
+void QSGRenderThread::postEvents(const QList<QEvent *> &events)
+{
+    eventQueue.addEvents(events);
+}
+
 
 
 void QSGRenderThread::processEvents()
@@ -660,6 +810,12 @@ void QSGRenderThread::processEventsAndWaitForMore()
         event(e);
         delete e;
     }
+    // Events posted together with the one that woke us belong to the same frame.
+    while (eventQueue.hasMoreEvents()) {
+        QEvent *e = eventQueue.takeEvent(false);
+        event(e);
+        delete e;
+    }
     qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "--- done processEventsAndWaitForMore()";
 }
 
@@ -673,16 +829,19 @@ void QSGRenderThread::run()
 
     while (active) {
 
-        if (window) {
-            if (!sgrc->openglContext() && windowSize.width() > 0 && windowSize.height() > 0 && gl->makeCurrent(window))
-                sgrc->initialize(gl);
+        if (!windows.isEmpty()) {
+            for (int i = 0; !sgrc->openglContext() && i < windows.size(); ++i) {
+                const WindowData &wd = windows.at(i);
+                if (wd.size.width() > 0 && wd.size.height() > 0 && gl->makeCurrent(wd.window))
+                    sgrc->initialize(gl);
+            }
             syncAndRender();
         }
 
         processEvents();
         QCoreApplication::processEvents();
 
-        if (active && (pendingUpdate == 0 || !window)) {
+        if (active && !hasPendingUpdate()) {
             qCDebug(QSG_LOG_RENDERLOOP) << QSG_RT_PAD << "done drawing, sleep...";
             sleeping = true;
             processEventsAndWaitForMore();
@@ -704,6 +863,8 @@ void QSGRenderThread::run()
 QSGThreadedRenderLoop::QSGThreadedRenderLoop()
     : sg(QSGContext::createDefaultContext())
     , m_animation_timer(0)
+    , m_render_thread(0)
+    , m_shared_rc(0)
 {
 #if defined(QSG_RENDER_LOOP_DEBUG)
     qsgrl_timer.start();
@@ -712,6 +873,8 @@ QSGThreadedRenderLoop::QSGThreadedRenderLoop()
     m_animation_driver = sg->createAnimationDriver(this);
 
     m_exhaust_delay = get_env_int("QML_EXHAUST_DELAY", 5);
+    m_pipelined_sync = get_env_int("QSG_PIPELINED_SYNC", 0) != 0;
+    m_shared_thread = get_env_int("QSG_SHARED_RENDER_THREAD", 0) != 0;
 
     connect(m_animation_driver, SIGNAL(started()), this, SLOT(animationStarted()));
     connect(m_animation_driver, SIGNAL(stopped()), this, SLOT(animationStopped()));
@@ -721,6 +884,13 @@ QSGThreadedRenderLoop::QSGThreadedRenderLoop()
 
 QSGRenderContext *QSGThreadedRenderLoop::createRenderContext(QSGContext *sg) const
 {
+    // The shared render thread owns the one render context, which lives as
+    // long as the render loop does, since every window keeps a pointer to it.
+    if (m_shared_thread) {
+        if (!m_shared_rc)
+            m_shared_rc = sg->createRenderContext();
+        return m_shared_rc;
+    }
     return sg->createRenderContext();
 }
 
@@ -835,11 +1005,15 @@ void QSGThreadedRenderLoop::windowDestroyed(QQuickWindow *window)
     handleObscurity(w);
     releaseResources(w, true);
 
+    // The shared render thread keeps running for the other windows and is
+    // never deleted, as it owns the render context of all windows.
     QSGRenderThread *thread = w->thread;
-    while (thread->isRunning())
-        QThread::yieldCurrentThread();
-    Q_ASSERT(thread->thread() == QThread::currentThread());
-    delete thread;
+    if (thread != m_render_thread) {
+        while (thread->isRunning())
+            QThread::yieldCurrentThread();
+        Q_ASSERT(thread->thread() == QThread::currentThread());
+        delete thread;
+    }
 
     for (int i=0; i<m_windows.size(); ++i) {
         if (m_windows.at(i).window == window) {
@@ -878,17 +1052,25 @@ void QSGThreadedRenderLoop::handleExposure(QQuickWindow *window)
         Window win;
         win.window = window;
         win.actualWindowFormat = window->format();
-        win.thread = new QSGRenderThread(this, QQuickWindowPrivate::get(window)->context);
+        if (m_shared_thread) {
+            if (!m_render_thread)
+                m_render_thread = new QSGRenderThread(this, QQuickWindowPrivate::get(window)->context);
+            win.thread = m_render_thread;
+        } else {
+            win.thread = new QSGRenderThread(this, QQuickWindowPrivate::get(window)->context);
+        }
         win.timerId = 0;
         win.updateDuringSync = false;
         win.forceRenderPass = true; // also covered by polishAndSync(inExpose=true), but doesn't hurt
+        win.syncDeferred = false;
+        win.exposed = false;
         m_windows << win;
         w = &m_windows.last();
     }
 
     // set this early as we'll be rendering shortly anyway and this avoids
     // specialcasing exposure in polishAndSync.
-    w->thread->window = window;
+    w->exposed = true;
 
     if (w->window->width() <= 0 || w->window->height() <= 0
             || !w->window->geometry().intersects(w->window->screen()->availableGeometry())) {
@@ -902,6 +1084,12 @@ void QSGThreadedRenderLoop::handleExposure(QQuickWindow *window)
     if (!w->window->handle())
         w->window->create();
 
+    // A shared render thread may already be running for other windows, so
+    // this is done regardless.
+    QQuickAnimatorController *controller = QQuickWindowPrivate::get(w->window)->animationController;
+    if (controller->thread() != w->thread)
+        controller->moveToThread(w->thread);
+
     // Start render thread if it is not running
     if (!w->thread->isRunning()) {
 
@@ -923,10 +1111,6 @@ void QSGThreadedRenderLoop::handleExposure(QQuickWindow *window)
             qCDebug(QSG_LOG_RENDERLOOP) << "- OpenGL context created";
         }
 
-        QQuickAnimatorController *controller = QQuickWindowPrivate::get(w->window)->animationController;
-        if (controller->thread() != w->thread)
-            controller->moveToThread(w->thread);
-
         w->thread->active = true;
         if (w->thread->thread() == QThread::currentThread()) {
             w->thread->sgrc->moveToThread(w->thread);
@@ -959,6 +1143,7 @@ void QSGThreadedRenderLoop::handleObscurity(Window *w)
         w->thread->postEvent(new WMWindowEvent(w->window, WM_Obscure));
         w->thread->waitCondition.wait(&w->thread->mutex);
         w->thread->mutex.unlock();
+        w->exposed = false;
     }
     startOrStopAnimationTimer();
 }
@@ -1015,7 +1200,7 @@ void QSGThreadedRenderLoop::update(QQuickWindow *window)
 
     if (w->thread == QThread::currentThread()) {
         qCDebug(QSG_LOG_RENDERLOOP) << "update on window - on render thread" << w->window;
-        w->thread->requestRepaint();
+        w->thread->requestRepaint(w->window);
         return;
     }
 
@@ -1089,23 +1274,63 @@ void QSGThreadedRenderLoop::polishAndSync(Window *w, bool inExpose)
     qCDebug(QSG_LOG_RENDERLOOP) << "polishAndSync" << (inExpose ? "(in expose)" : "(normal)") << w->window;
 
     QQuickWindow *window = w->window;
-    if (!w->thread || !w->thread->window) {
+    if (!w->thread || !w->exposed) {
         qCDebug(QSG_LOG_RENDERLOOP) << "- not exposed, abort";
         killTimer(w->timerId);
         w->timerId = 0;
         return;
     }
 
+    // A shared render thread syncs every window that is waiting for a frame
+    // in one go, so that it renders and swaps them back to back.
+    QList<QQuickWindow *> windows;
+    windows << window;
+    if (m_shared_thread && !inExpose) {
+        for (int i = 0; i < m_windows.size(); ++i) {
+            const Window &other = m_windows.at(i);
+            if (other.window != window && other.exposed && (other.timerId || other.syncDeferred))
+                windows << other.window;
+        }
+    }
+
     // Flush pending touch events.
-    QQuickWindowPrivate::get(window)->flushDelayedTouchEvent();
+    for (int i = 0; i < windows.size(); ++i) {
+        Window *other = windowFor(m_windows, windows.at(i));
+        if (other && other->exposed)
+            QQuickWindowPrivate::get(other->window)->flushDelayedTouchEvent();
+    }
     // The delivery of the event might have caused the window to stop rendering
     w = windowFor(m_windows, window);
-    if (!w || !w->thread || !w->thread->window) {
+    if (!w || !w->thread || !w->exposed) {
         qCDebug(QSG_LOG_RENDERLOOP) << "- removed after event flushing, abort";
         killTimer(w->timerId);
         w->timerId = 0;
         return;
     }
+    QList<Window *> batch;
+    for (int i = 0; i < windows.size(); ++i) {
+        Window *other = windowFor(m_windows, windows.at(i));
+        if (other && other->exposed)
+            batch << other;
+    }
+
+    // Don't wait for the render thread to finish its frame, it posts
+    // WM_ReadyForSync when it can sync right away.
+    if (m_pipelined_sync && !inExpose) {
+        w->thread->syncWanted.fetchAndStoreOrdered(1);
+        if (w->thread->rendering.loadAcquire()) {
+            qCDebug(QSG_LOG_RENDERLOOP) << "- render thread busy, sync deferred";
+            for (int i = 0; i < batch.size(); ++i) {
+                killTimer(batch.at(i)->timerId);
+                batch.at(i)->timerId = 0;
+                batch.at(i)->syncDeferred = true;
+            }
+            return;
+        }
+        w->thread->syncWanted.fetchAndStoreOrdered(0);
+    }
+    for (int i = 0; i < batch.size(); ++i)
+        batch.at(i)->syncDeferred = false;
 
 
     QElapsedTimer timer;
@@ -1113,22 +1338,27 @@ void QSGThreadedRenderLoop::polishAndSync(Window *w, bool inExpose)
     qint64 waitTime = 0;
     qint64 syncTime = 0;
     bool profileFrames = QSG_LOG_TIME_RENDERLOOP().isDebugEnabled()  || QQuickProfiler::enabled;
-    if (profileFrames)
-        timer.start();
+    timer.start();
 
     QQuickWindowPrivate *d = QQuickWindowPrivate::get(window);
-    d->polishItems();
+    for (int i = 0; i < batch.size(); ++i)
+        QQuickWindowPrivate::get(batch.at(i)->window)->polishItems();
 
     if (profileFrames)
         polishTime = timer.nsecsElapsed();
 
-    w->updateDuringSync = false;
+    QList<QEvent *> syncEvents;
+    for (int i = 0; i < batch.size(); ++i) {
+        Window *other = batch.at(i);
+        other->updateDuringSync = false;
+        syncEvents << new WMSyncEvent(other->window, inExpose, other->forceRenderPass);
+        other->forceRenderPass = false;
+    }
 
     qCDebug(QSG_LOG_RENDERLOOP) << "- lock for sync";
     w->thread->mutex.lock();
     m_lockedForSync = true;
-    w->thread->postEvent(new WMSyncEvent(window, inExpose, w->forceRenderPass));
-    w->forceRenderPass = false;
+    w->thread->postEvents(syncEvents);
 
     qCDebug(QSG_LOG_RENDERLOOP) << "- wait for sync";
     if (profileFrames)
@@ -1141,18 +1371,25 @@ void QSGThreadedRenderLoop::polishAndSync(Window *w, bool inExpose)
     if (profileFrames)
         syncTime = timer.nsecsElapsed();
 
-    killTimer(w->timerId);
-    w->timerId = 0;
+    for (int i = 0; i < batch.size(); ++i) {
+        killTimer(batch.at(i)->timerId);
+        batch.at(i)->timerId = 0;
+    }
 
     if (m_animation_timer == 0 && m_animation_driver->isRunning()) {
         qCDebug(QSG_LOG_RENDERLOOP) << "- advancing animations";
+        qint64 animationStart = timer.nsecsElapsed();
         m_animation_driver->advance();
+        d->frameStatistics.addTime(QQuickFrameStatistics::Animations, timer.nsecsElapsed() - animationStart);
         qCDebug(QSG_LOG_RENDERLOOP) << "- animations done..";
         // We need to trigger another sync to keep animations running...
         maybePostPolishRequest(w);
+        m_lastFrameTime = int(timer.elapsed());
         emit timeToIncubate();
-    } else if (w->updateDuringSync) {
-        maybePostPolishRequest(w);
+    }
+    for (int i = 0; i < batch.size(); ++i) {
+        if (batch.at(i)->updateDuringSync)
+            maybePostPolishRequest(batch.at(i));
     }
 
     qCDebug(QSG_LOG_TIME_RENDERLOOP()).nospace()
@@ -1189,7 +1426,10 @@ bool QSGThreadedRenderLoop::event(QEvent *e)
         QTimerEvent *te = static_cast<QTimerEvent *>(e);
         if (te->timerId() == m_animation_timer) {
             qCDebug(QSG_LOG_RENDERLOOP) << "- ticking non-visual timer";
+            QElapsedTimer timer;
+            timer.start();
             m_animation_driver->advance();
+            m_lastFrameTime = int(timer.elapsed());
             emit timeToIncubate();
         } else {
             qCDebug(QSG_LOG_RENDERLOOP) << "- polish and sync timer";
@@ -1202,6 +1442,25 @@ bool QSGThreadedRenderLoop::event(QEvent *e)
         return true;
     }
 
+    case WM_ReadyForSync: {
+        qCDebug(QSG_LOG_RENDERLOOP) << "- render thread ready for deferred sync";
+        QQuickWindow *window = static_cast<WMWindowEvent *>(e)->window;
+        if (!window) {
+            // Sent by a shared render thread, whose polishAndSync() picks
+            // up the other deferred windows as well.
+            for (int i = 0; i < m_windows.size(); ++i) {
+                if (m_windows.at(i).syncDeferred) {
+                    window = m_windows.at(i).window;
+                    break;
+                }
+            }
+        }
+        Window *w = windowFor(m_windows, window);
+        if (w && w->syncDeferred)
+            polishAndSync(w);
+        return true;
+    }
+
     default:
         break;
     }
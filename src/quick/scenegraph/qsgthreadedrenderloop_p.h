@@ -91,6 +91,8 @@ private:
         int timerId;
         uint updateDuringSync : 1;
         uint forceRenderPass : 1;
+        uint syncDeferred : 1;
+        uint exposed : 1;
     };
 
     friend class QSGRenderThread;
@@ -118,6 +120,12 @@ private:
 
     int m_animation_timer;
     int m_exhaust_delay;
+    bool m_pipelined_sync;
+    bool m_shared_thread;
+
+    // Used by all windows when m_shared_thread is set
+    QSGRenderThread *m_render_thread;
+    mutable QSGRenderContext *m_shared_rc;
 
     bool m_lockedForSync;
 };
@@ -352,6 +352,8 @@ bool QSGWindowsRenderLoop::event(QEvent *event)
 void QSGWindowsRenderLoop::render()
 {
     RLDEBUG("render");
+    QElapsedTimer frameTimer;
+    frameTimer.start();
     foreach (const WindowData &wd, m_windows) {
         if (wd.pendingUpdate) {
             const_cast<WindowData &>(wd).pendingUpdate = false;
@@ -362,9 +364,14 @@ void QSGWindowsRenderLoop::render()
     if (m_animationDriver->isRunning()) {
         RLDEBUG("advancing animations");
         QSG_RENDER_TIMING_SAMPLE(time_start);
+        const qint64 animationStart = frameTimer.nsecsElapsed();
         m_animationDriver->advance();
         RLDEBUG("animations advanced");
 
+        const qint64 animationTime = frameTimer.nsecsElapsed() - animationStart;
+        foreach (const WindowData &wd, m_windows)
+            QQuickWindowPrivate::get(wd.window)->frameStatistics.addTime(QQuickFrameStatistics::Animations, animationTime);
+
         qCDebug(QSG_LOG_TIME_RENDERLOOP,
                 "animations ticked in %dms",
                 int((qsg_render_timer.nsecsElapsed() - time_start)/1000000));
@@ -377,6 +384,7 @@ void QSGWindowsRenderLoop::render()
         // make sure there is another frame pending.
         maybePostUpdateTimer();
 
+        m_lastFrameTime = int(frameTimer.elapsed());
         emit timeToIncubate();
     }
 }
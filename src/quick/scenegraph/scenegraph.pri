@@ -28,8 +28,10 @@ SOURCES += \
 # Util API
 HEADERS += \
     $$PWD/util/qsgareaallocator_p.h \
+    $$PWD/util/qsgblockpool_p.h \
     $$PWD/util/qsgatlastexture_p.h \
     $$PWD/util/qsgdepthstencilbuffer_p.h \
+    $$PWD/util/qsgdamagetracker_p.h \
     $$PWD/util/qsgflatcolormaterial.h \
     $$PWD/util/qsgsimplematerial.h \
     $$PWD/util/qsgsimplerectnode.h \
@@ -42,12 +44,16 @@ HEADERS += \
     $$PWD/util/qsgtextureprovider.h \
     $$PWD/util/qsgpainternode_p.h \
     $$PWD/util/qsgdistancefieldutil_p.h \
+    $$PWD/util/qsgdistancefielddiskcache_p.h \
+    $$PWD/util/qsgdistancefieldgenerator_p.h \
     $$PWD/util/qsgshadersourcebuilder_p.h
 
 SOURCES += \
     $$PWD/util/qsgareaallocator.cpp \
+    $$PWD/util/qsgblockpool.cpp \
     $$PWD/util/qsgatlastexture.cpp \
     $$PWD/util/qsgdepthstencilbuffer.cpp \
+    $$PWD/util/qsgdamagetracker.cpp \
     $$PWD/util/qsgflatcolormaterial.cpp \
     $$PWD/util/qsgsimplerectnode.cpp \
     $$PWD/util/qsgsimpletexturenode.cpp \
@@ -57,6 +63,8 @@ SOURCES += \
     $$PWD/util/qsgtextureprovider.cpp \
     $$PWD/util/qsgpainternode.cpp \
     $$PWD/util/qsgdistancefieldutil.cpp \
+    $$PWD/util/qsgdistancefielddiskcache.cpp \
+    $$PWD/util/qsgdistancefieldgenerator.cpp \
     $$PWD/util/qsgsimplematerial.cpp \
     $$PWD/util/qsgshadersourcebuilder.cpp
 
@@ -104,6 +112,8 @@ OTHER_FILES += \
     $$PWD/shaders/distancefieldshiftedtext.vert \
     $$PWD/shaders/distancefieldtext.frag \
     $$PWD/shaders/distancefieldtext.vert \
+    $$PWD/shaders/distancefieldvertexcolortext.frag \
+    $$PWD/shaders/distancefieldvertexcolortext.vert \
     $$PWD/shaders/flatcolor.frag \
     $$PWD/shaders/flatcolor.vert \
     $$PWD/shaders/hiqsubpixeldistancefieldtext.frag \
@@ -136,6 +146,8 @@ OTHER_FILES += \
     $$PWD/shaders/distancefieldshiftedtext_core.vert \
     $$PWD/shaders/distancefieldtext_core.frag \
     $$PWD/shaders/distancefieldtext_core.vert \
+    $$PWD/shaders/distancefieldvertexcolortext_core.frag \
+    $$PWD/shaders/distancefieldvertexcolortext_core.vert \
     $$PWD/shaders/flatcolor_core.frag \
     $$PWD/shaders/flatcolor_core.vert \
     $$PWD/shaders/hiqsubpixeldistancefieldtext_core.frag \
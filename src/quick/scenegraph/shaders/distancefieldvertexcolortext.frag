@@ -0,0 +1,13 @@
+varying highp vec2 sampleCoord;
+varying lowp vec4 color;
+
+uniform mediump sampler2D _qt_texture;
+uniform mediump float alphaMin;
+uniform mediump float alphaMax;
+
+void main()
+{
+    gl_FragColor = color * smoothstep(alphaMin,
+                                      alphaMax,
+                                      texture2D(_qt_texture, sampleCoord).a);
+}
\ No newline at end of file
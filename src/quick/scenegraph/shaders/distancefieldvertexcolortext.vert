@@ -0,0 +1,17 @@
+uniform highp mat4 matrix;
+uniform highp vec2 textureScale;
+uniform lowp float opacity;
+
+attribute highp vec4 vCoord;
+attribute highp vec2 tCoord;
+attribute lowp vec4 vColor;
+
+varying highp vec2 sampleCoord;
+varying lowp vec4 color;
+
+void main()
+{
+     sampleCoord = tCoord * textureScale;
+     color = vColor * opacity;
+     gl_Position = matrix * vCoord;
+}
\ No newline at end of file
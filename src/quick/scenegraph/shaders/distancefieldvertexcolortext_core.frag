@@ -0,0 +1,16 @@
+#version 150 core
+
+in vec2 sampleCoord;
+in vec4 color;
+
+out vec4 fragColor;
+
+uniform sampler2D _qt_texture;
+uniform float alphaMin;
+uniform float alphaMax;
+
+void main()
+{
+    fragColor = color * smoothstep(alphaMin, alphaMax,
+                                   texture(_qt_texture, sampleCoord).r);
+}
\ No newline at end of file
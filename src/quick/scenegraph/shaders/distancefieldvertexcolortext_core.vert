@@ -0,0 +1,19 @@
+#version 150 core
+
+in vec4 vCoord;
+in vec2 tCoord;
+in vec4 vColor;
+
+out vec2 sampleCoord;
+out vec4 color;
+
+uniform mat4 matrix;
+uniform vec2 textureScale;
+uniform float opacity;
+
+void main()
+{
+     sampleCoord = tCoord * textureScale;
+     color = vColor * opacity;
+     gl_Position = matrix * vCoord;
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+uniform highp vec4 rect;
+uniform highp float radius;
+uniform highp float penWidth;
+uniform highp float smoothness;
+uniform lowp vec4 color;
+uniform lowp vec4 borderColor;
+uniform lowp float opacity;
+uniform lowp float useGradient;
+uniform highp float gradientRow;
+uniform sampler2D gradientTexture;
+
+varying highp vec2 coord;
+varying highp float gradientCoord;
+varying highp float pixelWidth;
+
+highp float roundedRectDistance(highp vec2 p, highp vec2 halfSize, highp float r)
+{
+    highp vec2 q = abs(p) - halfSize + r;
+    return min(max(q.x, q.y), 0.0) + length(max(q, 0.0)) - r;
+}
+
+void main()
+{
+    highp vec2 halfSize = 0.5 * rect.zw;
+    highp float width = pixelWidth * smoothness;
+    highp float outer = roundedRectDistance(coord, halfSize, radius);
+    highp float inner = roundedRectDistance(coord, halfSize - penWidth, max(radius - penWidth, 0.0));
+    lowp float coverage = clamp(0.5 - outer / width, 0.0, 1.0);
+    lowp float fillCoverage = penWidth > 0.0 ? clamp(0.5 - inner / width, 0.0, 1.0) : 1.0;
+
+    lowp vec4 fill = color;
+    if (useGradient > 0.5) {
+        highp float t = clamp(gradientCoord, 0.0, 1.0) * (255.0 / 256.0) + 0.5 / 256.0;
+        fill = texture2D(gradientTexture, vec2(t, gradientRow));
+    }
+
+    gl_FragColor = mix(borderColor, fill, fillCoverage) * (coverage * opacity);
+}
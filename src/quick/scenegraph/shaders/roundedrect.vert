@@ -0,0 +1,25 @@
+uniform highp mat4 matrix;
+uniform highp vec2 pixelSize;
+uniform highp vec4 rect;
+
+attribute highp vec4 vertex;
+attribute highp vec2 vertexOffset;
+
+varying highp vec2 coord;
+varying highp float gradientCoord;
+varying highp float pixelWidth;
+
+void main()
+{
+    // Size of a pixel in item coordinates, used to extend the quad
+    // by one pixel for antialiasing and to smooth the edges.
+    highp vec2 scale = vec2(length(matrix[0].xy), length(matrix[1].xy)) / pixelSize;
+    scale = max(scale, vec2(0.0001));
+    highp vec2 pos = vertex.xy + vertexOffset / scale;
+
+    coord = pos - (rect.xy + 0.5 * rect.zw);
+    gradientCoord = (pos.y - rect.y) / rect.w;
+    pixelWidth = 2.0 / (scale.x + scale.y);
+
+    gl_Position = matrix * vec4(pos, vertex.zw);
+}
@@ -0,0 +1,42 @@
+#version 150 core
+
+in vec2 coord;
+in float gradientCoord;
+in float pixelWidth;
+
+out vec4 fragColor;
+
+uniform vec4 rect;
+uniform float radius;
+uniform float penWidth;
+uniform float smoothness;
+uniform vec4 color;
+uniform vec4 borderColor;
+uniform float opacity;
+uniform float useGradient;
+uniform float gradientRow;
+uniform sampler2D gradientTexture;
+
+float roundedRectDistance(vec2 p, vec2 halfSize, float r)
+{
+    vec2 q = abs(p) - halfSize + r;
+    return min(max(q.x, q.y), 0.0) + length(max(q, 0.0)) - r;
+}
+
+void main()
+{
+    vec2 halfSize = 0.5 * rect.zw;
+    float width = pixelWidth * smoothness;
+    float outer = roundedRectDistance(coord, halfSize, radius);
+    float inner = roundedRectDistance(coord, halfSize - penWidth, max(radius - penWidth, 0.0));
+    float coverage = clamp(0.5 - outer / width, 0.0, 1.0);
+    float fillCoverage = penWidth > 0.0 ? clamp(0.5 - inner / width, 0.0, 1.0) : 1.0;
+
+    vec4 fill = color;
+    if (useGradient > 0.5) {
+        float t = clamp(gradientCoord, 0.0, 1.0) * (255.0 / 256.0) + 0.5 / 256.0;
+        fill = texture(gradientTexture, vec2(t, gradientRow));
+    }
+
+    fragColor = mix(borderColor, fill, fillCoverage) * (coverage * opacity);
+}
@@ -0,0 +1,27 @@
+#version 150 core
+
+in vec4 vertex;
+in vec2 vertexOffset;
+
+out vec2 coord;
+out float gradientCoord;
+out float pixelWidth;
+
+uniform mat4 matrix;
+uniform vec2 pixelSize;
+uniform vec4 rect;
+
+void main()
+{
+    // Size of a pixel in item coordinates, used to extend the quad
+    // by one pixel for antialiasing and to smooth the edges.
+    vec2 scale = vec2(length(matrix[0].xy), length(matrix[1].xy)) / pixelSize;
+    scale = max(scale, vec2(0.0001));
+    vec2 pos = vertex.xy + vertexOffset / scale;
+
+    coord = pos - (rect.xy + 0.5 * rect.zw);
+    gradientCoord = (pos.y - rect.y) / rect.w;
+    pixelWidth = 2.0 / (scale.x + scale.y);
+
+    gl_Position = matrix * vec4(pos, vertex.zw);
+}
@@ -44,6 +44,10 @@
 #include <QtCore/qglobal.h>
 #include <QtCore/qrect.h>
 #include <QtCore/qpoint.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qvector.h>
+
+#include <limits.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -93,18 +97,58 @@ bool QSGAreaAllocatorNode::isLeaf()
 }
 
 
-QSGAreaAllocator::QSGAreaAllocator(const QSize &size) : m_size(size)
+/*
+    The guillotine allocator keeps a list of disjoint free rectangles. An
+    allocation goes into the free rectangle it fits best, judged by the
+    shorter of the two leftover sides, and the remainder is cut in two along
+    the shorter leftover axis. Freed rectangles are merged with free
+    neighbours sharing a full edge, which keeps the list short as the atlas
+    churns.
+ */
+struct QSGAreaAllocatorGuillotine
+{
+    QVector<QRect> freeRects;
+    QHash<quint64, QSize> allocations; // keyed by top left corner
+
+    static quint64 key(const QPoint &p) { return (quint64(quint32(p.x())) << 32) | quint32(p.y()); }
+};
+
+QSGAreaAllocator::QSGAreaAllocator(const QSize &size, Strategy strategy)
+    : m_root(0)
+    , m_guillotine(0)
+    , m_size(size)
 {
-    m_root = new QSGAreaAllocatorNode(0);
+    if (strategy == DefaultStrategy) {
+        static const bool useGuillotine = qgetenv("QSG_AREA_ALLOCATOR") == "guillotine";
+        strategy = useGuillotine ? GuillotineStrategy : BinaryTreeStrategy;
+    }
+
+    if (strategy == GuillotineStrategy) {
+        m_guillotine = new QSGAreaAllocatorGuillotine;
+        m_guillotine->freeRects << QRect(QPoint(0, 0), size);
+    } else {
+        m_root = new QSGAreaAllocatorNode(0);
+    }
 }
 
 QSGAreaAllocator::~QSGAreaAllocator()
 {
     delete m_root;
+    delete m_guillotine;
+}
+
+bool QSGAreaAllocator::isEmpty() const
+{
+    if (m_guillotine)
+        return m_guillotine->allocations.isEmpty();
+    return m_root == 0;
 }
 
 QRect QSGAreaAllocator::allocate(const QSize &size)
 {
+    if (m_guillotine)
+        return allocateGuillotine(size);
+
     QPoint point;
     bool result = allocateInNode(size, point, QRect(QPoint(0, 0), m_size), m_root);
     return result ? QRect(point, size) : QRect();
@@ -112,9 +156,99 @@ QRect QSGAreaAllocator::allocate(const QSize &size)
 
 bool QSGAreaAllocator::deallocate(const QRect &rect)
 {
+    if (m_guillotine)
+        return deallocateGuillotine(rect);
+
     return deallocateInNode(rect.topLeft(), m_root);
 }
 
+QRect QSGAreaAllocator::allocateGuillotine(const QSize &size)
+{
+    if (size.width() <= 0 || size.height() <= 0)
+        return QRect();
+
+    QVector<QRect> &freeRects = m_guillotine->freeRects;
+    int best = -1;
+    int bestShortSide = INT_MAX;
+    int bestLongSide = INT_MAX;
+    for (int i = 0; i < freeRects.size(); ++i) {
+        const QRect &r = freeRects.at(i);
+        int dw = r.width() - size.width();
+        int dh = r.height() - size.height();
+        if (dw < 0 || dh < 0)
+            continue;
+        int shortSide = qMin(dw, dh);
+        int longSide = qMax(dw, dh);
+        if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide)) {
+            best = i;
+            bestShortSide = shortSide;
+            bestLongSide = longSide;
+            if (shortSide == 0 && longSide == 0)
+                break;
+        }
+    }
+    if (best < 0)
+        return QRect();
+
+    const QRect r = freeRects.at(best);
+    freeRects.remove(best);
+
+    const QRect result(r.topLeft(), size);
+    const int dw = r.width() - size.width();
+    const int dh = r.height() - size.height();
+    QRect right;
+    QRect bottom;
+    if (dw < dh) {
+        // Horizontal cut, the piece below keeps the full width.
+        right = QRect(r.x() + size.width(), r.y(), dw, size.height());
+        bottom = QRect(r.x(), r.y() + size.height(), r.width(), dh);
+    } else {
+        // Vertical cut, the piece to the right keeps the full height.
+        right = QRect(r.x() + size.width(), r.y(), dw, r.height());
+        bottom = QRect(r.x(), r.y() + size.height(), size.width(), dh);
+    }
+    if (!right.isEmpty())
+        freeRects << right;
+    if (!bottom.isEmpty())
+        freeRects << bottom;
+
+    m_guillotine->allocations.insert(QSGAreaAllocatorGuillotine::key(result.topLeft()), size);
+    return result;
+}
+
+bool QSGAreaAllocator::deallocateGuillotine(const QRect &rect)
+{
+    QHash<quint64, QSize>::iterator it = m_guillotine->allocations.find(QSGAreaAllocatorGuillotine::key(rect.topLeft()));
+    if (it == m_guillotine->allocations.end())
+        return false;
+    QRect freed(rect.topLeft(), it.value());
+    m_guillotine->allocations.erase(it);
+
+    // Merge with free neighbours until no more full edges are shared.
+    QVector<QRect> &freeRects = m_guillotine->freeRects;
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (int i = 0; i < freeRects.size(); ++i) {
+            const QRect &r = freeRects.at(i);
+            if (r.y() == freed.y() && r.height() == freed.height()
+                && (r.x() + r.width() == freed.x() || freed.x() + freed.width() == r.x())) {
+                freed = freed.united(r);
+            } else if (r.x() == freed.x() && r.width() == freed.width()
+                       && (r.y() + r.height() == freed.y() || freed.y() + freed.height() == r.y())) {
+                freed = freed.united(r);
+            } else {
+                continue;
+            }
+            freeRects.remove(i);
+            merged = true;
+            break;
+        }
+    }
+    freeRects << freed;
+    return true;
+}
+
 bool QSGAreaAllocator::allocateInNode(const QSize &size, QPoint &result, const QRect &currentRect, QSGAreaAllocatorNode *node)
 {
     if (size.width() > currentRect.width() || size.height() > currentRect.height())
@@ -50,22 +50,34 @@ QT_BEGIN_NAMESPACE
 class QRect;
 class QPoint;
 struct QSGAreaAllocatorNode;
+struct QSGAreaAllocatorGuillotine;
 class Q_QUICK_PRIVATE_EXPORT QSGAreaAllocator
 {
 public:
-    QSGAreaAllocator(const QSize &size);
+    enum Strategy {
+        DefaultStrategy,
+        BinaryTreeStrategy,
+        GuillotineStrategy
+    };
+
+    QSGAreaAllocator(const QSize &size, Strategy strategy = DefaultStrategy);
     ~QSGAreaAllocator();
 
     QRect allocate(const QSize &size);
     bool deallocate(const QRect &rect);
-    bool isEmpty() const { return m_root == 0; }
+    bool isEmpty() const;
     QSize size() const { return m_size; }
+    Strategy strategy() const { return m_guillotine ? GuillotineStrategy : BinaryTreeStrategy; }
 private:
     bool allocateInNode(const QSize &size, QPoint &result, const QRect &currentRect, QSGAreaAllocatorNode *node);
     bool deallocateInNode(const QPoint &pos, QSGAreaAllocatorNode *node);
     void mergeNodeWithNeighbors(QSGAreaAllocatorNode *node);
 
+    QRect allocateGuillotine(const QSize &size);
+    bool deallocateGuillotine(const QRect &rect);
+
     QSGAreaAllocatorNode *m_root;
+    QSGAreaAllocatorGuillotine *m_guillotine;
     QSize m_size;
 };
 
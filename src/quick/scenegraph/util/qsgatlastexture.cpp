@@ -90,7 +90,6 @@ static int qsg_envInt(const char *name, int defaultValue)
 }
 
 Manager::Manager()
-    : m_atlas(0)
 {
     QOpenGLContext *gl = QOpenGLContext::currentContext();
     Q_ASSERT(gl);
@@ -114,37 +113,91 @@ Manager::Manager()
     m_atlas_size_limit = qsg_envInt("QSG_ATLAS_SIZE_LIMIT", qMax(w, h) / 2);
     m_atlas_size = QSize(w, h);
 
-    qCDebug(QSG_LOG_INFO, "texture atlas dimensions: %dx%d", w, h);
+    // Images which don't fit in the existing pages go into a new page, up to
+    // this many. After that they become standalone textures.
+    m_atlas_page_limit = qMax(1, qsg_envInt("QSG_ATLAS_MAX_PAGES", 4));
+
+    qCDebug(QSG_LOG_INFO, "texture atlas dimensions: %dx%d, max pages: %d", w, h, m_atlas_page_limit);
 }
 
 
 Manager::~Manager()
 {
-    Q_ASSERT(m_atlas == 0);
+    Q_ASSERT(m_atlases.isEmpty());
 }
 
 void Manager::invalidate()
 {
-    if (m_atlas) {
-        m_atlas->invalidate();
-        m_atlas->deleteLater();
-        m_atlas = 0;
+    for (int i = 0; i < m_atlases.size(); ++i) {
+        m_atlases.at(i)->invalidate();
+        m_atlases.at(i)->deleteLater();
+    }
+    m_atlases.clear();
+}
+
+/*!
+    Returns the fraction of the allocated atlas pages which is in use by
+    textures, including their padding.
+ */
+qreal Manager::occupancy() const
+{
+    if (m_atlases.isEmpty())
+        return 0;
+    qint64 used = 0;
+    for (int i = 0; i < m_atlases.size(); ++i)
+        used += m_atlases.at(i)->usedArea();
+    return used / (qreal(m_atlas_size.width()) * m_atlas_size.height() * m_atlases.size());
+}
+
+/*
+    Pages left without textures are released, except for the last one. The
+    holes freed regions leave behind are never compacted, as the texture
+    coordinates of atlas textures are baked into the geometry using them,
+    but a page which drains completely gives its memory back and lets
+    newer images start on a clean page.
+ */
+void Manager::releaseEmptyPages()
+{
+    for (int i = m_atlases.size() - 1; i >= 0 && m_atlases.size() > 1; --i) {
+        Atlas *atlas = m_atlases.at(i);
+        if (atlas->isEmpty()) {
+            atlas->invalidate();
+            atlas->deleteLater();
+            m_atlases.removeAt(i);
+            qCDebug(QSG_LOG_INFO, "texture atlas page released, pages: %d, occupancy: %.1f%%",
+                    m_atlases.size(), occupancy() * 100);
+        }
     }
 }
 
 QSGTexture *Manager::create(const QImage &image)
 {
-    QSGTexture *t = 0;
-    if (image.width() < m_atlas_size_limit && image.height() < m_atlas_size_limit) {
-        if (!m_atlas)
-            m_atlas = new Atlas(m_atlas_size);
-        t = m_atlas->create(image);
+    if (image.width() >= m_atlas_size_limit || image.height() >= m_atlas_size_limit)
+        return 0;
+
+    releaseEmptyPages();
+
+    // Older pages come first, so the holes they have are filled before
+    // newer pages grow.
+    for (int i = 0; i < m_atlases.size(); ++i) {
+        if (Texture *t = m_atlases.at(i)->create(image))
+            return t;
     }
-    return t;
+
+    if (m_atlases.size() >= m_atlas_page_limit)
+        return 0;
+
+    Atlas *atlas = new Atlas(m_atlas_size);
+    m_atlases << atlas;
+    qCDebug(QSG_LOG_INFO, "texture atlas page added, pages: %d, occupancy: %.1f%%",
+            m_atlases.size(), occupancy() * 100);
+    return atlas->create(image);
 }
 
 Atlas::Atlas(const QSize &size)
     : m_allocator(size)
+    , m_texture_count(0)
+    , m_used_area(0)
     , m_texture_id(0)
     , m_size(size)
     , m_allocated(false)
@@ -205,6 +258,8 @@ Texture *Atlas::create(const QImage &image)
     if (rect.width() > 0 && rect.height() > 0) {
         Texture *t = new Texture(this, rect, image);
         m_pending_uploads << t;
+        ++m_texture_count;
+        m_used_area += rect.width() * rect.height();
         return t;
     }
     return 0;
@@ -412,6 +467,8 @@ void Atlas::remove(Texture *t)
     QRect atlasRect = t->atlasSubRect();
     m_allocator.deallocate(atlasRect);
     m_pending_uploads.removeOne(t);
+    --m_texture_count;
+    m_used_area -= atlasRect.width() * atlasRect.height();
 }
 
 
@@ -69,11 +69,16 @@ public:
     QSGTexture *create(const QImage &image);
     void invalidate();
 
+    qreal occupancy() const;
+
 private:
-    Atlas *m_atlas;
+    void releaseEmptyPages();
+
+    QList<Atlas *> m_atlases;
 
     QSize m_atlas_size;
     int m_atlas_size_limit;
+    int m_atlas_page_limit;
 };
 
 class Atlas : public QObject
@@ -95,8 +100,13 @@ public:
 
     QSize size() const { return m_size; }
 
+    bool isEmpty() const { return m_texture_count == 0; }
+    int usedArea() const { return m_used_area; }
+
 private:
     QSGAreaAllocator m_allocator;
+    int m_texture_count;
+    int m_used_area;
     GLuint m_texture_id;
     QSize m_size;
     QList<Texture *> m_pending_uploads;
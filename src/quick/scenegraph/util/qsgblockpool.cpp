@@ -0,0 +1,192 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsgblockpool_p.h"
+
+#include <QtCore/qmutex.h>
+#include <QtCore/qvarlengtharray.h>
+
+#include <stdlib.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Blocks are grouped into size classes: 16 byte steps up to 256 bytes, which
+    covers nodes, quads and nine-patch grids, followed by power of two classes
+    up to MaxPooledSize for glyph runs and larger nodes. Blocks are carved out
+    of 64KB chunks and kept on a free list when released, so geometry and
+    nodes that come and go with delegates recycle the same memory instead of
+    going through malloc and fragmenting the heap.
+ */
+
+namespace {
+
+enum {
+    SmallClassStep = 16,
+    SmallClassLimit = 256,
+    SmallClassCount = SmallClassLimit / SmallClassStep,
+    LargeClassCount = 4, // 512, 1024, 2048, 4096
+    ClassCount = SmallClassCount + LargeClassCount,
+    ChunkSize = 64 * 1024
+};
+
+struct FreeBlock
+{
+    FreeBlock *next;
+};
+
+inline int qsg_sizeClass(size_t size)
+{
+    if (size <= SmallClassLimit)
+        return size == 0 ? 0 : int((size - 1) / SmallClassStep);
+    int c = SmallClassCount;
+    size_t classSize = SmallClassLimit * 2;
+    while (classSize < size) {
+        classSize *= 2;
+        ++c;
+    }
+    return c;
+}
+
+inline size_t qsg_classSize(int sizeClass)
+{
+    if (sizeClass < SmallClassCount)
+        return (sizeClass + 1) * SmallClassStep;
+    return size_t(SmallClassLimit) << (sizeClass - SmallClassCount + 1);
+}
+
+class BlockPool
+{
+public:
+    BlockPool()
+    {
+        for (int i = 0; i < ClassCount; ++i) {
+            freeLists[i] = 0;
+            chunkPos[i] = 0;
+            chunkEnd[i] = 0;
+        }
+    }
+
+    ~BlockPool()
+    {
+        for (int i = 0; i < chunks.size(); ++i)
+            free(chunks.at(i));
+    }
+
+    void *allocate(int sizeClass)
+    {
+        QMutexLocker lock(&mutex);
+        if (FreeBlock *block = freeLists[sizeClass]) {
+            freeLists[sizeClass] = block->next;
+            return block;
+        }
+
+        const size_t blockSize = qsg_classSize(sizeClass);
+        if (chunkPos[sizeClass] + blockSize > chunkEnd[sizeClass]) {
+            char *chunk = (char *) malloc(ChunkSize);
+            Q_CHECK_PTR(chunk);
+            chunks.append(chunk);
+            chunkPos[sizeClass] = chunk;
+            chunkEnd[sizeClass] = chunk + ChunkSize;
+        }
+        void *block = chunkPos[sizeClass];
+        chunkPos[sizeClass] += blockSize;
+        return block;
+    }
+
+    void release(void *ptr, int sizeClass)
+    {
+        QMutexLocker lock(&mutex);
+        FreeBlock *block = static_cast<FreeBlock *>(ptr);
+        block->next = freeLists[sizeClass];
+        freeLists[sizeClass] = block;
+    }
+
+private:
+    QMutex mutex;
+    FreeBlock *freeLists[ClassCount];
+    char *chunkPos[ClassCount];
+    char *chunkEnd[ClassCount];
+    QVarLengthArray<char *, 16> chunks;
+};
+
+}
+
+Q_GLOBAL_STATIC(BlockPool, qsg_blockPool)
+
+/*!
+    \internal
+
+    Returns a block of at least \a size bytes. Blocks larger than
+    MaxPooledSize are allocated with malloc. The block must be returned
+    with release() using the same \a size.
+ */
+void *QSGBlockPool::allocate(size_t size)
+{
+    if (size > MaxPooledSize)
+        return malloc(size);
+    BlockPool *pool = qsg_blockPool();
+    if (!pool)
+        return malloc(size);
+    return pool->allocate(qsg_sizeClass(size));
+}
+
+/*!
+    \internal
+
+    Returns the block \a ptr, allocated with allocate() for \a size bytes,
+    to the pool.
+ */
+void QSGBlockPool::release(void *ptr, size_t size)
+{
+    if (!ptr)
+        return;
+    if (size > MaxPooledSize) {
+        free(ptr);
+        return;
+    }
+    // The pool owns the chunk the block lives in, so a block released after
+    // the pool has been destroyed during shutdown is simply dropped.
+    if (BlockPool *pool = qsg_blockPool())
+        pool->release(ptr, qsg_sizeClass(size));
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,177 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsgdamagetracker_p.h"
+
+#include <QtQuick/qsgnode.h>
+#include <QtGui/qmatrix4x4.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Tracks the bounds and opacity of the geometry nodes in a scene graph
+    between two renders, so that only the area which changed needs to be
+    rendered again. Used by layers and by windows which know what is left
+    in their back buffer.
+ */
+
+/*
+    Computes the bounding rect of the vertices of \a g, assuming that the
+    first attribute holds the vertex position as it does for all geometry
+    in the scene graph. Returns false if the position is not made of floats.
+ */
+static bool qsg_geometry_bounds(const QSGGeometry *g, QRectF *bounds)
+{
+    *bounds = QRectF();
+    if (!g || g->vertexCount() == 0)
+        return true;
+
+    const QSGGeometry::Attribute *a = g->attributes();
+    if (g->attributeCount() < 1 || a->type != GL_FLOAT || a->tupleSize < 2)
+        return false;
+
+    const char *data = static_cast<const char *>(g->vertexData());
+    const int stride = g->sizeOfVertex();
+    const float *v = reinterpret_cast<const float *>(data);
+    float x1 = v[0];
+    float y1 = v[1];
+    float x2 = x1;
+    float y2 = y1;
+    for (int i = 1; i < g->vertexCount(); ++i) {
+        v = reinterpret_cast<const float *>(data + i * stride);
+        x1 = qMin(x1, v[0]);
+        x2 = qMax(x2, v[0]);
+        y1 = qMin(y1, v[1]);
+        y2 = qMax(y2, v[1]);
+    }
+    *bounds = QRectF(x1, y1, x2 - x1, y2 - y1);
+    return true;
+}
+
+/*
+    Walks the subtree of \a node and records the bounds and opacity of the
+    geometry nodes in \a nodes. The area of nodes which are new, changed or
+    below a changed node, both before and after the change, is added to
+    \a damage, in the coordinates of the root. Returns false if the change cannot be
+    bounded, in which case everything needs to be rendered.
+ */
+bool QSGDamageTracker::collect(QSGNode *node, const QMatrix4x4 &matrix, qreal opacity, bool dirty,
+                               const QSet<QSGNode *> &changedNodes, QHash<QSGNode *, NodeDamage> *nodes,
+                               QRectF *damage) const
+{
+    if (node->isSubtreeBlocked())
+        return true;
+
+    dirty = dirty || changedNodes.contains(node);
+
+    const QMatrix4x4 *m = &matrix;
+    QMatrix4x4 combined;
+
+    switch (node->type()) {
+    case QSGNode::TransformNodeType:
+        combined = matrix * static_cast<QSGTransformNode *>(node)->matrix();
+        // Perspective transforms cannot be mapped to a rect.
+        if (!qFuzzyIsNull(combined(3, 0)) || !qFuzzyIsNull(combined(3, 1)))
+            return false;
+        m = &combined;
+        break;
+    case QSGNode::OpacityNodeType:
+        opacity *= static_cast<QSGOpacityNode *>(node)->opacity();
+        break;
+    case QSGNode::RenderNodeType:
+        return false;
+    case QSGNode::GeometryNodeType: {
+        QSGGeometryNode *gn = static_cast<QSGGeometryNode *>(node);
+        QHash<QSGNode *, NodeDamage>::const_iterator previous = m_nodes.constFind(node);
+        bool known = previous != m_nodes.constEnd();
+
+        NodeDamage state;
+        if (known && !dirty)
+            state.localBounds = previous->localBounds;
+        else if (!qsg_geometry_bounds(gn->geometry(), &state.localBounds))
+            return false;
+        state.bounds = m->mapRect(state.localBounds);
+        state.opacity = opacity;
+        nodes->insert(node, state);
+
+        // Nodes which update themselves in preprocess, like distance field
+        // text, may change after this point, so they are always redrawn.
+        if (!known)
+            *damage |= state.bounds;
+        else if (dirty || (gn->flags() & QSGNode::UsePreprocess)
+                 || previous->bounds != state.bounds || previous->opacity != opacity)
+            *damage |= previous->bounds | state.bounds;
+        break;
+    }
+    default:
+        break;
+    }
+
+    for (QSGNode *child = node->firstChild(); child; child = child->nextSibling()) {
+        if (!collect(child, *m, opacity, dirty, changedNodes, nodes, damage))
+            return false;
+    }
+    return true;
+}
+
+/*
+    Sets \a damage to the area, in the coordinates of \a root, which changed
+    since the last update, given the nodes reported as changed by the
+    renderer. Returns false if the change cannot be bounded.
+ */
+bool QSGDamageTracker::update(QSGNode *root, const QSet<QSGNode *> &changedNodes, QRectF *damage)
+{
+    QHash<QSGNode *, NodeDamage> nodes;
+    nodes.reserve(m_nodes.size());
+    *damage = QRectF();
+    bool bounded = collect(root, QMatrix4x4(), 1, false, changedNodes, &nodes, damage);
+
+    // Nodes which are gone leave their previous area behind.
+    for (QHash<QSGNode *, NodeDamage>::const_iterator it = m_nodes.constBegin();
+         it != m_nodes.constEnd(); ++it) {
+        if (!nodes.contains(it.key()))
+            *damage |= it->bounds;
+    }
+    m_nodes.swap(nodes);
+    return bounded;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,260 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsgdistancefielddiskcache_p.h"
+
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qstandardpaths.h>
+#include <QtCore/qtemporaryfile.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Distance fields are kept in one file per font and resolution, named after
+    a hash of the font's identity and its 'head' table. The 'head' table
+    holds the checksum of the whole font file, so a changed font gets a file
+    of its own. The file starts with a header describing the distance field
+    parameters, followed by records of glyph index, width, height and the
+    8-bit distance values. New glyphs are appended in one write per frame,
+    and a truncated record at the end, from a process which did not finish
+    writing, is ignored.
+ */
+
+namespace {
+
+enum {
+    CacheMagic = 0x51534446, // 'QSDF'
+    CacheVersion = 1,
+    HeaderSize = 6 * sizeof(quint32),
+    RecordHeaderSize = sizeof(quint32) + 2 * sizeof(quint16)
+};
+
+}
+
+QSGDistanceFieldDiskCache::QSGDistanceFieldDiskCache(const QString &fileName, bool doubleGlyphResolution)
+    : m_fileName(fileName)
+    , m_file(fileName)
+    , m_data(0)
+    , m_size(0)
+    , m_doubleGlyphResolution(doubleGlyphResolution)
+{
+}
+
+QSGDistanceFieldDiskCache::~QSGDistanceFieldDiskCache()
+{
+    flush();
+    if (m_data)
+        m_file.unmap(const_cast<uchar *>(m_data));
+}
+
+/*!
+    \internal
+
+    Returns the disk cache for \a font, or 0 if the cache is disabled with
+    QSG_DISTANCEFIELD_DISKCACHE=0 or can't be opened. The cache directory
+    can be set with QSG_DISTANCEFIELD_CACHE_DIR.
+ */
+QSGDistanceFieldDiskCache *QSGDistanceFieldDiskCache::create(const QRawFont &font, bool doubleGlyphResolution)
+{
+    static const bool disabled = qgetenv("QSG_DISTANCEFIELD_DISKCACHE") == "0";
+    if (disabled)
+        return 0;
+
+    const QByteArray head = font.fontTable("head");
+    if (head.isEmpty())
+        return 0;
+
+    QString dir = QString::fromLocal8Bit(qgetenv("QSG_DISTANCEFIELD_CACHE_DIR"));
+    if (dir.isEmpty()) {
+        dir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+        if (dir.isEmpty())
+            return 0;
+        dir += QLatin1String("/qtquick/distancefields");
+    }
+    if (!QDir().mkpath(dir))
+        return 0;
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(font.familyName().toUtf8());
+    hash.addData(font.styleName().toUtf8());
+    hash.addData(QByteArray::number(font.weight()));
+    hash.addData(QByteArray::number(int(font.style())));
+    hash.addData(head);
+
+    const QString fileName = dir + QLatin1Char('/')
+            + QString::fromLatin1(hash.result().toHex())
+            + (doubleGlyphResolution ? QLatin1String("-2x.qdf") : QLatin1String(".qdf"));
+
+    QSGDistanceFieldDiskCache *cache = new QSGDistanceFieldDiskCache(fileName, doubleGlyphResolution);
+    if (!cache->open()) {
+        delete cache;
+        return 0;
+    }
+    return cache;
+}
+
+QByteArray QSGDistanceFieldDiskCache::header() const
+{
+    const quint32 values[] = {
+        CacheMagic,
+        CacheVersion,
+        quint32(QT_DISTANCEFIELD_TILESIZE(m_doubleGlyphResolution)),
+        quint32(QT_DISTANCEFIELD_RADIUS(m_doubleGlyphResolution)),
+        quint32(QT_DISTANCEFIELD_SCALE(m_doubleGlyphResolution)),
+        quint32(QT_DISTANCEFIELD_BASEFONTSIZE(m_doubleGlyphResolution))
+    };
+    return QByteArray((const char *) values, sizeof(values));
+}
+
+/*
+    Maps the existing file and indexes its records. A missing file, or one
+    written with different parameters, is replaced by one holding only the
+    header.
+ */
+bool QSGDistanceFieldDiskCache::open()
+{
+    const QByteArray expected = header();
+
+    if (m_file.open(QIODevice::ReadOnly)) {
+        m_size = m_file.size();
+        if (m_size >= HeaderSize)
+            m_data = m_file.map(0, m_size);
+        if (m_data && memcmp(m_data, expected.constData(), HeaderSize) == 0) {
+            qint64 offset = HeaderSize;
+            while (offset + RecordHeaderSize <= m_size) {
+                const uchar *record = m_data + offset;
+                quint32 glyph;
+                quint16 width, height;
+                memcpy(&glyph, record, sizeof(quint32));
+                memcpy(&width, record + sizeof(quint32), sizeof(quint16));
+                memcpy(&height, record + sizeof(quint32) + sizeof(quint16), sizeof(quint16));
+                const qint64 next = offset + RecordHeaderSize + qint64(width) * height;
+                if (next > m_size)
+                    break;
+                m_index.insert(glyph, offset);
+                offset = next;
+            }
+            return true;
+        }
+
+        // Stale or broken, start over.
+        if (m_data)
+            m_file.unmap(const_cast<uchar *>(m_data));
+        m_data = 0;
+        m_size = 0;
+        m_file.close();
+        QFile::remove(m_fileName);
+    }
+
+    // Another process may be creating the file at the same time, so the
+    // header is written to a temporary file which is then moved in place.
+    QTemporaryFile tmp(m_fileName + QLatin1String(".XXXXXX"));
+    if (!tmp.open() || tmp.write(expected) != expected.size())
+        return false;
+    tmp.close();
+    if (tmp.rename(m_fileName))
+        tmp.setAutoRemove(false);
+    return QFile::exists(m_fileName);
+}
+
+/*!
+    \internal
+
+    Fills \a field with the distance field of \a glyph and returns true if
+    the glyph is in the cache.
+ */
+bool QSGDistanceFieldDiskCache::load(glyph_t glyph, QDistanceField *field) const
+{
+    QHash<glyph_t, qint64>::const_iterator it = m_index.constFind(glyph);
+    if (it == m_index.constEnd())
+        return false;
+
+    const uchar *record = m_data + it.value();
+    quint16 width, height;
+    memcpy(&width, record + sizeof(quint32), sizeof(quint16));
+    memcpy(&height, record + sizeof(quint32) + sizeof(quint16), sizeof(quint16));
+
+    *field = QDistanceField(width, height);
+    memcpy(field->bits(), record + RecordHeaderSize, int(width) * height);
+    return true;
+}
+
+/*!
+    \internal
+
+    Queues the distance field of \a glyph to be written by the next flush().
+ */
+void QSGDistanceFieldDiskCache::store(glyph_t glyph, const QDistanceField &field)
+{
+    if (field.isNull() || m_index.contains(glyph) || m_written.contains(glyph))
+        return;
+    if (field.width() > 0xffff || field.height() > 0xffff)
+        return;
+
+    const quint32 id = glyph;
+    const quint16 width = field.width();
+    const quint16 height = field.height();
+    m_pending.append((const char *) &id, sizeof(quint32));
+    m_pending.append((const char *) &width, sizeof(quint16));
+    m_pending.append((const char *) &height, sizeof(quint16));
+    m_pending.append((const char *) field.constBits(), int(width) * height);
+    m_written.insert(glyph);
+}
+
+/*!
+    \internal
+
+    Appends the queued distance fields to the cache file.
+ */
+void QSGDistanceFieldDiskCache::flush()
+{
+    if (m_pending.isEmpty())
+        return;
+
+    // A single unbuffered write keeps records from concurrent writers apart.
+    QFile out(m_fileName);
+    if (out.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Unbuffered))
+        out.write(m_pending);
+    m_pending.clear();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,86 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSGDISTANCEFIELDDISKCACHE_P_H
+#define QSGDISTANCEFIELDDISKCACHE_P_H
+
+#include <private/qtquickglobal_p.h>
+#include <private/qdistancefield_p.h>
+
+#include <QtCore/qfile.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qset.h>
+#include <QtGui/qrawfont.h>
+
+QT_BEGIN_NAMESPACE
+
+class Q_QUICK_PRIVATE_EXPORT QSGDistanceFieldDiskCache
+{
+public:
+    static QSGDistanceFieldDiskCache *create(const QRawFont &font, bool doubleGlyphResolution);
+    ~QSGDistanceFieldDiskCache();
+
+    bool load(glyph_t glyph, QDistanceField *field) const;
+    void store(glyph_t glyph, const QDistanceField &field);
+    void flush();
+
+    int glyphCount() const { return m_index.size(); }
+
+private:
+    QSGDistanceFieldDiskCache(const QString &fileName, bool doubleGlyphResolution);
+    bool open();
+    QByteArray header() const;
+
+    QString m_fileName;
+    QFile m_file;
+    const uchar *m_data;
+    qint64 m_size;
+
+    QHash<glyph_t, qint64> m_index;
+    QSet<glyph_t> m_written;
+    QByteArray m_pending;
+
+    bool m_doubleGlyphResolution;
+};
+
+QT_END_NAMESPACE
+
+#endif
@@ -0,0 +1,186 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsgdistancefieldgenerator_p.h"
+
+#include <QtCore/qrunnable.h>
+#include <QtCore/qthreadpool.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Generates the distance fields for a slice of a batch on a worker thread.
+    The glyph outlines are extracted on the render thread beforehand, so the
+    job never touches the font engine.
+ */
+class QSGDistanceFieldGeneratorJob : public QRunnable
+{
+public:
+    QSGDistanceFieldGeneratorJob(QSGDistanceFieldGenerator *generator,
+                                 const QVector<glyph_t> &glyphs,
+                                 const QList<QPainterPath> &paths)
+        : m_generator(generator)
+        , m_glyphs(glyphs)
+        , m_paths(paths)
+    {
+    }
+
+    void run()
+    {
+        QList<QDistanceField> fields;
+        fields.reserve(m_glyphs.size());
+        for (int i = 0; i < m_glyphs.size(); ++i)
+            fields.append(QDistanceField(m_paths.at(i), m_glyphs.at(i), m_generator->m_doubleGlyphResolution));
+
+        m_generator->addResults(m_glyphs, fields);
+        emit m_generator->glyphsReady();
+        m_generator->jobFinished();
+    }
+
+private:
+    QSGDistanceFieldGenerator *m_generator;
+    QVector<glyph_t> m_glyphs;
+    QList<QPainterPath> m_paths;
+};
+
+/*
+    Returns a generator which renders distance fields on the global thread
+    pool, or 0 if threaded generation is disabled or there is only one core
+    to run on. Batches smaller than QSG_DISTANCEFIELD_ASYNC_THRESHOLD glyphs
+    are left to the caller to generate synchronously.
+ */
+QSGDistanceFieldGenerator *QSGDistanceFieldGenerator::create(bool doubleGlyphResolution)
+{
+    static int threshold = -1;
+    if (threshold < 0) {
+        bool ok = false;
+        threshold = qgetenv("QSG_DISTANCEFIELD_ASYNC_THRESHOLD").toInt(&ok);
+        if (!ok || threshold < 0)
+            threshold = 32;
+    }
+
+    if (threshold == 0 || QThreadPool::globalInstance()->maxThreadCount() < 2)
+        return 0;
+
+    return new QSGDistanceFieldGenerator(threshold, doubleGlyphResolution);
+}
+
+QSGDistanceFieldGenerator::QSGDistanceFieldGenerator(int threshold, bool doubleGlyphResolution)
+    : m_activeJobs(0)
+    , m_threshold(threshold)
+    , m_doubleGlyphResolution(doubleGlyphResolution)
+{
+}
+
+QSGDistanceFieldGenerator::~QSGDistanceFieldGenerator()
+{
+    // The jobs refer back to us, so they must all be done before we go away.
+    QMutexLocker lock(&m_mutex);
+    while (m_activeJobs > 0)
+        m_idle.wait(&m_mutex);
+}
+
+/*
+    Returns true while glyphs are still being generated or have been
+    generated but not yet collected with takeResults().
+ */
+bool QSGDistanceFieldGenerator::isBusy() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_activeJobs > 0 || !m_readyGlyphs.isEmpty();
+}
+
+/*
+    Splits the batch into a few jobs per worker thread so that the first
+    results become available well before the whole batch is done.
+ */
+void QSGDistanceFieldGenerator::generate(const QVector<glyph_t> &glyphs, const QList<QPainterPath> &paths)
+{
+    Q_ASSERT(glyphs.size() == paths.size());
+
+    const int count = glyphs.size();
+    const int workers = QThreadPool::globalInstance()->maxThreadCount();
+    const int jobSize = qMax(8, (count + 2 * workers - 1) / (2 * workers));
+
+    for (int first = 0; first < count; first += jobSize) {
+        const int size = qMin(jobSize, count - first);
+        {
+            QMutexLocker lock(&m_mutex);
+            ++m_activeJobs;
+        }
+        QThreadPool::globalInstance()->start(new QSGDistanceFieldGeneratorJob(this,
+                                                                              glyphs.mid(first, size),
+                                                                              paths.mid(first, size)));
+    }
+}
+
+/*
+    Moves the distance fields finished since the last call into \a glyphs
+    and \a fields. Returns false if there were none.
+ */
+bool QSGDistanceFieldGenerator::takeResults(QVector<glyph_t> *glyphs, QList<QDistanceField> *fields)
+{
+    QMutexLocker lock(&m_mutex);
+    if (m_readyGlyphs.isEmpty())
+        return false;
+
+    *glyphs = m_readyGlyphs;
+    *fields = m_readyFields;
+    m_readyGlyphs.clear();
+    m_readyFields.clear();
+    return true;
+}
+
+void QSGDistanceFieldGenerator::addResults(const QVector<glyph_t> &glyphs, const QList<QDistanceField> &fields)
+{
+    QMutexLocker lock(&m_mutex);
+    m_readyGlyphs += glyphs;
+    m_readyFields += fields;
+}
+
+void QSGDistanceFieldGenerator::jobFinished()
+{
+    QMutexLocker lock(&m_mutex);
+    if (--m_activeJobs == 0)
+        m_idle.wakeAll();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,93 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSGDISTANCEFIELDGENERATOR_P_H
+#define QSGDISTANCEFIELDGENERATOR_P_H
+
+#include <private/qtquickglobal_p.h>
+#include <private/qdistancefield_p.h>
+
+#include <QtCore/qobject.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qwaitcondition.h>
+#include <QtCore/qvector.h>
+#include <QtGui/qpainterpath.h>
+
+QT_BEGIN_NAMESPACE
+
+class Q_QUICK_PRIVATE_EXPORT QSGDistanceFieldGenerator : public QObject
+{
+    Q_OBJECT
+public:
+    static QSGDistanceFieldGenerator *create(bool doubleGlyphResolution);
+    ~QSGDistanceFieldGenerator();
+
+    int threshold() const { return m_threshold; }
+    bool isBusy() const;
+
+    void generate(const QVector<glyph_t> &glyphs, const QList<QPainterPath> &paths);
+    bool takeResults(QVector<glyph_t> *glyphs, QList<QDistanceField> *fields);
+
+Q_SIGNALS:
+    void glyphsReady();
+
+private:
+    QSGDistanceFieldGenerator(int threshold, bool doubleGlyphResolution);
+
+    void addResults(const QVector<glyph_t> &glyphs, const QList<QDistanceField> &fields);
+    void jobFinished();
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_idle;
+    int m_activeJobs;
+
+    QVector<glyph_t> m_readyGlyphs;
+    QList<QDistanceField> m_readyFields;
+
+    int m_threshold;
+    bool m_doubleGlyphResolution;
+
+    friend class QSGDistanceFieldGeneratorJob;
+};
+
+QT_END_NAMESPACE
+
+#endif
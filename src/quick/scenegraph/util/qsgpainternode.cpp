@@ -68,8 +68,15 @@ static inline int qt_next_power_of_two(int v)
     return v;
 }
 
+#ifndef GL_BGRA
+#define GL_BGRA 0x80E1
+#endif
+
+void qsg_swizzleBGRAToRGBA(QImage *image);
+
 QSGPainterTexture::QSGPainterTexture()
     : QSGPlainTexture()
+    , m_uploaded(false)
 {
     m_retain_image = true;
 }
@@ -81,7 +88,26 @@ void QSGPainterTexture::bind()
         return;
     }
 
-    setImage(m_image);
+    // Once the texture holds the whole image, only the dirty part needs to
+    // be uploaded again. The node creates a new texture when it is resized.
+    const QRect rect = m_dirty_rect & QRect(QPoint(0, 0), m_image.size());
+    if (m_uploaded && !rect.isEmpty() && m_image.format() == QImage::Format_ARGB32_Premultiplied) {
+        QSystraceEvent systrace("graphics", "QSGPainterTexture::uploadDirty");
+
+        QImage dirty = m_image.copy(rect);
+        if (!m_uploaded_as_bgra)
+            qsg_swizzleBGRAToRGBA(&dirty);
+
+        glBindTexture(GL_TEXTURE_2D, m_texture_id);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, rect.x(), rect.y(), rect.width(), rect.height(),
+                        m_uploaded_as_bgra ? GL_BGRA : GL_RGBA, GL_UNSIGNED_BYTE, dirty.constBits());
+
+        m_dirty_texture = false;
+        m_mipmaps_generated = false;
+    } else {
+        setImage(m_image);
+        m_uploaded = true;
+    }
     QSGPlainTexture::bind();
 
     m_dirty_rect = QRect();
@@ -66,6 +66,7 @@ public:
 
 private:
     QRect m_dirty_rect;
+    bool m_uploaded;
 };
 
 class Q_QUICK_PRIVATE_EXPORT QSGPainterNode : public QSGGeometryNode
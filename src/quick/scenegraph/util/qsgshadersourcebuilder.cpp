@@ -42,10 +42,14 @@
 #include "qsgshadersourcebuilder_p.h"
 
 #include <QtGui/qopenglcontext.h>
+#include <QtGui/qopenglfunctions.h>
 #include <QtGui/qopenglshaderprogram.h>
 
+#include <QtCore/qcryptographichash.h>
 #include <QtCore/qdebug.h>
+#include <QtCore/qdir.h>
 #include <QtCore/qfile.h>
+#include <QtCore/qsavefile.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -226,6 +230,188 @@ void QSGShaderSourceBuilder::initializeProgramFromFiles(QOpenGLShaderProgram *pr
     program->addShaderFromSourceCode(QOpenGLShader::Fragment, builder.source());
 }
 
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+#define QSG_PROGRAM_BINARY_MAGIC 0x51534742 // "QSGB"
+
+namespace {
+
+struct ProgramBinaryHeader
+{
+    quint32 magic;
+    quint32 format;
+    quint32 length;
+};
+
+typedef void (QOPENGLF_APIENTRYP GetProgramBinaryFunction)(GLuint program, GLsizei bufSize, GLsizei *length,
+                                                           GLenum *binaryFormat, void *binary);
+typedef void (QOPENGLF_APIENTRYP ProgramBinaryFunction)(GLuint program, GLenum binaryFormat,
+                                                        const void *binary, GLsizei length);
+
+struct ProgramBinaryFunctions
+{
+    ProgramBinaryFunctions()
+        : getProgramBinary(0)
+        , programBinary(0)
+    {
+        QOpenGLContext *context = QOpenGLContext::currentContext();
+        if (!context)
+            return;
+#ifdef QT_OPENGL_ES
+        if (!context->hasExtension(QByteArrayLiteral("GL_OES_get_program_binary")))
+            return;
+        getProgramBinary = reinterpret_cast<GetProgramBinaryFunction>(context->getProcAddress("glGetProgramBinaryOES"));
+        programBinary = reinterpret_cast<ProgramBinaryFunction>(context->getProcAddress("glProgramBinaryOES"));
+#else
+        const QSurfaceFormat format = context->format();
+        if (qMakePair(format.majorVersion(), format.minorVersion()) < qMakePair(4, 1)
+                && !context->hasExtension(QByteArrayLiteral("GL_ARB_get_program_binary")))
+            return;
+        getProgramBinary = reinterpret_cast<GetProgramBinaryFunction>(context->getProcAddress("glGetProgramBinary"));
+        programBinary = reinterpret_cast<ProgramBinaryFunction>(context->getProcAddress("glProgramBinary"));
+#endif
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        if (formats <= 0) {
+            getProgramBinary = 0;
+            programBinary = 0;
+        }
+    }
+
+    bool isValid() const { return getProgramBinary && programBinary; }
+
+    GetProgramBinaryFunction getProgramBinary;
+    ProgramBinaryFunction programBinary;
+};
+
+}
+
+static QString programBinaryCacheDirectory()
+{
+    static const QString directory = QString::fromLocal8Bit(qgetenv("QSG_PROGRAM_BINARY_CACHE"));
+    return directory;
+}
+
+static QString programBinaryFile(const QByteArray &key)
+{
+    return programBinaryCacheDirectory() + QLatin1Char('/') + QString::fromLatin1(key) + QLatin1String(".bin");
+}
+
+static void addGLString(QCryptographicHash *hash, GLenum name)
+{
+    const char *value = reinterpret_cast<const char *>(glGetString(name));
+    if (value)
+        hash->addData(value, qstrlen(value) + 1);
+}
+
+/*
+    Returns the key under which the linked program built from \a vertexShader
+    and \a fragmentShader, with \a attributeNames bound to consecutive
+    locations, is stored in the program binary cache.
+
+    The key contains the identity of the GL driver of the current context, so
+    that binaries are never given to another GPU or driver version. An empty
+    key is returned when the cache, which is enabled by setting
+    QSG_PROGRAM_BINARY_CACHE to a directory, is not in use.
+ */
+QByteArray QSGShaderSourceBuilder::programBinaryKey(const QByteArray &vertexShader,
+                                                    const QByteArray &fragmentShader,
+                                                    char const *const *attributeNames)
+{
+    if (programBinaryCacheDirectory().isEmpty() || !QOpenGLContext::currentContext())
+        return QByteArray();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    addGLString(&hash, GL_VENDOR);
+    addGLString(&hash, GL_RENDERER);
+    addGLString(&hash, GL_VERSION);
+    hash.addData(vertexShader.constData(), vertexShader.size() + 1);
+    hash.addData(fragmentShader.constData(), fragmentShader.size() + 1);
+    for (int i = 0; attributeNames && attributeNames[i]; ++i)
+        hash.addData(attributeNames[i], qstrlen(attributeNames[i]) + 1);
+    return hash.result().toHex();
+}
+
+/*
+    Loads the binary stored under \a key into \a program and links it. Returns
+    false if there is no usable binary, in which case the program has to be
+    built from source.
+ */
+bool QSGShaderSourceBuilder::loadProgramBinary(QOpenGLShaderProgram *program, const QByteArray &key)
+{
+    if (key.isEmpty())
+        return false;
+
+    ProgramBinaryFunctions functions;
+    if (!functions.isValid())
+        return false;
+
+    QFile file(programBinaryFile(key));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    const QByteArray data = file.readAll();
+    file.close();
+
+    ProgramBinaryHeader header;
+    if (data.size() < int(sizeof(header)))
+        return false;
+    memcpy(&header, data.constData(), sizeof(header));
+    if (header.magic != QSG_PROGRAM_BINARY_MAGIC || header.length != data.size() - sizeof(header))
+        return false;
+
+    functions.programBinary(program->programId(), header.format, data.constData() + sizeof(header), header.length);
+    // With no shaders added, link() only checks whether the binary was accepted.
+    if (!program->link()) {
+        // The driver may reject binaries of an older version of itself.
+        QFile::remove(file.fileName());
+        return false;
+    }
+    return true;
+}
+
+/*
+    Stores the linked \a program in the program binary cache under \a key.
+ */
+void QSGShaderSourceBuilder::saveProgramBinary(QOpenGLShaderProgram *program, const QByteArray &key)
+{
+    if (key.isEmpty() || !program->isLinked())
+        return;
+
+    ProgramBinaryFunctions functions;
+    if (!functions.isValid())
+        return;
+
+    GLint length = 0;
+    QOpenGLContext::currentContext()->functions()->glGetProgramiv(program->programId(), GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    QByteArray data(sizeof(ProgramBinaryHeader) + length, Qt::Uninitialized);
+    GLsizei written = 0;
+    GLenum format = 0;
+    functions.getProgramBinary(program->programId(), length, &written, &format, data.data() + sizeof(ProgramBinaryHeader));
+    if (written <= 0)
+        return;
+
+    ProgramBinaryHeader header;
+    header.magic = QSG_PROGRAM_BINARY_MAGIC;
+    header.format = format;
+    header.length = written;
+    memcpy(data.data(), &header, sizeof(header));
+    data.resize(sizeof(header) + written);
+
+    QDir().mkpath(programBinaryCacheDirectory());
+    QSaveFile file(programBinaryFile(key));
+    if (file.open(QIODevice::WriteOnly) && file.write(data) == data.size())
+        file.commit();
+}
+
 QByteArray QSGShaderSourceBuilder::source() const
 {
     return m_source;
@@ -60,6 +60,12 @@ public:
                                            const QString &vertexShader,
                                            const QString &fragmentShader);
 
+    static QByteArray programBinaryKey(const QByteArray &vertexShader,
+                                       const QByteArray &fragmentShader,
+                                       char const *const *attributeNames);
+    static bool loadProgramBinary(QOpenGLShaderProgram *program, const QByteArray &key);
+    static void saveProgramBinary(QOpenGLShaderProgram *program, const QByteArray &key);
+
     QByteArray source() const;
     void clear();
 
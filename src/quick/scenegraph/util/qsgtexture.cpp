@@ -563,6 +563,7 @@ QSGPlainTexture::QSGPlainTexture()
     , m_owns_texture(true)
     , m_mipmaps_generated(false)
     , m_retain_image(false)
+    , m_uploaded_as_bgra(false)
 {
 }
 
@@ -744,6 +745,7 @@ void QSGPlainTexture::bind()
         swizzleTime = qsg_renderer_timer.nsecsElapsed();
 
     glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, w, h, 0, externalFormat, GL_UNSIGNED_BYTE, tmp.constBits());
+    m_uploaded_as_bgra = externalFormat == GL_BGRA;
 
     qint64 uploadTime = 0;
     if (profileFrames)
@@ -113,6 +113,7 @@ protected:
     uint m_owns_texture : 1;
     uint m_mipmaps_generated : 1;
     uint m_retain_image: 1;
+    uint m_uploaded_as_bgra : 1;
 };
 
 Q_QUICK_PRIVATE_EXPORT bool qsg_safeguard_texture(QSGTexture *);
@@ -2463,15 +2463,58 @@ QQmlListProperty<QObject> QQuickPropertyAnimation::exclude()
     return QQmlListProperty<QObject>(this, d->exclude);
 }
 
+/*
+    Returns the core index of \a property when it is a plain, writable qreal
+    property that can be written directly through the meta-object, or -1 if
+    the value has to go through the generic QVariant based write.
+*/
+int QQuickPropertyAnimationPrivate::directRealIndex(const QQmlProperty &property)
+{
+    if (!property.isValid() || property.type() != QQmlProperty::Property)
+        return -1;
+    const QQmlPropertyData &core = QQmlPropertyPrivate::get(property)->core;
+    if (core.isValueTypeVirtual() || core.isEnum() || !core.isWritable() || core.propType != QMetaType::QReal)
+        return -1;
+    return core.coreIndex;
+}
+
 void QQuickAnimationPropertyUpdater::setValue(qreal v)
 {
     bool deleted = false;
     wasDeleted = &deleted;
     if (reverse)
         v = 1 - v;
+
+    // Resolve the properties once per loop so intermediate steps of number
+    // animations can skip the QVariant round trip in QQmlPropertyPrivate::write.
+    if (!fromSourced || realIndexes.count() != actions.count()) {
+        realIndexes.resize(actions.count());
+        for (int ii = 0; ii < actions.count(); ++ii)
+            realIndexes[ii] = interpolatorType == QMetaType::QReal ? QQuickPropertyAnimationPrivate::directRealIndex(actions.at(ii).property) : -1;
+    }
+
     for (int ii = 0; ii < actions.count(); ++ii) {
         QQuickStateAction &action = actions[ii];
 
+        if (v != 1. && realIndexes.at(ii) != -1) {
+            if (!fromSourced && !fromDefined) {
+                action.fromValue = action.property.read();
+                QQuickPropertyAnimationPrivate::convertVariant(action.fromValue, interpolatorType);
+            }
+            if (action.fromValue.userType() == QMetaType::QReal && action.toValue.userType() == QMetaType::QReal) {
+                const qreal from = *reinterpret_cast<const qreal *>(action.fromValue.constData());
+                const qreal to = *reinterpret_cast<const qreal *>(action.toValue.constData());
+                qreal value = from + (to - from) * v;
+                int status = -1;
+                int flags = QQmlPropertyPrivate::BypassInterceptor | QQmlPropertyPrivate::DontRemoveBinding;
+                void *a[] = { &value, 0, &status, &flags };
+                QMetaObject::metacall(action.property.object(), QMetaObject::WriteProperty, realIndexes.at(ii), a);
+                if (deleted)
+                    return;
+                continue;
+            }
+        }
+
         if (v == 1.) {
             QQmlPropertyPrivate::write(action.property, action.toValue, QQmlPropertyPrivate::BypassInterceptor | QQmlPropertyPrivate::DontRemoveBinding);
         } else {
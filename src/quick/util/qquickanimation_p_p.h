@@ -66,6 +66,7 @@
 
 #include <private/qobject_p.h>
 #include "private/qanimationgroupjob_p.h"
+#include <QtCore/qvector.h>
 #include <QDebug>
 
 #include <private/qobject_p.h>
@@ -288,6 +289,7 @@ public:
 
     static QVariant interpolateVariant(const QVariant &from, const QVariant &to, qreal progress);
     static void convertVariant(QVariant &variant, int type);
+    static int directRealIndex(const QQmlProperty &property);
 };
 
 class QQuickRotationAnimationPrivate : public QQuickPropertyAnimationPrivate
@@ -308,6 +310,7 @@ public:
     void setValue(qreal v);
 
     QQuickStateActions actions;
+    QVector<int> realIndexes;   //core index of plain qreal properties, -1 otherwise
     int interpolatorType;       //for Number/ColorAnimation
     QVariantAnimation::Interpolator interpolator;
     int prevInterpolatorType;   //for generic
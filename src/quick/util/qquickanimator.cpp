@@ -221,8 +221,9 @@ void QQuickAnimatorPrivate::apply(QQuickAnimatorJob *job,
                                      QQuickStateActions &actions,
                                      QQmlProperties &modified)
 {
-
-    if (actions.size()) {
+    // Animators which do not map to a single property, like PathAnimator,
+    // always animate their own target.
+    if (actions.size() && !propertyName.isEmpty()) {
         for (int i=0; i<actions.size(); ++i) {
             QQuickStateAction &action = actions[i];
             if (action.property.name() != propertyName)
@@ -570,4 +571,244 @@ QQuickAnimatorJob *QQuickUniformAnimator::createJob() const
     return job;
 }
 
+/*!
+    \qmltype PathAnimator
+    \instantiates QQuickPathAnimator
+    \inqmlmodule QtQuick
+    \since 5.4
+    \ingroup qtquick-transitions-animations
+    \brief The PathAnimator type animates an Item along a path.
+
+    \l{Animator} types are different from normal Animation types. When
+    using an Animator, the animation can be run in the render thread
+    and the property value will jump to the end when the animation is
+    complete.
+
+    PathAnimator moves its target along \l path like \l PathAnimation,
+    but samples the path when the animation starts and updates the
+    item's transform on the render thread. The values of Item::x,
+    Item::y and, unless \l orientation is \c PathAnimator.Fixed,
+    Item::rotation are updated after the animation has finished.
+
+    The \l {Animator::from}{from} and \l {Animator::to}{to} properties
+    hold the progress along the path, from 0 to 1 by default.
+
+    \qml
+    PathAnimator {
+        target: box
+        duration: 2000
+        orientation: PathAnimator.RightFirst
+        path: Path {
+            startX: 50; startY: 50
+            PathCubic {
+                x: 350; y: 50
+                control1X: 150; control1Y: -50
+                control2X: 250; control2Y: 150
+            }
+        }
+    }
+    \endqml
+
+    Changes to the path while the animation is running do not affect it.
+
+    \sa PathAnimation
+ */
+
+QQuickPathAnimator::QQuickPathAnimator(QObject *parent)
+    : QQuickAnimator(*new QQuickPathAnimatorPrivate, parent)
+{
+}
+
+/*!
+    \qmlproperty Path QtQuick::PathAnimator::path
+    This property holds the path to animate along.
+
+    If the path does not define a start point, it starts at the position
+    of the target when the animation starts.
+ */
+QQuickPath *QQuickPathAnimator::path() const
+{
+    Q_D(const QQuickPathAnimator);
+    return d->path;
+}
+
+void QQuickPathAnimator::setPath(QQuickPath *path)
+{
+    Q_D(QQuickPathAnimator);
+    if (d->path == path)
+        return;
+    d->path = path;
+    Q_EMIT pathChanged(path);
+}
+
+/*!
+    \qmlproperty enumeration QtQuick::PathAnimator::orientation
+    This property controls the rotation of the item as it animates along the path.
+
+    \list
+    \li PathAnimator.Fixed (default) - the rotation of the item is not changed.
+    \li PathAnimator.RightFirst - The right side of the item will lead along the path.
+    \li PathAnimator.LeftFirst - The left side of the item will lead along the path.
+    \li PathAnimator.BottomFirst - The bottom of the item will lead along the path.
+    \li PathAnimator.TopFirst - The top of the item will lead along the path.
+    \endlist
+ */
+QQuickPathAnimator::Orientation QQuickPathAnimator::orientation() const
+{
+    Q_D(const QQuickPathAnimator);
+    return d->orientation;
+}
+
+void QQuickPathAnimator::setOrientation(Orientation orientation)
+{
+    Q_D(QQuickPathAnimator);
+    if (d->orientation == orientation)
+        return;
+    d->orientation = orientation;
+    Q_EMIT orientationChanged(orientation);
+}
+
+/*!
+    \qmlproperty point QtQuick::PathAnimator::anchorPoint
+    This property holds the point of the item which is kept on the path.
+
+    The default is the top left corner of the item. When the item is rotated
+    to follow the path, it rotates around this point.
+ */
+QPointF QQuickPathAnimator::anchorPoint() const
+{
+    Q_D(const QQuickPathAnimator);
+    return d->anchorPoint;
+}
+
+void QQuickPathAnimator::setAnchorPoint(const QPointF &point)
+{
+    Q_D(QQuickPathAnimator);
+    if (d->anchorPoint == point)
+        return;
+    d->anchorPoint = point;
+    Q_EMIT anchorPointChanged(point);
+}
+
+QQuickAnimatorJob *QQuickPathAnimator::createJob() const
+{
+    Q_D(const QQuickPathAnimator);
+    if (!d->path)
+        return 0;
+
+    QQuickPathAnimatorJob *job = new QQuickPathAnimatorJob();
+    job->setPath(d->path);
+    job->setOrientation(d->orientation);
+    job->setAnchorPoint(d->anchorPoint);
+    return job;
+}
+
+/*!
+    \qmltype ColorAnimator
+    \instantiates QQuickColorAnimator
+    \inqmlmodule QtQuick
+    \since 5.4
+    \ingroup qtquick-transitions-animations
+    \brief The ColorAnimator type animates the color of a Rectangle.
+
+    \l{Animator} types are different from normal Animation types. When
+    using an Animator, the animation can be run in the render thread
+    and the property value will jump to the end when the animation is
+    complete.
+
+    The value of Rectangle::color is updated after the animation has
+    finished. The target must be a \l Rectangle without a gradient.
+
+    \qml
+    Rectangle {
+        width: 100; height: 100
+        ColorAnimator on color { from: "red"; to: "blue"; duration: 1000 }
+    }
+    \endqml
+
+    \sa ColorAnimation
+ */
+
+QQuickColorAnimator::QQuickColorAnimator(QObject *parent)
+    : QQuickAnimator(*new QQuickColorAnimatorPrivate, parent)
+{
+}
+
+/*!
+    \qmlproperty color QtQuick::ColorAnimator::from
+    This property holds the color value at which the animation should begin.
+
+    If it is not set, the animation starts at the current color of the target.
+ */
+QColor QQuickColorAnimator::from() const
+{
+    Q_D(const QQuickColorAnimator);
+    return d->colorFrom;
+}
+
+void QQuickColorAnimator::setFrom(const QColor &from)
+{
+    Q_D(QQuickColorAnimator);
+    d->isFromDefined = true;
+    d->colorFrom = from;
+}
+
+/*!
+    \qmlproperty color QtQuick::ColorAnimator::to
+    This property holds the color value at which the animation should end.
+ */
+QColor QQuickColorAnimator::to() const
+{
+    Q_D(const QQuickColorAnimator);
+    return d->colorTo;
+}
+
+void QQuickColorAnimator::setTo(const QColor &to)
+{
+    Q_D(QQuickColorAnimator);
+    d->isToDefined = true;
+    d->colorTo = to;
+}
+
+QQuickAnimatorJob *QQuickColorAnimator::createJob() const
+{
+    Q_D(const QQuickColorAnimator);
+    QQuickColorAnimatorJob *job = new QQuickColorAnimatorJob();
+    if (d->isFromDefined)
+        job->setFromColor(d->colorFrom);
+    if (d->isToDefined)
+        job->setToColor(d->colorTo);
+    return job;
+}
+
+QAbstractAnimationJob *QQuickColorAnimator::transition(QQuickStateActions &actions,
+                                                       QQmlProperties &modified,
+                                                       TransitionDirection direction,
+                                                       QObject *defaultTarget)
+{
+    Q_D(QQuickColorAnimator);
+
+    // Pick up the colors of the transition before QQuickAnimator::transition()
+    // resets the action's from value.
+    QColor from = d->colorFrom;
+    QColor to = d->colorTo;
+    for (int i = 0; i < actions.size(); ++i) {
+        const QQuickStateAction &action = actions.at(i);
+        if (action.property.name() != propertyName())
+            continue;
+        if (!d->isFromDefined)
+            from = action.fromValue.isValid() ? action.fromValue.value<QColor>() : action.property.read().value<QColor>();
+        if (!d->isToDefined)
+            to = action.toValue.isValid() ? action.toValue.value<QColor>() : action.property.read().value<QColor>();
+    }
+
+    QAbstractAnimationJob *job = QQuickAnimator::transition(actions, modified, direction, defaultTarget);
+    if (job && actions.size()) {
+        QQuickColorAnimatorJob *colorJob = static_cast<QQuickColorAnimatorJob *>(job);
+        colorJob->setFromColor(from);
+        colorJob->setToColor(to);
+    }
+    return job;
+}
+
 QT_END_NAMESPACE
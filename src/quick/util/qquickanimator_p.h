@@ -47,6 +47,7 @@
 QT_BEGIN_NAMESPACE
 
 class QQuickItem;
+class QQuickPath;
 
 class QQuickAnimatorJob;
 class QQuickAnimatorPrivate;
@@ -183,6 +184,67 @@ protected:
     QString propertyName() const;
 };
 
+class QQuickPathAnimatorPrivate;
+class Q_QUICK_PRIVATE_EXPORT QQuickPathAnimator : public QQuickAnimator
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QQuickPathAnimator)
+    Q_PROPERTY(QQuickPath *path READ path WRITE setPath NOTIFY pathChanged)
+    Q_PROPERTY(Orientation orientation READ orientation WRITE setOrientation NOTIFY orientationChanged)
+    Q_PROPERTY(QPointF anchorPoint READ anchorPoint WRITE setAnchorPoint NOTIFY anchorPointChanged)
+
+    Q_ENUMS(Orientation)
+
+public:
+    enum Orientation { Fixed, RightFirst, LeftFirst, BottomFirst, TopFirst };
+
+    QQuickPathAnimator(QObject *parent = 0);
+
+    QQuickPath *path() const;
+    void setPath(QQuickPath *path);
+
+    Orientation orientation() const;
+    void setOrientation(Orientation orientation);
+
+    QPointF anchorPoint() const;
+    void setAnchorPoint(const QPointF &point);
+
+Q_SIGNALS:
+    void pathChanged(QQuickPath *path);
+    void orientationChanged(Orientation orientation);
+    void anchorPointChanged(const QPointF &point);
+
+protected:
+    QQuickAnimatorJob *createJob() const;
+    QString propertyName() const { return QString(); }
+};
+
+class QQuickColorAnimatorPrivate;
+class Q_QUICK_PRIVATE_EXPORT QQuickColorAnimator : public QQuickAnimator
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QQuickColorAnimator)
+    Q_PROPERTY(QColor from READ from WRITE setFrom)
+    Q_PROPERTY(QColor to READ to WRITE setTo)
+
+public:
+    QQuickColorAnimator(QObject *parent = 0);
+
+    QColor from() const;
+    void setFrom(const QColor &from);
+
+    QColor to() const;
+    void setTo(const QColor &to);
+
+protected:
+    QQuickAnimatorJob *createJob() const;
+    QString propertyName() const { return QStringLiteral("color"); }
+    QAbstractAnimationJob *transition(QQuickStateActions &actions,
+                                      QQmlProperties &modified,
+                                      TransitionDirection,
+                                      QObject *);
+};
+
 QT_END_NAMESPACE
 
 QML_DECLARE_TYPE(QQuickAnimator)
@@ -192,5 +254,7 @@ QML_DECLARE_TYPE(QQuickScaleAnimator)
 QML_DECLARE_TYPE(QQuickRotationAnimator)
 QML_DECLARE_TYPE(QQuickOpacityAnimator)
 QML_DECLARE_TYPE(QQuickUniformAnimator)
+QML_DECLARE_TYPE(QQuickPathAnimator)
+QML_DECLARE_TYPE(QQuickColorAnimator)
 
 #endif // QQUICKANIMATOR_P_H
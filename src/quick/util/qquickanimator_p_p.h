@@ -45,6 +45,7 @@
 #include "qquickanimator_p.h"
 #include "qquickanimation_p_p.h"
 #include <QtQuick/qquickitem.h>
+#include <private/qquickpath_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -92,6 +93,26 @@ public:
     QString uniform;
 };
 
+class QQuickPathAnimatorPrivate : public QQuickAnimatorPrivate
+{
+public:
+    QQuickPathAnimatorPrivate()
+        : orientation(QQuickPathAnimator::Fixed)
+    {
+        to = 1;
+    }
+    QPointer<QQuickPath> path;
+    QQuickPathAnimator::Orientation orientation;
+    QPointF anchorPoint;
+};
+
+class QQuickColorAnimatorPrivate : public QQuickAnimatorPrivate
+{
+public:
+    QColor colorFrom;
+    QColor colorTo;
+};
+
 QT_END_NAMESPACE
 
 #endif // QQUICKANIMATOR_P_P_H
@@ -46,6 +46,8 @@
 #include <private/qquickwindow_p.h>
 #include <private/qquickitem_p.h>
 #include <private/qquickshadereffectnode_p.h>
+#include <private/qquickrectangle_p.h>
+#include <private/qsgadaptationlayer_p.h>
 
 #include <private/qanimationgroupjob_p.h>
 
@@ -73,7 +75,8 @@ QQuickAnimatorProxyJob::QQuickAnimatorProxyJob(QAbstractAnimationJob *job, QObje
     // be negligiblie compared to animating and re-rendering the scene on the render thread.
     m_duration = -1;
 
-    QObject *ctx = findAnimationContext(m_animation);
+    // Items can drive render thread jobs of their own, without an animation.
+    QObject *ctx = m_animation ? findAnimationContext(m_animation) : item;
     if (!ctx) {
         qWarning("QtQuick: unable to find animation context for RT animation...");
         return;
@@ -533,6 +536,34 @@ void QQuickRotationAnimatorJob::writeBack()
         m_target->setRotation(value());
 }
 
+QQuickFlickAnimatorJob::QQuickFlickAnimatorJob()
+    : m_orientation(Qt::Vertical)
+    , m_velocity(0)
+    , m_acceleration(0)
+    , m_pixelAligned(false)
+{
+}
+
+void QQuickFlickAnimatorJob::updateCurrentTime(int time)
+{
+    if (!m_controller)
+        return;
+    Q_ASSERT(m_controller->m_window->openglContext()->thread() == QThread::currentThread());
+
+    qreal t = time / 1000.0;
+    m_value = m_from + m_velocity * t + 0.5 * m_acceleration * t * t;
+    if (time >= m_duration)
+        m_value = m_to;
+    if (m_pixelAligned)
+        m_value = -qRound(-m_value);
+
+    if (m_orientation == Qt::Horizontal)
+        m_helper->dx = m_value;
+    else
+        m_helper->dy = m_value;
+    m_helper->wasChanged = true;
+}
+
 QQuickUniformAnimatorJob::QQuickUniformAnimatorJob()
     : m_node(0)
     , m_uniformIndex(-1)
@@ -603,4 +634,205 @@ void QQuickUniformAnimatorJob::writeBack()
         m_target->setProperty(m_uniform, value());
 }
 
+QQuickPathAnimatorJob::QQuickPathAnimatorJob()
+    : m_orientation(QQuickPathAnimator::Fixed)
+    , m_rotation(0)
+{
+    m_to = 1;
+}
+
+void QQuickPathAnimatorJob::initialize(QQuickAnimatorController *controller)
+{
+    QQuickTransformAnimatorJob::initialize(controller);
+    if (m_controller)
+        samplePath();
+}
+
+void QQuickPathAnimatorJob::samplePath()
+{
+    m_points.clear();
+    m_angles.clear();
+    if (!m_path)
+        return;
+
+    // Like PathAnimation, a path without a start point starts at the
+    // current position of the target.
+    QPainterPath painterPath;
+    qreal pathLength = 0;
+    QList<QQuickPath::AttributePoint> attributePoints;
+    QQuickCachedBezier prevBez;
+    bool fromTarget = !m_path->hasStartX() || !m_path->hasStartY();
+    if (fromTarget) {
+        QPointF start = m_target->position() + m_anchorPoint;
+        painterPath = m_path->createPath(start, start, QStringList(), pathLength, attributePoints);
+    } else {
+        m_path->invalidateSequentialHistory();
+        pathLength = m_path->path().length();
+    }
+
+    int segments = qBound(32, int(pathLength / 2), 1024);
+    m_points.resize(segments + 1);
+    m_angles.resize(segments + 1);
+    for (int i = 0; i <= segments; ++i) {
+        qreal p = i / qreal(segments);
+        qreal angle = 0;
+        m_points[i] = fromTarget
+                ? QQuickPath::sequentialPointAt(painterPath, pathLength, attributePoints, prevBez, p, &angle)
+                : m_path->sequentialPointAt(p, &angle);
+
+        switch (m_orientation) {
+        case QQuickPathAnimator::RightFirst:
+            angle = -angle;
+            break;
+        case QQuickPathAnimator::TopFirst:
+            angle = -angle + 90;
+            break;
+        case QQuickPathAnimator::LeftFirst:
+            angle = -angle + 180;
+            break;
+        case QQuickPathAnimator::BottomFirst:
+            angle = -angle + 270;
+            break;
+        default:
+            angle = 0;
+            break;
+        }
+
+        // Keep the angles continuous, so that interpolating between two
+        // samples never spins the item around.
+        if (i > 0) {
+            qreal previous = m_angles.at(i - 1);
+            while (angle - previous > 180)
+                angle -= 360;
+            while (angle - previous < -180)
+                angle += 360;
+        } else if (m_orientation != QQuickPathAnimator::Fixed) {
+            // Take the shortest way from the current rotation of the target.
+            qreal current = m_target->rotation();
+            while (angle - current > 180)
+                angle -= 360;
+            while (angle - current < -180)
+                angle += 360;
+        }
+        m_angles[i] = angle;
+    }
+}
+
+void QQuickPathAnimatorJob::updateCurrentTime(int time)
+{
+    if (!m_controller || m_points.isEmpty())
+        return;
+    Q_ASSERT(m_controller->m_window->openglContext()->thread() == QThread::currentThread());
+
+    m_value = m_from + (m_to - m_from) * m_easing.valueForProgress(time / (qreal) m_duration);
+
+    qreal p = qBound<qreal>(0, m_value, 1) * (m_points.size() - 1);
+    int i = qMin(int(p), m_points.size() - 2);
+    qreal t = p - i;
+    m_position = m_points.at(i) * (1 - t) + m_points.at(i + 1) * t - m_anchorPoint;
+    m_helper->dx = m_position.x();
+    m_helper->dy = m_position.y();
+
+    if (m_orientation != QQuickPathAnimator::Fixed) {
+        m_rotation = m_angles.at(i) * (1 - t) + m_angles.at(i + 1) * t;
+        m_helper->rotation = m_rotation;
+        if (!m_anchorPoint.isNull()) {
+            m_helper->ox = m_anchorPoint.x();
+            m_helper->oy = m_anchorPoint.y();
+        }
+    }
+    m_helper->wasChanged = true;
+}
+
+void QQuickPathAnimatorJob::writeBack()
+{
+    if (!m_target)
+        return;
+
+    m_controller->lock();
+    QPointF position = m_position;
+    qreal rotation = m_rotation;
+    m_controller->unlock();
+
+    m_target->setPosition(position);
+    if (m_orientation != QQuickPathAnimator::Fixed) {
+        if (!m_anchorPoint.isNull())
+            m_target->setTransformOriginPoint(m_anchorPoint);
+        m_target->setRotation(rotation);
+    }
+}
+
+QQuickColorAnimatorJob::QQuickColorAnimatorJob()
+    : m_node(0)
+{
+}
+
+void QQuickColorAnimatorJob::setTarget(QQuickItem *target)
+{
+    if (qobject_cast<QQuickRectangle *>(target) != 0)
+        m_target = target;
+}
+
+void QQuickColorAnimatorJob::initialize(QQuickAnimatorController *controller)
+{
+    QQuickAnimatorJob::initialize(controller);
+
+    // Undefined end points animate from or to the current color.
+    QColor current = static_cast<QQuickRectangle *>(m_target)->color();
+    if (!m_fromColor.isValid())
+        m_fromColor = current;
+    if (!m_toColor.isValid())
+        m_toColor = current;
+    m_color = m_fromColor;
+}
+
+void QQuickColorAnimatorJob::nodeWasDestroyed()
+{
+    m_node = 0;
+}
+
+void QQuickColorAnimatorJob::afterNodeSync()
+{
+    // A fully transparent rectangle has no node; the color is then only
+    // written back when the animation ends.
+    m_node = static_cast<QSGRectangleNode *>(QQuickItemPrivate::get(m_target)->paintNode);
+
+    // The sync may have reset the node to the color of the item.
+    if (m_node && isRunning()) {
+        m_node->setColor(m_color);
+        m_node->update();
+    }
+}
+
+void QQuickColorAnimatorJob::updateCurrentTime(int time)
+{
+    if (!m_controller)
+        return;
+    Q_ASSERT(m_controller->m_window->openglContext()->thread() == QThread::currentThread());
+
+    m_value = m_easing.valueForProgress(time / (qreal) m_duration);
+    qreal t = m_value;
+    m_color = QColor::fromRgbF(m_fromColor.redF() + (m_toColor.redF() - m_fromColor.redF()) * t,
+                               m_fromColor.greenF() + (m_toColor.greenF() - m_fromColor.greenF()) * t,
+                               m_fromColor.blueF() + (m_toColor.blueF() - m_fromColor.blueF()) * t,
+                               m_fromColor.alphaF() + (m_toColor.alphaF() - m_fromColor.alphaF()) * t);
+
+    if (m_node) {
+        m_node->setColor(m_color);
+        m_node->update();
+    }
+}
+
+void QQuickColorAnimatorJob::writeBack()
+{
+    if (!m_target)
+        return;
+
+    m_controller->lock();
+    QColor color = m_color;
+    m_controller->unlock();
+
+    static_cast<QQuickRectangle *>(m_target)->setColor(color);
+}
+
 QT_END_NAMESPACE
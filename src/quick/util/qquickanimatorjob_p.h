@@ -44,11 +44,15 @@
 
 #include <private/qabstractanimationjob_p.h>
 #include <private/qquickanimator_p.h>
+#include <private/qquickpath_p.h>
 #include <private/qtquickglobal_p.h>
 
 #include <QtQuick/qquickitem.h>
 
 #include <QtCore/qeasingcurve.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qvector.h>
+#include <QtGui/qcolor.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -62,6 +66,7 @@ class QQuickAnimatorProxyJobPrivate;
 class QQuickShaderEffectNode;
 
 class QSGOpacityNode;
+class QSGRectangleNode;
 
 class Q_QUICK_PRIVATE_EXPORT QQuickAnimatorProxyJob : public QObject, public QAbstractAnimationJob
 {
@@ -132,6 +137,7 @@ public:
 
     virtual void targetWasDeleted();
     virtual void initialize(QQuickAnimatorController *controller);
+    virtual void afterNodeSync() { }
     virtual void writeBack() = 0;
     virtual void nodeWasDestroyed() = 0;
 
@@ -253,6 +259,37 @@ private:
     QQuickRotationAnimator::RotationDirection m_direction;
 };
 
+// Moves the target along the same decelerating curve as QQuickTimeLine::accel().
+// Used by Flickable to keep a fling going on the render thread while the
+// GUI thread is busy; the GUI side stays in charge of the real content
+// position, so nothing is written back.
+class Q_QUICK_PRIVATE_EXPORT QQuickFlickAnimatorJob : public QQuickTransformAnimatorJob
+{
+public:
+    QQuickFlickAnimatorJob();
+
+    void setOrientation(Qt::Orientation orientation) { m_orientation = orientation; }
+    Qt::Orientation orientation() const { return m_orientation; }
+
+    void setVelocity(qreal velocity) { m_velocity = velocity; }
+    qreal velocity() const { return m_velocity; }
+
+    void setAcceleration(qreal acceleration) { m_acceleration = acceleration; }
+    qreal acceleration() const { return m_acceleration; }
+
+    void setPixelAligned(bool aligned) { m_pixelAligned = aligned; }
+    bool pixelAligned() const { return m_pixelAligned; }
+
+    void updateCurrentTime(int time);
+    void writeBack() { }
+
+private:
+    Qt::Orientation m_orientation;
+    qreal m_velocity;
+    qreal m_acceleration;
+    bool m_pixelAligned;
+};
+
 class Q_QUICK_PRIVATE_EXPORT QQuickOpacityAnimatorJob : public QQuickAnimatorJob
 {
 public:
@@ -291,6 +328,58 @@ private:
     int m_uniformType : 8;
 };
 
+class Q_QUICK_PRIVATE_EXPORT QQuickPathAnimatorJob : public QQuickTransformAnimatorJob
+{
+public:
+    QQuickPathAnimatorJob();
+
+    void setPath(QQuickPath *path) { m_path = path; }
+    void setOrientation(QQuickPathAnimator::Orientation orientation) { m_orientation = orientation; }
+    void setAnchorPoint(const QPointF &point) { m_anchorPoint = point; }
+
+    void initialize(QQuickAnimatorController *controller);
+    void updateCurrentTime(int time);
+    void writeBack();
+
+private:
+    void samplePath();
+
+    QPointer<QQuickPath> m_path;
+    QQuickPathAnimator::Orientation m_orientation;
+    QPointF m_anchorPoint;
+
+    // The path is sampled during sync, as QQuickPath can only be used
+    // while the GUI thread is blocked.
+    QVector<QPointF> m_points;
+    QVector<qreal> m_angles;
+
+    QPointF m_position;
+    qreal m_rotation;
+};
+
+class Q_QUICK_PRIVATE_EXPORT QQuickColorAnimatorJob : public QQuickAnimatorJob
+{
+public:
+    QQuickColorAnimatorJob();
+
+    void setTarget(QQuickItem *target);
+
+    void setFromColor(const QColor &color) { m_fromColor = color; }
+    void setToColor(const QColor &color) { m_toColor = color; }
+
+    void initialize(QQuickAnimatorController *controller);
+    void afterNodeSync();
+    void updateCurrentTime(int time);
+    void writeBack();
+    void nodeWasDestroyed();
+
+private:
+    QSGRectangleNode *m_node;
+    QColor m_fromColor;
+    QColor m_toColor;
+    QColor m_color;
+};
+
 QT_END_NAMESPACE
 
 #endif // QQUICKANIMATORJOB_P_H
@@ -0,0 +1,637 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qquickcompressedtexture_p.h"
+
+#include <QtQuick/private/qsgtexture_p.h>
+
+#include <QtGui/qopenglcontext.h>
+#include <QtGui/qopenglfunctions.h>
+#include <QtCore/qendian.h>
+#include <QtCore/qiodevice.h>
+#include <QtCore/qdebug.h>
+
+QT_BEGIN_NAMESPACE
+
+#ifndef GL_ETC1_RGB8_OES
+#define GL_ETC1_RGB8_OES                                0x8D64
+#endif
+
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2                         0x9274
+#define GL_COMPRESSED_SRGB8_ETC2                        0x9275
+#define GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2     0x9276
+#define GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2    0x9277
+#define GL_COMPRESSED_RGBA8_ETC2_EAC                    0x9278
+#define GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC             0x9279
+#endif
+
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT                 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT                0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT                0x83F2
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT                0x83F3
+#endif
+
+#ifndef GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+#define GL_COMPRESSED_RGBA_ASTC_4x4_KHR                 0x93B0
+#define GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR         0x93D0
+#endif
+
+static const char ktxIdentifier[12] = { '\xAB', 'K', 'T', 'X', ' ', '1', '1', '\xBB', '\r', '\n', '\x1A', '\n' };
+
+// Block dimensions of the ASTC formats, in the order of their enums.
+static const int astcBlockSizes[14][2] = {
+    { 4, 4 }, { 5, 4 }, { 5, 5 }, { 6, 5 }, { 6, 6 }, { 8, 5 }, { 8, 6 },
+    { 8, 8 }, { 10, 5 }, { 10, 6 }, { 10, 8 }, { 10, 10 }, { 12, 10 }, { 12, 12 }
+};
+
+static bool blockInfo(uint format, int *blockWidth, int *blockHeight, int *blockBytes)
+{
+    *blockWidth = 4;
+    *blockHeight = 4;
+    switch (format) {
+    case GL_ETC1_RGB8_OES:
+    case GL_COMPRESSED_RGB8_ETC2:
+    case GL_COMPRESSED_SRGB8_ETC2:
+    case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+    case GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+    case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+        *blockBytes = 8;
+        return true;
+    case GL_COMPRESSED_RGBA8_ETC2_EAC:
+    case GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC:
+    case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        *blockBytes = 16;
+        return true;
+    default:
+        break;
+    }
+
+    int astc = -1;
+    if (format >= GL_COMPRESSED_RGBA_ASTC_4x4_KHR && format < GL_COMPRESSED_RGBA_ASTC_4x4_KHR + 14)
+        astc = format - GL_COMPRESSED_RGBA_ASTC_4x4_KHR;
+    else if (format >= GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR && format < GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR + 14)
+        astc = format - GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR;
+    if (astc < 0)
+        return false;
+
+    *blockWidth = astcBlockSizes[astc][0];
+    *blockHeight = astcBlockSizes[astc][1];
+    *blockBytes = 16;
+    return true;
+}
+
+static int compressedSize(uint format, const QSize &size)
+{
+    int blockWidth, blockHeight, blockBytes;
+    if (!blockInfo(format, &blockWidth, &blockHeight, &blockBytes) || size.isEmpty())
+        return 0;
+    return ((size.width() + blockWidth - 1) / blockWidth)
+            * ((size.height() + blockHeight - 1) / blockHeight)
+            * blockBytes;
+}
+
+static bool hasAlpha(uint format)
+{
+    return format != GL_ETC1_RGB8_OES
+            && format != GL_COMPRESSED_RGB8_ETC2
+            && format != GL_COMPRESSED_SRGB8_ETC2
+            && format != GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+}
+
+static bool hasEtc2(QOpenGLContext *context)
+{
+    if (context->hasExtension(QByteArrayLiteral("GL_ARB_ES3_compatibility")))
+        return true;
+#ifdef QT_OPENGL_ES_2
+    return context->format().majorVersion() >= 3;
+#else
+    return false;
+#endif
+}
+
+/*
+    Returns the format to upload data of \a format with in \a context, or 0 if the context
+    can't sample from it.
+*/
+static uint uploadFormat(QOpenGLContext *context, uint format)
+{
+    switch (format) {
+    case GL_ETC1_RGB8_OES:
+        if (context->hasExtension(QByteArrayLiteral("GL_OES_compressed_ETC1_RGB8_texture")))
+            return format;
+        // ETC1 data is valid ETC2 data.
+        return hasEtc2(context) ? GL_COMPRESSED_RGB8_ETC2 : 0;
+    case GL_COMPRESSED_RGB8_ETC2:
+    case GL_COMPRESSED_SRGB8_ETC2:
+    case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+    case GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+    case GL_COMPRESSED_RGBA8_ETC2_EAC:
+    case GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC:
+        return hasEtc2(context) ? format : 0;
+    case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+        if (context->hasExtension(QByteArrayLiteral("GL_EXT_texture_compression_dxt1")))
+            return format;
+        // fall through
+    case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        return context->hasExtension(QByteArrayLiteral("GL_EXT_texture_compression_s3tc")) ? format : 0;
+    default:
+        return context->hasExtension(QByteArrayLiteral("GL_KHR_texture_compression_astc_ldr")) ? format : 0;
+    }
+}
+
+static const int etc1Modifiers[8][2] = {
+    { 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }, { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 }
+};
+
+static void decodeEtc1Block(const uchar *block, QRgb *pixels)
+{
+    const quint32 high = qFromBigEndian<quint32>(block);
+    const quint32 low = qFromBigEndian<quint32>(block + 4);
+
+    int base[2][3];
+    if (high & 2) {
+        // Differential mode, a 5 bit base color and a 3 bit signed offset for the second one.
+        for (int c = 0; c < 3; ++c) {
+            const int shift = 27 - c * 8;
+            const int value = (high >> shift) & 0x1f;
+            int delta = (high >> (shift - 3)) & 0x7;
+            if (delta >= 4)
+                delta -= 8;
+            const int second = qBound(0, value + delta, 31);
+            base[0][c] = (value << 3) | (value >> 2);
+            base[1][c] = (second << 3) | (second >> 2);
+        }
+    } else {
+        // Individual mode, two 4 bit colors.
+        for (int c = 0; c < 3; ++c) {
+            const int shift = 28 - c * 8;
+            base[0][c] = ((high >> shift) & 0xf) * 17;
+            base[1][c] = ((high >> (shift - 4)) & 0xf) * 17;
+        }
+    }
+
+    const int tables[2] = { int(high >> 5) & 7, int(high >> 2) & 7 };
+    const bool flip = high & 1;
+    for (int x = 0; x < 4; ++x) {
+        for (int y = 0; y < 4; ++y) {
+            const int i = x * 4 + y;
+            const int subBlock = flip ? y / 2 : x / 2;
+            const int index = ((low >> (i + 15)) & 2) | ((low >> i) & 1);
+            const int modifier = etc1Modifiers[tables[subBlock]][index & 1];
+            const int delta = index & 2 ? -modifier : modifier;
+            pixels[y * 4 + x] = qRgb(qBound(0, base[subBlock][0] + delta, 255),
+                                     qBound(0, base[subBlock][1] + delta, 255),
+                                     qBound(0, base[subBlock][2] + delta, 255));
+        }
+    }
+}
+
+static inline QRgb rgb565(quint16 color)
+{
+    const int r = (color >> 11) & 0x1f;
+    const int g = (color >> 5) & 0x3f;
+    const int b = color & 0x1f;
+    return qRgb((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2));
+}
+
+static inline QRgb mixColors(QRgb a, QRgb b, int weightA, int weightB)
+{
+    const int total = weightA + weightB;
+    return qRgb((qRed(a) * weightA + qRed(b) * weightB) / total,
+                (qGreen(a) * weightA + qGreen(b) * weightB) / total,
+                (qBlue(a) * weightA + qBlue(b) * weightB) / total);
+}
+
+enum DxtColorMode { DxtOpaque, DxtPunchThrough, DxtFourColors };
+
+static void decodeDxtColors(const uchar *block, QRgb *pixels, DxtColorMode mode)
+{
+    const quint16 c0 = qFromLittleEndian<quint16>(block);
+    const quint16 c1 = qFromLittleEndian<quint16>(block + 2);
+    QRgb colors[4];
+    colors[0] = rgb565(c0);
+    colors[1] = rgb565(c1);
+    if (c0 > c1 || mode == DxtFourColors) {
+        colors[2] = mixColors(colors[0], colors[1], 2, 1);
+        colors[3] = mixColors(colors[0], colors[1], 1, 2);
+    } else {
+        colors[2] = mixColors(colors[0], colors[1], 1, 1);
+        colors[3] = mode == DxtPunchThrough ? qRgba(0, 0, 0, 0) : qRgb(0, 0, 0);
+    }
+
+    const quint32 indices = qFromLittleEndian<quint32>(block + 4);
+    for (int i = 0; i < 16; ++i)
+        pixels[i] = colors[(indices >> (2 * i)) & 3];
+}
+
+static void decodeDxt1RgbBlock(const uchar *block, QRgb *pixels)
+{
+    decodeDxtColors(block, pixels, DxtOpaque);
+}
+
+static void decodeDxt1RgbaBlock(const uchar *block, QRgb *pixels)
+{
+    decodeDxtColors(block, pixels, DxtPunchThrough);
+}
+
+static void decodeDxt3Block(const uchar *block, QRgb *pixels)
+{
+    decodeDxtColors(block + 8, pixels, DxtFourColors);
+    const quint64 alpha = qFromLittleEndian<quint64>(block);
+    for (int i = 0; i < 16; ++i)
+        pixels[i] = (pixels[i] & 0x00ffffff) | (uint(((alpha >> (4 * i)) & 0xf) * 17) << 24);
+}
+
+static void decodeDxt5Block(const uchar *block, QRgb *pixels)
+{
+    decodeDxtColors(block + 8, pixels, DxtFourColors);
+
+    int alphas[8];
+    alphas[0] = block[0];
+    alphas[1] = block[1];
+    if (alphas[0] > alphas[1]) {
+        for (int i = 1; i < 7; ++i)
+            alphas[i + 1] = ((7 - i) * alphas[0] + i * alphas[1]) / 7;
+    } else {
+        for (int i = 1; i < 5; ++i)
+            alphas[i + 1] = ((5 - i) * alphas[0] + i * alphas[1]) / 5;
+        alphas[6] = 0;
+        alphas[7] = 255;
+    }
+
+    quint64 indices = 0;
+    for (int i = 0; i < 6; ++i)
+        indices |= quint64(block[2 + i]) << (8 * i);
+    for (int i = 0; i < 16; ++i)
+        pixels[i] = (pixels[i] & 0x00ffffff) | (uint(alphas[(indices >> (3 * i)) & 7]) << 24);
+}
+
+static QImage decodeBlocks(const uchar *data, const QSize &size, QImage::Format imageFormat,
+                           int blockBytes, void (*decodeBlock)(const uchar *, QRgb *))
+{
+    QImage image(size, imageFormat);
+    QRgb pixels[16];
+    for (int by = 0; by < size.height(); by += 4) {
+        for (int bx = 0; bx < size.width(); bx += 4) {
+            decodeBlock(data, pixels);
+            data += blockBytes;
+            for (int y = 0; y < 4 && by + y < size.height(); ++y) {
+                QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(by + y)) + bx;
+                for (int x = 0; x < 4 && bx + x < size.width(); ++x)
+                    line[x] = pixels[y * 4 + x];
+            }
+        }
+    }
+    return image;
+}
+
+class QSGCompressedTexture : public QSGTexture
+{
+public:
+    QSGCompressedTexture(const QByteArray &data, const QVector<QQuickCompressedTextureFactory::Level> &levels,
+                         uint format, const QSize &size, bool alpha)
+        : m_data(data), m_levels(levels), m_format(format), m_size(size), m_textureId(0)
+        , m_hasAlpha(alpha), m_uploaded(false)
+    {
+    }
+
+    ~QSGCompressedTexture()
+    {
+        if (m_textureId)
+            glDeleteTextures(1, &m_textureId);
+    }
+
+    int textureId() const
+    {
+        if (!m_textureId)
+            glGenTextures(1, &const_cast<QSGCompressedTexture *>(this)->m_textureId);
+        return m_textureId;
+    }
+
+    QSize textureSize() const { return m_size; }
+    bool hasAlphaChannel() const { return m_hasAlpha; }
+    bool hasMipmaps() const { return m_levels.count() > 1; }
+
+    void bind()
+    {
+        glBindTexture(GL_TEXTURE_2D, textureId());
+        if (m_uploaded) {
+            updateBindOptions();
+            return;
+        }
+
+        QOpenGLFunctions *functions = QOpenGLContext::currentContext()->functions();
+        for (int i = 0; i < m_levels.count(); ++i) {
+            const QQuickCompressedTextureFactory::Level &level = m_levels.at(i);
+            functions->glCompressedTexImage2D(GL_TEXTURE_2D, i, m_format,
+                                              level.size.width(), level.size.height(), 0,
+                                              level.length, m_data.constData() + level.offset);
+        }
+        updateBindOptions(true);
+
+        // The data is only needed until it is uploaded.
+        m_data = QByteArray();
+        m_uploaded = true;
+    }
+
+private:
+    QByteArray m_data;
+    QVector<QQuickCompressedTextureFactory::Level> m_levels;
+    uint m_format;
+    QSize m_size;
+    GLuint m_textureId;
+    bool m_hasAlpha;
+    bool m_uploaded;
+};
+
+/*!
+    \internal
+    \class QQuickCompressedTextureFactory
+
+    Creates textures from GPU compressed image data in KTX, PKM or DDS container files, which
+    are uploaded as they are instead of being decoded to an image.  This saves both the time
+    to decode the image and most of the memory it would take on the GPU.
+
+    If the OpenGL context can't sample from the compressed format, ETC1 and S3TC (DXT) data is
+    decoded on the CPU instead.  Like all textures in the scene graph, data with an alpha
+    channel is expected to have premultiplied alpha.
+*/
+
+QQuickCompressedTextureFactory::QQuickCompressedTextureFactory()
+    : m_format(0)
+{
+}
+
+/*!
+    Returns true if \a device contains a compressed texture container, without reading from it.
+*/
+bool QQuickCompressedTextureFactory::canRead(QIODevice *device)
+{
+    const QByteArray header = device->peek(sizeof(ktxIdentifier));
+    return header.startsWith(QByteArray::fromRawData(ktxIdentifier, sizeof(ktxIdentifier)))
+            || header.startsWith("PKM ")
+            || header.startsWith("DDS ");
+}
+
+/*!
+    Reads the compressed texture in \a device.  Returns 0 and sets \a errorString if the
+    container is invalid or the format of its data isn't known.
+*/
+QQuickCompressedTextureFactory *QQuickCompressedTextureFactory::read(QIODevice *device, QString *errorString)
+{
+    QQuickCompressedTextureFactory *factory = new QQuickCompressedTextureFactory;
+    factory->m_data = device->readAll();
+
+    bool ok = false;
+    if (factory->m_data.startsWith(QByteArray::fromRawData(ktxIdentifier, sizeof(ktxIdentifier))))
+        ok = factory->readKtx();
+    else if (factory->m_data.startsWith("PKM "))
+        ok = factory->readPkm();
+    else if (factory->m_data.startsWith("DDS "))
+        ok = factory->readDds();
+
+    if (!ok) {
+        if (errorString)
+            *errorString = tr("Unsupported or invalid compressed texture");
+        delete factory;
+        return 0;
+    }
+    return factory;
+}
+
+bool QQuickCompressedTextureFactory::addLevel(int offset, const QSize &size)
+{
+    const int length = compressedSize(m_format, size);
+    if (offset < 0 || length <= 0 || length > m_data.size() - offset)
+        return false;
+
+    Level level;
+    level.offset = offset;
+    level.length = length;
+    level.size = size;
+    m_levels.append(level);
+    return true;
+}
+
+static inline quint32 readUInt32(const uchar *data, bool bigEndian)
+{
+    return bigEndian ? qFromBigEndian<quint32>(data) : qFromLittleEndian<quint32>(data);
+}
+
+bool QQuickCompressedTextureFactory::readKtx()
+{
+    // 12 bytes of identifier followed by 13 32-bit fields in the byte order of the writer.
+    if (m_data.size() < 64)
+        return false;
+
+    const uchar *header = reinterpret_cast<const uchar *>(m_data.constData());
+    const quint32 endianness = qFromLittleEndian<quint32>(header + 12);
+    if (endianness != 0x04030201 && endianness != 0x01020304)
+        return false;
+    const bool bigEndian = endianness != 0x04030201;
+
+    const quint32 glType = readUInt32(header + 16, bigEndian);
+    const quint32 pixelWidth = readUInt32(header + 36, bigEndian);
+    const quint32 pixelHeight = readUInt32(header + 40, bigEndian);
+    const quint32 pixelDepth = readUInt32(header + 44, bigEndian);
+    const quint32 arrayElements = readUInt32(header + 48, bigEndian);
+    const quint32 faces = readUInt32(header + 52, bigEndian);
+    const quint32 mipmapLevels = qMax<quint32>(readUInt32(header + 56, bigEndian), 1);
+    const quint32 keyValueBytes = readUInt32(header + 60, bigEndian);
+    m_format = readUInt32(header + 28, bigEndian);
+
+    // Only single 2D compressed textures, not arrays, cube maps or 3D textures.
+    if (glType != 0 || pixelDepth > 1 || arrayElements != 0 || faces != 1
+            || pixelWidth > 0xffff || pixelHeight > 0xffff || mipmapLevels > 16
+            || keyValueBytes > quint32(m_data.size())) {
+        return false;
+    }
+
+    m_imageSize = QSize(pixelWidth, pixelHeight);
+    int offset = 64 + keyValueBytes;
+    for (quint32 i = 0; i < mipmapLevels; ++i) {
+        if (offset + 4 > m_data.size())
+            return false;
+        const quint32 imageSize = readUInt32(header + offset, bigEndian);
+        const QSize size(qMax(1, m_imageSize.width() >> i), qMax(1, m_imageSize.height() >> i));
+        if (!addLevel(offset + 4, size) || imageSize < quint32(m_levels.last().length))
+            return false;
+        offset = (offset + 4 + imageSize + 3) & ~3;
+    }
+    return true;
+}
+
+bool QQuickCompressedTextureFactory::readPkm()
+{
+    // "PKM ", a two character version and 16-bit big endian fields for the type of the data,
+    // its size padded to whole blocks and the size of the image.
+    if (m_data.size() < 16)
+        return false;
+
+    const uchar *header = reinterpret_cast<const uchar *>(m_data.constData());
+    const QByteArray version = m_data.mid(4, 2);
+    const quint16 type = qFromBigEndian<quint16>(header + 6);
+    const QSize paddedSize(qFromBigEndian<quint16>(header + 8), qFromBigEndian<quint16>(header + 10));
+    m_imageSize = QSize(qFromBigEndian<quint16>(header + 12), qFromBigEndian<quint16>(header + 14));
+
+    if (version == "10" && type == 0) {
+        m_format = GL_ETC1_RGB8_OES;
+    } else if (version == "20") {
+        switch (type) {
+        case 0: m_format = GL_ETC1_RGB8_OES; break;
+        case 1: m_format = GL_COMPRESSED_RGB8_ETC2; break;
+        case 3: m_format = GL_COMPRESSED_RGBA8_ETC2_EAC; break;
+        case 4: m_format = GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2; break;
+        default: return false;
+        }
+    } else {
+        return false;
+    }
+
+    if (paddedSize.width() < m_imageSize.width() || paddedSize.height() < m_imageSize.height())
+        return false;
+    return addLevel(16, m_imageSize);
+}
+
+bool QQuickCompressedTextureFactory::readDds()
+{
+    // "DDS " followed by a 124 byte header with little endian fields, including a
+    // 32 byte pixel format at offset 76.
+    if (m_data.size() < 128)
+        return false;
+
+    const uchar *header = reinterpret_cast<const uchar *>(m_data.constData());
+    const quint32 flags = qFromLittleEndian<quint32>(header + 8);
+    const quint32 height = qFromLittleEndian<quint32>(header + 12);
+    const quint32 width = qFromLittleEndian<quint32>(header + 16);
+    const quint32 mipmapCount = qFromLittleEndian<quint32>(header + 28);
+    const quint32 pixelFormatFlags = qFromLittleEndian<quint32>(header + 80);
+    const QByteArray fourCC = m_data.mid(84, 4);
+    const quint32 caps2 = qFromLittleEndian<quint32>(header + 112);
+
+    const quint32 DDSD_MIPMAPCOUNT = 0x20000;
+    const quint32 DDPF_FOURCC = 0x4;
+    const quint32 DDSCAPS2_CUBEMAP = 0x200;
+    const quint32 DDSCAPS2_VOLUME = 0x200000;
+
+    if (qFromLittleEndian<quint32>(header + 4) != 124 || !(pixelFormatFlags & DDPF_FOURCC)
+            || (caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME))
+            || width > 0xffff || height > 0xffff) {
+        return false;
+    }
+
+    if (fourCC == "DXT1")
+        m_format = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+    else if (fourCC == "DXT3")
+        m_format = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+    else if (fourCC == "DXT5")
+        m_format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    else
+        return false;
+
+    m_imageSize = QSize(width, height);
+    const int levels = flags & DDSD_MIPMAPCOUNT ? qBound<quint32>(1, mipmapCount, 16) : 1;
+    int offset = 128;
+    for (int i = 0; i < levels; ++i) {
+        const QSize size(qMax(1, m_imageSize.width() >> i), qMax(1, m_imageSize.height() >> i));
+        if (!addLevel(offset, size))
+            return false;
+        offset += m_levels.last().length;
+    }
+    return true;
+}
+
+QSGTexture *QQuickCompressedTextureFactory::createTexture(QQuickWindow *) const
+{
+    QOpenGLContext *context = QOpenGLContext::currentContext();
+    const uint format = context ? uploadFormat(context, m_format) : 0;
+    if (format)
+        return new QSGCompressedTexture(m_data, m_levels, format, m_imageSize, hasAlpha(m_format));
+
+    const QImage decoded = image();
+    if (decoded.isNull())
+        qWarning("QQuickCompressedTextureFactory: texture format 0x%x is not supported", m_format);
+    return QSGPlainTexture::fromImage(decoded);
+}
+
+int QQuickCompressedTextureFactory::textureByteCount() const
+{
+    int count = 0;
+    for (int i = 0; i < m_levels.count(); ++i)
+        count += m_levels.at(i).length;
+    return count;
+}
+
+/*!
+    Returns the first level of the texture decoded on the CPU, or a null image if the format
+    can only be decoded by a GPU.
+*/
+QImage QQuickCompressedTextureFactory::image() const
+{
+    if (m_levels.isEmpty())
+        return QImage();
+
+    const Level &level = m_levels.first();
+    const uchar *data = reinterpret_cast<const uchar *>(m_data.constData()) + level.offset;
+    switch (m_format) {
+    case GL_ETC1_RGB8_OES:
+        return decodeBlocks(data, level.size, QImage::Format_RGB32, 8, decodeEtc1Block);
+    case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        return decodeBlocks(data, level.size, QImage::Format_RGB32, 8, decodeDxt1RgbBlock);
+    case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+        return decodeBlocks(data, level.size, QImage::Format_ARGB32_Premultiplied, 8, decodeDxt1RgbaBlock);
+    case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+        return decodeBlocks(data, level.size, QImage::Format_ARGB32_Premultiplied, 16, decodeDxt3Block);
+    case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        return decodeBlocks(data, level.size, QImage::Format_ARGB32_Premultiplied, 16, decodeDxt5Block);
+    default:
+        return QImage();
+    }
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,103 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QQUICKCOMPRESSEDTEXTURE_P_H
+#define QQUICKCOMPRESSEDTEXTURE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtQuick/qquickimageprovider.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+class QIODevice;
+
+class Q_QUICK_PRIVATE_EXPORT QQuickCompressedTextureFactory : public QQuickTextureFactory
+{
+    Q_OBJECT
+public:
+    struct Level {
+        int offset;
+        int length;
+        QSize size;
+    };
+
+    static bool canRead(QIODevice *device);
+    static QQuickCompressedTextureFactory *read(QIODevice *device, QString *errorString);
+
+    QSGTexture *createTexture(QQuickWindow *window) const;
+    QSize textureSize() const { return m_imageSize; }
+    int textureByteCount() const;
+    QImage image() const;
+
+    uint glInternalFormat() const { return m_format; }
+    const QVector<Level> &levels() const { return m_levels; }
+
+private:
+    QQuickCompressedTextureFactory();
+
+    bool addLevel(int offset, const QSize &size);
+
+    bool readKtx();
+    bool readPkm();
+    bool readDds();
+
+    QByteArray m_data;
+    QVector<Level> m_levels;
+    QSize m_imageSize;
+    uint m_format;
+};
+
+QT_END_NAMESPACE
+
+#endif // QQUICKCOMPRESSEDTEXTURE_P_H
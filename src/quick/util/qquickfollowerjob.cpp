@@ -0,0 +1,422 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qquickfollowerjob_p.h"
+#include "qquickanimation_p_p.h"
+
+#include <private/qqmlproperty_p.h>
+#include <private/qqmlglobal_p.h>
+
+#include <QtCore/qthreadstorage.h>
+#include <QtCore/qvector.h>
+#include <QtCore/qnumeric.h>
+
+#include <math.h>
+
+QT_BEGIN_NAMESPACE
+
+DEFINE_BOOL_CONFIG_OPTION(qmlNoFollowerBatch, QML_NO_FOLLOWER_BATCH);
+
+static void writeReal(const QQmlProperty &target, qreal value)
+{
+    int flags = QQmlPropertyPrivate::BypassInterceptor | QQmlPropertyPrivate::DontRemoveBinding;
+    int coreIndex = QQuickPropertyAnimationPrivate::directRealIndex(target);
+    if (coreIndex == -1) {
+        QQmlPropertyPrivate::write(target, value, QQmlPropertyPrivate::WriteFlags(flags));
+        return;
+    }
+    int status = -1;
+    void *a[] = { &value, 0, &status, &flags };
+    QMetaObject::metacall(target.object(), QMetaObject::WriteProperty, coreIndex, a);
+}
+
+class QQuickFollowerBatch : public QQmlAnimationTickListener
+{
+public:
+    QQuickFollowerBatch();
+    ~QQuickFollowerBatch();
+
+    static QQuickFollowerBatch *instance(bool create);
+    static QQuickFollowerBatch *current();
+
+    void scheduleWrite(QQuickFollowerJob *job, qreal value);
+    void scheduleSpring(QQuickFollowerJob *job, const QQuickSpringStep &step);
+    void remove(QQuickFollowerJob *job);
+
+    void animationTickFinished();
+
+private:
+    void integrateSprings();
+    void flushWrites();
+
+    bool m_integrating;
+    bool m_flushing;
+
+    QVector<QQuickFollowerJob *> m_springJobs;
+    QVector<QQuickSpringStep> m_springSteps;
+    QVector<bool> m_settled;
+
+    // Structure of arrays used while integrating the springs without a
+    // modulus, ordered by descending step count.
+    QVector<int> m_order;
+    QVector<qreal> m_value;
+    QVector<qreal> m_velocity;
+    QVector<qreal> m_to;
+    QVector<qreal> m_spring;
+    QVector<qreal> m_damping;
+    QVector<qreal> m_mass;
+    QVector<qreal> m_maxVelocity;
+
+    QVector<QQuickFollowerJob *> m_writeJobs;
+    QVector<qreal> m_writeValues;
+};
+
+#ifndef QT_NO_THREAD
+Q_GLOBAL_STATIC(QThreadStorage<QQuickFollowerBatch *>, followerBatch)
+#endif
+
+QQuickFollowerBatch::QQuickFollowerBatch()
+    : m_integrating(false)
+    , m_flushing(false)
+{
+    QQmlAnimationTimer::instance()->addTickListener(this);
+}
+
+QQuickFollowerBatch::~QQuickFollowerBatch()
+{
+    if (QQmlAnimationTimer *timer = QQmlAnimationTimer::instance(false))
+        timer->removeTickListener(this);
+}
+
+QQuickFollowerBatch *QQuickFollowerBatch::instance(bool create)
+{
+#ifndef QT_NO_THREAD
+    if (!followerBatch())
+        return 0;
+    if (create && !followerBatch()->hasLocalData())
+        followerBatch()->setLocalData(new QQuickFollowerBatch);
+    return followerBatch()->hasLocalData() ? followerBatch()->localData() : 0;
+#else
+    static QQuickFollowerBatch *batch = 0;
+    if (create && !batch)
+        batch = new QQuickFollowerBatch;
+    return batch;
+#endif
+}
+
+/*
+    Returns the batch that updates should be collected in, or 0 if they
+    have to be applied right away.
+ */
+QQuickFollowerBatch *QQuickFollowerBatch::current()
+{
+    static bool disabled = qmlNoFollowerBatch();
+    if (disabled)
+        return 0;
+    QQuickFollowerBatch *batch = instance(false);
+    if (batch && batch->m_integrating)
+        return batch;
+    QQmlAnimationTimer *timer = QQmlAnimationTimer::instance(false);
+    if (!timer || !timer->isTicking())
+        return 0;
+    return batch ? batch : instance(true);
+}
+
+void QQuickFollowerBatch::scheduleWrite(QQuickFollowerJob *job, qreal value)
+{
+    if (job->m_writeIndex != -1) {
+        m_writeValues[job->m_writeIndex] = value;
+        return;
+    }
+    job->m_writeIndex = m_writeJobs.count();
+    m_writeJobs.append(job);
+    m_writeValues.append(value);
+}
+
+void QQuickFollowerBatch::scheduleSpring(QQuickFollowerJob *job, const QQuickSpringStep &step)
+{
+    if (job->m_springIndex != -1) {
+        // Stepped twice within one tick; the state has not moved since the
+        // first call, so only the number of steps accumulates.
+        QQuickSpringStep &pending = m_springSteps[job->m_springIndex];
+        int steps = pending.steps + step.steps;
+        pending = step;
+        pending.steps = steps;
+        return;
+    }
+    job->m_springIndex = m_springJobs.count();
+    m_springJobs.append(job);
+    m_springSteps.append(step);
+}
+
+void QQuickFollowerBatch::remove(QQuickFollowerJob *job)
+{
+    if (job->m_writeIndex != -1) {
+        m_writeJobs[job->m_writeIndex] = 0;
+        job->m_writeIndex = -1;
+    }
+    if (job->m_springIndex != -1) {
+        m_springJobs[job->m_springIndex] = 0;
+        job->m_springIndex = -1;
+    }
+}
+
+void QQuickFollowerBatch::animationTickFinished()
+{
+    // A write can end up advancing the animation timer again; whatever
+    // that nested tick schedules is picked up by the outer flush.
+    if (m_flushing)
+        return;
+    if (!m_springJobs.isEmpty())
+        integrateSprings();
+    if (!m_writeJobs.isEmpty())
+        flushWrites();
+}
+
+void QQuickFollowerBatch::integrateSprings()
+{
+    const int count = m_springSteps.count();
+    m_settled.resize(count);
+    m_order.clear();
+
+    // Springs with a modulus need the wrap-around handling of the scalar
+    // path; the rest are stepped side by side.
+    for (int i = 0; i < count; ++i) {
+        if (!m_springJobs.at(i))
+            continue;
+        QQuickSpringStep &step = m_springSteps[i];
+        if (step.modulus != 0.0) {
+            bool settled;
+            QQuickFollowerJob::integrate(step, &settled);
+            m_settled[i] = settled;
+        } else {
+            int j = m_order.count();
+            m_order.append(i);
+            while (j > 0 && m_springSteps.at(m_order.at(j - 1)).steps < step.steps) {
+                m_order[j] = m_order.at(j - 1);
+                --j;
+            }
+            m_order[j] = i;
+        }
+    }
+
+    const int n = m_order.count();
+    m_value.resize(n);
+    m_velocity.resize(n);
+    m_to.resize(n);
+    m_spring.resize(n);
+    m_damping.resize(n);
+    m_mass.resize(n);
+    m_maxVelocity.resize(n);
+
+    qreal *value = m_value.data();
+    qreal *velocity = m_velocity.data();
+    qreal *to = m_to.data();
+    qreal *spring = m_spring.data();
+    qreal *damping = m_damping.data();
+    qreal *mass = m_mass.data();
+    qreal *maxVelocity = m_maxVelocity.data();
+
+    for (int j = 0; j < n; ++j) {
+        const QQuickSpringStep &step = m_springSteps.at(m_order.at(j));
+        value[j] = step.value;
+        velocity[j] = step.velocity;
+        to[j] = step.to;
+        spring[j] = step.spring;
+        damping[j] = step.damping;
+        mass[j] = step.mass;
+        maxVelocity[j] = step.maxVelocity > 0. ? step.maxVelocity : qreal(qInf());
+    }
+
+    // Entries are sorted by step count, so the springs still moving at
+    // step s always form the prefix [0, active).
+    int active = n;
+    const int maxSteps = n ? m_springSteps.at(m_order.at(0)).steps : 0;
+    for (int s = 0; s < maxSteps; ++s) {
+        while (active > 0 && m_springSteps.at(m_order.at(active - 1)).steps <= s)
+            --active;
+        for (int j = 0; j < active; ++j) {
+            const qreal diff = to[j] - value[j];
+            qreal v = velocity[j] + (spring[j] * diff - damping[j] * velocity[j]) / mass[j];
+            v = qMin(qMax(v, -maxVelocity[j]), maxVelocity[j]);
+            velocity[j] = v;
+            value[j] += v * 16.0 / 1000.0;
+        }
+    }
+
+    for (int j = 0; j < n; ++j) {
+        const int i = m_order.at(j);
+        QQuickSpringStep &step = m_springSteps[i];
+        bool settled = qAbs(velocity[j]) < step.epsilon && qAbs(step.to - value[j]) < step.epsilon;
+        step.value = settled ? step.to : value[j];
+        step.velocity = settled ? 0.0 : velocity[j];
+        m_settled[i] = settled;
+    }
+
+    // The jobs only schedule their writes here, which end up in this batch.
+    m_integrating = true;
+    for (int i = 0; i < count; ++i) {
+        QQuickFollowerJob *job = m_springJobs.at(i);
+        if (!job)
+            continue;
+        job->m_springIndex = -1;
+        const QQuickSpringStep &step = m_springSteps.at(i);
+        job->springStepped(step.value, step.velocity, m_settled.at(i));
+    }
+    m_integrating = false;
+
+    m_springJobs.clear();
+    m_springSteps.clear();
+}
+
+void QQuickFollowerBatch::flushWrites()
+{
+    // Writes may run bindings that start, stop or delete other followers;
+    // those are removed from the lists and updates they cause are no longer
+    // collected here since the tick is over.
+    m_flushing = true;
+    for (int i = 0; i < m_writeJobs.count(); ++i) {
+        QQuickFollowerJob *job = m_writeJobs.at(i);
+        if (!job)
+            continue;
+        writeReal(job->target, m_writeValues.at(i));
+        if (m_writeJobs.at(i) != job)
+            continue;
+        job->m_writeIndex = -1;
+        m_writeJobs[i] = 0;
+        job->valueWritten();
+    }
+    m_writeJobs.clear();
+    m_writeValues.clear();
+    m_flushing = false;
+}
+
+QQuickFollowerJob::QQuickFollowerJob()
+    : m_writeIndex(-1)
+    , m_springIndex(-1)
+{
+}
+
+QQuickFollowerJob::~QQuickFollowerJob()
+{
+    discardScheduledUpdates();
+}
+
+void QQuickFollowerJob::discardScheduledUpdates()
+{
+    if (m_writeIndex == -1 && m_springIndex == -1)
+        return;
+    if (QQuickFollowerBatch *batch = QQuickFollowerBatch::instance(false))
+        batch->remove(this);
+}
+
+/*
+    Advances \a step by the given number of 16 ms steps. Real men solve the
+    spring DEs using RK4; we do something much simpler which gives a result
+    that looks fine.
+ */
+void QQuickFollowerJob::integrate(QQuickSpringStep &step, bool *settled)
+{
+    const bool haveModulus = step.modulus != 0.0;
+    for (int i = 0; i < step.steps; ++i) {
+        qreal diff = step.to - step.value;
+        if (haveModulus && qAbs(diff) > step.modulus / 2) {
+            if (diff < 0)
+                diff += step.modulus;
+            else
+                diff -= step.modulus;
+        }
+        step.velocity = step.velocity + (step.spring * diff - step.damping * step.velocity) / step.mass;
+        if (step.maxVelocity > 0.) {
+            // limit velocity
+            if (step.velocity > step.maxVelocity)
+                step.velocity = step.maxVelocity;
+            else if (step.velocity < -step.maxVelocity)
+                step.velocity = -step.maxVelocity;
+        }
+        step.value += step.velocity * 16.0 / 1000.0;
+        if (haveModulus) {
+            step.value = fmod(step.value, step.modulus);
+            if (step.value < 0.0)
+                step.value += step.modulus;
+        }
+    }
+    *settled = qAbs(step.velocity) < step.epsilon && qAbs(step.to - step.value) < step.epsilon;
+    if (*settled) {
+        step.velocity = 0.0;
+        step.value = step.to;
+    }
+}
+
+void QQuickFollowerJob::writeValue(qreal value)
+{
+    if (QQuickFollowerBatch *batch = QQuickFollowerBatch::current()) {
+        batch->scheduleWrite(this, value);
+        return;
+    }
+    writeReal(target, value);
+    valueWritten();
+}
+
+void QQuickFollowerJob::stepSpring(const QQuickSpringStep &step)
+{
+    if (QQuickFollowerBatch *batch = QQuickFollowerBatch::current()) {
+        batch->scheduleSpring(this, step);
+        return;
+    }
+    QQuickSpringStep result = step;
+    bool settled;
+    integrate(result, &settled);
+    springStepped(result.value, result.velocity, settled);
+}
+
+void QQuickFollowerJob::springStepped(qreal value, qreal velocity, bool settled)
+{
+    Q_UNUSED(velocity);
+    Q_UNUSED(settled);
+    writeValue(value);
+}
+
+void QQuickFollowerJob::valueWritten()
+{
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,109 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QQUICKFOLLOWERJOB_P_H
+#define QQUICKFOLLOWERJOB_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qabstractanimationjob_p.h>
+#include <QtQml/qqmlproperty.h>
+
+QT_BEGIN_NAMESPACE
+
+struct QQuickSpringStep
+{
+    qreal value;
+    qreal velocity;
+    qreal to;
+    qreal spring;
+    qreal damping;
+    qreal mass;
+    qreal maxVelocity;
+    qreal modulus;
+    qreal epsilon;
+    int steps;
+};
+
+/*
+    Common base of the jobs behind SmoothedAnimation and SpringAnimation.
+
+    While the animation timer is ticking, the value writes and spring
+    integration steps of all followers are collected and carried out
+    together once every animation has been advanced. Outside of a tick,
+    or when QML_NO_FOLLOWER_BATCH is set, they happen immediately.
+ */
+class Q_AUTOTEST_EXPORT QQuickFollowerJob : public QAbstractAnimationJob
+{
+public:
+    QQuickFollowerJob();
+    ~QQuickFollowerJob();
+
+    QQmlProperty target;
+
+    static void integrate(QQuickSpringStep &step, bool *settled);
+
+protected:
+    void writeValue(qreal value);
+    void stepSpring(const QQuickSpringStep &step);
+    void discardScheduledUpdates();
+
+    virtual void springStepped(qreal value, qreal velocity, bool settled);
+    virtual void valueWritten();
+
+private:
+    friend class QQuickFollowerBatch;
+    int m_writeIndex;
+    int m_springIndex;
+};
+
+QT_END_NAMESPACE
+
+#endif // QQUICKFOLLOWERJOB_P_H
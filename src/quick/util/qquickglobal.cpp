@@ -42,6 +42,8 @@
 #include <private/qquickvaluetypes_p.h>
 #include <private/qquickapplication_p.h>
 #include <private/qqmlglobal_p.h>
+#include <private/qquickpixmapcache_p.h>
+#include <private/qquickwindow_p.h>
 #include <private/qv8engine_p.h>
 
 #include <QtGui/QGuiApplication>
@@ -962,6 +964,17 @@ public:
         return false;
 #endif
     }
+
+    qint64 releaseResources(QQmlEngine *engine, QQmlEngine::ReleaseLevel level)
+    {
+        // The pixmap cache is shared by all engines
+        qint64 released = QQuickPixmap::trimCache(level == QQmlEngine::AggressiveRelease);
+        foreach (QWindow *w, QGuiApplication::topLevelWindows()) {
+            if (QQuickWindow *window = qobject_cast<QQuickWindow *>(w))
+                released += QQuickWindowPrivate::get(window)->releaseResources(engine, level);
+        }
+        return released;
+    }
 };
 
 
@@ -249,6 +249,7 @@ void QQuickPath::pathElements_clear(QQmlListProperty<QQuickPathElement> *propert
     d->_pathElements.clear();
     d->_pathCurves.clear();
     d->_pointCache.clear();
+    d->_attributeCache.clear();
 }
 
 void QQuickPath::interpolate(int idx, const QString &name, qreal value)
@@ -330,6 +331,7 @@ void QQuickPath::processPath()
         return;
 
     d->_pointCache.clear();
+    d->_attributeCache.clear();
     d->prevBez.isValid = false;
 
     d->_path = createPath(QPointF(), QPointF(), d->_attributes, d->pathLength, d->_attributePoints, &d->closed);
@@ -744,16 +746,9 @@ QPointF QQuickPath::backwardsPointAt(const QPainterPath &path, const qreal &path
     return QPointF(0,0);
 }
 
-QPointF QQuickPath::pointAt(qreal p) const
+static inline QPointF interpolatedPointAt(const QVector<QPointF> &pointCache, qreal p)
 {
-    Q_D(const QQuickPath);
-    if (d->_pointCache.isEmpty()) {
-        createPointCache();
-        if (d->_pointCache.isEmpty())
-            return QPointF();
-    }
-
-    const int segmentCount = d->_pointCache.size() - 1;
+    const int segmentCount = pointCache.size() - 1;
     qreal idxf = p*segmentCount;
     int idx1 = qFloor(idxf);
     qreal delta = idxf - idx1;
@@ -763,7 +758,7 @@ QPointF QQuickPath::pointAt(qreal p) const
         idx1 = 0;
 
     if (delta == 0.0)
-        return d->_pointCache.at(idx1);
+        return pointCache.at(idx1);
 
     // interpolate between the two points.
     int idx2 = qCeil(idxf);
@@ -772,13 +767,118 @@ QPointF QQuickPath::pointAt(qreal p) const
     else if (idx2 < 0)
         idx2 = 0;
 
-    QPointF p1 = d->_pointCache.at(idx1);
-    QPointF p2 = d->_pointCache.at(idx2);
+    QPointF p1 = pointCache.at(idx1);
+    QPointF p2 = pointCache.at(idx2);
     QPointF pos = p1 * (1.0-delta) + p2 * delta;
 
     return pos;
 }
 
+QPointF QQuickPath::pointAt(qreal p) const
+{
+    Q_D(const QQuickPath);
+    if (d->_pointCache.isEmpty()) {
+        createPointCache();
+        if (d->_pointCache.isEmpty())
+            return QPointF();
+    }
+
+    return interpolatedPointAt(d->_pointCache, p);
+}
+
+/*!
+    \internal
+
+    Stores the points at each of the \a count \a percents in \a points. This is
+    equivalent to calling pointAt() for each of them, but looks up the point
+    cache only once.
+*/
+void QQuickPath::pointsAt(const qreal *percents, QPointF *points, int count) const
+{
+    Q_D(const QQuickPath);
+    if (d->_pointCache.isEmpty())
+        createPointCache();
+
+    const QVector<QPointF> &pointCache = d->_pointCache;
+    if (pointCache.isEmpty()) {
+        for (int i = 0; i < count; ++i)
+            points[i] = QPointF();
+        return;
+    }
+
+    for (int i = 0; i < count; ++i)
+        points[i] = interpolatedPointAt(pointCache, percents[i]);
+}
+
+// The attribute values of all attribute points, one row of attributes() values per point.
+void QQuickPath::createAttributeCache() const
+{
+    Q_D(const QQuickPath);
+    const int attributeCount = d->_attributes.count();
+    d->_attributeCache.resize(d->_attributePoints.count() * attributeCount);
+
+    qreal *values = d->_attributeCache.data();
+    for (int ii = 0; ii < d->_attributePoints.count(); ++ii) {
+        const AttributePoint &point = d->_attributePoints.at(ii);
+        for (int jj = 0; jj < attributeCount; ++jj)
+            *values++ = point.values.value(d->_attributes.at(jj));
+    }
+}
+
+/*!
+    \internal
+
+    Stores the value of each of the attributes() at \a percent in \a values, in the
+    same order. This is equivalent to calling attributeAt() for each attribute, but
+    locates \a percent on the path only once.
+*/
+void QQuickPath::attributesAt(qreal percent, qreal *values) const
+{
+    Q_D(const QQuickPath);
+    const int attributeCount = d->_attributes.count();
+    for (int jj = 0; jj < attributeCount; ++jj)
+        values[jj] = 0;
+    if (percent < 0 || percent > 1 || !attributeCount)
+        return;
+
+    if (d->_attributeCache.isEmpty()) {
+        createAttributeCache();
+        if (d->_attributeCache.isEmpty())
+            return;
+    }
+
+    // Binary search for the first point at or after percent
+    const QList<AttributePoint> &points = d->_attributePoints;
+    int low = 0;
+    int high = points.count();
+    while (low < high) {
+        const int mid = (low + high) / 2;
+        if (points.at(mid).percent < percent)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    const int ii = low;
+    if (ii == points.count())
+        return;
+
+    const AttributePoint &point = points.at(ii);
+    const qreal *curValues = d->_attributeCache.constData() + ii * attributeCount;
+    if (point.percent == percent) {
+        for (int jj = 0; jj < attributeCount; ++jj)
+            values[jj] = curValues[jj];
+        return;
+    }
+
+    const qreal lastPercent = ii ? points.at(ii - 1).percent : 0;
+    const qreal fraction = (percent - lastPercent) / (point.percent - lastPercent);
+    const qreal *lastValues = ii ? curValues - attributeCount : 0;
+    for (int jj = 0; jj < attributeCount; ++jj) {
+        const qreal lastValue = lastValues ? lastValues[jj] : 0;
+        values[jj] = lastValue + (curValues[jj] - lastValue) * fraction;
+    }
+}
+
 qreal QQuickPath::attributeAt(const QString &name, qreal percent) const
 {
     Q_D(const QQuickPath);
@@ -382,6 +382,8 @@ public:
     QStringList attributes() const;
     qreal attributeAt(const QString &, qreal) const;
     QPointF pointAt(qreal) const;
+    void pointsAt(const qreal *percents, QPointF *points, int count) const;
+    void attributesAt(qreal percent, qreal *values) const;
     QPointF sequentialPointAt(qreal p, qreal *angle = 0) const;
     void invalidateSequentialHistory() const;
 
@@ -423,6 +425,7 @@ private:
     void interpolate(int idx, const QString &name, qreal value);
     void endpoint(const QString &name);
     void createPointCache() const;
+    void createAttributeCache() const;
 
     static void interpolate(QList<AttributePoint> &points, int idx, const QString &name, qreal value);
     static void endpoint(QList<AttributePoint> &attributePoints, const QString &name);
@@ -433,6 +436,7 @@ private:
     Q_DISABLE_COPY(QQuickPath)
     Q_DECLARE_PRIVATE(QQuickPath)
     friend class QQuickPathAnimationUpdater;
+    friend class QQuickPathAnimatorJob;
 
 public:
     QPainterPath createPath(const QPointF &startPoint, const QPointF &endPoint, const QStringList &attributes, qreal &pathLength, QList<AttributePoint> &attributePoints, bool *closed = 0);
@@ -75,6 +75,7 @@ public:
     QPainterPath _path;
     QList<QQuickPathElement*> _pathElements;
     mutable QVector<QPointF> _pointCache;
+    mutable QVector<qreal> _attributeCache;
     QList<QQuickPath::AttributePoint> _attributePoints;
     QStringList _attributes;
     QList<QQuickCurve*> _pathCurves;
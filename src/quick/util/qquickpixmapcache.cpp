@@ -40,6 +40,7 @@
 ****************************************************************************/
 
 #include "qquickpixmapcache_p.h"
+#include "qquickcompressedtexture_p.h"
 #include <qqmlnetworkaccessmanagerfactory.h>
 #include <qquickimageprovider.h>
 
@@ -60,7 +61,14 @@
 #include <QNetworkReply>
 #include <QPixmapCache>
 #include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QSaveFile>
+#include <QCryptographicHash>
 #include <QThread>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QRunnable>
 #include <QMutex>
 #include <QMutexLocker>
 #include <QWaitCondition>
@@ -79,6 +87,7 @@
 #define IMAGEREQUEST_MAX_REDIRECT_RECURSION 16
 #define CACHE_EXPIRE_TIME 30
 #define CACHE_REMOVAL_FRACTION 4
+#define CACHE_EVICTION_CANDIDATES 4
 
 QT_BEGIN_NAMESPACE
 
@@ -90,6 +99,10 @@ static bool qsg_leak_check = !qgetenv("QML_LEAK_CHECK").isEmpty();
 // The cache limit describes the maximum "junk" in the cache.
 static int cache_limit = 2048 * 1024; // 2048 KB cache limit for embedded in qpixmapcache.cpp
 
+// The cache budget limits all cached pixmaps, whether they are in use or not. Unused pixmaps
+// are dropped to stay within it. A budget of 0 means no budget.
+static int cache_budget = qgetenv("QML_PIXMAP_CACHE_BUDGET").toInt() * 1024; // in KB
+
 static inline QString imageProviderId(const QUrl &url)
 {
     return url.host();
@@ -146,15 +159,17 @@ public:
 
     bool loading;
     int redirectCount;
+    QElapsedTimer loadTimer;
 
     class Event : public QEvent {
     public:
-        Event(ReadError, const QString &, const QSize &, QQuickTextureFactory *factory);
+        Event(ReadError, const QString &, const QSize &, QQuickTextureFactory *factory, int loadTime);
 
         ReadError error;
         QString errorString;
         QSize implicitSize;
         QQuickTextureFactory *textureFactory;
+        int loadTime;
     };
     void postReply(ReadError, const QString &, const QSize &, QQuickTextureFactory *factory);
 
@@ -186,6 +201,7 @@ private:
     QQuickPixmapReader *reader;
 };
 
+class QQuickPixmapDecodeTask;
 class QQuickPixmapData;
 class QQuickPixmapReader : public QThread
 {
@@ -205,12 +221,22 @@ protected:
 
 private:
     friend class QQuickPixmapReaderThreadObject;
+    friend class QQuickPixmapDecodeTask;
     void processJobs();
-    void processJob(QQuickPixmapReply *, const QUrl &, const QSize &);
-    void networkRequestDone(QNetworkReply *);
+    void processJob(QQuickPixmapReply *, const QUrl &);
+    void decodeJob(QQuickPixmapReply *, const QUrl &, const QSize &, const QByteArray &);
+    void decodeFinished(QQuickPixmapReply *, QQuickPixmapReply::ReadError, const QString &,
+                        const QSize &, QQuickTextureFactory *);
+    void startDecoding(QQuickPixmapReply *, const QUrl &, const QByteArray & = QByteArray());
+    int nextJobIndex() const;
+    void removeCancelledJobs();
 
     QList<QQuickPixmapReply*> jobs;
     QList<QQuickPixmapReply*> cancelled;
+    QSet<QQuickPixmapReply*> decoding;
+    QSet<QString> busyProviders;
+    QThreadPool decodePool;
+    bool lastJobFromProvider;
     QQmlEngine *engine;
     QObject *eventLoopQuitHack;
 
@@ -238,7 +264,7 @@ public:
     QQuickPixmapData(QQuickPixmap *pixmap, const QUrl &u, const QSize &s, const QString &e)
     : refCount(1), inCache(false), pixmapStatus(QQuickPixmap::Error),
       url(u), errorString(e), requestSize(s), textureFactory(0), reply(0), prevUnreferenced(0),
-      prevUnreferencedPtr(0), nextUnreferenced(0)
+      prevUnreferencedPtr(0), nextUnreferenced(0), loadTime(0)
     {
         declarativePixmaps.insert(pixmap);
     }
@@ -246,7 +272,7 @@ public:
     QQuickPixmapData(QQuickPixmap *pixmap, const QUrl &u, const QSize &r)
     : refCount(1), inCache(false), pixmapStatus(QQuickPixmap::Loading),
       url(u), requestSize(r), textureFactory(0), reply(0), prevUnreferenced(0), prevUnreferencedPtr(0),
-      nextUnreferenced(0)
+      nextUnreferenced(0), loadTime(0)
     {
         declarativePixmaps.insert(pixmap);
     }
@@ -254,7 +280,7 @@ public:
     QQuickPixmapData(QQuickPixmap *pixmap, const QUrl &u, QQuickTextureFactory *texture, const QSize &s, const QSize &r)
     : refCount(1), inCache(false), pixmapStatus(QQuickPixmap::Ready),
       url(u), implicitSize(s), requestSize(r), textureFactory(texture), reply(0), prevUnreferenced(0),
-      prevUnreferencedPtr(0), nextUnreferenced(0)
+      prevUnreferencedPtr(0), nextUnreferenced(0), loadTime(0)
     {
         declarativePixmaps.insert(pixmap);
     }
@@ -262,7 +288,7 @@ public:
     QQuickPixmapData(QQuickPixmap *pixmap, QQuickTextureFactory *texture)
     : refCount(1), inCache(false), pixmapStatus(QQuickPixmap::Ready),
       textureFactory(texture), reply(0), prevUnreferenced(0),
-      prevUnreferencedPtr(0), nextUnreferenced(0)
+      prevUnreferencedPtr(0), nextUnreferenced(0), loadTime(0)
     {
         if (texture)
             requestSize = implicitSize = texture->textureSize();
@@ -303,6 +329,8 @@ public:
     QQuickPixmapData *prevUnreferenced;
     QQuickPixmapData**prevUnreferencedPtr;
     QQuickPixmapData *nextUnreferenced;
+
+    int loadTime; // microseconds it took to load, an estimate of the cost of loading it again
 };
 
 int QQuickPixmapReply::finishedIndex = -1;
@@ -322,11 +350,13 @@ void QQuickPixmapReply::postReply(ReadError error, const QString &errorString,
                                         const QSize &implicitSize, QQuickTextureFactory *factory)
 {
     loading = false;
-    QCoreApplication::postEvent(this, new Event(error, errorString, implicitSize, factory));
+    const int loadTime = loadTimer.isValid() ? int(loadTimer.nsecsElapsed() / 1000) : 0;
+    QCoreApplication::postEvent(this, new Event(error, errorString, implicitSize, factory, loadTime));
 }
 
-QQuickPixmapReply::Event::Event(ReadError e, const QString &s, const QSize &iSize, QQuickTextureFactory *factory)
-    : QEvent(QEvent::User), error(e), errorString(s), implicitSize(iSize), textureFactory(factory)
+QQuickPixmapReply::Event::Event(ReadError e, const QString &s, const QSize &iSize, QQuickTextureFactory *factory,
+                                int time)
+    : QEvent(QEvent::User), error(e), errorString(s), implicitSize(iSize), textureFactory(factory), loadTime(time)
 {
 }
 
@@ -397,8 +427,200 @@ static bool readImage(const QUrl& url, QIODevice *dev, QImage *image, QString *e
     }
 }
 
+/*
+    Reads the image in \a dev into a texture factory. GPU compressed textures are kept
+    compressed and ignore \a requestSize, as they can't be scaled without decoding them.
+*/
+static QQuickTextureFactory *readTexture(const QUrl& url, QIODevice *dev, QString *errorString, QSize *impsize,
+                                         const QSize &requestSize)
+{
+    if (QQuickCompressedTextureFactory::canRead(dev)) {
+        QString error;
+        QQuickCompressedTextureFactory *factory = QQuickCompressedTextureFactory::read(dev, &error);
+        if (!factory) {
+            if (errorString)
+                *errorString = QQuickPixmap::tr("Error decoding: %1: %2").arg(url.toString()).arg(error);
+            return 0;
+        }
+        if (impsize)
+            *impsize = factory->textureSize();
+        return factory;
+    }
+
+    QImage image;
+    if (!readImage(url, dev, &image, errorString, impsize, requestSize))
+        return 0;
+    return textureFactoryForImage(image);
+}
+
+/*
+    Decodes one image in a thread of the reader's decode pool, so that images are no longer
+    decoded one after another on the reader thread.
+*/
+class QQuickPixmapDecodeTask : public QRunnable
+{
+public:
+    QQuickPixmapDecodeTask(QQuickPixmapReader *reader, QQuickPixmapReply *job, const QUrl &url,
+                           const QSize &requestSize, const QByteArray &data)
+        : reader(reader), job(job), url(url), requestSize(requestSize), data(data)
+    {
+    }
+
+    void run()
+    {
+        // Decoding used to happen on a lowest priority thread, keep it from competing with
+        // the GUI and render threads.
+        QThread::currentThread()->setPriority(QThread::LowestPriority);
+        reader->decodeJob(job, url, requestSize, data);
+    }
+
+private:
+    QQuickPixmapReader *reader;
+    QQuickPixmapReply *job;
+    QUrl url;
+    QSize requestSize;
+    QByteArray data;
+};
+
+// Scaled images read from local files can be kept in a disk cache, so that images shown
+// with a small sourceSize don't need to be decoded and scaled again every time.
+static QMutex diskCacheMutex;
+static QString disk_cache_directory = QString::fromLocal8Bit(qgetenv("QML_PIXMAP_DISK_CACHE"));
+
+static const char diskCacheMagic[4] = { 'Q', 'P', 'X', 'C' };
+enum { DiskCacheVersion = 1, DiskCacheHeaderSize = 64 };
+
+struct DiskCacheHeader
+{
+    char magic[4];
+    quint32 version;
+    qint32 width;
+    qint32 height;
+    qint32 format;
+    qint32 bytesPerLine;
+    qint32 implicitWidth;
+    qint32 implicitHeight;
+};
+
+static QString diskCacheFile(const QString &localFile, const QSize &requestSize)
+{
+    // Images are only worth caching if they are scaled, resources can't change and so
+    // don't have a modification time to key on.
+    if (requestSize.width() <= 0 && requestSize.height() <= 0)
+        return QString();
+    if (localFile.startsWith(QLatin1Char(':')))
+        return QString();
+
+    QMutexLocker locker(&diskCacheMutex);
+    if (disk_cache_directory.isEmpty())
+        return QString();
+
+    const QFileInfo info(localFile);
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(info.absoluteFilePath().toUtf8());
+    hash.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+    hash.addData(QByteArray::number(info.size()));
+    hash.addData(QByteArray::number(requestSize.width()) + 'x' + QByteArray::number(requestSize.height()));
+    return disk_cache_directory + QLatin1Char('/') + QString::fromLatin1(hash.result().toHex());
+}
+
+static void unmapDiskCacheFile(void *file)
+{
+    // destroying the file unmaps it
+    delete static_cast<QFile *>(file);
+}
+
+static bool readDiskCache(const QString &cacheFile, QImage *image, QSize *impsize)
+{
+    QFile *file = new QFile(cacheFile);
+    if (!file->open(QIODevice::ReadOnly) || file->size() < DiskCacheHeaderSize) {
+        delete file;
+        return false;
+    }
+
+    // The pixels are used straight from the mapped file, so this costs no more than paging
+    // them in. The mapping is read-only, the const constructor makes QImage copy before any
+    // write.
+    const uchar *data = file->map(0, file->size());
+    DiskCacheHeader header;
+    if (data)
+        memcpy(&header, data, sizeof(header));
+    if (!data || memcmp(header.magic, diskCacheMagic, sizeof(diskCacheMagic)) != 0
+            || header.version != DiskCacheVersion
+            || (header.format != QImage::Format_RGB32 && header.format != QImage::Format_ARGB32_Premultiplied)
+            || header.width <= 0 || header.height <= 0 || header.bytesPerLine < header.width * 4
+            || file->size() - DiskCacheHeaderSize < qint64(header.bytesPerLine) * header.height) {
+        delete file;
+        return false;
+    }
+
+    *image = QImage(data + DiskCacheHeaderSize, header.width, header.height, header.bytesPerLine,
+                    QImage::Format(header.format), unmapDiskCacheFile, file);
+    if (impsize)
+        *impsize = QSize(header.implicitWidth, header.implicitHeight);
+    return true;
+}
+
+static void writeDiskCache(const QString &cacheFile, QQuickTextureFactory *factory, const QSize &impsize)
+{
+    // Compressed textures are already fast to load.
+    if (qobject_cast<QQuickCompressedTextureFactory *>(factory))
+        return;
+
+    QImage image = factory->image();
+    if (image.isNull())
+        return;
+    if (image.format() != QImage::Format_RGB32 && image.format() != QImage::Format_ARGB32_Premultiplied)
+        image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    DiskCacheHeader header;
+    memcpy(header.magic, diskCacheMagic, sizeof(diskCacheMagic));
+    header.version = DiskCacheVersion;
+    header.width = image.width();
+    header.height = image.height();
+    header.format = image.format();
+    header.bytesPerLine = image.bytesPerLine();
+    header.implicitWidth = impsize.width();
+    header.implicitHeight = impsize.height();
+
+    QByteArray headerData(DiskCacheHeaderSize, 0);
+    memcpy(headerData.data(), &header, sizeof(header));
+
+    QDir().mkpath(QFileInfo(cacheFile).absolutePath());
+    // written to a temporary file first, so that other readers never see a partial file
+    QSaveFile file(cacheFile);
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+    file.write(headerData);
+    file.write(reinterpret_cast<const char *>(image.constBits()), qint64(image.bytesPerLine()) * image.height());
+    file.commit();
+}
+
+/*
+    Reads the already opened local file \a file, from the disk cache if it has a copy.
+*/
+static QQuickTextureFactory *readLocalTexture(const QUrl& url, QFile *file, QString *errorString, QSize *impsize,
+                                              const QSize &requestSize)
+{
+    const QString cacheFile = diskCacheFile(file->fileName(), requestSize);
+    if (cacheFile.isEmpty())
+        return readTexture(url, file, errorString, impsize, requestSize);
+
+    QImage image;
+    if (readDiskCache(cacheFile, &image, impsize))
+        return textureFactoryForImage(image);
+
+    QSize readSize;
+    QQuickTextureFactory *factory = readTexture(url, file, errorString, &readSize, requestSize);
+    if (factory)
+        writeDiskCache(cacheFile, factory, readSize);
+    if (impsize)
+        *impsize = readSize;
+    return factory;
+}
+
 QQuickPixmapReader::QQuickPixmapReader(QQmlEngine *eng)
-: QThread(eng), engine(eng), threadObject(0), accessManager(0)
+: QThread(eng), lastJobFromProvider(false), engine(eng), threadObject(0), accessManager(0)
 {
     eventLoopQuitHack = new QObject;
     eventLoopQuitHack->moveToThread(this);
@@ -427,9 +649,18 @@ QQuickPixmapReader::~QQuickPixmapReader()
             reply->data = 0;
         }
     }
+    foreach (QQuickPixmapReply *reply, decoding) {
+        if (!cancelled.contains(reply)) {
+            cancelled.append(reply);
+            reply->data = 0;
+        }
+    }
     if (threadObject) threadObject->processJobs();
     mutex.unlock();
 
+    // The decode tasks call back into the reader when they are done.
+    decodePool.waitForDone();
+
     eventLoopQuitHack->deleteLater();
     wait();
 }
@@ -460,25 +691,14 @@ void QQuickPixmapReader::networkRequestDone(QNetworkReply *reply)
             }
         }
 
-        QImage image;
-        QQuickPixmapReply::ReadError error = QQuickPixmapReply::NoError;
-        QString errorString;
-        QSize readSize;
-        if (reply->error()) {
-            error = QQuickPixmapReply::Loading;
-            errorString = reply->errorString();
-        } else {
-            QSystraceEvent trace("graphics", "QQuickPixmapCache::networkRead");
-            QByteArray all = reply->readAll();
-            QBuffer buff(&all);
-            buff.open(QIODevice::ReadOnly);
-            if (!readImage(reply->url(), &buff, &image, &errorString, &readSize, job->requestSize))
-                error = QQuickPixmapReply::Decoding;
-       }
-        // send completion event to the QQuickPixmapReply
         mutex.lock();
-        if (!cancelled.contains(job))
-            job->postReply(error, errorString, readSize, textureFactoryForImage(image));
+        if (reply->error()) {
+            // send completion event to the QQuickPixmapReply
+            if (!cancelled.contains(job))
+                job->postReply(QQuickPixmapReply::Loading, reply->errorString(), QSize(), 0);
+        } else if (!cancelled.contains(job)) {
+            startDecoding(job, reply->url(), reply->readAll());
+        }
         mutex.unlock();
     }
     reply->deleteLater();
@@ -513,142 +733,196 @@ void QQuickPixmapReaderThreadObject::networkRequestDone()
     reader->networkRequestDone(reply);
 }
 
+void QQuickPixmapReader::removeCancelledJobs()
+{
+    for (int i = 0; i < cancelled.count(); ++i) {
+        QQuickPixmapReply *job = cancelled.at(i);
+        // a decode task still refers to the job, it is removed once the task finishes
+        if (decoding.contains(job))
+            continue;
+        QNetworkReply *reply = replies.key(job, 0);
+        if (reply && reply->isRunning()) {
+            // cancel any jobs already started
+            replies.remove(reply);
+            reply->close();
+            QSystrace::counter("network", "QQuickPixmapReader::jobCount", "%d", replies.count());
+        }
+        // deleteLater, since not owned by this thread
+        job->deleteLater();
+        cancelled.removeAt(i--);
+    }
+}
+
+/*
+    Returns the index of the job to start next or -1 if none can be started yet.
+
+    The most recent requests are served first, as they belong to the items that were created
+    last, which in a view are the ones scrolled into sight.  Requests to image providers and
+    to other urls are taken in turns so that a slow provider doesn't starve file loading or
+    the other way round.  Each provider only handles one request at a time, as providers have
+    always been called from a single thread.
+*/
+int QQuickPixmapReader::nextJobIndex() const
+{
+    const bool canDecode = decoding.count() < decodePool.maxThreadCount();
+    const bool canRequest = replies.count() < IMAGEREQUEST_MAX_REQUEST_COUNT;
+
+    int fallback = -1;
+    for (int i = jobs.count() - 1; i >= 0; --i) {
+        const QUrl &url = jobs.at(i)->url;
+        const bool fromProvider = url.scheme() == QLatin1String("image");
+        if (fromProvider) {
+            if (!canDecode || busyProviders.contains(imageProviderId(url)))
+                continue;
+        } else if (QQmlFile::urlToLocalFileOrQrc(url).isEmpty() ? !canRequest : !canDecode) {
+            continue;
+        }
+
+        if (fromProvider != lastJobFromProvider)
+            return i;
+        if (fallback == -1)
+            fallback = i;
+    }
+    return fallback;
+}
+
 void QQuickPixmapReader::processJobs()
 {
     QMutexLocker locker(&mutex);
 
     while (true) {
-        if (cancelled.isEmpty() && (jobs.isEmpty() || replies.count() >= IMAGEREQUEST_MAX_REQUEST_COUNT))
-            return; // Nothing else to do
-
         // Clean cancelled jobs
-        if (cancelled.count()) {
-            for (int i = 0; i < cancelled.count(); ++i) {
-                QQuickPixmapReply *job = cancelled.at(i);
-                QNetworkReply *reply = replies.key(job, 0);
-                if (reply && reply->isRunning()) {
-                    // cancel any jobs already started
-                    replies.remove(reply);
-                    reply->close();
-                    QSystrace::counter("network", "QQuickPixmapReader::jobCount", "%d", replies.count());
-                }
-                // deleteLater, since not owned by this thread
-                job->deleteLater();
-            }
-            cancelled.clear();
-        }
+        if (cancelled.count())
+            removeCancelledJobs();
 
-        if (!jobs.isEmpty() && replies.count() < IMAGEREQUEST_MAX_REQUEST_COUNT) {
-            QQuickPixmapReply *runningJob = jobs.takeLast();
-            runningJob->loading = true;
+        const int index = nextJobIndex();
+        if (index == -1)
+            return; // Nothing else to do
 
-            QUrl url = runningJob->url;
-            Q_QUICK_PROFILE(pixmapStateChanged<QQuickProfiler::PixmapLoadingStarted>(url));
+        QQuickPixmapReply *runningJob = jobs.takeAt(index);
+        runningJob->loading = true;
+        runningJob->loadTimer.start();
 
-            QSize requestSize = runningJob->requestSize;
+        QUrl url = runningJob->url;
+        Q_QUICK_PROFILE(pixmapStateChanged<QQuickProfiler::PixmapLoadingStarted>(url));
+
+        lastJobFromProvider = url.scheme() == QLatin1String("image");
+        if (lastJobFromProvider || !QQmlFile::urlToLocalFileOrQrc(url).isEmpty()) {
+            startDecoding(runningJob, url);
+        } else {
             locker.unlock();
-            processJob(runningJob, url, requestSize);
+            processJob(runningJob, url);
             locker.relock();
         }
     }
 }
 
-void QQuickPixmapReader::processJob(QQuickPixmapReply *runningJob, const QUrl &url,
-                                          const QSize &requestSize)
+// must be called with the mutex locked
+void QQuickPixmapReader::startDecoding(QQuickPixmapReply *job, const QUrl &url, const QByteArray &data)
+{
+    decoding.insert(job);
+    if (url.scheme() == QLatin1String("image"))
+        busyProviders.insert(imageProviderId(url));
+    decodePool.start(new QQuickPixmapDecodeTask(this, job, url, job->requestSize, data));
+}
+
+void QQuickPixmapReader::decodeFinished(QQuickPixmapReply *job, QQuickPixmapReply::ReadError error,
+                                        const QString &errorString, const QSize &readSize,
+                                        QQuickTextureFactory *factory)
+{
+    mutex.lock();
+    decoding.remove(job);
+    if (job->url.scheme() == QLatin1String("image"))
+        busyProviders.remove(imageProviderId(job->url));
+    if (!cancelled.contains(job))
+        job->postReply(error, errorString, readSize, factory);
+    else
+        delete factory;
+    // a thread is free to take the next job
+    if (threadObject) threadObject->processJobs();
+    mutex.unlock();
+}
+
+void QQuickPixmapReader::processJob(QQuickPixmapReply *runningJob, const QUrl &url)
 {
+    // Network resource, decoded in the pool once it is downloaded
+    QNetworkRequest req(url);
+    req.setAttribute(QNetworkRequest::HttpPipeliningAllowedAttribute, true);
+    QNetworkReply *reply = networkAccessManager()->get(req);
+
+    QMetaObject::connect(reply, replyDownloadProgress, runningJob, downloadProgress);
+    QMetaObject::connect(reply, replyFinished, threadObject, threadNetworkRequestDone);
+
+    mutex.lock();
+    replies.insert(reply, runningJob);
+    QSystrace::counter("network", "QQuickPixmapReader::jobCount", "%d", replies.count());
+    mutex.unlock();
+}
+
+void QQuickPixmapReader::decodeJob(QQuickPixmapReply *runningJob, const QUrl &url,
+                                   const QSize &requestSize, const QByteArray &data)
+{
+    QQuickPixmapReply::ReadError errorCode = QQuickPixmapReply::NoError;
+    QString errorStr;
+    QSize readSize;
+    QQuickTextureFactory *factory = 0;
+
     // fetch
     if (url.scheme() == QLatin1String("image")) {
         // Use QQuickImageProvider
-        QSize readSize;
-
         QQuickImageProvider::ImageType imageType = QQuickImageProvider::Invalid;
         QQuickImageProvider *provider = static_cast<QQuickImageProvider *>(engine->imageProvider(imageProviderId(url)));
         if (provider)
             imageType = provider->imageType();
 
         if (imageType == QQuickImageProvider::Invalid) {
-            QQuickPixmapReply::ReadError errorCode = QQuickPixmapReply::Loading;
-            QString errorStr = QQuickPixmap::tr("Invalid image provider: %1").arg(url.toString());
-            QImage image;
-            mutex.lock();
-            if (!cancelled.contains(runningJob))
-                runningJob->postReply(errorCode, errorStr, readSize, textureFactoryForImage(image));
-            mutex.unlock();
+            errorCode = QQuickPixmapReply::Loading;
+            errorStr = QQuickPixmap::tr("Invalid image provider: %1").arg(url.toString());
         } else if (imageType == QQuickImageProvider::Image) {
             QImage image = provider->requestImage(imageId(url), &readSize, requestSize);
-            QQuickPixmapReply::ReadError errorCode = QQuickPixmapReply::NoError;
-            QString errorStr;
             if (image.isNull()) {
                 errorCode = QQuickPixmapReply::Loading;
                 errorStr = QQuickPixmap::tr("Failed to get image from provider: %1").arg(url.toString());
             }
-            mutex.lock();
-            if (!cancelled.contains(runningJob))
-                runningJob->postReply(errorCode, errorStr, readSize, textureFactoryForImage(image));
-            mutex.unlock();
+            factory = textureFactoryForImage(image);
         } else if (imageType == QQuickImageProvider::Pixmap) {
             const QPixmap pixmap = provider->requestPixmap(imageId(url), &readSize, requestSize);
-            QQuickPixmapReply::ReadError errorCode = QQuickPixmapReply::NoError;
-            QString errorStr;
             if (pixmap.isNull()) {
                 errorCode = QQuickPixmapReply::Loading;
                 errorStr = QQuickPixmap::tr("Failed to get image from provider: %1").arg(url.toString());
             }
-            mutex.lock();
-            if (!cancelled.contains(runningJob))
-                runningJob->postReply(errorCode, errorStr, readSize, textureFactoryForImage(pixmap.toImage()));
-            mutex.unlock();
+            factory = textureFactoryForImage(pixmap.toImage());
         } else {
-            QQuickTextureFactory *t = provider->requestTexture(imageId(url), &readSize, requestSize);
-            QQuickPixmapReply::ReadError errorCode = QQuickPixmapReply::NoError;
-            QString errorStr;
-            if (!t) {
+            factory = provider->requestTexture(imageId(url), &readSize, requestSize);
+            if (!factory) {
                 errorCode = QQuickPixmapReply::Loading;
                 errorStr = QQuickPixmap::tr("Failed to get texture from provider: %1").arg(url.toString());
             }
-            mutex.lock();
-            if (!cancelled.contains(runningJob))
-                runningJob->postReply(errorCode, errorStr, readSize, t);
-            else
-                delete t;
-            mutex.unlock();
-
         }
 
+    } else if (!data.isNull()) {
+        QSystraceEvent trace("graphics", "QQuickPixmapCache::networkRead");
+        QByteArray all = data;
+        QBuffer buff(&all);
+        buff.open(QIODevice::ReadOnly);
+        factory = readTexture(url, &buff, &errorStr, &readSize, requestSize);
+        if (!factory)
+            errorCode = QQuickPixmapReply::Decoding;
     } else {
-        QString lf = QQmlFile::urlToLocalFileOrQrc(url);
-        if (!lf.isEmpty()) {
-            // Image is local - load/decode immediately
-            QSystraceEvent trace("graphics", "QQuickPixmapCache::localRead");
-            QImage image;
-            QQuickPixmapReply::ReadError errorCode = QQuickPixmapReply::NoError;
-            QString errorStr;
-            QFile f(lf);
-            QSize readSize;
-            if (f.open(QIODevice::ReadOnly)) {
-                if (!readImage(url, &f, &image, &errorStr, &readSize, requestSize))
-                    errorCode = QQuickPixmapReply::Loading;
-            } else {
-                errorStr = QQuickPixmap::tr("Cannot open: %1").arg(url.toString());
+        // Image is local - load/decode immediately
+        QSystraceEvent trace("graphics", "QQuickPixmapCache::localRead");
+        QFile f(QQmlFile::urlToLocalFileOrQrc(url));
+        if (f.open(QIODevice::ReadOnly)) {
+            factory = readLocalTexture(url, &f, &errorStr, &readSize, requestSize);
+            if (!factory)
                 errorCode = QQuickPixmapReply::Loading;
-            }
-            mutex.lock();
-            if (!cancelled.contains(runningJob))
-                runningJob->postReply(errorCode, errorStr, readSize, textureFactoryForImage(image));
-            mutex.unlock();
         } else {
-            // Network resource
-            QNetworkRequest req(url);
-            req.setAttribute(QNetworkRequest::HttpPipeliningAllowedAttribute, true);
-            QNetworkReply *reply = networkAccessManager()->get(req);
-
-            QMetaObject::connect(reply, replyDownloadProgress, runningJob, downloadProgress);
-            QMetaObject::connect(reply, replyFinished, threadObject, threadNetworkRequestDone);
-
-            replies.insert(reply, runningJob);
-            QSystrace::counter("network", "QQuickPixmapReader::jobCount", "%d", replies.count());
+            errorStr = QQuickPixmap::tr("Cannot open: %1").arg(url.toString());
+            errorCode = QQuickPixmapReply::Loading;
         }
     }
+
+    decodeFinished(runningJob, errorCode, errorStr, readSize, factory);
 }
 
 QQuickPixmapReader *QQuickPixmapReader::instance(QQmlEngine *engine)
@@ -746,21 +1020,31 @@ public:
     void unreferencePixmap(QQuickPixmapData *);
     void referencePixmap(QQuickPixmapData *);
 
+    void addCost(int cost);
+    void removeCost(int cost);
+
     void purgeCache();
+    qint64 trimCache(bool aggressive);
+    void applyLimits();
 
 protected:
     virtual void timerEvent(QTimerEvent *);
 
 public:
     QHash<QQuickPixmapKey, QQuickPixmapData *> m_cache;
+    QSet<QUrl> m_pinned;
+
+    int m_cost;
+    int m_unreferencedCost;
 
 private:
     void shrinkCache(int remove);
+    void unlinkUnreferenced(QQuickPixmapData *);
+    QQuickPixmapData *evictionCandidate() const;
 
     QQuickPixmapData *m_unreferencedPixmaps;
     QQuickPixmapData *m_lastUnreferencedPixmap;
 
-    int m_unreferencedCost;
     int m_timerId;
     bool m_destroying;
 };
@@ -768,7 +1052,8 @@ Q_GLOBAL_STATIC(QQuickPixmapStore, pixmapStore);
 
 
 QQuickPixmapStore::QQuickPixmapStore()
-    : m_unreferencedPixmaps(0), m_lastUnreferencedPixmap(0), m_unreferencedCost(0), m_timerId(-1), m_destroying(false)
+    : m_cost(0), m_unreferencedCost(0), m_unreferencedPixmaps(0), m_lastUnreferencedPixmap(0), m_timerId(-1)
+    , m_destroying(false)
 {
 }
 
@@ -841,6 +1126,13 @@ void QQuickPixmapStore::referencePixmap(QQuickPixmapData *data)
 {
     Q_ASSERT(data->prevUnreferencedPtr);
 
+    unlinkUnreferenced(data);
+
+    m_unreferencedCost -= data->cost();
+}
+
+void QQuickPixmapStore::unlinkUnreferenced(QQuickPixmapData *data)
+{
     *data->prevUnreferencedPtr = data->nextUnreferenced;
     if (data->nextUnreferenced) {
         data->nextUnreferenced->prevUnreferencedPtr = data->prevUnreferencedPtr;
@@ -852,20 +1144,50 @@ void QQuickPixmapStore::referencePixmap(QQuickPixmapData *data)
     data->nextUnreferenced = 0;
     data->prevUnreferencedPtr = 0;
     data->prevUnreferenced = 0;
+}
 
-    m_unreferencedCost -= data->cost();
+/*
+    Returns the unreferenced pixmap to drop next.  Of the least recently used pixmaps, the one
+    that was the quickest to load is dropped first, so that a large cache of cheap images
+    doesn't push out the few that are slow to load again.  Pinned pixmaps are only dropped
+    when the store is destroyed.
+*/
+QQuickPixmapData *QQuickPixmapStore::evictionCandidate() const
+{
+    QQuickPixmapData *candidate = 0;
+    int candidates = 0;
+    for (QQuickPixmapData *data = m_lastUnreferencedPixmap;
+         data && candidates < CACHE_EVICTION_CANDIDATES; data = data->prevUnreferenced) {
+        if (!m_destroying && !m_pinned.isEmpty() && m_pinned.contains(data->url))
+            continue;
+        if (!candidate || data->loadTime < candidate->loadTime)
+            candidate = data;
+        ++candidates;
+    }
+    return candidate;
+}
+
+void QQuickPixmapStore::addCost(int cost)
+{
+    m_cost += cost;
+    if (cache_budget > 0 && m_cost > cache_budget)
+        shrinkCache(-1);
+}
+
+void QQuickPixmapStore::removeCost(int cost)
+{
+    if (!m_destroying)
+        m_cost -= cost;
 }
 
 void QQuickPixmapStore::shrinkCache(int remove)
 {
-    while ((remove > 0 || m_unreferencedCost > cache_limit) && m_lastUnreferencedPixmap) {
-        QQuickPixmapData *data = m_lastUnreferencedPixmap;
-        Q_ASSERT(data->nextUnreferenced == 0);
+    while (remove > 0 || m_unreferencedCost > cache_limit || (cache_budget > 0 && m_cost > cache_budget)) {
+        QQuickPixmapData *data = evictionCandidate();
+        if (!data)
+            break;
 
-        *data->prevUnreferencedPtr = 0;
-        m_lastUnreferencedPixmap = data->prevUnreferenced;
-        data->prevUnreferencedPtr = 0;
-        data->prevUnreferenced = 0;
+        unlinkUnreferenced(data);
 
         if (!m_destroying) {
             remove -= data->cost();
@@ -882,7 +1204,7 @@ void QQuickPixmapStore::timerEvent(QTimerEvent *)
 
     shrinkCache(removalCost);
 
-    if (m_unreferencedPixmaps == 0) {
+    if (!evictionCandidate()) {
         killTimer(m_timerId);
         m_timerId = -1;
     }
@@ -893,11 +1215,125 @@ void QQuickPixmapStore::purgeCache()
     shrinkCache(m_unreferencedCost);
 }
 
+// Drops half of the unreferenced pixmaps, or all of them if aggressive, and returns their cost.
+qint64 QQuickPixmapStore::trimCache(bool aggressive)
+{
+    const int unreferencedCost = m_unreferencedCost;
+    shrinkCache(aggressive ? m_unreferencedCost : m_unreferencedCost / 2);
+    return unreferencedCost - m_unreferencedCost;
+}
+
+void QQuickPixmapStore::applyLimits()
+{
+    shrinkCache(-1);
+}
+
 void QQuickPixmap::purgeCache()
 {
     pixmapStore()->purgeCache();
 }
 
+qint64 QQuickPixmap::trimCache(bool aggressive)
+{
+    return pixmapStore()->trimCache(aggressive);
+}
+
+/*
+    Sets the total size in bytes of the pixmaps kept in the cache after they stopped being
+    used.  Defaults to 2 MB.
+*/
+void QQuickPixmap::setCacheLimit(int bytes)
+{
+    cache_limit = bytes;
+    pixmapStore()->applyLimits();
+}
+
+int QQuickPixmap::cacheLimit()
+{
+    return cache_limit;
+}
+
+/*
+    Sets the total size in bytes of all cached pixmaps, including the ones in use, above
+    which unused pixmaps are dropped from the cache.  This is the memory taken by the images
+    or compressed data the textures are created from.  0, the default, means no budget; the
+    budget can also be set in kilobytes with the QML_PIXMAP_CACHE_BUDGET environment variable.
+*/
+void QQuickPixmap::setCacheBudget(int bytes)
+{
+    cache_budget = bytes;
+    pixmapStore()->applyLimits();
+}
+
+int QQuickPixmap::cacheBudget()
+{
+    return cache_budget;
+}
+
+/*
+    Returns the size in bytes of all pixmaps in the cache.
+*/
+int QQuickPixmap::cacheCost()
+{
+    return pixmapStore()->m_cost;
+}
+
+/*
+    Returns the size in bytes of the pixmaps in the cache which are not in use.
+*/
+int QQuickPixmap::unreferencedCacheCost()
+{
+    return pixmapStore()->m_unreferencedCost;
+}
+
+int QQuickPixmap::cacheCount()
+{
+    return pixmapStore()->m_cache.count();
+}
+
+/*
+    Keeps the pixmaps loaded from \a url in the cache after they stop being used, no matter
+    their age or the cache limits, until unpin() is called.  Pixmaps are still only cached
+    when loaded with the Cache option.
+*/
+void QQuickPixmap::pin(const QUrl &url)
+{
+    pixmapStore()->m_pinned.insert(url);
+}
+
+void QQuickPixmap::unpin(const QUrl &url)
+{
+    QQuickPixmapStore *store = pixmapStore();
+    if (store->m_pinned.remove(url))
+        store->applyLimits();
+}
+
+bool QQuickPixmap::isPinned(const QUrl &url)
+{
+    return pixmapStore()->m_pinned.contains(url);
+}
+
+/*
+    Sets the directory in which scaled images loaded from local files are cached, so that
+    they don't have to be decoded and scaled again the next time they are loaded with the
+    same sourceSize.  Entries are keyed on the file, its size and modification time and the
+    requested size.  An empty \a path, the default, disables the disk cache; it can also be
+    set with the QML_PIXMAP_DISK_CACHE environment variable.
+
+    The cache doesn't remove old entries itself.
+*/
+void QQuickPixmap::setDiskCacheDirectory(const QString &path)
+{
+    QMutexLocker locker(&diskCacheMutex);
+    disk_cache_directory = path;
+}
+
+QString QQuickPixmap::diskCacheDirectory()
+{
+    QMutexLocker locker(&diskCacheMutex);
+    return disk_cache_directory;
+}
+
 QQuickPixmapReply::QQuickPixmapReply(QQuickPixmapData *d)
 : data(d), engineForReader(0), requestSize(d->requestSize), url(d->url), loading(false), redirectCount(0)
 {
@@ -923,6 +1359,9 @@ bool QQuickPixmapReply::event(QEvent *event)
             if (data->pixmapStatus == QQuickPixmap::Ready) {
                 data->textureFactory = de->textureFactory;
                 data->implicitSize = de->implicitSize;
+                data->loadTime = de->loadTime;
+                if (data->inCache)
+                    pixmapStore()->addCost(data->cost());
                 Q_QUICK_PROFILE(pixmapLoadingFinished(data->url,
                         data->requestSize.width() > 0 ? data->requestSize : data->implicitSize));
             } else {
@@ -992,6 +1431,7 @@ void QQuickPixmapData::addToCache()
         QQuickPixmapKey key = { &url, &requestSize };
         pixmapStore()->m_cache.insert(key, this);
         inCache = true;
+        pixmapStore()->addCost(cost());
         Q_QUICK_PROFILE(pixmapCountChanged<QQuickProfiler::PixmapCacheCountChanged>(
                 url, pixmapStore()->m_cache.count()));
     }
@@ -1005,6 +1445,7 @@ void QQuickPixmapData::removeFromCache()
                 url, pixmapStore()->m_cache.count()));
         pixmapStore()->m_cache.remove(key);
         inCache = false;
+        pixmapStore()->removeCost(cost());
     }
 }
 
@@ -1063,11 +1504,9 @@ static QQuickPixmapData* createPixmapDataSync(QQuickPixmap *declarativePixmap, Q
     QString errorString;
 
     if (f.open(QIODevice::ReadOnly)) {
-        QImage image;
-
-        if (readImage(url, &f, &image, &errorString, &readSize, requestSize)) {
+        if (QQuickTextureFactory *factory = readLocalTexture(url, &f, &errorString, &readSize, requestSize)) {
             *ok = true;
-            return new QQuickPixmapData(declarativePixmap, url, textureFactoryForImage(image), readSize, requestSize);
+            return new QQuickPixmapData(declarativePixmap, url, factory, readSize, requestSize);
         }
         errorString = QQuickPixmap::tr("Invalid image data: %1").arg(url.toString());
 
@@ -1199,6 +1638,19 @@ void QQuickPixmap::setImage(const QImage &p)
         d = new QQuickPixmapData(this, textureFactoryForImage(p));
 }
 
+void QQuickPixmap::setPixmap(const QQuickPixmap &other)
+{
+    if (d == other.d)
+        return;
+    clear();
+
+    if (other.d) {
+        d = other.d;
+        d->addref();
+        d->declarativePixmaps.insert(this);
+    }
+}
+
 int QQuickPixmap::width() const
 {
     if (d && d->textureFactory)
@@ -1272,8 +1724,11 @@ void QQuickPixmap::load(QQmlEngine *engine, const QUrl &url, const QSize &reques
         if (!(options & QQuickPixmap::Asynchronous)) {
             bool ok = false;
             Q_QUICK_PROFILE(pixmapStateChanged<QQuickProfiler::PixmapLoadingStarted>(url));
+            QElapsedTimer loadTimer;
+            loadTimer.start();
             d = createPixmapDataSync(this, engine, url, requestSize, &ok);
             if (ok) {
+                d->loadTime = int(loadTimer.nsecsElapsed() / 1000);
                 Q_QUICK_PROFILE(pixmapLoadingFinished(url,
                         d->requestSize.width() > 0 ? d->requestSize : d->implicitSize));
                 if (options & QQuickPixmap::Cache)
@@ -101,6 +101,7 @@ public:
     const QSize &requestSize() const;
     QImage image() const;
     void setImage(const QImage &);
+    void setPixmap(const QQuickPixmap &other);
 
     QQuickTextureFactory *textureFactory() const;
 
@@ -122,6 +123,22 @@ public:
     bool connectDownloadProgress(QObject *, int);
 
     static void purgeCache();
+    static qint64 trimCache(bool aggressive);
+
+    static void setCacheLimit(int bytes);
+    static int cacheLimit();
+    static void setCacheBudget(int bytes);
+    static int cacheBudget();
+    static int cacheCost();
+    static int unreferencedCacheCost();
+    static int cacheCount();
+
+    static void pin(const QUrl &url);
+    static void unpin(const QUrl &url);
+    static bool isPinned(const QUrl &url);
+
+    static void setDiskCacheDirectory(const QString &path);
+    static QString diskCacheDirectory();
 
 private:
     Q_DISABLE_COPY(QQuickPixmap)
@@ -105,6 +105,8 @@ void QQuickProfilerData::toByteArrays(QList<QByteArray> &messages) const
                     case QQuickProfiler::SceneGraphWindowsAnimations: ds << subtime_1; break;
                     // WindowsRenderWindow: polish time; always comes packed after a RenderLoop
                     case QQuickProfiler::SceneGraphWindowsPolishFrame: ds << subtime_4; break;
+                    // PolishItems: item type, item count, polish time, polish iterations of the frame
+                    case QQuickProfiler::SceneGraphPolishItems: ds << detailString << (int)subtime_1 << subtime_2 << (int)subtime_3; break;
                     default:break;
                 }
                 break;
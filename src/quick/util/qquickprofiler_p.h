@@ -106,12 +106,19 @@ struct Q_AUTOTEST_EXPORT QQuickProfilerData
         time(time), messageType(messageType), detailType(detailType), subtime_1(d1), subtime_2(d2),
         subtime_3(d3), subtime_4(d4), subtime_5(d5) {}
 
+    // Scenegraph frames that are attributed to something named, e.g. an item type.
+    QQuickProfilerData(qint64 time, int messageType, int detailType, const QString &string,
+                       qint64 d1, qint64 d2, qint64 d3) :
+        time(time), messageType(messageType), detailType(detailType), detailString(string),
+        subtime_1(d1), subtime_2(d2), subtime_3(d3) {}
+
 
     qint64 time;
     int messageType;        //bit field of Message
     int detailType;
 
     QUrl detailUrl;
+    QString detailString;   //used by polish statistics
 
     union {
         qint64 subtime_1;
@@ -178,6 +185,13 @@ public:
                 1 << FrameType1 | 1 << FrameType2, value1, value2, value3, value4, value5));
     }
 
+    static void polishedItems(const QString &typeName, int count, qint64 polishTime,
+                              int iterations)
+    {
+        s_instance->processMessage(QQuickProfilerData(s_instance->timestamp(), 1 << SceneGraphFrame,
+                1 << SceneGraphPolishItems, typeName, count, polishTime, iterations));
+    }
+
     template<PixmapEventType PixmapState>
     static void pixmapStateChanged(const QUrl &url)
     {
@@ -56,6 +56,7 @@
 #include <private/qqmlboundsignal_p.h>
 
 #include <QtCore/qdebug.h>
+#include <QtCore/qhash.h>
 
 #include <private/qobject_p.h>
 
@@ -234,6 +235,11 @@ public:
     QList<ExpressionChange> expressions;
     QList<QQuickReplaceSignalHandler*> signalReplacements;
 
+    // Properties resolved against the current target, reused each time the
+    // state is applied. Entries go stale when the target changes or dies.
+    QHash<QString, QQmlProperty> resolvedProperties;
+
+    QQmlProperty resolve(const QString &);
     QQmlProperty property(const QString &);
 };
 
@@ -397,6 +403,7 @@ void QQuickPropertyChanges::setObject(QObject *o)
 {
     Q_D(QQuickPropertyChanges);
     d->object = o;
+    d->resolvedProperties.clear();
 }
 
 /*!
@@ -421,10 +428,24 @@ void QQuickPropertyChanges::setRestoreEntryValues(bool v)
 }
 
 QQmlProperty
-QQuickPropertyChangesPrivate::property(const QString &property)
+QQuickPropertyChangesPrivate::resolve(const QString &property)
 {
     Q_Q(QQuickPropertyChanges);
+    QHash<QString, QQmlProperty>::ConstIterator it = resolvedProperties.constFind(property);
+    if (it != resolvedProperties.constEnd() && object && it->object() == object)
+        return *it;
+
     QQmlProperty prop(object, property, qmlContext(q));
+    if (prop.isValid())
+        resolvedProperties.insert(property, prop);
+    return prop;
+}
+
+QQmlProperty
+QQuickPropertyChangesPrivate::property(const QString &property)
+{
+    Q_Q(QQuickPropertyChanges);
+    QQmlProperty prop = resolve(property);
     if (!prop.isValid()) {
         qmlInfo(q) << QQuickPropertyChanges::tr("Cannot assign to non-existent property \"%1\"").arg(property);
         return QQmlProperty();
@@ -444,12 +465,17 @@ QQuickPropertyChanges::ActionList QQuickPropertyChanges::actions()
     ActionList list;
 
     for (int ii = 0; ii < d->properties.count(); ++ii) {
+        const QString &property = d->properties.at(ii).first;
+        QQmlProperty prop = d->resolve(property);
 
-        QQuickStateAction a(d->object, d->properties.at(ii).first,
-                 qmlContext(this), d->properties.at(ii).second);
-
-        if (a.property.isValid()) {
+        if (prop.isValid()) {
+            QQuickStateAction a;
             a.restore = restoreEntryValues();
+            a.property = prop;
+            a.fromValue = a.property.read();
+            a.toValue = d->properties.at(ii).second;
+            a.specifiedObject = d->object;
+            a.specifiedProperty = property;
             list << a;
         }
     }
@@ -76,7 +76,7 @@ void QSmoothedAnimationTimer::stopAnimation()
 }
 
 QSmoothedAnimation::QSmoothedAnimation(QQuickSmoothedAnimationPrivate *priv)
-    : QAbstractAnimationJob(), to(0), velocity(200), userDuration(-1), maximumEasingTime(-1),
+    : QQuickFollowerJob(), to(0), velocity(200), userDuration(-1), maximumEasingTime(-1),
       reversingMode(QQuickSmoothedAnimation::Eased), initialVelocity(0),
       trackVelocity(0), initialValue(0), invert(false), finalDuration(-1), lastTime(0),
       skipUpdate(false), delayedStopTimer(new QSmoothedAnimationTimer(this)), animationTemplate(priv)
@@ -255,13 +255,13 @@ void QSmoothedAnimation::updateCurrentTime(int t)
 
     qreal value = easeFollow(time_seconds);
     value *= (invert? -1.0: 1.0);
-    QQmlPropertyPrivate::write(target, initialValue + value,
-                                       QQmlPropertyPrivate::BypassInterceptor
-                                       | QQmlPropertyPrivate::DontRemoveBinding);
+    writeValue(initialValue + value);
 }
 
 void QSmoothedAnimation::init()
 {
+    discardScheduledUpdates();
+
     if (velocity == 0) {
         stop();
         return;
@@ -57,6 +57,7 @@
 #include "qquickanimation_p.h"
 
 #include "qquickanimation_p_p.h"
+#include "qquickfollowerjob_p.h"
 
 #include <private/qobject_p.h>
 #include <QBasicTimer>
@@ -76,7 +77,7 @@ private:
 };
 
 class QQuickSmoothedAnimationPrivate;
-class Q_AUTOTEST_EXPORT QSmoothedAnimation : public QAbstractAnimationJob
+class Q_AUTOTEST_EXPORT QSmoothedAnimation : public QQuickFollowerJob
 {
     Q_DISABLE_COPY(QSmoothedAnimation)
 public:
@@ -93,8 +94,6 @@ public:
     qreal initialVelocity;
     qreal trackVelocity;
 
-    QQmlProperty target;
-
     int duration() const;
     void restart();
     void init();
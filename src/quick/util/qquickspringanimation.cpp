@@ -42,6 +42,7 @@
 #include "qquickspringanimation_p.h"
 
 #include "qquickanimation_p_p.h"
+#include "qquickfollowerjob_p.h"
 #include <private/qqmlproperty_p.h>
 #include "private/qcontinuinganimationgroupjob_p.h"
 
@@ -57,7 +58,7 @@
 QT_BEGIN_NAMESPACE
 
 class QQuickSpringAnimationPrivate;
-class Q_AUTOTEST_EXPORT QSpringAnimation : public QAbstractAnimationJob
+class Q_AUTOTEST_EXPORT QSpringAnimation : public QQuickFollowerJob
 {
     Q_DISABLE_COPY(QSpringAnimation)
 public:
@@ -81,7 +82,6 @@ public:
         Spring
     };
     Mode mode;
-    QQmlProperty target;
 
     qreal velocityms;
     qreal maxVelocity;
@@ -94,6 +94,8 @@ public:
     bool useMass : 1;
     bool haveModulus : 1;
     bool skipUpdate : 1;
+    bool stopPending : 1;
+    qreal stopTo;
     typedef QHash<QQmlProperty, QSpringAnimation*> ActiveAnimationHash;
 
     void clearTemplate() { animationTemplate = 0; }
@@ -101,6 +103,8 @@ public:
 protected:
     virtual void updateCurrentTime(int time);
     virtual void updateState(QAbstractAnimationJob::State, QAbstractAnimationJob::State);
+    virtual void springStepped(qreal value, qreal velocity, bool settled);
+    virtual void valueWritten();
 
 private:
     QQuickSpringAnimationPrivate *animationTemplate;
@@ -142,7 +146,7 @@ public:
 };
 
 QSpringAnimation::QSpringAnimation(QQuickSpringAnimationPrivate *priv)
-    : QAbstractAnimationJob()
+    : QQuickFollowerJob()
     , currentValue(0)
     , to(0)
     , velocity(0)
@@ -161,6 +165,8 @@ QSpringAnimation::QSpringAnimation(QQuickSpringAnimationPrivate *priv)
     , useMass(false)
     , haveModulus(false)
     , skipUpdate(false)
+    , stopPending(false)
+    , stopTo(0)
     , animationTemplate(priv)
 {
 }
@@ -204,6 +210,7 @@ void QSpringAnimation::restart()
 
 void QSpringAnimation::init()
 {
+    discardScheduledUpdates();
     lastTime = startTime = 0;
     stopTime = -1;
 }
@@ -237,77 +244,69 @@ void QSpringAnimation::updateCurrentTime(int time)
 
     qreal srcVal = to;
 
-    bool stopped = false;
-
     if (haveModulus) {
         currentValue = fmod(currentValue, modulus);
         srcVal = fmod(srcVal, modulus);
     }
+
+    // do not stop if we get restarted before the value is written
+    stopTo = to;
+
     if (mode == Spring) {
-        // Real men solve the spring DEs using RK4.
-        // We'll do something much simpler which gives a result that looks fine.
-        for (int i = 0; i < count; ++i) {
-            qreal diff = srcVal - currentValue;
-            if (haveModulus && qAbs(diff) > modulus / 2) {
-                if (diff < 0)
-                    diff += modulus;
-                else
-                    diff -= modulus;
-            }
-            if (useMass)
-                velocity = velocity + (spring * diff - damping * velocity) / mass;
-            else
-                velocity = velocity + spring * diff - damping * velocity;
-            if (maxVelocity > 0.) {
-                // limit velocity
-                if (velocity > maxVelocity)
-                    velocity = maxVelocity;
-                else if (velocity < -maxVelocity)
-                    velocity = -maxVelocity;
-            }
-            currentValue += velocity * 16.0 / 1000.0;
-            if (haveModulus) {
-                currentValue = fmod(currentValue, modulus);
-                if (currentValue < 0.0)
-                    currentValue += modulus;
-            }
-        }
-        if (qAbs(velocity) < epsilon && qAbs(srcVal - currentValue) < epsilon) {
-            velocity = 0.0;
-            currentValue = srcVal;
-            stopped = true;
-        }
+        QQuickSpringStep step;
+        step.value = currentValue;
+        step.velocity = velocity;
+        step.to = srcVal;
+        step.spring = spring;
+        step.damping = damping;
+        step.mass = useMass ? mass : 1.0;
+        step.maxVelocity = maxVelocity;
+        step.modulus = haveModulus ? modulus : 0.0;
+        step.epsilon = epsilon;
+        step.steps = count;
+        stepSpring(step);
+        return;
+    }
+
+    bool stopped = false;
+    qreal moveBy = elapsed * velocityms;
+    qreal diff = srcVal - currentValue;
+    if (haveModulus && qAbs(diff) > modulus / 2) {
+        if (diff < 0)
+            diff += modulus;
+        else
+            diff -= modulus;
+    }
+    if (diff > 0) {
+        currentValue += moveBy;
+        if (haveModulus)
+            currentValue = fmod(currentValue, modulus);
     } else {
-        qreal moveBy = elapsed * velocityms;
-        qreal diff = srcVal - currentValue;
-        if (haveModulus && qAbs(diff) > modulus / 2) {
-            if (diff < 0)
-                diff += modulus;
-            else
-                diff -= modulus;
-        }
-        if (diff > 0) {
-            currentValue += moveBy;
-            if (haveModulus)
-                currentValue = fmod(currentValue, modulus);
-        } else {
-            currentValue -= moveBy;
-            if (haveModulus && currentValue < 0.0)
-                currentValue = fmod(currentValue, modulus) + modulus;
-        }
-        if (lastTime - startTime >= dura) {
-            currentValue = to;
-            stopped = true;
-        }
+        currentValue -= moveBy;
+        if (haveModulus && currentValue < 0.0)
+            currentValue = fmod(currentValue, modulus) + modulus;
+    }
+    if (lastTime - startTime >= dura) {
+        currentValue = to;
+        stopped = true;
     }
 
-    qreal old_to = to;
+    stopPending = stopped;
+    writeValue(currentValue);
+}
 
-    QQmlPropertyPrivate::write(target, currentValue,
-                                       QQmlPropertyPrivate::BypassInterceptor |
-                                       QQmlPropertyPrivate::DontRemoveBinding);
+void QSpringAnimation::springStepped(qreal value, qreal v, bool settled)
+{
+    currentValue = value;
+    velocity = v;
+    stopPending = settled;
+    writeValue(currentValue);
+}
 
-    if (stopped && old_to == to) { // do not stop if we got restarted
+void QSpringAnimation::valueWritten()
+{
+    if (stopPending && stopTo == to) { // do not stop if we got restarted
+        stopPending = false;
         if (animationTemplate)
             stopTime = animationTemplate->elapsed.elapsed();
         stop();
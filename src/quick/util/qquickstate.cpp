@@ -48,6 +48,7 @@
 #include <private/qqmlglobal_p.h>
 
 #include <QtCore/qdebug.h>
+#include <QtCore/qhash.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -556,6 +557,27 @@ bool QQuickState::isStateActive() const
     return stateGroup() && stateGroup()->state() == name();
 }
 
+// Actions are matched against reverts by property. Index both lists by
+// (object, core index) so that applying a state is linear in the number of
+// actions; QQmlProperty::operator== still decides between candidates.
+typedef QPair<QObject *, int> QQuickStatePropertyKey;
+typedef QHash<QQuickStatePropertyKey, QList<int> > QQuickStatePropertyIndex;
+
+static inline QQuickStatePropertyKey qquickstate_propertyKey(const QQmlProperty &property)
+{
+    return QQuickStatePropertyKey(property.object(), property.index());
+}
+
+static void qquickstate_indexReverts(QQuickStatePropertyIndex &index,
+                                     const QQuickStatePrivate::SimpleActionList &reverts)
+{
+    index.clear();
+    for (int ii = 0; ii < reverts.count(); ++ii) {
+        if (!reverts.at(ii).event())
+            index[qquickstate_propertyKey(reverts.at(ii).property())] << ii;
+    }
+}
+
 void QQuickState::apply(QQuickTransition *trans, QQuickState *revert)
 {
     Q_D(QQuickState);
@@ -580,6 +602,9 @@ void QQuickState::apply(QQuickTransition *trans, QQuickState *revert)
 
     // List of actions that need to be reverted to roll back (just) this state
     QQuickStatePrivate::SimpleActionList additionalReverts;
+    QQuickStatePropertyIndex revertIndex;
+    qquickstate_indexReverts(revertIndex, d->revertList);
+    bool revertIndexDirty = false;
     // First add the reverse of all the applyList actions
     for (int ii = 0; ii < applyList.count(); ++ii) {
         QQuickStateAction &action = applyList[ii];
@@ -600,6 +625,7 @@ void QQuickState::apply(QQuickTransition *trans, QQuickState *revert)
                             QQuickSimpleAction r(action);
                             additionalReverts << r;
                             d->revertList.removeAt(jj);
+                            revertIndexDirty = true;
                             --jj;
                         } else if (action.event->isRewindable())    //###why needed?
                             action.event->saveCurrentValues();
@@ -619,13 +645,21 @@ void QQuickState::apply(QQuickTransition *trans, QQuickState *revert)
             bool found = false;
             action.fromBinding = QQmlPropertyPrivate::binding(action.property);
 
-            for (int jj = 0; jj < d->revertList.count(); ++jj) {
-                if (d->revertList.at(jj).property() == action.property) {
-                    found = true;
-                    if (d->revertList.at(jj).binding() != action.fromBinding) {
-                        action.deleteFromBinding();
+            if (revertIndexDirty) {
+                qquickstate_indexReverts(revertIndex, d->revertList);
+                revertIndexDirty = false;
+            }
+            QQuickStatePropertyIndex::ConstIterator it = revertIndex.constFind(qquickstate_propertyKey(action.property));
+            if (it != revertIndex.constEnd()) {
+                for (int kk = 0; kk < it->count(); ++kk) {
+                    const int jj = it->at(kk);
+                    if (d->revertList.at(jj).property() == action.property) {
+                        found = true;
+                        if (d->revertList.at(jj).binding() != action.fromBinding) {
+                            action.deleteFromBinding();
+                        }
+                        break;
                     }
-                    break;
                 }
             }
 
@@ -644,6 +678,11 @@ void QQuickState::apply(QQuickTransition *trans, QQuickState *revert)
 
     // Any reverts from a previous state that aren't carried forth
     // into this state need to be translated into apply actions
+    QQuickStatePropertyIndex applyIndex;
+    for (int ii = 0; ii < applyList.count(); ++ii) {
+        if (!applyList.at(ii).event)
+            applyIndex[qquickstate_propertyKey(applyList.at(ii).property)] << ii;
+    }
     for (int ii = 0; ii < d->revertList.count(); ++ii) {
         bool found = false;
         if (d->revertList.at(ii).event()) {
@@ -658,10 +697,13 @@ void QQuickState::apply(QQuickTransition *trans, QQuickState *revert)
                 }
             }
         } else {
-            for (int jj = 0; !found && jj < applyList.count(); ++jj) {
-                const QQuickStateAction &action = applyList.at(jj);
-                if (action.property == d->revertList.at(ii).property())
-                    found = true;
+            const QQmlProperty &property = d->revertList.at(ii).property();
+            QQuickStatePropertyIndex::ConstIterator it = applyIndex.constFind(qquickstate_propertyKey(property));
+            if (it != applyIndex.constEnd()) {
+                for (int kk = 0; !found && kk < it->count(); ++kk) {
+                    if (applyList.at(it->at(kk)).property == property)
+                        found = true;
+                }
             }
         }
         if (!found) {
@@ -682,6 +724,8 @@ void QQuickState::apply(QQuickTransition *trans, QQuickState *revert)
             a.reverseEvent = d->revertList.at(ii).reverseEvent();
             if (a.event && a.event->isRewindable())
                 a.event->saveCurrentValues();
+            if (!a.event)
+                applyIndex[qquickstate_propertyKey(a.property)] << applyList.count();
             applyList << a;
             // Store these special reverts in the reverting list
             if (a.event)
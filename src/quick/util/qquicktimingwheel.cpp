@@ -0,0 +1,250 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qquicktimingwheel_p.h"
+
+QT_BEGIN_NAMESPACE
+
+QQuickTimingWheel::QQuickTimingWheel()
+{
+    clear();
+}
+
+/*
+    Makes room for ids up to \a ids - 1, so that inserting them does not allocate.
+*/
+void QQuickTimingWheel::reserve(int ids)
+{
+    int oldSize = m_level.size();
+    if (ids <= oldSize)
+        return;
+    m_time.resize(ids);
+    m_next.resize(ids);
+    m_prev.resize(ids);
+    m_level.resize(ids);
+    m_slot.resize(ids);
+    for (int i = oldSize; i < ids; ++i)
+        m_level[i] = NoLevel;
+}
+
+void QQuickTimingWheel::clear(int now)
+{
+    m_now = now;
+    m_count = 0;
+    for (int i = 0; i <= Levels; ++i)
+        m_levelCount[i] = 0;
+    for (int i = 0; i <= Levels * Slots; ++i)
+        m_heads[i] = -1;
+    m_level.fill(NoLevel);
+}
+
+/*
+    Schedules \a id to expire at \a time, replacing any earlier schedule for it.
+*/
+void QQuickTimingWheel::insert(int id, int time)
+{
+    Q_ASSERT(id >= 0);
+    if (id >= m_level.size())
+        reserve(qMax(id + 1, m_level.size() * 2));
+    if (m_level.at(id) != NoLevel)
+        unlink(id);
+    else
+        ++m_count;
+    m_time[id] = time;
+    place(id);
+}
+
+void QQuickTimingWheel::remove(int id)
+{
+    if (!contains(id))
+        return;
+    unlink(id);
+    --m_count;
+}
+
+void QQuickTimingWheel::link(int id, int level, int slot)
+{
+    int *list = head(level, slot);
+    m_prev[id] = -1;
+    m_next[id] = *list;
+    if (*list != -1)
+        m_prev[*list] = id;
+    *list = id;
+    m_level[id] = level;
+    m_slot[id] = slot;
+    ++m_levelCount[level];
+}
+
+void QQuickTimingWheel::unlink(int id)
+{
+    int level = m_level.at(id);
+    int prev = m_prev.at(id);
+    int next = m_next.at(id);
+    if (prev != -1)
+        m_next[prev] = next;
+    else
+        *head(level, m_slot.at(id)) = next;
+    if (next != -1)
+        m_prev[next] = prev;
+    m_level[id] = NoLevel;
+    --m_levelCount[level];
+}
+
+/*
+    Links \a id into the level whose slots are the finest that still reach its time.
+    Times further away than the whole wheel go into the slot of the top level which
+    is cascaded last, and are placed again from there.
+*/
+void QQuickTimingWheel::place(int id)
+{
+    int time = m_time.at(id);
+    int delta = time - m_now;
+    if (delta <= 0) {
+        link(id, DueLevel, 0);
+        return;
+    }
+    for (int level = 0; level < Levels; ++level) {
+        if (level == Levels - 1 || delta < (1 << (Bits * (level + 1)))) {
+            int base = delta < (1 << (Bits * (level + 1))) ? time : m_now;
+            link(id, level, (base >> (Bits * level)) & SlotMask);
+            return;
+        }
+    }
+}
+
+void QQuickTimingWheel::take(int *list, QVector<int> *out)
+{
+    for (int id = *list; id != -1; id = m_next.at(id)) {
+        --m_levelCount[m_level.at(id)];
+        m_level[id] = NoLevel;
+        out->append(id);
+    }
+    *list = -1;
+}
+
+void QQuickTimingWheel::cascade(int level)
+{
+    m_scratch.resize(0);
+    take(head(level, (m_now >> (Bits * level)) & SlotMask), &m_scratch);
+    for (int i = 0; i < m_scratch.size(); ++i)
+        place(m_scratch.at(i));
+}
+
+/*
+    Moves the wheel forward to \a time, appending the ids which expired on the way
+    to \a expired. Ids which were already overdue come first, followed by the rest
+    in the order of their times. Expired ids are no longer scheduled.
+*/
+void QQuickTimingWheel::advance(int time, QVector<int> *expired)
+{
+    int oldCount = expired->size();
+    if (time < m_now) {
+        //The clock was reset, so everything has to be placed relative to the new time
+        m_scratch.resize(0);
+        for (int i = 0; i <= Levels * Slots; ++i)
+            take(&m_heads[i], &m_scratch);
+        m_now = time;
+        for (int i = 0; i < m_scratch.size(); ++i)
+            place(m_scratch.at(i));
+    }
+
+    take(head(DueLevel, 0), expired);
+    while (m_now < time) {
+        if (m_count == expired->size() - oldCount) {
+            m_now = time;
+            break;
+        }
+        //Skip over time for which the lower levels have nothing to expire or cascade
+        int level = 0;
+        while (level < Levels - 1 && !m_levelCount[level])
+            ++level;
+        if (level > 0) {
+            int next = m_now | ((1 << (Bits * level)) - 1);
+            if (next >= time) {
+                m_now = time;
+                break;
+            }
+            m_now = next;
+        }
+
+        ++m_now;
+        for (int l = 1; l < Levels && !((m_now >> (Bits * (l - 1))) & SlotMask); ++l)
+            cascade(l);
+        take(head(DueLevel, 0), expired);//Cascaded entries which are due right now
+        take(head(0, m_now & SlotMask), expired);
+    }
+    m_count -= expired->size() - oldCount;
+}
+
+/*
+    Returns the earliest scheduled time, or -1 if nothing is scheduled.
+*/
+int QQuickTimingWheel::nextTime() const
+{
+    if (!m_count)
+        return -1;
+    if (m_heads[Levels * Slots] != -1)
+        return m_now;
+    bool found = false;
+    int earliest = 0;
+    for (int level = 0; level < Levels; ++level) {
+        if (!m_levelCount[level])
+            continue;
+        int current = (m_now >> (Bits * level)) & SlotMask;
+        for (int i = 1; i <= Slots; ++i) {
+            int id = m_heads[level * Slots + ((current + i) & SlotMask)];
+            if (id == -1)
+                continue;
+            for (; id != -1; id = m_next.at(id)) {
+                if (!found || m_time.at(id) < earliest) {
+                    earliest = m_time.at(id);
+                    found = true;
+                }
+            }
+            //Over long runs, clamped entries can be spread across any slot of the top level
+            if (level < Levels - 1)
+                break;
+        }
+    }
+    return earliest;
+}
+
+QT_END_NAMESPACE
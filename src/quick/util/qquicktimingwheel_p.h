@@ -0,0 +1,121 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtQuick module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QQUICKTIMINGWHEEL_P_H
+#define QQUICKTIMINGWHEEL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qtquickglobal_p.h>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Schedules integer ids (such as particle or sprite indexes) at millisecond times.
+
+    This is a hierarchical timing wheel: each level has 64 slots, with each slot of a level
+    covering 64 times the span of a slot of the level below. Entries are kept in intrusive
+    lists indexed by id, so scheduling, rescheduling and removing an id are O(1) and do not
+    allocate once the id range has been reserved.
+*/
+class Q_QUICK_PRIVATE_EXPORT QQuickTimingWheel
+{
+public:
+    QQuickTimingWheel();
+
+    void reserve(int ids);
+    void clear(int now = 0);
+
+    void insert(int id, int time);
+    void remove(int id);
+    bool contains(int id) const { return id >= 0 && id < m_level.size() && m_level.at(id) != NoLevel; }
+    int time(int id) const { return contains(id) ? m_time.at(id) : -1; }
+
+    bool isEmpty() const { return m_count == 0; }
+    int count() const { return m_count; }
+    int currentTime() const { return m_now; }
+    int nextTime() const;
+
+    void advance(int time, QVector<int> *expired);
+
+private:
+    enum {
+        Bits = 6,
+        Slots = 1 << Bits,
+        SlotMask = Slots - 1,
+        Levels = 4,
+        DueLevel = Levels,
+        NoLevel = -1
+    };
+
+    int *head(int level, int slot) { return &m_heads[level * Slots + slot]; }
+    void link(int id, int level, int slot);
+    void unlink(int id);
+    void place(int id);
+    void cascade(int level);
+    void take(int *list, QVector<int> *out);
+
+    int m_now;
+    int m_count;
+    int m_levelCount[Levels + 1];
+    int m_heads[Levels * Slots + 1];//The extra list holds ids scheduled at or before m_now
+
+    QVector<int> m_time;
+    QVector<int> m_next;
+    QVector<int> m_prev;
+    QVector<signed char> m_level;
+    QVector<signed char> m_slot;
+    QVector<int> m_scratch;
+};
+
+QT_END_NAMESPACE
+
+#endif // QQUICKTIMINGWHEEL_P_H
@@ -99,6 +99,8 @@ void QQuickUtilModule::defineModule()
     qmlRegisterType<QQuickRotationAnimator>("QtQuick", 2, 2, "RotationAnimator");
     qmlRegisterType<QQuickOpacityAnimator>("QtQuick", 2, 2, "OpacityAnimator");
     qmlRegisterType<QQuickUniformAnimator>("QtQuick", 2, 2, "UniformAnimator");
+    qmlRegisterType<QQuickPathAnimator>("QtQuick", 2, 2, "PathAnimator");
+    qmlRegisterType<QQuickColorAnimator>("QtQuick", 2, 2, "ColorAnimator");
 
     qmlRegisterType<QQuickStateOperation>();
 
@@ -5,6 +5,7 @@ SOURCES += \
     $$PWD/qquicksystempalette.cpp \
     $$PWD/qquickspringanimation.cpp \
     $$PWD/qquicksmoothedanimation.cpp \
+    $$PWD/qquickfollowerjob.cpp \
     $$PWD/qquickanimationcontroller.cpp \
     $$PWD/qquickstate.cpp\
     $$PWD/qquicktransitionmanager.cpp \
@@ -14,6 +15,7 @@ SOURCES += \
     $$PWD/qquicktransition.cpp \
     $$PWD/qquicktimeline.cpp \
     $$PWD/qquickpixmapcache.cpp \
+    $$PWD/qquickcompressedtexture.cpp \
     $$PWD/qquickbehavior.cpp \
     $$PWD/qquickfontloader.cpp \
     $$PWD/qquickstyledtext.cpp \
@@ -26,7 +28,8 @@ SOURCES += \
     $$PWD/qquickanimator.cpp \
     $$PWD/qquickanimatorjob.cpp \
     $$PWD/qquickanimatorcontroller.cpp \
-    $$PWD/qquickprofiler.cpp
+    $$PWD/qquickprofiler.cpp \
+    $$PWD/qquicktimingwheel.cpp
 
 HEADERS += \
     $$PWD/qquickapplication_p.h\
@@ -38,6 +41,7 @@ HEADERS += \
     $$PWD/qquickanimationcontroller_p.h \
     $$PWD/qquicksmoothedanimation_p.h \
     $$PWD/qquicksmoothedanimation_p_p.h \
+    $$PWD/qquickfollowerjob_p.h \
     $$PWD/qquickstate_p.h\
     $$PWD/qquickstatechangescript_p.h \
     $$PWD/qquickpropertychanges_p.h \
@@ -47,6 +51,7 @@ HEADERS += \
     $$PWD/qquicktransition_p.h \
     $$PWD/qquicktimeline_p_p.h \
     $$PWD/qquickpixmapcache_p.h \
+    $$PWD/qquickcompressedtexture_p.h \
     $$PWD/qquickbehavior_p.h \
     $$PWD/qquickfontloader_p.h \
     $$PWD/qquickstyledtext_p.h \
@@ -60,4 +65,5 @@ HEADERS += \
     $$PWD/qquickanimator_p_p.h \
     $$PWD/qquickanimatorjob_p.h \
     $$PWD/qquickanimatorcontroller_p.h \
-    $$PWD/qquickprofiler_p.h
+    $$PWD/qquickprofiler_p.h \
+    $$PWD/qquicktimingwheel_p.h
@@ -57,6 +57,7 @@ private slots:
     void test_basic();
     void test_move();
     void test_affectedSignal();
+    void test_columns();
 };
 
 void tst_qquickcustomaffector::initTestCase()
@@ -138,6 +139,33 @@ void tst_qquickcustomaffector::test_affectedSignal()
     delete view;
 }
 
+void tst_qquickcustomaffector::test_columns()
+{
+    QQuickView* view = createView(testFileUrl("columns.qml"), 600);
+    QQuickParticleSystem* system = view->rootObject()->findChild<QQuickParticleSystem*>("system");
+    ensureAnimTime(600, system->m_animation);
+
+    QVERIFY(extremelyFuzzyCompare(system->groupData[0]->size(), 500, 10));
+    foreach (QQuickParticleData *d, system->groupData[0]->data) {
+        if (d->t == -1)
+            continue; //Particle data unused
+        if (!d->stillAlive())
+            continue; //parameters no longer get set once you die
+
+        QVERIFY(myFuzzyCompare(d->curX(), 50.0));
+        QVERIFY(myFuzzyCompare(d->curY(), 50.0));
+        QVERIFY(myFuzzyCompare(d->curVX(), 50.0));
+        QVERIFY(myFuzzyCompare(d->curVY(), 50.0));
+        QVERIFY(myFuzzyCompare(d->curAX(), 50.0));
+        QVERIFY(myFuzzyCompare(d->curAY(), 50.0));
+        QCOMPARE(d->lifeSpan, 0.5f);
+        QCOMPARE(d->size, 32.f);
+        QCOMPARE(d->endSize, 64.f);
+        QVERIFY(myFuzzyLEQ(d->t, ((qreal)system->timeInt/1000.0)));
+    }
+    delete view;
+}
+
 QTEST_MAIN(tst_qquickcustomaffector);
 
 #include "tst_qquickcustomaffector.moc"
@@ -57,6 +57,7 @@ Rectangle {
         }
 
         Gravity {
+            objectName: "gravity"
             acceleration: 1000
             angle: 45
         }
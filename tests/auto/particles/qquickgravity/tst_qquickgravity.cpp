@@ -55,6 +55,7 @@ public:
 private slots:
     void initTestCase();
     void test_basic();
+    void test_disabled();
 };
 
 void tst_qquickgravity::initTestCase()
@@ -76,8 +77,8 @@ void tst_qquickgravity::test_basic()
             continue; //Particle data unused or dead
 
         float t = ((qreal)system->timeInt/1000.0) - d->t;
-        QVERIFY(extremelyFuzzyCompare(d->vx, t*mag, 20.0f));
-        QVERIFY(extremelyFuzzyCompare(d->vy, t*mag, 20.0f));
+        QVERIFY(extremelyFuzzyCompare(d->curVX(), t*mag, 20.0f));
+        QVERIFY(extremelyFuzzyCompare(d->curVY(), t*mag, 20.0f));
         QCOMPARE(d->lifeSpan, 0.5f);
         QCOMPARE(d->size, 32.f);
         QCOMPARE(d->endSize, 32.f);
@@ -86,6 +87,27 @@ void tst_qquickgravity::test_basic()
     delete view;
 }
 
+void tst_qquickgravity::test_disabled()
+{
+    QQuickView* view = createView(testFileUrl("basic.qml"), 600);
+    QQuickParticleSystem* system = view->rootObject()->findChild<QQuickParticleSystem*>("system");
+    QObject* gravity = view->rootObject()->findChild<QObject*>("gravity");
+    QVERIFY(gravity);
+    ensureAnimTime(600, system->m_animation);
+
+    //Particles affected so far must stop accelerating, not keep what was added to them
+    gravity->setProperty("enabled", false);
+    ensureAnimTime(700, system->m_animation);
+    foreach (QQuickParticleData *d, system->groupData[0]->data) {
+        if (d->t == -1 || !d->stillAlive())
+            continue; //Particle data unused or dead
+
+        QVERIFY(myFuzzyCompare(d->curAX(), 0.0f));
+        QVERIFY(myFuzzyCompare(d->curAY(), 0.0f));
+    }
+    delete view;
+}
+
 QTEST_MAIN(tst_qquickgravity);
 
 #include "tst_qquickgravity.moc"
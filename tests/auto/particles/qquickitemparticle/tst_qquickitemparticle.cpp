@@ -56,6 +56,7 @@ public:
 private slots:
     void initTestCase();
     void test_basic();
+    void test_pool();
 };
 
 void tst_qquickitemparticle::initTestCase()
@@ -95,6 +96,19 @@ void tst_qquickitemparticle::test_basic()
     delete view;
 }
 
+void tst_qquickitemparticle::test_pool()
+{
+    QQuickView* view = createView(testFileUrl("pool.qml"), 1000);
+    QQuickParticleSystem* system = view->rootObject()->findChild<QQuickParticleSystem*>("system");
+    ensureAnimTime(1000, system->m_animation);
+
+    //About 100 particles were emitted, but only about 10 live at once
+    int created = system->property("created").toInt();
+    QVERIFY(created > 0);
+    QVERIFY(created < 50);
+    delete view;
+}
+
 QTEST_MAIN(tst_qquickitemparticle);
 
 #include "tst_qquickitemparticle.moc"
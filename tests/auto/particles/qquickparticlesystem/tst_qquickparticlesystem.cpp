@@ -55,6 +55,7 @@ public:
 private slots:
     void initTestCase();
     void test_basic();
+    void test_burst();
 };
 
 void tst_qquickparticlesystem::initTestCase()
@@ -92,6 +93,35 @@ void tst_qquickparticlesystem::test_basic()
     QVERIFY(extremelyFuzzyCompare(stillAlive, 500, 5));//Small simulation variance is permissible.
 }
 
+void tst_qquickparticlesystem::test_burst()
+{
+    QQuickView* view = createView(testFileUrl("burst.qml"), 100);
+    QQuickParticleSystem* system = view->rootObject()->findChild<QQuickParticleSystem*>("system");
+    QObject* emitter = view->rootObject()->findChild<QObject*>("emitter");
+    QVERIFY(emitter);
+    ensureAnimTime(100, system->m_animation);
+    QMetaObject::invokeMethod(emitter, "burst", Q_ARG(int, 1000));
+    ensureAnimTime(400, system->m_animation);
+
+    //Growing in doubling steps overshoots by less than the burst itself
+    QVERIFY(system->groupData[0]->size() >= 1000);
+    QVERIFY(system->groupData[0]->size() < 2000);
+    int stillAlive = 0;
+    QSet<int> indexes;
+    foreach (QQuickParticleData *d, system->groupData[0]->data) {
+        if (d->t == -1)
+            continue; //Particle data unused
+
+        if (d->stillAlive())
+            stillAlive++;
+        QVERIFY(!indexes.contains(d->index));
+        indexes << d->index;
+        QCOMPARE(d->lifeSpan, 5.0f);
+    }
+    QCOMPARE(stillAlive, 1000);
+    delete view;
+}
+
 QTEST_MAIN(tst_qquickparticlesystem);
 
 #include "tst_qquickparticlesystem.moc"
@@ -55,6 +55,7 @@ public:
 private slots:
     void initTestCase();
     void test_basic();
+    void test_period();
 };
 
 void tst_qquickturbulence::initTestCase()
@@ -86,6 +87,33 @@ void tst_qquickturbulence::test_basic()
     delete view;
 }
 
+void tst_qquickturbulence::test_period()
+{
+    QQuickView* view = createView(testFileUrl("period.qml"), 600);
+    QQuickParticleSystem* system = view->rootObject()->findChild<QQuickParticleSystem*>("system");
+    QQuickItem* turbulence = view->rootObject()->findChild<QQuickItem*>("turbulence");
+    QVERIFY(turbulence);
+    ensureAnimTime(300, system->m_animation);
+
+    //Resizing scales the existing field rather than rebuilding it
+    view->rootObject()->setWidth(480);
+    view->rootObject()->setHeight(480);
+    QCOMPARE(turbulence->width(), 480.0);
+    ensureAnimTime(600, system->m_animation);
+
+    QVERIFY(extremelyFuzzyCompare(system->groupData[0]->size(), 500, 10));
+    foreach (QQuickParticleData *d, system->groupData[0]->data) {
+        if (d->t == -1)
+            continue; //Particle data unused
+
+        QVERIFY(d->vx != 0.f);
+        QVERIFY(d->vy != 0.f);
+        QCOMPARE(d->lifeSpan, 0.5f);
+        QVERIFY(myFuzzyLEQ(d->t, ((qreal)system->timeInt/1000.0)));
+    }
+    delete view;
+}
+
 QTEST_MAIN(tst_qquickturbulence);
 
 #include "tst_qquickturbulence.moc"
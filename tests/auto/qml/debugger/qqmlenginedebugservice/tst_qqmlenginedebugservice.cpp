@@ -109,6 +109,7 @@ private slots:
 
     void watch_property();
     void watch_object();
+    void watch_batched();
     void watch_expression();
     void watch_expression_data();
     void watch_context();
@@ -130,6 +131,7 @@ private slots:
     void resetBindingForObject();
     void setMethodBody();
     void queryObjectTree();
+    void queryObjectPage();
     void setBindingInStates();
 
     void regression_QTCREATORBUG_7451();
@@ -496,6 +498,53 @@ void tst_QQmlEngineDebugService::watch_object()
     QCOMPARE(newHeight, origHeight * 2);
 }
 
+void tst_QQmlEngineDebugService::watch_batched()
+{
+    QmlDebugObjectReference obj = findRootObject();
+
+    bool success;
+
+    QList<QByteArray> properties;
+    properties << "width" << "height";
+    quint32 id = m_dbg->addBatchedWatch(obj, properties, 100, &success);
+    QVERIFY(success);
+    QVERIFY(QQmlDebugTest::waitForSignal(m_dbg, SIGNAL(result())));
+    QCOMPARE(m_dbg->valid(), true);
+
+    // the initial values
+    QVERIFY(QQmlDebugTest::waitForSignal(m_dbg, SIGNAL(valuesChanged(int))));
+
+    QSignalSpy batchSpy(m_dbg, SIGNAL(valuesChanged(int)));
+    QSignalSpy valueSpy(m_dbg, SIGNAL(valueChanged(QByteArray,QVariant)));
+
+    int origWidth = m_rootItem->property("width").toInt();
+    int origHeight = m_rootItem->property("height").toInt();
+    for (int i = 1; i <= 10; ++i)
+        m_rootItem->setProperty("width", origWidth + i);
+    m_rootItem->setProperty("height", origHeight * 2);
+    QVERIFY(QQmlDebugTest::waitForSignal(m_dbg, SIGNAL(valuesChanged(int))));
+
+    // all changes within the interval arrive in one message, with the last value of each property
+    QCOMPARE(batchSpy.count(), 1);
+    QCOMPARE(batchSpy.at(0).at(0).toInt(), 2);
+    QCOMPARE(valueSpy.count(), 2);
+    QCOMPARE(valueSpy.at(0).at(0).toByteArray(), QByteArray("height"));
+    QCOMPARE(valueSpy.at(0).at(1).value<QVariant>().toInt(), origHeight * 2);
+    QCOMPARE(valueSpy.at(1).at(0).toByteArray(), QByteArray("width"));
+    QCOMPARE(valueSpy.at(1).at(1).value<QVariant>().toInt(), origWidth + 10);
+
+    m_dbg->removeWatch(id, &success);
+    QVERIFY(success);
+    QVERIFY(QQmlDebugTest::waitForSignal(m_dbg, SIGNAL(result())));
+    QCOMPARE(m_dbg->valid(), true);
+
+    batchSpy.clear();
+    m_rootItem->setProperty("width", origWidth);
+    m_rootItem->setProperty("height", origHeight);
+    QTest::qWait(200);
+    QCOMPARE(batchSpy.count(), 0);
+}
+
 void tst_QQmlEngineDebugService::watch_expression()
 {
     QFETCH(QString, expr);
@@ -1187,6 +1236,47 @@ void tst_QQmlEngineDebugService::queryObjectTree()
     QCOMPARE(findProperty(animation.properties,"duration").value.toInt(), 100);
 }
 
+void tst_QQmlEngineDebugService::queryObjectPage()
+{
+    QmlDebugObjectReference rootObject = findRootObject();
+    QVERIFY(rootObject.debugId != -1);
+
+    QObjectList children;
+    foreach (QObject *child, m_rootItem->children()) {
+        if (!qobject_cast<QQmlContext *>(child))
+            children << child;
+    }
+    QVERIFY(children.count() >= 3);
+
+    bool success;
+    m_dbg->queryObjectPage(rootObject, 1, 1, 2, &success);
+    QVERIFY(success);
+    QVERIFY(QQmlDebugTest::waitForSignal(m_dbg, SIGNAL(result())));
+
+    QmlDebugObjectReference obj = m_dbg->object();
+    QCOMPARE(obj.debugId, rootObject.debugId);
+    QCOMPARE(obj.totalChildCount, children.count());
+    QCOMPARE(obj.children.count(), 2);
+    QCOMPARE(findProperty(obj.properties, "width").value.toInt(), m_rootItem->property("width").toInt());
+
+    for (int i = 0; i < 2; ++i) {
+        const QmlDebugObjectReference &child = obj.children.at(i);
+        QCOMPARE(child.debugId, QQmlDebugService::idForObject(children.at(i + 1)));
+        // expanded one level, but not beyond
+        QVERIFY(child.totalChildCount >= 0);
+        QVERIFY(child.children.count() <= 2);
+        foreach (const QmlDebugObjectReference &grandChild, child.children)
+            QCOMPARE(grandChild.totalChildCount, -1);
+    }
+
+    // an offset past the end gives an empty page
+    m_dbg->queryObjectPage(rootObject, 0, children.count(), 2, &success);
+    QVERIFY(success);
+    QVERIFY(QQmlDebugTest::waitForSignal(m_dbg, SIGNAL(result())));
+    QCOMPARE(m_dbg->object().totalChildCount, children.count());
+    QCOMPARE(m_dbg->object().children.count(), 0);
+}
+
 int main(int argc, char *argv[])
 {
     int _argc = argc + 1;
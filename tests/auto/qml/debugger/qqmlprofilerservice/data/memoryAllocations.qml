@@ -0,0 +1,12 @@
+import QtQuick 2.0
+
+Item {
+    property var list: [1, 2, 3].map(function(x) { return { value: x }; })
+
+    Repeater {
+        model: 3
+        Item { property var data: ({ index: index }) }
+    }
+
+    Component.onCompleted: console.log("created")
+}
@@ -0,0 +1,18 @@
+import QtQuick.Window 2.0
+import QtQuick 2.0
+
+Window
+{
+    Column {
+        Rectangle { id: first; width: 10; height: 10; color: "blue" }
+        Rectangle { width: 10; height: 10; color: "red" }
+    }
+
+    Timer {
+        interval: 10
+        running: true
+        onTriggered: first.height = 20
+    }
+
+    onFrameSwapped: if (first.height == 20) console.log("polished");
+}
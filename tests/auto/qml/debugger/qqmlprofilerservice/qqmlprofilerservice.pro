@@ -16,4 +16,5 @@ DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
 OTHER_FILES += \
     data/pixmapCacheTest.qml \
     data/controlFromJS.qml \
-    data/signalSourceLocation.qml
+    data/signalSourceLocation.qml \
+    data/polishTest.qml
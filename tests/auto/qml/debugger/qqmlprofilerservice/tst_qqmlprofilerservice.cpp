@@ -61,6 +61,7 @@ struct QQmlProfilerData
     int column;         //used by RangeLocation
     int framerate;      //used by animation events
     int animationcount; //used by animation events
+    qint64 size;        //used by memory allocations
 
     QByteArray toByteArray() const;
 };
@@ -79,6 +80,8 @@ public:
         Complete, // end of transmission
         PixmapCacheEvent,
         SceneGraphFrame,
+        MemoryAllocation,
+        Batch,
 
         MaximumMessage
     };
@@ -126,21 +129,39 @@ public:
         SceneGraphWindowsRenderShow,
         SceneGraphWindowsAnimations,
         SceneGraphWindowsPolishFrame,
+        SceneGraphPolishItems,
 
         MaximumSceneGraphFrameType
     };
 
+    enum MemoryType {
+        ObjectMemory,
+        JavaScriptMemory,
+        JavaScriptHeap,
+
+        MaximumMemoryType
+    };
+
+    enum TransportFlag {
+        BatchedTransport    = 1 << 0,
+        CompressedTransport = 1 << 1
+    };
+
     QQmlProfilerClient(QQmlDebugConnection *connection)
         : QQmlDebugClient(QLatin1String("CanvasFrameRate"), connection)
+        , batches(0)
     {
     }
 
     QList<QQmlProfilerData> traceMessages;
+    int batches;
 
-    void setTraceState(bool enabled) {
+    void setTraceState(bool enabled, int transportFlags = 0) {
         QByteArray message;
         QDataStream stream(&message, QIODevice::WriteOnly);
         stream << enabled;
+        if (transportFlags)
+            stream << -1 << transportFlags;
         sendMessage(message);
     }
 
@@ -169,7 +190,8 @@ private:
     QQmlDebugConnection *m_connection;
     QQmlProfilerClient *m_client;
 
-    void connect(bool block, const QString &testFile);
+    void connect(bool block, const QString &testFile,
+                 const QStringList &environment = QStringList());
 
 private slots:
     void cleanup();
@@ -179,9 +201,13 @@ private slots:
     void nonBlockingConnect();
     void pixmapCacheData();
     void scenegraphData();
+    void polishStatistics();
     void profileOnExit();
     void controlFromJS();
     void signalSourceLocation();
+    void memoryAllocations();
+    void batchedTransport_data();
+    void batchedTransport();
 };
 
 void QQmlProfilerClient::messageReceived(const QByteArray &message)
@@ -197,6 +223,7 @@ void QQmlProfilerClient::messageReceived(const QByteArray &message)
     data.line = -1;
     data.framerate = -1;
     data.animationcount = -1;
+    data.size = -1;
 
     stream >> data.time >> data.messageType;
 
@@ -229,6 +256,32 @@ void QQmlProfilerClient::messageReceived(const QByteArray &message)
         emit complete();
         return;
     }
+    case QQmlProfilerClient::Batch: {
+        bool compressed;
+        QByteArray batch;
+        stream >> compressed >> batch;
+        QVERIFY(stream.atEnd());
+        ++batches;
+        if (compressed)
+            batch = qUncompress(batch);
+        QVERIFY(!batch.isEmpty());
+
+        QDataStream batchStream(&batch, QIODevice::ReadOnly);
+        qint64 time = 0;
+        while (!batchStream.atEnd()) {
+            qint64 delta;
+            QByteArray rest;
+            batchStream >> delta >> rest;
+            time += delta;
+
+            QByteArray unpacked;
+            QDataStream out(&unpacked, QIODevice::WriteOnly);
+            out << time;
+            unpacked.append(rest);
+            messageReceived(unpacked);
+        }
+        return;
+    }
     case QQmlProfilerClient::RangeStart: {
         stream >> data.detailType;
         QVERIFY(data.detailType >= 0 && data.detailType < QQmlProfilerClient::MaximumRangeType);
@@ -285,9 +338,26 @@ void QQmlProfilerClient::messageReceived(const QByteArray &message)
         case QQmlProfilerClient::SceneGraphWindowsAnimations: stream >> subtime_1; break;
             // WindowsRenderWindow: polish time
         case QQmlProfilerClient::SceneGraphWindowsPolishFrame: stream >> subtime_1; break;
+            // PolishItems: item type, item count, polish time, iterations
+        case QQmlProfilerClient::SceneGraphPolishItems: {
+            int iterations;
+            stream >> data.detailData >> data.animationcount >> subtime_1 >> iterations;
+            QVERIFY(!data.detailData.isEmpty());
+            QVERIFY(data.animationcount > 0);
+            QVERIFY(iterations > 0);
+            break;
+        }
         }
         break;
     }
+    case QQmlProfilerClient::MemoryAllocation: {
+        QString typeName;
+        stream >> data.detailType >> typeName >> data.detailData >> data.line >> data.column
+               >> data.size;
+        QVERIFY(data.detailType >= 0 && data.detailType < QQmlProfilerClient::MaximumMemoryType);
+        QVERIFY(data.size > 0);
+        break;
+    }
     default:
         QString failMsg = QString("Unknown message type:") + data.messageType;
         QFAIL(qPrintable(failMsg));
@@ -297,7 +367,8 @@ void QQmlProfilerClient::messageReceived(const QByteArray &message)
     traceMessages.append(data);
 }
 
-void tst_QQmlProfilerService::connect(bool block, const QString &testFile)
+void tst_QQmlProfilerService::connect(bool block, const QString &testFile,
+                                      const QStringList &environment)
 {
     // ### Still using qmlscene due to QTBUG-33377
     const QString executable = QLibraryInfo::location(QLibraryInfo::BinariesPath) + "/qmlscene";
@@ -310,6 +381,8 @@ void tst_QQmlProfilerService::connect(bool block, const QString &testFile)
     arguments << QQmlDataTest::instance()->testFile(testFile);
 
     m_process = new QQmlDebugProcess(executable, this);
+    if (!environment.isEmpty())
+        m_process->setEnvironment(QProcess::systemEnvironment() + environment);
     m_process->start(QStringList() << arguments);
     QVERIFY2(m_process->waitForSessionStart(), "Could not launch application, or did not get 'Waiting for connection'.");
 
@@ -477,6 +550,32 @@ void tst_QQmlProfilerService::scenegraphData()
     QVERIFY(loopcheck >= 2);
 }
 
+void tst_QQmlProfilerService::polishStatistics()
+{
+    connect(true, "polishTest.qml");
+    QVERIFY(m_client);
+    QTRY_COMPARE(m_client->state(), QQmlDebugClient::Enabled);
+
+    m_client->setTraceState(true);
+
+    while (!m_process->output().contains(QLatin1String("polished")))
+        QVERIFY(QQmlDebugTest::waitForSignal(m_process, SIGNAL(readyReadStandardOutput())));
+    m_client->setTraceState(false);
+
+    QVERIFY2(QQmlDebugTest::waitForSignal(m_client, SIGNAL(complete())), "No trace received in time.");
+
+    // the Column has to be polished after its first child grew
+    bool columnPolished = false;
+    foreach (const QQmlProfilerData &msg, m_client->traceMessages) {
+        if (msg.messageType == QQmlProfilerClient::SceneGraphFrame
+                && msg.detailType == QQmlProfilerClient::SceneGraphPolishItems
+                && msg.detailData == QLatin1String("QQuickColumn")) {
+            columnPolished = true;
+        }
+    }
+    QVERIFY(columnPolished);
+}
+
 void tst_QQmlProfilerService::profileOnExit()
 {
     connect(true, "exit.qml");
@@ -543,6 +642,69 @@ void tst_QQmlProfilerService::signalSourceLocation()
     QCOMPARE(m_client->traceMessages.last().detailType, (int)QQmlProfilerClient::EndTrace);
 }
 
+void tst_QQmlProfilerService::memoryAllocations()
+{
+    connect(true, "memoryAllocations.qml", QStringList() << QLatin1String("QML_PROFILE_MEMORY=1"));
+    QVERIFY(m_client);
+    QTRY_COMPARE(m_client->state(), QQmlDebugClient::Enabled);
+
+    m_client->setTraceState(true);
+    while (!(m_process->output().contains(QLatin1String("created"))))
+        QVERIFY(QQmlDebugTest::waitForSignal(m_process, SIGNAL(readyReadStandardOutput())));
+    m_client->setTraceState(false);
+    QVERIFY2(QQmlDebugTest::waitForSignal(m_client, SIGNAL(complete())), "No trace received in time.");
+
+    bool objectMemory = false;
+    bool javaScriptMemory = false;
+    foreach (const QQmlProfilerData &msg, m_client->traceMessages) {
+        if (msg.messageType != QQmlProfilerClient::MemoryAllocation)
+            continue;
+        QVERIFY(msg.detailData.endsWith("memoryAllocations.qml"));
+        if (msg.detailType == QQmlProfilerClient::ObjectMemory)
+            objectMemory = true;
+        else if (msg.detailType == QQmlProfilerClient::JavaScriptMemory)
+            javaScriptMemory = true;
+    }
+    QVERIFY(objectMemory);
+    QVERIFY(javaScriptMemory);
+}
+
+void tst_QQmlProfilerService::batchedTransport_data()
+{
+    QTest::addColumn<int>("transportFlags");
+    QTest::newRow("batched") << (int)QQmlProfilerClient::BatchedTransport;
+    QTest::newRow("compressed") << (int)(QQmlProfilerClient::BatchedTransport
+                                         | QQmlProfilerClient::CompressedTransport);
+}
+
+void tst_QQmlProfilerService::batchedTransport()
+{
+    QFETCH(int, transportFlags);
+
+    connect(true, "test.qml");
+    QVERIFY(m_client);
+    QTRY_COMPARE(m_client->state(), QQmlDebugClient::Enabled);
+
+    m_client->setTraceState(true, transportFlags);
+    m_client->setTraceState(false, transportFlags);
+    QVERIFY2(QQmlDebugTest::waitForSignal(m_client, SIGNAL(complete())), "No trace received in time.");
+
+    QVERIFY(m_client->batches > 0);
+    QVERIFY(m_client->traceMessages.count());
+
+    // must start with "StartTrace"
+    QCOMPARE(m_client->traceMessages.first().messageType, (int)QQmlProfilerClient::Event);
+    QCOMPARE(m_client->traceMessages.first().detailType, (int)QQmlProfilerClient::StartTrace);
+
+    // must end with "EndTrace"
+    QCOMPARE(m_client->traceMessages.last().messageType, (int)QQmlProfilerClient::Event);
+    QCOMPARE(m_client->traceMessages.last().detailType, (int)QQmlProfilerClient::EndTrace);
+
+    // timestamps survive the delta encoding
+    foreach (const QQmlProfilerData &msg, m_client->traceMessages)
+        QVERIFY(msg.time >= 0);
+}
+
 QTEST_MAIN(tst_QQmlProfilerService)
 
 #include "tst_qqmlprofilerservice.moc"
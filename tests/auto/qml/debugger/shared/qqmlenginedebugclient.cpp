@@ -154,6 +154,24 @@ quint32 QQmlEngineDebugClient::addWatch(
     return 0;
 }
 
+quint32 QQmlEngineDebugClient::addBatchedWatch(
+        const QmlDebugObjectReference &object, const QList<QByteArray> &properties,
+        int interval, bool *success)
+{
+    quint32 id = -1;
+    *success = false;
+    if (state() == QQmlDebugClient::Enabled) {
+        id = getId();
+        QByteArray message;
+        QDataStream ds(&message, QIODevice::WriteOnly);
+        ds << QByteArray("WATCH_PROPERTIES_BATCHED") << id << object.debugId
+           << properties << interval;
+        sendMessage(message);
+        *success = true;
+    }
+    return id;
+}
+
 void QQmlEngineDebugClient::removeWatch(quint32 id, bool *success)
 {
     *success = false;
@@ -253,6 +271,25 @@ quint32 QQmlEngineDebugClient::queryObjectRecursive(
     return id;
 }
 
+quint32 QQmlEngineDebugClient::queryObjectPage(
+        const QmlDebugObjectReference &object, int depth, int childOffset,
+        int childLimit, bool *success)
+{
+    m_object = QmlDebugObjectReference();
+    quint32 id = -1;
+    *success = false;
+    if (state() == QQmlDebugClient::Enabled && object.debugId != -1) {
+        id = getId();
+        QByteArray message;
+        QDataStream ds(&message, QIODevice::WriteOnly);
+        ds << QByteArray("FETCH_OBJECT_PAGE") << id << object.debugId << depth
+           << childOffset << childLimit << true;
+        sendMessage(message);
+        *success = true;
+    }
+    return id;
+}
+
 quint32 QQmlEngineDebugClient::queryObjectsForLocationRecursive(const QString &file,
         int lineNumber, int columnNumber, bool *success)
 {
@@ -391,6 +428,33 @@ void QQmlEngineDebugClient::decode(QDataStream &ds,
         decode(ds, o.children.last(), !recur);
     }
 
+    decodeProperties(ds, o);
+}
+
+void QQmlEngineDebugClient::decodePage(QDataStream &ds,
+                                       QmlDebugObjectReference &o)
+{
+    decode(ds, o, true);
+
+    int childOffset;
+    int pageCount;
+    bool expanded;
+    ds >> o.totalChildCount >> childOffset >> pageCount >> expanded;
+
+    for (int ii = 0; ii < pageCount; ++ii) {
+        o.children.append(QmlDebugObjectReference());
+        if (expanded)
+            decodePage(ds, o.children.last());
+        else
+            decode(ds, o.children.last(), true);
+    }
+
+    decodeProperties(ds, o);
+}
+
+void QQmlEngineDebugClient::decodeProperties(QDataStream &ds,
+                                             QmlDebugObjectReference &o)
+{
     int propCount;
     ds >> propCount;
 
@@ -492,6 +556,10 @@ void QQmlEngineDebugClient::messageReceived(const QByteArray &data)
         if (!ds.atEnd())
             decode(ds, m_object, false);
 
+    } else if (type == "FETCH_OBJECT_PAGE_R") {
+        if (!ds.atEnd())
+            decodePage(ds, m_object);
+
     } else if (type == "FETCH_OBJECTS_FOR_LOCATION_R") {
         if (!ds.atEnd())
             decode(ds, m_objects, false);
@@ -508,6 +576,9 @@ void QQmlEngineDebugClient::messageReceived(const QByteArray &data)
     } else if (type == "WATCH_EXPR_OBJECT_R") {
         ds >> m_valid;
 
+    } else if (type == "WATCH_PROPERTIES_BATCHED_R") {
+        ds >> m_valid;
+
     } else if (type == "UPDATE_WATCH") {
         int debugId;
         QByteArray name;
@@ -516,6 +587,20 @@ void QQmlEngineDebugClient::messageReceived(const QByteArray &data)
         emit valueChanged(name, value);
         return;
 
+    } else if (type == "UPDATE_WATCHES") {
+        int count;
+        ds >> count;
+        for (int ii = 0; ii < count; ++ii) {
+            int watchId;
+            int debugId;
+            QByteArray name;
+            QVariant value;
+            ds >> watchId >> debugId >> name >> value;
+            emit valueChanged(name, value);
+        }
+        emit valuesChanged(count);
+        return;
+
     } else if (type == "OBJECT_CREATED") {
         emit newObjects();
         return;
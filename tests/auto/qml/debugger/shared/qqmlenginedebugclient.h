@@ -95,12 +95,12 @@ struct QmlDebugFileReference
 struct QmlDebugObjectReference
 {
     QmlDebugObjectReference()
-        : debugId(-1), contextDebugId(-1)
+        : debugId(-1), contextDebugId(-1), totalChildCount(-1)
     {
     }
 
     QmlDebugObjectReference(int id)
-        : debugId(id), contextDebugId(-1)
+        : debugId(id), contextDebugId(-1), totalChildCount(-1)
     {
     }
 
@@ -110,6 +110,7 @@ struct QmlDebugObjectReference
         debugId = o.debugId; className = o.className; idString = o.idString;
         name = o.name; source = o.source; contextDebugId = o.contextDebugId;
         properties = o.properties; children = o.children;
+        totalChildCount = o.totalChildCount;
         return *this;
     }
     int debugId;
@@ -118,6 +119,7 @@ struct QmlDebugObjectReference
     QString name;
     QmlDebugFileReference source;
     int contextDebugId;
+    int totalChildCount; // only set by queryObjectPage()
     QList<QmlDebugPropertyReference> properties;
     QList<QmlDebugObjectReference> children;
 };
@@ -184,6 +186,9 @@ public:
                      bool *success);
     quint32 addWatch(const QmlDebugFileReference &,
                      bool *success);
+    quint32 addBatchedWatch(const QmlDebugObjectReference &,
+                            const QList<QByteArray> &properties, int interval,
+                            bool *success);
 
     void removeWatch(quint32 watch, bool *success);
 
@@ -196,6 +201,8 @@ public:
             int lineNumber, int columnNumber, bool *success);
     quint32 queryObjectRecursive(const QmlDebugObjectReference &,
                                  bool *success);
+    quint32 queryObjectPage(const QmlDebugObjectReference &, int depth,
+                            int childOffset, int childLimit, bool *success);
     quint32 queryObjectsForLocationRecursive(const QString &file,
             int lineNumber, int columnNumber, bool *success);
     quint32 queryExpressionResult(int objectDebugId,
@@ -218,6 +225,8 @@ public:
     void decode(QDataStream &, QmlDebugContextReference &);
     void decode(QDataStream &, QmlDebugObjectReference &, bool simple);
     void decode(QDataStream &ds, QList<QmlDebugObjectReference> &o, bool simple);
+    void decodePage(QDataStream &, QmlDebugObjectReference &);
+    void decodeProperties(QDataStream &, QmlDebugObjectReference &);
 
     QList<QmlDebugEngineReference> engines() { return m_engines; }
     QmlDebugContextReference rootContext() { return m_rootContext; }
@@ -229,6 +238,7 @@ public:
 signals:
     void newObjects();
     void valueChanged(QByteArray,QVariant);
+    void valuesChanged(int count);
     void result();
 
 protected:
@@ -48,6 +48,7 @@
 #include <qstandarditemmodel.h>
 #include <QtCore/qnumeric.h>
 #include <qqmlengine.h>
+#include <private/qv4compileddata_p.h>
 #include <stdlib.h>
 
 #ifdef Q_CC_MSVC
@@ -79,6 +80,7 @@ private slots:
     void newArray();
     void newArray_HooliganTask218092();
     void newArray_HooliganTask233836();
+    void sparseArrayDensify();
     void newVariant();
     void newVariant_valueOfToString();
     void newRegExp();
@@ -98,6 +100,7 @@ private slots:
     void builtinFunctionNames();
     void evaluate_data();
     void evaluate();
+    void evaluateFromDiskCache();
     void errorMessage_QT679();
     void valueConversion_basic();
     void valueConversion_QVariant();
@@ -156,12 +159,19 @@ private slots:
 
     void prototypeChainGc();
 
+    void enumerationCache();
+    void compactStrings();
+    void switchDispatch();
+    void compareAndBranch();
+
 signals:
     void testSignal();
 };
 
 tst_QJSEngine::tst_QJSEngine()
 {
+    // Engines that use the JIT only use the disk cache when asked to.
+    qputenv("QML_FORCE_DISK_CACHE", "1");
 }
 
 tst_QJSEngine::~tst_QJSEngine()
@@ -258,6 +268,32 @@ void tst_QJSEngine::newArray_HooliganTask233836()
     }
 }
 
+void tst_QJSEngine::sparseArrayDensify()
+{
+    QJSEngine eng;
+    {
+        // removing the outlier makes the array dense again
+        QJSValue ret = eng.evaluate("var a = [0, 1, 2]; a[100000] = 3; a.length = 4; a[3] = 3; a.join(',')");
+        QCOMPARE(ret.toString(), QString::fromLatin1("0,1,2,3"));
+    }
+    {
+        QJSValue ret = eng.evaluate("var b = [0, 1]; b[10000] = 2; delete b[10000]; b[2] = 2; b.length + ',' + (10000 in b) + ',' + b[2] + ',' + (5 in b)");
+        QCOMPARE(ret.toString(), QString::fromLatin1("10001,false,2,false"));
+    }
+    {
+        // filling the holes makes it dense again, values and holes are preserved
+        QJSValue ret = eng.evaluate("var c = []; c[5000] = 'x'; for (var i = 0; i < 5000; ++i) if (i != 7) c[i] = i;"
+                                    "var n = 0; for (var k in c) ++n; n + ',' + c[4998] + ',' + (7 in c) + ',' + c[5000]");
+        QCOMPARE(ret.toString(), QString::fromLatin1("5000,4998,false,x"));
+    }
+    {
+        // deleting while enumerating across the conversion
+        QJSValue ret = eng.evaluate("var d = [0, 1, 2, 3]; d[8000] = 4; var seen = [];"
+                                    "for (var k in d) { seen.push(k); if (k == 1) delete d[8000]; } seen.join(',')");
+        QCOMPARE(ret.toString(), QString::fromLatin1("0,1,2,3"));
+    }
+}
+
 void tst_QJSEngine::newVariant()
 {
     QJSEngine eng;
@@ -958,6 +994,56 @@ void tst_QJSEngine::evaluate()
     }
 }
 
+static QString largeLibrary(int factor)
+{
+    QString library = QStringLiteral("function scale(x) { return x * %1; }\n").arg(factor);
+    // Make it large enough to be cached.
+    while (library.size() < 8192)
+        library += QStringLiteral("var unused%1 = scale(%1);\n").arg(library.size());
+    return library + QStringLiteral("scale(2);\n");
+}
+
+void tst_QJSEngine::evaluateFromDiskCache()
+{
+    QTemporaryDir cacheDir;
+    QVERIFY(cacheDir.isValid());
+    qputenv("QML_DISK_CACHE_PATH", cacheDir.path().toLocal8Bit());
+
+    const QString fileName = QStringLiteral("library.js");
+    const QString cacheFile = QV4::CompiledData::CompilationUnit::scriptCacheFilePath(fileName);
+    {
+        QJSEngine engine;
+        QCOMPARE(engine.evaluate(largeLibrary(3), fileName).toInt(), 6);
+    }
+    QVERIFY(QFile::exists(cacheFile));
+    const QDateTime written = QFileInfo(cacheFile).lastModified();
+
+    // Loaded from the cache, behaves the same.
+    {
+        QJSEngine engine;
+        QCOMPARE(engine.evaluate(largeLibrary(3), fileName).toInt(), 6);
+        QCOMPARE(engine.evaluate(QStringLiteral("scale(5)")).toInt(), 15);
+        QJSValue error = engine.evaluate(QStringLiteral("scale(undefinedVariable)"));
+        QVERIFY(error.isError());
+    }
+    QCOMPARE(QFileInfo(cacheFile).lastModified(), written);
+
+    // A different program under the same name doesn't pick up the old code.
+    {
+        QJSEngine engine;
+        QCOMPARE(engine.evaluate(largeLibrary(4), fileName).toInt(), 8);
+    }
+
+    // Small programs aren't cached.
+    {
+        QJSEngine engine;
+        QCOMPARE(engine.evaluate(QStringLiteral("1 + 1"), QStringLiteral("small.js")).toInt(), 2);
+    }
+    QVERIFY(!QFile::exists(QV4::CompiledData::CompilationUnit::scriptCacheFilePath(QStringLiteral("small.js"))));
+
+    qunsetenv("QML_DISK_CACHE_PATH");
+}
+
 void tst_QJSEngine::errorMessage_QT679()
 {
     QJSEngine engine;
@@ -2830,6 +2916,165 @@ void tst_QJSEngine::prototypeChainGc()
     QVERIFY(proto.isObject());
 }
 
+void tst_QJSEngine::enumerationCache()
+{
+    QJSEngine engine;
+
+    // Objects of the same shape share the cached keys
+    QJSValue result = engine.evaluate(
+            "var keys = [];\n"
+            "for (var i = 0; i < 3; ++i) {\n"
+            "    var o = { a: i, b: i, c: i };\n"
+            "    var s = '';\n"
+            "    for (var k in o) s += k;\n"
+            "    keys.push(s + Object.keys(o).join(''));\n"
+            "}\n"
+            "keys.join(',')");
+    QCOMPARE(result.toString(), QString::fromLatin1("abcabc,abcabc,abcabc"));
+
+    // Properties deleted before they are visited are skipped
+    result = engine.evaluate(
+            "var o = { a: 1, b: 2, c: 3 };\n"
+            "var s = '';\n"
+            "for (var k in o) { s += k; delete o.b; }\n"
+            "s");
+    QCOMPARE(result.toString(), QString::fromLatin1("ac"));
+
+    // Changes to the prototype chain are picked up, shadowed keys show up once
+    result = engine.evaluate(
+            "function C() { this.a = 1; }\n"
+            "var seen = [];\n"
+            "for (var i = 0; i < 3; ++i) {\n"
+            "    if (i == 1) C.prototype.p = 1;\n"
+            "    if (i == 2) C.prototype.a = 1;\n"
+            "    var s = '';\n"
+            "    for (var k in new C) s += k;\n"
+            "    seen.push(s);\n"
+            "}\n"
+            "seen.join(',')");
+    QCOMPARE(result.toString(), QString::fromLatin1("a,ap,ap"));
+
+    // Non-enumerable properties and indexed properties
+    result = engine.evaluate(
+            "var o = { a: 1 };\n"
+            "Object.defineProperty(o, 'hidden', { value: 1, enumerable: false });\n"
+            "var s = Object.keys(o).join('');\n"
+            "o[0] = 1;\n"
+            "s += ',' + Object.keys(o).join('');\n"
+            "for (var k in o) s += k;\n"
+            "s");
+    QCOMPARE(result.toString(), QString::fromLatin1("a,0a0a"));
+}
+
+void tst_QJSEngine::compactStrings()
+{
+    QJSEngine engine;
+
+    // JSON values and flattened concatenations use one byte per character,
+    // and have to behave like any other string
+    QJSValue result = engine.evaluate(
+            "var parsed = JSON.parse('{\"key\": \"value\", \"name\": \"caf\\u00e9\"}');\n"
+            "var joined = '';\n"
+            "for (var i = 0; i < 100; ++i) joined += 'ab' + i;\n"
+            "var o = { value: 1 };\n"
+            "[ parsed.key == 'value', parsed.key === 'val' + 'ue', o[parsed.key],\n"
+            "  parsed.name.length, parsed.name.charAt(3) == '\\u00e9', parsed.name > 'cafe',\n"
+            "  joined.length, joined.indexOf('ab99'), JSON.stringify(parsed),\n"
+            "  /(b)(\\d+)$/.exec(joined).join(','), (joined + '\\u20ac').length ].join(';')");
+    QCOMPARE(result.toString(), QString::fromUtf8("true;true;1;4;true;true;390;386;"
+                                                  "{\"key\":\"value\",\"name\":\"caf\u00e9\"};"
+                                                  "b99,b,99;391"));
+
+    result = engine.evaluate("JSON.parse('[\"\\u00e9t\\u00e9\"]')[0]");
+    QCOMPARE(result.toString(), QString::fromUtf8("\u00e9t\u00e9"));
+    QVERIFY(result.strictlyEquals(engine.toScriptValue(QString::fromUtf8("\u00e9t\u00e9"))));
+}
+
+void tst_QJSEngine::switchDispatch()
+{
+    QJSEngine engine;
+
+    // Enough constant cases for the binary search dispatch
+    QJSValue result = engine.evaluate(
+            "function f(x) {\n"
+            "    var s = '';\n"
+            "    switch (x) {\n"
+            "    case 10: s += 'a';\n"
+            "    case 2: s += 'b'; break;\n"
+            "    case -4: return 'neg';\n"
+            "    case 7: return 'seven';\n"
+            "    default: s += 'd';\n"
+            "    case 0: return s + 'zero';\n"
+            "    case 2: return 'duplicate';\n"
+            "    case 3: case 4: case 5: return 'three to five';\n"
+            "    case 100: return 'hundred';\n"
+            "    case 1.5: return 'fraction';\n"
+            "    }\n"
+            "    return s;\n"
+            "}\n"
+            "var calls = 0;\n"
+            "var o = { valueOf: function() { ++calls; return 3; } };\n"
+            "[ f(10), f(2), f(-4), f(7), f(0), f(-0), f(4), f(100), f(1.5),\n"
+            "  f(6), f('3'), f(o), f(NaN), f(undefined), calls ].join(',')");
+    QCOMPARE(result.toString(), QString::fromLatin1("ab,b,neg,seven,zero,zero,three to five,hundred,fraction,"
+                                                    "dzero,dzero,dzero,dzero,dzero,0"));
+
+    result = engine.evaluate(
+            "function g(x) {\n"
+            "    switch (x) {\n"
+            "    case 'get': return 1;\n"
+            "    case 'put': return 2;\n"
+            "    case 'post': return 3;\n"
+            "    case 'delete': return 4;\n"
+            "    case 'head': return 5;\n"
+            "    case 'options': return 6;\n"
+            "    case 'trace': return 7;\n"
+            "    case '': return 8;\n"
+            "    case 'patch': return 9;\n"
+            "    }\n"
+            "    return 0;\n"
+            "}\n"
+            "[ g('get'), g('put'), g('post'), g('delete'), g('head'), g('options'), g('trace'),\n"
+            "  g(''), g('patch'), g('GET'), g(1), g({ toString: function() { return 'get'; } }) ].join(',')");
+    QCOMPARE(result.toString(), QString::fromLatin1("1,2,3,4,5,6,7,8,9,0,0,0"));
+}
+
+void tst_QJSEngine::compareAndBranch()
+{
+    QJSEngine engine;
+
+    QJSValue result = engine.evaluate(
+            "function cmp(a, b) {\n"
+            "    var s = '';\n"
+            "    if (a < b) s += 'lt '; else s += '!lt ';\n"
+            "    if (a > b) s += 'gt '; else s += '!gt ';\n"
+            "    if (a <= b) s += 'le '; else s += '!le ';\n"
+            "    if (a >= b) s += 'ge '; else s += '!ge ';\n"
+            "    if (a == b) s += 'eq '; else s += '!eq ';\n"
+            "    if (a != b) s += 'ne '; else s += '!ne ';\n"
+            "    if (a === b) s += 'seq '; else s += '!seq ';\n"
+            "    if (a !== b) s += 'sne'; else s += '!sne';\n"
+            "    return s;\n"
+            "}\n"
+            "[ cmp(1, 2), cmp('b', 'a'), cmp(NaN, NaN), cmp(1, '1') ].join(',')");
+    QCOMPARE(result.toString(), QString::fromLatin1(
+                 "lt !gt le !ge !eq ne !seq sne,"
+                 "!lt gt !le ge !eq ne !seq sne,"
+                 "!lt !gt !le !ge !eq ne !seq sne,"
+                 "!lt !gt le ge eq !ne !seq sne"));
+
+    // loop conditions jump backwards, exceptions thrown by the comparison must propagate
+    result = engine.evaluate(
+            "var n = 0;\n"
+            "for (var i = 0; i < 1000; ++i) ++n;\n"
+            "var thrown = false;\n"
+            "try {\n"
+            "    if ({ valueOf: function() { throw 'boom'; } } < 1) n = -1;\n"
+            "} catch (e) { thrown = (e === 'boom'); }\n"
+            "n + ',' + thrown");
+    QCOMPARE(result.toString(), QString::fromLatin1("1000,true"));
+}
+
 QTEST_MAIN(tst_QJSEngine)
 
 #include "tst_qjsengine.moc"
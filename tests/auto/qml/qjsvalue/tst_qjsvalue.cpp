@@ -41,6 +41,7 @@
 
 #include "tst_qjsvalue.h"
 #include <QtWidgets/QPushButton>
+#include <private/qjsvalue_p.h>
 
 QT_BEGIN_NAMESPACE
 extern bool qt_script_isJITEnabled();
@@ -1803,6 +1804,53 @@ void tst_QJSValue::call_twoEngines()
     }
 }
 
+void tst_QJSValue::call_withoutValueList()
+{
+    QJSEngine eng;
+    QJSValue fun = eng.evaluate("(function(a, b, c, d) { return [this.x, a, b, c, d.objectName, arguments.length].join(','); })");
+    QVERIFY(fun.isCallable());
+
+    QObject object;
+    object.setObjectName("obj");
+    QJSValue self = eng.newObject();
+    self.setProperty("x", 7);
+
+    for (int i = 0; i < 3; ++i) {
+        QJSValueCall call(&eng, fun, 4);
+        QVERIFY(call.isValid());
+        call.setThisObject(self);
+        call.setArgument(0, i);
+        call.setArgument(1, 2.5);
+        call.setArgument(2, QString("str"));
+        call.setArgument(3, &object);
+        QVERIFY(call.call());
+        QCOMPARE(call.result()->toQStringNoThrow(), QString("7,%1,2.5,str,obj,4").arg(i));
+    }
+
+    {
+        // String literals are passed as strings, not converted to bool
+        QJSValue types = eng.evaluate("(function(a, b) { return typeof a + ',' + a + ',' + typeof b + ',' + b; })");
+        QJSValueCall call(&eng, types, 2);
+        call.setArgument(0, "text");
+        call.setArgument(1, QLatin1String("latin1"));
+        QVERIFY(call.call());
+        QCOMPARE(call.result()->toQStringNoThrow(), QString("string,text,string,latin1"));
+    }
+
+    {
+        QJSValue thrower = eng.evaluate("(function() { throw new Error('foo'); })");
+        QJSValueCall call(&eng, thrower, 0);
+        QVERIFY(!call.call());
+        QVERIFY(call.resultValue().isError());
+    }
+
+    {
+        QJSValueCall call(&eng, QJSValue(123), 0);
+        QVERIFY(!call.isValid());
+        QVERIFY(!call.call());
+    }
+}
+
 void tst_QJSValue::call_nonFunction_data()
 {
     newEngine();
@@ -134,6 +134,7 @@ private slots:
     void call_arguments();
     void call();
     void call_twoEngines();
+    void call_withoutValueList();
     void call_nonFunction_data();
     void call_nonFunction();
     void construct_nonFunction_data();
@@ -7,6 +7,7 @@ PUBLICTESTS += \
     parserstress \
     qjsvalueiterator \
     qjsonbinding \
+    qmlcachegen \
     qmlmin \
     qmlplugindump \
     qqmlcomponent \
@@ -0,0 +1,9 @@
+CONFIG += testcase
+TARGET = tst_qmlcachegen
+QT += qml testlib
+macx:CONFIG -= app_bundle
+
+SOURCES += tst_qmlcachegen.cpp
+
+CONFIG += parallel_test
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
@@ -0,0 +1,141 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtest.h>
+#include <QLibraryInfo>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QQmlEngine>
+#include <QQmlComponent>
+
+class tst_qmlcachegen : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void precompiledScript();
+    void syntaxErrors();
+
+private:
+    bool runQmlCacheGen(const QStringList &arguments, QByteArray *errorOutput = 0);
+
+    QString qmlcachegenPath;
+};
+
+static bool writeFile(const QString &fileName, const QByteArray &contents)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    return file.write(contents) == contents.size();
+}
+
+void tst_qmlcachegen::initTestCase()
+{
+    qmlcachegenPath = QLibraryInfo::location(QLibraryInfo::BinariesPath) + QLatin1String("/qmlcachegen");
+#ifdef Q_OS_WIN
+    qmlcachegenPath += QLatin1String(".exe");
+#endif
+    if (!QFileInfo(qmlcachegenPath).exists()) {
+        QString message = QString::fromLatin1("qmlcachegen executable not found (looked for %0)")
+                .arg(qmlcachegenPath);
+        QFAIL(qPrintable(message));
+    }
+}
+
+bool tst_qmlcachegen::runQmlCacheGen(const QStringList &arguments, QByteArray *errorOutput)
+{
+    QProcess process;
+    process.start(qmlcachegenPath, arguments);
+    if (!process.waitForFinished())
+        return false;
+    if (errorOutput)
+        *errorOutput = process.readAllStandardError();
+    return process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0;
+}
+
+void tst_qmlcachegen::precompiledScript()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QString scriptFile = dir.path() + QLatin1String("/script.js");
+    QVERIFY(writeFile(scriptFile, ".pragma library\nfunction value() { return 42; }"));
+    const QString mainFile = dir.path() + QLatin1String("/main.qml");
+    QVERIFY(writeFile(mainFile,
+                      "import QtQml 2.0\n"
+                      "import \"script.js\" as Script\n"
+                      "QtObject { property int value: Script.value() }"));
+    QVERIFY(runQmlCacheGen(QStringList() << scriptFile << mainFile));
+    QVERIFY(QFile::exists(scriptFile + QLatin1Char('c')));
+
+    // The application can be shipped without the script source.
+    QVERIFY(QFile::remove(scriptFile));
+
+    QQmlEngine engine;
+    QQmlComponent component(&engine, QUrl::fromLocalFile(mainFile));
+    QScopedPointer<QObject> object(component.create());
+    QVERIFY2(object, qPrintable(component.errorString()));
+    QCOMPARE(object->property("value").toInt(), 42);
+}
+
+void tst_qmlcachegen::syntaxErrors()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QString scriptFile = dir.path() + QLatin1String("/broken.js");
+    QVERIFY(writeFile(scriptFile, "function value() { return 42;"));
+    QByteArray errors;
+    QVERIFY(!runQmlCacheGen(QStringList() << scriptFile, &errors));
+    QVERIFY2(errors.contains("broken.js:1:"), errors.constData());
+    QVERIFY(!QFile::exists(scriptFile + QLatin1Char('c')));
+
+    const QString qmlFile = dir.path() + QLatin1String("/Broken.qml");
+    QVERIFY(writeFile(qmlFile, "import QtQml 2.0\nQtObject { property int value: }"));
+    QVERIFY(!runQmlCacheGen(QStringList() << qmlFile, &errors));
+    QVERIFY2(errors.contains("Broken.qml:2:"), errors.constData());
+}
+
+QTEST_MAIN(tst_qmlcachegen)
+
+#include "tst_qmlcachegen.moc"
@@ -0,0 +1,8 @@
+import QtQuick 2.0
+
+Item {
+    objectName: "root"
+    property int source: 1
+    property int doubled: source * 2
+    property int quadrupled: doubled * 2
+}
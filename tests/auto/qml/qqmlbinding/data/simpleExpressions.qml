@@ -0,0 +1,22 @@
+import QtQuick 2.0
+
+Item {
+    id: root
+    width: 100
+    height: 50
+
+    property bool flag: false
+    property string label: "item"
+    property Item other: null
+
+    Item { id: child; width: 20 }
+
+    property real sum: width + child.width
+    property real half: width / 2
+    property bool notFlag: !flag
+    property real chosen: flag ? width : height
+    property string text: label + ": " + width
+    property bool wide: width > height
+    property bool childIsTwenty: child.width === 20
+    property real otherWidth: other ? other.width : -1
+}
@@ -41,7 +41,11 @@
 #include <qtest.h>
 #include <QtQml/qqmlengine.h>
 #include <QtQml/qqmlcomponent.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
 #include <private/qqmlbind_p.h>
+#include <private/qqmlbindinggraph_p.h>
 #include <QtQuick/private/qquickrectangle_p.h>
 #include "../../shared/util.h"
 
@@ -58,6 +62,8 @@ private slots:
     void restoreBindingWithLoop();
     void restoreBindingWithoutCrash();
     void deletedObject();
+    void simpleExpressions();
+    void bindingGraph();
 
 private:
     QQmlEngine engine;
@@ -232,6 +238,111 @@ void tst_qqmlbinding::deletedObject()
     delete rect;
 }
 
+void tst_qqmlbinding::simpleExpressions()
+{
+    QQmlEngine engine;
+    QQmlComponent c(&engine, testFileUrl("simpleExpressions.qml"));
+    QQuickItem *root = qobject_cast<QQuickItem*>(c.create());
+    QVERIFY(root != 0);
+
+    QCOMPARE(root->property("sum").toReal(), qreal(120));
+    QCOMPARE(root->property("half").toReal(), qreal(50));
+    QCOMPARE(root->property("notFlag").toBool(), true);
+    QCOMPARE(root->property("chosen").toReal(), qreal(50));
+    QCOMPARE(root->property("text").toString(), QLatin1String("item: 100"));
+    QCOMPARE(root->property("wide").toBool(), true);
+    QCOMPARE(root->property("childIsTwenty").toBool(), true);
+    QCOMPARE(root->property("otherWidth").toReal(), qreal(-1));
+
+    QQuickItem *child = root->childItems().first();
+    root->setWidth(25);
+    root->setProperty("flag", true);
+    root->setProperty("label", QLatin1String("other"));
+    root->setProperty("other", QVariant::fromValue(child));
+    child->setWidth(30);
+
+    QCOMPARE(root->property("sum").toReal(), qreal(55));
+    QCOMPARE(root->property("half").toReal(), qreal(12.5));
+    QCOMPARE(root->property("notFlag").toBool(), false);
+    QCOMPARE(root->property("chosen").toReal(), qreal(25));
+    QCOMPARE(root->property("text").toString(), QLatin1String("other: 25"));
+    QCOMPARE(root->property("wide").toBool(), false);
+    QCOMPARE(root->property("childIsTwenty").toBool(), false);
+    QCOMPARE(root->property("otherWidth").toReal(), qreal(30));
+
+    delete root;
+}
+
+static int findNode(const QVector<QQmlBindingGraph::Node> &nodes, const QString &suffix)
+{
+    for (int i = 0; i < nodes.count(); ++i) {
+        if (nodes.at(i).name.endsWith(suffix))
+            return i;
+    }
+    return -1;
+}
+
+static const QQmlBindingGraph::Edge *findEdge(const QVector<QQmlBindingGraph::Edge> &edges,
+                                              int from, QQmlBindingGraph::EdgeKind kind)
+{
+    for (int i = 0; i < edges.count(); ++i) {
+        if (edges.at(i).from == from && edges.at(i).kind == kind)
+            return &edges.at(i);
+    }
+    return 0;
+}
+
+// Recording stays enabled for the rest of the process, so this runs last.
+void tst_qqmlbinding::bindingGraph()
+{
+    QQmlBindingGraph::enable();
+    QQmlBindingGraph *graph = QQmlBindingGraph::instance();
+    QVERIFY(graph);
+
+    QQmlEngine engine;
+    QQmlComponent c(&engine, testFileUrl("bindingGraph.qml"));
+    QScopedPointer<QObject> root(c.create());
+    QVERIFY(root);
+    root->setProperty("source", 5);
+    QCOMPARE(root->property("quadrupled").toInt(), 20);
+
+    const QVector<QQmlBindingGraph::Node> nodes = graph->nodes();
+    const QVector<QQmlBindingGraph::Edge> edges = graph->edges();
+    const int source = findNode(nodes, QLatin1String("(root).source"));
+    const int doubled = findNode(nodes, QLatin1String("(root).doubled"));
+    QVERIFY(source != -1);
+    QVERIFY(doubled != -1);
+    QCOMPARE(nodes.at(source).kind, QQmlBindingGraph::PropertyNode);
+
+    // source -> binding of doubled -> doubled -> binding of quadrupled
+    const QQmlBindingGraph::Edge *dependency = findEdge(edges, source,
+                                                        QQmlBindingGraph::DependencyEdge);
+    QVERIFY(dependency);
+    QCOMPARE(dependency->triggers, 1);
+    const QQmlBindingGraph::Node &doubledBinding = nodes.at(dependency->to);
+    QCOMPARE(doubledBinding.kind, QQmlBindingGraph::ExpressionNode);
+    QVERIFY(doubledBinding.name.startsWith(testFileUrl("bindingGraph.qml").toString()));
+    QCOMPARE(doubledBinding.evaluations, 2);
+
+    const QQmlBindingGraph::Edge *write = findEdge(edges, dependency->to,
+                                                   QQmlBindingGraph::WriteEdge);
+    QVERIFY(write);
+    QCOMPARE(write->to, doubled);
+
+    // Depending on the order of the initial evaluations, quadrupled may be updated once more.
+    dependency = findEdge(edges, doubled, QQmlBindingGraph::DependencyEdge);
+    QVERIFY(dependency);
+    QVERIFY(dependency->triggers >= 1);
+    QCOMPARE(nodes.at(dependency->to).evaluations, dependency->triggers + 1);
+
+    QJsonParseError error;
+    const QJsonDocument json = QJsonDocument::fromJson(graph->toJson(), &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QCOMPARE(json.object().value(QStringLiteral("nodes")).toArray().count(), nodes.count());
+    QCOMPARE(json.object().value(QStringLiteral("edges")).toArray().count(), edges.count());
+    QVERIFY(graph->toDot().startsWith("digraph bindings {"));
+}
+
 QTEST_MAIN(tst_qqmlbinding)
 
 #include "tst_qqmlbinding.moc"
@@ -55,6 +55,8 @@ private slots:
     void removeConsecutive();
     void insertConsecutive_data();
     void insertConsecutive();
+    void accumulate_data();
+    void accumulate();
 
     void copy();
     void debug();
@@ -1423,6 +1425,72 @@ void tst_qqmlchangeset::insertConsecutive()
     QCOMPARE(changes, output);
 }
 
+void tst_qqmlchangeset::accumulate_data()
+{
+    QTest::addColumn<SignalList>("input");
+    QTest::addColumn<SignalList>("output");
+
+    QTest::newRow("scattered changes")
+            << (SignalList() << Change(0,1) << Change(4,1) << Change(2,1) << Change(3,1) << Change(10,2))
+            << (SignalList() << Change(0,1) << Change(2,3) << Change(10,2));
+    QTest::newRow("consecutive inserts")
+            << (SignalList() << Insert(0,1) << Insert(1,1) << Insert(2,1) << Insert(1,2))
+            << (SignalList() << Insert(0,5));
+    QTest::newRow("consecutive removes")
+            << (SignalList() << Remove(5,1) << Remove(5,1) << Remove(5,1) << Remove(4,1))
+            << (SignalList() << Remove(4,4));
+    QTest::newRow("insert,move,change")
+            << (SignalList() << Insert(5,2) << Move(0,10,2,0) << Change(1,1))
+            << (SignalList() << Remove(0,2,0,0) << Insert(3,2) << Insert(10,2,0,0) << Change(1,1));
+}
+
+void tst_qqmlchangeset::accumulate()
+{
+    QFETCH(SignalList, input);
+    QFETCH(SignalList, output);
+
+    QQmlChangeSet set;
+    set.setAccumulating(true);
+    QVERIFY(set.isAccumulating());
+
+    QQmlChangeSet reference;
+
+    foreach (const Signal &signal, input) {
+        if (signal.isRemove()) {
+            set.remove(signal.index, signal.count);
+            reference.remove(signal.index, signal.count);
+        } else if (signal.isInsert()) {
+            set.insert(signal.index, signal.count);
+            reference.insert(signal.index, signal.count);
+        } else if (signal.isMove()) {
+            set.move(signal.index, signal.to, signal.count, signal.moveId);
+            reference.move(signal.index, signal.to, signal.count, signal.moveId);
+        } else if (signal.isChange()) {
+            set.change(signal.index, signal.count);
+            reference.change(signal.index, signal.count);
+        }
+    }
+
+    SignalList changes;
+    foreach (const QQmlChangeSet::Remove &remove, set.removes())
+        changes << Remove(remove.index, remove.count, remove.moveId, remove.offset);
+    foreach (const QQmlChangeSet::Insert &insert, set.inserts())
+        changes << Insert(insert.index, insert.count, insert.moveId, insert.offset);
+    foreach (const QQmlChangeSet::Change &change, set.changes())
+        changes << Change(change.index, change.count);
+
+    VERIFY_EXPECTED_OUTPUT
+    QCOMPARE(changes, output);
+    QCOMPARE(set.difference(), reference.difference());
+
+    // Applying an accumulated set to another is the same as applying the merged set.
+    QQmlChangeSet applied;
+    applied.apply(set);
+    QCOMPARE(applied.removes().count(), set.removes().count());
+    QCOMPARE(applied.inserts().count(), set.inserts().count());
+    QCOMPARE(applied.changes().count(), set.changes().count());
+}
+
 void tst_qqmlchangeset::copy()
 {
     QQmlChangeSet changeSet;
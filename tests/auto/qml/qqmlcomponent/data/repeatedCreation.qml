@@ -0,0 +1,22 @@
+import QtQuick 2.0
+
+Item {
+    id: root
+
+    property int counter: 0
+    property string label: "item"
+    property int childCount: children.length
+    property int triggered: 0
+
+    signal ping()
+    onPing: ++triggered
+    onCounterChanged: label = "item" + counter
+
+    width: 10 + counter
+    height: width * 2
+
+    Item { id: first; objectName: "first"; width: root.width }
+    Item { objectName: "second" }
+
+    property alias firstWidth: first.width
+}
@@ -124,6 +124,7 @@ private slots:
     void onDestructionCount();
     void recursion();
     void recursionContinuation();
+    void repeatedCreation();
 
 private:
     QQmlEngine engine;
@@ -450,6 +451,33 @@ void tst_qqmlcomponent::recursionContinuation()
     QVERIFY(object->property("success").toBool());
 }
 
+// Later instances replay the property lookups recorded by the first one
+void tst_qqmlcomponent::repeatedCreation()
+{
+    QQmlEngine engine;
+    QQmlComponent component(&engine, testFileUrl("repeatedCreation.qml"));
+
+    for (int i = 0; i < 3; ++i) {
+        QScopedPointer<QObject> object(component.create());
+        QVERIFY(!object.isNull());
+
+        QCOMPARE(object->property("childCount").toInt(), 2);
+        QVERIFY(object->findChild<QObject *>("first") != 0);
+        QVERIFY(object->findChild<QObject *>("second") != 0);
+
+        QCOMPARE(object->property("width").toReal(), qreal(10));
+        QCOMPARE(object->property("height").toReal(), qreal(20));
+        QCOMPARE(object->property("firstWidth").toReal(), qreal(10));
+
+        object->setProperty("counter", i + 1);
+        QCOMPARE(object->property("label").toString(), QString("item%1").arg(i + 1));
+        QCOMPARE(object->property("height").toReal(), qreal(2 * (11 + i)));
+
+        QVERIFY(QMetaObject::invokeMethod(object.data(), "ping"));
+        QCOMPARE(object->property("triggered").toInt(), 1);
+    }
+}
+
 QTEST_MAIN(tst_qqmlcomponent)
 
 #include "tst_qqmlcomponent.moc"
@@ -0,0 +1,10 @@
+import QtQuick 2.0
+
+QtObject {
+    property bool swap: false
+    property int a: 1
+    property int b: 2
+    property int c: 3
+
+    property int result: swap ? c * 100 + b * 10 + a + a : a * 100 + b * 10 + c + c
+}
@@ -0,0 +1,10 @@
+import QtQuick 2.0
+
+QtObject {
+    property int a: 1
+    property int b: 2
+    property int sum: a + b
+    property int doubled: sum * 2
+    property int sumChanges: 0
+    onSumChanged: ++sumChanges
+}
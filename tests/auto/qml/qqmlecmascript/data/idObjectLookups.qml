@@ -0,0 +1,20 @@
+import QtQuick 2.0
+
+QtObject {
+    id: root
+
+    property QtObject first: QtObject { id: a; property int value: 1 }
+    property QtObject second: QtObject { id: b; property int value: 2 }
+
+    property int sum: a.value + b.value
+    property bool sameObjects: a === root.first && b === root.second
+
+    function product() {
+        var result = 0;
+        for (var i = 0; i < 3; ++i)
+            result += a.value * b.value;
+        return result;
+    }
+
+    function secondObject() { return b; }
+}
@@ -0,0 +1,57 @@
+import QtQuick 2.0
+
+QtObject {
+    function check(failures, name, actual, expected) {
+        var same = (actual === expected && (actual !== 0 || 1 / actual === 1 / expected))
+                   || (actual !== actual && expected !== expected);
+        if (!same)
+            failures.push(name + ": " + actual + " != " + expected);
+    }
+
+    function run() {
+        var failures = [];
+        var str = "AbC";
+        for (var i = 0; i < 3; ++i) {
+            check(failures, "floor(2.5)", Math.floor(2.5), 2);
+            check(failures, "floor(-2.5)", Math.floor(-2.5), -3);
+            check(failures, "floor(-0.5)", Math.floor(-0.5), -1);
+            check(failures, "floor(0.5)", Math.floor(0.5), 0);
+            check(failures, "floor(-0)", Math.floor(-0), -0);
+            check(failures, "floor(7)", Math.floor(7), 7);
+            check(failures, "floor(NaN)", Math.floor(NaN), NaN);
+            check(failures, "floor(-2147483648.5)", Math.floor(-2147483648.5), -2147483649);
+            check(failures, "floor(1e10)", Math.floor(1e10 + 0.5), 1e10);
+            check(failures, "floor('7.5')", Math.floor("7.5"), 7);
+            check(failures, "abs(-3.5)", Math.abs(-3.5), 3.5);
+            check(failures, "abs(-0)", Math.abs(-0), 0);
+            check(failures, "abs(-4)", Math.abs(-4), 4);
+            check(failures, "sqrt(9)", Math.sqrt(9), 3);
+            check(failures, "sqrt(-1)", Math.sqrt(-1), NaN);
+            check(failures, "min(1, 2)", Math.min(1, 2), 1);
+            check(failures, "min(2.5, -1)", Math.min(2.5, -1), -1);
+            check(failures, "min(0, -0)", Math.min(0, -0), -0);
+            check(failures, "min(NaN, 1)", Math.min(NaN, 1), NaN);
+            check(failures, "max(1, 2)", Math.max(1, 2), 2);
+            check(failures, "max(1, undefined)", Math.max(1, undefined), NaN);
+            check(failures, "charCodeAt(1)", str.charCodeAt(1), 98);
+            check(failures, "charCodeAt(5)", str.charCodeAt(5), NaN);
+        }
+
+        // replaced builtins are called as usual
+        var floor = Math.floor;
+        Math.floor = function(v) { return "replaced"; }
+        check(failures, "replaced floor", Math.floor(2.5), "replaced");
+        Math.floor = floor;
+        check(failures, "restored floor", Math.floor(2.5), 2);
+
+        var charCodeAt = String.prototype.charCodeAt;
+        String.prototype.charCodeAt = function(i) { return -i; }
+        check(failures, "replaced charCodeAt", str.charCodeAt(1), -1);
+        String.prototype.charCodeAt = charCodeAt;
+
+        var notMath = { sqrt: function(v) { return v; } };
+        check(failures, "other sqrt", notMath.sqrt(4), 4);
+
+        return failures.join("; ");
+    }
+}
@@ -102,4 +102,12 @@ Item {
         if (testSequence[4] == 5)
             referenceDeletion = false;
     }
+
+    property var heldIntList
+    function holdSequence() {
+        heldIntList = msco.intListProperty2;
+    }
+    function readHeldSequence() {
+        return heldIntList.length + ":" + heldIntList[0];
+    }
 }
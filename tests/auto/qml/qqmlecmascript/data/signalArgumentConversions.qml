@@ -0,0 +1,14 @@
+import Qt.test 1.0
+
+MyQmlObject {
+    id: root
+    property int count: 0
+    property bool result: false
+    property bool nullObject: false
+
+    onTypedArgumentSignal: {
+        ++count
+        result = a === true && b === 4000000000 && c === 1.5 && d === -2.25 && e === root && f === "text"
+        nullObject = e === null
+    }
+}
@@ -257,6 +257,7 @@ signals:
     void signalWithGlobalName(int parseInt);
     void intChanged();
     void qjsvalueChanged();
+    void typedArgumentSignal(bool a, uint b, float c, double d, QObject *e, const QString &f);
 
 public slots:
     void deleteMe() { delete this; }
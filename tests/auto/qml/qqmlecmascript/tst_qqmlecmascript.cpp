@@ -48,6 +48,7 @@
 #include <QtCore/qdir.h>
 #include <QtCore/qnumeric.h>
 #include <private/qqmlengine_p.h>
+#include <private/qqmlbinding_p.h>
 #include <private/qqmlvmemetaobject_p.h>
 #include <private/qqmlcontextwrapper_p.h>
 #include "testtypes.h"
@@ -55,6 +56,14 @@
 #include "../../shared/util.h"
 #include <private/qv4functionobject_p.h>
 #include <private/qv4scopedvalue_p.h>
+#include <private/qv4mm_p.h>
+#include <private/qv4identifiertable_p.h>
+#include <private/qv4lookup_p.h>
+#include <private/qv4isel_moth_p.h>
+#include <private/qv4jsonobject_p.h>
+#include <private/qv4regexp_p.h>
+#include <private/qv4profiling_p.h>
+#include <private/qjsvalue_p.h>
 
 #ifdef Q_CC_MSVC
 #define NO_INLINE __declspec(noinline)
@@ -89,6 +98,7 @@ private slots:
     void exportDate_data();
     void exportDate();
     void idShortcutInvalidates();
+    void idObjectLookups();
     void boolPropertiesEvaluateAsBool();
     void methods();
     void signalAssignment();
@@ -116,6 +126,7 @@ private slots:
     void scope();
     void importScope();
     void signalParameterTypes();
+    void signalArgumentConversions();
     void objectsCompareAsEqual();
     void componentCreation_data();
     void componentCreation();
@@ -326,6 +337,24 @@ private slots:
     void importedScriptsAccessOnObjectWithInvalidContext();
     void contextObjectOnLazyBindings();
     void garbageCollectionDuringCreation();
+    void heapStatistics();
+    void sharedIdentifiers();
+    void polymorphicLookups();
+    void tieredExecution();
+    void tieredExecutionHotLoop();
+    void inlinedCalls();
+    void loopInvariants();
+    void typedArrays();
+    void integerArraySort();
+    void packedArrays();
+    void jsonParseAndStringify();
+    void sharedRegExpCode();
+    void lazyArgumentsObject();
+    void samplingProfiler();
+    void allocationSamplingProfiler();
+    void bindingDependencyOrder();
+    void deferredBindingUpdates();
+    void mathIntrinsics();
 
 private:
 //    static void propertyVarWeakRefCallback(v8::Persistent<v8::Value> object, void* parameter);
@@ -536,6 +565,31 @@ void tst_qqmlecmascript::idShortcutInvalidates()
     }
 }
 
+void tst_qqmlecmascript::idObjectLookups()
+{
+    QQmlComponent component(&engine, testFileUrl("idObjectLookups.qml"));
+    QScopedPointer<QObject> object(component.create());
+    QVERIFY(!object.isNull());
+
+    QObject *first = object->property("first").value<QObject *>();
+    QObject *second = object->property("second").value<QObject *>();
+    QVERIFY(first != 0);
+    QVERIFY(second != 0);
+
+    QCOMPARE(object->property("sum").toInt(), 3);
+    QCOMPARE(object->property("sameObjects").toBool(), true);
+
+    first->setProperty("value", 5);
+    QCOMPARE(object->property("sum").toInt(), 7);
+
+    QVariant result;
+    QVERIFY(QMetaObject::invokeMethod(object.data(), "product", Q_RETURN_ARG(QVariant, result)));
+    QCOMPARE(result.toInt(), 30);
+
+    QVERIFY(QMetaObject::invokeMethod(object.data(), "secondObject", Q_RETURN_ARG(QVariant, result)));
+    QCOMPARE(result.value<QObject *>(), second);
+}
+
 void tst_qqmlecmascript::boolPropertiesEvaluateAsBool()
 {
     {
@@ -1404,6 +1458,25 @@ void tst_qqmlecmascript::signalParameterTypes()
     delete object;
 }
 
+void tst_qqmlecmascript::signalArgumentConversions()
+{
+    QQmlComponent component(&engine, testFileUrl("signalArgumentConversions.qml"));
+    MyQmlObject *object = qobject_cast<MyQmlObject *>(component.create());
+    QVERIFY(object != 0);
+
+    // The second emission uses the conversions cached by the first one
+    for (int ii = 0; ii < 2; ++ii) {
+        emit object->typedArgumentSignal(true, 4000000000u, 1.5f, -2.25, object, QStringLiteral("text"));
+        QCOMPARE(object->property("count").toInt(), ii + 1);
+        QCOMPARE(object->property("result").toBool(), true);
+    }
+
+    emit object->typedArgumentSignal(false, 0, 0, 0, 0, QString());
+    QCOMPARE(object->property("nullObject").toBool(), true);
+
+    delete object;
+}
+
 /*
 Test that two JS objects for the same QObject compare as equal.
 */
@@ -2772,6 +2845,25 @@ void tst_qqmlecmascript::callQtInvokables()
     QCOMPARE(o->actuals().count(), 1);
     QCOMPARE(o->actuals().at(0), QVariant(QString("Hello")));
 
+    // Overload resolution is cached per argument signature
+    o->reset();
+    QVERIFY(EVALUATE_VALUE("object.method_overload(12)", QV4::Primitive::undefinedValue()));
+    QCOMPARE(o->invoked(), 16);
+    QCOMPARE(o->actuals().at(0), QVariant(12));
+
+    o->reset();
+    QVERIFY(EVALUATE_VALUE("object.method_overload(\"World\")", QV4::Primitive::undefinedValue()));
+    QCOMPARE(o->invoked(), 18);
+    QCOMPARE(o->actuals().at(0), QVariant(QString("World")));
+
+    o->reset();
+    QVERIFY(EVALUATE_VALUE("object.method_overload(\"World\")", QV4::Primitive::undefinedValue()));
+    QCOMPARE(o->invoked(), 18);
+
+    o->reset();
+    QVERIFY(EVALUATE_VALUE("object.method_overload(12, 13)", QV4::Primitive::undefinedValue()));
+    QCOMPARE(o->invoked(), 17);
+
     o->reset();
     QVERIFY(EVALUATE_VALUE("object.method_with_enum(9)", QV4::Primitive::undefinedValue()));
     QCOMPARE(o->error(), false);
@@ -5329,6 +5421,18 @@ void tst_qqmlecmascript::sequenceConversionRead()
         QMetaObject::invokeMethod(object, "testReferenceDeletion");
         QCOMPARE(object->property("referenceDeletion").toBool(), true);
 
+        // a held reference sequence sees changes made to the property from C++
+        QVariant heldValue;
+        QMetaObject::invokeMethod(object, "holdSequence");
+        QMetaObject::invokeMethod(object, "readHeldSequence", Q_RETURN_ARG(QVariant, heldValue));
+        QCOMPARE(heldValue.toString(), QString(QLatin1String("4:1")));
+        QMetaObject::invokeMethod(object, "readHeldSequence", Q_RETURN_ARG(QVariant, heldValue));
+        QCOMPARE(heldValue.toString(), QString(QLatin1String("4:1")));
+        intList.clear(); intList << 7 << 8;
+        seq->setIntListProperty2(intList);
+        QMetaObject::invokeMethod(object, "readHeldSequence", Q_RETURN_ARG(QVariant, heldValue));
+        QCOMPARE(heldValue.toString(), QString(QLatin1String("2:7")));
+
         delete object;
     }
 
@@ -7596,6 +7700,583 @@ void tst_qqmlecmascript::garbageCollectionDuringCreation()
     QCOMPARE(container->dataChildren.count(), 0);
 }
 
+void tst_qqmlecmascript::heapStatistics()
+{
+    QJSEngine jsEngine;
+    QJSValue list = jsEngine.evaluate("var list = []; for (var i = 0; i < 100; ++i) list.push({ value: i }); list");
+    QCOMPARE(list.property("length").toInt(), 100);
+
+    const QV4::MemoryManager::HeapStatistics stats = QV8Engine::getV4(&jsEngine)->memoryManager->heapStatistics();
+    QVERIFY(!stats.sizeClasses.isEmpty());
+    QVERIFY(stats.usedChunkBytes > 0);
+    QVERIFY(stats.usedChunkBytes <= stats.chunkBytes);
+    foreach (const QV4::MemoryManager::HeapStatistics::SizeClass &sizeClass, stats.sizeClasses)
+        QVERIFY(sizeClass.usedItems <= sizeClass.totalItems);
+    QVERIFY(stats.liveObjects.value(QStringLiteral("Object")).count >= 100);
+}
+
+void tst_qqmlecmascript::sharedIdentifiers()
+{
+    QJSEngine first;
+    QJSEngine second;
+    QCOMPARE(first.evaluate("var o = { sharedIdentifierProperty: 1 }; o.sharedIdentifierProperty").toInt(), 1);
+    QCOMPARE(second.evaluate("var o = { sharedIdentifierProperty: 2 }; o.sharedIdentifierProperty").toInt(), 2);
+
+    const QString name = QStringLiteral("sharedIdentifierProperty");
+    QV4::Identifier *firstIdentifier = QV8Engine::getV4(&first)->identifierTable->identifier(name);
+    QV4::Identifier *secondIdentifier = QV8Engine::getV4(&second)->identifierTable->identifier(name);
+    QVERIFY(firstIdentifier->isShared);
+    QCOMPARE(firstIdentifier, secondIdentifier);
+
+    // Identifiers created at run time stay private to their engine.
+    QCOMPARE(first.evaluate("var p = {}; var key = 'runtime' + 'Identifier'; p[key] = 3; p[key]").toInt(), 3);
+    QVERIFY(!QV8Engine::getV4(&first)->identifierTable->identifier(QStringLiteral("runtimeIdentifier"))->isShared);
+}
+
+void tst_qqmlecmascript::polymorphicLookups()
+{
+    QJSEngine jsEngine;
+    QJSValue accessShapes = jsEngine.evaluate(
+        "(function(shapeCount) {\n"
+        "    function get(o) { return o.x; }\n"
+        "    var objects = [];\n"
+        "    for (var i = 0; i < shapeCount; ++i) {\n"
+        "        var o = {};\n"
+        "        o['p' + i] = i;\n"
+        "        if (i % 2)\n"
+        "            o.x = i;\n"
+        "        else\n"
+        "            o.__proto__ = { x: i };\n"
+        "        objects.push(o);\n"
+        "    }\n"
+        "    var sum = 0;\n"
+        "    for (var j = 0; j < 10; ++j)\n"
+        "        for (var i = 0; i < shapeCount; ++i)\n"
+        "            sum += get(objects[i]);\n"
+        "    return sum;\n"
+        "})");
+    QVERIFY(accessShapes.isCallable());
+
+    QCOMPARE(accessShapes.call(QJSValueList() << 6).toInt(), 150);
+    QV4::LookupStatistics stats = QV8Engine::getV4(&jsEngine)->lookupStatistics();
+    QVERIFY(stats.polymorphicSites > 0);
+    QVERIFY(stats.polymorphicHits > 0);
+
+    // More shapes than a polymorphic lookup can hold go to the per engine cache.
+    QCOMPARE(accessShapes.call(QJSValueList() << 40).toInt(), 10 * 780);
+    stats = QV8Engine::getV4(&jsEngine)->lookupStatistics();
+    QVERIFY(stats.megamorphicSites > 0);
+    QVERIFY(stats.megamorphicHits > 0);
+}
+
+void tst_qqmlecmascript::tieredExecution()
+{
+    QJSEngine jsEngine;
+    QV4::ExecutionEngine *v4 = QV8Engine::getV4(&jsEngine);
+    v4->interpreterISelFactory.reset(new QV4::Moth::ISelFactory);
+    v4->jitCallThreshold = 3;
+    v4->jitBackEdgeThreshold = 1000;
+
+    QJSValue sumDoubles = jsEngine.evaluate(
+        "(function(count) {\n"
+        "    function twice(x) { return x * 2; }\n"
+        "    var sum = 0;\n"
+        "    for (var i = 0; i < count; ++i)\n"
+        "        sum += twice(i);\n"
+        "    return sum;\n"
+        "})");
+    QVERIFY(sumDoubles.isCallable());
+
+    QV4::CompiledData::CompilationUnit *unit = 0;
+    foreach (QV4::CompiledData::CompilationUnit *u, v4->compilationUnits) {
+        if (u->tierUpSource)
+            unit = u;
+    }
+    QVERIFY(unit);
+    QVERIFY(!unit->tieredUnit);
+
+    // twice() reaches the call threshold within the first loop, the rest runs JIT compiled code.
+    QCOMPARE(sumDoubles.call(QJSValueList() << 10).toInt(), 90);
+    QVERIFY(unit->tieredUnit);
+    QVERIFY(!unit->tierUpSource);
+    QCOMPARE(sumDoubles.call(QJSValueList() << 10).toInt(), 90);
+
+    // Hot loops tier up units on their back edges.
+    QJSValue loop = jsEngine.evaluate("(function() { var n = 0; for (var i = 0; i < 5000; ++i) n += i; return n; })");
+    QCOMPARE(loop.call().toInt(), 12497500);
+    QCOMPARE(loop.call().toInt(), 12497500);
+}
+
+void tst_qqmlecmascript::tieredExecutionHotLoop()
+{
+    QJSEngine jsEngine;
+    QV4::ExecutionEngine *v4 = QV8Engine::getV4(&jsEngine);
+    v4->interpreterISelFactory.reset(new QV4::Moth::ISelFactory);
+    v4->jitCallThreshold = 100000;
+    v4->jitBackEdgeThreshold = 1000;
+
+    // add() closes over the locals of the interpreted frame and is called both before and
+    // after the unit is recompiled.
+    QJSValue sumSquares = jsEngine.evaluate(
+        "(function(count) {\n"
+        "    var sum = 0;\n"
+        "    var samples = [];\n"
+        "    function add(x) { sum += x * x; }\n"
+        "    for (var i = 0; i < count; ++i) {\n"
+        "        add(i);\n"
+        "        if (i % 1000 == 0)\n"
+        "            samples.push(sum);\n"
+        "    }\n"
+        "    return sum + ',' + samples.length + ',' + samples[samples.length - 1];\n"
+        "})");
+    QVERIFY(sumSquares.isCallable());
+
+    QV4::CompiledData::CompilationUnit *unit = 0;
+    foreach (QV4::CompiledData::CompilationUnit *u, v4->compilationUnits) {
+        if (u->tierUpSource)
+            unit = u;
+    }
+    QVERIFY(unit);
+    QVERIFY(!unit->tieredUnit);
+
+    // A single call is far below the call threshold, so the back edges of its loop tier the
+    // unit up. The running frame finishes in the interpreter, there is no on-stack replacement.
+    QCOMPARE(sumSquares.call(QJSValueList() << 10000).toString(), QString("333283335000,10,243040501500"));
+    QVERIFY(unit->tieredUnit);
+    QVERIFY(!unit->tierUpSource);
+
+    // The next call runs the JIT compiled code.
+    QCOMPARE(sumSquares.call(QJSValueList() << 10000).toString(), QString("333283335000,10,243040501500"));
+    QCOMPARE(sumSquares.call(QJSValueList() << 3).toString(), QString("5,1,0"));
+}
+
+void tst_qqmlecmascript::inlinedCalls()
+{
+    QJSEngine jsEngine;
+    QJSValue result = jsEngine.evaluate(
+        "(function() {\n"
+        "    function clamp(v, lo, hi) { if (v < lo) return lo; if (v > hi) return hi; return v; }\n"
+        "    function scaled(v) { return v * factor; }\n"
+        "    function noArgs(a, b) { return b; }\n"
+        "    var factor = 3;\n"
+        "    var values = [];\n"
+        "    for (var i = -2; i < 3; ++i)\n"
+        "        values.push(clamp(scaled(i), -3, 3));\n"
+        "    values.push(noArgs(1));\n"
+        "    clamp = function(v) { return 'rebound ' + v; };\n"
+        "    values.push(clamp(4, 0, 1));\n"
+        "    return values.join(',');\n"
+        "})()");
+    QCOMPARE(result.toString(), QStringLiteral("-3,-3,0,3,3,,rebound 4"));
+
+    // Calls in a loop that end up rebinding their callee go through the fallback in later iterations.
+    result = jsEngine.evaluate(
+        "(function() {\n"
+        "    function next(x) { if (x > 2) step = function(y) { return y + 10; }; return x + 1; }\n"
+        "    function step(x) { return next(x); }\n"
+        "    var v = 0;\n"
+        "    for (var i = 0; i < 5; ++i)\n"
+        "        v = step(v);\n"
+        "    return v;\n"
+        "})()");
+    QCOMPARE(result.toInt(), 14);
+}
+
+void tst_qqmlecmascript::loopInvariants()
+{
+    QJSEngine jsEngine;
+    QJSValue result = jsEngine.evaluate(
+        "(function(width, height, scale) {\n"
+        "    var sum = 0;\n"
+        "    for (var y = 0; y < height; ++y) {\n"
+        "        for (var x = 0; x < width; ++x) {\n"
+        "            var offset = (width * scale) | 0;\n"
+        "            if (x > 1)\n"
+        "                sum += offset + y * width;\n"
+        "            else\n"
+        "                sum -= (height - 1) * 2;\n"
+        "        }\n"
+        "    }\n"
+        "    return sum;\n"
+        "})(4, 3, 2.5)");
+    // Per row: two columns add 10 + 4y, two subtract 4.
+    QCOMPARE(result.toInt(), 3 * (20 - 8) + 2 * 4 * (0 + 1 + 2));
+
+    // Loads from objects are not hoisted, even when nothing in the loop seems to change them.
+    result = jsEngine.evaluate(
+        "(function() {\n"
+        "    var calls = 0;\n"
+        "    var o = { get length() { return ++calls < 4 ? 10 : 0; } };\n"
+        "    var n = 0;\n"
+        "    for (var i = 0; i < o.length; ++i)\n"
+        "        ++n;\n"
+        "    return n + ',' + calls;\n"
+        "})()");
+    QCOMPARE(result.toString(), QStringLiteral("3,4"));
+}
+
+void tst_qqmlecmascript::typedArrays()
+{
+    QJSEngine jsEngine;
+    QJSValue result = jsEngine.evaluate(
+        "(function() {\n"
+        "    var r = [];\n"
+        "    var u8 = new Uint8Array(4);\n"
+        "    u8[0] = 257; u8[1] = -1; u8[2] = 3.7;\n"
+        "    r.push(u8[0], u8[1], u8[2], u8[3], u8[4], u8.length);\n"
+        "    var c = new Uint8ClampedArray([300, -5, 1.5, 2.5]);\n"
+        "    r.push(c[0], c[1], c[2], c[3]);\n"
+        "    var f = new Float64Array([0.5, 1.5]);\n"
+        "    var sub = f.subarray(1);\n"
+        "    sub[0] = 4;\n"
+        "    r.push(f[1], sub.length, sub.byteOffset);\n"
+        "    var b = new ArrayBuffer(16);\n"
+        "    var i32 = new Int32Array(b, 4, 2);\n"
+        "    i32.set([7, 8]);\n"
+        "    var all = new Int32Array(b);\n"
+        "    r.push(all[0], all[1], all[2], all[3], b.slice(4, 12).byteLength);\n"
+        "    var big = new Float32Array(100);\n"
+        "    for (var i = 0; i < big.length; ++i)\n"
+        "        big[i] = i * 0.5;\n"
+        "    var sum = 0;\n"
+        "    for (var i = 0; i < big.length; ++i)\n"
+        "        sum += big[i];\n"
+        "    r.push(sum);\n"
+        "    return r.join(',');\n"
+        "})()");
+    QCOMPARE(result.toString(), QStringLiteral("1,255,3,0,,4,255,0,2,2,4,1,8,0,7,8,0,8,2475"));
+
+    result = jsEngine.evaluate("new Uint8Array(-1)");
+    QVERIFY(result.isError());
+    result = jsEngine.evaluate("new Int32Array(new ArrayBuffer(6), 2)");
+    QVERIFY(result.isError());
+    QCOMPARE(jsEngine.evaluate("Float32Array.BYTES_PER_ELEMENT").toInt(), 4);
+}
+
+void tst_qqmlecmascript::integerArraySort()
+{
+    QJSEngine jsEngine;
+    QJSValue result = jsEngine.evaluate("[10, 9, 1, -5, 100, 2, -12, 0, 2147483647, -2147483648].sort().join()");
+    QCOMPARE(result.toString(), QStringLiteral("-12,-2147483648,-5,0,1,10,100,2,2147483647,9"));
+
+    // Mixed content still uses the generic string comparison
+    result = jsEngine.evaluate("[10, 'a', 9, 1.5].sort().join()");
+    QCOMPARE(result.toString(), QStringLiteral("1.5,10,9,a"));
+}
+
+static QV4::ArrayData::Type arrayTypeOf(QJSEngine *engine, const QJSValue &value)
+{
+    QV4::ExecutionEngine *v4 = QV8Engine::getV4(engine);
+    QV4::Scope scope(v4);
+    QV4::ScopedObject o(scope, QJSValuePrivate::get(value)->getValue(v4));
+    return o ? o->arrayType() : QV4::ArrayData::Simple;
+}
+
+void tst_qqmlecmascript::packedArrays()
+{
+    QJSEngine jsEngine;
+
+    QJSValue a = jsEngine.evaluate("[3, 1, 2]");
+    QCOMPARE(arrayTypeOf(&jsEngine, a), QV4::ArrayData::Int32);
+
+    a = jsEngine.evaluate("var a = []; for (var i = 0; i < 100; ++i) a.push(i); a");
+    QCOMPARE(arrayTypeOf(&jsEngine, a), QV4::ArrayData::Int32);
+    QCOMPARE(jsEngine.evaluate("a[99] + a.length").toInt(), 199);
+
+    // storing a fraction widens the elements to doubles
+    a = jsEngine.evaluate("a[5] = 0.5; a");
+    QCOMPARE(arrayTypeOf(&jsEngine, a), QV4::ArrayData::Double);
+    QCOMPARE(jsEngine.evaluate("a[5] + a[6]").toNumber(), 6.5);
+    QCOMPARE(jsEngine.evaluate("1/[-0][0]").toNumber(), -qInf());
+
+    // anything but a number converts to boxed values
+    a = jsEngine.evaluate("a[7] = 'x'; a");
+    QCOMPARE(arrayTypeOf(&jsEngine, a), QV4::ArrayData::Simple);
+    QCOMPARE(jsEngine.evaluate("a.slice(4, 9).join()").toString(), QStringLiteral("4,0.5,6,x,8"));
+
+    // holes
+    QCOMPARE(jsEngine.evaluate("var b = [1, 2, 3]; b[5] = 6; b.join() + ',' + (4 in b)").toString(),
+             QStringLiteral("1,2,3,,,6,false"));
+    QCOMPARE(jsEngine.evaluate("var c = [1, 2, 3]; delete c[1]; c.join() + ',' + (1 in c)").toString(),
+             QStringLiteral("1,,3,false"));
+    a = jsEngine.evaluate("var d = [1, 2, 3]; delete d[2]; d");
+    QCOMPARE(arrayTypeOf(&jsEngine, a), QV4::ArrayData::Int32);
+    QCOMPARE(jsEngine.evaluate("d.length + ',' + (2 in d) + ',' + d[2]").toString(), QStringLiteral("3,false,undefined"));
+
+    QCOMPARE(jsEngine.evaluate("var e = [4, 5.5]; e.unshift(1, 2); e.shift() + ',' + e.join()").toString(),
+             QStringLiteral("1,2,4,5.5"));
+    QCOMPARE(jsEngine.evaluate("var f = [1, 2, 3]; f.length = 1; f.push(7); f.join()").toString(), QStringLiteral("1,7"));
+    QCOMPARE(jsEngine.evaluate("[1, 2].concat([3.5], [4, 'y']).join()").toString(), QStringLiteral("1,2,3.5,4,y"));
+    QCOMPARE(jsEngine.evaluate("var s = ''; var g = [1, 2.5, 3]; for (var k in g) s += k + '=' + g[k] + ';'; s").toString(),
+             QStringLiteral("0=1;1=2.5;2=3;"));
+    QCOMPARE(jsEngine.evaluate("[3, 1, 20].sort(function(a, b) { return a - b; }).join()").toString(),
+             QStringLiteral("1,3,20"));
+    QCOMPARE(jsEngine.evaluate("[3.5, 1, 20].sort().join()").toString(), QStringLiteral("1,20,3.5"));
+    QCOMPARE(jsEngine.evaluate("var h = [1, 2]; Object.freeze(h); h[0] = 5; h[0] + ',' + Object.isFrozen(h)").toString(),
+             QStringLiteral("1,true"));
+    QCOMPARE(jsEngine.evaluate("var m = [1, 2]; Object.defineProperty(m, 0, { get: function() { return 9; } }); m.join()").toString(),
+             QStringLiteral("9,2"));
+}
+
+void tst_qqmlecmascript::jsonParseAndStringify()
+{
+    QJSEngine jsEngine;
+    QJSValue result = jsEngine.evaluate(
+        "JSON.stringify({a: 1, b: undefined, c: [1, undefined, function() {}], d: 'x\\\"\\n\\u0001', e: 0.5}, null, 2)");
+    QCOMPARE(result.toString(), QStringLiteral("{\n  \"a\": 1,\n  \"c\": [\n    1,\n    null,\n    null\n  ],\n"
+                                               "  \"d\": \"x\\\"\\n\\u0001\",\n  \"e\": 0.5\n}"));
+
+    result = jsEngine.evaluate("JSON.stringify({b: undefined, x: {}, y: [], z: [[]]})");
+    QCOMPARE(result.toString(), QStringLiteral("{\"x\":{},\"y\":[],\"z\":[[]]}"));
+
+    // Repeated keys are served from the parser's key cache, escaped ones are not
+    result = jsEngine.evaluate(
+        "JSON.parse('[{\"id\":1,\"n\":\"a\"},{\"id\":2,\"n\":\"b\"},{\"i\\\\u0064\":3}]')"
+        ".map(function(o) { return o.id + o.n; }).join()");
+    QCOMPARE(result.toString(), QStringLiteral("1a,2b,3undefined"));
+
+    QV4::ExecutionEngine *v4 = QV8Engine::getV4(&jsEngine);
+    QV4::Scope scope(v4);
+    QJsonParseError error;
+    QV4::ScopedObject o(scope, QV4::JsonObject::fromJson(v4, QByteArray("{\"k\": [1, \"\xc3\xa4\"]}"), &error));
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QVERIFY(o);
+    QV4::ScopedString k(scope, v4->newIdentifier(QStringLiteral("k")));
+    QV4::ScopedObject a(scope, o->get(k));
+    QVERIFY(a);
+    QCOMPARE(QV4::ScopedValue(scope, a->getIndexed(1))->toQStringNoThrow(), QString(QChar(0xe4)));
+
+    QV4::JsonObject::fromJson(v4, QByteArray("{\"k\": }"), &error);
+    QVERIFY(error.error != QJsonParseError::NoError);
+}
+
+void tst_qqmlecmascript::sharedRegExpCode()
+{
+    const QString source = QStringLiteral("/sh(a)red-[0-9]+/i.exec('xSHared-42')[1]");
+
+    const QV4::RegExpCodeCacheStatistics before = QV4::RegExp::sharedCodeCacheStatistics();
+    {
+        QJSEngine jsEngine;
+        QCOMPARE(jsEngine.evaluate(source).toString(), QStringLiteral("a"));
+    }
+    const QV4::RegExpCodeCacheStatistics afterFirst = QV4::RegExp::sharedCodeCacheStatistics();
+    if (afterFirst.misses == before.misses && afterFirst.hits == before.hits)
+        QSKIP("Regular expressions are not JIT compiled on this platform");
+
+    // The engine compiles patterns of its own during construction
+    QJSEngine jsEngine;
+    const QV4::RegExpCodeCacheStatistics beforeSecond = QV4::RegExp::sharedCodeCacheStatistics();
+    QCOMPARE(jsEngine.evaluate(source).toString(), QStringLiteral("a"));
+    const QV4::RegExpCodeCacheStatistics afterSecond = QV4::RegExp::sharedCodeCacheStatistics();
+    QCOMPARE(afterSecond.misses, beforeSecond.misses);
+    QCOMPARE(afterSecond.hits, beforeSecond.hits + 1);
+    QVERIFY(afterSecond.entries > 0);
+}
+
+void tst_qqmlecmascript::lazyArgumentsObject()
+{
+    QJSEngine jsEngine;
+    QJSValue result = jsEngine.evaluate(
+        "(function() {"
+        "    function sum() { var s = 0; for (var i = 0; i < arguments.length; ++i) s += arguments[i]; return s; }"
+        "    function at(a, b) { return arguments[2] + ',' + arguments[5] + ',' + arguments['length'] + ',' + arguments.length; }"
+        "    function mapped(a) { a = 42; return arguments[0]; }"
+        "    function strict(a) { 'use strict'; a = 42; return arguments[0]; }"
+        "    function written(a) { arguments[0] = 42; return a; }"
+        "    function callee() { return typeof arguments['callee']; }"
+        "    return [sum(), sum(1, 2, 3), new sum(4, 5) instanceof sum, at(1, 2, 3), mapped(1), strict(1),"
+        "            written(1), callee()].join(';');"
+        "})()");
+    QCOMPARE(result.toString(), QStringLiteral("0;6;true;3,undefined,3,3;42;1;42;function"));
+}
+
+void tst_qqmlecmascript::samplingProfiler()
+{
+    QJSEngine jsEngine;
+    QV4::ExecutionEngine *v4 = QV8Engine::getV4(&jsEngine);
+    v4->enableProfiler();
+    QV4::Profiling::Profiler *profiler = v4->profiler;
+    profiler->setSamplingInterval(100);
+    QCOMPARE(profiler->samplingInterval(), 100);
+
+    QSignalSpy spy(profiler, SIGNAL(dataReady(QList<QV4::Profiling::FunctionCallProperties>)));
+    profiler->startProfiling();
+    jsEngine.evaluate(
+        "function leaf(i) { return i * 2; }"
+        "function outer() { var s = 0; for (var i = 0; i < 100; ++i) s += leaf(i); return s; }"
+        "var start = Date.now();"
+        "while (Date.now() - start < 100) outer();");
+    profiler->stopProfiling();
+
+    QCOMPARE(spy.count(), 1);
+    QList<QV4::Profiling::FunctionCallProperties> calls =
+            spy.at(0).at(0).value<QList<QV4::Profiling::FunctionCallProperties> >();
+    QVERIFY(!calls.isEmpty());
+
+    // The call tree comes out as nested ranges: outer once, leaf inside it.
+    int outerIndex = -1;
+    for (int i = 0; i < calls.count(); ++i) {
+        if (calls.at(i).name == QLatin1String("outer")) {
+            QCOMPARE(outerIndex, -1);
+            outerIndex = i;
+        }
+        if (i > 0)
+            QVERIFY(calls.at(i).start >= calls.at(i - 1).start);
+    }
+    QVERIFY(outerIndex != -1);
+    const QV4::Profiling::FunctionCallProperties &outer = calls.at(outerIndex);
+    QVERIFY(outer.end > outer.start);
+    for (int i = 0; i < calls.count(); ++i) {
+        if (calls.at(i).name == QLatin1String("leaf")) {
+            QVERIFY(calls.at(i).start >= outer.start);
+            QVERIFY(calls.at(i).end <= outer.end);
+        }
+    }
+
+    // Switching back to tracing records every call again.
+    profiler->setSamplingInterval(0);
+    profiler->startProfiling();
+    jsEngine.evaluate("leaf(1); leaf(2);");
+    profiler->stopProfiling();
+    QCOMPARE(spy.count(), 2);
+    calls = spy.at(1).at(0).value<QList<QV4::Profiling::FunctionCallProperties> >();
+    QCOMPARE(calls.count(), 2);
+}
+
+void tst_qqmlecmascript::allocationSamplingProfiler()
+{
+    QJSEngine jsEngine;
+    QV4::ExecutionEngine *v4 = QV8Engine::getV4(&jsEngine);
+    v4->enableProfiler();
+    QV4::Profiling::Profiler *profiler = v4->profiler;
+    profiler->setAllocationSamplingInterval(1024);
+    QCOMPARE(profiler->allocationSamplingInterval(), 1024);
+
+    QSignalSpy spy(profiler,
+                   SIGNAL(allocationsReady(QList<QV4::Profiling::AllocationSiteProperties>)));
+    profiler->startProfiling();
+    jsEngine.evaluate(
+        "function allocate() { var a = []; for (var i = 0; i < 1000; ++i) a.push({ x: i }); return a; }"
+        "function outer() { return allocate().length; }"
+        "for (var j = 0; j < 10; ++j) outer();");
+    v4->memoryManager->runGC();
+    profiler->stopProfiling();
+
+    QCOMPARE(spy.count(), 1);
+    QList<QV4::Profiling::AllocationSiteProperties> sites =
+            spy.at(0).at(0).value<QList<QV4::Profiling::AllocationSiteProperties> >();
+    QVERIFY(!sites.isEmpty());
+
+    // Pre-order: allocate is nested in outer, and the object classes are leaves of functions.
+    int outerIndex = -1;
+    int allocateIndex = -1;
+    bool hasObjectClass = false;
+    for (int i = 0; i < sites.count(); ++i) {
+        const QV4::Profiling::AllocationSiteProperties &site = sites.at(i);
+        QCOMPARE(site.bytes, qint64(site.samples) * 1024);
+        if (i > 0)
+            QVERIFY(site.depth <= sites.at(i - 1).depth + 1);
+        if (site.objectClass) {
+            hasObjectClass = true;
+            QVERIFY(i + 1 == sites.count() || sites.at(i + 1).depth <= site.depth);
+        } else if (site.name == QLatin1String("outer")) {
+            outerIndex = i;
+        } else if (site.name == QLatin1String("allocate") && outerIndex != -1
+                   && site.depth == sites.at(outerIndex).depth + 1) {
+            allocateIndex = i;
+        }
+    }
+    QVERIFY(hasObjectClass);
+    QVERIFY(outerIndex != -1);
+    QVERIFY(allocateIndex > outerIndex);
+    QVERIFY(sites.at(allocateIndex).samples <= sites.at(outerIndex).samples);
+
+    // Without an interval nothing is sampled.
+    profiler->setAllocationSamplingInterval(0);
+    profiler->startProfiling();
+    jsEngine.evaluate("outer();");
+    profiler->stopProfiling();
+    QCOMPARE(spy.count(), 1);
+}
+
+void tst_qqmlecmascript::bindingDependencyOrder()
+{
+    QQmlComponent component(&engine, testFileUrl("bindingDependencyOrder.qml"));
+    QScopedPointer<QObject> object(component.create());
+    QVERIFY(object != 0);
+    QCOMPARE(object->property("result").toInt(), 126);
+
+    // Reverse the order the dependencies are read in
+    object->setProperty("swap", true);
+    QCOMPARE(object->property("result").toInt(), 322);
+
+    object->setProperty("a", 4);
+    QCOMPARE(object->property("result").toInt(), 328);
+    object->setProperty("b", 5);
+    QCOMPARE(object->property("result").toInt(), 358);
+    object->setProperty("c", 6);
+    QCOMPARE(object->property("result").toInt(), 658);
+
+    object->setProperty("swap", false);
+    QCOMPARE(object->property("result").toInt(), 462);
+    object->setProperty("c", 7);
+    QCOMPARE(object->property("result").toInt(), 464);
+    object->setProperty("a", 1);
+    QCOMPARE(object->property("result").toInt(), 164);
+}
+
+void tst_qqmlecmascript::deferredBindingUpdates()
+{
+    QQmlEngine engine;
+    QQmlEnginePrivate *ep = QQmlEnginePrivate::get(&engine);
+    ep->deferBindingUpdates = true;
+
+    QQmlComponent component(&engine, testFileUrl("deferredBindingUpdates.qml"));
+    QScopedPointer<QObject> object(component.create());
+    QVERIFY(object != 0);
+    QCOMPARE(object->property("doubled").toInt(), 6);
+    int changes = object->property("sumChanges").toInt();
+
+    // Both changes are coalesced into a single update
+    object->setProperty("a", 10);
+    object->setProperty("b", 20);
+    QCOMPARE(object->property("sum").toInt(), 3);
+    QVERIFY(ep->deferredBindings != 0);
+    ep->flushDeferredBindingUpdates();
+    QVERIFY(ep->deferredBindings == 0);
+    QCOMPARE(object->property("sum").toInt(), 30);
+    QCOMPARE(object->property("doubled").toInt(), 60);
+    QCOMPARE(object->property("sumChanges").toInt(), changes + 1);
+
+    // Reading a property from script brings its binding up to date first
+    object->setProperty("a", 100);
+    QQmlExpression expr(engine.rootContext(), object.data(), "sum");
+    QCOMPARE(expr.evaluate().toInt(), 120);
+
+    // The queue is also flushed from the event loop
+    object->setProperty("b", 200);
+    QTRY_COMPARE(object->property("doubled").toInt(), 600);
+
+    // Synchronous bindings are updated immediately
+    QQmlBinding *binding = static_cast<QQmlBinding *>(QQmlPropertyPrivate::binding(QQmlProperty(object.data(), "sum")));
+    QVERIFY(binding != 0);
+    binding->setSynchronous(true);
+    object->setProperty("a", 1);
+    QCOMPARE(object->property("sum").toInt(), 201);
+    QVERIFY(!binding->isUpdateDeferred());
+}
+
+void tst_qqmlecmascript::mathIntrinsics()
+{
+    QQmlComponent component(&engine, testFileUrl("mathIntrinsics.qml"));
+    QScopedPointer<QObject> object(component.create());
+    QVERIFY(object != 0);
+
+    QVariant failures;
+    QVERIFY(QMetaObject::invokeMethod(object.data(), "run", Q_RETURN_ARG(QVariant, failures)));
+    QCOMPARE(failures.toString(), QString());
+}
+
 QTEST_MAIN(tst_qqmlecmascript)
 
 #include "tst_qqmlecmascript.moc"
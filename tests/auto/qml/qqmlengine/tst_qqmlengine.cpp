@@ -82,6 +82,7 @@ private slots:
     void qtqmlModule();
     void urlInterceptor_data();
     void urlInterceptor();
+    void releaseResources();
 
 public slots:
     QObject *createAQObjectForOwnershipTest ()
@@ -785,6 +786,33 @@ void tst_qqmlengine::urlInterceptor()
     QCOMPARE(o->property("absoluteUrl").toString(), expectedAbsoluteUrl);
 }
 
+void tst_qqmlengine::releaseResources()
+{
+    QQmlEngine engine;
+
+    // Nothing to release yet, but it must not hurt either.
+    QVERIFY(engine.releaseResources() >= 0);
+
+    // Fill a few heap chunks with garbage only.
+    QJSValue result = engine.evaluate(
+                "(function() {\n"
+                "    var list = [];\n"
+                "    for (var i = 0; i < 100000; ++i)\n"
+                "        list.push({ value: i });\n"
+                "    return list.length;\n"
+                "})()");
+    QCOMPARE(result.toInt(), 100000);
+
+    QVERIFY(engine.releaseResources(QQmlEngine::AggressiveRelease) > 0);
+
+    // The heap is in a usable state afterwards.
+    result = engine.evaluate("var o = { a: [1, 2, 3], b: 'string' }; o.a.length + o.b.length");
+    QCOMPARE(result.toInt(), 9);
+    engine.collectGarbage();
+    result = engine.evaluate("o.a[2] + o.b.length");
+    QCOMPARE(result.toInt(), 9);
+}
+
 QTEST_MAIN(tst_qqmlengine)
 
 #include "tst_qqmlengine.moc"
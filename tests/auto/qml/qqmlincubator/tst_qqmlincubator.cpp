@@ -81,6 +81,7 @@ private slots:
     void chainedAsynchronousClear();
     void selfDelete();
     void contextDelete();
+    void preloadAfterVisible();
 
 private:
     QQmlIncubationController controller;
@@ -1159,6 +1160,38 @@ void tst_qqmlincubator::contextDelete()
     }
 }
 
+// Incubators marked as preloading only get time once no other incubator waits
+void tst_qqmlincubator::preloadAfterVisible()
+{
+    QQmlComponent component(&engine, testFileUrl("clear.qml"));
+    QVERIFY(component.isReady());
+
+    QQmlIncubator visible;
+    component.create(visible);
+    QQmlIncubator preload;
+    QQmlIncubatorPrivate::get(&preload)->preload = true;
+    component.create(preload);
+
+    QVERIFY(visible.isLoading());
+    QVERIFY(preload.isLoading());
+
+    while (visible.isLoading()) {
+        QVERIFY(preload.isLoading());
+        bool b = false;
+        controller.incubateWhile(&b);
+    }
+    QVERIFY(visible.isReady());
+
+    while (preload.isLoading()) {
+        bool b = false;
+        controller.incubateWhile(&b);
+    }
+    QVERIFY(preload.isReady());
+
+    delete visible.object();
+    delete preload.object();
+}
+
 QTEST_MAIN(tst_qqmlincubator)
 
 #include "tst_qqmlincubator.moc"
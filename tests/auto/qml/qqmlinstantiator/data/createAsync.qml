@@ -0,0 +1,19 @@
+import QtQml 2.1
+
+Instantiator {
+    model: 10
+    delegate: QtObject {
+        property bool success: true
+        property int idx: index
+    }
+}
+import QtQml 2.1
+
+Instantiator {
+    model: 50
+    asynchronous: true
+    delegate: QtObject {
+        property bool success: true
+        property int idx: index
+    }
+}
@@ -46,6 +46,7 @@
 #include <QtQml/qqmlcomponent.h>
 #include <QtQml/private/qqmlinstantiator_p.h>
 #include <QtQml/qqmlcontext.h>
+#include <QtQml/qqmlincubator.h>
 #include "../../shared/util.h"
 #include "stringmodel.h"
 
@@ -61,6 +62,7 @@ private slots:
     void activeProperty();
     void intModelChange();
     void createAndRemove();
+    void asynchronous();
 };
 
 void tst_qqmlinstantiator::createNone()
@@ -217,6 +219,43 @@ void tst_qqmlinstantiator::createAndRemove()
         QCOMPARE(object->property("datum").toString(), names[i]);
     }
 }
+void tst_qqmlinstantiator::asynchronous()
+{
+    QQmlEngine engine;
+    QQmlIncubationController controller;
+    engine.setIncubationController(&controller);
+
+    QQmlComponent component(&engine, testFileUrl("createAsync.qml"));
+    QScopedPointer<QQmlInstantiator> instantiator(qobject_cast<QQmlInstantiator*>(component.create()));
+    QVERIFY(instantiator != 0);
+    QSignalSpy addedSpy(instantiator.data(), SIGNAL(objectAdded(int,QObject*)));
+
+    // The slots for all rows exist already, the objects are created over time
+    QCOMPARE(instantiator->count(), 50);
+    QVERIFY(controller.incubatingObjectCount() > 0);
+    while (controller.incubatingObjectCount() > 0)
+        controller.incubateFor(5);
+
+    QCOMPARE(instantiator->count(), 50);
+    QCOMPARE(addedSpy.count(), 50);
+    for (int i=0; i<50; i++) {
+        QObject *object = instantiator->objectAt(i);
+        QVERIFY(object);
+        QCOMPARE(object->parent(), instantiator.data());
+        QCOMPARE(object->property("idx").toInt(), i);
+    }
+
+    instantiator->setModel(QVariant(3));
+    QCOMPARE(instantiator->count(), 3);
+    while (controller.incubatingObjectCount() > 0)
+        controller.incubateFor(5);
+    for (int i=0; i<3; i++) {
+        QObject *object = instantiator->objectAt(i);
+        QVERIFY(object);
+        QCOMPARE(object->property("idx").toInt(), i);
+    }
+}
+
 QTEST_MAIN(tst_qqmlinstantiator)
 
 #include "tst_qqmlinstantiator.moc"
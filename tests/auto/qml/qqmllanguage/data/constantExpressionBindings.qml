@@ -0,0 +1,11 @@
+import QtQml 2.0
+
+QtObject {
+    property int product: 100 * 2
+    property int truncated: 7 / 2
+    property real fraction: 1 / 4
+    property real negative: -(3 + 4)
+    property bool negated: !0
+    property string joined: "con" + "stant"
+    property var variant: 2 * 3
+}
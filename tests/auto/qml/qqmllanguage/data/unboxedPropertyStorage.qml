@@ -0,0 +1,29 @@
+import QtQuick 2.0
+QtObject {
+    property bool a
+    property int b
+    property string c: "c"
+    property bool d: true
+    property real e
+    property list<QtObject> f: [ QtObject {}, QtObject {} ]
+    property int g: 7
+    property color h: "blue"
+    property bool i: true
+
+    property int changes: 0
+    onBChanged: ++changes
+
+    property bool result: false
+    Component.onCompleted: {
+        if (a !== false || b !== 0 || c !== "c" || d !== true || e !== 0 || g !== 7 || i !== true)
+            return
+        if (f.length !== 2 || h != "#0000ff")
+            return
+        b = 5
+        b = 5
+        e = 1.5
+        a = true
+        result = a === true && b === 5 && e === 1.5 && changes === 1
+                && d === true && g === 7 && i === true && c === "c"
+    }
+}
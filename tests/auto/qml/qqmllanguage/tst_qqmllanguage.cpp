@@ -112,6 +112,7 @@ private slots:
     void overrideSignal();
     void dynamicProperties();
     void dynamicPropertiesNested();
+    void unboxedPropertyStorage();
     void listProperties();
     void dynamicObjectProperties();
     void dynamicSignalsAndSlots();
@@ -218,6 +219,8 @@ private slots:
 
     void earlyIdObjectAccess();
 
+    void constantExpressionBindings();
+
 private:
     QQmlEngine engine;
     QStringList defaultImportPathList;
@@ -1257,6 +1260,27 @@ void tst_qqmllanguage::dynamicProperties()
     QCOMPARE(object->property("varProperty"), QVariant("Hello World!"));
 }
 
+// Test that properties of mixed types stored next to each other keep their values
+void tst_qqmllanguage::unboxedPropertyStorage()
+{
+    QQmlComponent component(&engine, testFileUrl("unboxedPropertyStorage.qml"));
+    VERIFY_ERRORS(0);
+    QScopedPointer<QObject> object(component.create());
+    QVERIFY(!object.isNull());
+    QCOMPARE(object->property("result").toBool(), true);
+
+    QCOMPARE(object->property("b"), QVariant(5));
+    QCOMPARE(object->property("e"), QVariant(1.5));
+    QVERIFY(object->setProperty("g", 12));
+    QCOMPARE(object->property("g"), QVariant(12));
+    QCOMPARE(object->property("i"), QVariant(true));
+    QCOMPARE(object->property("c"), QVariant(QString("c")));
+    QCOMPARE(object->property("h"), QVariant(QColor("blue")));
+
+    QQmlListReference list(object.data(), "f");
+    QCOMPARE(list.count(), 2);
+}
+
 // Test that nested types can use dynamic properties
 void tst_qqmllanguage::dynamicPropertiesNested()
 {
@@ -3653,6 +3677,29 @@ void tst_qqmllanguage::earlyIdObjectAccess()
     QVERIFY(o->property("success").toBool());
 }
 
+void tst_qqmllanguage::constantExpressionBindings()
+{
+    QQmlComponent component(&engine, testFileUrl("constantExpressionBindings.qml"));
+    VERIFY_ERRORS(0);
+    QScopedPointer<QObject> o(component.create());
+    QVERIFY(!o.isNull());
+
+    QCOMPARE(o->property("product").toInt(), 200);
+    QCOMPARE(o->property("truncated").toInt(), 3);
+    QCOMPARE(o->property("fraction").toReal(), qreal(0.25));
+    QCOMPARE(o->property("negative").toReal(), qreal(-7));
+    QCOMPARE(o->property("negated").toBool(), true);
+    QCOMPARE(o->property("joined").toString(), QStringLiteral("constant"));
+    QCOMPARE(o->property("variant").toInt(), 6);
+
+    // Folded expressions are assigned as literals, the others remain bindings.
+    QVERIFY(!QQmlPropertyPrivate::binding(QQmlProperty(o.data(), "product")));
+    QVERIFY(!QQmlPropertyPrivate::binding(QQmlProperty(o.data(), "fraction")));
+    QVERIFY(!QQmlPropertyPrivate::binding(QQmlProperty(o.data(), "negated")));
+    QVERIFY(!QQmlPropertyPrivate::binding(QQmlProperty(o.data(), "joined")));
+    QVERIFY(QQmlPropertyPrivate::binding(QQmlProperty(o.data(), "truncated")));
+}
+
 QTEST_MAIN(tst_qqmllanguage)
 
 #include "tst_qqmllanguage.moc"
@@ -150,6 +150,7 @@ class tst_qqmllistcompositor : public QObject
 private slots:
     void find_data();
     void find();
+    void findFragmented();
     void findInsertPosition_data();
     void findInsertPosition();
     void insert();
@@ -233,6 +234,72 @@ void tst_qqmllistcompositor::find()
     QCOMPARE(it->index, rangeIndex);
 }
 
+void tst_qqmllistcompositor::findFragmented()
+{
+    int listA; void *a = &listA;
+
+    QQmlListCompositor compositor;
+    compositor.setGroupCount(4);
+    compositor.setDefaultGroups(VisibleFlag | C::DefaultFlag);
+
+    // Discontinuous list indexes prevent the ranges from being merged.
+    for (int i = 0; i < 200; ++i)
+        compositor.append(a, i * 3, 2, C::DefaultFlag | (i % 2 ? int(C::CacheFlag) : 0));
+
+    QCOMPARE(compositor.count(C::Default), 400);
+    QCOMPARE(compositor.count(C::Cache), 200);
+
+    for (int i = 0; i < 400; ++i) {
+        const int index = (i * 37) % 400;
+        QQmlListCompositor::iterator it = compositor.find(C::Default, index);
+        QCOMPARE(it.index[C::Default], index);
+        QCOMPARE(it.modelIndex(), (index / 2) * 3 + index % 2);
+    }
+
+    for (int i = 0; i < 200; ++i) {
+        const int index = (i * 71) % 200;
+        QQmlListCompositor::iterator it = compositor.find(C::Cache, index);
+        QCOMPARE(it.index[C::Cache], index);
+        QCOMPARE(it.index[C::Default], (index / 2) * 4 + 2 + index % 2);
+        QCOMPARE(it.modelIndex(), (index / 2) * 6 + 3 + index % 2);
+    }
+
+    compositor.insert(C::Default, 100, a, 1000, 2, C::DefaultFlag);
+    QCOMPARE(compositor.count(C::Default), 402);
+
+    for (int i = 0; i < 402; ++i) {
+        const int index = (i * 37) % 402;
+        const int expected = index < 100 ? (index / 2) * 3 + index % 2
+                : index < 102 ? 900 + index
+                : ((index - 2) / 2) * 3 + index % 2;
+        QQmlListCompositor::iterator it = compositor.find(C::Default, index);
+        QCOMPARE(it.index[C::Default], index);
+        QCOMPARE(it.modelIndex(), expected);
+
+        QQmlListCompositor::insert_iterator insertIt = compositor.findInsertPosition(C::Default, index);
+        QCOMPARE(insertIt.index[C::Default], index);
+    }
+
+    // Interleave modifications with lookups on either side of them.
+    QVector<int> modelIndexes;
+    for (int i = 0; i < 402; ++i)
+        modelIndexes.append(compositor.find(C::Default, i).modelIndex());
+
+    for (int i = 0; i < 100; ++i) {
+        const int removeIndex = (i * 53) % modelIndexes.count();
+        compositor.clearFlags(C::Default, removeIndex, 1, C::DefaultFlag);
+        modelIndexes.remove(removeIndex);
+        QCOMPARE(compositor.count(C::Default), modelIndexes.count());
+
+        for (int j = 0; j < 8; ++j) {
+            const int index = (j * 41 + i) % modelIndexes.count();
+            QQmlListCompositor::iterator it = compositor.find(C::Default, index);
+            QCOMPARE(it.index[C::Default], index);
+            QCOMPARE(it.modelIndex(), modelIndexes.at(index));
+        }
+    }
+}
+
 void tst_qqmllistcompositor::findInsertPosition_data()
 {
     QTest::addColumn<RangeList>("ranges");
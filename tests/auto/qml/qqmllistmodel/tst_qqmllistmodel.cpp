@@ -417,6 +417,14 @@ void tst_qqmllistmodel::dynamic_data()
         QTest::newRow("append4b") << "{append([{'foo':123},{'foo':456},{'foo':789}]);count}" << 3 << "" << dr;
         QTest::newRow("append4c") << "{append([{'foo':123},{'foo':456},{'foo':789}]);get(1).foo}" << 456 << "" << dr;
 
+        QTest::newRow("appendRows1") << "{appendRows(['foo','bar'],[[1,2],[3,4],[5,6]]);count}" << 3 << "" << dr;
+        QTest::newRow("appendRows2") << "{appendRows(['foo','bar'],[[1,2],[3,4],[5,6]]);get(2).bar}" << 6 << "" << dr;
+        QTest::newRow("appendRows3") << "{append({'foo':7});appendRows(['foo'],[[8],[9]]);get(1).foo}" << 8 << "" << dr;
+        QTest::newRow("appendRows4") << "{appendRows(['foo'],[[1],2]);count}" << 0 << "<Unknown File>: QML ListModel: appendRows: row 1 is not an array" << dr;
+        QTest::newRow("appendColumns1") << "{appendColumns({'foo':[1,2,3],'bar':[4,5,6]});count}" << 3 << "" << dr;
+        QTest::newRow("appendColumns2") << "{appendColumns({'foo':[1,2,3],'bar':[4,5,6]});get(1).bar}" << 5 << "" << dr;
+        QTest::newRow("appendColumns3") << "{appendColumns({'foo':[1,2],'bar':[4]});count}" << 0 << "<Unknown File>: QML ListModel: appendColumns: columns differ in length" << dr;
+
         QTest::newRow("clear1") << "{append({'foo':456});clear();count}" << 0 << "" << dr;
         QTest::newRow("clear2") << "{append({'foo':123});append({'foo':456});clear();count}" << 0 << "" << dr;
         QTest::newRow("clear3") << "{append({'foo':123});clear()}" << 0 << "" << dr;
@@ -326,7 +326,14 @@ void tst_qqmllistmodelworkerscript::dynamic_data()
         QTest::newRow("js7") << "{append({'foo':{'prop':27}});set(0, {'foo':null});count}" << 1 << "" << dr;
         QTest::newRow("js8") << "{append({'foo':{'prop':27}});set(0, {'foo':{'prop2':31}});get(0).foo.prop2}" << 31 << "" << dr;
 
+        // Change logs replayed on sync
+        QTest::newRow("replay-move1") << "{append({'foo':1});append({'foo':2});append({'foo':3});move(0,2,1);get(2).foo}" << 1 << "" << dr;
+        QTest::newRow("replay-move2") << "{append({'foo':1});append({'foo':2});append({'foo':3});move(2,0,1);get(0).foo}" << 3 << "" << dr;
+        QTest::newRow("replay-move3") << "{append({'foo':1});append({'foo':2});append({'foo':3});move(0,1,2);get(0).foo}" << 3 << "" << dr;
+        QTest::newRow("replay-remove-set") << "{append({'foo':1});append({'foo':2});remove(0);set(0,{'foo':5});get(0).foo}" << 5 << "" << dr;
+
         // Nested models
+
         QTest::newRow("nested-append1") << "{append({'foo':123,'bars':[{'a':1},{'a':2},{'a':3}]});count}" << 1 << "" << dr;
         QTest::newRow("nested-append2") << "{append({'foo':123,'bars':[{'a':1},{'a':2},{'a':3}]});get(0).bars.get(1).a}" << 2 << "" << dr;
         QTest::newRow("nested-append3") << "{append({'foo':123,'bars':[{'a':1},{'a':2},{'a':3}]});get(0).bars.append({'a':4});get(0).bars.get(3).a}" << 4 << "" << dr;
@@ -0,0 +1,38 @@
+import QtQuick 2.0
+
+QtObject {
+    function checkDay(failures, day) {
+        var d = new Date(2013, 0, 1 + day, 12, 30);
+        // CET/CEST: summer time from March 31st until October 27th 2013
+        var summer = day >= 89 && day < 299;
+        if (d.getHours() != 12 || d.getMinutes() != 30)
+            failures.push("day " + day + ": " + d.getHours() + ":" + d.getMinutes());
+        if (d.getTimezoneOffset() != (summer ? -120 : -60))
+            failures.push("day " + day + ": offset " + d.getTimezoneOffset());
+    }
+
+    function run() {
+        Date.timeZoneUpdated()
+
+        var failures = [];
+        var day;
+        for (day = 0; day < 365; day += 7)
+            checkDay(failures, day);
+        for (day = 364; day >= 0; --day)
+            checkDay(failures, day);
+
+        // Hour by hour across the spring transition at 01:00 UTC
+        var expectedHours = [1, 3, 4];
+        for (var hour = 0; hour < 3; ++hour) {
+            var t = new Date(Date.UTC(2013, 2, 31, hour));
+            if (t.getHours() != expectedHours[hour])
+                failures.push("UTC hour " + hour + ": " + t.getHours());
+        }
+
+        return failures.join("; ");
+    }
+
+    function resetTimeZone() {
+        Date.timeZoneUpdated()
+    }
+}
@@ -85,6 +85,7 @@ private slots:
     void timeFormat();
 #if defined(Q_OS_UNIX)
     void timeZoneUpdated();
+    void daylightSaving();
 #endif
 
     void dateToLocaleString_data();
@@ -108,6 +109,9 @@ private slots:
 
     void numberToLocaleString_data();
     void numberToLocaleString();
+    void numberToLocaleStringIntegral_data();
+    void numberToLocaleStringIntegral();
+    void localeObjectShared();
     void numberToLocaleCurrencyString_data();
     void numberToLocaleCurrencyString();
     void numberFromLocaleString_data();
@@ -1092,6 +1096,67 @@ void tst_qqmllocale::numberToLocaleString()
     QCOMPARE(val.toString(), l.toString(number, format, prec));
 }
 
+void tst_qqmllocale::numberToLocaleStringIntegral_data()
+{
+    QTest::addColumn<QString>("locale");
+
+    QTest::newRow("en_US") << "en_US";
+    QTest::newRow("de_DE") << "de_DE";
+    QTest::newRow("fr_FR") << "fr_FR";
+    QTest::newRow("ar_SA") << "ar_SA";
+    QTest::newRow("C") << "C";
+}
+
+void tst_qqmllocale::numberToLocaleStringIntegral()
+{
+    QFETCH(QString, locale);
+
+    QQmlComponent c(&engine, testFileUrl("number.qml"));
+
+    QObject *obj = c.create();
+    QVERIFY(obj);
+
+    QMetaObject::invokeMethod(obj, "setLocale", Qt::DirectConnection,
+        Q_ARG(QVariant, QVariant(locale)));
+
+    QLocale l(locale);
+    const double numbers[] = { 0, 7, -42, 999, 1000, 123456, -1234567, 4294967296.0, 1e15 };
+    const int precs[] = { 0, 2, 5 };
+    for (uint i = 0; i < sizeof(numbers) / sizeof(numbers[0]); ++i) {
+        for (uint j = 0; j < sizeof(precs) / sizeof(precs[0]); ++j) {
+            QVariant val;
+            QMetaObject::invokeMethod(obj, "toLocaleString", Qt::DirectConnection,
+                Q_RETURN_ARG(QVariant, val),
+                Q_ARG(QVariant, QVariant(numbers[i])),
+                Q_ARG(QVariant, QVariant(QString("f"))),
+                Q_ARG(QVariant, QVariant(precs[j])));
+            QCOMPARE(val.toString(), l.toString(numbers[i], 'f', precs[j]));
+        }
+    }
+
+    delete obj;
+}
+
+void tst_qqmllocale::localeObjectShared()
+{
+    QQmlEngine e;
+    QQmlComponent c(&e);
+    c.setData("import QtQml 2.2\n"
+              "QtObject {\n"
+              "    property bool sameNamed: Qt.locale(\"de_DE\") === Qt.locale(\"de_DE\")\n"
+              "    property bool sameDefault: Qt.locale() === Qt.locale()\n"
+              "    property bool different: Qt.locale(\"de_DE\") !== Qt.locale(\"en_US\")\n"
+              "    property string name: Qt.locale(\"de_DE\").name\n"
+              "}", QUrl());
+    QObject *obj = c.create();
+    QVERIFY(obj);
+    QVERIFY(obj->property("sameNamed").toBool());
+    QVERIFY(obj->property("sameDefault").toBool());
+    QVERIFY(obj->property("different").toBool());
+    QCOMPARE(obj->property("name").toString(), QString("de_DE"));
+    delete obj;
+}
+
 void tst_qqmllocale::numberToLocaleCurrencyString_data()
 {
     QTest::addColumn<QString>("locale");
@@ -1284,6 +1349,26 @@ void tst_qqmllocale::timeZoneUpdated()
 
     QCOMPARE(obj->property("success").toBool(), true);
 }
+
+void tst_qqmllocale::daylightSaving()
+{
+    QByteArray original(qgetenv("TZ"));
+
+    setTimeZone(QByteArray("CET-1CEST,M3.5.0,M10.5.0/3"));
+
+    QQmlEngine e;
+    QQmlComponent c(&e, testFileUrl("daylightSaving.qml"));
+    QScopedPointer<QObject> obj(c.create());
+    QVERIFY(obj);
+
+    QVariant failures;
+    QMetaObject::invokeMethod(obj.data(), "run", Q_RETURN_ARG(QVariant, failures));
+
+    setTimeZone(original);
+    QMetaObject::invokeMethod(obj.data(), "resetTimeZone");
+
+    QCOMPARE(failures.toString(), QString());
+}
 #endif
 
 QTEST_MAIN(tst_qqmllocale)
@@ -66,6 +66,7 @@ private slots:
     void invalidQmlTypeName();
     void registrationType();
     void compositeType();
+    void registrationAfterLookups();
 
     void isList();
 
@@ -119,6 +120,12 @@ public:
 };
 QML_DECLARE_TYPE(ValueInterceptorTestType);
 
+class LateTestType : public QObject
+{
+    Q_OBJECT
+};
+QML_DECLARE_TYPE(LateTestType);
+
 void tst_qqmlmetatype::initTestCase()
 {
     QQmlDataTest::initTestCase();
@@ -284,6 +291,25 @@ void tst_qqmlmetatype::compositeType()
     QCOMPARE(type->sourceUrl(), testFileUrl("ImplicitType.qml"));
 }
 
+void tst_qqmlmetatype::registrationAfterLookups()
+{
+    // Enough lookups for them to be served from a snapshot of the registry
+    for (int i = 0; i < 1000; ++i) {
+        QVERIFY(QQmlMetaType::qmlType(&TestType::staticMetaObject));
+        QVERIFY(!QQmlMetaType::qmlType(&LateTestType::staticMetaObject));
+    }
+
+    // A registration has to be visible to the next lookup
+    QVERIFY(qmlRegisterType<LateTestType>("Test", 1, 0, "LateTestType") >= 0);
+    QQmlType *type = QQmlMetaType::qmlType(&LateTestType::staticMetaObject);
+    QVERIFY(type);
+    QCOMPARE(type->elementName(), QString("LateTestType"));
+    QCOMPARE(QQmlMetaType::qmlType(QString("LateTestType"), QString("Test"), 1, 0), type);
+    QCOMPARE(QQmlMetaType::qmlType(qMetaTypeId<LateTestType *>()), type);
+    QVERIFY(QQmlMetaType::isQObject(qMetaTypeId<LateTestType *>()));
+    QVERIFY(QQmlMetaType::isList(qMetaTypeId<QQmlListProperty<LateTestType> >()));
+}
+
 QTEST_MAIN(tst_qqmlmetatype)
 
 #include "tst_qqmlmetatype.moc"
@@ -41,7 +41,9 @@
 
 #include <qtest.h>
 #include <private/qqmlpropertycache_p.h>
+#include <private/qqmldata_p.h>
 #include <QtQml/qqmlengine.h>
+#include <QtQml/qqmlcomponent.h>
 #include "../../shared/util.h"
 
 class tst_qqmlpropertycache : public QObject
@@ -57,6 +59,7 @@ private slots:
     void methodsDerived();
     void signalHandlers();
     void signalHandlersDerived();
+    void sharedDerivedCaches();
 
 private:
     QQmlEngine engine;
@@ -278,6 +281,33 @@ void tst_qqmlpropertycache::signalHandlersDerived()
     QCOMPARE(data->coreIndex, metaObject->indexOfMethod("propertyDChanged()"));
 }
 
+void tst_qqmlpropertycache::sharedDerivedCaches()
+{
+    QQmlEngine engine;
+    QQmlComponent component(&engine);
+    component.setData("import QtQml 2.0\n"
+                      "QtObject {\n"
+                      "    property QtObject a: QtObject { property int value: 1; signal ping(int x) }\n"
+                      "    property QtObject b: QtObject { property int value: 2; signal ping(int x) }\n"
+                      "    property QtObject c: QtObject { property real value: 3; signal ping(int x) }\n"
+                      "}", QUrl());
+    QScopedPointer<QObject> root(component.create());
+    QVERIFY2(!root.isNull(), qPrintable(component.errorString()));
+
+    QObject *a = root->property("a").value<QObject *>();
+    QObject *b = root->property("b").value<QObject *>();
+    QObject *c = root->property("c").value<QObject *>();
+    QVERIFY(a && b && c);
+
+    QCOMPARE(a->property("value").toInt(), 1);
+    QCOMPARE(b->property("value").toInt(), 2);
+    QCOMPARE(c->property("value").toReal(), qreal(3));
+
+    QVERIFY(QQmlData::get(a)->propertyCache);
+    QCOMPARE(QQmlData::get(a)->propertyCache, QQmlData::get(b)->propertyCache);
+    QVERIFY(QQmlData::get(a)->propertyCache != QQmlData::get(c)->propertyCache);
+}
+
 QTEST_MAIN(tst_qqmlpropertycache)
 
 #include "tst_qqmlpropertycache.moc"
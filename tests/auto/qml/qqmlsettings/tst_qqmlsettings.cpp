@@ -66,6 +66,7 @@ private slots:
     void categories();
     void siblings();
     void initial();
+    void writeDelay();
 };
 
 class CppObject : public QObject
@@ -597,6 +598,41 @@ void tst_QQmlSettings::initial()
     QCOMPARE(settings->property("value").toString(), QStringLiteral("initial"));
 }
 
+void tst_QQmlSettings::writeDelay()
+{
+    QQmlEngine engine;
+    QQmlComponent component(&engine);
+    component.setData("import Qt.labs.settings 1.0; Settings { writeDelay: 60000; property int value: 1 }", QUrl());
+    QScopedPointer<QObject> settings(component.create());
+    QVERIFY(settings.data());
+    QCOMPARE(settings->property("writeDelay").toInt(), 60000);
+
+    // the initial value is written once flushed
+    QSettings qs;
+    QVERIFY(!qs.contains("value"));
+    QVERIFY(QMetaObject::invokeMethod(settings.data(), "flush"));
+    QCOMPARE(qs.value("value").toInt(), 1);
+
+    // changes are collected until the delay has passed
+    settings->setProperty("value", 2);
+    settings->setProperty("value", 3);
+    QCoreApplication::processEvents();
+    QCOMPARE(qs.value("value").toInt(), 1);
+    QVERIFY(QMetaObject::invokeMethod(settings.data(), "flush"));
+    QCOMPARE(qs.value("value").toInt(), 3);
+
+    // a shorter delay writes the pending changes sooner
+    settings->setProperty("value", 4);
+    settings->setProperty("writeDelay", 0);
+    QTRY_COMPARE(qs.value("value").toInt(), 4);
+
+    // pending changes are written on destruction
+    settings->setProperty("writeDelay", 60000);
+    settings->setProperty("value", 5);
+    settings.reset();
+    QCOMPARE(qs.value("value").toInt(), 5);
+}
+
 QTEST_MAIN(tst_QQmlSettings)
 
 #include "tst_qqmlsettings.moc"
@@ -0,0 +1,41 @@
+.import QtQuick.LocalStorage 2.0 as Sql
+
+function test(item) {
+    var db = Sql.LocalStorage.openDatabase("QmlTestDB-async-error", "", "Test database from Qt autotests", 1000000);
+
+    db.transaction(
+        function(tx) {
+            tx.executeSql('CREATE TABLE IF NOT EXISTS Numbers(n INTEGER)');
+        },
+        function(error) {
+            item.text = "CREATE FAILED " + error.message;
+        },
+        function() {
+            db.transaction(
+                function(tx) {
+                    tx.executeSql('INSERT INTO Numbers VALUES(1)');
+                    // Returning false from the error callback lets the transaction continue.
+                    tx.executeSql('SELECT * FROM NotExists', [], null,
+                        function(tx, error) { return false; });
+                    tx.executeSql('INSERT INTO Numbers VALUES(2)');
+                    tx.executeSql('SELECT * FROM NotExists');
+                    tx.executeSql('INSERT INTO Numbers VALUES(3)');
+                },
+                function(error) {
+                    if (error.code != SQLException.DATABASE_ERR) {
+                        item.text = "WRONG ERROR CODE " + error.code;
+                        return;
+                    }
+                    db.readTransaction(function(tx) {
+                        tx.executeSql('SELECT * FROM Numbers', [], function(tx, rs) {
+                            item.text = (rs.rows.length == 0) ? "passed" : "NOT ROLLED BACK " + rs.rows.length;
+                        });
+                    });
+                },
+                function() {
+                    item.text = "SHOULD NOT SUCCEED";
+                }
+            );
+        }
+    );
+}
@@ -0,0 +1,50 @@
+.import QtQuick.LocalStorage 2.0 as Sql
+
+function test(item) {
+    var db = Sql.LocalStorage.openDatabase("QmlTestDB-async", "", "Test database from Qt autotests", 1000000);
+    var r = "";
+
+    db.transaction(
+        function(tx) {
+            tx.executeSql('CREATE TABLE IF NOT EXISTS Greeting(salutation TEXT, salutee TEXT)');
+            tx.executeSql('INSERT INTO Greeting VALUES(?, ?)', [ 'hello', 'world' ],
+                function(tx, rs) {
+                    // Statements can be queued from statement callbacks too.
+                    tx.executeSql('INSERT INTO Greeting VALUES(?, ?)', [ 'hello', 'again' ]);
+                });
+            r += "a";
+        },
+        function(error) {
+            item.text = "FIRST TRANSACTION FAILED " + error.message;
+        },
+        function() {
+            r += "b";
+        }
+    );
+
+    db.readTransaction(
+        function(tx) {
+            tx.executeSql('SELECT * FROM Greeting', [],
+                function(tx, rs) {
+                    if (rs.rows.length != 2)
+                        r = "SELECT RETURNED WRONG VALUE " + rs.rows.length;
+                    else if (rs.rows.item(1).salutee != "again" || rs.rows[0].salutee != "world")
+                        r = "SELECT RETURNED WRONG ROWS";
+                    else
+                        r += "c";
+                });
+        },
+        function(error) {
+            item.text = "SECOND TRANSACTION FAILED " + error.message;
+        },
+        function() {
+            if (ranSynchronously)
+                item.text = "RAN SYNCHRONOUSLY";
+            else
+                item.text = (r == "abc") ? "passed" : "WRONG ORDER " + r;
+        }
+    );
+
+    // Transactions only start once control returns to the event loop.
+    var ranSynchronously = (r != "");
+}
@@ -0,0 +1,30 @@
+.import QtQuick.LocalStorage 2.0 as Sql
+
+function test() {
+    var db = Sql.LocalStorage.openDatabaseSync("QmlTestDB-statementcache", "", "Test database from Qt autotests", 1000000);
+    var r="transaction_not_finished";
+
+    db.transaction(
+        function(tx) {
+            tx.executeSql('CREATE TABLE IF NOT EXISTS Pairs(a INTEGER, b INTEGER)');
+            for (var i = 0; i < 100; ++i)
+                tx.executeSql('INSERT INTO Pairs VALUES(?, ?)', [ i, i * 2 ]);
+
+            // Values bound by a previous execution of the same statement must not be reused.
+            tx.executeSql('INSERT INTO Pairs VALUES(?, ?)', [ 100 ]);
+
+            var rs = tx.executeSql('SELECT * FROM Pairs WHERE a = ?', [ 50 ]);
+            var rs2 = tx.executeSql('SELECT * FROM Pairs WHERE a = ?', [ 51 ]);
+            if (rs.rows.length != 1 || rs.rows.item(0).b != 100)
+                r = "FIRST SELECT RETURNED WRONG VALUE";
+            else if (rs2.rows.length != 1 || rs2.rows.item(0).b != 102)
+                r = "SECOND SELECT RETURNED WRONG VALUE";
+            else if (tx.executeSql('SELECT * FROM Pairs WHERE a = ?', [ 100 ]).rows.item(0).b != null)
+                r = "STALE VALUE BOUND";
+            else
+                r = "passed";
+        }
+    );
+
+    return r;
+}
@@ -81,6 +81,8 @@ private slots:
     void testQml();
     void testQml_cleanopen_data();
     void testQml_cleanopen();
+    void testQmlAsync_data();
+    void testQmlAsync();
     void totalDatabases();
 
     void cleanupTestCase();
@@ -135,7 +137,7 @@ void tst_qqmlsqldatabase::checkDatabasePath()
     QVERIFY(engine->offlineStoragePath().contains("OfflineStorage"));
 }
 
-static const int total_databases_created_by_tests = 12;
+static const int total_databases_created_by_tests = 15;
 void tst_qqmlsqldatabase::testQml_data()
 {
     QTest::addColumn<QString>("jsfile"); // The input file
@@ -157,6 +159,7 @@ void tst_qqmlsqldatabase::testQml_data()
     QTest::newRow("error-outsidetransaction") << "error-outsidetransaction.js"; // reuse above
     QTest::newRow("reopen1") << "reopen1.js";
     QTest::newRow("reopen2") << "reopen2.js"; // re-uses above DB
+    QTest::newRow("statementcache") << "statementcache.js";
 
     // If you add a test, you should usually use a new database in the
     // test - in which case increment total_databases_created_by_tests above.
@@ -246,6 +249,38 @@ void tst_qqmlsqldatabase::testQml_cleanopen()
     }
 }
 
+void tst_qqmlsqldatabase::testQmlAsync_data()
+{
+    QTest::addColumn<QString>("jsfile"); // The input file
+
+    // Each test should use a newly named DB to avoid inter-test dependencies
+    QTest::newRow("async") << "async.js";
+    QTest::newRow("async-error") << "async-error.js";
+}
+
+void tst_qqmlsqldatabase::testQmlAsync()
+{
+    if (engine->offlineStoragePath().isEmpty())
+        QSKIP("offlineStoragePath is empty, skip this test.");
+
+    // Same as testQml, but the result is only available once the
+    // transactions have finished.
+    QFETCH(QString, jsfile);
+
+    QString qml=
+        "import QtQuick 2.0\n"
+        "import \""+jsfile+"\" as JS\n"
+        "Text { id: text; Component.onCompleted: JS.test(text) }";
+
+    engine->setOfflineStoragePath(dbDir());
+    QQmlComponent component(engine);
+    component.setData(qml.toUtf8(), testFileUrl("empty.qml")); // just a file for relative local imports
+    QVERIFY(!component.isError());
+    QScopedPointer<QQuickText> text(qobject_cast<QQuickText*>(component.create()));
+    QVERIFY(text != 0);
+    QTRY_COMPARE(text->text(),QString("passed"));
+}
+
 void tst_qqmlsqldatabase::totalDatabases()
 {
     if (engine->offlineStoragePath().isEmpty())
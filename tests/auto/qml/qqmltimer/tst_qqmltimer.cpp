@@ -77,6 +77,7 @@ private slots:
     void restartFromTriggered();
     void runningFromTriggered();
     void parentProperty();
+    void multipleTimers();
 };
 
 class TimerHelper : public QObject
@@ -404,6 +405,51 @@ void tst_qqmltimer::parentProperty()
     delete timer;
 }
 
+void tst_qqmltimer::multipleTimers()
+{
+    QQmlEngine engine;
+    QQmlComponent component(&engine);
+    component.setData(QByteArray("import QtQml 2.0\nTimer { running: true }"), QUrl::fromLocalFile(""));
+
+    const int intervals[] = { 300, 100, 150, 100 };
+    QList<QQmlTimer *> timers;
+    QList<TimerHelper *> helpers;
+    for (int i = 0; i < 4; ++i) {
+        QQmlTimer *timer = qobject_cast<QQmlTimer*>(component.create());
+        QVERIFY(timer != 0);
+        timer->setInterval(intervals[i]);
+        TimerHelper *helper = new TimerHelper;
+        connect(timer, SIGNAL(triggered()), helper, SLOT(timeout()));
+        timers << timer;
+        helpers << helper;
+    }
+
+    // Deleting a running timer must not leave it waiting to be triggered
+    QQmlTimer *deleted = qobject_cast<QQmlTimer*>(component.create());
+    QVERIFY(deleted != 0);
+    deleted->setInterval(50);
+    delete deleted;
+
+    timers.at(3)->stop();
+
+    consistentWait(200);
+    QCOMPARE(helpers.at(0)->count, 0);
+    QCOMPARE(helpers.at(1)->count, 1);
+    QCOMPARE(helpers.at(2)->count, 1);
+    QCOMPARE(helpers.at(3)->count, 0);
+
+    consistentWait(200);
+    QCOMPARE(helpers.at(0)->count, 1);
+    QCOMPARE(helpers.at(1)->count, 1);
+    QCOMPARE(helpers.at(2)->count, 1);
+    QCOMPARE(helpers.at(3)->count, 0);
+    for (int i = 0; i < 4; ++i)
+        QVERIFY(!timers.at(i)->isRunning());
+
+    qDeleteAll(timers);
+    qDeleteAll(helpers);
+}
+
 QTEST_MAIN(tst_qqmltimer)
 
 #include "tst_qqmltimer.moc"
@@ -41,8 +41,10 @@
 
 #include <QtTest/QtTest>
 #include <QtQml/qqmlengine.h>
+#include <QtQml/qqmlcomponent.h>
 #include <QtQuick/qquickview.h>
 #include <QtQuick/qquickitem.h>
+#include <private/qv4compileddata_p.h>
 #include "../../shared/util.h"
 
 class tst_QQMLTypeLoader : public QQmlDataTest
@@ -50,9 +52,20 @@ class tst_QQMLTypeLoader : public QQmlDataTest
     Q_OBJECT
 
 private slots:
+    void initTestCase();
     void testLoadComplete();
+    void scriptDiskCache();
+    void scriptUnitSharing();
+    void prefetchedCompositeTypes();
 };
 
+void tst_QQMLTypeLoader::initTestCase()
+{
+    QQmlDataTest::initTestCase();
+    // Engines that use the JIT only write the disk cache when asked to.
+    qputenv("QML_FORCE_DISK_CACHE", "1");
+}
+
 void tst_QQMLTypeLoader::testLoadComplete()
 {
     QQuickView *window = new QQuickView();
@@ -70,6 +83,133 @@ void tst_QQMLTypeLoader::testLoadComplete()
     delete window;
 }
 
+static bool writeFile(const QString &fileName, const QByteArray &contents)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    return file.write(contents) == contents.size();
+}
+
+void tst_QQMLTypeLoader::scriptDiskCache()
+{
+    QTemporaryDir sourceDir;
+    QTemporaryDir cacheDir;
+    QVERIFY(sourceDir.isValid());
+    QVERIFY(cacheDir.isValid());
+    qputenv("QML_DISK_CACHE_PATH", cacheDir.path().toLocal8Bit());
+
+    QVERIFY(writeFile(sourceDir.path() + QLatin1String("/script.js"),
+                      "function value() { return 42; }"));
+    const QString mainFile = sourceDir.path() + QLatin1String("/main.qml");
+    QVERIFY(writeFile(mainFile,
+                      "import QtQml 2.0\n"
+                      "import \"script.js\" as Script\n"
+                      "QtObject { property int value: Script.value() }"));
+
+    // The first engine writes the cache file, the second one must load it and get the same result.
+    for (int i = 0; i < 2; ++i) {
+        QQmlEngine engine;
+        QQmlComponent component(&engine, QUrl::fromLocalFile(mainFile));
+        QScopedPointer<QObject> object(component.create());
+        QVERIFY2(object, qPrintable(component.errorString()));
+        QCOMPARE(object->property("value").toInt(), 42);
+
+        QCOMPARE(QDir(cacheDir.path()).entryList(QStringList() << QLatin1String("*.qv4c"), QDir::Files).count(), 1);
+    }
+
+    qunsetenv("QML_DISK_CACHE_PATH");
+}
+
+void tst_QQMLTypeLoader::scriptUnitSharing()
+{
+    QTemporaryDir sourceDir;
+    QVERIFY(sourceDir.isValid());
+
+    const QString scriptFile = sourceDir.path() + QLatin1String("/script.js");
+    QVERIFY(writeFile(scriptFile, "function value() { return 42; }"));
+    const QString mainFile = sourceDir.path() + QLatin1String("/main.qml");
+    QVERIFY(writeFile(mainFile,
+                      "import QtQml 2.0\n"
+                      "import \"script.js\" as Script\n"
+                      "QtObject { property int value: Script.value() }"));
+
+    {
+        QQmlEngine first;
+        QQmlComponent firstComponent(&first, QUrl::fromLocalFile(mainFile));
+        QScopedPointer<QObject> firstObject(firstComponent.create());
+        QVERIFY2(firstObject, qPrintable(firstComponent.errorString()));
+        QCOMPARE(firstObject->property("value").toInt(), 42);
+
+        QV4::CompiledData::CompilationUnit *shared = QV4::CompiledData::CompilationUnit::createShared(scriptFile);
+        if (!shared)
+            QSKIP("The engine's backend does not share compiled scripts");
+        shared->ref();
+        shared->deref();
+
+        // The second engine links the unit compiled by the first one
+        QQmlEngine second;
+        QQmlComponent secondComponent(&second, QUrl::fromLocalFile(mainFile));
+        QScopedPointer<QObject> secondObject(secondComponent.create());
+        QVERIFY2(secondObject, qPrintable(secondComponent.errorString()));
+        QCOMPARE(secondObject->property("value").toInt(), 42);
+
+        // A modified file is compiled again
+        QTest::qWait(1000);
+        QVERIFY(writeFile(scriptFile, "function value() { return 4242; }"));
+        QVERIFY(!QV4::CompiledData::CompilationUnit::createShared(scriptFile));
+        QQmlEngine third;
+        QQmlComponent thirdComponent(&third, QUrl::fromLocalFile(mainFile));
+        QScopedPointer<QObject> thirdObject(thirdComponent.create());
+        QVERIFY2(thirdObject, qPrintable(thirdComponent.errorString()));
+        QCOMPARE(thirdObject->property("value").toInt(), 4242);
+        QCOMPARE(secondObject->property("value").toInt(), 42);
+    }
+
+    // The shared unit goes away with the last engine using it
+    QVERIFY(!QV4::CompiledData::CompilationUnit::createShared(scriptFile));
+}
+
+void tst_QQMLTypeLoader::prefetchedCompositeTypes()
+{
+    QTemporaryDir sourceDir;
+    QVERIFY(sourceDir.isValid());
+
+    const QStringList typeNames = QStringList() << QLatin1String("First") << QLatin1String("Second")
+                                                << QLatin1String("Third") << QLatin1String("Fourth");
+    QByteArray mainSource = "import QtQml 2.0\nQtObject {\n";
+    for (int i = 0; i < typeNames.count(); ++i) {
+        QVERIFY(writeFile(sourceDir.path() + QLatin1Char('/') + typeNames.at(i) + QLatin1String(".qml"),
+                          "import QtQml 2.0\nQtObject { property int value: " + QByteArray::number(i + 1) + " }"));
+        mainSource += "    property QtObject " + typeNames.at(i).toLower().toUtf8() + ": " + typeNames.at(i).toUtf8() + " {}\n";
+    }
+    mainSource += "}";
+    const QString mainFile = sourceDir.path() + QLatin1String("/main.qml");
+    QVERIFY(writeFile(mainFile, mainSource));
+
+    {
+        QQmlEngine engine;
+        QQmlComponent component(&engine, QUrl::fromLocalFile(mainFile));
+        QScopedPointer<QObject> object(component.create());
+        QVERIFY2(object, qPrintable(component.errorString()));
+        for (int i = 0; i < typeNames.count(); ++i) {
+            QObject *child = object->property(typeNames.at(i).toLower().toUtf8()).value<QObject*>();
+            QVERIFY(child);
+            QCOMPARE(child->property("value").toInt(), i + 1);
+        }
+    }
+
+    // Errors in a document parsed ahead of time must still be reported against that document.
+    const QString brokenFile = sourceDir.path() + QLatin1String("/Third.qml");
+    QVERIFY(writeFile(brokenFile, "import QtQml 2.0\nQtObject { property int value: }"));
+    {
+        QQmlEngine engine;
+        QQmlComponent component(&engine, QUrl::fromLocalFile(mainFile));
+        QVERIFY(component.isError());
+        QVERIFY(component.errorString().contains(QUrl::fromLocalFile(brokenFile).toString()));
+    }
+}
+
 QTEST_MAIN(tst_QQMLTypeLoader)
 
 #include "tst_qqmltypeloader.moc"
@@ -0,0 +1,14 @@
+import Test 1.0
+
+MyTypeObject {
+    onRunScript: {
+        rect.x = 14;
+        rect.width = "31";
+        rectf.x = 2.5;
+        rectf.height = "7.5";
+        sizef.width = 12;
+        font.bold = true;
+        font.pixelSize = 19;
+        font.capitalization = "AllUppercase";
+    }
+}
@@ -97,6 +97,7 @@ private slots:
     void initializeByWrite();
     void groupedInterceptors();
     void groupedInterceptors_data();
+    void scriptWrite();
 
 private:
     QQmlEngine engine;
@@ -1451,6 +1452,26 @@ void tst_qqmlvaluetypes::groupedInterceptors()
     delete object;
 }
 
+// Script writes take a typed fast path for matching value kinds and must
+// still convert everything else as before
+void tst_qqmlvaluetypes::scriptWrite()
+{
+    QQmlComponent component(&engine, testFileUrl("scriptWrite.qml"));
+    MyTypeObject *object = qobject_cast<MyTypeObject *>(component.create());
+    QVERIFY(object != 0);
+
+    object->emitRunScript();
+
+    QCOMPARE(object->rect(), QRect(14, 3, 31, 102));
+    QCOMPARE(object->rectf(), QRectF(2.5, 99.2, 88.1, 7.5));
+    QCOMPARE(object->sizef(), QSizeF(12, 100923.2));
+    QCOMPARE(object->font().bold(), true);
+    QCOMPARE(object->font().pixelSize(), 19);
+    QCOMPARE(object->font().capitalization(), QFont::AllUppercase);
+
+    delete object;
+}
+
 QTEST_MAIN(tst_qqmlvaluetypes)
 
 #include "tst_qqmlvaluetypes.moc"
@@ -0,0 +1,74 @@
+import QtQuick 2.0
+
+QtObject {
+    property bool xmlTest: false
+    property bool dataOK: false
+
+    function checkXML(document)
+    {
+        var items = document.getElementsByTagName("item");
+        if (items.length != 4)
+            return;
+
+        var names = [ "header", "first", "second", "third" ];
+        for (var ii = 0; ii < names.length; ++ii) {
+            if (items[ii].tagName != "item")
+                return;
+            if (items[ii].attributes["name"].value != names[ii])
+                return;
+        }
+
+        // The elements found are part of the tree
+        if (items[2].parentNode.tagName != "group")
+            return;
+        if (items[2].parentNode.parentNode.tagName != "menu")
+            return;
+        if (items[1].nextSibling.nextSibling.firstChild.attributes["name"].value != "second")
+            return;
+        if (items[1].firstChild.data != "apple")
+            return;
+        if (items[3].firstChild.data != "<pear>")
+            return;
+
+        var envelope = document.getElementsByTagName("Envelope");
+        if (envelope.length != 1 || envelope[0].tagName != document.documentElement.tagName)
+            return;
+
+        // An element only searches below itself
+        var body = document.documentElement.childNodes[3];
+        if (body.tagName != "Body")
+            return;
+        if (body.getElementsByTagName("Body").length != 0)
+            return;
+        if (body.getElementsByTagName("item").length != 3)
+            return;
+        if (body.getElementsByTagName("*").length != 5)
+            return;
+        if (document.getElementsByTagName("*").length != 9)
+            return;
+        if (document.getElementsByTagName("missing").length != 0)
+            return;
+
+        xmlTest = true;
+    }
+
+    Component.onCompleted: {
+        var x = new XMLHttpRequest;
+
+        x.open("GET", "getElementsByTagName.xml");
+
+        // Test to the end
+        x.onreadystatechange = function() {
+            if (x.readyState == XMLHttpRequest.DONE) {
+
+                dataOK = true;
+
+                if (x.responseXML != null)
+                    checkXML(x.responseXML);
+
+            }
+        }
+
+        x.send()
+    }
+}
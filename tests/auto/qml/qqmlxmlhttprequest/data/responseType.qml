@@ -0,0 +1,66 @@
+import QtQuick 2.0
+
+QtObject {
+    property string url
+    property string responseType
+
+    property bool defaultType: false
+    property bool typeSet: false
+    property bool unsupportedIgnored: false
+    property bool loadingNull: false
+    property bool responseTextThrows: false
+    property bool setDuringLoadingThrows: false
+    property bool sameObject: false
+
+    property int byteLength: -1
+    property string jsonName
+    property int jsonValueCount: -1
+
+    property bool dataOK: false
+
+    Component.onCompleted: {
+        var x = new XMLHttpRequest;
+
+        defaultType = (x.responseType == "");
+
+        x.open("GET", url);
+        x.setRequestHeader("Accept-Language", "en-US");
+
+        x.responseType = responseType;
+        typeSet = (x.responseType == responseType);
+
+        x.responseType = "document";
+        unsupportedIgnored = (x.responseType == responseType);
+
+        x.onreadystatechange = function() {
+            if (x.readyState == XMLHttpRequest.LOADING) {
+                loadingNull = (x.response === null);
+                try {
+                    x.responseType = "text";
+                } catch (e) {
+                    setDuringLoadingThrows = (e.code == DOMException.INVALID_STATE_ERR);
+                }
+            } else if (x.readyState == XMLHttpRequest.DONE) {
+                try {
+                    var text = x.responseText;
+                } catch (e) {
+                    responseTextThrows = (e.code == DOMException.INVALID_STATE_ERR);
+                }
+
+                var response = x.response;
+                sameObject = (response === x.response);
+
+                if (responseType == "arraybuffer") {
+                    byteLength = response.byteLength;
+                } else if (responseType == "json") {
+                    jsonName = response.name;
+                    jsonValueCount = response.values.length;
+                }
+
+                dataOK = true;
+            }
+        }
+
+        x.send()
+    }
+}
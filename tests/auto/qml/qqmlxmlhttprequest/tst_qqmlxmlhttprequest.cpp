@@ -98,6 +98,8 @@ private slots:
     void statusText_data();
     void responseText();
     void responseText_data();
+    void responseType();
+    void responseType_data();
     void responseXML_invalid();
     void invalidMethodUsage();
     void redirects();
@@ -110,6 +112,7 @@ private slots:
     void attr();
     void text();
     void cdata();
+    void getElementsByTagName();
 
     // Crashes
     // void outstanding_request_at_shutdown();
@@ -869,6 +872,51 @@ void tst_qqmlxmlhttprequest::responseText_data()
     QTest::newRow("Bad Request") << testFileUrl("status.400.reply") << testFileUrl("testdocument.html") << "QML Rocks!\n";
 }
 
+void tst_qqmlxmlhttprequest::responseType()
+{
+    QFETCH(QString, responseType);
+    QFETCH(QUrl, bodyUrl);
+
+    TestHTTPServer server(SERVER_PORT);
+    QVERIFY(server.isValid());
+    QVERIFY(server.wait(testFileUrl("status.expect"),
+                        testFileUrl("status.200.reply"),
+                        bodyUrl));
+
+    QQmlComponent component(&engine, testFileUrl("responseType.qml"));
+    QScopedPointer<QObject> object(component.beginCreate(engine.rootContext()));
+    QVERIFY(!object.isNull());
+    object->setProperty("url", "http://127.0.0.1:14445/testdocument.html");
+    object->setProperty("responseType", responseType);
+    component.completeCreate();
+
+    QTRY_VERIFY(object->property("dataOK").toBool() == true);
+
+    QCOMPARE(object->property("defaultType").toBool(), true);
+    QCOMPARE(object->property("typeSet").toBool(), true);
+    QCOMPARE(object->property("unsupportedIgnored").toBool(), true);
+    QCOMPARE(object->property("loadingNull").toBool(), true);
+    QCOMPARE(object->property("setDuringLoadingThrows").toBool(), true);
+    QCOMPARE(object->property("responseTextThrows").toBool(), true);
+    QCOMPARE(object->property("sameObject").toBool(), true);
+
+    if (responseType == QLatin1String("arraybuffer")) {
+        QCOMPARE(object->property("byteLength").toInt(), 11);
+    } else {
+        QCOMPARE(object->property("jsonName").toString(), QString("QML"));
+        QCOMPARE(object->property("jsonValueCount").toInt(), 3);
+    }
+}
+
+void tst_qqmlxmlhttprequest::responseType_data()
+{
+    QTest::addColumn<QString>("responseType");
+    QTest::addColumn<QUrl>("bodyUrl");
+
+    QTest::newRow("arraybuffer") << "arraybuffer" << testFileUrl("testdocument.html");
+    QTest::newRow("json") << "json" << testFileUrl("testdocument.json");
+}
+
 void tst_qqmlxmlhttprequest::nonUtf8()
 {
     QFETCH(QString, fileName);
@@ -1061,6 +1109,17 @@ void tst_qqmlxmlhttprequest::cdata()
     QCOMPARE(object->property("xmlTest").toBool(), true);
 }
 
+void tst_qqmlxmlhttprequest::getElementsByTagName()
+{
+    QQmlComponent component(&engine, testFileUrl("getElementsByTagName.qml"));
+    QScopedPointer<QObject> object(component.create());
+    QVERIFY(!object.isNull());
+
+    QTRY_VERIFY(object->property("dataOK").toBool() == true);
+
+    QCOMPARE(object->property("xmlTest").toBool(), true);
+}
+
 void tst_qqmlxmlhttprequest::stateChangeCallingContext()
 {
 #ifdef Q_OS_WIN
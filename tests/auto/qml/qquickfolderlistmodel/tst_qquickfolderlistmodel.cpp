@@ -44,6 +44,7 @@
 #include <QtQml/qqmlcomponent.h>
 #include <QtCore/qdir.h>
 #include <QtCore/qfile.h>
+#include <QtCore/qtemporarydir.h>
 #include <QtCore/qabstractitemmodel.h>
 #include <QDebug>
 #include "../../shared/util.h"
@@ -82,6 +83,7 @@ private slots:
     void showDotAndDotDot();
     void showDotAndDotDot_data();
     void sortReversed();
+    void incrementalUpdate();
 
 private:
     void checkNoErrors(const QQmlComponent& component);
@@ -341,6 +343,53 @@ void tst_qquickfolderlistmodel::sortReversed()
     QCOMPARE(flm->data(flm->index(0),FileNameRole).toString(), QLatin1String("sortReversed.qml"));
 }
 
+void tst_qquickfolderlistmodel::incrementalUpdate()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QDir dir(tempDir.path());
+    foreach (const QString &name, QStringList() << "a.qml" << "c.qml" << "e.qml") {
+        QFile file(dir.filePath(name));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+    }
+
+    QQmlComponent component(&engine, testFileUrl("basic.qml"));
+    checkNoErrors(component);
+    QAbstractListModel *flm = qobject_cast<QAbstractListModel*>(component.create());
+    QVERIFY(flm != 0);
+
+    flm->setProperty("folder", QUrl::fromLocalFile(tempDir.path()));
+    QTRY_COMPARE(flm->property("count").toInt(), 3);
+
+    QSignalSpy insertedSpy(flm, SIGNAL(rowsInserted(QModelIndex,int,int)));
+    QSignalSpy removedSpy(flm, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+    QSignalSpy resetSpy(flm, SIGNAL(modelReset()));
+
+    // Only the new row is inserted, the others are left alone.
+    {
+        QFile file(dir.filePath("d.qml"));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+    }
+    QTRY_COMPARE(flm->property("count").toInt(), 4);
+    QCOMPARE(insertedSpy.count(), 1);
+    QCOMPARE(insertedSpy.at(0).at(1).toInt(), 2);
+    QCOMPARE(insertedSpy.at(0).at(2).toInt(), 2);
+    QCOMPARE(removedSpy.count(), 0);
+    QCOMPARE(flm->data(flm->index(2), FileNameRole).toString(), QLatin1String("d.qml"));
+
+    insertedSpy.clear();
+    QVERIFY(dir.remove("a.qml"));
+    QTRY_COMPARE(flm->property("count").toInt(), 3);
+    QCOMPARE(removedSpy.count(), 1);
+    QCOMPARE(removedSpy.at(0).at(1).toInt(), 0);
+    QCOMPARE(removedSpy.at(0).at(2).toInt(), 0);
+    QCOMPARE(insertedSpy.count(), 0);
+    QCOMPARE(resetSpy.count(), 0);
+    QCOMPARE(flm->data(flm->index(0), FileNameRole).toString(), QLatin1String("c.qml"));
+
+    delete flm;
+}
+
 QTEST_MAIN(tst_qquickfolderlistmodel)
 
 #include "tst_qquickfolderlistmodel.moc"
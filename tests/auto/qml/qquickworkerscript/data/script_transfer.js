@@ -0,0 +1,9 @@
+WorkerScript.onMessage = function(msg) {
+    var sum = 0
+    for (var i = 0; i < msg.view.length; ++i)
+        sum += msg.view[i]
+
+    var result = new Uint16Array(4)
+    result[0] = sum
+    WorkerScript.sendMessage({ sameBuffer: msg.view.buffer === msg.buffer, result: result }, [result])
+}
@@ -0,0 +1,37 @@
+import QtQuick 2.0
+
+WorkerScript {
+    id: worker
+    source: "script_transfer.js"
+
+    property int sentLength: -1
+    property bool rejectedInvalidTransfer: false
+    property bool sameBuffer: false
+    property int sum: -1
+    property int resultLength: -1
+
+    signal done()
+
+    function testTransfer() {
+        var buffer = new ArrayBuffer(16)
+        var view = new Uint8Array(buffer, 4, 8)
+        for (var i = 0; i < view.length; ++i)
+            view[i] = i + 1
+
+        try {
+            worker.sendMessage(buffer, [{}])
+        } catch (e) {
+            rejectedInvalidTransfer = e instanceof TypeError
+        }
+
+        worker.sendMessage({ buffer: buffer, view: view }, [buffer])
+        sentLength = buffer.byteLength + view.length + view.byteLength
+    }
+
+    onMessage: {
+        sameBuffer = messageObject.sameBuffer
+        sum = messageObject.result[0]
+        resultLength = messageObject.result.length
+        worker.done()
+    }
+}
@@ -64,6 +64,7 @@ private slots:
     void messaging_sendQObjectList();
     void messaging_sendJsObject();
     void messaging_sendExternalObject();
+    void messaging_transfer();
     void script_with_pragma();
     void script_included();
     void scriptError_onLoad();
@@ -208,6 +209,26 @@ void tst_QQuickWorkerScript::messaging_sendExternalObject()
     delete obj;
 }
 
+void tst_QQuickWorkerScript::messaging_transfer()
+{
+    QQmlComponent component(&m_engine, testFileUrl("worker_transfer.qml"));
+    QQuickWorkerScript *worker = qobject_cast<QQuickWorkerScript*>(component.create());
+    QVERIFY(worker != 0);
+
+    QVERIFY(QMetaObject::invokeMethod(worker, "testTransfer"));
+    QVERIFY(worker->property("rejectedInvalidTransfer").toBool());
+    // The transferred buffer and its view are empty on the sending side
+    QCOMPARE(worker->property("sentLength").toInt(), 0);
+
+    waitForEchoMessage(worker);
+    QVERIFY(worker->property("sameBuffer").toBool());
+    QCOMPARE(worker->property("sum").toInt(), 36);
+    QCOMPARE(worker->property("resultLength").toInt(), 4);
+
+    qApp->processEvents();
+    delete worker;
+}
+
 void tst_QQuickWorkerScript::script_with_pragma()
 {
     QVariant value(100);
@@ -54,6 +54,7 @@ private Q_SLOTS:
     void testPoint2D();
     void testTexturedPoint2D();
     void testCustomGeometry();
+    void testPooledStorage();
 
 private:
 };
@@ -175,6 +176,48 @@ void GeometryTest::testCustomGeometry()
 
 }
 
+void GeometryTest::testPooledStorage()
+{
+    // A nine-patch grid, small enough to come from the block pool
+    QSGGeometry *first = new QSGGeometry(QSGGeometry::defaultAttributes_TexturedPoint2D(), 16, 28);
+    QSGGeometry *second = new QSGGeometry(QSGGeometry::defaultAttributes_TexturedPoint2D(), 16, 28);
+
+    QSGGeometry::TexturedPoint2D *a = first->vertexDataAsTexturedPoint2D();
+    QSGGeometry::TexturedPoint2D *b = second->vertexDataAsTexturedPoint2D();
+    QVERIFY(a != b);
+
+    // Live geometries must not share storage
+    for (int i=0; i<16; ++i) {
+        a[i].set(i, i, i, i);
+        b[i].set(-i, -i, -i, -i);
+    }
+    quint16 *ia = first->indexDataAsUShort();
+    quint16 *ib = second->indexDataAsUShort();
+    for (int i=0; i<28; ++i) {
+        ia[i] = i;
+        ib[i] = 100 + i;
+    }
+    for (int i=0; i<16; ++i)
+        QCOMPARE(a[i].tx, (float) i);
+    for (int i=0; i<28; ++i)
+        QCOMPARE(ia[i], (quint16) i);
+
+    // Released storage is handed out again for the same size
+    void *released = second->vertexData();
+    delete second;
+    QSGGeometry *third = new QSGGeometry(QSGGeometry::defaultAttributes_TexturedPoint2D(), 16, 28);
+    QVERIFY(third->vertexData() == released);
+
+    // Growing beyond the pooled sizes still gives usable storage
+    first->allocate(1000, 3000);
+    quint16 *is = first->indexDataAsUShort();
+    for (int i=0; i<3000; ++i)
+        is[i] = i;
+    QCOMPARE(is[2999], (quint16) 2999);
+
+    delete first;
+    delete third;
+}
 
 QTEST_MAIN(GeometryTest);
 
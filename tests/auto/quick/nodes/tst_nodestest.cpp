@@ -50,6 +50,9 @@
 #include <QtQuick/private/qsgnodeupdater_p.h>
 #include <QtQuick/private/qsgrenderloop_p.h>
 #include <QtQuick/private/qsgcontext_p.h>
+#include <QtQuick/private/qsgdamagetracker_p.h>
+#include <QtQuick/private/qsggeometry_p.h>
+#include <QtQuick/private/qsgdefaultimagenode_p.h>
 
 #include <QtQuick/qsgsimplerectnode.h>
 
@@ -74,6 +77,11 @@ private Q_SLOTS:
 
     void isBlockedCheck();
 
+    void damageTracking();
+
+    void sharedGeometry();
+    void ninePatchGeometry();
+
 private:
     QOffscreenSurface *surface;
     QOpenGLContext *context;
@@ -259,6 +267,135 @@ void NodesTest::isBlockedCheck()
     QVERIFY(!updater.isNodeBlocked(node, &root));
 }
 
+void NodesTest::damageTracking()
+{
+    QSGRootNode root;
+    QSGTransformNode *transform = new QSGTransformNode();
+    QSGSimpleRectNode *rect = new QSGSimpleRectNode(QRectF(0, 0, 10, 10), Qt::red);
+    root.appendChildNode(transform);
+    transform->appendChildNode(rect);
+
+    QMatrix4x4 m;
+    m.translate(10, 20);
+    transform->setMatrix(m);
+
+    QSGDamageTracker tracker;
+    QRectF damage;
+    QVERIFY(tracker.update(&root, QSet<QSGNode *>(), &damage));
+    QCOMPARE(damage, QRectF(10, 20, 10, 10));
+
+    QVERIFY(tracker.update(&root, QSet<QSGNode *>(), &damage));
+    QVERIFY(damage.isEmpty());
+
+    // Both the old and the new position are damaged.
+    m.translate(20, 0);
+    transform->setMatrix(m);
+    QVERIFY(tracker.update(&root, QSet<QSGNode *>() << transform, &damage));
+    QCOMPARE(damage, QRectF(10, 20, 30, 10));
+
+    rect->setRect(0, 0, 5, 5);
+    QVERIFY(tracker.update(&root, QSet<QSGNode *>() << rect, &damage));
+    QCOMPARE(damage, QRectF(30, 20, 10, 10));
+
+    delete rect;
+    QVERIFY(tracker.update(&root, QSet<QSGNode *>(), &damage));
+    QCOMPARE(damage, QRectF(30, 20, 5, 5));
+
+    // Perspective transforms cannot be bounded.
+    transform->appendChildNode(new QSGSimpleRectNode(QRectF(0, 0, 10, 10), Qt::red));
+    QMatrix4x4 perspective;
+    perspective(3, 0) = 0.001f;
+    transform->setMatrix(perspective);
+    QVERIFY(!tracker.update(&root, QSet<QSGNode *>() << transform, &damage));
+}
+
+void NodesTest::sharedGeometry()
+{
+    QSGGeometry quad(QSGGeometry::defaultAttributes_TexturedPoint2D(), 4);
+    QSGGeometry::updateTexturedRectGeometry(&quad, QRectF(0, 0, 32, 32), QRectF(0, 0, 1, 1));
+
+    QSGGeometryNode *a = new QSGGeometryNode();
+    QSGGeometryNode *b = new QSGGeometryNode();
+    a->setFlag(QSGNode::OwnsGeometry);
+    b->setFlag(QSGNode::OwnsGeometry);
+    a->setGeometry(QSGSharedGeometry::share(&quad));
+    b->setGeometry(QSGSharedGeometry::share(&quad));
+
+    // Identical contents give the same object
+    QVERIFY(QSGSharedGeometry::isShared(a->geometry()));
+    QCOMPARE(a->geometry(), b->geometry());
+    QSGSharedGeometry *shared = static_cast<QSGSharedGeometry *>(a->geometry());
+    QCOMPARE(shared->refCount(), 2);
+
+    // Setting the same geometry again does not leak a reference
+    b->setGeometry(QSGSharedGeometry::share(&quad));
+    QCOMPARE(shared->refCount(), 2);
+
+    // Different contents give a different object
+    QSGGeometry other(QSGGeometry::defaultAttributes_TexturedPoint2D(), 4);
+    QSGGeometry::updateTexturedRectGeometry(&other, QRectF(0, 0, 64, 32), QRectF(0, 0, 1, 1));
+    QSGGeometryNode *c = new QSGGeometryNode();
+    c->setFlag(QSGNode::OwnsGeometry);
+    c->setGeometry(QSGSharedGeometry::share(&other));
+    QVERIFY(c->geometry() != a->geometry());
+
+    // Detaching a geometry used elsewhere gives the node a copy
+    QSGGeometry *copy = QSGSharedGeometry::detach(b);
+    QVERIFY(copy != shared);
+    QVERIFY(!QSGSharedGeometry::isShared(copy));
+    QCOMPARE(b->geometry(), copy);
+    QCOMPARE(shared->refCount(), 1);
+    QCOMPARE(memcmp(copy->vertexData(), quad.vertexData(), 4 * quad.sizeOfVertex()), 0);
+    copy->vertexDataAsTexturedPoint2D()[0].x = 100;
+    QCOMPARE(a->geometry()->vertexDataAsTexturedPoint2D()[0].x, 0.0f);
+
+    // The last reference is modified in place, and is no longer handed out
+    QCOMPARE(QSGSharedGeometry::detach(a), static_cast<QSGGeometry *>(shared));
+    QSGGeometryNode *d = new QSGGeometryNode();
+    d->setFlag(QSGNode::OwnsGeometry);
+    d->setGeometry(QSGSharedGeometry::share(&quad));
+    QVERIFY(d->geometry() != a->geometry());
+
+    delete a;
+    delete b;
+    delete c;
+    delete d;
+}
+
+class DummyTexture : public QSGTexture
+{
+public:
+    int textureId() const { return 0; }
+    QSize textureSize() const { return QSize(32, 32); }
+    bool hasAlphaChannel() const { return false; }
+    bool hasMipmaps() const { return false; }
+    void bind() { }
+};
+
+void NodesTest::ninePatchGeometry()
+{
+    DummyTexture texture;
+
+    QSGDefaultImageNode plain;
+    plain.setTexture(&texture);
+    plain.setTargetRect(QRectF(0, 0, 100, 40));
+    plain.setInnerTargetRect(QRectF(0, 0, 100, 40));
+    plain.update();
+
+    QSGDefaultImageNode ninePatch;
+    ninePatch.setTexture(&texture);
+    ninePatch.setTargetRect(QRectF(0, 0, 100, 40));
+    ninePatch.setInnerTargetRect(QRectF(8, 8, 84, 24));
+    ninePatch.setInnerSourceRect(QRectF(0.25, 0.25, 0.5, 0.5));
+    ninePatch.update();
+
+    // Nine-patches can be merged with plain images
+    QCOMPARE(ninePatch.geometry()->drawingMode(), plain.geometry()->drawingMode());
+    QCOMPARE(ninePatch.geometry()->attributes(), plain.geometry()->attributes());
+    QCOMPARE(ninePatch.geometry()->vertexCount(), 9 * 4);
+    QCOMPARE(ninePatch.geometry()->indexCount(), 9 * 6);
+}
+
 QTEST_MAIN(NodesTest);
 
 #include "tst_nodestest.moc"
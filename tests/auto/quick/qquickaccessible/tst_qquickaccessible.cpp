@@ -48,6 +48,7 @@
 #include <QtQuick/qquickview.h>
 #include <QtQuick/qquickitem.h>
 
+#include <QtQml/qqmlcomponent.h>
 #include <QtQml/qqmlengine.h>
 #include <QtQml/qqmlproperty.h>
 #include <QtQuick/private/qquickaccessibleattached_p.h>
@@ -104,6 +105,7 @@ private slots:
     void basicPropertiesTest();
     void hitTest();
     void checkableTest();
+    void childrenCache();
 };
 
 tst_QQuickAccessible::tst_QQuickAccessible()
@@ -409,6 +411,51 @@ void tst_QQuickAccessible::checkableTest()
     QVERIFY(checkBox2->state().checkable);
 }
 
+void tst_QQuickAccessible::childrenCache()
+{
+    QQuickView *window = new QQuickView();
+    window->setSource(testFileUrl("statictext.qml"));
+    window->show();
+
+    QQuickItem *contentItem = window->rootObject();
+    QVERIFY(contentItem);
+    QList<QQuickItem *> texts = contentItem->childItems();
+    QCOMPARE(texts.count(), 2);
+
+    QAccessibleInterface *item = QAccessible::queryAccessibleInterface(contentItem);
+    QVERIFY(item);
+    QCOMPARE(item->childCount(), 2);
+    QCOMPARE(item->child(0)->object(), texts.at(0));
+
+    // restacking reorders the cached children
+    texts.at(1)->stackBefore(texts.at(0));
+    QCOMPARE(item->childCount(), 2);
+    QCOMPARE(item->child(0)->object(), texts.at(1));
+    QCOMPARE(item->child(1)->object(), texts.at(0));
+
+    // a plain item is not listed until it becomes accessible
+    QQmlComponent component(window->engine());
+    component.setData("import QtQuick 2.0\nItem { }", QUrl());
+    QQuickItem *plain = qobject_cast<QQuickItem *>(component.create());
+    QVERIFY(plain);
+    plain->setParentItem(contentItem);
+    QCOMPARE(item->childCount(), 2);
+
+    QQmlComponent accessibleComponent(window->engine());
+    accessibleComponent.setData("import QtQuick 2.0\nItem { Item { Accessible.name: \"child\" } }", QUrl());
+    QQuickItem *accessible = qobject_cast<QQuickItem *>(accessibleComponent.create());
+    QVERIFY(accessible);
+    accessible->childItems().first()->setParentItem(plain);
+    QCOMPARE(item->childCount(), 3);
+    QCOMPARE(item->child(2)->object(), plain);
+
+    delete plain;
+    QCOMPARE(item->childCount(), 2);
+
+    delete accessible;
+    delete window;
+}
+
 QTEST_MAIN(tst_QQuickAccessible)
 
 #include "tst_qquickaccessible.moc"
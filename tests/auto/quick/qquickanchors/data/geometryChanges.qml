@@ -0,0 +1,20 @@
+import QtQuick 2.0
+
+Item {
+    width: 200; height: 200
+
+    Rectangle {
+        id: target; objectName: "target"
+        x: 10; y: 10
+        width: 50; height: 50
+    }
+
+    Rectangle {
+        objectName: "anchored"
+        anchors.left: target.left
+        anchors.right: target.right
+        anchors.top: target.top
+        anchors.bottom: target.bottom
+        anchors.margins: 5
+    }
+}
@@ -56,6 +56,14 @@ Q_DECLARE_METATYPE(QQuickAnchorLine::AnchorLine)
 
 using namespace QQuickVisualTestUtil;
 
+class GeometryChangeCounter : public QQuickItemChangeListener
+{
+public:
+    GeometryChangeCounter() : count(0) {}
+    void itemGeometryChanged(QQuickItem *, const QRectF &, const QRectF &) { ++count; }
+    int count;
+};
+
 class tst_qquickanchors : public QQmlDataTest
 {
     Q_OBJECT
@@ -87,6 +95,7 @@ private slots:
     void marginsRTL();
     void stretch();
     void baselineOffset();
+    void geometryChanges();
 };
 
 void tst_qquickanchors::basicAnchors()
@@ -815,6 +824,43 @@ void tst_qquickanchors::baselineOffset()
     QCOMPARE(anchoredItem->y(), 90.0);
 }
 
+void tst_qquickanchors::geometryChanges()
+{
+    QQmlEngine engine;
+    QQmlComponent component(&engine, testFileUrl("geometryChanges.qml"));
+    QScopedPointer<QObject> object(component.create());
+
+    QQuickItem *item = qobject_cast<QQuickItem *>(object.data());
+    QVERIFY(item);
+
+    QQuickItem *target = findItem<QQuickItem>(item, QLatin1String("target"));
+    QQuickItem *anchored = findItem<QQuickItem>(item, QLatin1String("anchored"));
+    QVERIFY(target);
+    QVERIFY(anchored);
+    QCOMPARE(anchored->position(), QPointF(15, 15));
+    QCOMPARE(anchored->width(), 40.0);
+    QCOMPARE(anchored->height(), 40.0);
+
+    GeometryChangeCounter counter;
+    QQuickItemPrivate::get(anchored)->addItemChangeListener(&counter, QQuickItemPrivate::Geometry);
+
+    // Moving and resizing the target in both directions at once must
+    // reach the anchored item as a single geometry change.
+    QQuickItemPrivate::get(target)->setGeometry(QRectF(20, 30, 100, 80),
+                                              QQuickItemPrivate::GeometryChange);
+    QCOMPARE(anchored->position(), QPointF(25, 35));
+    QCOMPARE(anchored->width(), 90.0);
+    QCOMPARE(anchored->height(), 70.0);
+    QCOMPARE(counter.count, 1);
+
+    // Only the horizontal edges move: x and width change together.
+    target->setWidth(60);
+    QCOMPARE(anchored->width(), 50.0);
+    QCOMPARE(counter.count, 2);
+
+    QQuickItemPrivate::get(anchored)->removeItemChangeListener(&counter, QQuickItemPrivate::Geometry);
+}
+
 QTEST_MAIN(tst_qquickanchors)
 
 #include "tst_qquickanchors.moc"
@@ -55,6 +55,7 @@ private slots:
     void test_properties();
     void test_runningChangedSignal();
     void test_frameChangedSignal();
+    void test_sharedSheet();
 };
 
 void tst_qquickanimatedsprite::initTestCase()
@@ -136,6 +137,31 @@ void tst_qquickanimatedsprite::test_frameChangedSignal()
     delete window;
 }
 
+void tst_qquickanimatedsprite::test_sharedSheet()
+{
+    QQuickView *window = new QQuickView(0);
+
+    window->setSource(testFileUrl("sharedSheet.qml"));
+    window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(window));
+
+    QVERIFY(window->rootObject());
+    QVERIFY(window->rootObject()->findChild<QQuickAnimatedSprite*>("sprite1"));
+    QVERIFY(window->rootObject()->findChild<QQuickAnimatedSprite*>("sprite2"));
+
+    // both sprites draw from the same sprite sheet
+    QImage black(160, 160, QImage::Format_RGB32);
+    black.fill(Qt::black);
+    QImage left;
+    QImage right;
+    QTRY_VERIFY(!(left = window->grabWindow().copy(0, 0, 160, 160).convertToFormat(QImage::Format_RGB32)).isNull()
+                && left != black);
+    right = window->grabWindow().copy(160, 0, 160, 160).convertToFormat(QImage::Format_RGB32);
+    QCOMPARE(left, right);
+
+    delete window;
+}
+
 QTEST_MAIN(tst_qquickanimatedsprite)
 
 #include "tst_qquickanimatedsprite.moc"
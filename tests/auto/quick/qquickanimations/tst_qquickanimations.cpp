@@ -72,6 +72,7 @@ private slots:
 
     void simpleProperty();
     void simpleNumber();
+    void numberIntermediateValues();
     void simpleColor();
     void simpleRotation();
     void simplePath();
@@ -172,6 +173,32 @@ void tst_qquickanimations::simpleNumber()
     QCOMPARE(rect.x(), qreal(100));
 }
 
+void tst_qquickanimations::numberIntermediateValues()
+{
+    QQuickRectangle rect;
+    rect.setOpacity(0);
+    QQuickNumberAnimation animation;
+    animation.setTargetObject(&rect);
+    animation.setProperties("x,opacity");
+    animation.setTo(1);
+    animation.start();
+    animation.pause();
+    animation.setCurrentTime(125);
+    QCOMPARE(rect.x(), qreal(0.5));
+    QCOMPARE(rect.opacity(), qreal(0.5));
+
+    animation.setFrom(0.25);
+    animation.start();
+    animation.pause();
+    animation.setCurrentTime(50);
+    QCOMPARE(rect.x(), qreal(0.4));
+    QCOMPARE(rect.opacity(), qreal(0.4));
+
+    animation.setCurrentTime(250);
+    QCOMPARE(rect.x(), qreal(1));
+    QCOMPARE(rect.opacity(), qreal(1));
+}
+
 void tst_qquickanimations::simpleColor()
 {
     QQuickRectangle rect;
@@ -4,3 +4,8 @@ CONFIG += testcase
 macx: CONFIG -= app_bundle
 SOURCES += tst_qquickanimators.cpp
 
+OTHER_FILES += \
+    data/windowWithAnimator.qml \
+    data/windowWithPathAnimator.qml \
+    data/windowWithColorAnimator.qml
+
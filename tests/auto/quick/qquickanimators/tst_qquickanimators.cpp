@@ -45,6 +45,7 @@
 #include <private/qquickanimator_p.h>
 
 #include <QtQml>
+#include <QtCore/qmath.h>
 
 class tst_Animators: public QObject
 {
@@ -53,6 +54,8 @@ class tst_Animators: public QObject
 private slots:
     void testMultiWinAnimator_data();
     void testMultiWinAnimator();
+    void testPathAnimator();
+    void testColorAnimator();
 };
 
 void tst_Animators::testMultiWinAnimator_data()
@@ -107,6 +110,36 @@ void tst_Animators::testMultiWinAnimator()
     QVERIFY(true);
 }
 
+void tst_Animators::testPathAnimator()
+{
+    QQmlEngine engine;
+    QQmlComponent component(&engine, "data/windowWithPathAnimator.qml");
+    QScopedPointer<QQuickWindow> window(qobject_cast<QQuickWindow *>(component.create()));
+    QVERIFY(window);
+
+    QTRY_VERIFY(window->property("animationDone").toBool());
+
+    // The end of the path and its direction are written back to the item.
+    QQuickItem *rect = window->contentItem()->childItems().first();
+    QCOMPARE(rect->x(), qreal(150));
+    QCOMPARE(rect->y(), qreal(100));
+    QVERIFY(qAbs(rect->rotation() - qRadiansToDegrees(qAtan2(100, 150))) < 0.5);
+}
+
+void tst_Animators::testColorAnimator()
+{
+    QQmlEngine engine;
+    QQmlComponent component(&engine, "data/windowWithColorAnimator.qml");
+    QScopedPointer<QQuickWindow> window(qobject_cast<QQuickWindow *>(component.create()));
+    QVERIFY(window);
+
+    QTRY_VERIFY(window->property("animationDone").toBool());
+    QVERIFY(QTest::qWaitForWindowExposed(window.data()));
+
+    QImage content = window->grabWindow();
+    QCOMPARE(content.pixel(100, 100), qRgb(0, 0, 0xff));
+}
+
 #include "tst_qquickanimators.moc"
 
 QTEST_MAIN(tst_Animators)
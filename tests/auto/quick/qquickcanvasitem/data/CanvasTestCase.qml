@@ -20,6 +20,11 @@ TestCase {
 //             { tag:"fbo immediate", properties:{width:100, height:100, renderTarget:Canvas.FramebufferObject, renderStrategy:Canvas.Immediate}},
 //             { tag:"fbo threaded", properties:{width:100, height:100, renderTarget:Canvas.FramebufferObject, renderStrategy:Canvas.Threaded}}
            ];
+    if (type === "geometry")
+      return [
+             { tag:"geometry threaded", properties:{width:100, height:100, renderTarget:Canvas.Geometry, renderStrategy:Canvas.Threaded}},
+             { tag:"geometry immediate", properties:{width:100, height:100, renderTarget:Canvas.Geometry, renderStrategy:Canvas.Immediate}},
+           ];
      return [];
   }
 
@@ -0,0 +1,72 @@
+import QtQuick 2.0
+
+CanvasTestCase {
+   id:testCase
+   name: "geometry"
+   function init_data() { return testData("geometry"); }
+
+   function test_fill(row) {
+       var canvas = createCanvasObject(row);
+       var ctx = canvas.getContext('2d');
+       ctx.fillStyle = "#00ff00";
+       ctx.fillRect(10, 10, 30, 30);
+       ctx.beginPath();
+       ctx.moveTo(60, 10);
+       ctx.lineTo(90, 10);
+       ctx.lineTo(90, 40);
+       ctx.closePath();
+       ctx.fill();
+       comparePixel(ctx, 20, 20, 0, 255, 0, 255);
+       comparePixel(ctx, 85, 15, 0, 255, 0, 255);
+       comparePixel(ctx, 65, 35, 0, 0, 0, 0);
+       comparePixel(ctx, 50, 50, 0, 0, 0, 0);
+       canvas.destroy();
+  }
+
+   function test_stroke(row) {
+       var canvas = createCanvasObject(row);
+       var ctx = canvas.getContext('2d');
+       ctx.strokeStyle = "#0000ff";
+       ctx.lineWidth = 10;
+       ctx.beginPath();
+       ctx.moveTo(0, 50);
+       ctx.lineTo(100, 50);
+       ctx.stroke();
+       comparePixel(ctx, 50, 50, 0, 0, 255, 255);
+       comparePixel(ctx, 50, 20, 0, 0, 0, 0);
+       canvas.destroy();
+  }
+
+   function test_order(row) {
+       var canvas = createCanvasObject(row);
+       var ctx = canvas.getContext('2d');
+       // the last red rectangle overlaps the green one, so it must not be
+       // batched with the first red one below it
+       ctx.fillStyle = "#ff0000";
+       ctx.fillRect(0, 0, 50, 50);
+       ctx.fillStyle = "#00ff00";
+       ctx.fillRect(25, 25, 50, 50);
+       ctx.fillStyle = "#ff0000";
+       ctx.fillRect(50, 50, 50, 50);
+       comparePixel(ctx, 10, 10, 255, 0, 0, 255);
+       comparePixel(ctx, 40, 40, 0, 255, 0, 255);
+       comparePixel(ctx, 60, 60, 255, 0, 0, 255);
+       canvas.destroy();
+  }
+
+   function test_clear(row) {
+       var canvas = createCanvasObject(row);
+       var ctx = canvas.getContext('2d');
+       ctx.fillStyle = "#00ff00";
+       ctx.fillRect(10, 10, 20, 20);
+       ctx.fillRect(60, 60, 20, 20);
+       ctx.clearRect(0, 0, 50, 50);
+       comparePixel(ctx, 20, 20, 0, 0, 0, 0);
+       comparePixel(ctx, 70, 70, 0, 255, 0, 255);
+       ctx.clearRect(0, 0, canvas.width, canvas.height);
+       comparePixel(ctx, 70, 70, 0, 0, 0, 0);
+       ctx.fillRect(10, 10, 20, 20);
+       comparePixel(ctx, 20, 20, 0, 255, 0, 255);
+       canvas.destroy();
+  }
+}
@@ -19,6 +19,7 @@ OTHER_FILES += \
     data/tst_line.qml \
     data/tst_fillStyle.qml \
     data/tst_fillrect.qml \
+    data/tst_geometry.qml \
     data/tst_drawimage.qml \
     data/tst_composite.qml \
     data/tst_canvas.qml \
@@ -0,0 +1,13 @@
+import QtQuick 2.3
+
+Flickable {
+    width: 400; height: 400
+    contentWidth: 400; contentHeight: 6000
+    boundsBehavior: Flickable.StopAtBounds
+    asynchronousFlicking: true
+
+    Rectangle {
+        width: 400; height: 6000
+        color: "yellow"
+    }
+}
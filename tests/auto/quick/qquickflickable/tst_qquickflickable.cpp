@@ -99,6 +99,7 @@ private slots:
     void stopAtBounds_data();
     void nestedMouseAreaUsingTouch();
     void pressDelayWithLoader();
+    void asynchronousFlicking();
 
 private:
     void flickWithTouch(QQuickWindow *window, QTouchDevice *touchDevice, const QPoint &from, const QPoint &to);
@@ -1642,6 +1643,50 @@ void tst_qquickflickable::pressDelayWithLoader()
     QTest::mouseRelease(window.data(), Qt::LeftButton, 0, QPoint(150, 150));
 }
 
+void tst_qquickflickable::asynchronousFlicking()
+{
+    QScopedPointer<QQuickView> window(new QQuickView);
+    window->setSource(testFileUrl("asynchronousFlicking.qml"));
+    QTRY_COMPARE(window->status(), QQuickView::Ready);
+    QQuickViewTestUtil::centerOnScreen(window.data());
+    QQuickViewTestUtil::moveMouseAway(window.data());
+    window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(window.data()));
+
+    QQuickFlickable *flickable = qobject_cast<QQuickFlickable*>(window->rootObject());
+    QVERIFY(flickable != 0);
+    QVERIFY(flickable->asynchronousFlicking());
+    QQuickFlickablePrivate *fp = QQuickFlickablePrivate::get(flickable);
+
+    // the render thread mirrors the fling, the GUI thread still ends up
+    // in the same place
+    flickable->flick(0, -2000);
+    QVERIFY(flickable->isFlickingVertically());
+    QVERIFY(fp->vData.asyncFlick != 0);
+    QVERIFY(fp->hData.asyncFlick == 0);
+    QTRY_VERIFY(!flickable->isMoving());
+    const qreal asyncContentY = flickable->contentY();
+    QVERIFY(asyncContentY > 0);
+
+    QSignalSpy spy(flickable, SIGNAL(asynchronousFlickingChanged()));
+    flickable->setAsynchronousFlicking(false);
+    QCOMPARE(spy.count(), 1);
+
+    flickable->setContentY(0);
+    flickable->flick(0, -2000);
+    QVERIFY(fp->vData.asyncFlick == 0);
+    QTRY_VERIFY(!flickable->isMoving());
+    QCOMPARE(flickable->contentY(), asyncContentY);
+
+    // interrupting the flick stops the render thread animation as well
+    flickable->setAsynchronousFlicking(true);
+    flickable->setContentY(0);
+    flickable->flick(0, -2000);
+    QVERIFY(fp->vData.asyncFlick != 0);
+    flickable->cancelFlick();
+    QVERIFY(fp->vData.asyncFlick == 0);
+}
+
 QTEST_MAIN(tst_qquickflickable)
 
 #include "tst_qquickflickable.moc"
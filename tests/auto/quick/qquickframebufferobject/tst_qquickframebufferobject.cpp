@@ -159,6 +159,8 @@ private slots:
     void testThatStuffWorks();
 
     void testInvalidate();
+
+    void testAsynchronous();
 };
 
 void tst_QQuickFramebufferObject::testThatStuffWorks_data()
@@ -250,6 +252,41 @@ void tst_QQuickFramebufferObject::testInvalidate()
     QCOMPARE(frameInfo.fboSize, QSize(300, 300));
 }
 
+void tst_QQuickFramebufferObject::testAsynchronous()
+{
+    frameInfo.renderCount = 0;
+    frameInfo.fboSize = QSize();
+
+    qmlRegisterType<FBOItem>("FBOItem", 1, 0, "FBOItem");
+
+    QQuickView view;
+    view.setSource(QUrl::fromLocalFile("data/testStuff.qml"));
+
+    FBOItem *item = view.rootObject()->findChild<FBOItem *>("fbo");
+    item->setColor(0xffff0000);
+    item->setAsynchronousRendering(true);
+    QVERIFY(item->asynchronousRendering());
+
+    view.show();
+    QTest::qWaitForWindowExposed(&view);
+
+    // The first frame is waited for
+    QImage result = view.grabWindow();
+    QCOMPARE(frameInfo.renderCount, 1);
+    QCOMPARE(result.pixel(0, 0), 0xffff0000);
+    QCOMPARE(frameInfo.fboSize, QSize(item->width(), item->height()) * view.devicePixelRatio());
+
+    // Later ones show up once the renderer thread is done with them
+    item->setColor(0xff00ff00);
+    item->update();
+    QTRY_COMPARE(frameInfo.renderCount, 2);
+    QTRY_COMPARE(view.grabWindow().pixel(0, 0), 0xff00ff00);
+
+    item->setSize(QSize(200, 200));
+    QTRY_COMPARE(frameInfo.fboSize, QSize(200, 200) * view.devicePixelRatio());
+    QTRY_COMPARE(view.grabWindow().pixel(150, 150), 0xff00ff00);
+}
+
 QTEST_MAIN(tst_QQuickFramebufferObject)
 
 #include "tst_qquickframebufferobject.moc"
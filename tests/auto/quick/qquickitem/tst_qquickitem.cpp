@@ -50,6 +50,7 @@
 #include <QDebug>
 #include <QTimer>
 #include <QQmlEngine>
+#include <QQmlComponent>
 #include "../../shared/util.h"
 #include "../shared/viewtestutil.h"
 #include <QSignalSpy>
@@ -99,15 +100,21 @@ class TestPolishItem : public QQuickItem
 Q_OBJECT
 public:
     TestPolishItem(QQuickItem *parent = 0)
-    : QQuickItem(parent), wasPolished(false) {
+    : QQuickItem(parent), wasPolished(false), polishOrder(0), deleteOnPolish(0) {
 
     }
 
     bool wasPolished;
+    QList<QQuickItem *> *polishOrder;
+    QQuickItem *deleteOnPolish;
 
 protected:
     virtual void updatePolish() {
         wasPolished = true;
+        if (polishOrder)
+            polishOrder->append(this);
+        delete deleteOnPolish;
+        deleteOnPolish = 0;
     }
 
 public slots:
@@ -158,6 +165,8 @@ private slots:
     void touchEventAcceptIgnore();
     void polishOutsideAnimation();
     void polishOnCompleted();
+    void polishChildrenFirst();
+    void polishDeletesPendingItem();
 
     void wheelEvent_data();
     void wheelEvent();
@@ -174,6 +183,10 @@ private slots:
 
     void testSGInvalidate();
 
+    void accessorPropertyBindings();
+
+    void lazySideData();
+
 private:
 
     enum PaintOrderOp {
@@ -1403,6 +1416,57 @@ void tst_qquickitem::polishOnCompleted()
     QTRY_VERIFY(item->wasPolished);
 }
 
+void tst_qquickitem::polishChildrenFirst()
+{
+    QQuickWindow window;
+    window.resize(200, 200);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+
+    QList<QQuickItem *> polishOrder;
+    TestPolishItem *parent = new TestPolishItem(window.contentItem());
+    TestPolishItem *child = new TestPolishItem(parent);
+    TestPolishItem *grandChild = new TestPolishItem(child);
+    parent->polishOrder = &polishOrder;
+    child->polishOrder = &polishOrder;
+    grandChild->polishOrder = &polishOrder;
+
+    parent->doPolish();
+    grandChild->doPolish();
+    child->doPolish();
+    QTRY_COMPARE(polishOrder.count(), 3);
+
+    QCOMPARE(polishOrder.at(0), static_cast<QQuickItem *>(grandChild));
+    QCOMPARE(polishOrder.at(1), static_cast<QQuickItem *>(child));
+    QCOMPARE(polishOrder.at(2), static_cast<QQuickItem *>(parent));
+}
+
+void tst_qquickitem::polishDeletesPendingItem()
+{
+    QQuickWindow window;
+    window.resize(200, 200);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+
+    QList<QQuickItem *> polishOrder;
+    TestPolishItem *parent = new TestPolishItem(window.contentItem());
+    TestPolishItem *child = new TestPolishItem(parent);
+    TestPolishItem *victim = new TestPolishItem(window.contentItem());
+    parent->polishOrder = &polishOrder;
+    child->polishOrder = &polishOrder;
+    victim->polishOrder = &polishOrder;
+
+    // The child is polished first and deletes an item that is still pending
+    child->deleteOnPolish = victim;
+    victim->doPolish();
+    parent->doPolish();
+    child->doPolish();
+    QTRY_COMPARE(polishOrder.count(), 2);
+
+    QCOMPARE(polishOrder.at(0), static_cast<QQuickItem *>(child));
+    QCOMPARE(polishOrder.at(1), static_cast<QQuickItem *>(parent));
+}
+
 void tst_qquickitem::wheelEvent_data()
 {
     QTest::addColumn<bool>("visible");
@@ -1920,6 +1984,75 @@ void tst_qquickitem::testSGInvalidate()
 
 }
 
+void tst_qquickitem::accessorPropertyBindings()
+{
+    // x, y, width and height are read through QQmlAccessors; bindings on them
+    // must still pick up the values and be notified of changes.
+    QQmlEngine engine;
+    QQmlComponent component(&engine);
+    component.setData("import QtQuick 2.0\n"
+                      "Item {\n"
+                      "    id: root; width: 100; height: 50\n"
+                      "    property real w: child.width\n"
+                      "    property real h: child.height * 2\n"
+                      "    property real sum: child.x + child.y\n"
+                      "    property Item child: Item { parent: root; width: root.width / 2; height: root.height; x: 3; y: 4 }\n"
+                      "}\n", QUrl());
+    QScopedPointer<QObject> object(component.create());
+    QQuickItem *root = qobject_cast<QQuickItem *>(object.data());
+    QVERIFY(root);
+    QQuickItem *child = root->property("child").value<QQuickItem *>();
+    QVERIFY(child);
+
+    QCOMPARE(root->property("w").toReal(), qreal(50));
+    QCOMPARE(root->property("h").toReal(), qreal(100));
+    QCOMPARE(root->property("sum").toReal(), qreal(7));
+
+    root->setWidth(300);
+    QCOMPARE(root->property("w").toReal(), qreal(150));
+    root->setHeight(10);
+    QCOMPARE(root->property("h").toReal(), qreal(20));
+    child->setX(10);
+    QCOMPARE(root->property("sum").toReal(), qreal(14));
+}
+
+void tst_qquickitem::lazySideData()
+{
+    // States and transforms live in the lazily allocated extra data, a plain item must not
+    // pay for them.
+    QQmlEngine engine;
+    QQmlComponent component(&engine);
+    component.setData("import QtQuick 2.0\n"
+                      "Item {\n"
+                      "    property Item plain: Item { width: 10; height: 10 }\n"
+                      "    property Item stateful: Item { state: \"wide\"; states: State { name: \"wide\"; PropertyChanges { target: stateful; width: 200 } } }\n"
+                      "    property Item transformed: Item { transform: Translate { x: 5; y: 7 } }\n"
+                      "}\n", QUrl());
+    QScopedPointer<QObject> object(component.create());
+    QVERIFY(object);
+
+    QQuickItem *plain = object->property("plain").value<QQuickItem *>();
+    QVERIFY(plain);
+    QVERIFY(!QQuickItemPrivate::get(plain)->extra.isAllocated());
+    QVERIFY(!QQuickItemPrivate::get(plain)->stateGroup());
+    QVERIFY(!QQuickItemPrivate::get(plain)->hasTransforms());
+    QCOMPARE(plain->state(), QString());
+
+    QQuickItem *stateful = object->property("stateful").value<QQuickItem *>();
+    QVERIFY(stateful);
+    QVERIFY(QQuickItemPrivate::get(stateful)->stateGroup());
+    QCOMPARE(stateful->state(), QString("wide"));
+    QCOMPARE(stateful->width(), qreal(200));
+
+    QQuickItem *transformed = object->property("transformed").value<QQuickItem *>();
+    QVERIFY(transformed);
+    QVERIFY(QQuickItemPrivate::get(transformed)->hasTransforms());
+    QCOMPARE(transformed->mapToItem(0, QPointF(0, 0)), QPointF(5, 7));
+
+    QVERIFY(QQuickItemPrivate::get(stateful)->memoryFootprint()
+            > QQuickItemPrivate::get(plain)->memoryFootprint());
+}
+
 QTEST_MAIN(tst_qquickitem)
 
 #include "tst_qquickitem.moc"
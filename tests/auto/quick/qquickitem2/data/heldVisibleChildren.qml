@@ -0,0 +1,23 @@
+import QtQuick 2.0
+
+Item {
+    id: root
+
+    Item { objectName: "a" }
+    Item { id: b; objectName: "b"; visible: false }
+    Item { objectName: "c" }
+
+    property var heldList
+    function holdList() {
+        heldList = root.visibleChildren;
+    }
+    function readHeldList() {
+        var names = [];
+        for (var i = 0; i < heldList.length; ++i)
+            names.push(heldList[i].objectName);
+        return names.join(",");
+    }
+    function showB() {
+        b.visible = true;
+    }
+}
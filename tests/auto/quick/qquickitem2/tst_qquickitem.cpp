@@ -112,6 +112,7 @@ private slots:
     void implicitSize();
     void qtbug_16871();
     void visibleChildren();
+    void heldVisibleChildren();
     void parentLoop();
     void contains_data();
     void contains();
@@ -2367,6 +2368,28 @@ void tst_QQuickItem::visibleChildren()
     delete window;
 }
 
+void tst_QQuickItem::heldVisibleChildren()
+{
+    QQmlComponent component(&engine, testFileUrl("heldVisibleChildren.qml"));
+    QObject *object = component.create();
+    QVERIFY(object != 0);
+
+    // The list held in JavaScript is read once and reused while it is
+    // iterated, until visibleChildren notifies a change
+    QVariant names;
+    QMetaObject::invokeMethod(object, "holdList");
+    QMetaObject::invokeMethod(object, "readHeldList", Q_RETURN_ARG(QVariant, names));
+    QCOMPARE(names.toString(), QString("a,c"));
+    QMetaObject::invokeMethod(object, "readHeldList", Q_RETURN_ARG(QVariant, names));
+    QCOMPARE(names.toString(), QString("a,c"));
+
+    QMetaObject::invokeMethod(object, "showB");
+    QMetaObject::invokeMethod(object, "readHeldList", Q_RETURN_ARG(QVariant, names));
+    QCOMPARE(names.toString(), QString("a,b,c"));
+
+    delete object;
+}
+
 void tst_QQuickItem::parentLoop()
 {
     QQuickView *window = new QQuickView(0);
@@ -0,0 +1,36 @@
+import QtQuick 2.0
+
+Item {
+    width: 200
+    height: 200
+
+    property alias partialUpdates: layered.layer.partialUpdates
+    property alias rightColor: right.color
+    property alias markerX: marker.x
+
+    Item {
+        id: layered
+        anchors.fill: parent
+        layer.enabled: true
+
+        Rectangle {
+            width: 100
+            height: 200
+            color: "#ff0000"
+        }
+        Rectangle {
+            id: right
+            x: 100
+            width: 100
+            height: 200
+            color: "#0000ff"
+        }
+        Rectangle {
+            id: marker
+            y: 80
+            width: 20
+            height: 20
+            color: "#ffffff"
+        }
+    }
+}
@@ -89,6 +89,9 @@ private slots:
     void itemEffect();
     void rectangleEffect();
 
+    void partialUpdates_data();
+    void partialUpdates();
+
 private:
     bool m_isMesaSoftwareRasterizer;
     int m_mesaVersion;
@@ -431,6 +434,45 @@ void tst_QQuickItemLayer::rectangleEffect()
 }
 
 
+void tst_QQuickItemLayer::partialUpdates_data()
+{
+    QTest::addColumn<bool>("partial");
+    QTest::newRow("partial") << true;
+    QTest::newRow("full") << false;
+}
+
+void tst_QQuickItemLayer::partialUpdates()
+{
+    if (m_isMesaSoftwareRasterizer && m_mesaVersion < QT_VERSION_CHECK(7, 11, 0))
+        QSKIP("Mesa Software Rasterizer below version 7.11 does not render this test correctly.");
+
+    QFETCH(bool, partial);
+
+    QQuickView view;
+    view.setSource(testFileUrl("PartialUpdates.qml"));
+    QQuickItem *root = view.rootObject();
+    root->setProperty("partialUpdates", partial);
+
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+    QImage fb = view.grabWindow();
+    QCOMPARE(fb.pixel(50, 50), qRgb(0xff, 0, 0));
+    QCOMPARE(fb.pixel(150, 50), qRgb(0, 0, 0xff));
+    QCOMPARE(fb.pixel(10, 90), qRgb(0xff, 0xff, 0xff));
+
+    // Change a part of the layer and move the marker, which
+    // leaves its old area behind.
+    root->setProperty("rightColor", QColor(Qt::green));
+    root->setProperty("markerX", 160);
+
+    fb = view.grabWindow();
+    QCOMPARE(fb.pixel(50, 50), qRgb(0xff, 0, 0));
+    QCOMPARE(fb.pixel(150, 50), qRgb(0, 0xff, 0));
+    QCOMPARE(fb.pixel(10, 90), qRgb(0xff, 0, 0));
+    QCOMPARE(fb.pixel(170, 90), qRgb(0xff, 0xff, 0xff));
+}
+
 QTEST_MAIN(tst_QQuickItemLayer)
 
 #include "tst_qquickitemlayer.moc"
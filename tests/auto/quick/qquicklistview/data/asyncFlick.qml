@@ -0,0 +1,14 @@
+import QtQuick 2.0
+
+ListView {
+    width: 240; height: 320
+    model: 500
+    flickDeceleration: 500
+    maximumFlickVelocity: 10000
+    delegate: Rectangle {
+        objectName: "wrapper"
+        width: ListView.view.width
+        height: 40
+        Text { text: index }
+    }
+}
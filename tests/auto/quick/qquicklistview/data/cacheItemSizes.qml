@@ -0,0 +1,27 @@
+import QtQuick 2.0
+
+ListView {
+    id: list
+    width: 240
+    height: 320
+    cacheItemSizes: true
+    sizeRole: "itemSize"
+
+    function removeFirst() {
+        model.remove(0)
+    }
+
+    model: ListModel {
+        id: listModel
+        Component.onCompleted: {
+            for (var i = 0; i < 2000; ++i)
+                append({ itemSize: i % 3 == 0 ? 100 : 20 })
+        }
+    }
+
+    delegate: Rectangle {
+        objectName: "wrapper"
+        width: list.width
+        height: itemSize
+    }
+}
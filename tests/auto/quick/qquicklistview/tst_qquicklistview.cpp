@@ -193,6 +193,8 @@ private slots:
     void QTBUG_21742();
 
     void asynchronous();
+    void asynchronousFlick();
+    void cacheItemSizes();
     void unrequestedVisibility();
 
     void populateTransitions();
@@ -5319,6 +5321,70 @@ void tst_QQuickListView::asynchronous()
     delete window;
 }
 
+void tst_QQuickListView::asynchronousFlick()
+{
+    QQuickView *window = createView();
+    QQmlIncubationController controller;
+    window->engine()->setIncubationController(&controller);
+    window->setSource(testFileUrl("asyncFlick.qml"));
+    window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(window));
+
+    QQuickListView *listview = qobject_cast<QQuickListView*>(window->rootObject());
+    QVERIFY(listview);
+    QTRY_COMPARE(QQuickItemPrivate::get(listview)->polishScheduled, false);
+    QVERIFY(findItem<QQuickItem>(listview->contentItem(), "wrapper", 0));
+
+    // The controller never incubates, so the delegates requested asynchronously
+    // while flicking are only created once the view stops waiting for them.
+    listview->flick(0, -8000);
+    QVERIFY(listview->isFlicking());
+    QTRY_VERIFY(listview->contentY() > 2000);
+    QTRY_VERIFY(!listview->isMoving());
+
+    // The whole view is filled when the flick ends
+    const int first = int(listview->contentY() / 40.0);
+    const int last = int((listview->contentY() + listview->height() - 1) / 40.0);
+    for (int i = first; i <= last; ++i) {
+        QQuickItem *item = findItem<QQuickItem>(listview->contentItem(), "wrapper", i);
+        QVERIFY2(item, QByteArray::number(i));
+        QVERIFY(!QQuickItemPrivate::get(item)->culled);
+        QCOMPARE(item->y(), i * 40.0);
+    }
+
+    delete window;
+}
+
+void tst_QQuickListView::cacheItemSizes()
+{
+    QQuickView *window = createView();
+    window->setSource(testFileUrl("cacheItemSizes.qml"));
+    window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(window));
+
+    QQuickListView *listview = qobject_cast<QQuickListView*>(window->rootObject());
+    QVERIFY(listview);
+    QTRY_COMPARE(QQuickItemPrivate::get(listview)->polishScheduled, false);
+    QCOMPARE(listview->count(), 2000);
+
+    // Every third item is 100 high and the others are 20, all read from the
+    // size role, so the content height is exact rather than estimated.
+    QTRY_COMPARE(listview->contentHeight(), 667 * 100.0 + 1333 * 20.0);
+
+    listview->positionViewAtIndex(1000, QQuickListView::Beginning);
+    QTRY_COMPARE(QQuickItemPrivate::get(listview)->polishScheduled, false);
+    QCOMPARE(listview->contentY(), 334 * 100.0 + 666 * 20.0);
+    QQuickItem *item = findItem<QQuickItem>(listview->contentItem(), "wrapper", 1000);
+    QVERIFY(item);
+    QCOMPARE(item->y(), 334 * 100.0 + 666 * 20.0);
+
+    // Removing an item that is not visible drops its size from the cache
+    QMetaObject::invokeMethod(window->rootObject(), "removeFirst");
+    QTRY_COMPARE(listview->contentHeight(), 666 * 100.0 + 1333 * 20.0);
+
+    delete window;
+}
+
 void tst_QQuickListView::snapOneItem_data()
 {
     QTest::addColumn<QQuickListView::Orientation>("orientation");
@@ -0,0 +1,12 @@
+import QtQuick 2.3
+
+Item {
+    width: 200; height: 200
+
+    Loader {
+        id: loader
+        objectName: "loader"
+        keepAlive: 1
+        source: "RedRect.qml"
+    }
+}
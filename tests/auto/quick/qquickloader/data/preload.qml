@@ -0,0 +1,13 @@
+import QtQuick 2.3
+
+Item {
+    width: 200; height: 200
+
+    Loader {
+        id: loader
+        objectName: "loader"
+        asynchronous: true
+        source: "RedRect.qml"
+        preload: "Rect120x60.qml"
+    }
+}
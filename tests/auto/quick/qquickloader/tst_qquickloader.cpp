@@ -41,6 +41,7 @@
 #include <qtest.h>
 
 #include <QSignalSpy>
+#include <QtCore/qpointer.h>
 
 #include <QtQml/qqmlengine.h>
 #include <QtQml/qqmlcomponent.h>
@@ -130,6 +131,10 @@ private slots:
 
     void sourceComponentGarbageCollection();
 
+    void sharedComponent();
+    void keepAlive();
+    void preload();
+
 private:
     QQmlEngine engine;
 };
@@ -1166,6 +1171,107 @@ void tst_QQuickLoader::sourceComponentGarbageCollection()
     QCOMPARE(spy.count(), 1);
 }
 
+void tst_QQuickLoader::sharedComponent()
+{
+    QQmlComponent component(&engine);
+    component.setData(QByteArray("import QtQuick 2.0\n"
+                                 "Item {\n"
+                                 "    Loader { objectName: \"loader1\"; source: \"RedRect.qml\" }\n"
+                                 "    Loader { objectName: \"loader2\"; source: \"RedRect.qml\" }\n"
+                                 "}"), dataDirectoryUrl());
+    QScopedPointer<QObject> root(component.create());
+    QVERIFY(!root.isNull());
+
+    QQuickLoader *loader1 = root->findChild<QQuickLoader*>("loader1");
+    QQuickLoader *loader2 = root->findChild<QQuickLoader*>("loader2");
+    QVERIFY(loader1 && loader2);
+    QVERIFY(loader1->item() && loader2->item());
+    QVERIFY(loader1->item() != loader2->item());
+    QVERIFY(loader1->sourceComponent());
+    QCOMPARE(loader1->sourceComponent(), loader2->sourceComponent());
+
+    // a cleared component cache must not leave a stale component behind
+    QQmlComponent *shared = loader1->sourceComponent();
+    loader1->setSource(QUrl());
+    engine.clearComponentCache();
+    loader1->setSource(testFileUrl("RedRect.qml"));
+    QVERIFY(loader1->item());
+    QVERIFY(loader1->sourceComponent() != shared);
+}
+
+void tst_QQuickLoader::keepAlive()
+{
+    QQmlComponent component(&engine, testFileUrl("keepAlive.qml"));
+    QScopedPointer<QObject> root(component.create());
+    QVERIFY(!root.isNull());
+
+    QQuickLoader *loader = root->findChild<QQuickLoader*>("loader");
+    QVERIFY(loader);
+    QCOMPARE(loader->keepAlive(), 1);
+
+    QPointer<QObject> red = loader->item();
+    QVERIFY(red);
+
+    loader->setSource(testFileUrl("Rect120x60.qml"));
+    QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+    QVERIFY(red);
+    QVERIFY(!qobject_cast<QQuickItem*>(red)->parentItem());
+    QPointer<QObject> rect = loader->item();
+    QVERIFY(rect);
+
+    loader->setSource(testFileUrl("RedRect.qml"));
+    QCOMPARE(loader->item(), red.data());
+    QCOMPARE(loader->status(), QQuickLoader::Ready);
+    QCOMPARE(qobject_cast<QQuickItem*>(red)->parentItem(), static_cast<QQuickItem*>(loader));
+    QVERIFY(qobject_cast<QQuickItem*>(red)->isVisible());
+
+    // only the most recently unloaded object is kept
+    loader->setSource(testFileUrl("BlueRect.qml"));
+    QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+    QVERIFY(red);
+    QVERIFY(!rect);
+
+    loader->setKeepAlive(0);
+    QCoreApplication::sendPostedEvents(0, QEvent::DeferredDelete);
+    QVERIFY(!red);
+}
+
+void tst_QQuickLoader::preload()
+{
+    PeriodicIncubationController *controller = new PeriodicIncubationController;
+    QQmlIncubationController *previous = engine.incubationController();
+    engine.setIncubationController(controller);
+    delete previous;
+    controller->start();
+
+    QQmlComponent component(&engine, testFileUrl("preload.qml"));
+    QScopedPointer<QObject> root(component.create());
+    QVERIFY(!root.isNull());
+
+    QQuickLoader *loader = root->findChild<QQuickLoader*>("loader");
+    QVERIFY(loader);
+    QTRY_VERIFY(loader->item());
+
+    // the preloaded page is created in the background and kept hidden
+    QTRY_COMPARE(static_cast<QQuickItem*>(loader)->childItems().count(), 2);
+    QQuickItem *prepared = 0;
+    foreach (QQuickItem *child, static_cast<QQuickItem*>(loader)->childItems()) {
+        if (child != loader->item())
+            prepared = child;
+    }
+    QVERIFY(prepared);
+    QVERIFY(!prepared->isVisible());
+
+    QSignalSpy spy(loader, SIGNAL(loaded()));
+    loader->setSource(testFileUrl("Rect120x60.qml"));
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(loader->item(), static_cast<QObject*>(prepared));
+    QCOMPARE(loader->status(), QQuickLoader::Ready);
+    QVERIFY(prepared->isVisible());
+    QCOMPARE(loader->width(), 120.0);
+    QCOMPARE(loader->height(), 60.0);
+}
+
 QTEST_MAIN(tst_QQuickLoader)
 
 #include "tst_qquickloader.moc"
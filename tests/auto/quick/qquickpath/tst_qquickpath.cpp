@@ -58,6 +58,7 @@ private slots:
     void closedCatmullromCurve();
     void svg();
     void line();
+    void batchQueries();
 };
 
 void tst_QuickPath::arc()
@@ -231,6 +232,53 @@ void tst_QuickPath::line()
     }
 }
 
+void tst_QuickPath::batchQueries()
+{
+    QQmlEngine engine;
+    QQmlComponent c(&engine);
+    c.setData(
+            "import QtQuick 2.0\n"
+            "Path {\n"
+                "startX: 0; startY: 0\n"
+                "PathAttribute { name: \"scale\"; value: 1 }\n"
+                "PathAttribute { name: \"z\"; value: 0 }\n"
+                "PathQuad { x: 100; y: 100; controlX: 100; controlY: 0 }\n"
+                "PathAttribute { name: \"scale\"; value: 0.5 }\n"
+                "PathAttribute { name: \"z\"; value: 10 }\n"
+                "PathPercent { value: 0.75 }\n"
+                "PathLine { x: 200; y: 100 }\n"
+                "PathAttribute { name: \"scale\"; value: 2 }\n"
+                "PathAttribute { name: \"z\"; value: 4 }\n"
+            "}", QUrl());
+    QScopedPointer<QObject> o(c.create());
+    QQuickPath *path = qobject_cast<QQuickPath *>(o.data());
+    QVERIFY(path);
+
+    const QStringList attributes = path->attributes();
+    QCOMPARE(attributes.count(), 2);
+
+    // The batch functions give the same results as the single queries
+    const int count = 101;
+    qreal percents[count];
+    QPointF points[count];
+    for (int i = 0; i < count; ++i)
+        percents[i] = i / qreal(count - 1);
+    path->pointsAt(percents, points, count);
+
+    for (int i = 0; i < count; ++i) {
+        QCOMPARE(points[i], path->pointAt(percents[i]));
+
+        qreal values[2];
+        path->attributesAt(percents[i], values);
+        for (int j = 0; j < attributes.count(); ++j)
+            QCOMPARE(values[j], path->attributeAt(attributes.at(j), percents[i]));
+    }
+
+    qreal values[2] = { -1, -1 };
+    path->attributesAt(1.5, values);
+    QCOMPARE(values[0], 0.0);
+    QCOMPARE(values[1], 0.0);
+}
 
 QTEST_MAIN(tst_QuickPath)
 
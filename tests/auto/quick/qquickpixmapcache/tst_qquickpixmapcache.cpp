@@ -47,6 +47,7 @@
 #include "../../shared/util.h"
 #include "testhttpserver.h"
 #include <QtNetwork/QNetworkConfigurationManager>
+#include <QtCore/QTemporaryDir>
 
 #ifndef QT_NO_CONCURRENT
 #include <qtconcurrentrun.h>
@@ -75,6 +76,11 @@ private slots:
 #endif
     void lockingCrash();
     void uncached();
+    void asynchronousDecoding();
+    void cacheBudget();
+    void diskCache();
+    void compressedTexture_data();
+    void compressedTexture();
 #if PIXMAP_DATA_LEAK_TEST
     void dataLeak();
 #endif
@@ -473,6 +479,203 @@ void tst_qquickpixmapcache::uncached()
     }
 }
 
+class CountingImageProvider : public QQuickImageProvider
+{
+public:
+    CountingImageProvider()
+    : QQuickImageProvider(Image) {}
+
+    virtual QImage requestImage(const QString &, QSize *size, const QSize &) {
+        if (active.fetchAndAddOrdered(1) != 0)
+            overlapped = true;
+        QTest::qSleep(20);
+        QImage image(10, 10, QImage::Format_RGB32);
+        image.fill(Qt::red);
+        *size = image.size();
+        active.deref();
+        return image;
+    }
+
+    QAtomicInt active;
+    bool overlapped;
+};
+
+void tst_qquickpixmapcache::asynchronousDecoding()
+{
+    QQmlEngine engine;
+    CountingImageProvider *provider = new CountingImageProvider;
+    provider->overlapped = false;
+    engine.addImageProvider(QLatin1String("counting"), provider);
+
+    QList<QQuickPixmap *> pixmaps;
+    QList<Slotter *> getters;
+    for (int i = 0; i < 6; ++i) {
+        QUrl url = i % 2 ? testFileUrl(QString("exists%1.png").arg(i % 3 ? 1 : 2))
+                         : QUrl("image://counting/" + QString::number(i));
+        QQuickPixmap *pixmap = new QQuickPixmap;
+        pixmap->load(&engine, url, QQuickPixmap::Asynchronous);
+        pixmaps.append(pixmap);
+        if (pixmap->isLoading()) {
+            getters.append(new Slotter);
+            pixmap->connectFinished(getters.last(), SLOT(got()));
+        }
+    }
+
+    // cancelling a request before it is decoded must not stop the others
+    QQuickPixmap *cancelled = new QQuickPixmap;
+    cancelled->load(&engine, QUrl("image://counting/cancelled"), QQuickPixmap::Asynchronous);
+    delete cancelled;
+
+    if (slotters) {
+        QTestEventLoop::instance().enterLoop(10);
+        QVERIFY(!QTestEventLoop::instance().timeout());
+    }
+
+    foreach (QQuickPixmap *pixmap, pixmaps) {
+        QVERIFY(pixmap->isReady());
+        QVERIFY(pixmap->width() > 0);
+    }
+
+    // image providers are not required to be thread safe
+    QVERIFY(!provider->overlapped);
+
+    qDeleteAll(getters);
+    qDeleteAll(pixmaps);
+}
+
+void tst_qquickpixmapcache::cacheBudget()
+{
+    QQmlEngine engine;
+    const int limit = QQuickPixmap::cacheLimit();
+    QQuickPixmap::purgeCache();
+    const int base = QQuickPixmap::cacheCost();
+    QCOMPARE(QQuickPixmap::unreferencedCacheCost(), 0);
+
+    const QUrl pinnedUrl = testFileUrl("exists.png");
+    QQuickPixmap::pin(pinnedUrl);
+    QVERIFY(QQuickPixmap::isPinned(pinnedUrl));
+
+    int cost = 0;
+    {
+        QQuickPixmap pinned(&engine, pinnedUrl);
+        QQuickPixmap other(&engine, testFileUrl("exists1.png"));
+        QVERIFY(pinned.isReady());
+        QVERIFY(other.isReady());
+        cost = pinned.textureFactory()->textureByteCount();
+        QCOMPARE(QQuickPixmap::cacheCost(), base + 2 * cost);
+        QCOMPARE(QQuickPixmap::unreferencedCacheCost(), 0);
+    }
+    QCOMPARE(QQuickPixmap::unreferencedCacheCost(), 2 * cost);
+
+    // only the pixmap that isn't pinned is dropped to fit in the limit
+    QQuickPixmap::setCacheLimit(cost / 2);
+    QCOMPARE(QQuickPixmap::unreferencedCacheCost(), cost);
+    QQuickPixmap::purgeCache();
+    QCOMPARE(QQuickPixmap::unreferencedCacheCost(), cost);
+
+    QQuickPixmap::unpin(pinnedUrl);
+    QVERIFY(!QQuickPixmap::isPinned(pinnedUrl));
+    QCOMPARE(QQuickPixmap::unreferencedCacheCost(), 0);
+    QCOMPARE(QQuickPixmap::cacheCost(), base);
+    QQuickPixmap::setCacheLimit(limit);
+
+    // the budget includes the pixmaps in use
+    {
+        QQuickPixmap used(&engine, testFileUrl("exists.png"));
+        {
+            QQuickPixmap unused(&engine, testFileUrl("exists1.png"));
+        }
+        QCOMPARE(QQuickPixmap::cacheCost(), base + 2 * cost);
+        QQuickPixmap::setCacheBudget(base + cost);
+        QCOMPARE(QQuickPixmap::cacheCost(), base + cost);
+        QCOMPARE(QQuickPixmap::unreferencedCacheCost(), 0);
+        QVERIFY(used.isReady());
+    }
+    QQuickPixmap::setCacheBudget(0);
+    QQuickPixmap::purgeCache();
+    QCOMPARE(QQuickPixmap::cacheCost(), base);
+}
+
+void tst_qquickpixmapcache::diskCache()
+{
+    QTemporaryDir cacheDir;
+    QVERIFY(cacheDir.isValid());
+    QQuickPixmap::setDiskCacheDirectory(cacheDir.path());
+    QCOMPARE(QQuickPixmap::diskCacheDirectory(), cacheDir.path());
+
+    QQmlEngine engine;
+    const QUrl url = testFileUrl("exists.png");
+    QImage decoded;
+    {
+        // images that aren't scaled aren't cached
+        QQuickPixmap pixmap;
+        pixmap.load(&engine, url, QSize(), 0);
+        QVERIFY(pixmap.isReady());
+        QVERIFY(QDir(cacheDir.path()).entryList(QDir::Files).isEmpty());
+
+        pixmap.load(&engine, url, QSize(50, 50), 0);
+        QVERIFY(pixmap.isReady());
+        QCOMPARE(pixmap.width(), 50);
+        decoded = pixmap.image();
+        QCOMPARE(QDir(cacheDir.path()).entryList(QDir::Files).count(), 1);
+    }
+
+    {
+        QQuickPixmap pixmap;
+        pixmap.load(&engine, url, QSize(50, 50), QQuickPixmap::Asynchronous);
+        if (pixmap.isLoading()) {
+            Slotter getter;
+            pixmap.connectFinished(&getter, SLOT(got()));
+            QTestEventLoop::instance().enterLoop(10);
+            QVERIFY(!QTestEventLoop::instance().timeout());
+        }
+        QVERIFY(pixmap.isReady());
+        QCOMPARE(pixmap.implicitSize(), QSize(100, 100));
+        QCOMPARE(pixmap.image().convertToFormat(decoded.format()), decoded);
+        QCOMPARE(QDir(cacheDir.path()).entryList(QDir::Files).count(), 1);
+    }
+
+    QQuickPixmap::setDiskCacheDirectory(QString());
+}
+
+void tst_qquickpixmapcache::compressedTexture_data()
+{
+    QTest::addColumn<QString>("file");
+    QTest::addColumn<QSize>("size");
+    QTest::addColumn<QRgb>("color");
+    QTest::addColumn<bool>("valid");
+
+    QTest::newRow("dds") << "compressed.dds" << QSize(8, 6) << qRgb(255, 0, 0) << true;
+    QTest::newRow("pkm") << "compressed.pkm" << QSize(4, 4) << qRgb(255, 2, 2) << true;
+    QTest::newRow("truncated") << "truncated.dds" << QSize() << QRgb(0) << false;
+}
+
+void tst_qquickpixmapcache::compressedTexture()
+{
+    QFETCH(QString, file);
+    QFETCH(QSize, size);
+    QFETCH(QRgb, color);
+    QFETCH(bool, valid);
+
+    QQmlEngine engine;
+    QQuickPixmap pixmap;
+    pixmap.load(&engine, testFileUrl(file), QQuickPixmap::Cache);
+    QCOMPARE(pixmap.isReady(), valid);
+    QCOMPARE(pixmap.isError(), !valid);
+    if (!valid)
+        return;
+
+    QVERIFY(pixmap.textureFactory());
+    QCOMPARE(pixmap.textureFactory()->textureSize(), size);
+    QCOMPARE(pixmap.implicitSize(), size);
+
+    // The data is kept compressed, the image is only decoded on request.
+    QCOMPARE(pixmap.textureFactory()->textureByteCount(), ((size.width() + 3) / 4) * ((size.height() + 3) / 4) * 8);
+    QImage image = pixmap.image();
+    QCOMPARE(image.size(), size);
+    QCOMPARE(image.pixel(0, 0), color);
+    QCOMPARE(image.pixel(size.width() - 1, size.height() - 1), color);
+}
 
 #if PIXMAP_DATA_LEAK_TEST
 // This test should not be enabled by default as it
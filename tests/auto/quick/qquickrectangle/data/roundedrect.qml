@@ -0,0 +1,21 @@
+import QtQuick 2.0
+
+Rectangle {
+    width: 100
+    height: 100
+    color: "black"
+
+    Rectangle {
+        x: 10
+        y: 10
+        width: 80
+        height: 80
+        radius: 20
+        border.color: "blue"
+        border.width: 4
+        gradient: Gradient {
+            GradientStop { position: 0.0; color: "red" }
+            GradientStop { position: 1.0; color: "red" }
+        }
+    }
+}
@@ -42,6 +42,7 @@
 
 #include <QtQml/qqmlengine.h>
 #include <QtQml/qqmlcomponent.h>
+#include <QtQuick/qquickview.h>
 #include <private/qquickrectangle_p.h>
 
 #include "../../shared/util.h"
@@ -54,6 +55,7 @@ public:
 
 private slots:
     void gradient();
+    void roundedRendering();
 
 private:
     QQmlEngine engine;
@@ -93,7 +95,23 @@ void tst_qquickrectangle::gradient()
 
     delete rect;
 }
-
+void tst_qquickrectangle::roundedRendering()
+{
+    QQuickView view;
+    view.setSource(testFileUrl("roundedrect.qml"));
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+    QImage fb = view.grabWindow();
+    QVERIFY(!fb.isNull());
+
+    // Fill, border, and the background outside the rounded corner.
+    QCOMPARE(fb.pixel(50, 50), qRgb(0xff, 0, 0));
+    QCOMPARE(fb.pixel(50, 11), qRgb(0, 0, 0xff));
+    QCOMPARE(fb.pixel(11, 50), qRgb(0, 0, 0xff));
+    QCOMPARE(fb.pixel(11, 11), qRgb(0, 0, 0));
+    QCOMPARE(fb.pixel(88, 88), qRgb(0, 0, 0));
+}
 
 QTEST_MAIN(tst_qquickrectangle)
 
@@ -0,0 +1,16 @@
+import QtQuick 2.3
+
+Column {
+    objectName: "container"
+
+    Repeater {
+        objectName: "repeater"
+        asynchronous: true
+        model: 5
+        Rectangle {
+            objectName: "delegate" + index
+            width: 50
+            height: 10
+        }
+    }
+}
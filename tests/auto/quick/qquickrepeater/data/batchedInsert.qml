@@ -0,0 +1,28 @@
+import QtQuick 2.0
+
+Column {
+    id: container
+    objectName: "container"
+
+    function insertItems(index, count) {
+        for (var i = 0; i < count; ++i)
+            model.insert(index + i, { "name": "inserted" + i })
+    }
+
+    ListModel {
+        id: model
+        ListElement { name: "first" }
+        ListElement { name: "last" }
+    }
+
+    Item { objectName: "before" }
+
+    Repeater {
+        id: repeater
+        objectName: "repeater"
+        model: model
+        Item { objectName: name; width: 10; height: 10 }
+    }
+
+    Item { objectName: "after" }
+}
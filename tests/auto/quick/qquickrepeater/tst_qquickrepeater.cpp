@@ -79,6 +79,8 @@ private slots:
     void initParent();
     void dynamicModelCrash();
     void visualItemModelCrash();
+    void batchedInsert();
+    void asynchronousProperty();
 };
 
 class TestObject : public QObject
@@ -744,6 +746,62 @@ void tst_QQuickRepeater::visualItemModelCrash()
     delete window;
 }
 
+void tst_QQuickRepeater::batchedInsert()
+{
+    QQmlEngine engine;
+    QQmlComponent component(&engine, testFileUrl("batchedInsert.qml"));
+    QScopedPointer<QQuickItem> container(qobject_cast<QQuickItem*>(component.create()));
+    QVERIFY(!container.isNull());
+
+    QQuickRepeater *repeater = findItem<QQuickRepeater>(container.data(), "repeater");
+    QVERIFY(repeater);
+    QCOMPARE(repeater->count(), 2);
+
+    QMetaObject::invokeMethod(container.data(), "insertItems", Q_ARG(QVariant, 1), Q_ARG(QVariant, 3));
+    QCOMPARE(repeater->count(), 5);
+
+    QStringList expected;
+    expected << "before" << "first" << "inserted0" << "inserted1" << "inserted2" << "last" << "repeater" << "after";
+    QStringList names;
+    foreach (QQuickItem *child, container->childItems())
+        names << child->objectName();
+    QCOMPARE(names, expected);
+
+    for (int i = 0; i < repeater->count(); ++i)
+        QCOMPARE(repeater->itemAt(i)->objectName(), expected.at(i + 1));
+}
+
+void tst_QQuickRepeater::asynchronousProperty()
+{
+    QQmlEngine engine;
+    QQmlIncubationController controller;
+    engine.setIncubationController(&controller);
+
+    QQmlComponent component(&engine, testFileUrl("asyncRepeater.qml"));
+    QScopedPointer<QQuickItem> container(qobject_cast<QQuickItem*>(component.create()));
+    QVERIFY(!container.isNull());
+
+    QQuickRepeater *repeater = findItem<QQuickRepeater>(container.data(), "repeater");
+    QVERIFY(repeater);
+    QVERIFY(repeater->asynchronous());
+    QCOMPARE(repeater->count(), 5);
+    QVERIFY(!repeater->itemAt(0));
+
+    // items are created one at a time
+    for (int i = 0; i < 5; ++i) {
+        QVERIFY(!repeater->itemAt(i));
+        while (!repeater->itemAt(i)) {
+            bool b = false;
+            controller.incubateWhile(&b);
+        }
+        QCOMPARE(repeater->itemAt(i)->objectName(), QString("delegate%1").arg(i));
+        QCOMPARE(repeater->itemAt(i)->parentItem(), container.data());
+    }
+
+    QCOMPARE(container->childItems().count(), 6);
+    QCOMPARE(container->childItems().last(), static_cast<QQuickItem*>(repeater));
+}
+
 QTEST_MAIN(tst_QQuickRepeater)
 
 #include "tst_qquickrepeater.moc"
@@ -44,6 +44,8 @@
 #include <QList>
 #include <QByteArray>
 #include <private/qquickshadereffect_p.h>
+#include <private/qquickshadereffectmesh_p.h>
+#include <QtQuick/qsggeometry.h>
 
 #include <QtQuick/QQuickView>
 #include "../../shared/util.h"
@@ -89,6 +91,7 @@ private slots:
 
     void deleteSourceItem();
     void deleteShaderEffectSource();
+    void gridMeshResize();
 
 private:
     enum PresenceFlags {
@@ -315,6 +318,38 @@ void tst_qquickshadereffect::deleteShaderEffectSource()
     delete view;
 }
 
+void tst_qquickshadereffect::gridMeshResize()
+{
+    QVector<QByteArray> attributes;
+    attributes << QByteArray("qt_Vertex") << QByteArray("qt_MultiTexCoord0");
+
+    QQuickGridMesh mesh;
+    mesh.setResolution(QSize(4, 3));
+
+    QSGGeometry *geometry = mesh.updateGeometry(0, attributes, QRectF(0, 0, 100, 50));
+    QVERIFY(geometry);
+
+    // Resizing keeps the geometry and gives the same result as building it
+    // from scratch.
+    QCOMPARE(mesh.updateGeometry(geometry, attributes, QRectF(0, 0, 40, 80)), geometry);
+    QSGGeometry *expected = mesh.updateGeometry(0, attributes, QRectF(0, 0, 40, 80));
+    QVERIFY(expected);
+    QCOMPARE(geometry->vertexCount(), expected->vertexCount());
+    QCOMPARE(geometry->indexCount(), expected->indexCount());
+    QVERIFY(memcmp(geometry->vertexData(), expected->vertexData(),
+                   geometry->vertexCount() * geometry->sizeOfVertex()) == 0);
+    QVERIFY(memcmp(geometry->indexData(), expected->indexData(),
+                   geometry->indexCount() * geometry->sizeOfIndex()) == 0);
+
+    // A new resolution still reallocates.
+    mesh.setResolution(QSize(2, 2));
+    QCOMPARE(mesh.updateGeometry(geometry, attributes, QRectF(0, 0, 40, 80)), geometry);
+    QCOMPARE(geometry->vertexCount(), 9);
+
+    delete expected;
+    delete geometry;
+}
+
 QTEST_MAIN(tst_qquickshadereffect)
 
 #include "tst_qquickshadereffect.moc"
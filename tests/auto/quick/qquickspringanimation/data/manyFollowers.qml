@@ -0,0 +1,25 @@
+import QtQuick 2.0
+
+Item {
+    id: root
+    width: 200
+    height: 200
+
+    property real target: 0
+
+    Repeater {
+        objectName: "repeater"
+        model: 20
+        Rectangle {
+            width: 10
+            height: 10
+            x: root.target
+            y: root.target
+            rotation: root.target
+
+            Behavior on x { SpringAnimation { spring: 2 + index * 0.1; damping: 0.2; epsilon: 0.25 } }
+            Behavior on y { SmoothedAnimation { velocity: 200 + index * 10 } }
+            Behavior on rotation { SpringAnimation { spring: 3; damping: 0.3; modulus: 360; epsilon: 0.25 } }
+        }
+    }
+}
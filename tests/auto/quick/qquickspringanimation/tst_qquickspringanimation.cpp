@@ -43,6 +43,7 @@
 #include <QtQml/qqmlcomponent.h>
 #include <QtQuick/qquickview.h>
 #include <private/qquickspringanimation_p.h>
+#include <private/qquickrepeater_p.h>
 #include <private/qqmlvaluetype_p.h>
 #include "../../shared/util.h"
 
@@ -57,6 +58,7 @@ private slots:
     void values();
     void disabled();
     void inTransition();
+    void manyFollowers();
 
 private:
     QQmlEngine engine;
@@ -138,6 +140,30 @@ void tst_qquickspringanimation::inTransition()
     QTest::qWait(2000);
 }
 
+void tst_qquickspringanimation::manyFollowers()
+{
+    QQuickView view(testFileUrl("manyFollowers.qml"));
+    view.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&view));
+
+    QQuickItem *root = view.rootObject();
+    QVERIFY(root);
+    QQuickRepeater *repeater = root->findChild<QQuickRepeater *>("repeater");
+    QVERIFY(repeater);
+    QCOMPARE(repeater->count(), 20);
+
+    root->setProperty("target", 100);
+
+    // the followers are stepped together at the end of each animation tick
+    // and must still come to rest individually
+    for (int i = 0; i < repeater->count(); ++i) {
+        QQuickItem *item = repeater->itemAt(i);
+        QTRY_COMPARE_WITH_TIMEOUT(item->x(), qreal(100), 10000);
+        QTRY_COMPARE_WITH_TIMEOUT(item->y(), qreal(100), 10000);
+        QTRY_COMPARE_WITH_TIMEOUT(item->rotation(), qreal(100), 10000);
+    }
+}
+
 QTEST_MAIN(tst_qquickspringanimation)
 
 #include "tst_qquickspringanimation.moc"
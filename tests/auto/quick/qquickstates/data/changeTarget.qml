@@ -0,0 +1,21 @@
+import QtQuick 2.0
+Rectangle {
+    id: root
+    width: 100; height: 100
+    color: "red"
+    property Item target: rect1
+
+    Rectangle { id: rect1; objectName: "rect1"; color: "red" }
+    Rectangle { id: rect2; objectName: "rect2"; color: "red" }
+
+    states: [
+        State {
+            name: "blue"
+            PropertyChanges { target: root.target; color: "blue"; width: 10 }
+        },
+        State {
+            name: "green"
+            PropertyChanges { target: root; color: "green" }
+        }
+    ]
+}
@@ -148,6 +148,7 @@ private slots:
     void QTBUG_14830();
     void avoidFastForward();
     void revertListBug();
+    void changeTarget();
 };
 
 void tst_qquickstates::initTestCase()
@@ -1626,6 +1627,49 @@ void tst_qquickstates::revertListBug()
     QCOMPARE(rect2->parentItem(), origParent2); //QTBUG-22583 causes rect2's parent item to be origParent1
 }
 
+void tst_qquickstates::changeTarget()
+{
+    QQmlEngine engine;
+
+    QQmlComponent c(&engine, testFileUrl("changeTarget.qml"));
+    QQuickRectangle *rect = qobject_cast<QQuickRectangle*>(c.create());
+    QVERIFY(rect != 0);
+
+    QQuickRectangle *rect1 = rect->findChild<QQuickRectangle*>("rect1");
+    QQuickRectangle *rect2 = rect->findChild<QQuickRectangle*>("rect2");
+    QVERIFY(rect1 != 0);
+    QVERIFY(rect2 != 0);
+
+    QQuickItemPrivate *rectPrivate = QQuickItemPrivate::get(rect);
+    for (int ii = 0; ii < 3; ++ii) {
+        rectPrivate->setState("blue");
+        QCOMPARE(rect1->color(), QColor("blue"));
+        QCOMPARE(rect1->width(), 10.);
+        QCOMPARE(rect->color(), QColor("red"));
+
+        rectPrivate->setState("green");
+        QCOMPARE(rect1->color(), QColor("red"));
+        QCOMPARE(rect1->width(), 0.);
+        QCOMPARE(rect->color(), QColor("green"));
+    }
+
+    rectPrivate->setState("");
+    QCOMPARE(rect->color(), QColor("red"));
+
+    // the properties resolved for rect1 must not be reused for rect2
+    rect->setProperty("target", QVariant::fromValue<QQuickItem*>(rect2));
+    rectPrivate->setState("blue");
+    QCOMPARE(rect1->color(), QColor("red"));
+    QCOMPARE(rect2->color(), QColor("blue"));
+    QCOMPARE(rect2->width(), 10.);
+
+    rectPrivate->setState("");
+    QCOMPARE(rect2->color(), QColor("red"));
+    QCOMPARE(rect2->width(), 0.);
+
+    delete rect;
+}
+
 QTEST_MAIN(tst_qquickstates)
 
 #include "tst_qquickstates.moc"
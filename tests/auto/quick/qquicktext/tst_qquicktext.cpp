@@ -48,6 +48,7 @@
 #include <private/qquicktext_p_p.h>
 #include <private/qquickvaluetypes_p.h>
 #include <QFontMetrics>
+#include <QFontDatabase>
 #include <qmath.h>
 #include <QtQuick/QQuickView>
 #include <private/qguiapplication_p.h>
@@ -153,6 +154,9 @@ private slots:
     void elideBeforeMaximumLineCount();
 
     void hover();
+    void sharedLayout();
+    void asynchronousLayout_data();
+    void asynchronousLayout();
 
 private:
     QStringList standard;
@@ -738,24 +742,24 @@ void tst_qquicktext::horizontalAlignment_RightToLeft()
     QQuickTextPrivate *textPrivate = QQuickTextPrivate::get(text);
     QVERIFY(textPrivate != 0);
 
-    QTRY_VERIFY(textPrivate->layout.lineCount());
+    QTRY_VERIFY(textPrivate->currentLayout()->lineCount());
 
     // implicit alignment should follow the reading direction of RTL text
     QCOMPARE(text->hAlign(), QQuickText::AlignRight);
     QCOMPARE(text->effectiveHAlign(), text->hAlign());
-    QVERIFY(textPrivate->layout.lineAt(0).naturalTextRect().left() > window->width()/2);
+    QVERIFY(textPrivate->currentLayout()->lineAt(0).naturalTextRect().left() > window->width()/2);
 
     // explicitly left aligned text
     text->setHAlign(QQuickText::AlignLeft);
     QCOMPARE(text->hAlign(), QQuickText::AlignLeft);
     QCOMPARE(text->effectiveHAlign(), text->hAlign());
-    QVERIFY(textPrivate->layout.lineAt(0).naturalTextRect().left() < window->width()/2);
+    QVERIFY(textPrivate->currentLayout()->lineAt(0).naturalTextRect().left() < window->width()/2);
 
     // explicitly right aligned text
     text->setHAlign(QQuickText::AlignRight);
     QCOMPARE(text->hAlign(), QQuickText::AlignRight);
     QCOMPARE(text->effectiveHAlign(), text->hAlign());
-    QVERIFY(textPrivate->layout.lineAt(0).naturalTextRect().left() > window->width()/2);
+    QVERIFY(textPrivate->currentLayout()->lineAt(0).naturalTextRect().left() > window->width()/2);
 
     // change to rich text
     QString textString = text->text();
@@ -788,13 +792,13 @@ void tst_qquicktext::horizontalAlignment_RightToLeft()
     text->setHAlign(QQuickText::AlignHCenter);
     QCOMPARE(text->hAlign(), QQuickText::AlignHCenter);
     QCOMPARE(text->effectiveHAlign(), text->hAlign());
-    QVERIFY(textPrivate->layout.lineAt(0).naturalTextRect().left() < window->width()/2);
-    QVERIFY(textPrivate->layout.lineAt(0).naturalTextRect().right() > window->width()/2);
+    QVERIFY(textPrivate->currentLayout()->lineAt(0).naturalTextRect().left() < window->width()/2);
+    QVERIFY(textPrivate->currentLayout()->lineAt(0).naturalTextRect().right() > window->width()/2);
 
     // reseted alignment should go back to following the text reading direction
     text->resetHAlign();
     QCOMPARE(text->hAlign(), QQuickText::AlignRight);
-    QVERIFY(textPrivate->layout.lineAt(0).naturalTextRect().left() > window->width()/2);
+    QVERIFY(textPrivate->currentLayout()->lineAt(0).naturalTextRect().left() > window->width()/2);
 
     // mirror the text item
     QQuickItemPrivate::get(text)->setLayoutMirror(true);
@@ -802,19 +806,19 @@ void tst_qquicktext::horizontalAlignment_RightToLeft()
     // mirrored implicit alignment should continue to follow the reading direction of the text
     QCOMPARE(text->hAlign(), QQuickText::AlignRight);
     QCOMPARE(text->effectiveHAlign(), QQuickText::AlignRight);
-    QVERIFY(textPrivate->layout.lineAt(0).naturalTextRect().left() > window->width()/2);
+    QVERIFY(textPrivate->currentLayout()->lineAt(0).naturalTextRect().left() > window->width()/2);
 
     // mirrored explicitly right aligned behaves as left aligned
     text->setHAlign(QQuickText::AlignRight);
     QCOMPARE(text->hAlign(), QQuickText::AlignRight);
     QCOMPARE(text->effectiveHAlign(), QQuickText::AlignLeft);
-    QVERIFY(textPrivate->layout.lineAt(0).naturalTextRect().left() < window->width()/2);
+    QVERIFY(textPrivate->currentLayout()->lineAt(0).naturalTextRect().left() < window->width()/2);
 
     // mirrored explicitly left aligned behaves as right aligned
     text->setHAlign(QQuickText::AlignLeft);
     QCOMPARE(text->hAlign(), QQuickText::AlignLeft);
     QCOMPARE(text->effectiveHAlign(), QQuickText::AlignRight);
-    QVERIFY(textPrivate->layout.lineAt(0).naturalTextRect().left() > window->width()/2);
+    QVERIFY(textPrivate->currentLayout()->lineAt(0).naturalTextRect().left() > window->width()/2);
 
     // disable mirroring
     QQuickItemPrivate::get(text)->setLayoutMirror(false);
@@ -823,7 +827,7 @@ void tst_qquicktext::horizontalAlignment_RightToLeft()
     // English text should be implicitly left aligned
     text->setText("Hello world!");
     QCOMPARE(text->hAlign(), QQuickText::AlignLeft);
-    QVERIFY(textPrivate->layout.lineAt(0).naturalTextRect().left() < window->width()/2);
+    QVERIFY(textPrivate->currentLayout()->lineAt(0).naturalTextRect().left() < window->width()/2);
 
     // empty text with implicit alignment follows the system locale-based
     // keyboard input direction from QInputMethod::inputDirection()
@@ -2602,8 +2606,8 @@ void tst_qquicktext::lineLaidOut()
 
     QVERIFY(!textPrivate->extra.isAllocated());
 
-    for (int i = 0; i < textPrivate->layout.lineCount(); ++i) {
-        QRectF r = textPrivate->layout.lineAt(i).rect();
+    for (int i = 0; i < textPrivate->currentLayout()->lineCount(); ++i) {
+        QRectF r = textPrivate->currentLayout()->lineAt(i).rect();
         QVERIFY(r.width() == i * 15);
         if (i >= 30)
             QVERIFY(r.x() == r.width() + 30);
@@ -2633,8 +2637,8 @@ void tst_qquicktext::lineLaidOutRelayout()
     QVERIFY(!textPrivate->extra.isAllocated());
 
     qreal maxH = 0;
-    for (int i = 0; i < textPrivate->layout.lineCount(); ++i) {
-        QRectF r = textPrivate->layout.lineAt(i).rect();
+    for (int i = 0; i < textPrivate->currentLayout()->lineCount(); ++i) {
+        QRectF r = textPrivate->currentLayout()->lineAt(i).rect();
 
         if (r.x() == 0) {
             QCOMPARE(r.y(), i * r.height());
@@ -2758,7 +2762,7 @@ void tst_qquicktext::imgTagsAlign()
     QQuickTextPrivate *textPrivate = QQuickTextPrivate::get(textObject);
     QVERIFY(textPrivate != 0);
 
-    QRectF br = textPrivate->layout.boundingRect();
+    QRectF br = textPrivate->currentLayout()->boundingRect();
     if (align == "bottom")
         QVERIFY(br.y() == imgHeight - br.height());
     else if (align == "middle")
@@ -3765,6 +3769,58 @@ void tst_qquicktext::elideBeforeMaximumLineCount()
     QCOMPARE(item->lineCount(), 2);
 }
 
+void tst_qquicktext::sharedLayout()
+{
+    QQmlComponent component(&engine);
+    component.setData(
+            "import QtQuick 2.0\n"
+            "Item {\n"
+                "Text { objectName: \"first\"; text: \"Status\"; width: 100 }\n"
+                "Text { objectName: \"second\"; text: \"Status\"; width: 100 }\n"
+                "Text { objectName: \"other\"; text: \"Status\"; width: 100; font.bold: true }\n"
+                "Text { objectName: \"wrapped\"; text: \"Status\"; width: 100; wrapMode: Text.Wrap }\n"
+                "Text { objectName: \"elided\"; text: \"Status\"; width: 100; elide: Text.ElideRight }\n"
+            "}", QUrl());
+    QScopedPointer<QObject> object(component.create());
+    QVERIFY(object);
+
+    QQuickText *firstText = object->findChild<QQuickText *>("first");
+    QQuickText *secondText = object->findChild<QQuickText *>("second");
+    QQuickText *wrappedText = object->findChild<QQuickText *>("wrapped");
+    QVERIFY(firstText);
+    QVERIFY(secondText);
+    QVERIFY(wrappedText);
+
+    QQuickTextPrivate *first = QQuickTextPrivate::get(firstText);
+    QQuickTextPrivate *second = QQuickTextPrivate::get(secondText);
+    QQuickTextPrivate *other = QQuickTextPrivate::get(object->findChild<QQuickText *>("other"));
+    QQuickTextPrivate *wrapped = QQuickTextPrivate::get(wrappedText);
+    QQuickTextPrivate *elided = QQuickTextPrivate::get(object->findChild<QQuickText *>("elided"));
+
+    // Text items with the same text, font and width share one layout.
+    QVERIFY(first->sharedLayout);
+    QCOMPARE(first->sharedLayout.data(), second->sharedLayout.data());
+    QCOMPARE(first->currentLayout()->lineCount(), 1);
+    QVERIFY(other->sharedLayout);
+    QVERIFY(other->sharedLayout != first->sharedLayout);
+
+    // Layouts that depend on more than the text and font aren't shared.
+    QVERIFY(!wrapped->sharedLayout);
+    QVERIFY(!elided->sharedLayout);
+    QCOMPARE(wrapped->currentLayout()->lineCount(), 1);
+
+    // Both items have the same geometry as an unshared layout.
+    QCOMPARE(firstText->implicitWidth(), wrappedText->implicitWidth());
+    QCOMPARE(firstText->implicitHeight(), wrappedText->implicitHeight());
+    QCOMPARE(firstText->baselineOffset(), wrappedText->baselineOffset());
+
+    // Changing the text of one item doesn't affect the other.
+    secondText->setText("Status changed");
+    QVERIFY(second->sharedLayout != first->sharedLayout);
+    QCOMPARE(first->currentLayout()->text(), QString("Status"));
+    QCOMPARE(second->currentLayout()->text(), QString("Status changed"));
+}
+
 void tst_qquicktext::hover()
 {   // QTBUG-33842
     QQmlComponent component(&engine, testFile("hover.qml"));
@@ -3792,4 +3848,60 @@ void tst_qquicktext::hover()
 
 QTEST_MAIN(tst_qquicktext)
 
+void tst_qquicktext::asynchronousLayout_data()
+{
+    QTest::addColumn<QString>("properties");
+
+    QTest::newRow("unwrapped") << "";
+    QTest::newRow("unwrapped, right aligned") << "horizontalAlignment: Text.AlignRight";
+    QTest::newRow("wrapped") << "width: 200; wrapMode: Text.Wrap";
+    QTest::newRow("wrapped, centered") << "width: 200; wrapMode: Text.Wrap; horizontalAlignment: Text.AlignHCenter";
+}
+
+void tst_qquicktext::asynchronousLayout()
+{
+    QFETCH(QString, properties);
+
+    QQmlComponent component(&engine);
+    component.setData(
+            "import QtQuick 2.2\n"
+            "Item {\n"
+                "Text { objectName: \"synchronous\"; " + properties.toUtf8() + " }\n"
+                "Text { objectName: \"asynchronous\"; asynchronous: true; " + properties.toUtf8() + " }\n"
+            "}", QUrl());
+    QScopedPointer<QObject> object(component.create());
+    QVERIFY(object);
+
+    QQuickText *synchronousText = object->findChild<QQuickText *>("synchronous");
+    QQuickText *asynchronousText = object->findChild<QQuickText *>("asynchronous");
+    QVERIFY(synchronousText);
+    QVERIFY(asynchronousText);
+    QCOMPARE(asynchronousText->asynchronous(), true);
+
+    QString text;
+    for (int i = 0; i < 2000; ++i)
+        text += QString::fromLatin1("Line %1 of the quick brown fox jumped over the lazy dog\n").arg(i);
+
+    synchronousText->setText(text);
+    asynchronousText->setText(text);
+
+    QQuickTextPrivate *asynchronousPrivate = QQuickTextPrivate::get(asynchronousText);
+    if (!QFontDatabase::supportsThreadedFontRendering())
+        QVERIFY(asynchronousPrivate->layoutBlocks.isEmpty());
+    else
+        QTRY_VERIFY(asynchronousPrivate->layoutBlocks.count() > 1);
+
+    QTRY_COMPARE(asynchronousText->lineCount(), synchronousText->lineCount());
+    QTRY_COMPARE(asynchronousText->implicitHeight(), synchronousText->implicitHeight());
+    QCOMPARE(asynchronousText->implicitWidth(), synchronousText->implicitWidth());
+    QCOMPARE(asynchronousText->contentHeight(), synchronousText->contentHeight());
+    QCOMPARE(asynchronousText->baselineOffset(), synchronousText->baselineOffset());
+
+    // Short text is laid out synchronously.
+    asynchronousText->setText("the quick brown fox");
+    QVERIFY(asynchronousPrivate->layoutBlocks.isEmpty());
+    QVERIFY(!asynchronousPrivate->asyncLayout);
+    QCOMPARE(asynchronousText->lineCount(), 1);
+}
+
 #include "tst_qquicktext.moc"
@@ -0,0 +1,14 @@
+import QtQuick 2.0
+
+Flickable {
+    width: 200
+    height: 100
+    contentWidth: edit.width
+    contentHeight: edit.height
+
+    TextEdit {
+        id: edit
+        objectName: "edit"
+        width: 200
+    }
+}
@@ -52,6 +52,7 @@
 #include <private/qquicktextedit_p.h>
 #include <private/qquicktextedit_p_p.h>
 #include <private/qquicktext_p_p.h>
+#include <private/qquickflickable_p.h>
 #include <QFontMetrics>
 #include <QtQuick/QQuickView>
 #include <QDir>
@@ -205,6 +206,7 @@ private slots:
     void embeddedImages_data();
 
     void emptytags_QTBUG_22058();
+    void virtualisedNodes();
 
 private:
     void simulateKeys(QWindow *window, const QList<Key> &keys);
@@ -5191,6 +5193,55 @@ void tst_qquicktextedit::emptytags_QTBUG_22058()
     QCOMPARE(input->text(), QString("<b>Bold<>"));
 }
 
+static int textNodesWithContent(QQuickTextEditPrivate *edit)
+{
+    int count = 0;
+    foreach (QQuickTextEditPrivate::Node *node, edit->textNodeMap) {
+        if (node->textNode()->childCount() > 0)
+            ++count;
+    }
+    return count;
+}
+
+void tst_qquicktextedit::virtualisedNodes()
+{
+    QQuickView window(testFileUrl("flickableDocument.qml"));
+    QQuickFlickable *flickable = qobject_cast<QQuickFlickable *>(window.rootObject());
+    QVERIFY(flickable);
+    QQuickTextEdit *edit = flickable->findChild<QQuickTextEdit *>("edit");
+    QVERIFY(edit);
+    QQuickTextEditPrivate *editPrivate = QQuickTextEditPrivate::get(edit);
+
+    QString text;
+    for (int i = 0; i < 1000; ++i)
+        text += QString::fromLatin1("Line %1\n").arg(i);
+    edit->setText(text);
+
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+
+    // Only the blocks close to the visible part of the document have content.
+    QTRY_VERIFY(!editPrivate->renderedRegion.isNull());
+    QVERIFY(editPrivate->renderedRegion.contains(QRectF(0, 0, 200, 100)));
+    QVERIFY(textNodesWithContent(editPrivate) > 0);
+    QVERIFY(textNodesWithContent(editPrivate) < 100);
+    QVERIFY(editPrivate->textNodeMap.count() < 100);
+
+    // Scrolling past the rendered region creates the nodes of the blocks coming into view.
+    const qreal contentY = edit->height() / 2;
+    flickable->setContentY(contentY);
+    QTRY_VERIFY(editPrivate->renderedRegion.contains(QRectF(0, contentY, 200, 100)));
+    QVERIFY(textNodesWithContent(editPrivate) > 0);
+    QVERIFY(textNodesWithContent(editPrivate) < 100);
+
+    // Edits above the view move the blocks in view.
+    edit->insert(0, QLatin1String("First\nSecond\n"));
+    QTRY_VERIFY(editPrivate->updateType == QQuickTextEditPrivate::UpdateNone);
+    QVERIFY(editPrivate->renderedRegion.contains(QRectF(0, contentY, 200, 100)));
+    QVERIFY(textNodesWithContent(editPrivate) > 0);
+    QVERIFY(textNodesWithContent(editPrivate) < 100);
+}
+
 QTEST_MAIN(tst_qquicktextedit)
 
 #include "tst_qquicktextedit.moc"
@@ -229,6 +229,7 @@ private slots:
     void maskCharacter_data();
     void maskCharacter();
     void fixup();
+    void validationReused();
 
 private:
     void simulateKey(QWindow *, int key);
@@ -6356,6 +6357,51 @@ void tst_qquicktextinput::fixup()
     QCOMPARE(input->text(), QStringLiteral("ok"));
 }
 
+class CountingValidator : public QValidator
+{
+public:
+    CountingValidator(QObject *parent = 0) : QValidator(parent), count(0) { }
+
+    State validate(QString &input, int &) const
+    {
+        ++count;
+        if (input.endsWith(QLatin1Char(' ')))
+            input.chop(1);
+        return input.isEmpty() ? Intermediate : Acceptable;
+    }
+    void notifyChanged() { emit changed(); }
+
+    mutable int count;
+};
+
+void tst_qquicktextinput::validationReused()
+{
+    QQuickTextInput input;
+    CountingValidator *validator = new CountingValidator(&input);
+    input.setValidator(validator);
+
+    input.setText(QStringLiteral("abc"));
+    QVERIFY(input.hasAcceptableInput());
+    int count = validator->count;
+    QVERIFY(count > 0);
+
+    // the text is unchanged, so neither needs to validate again
+    QVERIFY(input.hasAcceptableInput());
+    QCOMPARE(validator->count, count);
+
+    // a validator that changes the text validates its own output only once
+    input.setText(QStringLiteral("abcd "));
+    QCOMPARE(input.text(), QStringLiteral("abcd"));
+    QCOMPARE(validator->count, count + 2);
+
+    // a changed validator is asked again
+    count = validator->count;
+    validator->notifyChanged();
+    QCOMPARE(validator->count, count + 1);
+    QVERIFY(input.hasAcceptableInput());
+    QCOMPARE(validator->count, count + 1);
+}
+
 QTEST_MAIN(tst_qquicktextinput)
 
 #include "tst_qquicktextinput.moc"
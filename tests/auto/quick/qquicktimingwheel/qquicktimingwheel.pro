@@ -0,0 +1,9 @@
+CONFIG += testcase
+CONFIG += parallel_test
+TARGET = tst_qquicktimingwheel
+macx:CONFIG -= app_bundle
+
+SOURCES += tst_qquicktimingwheel.cpp
+QT += quick-private testlib
+
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
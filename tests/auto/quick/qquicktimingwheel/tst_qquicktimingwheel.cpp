@@ -0,0 +1,171 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtest.h>
+#include <private/qquicktimingwheel_p.h>
+
+class tst_QQuickTimingWheel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void expiry_data();
+    void expiry();
+    void reschedule();
+    void overdue();
+    void nextTime();
+    void timeReset();
+};
+
+void tst_QQuickTimingWheel::expiry_data()
+{
+    QTest::addColumn<int>("time");
+
+    QTest::newRow("first slot") << 10;
+    QTest::newRow("first level") << 63;
+    QTest::newRow("second level") << 64;
+    QTest::newRow("second level end") << 4095;
+    QTest::newRow("third level") << 70000;
+    QTest::newRow("top level") << (1 << 20) + 5;
+    QTest::newRow("beyond the wheel") << (1 << 26) + 17;
+}
+
+void tst_QQuickTimingWheel::expiry()
+{
+    QFETCH(int, time);
+
+    QQuickTimingWheel wheel;
+    QVector<int> expired;
+    wheel.insert(3, time);
+    QCOMPARE(wheel.count(), 1);
+    QCOMPARE(wheel.nextTime(), time);
+
+    wheel.advance(time - 1, &expired);
+    QVERIFY(expired.isEmpty());
+    QVERIFY(wheel.contains(3));
+
+    wheel.advance(time, &expired);
+    QCOMPARE(expired.count(), 1);
+    QCOMPARE(expired.first(), 3);
+    QVERIFY(!wheel.contains(3));
+    QVERIFY(wheel.isEmpty());
+    QCOMPARE(wheel.nextTime(), -1);
+}
+
+void tst_QQuickTimingWheel::reschedule()
+{
+    QQuickTimingWheel wheel;
+    QVector<int> expired;
+    for (int i = 0; i < 100; ++i)
+        wheel.insert(i, 1000 + i * 10);
+    wheel.insert(50, 20);//Moves an existing entry rather than adding one
+    wheel.remove(60);
+    QCOMPARE(wheel.count(), 99);
+    QCOMPARE(wheel.time(50), 20);
+    QCOMPARE(wheel.time(60), -1);
+
+    wheel.advance(2000, &expired);
+    QCOMPARE(expired.count(), 99);
+    QCOMPARE(expired.first(), 50);
+    for (int i = 2; i < expired.count(); ++i)
+        QVERIFY(expired.at(i) > expired.at(i - 1));
+    QVERIFY(!expired.contains(60));
+    QVERIFY(wheel.isEmpty());
+}
+
+void tst_QQuickTimingWheel::overdue()
+{
+    QQuickTimingWheel wheel;
+    QVector<int> expired;
+    wheel.advance(500, &expired);
+    wheel.insert(1, 200);
+    wheel.insert(2, 500);
+    QCOMPARE(wheel.nextTime(), 500);
+
+    wheel.advance(500, &expired);
+    QCOMPARE(expired.count(), 2);
+    QVERIFY(expired.contains(1));
+    QVERIFY(expired.contains(2));
+}
+
+void tst_QQuickTimingWheel::nextTime()
+{
+    QQuickTimingWheel wheel;
+    QVector<int> expired;
+    wheel.insert(0, 90000);
+    wheel.insert(1, 5000);
+    wheel.insert(2, 1 << 25);
+    QCOMPARE(wheel.nextTime(), 5000);
+
+    wheel.advance(5000, &expired);
+    QCOMPARE(expired, QVector<int>() << 1);
+    QCOMPARE(wheel.nextTime(), 90000);
+
+    expired.clear();
+    wheel.advance(1 << 24, &expired);
+    QCOMPARE(expired, QVector<int>() << 0);
+    QCOMPARE(wheel.nextTime(), 1 << 25);
+}
+
+void tst_QQuickTimingWheel::timeReset()
+{
+    QQuickTimingWheel wheel;
+    QVector<int> expired;
+    wheel.advance(10000, &expired);
+    wheel.insert(0, 10100);
+    wheel.insert(1, 300);
+
+    //Going back in time keeps what is scheduled and expires it once the time is reached again
+    wheel.advance(100, &expired);
+    QVERIFY(expired.isEmpty());
+    QCOMPARE(wheel.currentTime(), 100);
+    wheel.advance(300, &expired);
+    QCOMPARE(expired, QVector<int>() << 1);
+    QCOMPARE(wheel.count(), 1);
+
+    wheel.clear();
+    QVERIFY(wheel.isEmpty());
+    QVERIFY(!wheel.contains(0));
+}
+
+QTEST_MAIN(tst_QQuickTimingWheel)
+
+#include "tst_qquicktimingwheel.moc"
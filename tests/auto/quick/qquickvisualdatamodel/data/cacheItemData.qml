@@ -0,0 +1,11 @@
+import QtQuick 2.0
+
+VisualDataModel {
+    cacheItemData: true
+
+    model: myModel
+    delegate: Item {
+        property string first: name
+        property string second: name
+    }
+}
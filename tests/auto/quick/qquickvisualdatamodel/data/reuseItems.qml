@@ -0,0 +1,17 @@
+import QtQuick 2.0
+
+VisualDataModel {
+    id: visualModel
+
+    property int pooledCount: 0
+    property int reusedCount: 0
+
+    model: myModel
+    delegate: Item {
+        property string itemName: name
+        property int itemIndex: index
+
+        VisualDataModel.onPooled: ++visualModel.pooledCount
+        VisualDataModel.onReused: ++visualModel.reusedCount
+    }
+}
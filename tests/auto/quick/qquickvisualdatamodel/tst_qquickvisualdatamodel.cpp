@@ -246,6 +246,25 @@ private:
     Branch trunk;
 };
 
+class FetchCountingModel : public SingleRoleModel
+{
+    Q_OBJECT
+public:
+    FetchCountingModel(const QStringList &list) : SingleRoleModel(list), dataCount(0) {}
+
+    QVariant data(const QModelIndex &index, int role) const {
+        ++dataCount;
+        return SingleRoleModel::data(index, role);
+    }
+
+    mutable int dataCount;
+    QList<QPair<int, int> > prefetched;
+
+public slots:
+    void prefetchRows(const QModelIndex &, int first, int last) {
+        prefetched.append(qMakePair(first, last)); }
+};
+
 class StandardItem : public QObject, public QStandardItem
 {
     Q_OBJECT
@@ -438,6 +457,9 @@ private slots:
     void asynchronousMove_data();
     void asynchronousCancel();
     void invalidContext();
+    void reuseItems();
+    void cacheItemData();
+    void prefetchHint();
 
 private:
     template <int N> void groups_verify(
@@ -4243,6 +4265,148 @@ void tst_qquickvisualdatamodel::invalidContext()
     QVERIFY(!item);
 }
 
+void tst_qquickvisualdatamodel::reuseItems()
+{
+    QQmlEngine engine;
+    QaimModel model;
+    for (int i = 0; i < 8; i++)
+        model.addItem("Item" + QString::number(i), "");
+
+    engine.rootContext()->setContextProperty("myModel", &model);
+
+    QQmlComponent c(&engine, testFileUrl("reuseItems.qml"));
+    QScopedPointer<QQmlDelegateModel> visualModel(qobject_cast<QQmlDelegateModel*>(c.create()));
+    QVERIFY(visualModel);
+
+    QQuickItem *item = qobject_cast<QQuickItem*>(visualModel->object(1, false));
+    QVERIFY(item);
+    QCOMPARE(item->property("itemName").toString(), QString("Item1"));
+
+    QCOMPARE(visualModel->release(item, QQmlInstanceModel::Reusable), QQmlInstanceModel::ReleaseFlags(QQmlInstanceModel::Pooled));
+    QCOMPARE(visualModel->poolSize(), 1);
+    QCOMPARE(visualModel->property("pooledCount").toInt(), 1);
+
+    // The pooled delegate is handed out for a different index
+    QQuickItem *reused = qobject_cast<QQuickItem*>(visualModel->object(5, false));
+    QCOMPARE(reused, item);
+    QCOMPARE(visualModel->poolSize(), 0);
+    QCOMPARE(visualModel->property("reusedCount").toInt(), 1);
+    QCOMPARE(reused->property("itemIndex").toInt(), 5);
+    QCOMPARE(reused->property("itemName").toString(), QString("Item5"));
+
+    // Role changes for the new index still reach the delegate
+    model.modifyItem(5, "Modified", "");
+    QCOMPARE(reused->property("itemName").toString(), QString("Modified"));
+
+    QCOMPARE(visualModel->release(reused), QQmlInstanceModel::ReleaseFlags(QQmlInstanceModel::Destroyed));
+
+    item = qobject_cast<QQuickItem*>(visualModel->object(2, false));
+    QVERIFY(item);
+    visualModel->release(item, QQmlInstanceModel::Reusable);
+    QCOMPARE(visualModel->poolSize(), 1);
+
+    // Items stay in the pool until they have been unused for longer than maxPoolTime
+    visualModel->drainReusableItemsPool(1);
+    QCOMPARE(visualModel->poolSize(), 1);
+    visualModel->drainReusableItemsPool(1);
+    QCOMPARE(visualModel->poolSize(), 0);
+}
+
+void tst_qquickvisualdatamodel::prefetchHint()
+{
+    QQmlEngine engine;
+    QStringList list;
+    for (int i = 0; i < 40; ++i)
+        list << ("Item" + QString::number(i));
+    FetchCountingModel model(list);
+
+    engine.rootContext()->setContextProperty("myModel", &model);
+
+    QQmlComponent c(&engine, testFileUrl("cacheItemData.qml"));
+    QScopedPointer<QQmlDelegateModel> visualModel(qobject_cast<QQmlDelegateModel*>(c.create()));
+    QVERIFY(visualModel);
+
+    // A hint requests the rows from the model without creating any items.
+    visualModel->prefetch(10, 20);
+    QCOMPARE(model.prefetched.count(), 1);
+    QCOMPARE(model.prefetched.at(0), qMakePair(10, 20));
+    QCOMPARE(model.dataCount, 0);
+
+    // Rows already requested aren't requested again.
+    visualModel->prefetch(12, 18);
+    QCOMPARE(model.prefetched.count(), 1);
+
+    // The range is limited to the rows of the model.
+    visualModel->prefetch(30, 50);
+    QCOMPARE(model.prefetched.count(), 2);
+    QCOMPARE(model.prefetched.at(1), qMakePair(30, 39));
+
+    visualModel->prefetch(-5, -1);
+    QCOMPARE(model.prefetched.count(), 2);
+
+    // Creating an item from the hinted block doesn't request it again.
+    QQuickItem *item = qobject_cast<QQuickItem*>(visualModel->object(35, false));
+    QVERIFY(item);
+    QCOMPARE(model.prefetched.count(), 2);
+    visualModel->release(item);
+}
+
+void tst_qquickvisualdatamodel::cacheItemData()
+{
+    QQmlEngine engine;
+    QStringList list;
+    for (int i = 0; i < 40; ++i)
+        list << ("Item" + QString::number(i));
+    FetchCountingModel model(list);
+
+    engine.rootContext()->setContextProperty("myModel", &model);
+
+    QQmlComponent c(&engine, testFileUrl("cacheItemData.qml"));
+    QScopedPointer<QQmlDelegateModel> visualModel(qobject_cast<QQmlDelegateModel*>(c.create()));
+    QVERIFY(visualModel);
+    QCOMPARE(visualModel->cacheItemData(), true);
+
+    // Creating an item requests a block of rows ahead of it.
+    QQuickItem *item = qobject_cast<QQuickItem*>(visualModel->object(4, false));
+    QVERIFY(item);
+    QCOMPARE(model.prefetched.count(), 1);
+    QCOMPARE(model.prefetched.at(0), qMakePair(4, 35));
+
+    // Both bindings read the same role but the model is only queried once.
+    QCOMPARE(item->property("first").toString(), QString("Item4"));
+    QCOMPARE(item->property("second").toString(), QString("Item4"));
+    QCOMPARE(model.dataCount, 1);
+
+    // Rows within the prefetched block don't trigger another request, those before it do.
+    QQuickItem *other = qobject_cast<QQuickItem*>(visualModel->object(20, false));
+    QVERIFY(other);
+    QCOMPARE(model.prefetched.count(), 1);
+    visualModel->release(other);
+
+    other = qobject_cast<QQuickItem*>(visualModel->object(2, false));
+    QVERIFY(other);
+    QCOMPARE(model.prefetched.count(), 2);
+    QCOMPARE(model.prefetched.at(1), qMakePair(0, 2));
+    visualModel->release(other);
+
+    // dataChanged() invalidates the cached value.
+    model.dataCount = 0;
+    model.set(4, "Modified");
+    QCOMPARE(item->property("first").toString(), QString("Modified"));
+    QCOMPARE(item->property("second").toString(), QString("Modified"));
+    QCOMPARE(model.dataCount, 1);
+
+    // Without caching every read queries the model.
+    visualModel->setCacheItemData(false);
+    model.dataCount = 0;
+    model.set(4, "Uncached");
+    QCOMPARE(item->property("first").toString(), QString("Uncached"));
+    QCOMPARE(item->property("second").toString(), QString("Uncached"));
+    QCOMPARE(model.dataCount, 2);
+
+    visualModel->release(item);
+}
+
 QTEST_MAIN(tst_qquickvisualdatamodel)
 
 #include "tst_qquickvisualdatamodel.moc"
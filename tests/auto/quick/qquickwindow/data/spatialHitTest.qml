@@ -0,0 +1,35 @@
+import QtQuick 2.0
+import QtQuick.Window 2.0 as Window
+
+Window.Window {
+    id: root
+    width: 200
+    height: 200
+
+    property int pressedIndex: -1
+    property int hoveredIndex: -1
+
+    Grid {
+        columns: 10
+        Repeater {
+            model: 100
+            Item {
+                width: 20
+                height: 20
+                MouseArea {
+                    anchors.fill: parent
+                    hoverEnabled: true
+                    onPressed: root.pressedIndex = index
+                    onEntered: root.hoveredIndex = index
+                }
+            }
+        }
+    }
+
+    MouseArea {
+        objectName: "movable"
+        width: 20
+        height: 20
+        onPressed: root.pressedIndex = 100
+    }
+}
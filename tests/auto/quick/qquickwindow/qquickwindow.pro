@@ -15,6 +15,7 @@ OTHER_FILES += \
     data/active.qml \
     data/AnimationsWhileHidden.qml \
     data/Headless.qml \
-    data/showHideAnimate.qml
+    data/showHideAnimate.qml \
+    data/spatialHitTest.qml
 
 DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
@@ -44,6 +44,7 @@
 #include <QTouchEvent>
 #include <QtQuick/QQuickItem>
 #include <QtQuick/QQuickWindow>
+#include <QtQuick/QQuickRenderControl>
 #include <QtQml/QQmlEngine>
 #include <QtQml/QQmlComponent>
 #include <QtQuick/private/qquickrectangle_p.h>
@@ -55,6 +56,11 @@
 #include <private/qquickwindow_p.h>
 #include <private/qguiapplication_p.h>
 #include <QRunnable>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+#include <QtQuick/QSGFlatColorMaterial>
+#include <QtQuick/QSGVertexColorMaterial>
 
 struct TouchEventData {
     QEvent::Type type;
@@ -322,6 +328,7 @@ private slots:
 
     void grab_data();
     void grab();
+    void renderControl();
     void multipleWindows();
 
     void animationsWhileHidden();
@@ -355,6 +362,12 @@ private slots:
 
     void testRenderJob();
 
+    void precompileMaterials();
+
+    void spatialHitTest();
+
+    void frameStatistics();
+
 private:
     QTouchDevice *touchDevice;
     QTouchDevice *touchDeviceWithVelocity;
@@ -1042,6 +1055,62 @@ void tst_qquickwindow::grab()
     QCOMPARE((uint) content.convertToFormat(QImage::Format_RGB32).pixel(0, 0), (uint) 0xffff0000);
 }
 
+void tst_qquickwindow::renderControl()
+{
+    QOffscreenSurface surface;
+    surface.create();
+    QOpenGLContext context;
+    QVERIFY(context.create());
+    QVERIFY(context.makeCurrent(&surface));
+
+    QQuickRenderControl control;
+    control.initialize(&context);
+    QCOMPARE(control.openglContext(), &context);
+
+    QOpenGLFramebufferObject fbo(100, 80);
+    QOpenGLFramebufferObject otherFbo(100, 80);
+
+    QQuickWindow first(&control);
+    first.setColor(Qt::red);
+    first.resize(100, 80);
+    first.setRenderTarget(&fbo);
+
+    QQuickWindow second(&control);
+    second.setColor(Qt::blue);
+    second.resize(100, 80);
+    second.setRenderTarget(&otherFbo);
+
+    QSignalSpy sceneChanged(&control, SIGNAL(sceneChanged(QQuickWindow*)));
+    QQuickRectangle *rect = new QQuickRectangle(first.contentItem());
+    rect->setSize(QSizeF(10, 10));
+    rect->setColor(Qt::green);
+    QVERIFY(sceneChanged.count() > 0);
+    QCOMPARE(sceneChanged.last().at(0).value<QQuickWindow *>(), &first);
+
+    // Rendering the second scene while the first one is read back.
+    control.polishItems(&first);
+    control.sync(&first);
+    control.render(&first);
+    control.beginGrab(&first);
+    control.polishItems(&second);
+    control.sync(&second);
+    control.render(&second);
+    QImage firstImage = control.endGrab(&first);
+    QImage secondImage = control.grab(&second);
+
+    QCOMPARE(firstImage.size(), QSize(100, 80));
+    QCOMPARE((uint) firstImage.convertToFormat(QImage::Format_RGB32).pixel(50, 50), (uint) 0xffff0000);
+    QCOMPARE((uint) firstImage.convertToFormat(QImage::Format_RGB32).pixel(5, 5), (uint) 0xff00ff00);
+    QCOMPARE((uint) secondImage.convertToFormat(QImage::Format_RGB32).pixel(50, 50), (uint) 0xff0000ff);
+    QCOMPARE(first.grabWindow().size(), QSize(100, 80));
+    QVERIFY(control.endGrab(&first).isNull());
+
+    QSignalSpy invalidated(&first, SIGNAL(sceneGraphInvalidated()));
+    control.invalidate();
+    QCOMPARE(invalidated.count(), 1);
+    QVERIFY(!control.openglContext());
+}
+
 void tst_qquickwindow::multipleWindows()
 {
     QList<QQuickWindow *> windows;
@@ -1728,6 +1797,107 @@ void tst_qquickwindow::testRenderJob()
     QCOMPARE(RenderJob::deleted, 5);
 }
 
+void tst_qquickwindow::precompileMaterials()
+{
+    QQuickWindow window;
+    window.resize(100, 100);
+
+    QQuickRectangle *rect = new QQuickRectangle(window.contentItem());
+    rect->setSize(QSizeF(100, 100));
+    rect->setColor(Qt::green);
+
+    // Before the scene graph is initialized...
+    window.precompileMaterials(QList<QSGMaterial *>() << new QSGFlatColorMaterial);
+
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+
+    // ... and after
+    window.precompileMaterials(QList<QSGMaterial *>() << new QSGVertexColorMaterial);
+
+    QImage content = window.grabWindow();
+    QCOMPARE((uint) content.convertToFormat(QImage::Format_RGB32).pixel(50, 50), (uint) 0xff00ff00);
+}
+void tst_qquickwindow::spatialHitTest()
+{
+    qputenv("QML_SPATIAL_HIT_TEST", "1");
+    QQmlEngine engine;
+    QQmlComponent component(&engine);
+    component.loadUrl(testFileUrl("spatialHitTest.qml"));
+    QScopedPointer<QQuickWindow> window(qobject_cast<QQuickWindow *>(component.create()));
+    qunsetenv("QML_SPATIAL_HIT_TEST");
+    QVERIFY(window);
+    QVERIFY(QQuickWindowPrivate::get(window.data())->pointerIndex);
+    window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(window.data()));
+
+    // The topmost item under the point gets the press.
+    QTest::mouseClick(window.data(), Qt::LeftButton, 0, QPoint(10, 10));
+    QCOMPARE(window->property("pressedIndex").toInt(), 100);
+    QTest::mouseClick(window.data(), Qt::LeftButton, 0, QPoint(45, 25));
+    QCOMPARE(window->property("pressedIndex").toInt(), 12);
+
+    QTest::mouseMove(window.data(), QPoint(65, 5));
+    QTRY_COMPARE(window->property("hoveredIndex").toInt(), 3);
+    QTest::mouseMove(window.data(), QPoint(65, 185));
+    QTRY_COMPARE(window->property("hoveredIndex").toInt(), 93);
+
+    // Moving an item invalidates the index.
+    QQuickItem *movable = window->contentItem()->findChild<QQuickItem *>("movable");
+    QVERIFY(movable);
+    movable->setPosition(QPointF(100, 100));
+    QTest::mouseClick(window.data(), Qt::LeftButton, 0, QPoint(105, 105));
+    QCOMPARE(window->property("pressedIndex").toInt(), 100);
+    QTest::mouseClick(window.data(), Qt::LeftButton, 0, QPoint(10, 10));
+    QCOMPARE(window->property("pressedIndex").toInt(), 0);
+
+    // So does changing whether an item accepts mouse buttons.
+    movable->setAcceptedMouseButtons(Qt::NoButton);
+    QTest::mouseClick(window.data(), Qt::LeftButton, 0, QPoint(105, 105));
+    QCOMPARE(window->property("pressedIndex").toInt(), 55);
+}
+
+void tst_qquickwindow::frameStatistics()
+{
+    QQmlEngine engine;
+    QQmlComponent component(&engine);
+    component.setData("import QtQuick 2.0\n"
+                      "import QtQuick.Window 2.2\n"
+                      "Window {\n"
+                      "    width: 100; height: 100\n"
+                      "    function swappedFrames() { return frameStatistics().frames }\n"
+                      "    Rectangle { width: 50; height: 50; color: \"red\" }\n"
+                      "}\n", QUrl());
+    QScopedPointer<QQuickWindow> window(qobject_cast<QQuickWindow *>(component.create()));
+    QVERIFY(window);
+    window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(window.data()));
+
+    QTRY_VERIFY(window->frameStatistics().value("frames").toInt() > 0);
+
+    QVariantMap statistics = window->frameStatistics();
+    QCOMPARE(statistics.value("histogramLimits").toList().count(), 7);
+
+    QVariantMap render = statistics.value("render").toMap();
+    QVERIFY(render.value("count").toInt() > 0);
+    int histogramTotal = 0;
+    foreach (const QVariant &bucket, render.value("histogram").toList())
+        histogramTotal += bucket.toInt();
+    QCOMPARE(histogramTotal, render.value("count").toInt());
+    QVERIFY(render.value("maximum").toDouble() >= render.value("average").toDouble());
+    QVERIFY(statistics.value("batches").toMap().value("maximum").toDouble() > 0);
+    QVERIFY(statistics.value("drawCalls").toMap().value("maximum").toDouble() > 0);
+
+    QVariant frames;
+    QVERIFY(QMetaObject::invokeMethod(window.data(), "swappedFrames", Q_RETURN_ARG(QVariant, frames)));
+    QVERIFY(frames.toInt() > 0);
+
+    window->resetFrameStatistics();
+    statistics = window->frameStatistics();
+    QCOMPARE(statistics.value("frames").toInt(), 0);
+    QCOMPARE(statistics.value("render").toMap().value("count").toInt(), 0);
+}
+
 QTEST_MAIN(tst_qquickwindow)
 
 #include "tst_qquickwindow.moc"
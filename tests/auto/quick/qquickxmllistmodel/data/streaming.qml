@@ -0,0 +1,11 @@
+import QtQuick 2.0
+import QtQuick.XmlListModel 2.0
+
+XmlListModel {
+    query: "/feed/item"
+    XmlRole { name: "title"; query: "title/string()" }
+    XmlRole { name: "id"; query: "@id/number()" }
+    XmlRole { name: "author"; query: "author/name/string()" }
+    XmlRole { name: "link"; query: "link/@href/string()" }
+    XmlRole { name: "summary"; query: "summary/string()" }
+}
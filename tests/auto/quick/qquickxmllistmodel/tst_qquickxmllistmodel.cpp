@@ -106,6 +106,7 @@ private slots:
     void selectAncestor();
 
     void roleCrash();
+    void streaming();
 
 private:
     QString errorString(QAbstractItemModel *model) {
@@ -988,6 +989,57 @@ void tst_qquickxmllistmodel::roleCrash()
     delete model;
 }
 
+void tst_qquickxmllistmodel::streaming()
+{
+    const int itemCount = 1000;
+    QString xml = "<feed>";
+    for (int i = 0; i < itemCount; ++i) {
+        xml += "<item id=\"" + QString::number(i) + "\">"
+             + "<title>Item " + QString::number(i) + "</title>"
+             + "<author><name>Author <b>" + QString::number(i % 7) + "</b></name></author>";
+        if (i % 3 == 0)
+            xml += "<link href=\"http://example.com/" + QString::number(i) + "\"/>";
+        if (i % 5 == 0)
+            xml += "<summary><![CDATA[<p>Summary</p>]]></summary>";
+        xml += "</item>";
+    }
+    xml += "</feed>";
+
+    QQmlComponent component(&engine, testFileUrl("streaming.qml"));
+
+    // A plain element path query is read in a single pass and published in batches.
+    QScopedPointer<QAbstractItemModel> streamed(qobject_cast<QAbstractItemModel *>(component.create()));
+    QVERIFY(streamed != 0);
+    QSignalSpy insertedSpy(streamed.data(), SIGNAL(rowsInserted(QModelIndex,int,int)));
+    streamed->setProperty("xml", xml);
+
+    // The predicate requires XPath evaluation.
+    QScopedPointer<QAbstractItemModel> evaluated(qobject_cast<QAbstractItemModel *>(component.create()));
+    QVERIFY(evaluated != 0);
+    evaluated->setProperty("query", "/feed/item[true()]");
+    evaluated->setProperty("xml", xml);
+
+    QTRY_COMPARE(streamed->property("status").toInt(), static_cast<int>(QQuickXmlListModel::Ready));
+    QTRY_COMPARE(evaluated->property("status").toInt(), static_cast<int>(QQuickXmlListModel::Ready));
+
+    QCOMPARE(streamed->rowCount(), itemCount);
+    QCOMPARE(evaluated->rowCount(), itemCount);
+    QVERIFY(insertedSpy.count() > 1);
+
+    const QList<int> roles = streamed->roleNames().keys();
+    for (int i = 0; i < itemCount; ++i) {
+        foreach (int role, roles) {
+            const QVariant value = streamed->data(streamed->index(i, 0), role);
+            const QVariant expected = evaluated->data(evaluated->index(i, 0), role);
+            QCOMPARE(value.toString(), expected.toString());
+        }
+    }
+
+    QCOMPARE(streamed->data(streamed->index(10, 0), Qt::UserRole + 2).toString(), QString("Author 3"));
+    QCOMPARE(streamed->data(streamed->index(5, 0), Qt::UserRole + 4).toString(), QString("<p>Summary</p>"));
+    QCOMPARE(streamed->data(streamed->index(1, 0), Qt::UserRole + 3).toString(), QString());
+}
+
 QTEST_MAIN(tst_qquickxmllistmodel)
 
 #include "tst_qquickxmllistmodel.moc"
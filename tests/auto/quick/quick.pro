@@ -27,6 +27,7 @@ PRIVATETESTS += \
     qquickstates \
     qquicksystempalette \
     qquicktimeline \
+    qquicktimingwheel \
     qquickxmllistmodel
 
 # This test requires the xmlpatterns module
@@ -0,0 +1,99 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.2
+/*
+   The purpose of the test is to verify that content which is hidden
+   behind a large opaque rectangle, or which lies partially outside the
+   window, is still drawn once it becomes visible. In the final stage the
+   cover is moved out of the window, revealing what was behind it.
+
+   #samples: 6
+
+                PixelPos     R    G    B    Error-tolerance
+   #base:        50  50     1.0  1.0  1.0        0.05
+   #base:       120 120     1.0  1.0  1.0        0.05
+   #base:       195 195     0.0  0.0  1.0        0.05
+   #final:       50  50     1.0  0.0  0.0        0.05
+   #final:      120 120     0.0  1.0  0.0        0.05
+   #final:      195 195     0.0  0.0  1.0        0.05
+*/
+
+RenderTestBase
+{
+    Rectangle {
+        x: 0
+        y: 0
+        width: 100
+        height: 100
+        color: "red"
+    }
+
+    Rectangle {
+        x: 100
+        y: 100
+        width: 50
+        height: 50
+        color: "#00ff00"
+    }
+
+    Rectangle {
+        id: cover
+        x: 0
+        y: 0
+        width: 160
+        height: 160
+        color: "white"
+    }
+
+    Rectangle {
+        x: 180
+        y: 180
+        width: 100
+        height: 100
+        color: "blue"
+    }
+
+    onEnterFinalStage: {
+        cover.x = 200;
+        finalStageComplete = true;
+    }
+}
@@ -43,7 +43,9 @@ import QtQuick 2.2
 
 /*
    The purpose of the test is to verify that a batch of more than 64K
-   vertices gets split into multiple drawsets and still rendered correctly.
+   vertices is still rendered correctly, both when it gets split into
+   multiple drawsets for 16-bit indices and when it is drawn in one go
+   with 32-bit indices.
    Both the clipped and unclipped batches have 50.000 rectangles resulting
    in 200.000 vertices in each batch, which should be plenty..
 
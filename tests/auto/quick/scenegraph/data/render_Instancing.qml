@@ -0,0 +1,88 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.2
+
+/*
+   The purpose of the test is to verify that a batch of elements with
+   identical geometry, which the renderer draws as instances of the first
+   element where supported, is rendered correctly. The rectangles are
+   rotated and moved so that every instance has its own transform.
+
+   #samples: 8
+
+                PixelPos     R    G    B    Error-tolerance
+   #base:        10  10     1.0  0.0  0.0        0.05
+   #base:        15 195     1.0  0.0  0.0        0.05
+   #base:       190 190     1.0  0.0  0.0        0.05
+   #base:       195 105     1.0  0.0  0.0        0.05
+   #final:       10  10     0.0  0.0  1.0        0.05
+   #final:       15 195     0.0  0.0  1.0        0.05
+   #final:      190 190     0.0  0.0  1.0        0.05
+   #final:      195 105     0.0  0.0  1.0        0.05
+*/
+
+RenderTestBase
+{
+    id: root
+
+    property color cellColor: "red"
+
+    Grid {
+        width: 200
+        height: 200
+        columns: 10
+        Repeater {
+            model: 10 * 10
+            Rectangle {
+                width: 20
+                height: 20
+                rotation: 90 * (index % 4)
+                color: root.cellColor
+            }
+        }
+    }
+
+    onEnterFinalStage: {
+        cellColor = "blue";
+        finalStageComplete = true;
+    }
+}
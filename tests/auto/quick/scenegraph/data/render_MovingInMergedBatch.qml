@@ -0,0 +1,98 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+import QtQuick 2.2
+/*
+    The purpose of the test is to verify that items in a merged opaque
+    batch which move on their own, which the renderer may draw with a
+    matrix palette instead of uploading the batch again, end up in the
+    right place. There are more items than fit in one palette.
+
+    #samples: 8
+                 PixelPos     R    G    B    Error-tolerance
+    #base:        10  10     0.0  0.0  1.0       0.05
+    #base:       190 150     0.0  0.0  1.0       0.05
+    #base:        10 190     1.0  0.0  0.0       0.05
+    #base:       190 190     0.0  0.0  0.0       0.0
+    #final:       10  10     0.0  0.0  1.0       0.05
+    #final:       50 150     0.0  0.0  0.0       0.0
+    #final:       10 190     0.0  0.0  0.0       0.0
+    #final:      190 190     1.0  0.0  0.0       0.05
+*/
+
+RenderTestBase {
+    id: root
+
+    Repeater {
+        id: cells
+        model: 20
+        Rectangle {
+            x: 40 * (index % 5)
+            y: 40 * Math.floor(index / 5)
+            width: 40
+            height: 40
+            color: "blue"
+        }
+    }
+
+    Rectangle {
+        id: mover
+        x: 0
+        y: 180
+        width: 20
+        height: 20
+        color: "red"
+    }
+
+    SequentialAnimation {
+        id: animation
+        ParallelAnimation {
+            NumberAnimation { target: mover; property: "x"; from: 0; to: 180; duration: 100 }
+            NumberAnimation { id: cellAnimation; property: "y"; from: 120; to: 200; duration: 100 }
+        }
+        PropertyAction { target: root; property: "finalStageComplete"; value: true; }
+    }
+
+    onEnterFinalStage: {
+        cellAnimation.target = cells.itemAt(16);
+        animation.running = true;
+    }
+}
@@ -329,6 +329,10 @@ void tst_SceneGraph::render_data()
           << "data/render_ImageFiltering.qml"
           << "data/render_bug37422.qml"
           << "data/render_OpacityThroughBatchRoot.qml"
+          << "data/render_RotatedMerge.qml"
+          << "data/render_Instancing.qml"
+          << "data/render_Culling.qml"
+          << "data/render_MovingInMergedBatch.qml"
         ;
 
     QRegExp sampleCount("#samples: *(\\d+)");
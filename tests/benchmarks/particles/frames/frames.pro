@@ -0,0 +1,11 @@
+CONFIG += testcase
+TARGET = tst_frames
+SOURCES += tst_frames.cpp
+macx:CONFIG -= app_bundle
+
+testDataFiles.files = data
+testDataFiles.path = .
+DEPLOYMENT += testDataFiles
+
+QT += core-private gui-private  qml-private quick-private quickparticles-private testlib
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
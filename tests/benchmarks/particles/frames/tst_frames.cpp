@@ -0,0 +1,204 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtest.h>
+#include <QtTest/QtTest>
+#include "../../../auto/particles/shared/particlestestsshared.h"
+#include <private/qquickparticlesystem_p.h>
+#include <private/qabstractanimation_p.h>
+#include <QtCore/qatomic.h>
+#include <cstdlib>
+
+/*
+    Measures the cost of a single 16ms frame of a range of particle scenes.
+
+    frame() reports the time per frame through QBENCHMARK, and allocations() reports the
+    number of operator new calls per frame as an event count. Use the usual testlib
+    options for machine readable results, for example "-xml" or "-csv", and
+    "-tickcounter" to measure CPU ticks instead of walltime.
+
+    Scenes marked as rendered also grab the window every frame, so that painter
+    uploads are included. Grabbing adds a constant readback cost per frame.
+*/
+
+static QAtomicInt allocationCount;
+
+void *operator new(size_t size)
+{
+    allocationCount.ref();
+    void *p = malloc(size ? size : 1);
+    if (!p)
+        qBadAlloc();
+    return p;
+}
+
+void operator delete(void *p) throw()
+{
+    free(p);
+}
+
+static const int frameInterval = 16;
+static const int warmupTime = 2500;//Longer than the lifeSpan in the scenes, so they are full
+static const int allocationFrames = 100;
+
+class tst_frames : public QObject
+{
+    Q_OBJECT
+public:
+    tst_frames();
+
+private slots:
+    void initTestCase();
+    void frame();
+    void frame_data();
+    void allocations();
+    void allocations_data();
+
+private:
+    void addScenes();
+    QQuickView *startScene(QQuickParticleSystem **system, int *curTime);
+    void advance(QQuickView *view, QQuickParticleSystem *system, int *curTime);
+};
+
+tst_frames::tst_frames()
+{
+}
+
+void tst_frames::initTestCase()
+{
+    //Ticks ItemParticle's clock by a fixed interval whenever the benchmark advances
+    QUnifiedTimer::instance()->setConsistentTiming(true);
+    QUnifiedTimer::instance()->setTimingInterval(frameInterval);
+}
+
+void tst_frames::addScenes()
+{
+    QTest::addColumn<QString> ("file");
+    QTest::addColumn<int> ("count");
+    QTest::addColumn<bool> ("rendered");
+    QTest::newRow("ImageParticle colour") << "colored.qml" << 5000 << true;
+    QTest::newRow("ImageParticle rotation") << "rotated.qml" << 5000 << true;
+    QTest::newRow("ImageParticle sprites") << "sprites.qml" << 5000 << true;
+    QTest::newRow("ItemParticle") << "itemparticle.qml" << 200 << true;
+    QTest::newRow("CustomAffector") << "customaffector.qml" << 2000 << false;
+    QTest::newRow("TrailEmitter") << "trailemitter.qml" << 2000 << false;
+    QTest::newRow("GroupGoal") << "groupgoal.qml" << 5000 << false;
+    QTest::newRow("stress 50k") << "stress.qml" << 50000 << false;
+    QTest::newRow("stress 100k") << "stress.qml" << 100000 << false;
+    QTest::newRow("stress 250k") << "stress.qml" << 250000 << false;
+    QTest::newRow("stress 500k") << "stress.qml" << 500000 << false;
+}
+
+void tst_frames::frame_data()
+{
+    addScenes();
+}
+
+void tst_frames::allocations_data()
+{
+    addScenes();
+}
+
+QQuickView *tst_frames::startScene(QQuickParticleSystem **system, int *curTime)
+{
+    QFETCH(QString, file);
+    QFETCH(int, count);
+    QQuickView* view = createView(QCoreApplication::applicationDirPath() + "/data/" + file);
+    if (!view)
+        return 0;
+    view->rootObject()->setProperty("count", count);
+    *system = view->rootObject()->findChild<QQuickParticleSystem*>("system");
+    //Pretend we're running, but we manually advance the simulation
+    (*system)->m_running = true;
+    (*system)->m_animation = 0;
+    (*system)->reset();
+
+    *curTime = 1;
+    (*system)->updateCurrentTime(*curTime);//Fixed point and get init out of the way
+    while (*curTime < warmupTime)
+        advance(view, *system, curTime);
+    return view;
+}
+
+void tst_frames::advance(QQuickView *view, QQuickParticleSystem *system, int *curTime)
+{
+    QFETCH(bool, rendered);
+    *curTime += frameInterval;
+    system->updateCurrentTime(*curTime);
+    QUnifiedTimer::instance()->updateAnimationTimers(-1);
+    if (rendered)
+        view->grabWindow();
+}
+
+void tst_frames::frame()
+{
+    QQuickParticleSystem* system = 0;
+    int curTime = 0;
+    QQuickView* view = startScene(&system, &curTime);
+    QVERIFY(view);
+    QVERIFY(system->particleCount > 0);
+
+    QBENCHMARK {
+        advance(view, system, &curTime);
+    }
+    delete view;
+}
+
+void tst_frames::allocations()
+{
+    QQuickParticleSystem* system = 0;
+    int curTime = 0;
+    QQuickView* view = startScene(&system, &curTime);
+    QVERIFY(view);
+
+    int before = allocationCount.load();
+    for (int i = 0; i < allocationFrames; i++)
+        advance(view, system, &curTime);
+    int allocations = allocationCount.load() - before;
+    delete view;
+
+    QTest::setBenchmarkResult(qreal(allocations) / allocationFrames, QTest::Events);
+    QTest::setBenchmarkResult(qreal(allocations) / allocationFrames, QTest::Events); // twice to workaround bug in QTestLib
+}
+
+QTEST_MAIN(tst_frames);
+
+#include "tst_frames.moc"
@@ -2,4 +2,5 @@ TEMPLATE = subdirs
 
 SUBDIRS += \
             emission \
-            affectors
+            affectors \
+            frames
@@ -66,6 +66,8 @@ private slots:
     void basicproperty();
     void creation_data();
     void creation();
+    void dependencies_data();
+    void dependencies();
 
 private:
     QQmlEngine engine;
@@ -184,5 +186,44 @@ void tst_binding::creation()
     }
 }
 
+// Switching between two sets of dependencies drops the guards of one set and
+// creates the guards of the other on every evaluation
+void tst_binding::dependencies_data()
+{
+    QTest::addColumn<QString>("file");
+    QTest::addColumn<QString>("binding");
+    QTest::addColumn<int>("resultA");
+    QTest::addColumn<int>("resultB");
+
+    QTest::newRow("single") << SRCDIR "/data/dependencies.txt" << "flag ? a.value : b.value" << 1 << 2;
+    QTest::newRow("multiple") << SRCDIR "/data/dependencies.txt"
+                              << "flag ? a.value + a.object + a.value * 2 : b.value + b.object + b.value * 2"
+                              << 3 << 6;
+}
+
+void tst_binding::dependencies()
+{
+    QFETCH(QString, file);
+    QFETCH(QString, binding);
+    QFETCH(int, resultA);
+    QFETCH(int, resultB);
+
+    COMPONENT(file, binding);
+
+    MyQmlObject *object = qobject_cast<MyQmlObject *>(c.create());
+    QVERIFY(object != 0);
+    QCOMPARE(object->result(), resultB);
+    object->setProperty("flag", true);
+    QCOMPARE(object->result(), resultA);
+
+    QBENCHMARK {
+        object->setProperty("flag", false);
+        object->setProperty("flag", true);
+    }
+
+    QCOMPARE(object->result(), resultA);
+    delete object;
+}
+
 QTEST_MAIN(tst_binding)
 #include "tst_binding.moc"
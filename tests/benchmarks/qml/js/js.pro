@@ -3,6 +3,7 @@ SUBDIRS = \
         qjsengine \
         qjsvalue \
         qjsvalueiterator \
+        v4workloads \
 
 TRUSTED_BENCHMARKS += \
     qjsvalue \
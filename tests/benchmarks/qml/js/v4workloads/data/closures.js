@@ -0,0 +1,27 @@
+// Creates many closures capturing variables, and calls through them.
+function makeCounter(start) {
+    var count = start;
+    return {
+        increment: function() { return ++count; },
+        get: function() { return count; }
+    };
+}
+
+function compose(f, g) {
+    return function(x) { return f(g(x)); };
+}
+
+function run() {
+    var total = 0;
+    for (var i = 0; i < 2000; ++i) {
+        var counter = makeCounter(i);
+        counter.increment();
+        total += counter.get();
+    }
+    var f = function(x) { return x + 1; };
+    for (var i = 0; i < 20; ++i)
+        f = compose(f, function(x) { return x * 2 % 1000; });
+    for (var i = 0; i < 2000; ++i)
+        total += f(i);
+    return total;
+}
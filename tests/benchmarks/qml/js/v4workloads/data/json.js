@@ -0,0 +1,18 @@
+// Round trips a document of nested objects and arrays through JSON.
+var data = [];
+for (var i = 0; i < 500; ++i) {
+    data.push({
+        id: i,
+        name: "entry " + i,
+        active: i % 3 == 0,
+        ratio: i / 7,
+        tags: ["a", "b", "c" + i],
+        position: { x: i * 2, y: i * 3 }
+    });
+}
+
+function run() {
+    var text = JSON.stringify(data);
+    var parsed = JSON.parse(text);
+    return parsed.length + text.length;
+}
@@ -0,0 +1,24 @@
+// Integer and floating point arithmetic on arrays.
+var size = 64;
+var a = [];
+var b = [];
+for (var i = 0; i < size * size; ++i) {
+    a.push(i % 17 / 3);
+    b.push(i % 13 / 5);
+}
+
+function run() {
+    var c = new Array(size * size);
+    for (var i = 0; i < size; ++i) {
+        for (var j = 0; j < size; ++j) {
+            var sum = 0;
+            for (var k = 0; k < size; ++k)
+                sum += a[i * size + k] * b[k * size + j];
+            c[i * size + j] = sum;
+        }
+    }
+    var hash = 0;
+    for (var i = 0; i < c.length; ++i)
+        hash = (hash * 31 + (c[i] | 0)) & 0xffffff;
+    return hash + Math.sqrt(c[c.length - 1]);
+}
@@ -0,0 +1,22 @@
+// Allocates short-lived objects with a few properties and walks a linked structure.
+function Point(x, y) {
+    this.x = x;
+    this.y = y;
+}
+
+Point.prototype.add = function(other) {
+    return new Point(this.x + other.x, this.y + other.y);
+}
+
+function run() {
+    var sum = new Point(0, 0);
+    var list = null;
+    for (var i = 0; i < 20000; ++i) {
+        sum = sum.add(new Point(i, -i));
+        list = { value: i, next: list };
+    }
+    var count = 0;
+    for (var node = list; node; node = node.next)
+        count += node.value & 1;
+    return sum.x + sum.y + count;
+}
@@ -0,0 +1,16 @@
+// Matches, replaces and splits with regular expressions.
+var lines = [];
+for (var i = 0; i < 1000; ++i)
+    lines.push("2014-" + (i % 12 + 1) + "-" + (i % 28 + 1) + " user" + i + "@example.com value=" + i * 3);
+var text = lines.join("\n");
+
+function run() {
+    var dates = text.match(/\d{4}-\d{1,2}-\d{1,2}/g).length;
+    var mails = 0;
+    var re = /(\w+)@(\w+)\.com/g;
+    while (re.exec(text))
+        ++mails;
+    var replaced = text.replace(/value=(\d+)/g, "v:$1");
+    var words = text.split(/\s+/).length;
+    return dates + mails + replaced.length + words;
+}
@@ -0,0 +1,15 @@
+// Sorts numbers, strings and objects with and without comparison functions.
+var numbers = [];
+var seed = 1;
+for (var i = 0; i < 5000; ++i) {
+    seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+    numbers.push(seed % 100000);
+}
+
+function run() {
+    var sorted = numbers.slice().sort(function(a, b) { return a - b; });
+    var strings = numbers.slice(0, 2000).map(function(n) { return "n" + n; }).sort();
+    var objects = numbers.slice(0, 2000).map(function(n) { return { key: n % 100, value: n }; });
+    objects.sort(function(a, b) { return a.key - b.key || a.value - b.value; });
+    return sorted[0] + sorted[sorted.length - 1] + strings[0].length + objects[0].value;
+}
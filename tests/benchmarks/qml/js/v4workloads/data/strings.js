@@ -0,0 +1,17 @@
+// Builds strings by concatenation and joining, and takes them apart again.
+function run() {
+    var s = "";
+    for (var i = 0; i < 5000; ++i)
+        s += String.fromCharCode(97 + i % 26);
+
+    var parts = [];
+    for (var i = 0; i < 5000; ++i)
+        parts.push("item" + i);
+    var joined = parts.join(",");
+
+    var total = 0;
+    var split = joined.split(",");
+    for (var i = 0; i < split.length; ++i)
+        total += split[i].length + split[i].indexOf("9");
+    return s.length + total + joined.toUpperCase().charCodeAt(10);
+}
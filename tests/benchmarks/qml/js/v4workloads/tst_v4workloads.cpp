@@ -0,0 +1,170 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtest.h>
+#include <QtCore/QFile>
+#include <QtCore/QDebug>
+
+#include <private/qv4engine_p.h>
+#include <private/qv4context_p.h>
+#include <private/qv4script_p.h>
+#include <private/qv4mm_p.h>
+#include <private/qv4isel_moth_p.h>
+#ifdef V4_ENABLE_JIT
+#  include <private/qv4isel_masm_p.h>
+#endif
+
+/* Each workload in data/ defines a run() function, which is called once per
+   benchmark iteration after the file itself was evaluated. */
+class tst_v4workloads : public QObject
+{
+    Q_OBJECT
+public:
+    enum Mode { Jit, Interpreter };
+
+private slots:
+    void workload_data();
+    void workload();
+    void gcPauses_data();
+    void gcPauses();
+
+private:
+    static QV4::EvalISelFactory *createISelFactory(Mode mode);
+    static bool evaluate(QV4::Script *script);
+};
+
+Q_DECLARE_METATYPE(tst_v4workloads::Mode)
+
+QV4::EvalISelFactory *tst_v4workloads::createISelFactory(Mode mode)
+{
+#ifdef V4_ENABLE_JIT
+    if (mode == Jit)
+        return new QV4::JIT::ISelFactory;
+#endif
+    return new QV4::Moth::ISelFactory;
+}
+
+bool tst_v4workloads::evaluate(QV4::Script *script)
+{
+    QV4::ExecutionContext *ctx = script->scope;
+    QV4::Scope scope(ctx);
+    script->parse();
+    if (!scope.engine->hasException)
+        script->run();
+    if (scope.engine->hasException) {
+        QV4::ScopedValue ex(scope, ctx->catchException());
+        qWarning() << ex->toQStringNoThrow();
+        return false;
+    }
+    return true;
+}
+
+void tst_v4workloads::workload_data()
+{
+    QTest::addColumn<QString>("file");
+    QTest::addColumn<Mode>("mode");
+
+    const char *workloads[] = { "objects", "strings", "json", "regexp", "closures", "numeric", "sort" };
+    for (uint i = 0; i < sizeof(workloads) / sizeof(workloads[0]); ++i) {
+        const QString file = QFINDTESTDATA(QStringLiteral("data/%1.js").arg(QLatin1String(workloads[i])));
+#ifdef V4_ENABLE_JIT
+        QTest::newRow(QByteArray(workloads[i]).append(" jit")) << file << Jit;
+#endif
+        QTest::newRow(QByteArray(workloads[i]).append(" interpreter")) << file << Interpreter;
+    }
+}
+
+void tst_v4workloads::workload()
+{
+    QFETCH(QString, file);
+    QFETCH(Mode, mode);
+
+    QFile f(file);
+    QVERIFY(f.open(QIODevice::ReadOnly));
+    const QString source = QString::fromUtf8(f.readAll());
+
+    QV4::ExecutionEngine engine(createISelFactory(mode));
+    QV4::Script script(engine.rootContext, source, file);
+    QVERIFY(evaluate(&script));
+
+    QV4::Script run(engine.rootContext, QStringLiteral("run()"));
+    QVERIFY(evaluate(&run));
+    QBENCHMARK {
+        run.run();
+    }
+    QVERIFY(!engine.hasException);
+}
+
+void tst_v4workloads::gcPauses_data()
+{
+    workload_data();
+}
+
+// Reports the longest collection while running each workload a fixed number of times.
+// The number and total time of the collections are printed alongside.
+void tst_v4workloads::gcPauses()
+{
+    QFETCH(QString, file);
+    QFETCH(Mode, mode);
+
+    QFile f(file);
+    QVERIFY(f.open(QIODevice::ReadOnly));
+    const QString source = QString::fromUtf8(f.readAll());
+
+    QV4::ExecutionEngine engine(createISelFactory(mode));
+    QV4::Script script(engine.rootContext, source, file);
+    QVERIFY(evaluate(&script));
+
+    QV4::Script run(engine.rootContext, QStringLiteral("run()"));
+    QVERIFY(evaluate(&run));
+    engine.memoryManager->resetGCStatistics();
+    for (int i = 0; i < 20; ++i)
+        run.run();
+    QVERIFY(!engine.hasException);
+
+    const QV4::MemoryManager::GCStatistics stats = engine.memoryManager->gcStatistics();
+    qDebug("%u collections, %.3f ms in total", stats.collections, stats.totalPauseTime / 1000000.);
+    QTest::setBenchmarkResult(stats.maxPauseTime / 1000000., QTest::WalltimeMilliseconds);
+    QTest::setBenchmarkResult(stats.maxPauseTime / 1000000., QTest::WalltimeMilliseconds); // twice to workaround bug in QTestLib
+}
+
+QTEST_MAIN(tst_v4workloads)
+#include "tst_v4workloads.moc"
@@ -0,0 +1,15 @@
+CONFIG += testcase
+TEMPLATE = app
+TARGET = tst_bench_v4workloads
+macx:CONFIG -= app_bundle
+
+SOURCES += tst_v4workloads.cpp
+
+testDataFiles.files = data
+testDataFiles.path = .
+DEPLOYMENT += testDataFiles
+
+include($$PWD/../../../../../src/3rdparty/masm/masm-defs.pri)
+
+QT = core-private qml-private testlib
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
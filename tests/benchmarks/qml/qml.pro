@@ -8,8 +8,11 @@ SUBDIRS += \
            pointers \
            qqmlcomponent \
            qqmlimage \
+           qqmllistcompositor \
            qqmlmetaproperty \
+           qsgareaallocator \
            script \
+           startup \
            qmltime \
            js \
            qquickwindow
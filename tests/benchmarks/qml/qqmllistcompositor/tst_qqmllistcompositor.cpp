@@ -0,0 +1,161 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtest.h>
+#include <QtQml/private/qqmllistcompositor_p.h>
+
+typedef QQmlListCompositor C;
+
+class tst_qqmllistcompositor : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_qqmllistcompositor() {}
+
+private slots:
+    void find_data();
+    void find();
+    void findInsertPosition_data();
+    void findInsertPosition();
+    void findAfterEdit_data();
+    void findAfterEdit();
+
+private:
+    void populate(QQmlListCompositor *compositor, int rangeCount);
+};
+
+void tst_qqmllistcompositor::populate(QQmlListCompositor *compositor, int rangeCount)
+{
+    static int list;
+
+    // Discontinuous list indexes prevent the ranges from being merged so the compositor
+    // ends up with one range per append.
+    for (int i = 0; i < rangeCount; ++i)
+        compositor->append(&list, i * 3, 2, C::DefaultFlag | (i % 2 ? int(C::CacheFlag) : 0));
+}
+
+void tst_qqmllistcompositor::find_data()
+{
+    QTest::addColumn<int>("rangeCount");
+
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+}
+
+void tst_qqmllistcompositor::find()
+{
+    QFETCH(int, rangeCount);
+
+    QQmlListCompositor compositor;
+    populate(&compositor, rangeCount);
+
+    const int count = compositor.count(C::Default);
+    int index = 0;
+
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            // Alternate between distant items so the cached iterator is never close to the
+            // requested index.
+            index = (index + count / 2 + 7) % count;
+            compositor.find(C::Default, index);
+        }
+    }
+}
+
+void tst_qqmllistcompositor::findInsertPosition_data()
+{
+    find_data();
+}
+
+void tst_qqmllistcompositor::findInsertPosition()
+{
+    QFETCH(int, rangeCount);
+
+    QQmlListCompositor compositor;
+    populate(&compositor, rangeCount);
+
+    const int count = compositor.count(C::Cache);
+    int index = 0;
+
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            index = (index + count / 2 + 7) % count;
+            compositor.findInsertPosition(C::Cache, index);
+        }
+    }
+}
+
+void tst_qqmllistcompositor::findAfterEdit_data()
+{
+    find_data();
+}
+
+void tst_qqmllistcompositor::findAfterEdit()
+{
+    QFETCH(int, rangeCount);
+
+    QQmlListCompositor compositor;
+    populate(&compositor, rangeCount);
+
+    const int count = compositor.count(C::Default);
+    int index = 0;
+
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            // Toggle the cache flag of an item, which splits or merges ranges around it, and
+            // then look up items far from it.
+            index = (index + count / 2 + 7) % count;
+            C::iterator it = compositor.find(C::Default, index);
+            if (it->inCache())
+                compositor.clearFlags(C::Default, index, 1, C::CacheFlag);
+            else
+                compositor.setFlags(C::Default, index, 1, C::CacheFlag);
+            compositor.find(C::Default, (index + count / 3) % count);
+            compositor.find(C::Default, (index + 2 * count / 3) % count);
+        }
+    }
+}
+
+QTEST_MAIN(tst_qqmllistcompositor)
+
+#include "tst_qqmllistcompositor.moc"
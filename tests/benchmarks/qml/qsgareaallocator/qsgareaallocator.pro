@@ -0,0 +1,9 @@
+CONFIG += testcase
+TEMPLATE = app
+TARGET = tst_qsgareaallocator
+QT += quick-private testlib
+macx:CONFIG -= app_bundle
+
+SOURCES += tst_qsgareaallocator.cpp
+
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
@@ -0,0 +1,214 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtest.h>
+#include <QtQuick/private/qsgareaallocator_p.h>
+
+Q_DECLARE_METATYPE(QSGAreaAllocator::Strategy)
+
+class tst_qsgareaallocator : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_qsgareaallocator() {}
+
+private slots:
+    void fill_data();
+    void fill();
+    void churn_data();
+    void churn();
+    void occupancy_data();
+    void occupancy();
+
+private:
+    void addRows();
+    static QVector<QSize> workload(const QByteArray &name, int count);
+    static int fillAllocator(QSGAreaAllocator *allocator, const QVector<QSize> &sizes,
+                             QVector<QRect> *rects);
+};
+
+/*
+    Distance field glyphs all have the height of a tile and vary in width,
+    images vary in both dimensions. The sizes are deterministic so that runs
+    can be compared.
+ */
+QVector<QSize> tst_qsgareaallocator::workload(const QByteArray &name, int count)
+{
+    QVector<QSize> sizes;
+    sizes.reserve(count);
+    uint seed = 1;
+    for (int i = 0; i < count; ++i) {
+        seed = seed * 1103515245 + 12345;
+        int a = (seed >> 16) & 0x7fff;
+        seed = seed * 1103515245 + 12345;
+        int b = (seed >> 16) & 0x7fff;
+        if (name == "glyphs")
+            sizes << QSize(20 + a % 48, 64);
+        else
+            sizes << QSize(16 + a % 112, 16 + b % 112);
+    }
+    return sizes;
+}
+
+int tst_qsgareaallocator::fillAllocator(QSGAreaAllocator *allocator, const QVector<QSize> &sizes,
+                                        QVector<QRect> *rects)
+{
+    int area = 0;
+    for (int i = 0; i < sizes.size(); ++i) {
+        QRect r = allocator->allocate(sizes.at(i));
+        if (r.isEmpty())
+            break;
+        area += r.width() * r.height();
+        if (rects)
+            rects->append(r);
+    }
+    return area;
+}
+
+void tst_qsgareaallocator::addRows()
+{
+    QTest::addColumn<QSGAreaAllocator::Strategy>("strategy");
+    QTest::addColumn<QByteArray>("load");
+
+    QTest::newRow("tree, glyphs") << QSGAreaAllocator::BinaryTreeStrategy << QByteArray("glyphs");
+    QTest::newRow("guillotine, glyphs") << QSGAreaAllocator::GuillotineStrategy << QByteArray("glyphs");
+    QTest::newRow("tree, images") << QSGAreaAllocator::BinaryTreeStrategy << QByteArray("images");
+    QTest::newRow("guillotine, images") << QSGAreaAllocator::GuillotineStrategy << QByteArray("images");
+}
+
+void tst_qsgareaallocator::fill_data()
+{
+    addRows();
+}
+
+void tst_qsgareaallocator::fill()
+{
+    QFETCH(QSGAreaAllocator::Strategy, strategy);
+    QFETCH(QByteArray, load);
+
+    const QVector<QSize> sizes = workload(load, 4000);
+
+    QBENCHMARK {
+        QSGAreaAllocator allocator(QSize(1024, 1024), strategy);
+        fillAllocator(&allocator, sizes, 0);
+    }
+}
+
+void tst_qsgareaallocator::churn_data()
+{
+    addRows();
+}
+
+/*
+    Releases and reallocates every third entry of a full allocator, the way
+    a glyph cache or an atlas churns as text and delegates come and go.
+ */
+void tst_qsgareaallocator::churn()
+{
+    QFETCH(QSGAreaAllocator::Strategy, strategy);
+    QFETCH(QByteArray, load);
+
+    const QVector<QSize> sizes = workload(load, 4000);
+    QSGAreaAllocator allocator(QSize(1024, 1024), strategy);
+    QVector<QRect> rects;
+    fillAllocator(&allocator, sizes, &rects);
+    QVERIFY(!rects.isEmpty());
+
+    int round = 0;
+    QBENCHMARK {
+        for (int i = round % 3; i < rects.size(); i += 3) {
+            if (!rects.at(i).isEmpty())
+                allocator.deallocate(rects.at(i));
+            QRect r = allocator.allocate(sizes.at((i + round) % sizes.size()));
+            if (r.isEmpty() && !rects.at(i).isEmpty())
+                r = allocator.allocate(rects.at(i).size());
+            rects[i] = r;
+        }
+        ++round;
+    }
+}
+
+void tst_qsgareaallocator::occupancy_data()
+{
+    addRows();
+}
+
+/*
+    Fills the allocator, churns it for a while and then reports how much of
+    it can be filled before the first allocation fails.
+ */
+void tst_qsgareaallocator::occupancy()
+{
+    QFETCH(QSGAreaAllocator::Strategy, strategy);
+    QFETCH(QByteArray, load);
+
+    const QSize size(1024, 1024);
+    const QVector<QSize> sizes = workload(load, 8000);
+    QSGAreaAllocator allocator(size, strategy);
+    QVector<QRect> rects;
+    int area = fillAllocator(&allocator, sizes, &rects);
+    const qreal initial = area / qreal(size.width() * size.height());
+
+    for (int round = 0; round < 20; ++round) {
+        for (int i = round % 3; i < rects.size(); i += 3) {
+            if (rects.at(i).isEmpty())
+                continue;
+            allocator.deallocate(rects.at(i));
+            area -= rects.at(i).width() * rects.at(i).height();
+            rects[i] = QRect();
+        }
+        for (int i = round % 3; i < rects.size(); i += 3) {
+            QRect r = allocator.allocate(sizes.at((i * 7 + round) % sizes.size()));
+            if (r.isEmpty())
+                break;
+            area += r.width() * r.height();
+            rects[i] = r;
+        }
+    }
+    const qreal churned = area / qreal(size.width() * size.height());
+
+    qDebug("occupancy: %.1f%% when filled, %.1f%% after churning", initial * 100, churned * 100);
+}
+
+QTEST_MAIN(tst_qsgareaallocator)
+
+#include "tst_qsgareaallocator.moc"
@@ -0,0 +1,9 @@
+CONFIG += testcase
+TEMPLATE = app
+TARGET = tst_startup
+QT += qml quick testlib core-private qml-private
+macx:CONFIG -= app_bundle
+
+SOURCES += tst_startup.cpp
+
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
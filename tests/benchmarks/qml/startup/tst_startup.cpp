@@ -0,0 +1,244 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtest.h>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QDebug>
+#include <QtQml/QQmlEngine>
+#include <QtQml/QQmlComponent>
+
+#include <private/qqmlengine_p.h>
+#include <private/qqmltypeloader_p.h>
+
+#include <algorithm>
+
+/* Loads a generated application of several modules with a qmldir, QML types
+   and a JavaScript resource each, importing QtQuick and one another, and
+   reports the time of each startup phase. "cold" loads a fresh copy of the
+   application every time, so nothing is found in the compile caches; the
+   files were just written, so they are in the file system cache though.
+   "warm" loads the same copy again after it was loaded once. */
+class tst_startup : public QObject
+{
+    Q_OBJECT
+public:
+    tst_startup() : m_copies(0) {}
+
+    enum Phase {
+        FileIO = QQmlDataLoader::FileIO,
+        Parsing = QQmlDataLoader::Parsing,
+        ImportResolution = QQmlDataLoader::ImportResolution,
+        TypeCompilation = QQmlDataLoader::TypeCompilation,
+        IRBuilding = QQmlDataLoader::IRBuilding,
+        CodeGeneration = QQmlDataLoader::CodeGeneration,
+        Creation = QQmlDataLoader::LoadPhaseCount,
+        Total,
+        PhaseCount
+    };
+
+private slots:
+    void initTestCase();
+    void startup_data();
+    void startup();
+
+private:
+    QString generateApplication();
+    void measure(bool cold);
+
+    enum { ModuleCount = 10, TypesPerModule = 30, Runs = 5 };
+
+    QTemporaryDir m_dir;
+    int m_copies;
+    QString m_warmCopy;
+    // The median times of each phase in milliseconds, for cold and warm loads
+    QHash<bool, QVector<qreal> > m_results;
+};
+
+Q_DECLARE_METATYPE(tst_startup::Phase)
+
+static void writeFile(const QString &fileName, const QString &contents)
+{
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QVERIFY(file.write(contents.toUtf8()) >= 0);
+}
+
+void tst_startup::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    // Keep script units of the cold loads from being cached on disk for the warm ones.
+    qputenv("QML_DISK_CACHE_PATH", QFile::encodeName(m_dir.path() + QLatin1String("/qmlcache")));
+    m_warmCopy = generateApplication();
+}
+
+// Returns the main file of a new copy of the application.
+QString tst_startup::generateApplication()
+{
+    const QString root = m_dir.path() + QStringLiteral("/copy%1").arg(m_copies++);
+    for (int m = 0; m < ModuleCount; ++m) {
+        const QString moduleDir = root + QStringLiteral("/App/Module%1").arg(m);
+        QDir().mkpath(moduleDir);
+
+        QString qmldir = QStringLiteral("module App.Module%1\nUtils 1.0 utils.js\n").arg(m);
+        for (int t = 0; t < TypesPerModule; ++t) {
+            qmldir += QStringLiteral("Type%1 1.0 Type%1.qml\n").arg(t);
+
+            QString type = QStringLiteral("import QtQuick 2.0\n");
+            if (m > 0)
+                type += QStringLiteral("import App.Module%1 1.0 as Previous\n").arg(m - 1);
+            type += QStringLiteral(
+                        "Item {\n"
+                        "    id: root\n"
+                        "    property int value: %1\n"
+                        "    property string label: \"module %2 type %1: \" + value\n"
+                        "    property real ratio: width > 0 ? height / width : 0\n"
+                        "    signal activated(int index)\n"
+                        "    width: Utils.scale(10 + value)\n"
+                        "    height: 20\n"
+                        "    onActivated: value = compute(index)\n"
+                        "    function compute(count) {\n"
+                        "        var sum = 0;\n"
+                        "        for (var i = 0; i < count; ++i)\n"
+                        "            sum += i * value;\n"
+                        "        return sum % 1000;\n"
+                        "    }\n"
+                        "    Rectangle {\n"
+                        "        anchors.fill: parent\n"
+                        "        color: root.value % 2 ? \"red\" : \"blue\"\n"
+                        "        opacity: root.ratio\n"
+                        "    }\n").arg(t).arg(m);
+            // Every type of the previous module is used by exactly one type of this one.
+            if (m > 0)
+                type += QStringLiteral("    Previous.Type%1 { x: root.value; y: root.height }\n").arg(t * 7 % TypesPerModule);
+            type += QStringLiteral("}\n");
+            writeFile(moduleDir + QStringLiteral("/Type%1.qml").arg(t), type);
+        }
+        writeFile(moduleDir + QStringLiteral("/qmldir"), qmldir);
+        writeFile(moduleDir + QStringLiteral("/utils.js"),
+                  QStringLiteral(".pragma library\n"
+                                 "function scale(value) { return value * %1; }\n").arg(m + 1));
+    }
+
+    QString main = QStringLiteral("import QtQuick 2.0\nimport App.Module%1 1.0\nItem {\n").arg(ModuleCount - 1);
+    for (int t = 0; t < TypesPerModule; ++t)
+        main += QStringLiteral("    Type%1 {}\n").arg(t);
+    main += QStringLiteral("}\n");
+    writeFile(root + QStringLiteral("/main.qml"), main);
+    return root + QStringLiteral("/main.qml");
+}
+
+void tst_startup::measure(bool cold)
+{
+    QVector<QVector<qreal> > samples(PhaseCount);
+    if (!cold) {
+        // Load the warm copy once, so that it is found in the caches.
+        QQmlEngine engine;
+        engine.addImportPath(QFileInfo(m_warmCopy).path());
+        QQmlComponent component(&engine, QUrl::fromLocalFile(m_warmCopy));
+        delete component.create();
+    }
+
+    for (int run = 0; run < Runs; ++run) {
+        const QString file = cold ? generateApplication() : m_warmCopy;
+
+        QElapsedTimer timer;
+        timer.start();
+        QQmlEngine engine;
+        engine.addImportPath(QFileInfo(file).path());
+        QQmlComponent component(&engine, QUrl::fromLocalFile(file));
+        QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+        const qint64 loaded = timer.nsecsElapsed();
+        QObject *object = component.create();
+        const qint64 created = timer.nsecsElapsed();
+        QVERIFY(object);
+        delete object;
+
+        QQmlTypeLoader &typeLoader = QQmlEnginePrivate::get(&engine)->typeLoader;
+        for (int phase = 0; phase < QQmlDataLoader::LoadPhaseCount; ++phase)
+            samples[phase].append(typeLoader.loadPhaseTime(QQmlDataLoader::LoadPhase(phase)) / 1000000.);
+        samples[Creation].append((created - loaded) / 1000000.);
+        samples[Total].append(created / 1000000.);
+    }
+
+    QVector<qreal> medians(PhaseCount);
+    for (int phase = 0; phase < PhaseCount; ++phase) {
+        std::sort(samples[phase].begin(), samples[phase].end());
+        medians[phase] = samples[phase].at(Runs / 2);
+    }
+    m_results.insert(cold, medians);
+}
+
+void tst_startup::startup_data()
+{
+    QTest::addColumn<bool>("cold");
+    QTest::addColumn<Phase>("phase");
+
+    const char *phases[] = { "file I/O", "parsing", "import resolution", "type compilation",
+                             "IR building", "code generation", "creation", "total" };
+    for (int cold = 1; cold >= 0; --cold) {
+        for (int phase = 0; phase < PhaseCount; ++phase) {
+            QTest::newRow(QByteArray(cold ? "cold " : "warm ").append(phases[phase]))
+                    << bool(cold) << Phase(phase);
+        }
+    }
+}
+
+// The loads are measured once per cache state, each row reports one of the phases.
+void tst_startup::startup()
+{
+    QFETCH(bool, cold);
+    QFETCH(Phase, phase);
+
+    if (!m_results.contains(cold))
+        measure(cold);
+    QVERIFY(m_results.contains(cold));
+
+    const qreal time = m_results.value(cold).at(phase);
+    QTest::setBenchmarkResult(time, QTest::WalltimeMilliseconds);
+    QTest::setBenchmarkResult(time, QTest::WalltimeMilliseconds); // twice to workaround bug in QTestLib
+}
+
+QTEST_MAIN(tst_startup)
+#include "tst_startup.moc"
@@ -0,0 +1,231 @@
+/****************************************************************************
+**
+** Copyright (C) 2014 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the tools applications of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <private/qqmlirbuilder_p.h>
+#include <private/qv4engine_p.h>
+#include <private/qv4script_p.h>
+#include <private/qv4isel_moth_p.h>
+#include <QtQml/QQmlEngine>
+#include <QtQml/QQmlComponent>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QStringList>
+#include <QtCore/QUrl>
+#include <iostream>
+
+static void printError(const QString &fileName, int line, int column, const QString &message)
+{
+    std::cerr << qPrintable(fileName) << ':' << line << ':' << column << ": error: "
+              << qPrintable(message) << std::endl;
+}
+
+static void printErrors(const QList<QQmlError> &errors)
+{
+    foreach (const QQmlError &error, errors) {
+        const QString fileName = error.url().isLocalFile() ? error.url().toLocalFile() : error.url().toString();
+        printError(fileName, error.line(), error.column(), error.description());
+    }
+}
+
+static bool readSource(const QString &fileName, QString *source)
+{
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly)) {
+        std::cerr << "qmlcachegen: cannot open " << qPrintable(fileName) << ": "
+                  << qPrintable(file.errorString()) << std::endl;
+        return false;
+    }
+    *source = QString::fromUtf8(file.readAll());
+    return true;
+}
+
+// Compiles a JavaScript import into a unit that QQmlScriptBlob loads instead of the source.
+static bool compileJavaScript(QV4::ExecutionEngine *engine, const QString &fileName, const QString &outputFileName)
+{
+    QString source;
+    if (!readSource(fileName, &source))
+        return false;
+
+    const QUrl url = QUrl::fromLocalFile(QFileInfo(fileName).absoluteFilePath());
+
+    QmlIR::Document irUnit(/*debugMode*/false);
+    QQmlJS::DiagnosticMessage metaDataError;
+    irUnit.extractScriptMetaData(source, &metaDataError);
+    if (!metaDataError.message.isEmpty()) {
+        printError(fileName, metaDataError.loc.startLine, metaDataError.loc.startColumn, metaDataError.message);
+        return false;
+    }
+
+    // Precompiled units always contain interpreter code, see CompilationUnit::savePrecompiled().
+    QV4::Moth::ISelFactory interpreterFactory;
+    QList<QQmlError> errors;
+    QV4::CompiledData::CompilationUnit *unit = QV4::Script::precompile(&irUnit.jsModule, &irUnit.jsGenerator, engine, url, source,
+                                                                      &errors, &interpreterFactory);
+    if (unit)
+        unit->ref();
+    if (!errors.isEmpty() || !unit) {
+        printErrors(errors);
+        if (unit)
+            unit->deref();
+        return false;
+    }
+
+    QmlIR::QmlUnitGenerator qmlGenerator;
+    QV4::CompiledData::QmlUnit *qmlUnit = qmlGenerator.generate(irUnit);
+    // The js unit owns the data and will free the qml unit.
+    unit->data = &qmlUnit->header;
+
+    QString error;
+    const bool saved = unit->savePrecompiled(outputFileName, &error);
+    if (!saved)
+        std::cerr << "qmlcachegen: cannot write " << qPrintable(outputFileName) << ": " << qPrintable(error) << std::endl;
+    unit->deref();
+    return saved;
+}
+
+// QML documents are validated at build time only; they are still loaded from source at run time.
+static bool checkQmlDocument(QQmlEngine *engine, const QString &fileName)
+{
+    QString source;
+    if (!readSource(fileName, &source))
+        return false;
+
+    const QString urlString = QUrl::fromLocalFile(QFileInfo(fileName).absoluteFilePath()).toString();
+    QmlIR::Document document(/*debugMode*/false);
+    QmlIR::IRBuilder builder((QSet<QString>()));
+    if (!builder.generateFromQml(source, urlString, urlString, &document)) {
+        foreach (const QQmlJS::DiagnosticMessage &message, builder.errors)
+            printError(fileName, message.loc.startLine, message.loc.startColumn, message.message);
+        return false;
+    }
+
+    if (!engine)
+        return true;
+
+    QQmlComponent component(engine, QUrl(urlString), QQmlComponent::PreferSynchronous);
+    if (component.isError()) {
+        printErrors(component.errors());
+        return false;
+    }
+    return true;
+}
+
+static void showHelp()
+{
+    std::cerr << "Usage: qmlcachegen [options] <file>..." << std::endl
+              << std::endl
+              << "Compiles JavaScript files (.js) to precompiled units (.jsc) and checks" << std::endl
+              << "QML documents (.qml) for errors." << std::endl
+              << std::endl
+              << "Options:" << std::endl
+              << "  -o <file>        Write the precompiled unit of the only input file to <file>" << std::endl
+              << "  -I <path>        Add <path> to the import paths, implies --check-types" << std::endl
+              << "  --check-types    Resolve the types used by QML documents against their imports" << std::endl
+              << "  --help           Show this help" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QStringList args = app.arguments();
+    args.removeFirst();
+
+    QString outputFileName;
+    QStringList importPaths;
+    QStringList fileNames;
+    bool checkTypes = false;
+
+    while (!args.isEmpty()) {
+        const QString arg = args.takeFirst();
+        if (arg == QLatin1String("--help") || arg == QLatin1String("-h")) {
+            showHelp();
+            return 0;
+        } else if (arg == QLatin1String("-o") && !args.isEmpty()) {
+            outputFileName = args.takeFirst();
+        } else if (arg == QLatin1String("-I") && !args.isEmpty()) {
+            importPaths.append(args.takeFirst());
+            checkTypes = true;
+        } else if (arg == QLatin1String("--check-types")) {
+            checkTypes = true;
+        } else if (arg.startsWith(QLatin1Char('-'))) {
+            std::cerr << "qmlcachegen: unknown option " << qPrintable(arg) << std::endl;
+            showHelp();
+            return 1;
+        } else {
+            fileNames.append(arg);
+        }
+    }
+
+    if (fileNames.isEmpty() || (!outputFileName.isEmpty() && fileNames.count() != 1)) {
+        showHelp();
+        return 1;
+    }
+
+    // Type checking must not populate the disk cache of the machine the build runs on.
+    qputenv("QML_DISABLE_DISK_CACHE", "1");
+
+    QV4::ExecutionEngine v4;
+    QScopedPointer<QQmlEngine> qmlEngine;
+    if (checkTypes) {
+        qmlEngine.reset(new QQmlEngine);
+        foreach (const QString &path, importPaths)
+            qmlEngine->addImportPath(path);
+    }
+
+    bool ok = true;
+    foreach (const QString &fileName, fileNames) {
+        if (fileName.endsWith(QLatin1String(".js"))) {
+            const QString output = outputFileName.isEmpty()
+                    ? QV4::CompiledData::CompilationUnit::precompiledFilePath(fileName) : outputFileName;
+            ok &= compileJavaScript(&v4, fileName, output);
+        } else if (fileName.endsWith(QLatin1String(".qml"))) {
+            ok &= checkQmlDocument(qmlEngine.data(), fileName);
+        } else {
+            std::cerr << "qmlcachegen: don't know how to compile " << qPrintable(fileName) << std::endl;
+            ok = false;
+        }
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,7 @@
+QT       = core qml-private core-private
+CONFIG  += no_import_scan
+DEFINES += QT_NO_CAST_TO_ASCII QT_NO_CAST_FROM_ASCII
+
+SOURCES += main.cpp
+
+load(qt_tool)
@@ -44,6 +44,7 @@
 #include <private/qqmljsast_p.h>
 #include <private/qv4codegen_p.h>
 #include <private/qqmlpool_p.h>
+#include <private/qqmldirparser_p.h>
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDir>
@@ -59,6 +60,7 @@
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QLibraryInfo>
+#include <QtCore/QUrl>
 
 #include <iostream>
 
@@ -71,6 +73,8 @@ void printUsage(const QString &appName)
     std::cerr << qPrintable(QString::fromLatin1(
                                  "Usage: %1 -rootPath path/to/app/qml/directory -importPath path/to/qt/qml/directory \n"
                                  "       %1 -qmlFiles file1 file2 -importPath path/to/qt/qml/directory \n"
+                                 "Options: -dependencyGraph file   write the file-level dependency graph as JSON \n"
+                                 "         -prefetchManifest file  write the files in load order, for QML_PREFETCH_MANIFEST \n"
                                  "Example: %1 -rootPath . -importPath /home/user/dev/qt-install/qml \n").arg(
                                  appName));
 }
@@ -321,6 +325,251 @@ QVariantList findQmlImportsRecursively(const QStringList &qmlDirs, const QString
     return ret;
 }
 
+// Collect the type names of all object declarations in a document
+class TypeNameCollector : public QQmlJS::AST::Visitor
+{
+public:
+    QStringList typeNames;
+
+    bool visit(QQmlJS::AST::UiObjectDefinition *node)
+    {
+        addTypeName(node->qualifiedTypeNameId);
+        return true;
+    }
+
+    bool visit(QQmlJS::AST::UiObjectBinding *node)
+    {
+        addTypeName(node->qualifiedTypeNameId);
+        return true;
+    }
+
+private:
+    void addTypeName(QQmlJS::AST::UiQualifiedId *id)
+    {
+        QString name;
+        for (; id; id = id->next) {
+            name.append(id->name);
+            name.append(QLatin1Char('.'));
+        }
+        name.chop(1); // remove trailing "."
+        if (!name.isEmpty() && !typeNames.contains(name))
+            typeNames.append(name);
+    }
+};
+
+// A directory or module import, as far as type name lookup is concerned
+struct TypeImport
+{
+    QString qualifier;
+    QString path;
+    QQmlDirComponents components; // empty for directory imports
+};
+
+// Find the file declaring typeName in imports, or return an empty string for C++ types.
+QString resolveQmlType(const QString &typeName, const QString &qualifier, const QList<TypeImport> &imports)
+{
+    foreach (const TypeImport &import, imports) {
+        if (import.qualifier != qualifier)
+            continue;
+        if (import.components.isEmpty()) {
+            QString candidatePath = import.path + QLatin1Char('/') + typeName + QStringLiteral(".qml");
+            if (QFileInfo(candidatePath).isFile())
+                return candidatePath;
+        } else {
+            QQmlDirComponents::const_iterator it = import.components.constFind(typeName);
+            if (it != import.components.constEnd() && !it->fileName.isEmpty())
+                return QDir::cleanPath(import.path + QLatin1Char('/') + it->fileName);
+        }
+    }
+    return QString();
+}
+
+void addDependency(QVariantList *dependencies, const QString &type, const QString &path)
+{
+    QVariantMap dependency;
+    dependency[QStringLiteral("type")] = type;
+    dependency[QStringLiteral("path")] = path;
+    if (!dependencies->contains(dependency))
+        dependencies->append(dependency);
+}
+
+// Find the files a qml file needs when it is loaded: the qmldir files, plugins and scripts of
+// the imported modules, imported scripts and the qml files of the types used.
+QVariantList findDependenciesOfQmlFile(const QString &qmlFilePath)
+{
+    QVariantList dependencies;
+
+    QFile qmlFile(qmlFilePath);
+    if (!qmlFile.open(QIODevice::ReadOnly))
+        return dependencies; // already reported by findQmlImportsInFile()
+    QString code = QString::fromUtf8(qmlFile.readAll());
+
+    QQmlJS::Engine engine;
+    QQmlJS::Lexer lexer(&engine);
+    lexer.setCode(code, /*line = */ 1);
+    QQmlJS::Parser parser(&engine);
+    if (!parser.parse() || !parser.diagnosticMessages().isEmpty())
+        return dependencies;
+
+    const QString directory = QFileInfo(qmlFilePath).absolutePath();
+
+    // the implicit import of the file's own directory comes first
+    QList<TypeImport> typeImports;
+    TypeImport implicitImport;
+    implicitImport.path = directory;
+    typeImports.append(implicitImport);
+
+    for (QQmlJS::AST::UiHeaderItemList *headerItemIt = parser.ast()->headers; headerItemIt; headerItemIt = headerItemIt->next) {
+        QQmlJS::AST::UiImport *importNode = QQmlJS::AST::cast<QQmlJS::AST::UiImport *>(headerItemIt->headerItem);
+        if (!importNode)
+            continue;
+
+        TypeImport typeImport;
+        typeImport.qualifier = importNode->importId.toString();
+
+        if (!importNode->fileName.isEmpty()) {
+            QString path = QDir::cleanPath(directory + QLatin1Char('/') + importNode->fileName.toString());
+            if (path.endsWith(QStringLiteral(".js"))) {
+                addDependency(&dependencies, QStringLiteral("js"), path);
+            } else {
+                typeImport.path = path;
+                typeImports.append(typeImport);
+            }
+            continue;
+        }
+
+        QString uri;
+        for (QQmlJS::AST::UiQualifiedId *id = importNode->importUri; id; id = id->next) {
+            uri.append(id->name);
+            uri.append(QLatin1Char('.'));
+        }
+        uri.chop(1); // remove trailing "."
+        QString modulePath = resolveImportPath(uri, code.mid(importNode->versionToken.offset, importNode->versionToken.length));
+        if (modulePath.isEmpty())
+            continue;
+
+        QString qmldirPath = modulePath + QStringLiteral("/qmldir");
+        QFile qmldirFile(qmldirPath);
+        if (!qmldirFile.open(QIODevice::ReadOnly | QIODevice::Text))
+            continue;
+        QQmlDirParser qmldir;
+        qmldir.parse(QString::fromUtf8(qmldirFile.readAll()));
+        addDependency(&dependencies, QStringLiteral("qmldir"), qmldirPath);
+
+        // The plugin loader resolves the platform specific library prefix and suffix
+        foreach (const QQmlDirParser::Plugin &plugin, qmldir.plugins()) {
+            QString pluginDirectory = plugin.path.isEmpty() ? modulePath : QDir(modulePath).absoluteFilePath(plugin.path);
+            addDependency(&dependencies, QStringLiteral("plugin"),
+                          QDir::cleanPath(pluginDirectory + QLatin1Char('/') + plugin.name));
+        }
+        foreach (const QQmlDirParser::Script &script, qmldir.scripts()) {
+            addDependency(&dependencies, QStringLiteral("js"),
+                          QDir::cleanPath(modulePath + QLatin1Char('/') + script.fileName));
+        }
+
+        typeImport.path = modulePath;
+        typeImport.components = qmldir.components();
+        if (!typeImport.components.isEmpty())
+            typeImports.append(typeImport);
+    }
+
+    TypeNameCollector collector;
+    parser.ast()->accept(&collector);
+    foreach (const QString &name, collector.typeNames) {
+        QString qualifier;
+        QString typeName = name;
+        int dot = name.indexOf(QLatin1Char('.'));
+        if (dot != -1) {
+            qualifier = name.left(dot);
+            typeName = name.mid(dot + 1);
+        }
+        if (typeName.isEmpty() || typeName.at(0).isLower())
+            continue; // grouped property, such as anchors { }
+        QString path = resolveQmlType(typeName, qualifier, typeImports);
+        if (!path.isEmpty() && QFileInfo(path) != QFileInfo(qmlFilePath))
+            addDependency(&dependencies, QStringLiteral("qml"), path);
+    }
+
+    return dependencies;
+}
+
+// Build the file-level dependency graph of the root set of qml files. The files are visited
+// breadth first, so that each file is listed before the files it needs, in the order the type
+// loader discovers them. Each node lists the direct dependencies of the file.
+QVariantList findDependencyGraph(const QStringList &qmlDirs, const QStringList &qmlFiles)
+{
+    QStringList roots = qmlFiles;
+    foreach (const QString &qmlDir, qmlDirs) {
+        QDirIterator iterator(qmlDir, QDirIterator::Subdirectories);
+        while (iterator.hasNext()) {
+            QString path = iterator.next();
+            if (path.endsWith(QStringLiteral(".qml")))
+                roots.append(path);
+        }
+    }
+
+    QStringList toVisit;
+    QSet<QString> listed;
+    foreach (const QString &root, roots) {
+        QString path = QDir::cleanPath(QFileInfo(root).absoluteFilePath());
+        if (!listed.contains(path)) {
+            listed.insert(path);
+            toVisit.append(path);
+        }
+    }
+
+    QVariantList graph;
+    for (int i = 0; i < toVisit.count(); ++i) {
+        QString path = toVisit.at(i);
+        QVariantList dependencies = findDependenciesOfQmlFile(path);
+
+        QVariantMap node;
+        node[QStringLiteral("type")] = QStringLiteral("qml");
+        node[QStringLiteral("path")] = path;
+        node[QStringLiteral("dependencies")] = dependencies;
+        graph.append(node);
+
+        foreach (const QVariant &dependencyVariant, dependencies) {
+            QVariantMap dependency = qvariant_cast<QVariantMap>(dependencyVariant);
+            QString dependencyPath = dependency.value(QStringLiteral("path")).toString();
+            if (listed.contains(dependencyPath))
+                continue;
+            listed.insert(dependencyPath);
+            if (dependency.value(QStringLiteral("type")) == QStringLiteral("qml")) {
+                toVisit.append(dependencyPath);
+            } else {
+                dependency[QStringLiteral("dependencies")] = QVariantList();
+                graph.append(dependency);
+            }
+        }
+    }
+    return graph;
+}
+
+// Write the files of the graph in load order. Files below baseDirectory are written relative to
+// it, as the type loader resolves them against the URL of the first document.
+bool writePrefetchManifest(const QString &fileName, const QVariantList &graph, const QString &baseDirectory)
+{
+    QFile manifest(fileName);
+    if (!manifest.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+        std::cerr << "Cannot open output file " << QDir::toNativeSeparators(fileName).toStdString()
+                  << ':' << manifest.errorString().toStdString() << std::endl;
+        return false;
+    }
+
+    manifest.write("# QML_PREFETCH_MANIFEST written by qmlimportscanner\n");
+    QDir base(baseDirectory);
+    foreach (const QVariant &nodeVariant, graph) {
+        QVariantMap node = qvariant_cast<QVariantMap>(nodeVariant);
+        QString path = node.value(QStringLiteral("path")).toString();
+        QString location = base.relativeFilePath(path);
+        if (baseDirectory.isEmpty() || location.startsWith(QStringLiteral("..")))
+            location = QUrl::fromLocalFile(path).toString();
+        manifest.write(node.value(QStringLiteral("type")).toString().toUtf8() + ' ' + location.toUtf8() + '\n');
+    }
+    return true;
+}
+
 int main(int argc, char *argv[])
 {
     QCoreApplication app(argc, argv);
@@ -334,6 +583,8 @@ int main(int argc, char *argv[])
     QStringList qmlRootPaths;
     QStringList qmlFiles;
     QStringList qmlImportPaths;
+    QStringList dependencyGraphFile;
+    QStringList prefetchManifestFile;
 
     int i = 1;
     while (i < args.count()) {
@@ -354,6 +605,14 @@ int main(int argc, char *argv[])
             if (i >= args.count())
                 std::cerr << "-importPath requires an argument\n";
             argReceiver = &qmlImportPaths;
+        } else if (arg == QLatin1String("-dependencyGraph")) {
+            if (i >= args.count())
+                std::cerr << "-dependencyGraph requires an argument\n";
+            argReceiver = &dependencyGraphFile;
+        } else if (arg == QLatin1String("-prefetchManifest")) {
+            if (i >= args.count())
+                std::cerr << "-prefetchManifest requires an argument\n";
+            argReceiver = &prefetchManifestFile;
         } else {
             std::cerr << "Invalid argument: \"" << qPrintable(arg) << "\"\n";
             return 1;
@@ -376,5 +635,29 @@ int main(int argc, char *argv[])
     // Convert to JSON
     QByteArray json = QJsonDocument(QJsonArray::fromVariantList(imports)).toJson();
     std::cout << json.constData() << std::endl;
+
+    if (dependencyGraphFile.isEmpty() && prefetchManifestFile.isEmpty())
+        return 0;
+
+    QVariantList graph = findDependencyGraph(qmlRootPaths, qmlFiles);
+    if (!dependencyGraphFile.isEmpty()) {
+        QFile graphFile(dependencyGraphFile.first());
+        if (!graphFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            std::cerr << "Cannot open output file " << QDir::toNativeSeparators(graphFile.fileName()).toStdString()
+                      << ':' << graphFile.errorString().toStdString() << std::endl;
+            return 1;
+        }
+        graphFile.write(QJsonDocument(QJsonArray::fromVariantList(graph)).toJson());
+    }
+    if (!prefetchManifestFile.isEmpty()) {
+        // relative to the directory of the main document
+        QString baseDirectory;
+        if (!qmlFiles.isEmpty())
+            baseDirectory = QFileInfo(qmlFiles.first()).absolutePath();
+        else if (!qmlRootPaths.isEmpty())
+            baseDirectory = QFileInfo(qmlRootPaths.first()).absoluteFilePath();
+        if (!writePrefetchManifest(prefetchManifestFile.first(), graph, QDir::cleanPath(baseDirectory)))
+            return 1;
+    }
     return 0;
 }
@@ -64,6 +64,18 @@ static const char usageTextC[] =
 "    -help  Show this information and exit.\n"
 "    -fromStart\n"
 "           Record as soon as the engine is started, default is false.\n"
+"    -compress\n"
+"           Compress the trace data before sending it over the connection.\n"
+"    -memory\n"
+"           Attribute memory allocations to QML types and source locations.\n"
+"           Only when launching the program.\n"
+"    -heapSampling <milliseconds>\n"
+"           Sample the live JavaScript heap periodically.\n"
+"           Only when launching the program.\n"
+"    -allocationSampling <bytes>\n"
+"           Record the JavaScript stack about every <bytes> bytes allocated on\n"
+"           the JavaScript heap and save the allocation call tree.\n"
+"           Only when launching the program.\n"
 "    -p <number>, -port <number>\n"
 "           TCP/IP port to use, default is 3768.\n"
 "    -v, -verbose\n"
@@ -96,6 +108,7 @@ QmlProfilerApplication::QmlProfilerApplication(int &argc, char **argv) :
     m_v8DataReady(false)
 {
     m_connectTimer.setInterval(1000);
+    m_qmlProfilerClient.setTransportFlags(QQmlProfilerService::BatchedTransport);
     connect(&m_connectTimer, SIGNAL(timeout()), this, SLOT(tryToConnect()));
 
     connect(&m_connection, SIGNAL(connected()), this, SLOT(connected()));
@@ -109,6 +122,10 @@ QmlProfilerApplication::QmlProfilerApplication(int &argc, char **argv) :
     connect(&m_qmlProfilerClient, SIGNAL(traceFinished(qint64)), &m_profilerData, SLOT(setTraceEndTime(qint64)));
     connect(&m_qmlProfilerClient, SIGNAL(traceStarted(qint64)), &m_profilerData, SLOT(setTraceStartTime(qint64)));
     connect(&m_qmlProfilerClient, SIGNAL(frame(qint64,int,int,int)), &m_profilerData, SLOT(addFrameEvent(qint64,int,int,int)));
+    connect(&m_qmlProfilerClient, SIGNAL(memoryAllocation(QQmlProfilerService::MemoryType,qint64,qint64,int,QString,QmlEventLocation)),
+            &m_profilerData, SLOT(addMemoryEvent(QQmlProfilerService::MemoryType,qint64,qint64,int,QString,QmlEventLocation)));
+    connect(&m_qmlProfilerClient, SIGNAL(allocationSite(qint64,int,qint64,int,QString,bool,QmlEventLocation)),
+            &m_profilerData, SLOT(addAllocationSite(qint64,int,qint64,int,QString,bool,QmlEventLocation)));
     connect(&m_qmlProfilerClient, SIGNAL(complete()), this, SLOT(qmlComplete()));
 
     connect(&m_v8profilerClient, SIGNAL(enabledChanged()), this, SLOT(profilerClientEnabled()));
@@ -156,6 +173,35 @@ bool QmlProfilerApplication::parseArguments()
                 logError(QString("'%1' is not a valid port").arg(portStr));
                 return false;
             }
+        } else if (arg == QLatin1String("-memory")) {
+            m_programEnvironment << QLatin1String("QML_PROFILE_MEMORY=1");
+        } else if (arg == QLatin1String("-heapSampling")) {
+            if (argPos + 1 == arguments().size()) {
+                return false;
+            }
+            const QString intervalStr = arguments().at(++argPos);
+            bool isNumber;
+            const int interval = intervalStr.toInt(&isNumber);
+            if (!isNumber || interval <= 0) {
+                logError(QString("'%1' is not a valid interval").arg(intervalStr));
+                return false;
+            }
+            m_programEnvironment << QString("QML_PROFILE_HEAP_SAMPLING_INTERVAL=%1").arg(interval);
+        } else if (arg == QLatin1String("-allocationSampling")) {
+            if (argPos + 1 == arguments().size()) {
+                return false;
+            }
+            const QString intervalStr = arguments().at(++argPos);
+            bool isNumber;
+            const int interval = intervalStr.toInt(&isNumber);
+            if (!isNumber || interval <= 0) {
+                logError(QString("'%1' is not a valid interval").arg(intervalStr));
+                return false;
+            }
+            m_programEnvironment << QString("QV4_PROFILE_ALLOCATION_SAMPLING_INTERVAL=%1").arg(interval);
+        } else if (arg == QLatin1String("-compress")) {
+            m_qmlProfilerClient.setTransportFlags(QQmlProfilerService::BatchedTransport
+                                                  | QQmlProfilerService::CompressedTransport);
         } else if (arg == QLatin1String("-fromStart")) {
             m_qmlProfilerClient.setRecording(true);
             m_v8profilerClient.setRecording(true);
@@ -261,6 +307,8 @@ void QmlProfilerApplication::run()
         arguments << m_programArguments;
 
         m_process->setProcessChannelMode(QProcess::MergedChannels);
+        if (!m_programEnvironment.isEmpty())
+            m_process->setEnvironment(QProcess::systemEnvironment() + m_programEnvironment);
         connect(m_process, SIGNAL(readyRead()), this, SLOT(processHasOutput()));
         connect(m_process, SIGNAL(finished(int,QProcess::ExitStatus)), this,
                 SLOT(processFinished()));
@@ -96,6 +96,7 @@ private:
     // LaunchMode
     QString m_programPath;
     QStringList m_programArguments;
+    QStringList m_programEnvironment;
     QProcess *m_process;
     QString m_tracePrefix;
 
@@ -109,6 +109,7 @@ public:
     QmlProfilerClientPrivate()
         : inProgressRanges(0)
         , maximumTime(0)
+        , transportFlags(0)
     {
         ::memset(rangeCount, 0,
                  QQmlProfilerService::MaximumRangeType * sizeof(int));
@@ -121,6 +122,7 @@ public:
     QStack<QQmlProfilerService::BindingType> bindingTypes;
     int rangeCount[QQmlProfilerService::MaximumRangeType];
     qint64 maximumTime;
+    int transportFlags;
 };
 
 QmlProfilerClient::QmlProfilerClient(
@@ -143,14 +145,42 @@ void QmlProfilerClient::clearData()
     ProfilerClient::clearData();
 }
 
+void QmlProfilerClient::setTransportFlags(int flags)
+{
+    d->transportFlags = flags;
+}
+
 void QmlProfilerClient::sendRecordingStatus()
 {
     QByteArray ba;
     QDataStream stream(&ba, QIODevice::WriteOnly);
     stream << isRecording();
+    if (d->transportFlags)
+        stream << -1 << d->transportFlags;
     sendMessage(ba);
 }
 
+void QmlProfilerClient::unpackMessages(QByteArray batch, bool compressed)
+{
+    if (compressed)
+        batch = qUncompress(batch);
+
+    QDataStream stream(&batch, QIODevice::ReadOnly);
+    qint64 time = 0;
+    while (!stream.atEnd()) {
+        qint64 delta;
+        QByteArray rest;
+        stream >> delta >> rest;
+        time += delta;
+
+        QByteArray message;
+        QDataStream out(&message, QIODevice::WriteOnly);
+        out << time;
+        message.append(rest);
+        messageReceived(message);
+    }
+}
+
 void QmlProfilerClient::messageReceived(const QByteArray &data)
 {
     QByteArray rwData = data;
@@ -189,6 +219,37 @@ void QmlProfilerClient::messageReceived(const QByteArray &data)
     } else if (messageType == QQmlProfilerService::Complete) {
         emit complete();
 
+    } else if (messageType == QQmlProfilerService::Batch) {
+        bool compressed;
+        QByteArray batch;
+        stream >> compressed >> batch;
+        unpackMessages(batch, compressed);
+
+    } else if (messageType == QQmlProfilerService::MemoryAllocation) {
+        int type;
+        QString typeName, fileName;
+        int x, y;
+        qint64 size;
+        stream >> type >> typeName >> fileName >> x >> y >> size;
+
+        if (type >= QQmlProfilerService::MaximumMemoryType)
+            return;
+
+        if (type == QQmlProfilerService::JavaScriptAllocationSite) {
+            int samples, depth;
+            bool objectClass;
+            stream >> samples >> depth >> objectClass;
+            emit allocationSite(time, depth, size, samples, typeName, objectClass,
+                                QmlEventLocation(fileName, x, y));
+        } else if (type == QQmlProfilerService::JavaScriptHeap) {
+            // Heap samples have no location, they carry the number of objects instead.
+            emit memoryAllocation(QQmlProfilerService::JavaScriptHeap, time, size, x, typeName,
+                                  QmlEventLocation());
+        } else {
+            emit memoryAllocation((QQmlProfilerService::MemoryType)type, time, size, 1, typeName,
+                                  QmlEventLocation(fileName, x, y));
+        }
+        d->maximumTime = qMax(time, d->maximumTime);
     } else {
         int range;
         stream >> range;
@@ -90,6 +90,8 @@ public:
     QmlProfilerClient(QQmlDebugConnection *client);
     ~QmlProfilerClient();
 
+    void setTransportFlags(int flags);
+
 public slots:
     void clearData();
     void sendRecordingStatus();
@@ -103,11 +105,17 @@ signals:
                const QStringList &data,
                const QmlEventLocation &location);
     void frame(qint64 time, int frameRate, int animationCount, int threadId);
+    void memoryAllocation(QQmlProfilerService::MemoryType type, qint64 time, qint64 size,
+                          int count, const QString &typeName, const QmlEventLocation &location);
+    void allocationSite(qint64 time, int depth, qint64 bytes, int samples, const QString &name,
+                        bool objectClass, const QmlEventLocation &location);
 
 protected:
     virtual void messageReceived(const QByteArray &);
 
 private:
+    void unpackMessages(QByteArray batch, bool compressed);
+
     class QmlProfilerClientPrivate *d;
 };
 
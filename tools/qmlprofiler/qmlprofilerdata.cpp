@@ -45,6 +45,8 @@
 #include <QUrl>
 #include <QHash>
 #include <QFile>
+#include <QTemporaryFile>
+#include <QDataStream>
 #include <QXmlStreamReader>
 
 #include <algorithm>
@@ -55,7 +57,11 @@ namespace Constants {
     const char TYPE_CREATING_STR[] = "Creating";
     const char TYPE_BINDING_STR[] = "Binding";
     const char TYPE_HANDLINGSIGNAL_STR[] = "HandlingSignal";
-    const char PROFILER_FILE_VERSION[] = "1.02";
+    const char TYPE_OBJECTMEMORY_STR[] = "ObjectMemory";
+    const char TYPE_JAVASCRIPTMEMORY_STR[] = "JavaScriptMemory";
+    const char TYPE_JAVASCRIPTHEAP_STR[] = "JavaScriptHeap";
+    const char TYPE_JAVASCRIPTALLOCATIONSITE_STR[] = "JavaScriptAllocationSite";
+    const char PROFILER_FILE_VERSION[] = "1.03";
 
     // Save animation frames in "Qt5 style", 3 would mean Qt4
     const int ANIMATION_FRAME_TYPE = 4;
@@ -99,6 +105,54 @@ Q_DECLARE_TYPEINFO(QmlRangeEventData, Q_MOVABLE_TYPE);
 Q_DECLARE_TYPEINFO(QmlRangeEventStartInstance, Q_MOVABLE_TYPE);
 QT_END_NAMESPACE
 
+struct QmlMemoryEvent {
+    QmlMemoryEvent() {}
+    QmlMemoryEvent(QQmlProfilerService::MemoryType _type, qint64 _time, qint64 _size, int _count,
+                   const QString &_typeName, const QmlEventLocation &_location)
+        : type(_type), time(_time), size(_size), count(_count), typeName(_typeName),
+          location(_location) {}
+    QQmlProfilerService::MemoryType type;
+    qint64 time;
+    qint64 size;
+    int count;
+    QString typeName;
+    QmlEventLocation location;
+};
+
+QT_BEGIN_NAMESPACE
+Q_DECLARE_TYPEINFO(QmlMemoryEvent, Q_MOVABLE_TYPE);
+QT_END_NAMESPACE
+
+static QDataStream &operator<<(QDataStream &stream, const QmlMemoryEvent &event)
+{
+    return stream << (int)event.type << event.time << event.size << event.count << event.typeName
+                  << event.location.filename << event.location.line << event.location.column;
+}
+
+static QDataStream &operator>>(QDataStream &stream, QmlMemoryEvent &event)
+{
+    int type;
+    stream >> type >> event.time >> event.size >> event.count >> event.typeName
+           >> event.location.filename >> event.location.line >> event.location.column;
+    event.type = (QQmlProfilerService::MemoryType)type;
+    return stream;
+}
+
+// Node of the JS allocation call tree. The nodes arrive in pre-order.
+struct QmlAllocationSite {
+    qint64 time;
+    int depth;
+    qint64 bytes;
+    int samples;
+    QString name;
+    bool objectClass;
+    QmlEventLocation location;
+};
+
+QT_BEGIN_NAMESPACE
+Q_DECLARE_TYPEINFO(QmlAllocationSite, Q_MOVABLE_TYPE);
+QT_END_NAMESPACE
+
 struct QV8EventInfo {
     QString displayName;
     QString eventHashStr;
@@ -121,6 +175,13 @@ public:
     QHash<QString, QmlRangeEventData *> eventDescriptions;
     QVector<QmlRangeEventStartInstance> startInstanceList;
     QHash<QString, QV8EventInfo *> v8EventHash;
+    // Memory events are numerous and carry strings, so they are spooled to disk and only read
+    // back when saving. memoryEvents is used if no temporary file can be created.
+    QVector<QmlMemoryEvent> memoryEvents;
+    QTemporaryFile memorySpool;
+    QDataStream memorySpoolStream;
+    int memorySpoolCount;
+    QVector<QmlAllocationSite> allocationSites;
 
     qint64 traceStartTime;
     qint64 traceEndTime;
@@ -140,6 +201,7 @@ QmlProfilerData::QmlProfilerData(QObject *parent) :
     QObject(parent),d(new QmlProfilerDataPrivate(this))
 {
     d->state = Empty;
+    d->memorySpoolStream.setDevice(&d->memorySpool);
     clear();
 }
 
@@ -154,6 +216,13 @@ void QmlProfilerData::clear()
     qDeleteAll(d->eventDescriptions.values());
     d->eventDescriptions.clear();
     d->startInstanceList.clear();
+    d->memoryEvents.clear();
+    if (d->memorySpool.isOpen()) {
+        d->memorySpool.resize(0);
+        d->memorySpool.seek(0);
+    }
+    d->memorySpoolCount = 0;
+    d->allocationSites.clear();
 
     qDeleteAll(d->v8EventHash.values());
     d->v8EventHash.clear();
@@ -205,6 +274,22 @@ QString QmlProfilerData::qmlRangeTypeAsString(QQmlProfilerService::RangeType typ
     }
 }
 
+QString QmlProfilerData::memoryTypeAsString(QQmlProfilerService::MemoryType typeEnum)
+{
+    switch (typeEnum) {
+    case QQmlProfilerService::ObjectMemory:
+        return QLatin1String(Constants::TYPE_OBJECTMEMORY_STR);
+    case QQmlProfilerService::JavaScriptMemory:
+        return QLatin1String(Constants::TYPE_JAVASCRIPTMEMORY_STR);
+    case QQmlProfilerService::JavaScriptHeap:
+        return QLatin1String(Constants::TYPE_JAVASCRIPTHEAP_STR);
+    case QQmlProfilerService::JavaScriptAllocationSite:
+        return QLatin1String(Constants::TYPE_JAVASCRIPTALLOCATIONSITE_STR);
+    default:
+        return QString::number((int)typeEnum);
+    }
+}
+
 void QmlProfilerData::setTraceStartTime(qint64 time)
 {
     d->traceStartTime = time;
@@ -299,6 +384,20 @@ void QmlProfilerData::addFrameEvent(qint64 time, int framerate, int animationcou
     d->startInstanceList.append(rangeEventStartInstance);
 }
 
+void QmlProfilerData::addMemoryEvent(QQmlProfilerService::MemoryType type, qint64 time,
+                                     qint64 size, int count, const QString &typeName,
+                                     const QmlEventLocation &location)
+{
+    setState(AcquiringData);
+    const QmlMemoryEvent event(type, time, size, count, typeName, location);
+    if (d->memorySpool.isOpen() || d->memorySpool.open()) {
+        d->memorySpoolStream << event;
+        ++d->memorySpoolCount;
+    } else {
+        d->memoryEvents.append(event);
+    }
+}
+
 QString QmlProfilerData::rootEventName()
 {
     return tr("<program>");
@@ -442,6 +541,15 @@ void QmlProfilerData::sortStartTimes()
     }
 }
 
+void QmlProfilerData::addAllocationSite(qint64 time, int depth, qint64 bytes, int samples,
+                                        const QString &name, bool objectClass,
+                                        const QmlEventLocation &location)
+{
+    setState(AcquiringData);
+    const QmlAllocationSite site = { time, depth, bytes, samples, name, objectClass, location };
+    d->allocationSites.append(site);
+}
+
 void QmlProfilerData::complete()
 {
     setState(ProcessingData);
@@ -453,7 +561,72 @@ void QmlProfilerData::complete()
 
 bool QmlProfilerData::isEmpty() const
 {
-    return d->startInstanceList.isEmpty() && d->v8EventHash.isEmpty();
+    return d->startInstanceList.isEmpty() && d->v8EventHash.isEmpty()
+            && d->memoryEvents.isEmpty() && d->memorySpoolCount == 0
+            && d->allocationSites.isEmpty();
+}
+
+static void writeMemoryEvent(QXmlStreamWriter &stream, const QmlMemoryEvent &memoryEvent)
+{
+    stream.writeStartElement(QStringLiteral("allocation"));
+    stream.writeAttribute(QStringLiteral("time"), QString::number(memoryEvent.time));
+    stream.writeAttribute(QStringLiteral("type"),
+                          QmlProfilerData::memoryTypeAsString(memoryEvent.type));
+    stream.writeAttribute(QStringLiteral("size"), QString::number(memoryEvent.size));
+    if (memoryEvent.type == QQmlProfilerService::JavaScriptHeap)
+        stream.writeAttribute(QStringLiteral("count"), QString::number(memoryEvent.count));
+    if (!memoryEvent.typeName.isEmpty())
+        stream.writeAttribute(QStringLiteral("typeName"), memoryEvent.typeName);
+    if (!memoryEvent.location.filename.isEmpty()) {
+        stream.writeAttribute(QStringLiteral("filename"), memoryEvent.location.filename);
+        stream.writeAttribute(QStringLiteral("line"), QString::number(memoryEvent.location.line));
+        stream.writeAttribute(QStringLiteral("column"), QString::number(memoryEvent.location.column));
+    }
+    stream.writeEndElement();
+}
+
+// Each report of the allocation tree is written as one allocationTree element, with the sites
+// nested as they were recorded: functions contain their callees and, as leaves, the classes of
+// the objects allocated in them.
+static void writeAllocationSites(QXmlStreamWriter &stream,
+                                 const QVector<QmlAllocationSite> &sites)
+{
+    bool treeOpen = false;
+    qint64 treeTime = 0;
+    int openSites = 0;
+    foreach (const QmlAllocationSite &site, sites) {
+        if (!treeOpen || site.time != treeTime) {
+            if (treeOpen) {
+                for (; openSites > 0; --openSites)
+                    stream.writeEndElement(); // site
+                stream.writeEndElement(); // allocationTree
+            }
+            stream.writeStartElement(QStringLiteral("allocationTree"));
+            stream.writeAttribute(QStringLiteral("time"), QString::number(site.time));
+            treeOpen = true;
+            treeTime = site.time;
+        }
+        for (; openSites > site.depth; --openSites)
+            stream.writeEndElement(); // site
+
+        stream.writeStartElement(QStringLiteral("site"));
+        if (site.objectClass) {
+            stream.writeAttribute(QStringLiteral("typeName"), site.name);
+        } else {
+            stream.writeAttribute(QStringLiteral("function"), site.name);
+            stream.writeAttribute(QStringLiteral("filename"), site.location.filename);
+            stream.writeAttribute(QStringLiteral("line"), QString::number(site.location.line));
+            stream.writeAttribute(QStringLiteral("column"), QString::number(site.location.column));
+        }
+        stream.writeAttribute(QStringLiteral("samples"), QString::number(site.samples));
+        stream.writeAttribute(QStringLiteral("size"), QString::number(site.bytes));
+        ++openSites;
+    }
+    if (treeOpen) {
+        for (; openSites > 0; --openSites)
+            stream.writeEndElement(); // site
+        stream.writeEndElement(); // allocationTree
+    }
 }
 
 bool QmlProfilerData::save(const QString &filename)
@@ -550,6 +723,21 @@ bool QmlProfilerData::save(const QString &filename)
     }
     stream.writeEndElement(); // v8 profiler output
 
+    stream.writeStartElement(QStringLiteral("memoryProfile"));
+    if (d->memorySpoolCount > 0) {
+        d->memorySpoolStream.device()->seek(0);
+        QmlMemoryEvent memoryEvent;
+        for (int i = 0; i < d->memorySpoolCount; ++i) {
+            d->memorySpoolStream >> memoryEvent;
+            writeMemoryEvent(stream, memoryEvent);
+        }
+        d->memorySpoolStream.device()->seek(d->memorySpool.size());
+    }
+    foreach (const QmlMemoryEvent &memoryEvent, d->memoryEvents)
+        writeMemoryEvent(stream, memoryEvent);
+    writeAllocationSites(stream, d->allocationSites);
+    stream.writeEndElement(); // memoryProfile
+
     stream.writeEndElement(); // trace
     stream.writeEndDocument();
 
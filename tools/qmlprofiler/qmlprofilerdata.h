@@ -65,6 +65,7 @@ public:
     static QString getHashStringForQmlEvent(const QmlEventLocation &location, int eventType);
     static QString getHashStringForV8Event(const QString &displayName, const QString &function);
     static QString qmlRangeTypeAsString(QQmlProfilerService::RangeType typeEnum);
+    static QString memoryTypeAsString(QQmlProfilerService::MemoryType typeEnum);
     static QString rootEventName();
     static QString rootEventDescription();
 
@@ -89,6 +90,10 @@ public slots:
     void addV8Event(int depth, const QString &function, const QString &filename,
                     int lineNumber, double totalTime, double selfTime);
     void addFrameEvent(qint64 time, int framerate, int animationcount, int threadId);
+    void addMemoryEvent(QQmlProfilerService::MemoryType type, qint64 time, qint64 size, int count,
+                        const QString &typeName, const QmlEventLocation &location);
+    void addAllocationSite(qint64 time, int depth, qint64 bytes, int samples, const QString &name,
+                           bool objectClass, const QmlEventLocation &location);
 
     void complete();
     bool save(const QString &filename);
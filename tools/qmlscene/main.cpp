@@ -46,6 +46,12 @@
 #include <QtCore/qdatetime.h>
 #include <QtCore/qpointer.h>
 #include <QtCore/qscopedpointer.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qfile.h>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
 
 #include <QtGui/QGuiApplication>
 
@@ -67,6 +73,13 @@
 #include <QtCore/QTranslator>
 #include <QtCore/QLibraryInfo>
 
+#include <algorithm>
+#include <cstdio>
+
+#if defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
 #ifdef QML_RUNTIME_TESTING
 class RenderStatistics
 {
@@ -155,6 +168,7 @@ struct Options
         , quitImmediately(false)
         , resizeViewToRootItem(false)
         , multisample(false)
+        , benchmarkFrames(0)
     {
     }
 
@@ -172,8 +186,200 @@ struct Options
     bool resizeViewToRootItem;
     bool multisample;
     QString translationFile;
+    int benchmarkFrames;
+    QString benchmarkFlickable;
+    QString benchmarkOutput;
+};
+
+/* Runs the scene for a fixed number of frames after the first one and writes
+   a JSON report of the startup phases, the frame times and the peak memory
+   use. Phase times within a frame come from QQuickWindow::frameStatistics(),
+   the interval between frames is measured here. */
+class FrameBenchmark : public QObject
+{
+public:
+    FrameBenchmark(const Options &options);
+
+    void markPhase(const char *name);
+    void start(QQuickWindow *window, QObject *root);
+    bool writeReport();
+
+private:
+    void frameSwapped();
+    void nextFrame();
+    void flick();
+
+    Options m_options;
+    QElapsedTimer m_timer;
+    qint64 m_lastPhase;
+    QJsonObject m_phases;
+
+    QQuickWindow *m_window;
+    QPointer<QObject> m_flickable;
+    int m_frames;
+    QVariantMap m_frameStatistics;
+
+    QMutex m_lock;
+    QVector<qint64> m_swapTimes;
 };
 
+FrameBenchmark::FrameBenchmark(const Options &options)
+    : m_options(options)
+    , m_lastPhase(0)
+    , m_window(0)
+    , m_frames(0)
+{
+    m_timer.start();
+}
+
+void FrameBenchmark::markPhase(const char *name)
+{
+    qint64 now = m_timer.nsecsElapsed();
+    m_phases.insert(QLatin1String(name), (now - m_lastPhase) / 1000000.);
+    m_lastPhase = now;
+}
+
+void FrameBenchmark::start(QQuickWindow *window, QObject *root)
+{
+    m_window = window;
+    if (!m_options.benchmarkFlickable.isEmpty()) {
+        m_flickable = root->objectName() == m_options.benchmarkFlickable
+                ? root : root->findChild<QObject *>(m_options.benchmarkFlickable);
+        if (!m_flickable)
+            m_flickable = window->contentItem()->findChild<QObject *>(m_options.benchmarkFlickable);
+        if (!m_flickable)
+            qWarning("qmlscene: no Flickable named '%s' to flick.", qPrintable(m_options.benchmarkFlickable));
+    }
+
+    // frameSwapped() is emitted on the render thread, nextFrame() runs on the GUI thread.
+    connect(window, &QQuickWindow::frameSwapped, this, &FrameBenchmark::frameSwapped, Qt::DirectConnection);
+    connect(window, &QQuickWindow::frameSwapped, this, &FrameBenchmark::nextFrame, Qt::QueuedConnection);
+    window->update();
+}
+
+void FrameBenchmark::frameSwapped()
+{
+    QMutexLocker locker(&m_lock);
+    m_swapTimes.append(m_timer.nsecsElapsed());
+}
+
+void FrameBenchmark::nextFrame()
+{
+    if (m_frames > m_options.benchmarkFrames)
+        return;
+
+    if (m_frames == 0) {
+        markPhase("firstFrame");
+        m_phases.insert(QLatin1String("total"), m_lastPhase / 1000000.);
+        // Only measure the frames after the first one, which includes the scene graph
+        // initialization.
+        m_window->resetFrameStatistics();
+        QMutexLocker locker(&m_lock);
+        m_swapTimes.clear();
+        m_swapTimes.reserve(m_options.benchmarkFrames + 1);
+        m_swapTimes.append(m_timer.nsecsElapsed());
+    }
+
+    if (++m_frames > m_options.benchmarkFrames) {
+        m_frameStatistics = m_window->frameStatistics();
+        QCoreApplication::quit();
+        return;
+    }
+
+    if (m_flickable)
+        flick();
+    m_window->update();
+}
+
+/* Keeps the Flickable moving by flicking it towards the opposite end whenever
+   it came to rest. */
+void FrameBenchmark::flick()
+{
+    if (m_flickable->property("moving").toBool())
+        return;
+    qreal velocity = m_flickable->property("maximumFlickVelocity").toReal();
+    if (!m_flickable->property("atYEnd").toBool() && !m_flickable->property("atXEnd").toBool())
+        velocity = -velocity;
+    QMetaObject::invokeMethod(m_flickable, "flick", Q_ARG(qreal, velocity), Q_ARG(qreal, velocity));
+}
+
+static QJsonObject frameIntervalStatistics(QVector<qreal> intervals)
+{
+    QJsonObject result;
+    result.insert(QLatin1String("count"), intervals.size());
+    if (intervals.isEmpty())
+        return result;
+
+    qreal sum = 0;
+    for (int i = 0; i < intervals.size(); ++i)
+        sum += intervals.at(i);
+    std::sort(intervals.begin(), intervals.end());
+    const int last = intervals.size() - 1;
+    result.insert(QLatin1String("average"), sum / intervals.size());
+    result.insert(QLatin1String("minimum"), intervals.first());
+    result.insert(QLatin1String("median"), intervals.at(last / 2));
+    result.insert(QLatin1String("percentile90"), intervals.at(last * 90 / 100));
+    result.insert(QLatin1String("percentile99"), intervals.at(last * 99 / 100));
+    result.insert(QLatin1String("maximum"), intervals.last());
+    return result;
+}
+
+/* Returns the peak resident set size of the process in kilobytes, or -1 where
+   it is not known. */
+static qint64 peakMemoryUsage()
+{
+#if defined(Q_OS_UNIX)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+#  if defined(Q_OS_MAC)
+    return usage.ru_maxrss / 1024;
+#  else
+    return usage.ru_maxrss;
+#  endif
+#else
+    return -1;
+#endif
+}
+
+bool FrameBenchmark::writeReport()
+{
+    QVector<qreal> intervals;
+    {
+        QMutexLocker locker(&m_lock);
+        for (int i = 1; i < m_swapTimes.size(); ++i)
+            intervals.append((m_swapTimes.at(i) - m_swapTimes.at(i - 1)) / 1000000.);
+    }
+
+    QJsonArray perFrame;
+    for (int i = 0; i < intervals.size(); ++i)
+        perFrame.append(intervals.at(i));
+
+    QJsonObject report;
+    report.insert(QLatin1String("file"), m_options.file.toString());
+    report.insert(QLatin1String("frames"), intervals.size());
+    if (m_flickable)
+        report.insert(QLatin1String("flickable"), m_options.benchmarkFlickable);
+    report.insert(QLatin1String("startup"), m_phases);
+    report.insert(QLatin1String("frameInterval"), frameIntervalStatistics(intervals));
+    report.insert(QLatin1String("frameIntervals"), perFrame);
+    report.insert(QLatin1String("frameStatistics"), QJsonObject::fromVariantMap(m_frameStatistics));
+    report.insert(QLatin1String("peakMemoryKB"), double(peakMemoryUsage()));
+
+    const QByteArray json = QJsonDocument(report).toJson();
+    if (m_options.benchmarkOutput.isEmpty()) {
+        fwrite(json.constData(), 1, json.size(), stdout);
+        return true;
+    }
+
+    QFile file(m_options.benchmarkOutput);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size()) {
+        qWarning("qmlscene: could not write the benchmark report to '%s'.", qPrintable(m_options.benchmarkOutput));
+        return false;
+    }
+    return true;
+}
+
 #if defined(QMLSCENE_BUNDLE)
 QFileInfoList findQmlFiles(const QString &dirName)
 {
@@ -361,6 +567,10 @@ static void usage()
     qWarning("  -I <path> ................................. Add <path> to the list of import paths");
     qWarning("  -B <name> <file> .......................... Add a named bundle");
     qWarning("  -translation <translationfile> ............ Set the language to run in");
+    qWarning("  --benchmark <frames> ...................... Render <frames> frames after the first one, then quit");
+    qWarning("                                              and write a JSON report of the startup and frame times");
+    qWarning("  --benchmark-flick <objectName> ............ Keep flicking the named Flickable while benchmarking");
+    qWarning("  --benchmark-output <file> ................. Write the benchmark report to <file> instead of stdout");
 
     qWarning(" ");
     exit(1);
@@ -397,6 +607,12 @@ int main(int argc, char ** argv)
                 options.resizeViewToRootItem = true;
             else if (lowerArgument == QLatin1String("--multisample"))
                 options.multisample = true;
+            else if (lowerArgument == QLatin1String("--benchmark") && i + 1 < argc)
+                options.benchmarkFrames = qMax(1, QString::fromLatin1(argv[++i]).toInt());
+            else if (lowerArgument == QLatin1String("--benchmark-flick") && i + 1 < argc)
+                options.benchmarkFlickable = QString::fromLocal8Bit(argv[++i]);
+            else if (lowerArgument == QLatin1String("--benchmark-output") && i + 1 < argc)
+                options.benchmarkOutput = QString::fromLocal8Bit(argv[++i]);
             else if (lowerArgument == QLatin1String("-i") && i + 1 < argc)
                 imports.append(QString::fromLatin1(argv[++i]));
             else if (lowerArgument == QLatin1String("-b") && i + 2 < argc) {
@@ -462,6 +678,10 @@ int main(int argc, char ** argv)
 
             // TODO: as soon as the engine construction completes, the debug service is
             // listening for connections.  But actually we aren't ready to debug anything.
+            QScopedPointer<FrameBenchmark> benchmark;
+            if (options.benchmarkFrames > 0)
+                benchmark.reset(new FrameBenchmark(options));
+
             QQmlEngine engine;
             QPointer<QQmlComponent> component = new QQmlComponent(&engine);
             for (int i = 0; i < imports.size(); ++i)
@@ -476,17 +696,26 @@ int main(int argc, char ** argv)
                 loadDummyDataFiles(engine, fi.path());
             }
             QObject::connect(&engine, SIGNAL(quit()), QCoreApplication::instance(), SLOT(quit()));
+
+            if (benchmark)
+                benchmark->markPhase("engine");
+
             component->loadUrl(options.file);
             if ( !component->isReady() ) {
                 qWarning("%s", qPrintable(component->errorString()));
                 return -1;
             }
+            // Loading the types also compiles them.
+            if (benchmark)
+                benchmark->markPhase("load");
 
             QObject *topLevel = component->create();
             if (!topLevel && component->isError()) {
                 qWarning("%s", qPrintable(component->errorString()));
                 return -1;
             }
+            if (benchmark)
+                benchmark->markPhase("create");
             QScopedPointer<QQuickWindow> window(qobject_cast<QQuickWindow *>(topLevel));
             if (window) {
                 engine.setIncubationController(window->incubationController());
@@ -529,6 +758,13 @@ int main(int argc, char ** argv)
                     window->show();
             }
 
+            if (benchmark) {
+                if (window)
+                    benchmark->start(window.data(), topLevel);
+                else
+                    qWarning("qmlscene: nothing to benchmark, the root object is neither a Window nor an Item.");
+            }
+
             if (options.quitImmediately)
                 QMetaObject::invokeMethod(QCoreApplication::instance(), "quit", Qt::QueuedConnection);
 
@@ -539,6 +775,8 @@ int main(int argc, char ** argv)
 #ifdef QML_RUNTIME_TESTING
             RenderStatistics::printTotalStats();
 #endif
+            if (benchmark && !benchmark->writeReport())
+                exitCode = 1;
             // Ready to exit. Notice that the component might be owned by
             // QQuickView if one was created. That case is tracked by
             // QPointer, so it is safe to delete the component here.
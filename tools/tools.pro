@@ -10,7 +10,8 @@ qmlimportscanner.CONFIG = host_build
     SUBDIRS += \
         qml \
         qmlprofiler \
-        qmlbundle
+        qmlbundle \
+        qmlcachegen
     qtHaveModule(quick) {
         SUBDIRS += qmlscene qmlplugindump
         qtHaveModule(widgets): SUBDIRS += qmleasing
@@ -22,7 +23,7 @@ qmlimportscanner.CONFIG = host_build
 qml.depends = qmlimportscanner
 qmleasing.depends = qmlimportscanner
 
-# qmlmin, qmlimportscanner & qmlbundle are build tools.
+# qmlmin, qmlimportscanner, qmlbundle & qmlcachegen are build tools.
 # qmlscene is needed by the autotests.
 # qmltestrunner may be useful for manual testing.
 # qmlplugindump cannot be a build tool, because it loads target plugins.